@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+'''
+Convert a binary GStreamer debug log into the regular text format.
+
+How to run:
+1) generate some log
+GST_DEBUG="*:5" GST_DEBUG_BINARY=1 GST_DEBUG_FILE=gst.blog <application>
+
+2) convert it, the output can be used with the other tools
+python3 gst-debug-decode.py gst.blog > gst.log
+
+Messages are buffered per thread when logging, so they are sorted by their
+timestamp unless --no-sort is given.
+'''
+
+import argparse
+import logging
+import os
+import re
+import struct
+import sys
+
+
+logging.basicConfig(level=logging.WARNING)
+logger = logging.getLogger('gst-debug-decode')
+
+MAGIC = b'GSTBLOG\0'
+VERSION = 1
+
+LEVELS = ['', 'ERROR', 'WARN', 'FIXME', 'INFO', 'DEBUG', 'LOG', 'TRACE', '',
+          'MEMDUMP']
+
+_CONVERSION = re.compile(r"%(?P<flags>[-+ #0']*)(?P<width>\*|\d+)?"
+                         r"(?:\.(?P<precision>\*|\d*))?"
+                         r"(?P<length>hh|h|ll|l|L|q|j|z|t|I64|I32)?"
+                         r"(?P<conversion>[diouxXeEfFgGaAcsp%])")
+
+
+class DecodeError(Exception):
+    pass
+
+
+class Reader(object):
+    """
+    Reads the values of a binary log in the byte order given by its header.
+    """
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+        self.order = '<'
+
+    def eof(self):
+        return self.pos >= len(self.data)
+
+    def read(self, fmt):
+        fmt = self.order + fmt
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise DecodeError('truncated log')
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return values if len(values) > 1 else values[0]
+
+    def read_string(self):
+        length = self.read('I')
+        if length == 0xffffffff:
+            return None
+        if self.pos + length > len(self.data):
+            raise DecodeError('truncated log')
+        s = self.data[self.pos:self.pos + length]
+        self.pos += length
+        return s.decode('utf-8', errors='replace')
+
+    def read_arg(self):
+        kind = self.read('B')
+        if kind == ord('i'):
+            return self.read('q')
+        if kind == ord('u') or kind == ord('p'):
+            value = self.read('Q')
+            return Pointer(value) if kind == ord('p') else value
+        if kind == ord('d'):
+            return self.read('d')
+        if kind == ord('s'):
+            return self.read_string()
+        raise DecodeError('unknown argument type %r' % chr(kind))
+
+
+class Pointer(int):
+    pass
+
+
+def _format_one(spec, value):
+    flags = spec['flags'].replace("'", '')
+    conversion = spec['conversion']
+    width = spec['width'] or ''
+    precision = spec['precision']
+    precision = '' if precision is None else '.' + precision
+
+    if conversion == 's':
+        value = '(null)' if value is None else value
+    elif conversion == 'p':
+        value = '(nil)' if value == 0 else '0x%x' % value
+        conversion = 's'
+    elif conversion == 'c':
+        value = chr(value & 0xff)
+    elif conversion in 'iu':
+        conversion = 'd'
+    elif conversion in 'aA':
+        value = float(value).hex()
+        conversion = 's'
+    elif conversion == 'F':
+        conversion = 'f'
+
+    return ('%' + flags + width + precision + conversion) % value
+
+
+def format_message(fmt, args):
+    """
+    Formats @args according to the printf style @fmt.
+    """
+    args = list(args)
+    out = []
+    pos = 0
+
+    for m in _CONVERSION.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        spec = m.groupdict()
+        if spec['conversion'] == '%':
+            out.append('%')
+            continue
+        if spec['width'] == '*':
+            spec['width'] = str(args.pop(0))
+        if spec['precision'] == '*':
+            spec['precision'] = str(args.pop(0))
+        out.append(_format_one(spec, args.pop(0)))
+
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+def _format_time(t):
+    return '%u:%02u:%02u.%09u' % (t // (3600 * 1000000000),
+                                  (t // (60 * 1000000000)) % 60,
+                                  (t // 1000000000) % 60,
+                                  t % 1000000000)
+
+
+def decode(data):
+    """
+    Yields the messages of the binary log @data as tuples of
+    (timestamp, pid, thread, level, category, file, line, function, object,
+    message).
+    """
+    reader = Reader(data)
+    strings = {0: None}
+    pid = 0
+
+    while not reader.eof():
+        if data.startswith(MAGIC, reader.pos):
+            # header, also found again if logging switched to a new file
+            reader.pos += len(MAGIC)
+            for order in ('<', '>'):
+                reader.order = order
+                version, bom, pid = struct.unpack_from(order + 'III', data,
+                                                       reader.pos)
+                if bom == 0x01020304:
+                    break
+            else:
+                raise DecodeError('invalid header')
+            if version != VERSION:
+                raise DecodeError('unsupported version %d' % version)
+            reader.pos += 12
+            strings = {0: None}
+            continue
+
+        kind = reader.read('B')
+        if kind == ord('S'):
+            string_id = reader.read('I')
+            strings[string_id] = reader.read_string()
+        elif kind == ord('M'):
+            elapsed, thread, level = reader.read('QQB')
+            category, filename, function, line = reader.read('IIII')
+            obj = reader.read_string()
+            fmt, n_args = reader.read('II')
+            args = [reader.read_arg() for i in range(n_args)]
+
+            if strings.get(fmt) is None:
+                message = args[0] if args else ''
+            else:
+                try:
+                    message = format_message(strings[fmt], args)
+                except (TypeError, ValueError, IndexError) as e:
+                    logger.warning('could not format %r: %s', strings[fmt],
+                                   e)
+                    message = strings[fmt]
+
+            level_name = LEVELS[level] if level < len(LEVELS) else str(level)
+            yield (elapsed, pid, thread, level_name,
+                   strings.get(category, ''),
+                   os.path.basename(strings.get(filename) or ''),
+                   line, strings.get(function, ''), obj, message)
+        else:
+            raise DecodeError('unknown record type %d at offset %d' %
+                              (kind, reader.pos - 1))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Convert a binary GStreamer debug log to text')
+    parser.add_argument('file', help='binary log file')
+    parser.add_argument('--no-sort', action='store_true',
+                        help='keep the order of the file instead of sorting '
+                        'messages by time')
+    args = parser.parse_args()
+
+    with open(args.file, 'rb') as f:
+        data = f.read()
+
+    if not data.startswith(MAGIC):
+        sys.exit('%s is not a binary GStreamer debug log' % args.file)
+
+    messages = []
+    try:
+        for m in decode(data):
+            messages.append(m)
+    except DecodeError as e:
+        # the end of the file might be missing if the application crashed
+        logger.warning('%s', e)
+
+    if not args.no_sort:
+        messages.sort(key=lambda m: m[0])
+
+    ptr_width = 14 if struct.calcsize('P') == 8 else 10
+    for (elapsed, pid, thread, level, category, filename, line, function,
+         obj, message) in messages:
+        print('%s %5d %*s %-7s %20s %s:%d:%s:%s %s' %
+              (_format_time(elapsed), pid, ptr_width, '0x%x' % thread,
+               level, category, filename, line, function, obj, message))
+
+
+if __name__ == '__main__':
+    main()
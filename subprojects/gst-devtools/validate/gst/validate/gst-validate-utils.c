@@ -1497,7 +1497,7 @@ gst_validate_structure_set_variables_from_struct_file (GstStructure * vars,
   gchar *config_fname;
   gchar *config_name;
   gchar *t, *config_name_dir;
-  gchar *validateflow, *expectations_dir, *actual_result_dir;
+  gchar *validateflow, *validateperf, *expectations_dir, *actual_result_dir;
   const gchar *logdir;
   gboolean local = ! !vars;
 
@@ -1530,6 +1530,8 @@ gst_validate_structure_set_variables_from_struct_file (GstStructure * vars,
       g_strdup_printf
       ("validateflow, expectations-dir=\"%s\", actual-results-dir=\"%s\"",
       expectations_dir, actual_result_dir);
+  validateperf =
+      g_strdup_printf ("validateperf, report-dir=\"%s\"", actual_result_dir);
 
   structure_set_string_literal (vars, "gst_api_version", GST_API_VERSION);
   structure_set_string_literal (vars, !local ? "test_dir" : "CONFIG_DIR",
@@ -1541,12 +1543,14 @@ gst_validate_structure_set_variables_from_struct_file (GstStructure * vars,
   structure_set_string_literal (vars, !local ? "test_path" : "CONFIG_PATH",
       struct_file);
   structure_set_string_literal (vars, "validateflow", validateflow);
+  structure_set_string_literal (vars, "validateperf", validateperf);
 
   g_free (config_dir);
   g_free (config_name_dir);
   g_free (config_fname);
   g_free (config_name);
   g_free (validateflow);
+  g_free (validateperf);
   g_free (actual_result_dir);
   g_free (expectations_dir);
 }
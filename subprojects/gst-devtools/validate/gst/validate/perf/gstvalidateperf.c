@@ -0,0 +1,467 @@
+/* GStreamer
+ *
+ * gstvalidateperf.c: A plugin to check performance budgets of streams
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <json-glib/json-glib.h>
+#include <errno.h>
+#include <time.h>
+
+#include "../validate.h"
+#include "../gst-validate-utils.h"
+#include "../gst-validate-report.h"
+#include "../gst-validate-internal.h"
+
+#include "gstvalidateperf.h"
+
+#define VALIDATE_PERF_BUDGET_EXCEEDED g_quark_from_static_string ("validateperf::budget-exceeded")
+#define VALIDATE_PERF_NOT_ATTACHED g_quark_from_static_string ("validateperf::not-attached")
+
+struct _ValidatePerfOverride
+{
+  GstValidateOverride parent;
+
+  const gchar *pad_name;
+  GstStructure *config;
+  gchar *report_file_path;
+  gboolean was_attached;
+
+  /* budgets, 0 or GST_CLOCK_TIME_NONE when not set */
+  gdouble min_fps;
+  gdouble min_realtime_factor;
+  GstClockTime max_latency;
+  gdouble max_cpu_usage;
+
+  /* measurements, protected by @lock */
+  GMutex lock;
+  guint64 n_buffers;
+  gint64 first_wall_time;
+  gint64 last_wall_time;
+  clock_t first_cpu_time;
+  clock_t last_cpu_time;
+  GstClockTime first_running_time;
+  GstClockTime last_running_time;
+  GstClockTime max_measured_latency;
+};
+
+static GList *all_overrides = NULL;
+
+static void validate_perf_override_finalize (GObject * object);
+static void validate_perf_override_attached (GstValidateOverride * override);
+static void _runner_set (GObject * object, GParamSpec * pspec,
+    gpointer user_data);
+static void runner_stopping (GstValidateRunner * runner,
+    ValidatePerfOverride * perf);
+
+#define VALIDATE_TYPE_PERF_OVERRIDE validate_perf_override_get_type ()
+G_DEFINE_TYPE (ValidatePerfOverride, validate_perf_override,
+    GST_TYPE_VALIDATE_OVERRIDE);
+
+static void
+validate_perf_override_reset (ValidatePerfOverride * perf)
+{
+  g_mutex_lock (&perf->lock);
+  perf->n_buffers = 0;
+  perf->first_wall_time = perf->last_wall_time = 0;
+  perf->first_cpu_time = perf->last_cpu_time = 0;
+  perf->first_running_time = perf->last_running_time = GST_CLOCK_TIME_NONE;
+  perf->max_measured_latency = 0;
+  g_mutex_unlock (&perf->lock);
+}
+
+static void
+validate_perf_override_init (ValidatePerfOverride * self)
+{
+  g_mutex_init (&self->lock);
+  validate_perf_override_reset (self);
+}
+
+static void
+validate_perf_override_class_init (ValidatePerfOverrideClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstValidateOverrideClass *override_class =
+      GST_VALIDATE_OVERRIDE_CLASS (klass);
+
+  object_class->finalize = validate_perf_override_finalize;
+  override_class->attached = validate_perf_override_attached;
+
+  g_assert (gst_validate_is_initialized ());
+
+  gst_validate_issue_register (gst_validate_issue_new
+      (VALIDATE_PERF_BUDGET_EXCEEDED,
+          "A performance budget was exceeded.",
+          "The throughput, latency or CPU usage measured on the monitored pad"
+          " is outside of the budget set in the configuration.",
+          GST_VALIDATE_REPORT_LEVEL_CRITICAL));
+
+  gst_validate_issue_register (gst_validate_issue_new
+      (VALIDATE_PERF_NOT_ATTACHED,
+          "The pad to monitor was never attached.",
+          "The pad to monitor was never attached.",
+          GST_VALIDATE_REPORT_LEVEL_CRITICAL));
+}
+
+/* Returns how late @buffer is compared to when it should be rendered
+ * according to the clock of @element, 0 when it is early or when the element
+ * is not playing */
+static GstClockTime
+_get_buffer_latency (GstElement * element, GstClockTime running_time)
+{
+  GstClock *clock;
+  GstClockTime now, base_time, latency = 0;
+
+  if (GST_STATE (element) != GST_STATE_PLAYING)
+    return 0;
+
+  clock = gst_element_get_clock (element);
+  if (!clock)
+    return 0;
+
+  now = gst_clock_get_time (clock);
+  base_time = gst_element_get_base_time (element);
+  if (now > base_time + running_time)
+    latency = now - base_time - running_time;
+  gst_object_unref (clock);
+
+  return latency;
+}
+
+static void
+validate_perf_override_buffer_handler (GstValidateOverride * override,
+    GstValidateMonitor * monitor, GstBuffer * buffer)
+{
+  ValidatePerfOverride *perf = VALIDATE_PERF_OVERRIDE (override);
+  GstValidatePadMonitor *pad_monitor = GST_VALIDATE_PAD_MONITOR (monitor);
+  GstClockTime running_time = GST_CLOCK_TIME_NONE, end_time, latency = 0;
+  gint64 wall_time = g_get_monotonic_time ();
+  clock_t cpu_time = clock ();
+  GstElement *element;
+
+  if (pad_monitor->segment.format == GST_FORMAT_TIME &&
+      GST_BUFFER_PTS_IS_VALID (buffer)) {
+    running_time = gst_segment_to_running_time (&pad_monitor->segment,
+        GST_FORMAT_TIME, GST_BUFFER_PTS (buffer));
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID (running_time) &&
+      GST_CLOCK_TIME_IS_VALID (perf->max_latency)) {
+    element = gst_validate_monitor_get_element (monitor);
+    if (element) {
+      latency = _get_buffer_latency (element, running_time);
+      gst_object_unref (element);
+    }
+  }
+
+  g_mutex_lock (&perf->lock);
+  if (!perf->n_buffers) {
+    perf->first_wall_time = wall_time;
+    perf->first_cpu_time = cpu_time;
+  }
+  perf->n_buffers++;
+  perf->last_wall_time = wall_time;
+  perf->last_cpu_time = cpu_time;
+
+  if (GST_CLOCK_TIME_IS_VALID (running_time)) {
+    end_time = running_time;
+    if (GST_BUFFER_DURATION_IS_VALID (buffer))
+      end_time += GST_BUFFER_DURATION (buffer);
+
+    if (!GST_CLOCK_TIME_IS_VALID (perf->first_running_time) ||
+        running_time < perf->first_running_time)
+      perf->first_running_time = running_time;
+    if (!GST_CLOCK_TIME_IS_VALID (perf->last_running_time) ||
+        end_time > perf->last_running_time)
+      perf->last_running_time = end_time;
+  }
+  perf->max_measured_latency = MAX (perf->max_measured_latency, latency);
+  g_mutex_unlock (&perf->lock);
+}
+
+static gchar *
+make_safe_file_name (const gchar * name)
+{
+  gchar *ret = g_strdup (name);
+  gchar *c;
+  for (c = ret; *c; c++) {
+    switch (*c) {
+      case '<':
+      case '>':
+      case ':':
+      case '"':
+      case '/':
+      case '\\':
+      case '|':
+      case '?':
+      case '*':
+        *c = '-';
+        break;
+    }
+  }
+  return ret;
+}
+
+static ValidatePerfOverride *
+validate_perf_override_new (GstStructure * config)
+{
+  ValidatePerfOverride *perf;
+  GstValidateOverride *override;
+  const gchar *report_dir;
+
+  perf = g_object_new (VALIDATE_TYPE_PERF_OVERRIDE, NULL);
+  perf->config = config;
+
+  GST_OBJECT_FLAG_SET (perf, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  override = GST_VALIDATE_OVERRIDE (perf);
+
+  /* pad: Name of the pad where the flowing buffers will be measured. */
+  perf->pad_name = gst_structure_get_string (config, "pad");
+  if (!perf->pad_name) {
+    gst_validate_error_structure (config,
+        "pad property is mandatory, not found in %" GST_PTR_FORMAT, config);
+  }
+
+  /* min-fps: Minimum number of buffers per second going through the pad. */
+  gst_structure_get_double (config, "min-fps", &perf->min_fps);
+
+  /* min-realtime-factor: Minimum ratio between the stream duration and the
+   * time it took to process it, 1.0 meaning realtime. */
+  gst_structure_get_double (config, "min-realtime-factor",
+      &perf->min_realtime_factor);
+
+  /* max-latency: Maximum time a buffer can arrive after its running time
+   * according to the pipeline clock. */
+  gst_validate_utils_get_clocktime (config, "max-latency", &perf->max_latency);
+
+  /* max-cpu-usage: Maximum CPU time used by the process per second of
+   * processing, 1.0 meaning one core fully used. */
+  gst_structure_get_double (config, "max-cpu-usage", &perf->max_cpu_usage);
+
+  /* report-dir: Path to the directory where the JSON report of the
+   * measurements will be written, nothing is written when not set. */
+  report_dir = gst_structure_get_string (config, "report-dir");
+  if (report_dir) {
+    gchar *pad_name_safe = make_safe_file_name (perf->pad_name);
+    gchar *report_file_name = g_strdup_printf ("perf-%s.json", pad_name_safe);
+
+    perf->report_file_path = g_build_path (G_DIR_SEPARATOR_S, report_dir,
+        report_file_name, NULL);
+    g_free (report_file_name);
+    g_free (pad_name_safe);
+  }
+
+  gst_validate_override_register_by_name (perf->pad_name, override);
+
+  override->buffer_handler = validate_perf_override_buffer_handler;
+  override->buffer_probe_handler = validate_perf_override_buffer_handler;
+
+  g_signal_connect (perf, "notify::validate-runner",
+      G_CALLBACK (_runner_set), NULL);
+
+  return perf;
+}
+
+static void
+_runner_set (GObject * object, GParamSpec * pspec, gpointer user_data)
+{
+  ValidatePerfOverride *perf = VALIDATE_PERF_OVERRIDE (object);
+  GstValidateRunner *runner =
+      gst_validate_reporter_get_runner (GST_VALIDATE_REPORTER (perf));
+
+  g_signal_connect (runner, "stopping", G_CALLBACK (runner_stopping), perf);
+  gst_object_unref (runner);
+}
+
+static void
+validate_perf_override_attached (GstValidateOverride * override)
+{
+  ValidatePerfOverride *perf = VALIDATE_PERF_OVERRIDE (override);
+  perf->was_attached = TRUE;
+}
+
+static void
+write_report (ValidatePerfOverride * perf, gdouble elapsed, gdouble fps,
+    gdouble realtime_factor, gdouble cpu_usage, gboolean passed)
+{
+  JsonBuilder *jbuilder = json_builder_new ();
+  JsonGenerator *jgen;
+  GError *error = NULL;
+  gchar *directory_path;
+
+  json_builder_begin_object (jbuilder);
+  json_builder_set_member_name (jbuilder, "pad");
+  json_builder_add_string_value (jbuilder, perf->pad_name);
+  json_builder_set_member_name (jbuilder, "buffers");
+  json_builder_add_int_value (jbuilder, perf->n_buffers);
+  json_builder_set_member_name (jbuilder, "elapsed");
+  json_builder_add_double_value (jbuilder, elapsed);
+  json_builder_set_member_name (jbuilder, "fps");
+  json_builder_add_double_value (jbuilder, fps);
+  json_builder_set_member_name (jbuilder, "realtime-factor");
+  json_builder_add_double_value (jbuilder, realtime_factor);
+  json_builder_set_member_name (jbuilder, "max-latency");
+  json_builder_add_int_value (jbuilder, perf->max_measured_latency);
+  json_builder_set_member_name (jbuilder, "cpu-usage");
+  json_builder_add_double_value (jbuilder, cpu_usage);
+  json_builder_set_member_name (jbuilder, "passed");
+  json_builder_add_boolean_value (jbuilder, passed);
+  json_builder_end_object (jbuilder);
+
+  directory_path = g_path_get_dirname (perf->report_file_path);
+  if (g_mkdir_with_parents (directory_path, 0755) < 0) {
+    gst_validate_abort ("Could not create directory tree: %s Reason: %s",
+        directory_path, g_strerror (errno));
+  }
+  g_free (directory_path);
+
+  jgen = json_generator_new ();
+  json_generator_set_pretty (jgen, TRUE);
+  json_generator_set_root (jgen, json_builder_get_root (jbuilder));
+  if (!json_generator_to_file (jgen, perf->report_file_path, &error)) {
+    GST_ERROR_OBJECT (perf, "Could not write %s: %s", perf->report_file_path,
+        error->message);
+    g_clear_error (&error);
+  } else {
+    gst_validate_printf (NULL, "**-> Wrote performance report: '%s'**\n",
+        perf->report_file_path);
+  }
+
+  g_object_unref (jgen);
+  g_object_unref (jbuilder);
+}
+
+static void
+runner_stopping (GstValidateRunner * runner, ValidatePerfOverride * perf)
+{
+  gdouble elapsed, fps = 0.0, realtime_factor = 0.0, cpu_usage = 0.0;
+  gboolean passed = TRUE;
+
+  if (!perf->was_attached) {
+    GST_VALIDATE_REPORT (perf, VALIDATE_PERF_NOT_ATTACHED,
+        "The test ended without the pad ever being attached: %s",
+        perf->pad_name);
+    return;
+  }
+
+  g_mutex_lock (&perf->lock);
+  elapsed = (perf->last_wall_time - perf->first_wall_time) /
+      (gdouble) G_USEC_PER_SEC;
+  if (elapsed > 0.0) {
+    /* the first buffer starts the measurement */
+    fps = (perf->n_buffers - 1) / elapsed;
+    if (GST_CLOCK_TIME_IS_VALID (perf->first_running_time))
+      realtime_factor = (perf->last_running_time - perf->first_running_time)
+          / (gdouble) GST_SECOND / elapsed;
+    cpu_usage = (perf->last_cpu_time - perf->first_cpu_time) /
+        (gdouble) CLOCKS_PER_SEC / elapsed;
+  }
+
+  gst_validate_printf (perf, "%s: %" G_GUINT64_FORMAT " buffers in %.3fs, "
+      "%.2f fps, realtime factor %.2f, max latency %" GST_TIME_FORMAT
+      ", cpu usage %.2f\n", perf->pad_name, perf->n_buffers, elapsed, fps,
+      realtime_factor, GST_TIME_ARGS (perf->max_measured_latency), cpu_usage);
+
+  if (perf->min_fps > 0.0 && fps < perf->min_fps) {
+    GST_VALIDATE_REPORT (perf, VALIDATE_PERF_BUDGET_EXCEEDED,
+        "%s: %.2f fps, expected at least %.2f", perf->pad_name, fps,
+        perf->min_fps);
+    passed = FALSE;
+  }
+  if (perf->min_realtime_factor > 0.0 &&
+      realtime_factor < perf->min_realtime_factor) {
+    GST_VALIDATE_REPORT (perf, VALIDATE_PERF_BUDGET_EXCEEDED,
+        "%s: realtime factor %.2f, expected at least %.2f", perf->pad_name,
+        realtime_factor, perf->min_realtime_factor);
+    passed = FALSE;
+  }
+  if (GST_CLOCK_TIME_IS_VALID (perf->max_latency) &&
+      perf->max_measured_latency > perf->max_latency) {
+    GST_VALIDATE_REPORT (perf, VALIDATE_PERF_BUDGET_EXCEEDED,
+        "%s: latency %" GST_TIME_FORMAT ", expected at most %" GST_TIME_FORMAT,
+        perf->pad_name, GST_TIME_ARGS (perf->max_measured_latency),
+        GST_TIME_ARGS (perf->max_latency));
+    passed = FALSE;
+  }
+  if (perf->max_cpu_usage > 0.0 && cpu_usage > perf->max_cpu_usage) {
+    GST_VALIDATE_REPORT (perf, VALIDATE_PERF_BUDGET_EXCEEDED,
+        "%s: cpu usage %.2f, expected at most %.2f", perf->pad_name,
+        cpu_usage, perf->max_cpu_usage);
+    passed = FALSE;
+  }
+
+  if (perf->report_file_path)
+    write_report (perf, elapsed, fps, realtime_factor, cpu_usage, passed);
+  g_mutex_unlock (&perf->lock);
+}
+
+static void
+validate_perf_override_finalize (GObject * object)
+{
+  ValidatePerfOverride *perf = VALIDATE_PERF_OVERRIDE (object);
+
+  all_overrides = g_list_remove (all_overrides, perf);
+  g_free (perf->report_file_path);
+  g_mutex_clear (&perf->lock);
+
+  G_OBJECT_CLASS (validate_perf_override_parent_class)->finalize (object);
+}
+
+static gboolean
+_execute_reset_perf (GstValidateScenario * scenario,
+    GstValidateAction * action)
+{
+  GList *i;
+
+  for (i = all_overrides; i; i = i->next)
+    validate_perf_override_reset (i->data);
+
+  return TRUE;
+}
+
+gboolean
+gst_validate_perf_init ()
+{
+  GList *tmp;
+  GList *config_list = gst_validate_get_config ("validateperf");
+
+  if (!config_list)
+    return TRUE;
+
+  for (tmp = config_list; tmp; tmp = tmp->next) {
+    ValidatePerfOverride *perf = validate_perf_override_new (tmp->data);
+
+    all_overrides = g_list_append (all_overrides, perf);
+  }
+  g_list_free (config_list);
+
+/*  *INDENT-OFF* */
+  gst_validate_register_action_type ("reset-perf", "validateperf",
+      _execute_reset_perf, NULL,
+      "Restarts the performance measurements of all the `validateperf` "
+      "monitors, so that for example the preroll or a seek is not "
+      "taken into account.",
+      GST_VALIDATE_ACTION_TYPE_NONE);
+/*  *INDENT-ON* */
+
+  return TRUE;
+}
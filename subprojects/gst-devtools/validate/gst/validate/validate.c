@@ -491,6 +491,7 @@ gst_validate_init (void)
 
   gst_validate_extra_checks_init ();
   gst_validate_flow_init ();
+  gst_validate_perf_init ();
   gst_validate_init_plugins ();
   gst_validate_init_runner ();
 }
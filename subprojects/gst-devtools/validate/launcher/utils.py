@@ -661,6 +661,7 @@ def format_config_template(extra_data, config_text, test_name):
                                           test_name.replace('.', os.sep))
         extra_vars['validateflow'] = "validateflow, expectations-dir=\"%s\", actual-results-dir=\"%s\"" % (
             expectations_dir, actual_results_dir)
+        extra_vars['validateperf'] = "validateperf, report-dir=\"%s\"" % actual_results_dir
 
     if 'ssim-results-dir' in extra_vars:
         ssim_results = extra_vars['ssim-results-dir']
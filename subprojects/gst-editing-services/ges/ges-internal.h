@@ -496,6 +496,7 @@ G_GNUC_INTERNAL gboolean
 ges_source_get_rendering_smartly                      (GESSource *source);
 
 G_GNUC_INTERNAL void ges_track_set_smart_rendering     (GESTrack* track, gboolean rendering_smartly);
+G_GNUC_INTERNAL gboolean ges_track_get_smart_rendering     (GESTrack* track);
 G_GNUC_INTERNAL GstElement * ges_track_get_composition (GESTrack *track);
 
 
@@ -87,6 +87,8 @@ struct _GESPipelinePrivate
 
   GstEncodingProfile *profile;
 
+  gboolean preview_proxies;
+
   GThread *valid_thread;
 };
 
@@ -99,6 +101,7 @@ enum
   PROP_MODE,
   PROP_AUDIO_FILTER,
   PROP_VIDEO_FILTER,
+  PROP_PREVIEW_PROXIES,
   PROP_LAST
 };
 
@@ -197,6 +200,9 @@ ges_pipeline_get_property (GObject * object, guint property_id,
       g_object_get_property (G_OBJECT (self->priv->playsink), "video-filter",
           value);
       break;
+    case PROP_PREVIEW_PROXIES:
+      g_value_set_boolean (value, self->priv->preview_proxies);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -232,6 +238,9 @@ ges_pipeline_set_property (GObject * object, guint property_id,
       g_object_set (self->priv->playsink, "video-filter",
           GST_ELEMENT (g_value_get_object (value)), NULL);
       break;
+    case PROP_PREVIEW_PROXIES:
+      ges_pipeline_set_preview_proxies (self, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -379,6 +388,28 @@ ges_pipeline_class_init (GESPipelineClass * klass)
       "the Video filter(s) to apply, if possible", GST_TYPE_ELEMENT,
       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GESPipeline:preview-proxies:
+   *
+   * Whether #GESUriClip-s should play their assets' proxy (see
+   * ges_asset_set_proxy()) in preview mode, and their original asset in
+   * rendering mode.
+   *
+   * When set, the clips of the timeline are switched to the default proxy
+   * of their original asset, if any, whenever the pipeline goes to preview
+   * mode, and back to the original asset when going to
+   * #GES_PIPELINE_MODE_RENDER or #GES_PIPELINE_MODE_SMART_RENDER. This
+   * allows smooth previewing of high resolution sources through lower
+   * resolution proxies (see ges_uri_clip_asset_generate_proxy_async())
+   * while still rendering from the original media.
+   *
+   * Since: 1.22
+   */
+  properties[PROP_PREVIEW_PROXIES] =
+      g_param_spec_boolean ("preview-proxies", "Preview proxies",
+      "Use proxies in preview mode and originals for rendering", FALSE,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (object_class, PROP_LAST, properties);
 
   element_class->change_state = GST_DEBUG_FUNCPTR (ges_pipeline_change_state);
@@ -1165,6 +1196,100 @@ ges_pipeline_get_mode (GESPipeline * pipeline)
   return pipeline->priv->mode;
 }
 
+static GESAsset *
+_get_original_asset (GESAsset * asset)
+{
+  GESAsset *target;
+
+  while ((target = ges_asset_get_proxy_target (asset)))
+    asset = target;
+
+  return asset;
+}
+
+static GESAsset *
+_get_preview_asset (GESAsset * asset)
+{
+  GESAsset *proxy;
+
+  asset = _get_original_asset (asset);
+  while ((proxy = ges_asset_get_proxy (asset)))
+    asset = proxy;
+
+  return asset;
+}
+
+/* Makes the uri clips of the timeline use either the proxy or the original
+ * of their asset */
+static void
+_update_clip_assets (GESPipeline * self, gboolean use_proxies)
+{
+  GList *layers, *l, *clips, *c;
+  gboolean changed = FALSE;
+
+  if (!self->priv->timeline)
+    return;
+
+  layers = ges_timeline_get_layers (self->priv->timeline);
+  for (l = layers; l; l = l->next) {
+    clips = ges_layer_get_clips (l->data);
+    for (c = clips; c; c = c->next) {
+      GESTimelineElement *clip = c->data;
+      GESAsset *asset, *wanted;
+
+      if (!GES_IS_URI_CLIP (clip))
+        continue;
+
+      asset = ges_extractable_get_asset (GES_EXTRACTABLE (clip));
+      wanted = use_proxies ? _get_preview_asset (asset) :
+          _get_original_asset (asset);
+      if (wanted == asset || !GES_IS_URI_CLIP_ASSET (wanted))
+        continue;
+
+      GST_INFO_OBJECT (self, "Switching %" GES_FORMAT " to %s", GES_ARGS (clip),
+          ges_asset_get_id (wanted));
+      if (ges_extractable_set_asset (GES_EXTRACTABLE (clip), wanted))
+        changed = TRUE;
+      else
+        GST_WARNING_OBJECT (self, "Could not switch %" GES_FORMAT " to %s",
+            GES_ARGS (clip), ges_asset_get_id (wanted));
+    }
+    g_list_free_full (clips, gst_object_unref);
+  }
+  g_list_free_full (layers, gst_object_unref);
+
+  if (changed)
+    ges_timeline_commit (self->priv->timeline);
+}
+
+/**
+ * ges_pipeline_set_preview_proxies:
+ * @pipeline: A #GESPipeline
+ * @preview_proxies: Whether to preview through proxies
+ *
+ * Sets #GESPipeline:preview-proxies and switches the clips of the timeline
+ * to the assets matching the current mode.
+ *
+ * Since: 1.22
+ */
+void
+ges_pipeline_set_preview_proxies (GESPipeline * pipeline,
+    gboolean preview_proxies)
+{
+  g_return_if_fail (GES_IS_PIPELINE (pipeline));
+  CHECK_THREAD (pipeline);
+
+  if (pipeline->priv->preview_proxies == preview_proxies)
+    return;
+
+  pipeline->priv->preview_proxies = preview_proxies;
+  _update_clip_assets (pipeline, preview_proxies
+      && !IN_RENDERING_MODE (pipeline));
+
+  g_object_notify_by_pspec (G_OBJECT (pipeline),
+      properties[PROP_PREVIEW_PROXIES]);
+}
+
 /**
  * ges_pipeline_set_mode:
  * @pipeline: A #GESPipeline
@@ -1235,6 +1360,11 @@ ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
         pipeline->priv->encodebin, pipeline->priv->urisink, NULL);
   }
 
+  /* Must happen while the commit isn't frozen by the render mode */
+  if (pipeline->priv->preview_proxies)
+    _update_clip_assets (pipeline, !(mode & (GES_PIPELINE_MODE_RENDER |
+                GES_PIPELINE_MODE_SMART_RENDER)));
+
   /* Add new elements */
   if (!(pipeline->priv->mode & GES_PIPELINE_MODE_PREVIEW) &&
       (mode & GES_PIPELINE_MODE_PREVIEW)) {
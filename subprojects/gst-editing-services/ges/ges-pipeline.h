@@ -76,6 +76,10 @@ gboolean ges_pipeline_set_mode (GESPipeline *pipeline,
 GES_API
 GESPipelineFlags ges_pipeline_get_mode (GESPipeline *pipeline);
 
+GES_API
+void ges_pipeline_set_preview_proxies (GESPipeline *pipeline,
+                                       gboolean preview_proxies);
+
 GES_API GstSample *
 ges_pipeline_get_thumbnail(GESPipeline *self, GstCaps *caps);
 
@@ -192,8 +192,9 @@ ges_source_set_rendering_smartly (GESSource * source,
   if (is_rendering_smartly) {
     GESTrack *track = ges_track_element_get_track (GES_TRACK_ELEMENT (source));
 
-    if (track && ges_track_get_mixing (track)) {
-      GST_DEBUG_OBJECT (source, "Not rendering smartly as track is mixing!");
+    if (track && !ges_track_get_smart_rendering (track)) {
+      GST_DEBUG_OBJECT (source, "Not rendering smartly as track content "
+          "needs to be decoded");
 
       source->priv->is_rendering_smartly = FALSE;
       return;
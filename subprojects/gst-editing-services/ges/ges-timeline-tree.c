@@ -202,10 +202,251 @@ timeline_tree_debug (GNode * root)
       (GNodeTraverseFunc) print_node, NULL);
 }
 
+/****************************************************
+ *                     Index                        *
+ ****************************************************/
+
+/* Sources of a track sorted by start, so that we only visit the sources
+ * around a position when looking for overlaps or snapping edges */
+typedef struct
+{
+  GSequence *sources;
+  /* Upper bound of the duration of the sources, never shrinks */
+  GstClockTime max_duration;
+} TrackIndex;
+
+typedef struct
+{
+  /* GESTimelineElement -> GNode */
+  GHashTable *nodes;
+  /* GESTrack (or NULL) -> TrackIndex */
+  GHashTable *tracks;
+  /* GESSource -> GSequenceIter */
+  GHashTable *iters;
+  /* Sources whose start, duration or track changed since the index was
+   * last used */
+  GHashTable *changed;
+  /* Sources with marker lists, whose markers can be snapped to whatever
+   * their position */
+  GHashTable *with_markers;
+} TreeIndex;
+
+static GQuark
+tree_index_quark (void)
+{
+  return g_quark_from_static_string ("ges-timeline-tree-index");
+}
+
+static void
+track_index_free (TrackIndex * tindex)
+{
+  g_sequence_free (tindex->sources);
+  g_free (tindex);
+}
+
+static void
+tree_index_free (TreeIndex * index)
+{
+  g_hash_table_unref (index->nodes);
+  g_hash_table_unref (index->iters);
+  g_hash_table_unref (index->tracks);
+  g_hash_table_unref (index->changed);
+  g_hash_table_unref (index->with_markers);
+  g_free (index);
+}
+
+/* The index is owned by the timeline, which is the data of the root */
+static TreeIndex *
+get_index (GNode * root)
+{
+  TreeIndex *index = g_object_get_qdata (root->data, tree_index_quark ());
+
+  if (!index) {
+    index = g_new0 (TreeIndex, 1);
+    index->nodes = g_hash_table_new (NULL, NULL);
+    index->tracks = g_hash_table_new_full (NULL, NULL, NULL,
+        (GDestroyNotify) track_index_free);
+    index->iters = g_hash_table_new (NULL, NULL);
+    index->changed = g_hash_table_new (NULL, NULL);
+    index->with_markers = g_hash_table_new (NULL, NULL);
+    g_object_set_qdata_full (root->data, tree_index_quark (), index,
+        (GDestroyNotify) tree_index_free);
+  }
+
+  return index;
+}
+
 static GNode *
 find_node (GNode * root, gpointer element)
 {
-  return g_node_find (root, G_IN_ORDER, G_TRAVERSE_ALL, element);
+  return g_hash_table_lookup (get_index (root)->nodes, element);
+}
+
+/* NULL stands for the position passed as @position */
+static gint
+compare_start (gconstpointer a, gconstpointer b, gpointer position)
+{
+  GstClockTime a_start = a ? _START (a) : *(GstClockTime *) position;
+  GstClockTime b_start = b ? _START (b) : *(GstClockTime *) position;
+
+  if (a_start < b_start)
+    return -1;
+  if (a_start > b_start)
+    return 1;
+
+  return 0;
+}
+
+static void
+index_insert_source (TreeIndex * index, GESTimelineElement * source)
+{
+  GESTrack *track = ges_track_element_get_track (GES_TRACK_ELEMENT (source));
+  TrackIndex *tindex = g_hash_table_lookup (index->tracks, track);
+
+  if (!tindex) {
+    tindex = g_new0 (TrackIndex, 1);
+    tindex->sources = g_sequence_new (NULL);
+    g_hash_table_insert (index->tracks, track, tindex);
+  }
+
+  tindex->max_duration = MAX (tindex->max_duration, source->duration);
+  g_hash_table_insert (index->iters, source,
+      g_sequence_insert_sorted (tindex->sources, source, compare_start, NULL));
+}
+
+static void
+index_remove_source (TreeIndex * index, GESTimelineElement * source)
+{
+  GSequenceIter *iter = g_hash_table_lookup (index->iters, source);
+
+  if (iter) {
+    g_sequence_remove (iter);
+    g_hash_table_remove (index->iters, source);
+  }
+}
+
+/* Re-insert the sources that changed, the others are still sorted so this
+ * only costs O(log n) per changed source */
+static TreeIndex *
+get_updated_index (GNode * root)
+{
+  GHashTableIter iter;
+  GESTimelineElement *source;
+  TreeIndex *index = get_index (root);
+
+  if (!g_hash_table_size (index->changed))
+    return index;
+
+  g_hash_table_iter_init (&iter, index->changed);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & source, NULL))
+    index_remove_source (index, source);
+
+  g_hash_table_iter_init (&iter, index->changed);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & source, NULL))
+    index_insert_source (index, source);
+
+  g_hash_table_remove_all (index->changed);
+
+  return index;
+}
+
+static void
+track_index_foreach_source (TrackIndex * tindex, GstClockTime low,
+    GstClockTime high, GFunc func, gpointer user_data)
+{
+  GSequenceIter *it;
+  /* The start of a source ending after @low is at least this */
+  GstClockTime first_start =
+      low > tindex->max_duration ? low - tindex->max_duration : 0;
+
+  it = g_sequence_search (tindex->sources, NULL, compare_start, &first_start);
+  while (!g_sequence_iter_is_begin (it)
+      && _START (g_sequence_get (g_sequence_iter_prev (it))) >= first_start)
+    it = g_sequence_iter_prev (it);
+
+  for (; !g_sequence_iter_is_end (it); it = g_sequence_iter_next (it)) {
+    GESTimelineElement *source = g_sequence_get (it);
+
+    if (_START (source) > high)
+      break;
+
+    func (source, user_data);
+  }
+}
+
+/* Calls @func on all the sources of @track (or of any track if @track is
+ * NULL) whose edges might be within [@low, @high] */
+static void
+index_foreach_source (TreeIndex * index, GESTrack * track,
+    GstClockTime low, GstClockTime high, GFunc func, gpointer user_data)
+{
+  GHashTableIter iter;
+  TrackIndex *tindex;
+
+  if (track) {
+    tindex = g_hash_table_lookup (index->tracks, track);
+    if (tindex)
+      track_index_foreach_source (tindex, low, high, func, user_data);
+
+    return;
+  }
+
+  g_hash_table_iter_init (&iter, index->tracks);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & tindex))
+    track_index_foreach_source (tindex, low, high, func, user_data);
+}
+
+static void
+source_changed_cb (GESTimelineElement * source, GParamSpec * arg
+    G_GNUC_UNUSED, GNode * root)
+{
+  g_hash_table_add (get_index (root)->changed, source);
+}
+
+static void
+source_notify_meta_cb (GESTimelineElement * source, const gchar * key,
+    const GValue * value, GNode * root)
+{
+  if (G_VALUE_HOLDS_OBJECT (value)
+      && GES_IS_MARKER_LIST (g_value_get_object (value)))
+    g_hash_table_add (get_index (root)->with_markers, source);
+}
+
+static void
+check_source_markers (const GESMetaContainer * container, const gchar * key,
+    const GValue * value, GNode * root)
+{
+  source_notify_meta_cb (GES_TIMELINE_ELEMENT (container), key, value, root);
+}
+
+static void
+track_source (GNode * root, GESTimelineElement * source)
+{
+  index_insert_source (get_index (root), source);
+
+  g_signal_connect (source, "notify::start",
+      G_CALLBACK (source_changed_cb), root);
+  g_signal_connect (source, "notify::duration",
+      G_CALLBACK (source_changed_cb), root);
+  g_signal_connect (source, "notify::track",
+      G_CALLBACK (source_changed_cb), root);
+  g_signal_connect (source, "notify-meta",
+      G_CALLBACK (source_notify_meta_cb), root);
+  ges_meta_container_foreach (GES_META_CONTAINER (source),
+      (GESMetaForeachFunc) check_source_markers, root);
+}
+
+static void
+stop_tracking_source (GNode * root, GESTimelineElement * source)
+{
+  TreeIndex *index = get_index (root);
+
+  g_signal_handlers_disconnect_by_func (source, source_changed_cb, root);
+  g_signal_handlers_disconnect_by_func (source, source_notify_meta_cb, root);
+
+  index_remove_source (index, source);
+  g_hash_table_remove (index->changed, source);
+  g_hash_table_remove (index->with_markers, source);
 }
 
 static void
@@ -235,6 +476,9 @@ timeline_tree_track_element (GNode * root, GESTimelineElement * element)
     return;
   }
 
+  if (GES_IS_SOURCE (element))
+    track_source (root, element);
+
   g_signal_connect (element, "notify::parent",
       G_CALLBACK (timeline_element_parent_cb), root);
 
@@ -250,6 +494,7 @@ timeline_tree_track_element (GNode * root, GESTimelineElement * element)
     g_assert (parent);
     node = g_node_prepend_data (parent, element);
   }
+  g_hash_table_insert (get_index (root)->nodes, element, node);
 
   if (GES_IS_CONTAINER (element)) {
     GList *tmp;
@@ -287,6 +532,9 @@ timeline_tree_stop_tracking_element (GNode * root, GESTimelineElement * element)
   GST_DEBUG ("Stop tracking %" GES_FORMAT, GES_ARGS (element));
   g_signal_handlers_disconnect_by_func (element, timeline_element_parent_cb,
       root);
+  if (GES_IS_SOURCE (element))
+    stop_tracking_source (root, element);
+  g_hash_table_remove (get_index (root)->nodes, element);
 
   g_node_destroy (node);
   timeline_update_duration (root->data);
@@ -503,21 +751,18 @@ find_marker_snap (const GESMetaContainer * container, const gchar * key,
   g_object_unref (marker);
 }
 
-static gboolean
-find_snap (GNode * node, TreeIterationData * data)
+static void
+find_snap (GESTimelineElement * element, TreeIterationData * data)
 {
-  GESTimelineElement *element = node->data;
   GESTrackElement *track_el, *moving;
 
-  /* Only snap to sources */
+  /* Only snap to sources, which are the only indexed elements */
   /* Maybe we should allow snapping to anything that isn't an
    * auto-transition? */
-  if (!GES_IS_SOURCE (element))
-    return FALSE;
 
   /* don't snap to anything we are moving */
   if (g_hash_table_contains (data->moving, element))
-    return FALSE;
+    return;
 
   track_el = GES_TRACK_ELEMENT (element);
   moving = GES_TRACK_ELEMENT (data->element);
@@ -528,19 +773,39 @@ find_snap (GNode * node, TreeIterationData * data)
 
   ges_meta_container_foreach (GES_META_CONTAINER (element),
       (GESMetaForeachFunc) find_marker_snap, data);
-
-  return FALSE;
 }
 
 static void
 find_snap_for_element (GESTrackElement * element, GstClockTime position,
     gboolean negative, TreeIterationData * data)
 {
+  GHashTableIter iter;
+  GESTimelineElement *marked;
+  GstClockTime distance = data->snap->distance;
+  GstClockTime low = 0, high = GST_CLOCK_TIME_NONE;
+  TreeIndex *index = get_updated_index (data->root);
+
   data->element = GES_TIMELINE_ELEMENT (element);
   data->position = position;
   data->negative = negative;
-  g_node_traverse (data->root, G_IN_ORDER, G_TRAVERSE_LEAVES, -1,
-      (GNodeTraverseFunc) find_snap, data);
+
+  /* Only the edges within the snapping distance matter */
+  if (GST_CLOCK_TIME_IS_VALID (distance)) {
+    if (negative) {
+      high = distance;
+    } else {
+      low = position > distance ? position - distance : 0;
+      high = position < G_MAXUINT64 - distance ?
+          position + distance : GST_CLOCK_TIME_NONE;
+    }
+  }
+
+  index_foreach_source (index, NULL, low, high, (GFunc) find_snap, data);
+
+  /* markers can be anywhere */
+  g_hash_table_iter_init (&iter, index->with_markers);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & marked, NULL))
+    find_snap (marked, data);
 }
 
 /* find up to one source at the edge */
@@ -747,20 +1012,24 @@ set_triple_overlap_error (GError ** error, GESTimelineElement * first,
   GST_TIME_ARGS (cmp_start), GST_TIME_ARGS (cmp_end), cmp_layer_prio, \
   cmp_track
 
-static gboolean
-check_overlap_with_element (GNode * node, TreeIterationData * data)
+static void
+check_overlap_with_element (GESTimelineElement * e, TreeIterationData * data)
 {
-  GESTimelineElement *e = node->data, *cmp = data->element;
+  GESTimelineElement *cmp = data->element;
   GstClockTime start, end, cmp_start, cmp_end;
   guint32 layer_prio, cmp_layer_prio;
   GESTrack *track, *cmp_track;
   PositionData *pos_data;
 
+  /* already failed */
+  if (!data->res)
+    return;
+
   if (e == cmp)
-    return FALSE;
+    return;
 
   if (!GES_IS_SOURCE (e) || !GES_IS_SOURCE (cmp))
-    return FALSE;
+    return;
 
   /* get position of compared element */
   pos_data = data->pos_data;
@@ -798,20 +1067,20 @@ check_overlap_with_element (GNode * node, TreeIterationData * data)
   if (track != cmp_track || track == NULL || cmp_track == NULL) {
     GST_LOG (_ELEMENT_FORMAT " and " _ELEMENT_FORMAT " are not in the "
         "same track", _CMP_ARGS, _E_ARGS);
-    return FALSE;
+    return;
   }
 
   if (layer_prio != cmp_layer_prio) {
     GST_LOG (_ELEMENT_FORMAT " and " _ELEMENT_FORMAT " are not in the "
         "same layer", _CMP_ARGS, _E_ARGS);
-    return FALSE;
+    return;
   }
 
   if (start >= cmp_end || cmp_start >= end) {
     /* They do not overlap at all */
     GST_LOG (_ELEMENT_FORMAT " and " _ELEMENT_FORMAT " do not overlap",
         _CMP_ARGS, _E_ARGS);
-    return FALSE;
+    return;
   }
 
   if (cmp_start <= start && cmp_end >= end) {
@@ -883,11 +1152,19 @@ check_overlap_with_element (GNode * node, TreeIterationData * data)
     data->overlaping_on_end = e;
   }
 
-  return FALSE;
+  return;
 
 error:
   data->res = FALSE;
-  return TRUE;
+}
+
+static void
+check_overlap_with_unmoved_element (GESTimelineElement * e,
+    TreeIterationData * data)
+{
+  /* moving elements are checked at their new position */
+  if (!data->moving || !g_hash_table_contains (data->moving, e))
+    check_overlap_with_element (e, data);
 }
 
 /* check and find the overlaps with the element at node */
@@ -895,6 +1172,9 @@ static gboolean
 check_all_overlaps_with_element (GNode * node, TreeIterationData * data)
 {
   GESTimelineElement *element = node->data;
+  GstClockTime start, end;
+  GESTrack *track;
+
   if (GES_IS_SOURCE (element)) {
     data->element = element;
     data->overlaping_on_start = NULL;
@@ -906,8 +1186,31 @@ check_all_overlaps_with_element (GNode * node, TreeIterationData * data)
     else
       data->pos_data = NULL;
 
-    g_node_traverse (data->root, G_IN_ORDER, G_TRAVERSE_LEAVES, -1,
-        (GNodeTraverseFunc) check_overlap_with_element, data);
+    /* Only sources in the same track can overlap: look them up around the
+     * element, and check the moving ones at their new position */
+    track = ges_track_element_get_track (GES_TRACK_ELEMENT (element));
+    if (!track)
+      return FALSE;
+
+    if (data->pos_data) {
+      start = data->pos_data->start;
+      end = data->pos_data->end;
+    } else {
+      start = _START (element);
+      end = _END (element);
+    }
+
+    index_foreach_source (get_updated_index (data->root), track, start, end,
+        (GFunc) check_overlap_with_unmoved_element, data);
+
+    if (data->moving) {
+      GHashTableIter iter;
+      GESTimelineElement *moving;
+
+      g_hash_table_iter_init (&iter, data->moving);
+      while (g_hash_table_iter_next (&iter, (gpointer *) & moving, NULL))
+        check_overlap_with_element (moving, data);
+    }
 
     return !data->res;
   }
@@ -2573,3 +2876,42 @@ timeline_tree_set_smart_rendering (GNode * root, gboolean rendering_smartly)
   g_node_traverse (root, G_PRE_ORDER, G_TRAVERSE_LEAFS, -1,
       (GNodeTraverseFunc) set_is_smart_rendering, &rendering_smartly);
 }
+
+static gboolean
+collect_track_elements (GNode * node, GList ** elements)
+{
+  if (GES_IS_TRACK_ELEMENT (node->data)
+      && ges_track_element_is_active (node->data))
+    *elements = g_list_prepend (*elements, node->data);
+
+  return FALSE;
+}
+
+/* Returns the sorted positions at which no track element is in progress,
+ * meaning that what comes before and after them can be rendered
+ * independently. */
+GArray *
+timeline_tree_get_independent_positions (GNode * root)
+{
+  GList *tmp, *elements = NULL;
+  GstClockTime end = 0;
+  GArray *positions = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+
+  g_node_traverse (root, G_PRE_ORDER, G_TRAVERSE_LEAFS, -1,
+      (GNodeTraverseFunc) collect_track_elements, &elements);
+  elements = g_list_sort_with_data (elements, compare_start, NULL);
+
+  for (tmp = elements; tmp; tmp = tmp->next) {
+    GstClockTime start = _START (tmp->data);
+
+    if (start >= end && (!positions->len
+            || g_array_index (positions, GstClockTime,
+                positions->len - 1) != start))
+      g_array_append_val (positions, start);
+
+    end = MAX (end, _END (tmp->data));
+  }
+  g_list_free (elements);
+
+  return positions;
+}
@@ -83,5 +83,6 @@ timeline_update_duration                  (GESTimeline * timeline);
 
 void timeline_tree_reset_layer_active     (GNode *root, GESLayer *layer);
 void timeline_tree_set_smart_rendering    (GNode * root, gboolean rendering_smartly);
+GArray * timeline_tree_get_independent_positions (GNode * root);
 
 void timeline_tree_init_debug             (void);
@@ -2132,18 +2132,13 @@ void
 ges_timeline_set_smart_rendering (GESTimeline * timeline,
     gboolean rendering_smartly)
 {
-  if (rendering_smartly) {
-    GList *tmp;
+  GList *tmp;
+
+  /* Each track decides whether its content can be passed through, tracks
+   * that can't will simply be re-encoded */
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next)
+    ges_track_set_smart_rendering (tmp->data, rendering_smartly);
 
-    for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
-      if (ges_track_get_mixing (tmp->data)) {
-        GST_INFO_OBJECT (timeline, "Smart rendering will not"
-            " work as track %" GST_PTR_FORMAT " is doing mixing", tmp->data);
-      } else {
-        ges_track_set_smart_rendering (tmp->data, rendering_smartly);
-      }
-    }
-  }
   timeline_tree_set_smart_rendering (timeline->priv->tree, rendering_smartly);
   timeline->priv->rendering_smartly = rendering_smartly;
 }
@@ -3387,3 +3382,75 @@ ges_timeline_get_frame_at (GESTimeline * self, GstClockTime timestamp)
 
   return gst_util_uint64_scale (timestamp, fps_n, fps_d * GST_SECOND);
 }
+
+/**
+ * ges_timeline_get_render_split_points:
+ * @self: A #GESTimeline
+ * @n_ranges: The number of ranges to split @self into
+ *
+ * Computes the boundaries of @n_ranges time ranges, of roughly the same
+ * duration, into which @self can be split so that each range can be
+ * rendered separately, for example in parallel, before concatenating the
+ * results.
+ *
+ * Boundaries are aligned on frames of the timeline output, and are moved
+ * to a position where no element is in progress (for example between two
+ * clips, outside of any transition) whenever one is close enough, so each
+ * range starts on a clean cut. Fewer ranges than requested might be
+ * returned for short timelines.
+ *
+ * Returns: (transfer full) (element-type GstClockTime): The sorted
+ * boundaries of the ranges, starting with 0 and ending with the
+ * #GESTimeline:duration of @self.
+ *
+ * Since: 1.22
+ */
+GArray *
+ges_timeline_get_render_split_points (GESTimeline * self, guint n_ranges)
+{
+  guint i, j = 0;
+  GArray *points, *independent;
+  GstClockTime duration, last = 0;
+
+  g_return_val_if_fail (GES_IS_TIMELINE (self), NULL);
+  g_return_val_if_fail (n_ranges > 0, NULL);
+
+  duration = self->priv->duration;
+  points = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+  g_array_append_val (points, last);
+
+  independent = timeline_tree_get_independent_positions (self->priv->tree);
+  for (i = 1; i < n_ranges; i++) {
+    GstClockTime ideal = gst_util_uint64_scale (duration, i, n_ranges);
+    GstClockTime tolerance = duration / (2 * n_ranges);
+    GstClockTime distance = GST_CLOCK_TIME_NONE;
+    GstClockTime point = ges_timeline_get_frame_time (self,
+        ges_timeline_get_frame_at (self, ideal));
+
+    /* Use the closest independent position in the tolerance window */
+    for (; j < independent->len; j++) {
+      GstClockTime pos = g_array_index (independent, GstClockTime, j);
+      GstClockTime diff = pos > ideal ? pos - ideal : ideal - pos;
+
+      if (pos > ideal + tolerance)
+        break;
+
+      if (diff <= tolerance && diff < distance) {
+        distance = diff;
+        point = pos;
+      }
+    }
+
+    if (point <= last || point >= duration)
+      continue;
+
+    g_array_append_val (points, point);
+    last = point;
+  }
+  g_array_free (independent, TRUE);
+
+  if (duration > last || points->len == 1)
+    g_array_append_val (points, duration);
+
+  return points;
+}
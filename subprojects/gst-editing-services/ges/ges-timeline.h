@@ -160,4 +160,8 @@ GES_API
 GESFrameNumber ges_timeline_get_frame_at (GESTimeline *self,
                                           GstClockTime timestamp);
 
+GES_API
+GArray * ges_timeline_get_render_split_points (GESTimeline *self,
+                                               guint n_ranges);
+
 G_END_DECLS
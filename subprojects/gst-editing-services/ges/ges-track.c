@@ -53,6 +53,9 @@
 #include "ges-meta-container.h"
 #include "ges-video-track.h"
 #include "ges-audio-track.h"
+#include "ges-operation.h"
+#include "ges-video-uri-source.h"
+#include "ges-audio-uri-source.h"
 
 #define CHECK_THREAD(track) g_assert(track->priv->valid_thread == g_thread_self())
 
@@ -94,6 +97,10 @@ struct _GESTrackPrivate
 
   gboolean mixing;
   GstElement *mixing_operation;
+  /* Whether mixing_operation is currently in the composition */
+  gboolean mixing_operation_active;
+  /* Whether the track content is passed through without being decoded */
+  gboolean rendering_smartly;
   GstElement *capsfilter;
 
   /* Virtual method to create GstElement that fill gaps */
@@ -375,11 +382,101 @@ ges_track_get_composition (GESTrack * track)
   return track->priv->composition;
 }
 
+static gboolean
+_set_mixing_operation_active (GESTrack * track, gboolean active)
+{
+  GESTrackPrivate *priv = track->priv;
+
+  if (!priv->mixing_operation || active == priv->mixing_operation_active)
+    return TRUE;
+
+  if (active) {
+    if (!ges_nle_composition_add_object (priv->composition,
+            priv->mixing_operation)) {
+      GST_WARNING_OBJECT (track, "Could not add the mixer to our composition");
+      return FALSE;
+    }
+  } else {
+    if (!ges_nle_composition_remove_object (priv->composition,
+            priv->mixing_operation)) {
+      GST_WARNING_OBJECT (track,
+          "Could not remove the mixer from our composition");
+      return FALSE;
+    }
+  }
+
+  priv->mixing_operation_active = active;
+
+  return TRUE;
+}
+
+/* Whether the content of @track can be passed through without being
+ * decoded: it must only contain uri sources that do not overlap and leave
+ * no gap, and no operation (effects, transitions) */
+static gboolean
+_can_render_smartly (GESTrack * track)
+{
+  GSequenceIter *it;
+  GstClockTime end = 0;
+
+  for (it = g_sequence_get_begin_iter (track->priv->trackelements_by_start);
+      !g_sequence_iter_is_end (it); it = g_sequence_iter_next (it)) {
+    GESTrackElement *element = g_sequence_get (it);
+    GstClockTime start = _START (element);
+
+    if (!ges_track_element_is_active (element))
+      continue;
+
+    if (GES_IS_OPERATION (element)) {
+      GST_DEBUG_OBJECT (track, "%" GES_FORMAT " needs decoding",
+          GES_ARGS (element));
+      return FALSE;
+    }
+
+    if (!GES_IS_VIDEO_URI_SOURCE (element)
+        && !GES_IS_AUDIO_URI_SOURCE (element)) {
+      GST_DEBUG_OBJECT (track, "%" GES_FORMAT " is not a uri source",
+          GES_ARGS (element));
+      return FALSE;
+    }
+
+    if (start != end) {
+      GST_DEBUG_OBJECT (track, "%" GES_FORMAT " %s previous source",
+          GES_ARGS (element), start < end ? "overlaps" : "leaves a gap after");
+      return FALSE;
+    }
+
+    end = _END (element);
+  }
+
+  return TRUE;
+}
+
+/* Sources in @track must only render smartly if this returns %TRUE */
+gboolean
+ges_track_get_smart_rendering (GESTrack * track)
+{
+  return track->priv->rendering_smartly;
+}
+
 void
 ges_track_set_smart_rendering (GESTrack * track, gboolean rendering_smartly)
 {
   GESTrackPrivate *priv = track->priv;
 
+  /* Mixing tracks that only cut between sources can still pass the encoded
+   * data through, we just need to take the (raw only) mixer out. */
+  if (rendering_smartly && !_can_render_smartly (track)) {
+    GST_INFO_OBJECT (track, "Content needs to be decoded, not rendering "
+        "smartly");
+    rendering_smartly = FALSE;
+  }
+
+  if (!_set_mixing_operation_active (track, priv->mixing
+          && !rendering_smartly))
+    rendering_smartly = priv->mixing_operation_active;
+
+  priv->rendering_smartly = rendering_smartly;
   g_object_set (priv->capsfilter, "caps",
       rendering_smartly ? NULL : priv->restriction_caps, NULL);
 }
@@ -645,17 +742,13 @@ ges_track_constructed (GObject * object)
     }
     g_object_set (nleobject, "expandable", TRUE, NULL);
 
-    if (self->priv->mixing) {
-      if (!ges_nle_composition_add_object (self->priv->composition, nleobject)) {
-        GST_WARNING_OBJECT (self, "Could not add the mixer to our composition");
-        gst_object_unref (nleobject);
+    self->priv->mixing_operation = gst_object_ref (nleobject);
+    if (self->priv->mixing && !_set_mixing_operation_active (self, TRUE)) {
+      gst_clear_object (&self->priv->mixing_operation);
 
-        return;
-      }
+      return;
     }
 
-    self->priv->mixing_operation = gst_object_ref (nleobject);
-
   } else {
     GST_INFO_OBJECT (self, "No way to create a main mixer");
   }
@@ -1101,20 +1194,11 @@ ges_track_set_mixing (GESTrack * track, gboolean mixing)
     goto notify;
   }
 
-  if (mixing) {
-    if (!ges_nle_composition_add_object (track->priv->composition,
-            track->priv->mixing_operation)) {
-      GST_WARNING_OBJECT (track, "Could not add the mixer to our composition");
-      return;
-    }
-  } else {
-    if (!ges_nle_composition_remove_object (track->priv->composition,
-            track->priv->mixing_operation)) {
-      GST_WARNING_OBJECT (track,
-          "Could not remove the mixer from our composition");
-      return;
-    }
-  }
+  /* While rendering smartly the mixer is out of the composition, it is put
+   * back (or not) when smart rendering gets updated below */
+  if (!track->priv->rendering_smartly
+      && !_set_mixing_operation_active (track, mixing))
+    return;
 
 notify:
   track->priv->mixing = mixing;
@@ -775,6 +775,270 @@ ges_uri_clip_asset_get_stream_assets (GESUriClipAsset * self)
   return self->priv->asset_trackfilesources;
 }
 
+/* Proxy generation */
+
+typedef struct
+{
+  GESUriClipAsset *asset;
+  gchar *proxy_uri;
+  GstElement *pipeline;
+  GstElement *encodebin;
+  GSource *bus_source;
+  GCancellable *cancellable;
+  gulong cancelled_id;
+} ProxyJob;
+
+static void
+proxy_job_stop (ProxyJob * job)
+{
+  if (job->bus_source) {
+    g_source_destroy (job->bus_source);
+    g_source_unref (job->bus_source);
+    job->bus_source = NULL;
+  }
+
+  if (job->pipeline) {
+    gst_element_set_state (job->pipeline, GST_STATE_NULL);
+    gst_clear_object (&job->pipeline);
+  }
+}
+
+static void
+proxy_job_free (ProxyJob * job)
+{
+  if (job->cancelled_id)
+    g_cancellable_disconnect (job->cancellable, job->cancelled_id);
+  proxy_job_stop (job);
+  g_clear_object (&job->cancellable);
+  gst_object_unref (job->asset);
+  g_free (job->proxy_uri);
+  g_free (job);
+}
+
+static void
+proxy_decodebin_pad_added_cb (GstElement * decodebin, GstPad * pad,
+    ProxyJob * job)
+{
+  GstCaps *caps;
+  GstPad *sinkpad = NULL;
+
+  caps = gst_pad_get_current_caps (pad);
+  if (!caps)
+    caps = gst_pad_query_caps (pad, NULL);
+
+  g_signal_emit_by_name (job->encodebin, "request-pad", caps, &sinkpad);
+  if (!sinkpad) {
+    GstElement *fakesink = gst_element_factory_make ("fakesink", NULL);
+
+    GST_INFO_OBJECT (job->asset, "No stream profile for %" GST_PTR_FORMAT
+        ", dropping it", caps);
+    g_object_set (fakesink, "sync", FALSE, NULL);
+    gst_bin_add (GST_BIN (job->pipeline), fakesink);
+    gst_element_sync_state_with_parent (fakesink);
+    sinkpad = gst_element_get_static_pad (fakesink, "sink");
+  }
+  gst_caps_unref (caps);
+
+  if (gst_pad_link (pad, sinkpad) != GST_PAD_LINK_OK)
+    GST_WARNING_OBJECT (job->asset, "Could not link %" GST_PTR_FORMAT
+        " to %" GST_PTR_FORMAT, pad, sinkpad);
+  gst_object_unref (sinkpad);
+}
+
+static void
+proxy_asset_loaded_cb (GObject * source, GAsyncResult * res, GTask * task)
+{
+  ProxyJob *job = g_task_get_task_data (task);
+  GError *error = NULL;
+  GESAsset *proxy;
+
+  proxy = ges_asset_request_finish (res, &error);
+  if (!proxy) {
+    g_task_return_error (task, error);
+  } else if (!ges_asset_set_proxy (GES_ASSET (job->asset), proxy)) {
+    g_task_return_new_error (task, GES_ERROR, GES_ERROR_ASSET_LOADING,
+        "Could not use %s as a proxy for %s", job->proxy_uri,
+        ges_asset_get_id (GES_ASSET (job->asset)));
+    gst_object_unref (proxy);
+  } else {
+    GST_INFO_OBJECT (job->asset, "Proxy ready: %s", job->proxy_uri);
+    g_task_return_pointer (task, proxy, gst_object_unref);
+  }
+
+  g_object_unref (task);
+}
+
+static gboolean
+proxy_bus_cb (GstBus * bus, GstMessage * message, GTask * task)
+{
+  ProxyJob *job = g_task_get_task_data (task);
+  GError *error = NULL;
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_EOS:
+      GST_DEBUG_OBJECT (job->asset, "Transcoded to %s", job->proxy_uri);
+      /* This also drops the bus source, we are done with it */
+      proxy_job_stop (job);
+      ges_asset_request_async (GES_TYPE_URI_CLIP, job->proxy_uri,
+          g_task_get_cancellable (task),
+          (GAsyncReadyCallback) proxy_asset_loaded_cb, task);
+      return G_SOURCE_REMOVE;
+    case GST_MESSAGE_ERROR:
+      gst_message_parse_error (message, &error, NULL);
+      GST_WARNING_OBJECT (job->asset, "Could not generate proxy: %s",
+          error->message);
+      proxy_job_stop (job);
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return G_SOURCE_REMOVE;
+    case GST_MESSAGE_APPLICATION:
+      if (gst_message_has_name (message, "ges-proxy-cancelled")) {
+        proxy_job_stop (job);
+        g_task_return_error_if_cancelled (task);
+        g_object_unref (task);
+        return G_SOURCE_REMOVE;
+      }
+      break;
+    default:
+      break;
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+/* Called from the thread cancelling, wake up the bus watch */
+static void
+proxy_cancelled_cb (GCancellable * cancellable, GstBus * bus)
+{
+  gst_bus_post (bus, gst_message_new_application (NULL,
+          gst_structure_new_empty ("ges-proxy-cancelled")));
+}
+
+/**
+ * ges_uri_clip_asset_generate_proxy_async:
+ * @self: The #GESUriClipAsset to generate a proxy for
+ * @profile: The #GstEncodingProfile to transcode @self with
+ * @proxy_uri: The URI to write the proxy media to
+ * @cancellable: (nullable): A #GCancellable, or %NULL
+ * @callback: The #GAsyncReadyCallback to call once the proxy is ready
+ * @user_data: User data to pass to @callback
+ *
+ * Transcodes the media of @self to @proxy_uri with @profile in the
+ * background, then loads the result as a #GESUriClipAsset and sets it as
+ * the default proxy of @self with ges_asset_set_proxy().
+ *
+ * Proxies are typically a lower resolution, intra-frame only version of
+ * the original media. The resolution can be set through the restriction
+ * caps of the video profile of @profile.
+ *
+ * The job runs from the thread default #GMainContext of the caller, which
+ * must be running. Get the result with
+ * ges_uri_clip_asset_generate_proxy_finish() from @callback.
+ *
+ * See #GESPipeline:preview-proxies to automatically use the proxies while
+ * previewing and the original media while rendering.
+ *
+ * Since: 1.22
+ */
+void
+ges_uri_clip_asset_generate_proxy_async (GESUriClipAsset * self,
+    GstEncodingProfile * profile, const gchar * proxy_uri,
+    GCancellable * cancellable, GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+  GTask *task;
+  ProxyJob *job;
+  GstElement *decodebin, *sink;
+  GstBus *bus;
+  GError *error = NULL;
+
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET (self));
+  g_return_if_fail (GST_IS_ENCODING_PROFILE (profile));
+  g_return_if_fail (proxy_uri != NULL);
+
+  task = g_task_new (self, cancellable, callback, user_data);
+  job = g_new0 (ProxyJob, 1);
+  job->asset = gst_object_ref (self);
+  job->proxy_uri = g_strdup (proxy_uri);
+  g_task_set_task_data (task, job, (GDestroyNotify) proxy_job_free);
+
+  sink = gst_element_make_from_uri (GST_URI_SINK, proxy_uri, NULL, &error);
+  if (!sink) {
+    g_task_return_error (task, error);
+    g_object_unref (task);
+    return;
+  }
+
+  decodebin = gst_element_factory_make ("uridecodebin", NULL);
+  job->encodebin = gst_element_factory_make ("encodebin", NULL);
+  if (!decodebin || !job->encodebin) {
+    gst_clear_object (&decodebin);
+    gst_clear_object (&job->encodebin);
+    gst_object_unref (sink);
+    g_task_return_new_error (task, GST_CORE_ERROR,
+        GST_CORE_ERROR_MISSING_PLUGIN,
+        "Missing uridecodebin or encodebin to generate proxies");
+    g_object_unref (task);
+    return;
+  }
+
+  job->pipeline = gst_pipeline_new ("ges-proxy-generator");
+  g_object_set (decodebin, "uri", ges_asset_get_id (GES_ASSET (self)), NULL);
+  g_object_set (job->encodebin, "profile", profile, NULL);
+  gst_bin_add_many (GST_BIN (job->pipeline), decodebin, job->encodebin, sink,
+      NULL);
+  gst_element_link (job->encodebin, sink);
+  g_signal_connect (decodebin, "pad-added",
+      G_CALLBACK (proxy_decodebin_pad_added_cb), job);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (job->pipeline));
+  job->bus_source = gst_bus_create_watch (bus);
+  g_source_set_callback (job->bus_source, (GSourceFunc) proxy_bus_cb, task,
+      NULL);
+  g_source_attach (job->bus_source, g_task_get_context (task));
+  if (cancellable) {
+    job->cancellable = g_object_ref (cancellable);
+    job->cancelled_id = g_cancellable_connect (cancellable,
+        G_CALLBACK (proxy_cancelled_cb), gst_object_ref (bus),
+        gst_object_unref);
+  }
+  gst_object_unref (bus);
+
+  GST_INFO_OBJECT (self, "Generating proxy %s", proxy_uri);
+  if (gst_element_set_state (job->pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+    proxy_job_stop (job);
+    g_task_return_new_error (task, GST_CORE_ERROR,
+        GST_CORE_ERROR_STATE_CHANGE, "Could not start transcoding %s to %s",
+        ges_asset_get_id (GES_ASSET (self)), proxy_uri);
+    g_object_unref (task);
+  }
+}
+
+/**
+ * ges_uri_clip_asset_generate_proxy_finish:
+ * @self: The #GESUriClipAsset the proxy was generated for
+ * @res: The #GAsyncResult passed to the callback
+ * @error: An error to be set in case something wrong happens or %NULL
+ *
+ * Finishes a proxy generation started with
+ * ges_uri_clip_asset_generate_proxy_async().
+ *
+ * Returns: (transfer full): The proxy #GESUriClipAsset, now the default
+ * proxy of @self, or %NULL if an error happened
+ *
+ * Since: 1.22
+ */
+GESUriClipAsset *
+ges_uri_clip_asset_generate_proxy_finish (GESUriClipAsset * self,
+    GAsyncResult * res, GError ** error)
+{
+  g_return_val_if_fail (GES_IS_URI_CLIP_ASSET (self), NULL);
+  g_return_val_if_fail (g_task_is_valid (res, self), NULL);
+
+  return g_task_propagate_pointer (G_TASK (res), error);
+}
+
 /*****************************************************************
  *            GESUriSourceAsset implementation             *
  *****************************************************************/
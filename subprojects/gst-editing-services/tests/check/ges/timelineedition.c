@@ -1275,6 +1275,70 @@ GST_START_TEST (test_marker_snapping)
 
 GST_END_TEST;
 
+static void
+check_split_points (GESTimeline * timeline, guint n_ranges,
+    guint n_points, ...)
+{
+  guint i;
+  va_list var_args;
+  GArray *points = ges_timeline_get_render_split_points (timeline, n_ranges);
+
+  assert_equals_int (points->len, n_points);
+  va_start (var_args, n_points);
+  for (i = 0; i < n_points; i++)
+    assert_equals_uint64 (g_array_index (points, GstClockTime, i),
+        va_arg (var_args, GstClockTime));
+  va_end (var_args);
+
+  g_array_free (points, TRUE);
+}
+
+GST_START_TEST (test_render_split_points)
+{
+  GESAsset *asset;
+  GESTimeline *timeline;
+  GESLayer *layer, *layer1;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  layer1 = ges_timeline_append_layer (timeline);
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+
+  /**
+   * Our timeline
+   *
+   * layer:   0------ 10 ------ 20 ----------------- 40
+   * layer1:                           25 ---- 30
+   */
+  fail_unless (ges_layer_add_asset (layer, asset, 0, 0, 10 * GST_SECOND,
+          GES_TRACK_TYPE_UNKNOWN));
+  fail_unless (ges_layer_add_asset (layer, asset, 10 * GST_SECOND, 0,
+          10 * GST_SECOND, GES_TRACK_TYPE_UNKNOWN));
+  fail_unless (ges_layer_add_asset (layer, asset, 20 * GST_SECOND, 0,
+          20 * GST_SECOND, GES_TRACK_TYPE_UNKNOWN));
+  fail_unless (ges_layer_add_asset (layer1, asset, 25 * GST_SECOND, 0,
+          5 * GST_SECOND, GES_TRACK_TYPE_UNKNOWN));
+  gst_object_unref (asset);
+
+  check_split_points (timeline, 1, 2, (GstClockTime) 0, 40 * GST_SECOND);
+  check_split_points (timeline, 2, 3, (GstClockTime) 0, 20 * GST_SECOND,
+      40 * GST_SECOND);
+  /* Nothing can be cut cleanly around 30s, use the closest frame */
+  check_split_points (timeline, 4, 5, (GstClockTime) 0, 10 * GST_SECOND,
+      20 * GST_SECOND, 30 * GST_SECOND, 40 * GST_SECOND);
+  /* Clean cuts are moved to when close enough */
+  check_split_points (timeline, 5, 6, (GstClockTime) 0, 10 * GST_SECOND,
+      20 * GST_SECOND, 24 * GST_SECOND, 32 * GST_SECOND, 40 * GST_SECOND);
+
+  gst_object_unref (timeline);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -1290,6 +1354,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_groups);
   tcase_add_test (tc_chain, test_snapping_groups);
   tcase_add_test (tc_chain, test_marker_snapping);
+  tcase_add_test (tc_chain, test_render_split_points);
 
   return s;
 }
@@ -274,6 +274,68 @@ GST_START_TEST (test_filesource_images)
 GST_END_TEST;
 
 
+GST_START_TEST (test_filesource_preview_proxies)
+{
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESPipeline *pipeline;
+  GESAsset *original, *proxy;
+  GESClip *clip;
+  GFile *src, *dst;
+  gchar *proxy_uri;
+
+  ges_init ();
+
+  /* Use a copy of the file as proxy */
+  proxy_uri = ges_test_get_tmp_uri ("test-preview-proxy.ogg");
+  src = g_file_new_for_uri (av_uri);
+  dst = g_file_new_for_uri (proxy_uri);
+  fail_unless (g_file_copy (src, dst, G_FILE_COPY_OVERWRITE, NULL, NULL,
+          NULL, NULL));
+  g_object_unref (src);
+
+  original = GES_ASSET (ges_uri_clip_asset_request_sync (av_uri, NULL));
+  proxy = GES_ASSET (ges_uri_clip_asset_request_sync (proxy_uri, NULL));
+  fail_unless (original != NULL);
+  fail_unless (proxy != NULL);
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  clip = ges_layer_add_asset (layer, original, 0, 0, GST_CLOCK_TIME_NONE,
+      GES_TRACK_TYPE_UNKNOWN);
+  fail_unless (clip != NULL);
+
+  pipeline = ges_pipeline_new ();
+  fail_unless (ges_pipeline_set_timeline (pipeline, timeline));
+
+  /* No proxy yet, nothing changes */
+  g_object_set (pipeline, "preview-proxies", TRUE, NULL);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (clip)) == original);
+  g_object_set (pipeline, "preview-proxies", FALSE, NULL);
+
+  fail_unless (ges_asset_set_proxy (original, proxy));
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (clip)) == original);
+
+  g_object_set (pipeline, "preview-proxies", TRUE, NULL);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (clip)) == proxy);
+  assert_equals_string (ges_uri_clip_get_uri (GES_URI_CLIP (clip)), proxy_uri);
+
+  g_object_set (pipeline, "preview-proxies", FALSE, NULL);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (clip)) == original);
+  assert_equals_string (ges_uri_clip_get_uri (GES_URI_CLIP (clip)), av_uri);
+
+  gst_object_unref (pipeline);
+  gst_object_unref (original);
+  gst_object_unref (proxy);
+  g_file_delete (dst, NULL, NULL);
+  g_object_unref (dst);
+  g_free (proxy_uri);
+
+  ges_deinit ();
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -285,6 +347,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_filesource_basic);
   tcase_add_test (tc_chain, test_filesource_images);
   tcase_add_test (tc_chain, test_filesource_properties);
+  tcase_add_test (tc_chain, test_filesource_preview_proxies);
 
   return s;
 }
@@ -23,6 +23,8 @@
 
 #include <glib.h>
 #include <glib/gprintf.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #ifdef G_OS_UNIX
@@ -58,6 +60,17 @@ struct _GESLauncherPrivate
   gdouble rate;
 
   GstState desired_state;       /* as per user interaction, PAUSED or PLAYING */
+
+  /* Parallel rendering, see `--render-jobs` */
+  gchar *argv0;
+  GstEncodingProfile *render_profile;
+  gchar *render_dir;
+  GList *render_processes;
+  guint n_pending_renders;
+  GstElement *concat_pipeline;
+
+  /* Waiting for preroll to seek to `--render-range` */
+  gboolean render_range_pending;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (GESLauncher, ges_launcher, G_TYPE_APPLICATION);
@@ -651,6 +664,13 @@ _set_rendering_details (GESLauncher * self)
       ges_project_add_encoding_profile (proj, prof);
     }
 
+    if (prof && opts->render_jobs > 1) {
+      /* Render jobs pick the profile from the project by name */
+      if (!gst_encoding_profile_get_name (prof))
+        gst_encoding_profile_set_name (prof, "ges-launch-render");
+      self->priv->render_profile = gst_encoding_profile_ref (prof);
+    }
+
     opts->outputuri = ensure_uri (opts->outputuri);
     if (opts->smartrender) {
       g_signal_connect (self->priv->pipeline, "deep-element-added",
@@ -796,6 +816,248 @@ _project_loading_error_cb (GESProject * project, GESTimeline * timeline,
   g_application_quit (G_APPLICATION (self));
 }
 
+static void
+_remove_render_dir (GESLauncher * self)
+{
+  GDir *dir;
+  const gchar *name;
+
+  if (!self->priv->render_dir)
+    return;
+
+  dir = g_dir_open (self->priv->render_dir, 0, NULL);
+  if (dir) {
+    while ((name = g_dir_read_name (dir))) {
+      gchar *path = g_build_filename (self->priv->render_dir, name, NULL);
+
+      g_unlink (path);
+      g_free (path);
+    }
+    g_dir_close (dir);
+  }
+
+  g_rmdir (self->priv->render_dir);
+  g_clear_pointer (&self->priv->render_dir, g_free);
+}
+
+static void
+_concat_pad_added_cb (GstElement * src, GstPad * pad, GstElement * encodebin)
+{
+  GstPad *sinkpad = NULL;
+  GstCaps *caps = gst_pad_query_caps (pad, NULL);
+
+  g_signal_emit_by_name (encodebin, "request-pad", caps, &sinkpad);
+  if (!sinkpad || gst_pad_link (pad, sinkpad) != GST_PAD_LINK_OK)
+    ges_printerr ("Could not concatenate stream with caps %" GST_PTR_FORMAT
+        "\n", caps);
+
+  gst_caps_unref (caps);
+  gst_clear_object (&sinkpad);
+}
+
+static void
+_concat_bus_message_cb (GstBus * bus, GstMessage * message,
+    GESLauncher * self)
+{
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ERROR:{
+      GError *err = NULL;
+
+      gst_message_parse_error (message, &err, NULL);
+      ges_printerr ("ERROR concatenating rendered ranges from element %s: %s\n",
+          GST_OBJECT_NAME (message->src), err->message);
+      g_clear_error (&err);
+      self->priv->seenerrors = TRUE;
+      g_application_quit (G_APPLICATION (self));
+      break;
+    }
+    case GST_MESSAGE_EOS:
+      ges_ok ("\nDone\n");
+      g_application_quit (G_APPLICATION (self));
+      break;
+    default:
+      break;
+  }
+}
+
+/* Muxes the ranges rendered by the render jobs back into the output file,
+ * encodebin passes the already encoded streams through */
+static gboolean
+_concat_rendered_ranges (GESLauncher * self)
+{
+  GstBus *bus;
+  gchar *location, *ext;
+  GstElement *src, *encodebin, *sink;
+  GESLauncherParsedOptions *opts = &self->priv->parsed_options;
+
+  sink = gst_element_make_from_uri (GST_URI_SINK, opts->outputuri, NULL,
+      NULL);
+  if (!sink) {
+    ges_printerr ("Could not create a sink for %s\n", opts->outputuri);
+    return FALSE;
+  }
+
+  src = gst_element_factory_make ("splitmuxsrc", NULL);
+  encodebin = gst_element_factory_make ("encodebin", NULL);
+  if (!src || !encodebin) {
+    ges_printerr ("Missing splitmuxsrc or encodebin to concatenate the "
+        "rendered ranges\n");
+    gst_clear_object (&src);
+    gst_clear_object (&encodebin);
+    gst_object_unref (sink);
+    return FALSE;
+  }
+
+  ext = get_file_extension (opts->outputuri);
+  location = g_strdup_printf ("%s" G_DIR_SEPARATOR_S "part*%s%s",
+      self->priv->render_dir, ext ? "." : "", ext ? ext : "");
+  g_object_set (src, "location", location, NULL);
+  g_object_set (encodebin, "profile", self->priv->render_profile, NULL);
+  g_free (location);
+  g_free (ext);
+
+  self->priv->concat_pipeline = gst_pipeline_new ("ges-launch-concat");
+  gst_bin_add_many (GST_BIN (self->priv->concat_pipeline), src, encodebin,
+      sink, NULL);
+  gst_element_link (encodebin, sink);
+  g_signal_connect (src, "pad-added", G_CALLBACK (_concat_pad_added_cb),
+      encodebin);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (self->priv->concat_pipeline));
+  gst_bus_add_signal_watch (bus);
+  g_signal_connect (bus, "message", G_CALLBACK (_concat_bus_message_cb), self);
+  gst_object_unref (bus);
+
+  gst_print ("\nConcatenating rendered ranges into %s\n", opts->outputuri);
+
+  return gst_element_set_state (self->priv->concat_pipeline,
+      GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE;
+}
+
+static void
+_render_job_done_cb (GSubprocess * process, GAsyncResult * res,
+    GESLauncher * self)
+{
+  GError *err = NULL;
+
+  if (!g_subprocess_wait_check_finish (process, res, &err)) {
+    ges_printerr ("Render job failed: %s\n", err->message);
+    g_error_free (err);
+    self->priv->seenerrors = TRUE;
+    g_application_quit (G_APPLICATION (self));
+
+    return;
+  }
+
+  if (--self->priv->n_pending_renders)
+    return;
+
+  if (!_concat_rendered_ranges (self)) {
+    self->priv->seenerrors = TRUE;
+    g_application_quit (G_APPLICATION (self));
+  }
+}
+
+/* Splits the timeline in `--render-jobs` ranges, each rendered by a
+ * ges-launch subprocess loading a copy of the project */
+static gboolean
+_start_render_jobs (GESLauncher * self)
+{
+  guint i;
+  GArray *points;
+  GError *err = NULL;
+  gchar *project_path = NULL, *project_uri = NULL, *ext = NULL;
+  gboolean res = FALSE;
+  GESLauncherParsedOptions *opts = &self->priv->parsed_options;
+
+  self->priv->render_dir = g_dir_make_tmp ("ges-launch-XXXXXX", &err);
+  if (!self->priv->render_dir)
+    goto done;
+
+  project_path = g_build_filename (self->priv->render_dir, "project.xges",
+      NULL);
+  project_uri = gst_filename_to_uri (project_path, &err);
+  if (!project_uri || !ges_timeline_save_to_uri (self->priv->timeline,
+          project_uri, NULL, TRUE, &err))
+    goto done;
+
+  ext = get_file_extension (opts->outputuri);
+  points = ges_timeline_get_render_split_points (self->priv->timeline,
+      opts->render_jobs);
+
+  gst_print ("\nRendering %u ranges in parallel\n", points->len - 1);
+  for (i = 0; i + 1 < points->len; i++) {
+    GSubprocess *process;
+    GPtrArray *args = g_ptr_array_new_with_free_func (g_free);
+    gchar *part = g_strdup_printf ("part%05u%s%s", i, ext ? "." : "",
+        ext ? ext : "");
+
+    g_ptr_array_add (args, g_strdup (self->priv->argv0));
+    g_ptr_array_add (args, g_strdup ("--no-interactive"));
+    g_ptr_array_add (args, g_strdup ("--load"));
+    g_ptr_array_add (args, g_strdup (project_path));
+    g_ptr_array_add (args, g_strdup ("--outputuri"));
+    g_ptr_array_add (args, g_build_filename (self->priv->render_dir, part,
+            NULL));
+    g_ptr_array_add (args, g_strdup ("--encoding-profile"));
+    g_ptr_array_add (args,
+        g_strdup (gst_encoding_profile_get_name (self->priv->render_profile)));
+    g_ptr_array_add (args, g_strdup ("--render-range"));
+    g_ptr_array_add (args, g_strdup_printf ("%" G_GUINT64_FORMAT ":%"
+            G_GUINT64_FORMAT, g_array_index (points, GstClockTime, i),
+            g_array_index (points, GstClockTime, i + 1)));
+    if (opts->smartrender)
+      g_ptr_array_add (args, g_strdup ("--smart-rendering"));
+    if (opts->forward_tags)
+      g_ptr_array_add (args, g_strdup ("--forward-tags"));
+    g_ptr_array_add (args, NULL);
+    g_free (part);
+
+    process = g_subprocess_newv ((const gchar * const *) args->pdata,
+        G_SUBPROCESS_FLAGS_STDOUT_SILENCE, &err);
+    g_ptr_array_unref (args);
+    if (!process)
+      break;
+
+    self->priv->render_processes =
+        g_list_prepend (self->priv->render_processes, process);
+    self->priv->n_pending_renders++;
+    g_subprocess_wait_check_async (process, NULL,
+        (GAsyncReadyCallback) _render_job_done_cb, self);
+  }
+  g_array_free (points, TRUE);
+
+  res = !err;
+
+done:
+  if (err) {
+    ges_printerr ("Could not start render jobs: %s\n", err->message);
+    g_error_free (err);
+  }
+  g_free (project_path);
+  g_free (project_uri);
+  g_free (ext);
+
+  return res;
+}
+
+static gboolean
+_seek_render_range (GESLauncher * self)
+{
+  guint64 start, stop;
+  GESLauncherParsedOptions *opts = &self->priv->parsed_options;
+
+  if (sscanf (opts->render_range, "%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT,
+          &start, &stop) != 2 || start >= stop) {
+    ges_printerr ("Invalid render range: %s\n", opts->render_range);
+    return FALSE;
+  }
+
+  return gst_element_seek (GST_ELEMENT (self->priv->pipeline), 1.0,
+      GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE,
+      GST_SEEK_TYPE_SET, start, GST_SEEK_TYPE_SET, stop);
+}
+
 static void
 _project_loaded_cb (GESProject * project, GESTimeline * timeline,
     GESLauncher * self)
@@ -853,9 +1115,23 @@ _project_loaded_cb (GESProject * project, GESTimeline * timeline,
 
   g_free (project_uri);
 
+  if (!self->priv->seenerrors && self->priv->render_profile) {
+    if (!_start_render_jobs (self)) {
+      self->priv->seenerrors = TRUE;
+      g_application_quit (G_APPLICATION (self));
+    }
+
+    return;
+  }
+
+  /* Only start playing once prerolled and seeked to the range to render */
+  if (opts->render_range)
+    self->priv->render_range_pending = TRUE;
+
   if (!self->priv->seenerrors && opts->needs_set_state &&
       gst_element_set_state (GST_ELEMENT (self->priv->pipeline),
-          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+          opts->render_range ? GST_STATE_PAUSED : GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE) {
     g_error ("Failed to start the pipeline\n");
   }
 }
@@ -989,6 +1265,21 @@ bus_message_cb (GstBus * bus, GstMessage * message, GESLauncher * self)
         g_free (state_transition_name);
       }
       break;
+    case GST_MESSAGE_ASYNC_DONE:
+      if (self->priv->render_range_pending
+          && GST_MESSAGE_SRC (message) ==
+          GST_OBJECT_CAST (self->priv->pipeline)) {
+        self->priv->render_range_pending = FALSE;
+        if (!_seek_render_range (self)) {
+          self->priv->seenerrors = TRUE;
+          g_application_quit (G_APPLICATION (self));
+          break;
+        }
+
+        gst_element_set_state (GST_ELEMENT (self->priv->pipeline),
+            GST_STATE_PLAYING);
+      }
+      break;
     case GST_MESSAGE_REQUEST_STATE:
       ges_validate_handle_request_state_change (message, G_APPLICATION (self));
       break;
@@ -1280,6 +1571,15 @@ ges_launcher_get_rendering_option_group (GESLauncherParsedOptions * opts)
     {"smart-rendering", 0, 0, G_OPTION_ARG_NONE, &opts->smartrender,
           "Avoid reencoding when rendering. This option implies --disable-mixing.",
         NULL},
+    {"render-jobs", 0, 0, G_OPTION_ARG_INT, &opts->render_jobs,
+          "Split the timeline in <n> ranges, render them in parallel in "
+          "separate processes and concatenate the results. "
+          "This will have no effect if no outputuri has been specified.",
+        "<n>"},
+    {"render-range", 0, G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_STRING,
+          &opts->render_range,
+          "Only render the timeline between <start> and <stop>, in nanoseconds.",
+        "<start>:<stop>"},
     {NULL}
   };
 
@@ -1471,6 +1771,7 @@ _local_command_line (GApplication * application, gchar ** arguments[],
 
   *exit_status = 0;
   argc = g_strv_length (*arguments);
+  self->priv->argv0 = g_strdup ((*arguments)[0]);
 
   gst_init (&argc, arguments);
   if (!ges_launcher_parse_options (self, arguments, &argc, ctx, &error)) {
@@ -1639,6 +1940,16 @@ _shutdown (GApplication * application)
 
   _save_timeline (self);
 
+  g_list_foreach (self->priv->render_processes,
+      (GFunc) g_subprocess_force_exit, NULL);
+  g_list_free_full (self->priv->render_processes, g_object_unref);
+  self->priv->render_processes = NULL;
+  if (self->priv->concat_pipeline) {
+    gst_element_set_state (self->priv->concat_pipeline, GST_STATE_NULL);
+    gst_clear_object (&self->priv->concat_pipeline);
+  }
+  _remove_render_dir (self);
+
   if (self->priv->pipeline) {
     gst_element_set_state (GST_ELEMENT (self->priv->pipeline), GST_STATE_NULL);
     validate_res = ges_validate_clean (GST_PIPELINE (self->priv->pipeline));
@@ -1675,6 +1986,10 @@ _finalize (GObject * object)
   g_free (opts->audio_track_caps);
   g_free (opts->scenario);
   g_free (opts->testfile);
+  g_free (opts->render_range);
+  g_free (self->priv->argv0);
+  if (self->priv->render_profile)
+    gst_encoding_profile_unref (self->priv->render_profile);
 
   G_OBJECT_CLASS (ges_launcher_parent_class)->finalize (object);
 }
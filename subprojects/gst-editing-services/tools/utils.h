@@ -52,6 +52,9 @@ typedef struct
   gboolean ignore_eos;
   gboolean interactive;
   gboolean forward_tags;
+
+  gint render_jobs;
+  gchar *render_range;
 } GESLauncherParsedOptions;
 
 gchar * sanitize_timeline_description (gchar **args, GESLauncherParsedOptions *opts);
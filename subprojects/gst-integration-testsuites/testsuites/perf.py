@@ -0,0 +1,49 @@
+# -*- Mode: Python -*- vi:si:et:sw=4:sts=4:ts=4:syntax=python
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program; if not, write to the
+# Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+"""
+The GstValidate performance testsuite
+
+Decodes, encodes and transcodes the standard medias and checks the
+throughput, latency and CPU usage budgets set in the tests with validateperf.
+"""
+
+import os
+
+from testsuiteutils import update_assets
+from launcher import utils
+from launcher.apps.gstvalidate import GstValidateSimpleTestsGenerator
+
+
+TEST_MANAGER = "validate"
+
+
+def setup_tests(test_manager, options):
+    testsuite_dir = os.path.realpath(os.path.join(os.path.dirname(__file__)))
+    assets_dir = os.path.realpath(os.path.join(testsuite_dir, os.path.pardir, "medias", "defaults"))
+    if options.sync and not utils.USING_SUBPROJECT:
+        if not update_assets(options, assets_dir):
+            return False
+
+    options.add_paths(assets_dir)
+
+    test_manager.add_generators(
+        GstValidateSimpleTestsGenerator("perf", test_manager,
+            os.path.join(testsuite_dir, "perf"))
+    )
+
+    return True
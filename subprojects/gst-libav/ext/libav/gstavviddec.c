@@ -25,6 +25,7 @@
 #include <string.h>
 
 #include <libavcodec/avcodec.h>
+#include <libavutil/hwcontext.h>
 #include <libavutil/stereo3d.h>
 #include <libavutil/mastering_display_metadata.h>
 
@@ -41,6 +42,7 @@ GST_DEBUG_CATEGORY_STATIC (GST_CAT_PERFORMANCE);
 
 #define DEFAULT_LOWRES			0
 #define DEFAULT_SKIPFRAME		0
+#define DEFAULT_SKIP_LOOP_FILTER	AVDISCARD_DEFAULT
 #define DEFAULT_DIRECT_RENDERING	TRUE
 #define DEFAULT_MAX_THREADS		0
 #define DEFAULT_OUTPUT_CORRUPT		TRUE
@@ -48,17 +50,22 @@ GST_DEBUG_CATEGORY_STATIC (GST_CAT_PERFORMANCE);
 #define DEFAULT_STRIDE_ALIGN            31
 #define DEFAULT_ALLOC_PARAM             { 0, DEFAULT_STRIDE_ALIGN, 0, 0, }
 #define DEFAULT_THREAD_TYPE             0
+#define DEFAULT_HWACCEL                 NULL
+
+#define HW_DEVICE_CONTEXT_TYPE_PREFIX   "gst.libav.hw-device."
 
 enum
 {
   PROP_0,
   PROP_LOWRES,
   PROP_SKIPFRAME,
+  PROP_SKIP_LOOP_FILTER,
   PROP_DIRECT_RENDERING,
   PROP_DEBUG_MV,
   PROP_MAX_THREADS,
   PROP_OUTPUT_CORRUPT,
   PROP_THREAD_TYPE,
+  PROP_HWACCEL,
   PROP_LAST
 };
 
@@ -77,6 +84,12 @@ static gboolean gst_ffmpegviddec_stop (GstVideoDecoder * decoder);
 static gboolean gst_ffmpegviddec_flush (GstVideoDecoder * decoder);
 static gboolean gst_ffmpegviddec_decide_allocation (GstVideoDecoder * decoder,
     GstQuery * query);
+static gboolean gst_ffmpegviddec_src_query (GstVideoDecoder * decoder,
+    GstQuery * query);
+static gboolean gst_ffmpegviddec_sink_query (GstVideoDecoder * decoder,
+    GstQuery * query);
+static void gst_ffmpegviddec_set_context (GstElement * element,
+    GstContext * context);
 static gboolean gst_ffmpegviddec_propose_allocation (GstVideoDecoder * decoder,
     GstQuery * query);
 
@@ -106,6 +119,28 @@ static gboolean context_changed (GstFFMpegVidDec * ffmpegdec,
 
 static GstElementClass *parent_class = NULL;
 
+/* A reference to an AVHWDeviceContext, to share it in a GstContext */
+typedef AVBufferRef GstFFMpegHwDevice;
+
+static GstFFMpegHwDevice *
+gst_ffmpeg_hw_device_ref (GstFFMpegHwDevice * device)
+{
+  return av_buffer_ref (device);
+}
+
+static void
+gst_ffmpeg_hw_device_unref (GstFFMpegHwDevice * device)
+{
+  av_buffer_unref (&device);
+}
+
+/* *INDENT-OFF* */
+G_DEFINE_BOXED_TYPE (GstFFMpegHwDevice, gst_ffmpeg_hw_device,
+    gst_ffmpeg_hw_device_ref, gst_ffmpeg_hw_device_unref);
+/* *INDENT-ON* */
+
+#define GST_TYPE_FFMPEG_HW_DEVICE (gst_ffmpeg_hw_device_get_type ())
+
 #define GST_FFMPEGVIDDEC_TYPE_LOWRES (gst_ffmpegviddec_lowres_get_type())
 static GType
 gst_ffmpegviddec_lowres_get_type (void)
@@ -149,6 +184,31 @@ gst_ffmpegviddec_skipframe_get_type (void)
   return ffmpegdec_skipframe_type;
 }
 
+#define GST_FFMPEGVIDDEC_TYPE_SKIP_LOOP_FILTER (gst_ffmpegviddec_skip_loop_filter_get_type())
+static GType
+gst_ffmpegviddec_skip_loop_filter_get_type (void)
+{
+  static GType ffmpegdec_skip_loop_filter_type = 0;
+
+  if (!ffmpegdec_skip_loop_filter_type) {
+    static const GEnumValue ffmpegdec_skip_loop_filter[] = {
+      {AVDISCARD_DEFAULT, "Never skip the loop filter", "default"},
+      {AVDISCARD_NONREF, "Skip for non-reference frames", "non-ref"},
+      {AVDISCARD_BIDIR, "Skip for B-frames", "bidir"},
+      {AVDISCARD_NONINTRA, "Skip for non-intra frames", "non-intra"},
+      {AVDISCARD_NONKEY, "Skip for non-keyframes", "non-key"},
+      {AVDISCARD_ALL, "Skip for all frames", "all"},
+      {0, NULL, NULL},
+    };
+
+    ffmpegdec_skip_loop_filter_type =
+        g_enum_register_static ("GstLibAVVidDecSkipLoopFilter",
+        ffmpegdec_skip_loop_filter);
+  }
+
+  return ffmpegdec_skip_loop_filter_type;
+}
+
 static const GFlagsValue ffmpegdec_thread_types[] = {
   {0x0, "Auto", "auto"},
   {0x1, "Frame", "frame"},
@@ -243,6 +303,7 @@ static void
 gst_ffmpegviddec_class_init (GstFFMpegVidDecClass * klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
   GstVideoDecoderClass *viddec_class = GST_VIDEO_DECODER_CLASS (klass);
   int caps;
 
@@ -258,6 +319,21 @@ gst_ffmpegviddec_class_init (GstFFMpegVidDecClass * klass)
           "Which types of frames to skip during decoding",
           GST_FFMPEGVIDDEC_TYPE_SKIPFRAME, 0,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstFFMpegVidDec:skip-loop-filter:
+   *
+   * For which frames to skip the in-loop deblocking filter. Skipping it
+   * trades visual quality for a lower decoding time and can be changed while
+   * decoding, e.g. to degrade gracefully under CPU pressure.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_SKIP_LOOP_FILTER,
+      g_param_spec_enum ("skip-loop-filter", "Skip loop filter",
+          "For which frames to skip the in-loop deblocking filter",
+          GST_FFMPEGVIDDEC_TYPE_SKIP_LOOP_FILTER, DEFAULT_SKIP_LOOP_FILTER,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   g_object_class_install_property (gobject_class, PROP_LOWRES,
       g_param_spec_enum ("lowres", "Low resolution",
           "At which resolution to decode images",
@@ -293,6 +369,27 @@ gst_ffmpegviddec_class_init (GstFFMpegVidDecClass * klass)
             DEFAULT_THREAD_TYPE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   }
 
+  /**
+   * GstFFMpegVidDec:hwaccel:
+   *
+   * Name of the libav hardware device type to decode with, e.g. "vaapi",
+   * "cuda" or "d3d11va". The decoded frames are downloaded to system memory.
+   * The device is shared with other libav decoders through a #GstContext.
+   * If the device can't be created, or the codec can't be decoded with it,
+   * software decoding is used.
+   *
+   * Since: 1.22
+   */
+  if (avcodec_get_hw_config (klass->in_plugin, 0)) {
+    g_object_class_install_property (gobject_class, PROP_HWACCEL,
+        g_param_spec_string ("hwaccel", "Hardware acceleration",
+            "libav hardware device type to decode with, e.g. vaapi "
+            "(NULL = software decoding)", DEFAULT_HWACCEL,
+            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  }
+
+  element_class->set_context = gst_ffmpegviddec_set_context;
+
   viddec_class->set_format = gst_ffmpegviddec_set_format;
   viddec_class->handle_frame = gst_ffmpegviddec_handle_frame;
   viddec_class->start = gst_ffmpegviddec_start;
@@ -302,11 +399,14 @@ gst_ffmpegviddec_class_init (GstFFMpegVidDecClass * klass)
   viddec_class->drain = gst_ffmpegviddec_drain;
   viddec_class->decide_allocation = gst_ffmpegviddec_decide_allocation;
   viddec_class->propose_allocation = gst_ffmpegviddec_propose_allocation;
+  viddec_class->src_query = gst_ffmpegviddec_src_query;
+  viddec_class->sink_query = gst_ffmpegviddec_sink_query;
 
   GST_DEBUG_CATEGORY_GET (GST_CAT_PERFORMANCE, "GST_PERFORMANCE");
 
   gst_type_mark_as_plugin_api (GST_FFMPEGVIDDEC_TYPE_LOWRES, 0);
   gst_type_mark_as_plugin_api (GST_FFMPEGVIDDEC_TYPE_SKIPFRAME, 0);
+  gst_type_mark_as_plugin_api (GST_FFMPEGVIDDEC_TYPE_SKIP_LOOP_FILTER, 0);
   gst_type_mark_as_plugin_api (GST_FFMPEGVIDDEC_TYPE_THREAD_TYPE, 0);
 }
 
@@ -322,10 +422,14 @@ gst_ffmpegviddec_init (GstFFMpegVidDec * ffmpegdec)
   ffmpegdec->picture = av_frame_alloc ();
   ffmpegdec->opened = FALSE;
   ffmpegdec->skip_frame = ffmpegdec->lowres = 0;
+  ffmpegdec->skip_loop_filter = DEFAULT_SKIP_LOOP_FILTER;
   ffmpegdec->direct_rendering = DEFAULT_DIRECT_RENDERING;
   ffmpegdec->max_threads = DEFAULT_MAX_THREADS;
   ffmpegdec->output_corrupt = DEFAULT_OUTPUT_CORRUPT;
   ffmpegdec->thread_type = DEFAULT_THREAD_TYPE;
+  ffmpegdec->hwaccel = g_strdup (DEFAULT_HWACCEL);
+  ffmpegdec->hw_pix_fmt = AV_PIX_FMT_NONE;
+  ffmpegdec->hw_picture = av_frame_alloc ();
 
   GST_PAD_SET_ACCEPT_TEMPLATE (GST_VIDEO_DECODER_SINK_PAD (ffmpegdec));
   gst_video_decoder_set_use_default_pad_acceptcaps (GST_VIDEO_DECODER_CAST
@@ -340,7 +444,10 @@ gst_ffmpegviddec_finalize (GObject * object)
   GstFFMpegVidDec *ffmpegdec = (GstFFMpegVidDec *) object;
 
   av_frame_free (&ffmpegdec->picture);
+  av_frame_free (&ffmpegdec->hw_picture);
   avcodec_free_context (&ffmpegdec->context);
+  av_buffer_unref (&ffmpegdec->hw_device);
+  g_free (ffmpegdec->hwaccel);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -456,6 +563,242 @@ gst_ffmpegviddec_get_palette (GstFFMpegVidDec * ffmpegdec,
   }
 }
 
+/* with LOCK */
+static enum AVHWDeviceType
+gst_ffmpegviddec_get_hw_device_type (GstFFMpegVidDec * ffmpegdec)
+{
+  if (!ffmpegdec->hwaccel)
+    return AV_HWDEVICE_TYPE_NONE;
+
+  return av_hwdevice_find_type_by_name (ffmpegdec->hwaccel);
+}
+
+static enum AVPixelFormat
+gst_ffmpegviddec_get_hw_pix_fmt (GstFFMpegVidDec * ffmpegdec,
+    enum AVHWDeviceType type)
+{
+  GstFFMpegVidDecClass *oclass;
+  const AVCodecHWConfig *config;
+  gint i;
+
+  if (type == AV_HWDEVICE_TYPE_NONE)
+    return AV_PIX_FMT_NONE;
+
+  oclass = (GstFFMpegVidDecClass *) (G_OBJECT_GET_CLASS (ffmpegdec));
+  for (i = 0; (config = avcodec_get_hw_config (oclass->in_plugin, i)); i++) {
+    if ((config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX) &&
+        config->device_type == type)
+      return config->pix_fmt;
+  }
+
+  return AV_PIX_FMT_NONE;
+}
+
+static gchar *
+gst_ffmpegviddec_get_hw_context_type (enum AVHWDeviceType type)
+{
+  return g_strconcat (HW_DEVICE_CONTEXT_TYPE_PREFIX,
+      av_hwdevice_get_type_name (type), NULL);
+}
+
+static void
+gst_ffmpegviddec_set_context (GstElement * element, GstContext * context)
+{
+  GstFFMpegVidDec *ffmpegdec = (GstFFMpegVidDec *) element;
+  enum AVHWDeviceType type;
+  AVBufferRef *device = NULL;
+  gchar *context_type;
+
+  GST_OBJECT_LOCK (ffmpegdec);
+  type = gst_ffmpegviddec_get_hw_device_type (ffmpegdec);
+  if (type != AV_HWDEVICE_TYPE_NONE) {
+    context_type = gst_ffmpegviddec_get_hw_context_type (type);
+    if (!g_strcmp0 (gst_context_get_context_type (context), context_type) &&
+        gst_structure_get (gst_context_get_structure (context), "device",
+            GST_TYPE_FFMPEG_HW_DEVICE, &device, NULL) && device) {
+      GST_DEBUG_OBJECT (ffmpegdec, "Using %s device from context",
+          ffmpegdec->hwaccel);
+      av_buffer_unref (&ffmpegdec->hw_device);
+      ffmpegdec->hw_device = device;
+    }
+    g_free (context_type);
+  }
+  GST_OBJECT_UNLOCK (ffmpegdec);
+
+  GST_ELEMENT_CLASS (parent_class)->set_context (element, context);
+}
+
+static gboolean
+gst_ffmpegviddec_handle_context_query (GstFFMpegVidDec * ffmpegdec,
+    GstQuery * query)
+{
+  AVBufferRef *device = NULL;
+  GstContext *context, *old_context;
+  const gchar *context_type;
+  gchar *our_context_type;
+  gboolean ret = FALSE;
+
+  GST_OBJECT_LOCK (ffmpegdec);
+  if (ffmpegdec->hw_device)
+    device = av_buffer_ref (ffmpegdec->hw_device);
+  GST_OBJECT_UNLOCK (ffmpegdec);
+
+  if (!device)
+    return FALSE;
+
+  our_context_type = gst_ffmpegviddec_get_hw_context_type (((AVHWDeviceContext
+              *) device->data)->type);
+  gst_query_parse_context_type (query, &context_type);
+
+  if (!g_strcmp0 (context_type, our_context_type)) {
+    gst_query_parse_context (query, &old_context);
+    if (old_context)
+      context = gst_context_copy (old_context);
+    else
+      context = gst_context_new (our_context_type, TRUE);
+
+    gst_structure_set (gst_context_writable_structure (context), "device",
+        GST_TYPE_FFMPEG_HW_DEVICE, device, NULL);
+    gst_query_set_context (query, context);
+    gst_context_unref (context);
+    ret = TRUE;
+  }
+
+  g_free (our_context_type);
+  av_buffer_unref (&device);
+
+  return ret;
+}
+
+static gboolean
+gst_ffmpegviddec_src_query (GstVideoDecoder * decoder, GstQuery * query)
+{
+  if (GST_QUERY_TYPE (query) == GST_QUERY_CONTEXT &&
+      gst_ffmpegviddec_handle_context_query ((GstFFMpegVidDec *) decoder,
+          query))
+    return TRUE;
+
+  return GST_VIDEO_DECODER_CLASS (parent_class)->src_query (decoder, query);
+}
+
+static gboolean
+gst_ffmpegviddec_sink_query (GstVideoDecoder * decoder, GstQuery * query)
+{
+  if (GST_QUERY_TYPE (query) == GST_QUERY_CONTEXT &&
+      gst_ffmpegviddec_handle_context_query ((GstFFMpegVidDec *) decoder,
+          query))
+    return TRUE;
+
+  return GST_VIDEO_DECODER_CLASS (parent_class)->sink_query (decoder, query);
+}
+
+static gboolean
+gst_ffmpegviddec_has_hw_device (GstFFMpegVidDec * ffmpegdec)
+{
+  gboolean ret;
+
+  GST_OBJECT_LOCK (ffmpegdec);
+  ret = ffmpegdec->hw_device != NULL;
+  GST_OBJECT_UNLOCK (ffmpegdec);
+
+  return ret;
+}
+
+/* Finds a device of the type selected with the hwaccel property, shared by
+ * another element or the application, or creates a new one. Must be called
+ * without the object lock as it runs context queries. */
+static void
+gst_ffmpegviddec_ensure_hw_device (GstFFMpegVidDec * ffmpegdec)
+{
+  GstElement *element = GST_ELEMENT_CAST (ffmpegdec);
+  enum AVHWDeviceType type;
+  AVBufferRef *device = NULL;
+  GstContext *context = NULL;
+  GstQuery *query;
+  gchar *context_type;
+
+  GST_OBJECT_LOCK (ffmpegdec);
+  type = gst_ffmpegviddec_get_hw_device_type (ffmpegdec);
+  ffmpegdec->hw_pix_fmt = gst_ffmpegviddec_get_hw_pix_fmt (ffmpegdec, type);
+
+  if (ffmpegdec->hwaccel && type == AV_HWDEVICE_TYPE_NONE) {
+    GST_WARNING_OBJECT (ffmpegdec, "Unknown hardware device type %s",
+        ffmpegdec->hwaccel);
+  } else if (type != AV_HWDEVICE_TYPE_NONE &&
+      ffmpegdec->hw_pix_fmt == AV_PIX_FMT_NONE) {
+    GST_WARNING_OBJECT (ffmpegdec, "Codec can't be decoded with %s",
+        ffmpegdec->hwaccel);
+  }
+
+  /* the hwaccel property changed since the device was set */
+  if (ffmpegdec->hw_device &&
+      ((AVHWDeviceContext *) ffmpegdec->hw_device->data)->type != type)
+    av_buffer_unref (&ffmpegdec->hw_device);
+
+  if (ffmpegdec->hw_pix_fmt == AV_PIX_FMT_NONE || ffmpegdec->hw_device) {
+    GST_OBJECT_UNLOCK (ffmpegdec);
+    return;
+  }
+  GST_OBJECT_UNLOCK (ffmpegdec);
+
+  context_type = gst_ffmpegviddec_get_hw_context_type (type);
+
+  /* an element up- or downstream might already have a device */
+  query = gst_query_new_context (context_type);
+  if (gst_pad_peer_query (GST_VIDEO_DECODER_SRC_PAD (ffmpegdec), query) ||
+      gst_pad_peer_query (GST_VIDEO_DECODER_SINK_PAD (ffmpegdec), query)) {
+    gst_query_parse_context (query, &context);
+    if (context)
+      gst_element_set_context (element, context);
+  }
+  gst_query_unref (query);
+
+  /* then ask the bins and the application */
+  if (!gst_ffmpegviddec_has_hw_device (ffmpegdec)) {
+    gst_element_post_message (element,
+        gst_message_new_need_context (GST_OBJECT_CAST (element),
+            context_type));
+  }
+
+  if (!gst_ffmpegviddec_has_hw_device (ffmpegdec)) {
+    if (av_hwdevice_ctx_create (&device, type, NULL, NULL, 0) < 0) {
+      GST_WARNING_OBJECT (ffmpegdec, "Failed to create %s device, "
+          "decoding in software", av_hwdevice_get_type_name (type));
+      GST_OBJECT_LOCK (ffmpegdec);
+      ffmpegdec->hw_pix_fmt = AV_PIX_FMT_NONE;
+      GST_OBJECT_UNLOCK (ffmpegdec);
+    } else {
+      context = gst_context_new (context_type, TRUE);
+      gst_structure_set (gst_context_writable_structure (context), "device",
+          GST_TYPE_FFMPEG_HW_DEVICE, device, NULL);
+      av_buffer_unref (&device);
+
+      gst_element_set_context (element, context);
+      gst_element_post_message (element,
+          gst_message_new_have_context (GST_OBJECT_CAST (element), context));
+    }
+  }
+
+  g_free (context_type);
+}
+
+static enum AVPixelFormat
+gst_ffmpegviddec_get_format (AVCodecContext * context,
+    const enum AVPixelFormat *fmts)
+{
+  GstFFMpegVidDec *ffmpegdec = (GstFFMpegVidDec *) context->opaque;
+  const enum AVPixelFormat *fmt;
+
+  for (fmt = fmts; *fmt != AV_PIX_FMT_NONE; fmt++) {
+    if (*fmt == ffmpegdec->hw_pix_fmt)
+      return *fmt;
+  }
+
+  GST_WARNING_OBJECT (ffmpegdec, "Hardware format not available, "
+      "decoding in software");
+
+  return avcodec_default_get_format (context, fmts);
+}
 
 static gboolean
 gst_ffmpegviddec_set_format (GstVideoDecoder * decoder,
@@ -476,6 +819,8 @@ gst_ffmpegviddec_set_format (GstVideoDecoder * decoder,
 
   GST_DEBUG_OBJECT (ffmpegdec, "setcaps called");
 
+  gst_ffmpegviddec_ensure_hw_device (ffmpegdec);
+
   GST_OBJECT_LOCK (ffmpegdec);
 
   /* close old session */
@@ -508,6 +853,13 @@ gst_ffmpegviddec_set_format (GstVideoDecoder * decoder,
   ffmpegdec->context->get_buffer2 = gst_ffmpegviddec_get_buffer2;
   ffmpegdec->context->draw_horiz_band = NULL;
 
+  av_buffer_unref (&ffmpegdec->context->hw_device_ctx);
+  if (ffmpegdec->hw_device && ffmpegdec->hw_pix_fmt != AV_PIX_FMT_NONE) {
+    GST_DEBUG_OBJECT (ffmpegdec, "Decoding with %s", ffmpegdec->hwaccel);
+    ffmpegdec->context->hw_device_ctx = av_buffer_ref (ffmpegdec->hw_device);
+    ffmpegdec->context->get_format = gst_ffmpegviddec_get_format;
+  }
+
   /* reset coded_width/_height to prevent it being reused from last time when
    * the codec is opened again, causing a mismatch and possible
    * segfault/corruption. (Common scenario when renegotiating caps) */
@@ -539,7 +891,29 @@ gst_ffmpegviddec_set_format (GstVideoDecoder * decoder,
 
   /* for slow cpus */
   ffmpegdec->context->lowres = ffmpegdec->lowres;
+
+  /* if downstream scales down to a smaller size anyway, decode at a lower
+   * resolution that is still at least as large as that */
+  if (ffmpegdec->lowres == 0 && oclass->in_plugin->max_lowres > 0 &&
+      ffmpegdec->context->width > 0 && ffmpegdec->context->height > 0) {
+    gint pref_width, pref_height;
+
+    if (gst_video_peer_query_preferred_size (GST_VIDEO_DECODER_SRC_PAD
+            (ffmpegdec), &pref_width, &pref_height)) {
+      gint lowres = 0;
+
+      while (lowres < oclass->in_plugin->max_lowres &&
+          (ffmpegdec->context->width >> (lowres + 1)) >= pref_width &&
+          (ffmpegdec->context->height >> (lowres + 1)) >= pref_height)
+        lowres++;
+
+      GST_DEBUG_OBJECT (ffmpegdec, "downstream prefers %dx%d, using lowres %d",
+          pref_width, pref_height, lowres);
+      ffmpegdec->context->lowres = lowres;
+    }
+  }
   ffmpegdec->context->skip_frame = ffmpegdec->skip_frame;
+  ffmpegdec->context->skip_loop_filter = ffmpegdec->skip_loop_filter;
 
   if (ffmpegdec->thread_type) {
     GST_DEBUG_OBJECT (ffmpegdec, "Use requested thread type 0x%x",
@@ -833,6 +1207,10 @@ gst_ffmpegviddec_can_direct_render (GstFFMpegVidDec * ffmpegdec)
   if (!ffmpegdec->direct_rendering)
     return FALSE;
 
+  /* hardware frames are allocated by libav */
+  if (ffmpegdec->context->hw_device_ctx)
+    return FALSE;
+
   oclass = (GstFFMpegVidDecClass *) (G_OBJECT_GET_CLASS (ffmpegdec));
   return ((oclass->in_plugin->capabilities & AV_CODEC_CAP_DR1) ==
       AV_CODEC_CAP_DR1);
@@ -1650,6 +2028,31 @@ gst_avpacket_init (AVPacket * packet, guint8 * data, guint size)
   packet->size = size;
 }
 
+/* Downloads the hardware frame in picture to system memory. The hardware
+ * frame is kept in hw_picture, as its buffers own the frame data that gets
+ * released when it is freed */
+static gboolean
+gst_ffmpegviddec_download_picture (GstFFMpegVidDec * ffmpegdec)
+{
+  AVFrame *hw_picture = ffmpegdec->picture;
+  gint res;
+
+  av_frame_unref (ffmpegdec->hw_picture);
+  ffmpegdec->picture = ffmpegdec->hw_picture;
+  ffmpegdec->hw_picture = hw_picture;
+
+  res = av_hwframe_transfer_data (ffmpegdec->picture, hw_picture, 0);
+  if (res >= 0)
+    res = av_frame_copy_props (ffmpegdec->picture, hw_picture);
+
+  if (res < 0) {
+    GST_ERROR_OBJECT (ffmpegdec, "Failed to download hardware frame: %d", res);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 /*
  * Returns: whether a frame was decoded
  */
@@ -1688,6 +2091,16 @@ gst_ffmpegviddec_video_frame (GstFFMpegVidDec * ffmpegdec,
     goto beach;
   }
 
+  if (ffmpegdec->picture->format == ffmpegdec->hw_pix_fmt &&
+      !gst_ffmpegviddec_download_picture (ffmpegdec)) {
+    av_frame_unref (ffmpegdec->picture);
+    av_frame_unref (ffmpegdec->hw_picture);
+    GST_ELEMENT_ERROR (ffmpegdec, STREAM, DECODE, (NULL),
+        ("Failed to download hardware frame"));
+    *ret = GST_FLOW_ERROR;
+    goto beach;
+  }
+
   got_frame = TRUE;
 
   /* get the output picture timing info again */
@@ -1846,6 +2259,7 @@ gst_ffmpegviddec_video_frame (GstFFMpegVidDec * ffmpegdec,
   }
 
   av_frame_unref (ffmpegdec->picture);
+  av_frame_unref (ffmpegdec->hw_picture);
 
   if (frame)
     GST_VIDEO_CODEC_FRAME_FLAG_UNSET (frame,
@@ -2342,6 +2756,10 @@ gst_ffmpegviddec_set_property (GObject * object,
       ffmpegdec->skip_frame = ffmpegdec->context->skip_frame =
           g_value_get_enum (value);
       break;
+    case PROP_SKIP_LOOP_FILTER:
+      ffmpegdec->skip_loop_filter = ffmpegdec->context->skip_loop_filter =
+          g_value_get_enum (value);
+      break;
     case PROP_DIRECT_RENDERING:
       ffmpegdec->direct_rendering = g_value_get_boolean (value);
       break;
@@ -2359,6 +2777,12 @@ gst_ffmpegviddec_set_property (GObject * object,
     case PROP_THREAD_TYPE:
       ffmpegdec->thread_type = g_value_get_flags (value);
       break;
+    case PROP_HWACCEL:
+      GST_OBJECT_LOCK (ffmpegdec);
+      g_free (ffmpegdec->hwaccel);
+      ffmpegdec->hwaccel = g_value_dup_string (value);
+      GST_OBJECT_UNLOCK (ffmpegdec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2378,6 +2802,9 @@ gst_ffmpegviddec_get_property (GObject * object,
     case PROP_SKIPFRAME:
       g_value_set_enum (value, ffmpegdec->skip_frame);
       break;
+    case PROP_SKIP_LOOP_FILTER:
+      g_value_set_enum (value, ffmpegdec->skip_loop_filter);
+      break;
     case PROP_DIRECT_RENDERING:
       g_value_set_boolean (value, ffmpegdec->direct_rendering);
       break;
@@ -2395,6 +2822,11 @@ gst_ffmpegviddec_get_property (GObject * object,
     case PROP_THREAD_TYPE:
       g_value_set_flags (value, ffmpegdec->thread_type);
       break;
+    case PROP_HWACCEL:
+      GST_OBJECT_LOCK (ffmpegdec);
+      g_value_set_string (value, ffmpegdec->hwaccel);
+      GST_OBJECT_UNLOCK (ffmpegdec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -64,14 +64,23 @@ struct _GstFFMpegVidDec
 
   /* some properties */
   enum AVDiscard skip_frame;
+  enum AVDiscard skip_loop_filter;
   gint lowres;
   gboolean direct_rendering;
   int max_threads;
   gboolean output_corrupt;
   guint thread_type;
+  gchar *hwaccel;
 
   GstCaps *last_caps;
 
+  /* hardware decoding, hw_device is shared with other elements through a
+   * GstContext. hw_picture holds the hardware frame while the downloaded copy
+   * in picture is used */
+  AVBufferRef *hw_device;
+  enum AVPixelFormat hw_pix_fmt;
+  AVFrame *hw_picture;
+
   /* Internally used for direct rendering */
   GstBufferPool *internal_pool;
   gint pool_width;
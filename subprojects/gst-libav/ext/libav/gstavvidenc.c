@@ -213,6 +213,9 @@ gst_ffmpegvidenc_init (GstFFMpegVidEnc * ffmpegenc)
   ffmpegenc->picture = av_frame_alloc ();
   ffmpegenc->opened = FALSE;
   ffmpegenc->file = NULL;
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT (58, 134, 100)
+  g_mutex_init (&ffmpegenc->packet_pool_lock);
+#endif
 }
 
 static void
@@ -223,6 +226,10 @@ gst_ffmpegvidenc_finalize (GObject * object)
   /* clean up remaining allocated data */
   av_frame_free (&ffmpegenc->picture);
   gst_ffmpeg_avcodec_close (ffmpegenc->context);
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT (58, 134, 100)
+  av_buffer_pool_uninit (&ffmpegenc->packet_pool);
+  g_mutex_clear (&ffmpegenc->packet_pool_lock);
+#endif
   gst_ffmpeg_avcodec_close (ffmpegenc->refcontext);
   av_freep (&ffmpegenc->context);
   av_freep (&ffmpegenc->refcontext);
@@ -230,6 +237,49 @@ gst_ffmpegvidenc_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT (58, 134, 100)
+/* Intra codecs like ProRes or DNxHD produce packets of several MB at high
+ * resolutions, take them from a pool instead of allocating each one. The
+ * pool is sized for the biggest packet seen so far. This is called from the
+ * frame threads of the encoder, so the pool is protected by a lock */
+static int
+gst_ffmpegvidenc_get_encode_buffer (AVCodecContext * context, AVPacket * pkt,
+    int flags)
+{
+  GstFFMpegVidEnc *ffmpegenc = (GstFFMpegVidEnc *) context->opaque;
+  gsize size = pkt->size + AV_INPUT_BUFFER_PADDING_SIZE;
+
+  if (!(context->codec->capabilities & AV_CODEC_CAP_DR1))
+    return avcodec_default_get_encode_buffer (context, pkt, flags);
+
+  g_mutex_lock (&ffmpegenc->packet_pool_lock);
+  if (!ffmpegenc->packet_pool || ffmpegenc->packet_pool_size < size) {
+    /* outstanding packets keep the old pool alive until they are freed */
+    av_buffer_pool_uninit (&ffmpegenc->packet_pool);
+    ffmpegenc->packet_pool_size = size + size / 8;
+    ffmpegenc->packet_pool =
+        av_buffer_pool_init (ffmpegenc->packet_pool_size, NULL);
+    if (!ffmpegenc->packet_pool) {
+      g_mutex_unlock (&ffmpegenc->packet_pool_lock);
+      return AVERROR (ENOMEM);
+    }
+
+    GST_DEBUG_OBJECT (ffmpegenc, "packet pool of %" G_GSIZE_FORMAT " bytes",
+        ffmpegenc->packet_pool_size);
+  }
+
+  pkt->buf = av_buffer_pool_get (ffmpegenc->packet_pool);
+  g_mutex_unlock (&ffmpegenc->packet_pool_lock);
+  if (!pkt->buf)
+    return AVERROR (ENOMEM);
+
+  pkt->data = pkt->buf->data;
+  memset (pkt->data + pkt->size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+
+  return 0;
+}
+#endif
+
 static gboolean
 gst_ffmpegvidenc_set_format (GstVideoEncoder * encoder,
     GstVideoCodecState * state)
@@ -259,6 +309,12 @@ gst_ffmpegvidenc_set_format (GstVideoEncoder * encoder,
   /* additional avcodec settings */
   gst_ffmpeg_cfg_fill_context (G_OBJECT (ffmpegenc), ffmpegenc->context);
 
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT (58, 134, 100)
+  /* encoders without AV_CODEC_CAP_DR1 get the default buffers */
+  ffmpegenc->context->opaque = ffmpegenc;
+  ffmpegenc->context->get_encode_buffer = gst_ffmpegvidenc_get_encode_buffer;
+#endif
+
   if (GST_VIDEO_INFO_IS_INTERLACED (&state->info))
     ffmpegenc->context->flags |=
         AV_CODEC_FLAG_INTERLACED_DCT | AV_CODEC_FLAG_INTERLACED_ME;
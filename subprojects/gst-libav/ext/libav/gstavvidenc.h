@@ -54,6 +54,13 @@ struct _GstFFMpegVidEnc
   guint8 *working_buf;
   gsize working_buf_size;
 
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT (58, 134, 100)
+  /* output packets, protected by packet_pool_lock */
+  GMutex packet_pool_lock;
+  AVBufferPool *packet_pool;
+  gsize packet_pool_size;
+#endif
+
   AVCodecContext *refcontext;
 };
 
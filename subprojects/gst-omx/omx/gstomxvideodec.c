@@ -88,9 +88,11 @@ enum
 {
   PROP_0,
   PROP_INTERNAL_ENTROPY_BUFFERS,
+  PROP_EXTRA_INPUT_BUFFERS,
 };
 
 #define GST_OMX_VIDEO_DEC_INTERNAL_ENTROPY_BUFFERS_DEFAULT (5)
+#define GST_OMX_VIDEO_DEC_EXTRA_INPUT_BUFFERS_DEFAULT (0)
 
 /* class initialization */
 
@@ -106,9 +108,7 @@ static void
 gst_omx_video_dec_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
 {
-#ifdef USE_OMX_TARGET_ZYNQ_USCALE_PLUS
   GstOMXVideoDec *self = GST_OMX_VIDEO_DEC (object);
-#endif
 
   switch (prop_id) {
 #ifdef USE_OMX_TARGET_ZYNQ_USCALE_PLUS
@@ -116,6 +116,9 @@ gst_omx_video_dec_set_property (GObject * object, guint prop_id,
       self->internal_entropy_buffers = g_value_get_uint (value);
       break;
 #endif
+    case PROP_EXTRA_INPUT_BUFFERS:
+      self->extra_input_buffers = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -126,9 +129,7 @@ static void
 gst_omx_video_dec_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec)
 {
-#ifdef USE_OMX_TARGET_ZYNQ_USCALE_PLUS
   GstOMXVideoDec *self = GST_OMX_VIDEO_DEC (object);
-#endif
 
   switch (prop_id) {
 #ifdef USE_OMX_TARGET_ZYNQ_USCALE_PLUS
@@ -136,6 +137,9 @@ gst_omx_video_dec_get_property (GObject * object, guint prop_id,
       g_value_set_uint (value, self->internal_entropy_buffers);
       break;
 #endif
+    case PROP_EXTRA_INPUT_BUFFERS:
+      g_value_set_uint (value, self->extra_input_buffers);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -164,6 +168,24 @@ gst_omx_video_dec_class_init (GstOMXVideoDecClass * klass)
           GST_PARAM_MUTABLE_READY));
 #endif
 
+  /**
+   * GstOMXVideoDec:extra-input-buffers:
+   *
+   * Number of input buffers to allocate on top of the minimum required by
+   * the component. More buffers let several frames be queued while the
+   * component is busy decoding, so feeding doesn't wait for each buffer to
+   * be returned.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_EXTRA_INPUT_BUFFERS,
+      g_param_spec_uint ("extra-input-buffers", "Extra input buffers",
+          "Number of input buffers to allocate on top of the minimum required "
+          "by the component (0 = component default)",
+          0, 32, GST_OMX_VIDEO_DEC_EXTRA_INPUT_BUFFERS_DEFAULT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   element_class->change_state =
       GST_DEBUG_FUNCPTR (gst_omx_video_dec_change_state);
 
@@ -201,6 +223,7 @@ static void
 gst_omx_video_dec_init (GstOMXVideoDec * self)
 {
   self->dmabuf = FALSE;
+  self->extra_input_buffers = GST_OMX_VIDEO_DEC_EXTRA_INPUT_BUFFERS_DEFAULT;
 
 #ifdef USE_OMX_TARGET_ZYNQ_USCALE_PLUS
   self->internal_entropy_buffers =
@@ -2511,8 +2534,12 @@ gst_omx_video_dec_ensure_nb_in_buffers (GstOMXVideoDec * self)
 {
   GstOMXVideoDecClass *klass = GST_OMX_VIDEO_DEC_GET_CLASS (self);
 
-  if ((klass->cdata.hacks & GST_OMX_HACK_ENSURE_BUFFER_COUNT_ACTUAL)) {
-    if (!gst_omx_port_ensure_buffer_count_actual (self->dec_in_port, 0))
+  /* extra buffers were explicitly asked for, so set the count even if the
+   * component doesn't need the hack */
+  if ((klass->cdata.hacks & GST_OMX_HACK_ENSURE_BUFFER_COUNT_ACTUAL) ||
+      self->extra_input_buffers > 0) {
+    if (!gst_omx_port_ensure_buffer_count_actual (self->dec_in_port,
+            self->extra_input_buffers))
       return FALSE;
   }
 
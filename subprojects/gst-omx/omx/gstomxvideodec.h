@@ -100,6 +100,7 @@ struct _GstOMXVideoDec
 #ifdef USE_OMX_TARGET_ZYNQ_USCALE_PLUS
   guint32 internal_entropy_buffers;
 #endif
+  guint32 extra_input_buffers;
 };
 
 struct _GstOMXVideoDecClass
@@ -283,6 +283,7 @@ enum
   PROP_LONGTERM_REF,
   PROP_LONGTERM_FREQUENCY,
   PROP_LOOK_AHEAD,
+  PROP_EXTRA_INPUT_BUFFERS,
 };
 
 /* FIXME: Better defaults */
@@ -310,6 +311,7 @@ enum
 #define GST_OMX_VIDEO_ENC_LONGTERM_REF_DEFAULT (FALSE)
 #define GST_OMX_VIDEO_ENC_LONGTERM_FREQUENCY_DEFAULT (0)
 #define GST_OMX_VIDEO_ENC_LOOK_AHEAD_DEFAULT (0)
+#define GST_OMX_VIDEO_ENC_EXTRA_INPUT_BUFFERS_DEFAULT (0)
 
 /* ZYNQ_USCALE_PLUS encoder custom events */
 #define OMX_ALG_GST_EVENT_INSERT_LONGTERM "omx-alg/insert-longterm"
@@ -374,6 +376,24 @@ gst_omx_video_enc_class_init (GstOMXVideoEncClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
 
+  /**
+   * GstOMXVideoEnc:extra-input-buffers:
+   *
+   * Number of input buffers to allocate on top of the minimum required by
+   * the component. More buffers let several frames be queued while the
+   * component is busy, so feeding doesn't wait for each buffer to be
+   * returned.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_EXTRA_INPUT_BUFFERS,
+      g_param_spec_uint ("extra-input-buffers", "Extra input buffers",
+          "Number of input buffers to allocate on top of the minimum required "
+          "by the component (0 = component default)",
+          0, 32, GST_OMX_VIDEO_ENC_EXTRA_INPUT_BUFFERS_DEFAULT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
 #ifdef USE_OMX_TARGET_ZYNQ_USCALE_PLUS
   g_object_class_install_property (gobject_class, PROP_QP_MODE,
       g_param_spec_enum ("qp-mode", "QP mode",
@@ -559,6 +579,7 @@ gst_omx_video_enc_init (GstOMXVideoEnc * self)
   self->quant_i_frames = GST_OMX_VIDEO_ENC_QUANT_I_FRAMES_DEFAULT;
   self->quant_p_frames = GST_OMX_VIDEO_ENC_QUANT_P_FRAMES_DEFAULT;
   self->quant_b_frames = GST_OMX_VIDEO_ENC_QUANT_B_FRAMES_DEFAULT;
+  self->extra_input_buffers = GST_OMX_VIDEO_ENC_EXTRA_INPUT_BUFFERS_DEFAULT;
 #ifdef USE_OMX_TARGET_ZYNQ_USCALE_PLUS
   self->qp_mode = GST_OMX_VIDEO_ENC_QP_MODE_DEFAULT;
   self->min_qp = GST_OMX_VIDEO_ENC_MIN_QP_DEFAULT;
@@ -1163,6 +1184,9 @@ gst_omx_video_enc_set_property (GObject * object, guint prop_id,
     case PROP_QUANT_B_FRAMES:
       self->quant_b_frames = g_value_get_uint (value);
       break;
+    case PROP_EXTRA_INPUT_BUFFERS:
+      self->extra_input_buffers = g_value_get_uint (value);
+      break;
 #ifdef USE_OMX_TARGET_ZYNQ_USCALE_PLUS
     case PROP_QP_MODE:
       self->qp_mode = g_value_get_enum (value);
@@ -1252,6 +1276,9 @@ gst_omx_video_enc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_QUANT_B_FRAMES:
       g_value_set_uint (value, self->quant_b_frames);
       break;
+    case PROP_EXTRA_INPUT_BUFFERS:
+      g_value_set_uint (value, self->extra_input_buffers);
+      break;
 #ifdef USE_OMX_TARGET_ZYNQ_USCALE_PLUS
     case PROP_QP_MODE:
       g_value_set_enum (value, self->qp_mode);
@@ -2094,8 +2121,12 @@ gst_omx_video_enc_ensure_nb_in_buffers (GstOMXVideoEnc * self)
 {
   GstOMXVideoEncClass *klass = GST_OMX_VIDEO_ENC_GET_CLASS (self);
 
-  if ((klass->cdata.hacks & GST_OMX_HACK_ENSURE_BUFFER_COUNT_ACTUAL)) {
-    if (!gst_omx_port_ensure_buffer_count_actual (self->enc_in_port, 0))
+  /* extra buffers were explicitly asked for, so set the count even if the
+   * component doesn't need the hack */
+  if ((klass->cdata.hacks & GST_OMX_HACK_ENSURE_BUFFER_COUNT_ACTUAL) ||
+      self->extra_input_buffers > 0) {
+    if (!gst_omx_port_ensure_buffer_count_actual (self->enc_in_port,
+            self->extra_input_buffers))
       return FALSE;
   }
 
@@ -47,7 +47,8 @@ static void gst_mpdparser_parse_url_type_node (GstMPDURLTypeNode ** pointer,
     xmlNode * a_node);
 static void gst_mpdparser_parse_seg_base_type_ext (GstMPDSegmentBaseNode **
     pointer, xmlNode * a_node, GstMPDSegmentBaseNode * parent);
-static void gst_mpdparser_parse_s_node (GQueue * queue, xmlNode * a_node);
+static void gst_mpdparser_parse_s_node (GQueue * queue, xmlNode * a_node,
+    guint64 * next_t);
 static void gst_mpdparser_parse_segment_timeline_node (GstMPDSegmentTimelineNode
     ** pointer, xmlNode * a_node);
 static gboolean
@@ -318,17 +319,39 @@ gst_mpdparser_parse_seg_base_type_ext (GstMPDSegmentBaseNode ** pointer,
 
 
 static void
-gst_mpdparser_parse_s_node (GQueue * queue, xmlNode * a_node)
+gst_mpdparser_parse_s_node (GQueue * queue, xmlNode * a_node,
+    guint64 * next_t)
 {
-  GstMPDSNode *new_s_node;
+  GstMPDSNode *new_s_node, *last_s_node;
+  guint64 t, d;
+  gint r;
+
+  GST_LOG ("attributes of S node:");
+  gst_xml_helper_get_prop_unsigned_integer_64 (a_node, "t", 0, &t);
+  gst_xml_helper_get_prop_unsigned_integer_64 (a_node, "d", 0, &d);
+  gst_xml_helper_get_prop_signed_integer (a_node, "r", 0, &r);
+
+  /* An S entry continuing the previous one with the same duration is folded
+   * into its repeat count. Live timelines often list every segment on its own,
+   * this avoids allocating one node per segment on each manifest update */
+  last_s_node = g_queue_peek_tail (queue);
+  if (last_s_node && last_s_node->r >= 0 && r >= 0 && d > 0
+      && d == last_s_node->d && (t == 0 || t == *next_t)
+      && last_s_node->r < G_MAXINT - r) {
+    last_s_node->r += r + 1;
+    *next_t += d * (r + 1);
+    return;
+  }
 
   new_s_node = gst_mpd_s_node_new ();
+  new_s_node->t = t;
+  new_s_node->d = d;
+  new_s_node->r = r;
   g_queue_push_tail (queue, new_s_node);
 
-  GST_LOG ("attributes of S node:");
-  gst_xml_helper_get_prop_unsigned_integer_64 (a_node, "t", 0, &new_s_node->t);
-  gst_xml_helper_get_prop_unsigned_integer_64 (a_node, "d", 0, &new_s_node->d);
-  gst_xml_helper_get_prop_signed_integer (a_node, "r", 0, &new_s_node->r);
+  if (t > 0)
+    *next_t = t;
+  *next_t += d * (r >= 0 ? r + 1 : 1);
 }
 
 
@@ -339,6 +362,7 @@ gst_mpdparser_parse_segment_timeline_node (GstMPDSegmentTimelineNode ** pointer,
 {
   xmlNode *cur_node;
   GstMPDSegmentTimelineNode *new_seg_timeline;
+  guint64 next_t = 0;
 
   gst_mpd_segment_timeline_node_free (*pointer);
   *pointer = new_seg_timeline = gst_mpd_segment_timeline_node_new ();
@@ -351,7 +375,8 @@ gst_mpdparser_parse_segment_timeline_node (GstMPDSegmentTimelineNode ** pointer,
   for (cur_node = a_node->children; cur_node; cur_node = cur_node->next) {
     if (cur_node->type == XML_ELEMENT_NODE) {
       if (xmlStrcmp (cur_node->name, (xmlChar *) "S") == 0) {
-        gst_mpdparser_parse_s_node (&new_seg_timeline->S, cur_node);
+        gst_mpdparser_parse_s_node (&new_seg_timeline->S, cur_node,
+            &next_t);
       }
     }
   }
@@ -46,6 +46,7 @@
 #endif
 
 #include <openssl/bn.h>
+#include <openssl/ec.h>
 #include <openssl/rsa.h>
 #include <openssl/ssl.h>
 
@@ -187,11 +188,95 @@ static const gchar base64_alphabet[64] = {
   '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
 };
 
+static RSA *
+generate_rsa_key (void)
+{
+  RSA *rsa;
+
+  /* XXX: RSA_generate_key is actually deprecated in 0.9.8 */
+#if OPENSSL_VERSION_NUMBER < 0x10100001L
+  rsa = RSA_generate_key (2048, RSA_F4, NULL, NULL);
+#else
+  rsa = RSA_new ();
+  if (rsa != NULL) {
+    BIGNUM *e = BN_new ();
+    if (e == NULL || !BN_set_word (e, RSA_F4)
+        || !RSA_generate_key_ex (rsa, 2048, e, NULL)) {
+      RSA_free (rsa);
+      rsa = NULL;
+    }
+    if (e)
+      BN_free (e);
+  }
+#endif
+
+  return rsa;
+}
+
+static EC_KEY *
+generate_ec_key (void)
+{
+  EC_KEY *ec_key;
+
+  ec_key = EC_KEY_new_by_curve_name (NID_X9_62_prime256v1);
+  if (!ec_key)
+    return NULL;
+
+  /* Encode the curve by name, which is what peers expect */
+  EC_KEY_set_asn1_flag (ec_key, OPENSSL_EC_NAMED_CURVE);
+
+  if (!EC_KEY_generate_key (ec_key)) {
+    EC_KEY_free (ec_key);
+    return NULL;
+  }
+
+  return ec_key;
+}
+
+/* ECDSA P-256 keys are generated by default, which is orders of magnitude
+ * faster than generating a 2048 bit RSA key and is what browsers use for
+ * their WebRTC certificates. GST_DTLS_CERTIFICATE_KEY_TYPE=rsa restores the
+ * previous behaviour for peers that only accept RSA. */
+static gboolean
+assign_generated_key (GstDtlsCertificate * self, EVP_PKEY * private_key)
+{
+  const gchar *key_type = g_getenv ("GST_DTLS_CERTIFICATE_KEY_TYPE");
+
+  if (key_type && g_ascii_strcasecmp (key_type, "rsa") == 0) {
+    RSA *rsa = generate_rsa_key ();
+
+    if (!rsa) {
+      GST_WARNING_OBJECT (self, "failed to generate RSA");
+      return FALSE;
+    }
+
+    if (!EVP_PKEY_assign_RSA (private_key, rsa)) {
+      GST_WARNING_OBJECT (self, "failed to assign RSA");
+      RSA_free (rsa);
+      return FALSE;
+    }
+  } else {
+    EC_KEY *ec_key = generate_ec_key ();
+
+    if (!ec_key) {
+      GST_WARNING_OBJECT (self, "failed to generate EC key");
+      return FALSE;
+    }
+
+    if (!EVP_PKEY_assign_EC_KEY (private_key, ec_key)) {
+      GST_WARNING_OBJECT (self, "failed to assign EC key");
+      EC_KEY_free (ec_key);
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
 static void
 init_generated (GstDtlsCertificate * self)
 {
   GstDtlsCertificatePrivate *priv = self->priv;
-  RSA *rsa;
   BIGNUM *serial_number;
   ASN1_INTEGER *asn1_serial_number;
   X509_NAME *name = NULL;
@@ -217,43 +302,13 @@ init_generated (GstDtlsCertificate * self)
     return;
   }
 
-  /* XXX: RSA_generate_key is actually deprecated in 0.9.8 */
-#if OPENSSL_VERSION_NUMBER < 0x10100001L
-  rsa = RSA_generate_key (2048, RSA_F4, NULL, NULL);
-#else
-  rsa = RSA_new ();
-  if (rsa != NULL) {
-    BIGNUM *e = BN_new ();
-    if (e == NULL || !BN_set_word (e, RSA_F4)
-        || !RSA_generate_key_ex (rsa, 2048, e, NULL)) {
-      RSA_free (rsa);
-      rsa = NULL;
-    }
-    if (e)
-      BN_free (e);
-  }
-#endif
-
-  if (!rsa) {
-    GST_WARNING_OBJECT (self, "failed to generate RSA");
-    EVP_PKEY_free (priv->private_key);
-    priv->private_key = NULL;
-    X509_free (priv->x509);
-    priv->x509 = NULL;
-    return;
-  }
-
-  if (!EVP_PKEY_assign_RSA (priv->private_key, rsa)) {
-    GST_WARNING_OBJECT (self, "failed to assign RSA");
-    RSA_free (rsa);
-    rsa = NULL;
+  if (!assign_generated_key (self, priv->private_key)) {
     EVP_PKEY_free (priv->private_key);
     priv->private_key = NULL;
     X509_free (priv->x509);
     priv->x509 = NULL;
     return;
   }
-  rsa = NULL;
 
   X509_set_version (priv->x509, 2);
 
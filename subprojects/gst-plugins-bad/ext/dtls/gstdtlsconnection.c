@@ -70,6 +70,7 @@ enum
   PROP_0,
   PROP_AGENT,
   PROP_CONNECTION_STATE,
+  PROP_HANDSHAKE_DURATION,
   NUM_PROPERTIES
 };
 
@@ -105,6 +106,10 @@ struct _GstDtlsConnectionPrivate
 
   gboolean timeout_pending;
   GThreadPool *thread_pool;
+
+  /* monotonic time in microseconds */
+  gint64 handshake_start;
+  GstClockTime handshake_duration;
 };
 
 G_DEFINE_TYPE_WITH_CODE (GstDtlsConnection, gst_dtls_connection, G_TYPE_OBJECT,
@@ -174,6 +179,13 @@ gst_dtls_connection_class_init (GstDtlsConnectionClass * klass)
       GST_DTLS_TYPE_CONNECTION_STATE,
       GST_DTLS_CONNECTION_STATE_NEW, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  properties[PROP_HANDSHAKE_DURATION] =
+      g_param_spec_uint64 ("handshake-duration",
+      "Handshake Duration",
+      "Time the last completed handshake took in nanoseconds",
+      0, G_MAXUINT64, GST_CLOCK_TIME_NONE,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, NUM_PROPERTIES, properties);
 
   _gst_dtls_init_openssl ();
@@ -208,6 +220,8 @@ gst_dtls_connection_init (GstDtlsConnection * self)
   priv->thread_pool = g_thread_pool_new (handle_timeout, self, 1, FALSE, NULL);
   g_assert (priv->thread_pool);
   priv->timeout_pending = FALSE;
+
+  priv->handshake_duration = GST_CLOCK_TIME_NONE;
 }
 
 static void
@@ -316,6 +330,11 @@ gst_dtls_connection_get_property (GObject * object, guint prop_id,
       g_value_set_enum (value, priv->connection_state);
       g_mutex_unlock (&priv->mutex);
       break;
+    case PROP_HANDSHAKE_DURATION:
+      g_mutex_lock (&priv->mutex);
+      g_value_set_uint64 (value, priv->handshake_duration);
+      g_mutex_unlock (&priv->mutex);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (self, prop_id, pspec);
   }
@@ -348,6 +367,9 @@ gst_dtls_connection_start (GstDtlsConnection * self, gboolean is_client,
   priv->sent_close_notify = FALSE;
   priv->received_close_notify = FALSE;
 
+  priv->handshake_start = g_get_monotonic_time ();
+  priv->handshake_duration = GST_CLOCK_TIME_NONE;
+
   /* Client immediately starts connecting, the server waits for a client to
    * start the handshake process */
   priv->is_client = is_client;
@@ -667,6 +689,7 @@ gst_dtls_connection_process (GstDtlsConnection * self, gpointer data, gsize len,
   if (!priv->is_client) {
     if (self->priv->connection_state == GST_DTLS_CONNECTION_STATE_NEW) {
       priv->connection_state = GST_DTLS_CONNECTION_STATE_CONNECTING;
+      priv->handshake_start = g_get_monotonic_time ();
       notify_state = TRUE;
     }
   }
@@ -1065,6 +1088,11 @@ openssl_poll (GstDtlsConnection * self, gboolean * notify_state, GError ** err)
             && self->priv->connection_state !=
             GST_DTLS_CONNECTION_STATE_CONNECTED) {
           self->priv->connection_state = GST_DTLS_CONNECTION_STATE_CONNECTED;
+          self->priv->handshake_duration =
+              (g_get_monotonic_time () -
+              self->priv->handshake_start) * GST_USECOND;
+          GST_INFO_OBJECT (self, "handshake took %" GST_TIME_FORMAT,
+              GST_TIME_ARGS (self->priv->handshake_duration));
           *notify_state = TRUE;
         }
       } else {
@@ -70,6 +70,7 @@ enum
   PROP_SRTP_CIPHER,
   PROP_SRTP_AUTH,
   PROP_CONNECTION_STATE,
+  PROP_HANDSHAKE_DURATION,
   NUM_PROPERTIES
 };
 
@@ -139,6 +140,16 @@ gst_dtls_dec_class_init (GstDtlsDecClass * klass)
       "Every encoder/decoder pair should have the same, unique, connection-id",
       DEFAULT_CONNECTION_ID, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GstDtlsDec:pem:
+   *
+   * A string containing a X509 certificate and private key in PEM format.
+   *
+   * If none is set, a self-signed certificate is generated once per process
+   * and shared by all elements. Since 1.22 its key is an ECDSA P-256 key,
+   * setting the `GST_DTLS_CERTIFICATE_KEY_TYPE` environment variable to `rsa`
+   * generates a 2048 bit RSA key instead.
+   */
   properties[PROP_PEM] =
       g_param_spec_string ("pem",
       "PEM string",
@@ -181,6 +192,22 @@ gst_dtls_dec_class_init (GstDtlsDecClass * klass)
       GST_DTLS_TYPE_CONNECTION_STATE,
       GST_DTLS_CONNECTION_STATE_NEW, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GstDtlsDec:handshake-duration:
+   *
+   * The time the last completed DTLS handshake took, from the start of the
+   * handshake until the keys were available, or %GST_CLOCK_TIME_NONE if no
+   * handshake completed yet.
+   *
+   * Since: 1.22
+   */
+  properties[PROP_HANDSHAKE_DURATION] =
+      g_param_spec_uint64 ("handshake-duration",
+      "Handshake Duration",
+      "Time the last completed handshake took in nanoseconds",
+      0, G_MAXUINT64, GST_CLOCK_TIME_NONE,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, NUM_PROPERTIES, properties);
 
   gst_element_class_add_static_pad_template (element_class, &src_template);
@@ -318,6 +345,13 @@ gst_dtls_dec_get_property (GObject * object, guint prop_id, GValue * value,
       else
         g_value_set_enum (value, GST_DTLS_CONNECTION_STATE_CLOSED);
       break;
+    case PROP_HANDSHAKE_DURATION:
+      if (self->connection)
+        g_object_get_property (G_OBJECT (self->connection),
+            "handshake-duration", value);
+      else
+        g_value_set_uint64 (value, GST_CLOCK_TIME_NONE);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (self, prop_id, pspec);
   }
@@ -34,6 +34,13 @@
  * Just point an external webserver to the directory with the playlist and
  * fragment files.
  *
+ * When #GstHlsSink2:part-duration is set, a Low-Latency HLS playlist is
+ * produced: every fragment is advertised as a sequence of partial segments
+ * (byte ranges of the fragment file) while it is still being written, and
+ * the #GstHlsSink2::get-playlist action signal allows an application's HTTP
+ * layer to serve the playlist from memory, including blocking playlist
+ * reloads.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 videotestsrc is-live=true ! x264enc ! h264parse ! hlssink2 max-files=5
@@ -62,8 +69,11 @@ GST_DEBUG_CATEGORY_STATIC (gst_hls_sink2_debug);
 #define DEFAULT_TARGET_DURATION 15
 #define DEFAULT_PLAYLIST_LENGTH 5
 #define DEFAULT_SEND_KEYFRAME_REQUESTS TRUE
+#define DEFAULT_PART_DURATION 0
 
 #define GST_M3U8_PLAYLIST_VERSION 3
+/* Byte range parts and preload hints need a newer playlist version */
+#define GST_M3U8_PLAYLIST_VERSION_LOW_LATENCY 6
 
 enum
 {
@@ -75,6 +85,7 @@ enum
   PROP_TARGET_DURATION,
   PROP_PLAYLIST_LENGTH,
   PROP_SEND_KEYFRAME_REQUESTS,
+  PROP_PART_DURATION,
 };
 
 enum
@@ -82,6 +93,7 @@ enum
   SIGNAL_GET_PLAYLIST_STREAM,
   SIGNAL_GET_FRAGMENT_STREAM,
   SIGNAL_DELETE_FRAGMENT,
+  SIGNAL_GET_PLAYLIST,
   SIGNAL_LAST
 };
 
@@ -110,6 +122,7 @@ static void gst_hls_sink2_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * spec);
 static void gst_hls_sink2_handle_message (GstBin * bin, GstMessage * message);
 static void gst_hls_sink2_reset (GstHlsSink2 * sink);
+static void gst_hls_sink2_write_playlist (GstHlsSink2 * sink);
 static GstStateChangeReturn
 gst_hls_sink2_change_state (GstElement * element, GstStateChange trans);
 static GstPad *gst_hls_sink2_request_new_pad (GstElement * element,
@@ -133,8 +146,11 @@ gst_hls_sink2_finalize (GObject * object)
   g_free (sink->playlist_location);
   g_free (sink->playlist_root);
   g_free (sink->current_location);
+  g_free (sink->playlist_content);
   if (sink->playlist)
     gst_m3u8_playlist_free (sink->playlist);
+  g_mutex_clear (&sink->playlist_lock);
+  g_cond_clear (&sink->playlist_cond);
 
   g_queue_foreach (&sink->old_locations, (GFunc) g_free, NULL);
   g_queue_clear (&sink->old_locations);
@@ -187,6 +203,42 @@ gst_hls_sink2_get_fragment_stream (GstHlsSink2 * sink, const gchar * location)
   return ostream;
 }
 
+/* Called with playlist_lock */
+static gboolean
+gst_hls_sink2_has_part (GstHlsSink2 * sink, gint msn, gint part)
+{
+  if ((guint) msn < sink->index)
+    return TRUE;
+
+  return (guint) msn == sink->index && part >= 0
+      && (guint) part < sink->n_parts;
+}
+
+static gchar *
+gst_hls_sink2_get_playlist (GstHlsSink2 * sink, gint msn, gint part)
+{
+  gchar *playlist;
+  gint64 end_time;
+
+  g_mutex_lock (&sink->playlist_lock);
+  /* Blocking reloads wait at most three target durations */
+  end_time = g_get_monotonic_time () +
+      3 * MAX (sink->target_duration, 1) * G_TIME_SPAN_SECOND;
+  while (msn >= 0 && !sink->playlist_flushing &&
+      !gst_hls_sink2_has_part (sink, msn, part)) {
+    if (!g_cond_wait_until (&sink->playlist_cond, &sink->playlist_lock,
+            end_time)) {
+      GST_DEBUG_OBJECT (sink, "Timeout waiting for segment %d part %d", msn,
+          part);
+      break;
+    }
+  }
+  playlist = g_strdup (sink->playlist_content);
+  g_mutex_unlock (&sink->playlist_lock);
+
+  return playlist;
+}
+
 static void
 gst_hls_sink2_class_init (GstHlsSink2Class * klass)
 {
@@ -257,6 +309,23 @@ gst_hls_sink2_class_init (GstHlsSink2Class * klass)
           DEFAULT_SEND_KEYFRAME_REQUESTS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstHlsSink2:part-duration:
+   *
+   * Target duration in milliseconds of the Low-Latency HLS partial segments.
+   * Every fragment is advertised as byte ranges of roughly this duration
+   * while it is being written. 0 disables Low-Latency HLS.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_PART_DURATION,
+      g_param_spec_uint ("part-duration", "Part duration",
+          "The target duration in milliseconds of a Low-Latency HLS partial "
+          "segment (0 - disabled)",
+          0, G_MAXUINT, DEFAULT_PART_DURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   /**
    * GstHlsSink2::get-playlist-stream:
    * @sink: the #GstHlsSink2
@@ -302,8 +371,133 @@ gst_hls_sink2_class_init (GstHlsSink2Class * klass)
       g_signal_new ("delete-fragment", G_TYPE_FROM_CLASS (klass),
       G_SIGNAL_RUN_LAST, 0, NULL, NULL, NULL, G_TYPE_NONE, 1, G_TYPE_STRING);
 
+  /**
+   * GstHlsSink2::get-playlist:
+   * @sink: the #GstHlsSink2
+   * @msn: media sequence number to wait for, or -1
+   * @part: part index within @msn to wait for, or -1
+   *
+   * Returns the current playlist from memory, for serving it from an
+   * application provided HTTP server. If @msn is not -1, this blocks until
+   * the playlist contains the segment @msn (or its part @part if not -1), as
+   * requested by the _HLS_msn and _HLS_part parameters of a blocking
+   * playlist reload, or until three target durations have passed.
+   *
+   * Returns: (transfer full) (nullable): the playlist, or %NULL if nothing
+   * was written yet.
+   *
+   * Since: 1.22
+   */
+  signals[SIGNAL_GET_PLAYLIST] =
+      g_signal_new ("get-playlist", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstHlsSink2Class, get_playlist), NULL, NULL, NULL,
+      G_TYPE_STRING, 2, G_TYPE_INT, G_TYPE_INT);
+
   klass->get_playlist_stream = gst_hls_sink2_get_playlist_stream;
   klass->get_fragment_stream = gst_hls_sink2_get_fragment_stream;
+  klass->get_playlist = gst_hls_sink2_get_playlist;
+}
+
+static gchar *
+gst_hls_sink2_entry_location (GstHlsSink2 * sink)
+{
+  gchar *name, *entry_location;
+
+  name = g_path_get_basename (sink->current_location);
+  if (sink->playlist_root == NULL)
+    return name;
+
+  entry_location = g_build_filename (sink->playlist_root, name, NULL);
+  g_free (name);
+
+  return entry_location;
+}
+
+/* Called with playlist_lock, adds the bytes written since the last part
+ * boundary as a new part of the current fragment */
+static gboolean
+gst_hls_sink2_close_part (GstHlsSink2 * sink)
+{
+  gchar *entry_location;
+
+  if (!GST_CLOCK_TIME_IS_VALID (sink->part_start) || !sink->current_location
+      || sink->segment_bytes == sink->part_offset)
+    return FALSE;
+
+  entry_location = gst_hls_sink2_entry_location (sink);
+  gst_m3u8_playlist_add_part (sink->playlist, entry_location,
+      sink->part_end - sink->part_start, sink->part_offset,
+      sink->segment_bytes - sink->part_offset, sink->part_independent);
+  gst_m3u8_playlist_set_preload_hint (sink->playlist, entry_location,
+      sink->segment_bytes);
+  g_free (entry_location);
+
+  sink->part_offset = sink->segment_bytes;
+  sink->part_start = GST_CLOCK_TIME_NONE;
+  sink->n_parts++;
+
+  return TRUE;
+}
+
+/* Called with playlist_lock */
+static gboolean
+gst_hls_sink2_account_buffer (GstHlsSink2 * sink, GstBuffer * buffer)
+{
+  GstClockTime ts = GST_BUFFER_DTS_OR_PTS (buffer);
+  gboolean part_done = FALSE;
+
+  if (GST_CLOCK_TIME_IS_VALID (ts)) {
+    if (GST_CLOCK_TIME_IS_VALID (sink->part_start) &&
+        ts >= sink->part_start + sink->part_duration) {
+      sink->part_end = ts;
+      part_done = gst_hls_sink2_close_part (sink);
+    }
+
+    if (!GST_CLOCK_TIME_IS_VALID (sink->part_start)) {
+      sink->part_start = ts;
+      sink->part_end = ts;
+      sink->part_independent =
+          !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+    }
+
+    if (GST_BUFFER_DURATION_IS_VALID (buffer))
+      ts += GST_BUFFER_DURATION (buffer);
+    sink->part_end = MAX (sink->part_end, ts);
+  }
+
+  sink->segment_bytes += gst_buffer_get_size (buffer);
+
+  return part_done;
+}
+
+static GstPadProbeReturn
+on_fragment_data (GstPad * pad, GstPadProbeInfo * info, GstHlsSink2 * sink)
+{
+  gboolean part_done = FALSE;
+
+  if (sink->part_duration == 0)
+    return GST_PAD_PROBE_OK;
+
+  g_mutex_lock (&sink->playlist_lock);
+  if (info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+    part_done =
+        gst_hls_sink2_account_buffer (sink, GST_PAD_PROBE_INFO_BUFFER (info));
+  } else {
+    GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST (info);
+    guint i, len = gst_buffer_list_length (list);
+
+    for (i = 0; i < len; i++) {
+      part_done |=
+          gst_hls_sink2_account_buffer (sink, gst_buffer_list_get (list, i));
+    }
+  }
+  g_mutex_unlock (&sink->playlist_lock);
+
+  if (part_done)
+    gst_hls_sink2_write_playlist (sink);
+
+  return GST_PAD_PROBE_OK;
 }
 
 static gchar *
@@ -325,6 +519,15 @@ on_format_location (GstElement * splitmuxsink, guint fragment_id,
   } else {
     g_free (sink->current_location);
     sink->current_location = g_steal_pointer (&location);
+
+    if (sink->part_duration > 0) {
+      gchar *entry_location = gst_hls_sink2_entry_location (sink);
+
+      g_mutex_lock (&sink->playlist_lock);
+      gst_m3u8_playlist_set_preload_hint (sink->playlist, entry_location, 0);
+      g_mutex_unlock (&sink->playlist_lock);
+      g_free (entry_location);
+    }
   }
   g_object_set (sink->giostreamsink, "stream", stream, NULL);
 
@@ -340,6 +543,7 @@ static void
 gst_hls_sink2_init (GstHlsSink2 * sink)
 {
   GstElement *mux;
+  GstPad *pad;
 
   sink->location = g_strdup (DEFAULT_LOCATION);
   sink->playlist_location = g_strdup (DEFAULT_PLAYLIST_LOCATION);
@@ -348,13 +552,23 @@ gst_hls_sink2_init (GstHlsSink2 * sink)
   sink->max_files = DEFAULT_MAX_FILES;
   sink->target_duration = DEFAULT_TARGET_DURATION;
   sink->send_keyframe_requests = DEFAULT_SEND_KEYFRAME_REQUESTS;
+  sink->part_duration = DEFAULT_PART_DURATION;
   g_queue_init (&sink->old_locations);
+  g_mutex_init (&sink->playlist_lock);
+  g_cond_init (&sink->playlist_cond);
 
   sink->splitmuxsink = gst_element_factory_make ("splitmuxsink", NULL);
   gst_bin_add (GST_BIN (sink), sink->splitmuxsink);
 
   sink->giostreamsink = gst_element_factory_make ("giostreamsink", NULL);
 
+  /* Track the bytes written to the fragments for low-latency parts */
+  pad = gst_element_get_static_pad (sink->giostreamsink, "sink");
+  gst_pad_add_probe (pad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) on_fragment_data, sink, NULL);
+  gst_object_unref (pad);
+
   mux = gst_element_factory_make ("mpegtsmux", NULL);
   g_object_set (sink->splitmuxsink, "location", NULL, "max-size-time",
       ((GstClockTime) sink->target_duration * GST_SECOND),
@@ -369,15 +583,35 @@ gst_hls_sink2_init (GstHlsSink2 * sink)
   gst_hls_sink2_reset (sink);
 }
 
+static void
+gst_hls_sink2_reset_part (GstHlsSink2 * sink)
+{
+  sink->segment_bytes = 0;
+  sink->part_offset = 0;
+  sink->part_start = GST_CLOCK_TIME_NONE;
+  sink->part_end = GST_CLOCK_TIME_NONE;
+  sink->part_independent = FALSE;
+  sink->n_parts = 0;
+}
+
 static void
 gst_hls_sink2_reset (GstHlsSink2 * sink)
 {
+  g_mutex_lock (&sink->playlist_lock);
   sink->index = 0;
 
   if (sink->playlist)
     gst_m3u8_playlist_free (sink->playlist);
   sink->playlist =
-      gst_m3u8_playlist_new (GST_M3U8_PLAYLIST_VERSION, sink->playlist_length);
+      gst_m3u8_playlist_new (sink->part_duration > 0 ?
+      GST_M3U8_PLAYLIST_VERSION_LOW_LATENCY : GST_M3U8_PLAYLIST_VERSION,
+      sink->playlist_length);
+  sink->playlist->part_target = sink->part_duration;
+
+  g_free (sink->playlist_content);
+  sink->playlist_content = NULL;
+  gst_hls_sink2_reset_part (sink);
+  g_mutex_unlock (&sink->playlist_lock);
 
   g_queue_foreach (&sink->old_locations, (GFunc) g_free, NULL);
   g_queue_clear (&sink->old_locations);
@@ -402,7 +636,15 @@ gst_hls_sink2_write_playlist (GstHlsSink2 * sink)
     return;
   }
 
-  playlist_content = gst_m3u8_playlist_render (sink->playlist);
+  /* Keep the rendered playlist around for get-playlist and wake up
+   * blocking reloads */
+  g_mutex_lock (&sink->playlist_lock);
+  g_free (sink->playlist_content);
+  sink->playlist_content = gst_m3u8_playlist_render (sink->playlist);
+  playlist_content = g_strdup (sink->playlist_content);
+  g_cond_broadcast (&sink->playlist_cond);
+  g_mutex_unlock (&sink->playlist_lock);
+
   bytes_to_write = strlen (playlist_content);
   if (!g_output_stream_write_all (stream, playlist_content, bytes_to_write,
           NULL, NULL, &error)) {
@@ -443,17 +685,18 @@ gst_hls_sink2_handle_message (GstBin * bin, GstMessage * message)
           gst_structure_get_clock_time (s, "running-time", &running_time);
 
           GST_INFO_OBJECT (sink, "COUNT %d", sink->index);
-          if (sink->playlist_root == NULL) {
-            entry_location = g_path_get_basename (sink->current_location);
-          } else {
-            gchar *name = g_path_get_basename (sink->current_location);
-            entry_location = g_build_filename (sink->playlist_root, name, NULL);
-            g_free (name);
-          }
+          entry_location = gst_hls_sink2_entry_location (sink);
 
+          g_mutex_lock (&sink->playlist_lock);
+          if (sink->part_duration > 0) {
+            gst_hls_sink2_close_part (sink);
+            gst_m3u8_playlist_set_preload_hint (sink->playlist, NULL, 0);
+          }
           gst_m3u8_playlist_add_entry (sink->playlist, entry_location,
               NULL, running_time - sink->current_running_time_start,
               sink->index++, FALSE);
+          gst_hls_sink2_reset_part (sink);
+          g_mutex_unlock (&sink->playlist_lock);
           g_free (entry_location);
 
           gst_hls_sink2_write_playlist (sink);
@@ -495,7 +738,9 @@ gst_hls_sink2_handle_message (GstBin * bin, GstMessage * message)
       break;
     }
     case GST_MESSAGE_EOS:{
+      g_mutex_lock (&sink->playlist_lock);
       sink->playlist->end_list = TRUE;
+      g_mutex_unlock (&sink->playlist_lock);
       gst_hls_sink2_write_playlist (sink);
       sink->state |= GST_M3U8_PLAYLIST_RENDER_ENDED;
       break;
@@ -580,6 +825,20 @@ gst_hls_sink2_change_state (GstElement * element, GstStateChange trans)
         return GST_STATE_CHANGE_FAILURE;
       }
       break;
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      g_mutex_lock (&sink->playlist_lock);
+      sink->playlist_flushing = FALSE;
+      g_mutex_unlock (&sink->playlist_lock);
+      /* part-duration might have changed since the last reset */
+      gst_hls_sink2_reset (sink);
+      break;
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      /* wake up blocking playlist reloads */
+      g_mutex_lock (&sink->playlist_lock);
+      sink->playlist_flushing = TRUE;
+      g_cond_broadcast (&sink->playlist_cond);
+      g_mutex_unlock (&sink->playlist_lock);
+      break;
     default:
       break;
   }
@@ -593,7 +852,9 @@ gst_hls_sink2_change_state (GstElement * element, GstStateChange trans)
       /* drain playlist with #EXT-X-ENDLIST */
       if (sink->playlist && (sink->state & GST_M3U8_PLAYLIST_RENDER_STARTED) &&
           !(sink->state & GST_M3U8_PLAYLIST_RENDER_ENDED)) {
+        g_mutex_lock (&sink->playlist_lock);
         sink->playlist->end_list = TRUE;
+        g_mutex_unlock (&sink->playlist_lock);
         gst_hls_sink2_write_playlist (sink);
       }
       /* fall-through */
@@ -640,7 +901,9 @@ gst_hls_sink2_set_property (GObject * object, guint prop_id,
       break;
     case PROP_PLAYLIST_LENGTH:
       sink->playlist_length = g_value_get_uint (value);
+      g_mutex_lock (&sink->playlist_lock);
       sink->playlist->window_size = sink->playlist_length;
+      g_mutex_unlock (&sink->playlist_lock);
       break;
     case PROP_SEND_KEYFRAME_REQUESTS:
       sink->send_keyframe_requests = g_value_get_boolean (value);
@@ -649,6 +912,9 @@ gst_hls_sink2_set_property (GObject * object, guint prop_id,
             sink->send_keyframe_requests, NULL);
       }
       break;
+    case PROP_PART_DURATION:
+      sink->part_duration = g_value_get_uint (value) * GST_MSECOND;
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -683,6 +949,9 @@ gst_hls_sink2_get_property (GObject * object, guint prop_id,
     case PROP_SEND_KEYFRAME_REQUESTS:
       g_value_set_boolean (value, sink->send_keyframe_requests);
       break;
+    case PROP_PART_DURATION:
+      g_value_set_uint (value, sink->part_duration / GST_MSECOND);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -50,10 +50,25 @@ struct _GstHlsSink2
   gint max_files;
   gint target_duration;
   gboolean send_keyframe_requests;
+  GstClockTime part_duration;
 
   GstM3U8Playlist *playlist;
   guint index;
 
+  /* protects the playlist and the rendered playlist_content */
+  GMutex playlist_lock;
+  GCond playlist_cond;
+  gchar *playlist_content;
+  gboolean playlist_flushing;
+
+  /* Low-latency HLS part tracking, only used from the streaming thread */
+  guint64 segment_bytes;
+  guint64 part_offset;
+  GstClockTime part_start;
+  GstClockTime part_end;
+  gboolean part_independent;
+  guint n_parts;
+
   gchar *current_location;
   GstClockTime current_running_time_start;
   GQueue old_locations;
@@ -66,6 +81,9 @@ struct _GstHlsSink2Class
 
   GOutputStream * (*get_playlist_stream) (GstHlsSink2 * sink, const gchar * location);
   GOutputStream * (*get_fragment_stream) (GstHlsSink2 * sink, const gchar * location);
+
+  /* actions */
+  gchar * (*get_playlist) (GstHlsSink2 * sink, gint msn, gint part);
 };
 
 GType gst_hls_sink2_get_type (void);
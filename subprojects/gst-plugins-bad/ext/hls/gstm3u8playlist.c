@@ -32,7 +32,11 @@ enum
   GST_M3U8_PLAYLIST_TYPE_VOD,
 };
 
+/* Number of trailing segments for which the parts are still advertised */
+#define GST_M3U8_PLAYLIST_PART_SEGMENTS 3
+
 typedef struct _GstM3U8Entry GstM3U8Entry;
+typedef struct _GstM3U8Part GstM3U8Part;
 
 struct _GstM3U8Entry
 {
@@ -40,8 +44,45 @@ struct _GstM3U8Entry
   gchar *title;
   gchar *url;
   gboolean discontinuous;
+
+  /* rendered EXTINF and URI lines, the entry never changes once added */
+  gchar *rendered;
+  /* parts the entry was made of, for low-latency playlists */
+  GQueue parts;
 };
 
+struct _GstM3U8Part
+{
+  gfloat duration;
+  /* rendered EXT-X-PART line */
+  gchar *rendered;
+};
+
+static GstM3U8Part *
+gst_m3u8_part_new (const gchar * url, gfloat duration, guint64 offset,
+    guint64 size, gboolean independent)
+{
+  GstM3U8Part *part;
+  gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  part = g_new0 (GstM3U8Part, 1);
+  part->duration = duration;
+  part->rendered =
+      g_strdup_printf ("#EXT-X-PART:DURATION=%s,URI=\"%s\",BYTERANGE=%"
+      G_GUINT64_FORMAT "@%" G_GUINT64_FORMAT "%s\n",
+      g_ascii_dtostr (buf, sizeof (buf), duration / GST_SECOND), url, size,
+      offset, independent ? ",INDEPENDENT=YES" : "");
+
+  return part;
+}
+
+static void
+gst_m3u8_part_free (GstM3U8Part * part)
+{
+  g_free (part->rendered);
+  g_free (part);
+}
+
 static GstM3U8Entry *
 gst_m3u8_entry_new (const gchar * url, const gchar * title,
     gfloat duration, gboolean discontinuous)
@@ -55,14 +96,42 @@ gst_m3u8_entry_new (const gchar * url, const gchar * title,
   entry->title = g_strdup (title);
   entry->duration = duration;
   entry->discontinuous = discontinuous;
+  g_queue_init (&entry->parts);
   return entry;
 }
 
+static void
+gst_m3u8_entry_render (GstM3U8Entry * entry, guint version)
+{
+  GString *str = g_string_new (NULL);
+  gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  if (entry->discontinuous)
+    g_string_append (str, "#EXT-X-DISCONTINUITY\n");
+
+  if (version < 3) {
+    g_string_append_printf (str, "#EXTINF:%d,%s\n",
+        (gint) ((entry->duration + 500 * GST_MSECOND) / GST_SECOND),
+        entry->title ? entry->title : "");
+  } else {
+    g_string_append_printf (str, "#EXTINF:%s,%s\n",
+        g_ascii_dtostr (buf, sizeof (buf), entry->duration / GST_SECOND),
+        entry->title ? entry->title : "");
+  }
+
+  g_string_append_printf (str, "%s\n", entry->url);
+
+  entry->rendered = g_string_free (str, FALSE);
+}
+
 static void
 gst_m3u8_entry_free (GstM3U8Entry * entry)
 {
   g_return_if_fail (entry != NULL);
 
+  g_queue_foreach (&entry->parts, (GFunc) gst_m3u8_part_free, NULL);
+  g_queue_clear (&entry->parts);
+  g_free (entry->rendered);
   g_free (entry->url);
   g_free (entry->title);
   g_free (entry);
@@ -79,6 +148,7 @@ gst_m3u8_playlist_new (guint version, guint window_size)
   playlist->type = GST_M3U8_PLAYLIST_TYPE_EVENT;
   playlist->end_list = FALSE;
   playlist->entries = g_queue_new ();
+  playlist->parts = g_queue_new ();
 
   return playlist;
 }
@@ -90,6 +160,8 @@ gst_m3u8_playlist_free (GstM3U8Playlist * playlist)
 
   g_queue_foreach (playlist->entries, (GFunc) gst_m3u8_entry_free, NULL);
   g_queue_free (playlist->entries);
+  g_queue_free_full (playlist->parts, (GDestroyNotify) gst_m3u8_part_free);
+  g_free (playlist->preload_hint);
   g_free (playlist);
 }
 
@@ -108,6 +180,11 @@ gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
     return FALSE;
 
   entry = gst_m3u8_entry_new (url, title, duration, discontinuous);
+  gst_m3u8_entry_render (entry, playlist->version);
+
+  /* The parts written so far make up the new entry */
+  while (!g_queue_is_empty (playlist->parts))
+    g_queue_push_tail (&entry->parts, g_queue_pop_head (playlist->parts));
 
   if (playlist->window_size > 0) {
     /* Delete old entries from the playlist */
@@ -125,6 +202,40 @@ gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
   return TRUE;
 }
 
+/* Adds a part of the segment currently being written, as a byte range of
+ * that segment. Parts are moved to the segment entry once it is complete. */
+gboolean
+gst_m3u8_playlist_add_part (GstM3U8Playlist * playlist, const gchar * url,
+    gfloat duration, guint64 offset, guint64 size, gboolean independent)
+{
+  g_return_val_if_fail (playlist != NULL, FALSE);
+  g_return_val_if_fail (url != NULL, FALSE);
+
+  if (playlist->type == GST_M3U8_PLAYLIST_TYPE_VOD)
+    return FALSE;
+
+  g_queue_push_tail (playlist->parts,
+      gst_m3u8_part_new (url, duration, offset, size, independent));
+
+  return TRUE;
+}
+
+void
+gst_m3u8_playlist_set_preload_hint (GstM3U8Playlist * playlist,
+    const gchar * url, guint64 offset)
+{
+  g_return_if_fail (playlist != NULL);
+
+  g_free (playlist->preload_hint);
+  playlist->preload_hint = NULL;
+
+  if (url) {
+    playlist->preload_hint =
+        g_strdup_printf ("#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"%s\","
+        "BYTERANGE-START=%" G_GUINT64_FORMAT "\n", url, offset);
+  }
+}
+
 static guint
 gst_m3u8_playlist_target_duration (GstM3U8Playlist * playlist)
 {
@@ -146,6 +257,7 @@ gst_m3u8_playlist_render (GstM3U8Playlist * playlist)
 {
   GString *playlist_str;
   GList *l;
+  guint i;
 
   g_return_val_if_fail (playlist != NULL, NULL);
 
@@ -154,6 +266,18 @@ gst_m3u8_playlist_render (GstM3U8Playlist * playlist)
   g_string_append_printf (playlist_str, "#EXT-X-VERSION:%d\n",
       playlist->version);
 
+  if (playlist->part_target > 0) {
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+    g_string_append_printf (playlist_str,
+        "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=%s\n",
+        g_ascii_dtostr (buf, sizeof (buf),
+            (gdouble) (3 * playlist->part_target) / GST_SECOND));
+    g_string_append_printf (playlist_str, "#EXT-X-PART-INF:PART-TARGET=%s\n",
+        g_ascii_dtostr (buf, sizeof (buf),
+            (gdouble) playlist->part_target / GST_SECOND));
+  }
+
   g_string_append_printf (playlist_str, "#EXT-X-MEDIA-SEQUENCE:%d\n",
       playlist->sequence_number - playlist->entries->length);
 
@@ -161,25 +285,28 @@ gst_m3u8_playlist_render (GstM3U8Playlist * playlist)
       gst_m3u8_playlist_target_duration (playlist));
   g_string_append (playlist_str, "\n");
 
-  /* Entries */
-  for (l = playlist->entries->head; l != NULL; l = l->next) {
-    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+  /* Entries, rendered once when they were added */
+  for (l = playlist->entries->head, i = 0; l != NULL; l = l->next, i++) {
     GstM3U8Entry *entry = l->data;
 
-    if (entry->discontinuous)
-      g_string_append (playlist_str, "#EXT-X-DISCONTINUITY\n");
-
-    if (playlist->version < 3) {
-      g_string_append_printf (playlist_str, "#EXTINF:%d,%s\n",
-          (gint) ((entry->duration + 500 * GST_MSECOND) / GST_SECOND),
-          entry->title ? entry->title : "");
-    } else {
-      g_string_append_printf (playlist_str, "#EXTINF:%s,%s\n",
-          g_ascii_dtostr (buf, sizeof (buf), entry->duration / GST_SECOND),
-          entry->title ? entry->title : "");
+    if (playlist->part_target > 0 &&
+        i + GST_M3U8_PLAYLIST_PART_SEGMENTS >= playlist->entries->length) {
+      GList *p;
+
+      for (p = entry->parts.head; p != NULL; p = p->next)
+        g_string_append (playlist_str, ((GstM3U8Part *) p->data)->rendered);
     }
 
-    g_string_append_printf (playlist_str, "%s\n", entry->url);
+    g_string_append (playlist_str, entry->rendered);
+  }
+
+  /* Parts of the segment being written */
+  if (playlist->part_target > 0 && !playlist->end_list) {
+    for (l = playlist->parts->head; l != NULL; l = l->next)
+      g_string_append (playlist_str, ((GstM3U8Part *) l->data)->rendered);
+
+    if (playlist->preload_hint)
+      g_string_append (playlist_str, playlist->preload_hint);
   }
 
   if (playlist->end_list)
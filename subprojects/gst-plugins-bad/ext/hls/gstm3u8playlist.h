@@ -23,6 +23,7 @@
 #define __GST_M3U8_PLAYLIST_H__
 
 #include <glib.h>
+#include <gst/gst.h>
 
 G_BEGIN_DECLS
 
@@ -36,8 +37,14 @@ struct _GstM3U8Playlist
   gboolean end_list;
   guint sequence_number;
 
+  /* Low-latency HLS part target duration, 0 if disabled */
+  GstClockTime part_target;
+
   /*< Private >*/
   GQueue *entries;
+  /* parts of the segment that is still being written */
+  GQueue *parts;
+  gchar *preload_hint;
 };
 
 typedef enum
@@ -60,6 +67,17 @@ gboolean          gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
                                                guint             index,
                                                gboolean          discontinuous);
 
+gboolean          gst_m3u8_playlist_add_part (GstM3U8Playlist * playlist,
+                                              const gchar     * url,
+                                              gfloat            duration,
+                                              guint64           offset,
+                                              guint64           size,
+                                              gboolean          independent);
+
+void              gst_m3u8_playlist_set_preload_hint (GstM3U8Playlist * playlist,
+                                                      const gchar     * url,
+                                                      guint64           offset);
+
 gchar *           gst_m3u8_playlist_render (GstM3U8Playlist * playlist);
 
 G_END_DECLS
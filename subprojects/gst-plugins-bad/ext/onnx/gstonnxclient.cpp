@@ -29,9 +29,12 @@
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <map>
+#include <mutex>
 #include <numeric>
 #include <cmath>
 #include <sstream>
+#include <tuple>
 
 namespace GstOnnxNamespace
 {
@@ -73,7 +76,7 @@ GstOnnxClient::GstOnnxClient ():session (nullptr),
 
 GstOnnxClient::~GstOnnxClient ()
 {
-    delete session;
+    session.reset ();
     delete[]dest;
 }
 
@@ -85,6 +88,51 @@ Ort::Env & GstOnnxClient::getEnv (void)
     return env;
 }
 
+/* Sessions are shared by all the clients using the same model with the same
+ * settings, so the model weights are only loaded once per process. Running
+ * a session from several threads at the same time is supported by
+ * onnxruntime. */
+std::shared_ptr < Ort::Session > GstOnnxClient::getSharedSession (std::string
+      modelFile, GraphOptimizationLevel optim,
+      GstOnnxExecutionProvider provider)
+{
+    typedef std::tuple < std::string, GraphOptimizationLevel,
+        GstOnnxExecutionProvider > SessionKey;
+    static std::mutex lock;
+    static std::map < SessionKey, std::weak_ptr < Ort::Session > > sessions;
+
+    std::lock_guard < std::mutex > guard (lock);
+    SessionKey key (modelFile, optim, provider);
+    auto shared = sessions[key].lock ();
+    if (shared) {
+      GST_DEBUG ("Sharing session for model %s", modelFile.c_str ());
+      return shared;
+    }
+
+    Ort::SessionOptions sessionOptions;
+    // for debugging
+    //sessionOptions.SetIntraOpNumThreads (1);
+    sessionOptions.SetGraphOptimizationLevel (optim);
+    switch (provider) {
+      case GST_ONNX_EXECUTION_PROVIDER_CUDA:
+#ifdef GST_ML_ONNX_RUNTIME_HAVE_CUDA
+        Ort::ThrowOnError (OrtSessionOptionsAppendExecutionProvider_CUDA
+            (sessionOptions, 0));
+#else
+        return nullptr;
+#endif
+        break;
+      default:
+        break;
+
+    };
+    shared = std::make_shared < Ort::Session > (getEnv (), modelFile.c_str (),
+        sessionOptions);
+    sessions[key] = shared;
+
+    return shared;
+}
+
 int32_t GstOnnxClient::getWidth (void)
 {
     return width;
@@ -191,25 +239,11 @@ bool GstOnnxClient::createSession (std::string modelFile,
         break;
     };
 
-    Ort::SessionOptions sessionOptions;
-    // for debugging
-    //sessionOptions.SetIntraOpNumThreads (1);
-    sessionOptions.SetGraphOptimizationLevel (onnx_optim);
     m_provider = provider;
-    switch (m_provider) {
-      case GST_ONNX_EXECUTION_PROVIDER_CUDA:
-#ifdef GST_ML_ONNX_RUNTIME_HAVE_CUDA
-        Ort::ThrowOnError (OrtSessionOptionsAppendExecutionProvider_CUDA
-            (sessionOptions, 0));
-#else
-        return false;
-#endif
-        break;
-      default:
-        break;
+    session = getSharedSession (modelFile, onnx_optim, m_provider);
+    if (!session)
+      return false;
 
-    };
-    session = new Ort::Session (getEnv (), modelFile.c_str (), sessionOptions);
     auto inputTypeInfo = session->GetInputTypeInfo (0);
     std::vector < int64_t > inputDims =
         inputTypeInfo.GetTensorTypeAndShapeInfo ().GetShape ();
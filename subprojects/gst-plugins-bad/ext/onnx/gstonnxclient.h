@@ -26,6 +26,7 @@
 #include <onnxruntime_cxx_api.h>
 #include <gst/video/video.h>
 #include "gstonnxelement.h"
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -96,7 +97,9 @@ namespace GstOnnxNamespace {
             float scoreThreshold);
     std::vector < std::string > ReadLabels(const std::string & labelsFile);
     Ort::Env & getEnv(void);
-    Ort::Session * session;
+    std::shared_ptr < Ort::Session > getSharedSession(std::string modelFile,
+        GraphOptimizationLevel optim, GstOnnxExecutionProvider provider);
+    std::shared_ptr < Ort::Session > session;
     int32_t width;
     int32_t height;
     int32_t channels;
@@ -145,6 +145,8 @@ static GstPad *gst_sctp_enc_request_new_pad (GstElement * element,
     GstPadTemplate * template, const gchar * name, const GstCaps * caps);
 static void gst_sctp_enc_release_pad (GstElement * element, GstPad * pad);
 static void gst_sctp_enc_srcpad_loop (GstPad * pad);
+static GstFlowReturn gst_sctp_enc_sink_chain_list (GstPad * pad,
+    GstObject * parent, GstBufferList * list);
 static GstFlowReturn gst_sctp_enc_sink_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buffer);
 static gboolean gst_sctp_enc_sink_event (GstPad * pad, GstObject * parent,
@@ -427,6 +429,8 @@ gst_sctp_enc_request_new_pad (GstElement * element, GstPadTemplate * template,
       template->direction, "template", template, NULL);
   gst_pad_set_chain_function (new_pad,
       GST_DEBUG_FUNCPTR (gst_sctp_enc_sink_chain));
+  gst_pad_set_chain_list_function (new_pad,
+      GST_DEBUG_FUNCPTR (gst_sctp_enc_sink_chain_list));
   gst_pad_set_event_function (new_pad,
       GST_DEBUG_FUNCPTR (gst_sctp_enc_sink_event));
 
@@ -521,12 +525,36 @@ gst_sctp_enc_srcpad_loop (GstPad * pad)
 
   if (gst_data_queue_pop (self->outbound_sctp_packet_queue, &item)) {
     GstBuffer *buffer = GST_BUFFER (item->object);
+    GstBufferList *list = NULL;
 
-    GST_DEBUG_OBJECT (self, "Forwarding buffer %" GST_PTR_FORMAT, buffer);
-
-    flow_ret = gst_pad_push (self->src_pad, buffer);
     item->object = NULL;
 
+    /* Forward all packets that usrsctp produced since the last wakeup in one
+     * go, e.g. when a buffer list was sent on a sink pad */
+    while (!gst_data_queue_is_empty (self->outbound_sctp_packet_queue)) {
+      GstDataQueueItem *next;
+
+      if (!gst_data_queue_pop (self->outbound_sctp_packet_queue, &next))
+        break;
+
+      if (!list) {
+        list = gst_buffer_list_new ();
+        gst_buffer_list_add (list, buffer);
+      }
+      gst_buffer_list_add (list, GST_BUFFER (next->object));
+      next->object = NULL;
+      next->destroy (next);
+    }
+
+    if (list) {
+      GST_DEBUG_OBJECT (self, "Forwarding %u buffers",
+          gst_buffer_list_length (list));
+      flow_ret = gst_pad_push_list (self->src_pad, list);
+    } else {
+      GST_DEBUG_OBJECT (self, "Forwarding buffer %" GST_PTR_FORMAT, buffer);
+      flow_ret = gst_pad_push (self->src_pad, buffer);
+    }
+
     GST_OBJECT_LOCK (self);
     self->src_ret = flow_ret;
     GST_OBJECT_UNLOCK (self);
@@ -559,10 +587,27 @@ gst_sctp_enc_srcpad_loop (GstPad * pad)
 }
 
 static GstFlowReturn
-gst_sctp_enc_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+gst_sctp_enc_check_src_ret (GstSctpEnc * self, GstPad * pad)
 {
-  GstSctpEnc *self = GST_SCTP_ENC (parent);
-  GstSctpEncPad *sctpenc_pad = GST_SCTP_ENC_PAD (pad);
+  GstFlowReturn flow_ret = GST_FLOW_OK;
+
+  GST_OBJECT_LOCK (self);
+  if (self->src_ret != GST_FLOW_OK) {
+    GST_ERROR_OBJECT (pad, "Pushing on source pad failed before: %s",
+        gst_flow_get_name (self->src_ret));
+    flow_ret = self->src_ret;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  return flow_ret;
+}
+
+/* Does not take ownership of @buffer */
+static GstFlowReturn
+gst_sctp_enc_send_buffer (GstSctpEnc * self, GstSctpEncPad * sctpenc_pad,
+    GstBuffer * buffer)
+{
+  GstPad *pad = GST_PAD (sctpenc_pad);
   GstMapInfo map;
   guint32 ppid;
   gboolean ordered;
@@ -575,17 +620,6 @@ gst_sctp_enc_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   const guint8 *data;
   guint32 length;
 
-  GST_OBJECT_LOCK (self);
-  if (self->src_ret != GST_FLOW_OK) {
-    GST_ERROR_OBJECT (pad, "Pushing on source pad failed before: %s",
-        gst_flow_get_name (self->src_ret));
-    flow_ret = self->src_ret;
-    GST_OBJECT_UNLOCK (self);
-    gst_buffer_unref (buffer);
-    return flow_ret;
-  }
-  GST_OBJECT_UNLOCK (self);
-
   ppid = sctpenc_pad->ppid;
   ordered = sctpenc_pad->ordered;
   pr = sctpenc_pad->reliability;
@@ -623,7 +657,7 @@ gst_sctp_enc_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 
   if (!gst_buffer_map (buffer, &map, GST_MAP_READ)) {
     GST_ERROR_OBJECT (pad, "Could not map GstBuffer");
-    goto error;
+    return GST_FLOW_ERROR;
   }
 
   data = map.data;
@@ -679,11 +713,46 @@ out:
   g_mutex_unlock (&sctpenc_pad->lock);
 
   gst_buffer_unmap (buffer, &map);
-error:
+  return flow_ret;
+}
+
+static GstFlowReturn
+gst_sctp_enc_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GstSctpEnc *self = GST_SCTP_ENC (parent);
+  GstFlowReturn flow_ret;
+
+  flow_ret = gst_sctp_enc_check_src_ret (self, pad);
+  if (flow_ret == GST_FLOW_OK)
+    flow_ret = gst_sctp_enc_send_buffer (self, GST_SCTP_ENC_PAD (pad), buffer);
+
   gst_buffer_unref (buffer);
   return flow_ret;
 }
 
+/* Hands all messages of @list to the association back to back, which lets
+ * usrsctp bundle their DATA chunks whenever they can't be sent out right
+ * away, and the resulting packets are forwarded as one list */
+static GstFlowReturn
+gst_sctp_enc_sink_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstSctpEnc *self = GST_SCTP_ENC (parent);
+  GstFlowReturn flow_ret;
+  guint i, len;
+
+  flow_ret = gst_sctp_enc_check_src_ret (self, pad);
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len && flow_ret == GST_FLOW_OK; i++) {
+    flow_ret = gst_sctp_enc_send_buffer (self, GST_SCTP_ENC_PAD (pad),
+        gst_buffer_list_get (list, i));
+  }
+
+  gst_buffer_list_unref (list);
+  return flow_ret;
+}
+
 static gboolean
 gst_sctp_enc_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
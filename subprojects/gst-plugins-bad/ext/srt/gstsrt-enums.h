@@ -62,6 +62,23 @@ typedef enum
   GST_SRT_KEY_LENGTH_32 = 32,
 } GstSRTKeyLength;
 
+/**
+ * GstSRTCallerOverflow:
+ * @GST_SRT_CALLER_OVERFLOW_DROP_OLDEST: drop the oldest queued buffer
+ * @GST_SRT_CALLER_OVERFLOW_DROP_NEWEST: drop the buffer being queued
+ * @GST_SRT_CALLER_OVERFLOW_DISCONNECT: disconnect the caller
+ *
+ * What to do when the send queue of a caller is full.
+ *
+ * Since: 1.22
+ */
+typedef enum
+{
+  GST_SRT_CALLER_OVERFLOW_DROP_OLDEST = 0,
+  GST_SRT_CALLER_OVERFLOW_DROP_NEWEST,
+  GST_SRT_CALLER_OVERFLOW_DISCONNECT,
+} GstSRTCallerOverflow;
+
 G_END_DECLS
 
 #endif // __GST_SRT_ENUM_H__
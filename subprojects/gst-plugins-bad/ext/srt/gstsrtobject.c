@@ -71,15 +71,29 @@ enum
   PROP_WAIT_FOR_CONNECTION,
   PROP_STREAMID,
   PROP_AUTHENTICATION,
+  PROP_CALLER_QUEUE_SIZE,
+  PROP_CALLER_OVERFLOW,
+  PROP_AGGREGATE_LATENCY,
   PROP_LAST
 };
 
+/* Maximum number of sockets reported by one wakeup of the dispatch thread,
+ * and how long it waits for writable sockets before checking for shutdown */
+#define DISPATCH_MAX_SOCKETS 64
+#define DISPATCH_POLL_TIMEOUT 100
+
 typedef struct
 {
   SRTSOCKET sock;
   gint poll_id;
   GSocketAddress *sockaddr;
   gboolean sent_headers;
+
+  /* Messages waiting to be sent by the dispatch thread (GBytes) */
+  GQueue queue;
+  gsize queue_offset;
+  gboolean queue_pending;
+  guint64 queue_dropped;
 } SRTCaller;
 
 static GstStructure *gst_srt_object_accumulate_stats (GstSRTObject * srtobject,
@@ -92,6 +106,7 @@ srt_caller_new (void)
   caller->sock = SRT_INVALID_SOCK;
   caller->poll_id = SRT_ERROR;
   caller->sent_headers = FALSE;
+  g_queue_init (&caller->queue);
 
   return caller;
 }
@@ -99,10 +114,15 @@ srt_caller_new (void)
 static void
 srt_caller_free (SRTCaller * caller)
 {
+  GBytes *bytes;
+
   g_return_if_fail (caller != NULL);
 
   g_clear_object (&caller->sockaddr);
 
+  while ((bytes = g_queue_pop_head (&caller->queue)))
+    g_bytes_unref (bytes);
+
   if (caller->sock != SRT_INVALID_SOCK) {
     srt_close (caller->sock);
   }
@@ -130,6 +150,19 @@ srt_caller_signal_removed (SRTCaller * caller, GstSRTObject * srtobject)
       caller->sockaddr);
 }
 
+/* called with sock_lock */
+static void
+gst_srt_object_remove_caller (GstSRTObject * srtobject, SRTCaller * caller)
+{
+  srtobject->callers = g_list_remove (srtobject->callers, caller);
+
+  if (caller->queue_pending)
+    srtobject->dispatch_pending--;
+
+  srt_caller_signal_removed (caller, srtobject);
+  srt_caller_free (caller);
+}
+
 struct srt_constant_params
 {
   const gchar *name;
@@ -366,8 +399,15 @@ gst_srt_object_new (GstElement * element)
   srtobject->listener_poll_id = SRT_ERROR;
   srtobject->sent_headers = FALSE;
   srtobject->wait_for_connection = GST_SRT_DEFAULT_WAIT_FOR_CONNECTION;
+  srtobject->dispatch_poll_id = SRT_ERROR;
+  srtobject->caller_queue_size = GST_SRT_DEFAULT_CALLER_QUEUE_SIZE;
+  srtobject->caller_overflow = GST_SRT_DEFAULT_CALLER_OVERFLOW;
+  srtobject->aggregate_latency = GST_SRT_DEFAULT_AGGREGATE_LATENCY;
+  srtobject->read_sock = SRT_INVALID_SOCK;
+  srtobject->read_poll_id = SRT_ERROR;
 
   g_cond_init (&srtobject->sock_cond);
+  g_cond_init (&srtobject->dispatch_cond);
   return srtobject;
 }
 
@@ -382,6 +422,7 @@ gst_srt_object_destroy (GstSRTObject * srtobject)
   }
 
   g_cond_clear (&srtobject->sock_cond);
+  g_cond_clear (&srtobject->dispatch_cond);
 
   GST_DEBUG_OBJECT (srtobject->element, "Destroying srtobject");
   gst_structure_free (srtobject->parameters);
@@ -437,6 +478,15 @@ gst_srt_object_set_property_helper (GstSRTObject * srtobject,
     case PROP_AUTHENTICATION:
       srtobject->authentication = g_value_get_boolean (value);
       break;
+    case PROP_CALLER_QUEUE_SIZE:
+      srtobject->caller_queue_size = g_value_get_uint (value);
+      break;
+    case PROP_CALLER_OVERFLOW:
+      srtobject->caller_overflow = g_value_get_enum (value);
+      break;
+    case PROP_AGGREGATE_LATENCY:
+      srtobject->aggregate_latency = g_value_get_uint (value);
+      break;
     default:
       goto err;
   }
@@ -544,6 +594,21 @@ gst_srt_object_get_property_helper (GstSRTObject * srtobject,
     case PROP_AUTHENTICATION:
       g_value_set_boolean (value, srtobject->authentication);
       break;
+    case PROP_CALLER_QUEUE_SIZE:
+      GST_OBJECT_LOCK (srtobject->element);
+      g_value_set_uint (value, srtobject->caller_queue_size);
+      GST_OBJECT_UNLOCK (srtobject->element);
+      break;
+    case PROP_CALLER_OVERFLOW:
+      GST_OBJECT_LOCK (srtobject->element);
+      g_value_set_enum (value, srtobject->caller_overflow);
+      GST_OBJECT_UNLOCK (srtobject->element);
+      break;
+    case PROP_AGGREGATE_LATENCY:
+      GST_OBJECT_LOCK (srtobject->element);
+      g_value_set_uint (value, srtobject->aggregate_latency);
+      GST_OBJECT_UNLOCK (srtobject->element);
+      break;
     default:
       return FALSE;
   }
@@ -704,6 +769,59 @@ gst_srt_object_install_properties_helper (GObjectClass * gobject_class)
           "Authentication",
           "Authenticate a connection",
           FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstSRTSink:caller-queue-size:
+   *
+   * Maximum number of buffers queued per caller in listener mode. If not 0,
+   * `srtsink` hands the buffers to a dispatch thread that sends them to all
+   * callers as their sockets become writable, so a slow caller does not
+   * delay the streaming thread or the other callers. If 0, buffers are sent
+   * to each caller from the streaming thread.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_CALLER_QUEUE_SIZE,
+      g_param_spec_uint ("caller-queue-size", "Caller queue size",
+          "Maximum number of buffers queued per caller in listener mode "
+          "(0 = send from the streaming thread)", 0, G_MAXUINT,
+          GST_SRT_DEFAULT_CALLER_QUEUE_SIZE,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstSRTSink:caller-overflow:
+   *
+   * What to do when the queue of a caller is full, see
+   * #GstSRTSink:caller-queue-size.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_CALLER_OVERFLOW,
+      g_param_spec_enum ("caller-overflow", "Caller overflow",
+          "What to do when the queue of a caller is full",
+          GST_TYPE_SRT_CALLER_OVERFLOW, GST_SRT_DEFAULT_CALLER_OVERFLOW,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+  gst_type_mark_as_plugin_api (GST_TYPE_SRT_CALLER_OVERFLOW, 0);
+
+  /**
+   * GstSRTSrc:aggregate-latency:
+   *
+   * If not 0, `srtsrc` collects further SRT messages into the same output
+   * buffer, up to #GstBaseSrc:blocksize bytes, as long as they arrive within
+   * this many milliseconds of the first one. This reduces the number of
+   * buffers pushed downstream at high bitrates, at the cost of added latency.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_AGGREGATE_LATENCY,
+      g_param_spec_uint ("aggregate-latency", "Aggregate latency",
+          "Maximum time to wait for further messages to aggregate into one "
+          "buffer (milliseconds, 0 = one message per buffer)", 0, G_MAXINT32,
+          GST_SRT_DEFAULT_AGGREGATE_LATENCY,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -985,6 +1103,12 @@ thread_func (gpointer data)
           caller->sock);
 
       g_mutex_lock (&srtobject->sock_lock);
+      if (srtobject->dispatch_poll_id != SRT_ERROR) {
+        gint dispatch_flag = SRT_EPOLL_ERR;
+
+        srt_epoll_add_usock (srtobject->dispatch_poll_id, caller_sock,
+            &dispatch_flag);
+      }
       srtobject->callers = g_list_append (srtobject->callers, caller);
       g_cond_signal (&srtobject->sock_cond);
       g_mutex_unlock (&srtobject->sock_lock);
@@ -1000,6 +1124,238 @@ thread_func (gpointer data)
   }
 }
 
+/* called with sock_lock */
+static void
+srt_caller_set_pending (SRTCaller * caller, GstSRTObject * srtobject,
+    gboolean pending)
+{
+  gint flag = SRT_EPOLL_ERR;
+
+  if (caller->queue_pending == pending)
+    return;
+
+  caller->queue_pending = pending;
+
+  if (pending) {
+    flag |= SRT_EPOLL_OUT;
+    srtobject->dispatch_pending++;
+    g_cond_signal (&srtobject->dispatch_cond);
+  } else {
+    srtobject->dispatch_pending--;
+  }
+
+  /* Only poll for writability while there is something to send, otherwise
+   * the dispatch thread would be woken up continuously */
+  srt_epoll_update_usock (srtobject->dispatch_poll_id, caller->sock, &flag);
+}
+
+/* called with sock_lock. Returns FALSE if the caller has to be dropped */
+static gboolean
+srt_caller_enqueue (SRTCaller * caller, GstSRTObject * srtobject,
+    GBytes * bytes, guint max_size, GstSRTCallerOverflow overflow)
+{
+  if (g_queue_get_length (&caller->queue) >= max_size) {
+    GBytes *dropped = NULL;
+
+    switch (overflow) {
+      case GST_SRT_CALLER_OVERFLOW_DROP_OLDEST:
+        /* A partially sent message has to be completed */
+        dropped =
+            g_queue_pop_nth (&caller->queue, caller->queue_offset > 0 ? 1 : 0);
+        if (dropped)
+          break;
+        /* fallthrough */
+      case GST_SRT_CALLER_OVERFLOW_DROP_NEWEST:
+        caller->queue_dropped++;
+        GST_LOG_OBJECT (srtobject->element, "Queue of caller %d full, "
+            "dropping buffer", caller->sock);
+        return TRUE;
+      case GST_SRT_CALLER_OVERFLOW_DISCONNECT:
+        GST_WARNING_OBJECT (srtobject->element, "Queue of caller %d full, "
+            "dropping caller", caller->sock);
+        return FALSE;
+    }
+
+    caller->queue_dropped++;
+    g_bytes_unref (dropped);
+    GST_LOG_OBJECT (srtobject->element, "Queue of caller %d full, "
+        "dropped oldest buffer", caller->sock);
+  }
+
+  g_queue_push_tail (&caller->queue, g_bytes_ref (bytes));
+  srt_caller_set_pending (caller, srtobject, TRUE);
+
+  return TRUE;
+}
+
+/* called with sock_lock. Sends as many queued messages as the socket accepts
+ * without blocking. Returns FALSE if the caller has to be dropped */
+static gboolean
+srt_caller_send_queued (SRTCaller * caller, GstSRTObject * srtobject)
+{
+  gint payload_size, optlen = sizeof (payload_size);
+  GBytes *bytes;
+
+  if (srt_getsockflag (caller->sock, SRTO_PAYLOADSIZE, &payload_size,
+          &optlen)) {
+    GST_WARNING_OBJECT (srtobject->element, "%s", srt_getlasterror_str ());
+    return FALSE;
+  }
+
+  while ((bytes = g_queue_peek_head (&caller->queue))) {
+    gsize size;
+    const guint8 *data = g_bytes_get_data (bytes, &size);
+
+    if (caller->queue_offset < size) {
+      gint rest = MIN (size - caller->queue_offset, payload_size);
+      gint sent;
+
+      sent = srt_sendmsg2 (caller->sock, (char *) (data + caller->queue_offset),
+          rest, 0);
+      if (sent < 0) {
+        if (srt_getlasterror (NULL) == SRT_EASYNCSND) {
+          /* Send buffer is full, wait until the socket is writable again */
+          return TRUE;
+        }
+
+        GST_WARNING_OBJECT (srtobject->element, "Dropping caller %d: %s",
+            caller->sock, srt_getlasterror_str ());
+        return FALSE;
+      }
+
+      caller->queue_offset += sent;
+      if (caller->queue_offset < size)
+        continue;
+    }
+
+    g_bytes_unref (g_queue_pop_head (&caller->queue));
+    caller->queue_offset = 0;
+  }
+
+  srt_caller_set_pending (caller, srtobject, FALSE);
+
+  return TRUE;
+}
+
+/* called with sock_lock */
+static SRTCaller *
+gst_srt_object_find_caller (GstSRTObject * srtobject, SRTSOCKET sock)
+{
+  GList *item;
+
+  for (item = srtobject->callers; item; item = item->next) {
+    SRTCaller *caller = item->data;
+
+    if (caller->sock == sock)
+      return caller;
+  }
+
+  return NULL;
+}
+
+static gpointer
+dispatch_thread_func (gpointer data)
+{
+  GstSRTObject *srtobject = data;
+
+  g_mutex_lock (&srtobject->sock_lock);
+
+  while (!srtobject->dispatch_stop) {
+    SRTSOCKET rsocks[DISPATCH_MAX_SOCKETS];
+    SRTSOCKET wsocks[DISPATCH_MAX_SOCKETS];
+    gint rsocklen = DISPATCH_MAX_SOCKETS;
+    gint wsocklen = DISPATCH_MAX_SOCKETS;
+    gint i;
+
+    if (srtobject->dispatch_pending == 0) {
+      g_cond_wait (&srtobject->dispatch_cond, &srtobject->sock_lock);
+      continue;
+    }
+
+    g_mutex_unlock (&srtobject->sock_lock);
+
+    if (srt_epoll_wait (srtobject->dispatch_poll_id, rsocks, &rsocklen,
+            wsocks, &wsocklen, DISPATCH_POLL_TIMEOUT, NULL, 0, NULL, 0) < 0) {
+      if (srt_getlasterror (NULL) != SRT_ETIMEOUT) {
+        GST_ELEMENT_ERROR (srtobject->element, RESOURCE, FAILED,
+            ("abort polling: %s", srt_getlasterror_str ()), (NULL));
+        return NULL;
+      }
+      rsocklen = wsocklen = 0;
+    }
+
+    g_mutex_lock (&srtobject->sock_lock);
+
+    /* Only errors are polled for, so readable sockets have failed */
+    for (i = 0; i < rsocklen; i++) {
+      SRTCaller *caller = gst_srt_object_find_caller (srtobject, rsocks[i]);
+
+      if (caller) {
+        GST_WARNING_OBJECT (srtobject->element, "Dropping caller %d: "
+            "socket error", caller->sock);
+        gst_srt_object_remove_caller (srtobject, caller);
+      }
+    }
+
+    for (i = 0; i < wsocklen; i++) {
+      SRTCaller *caller = gst_srt_object_find_caller (srtobject, wsocks[i]);
+
+      if (caller && !srt_caller_send_queued (caller, srtobject))
+        gst_srt_object_remove_caller (srtobject, caller);
+    }
+  }
+
+  g_mutex_unlock (&srtobject->sock_lock);
+
+  return NULL;
+}
+
+static gboolean
+gst_srt_object_start_dispatch (GstSRTObject * srtobject, GError ** error)
+{
+  srtobject->dispatch_poll_id = srt_epoll_create ();
+  if (srtobject->dispatch_poll_id == SRT_ERROR) {
+    g_set_error (error, GST_LIBRARY_ERROR, GST_LIBRARY_ERROR_INIT, "%s",
+        srt_getlasterror_str ());
+    return FALSE;
+  }
+
+  srtobject->dispatch_stop = FALSE;
+  srtobject->dispatch_pending = 0;
+
+  srtobject->dispatch_thread =
+      g_thread_try_new ("GstSRTObjectDispatch", dispatch_thread_func,
+      srtobject, error);
+  if (srtobject->dispatch_thread == NULL) {
+    GST_ERROR_OBJECT (srtobject->element, "Failed to start dispatch thread");
+    srt_epoll_release (srtobject->dispatch_poll_id);
+    srtobject->dispatch_poll_id = SRT_ERROR;
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* called with sock_lock */
+static void
+gst_srt_object_stop_dispatch (GstSRTObject * srtobject)
+{
+  if (srtobject->dispatch_thread) {
+    GThread *thread = g_steal_pointer (&srtobject->dispatch_thread);
+
+    srtobject->dispatch_stop = TRUE;
+    g_cond_signal (&srtobject->dispatch_cond);
+    g_mutex_unlock (&srtobject->sock_lock);
+    g_thread_join (thread);
+    g_mutex_lock (&srtobject->sock_lock);
+  }
+
+  if (srtobject->dispatch_poll_id != SRT_ERROR) {
+    srt_epoll_release (srtobject->dispatch_poll_id);
+    srtobject->dispatch_poll_id = SRT_ERROR;
+  }
+}
+
 static GSocketAddress *
 peeraddr_to_g_socket_address (const struct sockaddr *peeraddr)
 {
@@ -1063,6 +1419,7 @@ gst_srt_object_wait_connect (GstSRTObject * srtobject,
   SRTSOCKET sock = SRT_INVALID_SOCK;
   const gchar *local_address = NULL;
   guint local_port = 0;
+  guint caller_queue_size;
   gint sock_flags = SRT_EPOLL_ERR | SRT_EPOLL_IN;
 
   gpointer bind_sa;
@@ -1078,6 +1435,8 @@ gst_srt_object_wait_connect (GstSRTObject * srtobject,
   if (local_address == NULL)
     local_address = GST_SRT_DEFAULT_LOCALADDRESS;
 
+  caller_queue_size = srtobject->caller_queue_size;
+
   GST_OBJECT_UNLOCK (srtobject->element);
 
   bind_addr =
@@ -1140,6 +1499,14 @@ gst_srt_object_wait_connect (GstSRTObject * srtobject,
     goto failed;
   }
 
+  /* Must be running before the first caller is accepted */
+  if (caller_queue_size > 0 &&
+      gst_uri_handler_get_uri_type (GST_URI_HANDLER (srtobject->element)) ==
+      GST_URI_SINK) {
+    if (!gst_srt_object_start_dispatch (srtobject, error))
+      goto failed;
+  }
+
   srtobject->thread =
       g_thread_try_new ("GstSRTObjectListener", thread_func, srtobject, error);
   if (srtobject->thread == NULL) {
@@ -1151,6 +1518,10 @@ gst_srt_object_wait_connect (GstSRTObject * srtobject,
 
 failed:
 
+  g_mutex_lock (&srtobject->sock_lock);
+  gst_srt_object_stop_dispatch (srtobject);
+  g_mutex_unlock (&srtobject->sock_lock);
+
   if (srtobject->listener_poll_id != SRT_ERROR) {
     srt_epoll_release (srtobject->listener_poll_id);
   }
@@ -1429,6 +1800,8 @@ gst_srt_object_close (GstSRTObject * srtobject)
     g_mutex_lock (&srtobject->sock_lock);
   }
 
+  gst_srt_object_stop_dispatch (srtobject);
+
   if (srtobject->listener_sock != SRT_INVALID_SOCK) {
     GST_DEBUG_OBJECT (srtobject->element, "Closing SRT listener socket (0x%x)",
         srtobject->listener_sock);
@@ -1443,6 +1816,9 @@ gst_srt_object_close (GstSRTObject * srtobject)
     g_list_free_full (callers, (GDestroyNotify) srt_caller_free);
   }
 
+  srtobject->read_sock = SRT_INVALID_SOCK;
+  srtobject->read_poll_id = SRT_ERROR;
+
   g_mutex_unlock (&srtobject->sock_lock);
 
   GST_OBJECT_LOCK (srtobject->element);
@@ -1584,12 +1960,62 @@ gst_srt_object_read (GstSRTObject * srtobject,
         return -1;
       }
     }
+
+    srtobject->read_sock = rsock;
+    srtobject->read_poll_id = poll_id;
     break;
   }
 
   return len;
 }
 
+gssize
+gst_srt_object_read_more (GstSRTObject * srtobject,
+    guint8 * data, gsize size, gint timeout, GError ** error,
+    SRT_MSGCTRL * mctrl)
+{
+  gint payload_size, optlen = sizeof (payload_size);
+  gssize len;
+
+  if (srtobject->read_sock == SRT_INVALID_SOCK)
+    return 0;
+
+  /* Messages are never split, so only try if a full one fits */
+  if (srt_getsockflag (srtobject->read_sock, SRTO_PAYLOADSIZE, &payload_size,
+          &optlen) || size < (gsize) payload_size)
+    return 0;
+
+  srt_msgctrl_init (mctrl);
+  len = srt_recvmsg2 (srtobject->read_sock, (char *) data, size, mctrl);
+
+  if (len == SRT_ERROR && srt_getlasterror (NULL) == SRT_EASYNCRCV &&
+      timeout > 0) {
+    SRTSOCKET rsock;
+    gint rsocklen = 1;
+    SRTSOCKET wsock;
+    gint wsocklen = 1;
+
+    /* Errors are left for the next gst_srt_object_read() to handle */
+    if (srt_epoll_wait (srtobject->read_poll_id, &rsock, &rsocklen, &wsock,
+            &wsocklen, timeout, NULL, 0, NULL, 0) < 0 || wsocklen == 1)
+      return 0;
+
+    srt_msgctrl_init (mctrl);
+    len = srt_recvmsg2 (srtobject->read_sock, (char *) data, size, mctrl);
+  }
+
+  if (len == SRT_ERROR) {
+    if (srt_getlasterror (NULL) == SRT_EASYNCRCV)
+      return 0;
+
+    g_set_error (error, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_READ,
+        "Failed to receive from SRT socket: %s", srt_getlasterror_str ());
+    return -1;
+  }
+
+  return len;
+}
+
 void
 gst_srt_object_wakeup (GstSRTObject * srtobject, GCancellable * cancellable)
 {
@@ -1715,9 +2141,7 @@ gst_srt_object_write_to_callers (GstSRTObject * srtobject,
     continue;
 
   err:
-    srtobject->callers = g_list_remove (srtobject->callers, caller);
-    srt_caller_signal_removed (caller, srtobject);
-    srt_caller_free (caller);
+    gst_srt_object_remove_caller (srtobject, caller);
   }
 
   g_mutex_unlock (&srtobject->sock_lock);
@@ -1728,6 +2152,99 @@ cancelled:
   return -1;
 }
 
+/* called with sock_lock */
+static gboolean
+gst_srt_object_queue_headers (GstSRTObject * srtobject, SRTCaller * caller,
+    GstBufferList * headers, guint max_size, GstSRTCallerOverflow overflow)
+{
+  guint size, i;
+
+  if (!headers)
+    return TRUE;
+
+  size = gst_buffer_list_length (headers);
+
+  GST_DEBUG_OBJECT (srtobject->element, "Queueing %u stream headers for "
+      "caller %d", size, caller->sock);
+
+  for (i = 0; i < size; i++) {
+    GstBuffer *buffer = gst_buffer_list_get (headers, i);
+    GstMapInfo mapinfo;
+    GBytes *bytes;
+    gboolean ret;
+
+    if (!gst_buffer_map (buffer, &mapinfo, GST_MAP_READ)) {
+      GST_ELEMENT_ERROR (srtobject->element, RESOURCE, READ,
+          ("Could not map the input stream"), (NULL));
+      return FALSE;
+    }
+
+    bytes = g_bytes_new (mapinfo.data, mapinfo.size);
+    gst_buffer_unmap (buffer, &mapinfo);
+
+    ret = srt_caller_enqueue (caller, srtobject, bytes, max_size, overflow);
+    g_bytes_unref (bytes);
+
+    if (!ret)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+static gssize
+gst_srt_object_queue_to_callers (GstSRTObject * srtobject,
+    GstBufferList * headers,
+    const GstMapInfo * mapinfo, GCancellable * cancellable, GError ** error)
+{
+  GList *callers;
+  GBytes *bytes;
+  guint max_size;
+  GstSRTCallerOverflow overflow;
+
+  GST_OBJECT_LOCK (srtobject->element);
+  max_size = srtobject->caller_queue_size;
+  overflow = srtobject->caller_overflow;
+  GST_OBJECT_UNLOCK (srtobject->element);
+
+  /* One copy shared by the queues of all callers */
+  bytes = g_bytes_new (mapinfo->data, mapinfo->size);
+
+  g_mutex_lock (&srtobject->sock_lock);
+  callers = srtobject->callers;
+  while (callers != NULL) {
+    SRTCaller *caller = callers->data;
+    callers = callers->next;
+
+    if (g_cancellable_is_cancelled (cancellable)) {
+      goto cancelled;
+    }
+
+    if (!caller->sent_headers) {
+      if (!gst_srt_object_queue_headers (srtobject, caller, headers, max_size,
+              overflow)) {
+        goto err;
+      }
+      caller->sent_headers = TRUE;
+    }
+
+    if (srt_caller_enqueue (caller, srtobject, bytes, max_size, overflow))
+      continue;
+
+  err:
+    gst_srt_object_remove_caller (srtobject, caller);
+  }
+
+  g_mutex_unlock (&srtobject->sock_lock);
+  g_bytes_unref (bytes);
+  return mapinfo->size;
+
+cancelled:
+  g_mutex_unlock (&srtobject->sock_lock);
+  g_bytes_unref (bytes);
+  return -1;
+}
+
 static gssize
 gst_srt_object_write_one (GstSRTObject * srtobject,
     GstBufferList * headers,
@@ -1841,9 +2358,15 @@ gst_srt_object_write (GstSRTObject * srtobject,
       if (!gst_srt_object_wait_caller (srtobject, cancellable, error))
         return -1;
     }
-    len =
-        gst_srt_object_write_to_callers (srtobject, headers, mapinfo,
-        cancellable, error);
+    if (srtobject->dispatch_thread) {
+      len =
+          gst_srt_object_queue_to_callers (srtobject, headers, mapinfo,
+          cancellable, error);
+    } else {
+      len =
+          gst_srt_object_write_to_callers (srtobject, headers, mapinfo,
+          cancellable, error);
+    }
   } else {
     len =
         gst_srt_object_write_one (srtobject, headers, mapinfo, cancellable,
@@ -1949,6 +2472,12 @@ gst_srt_object_get_stats (GstSRTObject * srtobject)
       gst_structure_set (tmp, "caller-address", G_TYPE_SOCKET_ADDRESS,
           caller->sockaddr, NULL);
 
+      if (srtobject->dispatch_thread) {
+        gst_structure_set (tmp,
+            "queue-length", G_TYPE_UINT, g_queue_get_length (&caller->queue),
+            "queue-dropped", G_TYPE_UINT64, caller->queue_dropped, NULL);
+      }
+
       g_value_array_append (callers_stats, NULL);
       v = g_value_array_get_nth (callers_stats, callers_stats->n_values - 1);
       g_value_init (v, GST_TYPE_STRUCTURE);
@@ -42,6 +42,9 @@ G_BEGIN_DECLS
 #define GST_SRT_DEFAULT_LATENCY 125
 #define GST_SRT_DEFAULT_MSG_SIZE 1316
 #define GST_SRT_DEFAULT_WAIT_FOR_CONNECTION (TRUE)
+#define GST_SRT_DEFAULT_CALLER_QUEUE_SIZE 0
+#define GST_SRT_DEFAULT_CALLER_OVERFLOW GST_SRT_CALLER_OVERFLOW_DROP_OLDEST
+#define GST_SRT_DEFAULT_AGGREGATE_LATENCY 0
 
 typedef struct _GstSRTObject GstSRTObject;
 
@@ -68,10 +71,27 @@ struct _GstSRTObject
 
   GList                        *callers;
 
+  /* Listener mode sink: callers with queued data are served from a
+   * separate dispatch thread, protected by sock_lock */
+  GThread                      *dispatch_thread;
+  GCond                         dispatch_cond;
+  gint                          dispatch_poll_id;
+  gboolean                      dispatch_stop;
+  guint                         dispatch_pending;
+
   gboolean                     wait_for_connection;
 
   gboolean                     authentication;
 
+  guint                        caller_queue_size;
+  GstSRTCallerOverflow         caller_overflow;
+
+  guint                        aggregate_latency;
+
+  /* Socket and poll set the last message was read from */
+  SRTSOCKET                    read_sock;
+  gint                         read_poll_id;
+
   guint64                      previous_bytes;
 };
 
@@ -103,6 +123,11 @@ gssize          gst_srt_object_read     (GstSRTObject * srtobject,
                                          GError **err,
 					 SRT_MSGCTRL *mctrl);
 
+gssize          gst_srt_object_read_more (GstSRTObject * srtobject,
+                                         guint8 *data, gsize size,
+                                         gint timeout, GError **err,
+                                         SRT_MSGCTRL *mctrl);
+
 gssize          gst_srt_object_write    (GstSRTObject * srtobject,
                                          GstBufferList * headers,
                                          const GstMapInfo * mapinfo,
@@ -140,6 +140,57 @@ gst_srt_src_stop (GstBaseSrc * bsrc)
   return TRUE;
 }
 
+/* Appends further messages to @outbuf as long as they arrive within
+ * @aggregate_latency milliseconds, returns the new amount of data */
+static gsize
+gst_srt_src_aggregate (GstSRTSrc * self, GstBuffer * outbuf, gsize offset,
+    guint aggregate_latency)
+{
+  GstMapInfo info;
+  gint64 deadline;
+
+  if (!gst_buffer_map (outbuf, &info, GST_MAP_WRITE))
+    return offset;
+
+  deadline = g_get_monotonic_time () +
+      aggregate_latency * G_TIME_SPAN_MILLISECOND;
+
+  while (offset < info.size && !g_cancellable_is_cancelled (self->cancellable)) {
+    GError *err = NULL;
+    SRT_MSGCTRL mctrl;
+    gint64 timeout;
+    gssize recv_len;
+
+    timeout = (deadline - g_get_monotonic_time ()) / G_TIME_SPAN_MILLISECOND;
+
+    recv_len = gst_srt_object_read_more (self->srtobject, info.data + offset,
+        info.size - offset, MAX (timeout, 0), &err, &mctrl);
+    if (recv_len <= 0) {
+      /* Errors are reported again by the next regular read */
+      if (err)
+        GST_DEBUG_OBJECT (self, "Stopping aggregation: %s", err->message);
+      g_clear_error (&err);
+      break;
+    }
+
+    GST_LOG_OBJECT (self, "aggregated recv_len:%" G_GSSIZE_FORMAT
+        " pktseq:%d msgno:%d", recv_len, mctrl.pktseq, mctrl.msgno);
+
+    if (mctrl.pktseq != self->next_pktseq) {
+      GST_WARNING_OBJECT (self, "discont detected %d (expected: %d)",
+          mctrl.pktseq, self->next_pktseq);
+      GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
+    }
+    self->next_pktseq = (mctrl.pktseq + 1) % G_MAXINT32;
+
+    offset += recv_len;
+  }
+
+  gst_buffer_unmap (outbuf, &info);
+
+  return offset;
+}
+
 static GstFlowReturn
 gst_srt_src_fill (GstPushSrc * src, GstBuffer * outbuf)
 {
@@ -154,6 +205,7 @@ gst_srt_src_fill (GstPushSrc * src, GstBuffer * outbuf)
   GstClockTimeDiff delay;
   int64_t srt_time;
   SRT_MSGCTRL mctrl;
+  guint aggregate_latency;
 
   if (g_cancellable_is_cancelled (self->cancellable)) {
     ret = GST_FLOW_FLUSHING;
@@ -246,6 +298,14 @@ gst_srt_src_fill (GstPushSrc * src, GstBuffer * outbuf)
     capture_time = 0;
   GST_BUFFER_TIMESTAMP (outbuf) = capture_time;
 
+  GST_OBJECT_LOCK (self);
+  aggregate_latency = self->srtobject->aggregate_latency;
+  GST_OBJECT_UNLOCK (self);
+
+  if (aggregate_latency > 0)
+    recv_len = gst_srt_src_aggregate (self, outbuf, recv_len,
+        aggregate_latency);
+
   gst_buffer_resize (outbuf, 0, recv_len);
 
   GST_LOG_OBJECT (src,
@@ -341,6 +401,9 @@ gst_srt_src_query (GstBaseSrc * basesrc, GstQuery * query)
     if (!gst_structure_get_int (self->srtobject->parameters, "latency",
             &latency))
       latency = GST_SRT_DEFAULT_LATENCY;
+    GST_OBJECT_LOCK (self);
+    latency += self->srtobject->aggregate_latency;
+    GST_OBJECT_UNLOCK (self);
     gst_query_set_latency (query, TRUE, latency * GST_MSECOND,
         latency * GST_MSECOND);
     return TRUE;
@@ -211,6 +211,10 @@ static GstFlowReturn gst_srtp_dec_chain_rtp (GstPad * pad,
     GstObject * parent, GstBuffer * buf);
 static GstFlowReturn gst_srtp_dec_chain_rtcp (GstPad * pad,
     GstObject * parent, GstBuffer * buf);
+static GstFlowReturn gst_srtp_dec_chain_list_rtp (GstPad * pad,
+    GstObject * parent, GstBufferList * buf_list);
+static GstFlowReturn gst_srtp_dec_chain_list_rtcp (GstPad * pad,
+    GstObject * parent, GstBufferList * buf_list);
 
 static GstStateChangeReturn gst_srtp_dec_change_state (GstElement * element,
     GstStateChange transition);
@@ -385,6 +389,8 @@ gst_srtp_dec_init (GstSrtpDec * filter)
       GST_DEBUG_FUNCPTR (gst_srtp_dec_iterate_internal_links_rtp));
   gst_pad_set_chain_function (filter->rtp_sinkpad,
       GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_rtp));
+  gst_pad_set_chain_list_function (filter->rtp_sinkpad,
+      GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_list_rtp));
 
   filter->rtp_srcpad =
       gst_pad_new_from_static_template (&rtp_src_template, "rtp_src");
@@ -408,6 +414,8 @@ gst_srtp_dec_init (GstSrtpDec * filter)
       GST_DEBUG_FUNCPTR (gst_srtp_dec_iterate_internal_links_rtcp));
   gst_pad_set_chain_function (filter->rtcp_sinkpad,
       GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_rtcp));
+  gst_pad_set_chain_list_function (filter->rtcp_sinkpad,
+      GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_list_rtcp));
 
   filter->rtcp_srcpad =
       gst_pad_new_from_static_template (&rtcp_src_template, "rtcp_src");
@@ -466,6 +474,7 @@ gst_srtp_dec_create_stats (GstSrtpDec * filter)
   gst_structure_set (s, "recv-count", G_TYPE_UINT, filter->recv_count, NULL);
   gst_structure_set (s, "recv-drop-count", G_TYPE_UINT,
       filter->recv_drop_count, NULL);
+  gst_structure_set (s, "recv-bytes", G_TYPE_UINT64, filter->recv_bytes, NULL);
   GST_LOG_OBJECT (filter, "stats: recv-count %u recv-drop-count %u",
       filter->recv_count, filter->recv_drop_count);
   g_value_unset (&v);
@@ -1329,20 +1338,21 @@ gst_srtp_dec_push_early_events (GstSrtpDec * filter, GstPad * pad,
  * This function should be called while holding the filter lock
  */
 static gboolean
-gst_srtp_dec_decode_buffer (GstSrtpDec * filter, GstPad * pad, GstBuffer * buf,
-    gboolean is_rtcp, guint32 ssrc)
+gst_srtp_dec_decode_buffer (GstSrtpDec * filter, GstPad * pad,
+    GstBuffer ** bufptr, gboolean is_rtcp, guint32 ssrc)
 {
   GstMapInfo map;
   srtp_err_status_t err;
   gint size;
   GstSrtpDecSsrcStream *stream;
+  GstBuffer *buf;
 
   GST_LOG_OBJECT (pad, "Received %s buffer of size %" G_GSIZE_FORMAT
-      " with SSRC = %u", is_rtcp ? "RTCP" : "RTP", gst_buffer_get_size (buf),
-      ssrc);
+      " with SSRC = %u", is_rtcp ? "RTCP" : "RTP",
+      gst_buffer_get_size (*bufptr), ssrc);
   filter->recv_count++;
   /* Change buffer to remove protection */
-  buf = gst_buffer_make_writable (buf);
+  buf = *bufptr = gst_buffer_make_writable (*bufptr);
 
   gst_buffer_map (buf, &map, GST_MAP_READWRITE);
   size = map.size;
@@ -1452,6 +1462,7 @@ unprotect:
   }
   gst_buffer_unmap (buf, &map);
   gst_buffer_set_size (buf, size);
+  filter->recv_bytes += size;
   return TRUE;
 
 err:
@@ -1460,6 +1471,24 @@ err:
   return FALSE;
 }
 
+/* Returns the source pad for RTP or RTCP packets, after making sure the
+ * sticky events were sent on it */
+static GstPad *
+gst_srtp_dec_get_src_pad (GstSrtpDec * filter, gboolean is_rtcp)
+{
+  if (is_rtcp) {
+    if (!filter->rtcp_has_segment)
+      gst_srtp_dec_push_early_events (filter, filter->rtcp_srcpad,
+          filter->rtp_srcpad, TRUE);
+    return filter->rtcp_srcpad;
+  } else {
+    if (!filter->rtp_has_segment)
+      gst_srtp_dec_push_early_events (filter, filter->rtp_srcpad,
+          filter->rtcp_srcpad, FALSE);
+    return filter->rtp_srcpad;
+  }
+}
+
 static GstFlowReturn
 gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
     gboolean is_rtcp)
@@ -1485,7 +1514,7 @@ gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
     goto push_out;
   }
 
-  if (!gst_srtp_dec_decode_buffer (filter, pad, buf, is_rtcp, ssrc)) {
+  if (!gst_srtp_dec_decode_buffer (filter, pad, &buf, is_rtcp, ssrc)) {
     GST_OBJECT_UNLOCK (filter);
     goto drop_buffer;
   }
@@ -1498,17 +1527,7 @@ gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
 
 push_out:
   /* Push buffer to source pad */
-  if (is_rtcp) {
-    otherpad = filter->rtcp_srcpad;
-    if (!filter->rtcp_has_segment)
-      gst_srtp_dec_push_early_events (filter, filter->rtcp_srcpad,
-          filter->rtp_srcpad, TRUE);
-  } else {
-    otherpad = filter->rtp_srcpad;
-    if (!filter->rtp_has_segment)
-      gst_srtp_dec_push_early_events (filter, filter->rtp_srcpad,
-          filter->rtcp_srcpad, FALSE);
-  }
+  otherpad = gst_srtp_dec_get_src_pad (filter, is_rtcp);
   ret = gst_pad_push (otherpad, buf);
 
   return ret;
@@ -1521,12 +1540,124 @@ drop_buffer:
   return ret;
 }
 
+typedef struct
+{
+  GstSrtpDec *filter;
+  GstPad *pad;
+  gboolean is_rtcp;
+  /* unprotected packets, by the type they turned out to be */
+  GstBufferList *out_lists[2];
+  GArray *soft_limit_ssrcs;
+} DecodeListData;
+
+/* Called with the filter lock held */
+static gboolean
+decode_buffer_it (GstBuffer ** buffer, guint idx, DecodeListData * data)
+{
+  GstSrtpDec *filter = data->filter;
+  GstSrtpDecSsrcStream *stream;
+  gboolean is_rtcp = data->is_rtcp;
+  guint32 ssrc = 0;
+
+  if (!(stream = validate_buffer (filter, *buffer, &ssrc, &is_rtcp))) {
+    GST_WARNING_OBJECT (filter, "Invalid buffer, dropping");
+    goto drop;
+  }
+
+  if (STREAM_HAS_CRYPTO (stream)) {
+    if (!gst_srtp_dec_decode_buffer (filter, data->pad, buffer, is_rtcp, ssrc))
+      goto drop;
+
+    if (gst_srtp_get_soft_limit_reached ()) {
+      if (!data->soft_limit_ssrcs)
+        data->soft_limit_ssrcs = g_array_new (FALSE, FALSE, sizeof (guint32));
+      g_array_append_val (data->soft_limit_ssrcs, ssrc);
+    }
+  }
+
+  if (!data->out_lists[is_rtcp])
+    data->out_lists[is_rtcp] = gst_buffer_list_new ();
+  gst_buffer_list_add (data->out_lists[is_rtcp], *buffer);
+  *buffer = NULL;
+
+  return TRUE;
+
+drop:
+  gst_clear_buffer (buffer);
+  return TRUE;
+}
+
+/* Unprotects all packets of the list in place while taking the lock only
+ * once, and pushes them downstream as lists again */
+static GstFlowReturn
+gst_srtp_dec_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * buf_list, gboolean is_rtcp)
+{
+  GstSrtpDec *filter = GST_SRTP_DEC (parent);
+  DecodeListData data = { NULL, };
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i;
+
+  GST_LOG_OBJECT (pad, "Buffer chain with list of %u",
+      gst_buffer_list_length (buf_list));
+
+  data.filter = filter;
+  data.pad = pad;
+  data.is_rtcp = is_rtcp;
+
+  buf_list = gst_buffer_list_make_writable (buf_list);
+
+  GST_OBJECT_LOCK (filter);
+  gst_buffer_list_foreach (buf_list, (GstBufferListFunc) decode_buffer_it,
+      &data);
+  GST_OBJECT_UNLOCK (filter);
+
+  gst_buffer_list_unref (buf_list);
+
+  /* If all is well, we may have reached soft limit */
+  if (data.soft_limit_ssrcs) {
+    for (i = 0; i < data.soft_limit_ssrcs->len; i++)
+      request_key_with_signal (filter, g_array_index (data.soft_limit_ssrcs,
+              guint32, i), SIGNAL_SOFT_LIMIT);
+    g_array_free (data.soft_limit_ssrcs, TRUE);
+  }
+
+  /* Push the lists of both types, keeping the first error */
+  for (i = 0; i < 2; i++) {
+    GstFlowReturn push_ret;
+
+    if (!data.out_lists[i])
+      continue;
+
+    push_ret = gst_pad_push_list (gst_srtp_dec_get_src_pad (filter, i),
+        data.out_lists[i]);
+    if (ret == GST_FLOW_OK)
+      ret = push_ret;
+  }
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_srtp_dec_chain_rtp (GstPad * pad, GstObject * parent, GstBuffer * buf)
 {
   return gst_srtp_dec_chain (pad, parent, buf, FALSE);
 }
 
+static GstFlowReturn
+gst_srtp_dec_chain_list_rtp (GstPad * pad, GstObject * parent,
+    GstBufferList * buf_list)
+{
+  return gst_srtp_dec_chain_list (pad, parent, buf_list, FALSE);
+}
+
+static GstFlowReturn
+gst_srtp_dec_chain_list_rtcp (GstPad * pad, GstObject * parent,
+    GstBufferList * buf_list)
+{
+  return gst_srtp_dec_chain_list (pad, parent, buf_list, TRUE);
+}
+
 static GstFlowReturn
 gst_srtp_dec_chain_rtcp (GstPad * pad, GstObject * parent, GstBuffer * buf)
 {
@@ -1556,6 +1687,7 @@ gst_srtp_dec_change_state (GstElement * element, GstStateChange transition)
       filter->rtcp_has_segment = FALSE;
       filter->recv_count = 0;
       filter->recv_drop_count = 0;
+      filter->recv_bytes = 0;
       break;
     case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
       break;
@@ -84,6 +84,7 @@ struct _GstSrtpDec
   gboolean rtcp_has_segment;
   guint recv_count;
   guint recv_drop_count;
+  guint64 recv_bytes;
 
 #ifndef HAVE_SRTP2
   GHashTable *streams_roc_changed;
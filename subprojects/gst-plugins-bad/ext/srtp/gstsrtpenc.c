@@ -165,7 +165,6 @@ typedef struct ProcessBufferItData
 {
   GstSrtpEnc *filter;
   GstPad *pad;
-  GstBufferList *out_list;
   GstFlowReturn flowret;
   gboolean is_rtcp;
 } ProcessBufferItData;
@@ -699,6 +698,9 @@ gst_srtp_enc_create_stats (GstSrtpEnc * filter)
   gst_structure_take_value (s, "streams", &va);
   g_value_unset (&v);
 
+  gst_structure_set (s, "send-count", G_TYPE_UINT64, filter->send_count,
+      "send-bytes", G_TYPE_UINT64, filter->send_bytes, NULL);
+
   return s;
 }
 
@@ -1123,24 +1125,44 @@ gst_srtp_enc_ensure_ssrc (GstSrtpEnc * filter, GstBuffer * buf)
   }
 }
 
+/* The protected packet is at most this much larger than the input */
+#define SRTP_PROTECT_OVERHEAD (SRTP_MAX_TRAILER_LEN + 10)
+
+/* Returns %TRUE if @buf can be protected in place, i.e. it is writable and
+ * has enough room behind its data for the authentication tag */
+static gboolean
+gst_srtp_enc_can_protect_in_place (GstBuffer * buf)
+{
+  GstMemory *mem;
+  gsize offset, maxsize, size;
+
+  if (!gst_buffer_is_writable (buf) || gst_buffer_n_memory (buf) != 1)
+    return FALSE;
+
+  mem = gst_buffer_peek_memory (buf, 0);
+  if (!gst_memory_is_writable (mem))
+    return FALSE;
+
+  size = gst_memory_get_sizes (mem, &offset, &maxsize);
+
+  return maxsize - offset - size >= SRTP_PROTECT_OVERHEAD;
+}
+
+/* Takes ownership of @buf and protects it in place if possible or else into
+ * a newly allocated buffer */
 static GstFlowReturn
 gst_srtp_enc_process_buffer (GstSrtpEnc * filter, GstPad * pad,
     GstBuffer * buf, gboolean is_rtcp, GstBuffer ** outbuf_ptr)
 {
   GstFlowReturn ret = GST_FLOW_OK;
-  gint size_max, size;
+  gint size;
   GstBuffer *bufout = NULL;
   GstMapInfo mapout;
   srtp_err_status_t err;
+  gboolean in_place;
 
-  /* Create a bigger buffer to add protection */
   size = gst_buffer_get_size (buf);
-  size_max = size + SRTP_MAX_TRAILER_LEN + 10;
-  bufout = gst_buffer_new_allocate (NULL, size_max, NULL);
-
-  gst_buffer_map (bufout, &mapout, GST_MAP_READWRITE);
-
-  gst_buffer_extract (buf, 0, mapout.data, size);
+  in_place = gst_srtp_enc_can_protect_in_place (buf);
 
   GST_OBJECT_LOCK (filter);
 
@@ -1155,6 +1177,18 @@ gst_srtp_enc_process_buffer (GstSrtpEnc * filter, GstPad * pad,
 
   gst_srtp_enc_ensure_ssrc (filter, buf);
 
+  if (in_place) {
+    bufout = buf;
+    gst_buffer_set_size (bufout, size + SRTP_PROTECT_OVERHEAD);
+    gst_buffer_map (bufout, &mapout, GST_MAP_READWRITE);
+  } else {
+    /* Create a bigger buffer to add protection */
+    bufout = gst_buffer_new_allocate (NULL, size + SRTP_PROTECT_OVERHEAD,
+        NULL);
+    gst_buffer_map (bufout, &mapout, GST_MAP_READWRITE);
+    gst_buffer_extract (buf, 0, mapout.data, size);
+  }
+
 #ifdef HAVE_SRTP2
   if (is_rtcp)
     err = srtp_protect_rtcp_mki (filter->session, mapout.data, &size,
@@ -1169,6 +1203,11 @@ gst_srtp_enc_process_buffer (GstSrtpEnc * filter, GstPad * pad,
     err = srtp_protect (filter->session, mapout.data, &size);
 #endif
 
+  if (err == srtp_err_status_ok) {
+    filter->send_count++;
+    filter->send_bytes += size;
+  }
+
   GST_OBJECT_UNLOCK (filter);
 
   gst_buffer_unmap (bufout, &mapout);
@@ -1176,10 +1215,13 @@ gst_srtp_enc_process_buffer (GstSrtpEnc * filter, GstPad * pad,
   if (err == srtp_err_status_ok) {
     /* Buffer protected */
     gst_buffer_set_size (bufout, size);
-    gst_buffer_copy_into (bufout, buf, GST_BUFFER_COPY_METADATA, 0, -1);
+    if (!in_place) {
+      gst_buffer_copy_into (bufout, buf, GST_BUFFER_COPY_METADATA, 0, -1);
+      gst_buffer_unref (buf);
+    }
 
-    GST_LOG_OBJECT (pad, "Encoding %s buffer of size %d",
-        is_rtcp ? "RTCP" : "RTP", size);
+    GST_LOG_OBJECT (pad, "Encoding %s buffer of size %d%s",
+        is_rtcp ? "RTCP" : "RTP", size, in_place ? " in place" : "");
 
   } else if (err == srtp_err_status_key_expired) {
 
@@ -1201,7 +1243,9 @@ gst_srtp_enc_process_buffer (GstSrtpEnc * filter, GstPad * pad,
   return ret;
 
 fail:
-  gst_buffer_unref (bufout);
+  if (bufout && !in_place)
+    gst_buffer_unref (bufout);
+  gst_buffer_unref (buf);
   return ret;
 }
 
@@ -1229,6 +1273,7 @@ gst_srtp_enc_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
   GST_OBJECT_UNLOCK (filter);
 
   ret = gst_srtp_enc_process_buffer (filter, pad, buf, is_rtcp, &bufout);
+  buf = NULL;
   if (ret != GST_FLOW_OK)
     goto out;
 
@@ -1253,7 +1298,8 @@ gst_srtp_enc_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
   GST_OBJECT_UNLOCK (filter);
 
 out:
-  gst_buffer_unref (buf);
+  if (buf)
+    gst_buffer_unref (buf);
   return ret;
 }
 
@@ -1264,14 +1310,16 @@ process_buffer_it (GstBuffer ** buffer, guint index, gpointer user_data)
   GstBuffer *bufout;
   GstFlowReturn ret;
 
+  /* the list owns the buffer again after replacing it */
   ret = gst_srtp_enc_process_buffer (data->filter, data->pad, *buffer,
       data->is_rtcp, &bufout);
   if (ret != GST_FLOW_OK) {
+    *buffer = NULL;
     data->flowret = ret;
     return FALSE;
   }
 
-  gst_buffer_list_add (data->out_list, bufout);
+  *buffer = bufout;
 
   return TRUE;
 }
@@ -1283,7 +1331,6 @@ gst_srtp_enc_chain_list (GstPad * pad, GstObject * parent,
   GstSrtpEnc *filter = GST_SRTP_ENC (parent);
   GstFlowReturn ret = GST_FLOW_OK;
   GstPad *otherpad;
-  GstBufferList *out_list = NULL;
   ProcessBufferItData process_data;
 
   GST_LOG_OBJECT (pad, "Buffer chain with list of %d",
@@ -1305,12 +1352,14 @@ gst_srtp_enc_chain_list (GstPad * pad, GstObject * parent,
 
   GST_OBJECT_UNLOCK (filter);
 
-  out_list = gst_buffer_list_new ();
+  /* The buffers are protected in place in the list where possible, which
+   * usually is the case as payloaders allocate their buffers with some
+   * room to spare */
+  buf_list = gst_buffer_list_make_writable (buf_list);
 
   process_data.filter = filter;
   process_data.pad = pad;
   process_data.is_rtcp = is_rtcp;
-  process_data.out_list = out_list;
   process_data.flowret = GST_FLOW_OK;
 
   if (!gst_buffer_list_foreach (buf_list, process_buffer_it, &process_data)) {
@@ -1318,17 +1367,12 @@ gst_srtp_enc_chain_list (GstPad * pad, GstObject * parent,
     goto out;
   }
 
-  if (!gst_buffer_list_length (out_list)) {
-    gst_buffer_list_unref (out_list);
-    ret = GST_FLOW_OK;
-    goto out;
-  }
-
   /* Push buffer to source pad */
   otherpad = get_rtp_other_pad (pad);
   GST_LOG_OBJECT (pad, "Pushing buffer chain of %d",
       gst_buffer_list_length (buf_list));
-  ret = gst_pad_push_list (otherpad, out_list);
+  ret = gst_pad_push_list (otherpad, buf_list);
+  buf_list = NULL;
 
   if (ret != GST_FLOW_OK) {
     goto out;
@@ -1348,7 +1392,8 @@ gst_srtp_enc_chain_list (GstPad * pad, GstObject * parent,
 
 out:
 
-  gst_buffer_list_unref (buf_list);
+  if (buf_list)
+    gst_buffer_list_unref (buf_list);
 
   return ret;
 }
@@ -1423,6 +1468,10 @@ gst_srtp_enc_change_state (GstElement * element, GstStateChange transition)
       GST_OBJECT_UNLOCK (filter);
       break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:
+      GST_OBJECT_LOCK (filter);
+      filter->send_count = 0;
+      filter->send_bytes = 0;
+      GST_OBJECT_UNLOCK (filter);
       break;
     case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
       break;
@@ -86,6 +86,9 @@ struct _GstSrtpEnc
   gboolean allow_repeat_tx;
 
   GHashTable *ssrcs_set;
+
+  guint64 send_count;
+  guint64 send_bytes;
 };
 
 struct _GstSrtpEncClass
@@ -32,6 +32,7 @@
 #include "vksink.h"
 #include "vkupload.h"
 #include "vkimageidentity.h"
+#include "vkscale.h"
 #include "vkcolorconvert.h"
 #include "vkshaderspv.h"
 #include "vkdownload.h"
@@ -57,6 +58,8 @@ plugin_init (GstPlugin * plugin)
 
   ret |= GST_ELEMENT_REGISTER (vulkanimageidentity, plugin);
 
+  ret |= GST_ELEMENT_REGISTER (vulkanscale, plugin);
+
   ret |= GST_ELEMENT_REGISTER (vulkanshaderspv, plugin);
 
   ret |= GST_ELEMENT_REGISTER (vulkanviewconvert, plugin);
@@ -32,6 +32,7 @@ void vulkan_element_init (GstPlugin * plugin);
 GST_ELEMENT_REGISTER_DECLARE (vulkancolorconvert);
 GST_ELEMENT_REGISTER_DECLARE (vulkandownload);
 GST_ELEMENT_REGISTER_DECLARE (vulkanimageidentity);
+GST_ELEMENT_REGISTER_DECLARE (vulkanscale);
 GST_ELEMENT_REGISTER_DECLARE (vulkanshaderspv);
 GST_ELEMENT_REGISTER_DECLARE (vulkansink);
 GST_ELEMENT_REGISTER_DECLARE (vulkanupload);
@@ -0,0 +1,697 @@
+/*
+ * GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-vulkanscale
+ * @title: vulkanscale
+ *
+ * vulkanscale resizes Vulkan images with a compute shader.  Unlike the
+ * render pass based elements it only needs a compute capable queue and does
+ * not go through the graphics pipeline, which makes it a better fit for
+ * headless transcoding.
+ *
+ * ## Example launch line
+ * |[
+ * gst-launch-1.0 videotestsrc ! vulkanupload ! vulkanscale ! video/x-raw(memory:VulkanImage),width=1280,height=720 ! vulkandownload ! fakesink
+ * ]|
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "gstvulkanelements.h"
+#include "vkscale.h"
+
+#include "shaders/scale.comp.h"
+
+GST_DEBUG_CATEGORY (gst_debug_vulkan_scale);
+#define GST_CAT_DEFAULT gst_debug_vulkan_scale
+
+/* must match the local size of the compute shader */
+#define WORKGROUP_SIZE 16
+
+#define STORAGE_IMAGE_USAGE (VK_IMAGE_USAGE_TRANSFER_SRC_BIT | \
+    VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | \
+    VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | \
+    VK_IMAGE_USAGE_STORAGE_BIT)
+
+static gboolean gst_vulkan_scale_start (GstBaseTransform * bt);
+static gboolean gst_vulkan_scale_stop (GstBaseTransform * bt);
+
+static GstCaps *gst_vulkan_scale_transform_caps (GstBaseTransform * bt,
+    GstPadDirection direction, GstCaps * caps, GstCaps * filter);
+static GstCaps *gst_vulkan_scale_fixate_caps (GstBaseTransform * bt,
+    GstPadDirection direction, GstCaps * caps, GstCaps * othercaps);
+static gboolean gst_vulkan_scale_set_caps (GstBaseTransform * bt,
+    GstCaps * in_caps, GstCaps * out_caps);
+static gboolean gst_vulkan_scale_decide_allocation (GstBaseTransform * bt,
+    GstQuery * query);
+static GstFlowReturn gst_vulkan_scale_transform (GstBaseTransform * bt,
+    GstBuffer * inbuf, GstBuffer * outbuf);
+
+/* the shader writes rgba8 storage images */
+#define IMAGE_FORMATS " { RGBA }"
+
+static GstStaticPadTemplate gst_vulkan_sink_template =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE_WITH_FEATURES
+        (GST_CAPS_FEATURE_MEMORY_VULKAN_IMAGE,
+            IMAGE_FORMATS)));
+
+static GstStaticPadTemplate gst_vulkan_src_template =
+GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE_WITH_FEATURES
+        (GST_CAPS_FEATURE_MEMORY_VULKAN_IMAGE,
+            IMAGE_FORMATS)));
+
+#define gst_vulkan_scale_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstVulkanScale, gst_vulkan_scale,
+    GST_TYPE_VULKAN_VIDEO_FILTER,
+    GST_DEBUG_CATEGORY_INIT (gst_debug_vulkan_scale,
+        "vulkanscale", 0, "Vulkan Scale"));
+GST_ELEMENT_REGISTER_DEFINE_WITH_CODE (vulkanscale, "vulkanscale",
+    GST_RANK_NONE, GST_TYPE_VULKAN_SCALE, vulkan_element_init (plugin));
+
+static void
+gst_vulkan_scale_class_init (GstVulkanScaleClass * klass)
+{
+  GstElementClass *gstelement_class;
+  GstBaseTransformClass *gstbasetransform_class;
+
+  gstelement_class = (GstElementClass *) klass;
+  gstbasetransform_class = (GstBaseTransformClass *) klass;
+
+  gst_element_class_set_metadata (gstelement_class, "Vulkan Scale",
+      "Filter/Video", "Resizes Vulkan images with a compute shader",
+      "GStreamer maintainers <gstreamer-devel@lists.freedesktop.org>");
+
+  gst_element_class_add_static_pad_template (gstelement_class,
+      &gst_vulkan_sink_template);
+  gst_element_class_add_static_pad_template (gstelement_class,
+      &gst_vulkan_src_template);
+
+  gstbasetransform_class->start = GST_DEBUG_FUNCPTR (gst_vulkan_scale_start);
+  gstbasetransform_class->stop = GST_DEBUG_FUNCPTR (gst_vulkan_scale_stop);
+  gstbasetransform_class->transform_caps = gst_vulkan_scale_transform_caps;
+  gstbasetransform_class->fixate_caps = gst_vulkan_scale_fixate_caps;
+  gstbasetransform_class->set_caps = gst_vulkan_scale_set_caps;
+  gstbasetransform_class->decide_allocation =
+      gst_vulkan_scale_decide_allocation;
+  gstbasetransform_class->transform = gst_vulkan_scale_transform;
+}
+
+static void
+gst_vulkan_scale_init (GstVulkanScale * scale)
+{
+}
+
+static GstCaps *
+gst_vulkan_scale_transform_caps (GstBaseTransform * bt,
+    GstPadDirection direction, GstCaps * caps, GstCaps * filter)
+{
+  GstCaps *ret;
+  gint i, n;
+
+  ret = gst_caps_copy (caps);
+  n = gst_caps_get_size (ret);
+  for (i = 0; i < n; i++) {
+    GstStructure *s = gst_caps_get_structure (ret, i);
+
+    gst_structure_set (s, "width", GST_TYPE_INT_RANGE, 1, G_MAXINT,
+        "height", GST_TYPE_INT_RANGE, 1, G_MAXINT, NULL);
+    gst_structure_remove_field (s, "pixel-aspect-ratio");
+  }
+
+  if (filter) {
+    GstCaps *tmp;
+
+    tmp = gst_caps_intersect_full (filter, ret, GST_CAPS_INTERSECT_FIRST);
+    gst_caps_unref (ret);
+    ret = tmp;
+  }
+
+  return ret;
+}
+
+static GstCaps *
+gst_vulkan_scale_fixate_caps (GstBaseTransform * bt,
+    GstPadDirection direction, GstCaps * caps, GstCaps * othercaps)
+{
+  GstStructure *ins, *outs;
+  gint width = 0, height = 0;
+
+  othercaps = gst_caps_truncate (othercaps);
+  othercaps = gst_caps_make_writable (othercaps);
+
+  ins = gst_caps_get_structure (caps, 0);
+  outs = gst_caps_get_structure (othercaps, 0);
+
+  /* keep the size if downstream does not constrain it */
+  if (gst_structure_get_int (ins, "width", &width))
+    gst_structure_fixate_field_nearest_int (outs, "width", width);
+  if (gst_structure_get_int (ins, "height", &height))
+    gst_structure_fixate_field_nearest_int (outs, "height", height);
+
+  return gst_caps_fixate (othercaps);
+}
+
+static gboolean
+create_sampler (GstVulkanScale * scale, GError ** error)
+{
+  GstVulkanVideoFilter *vfilter = GST_VULKAN_VIDEO_FILTER (scale);
+  /* *INDENT-OFF* */
+  VkSamplerCreateInfo sampler_info = {
+      .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+      .magFilter = VK_FILTER_LINEAR,
+      .minFilter = VK_FILTER_LINEAR,
+      .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+      .anisotropyEnable = VK_FALSE,
+      .maxAnisotropy = 1,
+      .borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK,
+      .unnormalizedCoordinates = VK_FALSE,
+      .compareEnable = VK_FALSE,
+      .compareOp = VK_COMPARE_OP_ALWAYS,
+      .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+      .mipLodBias = 0.0f,
+      .minLod = 0.0f,
+      .maxLod = 0.0f
+  };
+  /* *INDENT-ON* */
+  VkSampler sampler;
+  VkResult err;
+
+  err = vkCreateSampler (vfilter->device->device, &sampler_info, NULL,
+      &sampler);
+  if (gst_vulkan_error_to_g_error (err, error, "vkCreateSampler") < 0)
+    return FALSE;
+
+  scale->sampler = gst_vulkan_handle_new_wrapped (vfilter->device,
+      GST_VULKAN_HANDLE_TYPE_SAMPLER, (GstVulkanHandleTypedef) sampler,
+      gst_vulkan_handle_free_sampler, NULL);
+
+  return TRUE;
+}
+
+static gboolean
+create_pipeline (GstVulkanScale * scale, GError ** error)
+{
+  GstVulkanVideoFilter *vfilter = GST_VULKAN_VIDEO_FILTER (scale);
+  VkDescriptorSetLayoutBinding bindings[2];
+  VkDescriptorSetLayoutCreateInfo layout_info;
+  VkDescriptorSetLayout descriptor_set_layout;
+  VkPipelineLayoutCreateInfo pipeline_layout_info;
+  VkPipelineLayout pipeline_layout;
+  VkComputePipelineCreateInfo pipeline_info;
+  VkPipeline pipeline;
+  VkResult err;
+
+  /* *INDENT-OFF* */
+  bindings[0] = (VkDescriptorSetLayoutBinding) {
+      .binding = 0,
+      .descriptorCount = 1,
+      .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+      .pImmutableSamplers = NULL,
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+  };
+  bindings[1] = (VkDescriptorSetLayoutBinding) {
+      .binding = 1,
+      .descriptorCount = 1,
+      .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+      .pImmutableSamplers = NULL,
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+  };
+
+  layout_info = (VkDescriptorSetLayoutCreateInfo) {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .pNext = NULL,
+      .bindingCount = G_N_ELEMENTS (bindings),
+      .pBindings = bindings
+  };
+  /* *INDENT-ON* */
+
+  err = vkCreateDescriptorSetLayout (vfilter->device->device, &layout_info,
+      NULL, &descriptor_set_layout);
+  if (gst_vulkan_error_to_g_error (err, error,
+          "vkCreateDescriptorSetLayout") < 0)
+    return FALSE;
+
+  scale->descriptor_set_layout =
+      gst_vulkan_handle_new_wrapped (vfilter->device,
+      GST_VULKAN_HANDLE_TYPE_DESCRIPTOR_SET_LAYOUT,
+      (GstVulkanHandleTypedef) descriptor_set_layout,
+      gst_vulkan_handle_free_descriptor_set_layout, NULL);
+
+  /* *INDENT-OFF* */
+  pipeline_layout_info = (VkPipelineLayoutCreateInfo) {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .pNext = NULL,
+      .setLayoutCount = 1,
+      .pSetLayouts = &descriptor_set_layout,
+      .pushConstantRangeCount = 0,
+      .pPushConstantRanges = NULL,
+  };
+  /* *INDENT-ON* */
+
+  err = vkCreatePipelineLayout (vfilter->device->device,
+      &pipeline_layout_info, NULL, &pipeline_layout);
+  if (gst_vulkan_error_to_g_error (err, error, "vkCreatePipelineLayout") < 0)
+    return FALSE;
+
+  scale->pipeline_layout = gst_vulkan_handle_new_wrapped (vfilter->device,
+      GST_VULKAN_HANDLE_TYPE_PIPELINE_LAYOUT,
+      (GstVulkanHandleTypedef) pipeline_layout,
+      gst_vulkan_handle_free_pipeline_layout, NULL);
+
+  /* *INDENT-OFF* */
+  pipeline_info = (VkComputePipelineCreateInfo) {
+      .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+      .pNext = NULL,
+      .stage = (VkPipelineShaderStageCreateInfo) {
+          .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+          .pNext = NULL,
+          .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+          .module = (VkShaderModule) scale->shader->handle,
+          .pName = "main"
+      },
+      .layout = pipeline_layout,
+      .basePipelineHandle = VK_NULL_HANDLE
+  };
+  /* *INDENT-ON* */
+
+  err = vkCreateComputePipelines (vfilter->device->device,
+      gst_vulkan_device_get_pipeline_cache (vfilter->device), 1,
+      &pipeline_info, NULL, &pipeline);
+  if (gst_vulkan_error_to_g_error (err, error, "vkCreateComputePipelines") < 0)
+    return FALSE;
+
+  scale->compute_pipeline = gst_vulkan_handle_new_wrapped (vfilter->device,
+      GST_VULKAN_HANDLE_TYPE_PIPELINE, (GstVulkanHandleTypedef) pipeline,
+      gst_vulkan_handle_free_pipeline, NULL);
+
+  return TRUE;
+}
+
+static gboolean
+create_descriptor_pool (GstVulkanScale * scale, GError ** error)
+{
+  GstVulkanVideoFilter *vfilter = GST_VULKAN_VIDEO_FILTER (scale);
+  gsize max_sets = 32;          /* FIXME: don't hardcode this! */
+  VkDescriptorPoolSize pool_sizes[2];
+  VkDescriptorPoolCreateInfo pool_info;
+  VkDescriptorPool pool;
+  GstVulkanDescriptorPool *ret;
+  VkResult err;
+
+  /* *INDENT-OFF* */
+  pool_sizes[0] = (VkDescriptorPoolSize) {
+      .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+      .descriptorCount = max_sets
+  };
+  pool_sizes[1] = (VkDescriptorPoolSize) {
+      .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+      .descriptorCount = max_sets
+  };
+
+  pool_info = (VkDescriptorPoolCreateInfo) {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+      .pNext = NULL,
+      .flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+      .poolSizeCount = G_N_ELEMENTS (pool_sizes),
+      .pPoolSizes = pool_sizes,
+      .maxSets = max_sets
+  };
+  /* *INDENT-ON* */
+
+  err = vkCreateDescriptorPool (vfilter->device->device, &pool_info, NULL,
+      &pool);
+  if (gst_vulkan_error_to_g_error (err, error, "vkCreateDescriptorPool") < 0)
+    return FALSE;
+
+  ret = gst_vulkan_descriptor_pool_new_wrapped (vfilter->device, pool,
+      max_sets);
+  scale->descriptor_cache =
+      gst_vulkan_descriptor_cache_new (ret, 1, &scale->descriptor_set_layout);
+  gst_object_unref (ret);
+
+  return TRUE;
+}
+
+static gboolean
+gst_vulkan_scale_start (GstBaseTransform * bt)
+{
+  GstVulkanScale *scale = GST_VULKAN_SCALE (bt);
+  GstVulkanVideoFilter *vfilter = GST_VULKAN_VIDEO_FILTER (scale);
+  guint queue_flags;
+  GError *error = NULL;
+
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->start (bt))
+    return FALSE;
+
+  queue_flags = vfilter->device->physical_device->
+      queue_family_props[vfilter->queue->family].queueFlags;
+  if ((queue_flags & VK_QUEUE_COMPUTE_BIT) == 0) {
+    GST_ELEMENT_ERROR (bt, RESOURCE, NOT_FOUND,
+        ("Vulkan queue does not support compute operations"), (NULL));
+    return FALSE;
+  }
+
+  scale->trash_list = gst_vulkan_trash_fence_list_new ();
+
+  if (!(scale->shader = gst_vulkan_create_shader (vfilter->device, scale_comp,
+              scale_comp_size, &error)))
+    goto error;
+  if (!create_sampler (scale, &error))
+    goto error;
+  if (!create_pipeline (scale, &error))
+    goto error;
+  if (!create_descriptor_pool (scale, &error))
+    goto error;
+  if (!(scale->cmd_pool =
+          gst_vulkan_queue_create_command_pool (vfilter->queue, &error)))
+    goto error;
+
+  return TRUE;
+
+error:
+  GST_ELEMENT_ERROR (bt, RESOURCE, NOT_FOUND, ("%s", error->message), (NULL));
+  g_clear_error (&error);
+  return FALSE;
+}
+
+static gboolean
+gst_vulkan_scale_stop (GstBaseTransform * bt)
+{
+  GstVulkanScale *scale = GST_VULKAN_SCALE (bt);
+
+  if (scale->trash_list) {
+    gst_vulkan_trash_list_wait (scale->trash_list, -1);
+    gst_vulkan_trash_list_gc (scale->trash_list);
+    gst_clear_object (&scale->trash_list);
+  }
+
+  gst_clear_object (&scale->cmd_pool);
+  gst_clear_object (&scale->descriptor_cache);
+  gst_clear_mini_object ((GstMiniObject **) & scale->compute_pipeline);
+  gst_clear_mini_object ((GstMiniObject **) & scale->pipeline_layout);
+  gst_clear_mini_object ((GstMiniObject **) & scale->descriptor_set_layout);
+  gst_clear_mini_object ((GstMiniObject **) & scale->sampler);
+  gst_clear_mini_object ((GstMiniObject **) & scale->shader);
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->stop (bt);
+}
+
+static gboolean
+gst_vulkan_scale_set_caps (GstBaseTransform * bt, GstCaps * in_caps,
+    GstCaps * out_caps)
+{
+  GstVulkanVideoFilter *vfilter = GST_VULKAN_VIDEO_FILTER (bt);
+  VkFormatProperties props;
+  VkFormat vk_format;
+
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->set_caps (bt, in_caps,
+          out_caps))
+    return FALSE;
+
+  vk_format = gst_vulkan_format_from_video_info (&vfilter->out_info, 0);
+  vkGetPhysicalDeviceFormatProperties (vfilter->device->physical_device->device,
+      vk_format, &props);
+  if ((props.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) == 0) {
+    GST_ERROR_OBJECT (bt, "Output format %u cannot be used as a storage image",
+        vk_format);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static gboolean
+gst_vulkan_scale_decide_allocation (GstBaseTransform * bt, GstQuery * query)
+{
+  GstBufferPool *pool = NULL;
+  GstStructure *config;
+  guint min, max, size;
+
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->decide_allocation (bt, query))
+    return FALSE;
+
+  /* the output images are written from the compute shader */
+  gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+  if (!pool)
+    return FALSE;
+
+  config = gst_buffer_pool_get_config (pool);
+  gst_vulkan_image_buffer_pool_config_set_allocation_params (config,
+      STORAGE_IMAGE_USAGE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+  if (!gst_buffer_pool_set_config (pool, config)) {
+    GST_WARNING_OBJECT (bt, "Failed to set storage image usage on the pool");
+    gst_object_unref (pool);
+    return FALSE;
+  }
+
+  gst_object_unref (pool);
+
+  return TRUE;
+}
+
+static GstVulkanImageMemory *
+peek_image_from_buffer (GstBuffer * buffer)
+{
+  GstMemory *mem = gst_buffer_peek_memory (buffer, 0);
+
+  if (!gst_is_vulkan_image_memory (mem))
+    return NULL;
+
+  return (GstVulkanImageMemory *) mem;
+}
+
+static void
+image_barrier (GstVulkanCommandBuffer * cmd, GstVulkanImageMemory * img_mem,
+    VkAccessFlags access, VkImageLayout layout)
+{
+  /* *INDENT-OFF* */
+  VkImageMemoryBarrier barrier = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .pNext = NULL,
+      .srcAccessMask = img_mem->barrier.parent.access_flags,
+      .dstAccessMask = access,
+      .oldLayout = img_mem->barrier.image_layout,
+      .newLayout = layout,
+      /* FIXME: implement exclusive transfers */
+      .srcQueueFamilyIndex = 0,
+      .dstQueueFamilyIndex = 0,
+      .image = img_mem->image,
+      .subresourceRange = img_mem->barrier.subresource_range
+  };
+  /* *INDENT-ON* */
+
+  vkCmdPipelineBarrier (cmd->cmd, img_mem->barrier.parent.pipeline_stages,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+
+  img_mem->barrier.parent.pipeline_stages =
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+  img_mem->barrier.parent.access_flags = access;
+  img_mem->barrier.image_layout = layout;
+}
+
+static GstFlowReturn
+gst_vulkan_scale_transform (GstBaseTransform * bt, GstBuffer * inbuf,
+    GstBuffer * outbuf)
+{
+  GstVulkanScale *scale = GST_VULKAN_SCALE (bt);
+  GstVulkanVideoFilter *vfilter = GST_VULKAN_VIDEO_FILTER (bt);
+  GstVulkanImageMemory *in_mem, *out_mem;
+  GstVulkanImageView *in_view = NULL, *out_view = NULL;
+  GstVulkanDescriptorSet *set = NULL;
+  GstVulkanCommandBuffer *cmd = NULL;
+  GstVulkanFence *fence = NULL;
+  GError *error = NULL;
+  VkResult err;
+
+  in_mem = peek_image_from_buffer (inbuf);
+  out_mem = peek_image_from_buffer (outbuf);
+  if (!in_mem || !out_mem) {
+    g_set_error_literal (&error, GST_VULKAN_ERROR, GST_VULKAN_FAILED,
+        "Input and output memory must be a GstVulkanImageMemory");
+    goto error;
+  }
+
+  if (!(fence = gst_vulkan_device_create_fence (vfilter->device, &error)))
+    goto error;
+
+  in_view = gst_vulkan_get_or_create_image_view (in_mem);
+  out_view = gst_vulkan_get_or_create_image_view (out_mem);
+
+  if (!(set = gst_vulkan_descriptor_cache_acquire (scale->descriptor_cache,
+              &error)))
+    goto error;
+
+  {
+    VkDescriptorImageInfo image_info[2];
+    VkWriteDescriptorSet writes[2];
+
+    /* *INDENT-OFF* */
+    image_info[0] = (VkDescriptorImageInfo) {
+        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .imageView = in_view->view,
+        .sampler = (VkSampler) scale->sampler->handle
+    };
+    image_info[1] = (VkDescriptorImageInfo) {
+        .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+        .imageView = out_view->view,
+        .sampler = VK_NULL_HANDLE
+    };
+
+    writes[0] = (VkWriteDescriptorSet) {
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .pNext = NULL,
+        .dstSet = set->set,
+        .dstBinding = 0,
+        .dstArrayElement = 0,
+        .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        .descriptorCount = 1,
+        .pImageInfo = &image_info[0]
+    };
+    writes[1] = (VkWriteDescriptorSet) {
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .pNext = NULL,
+        .dstSet = set->set,
+        .dstBinding = 1,
+        .dstArrayElement = 0,
+        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        .descriptorCount = 1,
+        .pImageInfo = &image_info[1]
+    };
+    /* *INDENT-ON* */
+
+    vkUpdateDescriptorSets (vfilter->device->device, G_N_ELEMENTS (writes),
+        writes, 0, NULL);
+  }
+
+  if (!(cmd = gst_vulkan_command_pool_create (scale->cmd_pool, &error)))
+    goto error;
+
+  {
+    /* *INDENT-OFF* */
+    VkCommandBufferBeginInfo cmd_buf_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext = NULL,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = NULL
+    };
+    /* *INDENT-ON* */
+
+    gst_vulkan_command_buffer_lock (cmd);
+    err = vkBeginCommandBuffer (cmd->cmd, &cmd_buf_info);
+    if (gst_vulkan_error_to_g_error (err, &error, "vkBeginCommandBuffer") < 0)
+      goto unlock_error;
+  }
+
+  image_barrier (cmd, in_mem, VK_ACCESS_SHADER_READ_BIT,
+      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  image_barrier (cmd, out_mem, VK_ACCESS_SHADER_WRITE_BIT,
+      VK_IMAGE_LAYOUT_GENERAL);
+
+  vkCmdBindPipeline (cmd->cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+      (VkPipeline) scale->compute_pipeline->handle);
+  vkCmdBindDescriptorSets (cmd->cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+      (VkPipelineLayout) scale->pipeline_layout->handle, 0, 1, &set->set, 0,
+      NULL);
+  vkCmdDispatch (cmd->cmd,
+      (GST_VIDEO_INFO_WIDTH (&vfilter->out_info) + WORKGROUP_SIZE - 1)
+      / WORKGROUP_SIZE,
+      (GST_VIDEO_INFO_HEIGHT (&vfilter->out_info) + WORKGROUP_SIZE - 1)
+      / WORKGROUP_SIZE, 1);
+
+  err = vkEndCommandBuffer (cmd->cmd);
+  gst_vulkan_command_buffer_unlock (cmd);
+  if (gst_vulkan_error_to_g_error (err, &error, "vkEndCommandBuffer") < 0)
+    goto error;
+
+  {
+    /* *INDENT-OFF* */
+    VkSubmitInfo submit_info = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = NULL,
+        .waitSemaphoreCount = 0,
+        .pWaitSemaphores = NULL,
+        .pWaitDstStageMask = NULL,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &cmd->cmd,
+        .signalSemaphoreCount = 0,
+        .pSignalSemaphores = NULL,
+    };
+    /* *INDENT-ON* */
+
+    /* Submissions on the same queue execute in order and the barriers above
+     * order this dispatch against the previous and next element's work, so
+     * no CPU wait is needed here.  The fence only guards the resources
+     * that are released once the dispatch completed. */
+    gst_vulkan_queue_submit_lock (vfilter->queue);
+    err = vkQueueSubmit (vfilter->queue->queue, 1, &submit_info,
+        GST_VULKAN_FENCE_FENCE (fence));
+    gst_vulkan_queue_submit_unlock (vfilter->queue);
+    if (gst_vulkan_error_to_g_error (err, &error, "vkQueueSubmit") < 0)
+      goto error;
+  }
+
+  gst_vulkan_trash_list_add (scale->trash_list,
+      gst_vulkan_trash_list_acquire (scale->trash_list, fence,
+          gst_vulkan_trash_mini_object_unref, GST_MINI_OBJECT_CAST (cmd)));
+  gst_vulkan_trash_list_add (scale->trash_list,
+      gst_vulkan_trash_list_acquire (scale->trash_list, fence,
+          gst_vulkan_trash_mini_object_unref, GST_MINI_OBJECT_CAST (set)));
+  gst_vulkan_trash_list_add (scale->trash_list,
+      gst_vulkan_trash_list_acquire (scale->trash_list, fence,
+          gst_vulkan_trash_mini_object_unref,
+          GST_MINI_OBJECT_CAST (in_view)));
+  gst_vulkan_trash_list_add (scale->trash_list,
+      gst_vulkan_trash_list_acquire (scale->trash_list, fence,
+          gst_vulkan_trash_mini_object_unref,
+          GST_MINI_OBJECT_CAST (out_view)));
+  gst_vulkan_trash_list_gc (scale->trash_list);
+
+  gst_vulkan_fence_unref (fence);
+
+  return GST_FLOW_OK;
+
+unlock_error:
+  gst_vulkan_command_buffer_unlock (cmd);
+
+error:
+  gst_clear_mini_object ((GstMiniObject **) & cmd);
+  gst_clear_mini_object ((GstMiniObject **) & set);
+  gst_clear_mini_object ((GstMiniObject **) & in_view);
+  gst_clear_mini_object ((GstMiniObject **) & out_view);
+  gst_clear_mini_object ((GstMiniObject **) & fence);
+  GST_ELEMENT_ERROR (bt, LIBRARY, FAILED, ("%s", error->message), (NULL));
+  g_clear_error (&error);
+  return GST_FLOW_ERROR;
+}
@@ -31,6 +31,14 @@
  *
  *  The current implementation is based on weston compositor.
  *
+ *  If the compositor supports the presentation-time protocol, the time
+ *  between committing a frame and the compositor presenting it is measured
+ *  and reported as render delay, so that the pipeline latency accounts for
+ *  the compositor's own scheduling. wl_buffers created for dmabuf memory are
+ *  kept for a while after the memory is freed and reused when a later buffer
+ *  carries the same dmabufs, which avoids a new import in the compositor for
+ *  every frame when upstream does not recycle its GstMemory.
+ *
  * ## Example pipelines
  * |[
  * gst-launch-1.0 -v videotestsrc ! waylandsink
@@ -220,6 +228,10 @@ gst_wayland_sink_init (GstWaylandSink * sink)
 {
   g_mutex_init (&sink->display_lock);
   g_mutex_init (&sink->render_lock);
+
+  sink->commit_time = GST_CLOCK_TIME_NONE;
+  sink->present_latency = GST_CLOCK_TIME_NONE;
+  sink->reported_latency = GST_CLOCK_TIME_NONE;
 }
 
 static void
@@ -412,6 +424,8 @@ gst_wayland_sink_change_state (GstElement * element, GstStateChange transition)
         wl_callback_destroy (sink->callback);
         sink->callback = NULL;
       }
+      g_clear_pointer (&sink->feedback, wp_presentation_feedback_destroy);
+      sink->commit_time = GST_CLOCK_TIME_NONE;
       sink->redraw_pending = FALSE;
       g_mutex_unlock (&sink->render_lock);
       break;
@@ -656,6 +670,87 @@ static const struct wl_callback_listener frame_callback_listener = {
   frame_redraw_callback
 };
 
+static GstClockTime
+get_presentation_time (GstWaylandSink * sink)
+{
+  struct timespec ts;
+
+  if (clock_gettime (sink->display->presentation_clock, &ts) < 0)
+    return GST_CLOCK_TIME_NONE;
+
+  return GST_TIMESPEC_TO_TIME (ts);
+}
+
+static void
+presentation_feedback_sync_output (void *data,
+    struct wp_presentation_feedback *feedback, struct wl_output *output)
+{
+}
+
+static void
+presentation_feedback_presented (void *data,
+    struct wp_presentation_feedback *feedback, uint32_t tv_sec_hi,
+    uint32_t tv_sec_lo, uint32_t tv_nsec, uint32_t refresh, uint32_t seq_hi,
+    uint32_t seq_lo, uint32_t flags)
+{
+  GstWaylandSink *sink = data;
+  GstClockTime presented, latency;
+
+  presented = (((guint64) tv_sec_hi << 32) | tv_sec_lo) * GST_SECOND + tv_nsec;
+
+  g_mutex_lock (&sink->render_lock);
+  if (feedback != sink->feedback)
+    goto done;
+
+  if (!GST_CLOCK_TIME_IS_VALID (sink->commit_time) ||
+      presented < sink->commit_time)
+    goto done;
+
+  latency = presented - sink->commit_time;
+  GST_LOG_OBJECT (sink, "frame presented %" GST_TIME_FORMAT " after commit",
+      GST_TIME_ARGS (latency));
+
+  /* smooth out the jitter of the compositor's repaint cycle */
+  if (GST_CLOCK_TIME_IS_VALID (sink->present_latency))
+    latency = (sink->present_latency * 7 + latency) / 8;
+
+  /* only report changes the latency calculation cares about */
+  if (!GST_CLOCK_TIME_IS_VALID (sink->reported_latency) ||
+      ABS (GST_CLOCK_DIFF (sink->reported_latency, latency)) > GST_MSECOND)
+    sink->present_latency_changed = TRUE;
+  sink->present_latency = latency;
+
+done:
+  if (feedback == sink->feedback)
+    sink->feedback = NULL;
+  g_mutex_unlock (&sink->render_lock);
+
+  wp_presentation_feedback_destroy (feedback);
+}
+
+static void
+presentation_feedback_discarded (void *data,
+    struct wp_presentation_feedback *feedback)
+{
+  GstWaylandSink *sink = data;
+
+  GST_LOG_OBJECT (sink, "frame discarded");
+
+  g_mutex_lock (&sink->render_lock);
+  if (feedback == sink->feedback)
+    sink->feedback = NULL;
+  g_mutex_unlock (&sink->render_lock);
+
+  wp_presentation_feedback_destroy (feedback);
+}
+
+static const struct wp_presentation_feedback_listener
+    presentation_feedback_listener = {
+  presentation_feedback_sync_output,
+  presentation_feedback_presented,
+  presentation_feedback_discarded
+};
+
 /* must be called with the render lock */
 static void
 render_last_buffer (GstWaylandSink * sink, gboolean redraw)
@@ -673,11 +768,24 @@ render_last_buffer (GstWaylandSink * sink, gboolean redraw)
   sink->callback = callback;
   wl_callback_add_listener (callback, &frame_callback_listener, sink);
 
+  /* only measure frames that carry new content */
+  if (sink->display->presentation && !redraw) {
+    if (sink->feedback)
+      wp_presentation_feedback_destroy (sink->feedback);
+    sink->feedback = wp_presentation_feedback (sink->display->presentation,
+        surface);
+    wp_presentation_feedback_add_listener (sink->feedback,
+        &presentation_feedback_listener, sink);
+  }
+
   if (G_UNLIKELY (sink->video_info_changed && !redraw)) {
     info = &sink->video_info;
     sink->video_info_changed = FALSE;
   }
   gst_wl_window_render (sink->window, wlbuffer, info);
+
+  if (sink->feedback && !redraw)
+    sink->commit_time = get_presentation_time (sink);
 }
 
 static void
@@ -701,6 +809,8 @@ gst_wayland_sink_show_frame (GstVideoSink * vsink, GstBuffer * buffer)
   GstVideoInfo old_vinfo;
   GstMemory *mem;
   struct wl_buffer *wbuf = NULL;
+  gchar *dmabuf_key = NULL;
+  GstClockTime present_latency = GST_CLOCK_TIME_NONE;
 
   GstFlowReturn ret = GST_FLOW_OK;
 
@@ -769,9 +879,22 @@ gst_wayland_sink_show_frame (GstVideoSink * vsink, GstBuffer * buffer)
       if (gst_is_dmabuf_memory (gst_buffer_peek_memory (buffer, i)))
         nb_dmabuf++;
 
-    if (nb_dmabuf && (nb_dmabuf == gst_buffer_n_memory (buffer)))
-      wbuf = gst_wl_linux_dmabuf_construct_wl_buffer (buffer, sink->display,
-          &sink->video_info);
+    if (nb_dmabuf && (nb_dmabuf == gst_buffer_n_memory (buffer))) {
+      /* reuse the wl_buffer of previous memory wrapping the same dmabufs */
+      dmabuf_key = gst_wl_linux_dmabuf_get_key (buffer, &sink->video_info);
+      if (dmabuf_key)
+        wbuf = gst_wl_display_take_dmabuf_buffer (sink->display, dmabuf_key);
+
+      if (wbuf)
+        GST_LOG_OBJECT (sink, "reusing wl_buffer %p for buffer %p", wbuf,
+            buffer);
+      else
+        wbuf = gst_wl_linux_dmabuf_construct_wl_buffer (buffer, sink->display,
+            &sink->video_info);
+
+      if (!wbuf)
+        g_clear_pointer (&dmabuf_key, g_free);
+    }
   }
 
   if (!wbuf && gst_wl_display_check_format_for_shm (sink->display, format)) {
@@ -854,6 +977,7 @@ gst_wayland_sink_show_frame (GstVideoSink * vsink, GstBuffer * buffer)
     goto no_wl_buffer;
 
   wlbuffer = gst_buffer_add_wl_buffer (buffer, wbuf, sink->display);
+  wlbuffer->dmabuf_key = dmabuf_key;
   to_render = buffer;
 
 render:
@@ -918,7 +1042,18 @@ dst_map_failed:
   }
 done:
   {
+    if (sink->present_latency_changed) {
+      present_latency = sink->reported_latency = sink->present_latency;
+      sink->present_latency_changed = FALSE;
+    }
     g_mutex_unlock (&sink->render_lock);
+
+    /* posts a latency message, so not under the render lock */
+    if (GST_CLOCK_TIME_IS_VALID (present_latency)) {
+      GST_DEBUG_OBJECT (sink, "presentation latency %" GST_TIME_FORMAT,
+          GST_TIME_ARGS (present_latency));
+      gst_base_sink_set_render_delay (GST_BASE_SINK (sink), present_latency);
+    }
     return ret;
   }
 }
@@ -69,6 +69,13 @@ struct _GstWaylandSink
   GstBuffer *last_buffer;
 
   struct wl_callback *callback;
+
+  /* presentation feedback, protected by render_lock */
+  struct wp_presentation_feedback *feedback;
+  GstClockTime commit_time;
+  GstClockTime present_latency;
+  GstClockTime reported_latency;
+  gboolean present_latency_changed;
 };
 
 struct _GstWaylandSinkClass
@@ -108,8 +108,15 @@ gst_wl_buffer_finalize (GObject * gobject)
 
   GST_TRACE_OBJECT (self, "finalize");
 
-  if (self->wlbuffer)
+  if (self->wlbuffer && self->dmabuf_key && self->display) {
+    gst_wl_display_park_dmabuf_buffer (self->display, self->dmabuf_key,
+        self->wlbuffer);
+    self->dmabuf_key = NULL;
+  } else if (self->wlbuffer) {
     wl_buffer_destroy (self->wlbuffer);
+  }
+
+  g_free (self->dmabuf_key);
 
   G_OBJECT_CLASS (gst_wl_buffer_parent_class)->finalize (gobject);
 }
@@ -132,7 +139,13 @@ static void
 buffer_release (void *data, struct wl_buffer *wl_buffer)
 {
   GstWlBuffer *self = data;
-  GstBuffer *buf = self->current_gstbuffer;
+  GstBuffer *buf;
+
+  /* kept by the display, not wrapping any GstMemory */
+  if (!self)
+    return;
+
+  buf = self->current_gstbuffer;
 
   GST_LOG_OBJECT (self, "wl_buffer::release (GstBuffer: %p)", buf);
 
@@ -173,7 +186,11 @@ gst_buffer_add_wl_buffer (GstBuffer * gstbuffer, struct wl_buffer *wlbuffer,
 
   gst_wl_display_register_buffer (self->display, self->gstmem, self);
 
-  wl_buffer_add_listener (self->wlbuffer, &buffer_listener, self);
+  /* a wl_buffer kept by the display already has the listener */
+  if (wl_proxy_get_listener ((struct wl_proxy *) self->wlbuffer))
+    wl_proxy_set_user_data ((struct wl_proxy *) self->wlbuffer, self);
+  else
+    wl_buffer_add_listener (self->wlbuffer, &buffer_listener, self);
 
   gst_mini_object_weak_ref (GST_MINI_OBJECT (self->gstmem),
       (GstMiniObjectNotify) gstmemory_disposed, self);
@@ -46,6 +46,10 @@ struct _GstWlBuffer
   GstWlDisplay *display;
 
   gboolean used_by_compositor;
+
+  /* identity of the dmabuf, the wl_buffer is kept by the display for this
+   * key when the GstMemory goes away */
+  gchar *dmabuf_key;
 };
 
 struct _GstWlBufferClass
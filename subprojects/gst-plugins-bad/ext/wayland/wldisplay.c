@@ -27,6 +27,10 @@
 #include "wlvideoformat.h"
 
 #include <errno.h>
+#include <time.h>
+
+/* number of wl_buffers kept for dmabufs that are no longer wrapped */
+#define DMABUF_CACHE_SIZE 32
 
 GST_DEBUG_CATEGORY_EXTERN (gstwayland_debug);
 #define GST_CAT_DEFAULT gstwayland_debug
@@ -49,6 +53,10 @@ gst_wl_display_init (GstWlDisplay * self)
   self->dmabuf_formats = g_array_new (FALSE, FALSE, sizeof (uint32_t));
   self->wl_fd_poll = gst_poll_new (TRUE);
   self->buffers = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->dmabuf_buffers = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, (GDestroyNotify) wl_buffer_destroy);
+  g_queue_init (&self->dmabuf_buffers_lru);
+  self->presentation_clock = CLOCK_MONOTONIC;
   g_mutex_init (&self->buffers_mutex);
 }
 
@@ -78,6 +86,9 @@ gst_wl_display_finalize (GObject * gobject)
       (GHFunc) gst_wl_buffer_force_release_and_unref, NULL);
   g_hash_table_remove_all (self->buffers);
 
+  g_queue_clear (&self->dmabuf_buffers_lru);
+  g_hash_table_unref (self->dmabuf_buffers);
+
   g_array_unref (self->shm_formats);
   g_array_unref (self->dmabuf_formats);
   gst_poll_free (self->wl_fd_poll);
@@ -87,6 +98,9 @@ gst_wl_display_finalize (GObject * gobject)
   if (self->viewporter)
     wp_viewporter_destroy (self->viewporter);
 
+  if (self->presentation)
+    wp_presentation_destroy (self->presentation);
+
   if (self->shm)
     wl_shm_destroy (self->shm);
 
@@ -195,6 +209,19 @@ gst_wl_display_check_format_for_dmabuf (GstWlDisplay * display,
   return FALSE;
 }
 
+static void
+presentation_clock_id (void *data, struct wp_presentation *presentation,
+    uint32_t clk_id)
+{
+  GstWlDisplay *self = data;
+
+  self->presentation_clock = clk_id;
+}
+
+static const struct wp_presentation_listener presentation_listener = {
+  presentation_clock_id,
+};
+
 static void
 handle_xdg_wm_base_ping (void *user_data, struct xdg_wm_base *xdg_wm_base,
     uint32_t serial)
@@ -233,6 +260,11 @@ registry_handle_global (void *data, struct wl_registry *registry,
   } else if (g_strcmp0 (interface, "wp_viewporter") == 0) {
     self->viewporter =
         wl_registry_bind (registry, id, &wp_viewporter_interface, 1);
+  } else if (g_strcmp0 (interface, "wp_presentation") == 0) {
+    self->presentation =
+        wl_registry_bind (registry, id, &wp_presentation_interface, 1);
+    wp_presentation_add_listener (self->presentation, &presentation_listener,
+        self);
   } else if (g_strcmp0 (interface, "zwp_linux_dmabuf_v1") == 0) {
     self->dmabuf =
         wl_registry_bind (registry, id, &zwp_linux_dmabuf_v1_interface, 1);
@@ -418,3 +450,55 @@ gst_wl_display_unregister_buffer (GstWlDisplay * self, gpointer gstmem)
     g_hash_table_remove (self->buffers, gstmem);
   g_mutex_unlock (&self->buffers_mutex);
 }
+
+/* Keeps the wl_buffer of a dmabuf whose GstMemory was freed, so that it can
+ * be used again when the same dmabuf comes back wrapped in a new GstMemory,
+ * for instance after upstream re-imported it. @key is transfer-full. */
+void
+gst_wl_display_park_dmabuf_buffer (GstWlDisplay * self, gchar * key,
+    struct wl_buffer *wlbuffer)
+{
+  g_mutex_lock (&self->buffers_mutex);
+  if (G_UNLIKELY (self->shutting_down)) {
+    g_mutex_unlock (&self->buffers_mutex);
+    wl_buffer_destroy (wlbuffer);
+    g_free (key);
+    return;
+  }
+
+  GST_TRACE_OBJECT (self, "keeping wl_buffer %p for %s", wlbuffer, key);
+
+  wl_proxy_set_user_data ((struct wl_proxy *) wlbuffer, NULL);
+
+  if (g_hash_table_contains (self->dmabuf_buffers, key)) {
+    g_queue_remove (&self->dmabuf_buffers_lru,
+        g_queue_find_custom (&self->dmabuf_buffers_lru, key,
+            (GCompareFunc) g_strcmp0)->data);
+    g_hash_table_remove (self->dmabuf_buffers, key);
+  } else if (g_hash_table_size (self->dmabuf_buffers) >= DMABUF_CACHE_SIZE) {
+    gchar *old = g_queue_pop_head (&self->dmabuf_buffers_lru);
+    g_hash_table_remove (self->dmabuf_buffers, old);
+  }
+
+  g_queue_push_tail (&self->dmabuf_buffers_lru, key);
+  g_hash_table_insert (self->dmabuf_buffers, key, wlbuffer);
+  g_mutex_unlock (&self->buffers_mutex);
+}
+
+struct wl_buffer *
+gst_wl_display_take_dmabuf_buffer (GstWlDisplay * self, const gchar * key)
+{
+  struct wl_buffer *wlbuffer = NULL;
+  gpointer orig_key;
+
+  g_mutex_lock (&self->buffers_mutex);
+  if (g_hash_table_lookup_extended (self->dmabuf_buffers, key, &orig_key,
+          (gpointer *) & wlbuffer)) {
+    g_queue_remove (&self->dmabuf_buffers_lru, orig_key);
+    g_hash_table_steal (self->dmabuf_buffers, orig_key);
+    g_free (orig_key);
+  }
+  g_mutex_unlock (&self->buffers_mutex);
+
+  return wlbuffer;
+}
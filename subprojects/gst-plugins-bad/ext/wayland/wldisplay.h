@@ -24,10 +24,12 @@
 #include <gst/gst.h>
 #include <gst/video/video.h>
 #include <wayland-client.h>
+#include <time.h>
 #include "xdg-shell-client-protocol.h"
 #include "viewporter-client-protocol.h"
 #include "linux-dmabuf-unstable-v1-client-protocol.h"
 #include "fullscreen-shell-unstable-v1-client-protocol.h"
+#include "presentation-time-client-protocol.h"
 
 G_BEGIN_DECLS
 
@@ -60,9 +62,13 @@ struct _GstWlDisplay
   struct wl_shm *shm;
   struct wp_viewporter *viewporter;
   struct zwp_linux_dmabuf_v1 *dmabuf;
+  struct wp_presentation *presentation;
   GArray *shm_formats;
   GArray *dmabuf_formats;
 
+  /* clock of the presentation timestamps */
+  clockid_t presentation_clock;
+
   /* private */
   gboolean own_display;
   GThread *thread;
@@ -71,6 +77,12 @@ struct _GstWlDisplay
   GMutex buffers_mutex;
   GHashTable *buffers;
   gboolean shutting_down;
+
+  /* dmabuf identity -> wl_buffer no longer wrapping any GstMemory, the queue
+   * holds the keys with the least recently used first. Protected by
+   * buffers_mutex */
+  GHashTable *dmabuf_buffers;
+  GQueue dmabuf_buffers_lru;
 };
 
 struct _GstWlDisplayClass
@@ -90,6 +102,11 @@ void gst_wl_display_register_buffer (GstWlDisplay * self, gpointer gstmem,
 void gst_wl_display_unregister_buffer (GstWlDisplay * self, gpointer gstmem);
 gpointer gst_wl_display_lookup_buffer (GstWlDisplay * self, gpointer gstmem);
 
+void gst_wl_display_park_dmabuf_buffer (GstWlDisplay * self, gchar * key,
+    struct wl_buffer * wlbuffer);
+struct wl_buffer *gst_wl_display_take_dmabuf_buffer (GstWlDisplay * self,
+    const gchar * key);
+
 gboolean gst_wl_display_check_format_for_shm (GstWlDisplay * display,
     GstVideoFormat format);
 gboolean gst_wl_display_check_format_for_dmabuf (GstWlDisplay * display,
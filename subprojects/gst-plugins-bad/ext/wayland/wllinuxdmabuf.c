@@ -24,6 +24,7 @@
 #endif
 
 #include <gst/allocators/gstdmabuf.h>
+#include <sys/stat.h>
 
 #include "wllinuxdmabuf.h"
 #include "wlvideoformat.h"
@@ -162,3 +163,46 @@ out:
 
   return data.wbuf;
 }
+
+/* Identifies the dmabufs and layout of @buf, the same key means the
+ * wl_buffer of a previous GstMemory can be used. Returns NULL if the
+ * dmabufs cannot be identified. */
+gchar *
+gst_wl_linux_dmabuf_get_key (GstBuffer * buf, const GstVideoInfo * info)
+{
+  GString *key;
+  guint i, nplanes;
+
+  nplanes = GST_VIDEO_INFO_N_PLANES (info);
+
+  key = g_string_new (NULL);
+  g_string_append_printf (key, "%s:%dx%d:%x", GST_VIDEO_INFO_NAME (info),
+      GST_VIDEO_INFO_WIDTH (info), GST_VIDEO_INFO_HEIGHT (info),
+      GST_BUFFER_FLAGS (buf) & (GST_VIDEO_BUFFER_FLAG_INTERLACED |
+          GST_VIDEO_BUFFER_FLAG_TFF));
+
+  for (i = 0; i < nplanes; i++) {
+    guint offset, mem_idx, length;
+    gsize skip;
+    GstMemory *m;
+    struct stat st;
+
+    offset = GST_VIDEO_INFO_PLANE_OFFSET (info, i);
+    if (!gst_buffer_find_memory (buf, offset, 1, &mem_idx, &length, &skip))
+      goto failed;
+
+    m = gst_buffer_peek_memory (buf, mem_idx);
+    if (fstat (gst_dmabuf_memory_get_fd (m), &st) < 0)
+      goto failed;
+
+    g_string_append_printf (key, "/%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT
+        ":%" G_GSIZE_FORMAT ":%d", (guint64) st.st_dev, (guint64) st.st_ino,
+        m->offset + skip, GST_VIDEO_INFO_PLANE_STRIDE (info, i));
+  }
+
+  return g_string_free (key, FALSE);
+
+failed:
+  g_string_free (key, TRUE);
+  return NULL;
+}
@@ -33,6 +33,9 @@ G_BEGIN_DECLS
 struct wl_buffer * gst_wl_linux_dmabuf_construct_wl_buffer (GstBuffer * buf,
     GstWlDisplay * display, const GstVideoInfo * info);
 
+gchar * gst_wl_linux_dmabuf_get_key (GstBuffer * buf,
+    const GstVideoInfo * info);
+
 G_END_DECLS
 
 #endif /* __GST_WL_LINUX_DMABUF_H__ */
@@ -65,6 +65,8 @@
 #define RTPSTORAGE_EXTRA_TIME (50)
 
 #define DEFAULT_JB_LATENCY 200
+#define DEFAULT_ICE_SHARED_THREAD FALSE
+#define DEFAULT_STATS_CACHE_TIME 0
 
 #define RTPHDREXT_MID GST_RTP_HDREXT_BASE "sdes:mid"
 #define RTPHDREXT_STREAM_ID GST_RTP_HDREXT_BASE "sdes:rtp-stream-id"
@@ -485,6 +487,7 @@ enum
   ON_ICE_CANDIDATE_SIGNAL,
   ON_NEW_TRANSCEIVER_SIGNAL,
   GET_STATS_SIGNAL,
+  GET_STATS_DELTA_SIGNAL,
   ADD_TRANSCEIVER_SIGNAL,
   GET_TRANSCEIVER_SIGNAL,
   GET_TRANSCEIVERS_SIGNAL,
@@ -514,6 +517,8 @@ enum
   PROP_ICE_AGENT,
   PROP_LATENCY,
   PROP_SCTP_TRANSPORT,
+  PROP_ICE_SHARED_THREAD,
+  PROP_STATS_CACHE_TIME,
 };
 
 static guint gst_webrtc_bin_signals[LAST_SIGNAL] = { 0 };
@@ -6625,6 +6630,7 @@ struct get_stats
 {
   GstPad *pad;
   GstPromise *promise;
+  gboolean delta;
 };
 
 static void
@@ -6641,24 +6647,70 @@ _free_get_stats (struct get_stats *stats)
 static GstStructure *
 _get_stats_task (GstWebRTCBin * webrtc, struct get_stats *stats)
 {
+  GstStructure *s, *delta;
+
   /* Our selector is the pad,
    * https://www.w3.org/TR/webrtc/#dfn-stats-selection-algorithm
    */
 
-  return gst_webrtc_bin_create_stats (webrtc, stats->pad);
+  s = gst_webrtc_bin_create_stats (webrtc, stats->pad);
+
+  g_mutex_lock (&webrtc->priv->stats_lock);
+  if (!stats->pad && webrtc->priv->stats_cache_time > 0) {
+    gst_clear_structure (&webrtc->priv->stats_cache);
+    webrtc->priv->stats_cache = gst_structure_copy (s);
+    webrtc->priv->stats_cache_timestamp = g_get_monotonic_time ();
+  }
+
+  if (stats->delta) {
+    delta = gst_webrtc_bin_diff_stats (webrtc->priv->stats_delta_previous, s);
+    gst_clear_structure (&webrtc->priv->stats_delta_previous);
+    webrtc->priv->stats_delta_previous = s;
+    s = delta;
+  }
+  g_mutex_unlock (&webrtc->priv->stats_lock);
+
+  return s;
+}
+
+/* Replies to @promise with a copy of the cached stats if they are recent
+ * enough, without having to wait for the peerconnection thread */
+static gboolean
+_reply_cached_stats (GstWebRTCBin * webrtc, GstPromise * promise)
+{
+  GstStructure *s = NULL;
+
+  g_mutex_lock (&webrtc->priv->stats_lock);
+  if (webrtc->priv->stats_cache &&
+      g_get_monotonic_time () - webrtc->priv->stats_cache_timestamp <
+      (gint64) webrtc->priv->stats_cache_time * G_TIME_SPAN_MILLISECOND)
+    s = gst_structure_copy (webrtc->priv->stats_cache);
+  g_mutex_unlock (&webrtc->priv->stats_lock);
+
+  if (!s)
+    return FALSE;
+
+  GST_LOG_OBJECT (webrtc, "replying with cached stats");
+  gst_promise_reply (promise, s);
+
+  return TRUE;
 }
 
 static void
-gst_webrtc_bin_get_stats (GstWebRTCBin * webrtc, GstPad * pad,
-    GstPromise * promise)
+_get_stats_full (GstWebRTCBin * webrtc, GstPad * pad, GstPromise * promise,
+    gboolean delta)
 {
   struct get_stats *stats;
 
   g_return_if_fail (promise != NULL);
   g_return_if_fail (pad == NULL || GST_IS_WEBRTC_BIN_PAD (pad));
 
+  if (!pad && !delta && _reply_cached_stats (webrtc, promise))
+    return;
+
   stats = g_new0 (struct get_stats, 1);
   stats->promise = gst_promise_ref (promise);
+  stats->delta = delta;
   /* FIXME: check that pad exists in element */
   if (pad)
     stats->pad = gst_object_ref (pad);
@@ -6677,6 +6729,20 @@ gst_webrtc_bin_get_stats (GstWebRTCBin * webrtc, GstPad * pad,
   }
 }
 
+static void
+gst_webrtc_bin_get_stats (GstWebRTCBin * webrtc, GstPad * pad,
+    GstPromise * promise)
+{
+  _get_stats_full (webrtc, pad, promise, FALSE);
+}
+
+static void
+gst_webrtc_bin_get_stats_delta (GstWebRTCBin * webrtc, GstPad * pad,
+    GstPromise * promise)
+{
+  _get_stats_full (webrtc, pad, promise, TRUE);
+}
+
 static GstWebRTCRTPTransceiver *
 gst_webrtc_bin_add_transceiver (GstWebRTCBin * webrtc,
     GstWebRTCRTPTransceiverDirection direction, GstCaps * caps)
@@ -7928,6 +7994,15 @@ gst_webrtc_bin_set_property (GObject * object, guint prop_id,
       webrtc->priv->jb_latency = g_value_get_uint (value);
       _update_rtpstorage_latency (webrtc);
       break;
+    case PROP_ICE_SHARED_THREAD:
+      webrtc->priv->ice_shared_thread = g_value_get_boolean (value);
+      break;
+    case PROP_STATS_CACHE_TIME:
+      g_mutex_lock (&webrtc->priv->stats_lock);
+      webrtc->priv->stats_cache_time = g_value_get_uint (value);
+      gst_clear_structure (&webrtc->priv->stats_cache);
+      g_mutex_unlock (&webrtc->priv->stats_lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -8005,6 +8080,14 @@ gst_webrtc_bin_get_property (GObject * object, guint prop_id,
     case PROP_SCTP_TRANSPORT:
       g_value_set_object (value, webrtc->priv->sctp_transport);
       break;
+    case PROP_ICE_SHARED_THREAD:
+      g_value_set_boolean (value, webrtc->priv->ice_shared_thread);
+      break;
+    case PROP_STATS_CACHE_TIME:
+      g_mutex_lock (&webrtc->priv->stats_lock);
+      g_value_set_uint (value, webrtc->priv->stats_cache_time);
+      g_mutex_unlock (&webrtc->priv->stats_lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -8019,7 +8102,8 @@ gst_webrtc_bin_constructed (GObject * object)
   gchar *name;
 
   name = g_strdup_printf ("%s:ice", GST_OBJECT_NAME (webrtc));
-  webrtc->priv->ice = gst_webrtc_ice_new (name);
+  webrtc->priv->ice = gst_webrtc_ice_new_full (name,
+      webrtc->priv->ice_shared_thread);
 
   gst_webrtc_ice_set_on_ice_candidate (webrtc->priv->ice,
       (GstWebRTCIceOnCandidateFunc) _on_local_ice_candidate_cb, webrtc, NULL);
@@ -8113,6 +8197,10 @@ gst_webrtc_bin_finalize (GObject * object)
     gst_webrtc_session_description_free (webrtc->priv->last_generated_offer);
   webrtc->priv->last_generated_offer = NULL;
 
+  gst_clear_structure (&webrtc->priv->stats_cache);
+  gst_clear_structure (&webrtc->priv->stats_delta_previous);
+  g_mutex_clear (&webrtc->priv->stats_lock);
+
   g_mutex_clear (DC_GET_LOCK (webrtc));
   g_mutex_clear (ICE_GET_LOCK (webrtc));
   g_mutex_clear (PC_GET_LOCK (webrtc));
@@ -8298,6 +8386,41 @@ gst_webrtc_bin_class_init (GstWebRTCBinClass * klass)
           GST_TYPE_WEBRTC_SCTP_TRANSPORT,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstWebRTCBin:ice-shared-thread:
+   *
+   * Run the ICE agent of this webrtcbin on a thread shared with all other
+   * webrtcbin instances in the process that have this property set. Servers
+   * handling many peers otherwise end up with one ICE thread per peer.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_ICE_SHARED_THREAD,
+      g_param_spec_boolean ("ice-shared-thread", "ICE shared thread",
+          "Run the ICE agent on a thread shared with all other webrtcbin "
+          "instances in the process that have this property set",
+          DEFAULT_ICE_SHARED_THREAD,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstWebRTCBin:stats-cache-time:
+   *
+   * Time in milliseconds for which the result of a #GstWebRTCBin::get-stats
+   * call for all pads is cached. Calls within that time are answered with a
+   * copy of the cached stats directly, without walking all transceivers and
+   * taking the peerconnection lock. 0 disables the cache.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_STATS_CACHE_TIME,
+      g_param_spec_uint ("stats-cache-time", "Stats cache time",
+          "Time in milliseconds for which the stats of all pads are cached "
+          "(0 = disabled)", 0, G_MAXUINT, DEFAULT_STATS_CACHE_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstWebRTCBin::create-offer:
    * @object: the #webrtcbin
@@ -8458,6 +8581,25 @@ gst_webrtc_bin_class_init (GstWebRTCBinClass * klass)
       G_CALLBACK (gst_webrtc_bin_get_stats), NULL, NULL, NULL,
       G_TYPE_NONE, 2, GST_TYPE_PAD, GST_TYPE_PROMISE);
 
+  /**
+   * GstWebRTCBin::get-stats-delta:
+   * @object: the #webrtcbin
+   * @pad: (nullable): A #GstPad to get the stats for, or %NULL for all
+   * @promise: a #GstPromise for the result
+   *
+   * Like #GstWebRTCBin::get-stats but the reply only contains the stats
+   * objects that were added or changed since the previous call of this
+   * signal. Changes of the "timestamp" field alone are ignored. The first
+   * call returns all stats objects.
+   *
+   * Since: 1.22
+   */
+  gst_webrtc_bin_signals[GET_STATS_DELTA_SIGNAL] =
+      g_signal_new_class_handler ("get-stats-delta",
+      G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_CALLBACK (gst_webrtc_bin_get_stats_delta), NULL, NULL, NULL,
+      G_TYPE_NONE, 2, GST_TYPE_PAD, GST_TYPE_PROMISE);
+
   /**
    * GstWebRTCBin::on-negotiation-needed:
    * @object: the #webrtcbin
@@ -8626,6 +8768,8 @@ gst_webrtc_bin_init (GstWebRTCBin * webrtc)
 
   g_mutex_init (ICE_GET_LOCK (webrtc));
   g_mutex_init (DC_GET_LOCK (webrtc));
+  g_mutex_init (&webrtc->priv->stats_lock);
+  webrtc->priv->stats_cache_time = DEFAULT_STATS_CACHE_TIME;
 
   webrtc->rtpbin = _create_rtpbin (webrtc);
   gst_bin_add (GST_BIN (webrtc), webrtc->rtpbin);
@@ -112,6 +112,7 @@ struct _GstWebRTCBinPrivate
   TransportStream *data_channel_transport;
 
   GstWebRTCICE *ice;
+  gboolean ice_shared_thread;
   GArray *ice_stream_map;
   GMutex ice_lock;
   GArray *pending_remote_ice_candidates;
@@ -143,6 +144,13 @@ struct _GstWebRTCBinPrivate
   GstWebRTCSessionDescription *last_generated_answer;
 
   gboolean tos_attached;
+
+  /* stats_lock protects the stats_* fields */
+  GMutex stats_lock;
+  guint stats_cache_time;
+  GstStructure *stats_cache;
+  gint64 stats_cache_timestamp;
+  GstStructure *stats_delta_previous;
 };
 
 typedef GstStructure *(*GstWebRTCBinFunc) (GstWebRTCBin * webrtc, gpointer data);
@@ -66,8 +66,11 @@ enum
   PROP_ICE_UDP,
   PROP_MIN_RTP_PORT,
   PROP_MAX_RTP_PORT,
+  PROP_SHARED_THREAD,
 };
 
+#define DEFAULT_SHARED_THREAD FALSE
+
 static guint gst_webrtc_ice_signals[LAST_SIGNAL] = { 0 };
 
 struct _GstWebRTCICEPrivate
@@ -76,6 +79,7 @@ struct _GstWebRTCICEPrivate
 
   GArray *nice_stream_map;
 
+  gboolean shared_thread;
   GThread *thread;
   GMainContext *main_context;
   GMainLoop *loop;
@@ -124,9 +128,98 @@ _gst_nice_thread (GstWebRTCICE * ice)
   return NULL;
 }
 
+/* Thread and main context shared by all agents created with the
+ * shared-thread property, so that the number of threads does not grow with
+ * the number of peers */
+typedef struct
+{
+  GThread *thread;
+  GMainContext *main_context;
+  GMainLoop *loop;
+  guint refcount;
+} SharedNiceThread;
+
+G_LOCK_DEFINE_STATIC (shared_nice_thread);
+static SharedNiceThread *shared_nice_thread = NULL;
+
+static gpointer
+_gst_nice_shared_thread (SharedNiceThread * shared)
+{
+  g_main_loop_run (shared->loop);
+
+  g_main_loop_unref (shared->loop);
+  g_main_context_unref (shared->main_context);
+  g_free (shared);
+
+  return NULL;
+}
+
+static gboolean
+_quit_shared_loop (GMainLoop * loop)
+{
+  g_main_loop_quit (loop);
+  return G_SOURCE_REMOVE;
+}
+
+static void
+_start_shared_thread (GstWebRTCICE * ice)
+{
+  G_LOCK (shared_nice_thread);
+  if (!shared_nice_thread) {
+    SharedNiceThread *shared = g_new0 (SharedNiceThread, 1);
+
+    GST_DEBUG_OBJECT (ice, "starting shared ICE thread");
+
+    shared->main_context = g_main_context_new ();
+    shared->loop = g_main_loop_new (shared->main_context, FALSE);
+    shared->thread = g_thread_new ("webrtc-ice-shared",
+        (GThreadFunc) _gst_nice_shared_thread, shared);
+    shared_nice_thread = shared;
+  }
+  shared_nice_thread->refcount++;
+  ice->priv->main_context =
+      g_main_context_ref (shared_nice_thread->main_context);
+  G_UNLOCK (shared_nice_thread);
+}
+
+static void
+_stop_shared_thread (GstWebRTCICE * ice)
+{
+  GThread *thread = NULL;
+
+  G_LOCK (shared_nice_thread);
+  if (--shared_nice_thread->refcount == 0) {
+    GST_DEBUG_OBJECT (ice, "stopping shared ICE thread");
+
+    /* quitting from inside the loop also works if the loop did not start
+     * running yet */
+    g_main_context_invoke (shared_nice_thread->main_context,
+        (GSourceFunc) _quit_shared_loop, shared_nice_thread->loop);
+    thread = shared_nice_thread->thread;
+    shared_nice_thread = NULL;
+  }
+  G_UNLOCK (shared_nice_thread);
+
+  if (thread) {
+    /* the last agent may be finalized from a callback in the thread itself */
+    if (thread == g_thread_self ())
+      g_thread_unref (thread);
+    else
+      g_thread_join (thread);
+  }
+
+  g_main_context_unref (ice->priv->main_context);
+  ice->priv->main_context = NULL;
+}
+
 static void
 _start_thread (GstWebRTCICE * ice)
 {
+  if (ice->priv->shared_thread) {
+    _start_shared_thread (ice);
+    return;
+  }
+
   g_mutex_lock (&ice->priv->lock);
   ice->priv->thread = g_thread_new (GST_OBJECT_NAME (ice),
       (GThreadFunc) _gst_nice_thread, ice);
@@ -139,6 +232,11 @@ _start_thread (GstWebRTCICE * ice)
 static void
 _stop_thread (GstWebRTCICE * ice)
 {
+  if (ice->priv->shared_thread) {
+    _stop_shared_thread (ice);
+    return;
+  }
+
   g_mutex_lock (&ice->priv->lock);
   g_main_loop_quit (ice->priv->loop);
   while (ice->priv->loop)
@@ -1229,6 +1327,10 @@ gst_webrtc_ice_set_property (GObject * object, guint prop_id,
             " min-rtp-port %u", ice->max_rtp_port, ice->min_rtp_port);
       break;
 
+    case PROP_SHARED_THREAD:
+      ice->priv->shared_thread = g_value_get_boolean (value);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1262,6 +1364,10 @@ gst_webrtc_ice_get_property (GObject * object, guint prop_id,
       g_value_set_uint (value, ice->max_rtp_port);
       break;
 
+    case PROP_SHARED_THREAD:
+      g_value_set_boolean (value, ice->priv->shared_thread);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1379,6 +1485,24 @@ gst_webrtc_ice_class_init (GstWebRTCICEClass * klass)
           0, 65535, 65535,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstWebRTCICE:shared-thread:
+   *
+   * Run the ICE agent on a main context and thread that is shared with all
+   * other agents in the process that have this property set, instead of on
+   * a thread of its own.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_SHARED_THREAD,
+      g_param_spec_boolean ("shared-thread", "Shared thread",
+          "Run the agent on a thread shared with all other agents in the "
+          "process that have this property set",
+          DEFAULT_SHARED_THREAD,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+          G_PARAM_STATIC_STRINGS));
+
   /**
    * GstWebRTCICE::add-local-ip-address:
    * @object: the #GstWebRTCICE
@@ -1420,3 +1544,10 @@ gst_webrtc_ice_new (const gchar * name)
 {
   return g_object_new (GST_TYPE_WEBRTC_ICE, "name", name, NULL);
 }
+
+GstWebRTCICE *
+gst_webrtc_ice_new_full (const gchar * name, gboolean shared_thread)
+{
+  return g_object_new (GST_TYPE_WEBRTC_ICE, "name", name, "shared-thread",
+      shared_thread, NULL);
+}
@@ -74,6 +74,8 @@ struct _GstWebRTCICEClass
 };
 
 GstWebRTCICE *              gst_webrtc_ice_new                      (const gchar * name);
+GstWebRTCICE *              gst_webrtc_ice_new_full                 (const gchar * name,
+                                                                     gboolean shared_thread);
 GstWebRTCICEStream *        gst_webrtc_ice_add_stream               (GstWebRTCICE * ice,
                                                                      guint session_id);
 GstWebRTCICETransport *     gst_webrtc_ice_find_transport           (GstWebRTCICE * ice,
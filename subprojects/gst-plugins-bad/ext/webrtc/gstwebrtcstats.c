@@ -1009,3 +1009,65 @@ gst_webrtc_bin_create_stats (GstWebRTCBin * webrtc, GstPad * pad)
 
   return s;
 }
+
+static gboolean
+_stats_equal_ignoring_timestamp (const GstStructure * a, const GstStructure * b)
+{
+  GstStructure *ca, *cb;
+  gboolean ret;
+
+  ca = gst_structure_copy (a);
+  cb = gst_structure_copy (b);
+  gst_structure_remove_field (ca, "timestamp");
+  gst_structure_remove_field (cb, "timestamp");
+
+  ret = gst_structure_is_equal (ca, cb);
+
+  gst_structure_free (ca);
+  gst_structure_free (cb);
+
+  return ret;
+}
+
+struct stats_diff
+{
+  const GstStructure *previous;
+  GstStructure *delta;
+};
+
+static gboolean
+_diff_stats_field (GQuark field_id, const GValue * value,
+    struct stats_diff *diff)
+{
+  const GValue *prev_value;
+
+  if (G_VALUE_TYPE (value) == GST_TYPE_STRUCTURE && diff->previous) {
+    prev_value = gst_structure_id_get_value (diff->previous, field_id);
+
+    if (prev_value && G_VALUE_TYPE (prev_value) == GST_TYPE_STRUCTURE &&
+        _stats_equal_ignoring_timestamp (gst_value_get_structure (value),
+            gst_value_get_structure (prev_value)))
+      return TRUE;
+  }
+
+  gst_structure_id_set_value (diff->delta, field_id, value);
+
+  return TRUE;
+}
+
+/* Returns the stats objects of @current that are new or changed compared to
+ * @previous, ignoring their timestamps */
+GstStructure *
+gst_webrtc_bin_diff_stats (const GstStructure * previous,
+    const GstStructure * current)
+{
+  struct stats_diff diff;
+
+  diff.previous = previous;
+  diff.delta = gst_structure_new_empty (gst_structure_get_name (current));
+
+  gst_structure_foreach (current, (GstStructureForeachFunc) _diff_stats_field,
+      &diff);
+
+  return diff.delta;
+}
@@ -30,6 +30,9 @@ G_BEGIN_DECLS
 G_GNUC_INTERNAL
 GstStructure *     gst_webrtc_bin_create_stats         (GstWebRTCBin * webrtc,
                                                         GstPad * pad);
+G_GNUC_INTERNAL
+GstStructure *     gst_webrtc_bin_diff_stats           (const GstStructure * previous,
+                                                        const GstStructure * current);
 
 G_END_DECLS
 
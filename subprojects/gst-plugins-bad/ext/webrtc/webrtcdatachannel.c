@@ -274,6 +274,81 @@ _channel_store_error (WebRTCDataChannel * channel, GError * error)
   GST_WEBRTC_DATA_CHANNEL_UNLOCK (channel);
 }
 
+static void _close_procedure (WebRTCDataChannel * channel,
+    gpointer user_data);
+
+static void
+_emit_high_threshold (WebRTCDataChannel * channel, gpointer user_data)
+{
+  gst_webrtc_data_channel_on_buffered_amount_high (GST_WEBRTC_DATA_CHANNEL
+      (channel));
+}
+
+/* Messages are not pushed into appsrc one by one. They are collected in
+ * pending_buffers and handed over as a single buffer list whenever the appsrc
+ * streaming thread asks for more data, so that a burst of small messages
+ * traverses appsrc and sctpenc once per wakeup instead of once per message.
+ *
+ * Call with the channel lock */
+static GstFlowReturn
+_channel_queue_buffer (WebRTCDataChannel * channel, GstBuffer * buffer)
+{
+  guint64 prev_amount = channel->parent.buffered_amount;
+  guint64 high_threshold = channel->parent.buffered_amount_high_threshold;
+
+  channel->parent.buffered_amount += gst_buffer_get_size (buffer);
+
+  if (high_threshold > 0 && prev_amount < high_threshold
+      && channel->parent.buffered_amount >= high_threshold) {
+    _channel_enqueue_task (channel, (ChannelTask) _emit_high_threshold, NULL,
+        NULL);
+  }
+
+  if (!channel->pending_buffers)
+    channel->pending_buffers = gst_buffer_list_new ();
+  gst_buffer_list_add (channel->pending_buffers, buffer);
+
+  if (!channel->appsrc_waiting)
+    return GST_FLOW_OK;
+
+  channel->appsrc_waiting = FALSE;
+
+  /* appsrc does not block, so this only queues and wakes up the streaming
+   * thread */
+  return gst_app_src_push_buffer_list (GST_APP_SRC (channel->appsrc),
+      g_steal_pointer (&channel->pending_buffers));
+}
+
+static void
+on_appsrc_need_data (GstAppSrc * appsrc, guint length, gpointer user_data)
+{
+  WebRTCDataChannel *channel = user_data;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  GST_WEBRTC_DATA_CHANNEL_LOCK (channel);
+  if (channel->pending_buffers) {
+    GST_TRACE_OBJECT (channel, "Pushing %u pending messages",
+        gst_buffer_list_length (channel->pending_buffers));
+    ret = gst_app_src_push_buffer_list (appsrc,
+        g_steal_pointer (&channel->pending_buffers));
+  } else {
+    channel->appsrc_waiting = TRUE;
+  }
+  GST_WEBRTC_DATA_CHANNEL_UNLOCK (channel);
+
+  if (ret != GST_FLOW_OK) {
+    GError *error = NULL;
+    g_set_error (&error, GST_WEBRTC_ERROR,
+        GST_WEBRTC_ERROR_DATA_CHANNEL_FAILURE, "Failed to send data");
+    _channel_store_error (channel, error);
+    _channel_enqueue_task (channel, (ChannelTask) _close_procedure, NULL, NULL);
+  }
+}
+
+static GstAppSrcCallbacks src_callbacks = {
+  on_appsrc_need_data,
+};
+
 static void
 _emit_on_open (WebRTCDataChannel * channel, gpointer user_data)
 {
@@ -477,10 +552,9 @@ _parse_control_packet (WebRTCDataChannel * channel, guint8 * data,
     buffer = construct_ack_packet (channel);
 
     GST_WEBRTC_DATA_CHANNEL_LOCK (channel);
-    channel->parent.buffered_amount += gst_buffer_get_size (buffer);
+    ret = _channel_queue_buffer (channel, buffer);
     GST_WEBRTC_DATA_CHANNEL_UNLOCK (channel);
 
-    ret = gst_app_src_push_buffer (GST_APP_SRC (channel->appsrc), buffer);
     if (ret != GST_FLOW_OK) {
       g_set_error (error, GST_WEBRTC_ERROR,
           GST_WEBRTC_ERROR_DATA_CHANNEL_FAILURE, "Could not send ack packet");
@@ -692,6 +766,7 @@ void
 webrtc_data_channel_start_negotiation (WebRTCDataChannel * channel)
 {
   GstBuffer *buffer;
+  GstFlowReturn ret;
 
   g_return_if_fail (!channel->parent.negotiated);
   g_return_if_fail (channel->parent.id != -1);
@@ -705,12 +780,11 @@ webrtc_data_channel_start_negotiation (WebRTCDataChannel * channel)
       channel->parent.ordered ? "true" : "false");
 
   GST_WEBRTC_DATA_CHANNEL_LOCK (channel);
-  channel->parent.buffered_amount += gst_buffer_get_size (buffer);
+  ret = _channel_queue_buffer (channel, buffer);
   GST_WEBRTC_DATA_CHANNEL_UNLOCK (channel);
   g_object_notify (G_OBJECT (&channel->parent), "buffered-amount");
 
-  if (gst_app_src_push_buffer (GST_APP_SRC (channel->appsrc),
-          buffer) == GST_FLOW_OK) {
+  if (ret == GST_FLOW_OK) {
     channel->opened = TRUE;
     _channel_enqueue_task (channel, (ChannelTask) _emit_on_open, NULL, NULL);
   } else {
@@ -789,12 +863,10 @@ webrtc_data_channel_send_data (GstWebRTCDataChannel * base_channel,
       buffer);
 
   GST_WEBRTC_DATA_CHANNEL_LOCK (channel);
-  channel->parent.buffered_amount += gst_buffer_get_size (buffer);
+  ret = _channel_queue_buffer (channel, buffer);
   GST_WEBRTC_DATA_CHANNEL_UNLOCK (channel);
   g_object_notify (G_OBJECT (&channel->parent), "buffered-amount");
 
-  ret = gst_app_src_push_buffer (GST_APP_SRC (channel->appsrc), buffer);
-
   if (ret != GST_FLOW_OK) {
     GError *error = NULL;
     g_set_error (&error, GST_WEBRTC_ERROR,
@@ -852,12 +924,10 @@ webrtc_data_channel_send_string (GstWebRTCDataChannel * base_channel,
       buffer);
 
   GST_WEBRTC_DATA_CHANNEL_LOCK (channel);
-  channel->parent.buffered_amount += gst_buffer_get_size (buffer);
+  ret = _channel_queue_buffer (channel, buffer);
   GST_WEBRTC_DATA_CHANNEL_UNLOCK (channel);
   g_object_notify (G_OBJECT (&channel->parent), "buffered-amount");
 
-  ret = gst_app_src_push_buffer (GST_APP_SRC (channel->appsrc), buffer);
-
   if (ret != GST_FLOW_OK) {
     GError *error = NULL;
     g_set_error (&error, GST_WEBRTC_ERROR,
@@ -985,6 +1055,8 @@ gst_webrtc_data_channel_constructed (GObject * object)
       NULL);
   gst_app_sink_set_callbacks (GST_APP_SINK (channel->appsink), &sink_callbacks,
       channel, NULL);
+  gst_app_src_set_callbacks (GST_APP_SRC (channel->appsrc), &src_callbacks,
+      channel, NULL);
 
   gst_object_unref (pad);
   gst_caps_unref (caps);
@@ -1012,6 +1084,14 @@ gst_webrtc_data_channel_finalize (GObject * object)
     channel->src_probe = 0;
   }
 
+  if (channel->appsrc) {
+    GstAppSrcCallbacks no_callbacks = { NULL, };
+
+    gst_app_src_set_callbacks (GST_APP_SRC (channel->appsrc), &no_callbacks,
+        NULL, NULL);
+  }
+  gst_clear_buffer_list (&channel->pending_buffers);
+
   if (channel->sctp_transport)
     g_signal_handlers_disconnect_by_data (channel->sctp_transport, channel);
   g_clear_object (&channel->sctp_transport);
@@ -55,6 +55,10 @@ struct _WebRTCDataChannel
   GError                           *stored_error;
   gboolean                          peer_closed;
 
+  /* protected by the channel lock */
+  GstBufferList                    *pending_buffers;
+  gboolean                          appsrc_waiting;
+
   gpointer                          _padding[GST_PADDING];
 };
 
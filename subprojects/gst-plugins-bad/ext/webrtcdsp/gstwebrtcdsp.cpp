@@ -37,7 +37,10 @@
  * webrtcdsp and the webrtechoprobe. Though, the number of channels can differ.
  * The probe is found by the DSP element using it's object name. By default,
  * webrtcdsp looks for webrtcechoprobe0, which means it just work if you have
- * a single probe and DSP.
+ * a single probe and DSP. When a single far-end mix is heard by several
+ * near-end captures, as in a conferencing server, set the
+ * #webrtcechoprobe:shared property so that all the DSP elements can use the
+ * same probe.
  *
  * The probe can only be used within the same top level GstPipeline.
  * Additionally, to simplify the code, the probe element must be created
@@ -248,7 +251,11 @@ struct _GstWebrtcDsp
   /* Protected by the stream lock */
   GstAdapter *adapter;
   GstPlanarAudioAdapter *padapter;
+  GstBuffer *direct;
   webrtc::AudioProcessing * apm;
+  guint64 probe_position;
+  gfloat *reverse_scratch;
+  gsize reverse_scratch_size;
 
   /* Protected by the object lock */
   gchar *probe_name;
@@ -397,7 +404,8 @@ gst_webrtc_dsp_analyze_reverse_stream (GstWebrtcDsp * self,
     rec_time = GST_CLOCK_TIME_NONE;
 
 again:
-  delay = gst_webrtc_echo_probe_read (probe, rec_time, (gpointer) &frame, &buf);
+  delay = gst_webrtc_echo_probe_read (probe, rec_time, (gpointer) &frame, &buf,
+      &self->probe_position);
   apm->set_stream_delay_ms (delay);
 
   if (delay < 0)
@@ -417,10 +425,31 @@ again:
         false);
     GstAudioBuffer abuf;
     float * const * data;
+    float **dest;
+
+    /* A shared probe hands out read-only periods, the processed reverse
+     * stream is not used so write it to a scratch area */
+    if (gst_buffer_is_writable (buf)) {
+      gst_audio_buffer_map (&abuf, &self->info, buf, GST_MAP_READWRITE);
+      dest = (float **) abuf.planes;
+    } else {
+      gsize size = frame.num_channels_ * frame.samples_per_channel_;
+      gint c;
+
+      if (self->reverse_scratch_size < size) {
+        g_free (self->reverse_scratch);
+        self->reverse_scratch = g_new (gfloat, size);
+        self->reverse_scratch_size = size;
+      }
+
+      gst_audio_buffer_map (&abuf, &self->info, buf, GST_MAP_READ);
+      dest = g_newa (float *, frame.num_channels_);
+      for (c = 0; c < (gint) frame.num_channels_; c++)
+        dest[c] = self->reverse_scratch + c * frame.samples_per_channel_;
+    }
 
-    gst_audio_buffer_map (&abuf, &self->info, buf, GST_MAP_READWRITE);
     data = (float * const *) abuf.planes;
-    if ((err = apm->ProcessReverseStream (data, config, config, data)) < 0)
+    if ((err = apm->ProcessReverseStream (data, config, config, dest)) < 0)
       GST_WARNING_OBJECT (self, "Reverse stream analyses failed: %s.",
           webrtc_error_to_string (err));
     gst_audio_buffer_unmap (&abuf);
@@ -443,9 +472,8 @@ done:
 
 static void
 gst_webrtc_vad_post_activity (GstWebrtcDsp *self, GstBuffer *buffer,
-    gboolean stream_has_voice)
+    GstClockTime timestamp, gboolean stream_has_voice)
 {
-  GstClockTime timestamp = GST_BUFFER_PTS (buffer);
   GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (self);
   GstStructure *s;
   GstClockTime stream_time;
@@ -475,33 +503,32 @@ gst_webrtc_vad_post_activity (GstWebrtcDsp *self, GstBuffer *buffer,
       gst_message_new_element (GST_OBJECT (self), s));
 }
 
-static GstFlowReturn
-gst_webrtc_dsp_process_stream (GstWebrtcDsp * self,
-    GstBuffer * buffer)
+/* Processes the 10ms period starting at sample @offset of @abuf in place */
+static void
+gst_webrtc_dsp_process_period (GstWebrtcDsp * self, GstBuffer * buffer,
+    GstAudioBuffer * abuf, guint offset, GstClockTime timestamp)
 {
-  GstAudioBuffer abuf;
   webrtc::AudioProcessing * apm = self->apm;
   gint err;
 
-  if (!gst_audio_buffer_map (&abuf, &self->info, buffer,
-          (GstMapFlags) GST_MAP_READWRITE)) {
-    gst_buffer_unref (buffer);
-    return GST_FLOW_ERROR;
-  }
-
   if (self->interleaved) {
+    guint8 *data = (guint8 *) abuf->planes[0] + offset * self->info.bpf;
     webrtc::AudioFrame frame;
     frame.num_channels_ = self->info.channels;
     frame.sample_rate_hz_ = self->info.rate;
     frame.samples_per_channel_ = self->period_samples;
 
-    memcpy (frame.data_, abuf.planes[0], self->period_size);
+    memcpy (frame.data_, data, self->period_size);
     err = apm->ProcessStream (&frame);
     if (err >= 0)
-      memcpy (abuf.planes[0], frame.data_, self->period_size);
+      memcpy (data, frame.data_, self->period_size);
   } else {
-    float * const * data = (float * const *) abuf.planes;
+    float **data = g_newa (float *, self->info.channels);
     webrtc::StreamConfig config (self->info.rate, self->info.channels, false);
+    gint c;
+
+    for (c = 0; c < self->info.channels; c++)
+      data[c] = (float *) abuf->planes[c] + offset;
 
     err = apm->ProcessStream (data, config, config, data);
   }
@@ -514,15 +541,67 @@ gst_webrtc_dsp_process_stream (GstWebrtcDsp * self,
       gboolean stream_has_voice = apm->voice_detection ()->stream_has_voice ();
 
       if (stream_has_voice != self->stream_has_voice)
-        gst_webrtc_vad_post_activity (self, buffer, stream_has_voice);
+        gst_webrtc_vad_post_activity (self, buffer, timestamp,
+            stream_has_voice);
 
       self->stream_has_voice = stream_has_voice;
     }
   }
+}
+
+/* @buffer holds a whole number of periods, they are analysed and processed
+ * directly in the mapped planes */
+static GstFlowReturn
+gst_webrtc_dsp_process_stream (GstWebrtcDsp * self,
+    GstBuffer * buffer)
+{
+  GstAudioBuffer abuf;
+  GstClockTime timestamp = GST_BUFFER_PTS (buffer);
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint offset;
+
+  if (!gst_audio_buffer_map (&abuf, &self->info, buffer,
+          (GstMapFlags) GST_MAP_READWRITE)) {
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
+
+  for (offset = 0; offset + self->period_samples <= abuf.n_samples;
+      offset += self->period_samples) {
+    GstClockTime period_time = timestamp;
+
+    if (GST_CLOCK_TIME_IS_VALID (timestamp))
+      period_time += gst_util_uint64_scale_int (offset, GST_SECOND,
+          self->info.rate);
+
+    ret = gst_webrtc_dsp_analyze_reverse_stream (self, period_time);
+    if (ret != GST_FLOW_OK)
+      break;
+
+    gst_webrtc_dsp_process_period (self, buffer, &abuf, offset, period_time);
+  }
 
   gst_audio_buffer_unmap (&abuf);
 
-  return GST_FLOW_OK;
+  return ret;
+}
+
+/* Number of samples in @buffer if it only holds whole periods, 0 otherwise */
+static gsize
+gst_webrtc_dsp_get_direct_samples (GstWebrtcDsp * self, GstBuffer * buffer)
+{
+  GstAudioMeta *meta = gst_buffer_get_audio_meta (buffer);
+  gsize samples;
+
+  if (meta)
+    samples = meta->samples;
+  else
+    samples = gst_buffer_get_size (buffer) / self->info.bpf;
+
+  if (samples % self->period_samples)
+    return 0;
+
+  return samples;
 }
 
 static GstFlowReturn
@@ -544,6 +623,15 @@ gst_webrtc_dsp_submit_input_buffer (GstBaseTransform * btrans,
       gst_planar_audio_adapter_clear (self->padapter);
   }
 
+  /* Buffers made of whole periods are processed in place when nothing is
+   * pending in the adapter, which saves the copy to 10ms buffers */
+  if (!self->direct && gst_webrtc_dsp_get_direct_samples (self, buffer) &&
+      (self->interleaved ? gst_adapter_available (self->adapter) :
+          gst_planar_audio_adapter_available (self->padapter)) == 0) {
+    self->direct = buffer;
+    return GST_FLOW_OK;
+  }
+
   if (self->interleaved)
     gst_adapter_push (self->adapter, buffer);
   else
@@ -556,9 +644,14 @@ static GstFlowReturn
 gst_webrtc_dsp_generate_output (GstBaseTransform * btrans, GstBuffer ** outbuf)
 {
   GstWebrtcDsp *self = GST_WEBRTC_DSP (btrans);
-  GstFlowReturn ret;
   gboolean not_enough;
 
+  if (self->direct) {
+    *outbuf = self->direct;
+    self->direct = NULL;
+    return gst_webrtc_dsp_process_stream (self, *outbuf);
+  }
+
   if (self->interleaved)
     not_enough = gst_adapter_available (self->adapter) < self->period_size;
   else
@@ -571,12 +664,8 @@ gst_webrtc_dsp_generate_output (GstBaseTransform * btrans, GstBuffer ** outbuf)
   }
 
   *outbuf = gst_webrtc_dsp_take_buffer (self);
-  ret = gst_webrtc_dsp_analyze_reverse_stream (self, GST_BUFFER_PTS (*outbuf));
 
-  if (ret == GST_FLOW_OK)
-    ret = gst_webrtc_dsp_process_stream (self, *outbuf);
-
-  return ret;
+  return gst_webrtc_dsp_process_stream (self, *outbuf);
 }
 
 static gboolean
@@ -607,6 +696,12 @@ gst_webrtc_dsp_start (GstBaseTransform * btrans)
           ("No echo probe with name %s found.", self->probe_name), (NULL));
       return FALSE;
     }
+
+    /* start reading a shared probe from its most recent period */
+    GST_WEBRTC_ECHO_PROBE_LOCK (self->probe);
+    self->probe_position = self->probe->first_period +
+        self->probe->periods.length;
+    GST_WEBRTC_ECHO_PROBE_UNLOCK (self->probe);
   }
 
   GST_OBJECT_UNLOCK (self);
@@ -770,6 +865,11 @@ gst_webrtc_dsp_stop (GstBaseTransform * btrans)
 
   gst_adapter_clear (self->adapter);
   gst_planar_audio_adapter_clear (self->padapter);
+  gst_buffer_replace (&self->direct, NULL);
+
+  g_free (self->reverse_scratch);
+  self->reverse_scratch = NULL;
+  self->reverse_scratch_size = 0;
 
   if (self->probe) {
     gst_webrtc_release_echo_probe (self->probe);
@@ -25,6 +25,13 @@
  *
  * This echo probe is to be used with the webrtcdsp element. See #webrtcdsp
  * documentation for more details.
+ *
+ * By default a probe can only be used by a single webrtcdsp element. When
+ * the #webrtcechoprobe:shared property is set, the far-end audio is cut into
+ * timestamped 10ms periods once, and any number of webrtcdsp elements can
+ * read them concurrently, each keeping its own position. This is useful
+ * when a single far-end mix is played back to many participants, for
+ * instance in a conferencing server.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -41,6 +48,14 @@ GST_DEBUG_CATEGORY_EXTERN (webrtc_dsp_debug);
 
 #define MAX_ADAPTER_SIZE (1*1024*1024)
 
+#define DEFAULT_SHARED FALSE
+
+enum
+{
+  PROP_0,
+  PROP_SHARED,
+};
+
 static GstStaticPadTemplate gst_webrtc_echo_probe_sink_template =
 GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
@@ -118,14 +133,26 @@ period_too_big:
   return FALSE;
 }
 
+/* Called with the probe lock held */
+static void
+gst_webrtc_echo_probe_clear (GstWebrtcEchoProbe * self)
+{
+  gst_adapter_clear (self->adapter);
+  gst_planar_audio_adapter_clear (self->padapter);
+
+  /* keep the period numbering monotonic for the readers */
+  self->first_period += self->periods.length;
+  g_queue_foreach (&self->periods, (GFunc) gst_buffer_unref, NULL);
+  g_queue_clear (&self->periods);
+}
+
 static gboolean
 gst_webrtc_echo_probe_stop (GstBaseTransform * btrans)
 {
   GstWebrtcEchoProbe *self = GST_WEBRTC_ECHO_PROBE (btrans);
 
   GST_WEBRTC_ECHO_PROBE_LOCK (self);
-  gst_adapter_clear (self->adapter);
-  gst_planar_audio_adapter_clear (self->padapter);
+  gst_webrtc_echo_probe_clear (self);
   GST_WEBRTC_ECHO_PROBE_UNLOCK (self);
 
   return TRUE;
@@ -170,6 +197,50 @@ gst_webrtc_echo_probe_src_event (GstBaseTransform * btrans, GstEvent * event)
   return klass->src_event (btrans, event);
 }
 
+/* Called with the probe lock held, cuts the adapter content into 10ms
+ * periods that all the readers share */
+static void
+gst_webrtc_echo_probe_queue_periods (GstWebrtcEchoProbe * self)
+{
+  guint max_periods = MAX (1, MAX_ADAPTER_SIZE / self->period_size);
+  GstBuffer *period;
+  GstClockTime timestamp;
+  guint64 distance;
+
+  while (TRUE) {
+    if (self->interleaved) {
+      if (gst_adapter_available (self->adapter) < self->period_size)
+        break;
+
+      timestamp = gst_adapter_prev_pts (self->adapter, &distance);
+      distance /= self->info.bpf;
+      period = gst_adapter_take_buffer (self->adapter, self->period_size);
+    } else {
+      if (gst_planar_audio_adapter_available (self->padapter) <
+          self->period_samples)
+        break;
+
+      timestamp = gst_planar_audio_adapter_prev_pts (self->padapter,
+          &distance);
+      period = gst_planar_audio_adapter_take_buffer (self->padapter,
+          self->period_samples, GST_MAP_READ);
+    }
+
+    if (GST_CLOCK_TIME_IS_VALID (timestamp))
+      timestamp += gst_util_uint64_scale_int (distance, GST_SECOND,
+          self->info.rate);
+
+    GST_BUFFER_PTS (period) = timestamp;
+    GST_BUFFER_DURATION (period) = 10 * GST_MSECOND;
+    g_queue_push_tail (&self->periods, period);
+  }
+
+  while (self->periods.length > max_periods) {
+    gst_buffer_unref ((GstBuffer *) g_queue_pop_head (&self->periods));
+    self->first_period++;
+  }
+}
+
 static GstFlowReturn
 gst_webrtc_echo_probe_transform_ip (GstBaseTransform * btrans,
     GstBuffer * buffer)
@@ -200,11 +271,56 @@ gst_webrtc_echo_probe_transform_ip (GstBaseTransform * btrans,
           (available - MAX_ADAPTER_SIZE) / self->info.bpf);
   }
 
+  if (self->shared)
+    gst_webrtc_echo_probe_queue_periods (self);
+
   GST_WEBRTC_ECHO_PROBE_UNLOCK (self);
 
   return GST_FLOW_OK;
 }
 
+static void
+gst_webrtc_echo_probe_set_property (GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec)
+{
+  GstWebrtcEchoProbe *self = GST_WEBRTC_ECHO_PROBE (object);
+
+  GST_WEBRTC_ECHO_PROBE_LOCK (self);
+  switch (prop_id) {
+    case PROP_SHARED:{
+      gboolean shared = g_value_get_boolean (value);
+
+      if (shared != self->shared) {
+        gst_webrtc_echo_probe_clear (self);
+        self->shared = shared;
+      }
+      break;
+    }
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_WEBRTC_ECHO_PROBE_UNLOCK (self);
+}
+
+static void
+gst_webrtc_echo_probe_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec)
+{
+  GstWebrtcEchoProbe *self = GST_WEBRTC_ECHO_PROBE (object);
+
+  GST_WEBRTC_ECHO_PROBE_LOCK (self);
+  switch (prop_id) {
+    case PROP_SHARED:
+      g_value_set_boolean (value, self->shared);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_WEBRTC_ECHO_PROBE_UNLOCK (self);
+}
+
 static void
 gst_webrtc_echo_probe_finalize (GObject * object)
 {
@@ -214,6 +330,8 @@ gst_webrtc_echo_probe_finalize (GObject * object)
   gst_aec_probes = g_list_remove (gst_aec_probes, self);
   G_UNLOCK (gst_aec_probes);
 
+  g_queue_foreach (&self->periods, (GFunc) gst_buffer_unref, NULL);
+  g_queue_clear (&self->periods);
   gst_object_unref (self->adapter);
   gst_object_unref (self->padapter);
   self->adapter = NULL;
@@ -228,8 +346,11 @@ gst_webrtc_echo_probe_init (GstWebrtcEchoProbe * self)
   self->adapter = gst_adapter_new ();
   self->padapter = gst_planar_audio_adapter_new ();
   gst_audio_info_init (&self->info);
+  g_queue_init (&self->periods);
   g_mutex_init (&self->lock);
 
+  self->shared = DEFAULT_SHARED;
+
   self->latency = GST_CLOCK_TIME_NONE;
 
   G_LOCK (gst_aec_probes);
@@ -246,6 +367,8 @@ gst_webrtc_echo_probe_class_init (GstWebrtcEchoProbeClass * klass)
   GstAudioFilterClass *audiofilter_class = GST_AUDIO_FILTER_CLASS (klass);
 
   gobject_class->finalize = gst_webrtc_echo_probe_finalize;
+  gobject_class->set_property = gst_webrtc_echo_probe_set_property;
+  gobject_class->get_property = gst_webrtc_echo_probe_get_property;
 
   btrans_class->passthrough_on_same_caps = TRUE;
   btrans_class->src_event = GST_DEBUG_FUNCPTR (gst_webrtc_echo_probe_src_event);
@@ -255,6 +378,22 @@ gst_webrtc_echo_probe_class_init (GstWebrtcEchoProbeClass * klass)
 
   audiofilter_class->setup = GST_DEBUG_FUNCPTR (gst_webrtc_echo_probe_setup);
 
+  /**
+   * GstWebrtcEchoProbe:shared:
+   *
+   * Let several webrtcdsp elements use this probe at the same time. The
+   * far-end audio is then split into 10ms periods once and each DSP reads
+   * them at its own pace instead of consuming them.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_SHARED,
+      g_param_spec_boolean ("shared", "Shared",
+          "Allow multiple webrtcdsp elements to use this probe",
+          DEFAULT_SHARED, (GParamFlags) (G_PARAM_READWRITE |
+              G_PARAM_STATIC_STRINGS | GST_PARAM_MUTABLE_READY)));
+
   gst_element_class_add_static_pad_template (element_class,
       &gst_webrtc_echo_probe_src_template);
   gst_element_class_add_static_pad_template (element_class,
@@ -279,8 +418,9 @@ gst_webrtc_acquire_echo_probe (const gchar * name)
     GstWebrtcEchoProbe *probe = GST_WEBRTC_ECHO_PROBE (l->data);
 
     GST_WEBRTC_ECHO_PROBE_LOCK (probe);
-    if (!probe->acquired && g_strcmp0 (GST_OBJECT_NAME (probe), name) == 0) {
-      probe->acquired = TRUE;
+    if ((!probe->acquired || probe->shared) &&
+        g_strcmp0 (GST_OBJECT_NAME (probe), name) == 0) {
+      probe->acquired++;
       ret = GST_WEBRTC_ECHO_PROBE (gst_object_ref (probe));
       GST_WEBRTC_ECHO_PROBE_UNLOCK (probe);
       break;
@@ -296,14 +436,71 @@ void
 gst_webrtc_release_echo_probe (GstWebrtcEchoProbe * probe)
 {
   GST_WEBRTC_ECHO_PROBE_LOCK (probe);
-  probe->acquired = FALSE;
+  probe->acquired--;
   GST_WEBRTC_ECHO_PROBE_UNLOCK (probe);
   gst_object_unref (probe);
 }
 
+/* Called with the probe lock held. Shared mode only aligns on period
+ * boundaries, the remaining error is well within what the echo canceller
+ * tolerates. */
+static gboolean
+gst_webrtc_echo_probe_read_period (GstWebrtcEchoProbe * self,
+    GstClockTime rec_time, webrtc::AudioFrame * frame, GstBuffer ** buf,
+    guint64 * position)
+{
+  guint64 end = self->first_period + self->periods.length;
+  GstBuffer *period;
+
+  if (*position < self->first_period) {
+    GST_DEBUG_OBJECT (self, "Reader is late, skipping %" G_GUINT64_FORMAT
+        " periods", self->first_period - *position);
+    *position = self->first_period;
+  }
+
+  for (; *position < end; (*position)++) {
+    GstClockTime play_time;
+    GstClockTimeDiff diff;
+
+    period = (GstBuffer *) g_queue_peek_nth (&self->periods,
+        *position - self->first_period);
+    play_time = GST_BUFFER_PTS (period);
+
+    /* In delay agnostic mode, or without timestamp, take the next period */
+    if (!GST_CLOCK_TIME_IS_VALID (rec_time) ||
+        !GST_CLOCK_TIME_IS_VALID (play_time))
+      break;
+
+    diff = GST_CLOCK_DIFF (rec_time, play_time + self->latency) / GST_MSECOND;
+
+    /* Not played yet at the time this frame was recorded */
+    if (diff >= self->delay + 10)
+      return FALSE;
+
+    if (diff + 10 > self->delay)
+      break;
+  }
+
+  if (*position >= end)
+    return FALSE;
+
+  period = (GstBuffer *) g_queue_peek_nth (&self->periods,
+      *position - self->first_period);
+  (*position)++;
+
+  if (self->interleaved)
+    gst_buffer_extract (period, 0, frame->data_, self->period_size);
+  else
+    *buf = gst_buffer_ref (period);
+
+  return TRUE;
+}
+
+/* @position is the reader position in shared mode, otherwise it is unused
+ * and the data is consumed. In shared mode, the returned @buf is read-only. */
 gint
 gst_webrtc_echo_probe_read (GstWebrtcEchoProbe * self, GstClockTime rec_time,
-    gpointer _frame, GstBuffer ** buf)
+    gpointer _frame, GstBuffer ** buf, guint64 * position)
 {
   webrtc::AudioFrame * frame = (webrtc::AudioFrame *) _frame;
   GstClockTimeDiff diff;
@@ -316,6 +513,14 @@ gst_webrtc_echo_probe_read (GstWebrtcEchoProbe * self, GstClockTime rec_time,
       !GST_AUDIO_INFO_IS_VALID (&self->info))
     goto done;
 
+  if (self->shared) {
+    if (!gst_webrtc_echo_probe_read_period (self, rec_time, frame, buf,
+            position))
+      goto done;
+
+    goto read;
+  }
+
   if (self->interleaved)
     avail = gst_adapter_available (self->adapter) / self->info.bpf;
   else
@@ -440,6 +645,7 @@ copy:
     *buf = ret;
   }
 
+read:
   frame->num_channels_ = self->info.channels;
   frame->sample_rate_hz_ = self->info.rate;
   frame->samples_per_channel_ = self->period_samples;
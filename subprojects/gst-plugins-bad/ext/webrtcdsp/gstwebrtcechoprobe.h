@@ -76,8 +76,14 @@ struct _GstWebrtcEchoProbe
   GstAdapter *adapter;
   GstPlanarAudioAdapter *padapter;
 
+  /* Shared mode, complete 10ms periods of far-end audio with running time
+   * timestamps. Readers keep their own position in this queue. */
+  gboolean shared;
+  GQueue periods;
+  guint64 first_period;
+
   /* Private */
-  gboolean acquired;
+  guint acquired;
 };
 
 struct _GstWebrtcEchoProbeClass
@@ -92,7 +98,8 @@ GST_ELEMENT_REGISTER_DECLARE (webrtcechoprobe);
 GstWebrtcEchoProbe *gst_webrtc_acquire_echo_probe (const gchar * name);
 void gst_webrtc_release_echo_probe (GstWebrtcEchoProbe * probe);
 gint gst_webrtc_echo_probe_read (GstWebrtcEchoProbe * self,
-    GstClockTime rec_time, gpointer frame, GstBuffer ** buf);
+    GstClockTime rec_time, gpointer frame, GstBuffer ** buf,
+    guint64 * position);
 
 G_END_DECLS
 #endif /* __GST_WEBRTC_ECHO_PROBE_H__ */
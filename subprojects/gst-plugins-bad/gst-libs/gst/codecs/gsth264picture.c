@@ -112,15 +112,27 @@ struct _GstH264Dpb
   gint32 last_output_poc;
   gboolean last_output_non_ref;
 
+  /* POC order of the pictures in decoding order, to infer whether the
+   * stream uses reordering when num_reorder_frames is not known */
+  gint32 last_added_poc;
+  guint num_added_in_order;
+  gboolean reorder_seen;
+
   gboolean interlaced;
 };
 
+/* number of pictures in POC order needed before assuming that a stream
+ * does not use reordering, the maximum DPB size */
+#define NUM_IN_ORDER_FOR_NO_REORDER 16
+
 static void
 gst_h264_dpb_init (GstH264Dpb * dpb)
 {
   dpb->num_output_needed = 0;
   dpb->last_output_poc = G_MININT32;
   dpb->last_output_non_ref = FALSE;
+  /* the reordering inference is kept across IDRs, which clear the DPB */
+  dpb->last_added_poc = G_MININT32;
 }
 
 /**
@@ -137,6 +149,8 @@ gst_h264_dpb_new (void)
 
   dpb = g_new0 (GstH264Dpb, 1);
   gst_h264_dpb_init (dpb);
+  dpb->num_added_in_order = 0;
+  dpb->reorder_seen = FALSE;
 
   dpb->pic_list =
       g_array_sized_new (FALSE, TRUE, sizeof (GstH264Picture *),
@@ -308,6 +322,20 @@ gst_h264_dpb_add (GstH264Dpb * dpb, GstH264Picture * picture)
     GST_TRACE ("last_output_poc reset because of IDR or mem_mgmt_5");
     dpb->last_output_poc = G_MININT32;
     dpb->last_output_non_ref = FALSE;
+    dpb->last_added_poc = G_MININT32;
+  }
+
+  if (!picture->nonexisting && !picture->second_field) {
+    if (picture->pic_order_cnt < dpb->last_added_poc) {
+      if (!dpb->reorder_seen)
+        GST_TRACE ("poc %d decoded after poc %d, the stream uses reordering",
+            picture->pic_order_cnt, dpb->last_added_poc);
+      dpb->reorder_seen = TRUE;
+    }
+
+    dpb->last_added_poc = picture->pic_order_cnt;
+    if (!dpb->reorder_seen)
+      dpb->num_added_in_order++;
   }
 }
 
@@ -771,6 +799,19 @@ gst_h264_dpb_needs_bump (GstH264Dpb * dpb, GstH264Picture * to_insert,
       }
     }
 
+    /* Without num_reorder_frames, max_num_reorder_frames is the DPB size. If
+       all the pictures so far were decoded in POC order, the stream most
+       likely doesn't use reordering at all, and the lowest POC picture can
+       be output as long as it precedes the picture to insert. */
+    if (dpb->max_num_reorder_frames == dpb->max_num_frames
+        && !dpb->reorder_seen
+        && dpb->num_added_in_order >= NUM_IN_ORDER_FOR_NO_REORDER
+        && (!to_insert || to_insert->pic_order_cnt > lowest_poc)) {
+      GST_TRACE ("no reordering in the first %d pictures, bumping poc %d "
+          "for low-latency", dpb->num_added_in_order, lowest_poc);
+      return TRUE;
+    }
+
     /* Bump leading picture with the negative POC if already found positive
        POC. It's even impossible to insert another negative POC after the
        positive POCs. Almost safe. */
@@ -1208,6 +1208,71 @@ gst_d3d11_device_get_device_context_handle (GstD3D11Device * device)
   return device->priv->device_context;
 }
 
+/**
+ * gst_d3d11_device_create_deferred_context:
+ * @device: a #GstD3D11Device
+ *
+ * Creates a new deferred ID3D11DeviceContext for @device. Commands recorded
+ * on a deferred context do not need gst_d3d11_device_lock(), only the
+ * submission of the resulting ID3D11CommandList via
+ * gst_d3d11_device_execute_command_list() does.
+ * A deferred context itself is not thread-safe, caller needs to serialize
+ * access to it.
+ *
+ * Returns: (transfer full) (nullable): a new deferred ID3D11DeviceContext
+ * handle or %NULL if deferred context is not supported by @device
+ *
+ * Since: 1.22
+ */
+ID3D11DeviceContext *
+gst_d3d11_device_create_deferred_context (GstD3D11Device * device)
+{
+  GstD3D11DevicePrivate *priv;
+  ID3D11DeviceContext *context = NULL;
+  HRESULT hr;
+
+  g_return_val_if_fail (GST_IS_D3D11_DEVICE (device), NULL);
+
+  priv = device->priv;
+
+  /* ID3D11Device methods are thread-safe */
+  hr = priv->device->CreateDeferredContext (0, &context);
+  if (FAILED (hr)) {
+    GST_DEBUG_OBJECT (device, "Couldn't create deferred context, hr: 0x%x",
+        (guint) hr);
+    return NULL;
+  }
+
+  return context;
+}
+
+/**
+ * gst_d3d11_device_execute_command_list:
+ * @device: a #GstD3D11Device
+ * @command_list: a ID3D11CommandList
+ *
+ * Submits @command_list recorded on a deferred context created by
+ * gst_d3d11_device_create_deferred_context() to the immediate context of
+ * @device. The device lock is held only for the submission.
+ *
+ * Since: 1.22
+ */
+void
+gst_d3d11_device_execute_command_list (GstD3D11Device * device,
+    ID3D11CommandList * command_list)
+{
+  GstD3D11DevicePrivate *priv;
+
+  g_return_if_fail (GST_IS_D3D11_DEVICE (device));
+  g_return_if_fail (command_list != NULL);
+
+  priv = device->priv;
+
+  gst_d3d11_device_lock (device);
+  priv->device_context->ExecuteCommandList (command_list, FALSE);
+  gst_d3d11_device_unlock (device);
+}
+
 /**
  * gst_d3d11_device_get_dxgi_factory_handle:
  * @device: a #GstD3D11Device
@@ -75,6 +75,13 @@ ID3D11Device *        gst_d3d11_device_get_device_handle  (GstD3D11Device * devi
 GST_D3D11_API
 ID3D11DeviceContext * gst_d3d11_device_get_device_context_handle (GstD3D11Device * device);
 
+GST_D3D11_API
+ID3D11DeviceContext * gst_d3d11_device_create_deferred_context (GstD3D11Device * device);
+
+GST_D3D11_API
+void                  gst_d3d11_device_execute_command_list (GstD3D11Device * device,
+                                                             ID3D11CommandList * command_list);
+
 GST_D3D11_API
 IDXGIFactory1 *       gst_d3d11_device_get_dxgi_factory_handle (GstD3D11Device * device);
 
@@ -916,6 +916,109 @@ gst_va_dmabuf_memories_setup (GstVaDisplay * display, GstVideoInfo * info,
   return TRUE;
 }
 
+/*============================ VA surface cache ==============================*/
+
+/* Surfaces of the GstVaAllocator's that are flushed, because a decoder
+ * renegotiated or was destroyed, are kept in a cache of their display instead
+ * of being destroyed, so the next allocator with the same format, size and
+ * usage doesn't have to create them again. */
+
+#define SURFACE_CACHE_MAX_SIZE 64
+
+typedef struct
+{
+  guint rt_format;
+  guint fourcc;
+  gint width;
+  gint height;
+  guint usage_hint;
+  VASurfaceID surface;
+} GstVaCachedSurface;
+
+static GMutex surface_cache_lock;
+
+static void
+_surface_cache_free (GQueue * cache)
+{
+  /* the surfaces are released along with the VA display */
+  g_queue_free_full (cache, g_free);
+}
+
+static GQueue *
+_surface_cache_get_unlocked (GstVaDisplay * display)
+{
+  static GQuark quark = 0;
+  GQueue *cache;
+
+  if (!quark)
+    quark = g_quark_from_static_string ("GstVaSurfaceCache");
+
+  cache = g_object_get_qdata (G_OBJECT (display), quark);
+  if (!cache) {
+    cache = g_queue_new ();
+    g_object_set_qdata_full (G_OBJECT (display), quark, cache,
+        (GDestroyNotify) _surface_cache_free);
+  }
+
+  return cache;
+}
+
+static VASurfaceID
+_surface_cache_pop (GstVaDisplay * display, guint rt_format, guint fourcc,
+    gint width, gint height, guint usage_hint)
+{
+  VASurfaceID surface = VA_INVALID_ID;
+  GQueue *cache;
+  GList *l;
+
+  g_mutex_lock (&surface_cache_lock);
+  cache = _surface_cache_get_unlocked (display);
+  for (l = cache->head; l; l = l->next) {
+    GstVaCachedSurface *cached = l->data;
+
+    if (cached->rt_format == rt_format && cached->fourcc == fourcc
+        && cached->width == width && cached->height == height
+        && cached->usage_hint == usage_hint) {
+      surface = cached->surface;
+      g_queue_delete_link (cache, l);
+      g_free (cached);
+      break;
+    }
+  }
+  g_mutex_unlock (&surface_cache_lock);
+
+  return surface;
+}
+
+static void
+_surface_cache_push (GstVaDisplay * display, guint rt_format, guint fourcc,
+    gint width, gint height, guint usage_hint, VASurfaceID surface)
+{
+  GstVaCachedSurface *cached, *oldest = NULL;
+  GQueue *cache;
+
+  cached = g_new (GstVaCachedSurface, 1);
+  cached->rt_format = rt_format;
+  cached->fourcc = fourcc;
+  cached->width = width;
+  cached->height = height;
+  cached->usage_hint = usage_hint;
+  cached->surface = surface;
+
+  g_mutex_lock (&surface_cache_lock);
+  cache = _surface_cache_get_unlocked (display);
+  g_queue_push_tail (cache, cached);
+  if (g_queue_get_length (cache) > SURFACE_CACHE_MAX_SIZE)
+    oldest = g_queue_pop_head (cache);
+  g_mutex_unlock (&surface_cache_lock);
+
+  if (oldest) {
+    GST_LOG ("Destroying cached surface %#x", oldest->surface);
+    va_destroy_surfaces (display, &oldest->surface, 1);
+    g_free (oldest);
+  }
+}
+
 /*===================== GstVaAllocator / GstVaMemory =========================*/
 
 typedef struct _GstVaAllocator GstVaAllocator;
@@ -1013,8 +1116,11 @@ _va_free (GstAllocator * allocator, GstMemory * mem)
   }
 
   if (va_mem->surface != VA_INVALID_ID && mem->parent == NULL) {
-    GST_LOG_OBJECT (self, "Destroying surface %#x", va_mem->surface);
-    va_destroy_surfaces (self->display, &va_mem->surface, 1);
+    GST_LOG_OBJECT (self, "Caching surface %#x", va_mem->surface);
+    _surface_cache_push (self->display, self->rt_format, self->fourcc,
+        GST_VIDEO_INFO_WIDTH (&self->info),
+        GST_VIDEO_INFO_HEIGHT (&self->info), self->usage_hint,
+        va_mem->surface);
   }
 
   g_mutex_clear (&va_mem->lock);
@@ -1426,11 +1532,17 @@ gst_va_allocator_alloc (GstAllocator * allocator)
     return NULL;
   }
 
-  if (!va_create_surfaces (self->display, self->rt_format, self->fourcc,
+  surface = _surface_cache_pop (self->display, self->rt_format, self->fourcc,
+      GST_VIDEO_INFO_WIDTH (&self->info), GST_VIDEO_INFO_HEIGHT (&self->info),
+      self->usage_hint);
+  if (surface != VA_INVALID_ID) {
+    GST_LOG_OBJECT (self, "Reusing cached surface %#x", surface);
+  } else if (!va_create_surfaces (self->display, self->rt_format, self->fourcc,
           GST_VIDEO_INFO_WIDTH (&self->info),
           GST_VIDEO_INFO_HEIGHT (&self->info), self->usage_hint, NULL,
-          &surface, 1))
+          &surface, 1)) {
     return NULL;
+  }
 
   mem = g_slice_new (GstVaMemory);
 
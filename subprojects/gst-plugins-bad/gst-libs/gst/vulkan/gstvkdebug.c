@@ -108,6 +108,9 @@ static const struct
 #if VK_HEADER_VERSION >= 70
   {VK_QUEUE_PROTECTED_BIT, "protected"},
 #endif
+#if VK_HEADER_VERSION >= 238
+  {VK_QUEUE_VIDEO_DECODE_BIT_KHR, "video-decode"},
+#endif
 };
 /**
  * gst_vulkan_queue_flags_to_string:
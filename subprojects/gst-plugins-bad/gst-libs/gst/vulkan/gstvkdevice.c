@@ -34,6 +34,11 @@
  * @see_also: #GstVulkanPhysicalDevice, #GstVulkanInstance
  *
  * A #GstVulkanDevice encapsulates a VkDevice
+ *
+ * If the `GST_VULKAN_PIPELINE_CACHE_DIR` environment variable points to a
+ * directory, the contents of the pipeline cache returned by
+ * gst_vulkan_device_get_pipeline_cache() are loaded from and stored in that
+ * directory so that pipelines are not recompiled by every process.
  */
 
 #define GST_CAT_DEFAULT gst_vulkan_device_debug
@@ -58,10 +63,13 @@ struct _GstVulkanDevicePrivate
   GPtrArray *enabled_extensions;
 
   gboolean opened;
-  guint queue_family_id;
+  /* number of queues created for each queue family */
   guint n_queues;
 
   GstVulkanFenceCache *fence_cache;
+
+  VkPipelineCache pipeline_cache;
+  gchar *pipeline_cache_filename;
 };
 
 static void
@@ -226,6 +234,115 @@ gst_vulkan_device_dispose (GObject * object)
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
+static gchar *
+_get_pipeline_cache_filename (GstVulkanDevice * device)
+{
+  VkPhysicalDeviceProperties *props = &device->physical_device->properties;
+  GString *basename;
+  const gchar *dir;
+  gchar *filename;
+  guint i;
+
+  dir = g_getenv ("GST_VULKAN_PIPELINE_CACHE_DIR");
+  if (!dir || !dir[0])
+    return NULL;
+
+  /* the driver rejects data with a different pipelineCacheUUID anyway, but
+   * keeping one file per UUID avoids devices overwriting each other's data */
+  basename = g_string_new (NULL);
+  g_string_append_printf (basename, "%08x-%08x-", props->vendorID,
+      props->deviceID);
+  for (i = 0; i < VK_UUID_SIZE; i++)
+    g_string_append_printf (basename, "%02x", props->pipelineCacheUUID[i]);
+  g_string_append (basename, ".bin");
+
+  filename = g_build_filename (dir, basename->str, NULL);
+  g_string_free (basename, TRUE);
+
+  return filename;
+}
+
+static void
+_create_pipeline_cache (GstVulkanDevice * device)
+{
+  GstVulkanDevicePrivate *priv = GET_PRIV (device);
+  VkPipelineCacheCreateInfo cache_info = { 0, };
+  gchar *contents = NULL;
+  gsize length = 0;
+  VkResult err;
+
+  priv->pipeline_cache_filename = _get_pipeline_cache_filename (device);
+  if (priv->pipeline_cache_filename
+      && g_file_get_contents (priv->pipeline_cache_filename, &contents,
+          &length, NULL))
+    GST_DEBUG_OBJECT (device, "Loaded %" G_GSIZE_FORMAT " bytes of pipeline "
+        "cache from %s", length, priv->pipeline_cache_filename);
+
+  /* *INDENT-OFF* */
+  cache_info = (VkPipelineCacheCreateInfo) {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+      .initialDataSize = length,
+      .pInitialData = contents,
+  };
+  /* *INDENT-ON* */
+
+  err = vkCreatePipelineCache (device->device, &cache_info, NULL,
+      &priv->pipeline_cache);
+  if (err != VK_SUCCESS && contents) {
+    GST_INFO_OBJECT (device, "Ignoring invalid pipeline cache data");
+    cache_info.initialDataSize = 0;
+    cache_info.pInitialData = NULL;
+    err = vkCreatePipelineCache (device->device, &cache_info, NULL,
+        &priv->pipeline_cache);
+  }
+  if (err != VK_SUCCESS) {
+    GST_WARNING_OBJECT (device, "Failed to create pipeline cache: %s",
+        gst_vulkan_result_to_string (err));
+    priv->pipeline_cache = VK_NULL_HANDLE;
+  }
+
+  g_free (contents);
+}
+
+static void
+_store_pipeline_cache (GstVulkanDevice * device)
+{
+  GstVulkanDevicePrivate *priv = GET_PRIV (device);
+  GError *error = NULL;
+  gchar *contents, *dir;
+  size_t length = 0;
+  VkResult err;
+
+  err = vkGetPipelineCacheData (device->device, priv->pipeline_cache, &length,
+      NULL);
+  if (err != VK_SUCCESS || length == 0)
+    return;
+
+  contents = g_malloc (length);
+  err = vkGetPipelineCacheData (device->device, priv->pipeline_cache, &length,
+      contents);
+  if (err != VK_SUCCESS && err != VK_INCOMPLETE) {
+    g_free (contents);
+    return;
+  }
+
+  dir = g_path_get_dirname (priv->pipeline_cache_filename);
+  g_mkdir_with_parents (dir, 0755);
+  g_free (dir);
+
+  if (!g_file_set_contents (priv->pipeline_cache_filename, contents, length,
+          &error)) {
+    GST_WARNING_OBJECT (device, "Failed to store pipeline cache: %s",
+        error->message);
+    g_clear_error (&error);
+  } else {
+    GST_DEBUG_OBJECT (device, "Stored %" G_GSIZE_FORMAT " bytes of pipeline "
+        "cache in %s", (gsize) length, priv->pipeline_cache_filename);
+  }
+
+  g_free (contents);
+}
+
 static void
 gst_vulkan_device_finalize (GObject * object)
 {
@@ -234,8 +351,16 @@ gst_vulkan_device_finalize (GObject * object)
 
   if (device->device) {
     vkDeviceWaitIdle (device->device);
+    if (priv->pipeline_cache) {
+      if (priv->pipeline_cache_filename)
+        _store_pipeline_cache (device);
+      vkDestroyPipelineCache (device->device, priv->pipeline_cache, NULL);
+    }
     vkDestroyDevice (device->device, NULL);
   }
+  priv->pipeline_cache = VK_NULL_HANDLE;
+  g_free (priv->pipeline_cache_filename);
+  priv->pipeline_cache_filename = NULL;
   device->device = VK_NULL_HANDLE;
 
   gst_clear_object (&device->physical_device);
@@ -267,7 +392,7 @@ gst_vulkan_device_open (GstVulkanDevice * device, GError ** error)
   GstVulkanDevicePrivate *priv = GET_PRIV (device);
   VkPhysicalDevice gpu;
   VkResult err;
-  guint i;
+  guint i, n_queue_families;
 
   g_return_val_if_fail (GST_IS_VULKAN_DEVICE (device), FALSE);
 
@@ -280,18 +405,21 @@ gst_vulkan_device_open (GstVulkanDevice * device, GError ** error)
 
   gpu = gst_vulkan_device_get_physical_device (device);
 
-  /* FIXME: allow overriding/selecting */
-  for (i = 0; i < device->physical_device->n_queue_families; i++) {
+  n_queue_families = device->physical_device->n_queue_families;
+  for (i = 0; i < n_queue_families; i++) {
     if (device->physical_device->
         queue_family_props[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
       break;
   }
-  if (i >= device->physical_device->n_queue_families) {
+  if (i >= n_queue_families) {
     g_set_error (error, GST_VULKAN_ERROR, VK_ERROR_INITIALIZATION_FAILED,
         "Failed to find a compatible queue family");
     goto error;
   }
-  priv->queue_family_id = i;
+  /* FIXME: allow overriding/selecting.
+   * One queue is created in every queue family, so that queues with other
+   * capabilities than graphics (compute only, transfer only, video decode)
+   * can be retrieved with gst_vulkan_device_select_queue() */
   priv->n_queues = 1;
 
   GST_INFO_OBJECT (device, "Creating a device from physical %" GST_PTR_FORMAT
@@ -306,20 +434,23 @@ gst_vulkan_device_open (GstVulkanDevice * device, GError ** error)
         (gchar *) g_ptr_array_index (priv->enabled_extensions, i));
 
   {
-    VkDeviceQueueCreateInfo queue_info = { 0, };
+    VkDeviceQueueCreateInfo *queue_info;
     VkDeviceCreateInfo device_info = { 0, };
     gfloat queue_priority = 0.5;
 
-    queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    queue_info.pNext = NULL;
-    queue_info.queueFamilyIndex = priv->queue_family_id;
-    queue_info.queueCount = priv->n_queues;
-    queue_info.pQueuePriorities = &queue_priority;
+    queue_info = g_new0 (VkDeviceQueueCreateInfo, n_queue_families);
+    for (i = 0; i < n_queue_families; i++) {
+      queue_info[i].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+      queue_info[i].pNext = NULL;
+      queue_info[i].queueFamilyIndex = i;
+      queue_info[i].queueCount = priv->n_queues;
+      queue_info[i].pQueuePriorities = &queue_priority;
+    }
 
     device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     device_info.pNext = NULL;
-    device_info.queueCreateInfoCount = 1;
-    device_info.pQueueCreateInfos = &queue_info;
+    device_info.queueCreateInfoCount = n_queue_families;
+    device_info.pQueueCreateInfos = queue_info;
     device_info.enabledLayerCount = priv->enabled_layers->len;
     device_info.ppEnabledLayerNames =
         (const char *const *) priv->enabled_layers->pdata;
@@ -329,6 +460,7 @@ gst_vulkan_device_open (GstVulkanDevice * device, GError ** error)
     device_info.pEnabledFeatures = NULL;
 
     err = vkCreateDevice (gpu, &device_info, NULL, &device->device);
+    g_free (queue_info);
     if (gst_vulkan_error_to_g_error (err, error, "vkCreateDevice") < 0) {
       goto error;
     }
@@ -338,6 +470,8 @@ gst_vulkan_device_open (GstVulkanDevice * device, GError ** error)
   /* avoid reference loops between us and the fence cache */
   gst_object_unref (device);
 
+  _create_pipeline_cache (device);
+
   priv->opened = TRUE;
   GST_OBJECT_UNLOCK (device);
   return TRUE;
@@ -369,7 +503,9 @@ gst_vulkan_device_get_queue (GstVulkanDevice * device, guint32 queue_family,
   g_return_val_if_fail (GST_IS_VULKAN_DEVICE (device), NULL);
   g_return_val_if_fail (device->device != NULL, NULL);
   g_return_val_if_fail (priv->opened, NULL);
-  g_return_val_if_fail (queue_family < priv->n_queues, NULL);
+  g_return_val_if_fail (queue_family <
+      device->physical_device->n_queue_families, NULL);
+  g_return_val_if_fail (queue_i < priv->n_queues, NULL);
   g_return_val_if_fail (queue_i <
       device->physical_device->queue_family_props[queue_family].queueCount,
       NULL);
@@ -401,20 +537,54 @@ gst_vulkan_device_foreach_queue (GstVulkanDevice * device,
 {
   GstVulkanDevicePrivate *priv = GET_PRIV (device);
   gboolean done = FALSE;
-  guint i;
+  guint i, j;
 
-  for (i = 0; i < priv->n_queues; i++) {
-    GstVulkanQueue *queue =
-        gst_vulkan_device_get_queue (device, priv->queue_family_id, i);
+  for (i = 0; i < device->physical_device->n_queue_families && !done; i++) {
+    for (j = 0; j < priv->n_queues; j++) {
+      GstVulkanQueue *queue = gst_vulkan_device_get_queue (device, i, j);
 
-    if (!func (device, queue, user_data))
-      done = TRUE;
+      if (!func (device, queue, user_data))
+        done = TRUE;
 
-    gst_object_unref (queue);
+      gst_object_unref (queue);
 
-    if (done)
-      break;
+      if (done)
+        break;
+    }
+  }
+}
+
+/**
+ * gst_vulkan_device_select_queue:
+ * @device: a #GstVulkanDevice
+ * @expected_flags: the capabilities the queue must have
+ *
+ * Selects the first queue of @device whose family supports all of
+ * @expected_flags, e.g. `VK_QUEUE_COMPUTE_BIT` or
+ * `VK_QUEUE_VIDEO_DECODE_BIT_KHR`.
+ *
+ * Returns: (transfer full) (nullable): a #GstVulkanQueue or %NULL if no
+ *     queue family of @device has these capabilities
+ *
+ * Since: 1.22
+ */
+GstVulkanQueue *
+gst_vulkan_device_select_queue (GstVulkanDevice * device,
+    VkQueueFlagBits expected_flags)
+{
+  GstVulkanPhysicalDevice *gpu;
+  guint i;
+
+  g_return_val_if_fail (GST_IS_VULKAN_DEVICE (device), NULL);
+
+  gpu = device->physical_device;
+  for (i = 0; i < gpu->n_queue_families; i++) {
+    if ((gpu->queue_family_props[i].queueFlags & expected_flags) ==
+        expected_flags)
+      return gst_vulkan_device_get_queue (device, i, 0);
   }
+
+  return NULL;
 }
 
 /**
@@ -473,6 +643,28 @@ gst_vulkan_device_get_physical_device (GstVulkanDevice * device)
   return gst_vulkan_physical_device_get_handle (device->physical_device);
 }
 
+/**
+ * gst_vulkan_device_get_pipeline_cache: (skip)
+ * @device: a #GstVulkanDevice
+ *
+ * The returned `VkPipelineCache` is owned by @device and is persisted across
+ * processes if the `GST_VULKAN_PIPELINE_CACHE_DIR` environment variable is
+ * set.  Vulkan pipeline caches are internally synchronized so it can be used
+ * from multiple threads.
+ *
+ * Returns: the `VkPipelineCache` to use when creating pipelines on @device or
+ *     %VK_NULL_HANDLE
+ *
+ * Since: 1.22
+ */
+VkPipelineCache
+gst_vulkan_device_get_pipeline_cache (GstVulkanDevice * device)
+{
+  g_return_val_if_fail (GST_IS_VULKAN_DEVICE (device), VK_NULL_HANDLE);
+
+  return GET_PRIV (device)->pipeline_cache;
+}
+
 /**
  * gst_context_set_vulkan_device:
  * @context: a #GstContext
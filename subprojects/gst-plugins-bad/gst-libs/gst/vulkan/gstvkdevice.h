@@ -124,7 +124,12 @@ GstVulkanQueue *    gst_vulkan_device_get_queue             (GstVulkanDevice * d
                                                              guint32 queue_family,
                                                              guint32 queue_i);
 GST_VULKAN_API
+GstVulkanQueue *    gst_vulkan_device_select_queue          (GstVulkanDevice * device,
+                                                             VkQueueFlagBits expected_flags);
+GST_VULKAN_API
 VkPhysicalDevice    gst_vulkan_device_get_physical_device   (GstVulkanDevice * device);
+GST_VULKAN_API
+VkPipelineCache     gst_vulkan_device_get_pipeline_cache    (GstVulkanDevice * device);
 
 GST_VULKAN_API
 void                gst_context_set_vulkan_device           (GstContext * context,
@@ -512,7 +512,8 @@ create_pipeline (GstVulkanFullScreenQuad * self, GError ** error)
   /* *INDENT-ON* */
 
   err =
-      vkCreateGraphicsPipelines (self->queue->device->device, VK_NULL_HANDLE, 1,
+      vkCreateGraphicsPipelines (self->queue->device->device,
+      gst_vulkan_device_get_pipeline_cache (self->queue->device), 1,
       &pipeline_create_info, NULL, &pipeline);
   if (gst_vulkan_error_to_g_error (err, error, "vkCreateGraphicsPipelines") < 0) {
     return FALSE;
@@ -45,8 +45,15 @@ struct _GstVulkanImageBufferPoolPrivate
   gboolean raw_caps;
   GstVideoInfo v_info;
   gboolean add_videometa;
+  VkImageUsageFlags usage;
+  VkMemoryPropertyFlags mem_props;
 };
 
+#define DEFAULT_USAGE (VK_IMAGE_USAGE_TRANSFER_SRC_BIT | \
+    VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | \
+    VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT)
+#define DEFAULT_MEM_PROPS VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+
 static void gst_vulkan_image_buffer_pool_finalize (GObject * object);
 
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_VULKAN_IMAGE_BUFFER_POOL);
@@ -70,6 +77,28 @@ gst_vulkan_image_buffer_pool_get_options (GstBufferPool * pool)
   return options;
 }
 
+/**
+ * gst_vulkan_image_buffer_pool_config_set_allocation_params:
+ * @config: the #GstStructure with the pool's configuration.
+ * @usage: The Vulkan image usage flags.
+ * @mem_properties: Vulkan memory property flags.
+ *
+ * Sets the @usage and @mem_properties of the images to setup.  This is
+ * required for e.g. writing to the images from a compute shader, which needs
+ * %VK_IMAGE_USAGE_STORAGE_BIT.
+ *
+ * Since: 1.22
+ */
+void
+gst_vulkan_image_buffer_pool_config_set_allocation_params (GstStructure *
+    config, VkImageUsageFlags usage, VkMemoryPropertyFlags mem_properties)
+{
+  g_return_if_fail (config != NULL);
+
+  gst_structure_set (config, "usage", G_TYPE_UINT, usage, "memory-properties",
+      G_TYPE_UINT, mem_properties, NULL);
+}
+
 static gboolean
 gst_vulkan_image_buffer_pool_set_config (GstBufferPool * pool,
     GstStructure * config)
@@ -102,6 +131,11 @@ gst_vulkan_image_buffer_pool_set_config (GstBufferPool * pool,
   priv->raw_caps = features == NULL || gst_caps_features_is_equal (features,
       GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY);
 
+  if (!gst_structure_get_uint (config, "usage", &priv->usage))
+    priv->usage = DEFAULT_USAGE;
+  if (!gst_structure_get_uint (config, "memory-properties", &priv->mem_props))
+    priv->mem_props = DEFAULT_MEM_PROPS;
+
   /* get the size of the buffer to allocate */
   priv->v_info.size = 0;
   for (i = 0; i < GST_VIDEO_INFO_N_PLANES (&priv->v_info); i++) {
@@ -118,11 +152,9 @@ gst_vulkan_image_buffer_pool_set_config (GstBufferPool * pool,
 
     img_mem = (GstVulkanImageMemory *)
         gst_vulkan_image_memory_alloc (vk_pool->device, vk_format, width,
-        height, tiling,
-        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
-        VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        height, tiling, priv->usage, priv->mem_props);
+    if (!img_mem)
+      goto mem_create_failed;
 
     priv->v_info.offset[i] = priv->v_info.size;
     priv->v_info.size += img_mem->requirements.size;
@@ -155,6 +187,11 @@ wrong_caps:
         "failed getting geometry from caps %" GST_PTR_FORMAT, caps);
     return FALSE;
   }
+mem_create_failed:
+  {
+    GST_WARNING_OBJECT (pool, "Could not create Vulkan Memory");
+    return FALSE;
+  }
 }
 
 /* This function handles GstBuffer creation */
@@ -182,13 +219,8 @@ gst_vulkan_image_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
 
     mem = gst_vulkan_image_memory_alloc (vk_pool->device,
         vk_format, GST_VIDEO_INFO_COMP_WIDTH (&priv->v_info, i),
-        GST_VIDEO_INFO_COMP_HEIGHT (&priv->v_info, i), tiling,
-        /* FIXME: choose from outside */
-        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
-        VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
-        /* FIXME: choose from outside */
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        GST_VIDEO_INFO_COMP_HEIGHT (&priv->v_info, i), tiling, priv->usage,
+        priv->mem_props);
     if (!mem) {
       gst_buffer_unref (buf);
       goto mem_create_failed;
@@ -78,6 +78,12 @@ struct _GstVulkanImageBufferPoolClass
 GST_VULKAN_API
 GstBufferPool *gst_vulkan_image_buffer_pool_new (GstVulkanDevice * device);
 
+GST_VULKAN_API
+void gst_vulkan_image_buffer_pool_config_set_allocation_params
+                                                (GstStructure * config,
+                                                 VkImageUsageFlags usage,
+                                                 VkMemoryPropertyFlags mem_properties);
+
 G_END_DECLS
 
 #endif /* __GST_VULKAN_IMAGE_BUFFER_POOL_H__ */
@@ -250,6 +250,7 @@ struct _GstWebRTCDataChannel
   GstWebRTCDataChannelState         ready_state;
   guint64                           buffered_amount;
   guint64                           buffered_amount_low_threshold;
+  guint64                           buffered_amount_high_threshold;
 
   gpointer                         _padding[GST_PADDING];
 };
@@ -288,6 +289,9 @@ void gst_webrtc_data_channel_on_message_string (GstWebRTCDataChannel * channel,
 GST_WEBRTC_API
 void gst_webrtc_data_channel_on_buffered_amount_low (GstWebRTCDataChannel * channel);
 
+GST_WEBRTC_API
+void gst_webrtc_data_channel_on_buffered_amount_high (GstWebRTCDataChannel * channel);
+
 
 /**
  * GstWebRTCSCTPTransport:
@@ -0,0 +1,92 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gstaudiomixmatrix-arm-neon.h"
+
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#include <math.h>
+#include <string.h>
+
+/* adds x * matrix to the out_channels values in @acc */
+static inline void
+accumulate_f32 (gfloat * acc, const gfloat * matrix, gfloat x,
+    gint out_channels)
+{
+  gint o = 0;
+
+  for (; o + 4 <= out_channels; o += 4)
+    vst1q_f32 (acc + o, vmlaq_n_f32 (vld1q_f32 (acc + o),
+            vld1q_f32 (matrix + o), x));
+  for (; o < out_channels; o++)
+    acc[o] += x * matrix[o];
+}
+
+void
+audio_mix_matrix_f32_neon (const gfloat * in, gfloat * out,
+    const gfloat * matrix, gfloat * acc, gint in_channels, gint out_channels,
+    gint n_samples)
+{
+  gint n, i;
+
+  for (n = 0; n < n_samples; n++) {
+    /* accumulate straight into the output frame */
+    memset (out, 0, out_channels * sizeof (gfloat));
+    for (i = 0; i < in_channels; i++)
+      accumulate_f32 (out, matrix + i * out_channels, in[i], out_channels);
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+void
+audio_mix_matrix_s16_neon (const gint16 * in, gint16 * out,
+    const gfloat * matrix, gfloat * acc, gint in_channels, gint out_channels,
+    gint n_samples)
+{
+  gint n, i, o;
+
+  for (n = 0; n < n_samples; n++) {
+    memset (acc, 0, out_channels * sizeof (gfloat));
+    for (i = 0; i < in_channels; i++)
+      accumulate_f32 (acc, matrix + i * out_channels, in[i], out_channels);
+
+    for (o = 0; o + 4 <= out_channels; o += 4) {
+      float32x4_t a = vld1q_f32 (acc + o);
+      /* round to nearest, the conversion saturates */
+#ifdef __aarch64__
+      int32x4_t v = vcvtnq_s32_f32 (a);
+#else
+      int32x4_t v = vcvtq_s32_f32 (vaddq_f32 (a,
+              vbslq_f32 (vcltq_f32 (a, vdupq_n_f32 (0.0f)),
+                  vdupq_n_f32 (-0.5f), vdupq_n_f32 (0.5f))));
+#endif
+      vst1_s16 (out + o, vqmovn_s32 (v));
+    }
+    for (; o < out_channels; o++)
+      out[o] = lrintf (CLAMP (acc[o], G_MININT16, G_MAXINT16));
+    in += in_channels;
+    out += out_channels;
+  }
+}
+#endif
@@ -0,0 +1,43 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_AUDIO_MIX_MATRIX_ARM_NEON_H__
+#define __GST_AUDIO_MIX_MATRIX_ARM_NEON_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#ifdef __ARM_NEON
+/* Dense interleaved mixing with the matrix transposed to
+ * m[in_channels][out_channels]. @acc holds one output frame. */
+G_GNUC_INTERNAL
+void audio_mix_matrix_f32_neon (const gfloat * in, gfloat * out,
+    const gfloat * matrix, gfloat * acc, gint in_channels, gint out_channels,
+    gint n_samples);
+
+G_GNUC_INTERNAL
+void audio_mix_matrix_s16_neon (const gint16 * in, gint16 * out,
+    const gfloat * matrix, gfloat * acc, gint in_channels, gint out_channels,
+    gint n_samples);
+#endif
+
+G_END_DECLS
+
+#endif /* __GST_AUDIO_MIX_MATRIX_ARM_NEON_H__ */
@@ -0,0 +1,158 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gstaudiomixmatrix-x86-avx2.h"
+
+#include <string.h>
+
+#if defined (HAVE_IMMINTRIN_H) && defined(__AVX2__)
+#include <immintrin.h>
+
+/* adds x * matrix to the out_channels values in @acc */
+static inline void
+accumulate_f32 (gfloat * acc, const gfloat * matrix, gfloat x,
+    gint out_channels)
+{
+  __m256 vx = _mm256_set1_ps (x);
+  gint o = 0;
+
+  for (; o + 8 <= out_channels; o += 8) {
+    __m256 a = _mm256_loadu_ps (acc + o);
+    __m256 m = _mm256_loadu_ps (matrix + o);
+    _mm256_storeu_ps (acc + o, _mm256_add_ps (a, _mm256_mul_ps (vx, m)));
+  }
+  for (; o < out_channels; o++)
+    acc[o] += x * matrix[o];
+}
+
+static inline void
+accumulate_f64 (gdouble * acc, const gdouble * matrix, gdouble x,
+    gint out_channels)
+{
+  __m256d vx = _mm256_set1_pd (x);
+  gint o = 0;
+
+  for (; o + 4 <= out_channels; o += 4) {
+    __m256d a = _mm256_loadu_pd (acc + o);
+    __m256d m = _mm256_loadu_pd (matrix + o);
+    _mm256_storeu_pd (acc + o, _mm256_add_pd (a, _mm256_mul_pd (vx, m)));
+  }
+  for (; o < out_channels; o++)
+    acc[o] += x * matrix[o];
+}
+
+void
+audio_mix_matrix_f32_avx2 (const gfloat * in, gfloat * out,
+    const gfloat * matrix, gfloat * acc, gint in_channels, gint out_channels,
+    gint n_samples)
+{
+  gint n, i;
+
+  for (n = 0; n < n_samples; n++) {
+    /* accumulate straight into the output frame */
+    memset (out, 0, out_channels * sizeof (gfloat));
+    for (i = 0; i < in_channels; i++)
+      accumulate_f32 (out, matrix + i * out_channels, in[i], out_channels);
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+void
+audio_mix_matrix_f64_avx2 (const gdouble * in, gdouble * out,
+    const gdouble * matrix, gdouble * acc, gint in_channels, gint out_channels,
+    gint n_samples)
+{
+  gint n, i;
+
+  for (n = 0; n < n_samples; n++) {
+    memset (out, 0, out_channels * sizeof (gdouble));
+    for (i = 0; i < in_channels; i++)
+      accumulate_f64 (out, matrix + i * out_channels, in[i], out_channels);
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+void
+audio_mix_matrix_s16_avx2 (const gint16 * in, gint16 * out,
+    const gfloat * matrix, gfloat * acc, gint in_channels, gint out_channels,
+    gint n_samples)
+{
+  const __m256 vmin = _mm256_set1_ps (G_MININT16);
+  const __m256 vmax = _mm256_set1_ps (G_MAXINT16);
+  gint n, i, o;
+
+  for (n = 0; n < n_samples; n++) {
+    memset (acc, 0, out_channels * sizeof (gfloat));
+    for (i = 0; i < in_channels; i++)
+      accumulate_f32 (acc, matrix + i * out_channels, in[i], out_channels);
+
+    for (o = 0; o + 8 <= out_channels; o += 8) {
+      __m256 a = _mm256_loadu_ps (acc + o);
+      __m256i v;
+
+      a = _mm256_min_ps (_mm256_max_ps (a, vmin), vmax);
+      v = _mm256_cvtps_epi32 (a);
+      _mm_storeu_si128 ((__m128i *) (out + o),
+          _mm_packs_epi32 (_mm256_castsi256_si128 (v),
+              _mm256_extracti128_si256 (v, 1)));
+    }
+    for (; o < out_channels; o++) {
+      gfloat a = CLAMP (acc[o], G_MININT16, G_MAXINT16);
+      out[o] = _mm_cvtss_si32 (_mm_set_ss (a));
+    }
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+void
+audio_mix_matrix_s32_avx2 (const gint32 * in, gint32 * out,
+    const gdouble * matrix, gdouble * acc, gint in_channels, gint out_channels,
+    gint n_samples)
+{
+  const __m256d vmin = _mm256_set1_pd (G_MININT32);
+  const __m256d vmax = _mm256_set1_pd (G_MAXINT32);
+  gint n, i, o;
+
+  for (n = 0; n < n_samples; n++) {
+    memset (acc, 0, out_channels * sizeof (gdouble));
+    for (i = 0; i < in_channels; i++)
+      accumulate_f64 (acc, matrix + i * out_channels, in[i], out_channels);
+
+    for (o = 0; o + 4 <= out_channels; o += 4) {
+      __m256d a = _mm256_loadu_pd (acc + o);
+
+      a = _mm256_min_pd (_mm256_max_pd (a, vmin), vmax);
+      _mm_storeu_si128 ((__m128i *) (out + o), _mm256_cvtpd_epi32 (a));
+    }
+    for (; o < out_channels; o++) {
+      gdouble a = CLAMP (acc[o], G_MININT32, G_MAXINT32);
+      out[o] = _mm_cvtsd_si32 (_mm_set_sd (a));
+    }
+    in += in_channels;
+    out += out_channels;
+  }
+}
+#endif
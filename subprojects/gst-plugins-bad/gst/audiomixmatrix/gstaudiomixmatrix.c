@@ -33,6 +33,9 @@
  * are automatically negotiated and the transformation matrix is a truncated
  * identity matrix.
  *
+ * Matrices with mostly zero coefficients, as typically used for routing
+ * channels, are detected and only the non-zero coefficients are evaluated.
+ *
  * ## Example matrix generation code
  * To generate the matrix using code:
  *
@@ -67,6 +70,8 @@
 #endif
 
 #include "gstaudiomixmatrix.h"
+#include "gstaudiomixmatrix-x86-avx2.h"
+#include "gstaudiomixmatrix-arm-neon.h"
 
 #include <gst/gst.h>
 #include <stdlib.h>
@@ -76,6 +81,35 @@
 GST_DEBUG_CATEGORY_STATIC (audiomixmatrix_debug);
 #define GST_CAT_DEFAULT audiomixmatrix_debug
 
+#define MAX_CHANNELS 256
+
+/* use the sparse representation when at most 1/SPARSE_DENSITY of the
+ * coefficients are non-zero */
+#define SPARSE_DENSITY 4
+
+/* mixing setup derived from the matrix. It is immutable once created, so
+ * that transform() can mix with a reference while the matrix is changed */
+struct _GstAudioMixMatrixKernels
+{
+  gint refcount;
+
+  guint in_channels;
+  guint out_channels;
+  gboolean sparse;
+  /* dense matrix transposed to m[in_channels][out_channels] */
+  gfloat *f32_matrix;
+  gdouble *f64_matrix;
+  /* non-zero coefficients of output channel i are at indices
+   * sparse_offsets[i] to sparse_offsets[i + 1] - 1 of sparse_in, which holds
+   * the input channel, and sparse_f32/sparse_f64 */
+  guint *sparse_offsets;
+  guint *sparse_in;
+  gfloat *sparse_f32;
+  gdouble *sparse_f64;
+  /* accumulator for one output frame, only used by the streaming thread */
+  gdouble *acc;
+};
+
 /* GstAudioMixMatrix properties */
 enum
 {
@@ -148,6 +182,166 @@ static GstCaps *gst_audio_mix_matrix_fixate_caps (GstBaseTransform * trans,
 static GstStateChangeReturn gst_audio_mix_matrix_change_state (GstElement *
     element, GstStateChange transition);
 
+/* dense mixing with the matrix transposed to m[in_channels][out_channels] so
+ * that the inner loop runs over the contiguous output frame */
+static void
+mix_f32_c (const gfloat * in, gfloat * out, const gfloat * matrix,
+    gfloat * acc, gint in_channels, gint out_channels, gint n_samples)
+{
+  gint n, i, o;
+
+  for (n = 0; n < n_samples; n++) {
+    for (o = 0; o < out_channels; o++)
+      out[o] = 0.0f;
+    for (i = 0; i < in_channels; i++) {
+      const gfloat *m = matrix + i * out_channels;
+      gfloat x = in[i];
+
+      for (o = 0; o < out_channels; o++)
+        out[o] += x * m[o];
+    }
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+static void
+mix_f64_c (const gdouble * in, gdouble * out, const gdouble * matrix,
+    gdouble * acc, gint in_channels, gint out_channels, gint n_samples)
+{
+  gint n, i, o;
+
+  for (n = 0; n < n_samples; n++) {
+    for (o = 0; o < out_channels; o++)
+      out[o] = 0.0;
+    for (i = 0; i < in_channels; i++) {
+      const gdouble *m = matrix + i * out_channels;
+      gdouble x = in[i];
+
+      for (o = 0; o < out_channels; o++)
+        out[o] += x * m[o];
+    }
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+static void
+mix_s16_c (const gint16 * in, gint16 * out, const gfloat * matrix,
+    gfloat * acc, gint in_channels, gint out_channels, gint n_samples)
+{
+  gint n, i, o;
+
+  for (n = 0; n < n_samples; n++) {
+    for (o = 0; o < out_channels; o++)
+      acc[o] = 0.0f;
+    for (i = 0; i < in_channels; i++) {
+      const gfloat *m = matrix + i * out_channels;
+      gfloat x = in[i];
+
+      for (o = 0; o < out_channels; o++)
+        acc[o] += x * m[o];
+    }
+    for (o = 0; o < out_channels; o++)
+      out[o] = lrintf (CLAMP (acc[o], G_MININT16, G_MAXINT16));
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+static void
+mix_s32_c (const gint32 * in, gint32 * out, const gdouble * matrix,
+    gdouble * acc, gint in_channels, gint out_channels, gint n_samples)
+{
+  gint n, i, o;
+
+  for (n = 0; n < n_samples; n++) {
+    for (o = 0; o < out_channels; o++)
+      acc[o] = 0.0;
+    for (i = 0; i < in_channels; i++) {
+      const gdouble *m = matrix + i * out_channels;
+      gdouble x = in[i];
+
+      for (o = 0; o < out_channels; o++)
+        acc[o] += x * m[o];
+    }
+    for (o = 0; o < out_channels; o++)
+      out[o] = lrint (CLAMP (acc[o], G_MININT32, G_MAXINT32));
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+static void (*mix_f32) (const gfloat * in, gfloat * out,
+    const gfloat * matrix, gfloat * acc, gint in_channels, gint out_channels,
+    gint n_samples) = mix_f32_c;
+static void (*mix_f64) (const gdouble * in, gdouble * out,
+    const gdouble * matrix, gdouble * acc, gint in_channels, gint out_channels,
+    gint n_samples) = mix_f64_c;
+static void (*mix_s16) (const gint16 * in, gint16 * out,
+    const gfloat * matrix, gfloat * acc, gint in_channels, gint out_channels,
+    gint n_samples) = mix_s16_c;
+static void (*mix_s32) (const gint32 * in, gint32 * out,
+    const gdouble * matrix, gdouble * acc, gint in_channels, gint out_channels,
+    gint n_samples) = mix_s32_c;
+
+/* sparse mixing only visits the non-zero coefficients of each output
+ * channel */
+#define DEFINE_SPARSE_MIX_FUNC(name, type, ctype, coeffs, store) \
+static void \
+mix_##name##_sparse (const GstAudioMixMatrixKernels * kernels, \
+    const type * in, type * out, gint n_samples) \
+{ \
+  const guint *offsets = kernels->sparse_offsets; \
+  const guint *in_idx = kernels->sparse_in; \
+  const ctype *c = kernels->coeffs; \
+  guint inchannels = kernels->in_channels; \
+  guint outchannels = kernels->out_channels; \
+  guint o, k; \
+  gint n; \
+  \
+  for (n = 0; n < n_samples; n++) { \
+    for (o = 0; o < outchannels; o++) { \
+      ctype res = 0; \
+      \
+      for (k = offsets[o]; k < offsets[o + 1]; k++) \
+        res += in[in_idx[k]] * c[k]; \
+      out[o] = store (res); \
+    } \
+    in += inchannels; \
+    out += outchannels; \
+  } \
+}
+
+#define STORE_FLOAT(res) (res)
+#define STORE_S16(res) lrintf (CLAMP (res, G_MININT16, G_MAXINT16))
+#define STORE_S32(res) lrint (CLAMP (res, G_MININT32, G_MAXINT32))
+
+DEFINE_SPARSE_MIX_FUNC (f32, gfloat, gfloat, sparse_f32, STORE_FLOAT);
+DEFINE_SPARSE_MIX_FUNC (f64, gdouble, gdouble, sparse_f64, STORE_FLOAT);
+DEFINE_SPARSE_MIX_FUNC (s16, gint16, gfloat, sparse_f32, STORE_S16);
+DEFINE_SPARSE_MIX_FUNC (s32, gint32, gdouble, sparse_f64, STORE_S32);
+
+static void
+gst_audio_mix_matrix_init_simd (void)
+{
+#if defined (HAVE_IMMINTRIN_H) && defined (HAVE_AVX2) && (defined (__GNUC__) || defined (__clang__))
+  /* ORC has no AVX2 target flag, so ask the CPU directly */
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2")) {
+    GST_DEBUG ("using AVX2 mixing");
+    mix_f32 = audio_mix_matrix_f32_avx2;
+    mix_f64 = audio_mix_matrix_f64_avx2;
+    mix_s16 = audio_mix_matrix_s16_avx2;
+    mix_s32 = audio_mix_matrix_s32_avx2;
+  }
+#elif defined (__ARM_NEON)
+  GST_DEBUG ("using NEON mixing");
+  mix_f32 = audio_mix_matrix_f32_neon;
+  mix_s16 = audio_mix_matrix_s16_neon;
+#endif
+}
+
 G_DEFINE_TYPE (GstAudioMixMatrix, gst_audio_mix_matrix,
     GST_TYPE_BASE_TRANSFORM);
 GST_ELEMENT_REGISTER_DEFINE (audiomixmatrix, "audiomixmatrix", GST_RANK_NONE,
@@ -162,6 +356,7 @@ gst_audio_mix_matrix_class_init (GstAudioMixMatrixClass * klass)
 
   GST_DEBUG_CATEGORY_INIT (audiomixmatrix_debug, "audiomixmatrix", 0,
       "audiomixmatrix");
+  gst_audio_mix_matrix_init_simd ();
   gst_element_class_set_static_metadata (element_class, "Matrix audio mix",
       "Filter/Audio",
       "Mixes a number of input channels into a number of output channels according to a transformation matrix",
@@ -174,11 +369,11 @@ gst_audio_mix_matrix_class_init (GstAudioMixMatrixClass * klass)
   g_object_class_install_property (gobject_class, PROP_IN_CHANNELS,
       g_param_spec_uint ("in-channels", "Input audio channels",
           "How many audio channels we have on the input side",
-          0, 64, 0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+          0, MAX_CHANNELS, 0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   g_object_class_install_property (gobject_class, PROP_OUT_CHANNELS,
       g_param_spec_uint ("out-channels", "Output audio channels",
           "How many audio channels we have on the output side",
-          0, 64, 0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+          0, MAX_CHANNELS, 0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   g_object_class_install_property (gobject_class, PROP_MATRIX,
       gst_param_spec_array ("matrix",
           "Input/output channel matrix",
@@ -229,60 +424,116 @@ gst_audio_mix_matrix_init (GstAudioMixMatrix * self)
   self->out_channels = 0;
   self->matrix = NULL;
   self->channel_mask = 0;
-  self->s16_conv_matrix = NULL;
-  self->s32_conv_matrix = NULL;
+  self->kernels = NULL;
   self->mode = GST_AUDIO_MIX_MATRIX_MODE_MANUAL;
 }
 
-static void
-gst_audio_mix_matrix_dispose (GObject * object)
+static GstAudioMixMatrixKernels *
+gst_audio_mix_matrix_kernels_ref (GstAudioMixMatrixKernels * kernels)
 {
-  GstAudioMixMatrix *self = GST_AUDIO_MIX_MATRIX (object);
+  g_atomic_int_inc (&kernels->refcount);
 
-  if (self->matrix) {
-    g_free (self->matrix);
-    self->matrix = NULL;
-  }
+  return kernels;
+}
 
-  G_OBJECT_CLASS (gst_audio_mix_matrix_parent_class)->dispose (object);
+static void
+gst_audio_mix_matrix_kernels_unref (GstAudioMixMatrixKernels * kernels)
+{
+  if (!g_atomic_int_dec_and_test (&kernels->refcount))
+    return;
+
+  g_free (kernels->f32_matrix);
+  g_free (kernels->f64_matrix);
+  g_free (kernels->sparse_offsets);
+  g_free (kernels->sparse_in);
+  g_free (kernels->sparse_f32);
+  g_free (kernels->sparse_f64);
+  g_free (kernels->acc);
+  g_free (kernels);
 }
 
+/* must be called with the object lock */
 static void
-gst_audio_mix_matrix_convert_s16_matrix (GstAudioMixMatrix * self)
+gst_audio_mix_matrix_clear_kernels (GstAudioMixMatrix * self)
 {
-  gint i;
+  g_clear_pointer (&self->kernels, gst_audio_mix_matrix_kernels_unref);
+}
+
+/* converts the matrix to the layouts used by the mixing functions, must be
+ * called with the object lock */
+static void
+gst_audio_mix_matrix_setup_kernels (GstAudioMixMatrix * self)
+{
+  GstAudioMixMatrixKernels *kernels;
+  guint in, out, nnz = 0, idx;
+  guint inchannels = self->in_channels;
+  guint outchannels = self->out_channels;
 
-  /* converted bits - input bits - sign - bits needed for channel */
-  self->shift_bytes = 32 - 16 - 1 - ceil (log (self->in_channels) / log (2));
+  gst_audio_mix_matrix_clear_kernels (self);
 
-  if (self->s16_conv_matrix)
-    g_free (self->s16_conv_matrix);
-  self->s16_conv_matrix =
-      g_new (gint32, self->in_channels * self->out_channels);
-  for (i = 0; i < self->in_channels * self->out_channels; i++) {
-    self->s16_conv_matrix[i] =
-        (gint32) ((self->matrix[i]) * (1 << self->shift_bytes));
+  if (self->matrix == NULL || inchannels == 0 || outchannels == 0)
+    return;
+
+  kernels = g_new0 (GstAudioMixMatrixKernels, 1);
+  kernels->refcount = 1;
+  kernels->in_channels = inchannels;
+  kernels->out_channels = outchannels;
+
+  kernels->f32_matrix = g_new (gfloat, inchannels * outchannels);
+  kernels->f64_matrix = g_new (gdouble, inchannels * outchannels);
+  for (out = 0; out < outchannels; out++) {
+    for (in = 0; in < inchannels; in++) {
+      gdouble coefficient = self->matrix[out * inchannels + in];
+
+      kernels->f32_matrix[in * outchannels + out] = coefficient;
+      kernels->f64_matrix[in * outchannels + out] = coefficient;
+      if (coefficient != 0.0)
+        nnz++;
+    }
   }
+  kernels->acc = g_new (gdouble, outchannels);
+  self->kernels = kernels;
+
+  kernels->sparse = nnz * SPARSE_DENSITY <= inchannels * outchannels;
+  GST_DEBUG_OBJECT (self, "%u of %u coefficients are non-zero, using %s "
+      "mixing", nnz, inchannels * outchannels,
+      kernels->sparse ? "sparse" : "dense");
+  if (!kernels->sparse)
+    return;
+
+  kernels->sparse_offsets = g_new (guint, outchannels + 1);
+  kernels->sparse_in = g_new (guint, MAX (nnz, 1));
+  kernels->sparse_f32 = g_new (gfloat, MAX (nnz, 1));
+  kernels->sparse_f64 = g_new (gdouble, MAX (nnz, 1));
+  for (out = 0, idx = 0; out < outchannels; out++) {
+    kernels->sparse_offsets[out] = idx;
+    for (in = 0; in < inchannels; in++) {
+      gdouble coefficient = self->matrix[out * inchannels + in];
+
+      if (coefficient == 0.0)
+        continue;
+      kernels->sparse_in[idx] = in;
+      kernels->sparse_f32[idx] = coefficient;
+      kernels->sparse_f64[idx] = coefficient;
+      idx++;
+    }
+  }
+  kernels->sparse_offsets[outchannels] = idx;
 }
 
 static void
-gst_audio_mix_matrix_convert_s32_matrix (GstAudioMixMatrix * self)
+gst_audio_mix_matrix_dispose (GObject * object)
 {
-  gint i;
-
-  /* converted bits - input bits - sign - bits needed for channel */
-  self->shift_bytes = 64 - 32 - 1 - (gint) (log (self->in_channels) / log (2));
+  GstAudioMixMatrix *self = GST_AUDIO_MIX_MATRIX (object);
 
-  if (self->s32_conv_matrix)
-    g_free (self->s32_conv_matrix);
-  self->s32_conv_matrix =
-      g_new (gint64, self->in_channels * self->out_channels);
-  for (i = 0; i < self->in_channels * self->out_channels; i++) {
-    self->s32_conv_matrix[i] =
-        (gint64) ((self->matrix[i]) * (1 << self->shift_bytes));
+  if (self->matrix) {
+    g_free (self->matrix);
+    self->matrix = NULL;
   }
-}
+  gst_audio_mix_matrix_clear_kernels (self);
 
+  G_OBJECT_CLASS (gst_audio_mix_matrix_parent_class)->dispose (object);
+}
 
 static void
 gst_audio_mix_matrix_set_property (GObject * object, guint prop_id,
@@ -291,43 +542,63 @@ gst_audio_mix_matrix_set_property (GObject * object, guint prop_id,
   GstAudioMixMatrix *self = GST_AUDIO_MIX_MATRIX (object);
 
   switch (prop_id) {
-    case PROP_IN_CHANNELS:
-      self->in_channels = g_value_get_uint (value);
-      if (self->matrix) {
-        gst_audio_mix_matrix_convert_s16_matrix (self);
-        gst_audio_mix_matrix_convert_s32_matrix (self);
+    case PROP_IN_CHANNELS:{
+      guint in_channels = g_value_get_uint (value);
+
+      GST_OBJECT_LOCK (self);
+      /* a matrix of the old size can't be used anymore */
+      if (self->matrix && in_channels != self->in_channels) {
+        g_clear_pointer (&self->matrix, g_free);
+        gst_audio_mix_matrix_clear_kernels (self);
       }
+      self->in_channels = in_channels;
+      GST_OBJECT_UNLOCK (self);
       break;
-    case PROP_OUT_CHANNELS:
-      self->out_channels = g_value_get_uint (value);
-      if (self->matrix) {
-        gst_audio_mix_matrix_convert_s16_matrix (self);
-        gst_audio_mix_matrix_convert_s32_matrix (self);
+    }
+    case PROP_OUT_CHANNELS:{
+      guint out_channels = g_value_get_uint (value);
+
+      GST_OBJECT_LOCK (self);
+      if (self->matrix && out_channels != self->out_channels) {
+        g_clear_pointer (&self->matrix, g_free);
+        gst_audio_mix_matrix_clear_kernels (self);
       }
+      self->out_channels = out_channels;
+      GST_OBJECT_UNLOCK (self);
       break;
+    }
     case PROP_MATRIX:{
       gint in, out;
-
-      if (self->matrix)
-        g_free (self->matrix);
-      self->matrix = g_new (gdouble, self->in_channels * self->out_channels);
+      gdouble *matrix;
 
       g_return_if_fail (gst_value_array_get_size (value) == self->out_channels);
+      matrix = g_new (gdouble, self->in_channels * self->out_channels);
       for (out = 0; out < self->out_channels; out++) {
         const GValue *row = gst_value_array_get_value (value, out);
-        g_return_if_fail (gst_value_array_get_size (row) == self->in_channels);
+        if (gst_value_array_get_size (row) != self->in_channels)
+          goto invalid_matrix;
         for (in = 0; in < self->in_channels; in++) {
           const GValue *itm;
           gdouble coefficient;
 
           itm = gst_value_array_get_value (row, in);
-          g_return_if_fail (G_VALUE_HOLDS_DOUBLE (itm));
+          if (!G_VALUE_HOLDS_DOUBLE (itm))
+            goto invalid_matrix;
           coefficient = g_value_get_double (itm);
-          self->matrix[out * self->in_channels + in] = coefficient;
+          matrix[out * self->in_channels + in] = coefficient;
         }
       }
-      gst_audio_mix_matrix_convert_s16_matrix (self);
-      gst_audio_mix_matrix_convert_s32_matrix (self);
+
+      GST_OBJECT_LOCK (self);
+      g_free (self->matrix);
+      self->matrix = matrix;
+      gst_audio_mix_matrix_setup_kernels (self);
+      GST_OBJECT_UNLOCK (self);
+      break;
+
+    invalid_matrix:
+      g_free (matrix);
+      g_return_if_reached ();
       break;
     }
     case PROP_CHANNEL_MASK:
@@ -399,15 +670,9 @@ gst_audio_mix_matrix_change_state (GstElement * element,
       (element, transition);
 
   if (transition == GST_STATE_CHANGE_PAUSED_TO_READY) {
-    if (self->s16_conv_matrix) {
-      g_free (self->s16_conv_matrix);
-      self->s16_conv_matrix = NULL;
-    }
-
-    if (self->s32_conv_matrix) {
-      g_free (self->s32_conv_matrix);
-      self->s32_conv_matrix = NULL;
-    }
+    GST_OBJECT_LOCK (self);
+    gst_audio_mix_matrix_clear_kernels (self);
+    GST_OBJECT_UNLOCK (self);
   }
 
   return s;
@@ -420,120 +685,105 @@ gst_audio_mix_matrix_transform (GstBaseTransform * vfilter,
 {
   GstMapInfo inmap, outmap;
   GstAudioMixMatrix *self = GST_AUDIO_MIX_MATRIX (vfilter);
-  gint in, out, sample;
-  guint inchannels = self->in_channels;
-  guint outchannels = self->out_channels;
-  gdouble *matrix = self->matrix;
+  GstAudioMixMatrixKernels *kernels;
+  guint inchannels, outchannels, bps;
+  GstFlowReturn ret = GST_FLOW_OK;
+  gint n_samples;
+
+  /* mix with a snapshot of the matrix, so that setting a new one doesn't
+   * have to wait for the whole buffer */
+  GST_OBJECT_LOCK (self);
+  if (G_UNLIKELY (self->kernels == NULL))
+    gst_audio_mix_matrix_setup_kernels (self);
+  kernels = self->kernels ? gst_audio_mix_matrix_kernels_ref (self->kernels) :
+      NULL;
+  GST_OBJECT_UNLOCK (self);
+
+  if (kernels == NULL) {
+    GST_ELEMENT_ERROR (self, CORE, NEGOTIATION, (NULL),
+        ("No transformation matrix"));
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  inchannels = kernels->in_channels;
+  outchannels = kernels->out_channels;
 
   if (!gst_buffer_map (inbuf, &inmap, GST_MAP_READ)) {
+    gst_audio_mix_matrix_kernels_unref (kernels);
     return GST_FLOW_ERROR;
   }
   if (!gst_buffer_map (outbuf, &outmap, GST_MAP_WRITE)) {
     gst_buffer_unmap (inbuf, &inmap);
+    gst_audio_mix_matrix_kernels_unref (kernels);
     return GST_FLOW_ERROR;
   }
 
+  /* the channels might have been changed since the caps were negotiated */
+  bps = GST_AUDIO_FORMAT_INFO_WIDTH (gst_audio_format_get_info (self->format))
+      / 8;
+  if (inmap.size / (bps * inchannels) != outmap.size / (bps * outchannels)) {
+    gst_buffer_unmap (inbuf, &inmap);
+    gst_buffer_unmap (outbuf, &outmap);
+    gst_audio_mix_matrix_kernels_unref (kernels);
+    GST_ELEMENT_ERROR (self, CORE, NEGOTIATION, (NULL),
+        ("Matrix does not match the negotiated channels"));
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
   switch (self->format) {
     case GST_AUDIO_FORMAT_F32LE:
-    case GST_AUDIO_FORMAT_F32BE:{
-      const gfloat *inarray;
-      gfloat *outarray;
-      guint n_samples = outmap.size / (sizeof (gfloat) * outchannels);
-
-      inarray = (gfloat *) inmap.data;
-      outarray = (gfloat *) outmap.data;
-
-      for (sample = 0; sample < n_samples; sample++) {
-        for (out = 0; out < outchannels; out++) {
-          gfloat outval = 0;
-          for (in = 0; in < inchannels; in++) {
-            outval +=
-                inarray[sample * inchannels +
-                in] * matrix[out * inchannels + in];
-          }
-          outarray[sample * outchannels + out] = outval;
-        }
-      }
+    case GST_AUDIO_FORMAT_F32BE:
+      n_samples = outmap.size / (sizeof (gfloat) * outchannels);
+      if (kernels->sparse)
+        mix_f32_sparse (kernels, (const gfloat *) inmap.data,
+            (gfloat *) outmap.data, n_samples);
+      else
+        mix_f32 ((const gfloat *) inmap.data, (gfloat *) outmap.data,
+            kernels->f32_matrix, (gfloat *) kernels->acc, inchannels,
+            outchannels, n_samples);
       break;
-    }
     case GST_AUDIO_FORMAT_F64LE:
-    case GST_AUDIO_FORMAT_F64BE:{
-      const gdouble *inarray;
-      gdouble *outarray;
-      guint n_samples = outmap.size / (sizeof (gdouble) * outchannels);
-
-      inarray = (gdouble *) inmap.data;
-      outarray = (gdouble *) outmap.data;
-
-      for (sample = 0; sample < n_samples; sample++) {
-        for (out = 0; out < outchannels; out++) {
-          gdouble outval = 0;
-          for (in = 0; in < inchannels; in++) {
-            outval +=
-                inarray[sample * inchannels +
-                in] * matrix[out * inchannels + in];
-          }
-          outarray[sample * outchannels + out] = outval;
-        }
-      }
+    case GST_AUDIO_FORMAT_F64BE:
+      n_samples = outmap.size / (sizeof (gdouble) * outchannels);
+      if (kernels->sparse)
+        mix_f64_sparse (kernels, (const gdouble *) inmap.data,
+            (gdouble *) outmap.data, n_samples);
+      else
+        mix_f64 ((const gdouble *) inmap.data, (gdouble *) outmap.data,
+            kernels->f64_matrix, kernels->acc, inchannels, outchannels,
+            n_samples);
       break;
-    }
     case GST_AUDIO_FORMAT_S16LE:
-    case GST_AUDIO_FORMAT_S16BE:{
-      const gint16 *inarray;
-      gint16 *outarray;
-      guint n_samples = outmap.size / (sizeof (gint16) * outchannels);
-      guint n = self->shift_bytes;
-      gint32 *conv_matrix = self->s16_conv_matrix;
-
-      inarray = (gint16 *) inmap.data;
-      outarray = (gint16 *) outmap.data;
-
-      for (sample = 0; sample < n_samples; sample++) {
-        for (out = 0; out < outchannels; out++) {
-          gint32 outval = 0;
-          for (in = 0; in < inchannels; in++) {
-            outval += (gint32) (inarray[sample * inchannels + in] *
-                conv_matrix[out * inchannels + in]);
-          }
-          outarray[sample * outchannels + out] = (gint16) (outval >> n);
-        }
-      }
+    case GST_AUDIO_FORMAT_S16BE:
+      n_samples = outmap.size / (sizeof (gint16) * outchannels);
+      if (kernels->sparse)
+        mix_s16_sparse (kernels, (const gint16 *) inmap.data,
+            (gint16 *) outmap.data, n_samples);
+      else
+        mix_s16 ((const gint16 *) inmap.data, (gint16 *) outmap.data,
+            kernels->f32_matrix, (gfloat *) kernels->acc, inchannels,
+            outchannels, n_samples);
       break;
-    }
     case GST_AUDIO_FORMAT_S32LE:
-    case GST_AUDIO_FORMAT_S32BE:{
-      const gint32 *inarray;
-      gint32 *outarray;
-      guint n_samples = outmap.size / (sizeof (gint32) * outchannels);
-      guint n = self->shift_bytes;
-      gint64 *conv_matrix = self->s32_conv_matrix;
-
-      inarray = (gint32 *) inmap.data;
-      outarray = (gint32 *) outmap.data;
-
-      for (sample = 0; sample < n_samples; sample++) {
-        for (out = 0; out < outchannels; out++) {
-          gint64 outval = 0;
-          for (in = 0; in < inchannels; in++) {
-            outval += (gint64) (inarray[sample * inchannels + in] *
-                conv_matrix[out * inchannels + in]);
-          }
-          outarray[sample * outchannels + out] = (gint32) (outval >> n);
-        }
-      }
+    case GST_AUDIO_FORMAT_S32BE:
+      n_samples = outmap.size / (sizeof (gint32) * outchannels);
+      if (kernels->sparse)
+        mix_s32_sparse (kernels, (const gint32 *) inmap.data,
+            (gint32 *) outmap.data, n_samples);
+      else
+        mix_s32 ((const gint32 *) inmap.data, (gint32 *) outmap.data,
+            kernels->f64_matrix, kernels->acc, inchannels, outchannels,
+            n_samples);
       break;
-    }
     default:
-      gst_buffer_unmap (inbuf, &inmap);
-      gst_buffer_unmap (outbuf, &outmap);
-      return GST_FLOW_NOT_SUPPORTED;
-
+      ret = GST_FLOW_NOT_SUPPORTED;
+      break;
   }
 
   gst_buffer_unmap (inbuf, &inmap);
   gst_buffer_unmap (outbuf, &outmap);
-  return GST_FLOW_OK;
+  gst_audio_mix_matrix_kernels_unref (kernels);
+  return ret;
 }
 
 static gboolean
@@ -565,12 +815,14 @@ gst_audio_mix_matrix_set_caps (GstBaseTransform * trans, GstCaps * incaps,
 
   self->format = info.finfo->format;
 
+  GST_OBJECT_LOCK (self);
   if (self->mode == GST_AUDIO_MIX_MATRIX_MODE_FIRST_CHANNELS) {
     gint in, out;
 
     self->in_channels = info.channels;
     self->out_channels = out_info.channels;
 
+    g_free (self->matrix);
     self->matrix = g_new (gdouble, self->in_channels * self->out_channels);
 
     for (out = 0; out < self->out_channels; out++) {
@@ -580,26 +832,16 @@ gst_audio_mix_matrix_set_caps (GstBaseTransform * trans, GstCaps * incaps,
     }
   } else if (!self->matrix || info.channels != self->in_channels ||
       out_info.channels != self->out_channels) {
+    GST_OBJECT_UNLOCK (self);
     GST_ELEMENT_ERROR (self, LIBRARY, SETTINGS,
         ("Erroneous matrix detected"),
         ("Please enter a matrix with the correct input and output channels"));
     return FALSE;
   }
 
-  switch (self->format) {
-    case GST_AUDIO_FORMAT_S16LE:
-    case GST_AUDIO_FORMAT_S16BE:{
-      gst_audio_mix_matrix_convert_s16_matrix (self);
-      break;
-    }
-    case GST_AUDIO_FORMAT_S32LE:
-    case GST_AUDIO_FORMAT_S32BE:{
-      gst_audio_mix_matrix_convert_s32_matrix (self);
-      break;
-    }
-    default:
-      break;
-  }
+  gst_audio_mix_matrix_setup_kernels (self);
+  GST_OBJECT_UNLOCK (self);
+
   return TRUE;
 }
 
@@ -36,6 +36,7 @@
 
 typedef struct _GstAudioMixMatrix GstAudioMixMatrix;
 typedef struct _GstAudioMixMatrixClass GstAudioMixMatrixClass;
+typedef struct _GstAudioMixMatrixKernels GstAudioMixMatrixKernels;
 
 typedef enum _GstAudioMixMatrixMode
 {
@@ -58,9 +59,9 @@ struct _GstAudioMixMatrix
   gdouble *matrix;
   guint64 channel_mask;
   GstAudioMixMatrixMode mode;
-  gint32 *s16_conv_matrix;
-  gint64 *s32_conv_matrix;
-  gint shift_bytes;
+
+  /* mixing setup derived from the matrix, with the object lock */
+  GstAudioMixMatrixKernels *kernels;
 
   GstAudioFormat format;
 };
@@ -228,7 +228,7 @@ gst_inter_audio_sink_stop (GstBaseSink * sink)
   GST_DEBUG_OBJECT (interaudiosink, "stop");
 
   g_mutex_lock (&interaudiosink->surface->mutex);
-  gst_adapter_clear (interaudiosink->surface->audio_adapter);
+  gst_inter_surface_audio_clear (interaudiosink->surface);
   memset (&interaudiosink->surface->audio_info, 0, sizeof (GstAudioInfo));
   g_mutex_unlock (&interaudiosink->surface->mutex);
 
@@ -255,7 +255,7 @@ gst_inter_audio_sink_set_caps (GstBaseSink * sink, GstCaps * caps)
   interaudiosink->surface->audio_info = info;
   interaudiosink->info = info;
   /* TODO: Ideally we would drain the source here */
-  gst_adapter_clear (interaudiosink->surface->audio_adapter);
+  gst_inter_surface_audio_clear (interaudiosink->surface);
   g_mutex_unlock (&interaudiosink->surface->mutex);
 
   return TRUE;
@@ -274,7 +274,7 @@ gst_inter_audio_sink_event (GstBaseSink * sink, GstEvent * event)
       if ((n = gst_adapter_available (interaudiosink->input_adapter)) > 0) {
         g_mutex_lock (&interaudiosink->surface->mutex);
         tmp = gst_adapter_take_buffer (interaudiosink->input_adapter, n);
-        gst_adapter_push (interaudiosink->surface->audio_adapter, tmp);
+        gst_inter_surface_audio_push (interaudiosink->surface, tmp);
         g_mutex_unlock (&interaudiosink->surface->mutex);
       }
       break;
@@ -319,14 +319,8 @@ gst_inter_audio_sink_render (GstBaseSink * sink, GstBuffer * buffer)
       gst_util_uint64_scale (period_time, interaudiosink->info.rate,
       GST_SECOND);
 
-  n = gst_adapter_available (interaudiosink->surface->audio_adapter) / bpf;
-  while (n > buffer_samples) {
-    GST_DEBUG_OBJECT (interaudiosink, "flushing %" GST_TIME_FORMAT,
-        GST_TIME_ARGS (period_time));
-    gst_adapter_flush (interaudiosink->surface->audio_adapter,
-        period_samples * bpf);
-    n -= period_samples;
-  }
+  /* the readers don't consume the data, keep at most buffer-time of it */
+  gst_inter_surface_audio_trim (interaudiosink->surface, buffer_samples * bpf);
 
   n = gst_adapter_available (interaudiosink->input_adapter);
   if (period_samples * bpf > gst_buffer_get_size (buffer) + n) {
@@ -336,9 +330,9 @@ gst_inter_audio_sink_render (GstBaseSink * sink, GstBuffer * buffer)
 
     if (n > 0) {
       tmp = gst_adapter_take_buffer (interaudiosink->input_adapter, n);
-      gst_adapter_push (interaudiosink->surface->audio_adapter, tmp);
+      gst_inter_surface_audio_push (interaudiosink->surface, tmp);
     }
-    gst_adapter_push (interaudiosink->surface->audio_adapter,
+    gst_inter_surface_audio_push (interaudiosink->surface,
         gst_buffer_ref (buffer));
   }
   g_mutex_unlock (&interaudiosink->surface->mutex);
@@ -284,6 +284,7 @@ gst_inter_audio_src_start (GstBaseSrc * src)
   interaudiosrc->surface = gst_inter_surface_get (interaudiosrc->channel);
   interaudiosrc->timestamp_offset = 0;
   interaudiosrc->n_samples = 0;
+  interaudiosrc->audio_pos = GST_INTER_SURFACE_AUDIO_POS_NONE;
 
   g_mutex_lock (&interaudiosrc->surface->mutex);
   interaudiosrc->surface->audio_buffer_time = interaudiosrc->buffer_time;
@@ -366,15 +367,16 @@ gst_inter_audio_src_create (GstBaseSrc * src, guint64 offset, guint size,
       gst_util_uint64_scale (period_time, interaudiosrc->info.rate, GST_SECOND);
 
   if (bpf > 0)
-    n = gst_adapter_available (interaudiosrc->surface->audio_adapter) / bpf;
+    n = gst_inter_surface_audio_available (interaudiosrc->surface,
+        &interaudiosrc->audio_pos) / bpf;
   else
     n = 0;
 
   if (n > period_samples)
     n = period_samples;
   if (n > 0) {
-    buffer = gst_adapter_take_buffer (interaudiosrc->surface->audio_adapter,
-        n * bpf);
+    buffer = gst_inter_surface_audio_read (interaudiosrc->surface,
+        &interaudiosrc->audio_pos, n * bpf);
   } else {
     buffer = gst_buffer_new ();
     GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_GAP);
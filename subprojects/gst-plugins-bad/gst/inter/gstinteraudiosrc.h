@@ -46,6 +46,8 @@ struct _GstInterAudioSrc
   GstClockTime timestamp_offset;
   GstAudioInfo info;
   guint64 buffer_time, latency_time, period_time;
+  /* read position in the surface audio */
+  guint64 audio_pos;
 };
 
 struct _GstInterAudioSrcClass
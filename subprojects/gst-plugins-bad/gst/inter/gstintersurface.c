@@ -48,7 +48,7 @@ gst_inter_surface_get (const char *name)
   surface->ref_count = 1;
   surface->name = g_strdup (name);
   g_mutex_init (&surface->mutex);
-  surface->audio_adapter = gst_adapter_new ();
+  g_queue_init (&surface->audio_buffers);
   surface->audio_buffer_time = DEFAULT_AUDIO_BUFFER_TIME;
   surface->audio_latency_time = DEFAULT_AUDIO_LATENCY_TIME;
   surface->audio_period_time = DEFAULT_AUDIO_PERIOD_TIME;
@@ -80,9 +80,131 @@ gst_inter_surface_unref (GstInterSurface * surface)
     g_mutex_clear (&surface->mutex);
     gst_buffer_replace (&surface->video_buffer, NULL);
     gst_buffer_replace (&surface->sub_buffer, NULL);
-    gst_object_unref (surface->audio_adapter);
+    gst_inter_surface_audio_clear (surface);
     g_free (surface->name);
     g_free (surface);
   }
   g_mutex_unlock (&mutex);
 }
+
+/* All the audio functions must be called with the surface mutex held.
+ *
+ * The audio is kept as a list of buffers instead of a GstAdapter, so that
+ * multiple readers can get zero-copy sub-buffers of it at their own position
+ * without consuming it. Only the writer drops data, when there is more than
+ * buffer-time worth of it. */
+
+/* takes ownership of @buffer */
+void
+gst_inter_surface_audio_push (GstInterSurface * surface, GstBuffer * buffer)
+{
+  gsize size = gst_buffer_get_size (buffer);
+
+  if (size == 0) {
+    gst_buffer_unref (buffer);
+    return;
+  }
+
+  g_queue_push_tail (&surface->audio_buffers, buffer);
+  surface->audio_end += size;
+}
+
+/* drops the oldest data until at most @max_size bytes are left */
+void
+gst_inter_surface_audio_trim (GstInterSurface * surface, guint64 max_size)
+{
+  while (surface->audio_end - surface->audio_start > max_size) {
+    GstBuffer *head = g_queue_peek_head (&surface->audio_buffers);
+    guint64 excess = surface->audio_end - surface->audio_start - max_size;
+    gsize size = gst_buffer_get_size (head);
+
+    if (size <= excess) {
+      gst_buffer_unref (g_queue_pop_head (&surface->audio_buffers));
+      surface->audio_start += size;
+    } else {
+      GstBuffer *tail = gst_buffer_copy_region (head, GST_BUFFER_COPY_MEMORY,
+          excess, size - excess);
+
+      gst_buffer_unref (head);
+      g_queue_peek_head_link (&surface->audio_buffers)->data = tail;
+      surface->audio_start += excess;
+    }
+  }
+}
+
+void
+gst_inter_surface_audio_clear (GstInterSurface * surface)
+{
+  GstBuffer *buffer;
+
+  while ((buffer = g_queue_pop_head (&surface->audio_buffers)))
+    gst_buffer_unref (buffer);
+
+  /* positions stay monotonic so that the readers notice the discontinuity */
+  surface->audio_start = surface->audio_end;
+}
+
+/* updates the reader position @pos if it is not valid anymore and returns
+ * the number of bytes it can read */
+guint64
+gst_inter_surface_audio_available (GstInterSurface * surface, guint64 * pos)
+{
+  if (*pos == GST_INTER_SURFACE_AUDIO_POS_NONE) {
+    guint64 latency = 0;
+
+    /* a new reader starts latency-time behind the writer and not at the
+     * start of the history, like a reader that kept up */
+    if (surface->audio_info.finfo && surface->audio_info.rate > 0)
+      latency = gst_util_uint64_scale (surface->audio_latency_time,
+          surface->audio_info.rate, GST_SECOND) * surface->audio_info.bpf;
+
+    if (surface->audio_end - surface->audio_start > latency)
+      *pos = surface->audio_end - latency;
+    else
+      *pos = surface->audio_start;
+  } else if (*pos < surface->audio_start) {
+    /* the reader fell behind or the writer was reset */
+    *pos = surface->audio_start;
+  }
+
+  return surface->audio_end - *pos;
+}
+
+/* returns up to @size bytes from the reader position @pos and advances it,
+ * the returned buffer shares the memory of the queued ones */
+GstBuffer *
+gst_inter_surface_audio_read (GstInterSurface * surface, guint64 * pos,
+    guint64 size)
+{
+  GstBuffer *result = NULL;
+  guint64 offset;
+  GList *l;
+
+  size = MIN (size, gst_inter_surface_audio_available (surface, pos));
+  if (size == 0)
+    return NULL;
+
+  offset = surface->audio_start;
+  for (l = surface->audio_buffers.head; l && size > 0; l = l->next) {
+    GstBuffer *buffer = l->data;
+    gsize buffer_size = gst_buffer_get_size (buffer);
+    GstBuffer *region;
+    gsize skip, len;
+
+    if (offset + buffer_size <= *pos) {
+      offset += buffer_size;
+      continue;
+    }
+
+    skip = *pos - offset;
+    len = MIN (buffer_size - skip, size);
+    region = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_MEMORY, skip, len);
+    result = result ? gst_buffer_append (result, region) : region;
+
+    *pos += len;
+    size -= len;
+    offset += buffer_size;
+  }
+
+  return result;
+}
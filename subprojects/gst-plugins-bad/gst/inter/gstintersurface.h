@@ -37,7 +37,9 @@ struct _GstInterSurface
 
   /* video */
   GstVideoInfo video_info;
-  int video_buffer_count;
+  /* incremented for every new video_buffer, readers compare it with the
+   * last one they have seen to detect repeats */
+  guint64 video_buffer_seqnum;
 
   /* audio */
   GstAudioInfo audio_info;
@@ -47,9 +49,17 @@ struct _GstInterSurface
 
   GstBuffer *video_buffer;
   GstBuffer *sub_buffer;
-  GstAdapter *audio_adapter;
+
+  /* audio history shared by all readers, each reader keeps its own byte
+   * position in [audio_start, audio_end) */
+  GQueue audio_buffers;
+  guint64 audio_start;
+  guint64 audio_end;
 };
 
+/* position of a reader that did not read any audio yet */
+#define GST_INTER_SURFACE_AUDIO_POS_NONE G_MAXUINT64
+
 #define DEFAULT_AUDIO_BUFFER_TIME  (GST_SECOND)
 #define DEFAULT_AUDIO_LATENCY_TIME (100 * GST_MSECOND)
 #define DEFAULT_AUDIO_PERIOD_TIME  (25 * GST_MSECOND)
@@ -58,6 +68,13 @@ struct _GstInterSurface
 GstInterSurface * gst_inter_surface_get (const char *name);
 void gst_inter_surface_unref (GstInterSurface *surface);
 
+void gst_inter_surface_audio_push (GstInterSurface *surface, GstBuffer *buffer);
+void gst_inter_surface_audio_trim (GstInterSurface *surface, guint64 max_size);
+void gst_inter_surface_audio_clear (GstInterSurface *surface);
+guint64 gst_inter_surface_audio_available (GstInterSurface *surface, guint64 *pos);
+GstBuffer * gst_inter_surface_audio_read (GstInterSurface *surface, guint64 *pos,
+    guint64 size);
+
 
 G_END_DECLS
 
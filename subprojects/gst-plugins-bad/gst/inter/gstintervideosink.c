@@ -257,7 +257,7 @@ gst_inter_video_sink_show_frame (GstVideoSink * sink, GstBuffer * buffer)
     gst_buffer_unref (intervideosink->surface->video_buffer);
   }
   intervideosink->surface->video_buffer = gst_buffer_ref (buffer);
-  intervideosink->surface->video_buffer_count = 0;
+  intervideosink->surface->video_buffer_seqnum++;
   g_mutex_unlock (&intervideosink->surface->mutex);
 
   return GST_FLOW_OK;
@@ -278,6 +278,8 @@ gst_inter_video_src_start (GstBaseSrc * src)
   intervideosrc->surface = gst_inter_surface_get (intervideosrc->channel);
   intervideosrc->timestamp_offset = 0;
   intervideosrc->n_frames = 0;
+  intervideosrc->video_seqnum = 0;
+  intervideosrc->video_count = 0;
 
   return TRUE;
 }
@@ -362,24 +364,27 @@ gst_inter_video_src_create (GstBaseSrc * src, guint64 offset, guint size,
     }
   }
 
-  if (intervideosrc->surface->video_buffer) {
+  /* The surface buffer is shared by all sources of the channel, each of them
+   * counts on its own how often it repeated it */
+  if (intervideosrc->surface->video_buffer_seqnum !=
+      intervideosrc->video_seqnum) {
+    intervideosrc->video_seqnum = intervideosrc->surface->video_buffer_seqnum;
+    intervideosrc->video_count = 0;
+  }
+
+  if (intervideosrc->surface->video_buffer &&
+      intervideosrc->video_count <= frames) {
     /* We have a buffer to push */
     buffer = gst_buffer_ref (intervideosrc->surface->video_buffer);
-
-    /* Can only be true if timeout > 0 */
-    if (intervideosrc->surface->video_buffer_count == frames) {
-      gst_buffer_unref (intervideosrc->surface->video_buffer);
-      intervideosrc->surface->video_buffer = NULL;
-    }
   }
 
-  if (intervideosrc->surface->video_buffer_count != 0 &&
-      intervideosrc->surface->video_buffer_count != (frames + 1)) {
+  if (intervideosrc->video_count != 0 &&
+      intervideosrc->video_count != (frames + 1)) {
     /* This is a repeat of the stored buffer or of a black frame */
     is_gap = TRUE;
   }
 
-  intervideosrc->surface->video_buffer_count++;
+  intervideosrc->video_count++;
   g_mutex_unlock (&intervideosrc->surface->mutex);
 
   if (caps) {
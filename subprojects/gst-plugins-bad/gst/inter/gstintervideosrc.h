@@ -48,6 +48,9 @@ struct _GstInterVideoSrc
   GstBuffer *black_frame;
   int n_frames;
   GstClockTime timestamp_offset;
+  /* surface buffer last output and how often it was output */
+  guint64 video_seqnum;
+  guint64 video_count;
 };
 
 struct _GstInterVideoSrcClass
@@ -85,7 +85,9 @@ typedef struct
   guint8  section_number;
   guint8  last_section_number;
 
-  GSList *subtables;
+  /* table_id << 16 | subtable_extension -> MpegTSPacketizerStreamSubtable,
+   * created on the first section */
+  GHashTable *subtables;
 
   /* Upstream offset of the data contained in the section */
   guint64 offset;
@@ -70,10 +70,22 @@
  */
 #define SEEK_TIMESTAMP_OFFSET (2500 * GST_MSECOND)
 
+/* Start offset of a keyframe search that succeeded, with the pts of the
+ * keyframe that was found from there */
+typedef struct
+{
+  GstClockTime pts;
+  guint64 offset;
+} TSDemuxKeyframeEntry;
+
 #define GST_FLOW_REWINDING GST_FLOW_CUSTOM_ERROR
 
 /* latency in msecs */
 #define DEFAULT_LATENCY (700)
+#define DEFAULT_OUTPUT_THREADS FALSE
+
+/* Maximum number of buffers/events queued up for a stream output thread */
+#define MAX_OUTPUT_QUEUE_SIZE 32
 
 /* Limit PES packet collection to a maximum of 32MB
  * which is more than large enough to support an H264 frame at
@@ -227,6 +239,21 @@ struct _TSDemuxStream
   TSDemuxH264ParsingInfos h264infos;
   TSDemuxJP2KParsingInfos jp2kInfos;
   TSDemuxADTSParsingInfos atdsInfos;
+
+  /* Whether data is pushed from the stream's own pad task */
+  gboolean threaded;
+
+  /* Output queue, protected by output_lock */
+  GMutex output_lock;
+  GCond output_cond;
+  GQueue output_queue;
+  gboolean output_flushing;
+  /* TRUE if the pad task was started */
+  gboolean output_running;
+  /* TRUE while the pad task is pushing an item downstream */
+  gboolean output_pushing;
+  /* Last flow return of the pad task */
+  GstFlowReturn output_flow;
 };
 
 #define VIDEO_CAPS \
@@ -302,6 +329,7 @@ enum
   PROP_EMIT_STATS,
   PROP_LATENCY,
   PROP_SEND_SCTE35_EVENTS,
+  PROP_OUTPUT_THREADS,
   /* FILL ME */
 };
 
@@ -385,6 +413,7 @@ gst_ts_demux_finalize (GObject * object)
   GstTSDemux *demux = GST_TS_DEMUX_CAST (object);
 
   gst_event_replace (&demux->segment_event, NULL);
+  g_array_unref (demux->keyframe_index);
   g_mutex_clear (&demux->lock);
 
   GST_CALL_PARENT (G_OBJECT_CLASS, finalize, (object));
@@ -435,6 +464,27 @@ gst_ts_demux_class_init (GstTSDemuxClass * klass)
           G_MAXINT, DEFAULT_LATENCY,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * tsdemux:output-threads:
+   *
+   * Push the data of each elementary stream from its own streaming thread.
+   *
+   * Packet synchronization, PID filtering and PCR/timestamp handling stay in
+   * the upstream streaming thread, only the downstream pushes are moved to a
+   * per-stream pad task with a small bounded queue. This allows expensive
+   * downstream branches (e.g. decoders without a queue in front of them) to
+   * be processed in parallel.
+   *
+   * Changes only take effect for pads created after the property is set.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_OUTPUT_THREADS,
+      g_param_spec_boolean ("output-threads", "Output threads",
+          "Push each stream from its own streaming thread",
+          DEFAULT_OUTPUT_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   element_class = GST_ELEMENT_CLASS (klass);
   gst_element_class_add_pad_template (element_class,
       gst_static_pad_template_get (&video_template));
@@ -493,6 +543,7 @@ gst_ts_demux_reset (MpegTSBase * base)
   demux->group_id = G_MAXUINT;
 
   demux->last_seek_offset = -1;
+  g_array_set_size (demux->keyframe_index, 0);
   demux->program_generation = 0;
 
   demux->mpeg_pts_offset = 0;
@@ -512,6 +563,9 @@ gst_ts_demux_init (GstTSDemux * demux)
   demux->requested_program_number = -1;
   demux->program_number = -1;
   demux->latency = DEFAULT_LATENCY;
+  demux->output_threads = DEFAULT_OUTPUT_THREADS;
+  demux->keyframe_index =
+      g_array_new (FALSE, FALSE, sizeof (TSDemuxKeyframeEntry));
   gst_ts_demux_reset (base);
 
   g_mutex_init (&demux->lock);
@@ -539,6 +593,11 @@ gst_ts_demux_set_property (GObject * object, guint prop_id,
     case PROP_LATENCY:
       demux->latency = g_value_get_int (value);
       break;
+    case PROP_OUTPUT_THREADS:
+      GST_OBJECT_LOCK (demux);
+      demux->output_threads = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (demux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -563,6 +622,11 @@ gst_ts_demux_get_property (GObject * object, guint prop_id,
     case PROP_LATENCY:
       g_value_set_int (value, demux->latency);
       break;
+    case PROP_OUTPUT_THREADS:
+      GST_OBJECT_LOCK (demux);
+      g_value_set_boolean (value, demux->output_threads);
+      GST_OBJECT_UNLOCK (demux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -592,6 +656,197 @@ gst_ts_demux_get_duration (GstTSDemux * demux, GstClockTime * dur)
   return res;
 }
 
+/* Per-stream output threads
+ *
+ * When the output-threads property is enabled, buffers and serialized events
+ * for a stream are not pushed from the sinkpad streaming thread but queued
+ * up and pushed from a pad task on the stream's source pad. The queue is
+ * bounded, which throttles the upstream thread if one branch is slower than
+ * the others. Flushing events bypass the queue. */
+
+static void
+gst_ts_demux_stream_output_loop (TSDemuxStream * stream)
+{
+  GstMiniObject *obj;
+  GstFlowReturn res = GST_FLOW_OK;
+
+  g_mutex_lock (&stream->output_lock);
+  while (!stream->output_flushing && g_queue_is_empty (&stream->output_queue))
+    g_cond_wait (&stream->output_cond, &stream->output_lock);
+
+  if (stream->output_flushing) {
+    g_mutex_unlock (&stream->output_lock);
+    gst_pad_pause_task (stream->pad);
+    return;
+  }
+
+  obj = g_queue_pop_head (&stream->output_queue);
+  stream->output_pushing = TRUE;
+  g_cond_broadcast (&stream->output_cond);
+  g_mutex_unlock (&stream->output_lock);
+
+  if (GST_IS_BUFFER (obj)) {
+    res = gst_pad_push (stream->pad, GST_BUFFER_CAST (obj));
+  } else if (GST_IS_BUFFER_LIST (obj)) {
+    res = gst_pad_push_list (stream->pad, GST_BUFFER_LIST_CAST (obj));
+  } else {
+    gst_pad_push_event (stream->pad, GST_EVENT_CAST (obj));
+  }
+
+  g_mutex_lock (&stream->output_lock);
+  stream->output_pushing = FALSE;
+  /* Don't override the flow return with the one for events */
+  if (!GST_IS_EVENT (obj) && !stream->output_flushing)
+    stream->output_flow = res;
+  g_cond_broadcast (&stream->output_cond);
+  g_mutex_unlock (&stream->output_lock);
+
+  if (res != GST_FLOW_OK)
+    GST_DEBUG_OBJECT (stream->pad, "Returned %s", gst_flow_get_name (res));
+}
+
+/* Takes ownership of @obj. Returns the last flow return of the output
+ * thread */
+static GstFlowReturn
+gst_ts_demux_stream_queue_output (TSDemuxStream * stream, GstMiniObject * obj)
+{
+  GstFlowReturn res;
+  gboolean start = FALSE;
+
+  g_mutex_lock (&stream->output_lock);
+  while (!stream->output_flushing &&
+      g_queue_get_length (&stream->output_queue) >= MAX_OUTPUT_QUEUE_SIZE)
+    g_cond_wait (&stream->output_cond, &stream->output_lock);
+
+  if (stream->output_flushing) {
+    g_mutex_unlock (&stream->output_lock);
+    GST_DEBUG_OBJECT (stream->pad, "Flushing, dropping %" GST_PTR_FORMAT, obj);
+    gst_mini_object_unref (obj);
+    return GST_FLOW_FLUSHING;
+  }
+
+  g_queue_push_tail (&stream->output_queue, obj);
+  g_cond_broadcast (&stream->output_cond);
+  if (!stream->output_running) {
+    stream->output_running = TRUE;
+    start = TRUE;
+  }
+  res = stream->output_flow;
+  g_mutex_unlock (&stream->output_lock);
+
+  if (start) {
+    GST_DEBUG_OBJECT (stream->pad, "Starting output task");
+    gst_pad_start_task (stream->pad,
+        (GstTaskFunction) gst_ts_demux_stream_output_loop, stream, NULL);
+  }
+
+  return res;
+}
+
+static void
+gst_ts_demux_stream_set_output_flushing (TSDemuxStream * stream,
+    gboolean flushing)
+{
+  g_mutex_lock (&stream->output_lock);
+  stream->output_flushing = flushing;
+  if (flushing) {
+    g_queue_clear_full (&stream->output_queue,
+        (GDestroyNotify) gst_mini_object_unref);
+  } else {
+    stream->output_flow = GST_FLOW_OK;
+  }
+  g_cond_broadcast (&stream->output_cond);
+  g_mutex_unlock (&stream->output_lock);
+}
+
+/* Wait until the output thread pushed out all queued items */
+static void
+gst_ts_demux_stream_drain_output (TSDemuxStream * stream)
+{
+  g_mutex_lock (&stream->output_lock);
+  while (!stream->output_flushing &&
+      (!g_queue_is_empty (&stream->output_queue) || stream->output_pushing))
+    g_cond_wait (&stream->output_cond, &stream->output_lock);
+  g_mutex_unlock (&stream->output_lock);
+}
+
+static gboolean
+gst_ts_demux_srcpad_activate_mode (GstPad * pad, GstObject * parent,
+    GstPadMode mode, gboolean active)
+{
+  TSDemuxStream *stream = gst_pad_get_element_private (pad);
+  gboolean res;
+
+  if (mode != GST_PAD_MODE_PUSH)
+    return FALSE;
+
+  gst_ts_demux_stream_set_output_flushing (stream, !active);
+  if (active)
+    return TRUE;
+
+  /* Wake up and stop the output thread */
+  res = gst_pad_stop_task (pad);
+  g_mutex_lock (&stream->output_lock);
+  stream->output_running = FALSE;
+  g_mutex_unlock (&stream->output_lock);
+
+  return res;
+}
+
+static GstFlowReturn
+gst_ts_demux_stream_push (TSDemuxStream * stream, GstBuffer * buffer)
+{
+  if (!stream->threaded)
+    return gst_pad_push (stream->pad, buffer);
+
+  return gst_ts_demux_stream_queue_output (stream,
+      GST_MINI_OBJECT_CAST (buffer));
+}
+
+static GstFlowReturn
+gst_ts_demux_stream_push_list (TSDemuxStream * stream, GstBufferList * list)
+{
+  if (!stream->threaded)
+    return gst_pad_push_list (stream->pad, list);
+
+  return gst_ts_demux_stream_queue_output (stream, GST_MINI_OBJECT_CAST (list));
+}
+
+static gboolean
+gst_ts_demux_stream_push_event (TSDemuxStream * stream, GstEvent * event)
+{
+  gboolean res;
+
+  if (!stream->threaded)
+    return gst_pad_push_event (stream->pad, event);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_FLUSH_START:
+      gst_ts_demux_stream_set_output_flushing (stream, TRUE);
+      res = gst_pad_push_event (stream->pad, event);
+      /* Wait for the output thread to be stopped */
+      gst_pad_pause_task (stream->pad);
+      g_mutex_lock (&stream->output_lock);
+      stream->output_running = FALSE;
+      g_mutex_unlock (&stream->output_lock);
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      gst_ts_demux_stream_set_output_flushing (stream, FALSE);
+      res = gst_pad_push_event (stream->pad, event);
+      break;
+    default:
+      if (!GST_EVENT_IS_SERIALIZED (event)) {
+        res = gst_pad_push_event (stream->pad, event);
+      } else {
+        res = gst_ts_demux_stream_queue_output (stream,
+            GST_MINI_OBJECT_CAST (event)) != GST_FLOW_FLUSHING;
+      }
+      break;
+  }
+
+  return res;
+}
+
 static gboolean
 gst_ts_demux_srcpad_query (GstPad * pad, GstObject * parent, GstQuery * query)
 {
@@ -909,6 +1164,67 @@ gst_ts_demux_adjust_seek_offset_for_keyframe (TSDemuxStream * stream,
   return TRUE;
 }
 
+/* Returns the entry with the highest pts at or before @pts if it is at most
+ * one GOP before @pts, or NULL. The GOP length is estimated as the smallest
+ * distance between two indexed keyframes, which is never shorter than a GOP */
+static TSDemuxKeyframeEntry *
+gst_ts_demux_find_keyframe_entry (GstTSDemux * demux, GstClockTime pts)
+{
+  TSDemuxKeyframeEntry *entry = NULL;
+  GstClockTime gop = GST_CLOCK_TIME_NONE;
+  guint i;
+
+  for (i = 0; i < demux->keyframe_index->len; i++) {
+    TSDemuxKeyframeEntry *cand =
+        &g_array_index (demux->keyframe_index, TSDemuxKeyframeEntry, i);
+
+    if (i > 0) {
+      TSDemuxKeyframeEntry *prev =
+          &g_array_index (demux->keyframe_index, TSDemuxKeyframeEntry, i - 1);
+
+      if (!GST_CLOCK_TIME_IS_VALID (gop) || cand->pts - prev->pts < gop)
+        gop = cand->pts - prev->pts;
+    }
+
+    if (cand->pts <= pts)
+      entry = cand;
+  }
+
+  /* a later keyframe closer to @pts is likely, don't decode a whole GOP */
+  if (entry && GST_CLOCK_TIME_IS_VALID (gop) && pts - entry->pts > gop)
+    entry = NULL;
+
+  return entry;
+}
+
+static void
+gst_ts_demux_add_keyframe_entry (GstTSDemux * demux, GstClockTime pts,
+    guint64 offset)
+{
+  TSDemuxKeyframeEntry new_entry;
+  guint i;
+
+  for (i = 0; i < demux->keyframe_index->len; i++) {
+    TSDemuxKeyframeEntry *cand =
+        &g_array_index (demux->keyframe_index, TSDemuxKeyframeEntry, i);
+
+    if (cand->pts == pts) {
+      cand->offset = MIN (cand->offset, offset);
+      return;
+    }
+
+    if (cand->pts > pts)
+      break;
+  }
+
+  GST_DEBUG_OBJECT (demux, "Indexing keyframe %" GST_TIME_FORMAT
+      " found from offset %" G_GUINT64_FORMAT, GST_TIME_ARGS (pts), offset);
+
+  new_entry.pts = pts;
+  new_entry.offset = offset;
+  g_array_insert_val (demux->keyframe_index, i, new_entry);
+}
+
 static GstFlowReturn
 gst_ts_demux_do_seek (MpegTSBase * base, GstEvent * event)
 {
@@ -984,6 +1300,21 @@ gst_ts_demux_do_seek (MpegTSBase * base, GstEvent * event)
       goto done;
     }
 
+    /* For accurate seeks, start from where a keyframe before the target was
+     * already found instead of rewinding step by step until one shows up */
+    if (flags & GST_SEEK_FLAG_ACCURATE) {
+      TSDemuxKeyframeEntry *entry =
+          gst_ts_demux_find_keyframe_entry (demux, seeksegment.start);
+
+      /* only ever move the start closer to the target */
+      if (entry && entry->offset > start_offset) {
+        GST_DEBUG_OBJECT (demux, "Using indexed keyframe %" GST_TIME_FORMAT
+            " at offset %" G_GUINT64_FORMAT, GST_TIME_ARGS (entry->pts),
+            entry->offset);
+        start_offset = entry->offset;
+      }
+    }
+
     base->seek_offset = start_offset;
     demux->last_seek_offset = base->seek_offset;
     /* Reset segment if we're not doing an accurate seek */
@@ -1117,7 +1448,7 @@ push_event (MpegTSBase * base, GstEvent * event)
         gst_ts_demux_push_pending_data (demux, stream, NULL);
 
       gst_event_ref (event);
-      gst_pad_push_event (stream->pad, event);
+      gst_ts_demux_stream_push_event (stream, event);
     }
   }
 
@@ -1968,6 +2299,21 @@ done:
         "stream:%p creating pad with name %s and caps %" GST_PTR_FORMAT,
         stream, name, caps);
     pad = gst_pad_new_from_template (template, name);
+
+    GST_OBJECT_LOCK (demux);
+    stream->threaded = demux->output_threads;
+    GST_OBJECT_UNLOCK (demux);
+    g_mutex_init (&stream->output_lock);
+    g_cond_init (&stream->output_cond);
+    g_queue_init (&stream->output_queue);
+    stream->output_flushing = TRUE;
+    stream->output_running = FALSE;
+    stream->output_pushing = FALSE;
+    stream->output_flow = GST_FLOW_OK;
+    gst_pad_set_element_private (pad, stream);
+    gst_pad_set_activatemode_function (pad,
+        gst_ts_demux_srcpad_activate_mode);
+
     gst_pad_set_active (pad, TRUE);
     gst_pad_use_fixed_caps (pad);
     stream_id = gst_stream_get_stream_id (bstream->stream_object);
@@ -2092,7 +2438,9 @@ gst_ts_demux_stream_removed (MpegTSBase * base, MpegTSBaseStream * bstream)
         gst_ts_demux_push_pending_data ((GstTSDemux *) base, stream, NULL);
 
         GST_DEBUG_OBJECT (stream->pad, "Pushing out EOS");
-        gst_pad_push_event (stream->pad, gst_event_new_eos ());
+        gst_ts_demux_stream_push_event (stream, gst_event_new_eos ());
+        if (stream->threaded)
+          gst_ts_demux_stream_drain_output (stream);
         gst_pad_set_active (stream->pad, FALSE);
       }
 
@@ -2100,9 +2448,16 @@ gst_ts_demux_stream_removed (MpegTSBase * base, MpegTSBaseStream * bstream)
       gst_element_remove_pad (GST_ELEMENT_CAST (base), stream->pad);
       stream->active = FALSE;
     } else {
+      /* Make sure the output thread is stopped */
+      if (stream->threaded)
+        gst_pad_set_active (stream->pad, FALSE);
       gst_object_unref (stream->pad);
     }
     stream->pad = NULL;
+    g_queue_clear_full (&stream->output_queue,
+        (GDestroyNotify) gst_mini_object_unref);
+    g_cond_clear (&stream->output_cond);
+    g_mutex_clear (&stream->output_lock);
   }
 
   gst_ts_demux_stream_flush (stream, GST_TS_DEMUX_CAST (base), TRUE);
@@ -2228,7 +2583,7 @@ gst_ts_demux_update_program (MpegTSBase * base, MpegTSBaseProgram * program)
          * or serialized event (which means very late in case of subtitle streams),
          * and playsink waits for stream-start or another serialized event */
         GST_DEBUG_OBJECT (stream->pad, "sparse stream, pushing GAP event");
-        gst_pad_push_event (stream->pad, gst_event_new_gap (0, 0));
+        gst_ts_demux_stream_push_event (stream, gst_event_new_gap (0, 0));
       }
     }
   }
@@ -2252,6 +2607,9 @@ gst_ts_demux_program_started (MpegTSBase * base, MpegTSBaseProgram * program)
     demux->program_number = program->program_number;
     demux->program = program;
 
+    /* Keyframe positions are only valid for the timeline they were found in */
+    g_array_set_size (demux->keyframe_index, 0);
+
     /* Increment the program_generation counter */
     demux->program_generation = (demux->program_generation + 1) & 0xf;
 
@@ -2315,7 +2673,7 @@ gst_ts_demux_program_started (MpegTSBase * base, MpegTSBaseProgram * program)
          * or serialized event (which means very late in case of subtitle streams),
          * and playsink waits for stream-start or another serialized event */
         GST_DEBUG_OBJECT (stream->pad, "sparse stream, pushing GAP event");
-        gst_pad_push_event (stream->pad, gst_event_new_gap (0, 0));
+        gst_ts_demux_stream_push_event (stream, gst_event_new_gap (0, 0));
       }
     }
 
@@ -2892,13 +3250,13 @@ push_new_segment:
       GST_DEBUG_OBJECT (stream->pad, "Pushing newsegment event");
 
       g_mutex_unlock (&demux->lock);
-      gst_pad_push_event (stream->pad, evt);
+      gst_ts_demux_stream_push_event (stream, evt);
     } else {
       g_mutex_unlock (&demux->lock);
     }
 
     if (demux->global_tags) {
-      gst_pad_push_event (stream->pad,
+      gst_ts_demux_stream_push_event (stream,
           gst_event_new_tag (gst_tag_list_ref (demux->global_tags)));
     }
 
@@ -2906,7 +3264,8 @@ push_new_segment:
     if (stream->taglist) {
       GST_DEBUG_OBJECT (stream->pad, "Sending tags %" GST_PTR_FORMAT,
           stream->taglist);
-      gst_pad_push_event (stream->pad, gst_event_new_tag (stream->taglist));
+      gst_ts_demux_stream_push_event (stream,
+          gst_event_new_tag (stream->taglist));
       stream->taglist = NULL;
     }
 
@@ -2971,7 +3330,7 @@ gst_ts_demux_check_and_sync_streams (GstTSDemux * demux, GstClockTime time)
         calculate_and_push_newsegment (demux, ps, NULL);
 
       /* Now send gap event */
-      gst_pad_push_event (ps->pad, gst_event_new_gap (time, 0));
+      gst_ts_demux_stream_push_event (ps, gst_event_new_gap (time, 0));
     }
 
     /* Update GAP tracking vars so we don't re-check this stream for a while */
@@ -3300,7 +3659,7 @@ out:
 
     gst_caps_set_simple (caps, "mpegversion", G_TYPE_INT, mpegversion, NULL);
     gst_stream_set_caps (bstream->stream_object, caps);
-    gst_pad_set_caps (stream->pad, caps);
+    gst_ts_demux_stream_push_event (stream, gst_event_new_caps (caps));
     gst_caps_unref (caps);
   }
 
@@ -3346,9 +3705,11 @@ gst_ts_demux_push_pending_data (GstTSDemux * demux, TSDemuxStream * stream,
 
   if (stream->needs_keyframe) {
     MpegTSBase *base = (MpegTSBase *) demux;
+    gboolean is_keyframe =
+        gst_ts_demux_adjust_seek_offset_for_keyframe (stream, stream->data,
+        stream->current_size);
 
-    if ((gst_ts_demux_adjust_seek_offset_for_keyframe (stream, stream->data,
-                stream->current_size)) || demux->last_seek_offset == 0) {
+    if (is_keyframe || demux->last_seek_offset == 0) {
       GST_DEBUG_OBJECT (stream->pad,
           "Got Keyframe, ready to go at %" GST_TIME_FORMAT,
           GST_TIME_ARGS (stream->pts));
@@ -3376,6 +3737,15 @@ gst_ts_demux_push_pending_data (GstTSDemux * demux, TSDemuxStream * stream,
         buffer = gst_buffer_new_wrapped (stream->data, stream->current_size);
       }
 
+      /* Only keyframes found by scanning are meaningful, not the fallback at
+       * the start of the file */
+      if (is_keyframe && stream->scan_function
+          && GST_CLOCK_TIME_IS_VALID (stream->pts)
+          && demux->last_seek_offset != -1) {
+        gst_ts_demux_add_keyframe_entry (demux, stream->pts,
+            demux->last_seek_offset);
+      }
+
       stream->seeked_pts = stream->pts;
       stream->seeked_dts = stream->dts;
       stream->needs_keyframe = FALSE;
@@ -3482,7 +3852,7 @@ gst_ts_demux_push_pending_data (GstTSDemux * demux, TSDemuxStream * stream,
         GST_BUFFER_FLAG_SET (pend->buffer, GST_BUFFER_FLAG_DISCONT);
       stream->discont = FALSE;
 
-      res = gst_pad_push (stream->pad, pend->buffer);
+      res = gst_ts_demux_stream_push (stream, pend->buffer);
       stream->nb_out_buffers += 1;
       g_slice_free (PendingBuffer, pend);
     }
@@ -3541,12 +3911,12 @@ gst_ts_demux_push_pending_data (GstTSDemux * demux, TSDemuxStream * stream,
   }
 
   if (buffer) {
-    res = gst_pad_push (stream->pad, buffer);
+    res = gst_ts_demux_stream_push (stream, buffer);
     /* Record that a buffer was pushed */
     stream->nb_out_buffers += 1;
   } else {
     guint n = gst_buffer_list_length (buffer_list);
-    res = gst_pad_push_list (stream->pad, buffer_list);
+    res = gst_ts_demux_stream_push_list (stream, buffer_list);
     /* Record that a buffer was pushed */
     stream->nb_out_buffers += n;
   }
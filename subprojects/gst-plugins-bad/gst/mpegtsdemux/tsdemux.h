@@ -78,6 +78,7 @@ struct _GstTSDemux
   gboolean emit_statistics;
   gboolean send_scte35_events;
   gint latency; /* latency in ms */
+  gboolean output_threads; /* push each stream from its own pad task */
 
   /*< private >*/
   gint program_generation; /* Incremented each time we switch program 0..15 */
@@ -103,6 +104,10 @@ struct _GstTSDemux
   /* Used when seeking for a keyframe to go backward in the stream */
   guint64 last_seek_offset;
 
+  /* Keyframes found by previous accurate seeks, sorted by pts.
+   * Array of TSDemuxKeyframeEntry */
+  GArray *keyframe_index;
+
   /* The current difference between PES PTSs and our output running times,
    * in the MPEG time domain. This is used for potentially updating
    * SCTE 35 sections' pts_adjustment further down the line (eg mpegtsmux) */
@@ -94,6 +94,15 @@ G_DEFINE_TYPE (GstBaseTsMuxPad, gst_base_ts_mux_pad, GST_TYPE_AGGREGATOR_PAD);
 
 /* Internals */
 
+static void
+gst_base_ts_mux_clear_packet_pool (GstBaseTsMux * mux)
+{
+  if (mux->packet_pool) {
+    gst_buffer_pool_set_active (mux->packet_pool, FALSE);
+    gst_clear_object (&mux->packet_pool);
+  }
+}
+
 static void
 gst_base_ts_mux_pad_reset (GstBaseTsMuxPad * pad)
 {
@@ -2406,6 +2415,7 @@ gst_base_ts_mux_dispose (GObject * object)
     g_object_unref (mux->out_adapter);
     mux->out_adapter = NULL;
   }
+  gst_base_ts_mux_clear_packet_pool (mux);
   if (mux->prog_map) {
     gst_structure_free (mux->prog_map);
     mux->prog_map = NULL;
@@ -2572,9 +2582,34 @@ static void
 gst_base_ts_mux_default_allocate_packet (GstBaseTsMux * mux,
     GstBuffer ** buffer)
 {
-  GstBuffer *buf;
+  GstBuffer *buf = NULL;
+
+  /* Packets are recycled through a pool rather than allocating two objects
+   * for every 188 bytes of output */
+  if (mux->packet_pool && mux->packet_pool_size != mux->packet_size)
+    gst_base_ts_mux_clear_packet_pool (mux);
+
+  if (!mux->packet_pool) {
+    GstStructure *config;
+
+    mux->packet_pool = gst_buffer_pool_new ();
+    mux->packet_pool_size = mux->packet_size;
+
+    config = gst_buffer_pool_get_config (mux->packet_pool);
+    gst_buffer_pool_config_set_params (config, NULL, mux->packet_size, 0, 0);
+
+    if (!gst_buffer_pool_set_config (mux->packet_pool, config) ||
+        !gst_buffer_pool_set_active (mux->packet_pool, TRUE)) {
+      GST_WARNING_OBJECT (mux, "Failed to set up packet pool");
+      gst_clear_object (&mux->packet_pool);
+    }
+  }
+
+  if (mux->packet_pool)
+    gst_buffer_pool_acquire_buffer (mux->packet_pool, &buf, NULL);
 
-  buf = gst_buffer_new_and_alloc (mux->packet_size);
+  if (!buf)
+    buf = gst_buffer_new_and_alloc (mux->packet_size);
 
   *buffer = buf;
 }
@@ -179,6 +179,10 @@ struct GstBaseTsMux {
   gsize packet_size;
   gsize automatic_alignment;
 
+  /* recycles the buffers of the default allocate_packet implementation */
+  GstBufferPool *packet_pool;
+  gsize packet_pool_size;
+
   /* output buffer aggregation */
   GstAdapter *out_adapter;
   GstBuffer *out_buffer;
@@ -109,10 +109,18 @@ static gboolean tsmux_write_ts_header (TsMux * mux, guint8 * buf,
     TsMuxPacketInfo * pi, guint * payload_len_out, guint * payload_offset_out,
     guint stream_avail);
 
+static void
+tsmux_section_clear_packets (TsMuxSection * section)
+{
+  g_clear_pointer (&section->packets, g_free);
+  section->n_packets = 0;
+}
+
 static void
 tsmux_section_free (TsMuxSection * section)
 {
   gst_mpegts_section_unref (section->section);
+  tsmux_section_clear_packets (section);
   g_slice_free (TsMuxSection, section);
 }
 
@@ -378,6 +386,7 @@ tsmux_free (TsMux * mux)
   /* Free PAT section */
   if (mux->pat.section)
     gst_mpegts_section_unref (mux->pat.section);
+  tsmux_section_clear_packets (&mux->pat);
 
   /* Free all programs */
   for (cur = mux->programs; cur; cur = cur->next) {
@@ -1268,6 +1277,106 @@ fail:
   return FALSE;
 }
 
+/* Serializes all TS packets of @section once, so that periodically repeated
+ * sections only need to be copied instead of packetized again. The
+ * continuity counters are filled in when the packets are output. */
+static gboolean
+tsmux_section_build_packets (TsMux * mux, TsMuxSection * section)
+{
+  TsMuxPacketInfo pi = section->pi;
+  guint8 saved_count = mux->pid_packet_counts[pi.pid];
+  gsize data_size = 0, payload_written = 0;
+  guint8 *data;
+  guint i;
+
+  tsmux_section_clear_packets (section);
+
+  data = gst_mpegts_section_packetize (section->section, &data_size);
+  if (!data) {
+    TS_DEBUG ("Could not packetize section");
+    return FALSE;
+  }
+
+  /* The first packet also carries the pointer byte */
+  pi.packet_start_unit_indicator = TRUE;
+  pi.stream_avail = data_size + 1;
+
+  section->n_packets =
+      (pi.stream_avail + TSMUX_PAYLOAD_LENGTH - 1) / TSMUX_PAYLOAD_LENGTH;
+  section->packets = g_malloc (section->n_packets * TSMUX_PACKET_LENGTH);
+
+  for (i = 0; i < section->n_packets; i++) {
+    guint8 *packet = section->packets + i * TSMUX_PACKET_LENGTH;
+    guint len, offset, payload_len;
+
+    if (!tsmux_write_ts_header (mux, packet, &pi, &len, &offset,
+            pi.stream_avail))
+      goto fail;
+
+    payload_len = len;
+    if (pi.packet_start_unit_indicator) {
+      packet[offset++] = 0x00;
+      payload_len--;
+    }
+
+    memcpy (packet + offset, data + payload_written, payload_len);
+
+    pi.stream_avail -= len;
+    payload_written += payload_len;
+    pi.packet_start_unit_indicator = FALSE;
+  }
+
+  mux->pid_packet_counts[pi.pid] = saved_count;
+
+  TS_DEBUG ("Cached %u packets for section on PID 0x%04x", section->n_packets,
+      pi.pid);
+
+  return TRUE;
+
+fail:
+  mux->pid_packet_counts[pi.pid] = saved_count;
+  tsmux_section_clear_packets (section);
+  return FALSE;
+}
+
+/* The unused_arg is needed for g_hash_table_foreach() */
+static gboolean
+tsmux_section_write_cached_packets (gpointer unused_arg,
+    TsMuxSection * section, TsMux * mux)
+{
+  guint16 pid = section->pi.pid;
+  guint i;
+
+  g_return_val_if_fail (section != NULL, FALSE);
+  g_return_val_if_fail (mux != NULL, FALSE);
+
+  if (!section->packets && !tsmux_section_build_packets (mux, section))
+    return FALSE;
+
+  for (i = 0; i < section->n_packets; i++) {
+    GstBuffer *buf = NULL;
+    GstMapInfo map;
+
+    if (!tsmux_get_buffer (mux, &buf))
+      return FALSE;
+
+    gst_buffer_map (buf, &map, GST_MAP_WRITE);
+    memcpy (map.data, section->packets + i * TSMUX_PACKET_LENGTH,
+        TSMUX_PACKET_LENGTH);
+
+    /* Every section packet carries payload */
+    mux->pid_packet_counts[pid]++;
+    map.data[3] = (map.data[3] & 0xf0) | (mux->pid_packet_counts[pid] & 0x0f);
+    gst_buffer_unmap (buf, &map);
+
+    /* Push the packet without PCR */
+    if (G_UNLIKELY (!tsmux_packet_out (mux, buf, -1)))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
 /**
  * tsmux_send_section:
  * @mux: a #TsMux
@@ -1304,7 +1413,7 @@ static gboolean
 tsmux_write_si (TsMux * mux)
 {
   g_hash_table_foreach (mux->si_sections,
-      (GHFunc) tsmux_section_write_packet, mux);
+      (GHFunc) tsmux_section_write_cached_packets, mux);
 
   mux->si_changed = FALSE;
 
@@ -1627,7 +1736,7 @@ tsmux_write_stream_packet (TsMux * mux, TsMuxStream * stream)
   if (!tsmux_get_buffer (mux, &buf))
     return FALSE;
 
-  gst_buffer_map (buf, &map, GST_MAP_READ);
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
 
   if (!tsmux_write_ts_header (mux, map.data, pi, &payload_len, &payload_offs,
           pi->stream_avail))
@@ -1673,6 +1782,7 @@ tsmux_program_free (TsMuxProgram * program)
   /* Free PMT section */
   if (program->pmt.section)
     gst_mpegts_section_unref (program->pmt.section);
+  tsmux_section_clear_packets (&program->pmt);
   if (program->scte35_null_section)
     tsmux_section_free (program->scte35_null_section);
 
@@ -1741,9 +1851,10 @@ tsmux_write_pat (TsMux * mux)
 
     TS_DEBUG ("PAT has %d programs", mux->nb_programs);
     mux->pat_changed = FALSE;
+    tsmux_section_clear_packets (&mux->pat);
   }
 
-  return tsmux_section_write_packet (NULL, &mux->pat, mux);
+  return tsmux_section_write_cached_packets (NULL, &mux->pat, mux);
 }
 
 static gboolean
@@ -1841,9 +1952,10 @@ tsmux_write_pmt (TsMux * mux, TsMuxProgram * program)
 
     program->pmt.section = gst_mpegts_section_from_pmt (pmt, program->pmt_pid);
     program->pmt.section->version_number = program->pmt_version++;
+    tsmux_section_clear_packets (&program->pmt);
   }
 
-  return tsmux_section_write_packet (NULL, &program->pmt, mux);
+  return tsmux_section_write_cached_packets (NULL, &program->pmt, mux);
 }
 
 static gboolean
@@ -1851,7 +1963,8 @@ tsmux_write_scte_null (TsMux * mux, TsMuxProgram * program)
 {
   /* SCTE-35 NULL section is created when PID is set */
   GST_LOG ("Writing SCTE NULL packet");
-  return tsmux_section_write_packet (NULL, program->scte35_null_section, mux);
+  return tsmux_section_write_cached_packets (NULL,
+      program->scte35_null_section, mux);
 }
 
 void
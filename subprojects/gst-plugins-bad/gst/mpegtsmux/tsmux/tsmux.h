@@ -91,6 +91,11 @@ typedef TsMuxStream * (*TsMuxNewStreamFunc) (guint16 new_pid, guint stream_type,
 struct TsMuxSection {
   TsMuxPacketInfo pi;
   GstMpegtsSection *section;
+
+  /* Serialized TS packets of the section with a zero continuity counter,
+   * built on first output and dropped when the section changes */
+  guint8 *packets;
+  guint n_packets;
 };
 
 /* Information for the streams associated with one program */
@@ -3155,10 +3155,8 @@ out:
 }
 
 /*
- * Called when analyzing the (RIP) Random Index Pack.
- *
- * FIXME : If a file doesn't have a RIP, we should iterate the partition headers
- * to collect as much information as possible.
+ * Called when analyzing the (RIP) Random Index Pack, or when walking the
+ * partitions backwards from the footer if a file doesn't have a RIP.
  *
  * This function collects as much information as possible from the partition headers:
  * * Store partition information in the list of partitions
@@ -3593,6 +3591,86 @@ gst_mxf_demux_pull_random_index_pack (GstMXFDemux * demux)
   }
 }
 
+/* Fallback for files without a RIP: follow the PreviousPartition links from
+ * the footer partition to collect all partitions and index table segments
+ * up-front, so that seeking doesn't need to scan the essence */
+static void
+gst_mxf_demux_pull_partitions_from_footer (GstMXFDemux * demux)
+{
+  guint64 old_offset = demux->offset;
+  GstMXFDemuxPartition *old_partition = demux->current_partition;
+  MXFPartitionPack header;
+  GstMXFKLV klv;
+  GstMapInfo map;
+  guint64 offset;
+  guint n_partitions = 0;
+  gboolean ret;
+
+  if (gst_mxf_demux_peek_klv_packet (demux, demux->run_in,
+          &klv) != GST_FLOW_OK || !mxf_is_header_partition_pack (&klv.key))
+    return;
+
+  if (gst_mxf_demux_fill_klv (demux, &klv) != GST_FLOW_OK)
+    return;
+
+  gst_buffer_map (klv.data, &map, GST_MAP_READ);
+  ret = mxf_partition_pack_parse (&klv.key, &header, map.data, map.size);
+  gst_buffer_unmap (klv.data, &map);
+  gst_buffer_unref (klv.data);
+
+  if (!ret) {
+    GST_DEBUG_OBJECT (demux, "Failed parsing header partition pack");
+    return;
+  }
+
+  offset = header.footer_partition;
+  mxf_partition_pack_reset (&header);
+
+  if (offset == 0) {
+    GST_DEBUG_OBJECT (demux, "Header partition doesn't point to the footer");
+    return;
+  }
+
+  GST_DEBUG_OBJECT (demux, "No random index pack, walking partitions "
+      "backwards from footer partition at %" G_GUINT64_FORMAT, offset);
+
+  /* Partitions are inserted in front of the already known ones, so the
+   * PreviousPartition value parsed from each of them is kept as is */
+  while (offset != 0) {
+    guint64 prev_offset;
+
+    demux->offset = demux->run_in + offset;
+    demux->current_partition = NULL;
+    read_partition_header (demux);
+
+    if (!demux->current_partition) {
+      GST_WARNING_OBJECT (demux, "No partition pack at offset %"
+          G_GUINT64_FORMAT, offset);
+      break;
+    }
+
+    n_partitions++;
+    prev_offset = demux->current_partition->partition.prev_partition;
+    if (prev_offset >= offset) {
+      GST_WARNING_OBJECT (demux, "Invalid previous partition offset %"
+          G_GUINT64_FORMAT " in partition at %" G_GUINT64_FORMAT, prev_offset,
+          offset);
+      break;
+    }
+
+    offset = prev_offset;
+  }
+
+  GST_DEBUG_OBJECT (demux, "Collected %u partitions from the footer",
+      n_partitions);
+
+  demux->offset = old_offset;
+  demux->current_partition = old_partition;
+
+  if (demux->pending_index_table_segments)
+    collect_index_table_segments (demux);
+}
+
 static void
 gst_mxf_demux_parse_footer_metadata (GstMXFDemux * demux)
 {
@@ -4350,6 +4428,10 @@ gst_mxf_demux_loop (GstPad * pad)
 
     /* Grab the RIP at the end of the file (if present) */
     gst_mxf_demux_pull_random_index_pack (demux);
+
+    /* Otherwise collect partitions and indexes by starting from the footer */
+    if (!demux->random_index_pack)
+      gst_mxf_demux_pull_partitions_from_footer (demux);
   }
 
   /* Now actually do something */
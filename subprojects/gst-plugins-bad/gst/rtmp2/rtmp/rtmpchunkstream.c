@@ -666,21 +666,27 @@ gst_rtmp_chunk_stream_serialize_next (GstRtmpChunkStream * cstream,
   return serialize_next (cstream, chunk_size, CHUNK_TYPE_3);
 }
 
-GstBuffer *
+/* Adds one buffer per chunk to @list instead of appending them to a single
+ * buffer, which would merge (copy) the memories past GstBuffer's memory
+ * limit. Each chunk only holds its header and a reference to the payload. */
+gboolean
 gst_rtmp_chunk_stream_serialize_all (GstRtmpChunkStream * cstream,
-    GstBuffer * buffer, guint32 chunk_size)
+    GstBuffer * buffer, guint32 chunk_size, GstBufferList * list)
 {
-  GstBuffer *outbuf, *nextbuf;
+  GstBuffer *chunk;
 
-  outbuf = gst_rtmp_chunk_stream_serialize_start (cstream, buffer, chunk_size);
-  nextbuf = gst_rtmp_chunk_stream_serialize_next (cstream, chunk_size);
+  g_return_val_if_fail (GST_IS_BUFFER_LIST (list), FALSE);
 
-  while (nextbuf) {
-    outbuf = gst_buffer_append (outbuf, nextbuf);
-    nextbuf = gst_rtmp_chunk_stream_serialize_next (cstream, chunk_size);
+  chunk = gst_rtmp_chunk_stream_serialize_start (cstream, buffer, chunk_size);
+  if (!chunk)
+    return FALSE;
+
+  while (chunk) {
+    gst_buffer_list_add (list, chunk);
+    chunk = gst_rtmp_chunk_stream_serialize_next (cstream, chunk_size);
   }
 
-  return outbuf;
+  return TRUE;
 }
 
 GstRtmpChunkStreams *
@@ -92,6 +92,8 @@ struct _GstRtmpConnection
   guint64 out_bytes_total;
   guint64 in_bytes_acked;
   guint64 out_bytes_acked;
+  guint64 out_messages_total;
+  guint64 out_writes_total;
 };
 
 
@@ -513,34 +515,29 @@ gst_rtmp_connection_input_ready (GInputStream * is, gpointer user_data)
   return G_SOURCE_CONTINUE;
 }
 
-static void
-gst_rtmp_connection_start_write (GstRtmpConnection * self)
+/* Upper bound of messages serialized into a single socket write */
+#define MAX_MESSAGES_PER_WRITE 64
+
+/* Serializes @message into @chunks, returns FALSE if the message has to be
+ * dropped */
+static gboolean
+gst_rtmp_connection_serialize_message (GstRtmpConnection * self,
+    GstBuffer * message, GstBufferList * chunks)
 {
-  GOutputStream *os;
-  GstBuffer *message, *chunks;
   GstRtmpMeta *meta;
   GstRtmpChunkStream *cstream;
 
-  if (self->writing) {
-    return;
-  }
-
-  message = g_async_queue_try_pop (self->output_queue);
-  if (!message) {
-    return;
-  }
-
   meta = gst_buffer_get_rtmp_meta (message);
   if (!meta) {
     GST_ERROR_OBJECT (self, "No RTMP meta on %" GST_PTR_FORMAT, message);
-    goto out;
+    return FALSE;
   }
 
   if (gst_rtmp_message_is_protocol_control (message)) {
     if (!gst_rtmp_connection_prepare_protocol_control (self, message)) {
       GST_ERROR_OBJECT (self,
           "Failed to prepare protocol control %" GST_PTR_FORMAT, message);
-      goto out;
+      return FALSE;
     }
   }
 
@@ -548,30 +545,73 @@ gst_rtmp_connection_start_write (GstRtmpConnection * self)
   if (!cstream) {
     GST_ERROR_OBJECT (self, "Failed to get chunk stream for %" GST_PTR_FORMAT,
         message);
-    goto out;
+    return FALSE;
   }
 
-  chunks = gst_rtmp_chunk_stream_serialize_all (cstream, message,
-      self->out_chunk_size);
-  if (!chunks) {
+  if (!gst_rtmp_chunk_stream_serialize_all (cstream, message,
+          self->out_chunk_size, chunks)) {
     GST_ERROR_OBJECT (self, "Failed to serialize %" GST_PTR_FORMAT, message);
-    goto out;
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static void
+gst_rtmp_connection_start_write (GstRtmpConnection * self)
+{
+  GOutputStream *os;
+  GstBuffer *message;
+  GstBufferList *chunks;
+  guint n_messages = 0;
+
+  if (self->writing) {
+    return;
   }
 
+  chunks = gst_buffer_list_new ();
+
+  /* Batch everything queued so far into one vectored write. A protocol
+   * control message ends the batch since it's only applied once written,
+   * and it can change how the following messages need to be chunked. */
+  while (n_messages < MAX_MESSAGES_PER_WRITE &&
+      (message = g_async_queue_try_pop (self->output_queue))) {
+    gboolean is_protocol_control =
+        gst_rtmp_message_is_protocol_control (message);
+
+    if (gst_rtmp_connection_serialize_message (self, message, chunks))
+      n_messages++;
+
+    gst_buffer_unref (message);
+
+    if (is_protocol_control)
+      break;
+  }
+
+  if (n_messages == 0) {
+    gst_buffer_list_unref (chunks);
+    return;
+  }
+
+  GST_LOG_OBJECT (self, "writing %u messages in %u chunks", n_messages,
+      gst_buffer_list_length (chunks));
+
+  g_mutex_lock (&self->stats_lock);
+  self->out_messages_total += n_messages;
+  self->out_writes_total++;
+  g_mutex_unlock (&self->stats_lock);
+
   self->writing = TRUE;
   if (self->output_handler) {
     self->output_handler (self, self->output_handler_user_data);
   }
 
   os = g_io_stream_get_output_stream (G_IO_STREAM (self->connection));
-  gst_rtmp_output_stream_write_all_buffer_async (os, chunks, G_PRIORITY_DEFAULT,
-      self->cancellable, gst_rtmp_connection_write_buffer_done,
-      g_object_ref (self));
-
-  gst_buffer_unref (chunks);
+  gst_rtmp_output_stream_write_all_buffer_list_async (os, chunks,
+      G_PRIORITY_DEFAULT, self->cancellable,
+      gst_rtmp_connection_write_buffer_done, g_object_ref (self));
 
-out:
-  gst_buffer_unref (message);
+  gst_buffer_list_unref (chunks);
 }
 
 static void
@@ -601,7 +641,7 @@ gst_rtmp_connection_write_buffer_done (GObject * obj,
 
   self->writing = FALSE;
 
-  res = gst_rtmp_output_stream_write_all_buffer_finish (os, result,
+  res = gst_rtmp_output_stream_write_all_buffer_list_finish (os, result,
       &bytes_written, &error);
 
   g_mutex_lock (&self->stats_lock);
@@ -1379,7 +1419,11 @@ get_stats (GstRtmpConnection * self)
       "in-bytes-total", G_TYPE_UINT64, self ? self->in_bytes_total : 0,
       "out-bytes-total", G_TYPE_UINT64, self ? self->out_bytes_total : 0,
       "in-bytes-acked", G_TYPE_UINT64, self ? self->in_bytes_acked : 0,
-      "out-bytes-acked", G_TYPE_UINT64, self ? self->out_bytes_acked : 0, NULL);
+      "out-bytes-acked", G_TYPE_UINT64, self ? self->out_bytes_acked : 0,
+      "out-messages-total", G_TYPE_UINT64, self ? self->out_messages_total : 0,
+      "out-writes-total", G_TYPE_UINT64, self ? self->out_writes_total : 0,
+      "out-queue-length", G_TYPE_UINT,
+      self ? MAX (g_async_queue_length (self->output_queue), 0) : 0, NULL);
 }
 
 GstStructure *
@@ -30,8 +30,8 @@ static void read_all_bytes_done (GObject * source, GAsyncResult * result,
     gpointer user_data);
 static void write_all_bytes_done (GObject * source, GAsyncResult * result,
     gpointer user_data);
-static void write_all_buffer_done (GObject * source, GAsyncResult * result,
-    gpointer user_data);
+static void write_all_buffer_list_done (GObject * source,
+    GAsyncResult * result, gpointer user_data);
 
 void
 gst_rtmp_byte_array_append_bytes (GByteArray * bytearray, GBytes * bytes)
@@ -158,75 +158,148 @@ gst_rtmp_output_stream_write_all_bytes_finish (GOutputStream * stream,
 
 typedef struct
 {
-  GstBuffer *buffer;
-  GstMapInfo map;
-  gboolean mapped;
+  GstBufferList *list;
+  GArray *maps;
+  GArray *vectors;
+  /* only used when vectored writes are unavailable */
+  GBytes *flat;
   gsize bytes_written;
-} WriteAllBufferData;
+} WriteAllBufferListData;
 
-static WriteAllBufferData *
-write_all_buffer_data_new (GstBuffer * buffer)
+static void
+write_all_buffer_list_data_unmap (WriteAllBufferListData * data)
 {
-  WriteAllBufferData *data = g_slice_new0 (WriteAllBufferData);
-  data->buffer = gst_buffer_ref (buffer);
+  guint i;
+
+  for (i = 0; i < data->maps->len; i++) {
+    GstMapInfo *map = &g_array_index (data->maps, GstMapInfo, i);
+    gst_memory_unmap (map->memory, map);
+  }
+
+  g_array_set_size (data->maps, 0);
+}
+
+static WriteAllBufferListData *
+write_all_buffer_list_data_new (GstBufferList * list)
+{
+  WriteAllBufferListData *data = g_slice_new0 (WriteAllBufferListData);
+  data->list = gst_buffer_list_ref (list);
+  data->maps = g_array_new (FALSE, FALSE, sizeof (GstMapInfo));
+  data->vectors = g_array_new (FALSE, FALSE, sizeof (GOutputVector));
   return data;
 }
 
 static void
-write_all_buffer_data_free (gpointer ptr)
+write_all_buffer_list_data_free (gpointer ptr)
+{
+  WriteAllBufferListData *data = ptr;
+  write_all_buffer_list_data_unmap (data);
+  g_array_unref (data->maps);
+  g_array_unref (data->vectors);
+  g_clear_pointer (&data->flat, g_bytes_unref);
+  g_clear_pointer (&data->list, gst_buffer_list_unref);
+  g_slice_free (WriteAllBufferListData, data);
+}
+
+/* Maps every memory of every buffer in the list individually, so that the
+ * chunk headers and the payload they refer to are written without being
+ * merged into a single allocation first */
+static gboolean
+write_all_buffer_list_data_map (WriteAllBufferListData * data)
 {
-  WriteAllBufferData *data = ptr;
-  if (data->mapped) {
-    gst_buffer_unmap (data->buffer, &data->map);
+  guint i, j, n_buffers;
+
+  n_buffers = gst_buffer_list_length (data->list);
+
+  for (i = 0; i < n_buffers; i++) {
+    GstBuffer *buffer = gst_buffer_list_get (data->list, i);
+    guint n_mem = gst_buffer_n_memory (buffer);
+
+    for (j = 0; j < n_mem; j++) {
+      GstMemory *mem = gst_buffer_peek_memory (buffer, j);
+      GstMapInfo map;
+      GOutputVector vector;
+
+      if (!gst_memory_map (mem, &map, GST_MAP_READ))
+        return FALSE;
+
+      g_array_append_val (data->maps, map);
+
+      vector.buffer = map.data;
+      vector.size = map.size;
+      g_array_append_val (data->vectors, vector);
+    }
   }
-  g_clear_pointer (&data->buffer, gst_buffer_unref);
-  g_slice_free (WriteAllBufferData, data);
+
+  return TRUE;
 }
 
 void
-gst_rtmp_output_stream_write_all_buffer_async (GOutputStream * stream,
-    GstBuffer * buffer, int io_priority, GCancellable * cancellable,
+gst_rtmp_output_stream_write_all_buffer_list_async (GOutputStream * stream,
+    GstBufferList * list, int io_priority, GCancellable * cancellable,
     GAsyncReadyCallback callback, gpointer user_data)
 {
   GTask *task;
-  WriteAllBufferData *data;
+  WriteAllBufferListData *data;
 
   g_return_if_fail (G_IS_OUTPUT_STREAM (stream));
-  g_return_if_fail (GST_IS_BUFFER (buffer));
+  g_return_if_fail (GST_IS_BUFFER_LIST (list));
 
   task = g_task_new (stream, cancellable, callback, user_data);
 
-  data = write_all_buffer_data_new (buffer);
-  g_task_set_task_data (task, data, write_all_buffer_data_free);
+  data = write_all_buffer_list_data_new (list);
+  g_task_set_task_data (task, data, write_all_buffer_list_data_free);
 
-  if (!gst_buffer_map (buffer, &data->map, GST_MAP_READ)) {
+  if (!write_all_buffer_list_data_map (data)) {
     g_task_return_new_error (task, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_READ,
         "Failed to map buffer for reading");
     g_object_unref (task);
     return;
   }
 
-  data->mapped = TRUE;
+#if GLIB_CHECK_VERSION(2, 60, 0)
+  g_output_stream_writev_all_async (stream,
+      (GOutputVector *) data->vectors->data, data->vectors->len, io_priority,
+      cancellable, write_all_buffer_list_done, task);
+#else
+  {
+    GByteArray *flat = g_byte_array_new ();
+    guint i;
+
+    for (i = 0; i < data->vectors->len; i++) {
+      GOutputVector *vector = &g_array_index (data->vectors, GOutputVector, i);
+      g_byte_array_append (flat, vector->buffer, vector->size);
+    }
+
+    write_all_buffer_list_data_unmap (data);
+    data->flat = g_byte_array_free_to_bytes (flat);
 
-  g_output_stream_write_all_async (stream, data->map.data, data->map.size,
-      io_priority, cancellable, write_all_buffer_done, task);
+    g_output_stream_write_all_async (stream,
+        g_bytes_get_data (data->flat, NULL), g_bytes_get_size (data->flat),
+        io_priority, cancellable, write_all_buffer_list_done, task);
+  }
+#endif
 }
 
 static void
-write_all_buffer_done (GObject * source, GAsyncResult * result,
+write_all_buffer_list_done (GObject * source, GAsyncResult * result,
     gpointer user_data)
 {
   GOutputStream *os = G_OUTPUT_STREAM (source);
   GTask *task = user_data;
-  WriteAllBufferData *data = g_task_get_task_data (task);
+  WriteAllBufferListData *data = g_task_get_task_data (task);
   GError *error = NULL;
   gboolean res;
 
+#if GLIB_CHECK_VERSION(2, 60, 0)
+  res = g_output_stream_writev_all_finish (os, result, &data->bytes_written,
+      &error);
+#else
   res = g_output_stream_write_all_finish (os, result, &data->bytes_written,
       &error);
+#endif
 
-  gst_buffer_unmap (data->buffer, &data->map);
-  data->mapped = FALSE;
+  write_all_buffer_list_data_unmap (data);
 
   if (!res) {
     g_task_return_error (task, error);
@@ -240,10 +313,10 @@ write_all_buffer_done (GObject * source, GAsyncResult * result,
 
 
 gboolean
-gst_rtmp_output_stream_write_all_buffer_finish (GOutputStream * stream,
+gst_rtmp_output_stream_write_all_buffer_list_finish (GOutputStream * stream,
     GAsyncResult * result, gsize * bytes_written, GError ** error)
 {
-  WriteAllBufferData *data;
+  WriteAllBufferListData *data;
   GTask *task;
 
   g_return_val_if_fail (g_task_is_valid (result, stream), FALSE);
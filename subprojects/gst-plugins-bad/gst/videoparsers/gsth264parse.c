@@ -34,6 +34,10 @@
 
 #include <string.h>
 
+/* NALs of at least this size are shared with the input when converting
+ * between stream formats, smaller ones are copied */
+#define GST_H264_PARSE_MIN_SHARED_NAL_SIZE 512
+
 GST_DEBUG_CATEGORY (h264_parse_debug);
 #define GST_CAT_DEFAULT h264_parse_debug
 
@@ -474,6 +478,17 @@ gst_h264_parse_negotiate (GstH264Parse * h264parse, gint in_format,
     gst_caps_unref (caps);
 }
 
+/* Sets the mapped input @buffer that the NALs being processed point into,
+ * or unsets it if @map is %NULL */
+static inline void
+gst_h264_parse_set_nal_source (GstH264Parse * h264parse, GstBuffer * buffer,
+    const GstMapInfo * map)
+{
+  h264parse->nal_src = map ? buffer : NULL;
+  h264parse->nal_src_data = map ? map->data : NULL;
+  h264parse->nal_src_size = map ? map->size : 0;
+}
+
 static GstBuffer *
 gst_h264_parse_wrap_nal (GstH264Parse * h264parse, guint format, guint8 * data,
     guint size)
@@ -484,7 +499,6 @@ gst_h264_parse_wrap_nal (GstH264Parse * h264parse, guint format, guint8 * data,
 
   GST_DEBUG_OBJECT (h264parse, "nal length %d", size);
 
-  buf = gst_buffer_new_allocate (NULL, 4 + size, NULL);
   if (format == GST_H264_PARSE_FORMAT_AVC
       || format == GST_H264_PARSE_FORMAT_AVC3) {
     tmp = GUINT32_TO_BE (size << (32 - 8 * nl));
@@ -496,6 +510,20 @@ gst_h264_parse_wrap_nal (GstH264Parse * h264parse, guint format, guint8 * data,
     tmp = GUINT32_TO_BE (1);
   }
 
+  /* bigger NALs of the input buffer, i.e. slices, are not copied but put
+   * behind a small prefix memory */
+  if (h264parse->nal_src != NULL &&
+      size >= GST_H264_PARSE_MIN_SHARED_NAL_SIZE &&
+      data >= h264parse->nal_src_data &&
+      data + size <= h264parse->nal_src_data + h264parse->nal_src_size) {
+    buf = gst_buffer_new_allocate (NULL, nl, NULL);
+    gst_buffer_fill (buf, 0, &tmp, nl);
+
+    return gst_buffer_append (buf, gst_buffer_copy_region (h264parse->nal_src,
+            GST_BUFFER_COPY_MEMORY, data - h264parse->nal_src_data, size));
+  }
+
+  buf = gst_buffer_new_allocate (NULL, 4 + size, NULL);
   gst_buffer_fill (buf, 0, &tmp, sizeof (guint32));
   gst_buffer_fill (buf, nl, data, size);
   gst_buffer_set_size (buf, size + nl);
@@ -1224,6 +1252,7 @@ gst_h264_parse_handle_frame_packetized (GstBaseParse * parse,
     buffer = gst_buffer_copy (frame->buffer);
 
   gst_buffer_map (buffer, &map, GST_MAP_READ);
+  gst_h264_parse_set_nal_source (h264parse, buffer, &map);
 
   left = map.size;
 
@@ -1275,6 +1304,7 @@ gst_h264_parse_handle_frame_packetized (GstBaseParse * parse,
   }
 
   gst_buffer_unmap (buffer, &map);
+  gst_h264_parse_set_nal_source (h264parse, NULL, NULL);
 
   if (!h264parse->split_packetized) {
     h264parse->marker = TRUE;
@@ -1333,6 +1363,7 @@ gst_h264_parse_handle_frame (GstBaseParse * parse,
     return gst_h264_parse_handle_frame_packetized (parse, frame);
 
   gst_buffer_map (buffer, &map, GST_MAP_READ);
+  gst_h264_parse_set_nal_source (h264parse, buffer, &map);
   data = map.data;
   size = map.size;
 
@@ -1341,6 +1372,7 @@ gst_h264_parse_handle_frame (GstBaseParse * parse,
    * (e.g. EOS/EOB placed at the end of an AU.) */
   if (G_UNLIKELY (size < 4)) {
     gst_buffer_unmap (buffer, &map);
+    gst_h264_parse_set_nal_source (h264parse, NULL, NULL);
     *skipsize = 1;
     return GST_FLOW_OK;
   }
@@ -1554,6 +1586,7 @@ end:
   framesize = nalu.offset + nalu.size;
 
   gst_buffer_unmap (buffer, &map);
+  gst_h264_parse_set_nal_source (h264parse, NULL, NULL);
 
   gst_h264_parse_parse_frame (parse, frame);
 
@@ -1569,6 +1602,7 @@ more:
   /* Fall-through. */
 out:
   gst_buffer_unmap (buffer, &map);
+  gst_h264_parse_set_nal_source (h264parse, NULL, NULL);
   return GST_FLOW_OK;
 
 skip:
@@ -1584,6 +1618,7 @@ skip:
 
 invalid_stream:
   gst_buffer_unmap (buffer, &map);
+  gst_h264_parse_set_nal_source (h264parse, NULL, NULL);
   return GST_FLOW_ERROR;
 }
 
@@ -2696,7 +2731,7 @@ gst_h264_parse_parse_frame (GstBaseParse * parse, GstBaseParseFrame * frame)
   if (av) {
     GstBuffer *buf;
 
-    buf = gst_adapter_take_buffer (h264parse->frame_out, av);
+    buf = gst_adapter_take_buffer_fast (h264parse->frame_out, av);
     gst_buffer_copy_into (buf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
     gst_buffer_replace (&frame->out_buffer, buf);
     gst_buffer_unref (buf);
@@ -2861,13 +2896,14 @@ gst_h264_parse_handle_sps_pps_nals (GstH264Parse * h264parse,
   } else {
     /* insert config NALs into AU */
     GstByteWriter bw;
-    GstBuffer *new_buf;
+    GstBuffer *new_buf, *config_buf;
     const gboolean bs = h264parse->format == GST_H264_PARSE_FORMAT_BYTE;
     const gint nls = 4 - h264parse->nal_length_size;
     gboolean ok;
 
-    gst_byte_writer_init_with_size (&bw, gst_buffer_get_size (buffer), FALSE);
-    ok = gst_byte_writer_put_buffer (&bw, buffer, 0, h264parse->idr_pos);
+    /* only the config NALs are written, the AU data is shared */
+    gst_byte_writer_init (&bw);
+    ok = TRUE;
     GST_DEBUG_OBJECT (h264parse, "- inserting SPS/PPS");
     for (i = 0; i < GST_H264_MAX_SPS_COUNT; i++) {
       if ((codec_nal = h264parse->sps_nals[i])) {
@@ -2900,9 +2936,16 @@ gst_h264_parse_handle_sps_pps_nals (GstH264Parse * h264parse,
         send_done = TRUE;
       }
     }
-    ok &= gst_byte_writer_put_buffer (&bw, buffer, h264parse->idr_pos, -1);
+    config_buf = gst_byte_writer_reset_and_get_buffer (&bw);
     /* collect result and push */
-    new_buf = gst_byte_writer_reset_and_get_buffer (&bw);
+    if (h264parse->idr_pos > 0)
+      new_buf = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_MEMORY, 0,
+          h264parse->idr_pos);
+    else
+      new_buf = gst_buffer_new ();
+    new_buf = gst_buffer_append (new_buf, config_buf);
+    new_buf = gst_buffer_append (new_buf, gst_buffer_copy_region (buffer,
+            GST_BUFFER_COPY_MEMORY, h264parse->idr_pos, -1));
     gst_buffer_copy_into (new_buf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
     /* should already be keyframe/IDR, but it may not have been,
      * so mark it as such to avoid being discarded by picky decoder */
@@ -136,6 +136,10 @@ struct _GstH264Parse
   gint pic_timing_sei_size;
   gboolean update_caps;
   GstAdapter *frame_out;
+  /* mapped input buffer of the NALs being processed */
+  GstBuffer *nal_src;
+  const guint8 *nal_src_data;
+  gsize nal_src_size;
   gboolean keyframe;
   gboolean predicted;
   gboolean bidirectional;
@@ -29,6 +29,10 @@
 
 #include <string.h>
 
+/* NALs of at least this size are shared with the input when converting
+ * between stream formats, smaller ones are copied */
+#define GST_H265_PARSE_MIN_SHARED_NAL_SIZE 512
+
 GST_DEBUG_CATEGORY (h265_parse_debug);
 #define GST_CAT_DEFAULT h265_parse_debug
 
@@ -421,6 +425,17 @@ gst_h265_parse_negotiate (GstH265Parse * h265parse, gint in_format,
     gst_caps_unref (caps);
 }
 
+/* Sets the mapped input @buffer that the NALs being processed point into,
+ * or unsets it if @map is %NULL */
+static inline void
+gst_h265_parse_set_nal_source (GstH265Parse * h265parse, GstBuffer * buffer,
+    const GstMapInfo * map)
+{
+  h265parse->nal_src = map ? buffer : NULL;
+  h265parse->nal_src_data = map ? map->data : NULL;
+  h265parse->nal_src_size = map ? map->size : 0;
+}
+
 static GstBuffer *
 gst_h265_parse_wrap_nal (GstH265Parse * h265parse, guint format, guint8 * data,
     guint size)
@@ -431,7 +446,6 @@ gst_h265_parse_wrap_nal (GstH265Parse * h265parse, guint format, guint8 * data,
 
   GST_DEBUG_OBJECT (h265parse, "nal length %d", size);
 
-  buf = gst_buffer_new_allocate (NULL, 4 + size, NULL);
   if (format == GST_H265_PARSE_FORMAT_HVC1
       || format == GST_H265_PARSE_FORMAT_HEV1) {
     tmp = GUINT32_TO_BE (size << (32 - 8 * nl));
@@ -443,6 +457,20 @@ gst_h265_parse_wrap_nal (GstH265Parse * h265parse, guint format, guint8 * data,
     tmp = GUINT32_TO_BE (1);
   }
 
+  /* bigger NALs of the input buffer, i.e. slices, are not copied but put
+   * behind a small prefix memory */
+  if (h265parse->nal_src != NULL &&
+      size >= GST_H265_PARSE_MIN_SHARED_NAL_SIZE &&
+      data >= h265parse->nal_src_data &&
+      data + size <= h265parse->nal_src_data + h265parse->nal_src_size) {
+    buf = gst_buffer_new_allocate (NULL, nl, NULL);
+    gst_buffer_fill (buf, 0, &tmp, nl);
+
+    return gst_buffer_append (buf, gst_buffer_copy_region (h265parse->nal_src,
+            GST_BUFFER_COPY_MEMORY, data - h265parse->nal_src_data, size));
+  }
+
+  buf = gst_buffer_new_allocate (NULL, 4 + size, NULL);
   gst_buffer_fill (buf, 0, &tmp, sizeof (guint32));
   gst_buffer_fill (buf, nl, data, size);
   gst_buffer_set_size (buf, size + nl);
@@ -1050,6 +1078,7 @@ gst_h265_parse_handle_frame_packetized (GstBaseParse * parse,
     buffer = gst_buffer_copy (frame->buffer);
 
   gst_buffer_map (buffer, &map, GST_MAP_READ);
+  gst_h265_parse_set_nal_source (h265parse, buffer, &map);
 
   left = map.size;
 
@@ -1096,6 +1125,7 @@ gst_h265_parse_handle_frame_packetized (GstBaseParse * parse,
   }
 
   gst_buffer_unmap (buffer, &map);
+  gst_h265_parse_set_nal_source (h265parse, NULL, NULL);
 
   if (!h265parse->split_packetized) {
     h265parse->marker = TRUE;
@@ -1154,6 +1184,7 @@ gst_h265_parse_handle_frame (GstBaseParse * parse,
     return gst_h265_parse_handle_frame_packetized (parse, frame);
 
   gst_buffer_map (buffer, &map, GST_MAP_READ);
+  gst_h265_parse_set_nal_source (h265parse, buffer, &map);
   data = map.data;
   size = map.size;
 
@@ -1162,6 +1193,7 @@ gst_h265_parse_handle_frame (GstBaseParse * parse,
    * (e.g. EOS/EOB placed at the end of an AU.) */
   if (G_UNLIKELY (size < 5)) {
     gst_buffer_unmap (buffer, &map);
+    gst_h265_parse_set_nal_source (h265parse, NULL, NULL);
     *skipsize = 1;
     return GST_FLOW_OK;
   }
@@ -1365,6 +1397,7 @@ end:
   framesize = nalu.offset + nalu.size;
 
   gst_buffer_unmap (buffer, &map);
+  gst_h265_parse_set_nal_source (h265parse, NULL, NULL);
 
   gst_h265_parse_parse_frame (parse, frame);
 
@@ -1380,6 +1413,7 @@ more:
   /* Fall-through. */
 out:
   gst_buffer_unmap (buffer, &map);
+  gst_h265_parse_set_nal_source (h265parse, NULL, NULL);
   return GST_FLOW_OK;
 
 skip:
@@ -1395,6 +1429,7 @@ skip:
 
 invalid_stream:
   gst_buffer_unmap (buffer, &map);
+  gst_h265_parse_set_nal_source (h265parse, NULL, NULL);
   return GST_FLOW_ERROR;
 }
 
@@ -2554,7 +2589,7 @@ gst_h265_parse_parse_frame (GstBaseParse * parse, GstBaseParseFrame * frame)
   if (av) {
     GstBuffer *buf;
 
-    buf = gst_adapter_take_buffer (h265parse->frame_out, av);
+    buf = gst_adapter_take_buffer_fast (h265parse->frame_out, av);
     gst_buffer_copy_into (buf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
     gst_buffer_replace (&frame->out_buffer, buf);
     gst_buffer_unref (buf);
@@ -2738,13 +2773,14 @@ gst_h265_parse_handle_vps_sps_pps_nals (GstH265Parse * h265parse,
   } else {
     /* insert config NALs into AU */
     GstByteWriter bw;
-    GstBuffer *new_buf;
+    GstBuffer *new_buf, *config_buf;
     const gboolean bs = h265parse->format == GST_H265_PARSE_FORMAT_BYTE;
     const gint nls = 4 - h265parse->nal_length_size;
     gboolean ok;
 
-    gst_byte_writer_init_with_size (&bw, gst_buffer_get_size (buffer), FALSE);
-    ok = gst_byte_writer_put_buffer (&bw, buffer, 0, h265parse->idr_pos);
+    /* only the config NALs are written, the AU data is shared */
+    gst_byte_writer_init (&bw);
+    ok = TRUE;
     GST_DEBUG_OBJECT (h265parse, "- inserting VPS/SPS/PPS");
     for (i = 0; i < GST_H265_MAX_VPS_COUNT; i++) {
       if ((codec_nal = h265parse->vps_nals[i])) {
@@ -2793,9 +2829,16 @@ gst_h265_parse_handle_vps_sps_pps_nals (GstH265Parse * h265parse,
         send_done = TRUE;
       }
     }
-    ok &= gst_byte_writer_put_buffer (&bw, buffer, h265parse->idr_pos, -1);
+    config_buf = gst_byte_writer_reset_and_get_buffer (&bw);
     /* collect result and push */
-    new_buf = gst_byte_writer_reset_and_get_buffer (&bw);
+    if (h265parse->idr_pos > 0)
+      new_buf = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_MEMORY, 0,
+          h265parse->idr_pos);
+    else
+      new_buf = gst_buffer_new ();
+    new_buf = gst_buffer_append (new_buf, config_buf);
+    new_buf = gst_buffer_append (new_buf, gst_buffer_copy_region (buffer,
+            GST_BUFFER_COPY_MEMORY, h265parse->idr_pos, -1));
     gst_buffer_copy_into (new_buf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
     /* should already be keyframe/IDR, but it may not have been,
      * so mark it as such to avoid being discarded by picky decoder */
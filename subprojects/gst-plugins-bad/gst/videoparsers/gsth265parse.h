@@ -106,6 +106,10 @@ struct _GstH265Parse
   gint idr_pos, sei_pos;
   gboolean update_caps;
   GstAdapter *frame_out;
+  /* mapped input buffer of the NALs being processed */
+  GstBuffer *nal_src;
+  const guint8 *nal_src_data;
+  gsize nal_src_size;
   gboolean keyframe;
   gboolean predicted;
   gboolean bidirectional;
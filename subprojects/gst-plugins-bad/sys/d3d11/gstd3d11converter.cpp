@@ -456,6 +456,16 @@ struct _GstD3D11Converter
   ConvertInfo convert_info;
 
   GstStructure *config;
+
+  /* protects the deferred context and the update_* states, so that
+   * gst_d3d11_converter_convert() records commands without the device lock */
+  GMutex lock;
+  ID3D11DeviceContext *deferred_context;
+
+  /* GPU time of the last submitted command list, protected by device lock */
+  ID3D11Query *disjoint_query;
+  ID3D11Query *timestamp_query[2];
+  gboolean query_pending;
 };
 
 static gdouble
@@ -1925,6 +1935,7 @@ gst_d3d11_converter_new (GstD3D11Device * device,
 
   converter = g_new0 (GstD3D11Converter, 1);
   converter->device = (GstD3D11Device *) gst_object_ref (device);
+  g_mutex_init (&converter->lock);
   converter->config = gst_structure_new_empty ("GstD3D11Converter-Config");
   if (config)
     gst_d3d11_converter_set_config (converter, config);
@@ -2007,6 +2018,13 @@ gst_d3d11_converter_new (GstD3D11Device * device,
   } else {
     converter->in_info = *in_info;
     converter->out_info = *out_info;
+
+    /* Record draw calls on our own deferred context so that converters
+     * sharing a device contend on the device lock only for submission */
+    converter->deferred_context =
+        gst_d3d11_device_create_deferred_context (device);
+    if (!converter->deferred_context)
+      GST_DEBUG ("Deferred context is not supported, use immediate context");
   }
 
   return converter;
@@ -2048,23 +2066,28 @@ gst_d3d11_converter_free (GstD3D11Converter * converter)
   GST_D3D11_CLEAR_COM (converter->vertex_buffer);
   GST_D3D11_CLEAR_COM (converter->linear_sampler);
   GST_D3D11_CLEAR_COM (converter->alpha_const_buffer);
+  GST_D3D11_CLEAR_COM (converter->deferred_context);
+  GST_D3D11_CLEAR_COM (converter->disjoint_query);
+  GST_D3D11_CLEAR_COM (converter->timestamp_query[0]);
+  GST_D3D11_CLEAR_COM (converter->timestamp_query[1]);
 
   gst_clear_object (&converter->device);
 
   if (converter->config)
     gst_structure_free (converter->config);
 
+  g_mutex_clear (&converter->lock);
   g_free (converter);
 }
 
-/* must be called with gst_d3d11_device_lock since ID3D11DeviceContext is not
- * thread-safe */
+/* must be called with converter lock, and also with gst_d3d11_device_lock
+ * if @context_handle is the immediate context */
 static gboolean
-gst_d3d11_converter_update_vertex_buffer (GstD3D11Converter * self)
+gst_d3d11_converter_update_vertex_buffer (GstD3D11Converter * self,
+    ID3D11DeviceContext * context_handle)
 {
   D3D11_MAPPED_SUBRESOURCE map;
   VertexData *vertex_data;
-  ID3D11DeviceContext *context_handle;
   HRESULT hr;
   FLOAT x1, y1, x2, y2;
   FLOAT u, v;
@@ -2074,8 +2097,6 @@ gst_d3d11_converter_update_vertex_buffer (GstD3D11Converter * self)
   gint texture_height = self->input_texture_height;
   gdouble val;
 
-  context_handle = gst_d3d11_device_get_device_context_handle (self->device);
-
   hr = context_handle->Map (self->vertex_buffer, 0, D3D11_MAP_WRITE_DISCARD,
       0, &map);
 
@@ -2150,28 +2171,11 @@ gst_d3d11_converter_update_vertex_buffer (GstD3D11Converter * self)
   return TRUE;
 }
 
-gboolean
-gst_d3d11_converter_convert (GstD3D11Converter * converter,
-    ID3D11ShaderResourceView * srv[GST_VIDEO_MAX_PLANES],
-    ID3D11RenderTargetView * rtv[GST_VIDEO_MAX_PLANES],
-    ID3D11BlendState * blend, gfloat blend_factor[4])
-{
-  gboolean ret;
-
-  g_return_val_if_fail (converter != NULL, FALSE);
-  g_return_val_if_fail (srv != NULL, FALSE);
-  g_return_val_if_fail (rtv != NULL, FALSE);
-
-  gst_d3d11_device_lock (converter->device);
-  ret = gst_d3d11_converter_convert_unlocked (converter,
-      srv, rtv, blend, blend_factor);
-  gst_d3d11_device_unlock (converter->device);
-
-  return ret;
-}
-
-gboolean
-gst_d3d11_converter_convert_unlocked (GstD3D11Converter * converter,
+/* must be called with converter lock, and also with gst_d3d11_device_lock
+ * if @context_handle is the immediate context */
+static gboolean
+gst_d3d11_converter_record (GstD3D11Converter * converter,
+    ID3D11DeviceContext * context_handle,
     ID3D11ShaderResourceView * srv[GST_VIDEO_MAX_PLANES],
     ID3D11RenderTargetView * rtv[GST_VIDEO_MAX_PLANES],
     ID3D11BlendState * blend, gfloat blend_factor[4])
@@ -2183,10 +2187,6 @@ gst_d3d11_converter_convert_unlocked (GstD3D11Converter * converter,
   /* *INDENT-ON* */
   D3D11_TEXTURE2D_DESC desc;
 
-  g_return_val_if_fail (converter != NULL, FALSE);
-  g_return_val_if_fail (srv != NULL, FALSE);
-  g_return_val_if_fail (rtv != NULL, FALSE);
-
   /* check texture resolution and update crop area */
   srv[0]->GetResource (&resource);
   resource.As (&texture);
@@ -2201,7 +2201,7 @@ gst_d3d11_converter_convert_unlocked (GstD3D11Converter * converter,
     converter->input_texture_width = desc.Width;
     converter->input_texture_height = desc.Height;
 
-    if (!gst_d3d11_converter_update_vertex_buffer (converter)) {
+    if (!gst_d3d11_converter_update_vertex_buffer (converter, context_handle)) {
       GST_ERROR ("Cannot update vertex buffer");
       return FALSE;
     }
@@ -2209,15 +2209,11 @@ gst_d3d11_converter_convert_unlocked (GstD3D11Converter * converter,
 
   if (converter->update_alpha) {
     D3D11_MAPPED_SUBRESOURCE map;
-    ID3D11DeviceContext *context_handle;
     AlphaConstBuffer *alpha_const;
     HRESULT hr;
 
     g_assert (converter->alpha_const_buffer != nullptr);
 
-    context_handle =
-        gst_d3d11_device_get_device_context_handle (converter->device);
-
     hr = context_handle->Map (converter->alpha_const_buffer,
         0, D3D11_MAP_WRITE_DISCARD, 0, &map);
 
@@ -2233,15 +2229,15 @@ gst_d3d11_converter_convert_unlocked (GstD3D11Converter * converter,
     converter->update_alpha = FALSE;
   }
 
-  ret = gst_d3d11_draw_quad_unlocked (converter->quad[0], converter->viewport,
-      1, srv, converter->num_input_view, rtv, 1, blend, blend_factor,
-      &converter->linear_sampler, 1);
+  ret = gst_d3d11_draw_quad_on_context (converter->quad[0], context_handle,
+      converter->viewport, 1, srv, converter->num_input_view, rtv, 1,
+      blend, blend_factor, &converter->linear_sampler, 1);
 
   if (!ret)
     return FALSE;
 
   if (converter->quad[1]) {
-    ret = gst_d3d11_draw_quad_unlocked (converter->quad[1],
+    ret = gst_d3d11_draw_quad_on_context (converter->quad[1], context_handle,
         &converter->viewport[1], converter->num_output_view - 1,
         srv, converter->num_input_view, &rtv[1], converter->num_output_view - 1,
         blend, blend_factor, &converter->linear_sampler, 1);
@@ -2253,6 +2249,173 @@ gst_d3d11_converter_convert_unlocked (GstD3D11Converter * converter,
   return TRUE;
 }
 
+/* must be called with gst_d3d11_device_lock */
+static void
+gst_d3d11_converter_collect_gpu_time (GstD3D11Converter * self,
+    ID3D11DeviceContext * context_handle)
+{
+  D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+  UINT64 begin, end;
+  HRESULT hr;
+
+  if (!self->query_pending)
+    return;
+
+  /* Never stall the pipeline, results are picked up on a later frame */
+  hr = context_handle->GetData (self->disjoint_query, &disjoint,
+      sizeof (disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+  if (hr != S_OK)
+    return;
+
+  self->query_pending = FALSE;
+
+  if (disjoint.Disjoint || disjoint.Frequency == 0)
+    return;
+
+  if (context_handle->GetData (self->timestamp_query[0], &begin,
+          sizeof (begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+      context_handle->GetData (self->timestamp_query[1], &end,
+          sizeof (end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+    return;
+  }
+
+  GST_DEBUG ("Converter %p GPU time %" GST_TIME_FORMAT, self,
+      GST_TIME_ARGS (gst_util_uint64_scale (end - begin, GST_SECOND,
+              disjoint.Frequency)));
+}
+
+/* must be called with gst_d3d11_device_lock */
+static gboolean
+gst_d3d11_converter_ensure_queries (GstD3D11Converter * self)
+{
+  ID3D11Device *device_handle;
+  D3D11_QUERY_DESC desc;
+  HRESULT hr;
+
+  if (self->disjoint_query)
+    return TRUE;
+
+  device_handle = gst_d3d11_device_get_device_handle (self->device);
+
+  desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+  desc.MiscFlags = 0;
+  hr = device_handle->CreateQuery (&desc, &self->disjoint_query);
+  if (!gst_d3d11_result (hr, self->device))
+    return FALSE;
+
+  desc.Query = D3D11_QUERY_TIMESTAMP;
+  hr = device_handle->CreateQuery (&desc, &self->timestamp_query[0]);
+  if (gst_d3d11_result (hr, self->device))
+    hr = device_handle->CreateQuery (&desc, &self->timestamp_query[1]);
+
+  if (!gst_d3d11_result (hr, self->device)) {
+    GST_D3D11_CLEAR_COM (self->disjoint_query);
+    GST_D3D11_CLEAR_COM (self->timestamp_query[0]);
+    GST_D3D11_CLEAR_COM (self->timestamp_query[1]);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static void
+gst_d3d11_converter_submit (GstD3D11Converter * self,
+    ID3D11CommandList * command_list)
+{
+  ID3D11DeviceContext *context_handle;
+  gboolean measure;
+
+  /* GPU timestamps are collected only when someone is going to read them */
+  if (gst_debug_category_get_threshold (GST_CAT_DEFAULT) < GST_LEVEL_DEBUG) {
+    gst_d3d11_device_execute_command_list (self->device, command_list);
+    return;
+  }
+
+  context_handle = gst_d3d11_device_get_device_context_handle (self->device);
+
+  gst_d3d11_device_lock (self->device);
+  gst_d3d11_converter_collect_gpu_time (self, context_handle);
+
+  measure = !self->query_pending && gst_d3d11_converter_ensure_queries (self);
+  if (measure) {
+    context_handle->Begin (self->disjoint_query);
+    context_handle->End (self->timestamp_query[0]);
+  }
+
+  gst_d3d11_device_execute_command_list (self->device, command_list);
+
+  if (measure) {
+    context_handle->End (self->timestamp_query[1]);
+    context_handle->End (self->disjoint_query);
+    self->query_pending = TRUE;
+  }
+  gst_d3d11_device_unlock (self->device);
+}
+
+gboolean
+gst_d3d11_converter_convert (GstD3D11Converter * converter,
+    ID3D11ShaderResourceView * srv[GST_VIDEO_MAX_PLANES],
+    ID3D11RenderTargetView * rtv[GST_VIDEO_MAX_PLANES],
+    ID3D11BlendState * blend, gfloat blend_factor[4])
+{
+  gboolean ret;
+  ID3D11CommandList *command_list = nullptr;
+  HRESULT hr;
+
+  g_return_val_if_fail (converter != NULL, FALSE);
+  g_return_val_if_fail (srv != NULL, FALSE);
+  g_return_val_if_fail (rtv != NULL, FALSE);
+
+  if (!converter->deferred_context) {
+    gst_d3d11_device_lock (converter->device);
+    ret = gst_d3d11_converter_convert_unlocked (converter,
+        srv, rtv, blend, blend_factor);
+    gst_d3d11_device_unlock (converter->device);
+
+    return ret;
+  }
+
+  g_mutex_lock (&converter->lock);
+  ret = gst_d3d11_converter_record (converter, converter->deferred_context,
+      srv, rtv, blend, blend_factor);
+  /* Always finish the command list, it resets the deferred context state */
+  hr = converter->deferred_context->FinishCommandList (FALSE, &command_list);
+  g_mutex_unlock (&converter->lock);
+
+  if (!gst_d3d11_result (hr, converter->device)) {
+    GST_ERROR ("Couldn't finish command list, hr: 0x%x", (guint) hr);
+    return FALSE;
+  }
+
+  if (ret)
+    gst_d3d11_converter_submit (converter, command_list);
+
+  command_list->Release ();
+
+  return ret;
+}
+
+gboolean
+gst_d3d11_converter_convert_unlocked (GstD3D11Converter * converter,
+    ID3D11ShaderResourceView * srv[GST_VIDEO_MAX_PLANES],
+    ID3D11RenderTargetView * rtv[GST_VIDEO_MAX_PLANES],
+    ID3D11BlendState * blend, gfloat blend_factor[4])
+{
+  gboolean ret;
+
+  g_return_val_if_fail (converter != NULL, FALSE);
+  g_return_val_if_fail (srv != NULL, FALSE);
+  g_return_val_if_fail (rtv != NULL, FALSE);
+
+  g_mutex_lock (&converter->lock);
+  ret = gst_d3d11_converter_record (converter,
+      gst_d3d11_device_get_device_context_handle (converter->device),
+      srv, rtv, blend, blend_factor);
+  g_mutex_unlock (&converter->lock);
+
+  return ret;
+}
+
 gboolean
 gst_d3d11_converter_update_viewport (GstD3D11Converter * converter,
     D3D11_VIEWPORT * viewport)
@@ -2325,7 +2488,7 @@ gst_d3d11_converter_update_src_rect (GstD3D11Converter * converter,
   g_return_val_if_fail (converter != NULL, FALSE);
   g_return_val_if_fail (src_rect != NULL, FALSE);
 
-  gst_d3d11_device_lock (converter->device);
+  g_mutex_lock (&converter->lock);
   if (converter->src_rect.left != src_rect->left ||
       converter->src_rect.top != src_rect->top ||
       converter->src_rect.right != src_rect->right ||
@@ -2335,7 +2498,7 @@ gst_d3d11_converter_update_src_rect (GstD3D11Converter * converter,
     /* vertex buffer will be updated on next convert() call */
     converter->update_vertex = TRUE;
   }
-  gst_d3d11_device_unlock (converter->device);
+  g_mutex_unlock (&converter->lock);
 
   return TRUE;
 }
@@ -2347,7 +2510,7 @@ gst_d3d11_converter_update_dest_rect (GstD3D11Converter * converter,
   g_return_val_if_fail (converter != NULL, FALSE);
   g_return_val_if_fail (dest_rect != NULL, FALSE);
 
-  gst_d3d11_device_lock (converter->device);
+  g_mutex_lock (&converter->lock);
   if (converter->dest_rect.left != dest_rect->left ||
       converter->dest_rect.top != dest_rect->top ||
       converter->dest_rect.right != dest_rect->right ||
@@ -2357,7 +2520,7 @@ gst_d3d11_converter_update_dest_rect (GstD3D11Converter * converter,
     /* vertex buffer will be updated on next convert() call */
     converter->update_vertex = TRUE;
   }
-  gst_d3d11_device_unlock (converter->device);
+  g_mutex_unlock (&converter->lock);
 
   return TRUE;
 }
@@ -2369,7 +2532,7 @@ gst_d3d11_converter_update_config (GstD3D11Converter * converter,
   g_return_val_if_fail (converter != nullptr, FALSE);
   g_return_val_if_fail (config != nullptr, FALSE);
 
-  gst_d3d11_device_lock (converter->device);
+  g_mutex_lock (&converter->lock);
   gst_d3d11_converter_set_config (converter, config);
 
   /* Check whether options are updated or not */
@@ -2382,7 +2545,7 @@ gst_d3d11_converter_update_config (GstD3D11Converter * converter,
       converter->update_alpha = TRUE;
     }
   }
-  gst_d3d11_device_unlock (converter->device);
+  g_mutex_unlock (&converter->lock);
 
   return TRUE;
 }
@@ -351,7 +351,24 @@ gst_d3d11_draw_quad_unlocked (GstD3D11Quad * quad,
     ID3D11BlendState * blend, gfloat blend_factor[4],
     ID3D11SamplerState ** sampler, guint num_sampler)
 {
-  ID3D11DeviceContext *context;
+  g_return_val_if_fail (quad != NULL, FALSE);
+
+  return gst_d3d11_draw_quad_on_context (quad,
+      gst_d3d11_device_get_device_context_handle (quad->device),
+      viewport, num_viewport, srv, num_srv, rtv, num_rtv, blend, blend_factor,
+      sampler, num_sampler);
+}
+
+/* @context can be a deferred context, then the device lock is not required */
+gboolean
+gst_d3d11_draw_quad_on_context (GstD3D11Quad * quad,
+    ID3D11DeviceContext * context,
+    D3D11_VIEWPORT viewport[GST_VIDEO_MAX_PLANES], guint num_viewport,
+    ID3D11ShaderResourceView * srv[GST_VIDEO_MAX_PLANES], guint num_srv,
+    ID3D11RenderTargetView * rtv[GST_VIDEO_MAX_PLANES], guint num_rtv,
+    ID3D11BlendState * blend, gfloat blend_factor[4],
+    ID3D11SamplerState ** sampler, guint num_sampler)
+{
   UINT offsets = 0;
   ID3D11ShaderResourceView *clear_view[GST_VIDEO_MAX_PLANES] = { NULL, };
   ID3D11BlendState *blend_state = blend;
@@ -361,8 +378,7 @@ gst_d3d11_draw_quad_unlocked (GstD3D11Quad * quad,
   g_return_val_if_fail (num_viewport <= GST_VIDEO_MAX_PLANES, FALSE);
   g_return_val_if_fail (rtv != NULL, FALSE);
   g_return_val_if_fail (num_rtv <= GST_VIDEO_MAX_PLANES, FALSE);
-
-  context = gst_d3d11_device_get_device_context_handle (quad->device);
+  g_return_val_if_fail (context != NULL, FALSE);
 
   context->IASetPrimitiveTopology (D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
   context->IASetInputLayout (quad->layout);
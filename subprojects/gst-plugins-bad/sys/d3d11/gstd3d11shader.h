@@ -81,6 +81,19 @@ gboolean gst_d3d11_draw_quad_unlocked (GstD3D11Quad * quad,
                                        ID3D11SamplerState ** sampler,
                                        guint num_sampler);
 
+gboolean gst_d3d11_draw_quad_on_context (GstD3D11Quad * quad,
+                                         ID3D11DeviceContext * context,
+                                         D3D11_VIEWPORT viewport[GST_VIDEO_MAX_PLANES],
+                                         guint num_viewport,
+                                         ID3D11ShaderResourceView *srv[GST_VIDEO_MAX_PLANES],
+                                         guint num_srv,
+                                         ID3D11RenderTargetView *rtv[GST_VIDEO_MAX_PLANES],
+                                         guint num_rtv,
+                                         ID3D11BlendState *blend,
+                                         gfloat blend_factor[4],
+                                         ID3D11SamplerState ** sampler,
+                                         guint num_sampler);
+
 G_END_DECLS
 
 #endif /* __GST_D3D11_SHADER_H__ */
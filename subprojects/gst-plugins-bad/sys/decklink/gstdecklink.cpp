@@ -32,6 +32,10 @@
 #include "gstdecklinkvideosrc.h"
 #include "gstdecklinkdeviceprovider.h"
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (gst_decklink_debug);
 #define GST_CAT_DEFAULT gst_decklink_debug
 
@@ -1135,6 +1139,19 @@ public:
   }
 };
 
+/* Captured frames are page aligned so that they can be handed to anything
+ * downstream (DMA, GPU upload, pinning) without another copy */
+#define DECKLINK_BUFFER_ALIGN 4096
+/* Frames of this size or bigger (UHD and above) are backed by transparent
+ * huge pages where available to reduce TLB pressure */
+#define DECKLINK_HUGEPAGE_MIN_SIZE (2 * 1024 * 1024)
+
+typedef struct
+{
+  void *alloc_buf;
+  uint32_t size;
+} DecklinkBufferHeader;
+
 class GStreamerDecklinkMemoryAllocator:public IDeckLinkMemoryAllocator
 {
 private:
@@ -1144,6 +1161,44 @@ private:
   GstQueueArray *m_buffers;
   gint m_refcount;
 
+  static DecklinkBufferHeader *_getHeader (void *buffer)
+  {
+    return ((DecklinkBufferHeader *) buffer) - 1;
+  }
+
+  static uint8_t *_allocBuffer (uint32_t bufferSize)
+  {
+    uint8_t *alloc_buf;
+    uint8_t *buf;
+    DecklinkBufferHeader *header;
+
+    /* Leave room for the header right before the aligned buffer */
+    alloc_buf = (uint8_t *) g_malloc (bufferSize + DECKLINK_BUFFER_ALIGN +
+        sizeof (DecklinkBufferHeader));
+    buf = (uint8_t *) GSIZE_TO_POINTER (GPOINTER_TO_SIZE (alloc_buf +
+            sizeof (DecklinkBufferHeader) + DECKLINK_BUFFER_ALIGN - 1) &
+        ~((gsize) DECKLINK_BUFFER_ALIGN - 1));
+
+    header = _getHeader (buf);
+    header->alloc_buf = alloc_buf;
+    header->size = bufferSize;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (bufferSize >= DECKLINK_HUGEPAGE_MIN_SIZE) {
+      /* Only a hint, the kernel may or may not honour it */
+      madvise (buf, bufferSize & ~((gsize) DECKLINK_BUFFER_ALIGN - 1),
+          MADV_HUGEPAGE);
+    }
+#endif
+
+    return buf;
+  }
+
+  static void _freeBuffer (void *buffer)
+  {
+    g_free (_getHeader (buffer)->alloc_buf);
+  }
+
   void _clearBufferPool ()
   {
     uint8_t *buf;
@@ -1151,11 +1206,8 @@ private:
     if (!m_buffers)
         return;
 
-    while ((buf = (uint8_t *) gst_queue_array_pop_head (m_buffers))) {
-      uint8_t offset = *(buf - 1);
-      void *alloc_buf = buf - 128 + offset;
-        g_free (alloc_buf);
-    }
+    while ((buf = (uint8_t *) gst_queue_array_pop_head (m_buffers)))
+      _freeBuffer (buf);
   }
 
 public:
@@ -1215,7 +1267,6 @@ public:
       AllocateBuffer (uint32_t bufferSize, void **allocatedBuffer)
   {
     uint8_t *buf;
-    uint8_t offset = 0;
 
     g_mutex_lock (&m_mutex);
 
@@ -1228,24 +1279,7 @@ public:
     /* Look if there is a free buffer in the pool */
     if (!(buf = (uint8_t *) gst_queue_array_pop_head (m_buffers))) {
       /* If not, alloc a new one */
-      buf = (uint8_t *) g_malloc (bufferSize + 128);
-
-      /* The Decklink SDK requires 16 byte aligned memory at least but for us
-       * to work nicely let's align to 64 bytes (512 bits) as this allows
-       * aligned AVX2 operations for example */
-      if (((guintptr) buf) % 64 != 0) {
-        offset = ((guintptr) buf) % 64;
-      }
-
-      /* Write the allocation size at the very beginning. It's guaranteed by
-       * malloc() to be allocated aligned enough for doing this. */
-      *((uint32_t *) buf) = bufferSize;
-
-      /* Align our buffer */
-      buf += 128 - offset;
-
-      /* And write the alignment offset right before the buffer */
-      *(buf - 1) = offset;
+      buf = _allocBuffer (bufferSize);
     }
     *allocatedBuffer = (void *) buf;
 
@@ -1254,9 +1288,7 @@ public:
     if (gst_queue_array_get_length (m_buffers) > 0) {
       if (++m_nonEmptyCalls >= 5) {
         buf = (uint8_t *) gst_queue_array_pop_head (m_buffers);
-        uint8_t offset = *(buf - 1);
-        void *alloc_buf = buf - 128 + offset;
-        g_free (alloc_buf);
+        _freeBuffer (buf);
         m_nonEmptyCalls = 0;
       }
     } else {
@@ -1273,13 +1305,10 @@ public:
     g_mutex_lock (&m_mutex);
 
     /* Put the buffer back to the pool if size matches with current pool */
-    uint8_t offset = *(((uint8_t *) buffer) - 1);
-    uint8_t *alloc_buffer = ((uint8_t *) buffer) - 128 + offset;
-    uint32_t size = *(uint32_t *) alloc_buffer;
-    if (size == m_lastBufferSize) {
+    if (_getHeader (buffer)->size == m_lastBufferSize) {
       gst_queue_array_push_tail (m_buffers, buffer);
     } else {
-      g_free (alloc_buffer);
+      _freeBuffer (buffer);
     }
 
     g_mutex_unlock (&m_mutex);
@@ -171,6 +171,7 @@ enum
   PROP_HW_SERIAL_NUMBER,
   PROP_OUTPUT_CC,
   PROP_OUTPUT_AFD_BAR,
+  PROP_DROPPED_FRAMES,
 };
 
 typedef struct
@@ -374,6 +375,20 @@ gst_decklink_video_src_class_init (GstDecklinkVideoSrcClass * klass)
           DEFAULT_OUTPUT_AFD_BAR,
           (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 
+  /**
+   * GstDecklinkVideoSrc:dropped-frames:
+   *
+   * Number of captured frames that were dropped because the internal buffer
+   * of #GstDecklinkVideoSrc:buffer-size frames was full.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_DROPPED_FRAMES,
+      g_param_spec_uint64 ("dropped-frames", "Dropped frames",
+          "Number of captured frames dropped because the internal buffer "
+          "was full", 0, G_MAXUINT64, 0,
+          (GParamFlags) (G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
+
   templ_caps = gst_decklink_mode_get_template_caps (TRUE);
   gst_element_class_add_pad_template (element_class,
       gst_pad_template_new ("src", GST_PAD_SRC, GST_PAD_ALWAYS, templ_caps));
@@ -555,6 +570,11 @@ gst_decklink_video_src_get_property (GObject * object, guint property_id,
     case PROP_OUTPUT_AFD_BAR:
       g_value_set_boolean (value, self->output_afd_bar);
       break;
+    case PROP_DROPPED_FRAMES:
+      g_mutex_lock (&self->lock);
+      g_value_set_uint64 (value, self->dropped_frames);
+      g_mutex_unlock (&self->lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -782,6 +802,54 @@ gst_decklink_video_src_update_time_mapping (GstDecklinkVideoSrc * self,
   }
 }
 
+/* Must be called without the lock, takes ownership of @dtc */
+static GstVideoTimeCode *
+gst_decklink_video_src_parse_timecode (GstDecklinkVideoSrc * self,
+    IDeckLinkTimecode * dtc, GstDecklinkModeEnum mode)
+{
+  const GstDecklinkMode *bmode;
+  GstVideoTimeCodeFlags flags = GST_VIDEO_TIME_CODE_FLAGS_NONE;
+  guint field_count = 0;
+  uint8_t hours, minutes, seconds, frames;
+  GstVideoTimeCode *tc = NULL;
+  HRESULT res;
+
+  res = dtc->GetComponents (&hours, &minutes, &seconds, &frames);
+  if (res != S_OK) {
+    GST_ERROR ("Could not get components for timecode %p: 0x%08lx", dtc,
+        (unsigned long) res);
+  } else {
+    GST_DEBUG_OBJECT (self, "Got timecode %02d:%02d:%02d:%02d",
+        hours, minutes, seconds, frames);
+    bmode = gst_decklink_get_mode (mode);
+    if (bmode->interlaced)
+      flags =
+          (GstVideoTimeCodeFlags) (flags |
+          GST_VIDEO_TIME_CODE_FLAGS_INTERLACED);
+    if (bmode->fps_d == 1001) {
+      if (bmode->fps_n == 30000 || bmode->fps_n == 60000) {
+        /* Some occurrences have been spotted where the driver mistakenly
+         * fails to set the drop-frame flag for drop-frame timecodes.
+         * Assume always drop-frame for 29.97 and 59.94 FPS */
+        flags =
+            (GstVideoTimeCodeFlags) (flags |
+            GST_VIDEO_TIME_CODE_FLAGS_DROP_FRAME);
+      } else {
+        /* Drop-frame isn't defined for any other framerates (e.g. 23.976)
+         * */
+        flags =
+            (GstVideoTimeCodeFlags) (flags &
+            ~GST_VIDEO_TIME_CODE_FLAGS_DROP_FRAME);
+      }
+    }
+    tc = gst_video_time_code_new (bmode->fps_n, bmode->fps_d, NULL, flags,
+        hours, minutes, seconds, frames, field_count);
+  }
+  dtc->Release ();
+
+  return tc;
+}
+
 static void
 gst_decklink_video_src_got_frame (GstElement * element,
     IDeckLinkVideoInputFrame * frame, GstDecklinkModeEnum mode,
@@ -791,12 +859,18 @@ gst_decklink_video_src_got_frame (GstElement * element,
 {
   GstDecklinkVideoSrc *self = GST_DECKLINK_VIDEO_SRC_CAST (element);
   GstClockTime timestamp, duration;
+  GstVideoTimeCode *tc = NULL;
 
   GST_LOG_OBJECT (self,
       "Got video frame at %" GST_TIME_FORMAT " / %" GST_TIME_FORMAT " (%"
       GST_TIME_FORMAT "), no signal: %d", GST_TIME_ARGS (capture_time),
       GST_TIME_ARGS (stream_time), GST_TIME_ARGS (stream_duration), no_signal);
 
+  /* Keep the critical section short, the streaming thread and the other
+   * capture callbacks of this device contend on it */
+  if (dtc != NULL)
+    tc = gst_decklink_video_src_parse_timecode (self, dtc, mode);
+
   g_mutex_lock (&self->lock);
   if (self->first_time == GST_CLOCK_TIME_NONE)
     self->first_time = stream_time;
@@ -808,6 +882,8 @@ gst_decklink_video_src_got_frame (GstElement * element,
         "Skipping frame as requested: %" GST_TIME_FORMAT " < %" GST_TIME_FORMAT,
         GST_TIME_ARGS (stream_time),
         GST_TIME_ARGS (self->skip_first_time + self->first_time));
+    if (tc)
+      gst_video_time_code_free (tc);
     return;
   }
 
@@ -820,6 +896,9 @@ gst_decklink_video_src_got_frame (GstElement * element,
     g_cond_signal (&self->cond);
     g_mutex_unlock (&self->lock);
 
+    if (tc)
+      gst_video_time_code_free (tc);
+
     return;
   }
 
@@ -843,9 +922,6 @@ gst_decklink_video_src_got_frame (GstElement * element,
 
   if (!self->flushing) {
     CaptureFrame f;
-    const GstDecklinkMode *bmode;
-    GstVideoTimeCodeFlags flags = GST_VIDEO_TIME_CODE_FLAGS_NONE;
-    guint field_count = 0;
     guint skipped_frames = 0;
 
     while (gst_queue_array_get_length (self->current_frames) >=
@@ -880,6 +956,7 @@ gst_decklink_video_src_got_frame (GstElement * element,
     }
 
     self->skipped_last += skipped_frames;
+    self->dropped_frames += skipped_frames;
 
     memset (&f, 0, sizeof (f));
     f.frame = frame;
@@ -892,53 +969,17 @@ gst_decklink_video_src_got_frame (GstElement * element,
     f.mode = mode;
     f.format = frame->GetPixelFormat ();
     f.no_signal = no_signal;
-    if (dtc != NULL) {
-      uint8_t hours, minutes, seconds, frames;
-      HRESULT res;
-
-      res = dtc->GetComponents (&hours, &minutes, &seconds, &frames);
-      if (res != S_OK) {
-        GST_ERROR ("Could not get components for timecode %p: 0x%08lx", dtc,
-            (unsigned long) res);
-        f.tc = NULL;
-      } else {
-        GST_DEBUG_OBJECT (self, "Got timecode %02d:%02d:%02d:%02d",
-            hours, minutes, seconds, frames);
-        bmode = gst_decklink_get_mode (mode);
-        if (bmode->interlaced)
-          flags =
-              (GstVideoTimeCodeFlags) (flags |
-              GST_VIDEO_TIME_CODE_FLAGS_INTERLACED);
-        if (bmode->fps_d == 1001) {
-          if (bmode->fps_n == 30000 || bmode->fps_n == 60000) {
-            /* Some occurrences have been spotted where the driver mistakenly
-             * fails to set the drop-frame flag for drop-frame timecodes.
-             * Assume always drop-frame for 29.97 and 59.94 FPS */
-            flags =
-                (GstVideoTimeCodeFlags) (flags |
-                GST_VIDEO_TIME_CODE_FLAGS_DROP_FRAME);
-          } else {
-            /* Drop-frame isn't defined for any other framerates (e.g. 23.976)
-             * */
-            flags =
-                (GstVideoTimeCodeFlags) (flags &
-                ~GST_VIDEO_TIME_CODE_FLAGS_DROP_FRAME);
-          }
-        }
-        f.tc =
-            gst_video_time_code_new (bmode->fps_n, bmode->fps_d, NULL, flags,
-            hours, minutes, seconds, frames, field_count);
-      }
-      dtc->Release ();
-    } else {
-      f.tc = NULL;
-    }
+    f.tc = tc;
+    tc = NULL;
 
     frame->AddRef ();
     gst_queue_array_push_tail_struct (self->current_frames, &f);
     g_cond_signal (&self->cond);
   }
   g_mutex_unlock (&self->lock);
+
+  if (tc)
+    gst_video_time_code_free (tc);
 }
 
 static void
@@ -1645,6 +1686,7 @@ gst_decklink_video_src_change_state (GstElement * element,
     case GST_STATE_CHANGE_NULL_TO_READY:
       self->processed = 0;
       self->dropped = 0;
+      self->dropped_frames = 0;
       self->expected_stream_time = GST_CLOCK_TIME_NONE;
       self->first_stream_time = GST_CLOCK_TIME_NONE;
       if (!gst_decklink_video_src_open (self)) {
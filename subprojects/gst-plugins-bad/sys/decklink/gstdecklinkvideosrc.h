@@ -114,6 +114,8 @@ struct _GstDecklinkVideoSrc
   gint last_afd_bar_vbi_line_field2;
 
   guint skipped_last;
+  /* Protected by lock */
+  guint64 dropped_frames;
   GstClockTime skip_from_timestamp;
   GstClockTime skip_to_timestamp;
 };
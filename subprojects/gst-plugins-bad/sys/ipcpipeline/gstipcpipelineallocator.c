@@ -0,0 +1,116 @@
+/* GStreamer
+ * Copyright (C) 2015-2017 YouView TV Ltd
+ *   Author: Vincent Penquerch <vincent.penquerch@collabora.co.uk>
+ *
+ * gstipcpipelineallocator.c:
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <errno.h>
+#include <string.h>
+#ifdef HAVE_UNISTD_H
+#  include <unistd.h>
+#endif
+#ifdef HAVE_MEMFD_CREATE
+#  include <sys/mman.h>
+#endif
+#include "gstipcpipelineallocator.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_ipc_pipeline_allocator_debug);
+#define GST_CAT_DEFAULT gst_ipc_pipeline_allocator_debug
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_ipc_pipeline_allocator_debug, "ipcpipelineallocator", 0, "ipcpipeline memfd allocator");
+G_DEFINE_TYPE_WITH_CODE (GstIpcPipelineAllocator, gst_ipc_pipeline_allocator,
+    GST_TYPE_FD_ALLOCATOR, _do_init);
+
+static GstMemory *
+gst_ipc_pipeline_allocator_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+#ifdef HAVE_MEMFD_CREATE
+  GstMemory *mem;
+  gsize maxsize;
+  int fd;
+
+  /* mmap() gives us page aligned memory, which is more than any alignment
+   * a GstAllocationParams can reasonably ask for */
+  maxsize = size;
+  if (params)
+    maxsize += params->prefix + params->padding;
+
+  fd = memfd_create ("gst-ipcpipeline", MFD_CLOEXEC);
+  if (fd < 0) {
+    GST_ERROR_OBJECT (allocator, "memfd_create failed: %s", strerror (errno));
+    return NULL;
+  }
+
+  if (ftruncate (fd, maxsize) < 0) {
+    GST_ERROR_OBJECT (allocator, "ftruncate failed: %s", strerror (errno));
+    close (fd);
+    return NULL;
+  }
+
+  mem = gst_fd_allocator_alloc (allocator, fd, maxsize,
+      GST_FD_MEMORY_FLAG_KEEP_MAPPED);
+  if (G_UNLIKELY (!mem)) {
+    GST_ERROR_OBJECT (allocator, "GstFdMemory allocation failed");
+    close (fd);
+    return NULL;
+  }
+
+  if (params && params->prefix)
+    gst_memory_resize (mem, params->prefix, size);
+
+  return mem;
+#else
+  GST_ERROR_OBJECT (allocator, "memfd is not supported on this platform");
+  return NULL;
+#endif
+}
+
+static void
+gst_ipc_pipeline_allocator_class_init (GstIpcPipelineAllocatorClass * klass)
+{
+  GstAllocatorClass *alloc_class = (GstAllocatorClass *) klass;
+
+  alloc_class->alloc = GST_DEBUG_FUNCPTR (gst_ipc_pipeline_allocator_alloc);
+}
+
+static void
+gst_ipc_pipeline_allocator_init (GstIpcPipelineAllocator * self)
+{
+  GstAllocator *alloc = GST_ALLOCATOR_CAST (self);
+
+  alloc->mem_type = GST_ALLOCATOR_IPC_PIPELINE_MEMFD;
+
+  GST_OBJECT_FLAG_UNSET (self, GST_ALLOCATOR_FLAG_CUSTOM_ALLOC);
+}
+
+GstAllocator *
+gst_ipc_pipeline_allocator_new (void)
+{
+  GstAllocator *alloc;
+
+  alloc = g_object_new (GST_TYPE_IPC_PIPELINE_ALLOCATOR, NULL);
+  gst_object_ref_sink (alloc);
+  return alloc;
+}
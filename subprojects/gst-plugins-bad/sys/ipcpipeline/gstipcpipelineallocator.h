@@ -0,0 +1,60 @@
+/* GStreamer
+ * Copyright (C) 2015-2017 YouView TV Ltd
+ *   Author: Vincent Penquerch <vincent.penquerch@collabora.co.uk>
+ *
+ * gstipcpipelineallocator.h:
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_IPC_PIPELINE_ALLOCATOR_H__
+#define __GST_IPC_PIPELINE_ALLOCATOR_H__
+
+#include <gst/gst.h>
+#include <gst/allocators/gstfdmemory.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_IPC_PIPELINE_ALLOCATOR \
+  (gst_ipc_pipeline_allocator_get_type())
+#define GST_IPC_PIPELINE_ALLOCATOR(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_IPC_PIPELINE_ALLOCATOR,GstIpcPipelineAllocator))
+#define GST_IS_IPC_PIPELINE_ALLOCATOR(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_IPC_PIPELINE_ALLOCATOR))
+
+#define GST_ALLOCATOR_IPC_PIPELINE_MEMFD "ipcpipelinememfd"
+
+typedef struct _GstIpcPipelineAllocator GstIpcPipelineAllocator;
+typedef struct _GstIpcPipelineAllocatorClass GstIpcPipelineAllocatorClass;
+
+/* GstFdMemory backed by anonymous shared memory (memfd), so that
+ * ipcpipelinesink can hand the memory over to the other process by
+ * passing its fd instead of writing its contents on the socket */
+struct _GstIpcPipelineAllocator {
+  GstFdAllocator parent;
+};
+
+struct _GstIpcPipelineAllocatorClass {
+  GstFdAllocatorClass parent_class;
+};
+
+G_GNUC_INTERNAL GType gst_ipc_pipeline_allocator_get_type (void);
+
+G_GNUC_INTERNAL GstAllocator *gst_ipc_pipeline_allocator_new (void);
+
+G_END_DECLS
+
+#endif /* __GST_IPC_PIPELINE_ALLOCATOR_H__ */
@@ -32,10 +32,15 @@
 #  define ssize_t int
 #  include <winsock2.h>
 #endif
+#if defined (G_OS_UNIX) && defined (HAVE_SYS_SOCKET_H)
+#  include <sys/socket.h>
+#  define HAVE_FD_PASSING 1
+#endif
 #include <errno.h>
 #include <string.h>
 #include <gst/base/gstbytewriter.h>
 #include <gst/gstprotection.h>
+#include <gst/allocators/gstdmabuf.h>
 #include "gstipcpipelinecomm.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_ipc_pipeline_comm_debug);
@@ -43,6 +48,17 @@ GST_DEBUG_CATEGORY_STATIC (gst_ipc_pipeline_comm_debug);
 
 #define DEFAULT_ACK_TIME (10 * G_TIME_SPAN_SECOND)
 
+/* a GstBuffer holds at most 16 memories, so this is the most fds a
+ * FD_BUFFER chunk can carry */
+#define MAX_PASSED_FDS 16
+
+typedef enum
+{
+  COMM_MEMORY_KIND_INLINE,
+  COMM_MEMORY_KIND_FD,
+  COMM_MEMORY_KIND_DMABUF
+} CommMemoryKind;
+
 GQuark QUARK_ID;
 
 typedef enum
@@ -193,6 +209,10 @@ gst_ipc_pipeline_comm_data_type_get_name (GstIpcPipelineCommDataType type)
       return "MESSAGE";
     case GST_IPC_PIPELINE_COMM_DATA_TYPE_GERROR_MESSAGE:
       return "GERROR_MESSAGE";
+    case GST_IPC_PIPELINE_COMM_DATA_TYPE_FD_BUFFER:
+      return "FD_BUFFER";
+    case GST_IPC_PIPELINE_COMM_DATA_TYPE_RELEASE:
+      return "RELEASE";
     default:
       return "UNKNOWN";
   }
@@ -262,6 +282,72 @@ done:
   return ret;
 }
 
+#ifdef HAVE_FD_PASSING
+static gboolean
+fd_is_unix_socket (int fd)
+{
+  struct sockaddr_storage addr;
+  socklen_t len = sizeof (addr);
+
+  if (fd < 0)
+    return FALSE;
+  if (getsockname (fd, (struct sockaddr *) &addr, &len) < 0)
+    return FALSE;
+  return addr.ss_family == AF_UNIX;
+}
+
+/* sends the fds as SCM_RIGHTS along with the first bytes of data, the
+ * rest of the data is written as usual */
+static gboolean
+write_to_fd_with_fds (GstIpcPipelineComm * comm, const void *data,
+    size_t size, const int *fds, guint n_fds)
+{
+  union
+  {
+    char buf[CMSG_SPACE (sizeof (int) * MAX_PASSED_FDS)];
+    struct cmsghdr align;
+  } control;
+  struct msghdr msg = { 0, };
+  struct cmsghdr *cmsg;
+  struct iovec iov;
+  ssize_t written;
+
+  g_return_val_if_fail (n_fds > 0 && n_fds <= MAX_PASSED_FDS, FALSE);
+  g_return_val_if_fail (size > 0, FALSE);
+
+  GST_TRACE_OBJECT (comm->element, "Writing %u bytes and %u fds to fdout",
+      (unsigned) size, n_fds);
+
+  iov.iov_base = (void *) data;
+  iov.iov_len = size;
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  memset (&control, 0, sizeof (control));
+  msg.msg_control = control.buf;
+  msg.msg_controllen = CMSG_SPACE (sizeof (int) * n_fds);
+  cmsg = CMSG_FIRSTHDR (&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN (sizeof (int) * n_fds);
+  memcpy (CMSG_DATA (cmsg), fds, sizeof (int) * n_fds);
+
+  do {
+    written = sendmsg (comm->fdout, &msg, 0);
+  } while (written < 0 && (errno == EAGAIN || errno == EINTR));
+
+  if (written < 0) {
+    GST_ERROR_OBJECT (comm->element, "Failed to send fds: %s",
+        strerror (errno));
+    return FALSE;
+  }
+
+  if ((size_t) written < size)
+    return write_to_fd_raw (comm, (const guint8 *) data + written,
+        size - written);
+  return TRUE;
+}
+#endif
+
 static gboolean
 write_byte_writer_to_fd (GstIpcPipelineComm * comm, GstByteWriter * bw)
 {
@@ -501,6 +587,19 @@ build_meta (GstBuffer * buffer, GstMeta ** meta, gpointer user_data)
         strlen (repr->info[repr->n_meta - 1].str) + 1;
     GST_TRACE_OBJECT (repr->comm->element, "Found GstMeta type %s: %s",
         g_type_name ((*meta)->info->api), repr->info[repr->n_meta - 1].str);
+  } else if ((*meta)->info->api == GST_REFERENCE_TIMESTAMP_META_API_TYPE) {
+    GstReferenceTimestampMeta *m = (GstReferenceTimestampMeta *) * meta;
+    GstStructure *s = gst_structure_new ("reference-timestamp",
+        "reference", GST_TYPE_CAPS, m->reference,
+        "timestamp", G_TYPE_UINT64, m->timestamp,
+        "duration", G_TYPE_UINT64, m->duration, NULL);
+
+    repr->info[repr->n_meta - 1].str = gst_structure_to_string (s);
+    repr->info[repr->n_meta - 1].bytes +=
+        strlen (repr->info[repr->n_meta - 1].str) + 1;
+    gst_structure_free (s);
+    GST_TRACE_OBJECT (repr->comm->element, "Found GstMeta type %s: %s",
+        g_type_name ((*meta)->info->api), repr->info[repr->n_meta - 1].str);
   } else {
     GST_WARNING_OBJECT (repr->comm->element, "Ignoring GstMeta type %s",
         g_type_name ((*meta)->info->api));
@@ -519,6 +618,157 @@ typedef struct
   guint64 flags;
 } CommBufferMetadata;
 
+static gboolean
+put_meta_list (GstByteWriter * bw, const MetaListRepresentation * repr)
+{
+  guint32 n;
+
+  if (!gst_byte_writer_put_uint32_le (bw, repr->n_meta))
+    return FALSE;
+  for (n = 0; n < repr->n_meta; ++n) {
+    const MetaBuildInfo *info = repr->info + n;
+    guint32 len;
+    const char *s;
+
+    if (!gst_byte_writer_put_uint32_le (bw, info->bytes))
+      return FALSE;
+
+    if (!gst_byte_writer_put_uint32_le (bw, info->flags))
+      return FALSE;
+
+    s = g_type_name (info->api);
+    len = strlen (s) + 1;
+    if (!gst_byte_writer_put_uint32_le (bw, len))
+      return FALSE;
+    if (!gst_byte_writer_put_data (bw, (const guint8 *) s, len))
+      return FALSE;
+
+    if (!gst_byte_writer_put_uint64_le (bw, info->size))
+      return FALSE;
+
+    s = info->str;
+    len = s ? (strlen (s) + 1) : 0;
+    if (!gst_byte_writer_put_uint32_le (bw, len))
+      return FALSE;
+    if (len)
+      if (!gst_byte_writer_put_data (bw, (const guint8 *) s, len))
+        return FALSE;
+  }
+  return TRUE;
+}
+
+/* whether fd backed memory is passed as fds on fdout, rather than
+ * having its contents written on it */
+gboolean
+gst_ipc_pipeline_comm_can_pass_fds (GstIpcPipelineComm * comm)
+{
+#ifdef HAVE_FD_PASSING
+  return comm->fd_passing && fd_is_unix_socket (comm->fdout);
+#else
+  return FALSE;
+#endif
+}
+
+#ifdef HAVE_FD_PASSING
+static gboolean
+buffer_has_fd_memory (GstBuffer * buffer)
+{
+  guint n, n_mem = gst_buffer_n_memory (buffer);
+
+  for (n = 0; n < n_mem; ++n)
+    if (gst_is_fd_memory (gst_buffer_peek_memory (buffer, n)))
+      return TRUE;
+  return FALSE;
+}
+
+/* Same as the BUFFER chunk, except the data is described per GstMemory.
+ * fd backed memory travels as a fd attached to the chunk, and only its
+ * offset and size are written in the payload. Any other memory is written
+ * inline. The whole chunk is sent in a single sendmsg where possible. */
+static gboolean
+write_fd_buffer_to_fd (GstIpcPipelineComm * comm, GstBuffer * buffer,
+    const CommBufferMetadata * meta, const MetaListRepresentation * repr)
+{
+  const unsigned char payload_type = GST_IPC_PIPELINE_COMM_DATA_TYPE_FD_BUFFER;
+  int fds[MAX_PASSED_FDS];
+  guint n, n_mem, n_fds = 0;
+  GstByteWriter bw;
+  guint8 *data;
+  guint size;
+  gboolean ret;
+
+  n_mem = gst_buffer_n_memory (buffer);
+
+  gst_byte_writer_init (&bw);
+  if (!gst_byte_writer_put_uint8 (&bw, payload_type))
+    goto write_failed;
+  if (!gst_byte_writer_put_uint32_le (&bw, comm->send_id))
+    goto write_failed;
+  /* payload size, filled in once known */
+  if (!gst_byte_writer_put_uint32_le (&bw, 0))
+    goto write_failed;
+  if (!gst_byte_writer_put_data (&bw, (const guint8 *) meta, sizeof (*meta)))
+    goto write_failed;
+  if (!gst_byte_writer_put_uint32_le (&bw, n_mem))
+    goto write_failed;
+
+  for (n = 0; n < n_mem; ++n) {
+    GstMemory *mem = gst_buffer_peek_memory (buffer, n);
+
+    if (gst_is_fd_memory (mem) && n_fds < MAX_PASSED_FDS) {
+      guint8 kind = gst_is_dmabuf_memory (mem) ?
+          COMM_MEMORY_KIND_DMABUF : COMM_MEMORY_KIND_FD;
+
+      if (!gst_byte_writer_put_uint8 (&bw, kind))
+        goto write_failed;
+      if (!gst_byte_writer_put_uint64_le (&bw, mem->offset))
+        goto write_failed;
+      if (!gst_byte_writer_put_uint64_le (&bw, mem->size))
+        goto write_failed;
+      if (!gst_byte_writer_put_uint64_le (&bw, mem->maxsize))
+        goto write_failed;
+      fds[n_fds++] = gst_fd_memory_get_fd (mem);
+    } else {
+      GstMapInfo map;
+
+      if (!gst_byte_writer_put_uint8 (&bw, COMM_MEMORY_KIND_INLINE))
+        goto write_failed;
+      if (!gst_memory_map (mem, &map, GST_MAP_READ))
+        goto write_failed;
+      ret = gst_byte_writer_put_uint32_le (&bw, map.size)
+          && gst_byte_writer_put_data (&bw, map.data, map.size);
+      gst_memory_unmap (mem, &map);
+      if (!ret)
+        goto write_failed;
+    }
+  }
+
+  if (!put_meta_list (&bw, repr))
+    goto write_failed;
+
+  size = gst_byte_writer_get_size (&bw);
+  data = gst_byte_writer_reset_and_get_data (&bw);
+  if (!data)
+    return FALSE;
+  GST_WRITE_UINT32_LE (data + 1 + sizeof (guint32), size - 1 -
+      2 * sizeof (guint32));
+
+  ret = write_to_fd_with_fds (comm, data, size, fds, n_fds);
+  g_free (data);
+
+  /* the other side maps the same memory, so it must not go back to its
+   * pool until the other side tells us it is done with it */
+  if (ret)
+    g_hash_table_insert (comm->shared_buffers,
+        GINT_TO_POINTER (comm->send_id), gst_buffer_ref (buffer));
+  return ret;
+
+write_failed:
+  gst_byte_writer_reset (&bw);
+  return FALSE;
+}
+#endif
+
 GstFlowReturn
 gst_ipc_pipeline_comm_write_buffer_to_fd (GstIpcPipelineComm * comm,
     GstBuffer * buffer)
@@ -550,6 +800,15 @@ gst_ipc_pipeline_comm_write_buffer_to_fd (GstIpcPipelineComm * comm,
   /* work out meta size */
   gst_buffer_foreach_meta (buffer, build_meta, &repr);
 
+#ifdef HAVE_FD_PASSING
+  if (buffer_has_fd_memory (buffer)
+      && gst_ipc_pipeline_comm_can_pass_fds (comm)) {
+    if (!write_fd_buffer_to_fd (comm, buffer, &meta, &repr))
+      goto write_failed;
+    goto sync;
+  }
+#endif
+
   if (!gst_byte_writer_put_uint8 (&bw, payload_type))
     goto write_failed;
   if (!gst_byte_writer_put_uint32_le (&bw, comm->send_id))
@@ -576,41 +835,15 @@ gst_ipc_pipeline_comm_write_buffer_to_fd (GstIpcPipelineComm * comm,
 
   /* meta */
   gst_byte_writer_init (&bw);
-  if (!gst_byte_writer_put_uint32_le (&bw, repr.n_meta))
+  if (!put_meta_list (&bw, &repr))
     goto write_failed;
-  for (n = 0; n < repr.n_meta; ++n) {
-    const MetaBuildInfo *info = repr.info + n;
-    guint32 len;
-    const char *s;
-
-    if (!gst_byte_writer_put_uint32_le (&bw, info->bytes))
-      goto write_failed;
-
-    if (!gst_byte_writer_put_uint32_le (&bw, info->flags))
-      goto write_failed;
-
-    s = g_type_name (info->api);
-    len = strlen (s) + 1;
-    if (!gst_byte_writer_put_uint32_le (&bw, len))
-      goto write_failed;
-    if (!gst_byte_writer_put_data (&bw, (const guint8 *) s, len))
-      goto write_failed;
-
-    if (!gst_byte_writer_put_uint64_le (&bw, info->size))
-      goto write_failed;
-
-    s = info->str;
-    len = s ? (strlen (s) + 1) : 0;
-    if (!gst_byte_writer_put_uint32_le (&bw, len))
-      goto write_failed;
-    if (len)
-      if (!gst_byte_writer_put_data (&bw, (const guint8 *) s, len))
-        goto write_failed;
-  }
 
   if (!write_byte_writer_to_fd (comm, &bw))
     goto write_failed;
 
+#ifdef HAVE_FD_PASSING
+sync:
+#endif
   if (!gst_ipc_pipeline_comm_sync_fd (comm, comm->send_id, NULL, &ret32,
           ACK_TYPE_BLOCKING, COMM_REQUEST_TYPE_BUFFER))
     goto wait_failed;
@@ -643,12 +876,14 @@ map_failed:
   goto done;
 }
 
+static gboolean gst_ipc_pipeline_comm_read_buffer_meta (GstIpcPipelineComm *
+    comm, GstBuffer * buffer, guint32 size);
+
 static GstBuffer *
 gst_ipc_pipeline_comm_read_buffer (GstIpcPipelineComm * comm, guint32 size)
 {
   GstBuffer *buffer;
   CommBufferMetadata meta;
-  guint32 n_meta, n;
   const guint8 *payload = NULL;
   guint32 mapped_size, buffer_data_size;
 
@@ -682,16 +917,222 @@ gst_ipc_pipeline_comm_read_buffer (GstIpcPipelineComm * comm, guint32 size)
   GST_BUFFER_OFFSET_END (buffer) = meta.offset_end;
   GST_BUFFER_FLAGS (buffer) = meta.flags;
 
+  if (!gst_ipc_pipeline_comm_read_buffer_meta (comm, buffer, size)) {
+    gst_buffer_unref (buffer);
+    return NULL;
+  }
+
+  return buffer;
+}
+
+#ifdef HAVE_FD_PASSING
+typedef struct
+{
+  GstElement *element;
+  GstIpcPipelineComm *comm;
+  guint32 id;
+  gint n_memories;
+} SharedMemoryRelease;
+
+static void
+gst_ipc_pipeline_comm_write_release_to_fd (GstIpcPipelineComm * comm,
+    guint32 id)
+{
+  const unsigned char payload_type = GST_IPC_PIPELINE_COMM_DATA_TYPE_RELEASE;
+  GstByteWriter bw;
+
+  g_mutex_lock (&comm->mutex);
+
+  if (comm->fdout < 0)
+    goto done;
+
+  GST_TRACE_OBJECT (comm->element, "Writing RELEASE for %u", id);
+  gst_byte_writer_init (&bw);
+  if (!gst_byte_writer_put_uint8 (&bw, payload_type))
+    goto write_failed;
+  if (!gst_byte_writer_put_uint32_le (&bw, id))
+    goto write_failed;
+  if (!gst_byte_writer_put_uint32_le (&bw, 0))
+    goto write_failed;
+  if (!write_byte_writer_to_fd (comm, &bw))
+    goto write_failed;
+
+done:
+  g_mutex_unlock (&comm->mutex);
+  return;
+
+write_failed:
+  /* the other side may well be gone already, which is not an error */
+  GST_WARNING_OBJECT (comm->element, "Failed to write RELEASE for %u", id);
+  gst_byte_writer_reset (&bw);
+  goto done;
+}
+
+/* called when one of the memories we received as a fd is freed. We
+ * track memories rather than the buffer since they may outlive it,
+ * eg. when the buffer gets copied downstream. */
+static void
+shared_memory_freed (gpointer data, GstMiniObject * where_the_object_was)
+{
+  SharedMemoryRelease *release = data;
+
+  if (!g_atomic_int_dec_and_test (&release->n_memories))
+    return;
+
+  gst_ipc_pipeline_comm_write_release_to_fd (release->comm, release->id);
+  gst_object_unref (release->element);
+  g_free (release);
+}
+
+static GstBuffer *
+gst_ipc_pipeline_comm_read_fd_buffer (GstIpcPipelineComm * comm, guint32 size)
+{
+  GstBuffer *buffer;
+  CommBufferMetadata meta;
+  guint32 n_mem, n;
+  const guint8 *payload = NULL;
+  guint32 mapped_size;
+  SharedMemoryRelease *release;
+
+  /* this should not be called if we don't have enough yet */
+  g_return_val_if_fail (gst_adapter_available (comm->adapter) >= size, NULL);
+
+  mapped_size = sizeof (CommBufferMetadata) + sizeof (n_mem);
+  if (size < mapped_size)
+    return NULL;
+  payload = gst_adapter_map (comm->adapter, mapped_size);
+  if (!payload)
+    return NULL;
+  memcpy (&meta, payload, sizeof (CommBufferMetadata));
+  payload += sizeof (CommBufferMetadata);
+  memcpy (&n_mem, payload, sizeof (n_mem));
+  size -= mapped_size;
+  gst_adapter_unmap (comm->adapter);
+  gst_adapter_flush (comm->adapter, mapped_size);
+
+  buffer = gst_buffer_new ();
+  release = g_new0 (SharedMemoryRelease, 1);
+  release->element = gst_object_ref (comm->element);
+  release->comm = comm;
+  release->id = comm->id;
+  /* held until all memories are built, so that a failure half way through
+   * releases the buffer exactly once */
+  release->n_memories = 1;
+
+  for (n = 0; n < n_mem; ++n) {
+    guint8 kind;
+
+    if (size < 1)
+      goto bad_payload;
+    gst_adapter_copy (comm->adapter, &kind, 0, 1);
+    gst_adapter_flush (comm->adapter, 1);
+    size -= 1;
+
+    if (kind == COMM_MEMORY_KIND_INLINE) {
+      guint32 mem_size;
+
+      if (size < sizeof (mem_size))
+        goto bad_payload;
+      gst_adapter_copy (comm->adapter, &mem_size, 0, sizeof (mem_size));
+      gst_adapter_flush (comm->adapter, sizeof (mem_size));
+      size -= sizeof (mem_size);
+      if (size < mem_size)
+        goto bad_payload;
+      if (mem_size > 0) {
+        buffer = gst_buffer_append (buffer,
+            gst_adapter_take_buffer (comm->adapter, mem_size));
+        size -= mem_size;
+      }
+    } else if (kind == COMM_MEMORY_KIND_FD || kind == COMM_MEMORY_KIND_DMABUF) {
+      guint64 desc[3];          /* offset, size, maxsize */
+      GstAllocator *allocator;
+      GstMemory *mem;
+      int fd;
+
+      if (size < sizeof (desc))
+        goto bad_payload;
+      gst_adapter_copy (comm->adapter, desc, 0, sizeof (desc));
+      gst_adapter_flush (comm->adapter, sizeof (desc));
+      size -= sizeof (desc);
+
+      if (g_queue_is_empty (&comm->received_fds))
+        goto missing_fd;
+      fd = GPOINTER_TO_INT (g_queue_pop_head (&comm->received_fds));
+
+      if (desc[0] + desc[1] > desc[2]) {
+        close (fd);
+        goto bad_payload;
+      }
+
+      allocator = kind == COMM_MEMORY_KIND_DMABUF ?
+          comm->dmabuf_allocator : comm->fd_allocator;
+      mem = gst_fd_allocator_alloc (allocator, fd, desc[2],
+          GST_FD_MEMORY_FLAG_KEEP_MAPPED);
+      if (!mem) {
+        close (fd);
+        goto bad_payload;
+      }
+      gst_memory_resize (mem, desc[0], desc[1]);
+      g_atomic_int_inc (&release->n_memories);
+      gst_mini_object_weak_ref (GST_MINI_OBJECT_CAST (mem),
+          shared_memory_freed, release);
+      gst_buffer_append_memory (buffer, mem);
+    } else {
+      goto bad_payload;
+    }
+  }
+
+  /* drop the reference held while building */
+  shared_memory_freed (release, NULL);
+
+  GST_BUFFER_PTS (buffer) = meta.pts;
+  GST_BUFFER_DTS (buffer) = meta.dts;
+  GST_BUFFER_DURATION (buffer) = meta.duration;
+  GST_BUFFER_OFFSET (buffer) = meta.offset;
+  GST_BUFFER_OFFSET_END (buffer) = meta.offset_end;
+  GST_BUFFER_FLAGS (buffer) = meta.flags;
+
+  if (!gst_ipc_pipeline_comm_read_buffer_meta (comm, buffer, size)) {
+    gst_buffer_unref (buffer);
+    return NULL;
+  }
+
+  return buffer;
+
+bad_payload:
+  GST_ERROR_OBJECT (comm->element, "Invalid memory description in buffer");
+  goto failed;
+
+missing_fd:
+  GST_ERROR_OBJECT (comm->element, "Buffer refers to a fd we did not receive");
+  goto failed;
+
+failed:
+  gst_buffer_unref (buffer);
+  shared_memory_freed (release, NULL);
+  return NULL;
+}
+#endif
+
+static gboolean
+gst_ipc_pipeline_comm_read_buffer_meta (GstIpcPipelineComm * comm,
+    GstBuffer * buffer, guint32 size)
+{
+  guint32 n_meta, n;
+  const guint8 *payload = NULL;
+  guint32 mapped_size;
+
   /* If you don't call that, the GType isn't yet known at the
      g_type_from_name below */
   gst_protection_meta_get_info ();
+  gst_reference_timestamp_meta_get_info ();
 
+  if (size < sizeof (n_meta))
+    return FALSE;
   mapped_size = size;
   payload = gst_adapter_map (comm->adapter, mapped_size);
-  if (!payload) {
-    gst_buffer_unref (buffer);
-    return NULL;
-  }
+  if (!payload)
+    return FALSE;
   memcpy (&n_meta, payload, sizeof (n_meta));
   payload += sizeof (n_meta);
 
@@ -718,7 +1159,7 @@ gst_ipc_pipeline_comm_read_buffer (GstIpcPipelineComm * comm, guint32 size)
     READ_FIELD (len);
     if (len) {
       structure = gst_structure_new_from_string ((const char *) payload);
-      payload += len + 1;
+      payload += len;
     }
 
     /* Seems we can add a meta from the api nor type ? */
@@ -726,6 +1167,21 @@ gst_ipc_pipeline_comm_read_buffer (GstIpcPipelineComm * comm, guint32 size)
       meta =
           gst_buffer_add_meta (buffer, gst_protection_meta_get_info (), NULL);
       ((GstProtectionMeta *) meta)->info = structure;
+    } else if (api == GST_REFERENCE_TIMESTAMP_META_API_TYPE && structure) {
+      GstCaps *reference = NULL;
+      guint64 timestamp = GST_CLOCK_TIME_NONE, duration = GST_CLOCK_TIME_NONE;
+
+      gst_structure_get (structure, "reference", GST_TYPE_CAPS, &reference,
+          "timestamp", G_TYPE_UINT64, &timestamp,
+          "duration", G_TYPE_UINT64, &duration, NULL);
+      if (reference) {
+        gst_buffer_add_reference_timestamp_meta (buffer, reference, timestamp,
+            duration);
+        gst_caps_unref (reference);
+      } else {
+        GST_WARNING_OBJECT (comm->element, "Invalid reference timestamp meta");
+      }
+      gst_structure_free (structure);
     } else {
       GST_WARNING_OBJECT (comm->element, "Unsupported meta: %s",
           g_type_name (api));
@@ -740,7 +1196,7 @@ gst_ipc_pipeline_comm_read_buffer (GstIpcPipelineComm * comm, guint32 size)
   gst_adapter_unmap (comm->adapter);
   gst_adapter_flush (comm->adapter, mapped_size);
 
-  return buffer;
+  return TRUE;
 }
 
 static gboolean
@@ -1630,11 +2086,24 @@ gst_ipc_pipeline_comm_init (GstIpcPipelineComm * comm, GstElement * element)
   comm->adapter = gst_adapter_new ();
   comm->poll = gst_poll_new (TRUE);
   gst_poll_fd_init (&comm->pollFDin);
+  g_queue_init (&comm->received_fds);
+  comm->shared_buffers =
+      g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+      (GDestroyNotify) gst_buffer_unref);
+  comm->fd_allocator = gst_fd_allocator_new ();
+  comm->dmabuf_allocator = gst_dmabuf_allocator_new ();
 }
 
 void
 gst_ipc_pipeline_comm_clear (GstIpcPipelineComm * comm)
 {
+#ifdef HAVE_FD_PASSING
+  while (!g_queue_is_empty (&comm->received_fds))
+    close (GPOINTER_TO_INT (g_queue_pop_head (&comm->received_fds)));
+#endif
+  g_hash_table_destroy (comm->shared_buffers);
+  gst_object_unref (comm->fd_allocator);
+  gst_object_unref (comm->dmabuf_allocator);
   g_hash_table_destroy (comm->waiting_ids);
   gst_object_unref (comm->adapter);
   gst_poll_free (comm->poll);
@@ -1675,6 +2144,7 @@ gst_ipc_pipeline_comm_cancel (GstIpcPipelineComm * comm, gboolean cleanup)
     comm->waiting_ids =
         g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
         (GDestroyNotify) comm_request_free);
+    g_hash_table_remove_all (comm->shared_buffers);
   }
   g_mutex_unlock (&comm->mutex);
 }
@@ -1722,6 +2192,57 @@ gst_ipc_pipeline_comm_reply_request (GstIpcPipelineComm * comm, guint32 id,
   return TRUE;
 }
 
+#ifdef HAVE_FD_PASSING
+/* reads data, queueing any fds that were passed along with it. These are
+ * picked up in order by the FD_BUFFER chunks that refer to them. */
+static ssize_t
+read_with_fds (GstIpcPipelineComm * comm, void *data, size_t size)
+{
+  union
+  {
+    char buf[CMSG_SPACE (sizeof (int) * MAX_PASSED_FDS)];
+    struct cmsghdr align;
+  } control;
+  struct msghdr msg = { 0, };
+  struct cmsghdr *cmsg;
+  struct iovec iov;
+  int flags = 0;
+  ssize_t sz;
+
+  iov.iov_base = data;
+  iov.iov_len = size;
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof (control.buf);
+
+#ifdef MSG_CMSG_CLOEXEC
+  flags |= MSG_CMSG_CLOEXEC;
+#endif
+  sz = recvmsg (comm->pollFDin.fd, &msg, flags);
+  if (sz < 0)
+    return sz;
+
+  if (msg.msg_flags & MSG_CTRUNC)
+    GST_WARNING_OBJECT (comm->element, "Some passed fds were dropped");
+
+  for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+    const int *fds;
+    guint n, n_fds;
+
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+      continue;
+    fds = (const int *) CMSG_DATA (cmsg);
+    n_fds = (cmsg->cmsg_len - CMSG_LEN (0)) / sizeof (int);
+    for (n = 0; n < n_fds; ++n)
+      g_queue_push_tail (&comm->received_fds, GINT_TO_POINTER (fds[n]));
+    GST_TRACE_OBJECT (comm->element, "Received %u fds", n_fds);
+  }
+
+  return sz;
+}
+#endif
+
 static gint
 update_adapter (GstIpcPipelineComm * comm)
 {
@@ -1749,6 +2270,9 @@ again:
       comm->pollFDin.fd = comm->fdin;
       gst_poll_add_fd (comm->poll, &comm->pollFDin);
       gst_poll_fd_ctl_read (comm->poll, &comm->pollFDin, TRUE);
+#ifdef HAVE_FD_PASSING
+      comm->fdin_is_socket = fd_is_unix_socket (comm->fdin);
+#endif
     }
   }
 
@@ -1778,6 +2302,11 @@ again:
         errno = last_error;
       }
     }
+#elif defined (HAVE_FD_PASSING)
+    if (comm->fdin_is_socket)
+      sz = read_with_fds (comm, map.data, map.size);
+    else
+      sz = read (comm->pollFDin.fd, map.data, map.size);
 #else
     sz = read (comm->pollFDin.fd, map.data, map.size);
 #endif
@@ -1845,6 +2374,10 @@ read_many (GstIpcPipelineComm * comm)
           case GST_IPC_PIPELINE_COMM_DATA_TYPE_STATE_LOST:
           case GST_IPC_PIPELINE_COMM_DATA_TYPE_MESSAGE:
           case GST_IPC_PIPELINE_COMM_DATA_TYPE_GERROR_MESSAGE:
+#ifdef HAVE_FD_PASSING
+          case GST_IPC_PIPELINE_COMM_DATA_TYPE_FD_BUFFER:
+          case GST_IPC_PIPELINE_COMM_DATA_TYPE_RELEASE:
+#endif
             GST_TRACE_OBJECT (comm->element, "switching to state %s",
                 gst_ipc_pipeline_comm_data_type_get_name (type));
             comm->state = type;
@@ -1909,6 +2442,9 @@ read_many (GstIpcPipelineComm * comm)
         break;
       }
       case GST_IPC_PIPELINE_COMM_DATA_TYPE_BUFFER:
+#ifdef HAVE_FD_PASSING
+      case GST_IPC_PIPELINE_COMM_DATA_TYPE_FD_BUFFER:
+#endif
       {
         GstBuffer *buf;
 
@@ -1916,7 +2452,13 @@ read_many (GstIpcPipelineComm * comm)
         if (available < comm->payload_length)
           goto done;
 
-        buf = gst_ipc_pipeline_comm_read_buffer (comm, comm->payload_length);
+#ifdef HAVE_FD_PASSING
+        if (comm->state == GST_IPC_PIPELINE_COMM_DATA_TYPE_FD_BUFFER)
+          buf = gst_ipc_pipeline_comm_read_fd_buffer (comm,
+              comm->payload_length);
+        else
+#endif
+          buf = gst_ipc_pipeline_comm_read_buffer (comm, comm->payload_length);
         if (!buf)
           goto buffer_failed;
 
@@ -2046,6 +2588,25 @@ read_many (GstIpcPipelineComm * comm)
         comm->state = GST_IPC_PIPELINE_COMM_STATE_TYPE;
         break;
       }
+#ifdef HAVE_FD_PASSING
+      case GST_IPC_PIPELINE_COMM_DATA_TYPE_RELEASE:
+      {
+        available = gst_adapter_available (comm->adapter);
+        if (available < comm->payload_length)
+          goto done;
+        gst_adapter_flush (comm->adapter, comm->payload_length);
+
+        GST_TRACE_OBJECT (comm->element, "Got RELEASE for id %u", comm->id);
+
+        g_mutex_lock (&comm->mutex);
+        g_hash_table_remove (comm->shared_buffers, GINT_TO_POINTER (comm->id));
+        g_mutex_unlock (&comm->mutex);
+
+        GST_TRACE_OBJECT (comm->element, "switching to state TYPE");
+        comm->state = GST_IPC_PIPELINE_COMM_STATE_TYPE;
+        break;
+      }
+#endif
       case GST_IPC_PIPELINE_COMM_DATA_TYPE_STATE_LOST:
       {
         available = gst_adapter_available (comm->adapter);
@@ -51,6 +51,8 @@ typedef enum {
   GST_IPC_PIPELINE_COMM_DATA_TYPE_STATE_LOST,
   GST_IPC_PIPELINE_COMM_DATA_TYPE_MESSAGE,
   GST_IPC_PIPELINE_COMM_DATA_TYPE_GERROR_MESSAGE,
+  GST_IPC_PIPELINE_COMM_DATA_TYPE_FD_BUFFER,
+  GST_IPC_PIPELINE_COMM_DATA_TYPE_RELEASE,
 } GstIpcPipelineCommDataType;
 
 typedef struct
@@ -76,6 +78,15 @@ typedef struct
   guint read_chunk_size;
   GstClockTime ack_time;
 
+  /* fd backed memory is passed as fds over a unix socket */
+  gboolean fd_passing;
+  gboolean fdin_is_socket;
+  GQueue received_fds;
+  /* buffers whose memory the other side still uses, by id */
+  GHashTable *shared_buffers;
+  GstAllocator *fd_allocator;
+  GstAllocator *dmabuf_allocator;
+
   void (*on_buffer) (guint32, GstBuffer *, gpointer);
   void (*on_event) (guint32, GstEvent *, gboolean, gpointer);
   void (*on_query) (guint32, GstQuery *, gboolean, gpointer);
@@ -115,6 +126,8 @@ void gst_ipc_pipeline_comm_write_state_lost_to_fd (GstIpcPipelineComm * comm);
 gboolean gst_ipc_pipeline_comm_write_message_to_fd (GstIpcPipelineComm * comm,
     GstMessage *message);
 
+gboolean gst_ipc_pipeline_comm_can_pass_fds (GstIpcPipelineComm * comm);
+
 gboolean gst_ipc_pipeline_comm_start_reader_thread (GstIpcPipelineComm * comm,
     void (*on_buffer) (guint32, GstBuffer *, gpointer),
     void (*on_event) (guint32, GstEvent *, gboolean, gpointer),
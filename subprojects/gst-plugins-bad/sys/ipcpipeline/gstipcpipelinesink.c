@@ -66,7 +66,12 @@
  * GError are serialized differently).
  *
  * Buffers are transported by writing their content directly on the socket.
- * More efficient ways for memory sharing could be implemented in the future.
+ * If #GstIpcPipelineSink:fd-passing is enabled and the socket is a unix
+ * domain socket, memory backed by a file descriptor (dmabuf, memfd...) is
+ * instead handed over to the other process by passing its file descriptor,
+ * and only the buffer metadata is written on the socket. In that mode, the
+ * element answers ALLOCATION queries with a memfd based allocator, so that
+ * upstream elements produce memory that can be shared this way.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -75,6 +80,7 @@
 
 #include "gstipcpipelineelements.h"
 #include "gstipcpipelinesink.h"
+#include "gstipcpipelineallocator.h"
 
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
@@ -99,11 +105,13 @@ enum
   PROP_FDOUT,
   PROP_READ_CHUNK_SIZE,
   PROP_ACK_TIME,
+  PROP_FD_PASSING,
 };
 
 
 #define DEFAULT_READ_CHUNK_SIZE 4096
 #define DEFAULT_ACK_TIME (10 * G_TIME_SPAN_SECOND)
+#define DEFAULT_FD_PASSING FALSE
 
 #define _do_init \
     GST_DEBUG_CATEGORY_INIT (gst_ipc_pipeline_sink_debug, "ipcpipelinesink", 0, "ipcpipelinesink element");
@@ -178,6 +186,20 @@ gst_ipc_pipeline_sink_class_init (GstIpcPipelineSinkClass * klass)
           "Maximum time to wait for a response to a message",
           0, G_MAXUINT64, DEFAULT_ACK_TIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstIpcPipelineSink:fd-passing:
+   *
+   * Pass file descriptor backed memory (dmabuf, memfd...) to the other
+   * process as file descriptors instead of copying its contents on the
+   * socket. This requires fdout to be a unix domain socket. Other memory
+   * is still written on the socket.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_FD_PASSING,
+      g_param_spec_boolean ("fd-passing", "FD passing",
+          "Pass fd backed memory as file descriptors on unix sockets",
+          DEFAULT_FD_PASSING, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gst_ipc_pipeline_sink_signals[SIGNAL_DISCONNECT] =
       g_signal_new ("disconnect",
@@ -216,6 +238,7 @@ gst_ipc_pipeline_sink_init (GstIpcPipelineSink * sink)
   sink->comm.ack_time = DEFAULT_ACK_TIME;
   sink->comm.fdin = -1;
   sink->comm.fdout = -1;
+  sink->comm.fd_passing = DEFAULT_FD_PASSING;
   sink->threads = g_thread_pool_new (pusher, sink, -1, FALSE, NULL);
   gst_ipc_pipeline_sink_start_reader_thread (sink);
 
@@ -252,6 +275,8 @@ gst_ipc_pipeline_sink_finalize (GObject * obj)
 
   gst_ipc_pipeline_comm_clear (&sink->comm);
   g_thread_pool_free (sink->threads, TRUE, TRUE);
+  if (sink->allocator)
+    gst_object_unref (sink->allocator);
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -275,6 +300,9 @@ gst_ipc_pipeline_sink_set_property (GObject * object, guint prop_id,
     case PROP_ACK_TIME:
       sink->comm.ack_time = g_value_get_uint64 (value);
       break;
+    case PROP_FD_PASSING:
+      sink->comm.fd_passing = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -300,6 +328,9 @@ gst_ipc_pipeline_sink_get_property (GObject * object, guint prop_id,
     case PROP_ACK_TIME:
       g_value_set_uint64 (value, sink->comm.ack_time);
       break;
+    case PROP_FD_PASSING:
+      g_value_set_boolean (value, sink->comm.fd_passing);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -348,6 +379,17 @@ gst_ipc_pipeline_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
 
   switch (GST_QUERY_TYPE (query)) {
     case GST_QUERY_ALLOCATION:
+#ifdef HAVE_MEMFD_CREATE
+      if (gst_ipc_pipeline_comm_can_pass_fds (&sink->comm)) {
+        GST_DEBUG_OBJECT (sink, "Proposing memfd allocator");
+        GST_OBJECT_LOCK (sink);
+        if (!sink->allocator)
+          sink->allocator = gst_ipc_pipeline_allocator_new ();
+        GST_OBJECT_UNLOCK (sink);
+        gst_query_add_allocation_param (query, sink->allocator, NULL);
+        return TRUE;
+      }
+#endif
       GST_DEBUG_OBJECT (sink, "Rejecting ALLOCATION query");
       return FALSE;
     case GST_QUERY_CAPS:
@@ -32,6 +32,7 @@
 #include <xf86drmMode.h>
 #include <stdlib.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 /* it needs to be below because is internal to libdrm */
@@ -51,6 +52,9 @@ GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
 #define GST_KMS_MEMORY_TYPE "KMSMemory"
 
+/* number of framebuffers kept for imported dmabufs */
+#define FB_CACHE_SIZE 32
+
 struct kms_bo
 {
   void *ptr;
@@ -65,6 +69,11 @@ struct _GstKMSAllocatorPrivate
   /* protected by GstKMSAllocator object lock */
   GList *mem_cache;
   GstAllocator *dmabuf_alloc;
+
+  /* dmabuf identity -> GstKMSMemory, the queue holds the keys with the least
+   * recently used first. Protected by GstKMSAllocator object lock */
+  GHashTable *fb_cache;
+  GQueue fb_cache_lru;
 };
 
 #define parent_class gst_kms_allocator_parent_class
@@ -284,6 +293,7 @@ gst_kms_allocator_finalize (GObject * obj)
   alloc = GST_KMS_ALLOCATOR (obj);
 
   gst_kms_allocator_clear_cache (GST_ALLOCATOR (alloc));
+  g_hash_table_unref (alloc->priv->fb_cache);
 
   if (alloc->priv->dmabuf_alloc)
     gst_object_unref (alloc->priv->dmabuf_alloc);
@@ -389,6 +399,9 @@ gst_kms_allocator_init (GstKMSAllocator * allocator)
 
   allocator->priv = gst_kms_allocator_get_instance_private (allocator);
   allocator->priv->fd = -1;
+  allocator->priv->fb_cache = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, (GDestroyNotify) gst_memory_unref);
+  g_queue_init (&allocator->priv->fb_cache_lru);
 
   alloc->mem_type = GST_KMS_MEMORY_TYPE;
   alloc->mem_map = gst_kms_memory_map;
@@ -487,6 +500,75 @@ fail:
   return NULL;
 }
 
+/* Upstream elements may wrap the same dmabuf in a new GstMemory for each
+ * frame, so the framebuffers are also looked up by the identity of the
+ * underlying dmabufs and the layout of the frame. */
+static gchar *
+gst_kms_allocator_fb_cache_key (gint * prime_fds, gint n_planes,
+    gsize offsets[GST_VIDEO_MAX_PLANES], GstVideoInfo * vinfo)
+{
+  GString *key;
+  struct stat st;
+  gint i;
+
+  key = g_string_new (NULL);
+  g_string_append_printf (key, "%s:%ux%u",
+      GST_VIDEO_INFO_NAME (vinfo), GST_VIDEO_INFO_WIDTH (vinfo),
+      GST_VIDEO_INFO_HEIGHT (vinfo));
+
+  for (i = 0; i < n_planes; i++) {
+    if (fstat (prime_fds[i], &st) < 0) {
+      g_string_free (key, TRUE);
+      return NULL;
+    }
+
+    g_string_append_printf (key, "/%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT
+        ":%" G_GSIZE_FORMAT ":%d", (guint64) st.st_dev, (guint64) st.st_ino,
+        offsets[i], GST_VIDEO_INFO_PLANE_STRIDE (vinfo, i));
+  }
+
+  return g_string_free (key, FALSE);
+}
+
+static GstKMSMemory *
+gst_kms_allocator_fb_cache_lookup (GstKMSAllocator * alloc, const gchar * key)
+{
+  GstKMSMemory *kmsmem;
+  GList *link;
+
+  GST_OBJECT_LOCK (alloc);
+  kmsmem = g_hash_table_lookup (alloc->priv->fb_cache, key);
+  if (kmsmem) {
+    link = g_queue_find_custom (&alloc->priv->fb_cache_lru, key,
+        (GCompareFunc) g_strcmp0);
+    g_queue_unlink (&alloc->priv->fb_cache_lru, link);
+    g_queue_push_tail_link (&alloc->priv->fb_cache_lru, link);
+    gst_memory_ref (GST_MEMORY_CAST (kmsmem));
+  }
+  GST_OBJECT_UNLOCK (alloc);
+
+  return kmsmem;
+}
+
+/* @key is transfer-full */
+static void
+gst_kms_allocator_fb_cache_insert (GstKMSAllocator * alloc, gchar * key,
+    GstKMSMemory * kmsmem)
+{
+  GST_OBJECT_LOCK (alloc);
+  if (g_hash_table_size (alloc->priv->fb_cache) >= FB_CACHE_SIZE) {
+    gchar *old = g_queue_pop_head (&alloc->priv->fb_cache_lru);
+
+    GST_DEBUG_OBJECT (alloc, "evicting framebuffer of %s", old);
+    g_hash_table_remove (alloc->priv->fb_cache, old);
+  }
+
+  g_queue_push_tail (&alloc->priv->fb_cache_lru, key);
+  g_hash_table_insert (alloc->priv->fb_cache, key,
+      gst_memory_ref (GST_MEMORY_CAST (kmsmem)));
+  GST_OBJECT_UNLOCK (alloc);
+}
+
 GstKMSMemory *
 gst_kms_allocator_dmabuf_import (GstAllocator * allocator, gint * prime_fds,
     gint n_planes, gsize offsets[GST_VIDEO_MAX_PLANES], GstVideoInfo * vinfo)
@@ -494,10 +576,23 @@ gst_kms_allocator_dmabuf_import (GstAllocator * allocator, gint * prime_fds,
   GstKMSAllocator *alloc;
   GstKMSMemory *kmsmem;
   GstMemory *mem;
+  gchar *key;
   gint i, ret;
 
   g_return_val_if_fail (n_planes <= GST_VIDEO_MAX_PLANES, FALSE);
 
+  alloc = GST_KMS_ALLOCATOR (allocator);
+
+  key = gst_kms_allocator_fb_cache_key (prime_fds, n_planes, offsets, vinfo);
+  if (key) {
+    kmsmem = gst_kms_allocator_fb_cache_lookup (alloc, key);
+    if (kmsmem) {
+      GST_LOG_OBJECT (alloc, "reusing fb id %d for %s", kmsmem->fb_id, key);
+      g_free (key);
+      return kmsmem;
+    }
+  }
+
   kmsmem = g_slice_new0 (GstKMSMemory);
   if (!kmsmem)
     return FALSE;
@@ -506,7 +601,6 @@ gst_kms_allocator_dmabuf_import (GstAllocator * allocator, gint * prime_fds,
   gst_memory_init (mem, GST_MEMORY_FLAG_NO_SHARE, allocator, NULL,
       GST_VIDEO_INFO_SIZE (vinfo), 0, 0, GST_VIDEO_INFO_SIZE (vinfo));
 
-  alloc = GST_KMS_ALLOCATOR (allocator);
   for (i = 0; i < n_planes; i++) {
     ret = drmPrimeFDToHandle (alloc->priv->fd, prime_fds[i],
         &kmsmem->gem_handle[i]);
@@ -529,6 +623,9 @@ gst_kms_allocator_dmabuf_import (GstAllocator * allocator, gint * prime_fds,
     kmsmem->gem_handle[i] = 0;
   }
 
+  if (key)
+    gst_kms_allocator_fb_cache_insert (alloc, key, kmsmem);
+
   return kmsmem;
 
   /* ERRORS */
@@ -541,6 +638,7 @@ import_fd_failed:
 
 failed:
   {
+    g_free (key);
     gst_memory_unref (mem);
     return NULL;
   }
@@ -625,6 +723,10 @@ gst_kms_allocator_clear_cache (GstAllocator * allocator)
   g_list_free (alloc->priv->mem_cache);
   alloc->priv->mem_cache = NULL;
 
+  /* the keys are owned by the hash table */
+  g_queue_clear (&alloc->priv->fb_cache_lru);
+  g_hash_table_remove_all (alloc->priv->fb_cache);
+
   GST_OBJECT_UNLOCK (alloc);
 }
 
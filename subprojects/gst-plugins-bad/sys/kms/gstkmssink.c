@@ -41,6 +41,23 @@
  * gst-launch-1.0 videotestsrc ! kmssink plane-properties=s,rotation=4
  * ]|
  *
+ * ## Atomic modesetting
+ *
+ * When the #kmssink:atomic property is set and the driver supports it, the
+ * plane is updated with non-blocking atomic commits. The out fence of each
+ * commit is waited for before the next one, so the streaming thread does
+ * not block on the page flip of the frame it just queued.
+ *
+ * In this mode, all the kmssink instances of a process driving the same
+ * device share a single DRM file descriptor, and each automatically picks
+ * an overlay plane that no other instance uses. This allows scanning out
+ * several video streams at once without any composition, for instance:
+ *
+ * |[
+ * gst-launch-1.0 videotestsrc ! kmssink atomic=true render-rectangle="<0,0,640,480>" \
+ *     videotestsrc pattern=ball ! kmssink atomic=true render-rectangle="<640,0,640,480>"
+ * ]|
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -56,6 +73,7 @@
 #include <xf86drmMode.h>
 #include <drm_fourcc.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "gstkmssink.h"
 #include "gstkmsutils.h"
@@ -97,11 +115,94 @@ enum
   PROP_DISPLAY_HEIGHT,
   PROP_CONNECTOR_PROPS,
   PROP_PLANE_PROPS,
+  PROP_ATOMIC,
   PROP_N,
 };
 
 static GParamSpec *g_properties[PROP_N] = { NULL, };
 
+/* In atomic mode, only the DRM master can commit, so the sinks driving the
+ * same device share its file descriptor and keep track of the planes each
+ * of them uses. */
+struct _GstKMSDevice
+{
+  gchar *name;
+  gint fd;
+  guint refcount;
+  GList *planes;
+};
+
+G_LOCK_DEFINE_STATIC (devices);
+static GList *devices = NULL;
+
+/* Takes ownership of @fd, which is closed if the device is already open */
+static GstKMSDevice *
+gst_kms_device_acquire (const gchar * name, gint fd)
+{
+  GstKMSDevice *device = NULL;
+  GList *l;
+
+  G_LOCK (devices);
+  for (l = devices; l; l = l->next) {
+    if (g_strcmp0 (((GstKMSDevice *) l->data)->name, name) == 0) {
+      device = l->data;
+      break;
+    }
+  }
+
+  if (device) {
+    drmClose (fd);
+    device->refcount++;
+  } else {
+    device = g_new0 (GstKMSDevice, 1);
+    device->name = g_strdup (name);
+    device->fd = fd;
+    device->refcount = 1;
+    devices = g_list_prepend (devices, device);
+  }
+  G_UNLOCK (devices);
+
+  return device;
+}
+
+static void
+gst_kms_device_release (GstKMSDevice * device)
+{
+  G_LOCK (devices);
+  if (--device->refcount == 0) {
+    devices = g_list_remove (devices, device);
+    drmClose (device->fd);
+    g_list_free (device->planes);
+    g_free (device->name);
+    g_free (device);
+  }
+  G_UNLOCK (devices);
+}
+
+static gboolean
+gst_kms_device_claim_plane (GstKMSDevice * device, guint32 plane_id)
+{
+  gboolean ret = FALSE;
+
+  G_LOCK (devices);
+  if (!g_list_find (device->planes, GUINT_TO_POINTER (plane_id))) {
+    device->planes = g_list_prepend (device->planes,
+        GUINT_TO_POINTER (plane_id));
+    ret = TRUE;
+  }
+  G_UNLOCK (devices);
+
+  return ret;
+}
+
+static void
+gst_kms_device_release_plane (GstKMSDevice * device, guint32 plane_id)
+{
+  G_LOCK (devices);
+  device->planes = g_list_remove (device->planes, GUINT_TO_POINTER (plane_id));
+  G_UNLOCK (devices);
+}
+
 static void
 gst_kms_sink_set_render_rectangle (GstVideoOverlay * overlay,
     gint x, gint y, gint width, gint height)
@@ -223,6 +324,65 @@ find_plane_for_crtc (int fd, drmModeRes * res, drmModePlaneRes * pres,
   return NULL;
 }
 
+static gboolean
+find_property (int fd, guint32 obj_id, guint32 obj_type, const gchar * name,
+    guint32 * prop_id, guint64 * value)
+{
+  drmModeObjectPropertiesPtr props;
+  drmModePropertyPtr prop;
+  gboolean ret = FALSE;
+  guint i;
+
+  props = drmModeObjectGetProperties (fd, obj_id, obj_type);
+  if (!props)
+    return FALSE;
+
+  for (i = 0; i < props->count_props && !ret; i++) {
+    prop = drmModeGetProperty (fd, props->props[i]);
+    if (!prop)
+      continue;
+
+    if (!strcmp (prop->name, name)) {
+      if (prop_id)
+        *prop_id = prop->prop_id;
+      if (value)
+        *value = props->prop_values[i];
+      ret = TRUE;
+    }
+    drmModeFreeProperty (prop);
+  }
+
+  drmModeFreeObjectProperties (props);
+
+  return ret;
+}
+
+/* Picks the first overlay plane of the crtc that no other sink uses */
+static drmModePlane *
+find_free_overlay_plane (GstKMSSink * self, drmModePlaneRes * pres)
+{
+  drmModePlane *plane;
+  guint64 type;
+  int i;
+
+  for (i = 0; i < pres->count_planes; i++) {
+    plane = drmModeGetPlane (self->fd, pres->planes[i]);
+    if (!plane)
+      continue;
+
+    if ((plane->possible_crtcs & (1 << self->pipe)) &&
+        find_property (self->fd, plane->plane_id, DRM_MODE_OBJECT_PLANE,
+            "type", NULL, &type) && type == DRM_PLANE_TYPE_OVERLAY &&
+        gst_kms_device_claim_plane (self->device, plane->plane_id)) {
+      self->claimed_plane_id = plane->plane_id;
+      return plane;
+    }
+    drmModeFreePlane (plane);
+  }
+
+  return NULL;
+}
+
 static drmModeCrtc *
 find_crtc_for_connector (int fd, drmModeRes * res, drmModeConnector * conn,
     guint * pipe)
@@ -708,6 +868,151 @@ gst_kms_sink_update_plane_properties (GstKMSSink * self)
   gst_kms_sink_update_properties (&iter, self->plane_props);
 }
 
+static void
+gst_kms_sink_enable_atomic (GstKMSSink * self)
+{
+  if (drmSetClientCap (self->fd, DRM_CLIENT_CAP_ATOMIC, 1)) {
+    GST_WARNING_OBJECT (self, "driver does not support atomic modesetting");
+    return;
+  }
+
+  self->device = gst_kms_device_acquire (self->bus_id ? self->bus_id :
+      self->devname, self->fd);
+  self->fd = self->device->fd;
+  self->has_atomic = TRUE;
+}
+
+static gboolean
+gst_kms_sink_get_atomic_props (GstKMSSink * self)
+{
+  static const gchar *plane_props[GST_KMS_PLANE_PROP_N] = {
+    "FB_ID", "CRTC_ID", "SRC_X", "SRC_Y", "SRC_W", "SRC_H",
+    "CRTC_X", "CRTC_Y", "CRTC_W", "CRTC_H",
+  };
+  guint i;
+
+  for (i = 0; i < GST_KMS_PLANE_PROP_N; i++) {
+    if (!find_property (self->fd, self->plane_id, DRM_MODE_OBJECT_PLANE,
+            plane_props[i], &self->plane_prop_ids[i], NULL)) {
+      GST_WARNING_OBJECT (self, "plane has no %s property", plane_props[i]);
+      return FALSE;
+    }
+  }
+
+  /* without out fence, commits block until the flip is done */
+  self->out_fence_prop_id = 0;
+  if (!find_property (self->fd, self->crtc_id, DRM_MODE_OBJECT_CRTC,
+          "OUT_FENCE_PTR", &self->out_fence_prop_id, NULL))
+    GST_INFO_OBJECT (self, "crtc has no out fence support");
+
+  return TRUE;
+}
+
+/* Waits until the last commit is on screen, after which the buffer it
+ * replaced is not scanned out anymore */
+static void
+gst_kms_sink_wait_fence (GstKMSSink * self)
+{
+  GPollFD pfd;
+  gint ret;
+
+  if (self->out_fence >= 0) {
+    pfd.fd = self->out_fence;
+    pfd.events = G_IO_IN;
+    pfd.revents = 0;
+
+    do {
+      ret = g_poll (&pfd, 1, 3000);
+    } while (ret == -1 && (errno == EAGAIN || errno == EINTR));
+
+    if (ret <= 0)
+      GST_WARNING_OBJECT (self, "out fence was not signalled: %s",
+          ret == 0 ? "timeout" : g_strerror (errno));
+
+    close (self->out_fence);
+    self->out_fence = -1;
+  }
+
+  gst_buffer_replace (&self->prev_buffer, NULL);
+}
+
+/* Shows @fb_id on the plane, or disables the plane if @fb_id is 0 */
+static gint
+gst_kms_sink_atomic_commit (GstKMSSink * self, guint32 fb_id,
+    GstVideoRectangle * dst, GstVideoRectangle * src)
+{
+  drmModeAtomicReq *req;
+  guint32 *ids = self->plane_prop_ids;
+  guint32 flags = 0;
+  gint ret;
+
+  gst_kms_sink_wait_fence (self);
+
+  req = drmModeAtomicAlloc ();
+  if (!req)
+    return -1;
+
+  drmModeAtomicAddProperty (req, self->plane_id,
+      ids[GST_KMS_PLANE_PROP_FB_ID], fb_id);
+  drmModeAtomicAddProperty (req, self->plane_id,
+      ids[GST_KMS_PLANE_PROP_CRTC_ID], fb_id ? self->crtc_id : 0);
+
+  if (fb_id) {
+    /* source coordinates are given in Q16 */
+    drmModeAtomicAddProperty (req, self->plane_id,
+        ids[GST_KMS_PLANE_PROP_SRC_X], (guint64) src->x << 16);
+    drmModeAtomicAddProperty (req, self->plane_id,
+        ids[GST_KMS_PLANE_PROP_SRC_Y], (guint64) src->y << 16);
+    drmModeAtomicAddProperty (req, self->plane_id,
+        ids[GST_KMS_PLANE_PROP_SRC_W], (guint64) src->w << 16);
+    drmModeAtomicAddProperty (req, self->plane_id,
+        ids[GST_KMS_PLANE_PROP_SRC_H], (guint64) src->h << 16);
+    drmModeAtomicAddProperty (req, self->plane_id,
+        ids[GST_KMS_PLANE_PROP_CRTC_X], dst->x);
+    drmModeAtomicAddProperty (req, self->plane_id,
+        ids[GST_KMS_PLANE_PROP_CRTC_Y], dst->y);
+    drmModeAtomicAddProperty (req, self->plane_id,
+        ids[GST_KMS_PLANE_PROP_CRTC_W], dst->w);
+    drmModeAtomicAddProperty (req, self->plane_id,
+        ids[GST_KMS_PLANE_PROP_CRTC_H], dst->h);
+  }
+
+  if (self->out_fence_prop_id) {
+    drmModeAtomicAddProperty (req, self->crtc_id, self->out_fence_prop_id,
+        (guint64) (guintptr) & self->out_fence);
+    flags = DRM_MODE_ATOMIC_NONBLOCK;
+  }
+
+  ret = drmModeAtomicCommit (self->fd, req, flags, NULL);
+
+  /* another sink has a commit pending on the same crtc, wait for it */
+  if (ret && errno == EBUSY && flags) {
+    GST_DEBUG_OBJECT (self, "crtc busy, using a blocking commit");
+    ret = drmModeAtomicCommit (self->fd, req, 0, NULL);
+  }
+
+  drmModeAtomicFree (req);
+
+  return ret;
+}
+
+static void
+gst_kms_sink_close (GstKMSSink * self)
+{
+  if (self->device) {
+    if (self->claimed_plane_id)
+      gst_kms_device_release_plane (self->device, self->claimed_plane_id);
+    gst_kms_device_release (self->device);
+    self->device = NULL;
+  } else if (self->fd >= 0) {
+    drmClose (self->fd);
+  }
+
+  self->fd = -1;
+  self->claimed_plane_id = 0;
+  self->has_atomic = FALSE;
+}
+
 static gboolean
 gst_kms_sink_start (GstBaseSink * bsink)
 {
@@ -740,6 +1045,9 @@ gst_kms_sink_start (GstBaseSink * bsink)
   if (!get_drm_caps (self))
     goto bail;
 
+  if (self->atomic)
+    gst_kms_sink_enable_atomic (self);
+
   res = drmModeGetResources (self->fd);
   if (!res)
     goto resources_failed;
@@ -765,6 +1073,11 @@ gst_kms_sink_start (GstBaseSink * bsink)
     self->saved_crtc = (drmModeCrtc *) crtc;
   }
 
+  if (self->has_atomic && self->modesetting_enabled) {
+    GST_INFO_OBJECT (self, "atomic commits are only used for plane updates");
+    self->has_atomic = FALSE;
+  }
+
 retry_find_plane:
   if (universal_planes &&
       drmSetClientCap (self->fd, DRM_CLIENT_CAP_UNIVERSAL_PLANES, 1))
@@ -774,13 +1087,21 @@ retry_find_plane:
   if (!pres)
     goto plane_resources_failed;
 
-  if (self->plane_id == -1)
+  if (self->plane_id == -1 && self->has_atomic)
+    plane = find_free_overlay_plane (self, pres);
+  else if (self->plane_id == -1)
     plane = find_plane_for_crtc (self->fd, res, pres, crtc->crtc_id);
   else
     plane = drmModeGetPlane (self->fd, self->plane_id);
   if (!plane)
     goto plane_failed;
 
+  if (self->device && !self->claimed_plane_id) {
+    if (!gst_kms_device_claim_plane (self->device, plane->plane_id))
+      goto plane_busy;
+    self->claimed_plane_id = plane->plane_id;
+  }
+
   if (!ensure_allowed_caps (self, conn, plane, res))
     goto allowed_caps_failed;
 
@@ -791,6 +1112,11 @@ retry_find_plane:
   GST_INFO_OBJECT (self, "connector id = %d / crtc id = %d / plane id = %d",
       self->conn_id, self->crtc_id, self->plane_id);
 
+  if (self->has_atomic && !gst_kms_sink_get_atomic_props (self)) {
+    GST_WARNING_OBJECT (self, "falling back to legacy plane updates");
+    self->has_atomic = FALSE;
+  }
+
   GST_OBJECT_LOCK (self);
   self->hdisplay = crtc->mode.hdisplay;
   self->vdisplay = crtc->mode.vdisplay;
@@ -837,10 +1163,8 @@ bail:
   if (res)
     drmModeFreeResources (res);
 
-  if (!ret && self->fd >= 0) {
-    drmClose (self->fd);
-    self->fd = -1;
-  }
+  if (!ret)
+    gst_kms_sink_close (self);
 
   return ret;
 
@@ -902,6 +1226,14 @@ plane_failed:
     }
   }
 
+plane_busy:
+  {
+    GST_ELEMENT_ERROR (self, RESOURCE, BUSY,
+        ("Plane %d is already used by another kmssink", plane->plane_id),
+        (NULL));
+    goto bail;
+  }
+
 allowed_caps_failed:
   {
     GST_ELEMENT_ERROR (self, RESOURCE, SETTINGS,
@@ -919,6 +1251,8 @@ gst_kms_sink_stop (GstBaseSink * bsink)
 
   self = GST_KMS_SINK (bsink);
 
+  gst_kms_sink_wait_fence (self);
+
   if (self->allocator)
     gst_kms_allocator_clear_cache (self->allocator);
 
@@ -944,10 +1278,7 @@ gst_kms_sink_stop (GstBaseSink * bsink)
     self->saved_crtc = NULL;
   }
 
-  if (self->fd >= 0) {
-    drmClose (self->fd);
-    self->fd = -1;
-  }
+  gst_kms_sink_close (self);
 
   GST_OBJECT_LOCK (bsink);
   self->hdisplay = 0;
@@ -1649,6 +1980,10 @@ retry_set_plane:
 
   if (result.w <= 0 || result.h <= 0) {
     GST_WARNING_OBJECT (self, "video is out of display range");
+    /* the buffers are only kept until the next commit is on screen */
+    if (self->has_atomic && gst_kms_sink_atomic_commit (self, 0, NULL, NULL))
+      GST_WARNING_OBJECT (self, "failed to disable plane: %s",
+          g_strerror (errno));
     goto sync_frame;
   }
 
@@ -1659,13 +1994,18 @@ retry_set_plane:
   }
 
   GST_TRACE_OBJECT (self,
-      "drmModeSetPlane at (%i,%i) %ix%i sourcing at (%i,%i) %ix%i",
+      "%s at (%i,%i) %ix%i sourcing at (%i,%i) %ix%i",
+      self->has_atomic ? "drmModeAtomicCommit" : "drmModeSetPlane",
       result.x, result.y, result.w, result.h, src.x, src.y, src.w, src.h);
 
-  ret = drmModeSetPlane (self->fd, self->plane_id, self->crtc_id, fb_id, 0,
-      result.x, result.y, result.w, result.h,
-      /* source/cropping coordinates are given in Q16 */
-      src.x << 16, src.y << 16, src.w << 16, src.h << 16);
+  if (self->has_atomic) {
+    ret = gst_kms_sink_atomic_commit (self, fb_id, &result, &src);
+  } else {
+    ret = drmModeSetPlane (self->fd, self->plane_id, self->crtc_id, fb_id, 0,
+        result.x, result.y, result.w, result.h,
+        /* source/cropping coordinates are given in Q16 */
+        src.x << 16, src.y << 16, src.w << 16, src.h << 16);
+  }
   if (ret) {
     if (self->can_scale) {
       self->can_scale = FALSE;
@@ -1675,14 +2015,18 @@ retry_set_plane:
   }
 
 sync_frame:
-  /* Wait for the previous frame to complete redraw */
-  if (!gst_kms_sink_sync (self)) {
+  /* Wait for the previous frame to complete redraw, atomic commits wait
+   * for the out fence of the previous one instead */
+  if (!self->has_atomic && !gst_kms_sink_sync (self)) {
     GST_OBJECT_UNLOCK (self);
     goto bail;
   }
 
   /* Save the rendered buffer and its metadata in case a redraw is needed */
   if (buffer != self->last_buffer) {
+    /* still on screen until the commit of this one completes */
+    if (self->has_atomic)
+      gst_buffer_replace (&self->prev_buffer, self->last_buffer);
     gst_buffer_replace (&self->last_buffer, buffer);
     self->last_width = GST_VIDEO_SINK_WIDTH (self);
     self->last_height = GST_VIDEO_SINK_HEIGHT (self);
@@ -1711,7 +2055,9 @@ set_plane_failed:
         result.w, result.h, src.x, src.y, src.w, src.h, dst.x, dst.y, dst.w,
         dst.h);
     GST_ELEMENT_ERROR (self, RESOURCE, FAILED,
-        (NULL), ("drmModeSetPlane failed: %s (%d)", g_strerror (errno), errno));
+        (NULL), ("%s failed: %s (%d)",
+            self->has_atomic ? "drmModeAtomicCommit" : "drmModeSetPlane",
+            g_strerror (errno), errno));
     goto bail;
   }
 no_disp_ratio:
@@ -1728,6 +2074,8 @@ gst_kms_sink_drain (GstKMSSink * self)
 {
   GstParentBufferMeta *parent_meta;
 
+  gst_kms_sink_wait_fence (self);
+
   if (!self->last_buffer)
     return;
 
@@ -1752,6 +2100,7 @@ gst_kms_sink_drain (GstKMSSink * self)
 
     gst_kms_allocator_clear_cache (self->allocator);
     gst_kms_sink_show_frame (GST_VIDEO_SINK (self), NULL);
+    gst_kms_sink_wait_fence (self);
     gst_buffer_unref (last_buf);
   }
 }
@@ -1827,6 +2176,9 @@ gst_kms_sink_set_property (GObject * object, guint prop_id,
 
       break;
     }
+    case PROP_ATOMIC:
+      sink->atomic = g_value_get_boolean (value);
+      break;
     default:
       if (!gst_video_overlay_set_property (object, PROP_N, prop_id, value))
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -1880,6 +2232,9 @@ gst_kms_sink_get_property (GObject * object, guint prop_id,
     case PROP_PLANE_PROPS:
       gst_value_set_structure (value, sink->plane_props);
       break;
+    case PROP_ATOMIC:
+      g_value_set_boolean (value, sink->atomic);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1909,6 +2264,7 @@ gst_kms_sink_init (GstKMSSink * sink)
   sink->conn_id = -1;
   sink->plane_id = -1;
   sink->can_scale = TRUE;
+  sink->out_fence = -1;
   gst_poll_fd_init (&sink->pollfd);
   sink->poll = gst_poll_new (TRUE);
   gst_video_info_init (&sink->vinfo);
@@ -2078,6 +2434,20 @@ gst_kms_sink_class_init (GstKMSSinkClass * klass)
       "Additional properties for the plane",
       GST_TYPE_STRUCTURE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * kmssink:atomic:
+   *
+   * Update the plane with atomic commits when the driver supports it. The
+   * sinks of a process driving the same device then share it, and each
+   * one picks a free overlay plane unless #kmssink:plane-id is set.
+   *
+   * Since: 1.22
+   */
+  g_properties[PROP_ATOMIC] =
+      g_param_spec_boolean ("atomic", "Atomic",
+      "Use atomic modesetting when supported by the driver", FALSE,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_CONSTRUCT);
+
   g_object_class_install_properties (gobject_class, PROP_N, g_properties);
 
   gst_video_overlay_install_properties (gobject_class, PROP_N);
@@ -43,6 +43,21 @@ G_BEGIN_DECLS
 
 typedef struct _GstKMSSink GstKMSSink;
 typedef struct _GstKMSSinkClass GstKMSSinkClass;
+typedef struct _GstKMSDevice GstKMSDevice;
+
+enum {
+  GST_KMS_PLANE_PROP_FB_ID,
+  GST_KMS_PLANE_PROP_CRTC_ID,
+  GST_KMS_PLANE_PROP_SRC_X,
+  GST_KMS_PLANE_PROP_SRC_Y,
+  GST_KMS_PLANE_PROP_SRC_W,
+  GST_KMS_PLANE_PROP_SRC_H,
+  GST_KMS_PLANE_PROP_CRTC_X,
+  GST_KMS_PLANE_PROP_CRTC_Y,
+  GST_KMS_PLANE_PROP_CRTC_W,
+  GST_KMS_PLANE_PROP_CRTC_H,
+  GST_KMS_PLANE_PROP_N,
+};
 
 struct _GstKMSSink {
   GstVideoSink videosink;
@@ -62,6 +77,7 @@ struct _GstKMSSink {
   gboolean has_prime_import;
   gboolean has_prime_export;
   gboolean has_async_page_flip;
+  gboolean has_atomic;
   gboolean can_scale;
 
   gboolean modesetting_enabled;
@@ -93,6 +109,16 @@ struct _GstKMSSink {
   /* reconfigure info if driver doesn't scale */
   GstVideoRectangle pending_rect;
   gboolean reconfigure;
+
+  /* atomic modesetting */
+  gboolean atomic;
+  GstKMSDevice *device;
+  guint32 claimed_plane_id;
+  guint32 plane_prop_ids[GST_KMS_PLANE_PROP_N];
+  guint32 out_fence_prop_id;
+  gint out_fence;
+  /* the buffer scanned out until the out fence signals */
+  GstBuffer *prev_buffer;
 };
 
 struct _GstKMSSinkClass {
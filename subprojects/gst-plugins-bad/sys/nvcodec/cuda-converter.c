@@ -941,11 +941,14 @@ convert_ensure_fallback_memory (GstCudaConverter * convert,
   return TRUE;
 }
 
-/* create a 2D CUDA texture without alignment check */
+/* create a 2D CUDA texture without alignment check.
+ * Creating the texture object doesn't access the memory, so there is no need
+ * to wait for pending work on the stream here, the kernels reading from the
+ * texture are launched on the same stream */
 static CUtexObject
 convert_create_texture_unchecked (const CUdeviceptr src, gint width,
     gint height, gint channels, gint stride, CUarray_format format,
-    CUfilter_mode mode, CUstream cuda_stream)
+    CUfilter_mode mode)
 {
   CUDA_TEXTURE_DESC texture_desc;
   CUDA_RESOURCE_DESC resource_desc;
@@ -966,7 +969,6 @@ convert_create_texture_unchecked (const CUdeviceptr src, gint width,
   texture_desc.filterMode = mode;
   texture_desc.flags = CU_TRSF_READ_AS_INTEGER;
 
-  gst_cuda_result (CuStreamSynchronize (cuda_stream));
   cuda_ret = CuTexObjectCreate (&texture, &resource_desc, &texture_desc, NULL);
 
   if (!gst_cuda_result (cuda_ret)) {
@@ -1041,7 +1043,7 @@ convert_create_texture (GstCudaConverter * convert, GstVideoFrame * src_frame,
   return convert_create_texture_unchecked (src_ptr,
       GST_VIDEO_FRAME_COMP_WIDTH (src_frame, plane),
       GST_VIDEO_FRAME_COMP_HEIGHT (src_frame, plane), channels, stride, format,
-      mode, cuda_stream);
+      mode);
 }
 
 /* main conversion function for YUV to YUV conversion */
@@ -1287,7 +1289,7 @@ convert_RGB_TO_YUV (GstCudaConverter * convert, GstVideoFrame * src_frame,
   texture =
       convert_create_texture_unchecked (convert->unpack_surface.device_ptr,
       in_width, in_height, 4, convert->unpack_surface.cuda_stride, format,
-      mode, cuda_stream);
+      mode);
 
   if (!texture) {
     GST_ERROR ("could not create texture");
@@ -1317,7 +1319,7 @@ convert_RGB_TO_YUV (GstCudaConverter * convert, GstVideoFrame * src_frame,
     yuv_texture[i] =
         convert_create_texture_unchecked (convert->y444_surface[i].device_ptr,
         in_width, in_height, 1, convert->y444_surface[i].cuda_stride, format,
-        mode, cuda_stream);
+        mode);
 
     if (!yuv_texture[i]) {
       GST_ERROR ("could not create %dth yuv texture", i);
@@ -1406,7 +1408,7 @@ convert_RGB_TO_RGB (GstCudaConverter * convert, GstVideoFrame * src_frame,
   texture =
       convert_create_texture_unchecked (convert->unpack_surface.device_ptr,
       in_width, in_height, 4, convert->unpack_surface.cuda_stride, format,
-      mode, cuda_stream);
+      mode);
 
   if (!texture) {
     GST_ERROR ("could not create texture");
@@ -55,6 +55,14 @@ GST_DEBUG_CATEGORY_STATIC (gst_nv_encoder_debug);
   g_mutex_unlock(GET_LOCK(e)); \
 } G_STMT_END
 
+enum
+{
+  PROP_0,
+  PROP_IN_FLIGHT_FRAMES,
+};
+
+#define DEFAULT_IN_FLIGHT_FRAMES 0
+
 struct _GstNvEncoderPrivate
 {
   GstCudaContext *context;
@@ -88,6 +96,9 @@ struct _GstNvEncoderPrivate
   GThread *encoding_thread;
 
   GstFlowReturn last_flow;
+
+  /* properties, protected by the object lock */
+  guint in_flight_frames;
 };
 
 #define gst_nv_encoder_parent_class parent_class
@@ -95,6 +106,10 @@ G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GstNvEncoder, gst_nv_encoder,
     GST_TYPE_VIDEO_ENCODER);
 
 static void gst_nv_encoder_finalize (GObject * object);
+static void gst_nv_encoder_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_nv_encoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 static void gst_nv_encoder_set_context (GstElement * element,
     GstContext * context);
 static gboolean gst_nv_encoder_open (GstVideoEncoder * encoder);
@@ -122,6 +137,26 @@ gst_nv_encoder_class_init (GstNvEncoderClass * klass)
   GstVideoEncoderClass *videoenc_class = GST_VIDEO_ENCODER_CLASS (klass);
 
   object_class->finalize = gst_nv_encoder_finalize;
+  object_class->set_property = gst_nv_encoder_set_property;
+  object_class->get_property = gst_nv_encoder_get_property;
+
+  /**
+   * GstNvEncoder:in-flight-frames:
+   *
+   * Number of frames that can be submitted to the encoder before waiting
+   * for encoded output. More frames in flight keep the hardware encoder
+   * busier when several sessions share a GPU, at the cost of latency and
+   * memory. Zero selects the minimum required by the encoder configuration,
+   * and smaller values are ignored. Takes effect when the encoding session
+   * is (re)initialized.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (object_class, PROP_IN_FLIGHT_FRAMES,
+      g_param_spec_uint ("in-flight-frames", "In Flight Frames",
+          "Number of frames submitted to the encoder before waiting for "
+          "output (0 = automatic)", 0, 64, DEFAULT_IN_FLIGHT_FRAMES,
+          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 
   element_class->set_context = GST_DEBUG_FUNCPTR (gst_nv_encoder_set_context);
 
@@ -159,6 +194,8 @@ gst_nv_encoder_init (GstNvEncoder * self)
   g_mutex_init (&priv->lock);
   g_cond_init (&priv->cond);
 
+  priv->in_flight_frames = DEFAULT_IN_FLIGHT_FRAMES;
+
   gst_video_encoder_set_min_pts (GST_VIDEO_ENCODER (self),
       GST_SECOND * 60 * 60 * 1000);
 }
@@ -174,6 +211,44 @@ gst_nv_encoder_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+static void
+gst_nv_encoder_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstNvEncoder *self = GST_NV_ENCODER (object);
+  GstNvEncoderPrivate *priv = self->priv;
+
+  switch (prop_id) {
+    case PROP_IN_FLIGHT_FRAMES:
+      GST_OBJECT_LOCK (self);
+      priv->in_flight_frames = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_nv_encoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstNvEncoder *self = GST_NV_ENCODER (object);
+  GstNvEncoderPrivate *priv = self->priv;
+
+  switch (prop_id) {
+    case PROP_IN_FLIGHT_FRAMES:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint (value, priv->in_flight_frames);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 static void
 gst_nv_encoder_set_context (GstElement * element, GstContext * context)
 {
@@ -940,7 +1015,9 @@ static guint
 gst_nv_encoder_calculate_task_pool_size (GstNvEncoder * self,
     NV_ENC_CONFIG * config)
 {
+  GstNvEncoderPrivate *priv = self->priv;
   guint num_tasks;
+  guint in_flight_frames;
 
   /* At least 4 surfaces are required as documented by Nvidia Encoder guide */
   num_tasks = 4;
@@ -951,9 +1028,16 @@ gst_nv_encoder_calculate_task_pool_size (GstNvEncoder * self,
   /* B frames + 1 */
   num_tasks += MAX (0, config->frameIntervalP - 1) + 1;
 
+  GST_OBJECT_LOCK (self);
+  in_flight_frames = priv->in_flight_frames;
+  GST_OBJECT_UNLOCK (self);
+
   GST_DEBUG_OBJECT (self, "Calculated task pool size: %d "
-      "(lookahead %d, frameIntervalP %d)",
-      num_tasks, config->rcParams.lookaheadDepth, config->frameIntervalP);
+      "(lookahead %d, frameIntervalP %d, in-flight-frames %d)",
+      num_tasks, config->rcParams.lookaheadDepth, config->frameIntervalP,
+      in_flight_frames);
+
+  num_tasks = MAX (num_tasks, in_flight_frames);
 
   return num_tasks;
 }
@@ -31,6 +31,15 @@
  * ! shmsink socket-path=/tmp/blah shm-size=2000000
  * ]| Send video to shm buffers.
  *
+ * When #GstShmSink:pass-fds is enabled, buffers backed by a single fd
+ * memory (such as dmabuf from a hardware decoder or memfd) are not copied
+ * into the shared memory area. Their fd is passed to the clients instead, which
+ * map it read-only. All clients need to support this.
+ *
+ * #GstShmSink:max-pending-buffers limits how many buffers each client may
+ * hold at once. A client at that limit does not get new buffers. The other
+ * clients are not stalled.
+ *
  */
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -39,6 +48,7 @@
 #include "gstshmsink.h"
 
 #include <gst/gst.h>
+#include <gst/allocators/gstfdmemory.h>
 
 #include <string.h>
 
@@ -58,7 +68,9 @@ enum
   PROP_PERMS,
   PROP_SHM_SIZE,
   PROP_WAIT_FOR_CONNECTION,
-  PROP_BUFFER_TIME
+  PROP_BUFFER_TIME,
+  PROP_PASS_FDS,
+  PROP_MAX_PENDING_BUFFERS
 };
 
 struct GstShmClient
@@ -69,6 +81,8 @@ struct GstShmClient
 
 #define DEFAULT_SIZE ( 64 * 1024 * 1024 )
 #define DEFAULT_WAIT_FOR_CONNECTION (TRUE)
+#define DEFAULT_PASS_FDS (FALSE)
+#define DEFAULT_MAX_PENDING_BUFFERS (0)
 /* Default is user read/write, group read */
 #define DEFAULT_PERMS ( S_IRUSR | S_IWUSR | S_IRGRP )
 
@@ -357,6 +371,8 @@ gst_shm_sink_init (GstShmSink * self)
   self->unlock = FALSE;
   self->wait_for_connection = DEFAULT_WAIT_FOR_CONNECTION;
   self->perms = DEFAULT_PERMS;
+  self->pass_fds = DEFAULT_PASS_FDS;
+  self->max_pending_buffers = DEFAULT_MAX_PENDING_BUFFERS;
 
   gst_allocation_params_init (&self->params);
 }
@@ -419,6 +435,38 @@ gst_shm_sink_class_init (GstShmSinkClass * klass)
           -1, G_MAXINT64, -1,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstShmSink:pass-fds:
+   *
+   * Pass the fd of buffers backed by a single #GstFdMemory to the clients
+   * instead of copying them into the shared memory area. This requires
+   * clients that support receiving fds.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_PASS_FDS,
+      g_param_spec_boolean ("pass-fds",
+          "Pass fds",
+          "Pass the fd of fd backed memory to the clients instead of copying "
+          "it into the shared memory area", DEFAULT_PASS_FDS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstShmSink:max-pending-buffers:
+   *
+   * Maximum number of buffers a single client may hold before it stops
+   * getting new buffers, so a slow client does not stall the other clients.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_PENDING_BUFFERS,
+      g_param_spec_uint ("max-pending-buffers",
+          "Max pending buffers",
+          "Maximum number of buffers a client may hold before buffers are "
+          "dropped for that client (0 = unlimited)",
+          0, G_MAXINT, DEFAULT_MAX_PENDING_BUFFERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   signals[SIGNAL_CLIENT_CONNECTED] = g_signal_new ("client-connected",
       GST_TYPE_SHM_SINK, G_SIGNAL_RUN_LAST, 0, NULL, NULL, NULL,
       G_TYPE_NONE, 1, G_TYPE_INT);
@@ -507,6 +555,18 @@ gst_shm_sink_set_property (GObject * object, guint prop_id,
       GST_OBJECT_UNLOCK (object);
       g_cond_broadcast (&self->cond);
       break;
+    case PROP_PASS_FDS:
+      GST_OBJECT_LOCK (object);
+      self->pass_fds = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
+    case PROP_MAX_PENDING_BUFFERS:
+      GST_OBJECT_LOCK (object);
+      self->max_pending_buffers = g_value_get_uint (value);
+      if (self->pipe)
+        sp_writer_set_max_pending (self->pipe, self->max_pending_buffers);
+      GST_OBJECT_UNLOCK (object);
+      break;
     default:
       break;
   }
@@ -536,6 +596,12 @@ gst_shm_sink_get_property (GObject * object, guint prop_id,
     case PROP_BUFFER_TIME:
       g_value_set_int64 (value, self->buffer_time);
       break;
+    case PROP_PASS_FDS:
+      g_value_set_boolean (value, self->pass_fds);
+      break;
+    case PROP_MAX_PENDING_BUFFERS:
+      g_value_set_uint (value, self->max_pending_buffers);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -572,6 +638,7 @@ gst_shm_sink_start (GstBaseSink * bsink)
   }
 
   sp_set_data (self->pipe, self);
+  sp_writer_set_max_pending (self->pipe, self->max_pending_buffers);
   g_free (self->socket_path);
   self->socket_path = g_strdup (sp_writer_get_path (self->pipe));
 
@@ -703,6 +770,25 @@ gst_shm_sink_render (GstBaseSink * bsink, GstBuffer * buf)
   }
 
 
+  if (self->pass_fds && gst_buffer_n_memory (buf) == 1 &&
+      gst_is_fd_memory (gst_buffer_peek_memory (buf, 0)) &&
+      gst_buffer_get_size (buf) > 0) {
+    memory = gst_buffer_peek_memory (buf, 0);
+    sendbuf = gst_buffer_ref (buf);
+
+    GST_LOG_OBJECT (self, "Passing fd %d of buffer %p",
+        gst_fd_memory_get_fd (memory), buf);
+    rv = sp_writer_send_fd (self->pipe, gst_fd_memory_get_fd (memory),
+        memory->offset, memory->size, sendbuf);
+    if (rv == -1) {
+      GST_ELEMENT_ERROR (self, STREAM, FAILED,
+          (NULL), ("Failed to pass fd over SHM"));
+      gst_buffer_unref (sendbuf);
+      goto error;
+    }
+    goto sent;
+  }
+
   if (gst_buffer_n_memory (buf) > 1) {
     GST_LOG_OBJECT (self, "Buffer %p has %d GstMemory, we only support a single"
         " one, need to do a memcpy", buf, gst_buffer_n_memory (buf));
@@ -800,6 +886,7 @@ gst_shm_sink_render (GstBaseSink * bsink, GstBuffer * buf)
 
   gst_buffer_unmap (sendbuf, &map);
 
+sent:
   GST_OBJECT_UNLOCK (self);
 
   if (rv == 0) {
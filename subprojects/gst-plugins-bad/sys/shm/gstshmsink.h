@@ -63,6 +63,8 @@ struct _GstShmSink
   gboolean stop;
   gboolean unlock;
   GstClockTimeDiff buffer_time;
+  gboolean pass_fds;
+  guint max_pending_buffers;
 
   GCond cond;
 
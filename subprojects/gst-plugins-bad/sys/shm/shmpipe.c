@@ -67,6 +67,12 @@
  * type 4: ack buffer
  * offset
  *
+ * type 5: fd buffer
+ * offset
+ * bufsize
+ * The fd is passed as SCM_RIGHTS ancillary data, the area id is only
+ * valid for this single buffer.
+ *
  * Type 4 goes from the client to the server
  * The rest are from the server to the client
  * The client should never write in the SHM
@@ -80,7 +86,8 @@ enum
   COMMAND_NEW_SHM_AREA = 1,
   COMMAND_CLOSE_SHM_AREA = 2,
   COMMAND_NEW_BUFFER = 3,
-  COMMAND_ACK_BUFFER = 4
+  COMMAND_ACK_BUFFER = 4,
+  COMMAND_NEW_FD_BUFFER = 5
 };
 
 typedef struct _ShmArea ShmArea;
@@ -141,12 +148,17 @@ struct _ShmPipe
   ShmClient *clients;
 
   mode_t perms;
+
+  int max_pending;
 };
 
 struct _ShmClient
 {
   int fd;
 
+  /* buffers sent but not acked yet */
+  int pending;
+
   ShmClient *next;
 };
 
@@ -462,8 +474,11 @@ sp_writer_setperms_shm (ShmPipe * self, mode_t perms)
   ShmArea *area;
 
   self->perms = perms;
-  for (area = self->shm_area; area; area = area->next)
-    ret |= fchmod (area->shm_fd, perms);
+  for (area = self->shm_area; area; area = area->next) {
+    /* passed fds are not ours */
+    if (area->shm_area_name)
+      ret |= fchmod (area->shm_fd, perms);
+  }
 
   ret |= chmod (self->socket_path, perms);
 
@@ -484,6 +499,42 @@ send_command (int fd, struct CommandBuffer *cb, unsigned short int type,
   return 1;
 }
 
+static int
+send_command_with_fd (int fd, struct CommandBuffer *cb,
+    unsigned short int type, int area_id, int passed_fd)
+{
+  struct msghdr msg = { 0 };
+  struct iovec iov;
+  union
+  {
+    struct cmsghdr cmsg;
+    char buf[CMSG_SPACE (sizeof (int))];
+  } control;
+  struct cmsghdr *cmsg;
+
+  cb->type = type;
+  cb->area_id = area_id;
+
+  iov.iov_base = cb;
+  iov.iov_len = sizeof (struct CommandBuffer);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+
+  memset (&control, 0, sizeof (control));
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof (control.buf);
+  cmsg = CMSG_FIRSTHDR (&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN (sizeof (int));
+  memcpy (CMSG_DATA (cmsg), &passed_fd, sizeof (int));
+
+  if (sendmsg (fd, &msg, MSG_NOSIGNAL) != sizeof (struct CommandBuffer))
+    return 0;
+
+  return 1;
+}
+
 int
 sp_writer_resize (ShmPipe * self, size_t size)
 {
@@ -572,36 +623,23 @@ sp_writer_free_block (ShmBlock * block)
   spalloc_free (ShmBlock, block);
 }
 
-/* Returns the number of client this has successfully been sent to */
+void
+sp_writer_set_max_pending (ShmPipe * self, int max_pending)
+{
+  self->max_pending = max_pending;
+}
 
-int
-sp_writer_send_buf (ShmPipe * self, char *buf, size_t size, void *tag)
+static int
+sp_writer_send_area_buf (ShmPipe * self, ShmArea * area,
+    ShmAllocBlock * ablock, unsigned long offset, size_t size, void *tag,
+    int passed_fd)
 {
-  ShmArea *area = NULL;
-  unsigned long offset = 0;
   unsigned long bsize = size;
   ShmBuffer *sb;
   ShmClient *client = NULL;
-  ShmAllocBlock *ablock = NULL;
   int i = 0;
   int c = 0;
 
-  if (self->num_clients == 0)
-    return 0;
-
-  for (area = self->shm_area; area; area = area->next) {
-    if (buf >= area->shm_area_buf &&
-        buf < (area->shm_area_buf + area->shm_area_len)) {
-      offset = buf - area->shm_area_buf;
-      ablock = shm_alloc_space_block_get (area->allocspace, offset);
-      assert (ablock);
-      break;
-    }
-  }
-
-  if (!ablock)
-    return -1;
-
   sb = spalloc_alloc (sizeof (ShmBuffer) + sizeof (int) * self->num_clients);
   memset (sb, 0, sizeof (ShmBuffer));
   memset (sb->clients, -1, sizeof (int) * self->num_clients);
@@ -614,11 +652,24 @@ sp_writer_send_buf (ShmPipe * self, char *buf, size_t size, void *tag)
 
   for (client = self->clients; client; client = client->next) {
     struct CommandBuffer cb = { 0 };
+
+    /* a slow client doesn't get new buffers until it has released enough of
+     * the old ones, so it can't stall the others */
+    if (self->max_pending > 0 && client->pending >= self->max_pending)
+      continue;
+
     cb.payload.buffer.offset = offset;
     cb.payload.buffer.size = bsize;
-    if (!send_command (client->fd, &cb, COMMAND_NEW_BUFFER, self->shm_area->id))
-      continue;
+    if (passed_fd >= 0) {
+      if (!send_command_with_fd (client->fd, &cb, COMMAND_NEW_FD_BUFFER,
+              area->id, passed_fd))
+        continue;
+    } else {
+      if (!send_command (client->fd, &cb, COMMAND_NEW_BUFFER, area->id))
+        continue;
+    }
     sb->clients[i++] = client->fd;
+    client->pending++;
     c++;
   }
 
@@ -628,7 +679,8 @@ sp_writer_send_buf (ShmPipe * self, char *buf, size_t size, void *tag)
   }
 
   sp_shm_area_inc (area);
-  shm_alloc_space_block_inc (ablock);
+  if (ablock)
+    shm_alloc_space_block_inc (ablock);
 
   sb->use_count = c;
 
@@ -638,12 +690,117 @@ sp_writer_send_buf (ShmPipe * self, char *buf, size_t size, void *tag)
   return c;
 }
 
+/* Returns the number of client this has successfully been sent to */
+
+int
+sp_writer_send_buf (ShmPipe * self, char *buf, size_t size, void *tag)
+{
+  ShmArea *area = NULL;
+  unsigned long offset = 0;
+  ShmAllocBlock *ablock = NULL;
+
+  if (self->num_clients == 0)
+    return 0;
+
+  for (area = self->shm_area; area; area = area->next) {
+    if (area->allocspace && buf >= area->shm_area_buf &&
+        buf < (area->shm_area_buf + area->shm_area_len)) {
+      offset = buf - area->shm_area_buf;
+      ablock = shm_alloc_space_block_get (area->allocspace, offset);
+      assert (ablock);
+      break;
+    }
+  }
+
+  if (!ablock)
+    return -1;
+
+  return sp_writer_send_area_buf (self, area, ablock, offset, size, tag, -1);
+}
+
+/* Passes @fd to the clients, they map @size bytes starting at @offset.
+ * Returns the number of client this has successfully been sent to */
+
+int
+sp_writer_send_fd (ShmPipe * self, int fd, unsigned long offset, size_t size,
+    void *tag)
+{
+  ShmArea *area;
+  int c;
+
+  if (self->num_clients == 0)
+    return 0;
+
+  area = spalloc_new (ShmArea);
+  memset (area, 0, sizeof (ShmArea));
+  area->shm_area_buf = MAP_FAILED;
+  area->use_count = 1;
+  area->is_writer = 1;
+  area->shm_fd = fcntl (fd, F_DUPFD_CLOEXEC, 0);
+
+  if (area->shm_fd < 0) {
+    spalloc_free (ShmArea, area);
+    return -1;
+  }
+
+  area->id = ++self->next_area_id;
+
+  /* keep the current area first, it is the one used for allocations */
+  area->next = self->shm_area->next;
+  self->shm_area->next = area;
+
+  c = sp_writer_send_area_buf (self, area, NULL, offset, size, tag,
+      area->shm_fd);
+
+  /* the pending buffer, if any, keeps the area alive */
+  sp_shm_area_dec (self, area);
+
+  return c;
+}
+
 static int
-recv_command (int fd, struct CommandBuffer *cb)
+recv_command (int fd, struct CommandBuffer *cb, int *passed_fd)
 {
+  struct msghdr msg = { 0 };
+  struct iovec iov;
+  union
+  {
+    struct cmsghdr cmsg;
+    char buf[CMSG_SPACE (sizeof (int))];
+  } control;
+  struct cmsghdr *cmsg;
+  int received_fd = -1;
+  int flags = MSG_DONTWAIT;
   int retval;
 
-  retval = recv (fd, cb, sizeof (struct CommandBuffer), MSG_DONTWAIT);
+#ifdef MSG_CMSG_CLOEXEC
+  flags |= MSG_CMSG_CLOEXEC;
+#endif
+
+  iov.iov_base = cb;
+  iov.iov_len = sizeof (struct CommandBuffer);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof (control.buf);
+
+  retval = recvmsg (fd, &msg, flags);
+
+  for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+        cmsg->cmsg_len == CMSG_LEN (sizeof (int)))
+      memcpy (&received_fd, CMSG_DATA (cmsg), sizeof (int));
+  }
+
+  if (retval != sizeof (struct CommandBuffer) || !passed_fd) {
+    if (received_fd >= 0)
+      close (received_fd);
+    received_fd = -1;
+  }
+
+  if (passed_fd)
+    *passed_fd = received_fd;
+
   if (retval == sizeof (struct CommandBuffer)) {
     return 1;
   } else {
@@ -651,6 +808,32 @@ recv_command (int fd, struct CommandBuffer *cb)
   }
 }
 
+/* Maps @size bytes of a passed fd, takes ownership of @fd */
+static ShmArea *
+sp_open_fd_area (int fd, int id, size_t size)
+{
+  ShmArea *area = spalloc_new (ShmArea);
+
+  memset (area, 0, sizeof (ShmArea));
+
+  area->use_count = 1;
+  area->shm_fd = fd;
+  area->shm_area_len = size;
+  area->id = id;
+
+  area->shm_area_buf = mmap (NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+
+  if (area->shm_area_buf == MAP_FAILED) {
+    fprintf (stderr, "mmap of passed fd failed (%d): %s\n", errno,
+        strerror (errno));
+    area->use_count--;
+    sp_close_shm (area);
+    return NULL;
+  }
+
+  return area;
+}
+
 long int
 sp_client_recv (ShmPipe * self, char **buf)
 {
@@ -658,11 +841,17 @@ sp_client_recv (ShmPipe * self, char **buf)
   ShmArea *newarea;
   ShmArea *area;
   struct CommandBuffer cb;
+  int passed_fd;
   int retval;
 
-  if (!recv_command (self->main_socket, &cb))
+  if (!recv_command (self->main_socket, &cb, &passed_fd))
     return -1;
 
+  if (passed_fd >= 0 && cb.type != COMMAND_NEW_FD_BUFFER) {
+    close (passed_fd);
+    passed_fd = -1;
+  }
+
   switch (cb.type) {
     case COMMAND_NEW_SHM_AREA:
       assert (cb.payload.new_shm_area.path_size > 0);
@@ -708,6 +897,22 @@ sp_client_recv (ShmPipe * self, char **buf)
       }
       return -23;
 
+    case COMMAND_NEW_FD_BUFFER:
+      assert (buf);
+      if (passed_fd < 0)
+        return -24;
+
+      newarea = sp_open_fd_area (passed_fd, cb.area_id,
+          cb.payload.buffer.offset + cb.payload.buffer.size);
+      if (!newarea)
+        return -4;
+
+      /* the area only lives as long as the buffer */
+      newarea->next = self->shm_area;
+      self->shm_area = newarea;
+      *buf = newarea->shm_area_buf + cb.payload.buffer.offset;
+      return cb.payload.buffer.size;
+
     default:
       return -99;
   }
@@ -721,7 +926,7 @@ sp_writer_recv (ShmPipe * self, ShmClient * client, void **tag)
   ShmBuffer *buf = NULL, *prev_buf = NULL;
   struct CommandBuffer cb;
 
-  if (!recv_command (client->fd, &cb))
+  if (!recv_command (client->fd, &cb, NULL))
     return -1;
 
   switch (cb.type) {
@@ -748,6 +953,7 @@ sp_client_recv_finish (ShmPipe * self, char *buf)
 {
   ShmArea *shm_area = NULL;
   unsigned long offset;
+  int area_id;
   struct CommandBuffer cb = { 0 };
 
   for (shm_area = self->shm_area; shm_area; shm_area = shm_area->next) {
@@ -759,12 +965,12 @@ sp_client_recv_finish (ShmPipe * self, char *buf)
   assert (shm_area);
 
   offset = buf - shm_area->shm_area_buf;
+  area_id = shm_area->id;
 
   sp_shm_area_dec (self, shm_area);
 
   cb.payload.ack_buffer.offset = offset;
-  return send_command (self->main_socket, &cb, COMMAND_ACK_BUFFER,
-      self->shm_area->id);
+  return send_command (self->main_socket, &cb, COMMAND_ACK_BUFFER, area_id);
 }
 
 ShmPipe *
@@ -864,6 +1070,7 @@ sp_shmbuf_dec (ShmPipe * self, ShmBuffer * buf, ShmBuffer * prev_buf,
   for (i = 0; i < buf->num_clients; i++) {
     if (buf->clients[i] == client->fd) {
       buf->clients[i] = -1;
+      client->pending--;
       had_client = 1;
       break;
     }
@@ -881,7 +1088,8 @@ sp_shmbuf_dec (ShmPipe * self, ShmBuffer * buf, ShmBuffer * prev_buf,
 
     if (tag)
       *tag = buf->tag;
-    shm_alloc_space_block_dec (buf->ablock);
+    if (buf->ablock)
+      shm_alloc_space_block_dec (buf->ablock);
     sp_shm_area_dec (self, buf->shm_area);
     spalloc_free1 (sizeof (ShmBuffer) + sizeof (int) * buf->num_clients, buf);
     return 0;
@@ -46,6 +46,13 @@
  * for events on the client fd (the ones where sp_writer_recv() is
  * called), and then try to re-alloc.
  *
+ * Instead of copying into a block, the writer can also pass the fd of
+ * an existing mappable memory (memfd, dmabuf) to the clients with
+ * sp_writer_send_fd(). The clients then map it read-only themselves, it
+ * is acked and released like any other buffer. With
+ * sp_writer_set_max_pending(), a client that has not acked that many
+ * buffers yet is skipped until it catches up.
+ *
  * The reader (client) connect to the writer with sp_client_open() And
  * select()s on the fd from sp_get_fd() until there is something to
  * read.  Then they must read using sp_client_recv() which will return
@@ -97,6 +104,9 @@ int sp_writer_get_client_fd (ShmClient * client);
 ShmBlock *sp_writer_alloc_block (ShmPipe * self, size_t size);
 void sp_writer_free_block (ShmBlock *block);
 int sp_writer_send_buf (ShmPipe * self, char *buf, size_t size, void * tag);
+int sp_writer_send_fd (ShmPipe * self, int fd, unsigned long offset,
+    size_t size, void * tag);
+void sp_writer_set_max_pending (ShmPipe * self, int max_pending);
 char *sp_writer_block_get_buf (ShmBlock *block);
 ShmPipe *sp_writer_block_get_pipe (ShmBlock *block);
 size_t sp_writer_get_max_buf_size (ShmPipe * self);
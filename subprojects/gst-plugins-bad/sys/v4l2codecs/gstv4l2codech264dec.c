@@ -427,7 +427,8 @@ gst_v4l2_codec_h264_dec_decide_allocation (GstVideoDecoder * decoder,
   }
 
   self->src_allocator = gst_v4l2_codec_allocator_new (self->decoder,
-      GST_PAD_SRC, self->min_pool_size + min + 4);
+      GST_PAD_SRC, self->min_pool_size + min + 3 +
+      MAX (1, gst_v4l2_decoder_get_render_delay (self->decoder)));
   if (!self->src_allocator) {
     GST_ELEMENT_ERROR (self, RESOURCE, NO_SPACE_LEFT,
         ("Not enough memory to allocate source buffers."), (NULL));
@@ -1352,11 +1353,7 @@ gst_v4l2_codec_h264_dec_get_preferred_output_delay (GstH264Decoder * decoder,
   GstV4l2CodecH264Dec *self = GST_V4L2_CODEC_H264_DEC (decoder);
   guint delay;
 
-  if (live)
-    delay = 0;
-  else
-    /* Just one for now, perhaps we can make this configurable in the future. */
-    delay = 1;
+  delay = gst_v4l2_decoder_get_preferred_render_delay (self->decoder, live);
 
   gst_v4l2_decoder_set_render_delay (self->decoder, delay);
 
@@ -104,11 +104,7 @@ gst_v4l2_codec_mpeg2_dec_get_preferred_output_delay (GstMpeg2Decoder * decoder,
   GstV4l2CodecMpeg2Dec *self = GST_V4L2_CODEC_MPEG2_DEC (decoder);
   guint delay;
 
-  if (is_live)
-    delay = 0;
-  else
-    /* Just one for now, perhaps we can make this configurable in the future. */
-    delay = 1;
+  delay = gst_v4l2_decoder_get_preferred_render_delay (self->decoder, is_live);
 
   gst_v4l2_decoder_set_render_delay (self->decoder, delay);
 
@@ -344,7 +340,8 @@ gst_v4l2_codec_mpeg2_dec_decide_allocation (GstVideoDecoder * decoder,
   self->sink_allocator = gst_v4l2_codec_allocator_new (self->decoder,
       GST_PAD_SINK, num_bitstream);
   self->src_allocator = gst_v4l2_codec_allocator_new (self->decoder,
-      GST_PAD_SRC, self->min_pool_size + min + 4);
+      GST_PAD_SRC, self->min_pool_size + min + 3 +
+      MAX (1, gst_v4l2_decoder_get_render_delay (self->decoder)));
   self->src_pool = gst_v4l2_codec_pool_new (self->src_allocator, &self->vinfo);
 
   /* Our buffer pool is internal, we will let the base class create a video
@@ -95,11 +95,7 @@ gst_v4l2_codec_vp8_dec_get_preferred_output_delay (GstVp8Decoder * decoder,
   GstV4l2CodecVp8Dec *self = GST_V4L2_CODEC_VP8_DEC (decoder);
   guint delay;
 
-  if (is_live)
-    delay = 0;
-  else
-    /* Just one for now, perhaps we can make this configurable in the future. */
-    delay = 1;
+  delay = gst_v4l2_decoder_get_preferred_render_delay (self->decoder, is_live);
 
   gst_v4l2_decoder_set_render_delay (self->decoder, delay);
   return delay;
@@ -296,7 +292,8 @@ gst_v4l2_codec_vp8_dec_decide_allocation (GstVideoDecoder * decoder,
   }
 
   self->src_allocator = gst_v4l2_codec_allocator_new (self->decoder,
-      GST_PAD_SRC, self->min_pool_size + min + 4);
+      GST_PAD_SRC, self->min_pool_size + min + 3 +
+      MAX (1, gst_v4l2_decoder_get_render_delay (self->decoder)));
   if (!self->src_allocator) {
     GST_ELEMENT_ERROR (self, RESOURCE, NO_SPACE_LEFT,
         ("Not enough memory to allocate source buffers."), (NULL));
@@ -104,10 +104,7 @@ gst_v4l2_codec_vp9_dec_get_preferred_output_delay (GstVp9Decoder * decoder,
   GstV4l2CodecVp9Dec *self = GST_V4L2_CODEC_VP9_DEC (decoder);
   guint delay;
 
-  if (is_live)
-    delay = 0;
-  else
-    delay = 1;
+  delay = gst_v4l2_decoder_get_preferred_render_delay (self->decoder, is_live);
 
   gst_v4l2_decoder_set_render_delay (self->decoder, delay);
   return delay;
@@ -561,7 +558,8 @@ gst_v4l2_codec_vp9_dec_decide_allocation (GstVideoDecoder * decoder,
   }
 
   self->src_allocator = gst_v4l2_codec_allocator_new (self->decoder,
-      GST_PAD_SRC, GST_VP9_REF_FRAMES + min + 4);
+      GST_PAD_SRC, GST_VP9_REF_FRAMES + min + 3 +
+      MAX (1, gst_v4l2_decoder_get_render_delay (self->decoder)));
   if (!self->src_allocator) {
     GST_ELEMENT_ERROR (self, RESOURCE, NO_SPACE_LEFT,
         ("Not enough memory to allocate source buffers."), (NULL));
@@ -38,6 +38,8 @@
 
 #define IMAGE_MINSZ 4096
 
+#define DEFAULT_RENDER_DELAY 1
+
 GST_DEBUG_CATEGORY (v4l2_decoder_debug);
 #define GST_CAT_DEFAULT v4l2_decoder_debug
 
@@ -46,6 +48,7 @@ enum
   PROP_0,
   PROP_MEDIA_DEVICE,
   PROP_VIDEO_DEVICE,
+  PROP_RENDER_DELAY,
 };
 
 struct _GstV4l2Request
@@ -86,6 +89,7 @@ struct _GstV4l2Decoder
   /* properties */
   gchar *media_device;
   gchar *video_device;
+  guint preferred_render_delay;
   guint render_delay;
 
   /* detected features */
@@ -127,6 +131,7 @@ gst_v4l2_decoder_init (GstV4l2Decoder * self)
 {
   self->request_pool = gst_queue_array_new (16);
   self->pending_requests = gst_queue_array_new (16);
+  self->preferred_render_delay = DEFAULT_RENDER_DELAY;
 }
 
 static void
@@ -787,6 +792,23 @@ gst_v4l2_decoder_install_properties (GObjectClass * gobject_class,
       g_param_spec_string ("video-device", "Video Device Path",
           "Path to the video device node", video_device_path,
           G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstV4l2Decoder:render-delay:
+   *
+   * Number of requests queued to the accelerator ahead of the one being
+   * waited for when not live. Higher values keep the hardware busy between
+   * frames at the cost of latency and of one more bitstream and picture
+   * buffer per request.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_RENDER_DELAY,
+      g_param_spec_uint ("render-delay", "Render Delay",
+          "Number of frames kept in flight in the accelerator when not live",
+          1, 16, DEFAULT_RENDER_DELAY,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
 }
 
 void
@@ -804,6 +826,9 @@ gst_v4l2_decoder_set_property (GObject * object, guint prop_id,
       g_free (self->video_device);
       self->video_device = g_value_dup_string (value);
       break;
+    case PROP_RENDER_DELAY:
+      self->preferred_render_delay = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -823,6 +848,9 @@ gst_v4l2_decoder_get_property (GObject * object, guint prop_id,
     case PROP_VIDEO_DEVICE:
       g_value_set_string (value, self->video_device);
       break;
+    case PROP_RENDER_DELAY:
+      g_value_set_uint (value, self->preferred_render_delay);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -989,6 +1017,24 @@ gst_v4l2_decoder_alloc_sub_request (GstV4l2Decoder * self,
   return request;
 }
 
+/**
+ * gst_v4l2_decoder_get_preferred_render_delay:
+ * @self: a #GstV4l2Decoder pointer
+ * @is_live: whether the stream is live
+ *
+ * Returns: The render delay to use, 0 for live streams and the
+ * #GstV4l2Decoder:render-delay property otherwise.
+ */
+guint
+gst_v4l2_decoder_get_preferred_render_delay (GstV4l2Decoder * self,
+    gboolean is_live)
+{
+  if (is_live)
+    return 0;
+
+  return self->preferred_render_delay;
+}
+
 /**
  * gst_v4l2_decoder_set_render_delay:
  * @self: a #GstV4l2Decoder pointer
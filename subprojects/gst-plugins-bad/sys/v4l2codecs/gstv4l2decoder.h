@@ -116,6 +116,9 @@ GstV4l2Request   *gst_v4l2_decoder_alloc_sub_request (GstV4l2Decoder * self,
                                                       GstV4l2Request * prev_request,
                                                       GstMemory *bitstream);
 
+guint             gst_v4l2_decoder_get_preferred_render_delay (GstV4l2Decoder * self,
+                                                               gboolean is_live);
+
 void              gst_v4l2_decoder_set_render_delay (GstV4l2Decoder * self,
                                                      guint delay);
 
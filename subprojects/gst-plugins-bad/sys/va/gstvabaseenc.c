@@ -33,14 +33,20 @@ struct _GstVaBaseEncPrivate
 {
   GstVideoInfo sinkpad_info;
   GstBufferPool *raw_pool;
+
+  /* protected by the object lock */
+  guint async_depth;
 };
 
 enum
 {
   PROP_DEVICE_PATH = 1,
+  PROP_ASYNC_DEPTH,
   N_PROPERTIES
 };
 
+#define DEFAULT_ASYNC_DEPTH 0
+
 static GParamSpec *properties[N_PROPERTIES];
 
 /**
@@ -58,6 +64,8 @@ G_DEFINE_ABSTRACT_TYPE_WITH_CODE (GstVaBaseEnc, gst_va_base_enc,
         "vabaseenc", 0, "vabaseenc element"););
 /* *INDENT-ON* */
 
+extern GRecMutex GST_VA_SHARED_LOCK;
+
 static void
 gst_va_base_enc_reset_state (GstVaBaseEnc * base)
 {
@@ -235,19 +243,106 @@ _get_sinkpad_pool (GstVaBaseEnc * base)
   return base->priv->raw_pool;
 }
 
+static inline gsize
+_get_plane_data_size (GstVideoInfo * info, guint plane)
+{
+  gint comp[GST_VIDEO_MAX_COMPONENTS];
+  gint height, padded_height;
+
+  gst_video_format_info_component (info->finfo, plane, comp);
+
+  height = GST_VIDEO_INFO_HEIGHT (info);
+  padded_height =
+      GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (info->finfo, comp[0], height);
+
+  return GST_VIDEO_INFO_PLANE_STRIDE (info, plane) * padded_height;
+}
+
+static gboolean
+_try_import_dmabuf_unlocked (GstVaBaseEnc * base, GstBuffer * inbuf)
+{
+  GstVideoMeta *meta;
+  GstVideoInfo in_info = base->input_state->info;
+  GstMemory *mems[GST_VIDEO_MAX_PLANES];
+  guint i, n_mem, n_planes;
+  gsize offset[GST_VIDEO_MAX_PLANES];
+  uintptr_t fd[GST_VIDEO_MAX_PLANES];
+
+  n_planes = GST_VIDEO_INFO_N_PLANES (&in_info);
+  n_mem = gst_buffer_n_memory (inbuf);
+  meta = gst_buffer_get_video_meta (inbuf);
+
+  /* This will eliminate most non-dmabuf out there */
+  if (!gst_is_dmabuf_memory (gst_buffer_peek_memory (inbuf, 0)))
+    return FALSE;
+
+  /* We cannot have multiple dmabuf per plane */
+  if (n_mem > n_planes)
+    return FALSE;
+
+  /* Update video info based on video meta */
+  if (meta) {
+    GST_VIDEO_INFO_WIDTH (&in_info) = meta->width;
+    GST_VIDEO_INFO_HEIGHT (&in_info) = meta->height;
+
+    for (i = 0; i < meta->n_planes; i++) {
+      GST_VIDEO_INFO_PLANE_OFFSET (&in_info, i) = meta->offset[i];
+      GST_VIDEO_INFO_PLANE_STRIDE (&in_info, i) = meta->stride[i];
+    }
+  }
+
+  /* Find and validate all memories */
+  for (i = 0; i < n_planes; i++) {
+    guint plane_size;
+    guint length;
+    guint mem_idx;
+    gsize mem_skip;
+
+    plane_size = _get_plane_data_size (&in_info, i);
+
+    if (!gst_buffer_find_memory (inbuf, in_info.offset[i], plane_size,
+            &mem_idx, &length, &mem_skip))
+      return FALSE;
+
+    /* We can't have more then one dmabuf per plane */
+    if (length != 1)
+      return FALSE;
+
+    mems[i] = gst_buffer_peek_memory (inbuf, mem_idx);
+
+    /* And all memory found must be dmabuf */
+    if (!gst_is_dmabuf_memory (mems[i]))
+      return FALSE;
+
+    offset[i] = mems[i]->offset + mem_skip;
+    fd[i] = gst_dmabuf_memory_get_fd (mems[i]);
+  }
+
+  /* Now create a VASurfaceID for the buffer. The surface is attached to the
+   * memories, so it is only created once for each buffer of an upstream
+   * pool, and the buffer goes back to that pool once the encoder drops its
+   * reference, after the picture is encoded. */
+  return gst_va_dmabuf_memories_setup (base->display, &in_info, n_planes,
+      mems, fd, offset, VA_SURFACE_ATTRIB_USAGE_HINT_ENCODER);
+}
+
 static gboolean
 _try_import_buffer (GstVaBaseEnc * base, GstBuffer * inbuf)
 {
   VASurfaceID surface;
+  gboolean ret;
 
   /* The VA buffer. */
   surface = gst_va_buffer_get_surface (inbuf);
   if (surface != VA_INVALID_ID)
     return TRUE;
 
-  /* TODO: DMA buffer. */
+  /* The DMA buffer. */
+  g_rec_mutex_lock (&GST_VA_SHARED_LOCK);
+  ret = _try_import_dmabuf_unlocked (base, inbuf);
+  g_rec_mutex_unlock (&GST_VA_SHARED_LOCK);
 
-  return FALSE;
+  return ret;
 }
 
 static GstFlowReturn
@@ -516,6 +611,7 @@ gst_va_base_enc_handle_frame (GstVideoEncoder * venc,
   GstFlowReturn ret;
   GstBuffer *in_buf = NULL;
   GstVideoCodecFrame *frame_encode = NULL;
+  guint async_depth;
 
   GST_LOG_OBJECT (venc,
       "handle frame id %d, dts %" GST_TIME_FORMAT ", pts %" GST_TIME_FORMAT,
@@ -540,12 +636,16 @@ gst_va_base_enc_handle_frame (GstVideoEncoder * venc,
   /* pass it to reorder list and we should not use it again. */
   frame = NULL;
 
+  async_depth = gst_va_base_enc_get_async_depth (base);
+
   while (frame_encode) {
     ret = base_class->encode_frame (base, frame_encode, FALSE);
     if (ret != GST_FLOW_OK)
       goto error_encode;
 
-    while (g_queue_get_length (&base->output_list) > 0) {
+    /* Keep up to async-depth frames in flight, so we only wait for the
+     * oldest one while the hardware works on the others */
+    while (g_queue_get_length (&base->output_list) > async_depth) {
       ret = _push_out_one_buffer (base);
       if (ret != GST_FLOW_OK)
         goto error_push_buffer;
@@ -832,6 +932,29 @@ gst_va_base_enc_set_context (GstElement * element, GstContext * context)
   GST_ELEMENT_CLASS (parent_class)->set_context (element, context);
 }
 
+static void
+gst_va_base_enc_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstVaBaseEnc *base = GST_VA_BASE_ENC (object);
+
+  switch (prop_id) {
+    case PROP_ASYNC_DEPTH:
+      GST_OBJECT_LOCK (base);
+      /* the reconstructed surfaces are allocated for it */
+      if (GST_STATE (base) > GST_STATE_READY) {
+        GST_WARNING_OBJECT (base, "async-depth can only be changed in "
+            "NULL or READY state");
+      } else {
+        base->priv->async_depth = g_value_get_uint (value);
+      }
+      GST_OBJECT_UNLOCK (base);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+  }
+}
+
 static void
 gst_va_base_enc_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec)
@@ -847,6 +970,11 @@ gst_va_base_enc_get_property (GObject * object, guint prop_id,
       g_object_get_property (G_OBJECT (base->display), "path", value);
       break;
     }
+    case PROP_ASYNC_DEPTH:
+      GST_OBJECT_LOCK (base);
+      g_value_set_uint (value, base->priv->async_depth);
+      GST_OBJECT_UNLOCK (base);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -860,6 +988,7 @@ gst_va_base_enc_init (GstVaBaseEnc * self)
   g_queue_init (&self->output_list);
 
   self->priv = gst_va_base_enc_get_instance_private (self);
+  self->priv->async_depth = DEFAULT_ASYNC_DEPTH;
 }
 
 static void
@@ -878,6 +1007,7 @@ gst_va_base_enc_class_init (GstVaBaseEncClass * klass)
   GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
   GstVideoEncoderClass *encoder_class = GST_VIDEO_ENCODER_CLASS (klass);
 
+  gobject_class->set_property = gst_va_base_enc_set_property;
   gobject_class->get_property = gst_va_base_enc_get_property;
   gobject_class->dispose = gst_va_base_enc_dispose;
 
@@ -904,6 +1034,23 @@ gst_va_base_enc_class_init (GstVaBaseEncClass * klass)
       "Device Path", "DRM device path", NULL,
       G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GstVaBaseEnc:async-depth:
+   *
+   * Number of encoded frames kept in flight before waiting for the oldest
+   * one to finish. Higher values let the hardware encode the next frames
+   * while the previous output is retrieved, at the cost of that many frames
+   * of latency. Each frame in flight holds a reconstructed surface, which
+   * are allocated when the encoder is configured, so it can't be changed
+   * once the element left the READY state.
+   *
+   * Since: 1.22
+   */
+  properties[PROP_ASYNC_DEPTH] = g_param_spec_uint ("async-depth",
+      "Async Depth", "Number of encoded frames kept in flight", 0, 16,
+      DEFAULT_ASYNC_DEPTH, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+      GST_PARAM_MUTABLE_READY);
+
   g_object_class_install_properties (gobject_class, N_PROPERTIES, properties);
 
   gst_type_mark_as_plugin_api (GST_TYPE_VA_BASE_ENC, 0);
@@ -1071,6 +1218,20 @@ gst_va_base_enc_add_trellis_parameter (GstVaBaseEnc * base,
   return TRUE;
 }
 
+/* Number of frames kept in the output list once encoded, which subclasses
+ * have to account for in the reconstructed surfaces */
+guint
+gst_va_base_enc_get_async_depth (GstVaBaseEnc * base)
+{
+  guint async_depth;
+
+  GST_OBJECT_LOCK (base);
+  async_depth = base->priv->async_depth;
+  GST_OBJECT_UNLOCK (base);
+
+  return async_depth;
+}
+
 void
 gst_va_base_enc_add_codec_tag (GstVaBaseEnc * base, const gchar * codec_name)
 {
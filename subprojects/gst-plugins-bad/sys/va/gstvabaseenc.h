@@ -128,6 +128,7 @@ gboolean              gst_va_base_enc_add_trellis_parameter (GstVaBaseEnc * base
                                                              gboolean use_trellis);
 void                  gst_va_base_enc_add_codec_tag        (GstVaBaseEnc * base,
                                                             const gchar * codec_name);
+guint                 gst_va_base_enc_get_async_depth      (GstVaBaseEnc * base);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstVaBaseEnc, gst_object_unref)
 
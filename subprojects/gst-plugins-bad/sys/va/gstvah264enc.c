@@ -218,6 +218,9 @@ struct _GstVaH264Enc
     guint32 ref_num_list1;
 
     guint num_reorder_frames;
+
+    /* Forced key frame waiting for the current GOP to be output */
+    GstVideoCodecFrame *pending_key_frame;
   } gop;
 
   struct
@@ -1483,6 +1486,7 @@ gst_va_h264_enc_reset_state (GstVaBaseEnc * base)
   self->gop.max_pic_order_cnt = 0;
   self->gop.log2_max_pic_order_cnt = 0;
   self->gop.num_ref_frames = self->prop.num_ref_frames;
+  g_clear_pointer (&self->gop.pending_key_frame, gst_video_codec_frame_unref);
   self->gop.ref_num_list0 = 0;
   self->gop.ref_num_list1 = 0;
   self->gop.num_reorder_frames = 0;
@@ -1568,6 +1572,8 @@ gst_va_h264_enc_reconfig (GstVaBaseEnc * base)
     return FALSE;
 
   max_ref_frames = self->gop.num_ref_frames + 3 /* scratch frames */ ;
+  /* the frames kept in flight still hold their reconstructed surface */
+  max_ref_frames += gst_va_base_enc_get_async_depth (base);
   if (!gst_va_encoder_open (base->encoder, base->profile, base->entrypoint,
           GST_VIDEO_INFO_FORMAT (&base->input_state->info), base->rt_format,
           self->mb_width * 16, self->mb_height * 16, base->codedbuf_size,
@@ -1870,15 +1876,50 @@ static gboolean
 gst_va_h264_enc_reorder_frame (GstVaBaseEnc * base, GstVideoCodecFrame * frame,
     gboolean bump_all, GstVideoCodecFrame ** out_frame)
 {
+  GstVaH264Enc *self = GST_VA_H264_ENC (base);
+  GstVideoCodecFrame *key_frame = NULL;
+
+  /* A forced key frame in the middle of a GOP (e.g. a scene cut found by
+   * upstream analysis) starts a new GOP with an IDR. Close the current GOP
+   * as at the end of the stream, and only push the key frame once all the
+   * frames of it have been popped. */
+  if (frame && GST_VIDEO_CODEC_FRAME_IS_FORCE_KEYFRAME (frame)
+      && self->gop.cur_frame_index > 0
+      && self->gop.cur_frame_index < self->gop.idr_period) {
+    GST_DEBUG_OBJECT (self, "system_frame_number: %d, a force key frame,"
+        " end the current GOP at frame index %d", frame->system_frame_number,
+        self->gop.cur_frame_index);
+
+    if (!_push_one_frame (base, NULL, TRUE)) {
+      *out_frame = NULL;
+      return FALSE;
+    }
+
+    g_assert (self->gop.pending_key_frame == NULL);
+    self->gop.pending_key_frame = gst_video_codec_frame_ref (frame);
+    frame = NULL;
+  }
+
+  if (!frame && self->gop.pending_key_frame
+      && g_queue_is_empty (&base->reorder_list)) {
+    key_frame = g_steal_pointer (&self->gop.pending_key_frame);
+    frame = key_frame;
+  }
+
   if (!_push_one_frame (base, frame, bump_all)) {
     GST_ERROR_OBJECT (base, "Failed to push the input frame"
         " system_frame_number: %d into the reorder list",
         frame->system_frame_number);
 
+    if (key_frame)
+      gst_video_codec_frame_unref (key_frame);
     *out_frame = NULL;
     return FALSE;
   }
 
+  if (key_frame)
+    gst_video_codec_frame_unref (key_frame);
+
   if (!_pop_one_frame (base, out_frame)) {
     GST_ERROR_OBJECT (base, "Failed to pop the frame from the reorder list");
     *out_frame = NULL;
@@ -0,0 +1,366 @@
+/* GStreamer unit test for audiomixmatrix
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+#include <gst/audio/audio.h>
+#include <math.h>
+
+#define N_SAMPLES 67
+
+static const GstAudioFormat formats[] = {
+  GST_AUDIO_FORMAT_F32, GST_AUDIO_FORMAT_F64, GST_AUDIO_FORMAT_S16,
+  GST_AUDIO_FORMAT_S32
+};
+
+static void
+set_matrix (GstElement * element, const gdouble * matrix, guint in_channels,
+    guint out_channels)
+{
+  GValue v = G_VALUE_INIT;
+  guint in, out;
+
+  g_value_init (&v, GST_TYPE_ARRAY);
+  for (out = 0; out < out_channels; out++) {
+    GValue row = G_VALUE_INIT;
+
+    g_value_init (&row, GST_TYPE_ARRAY);
+    for (in = 0; in < in_channels; in++) {
+      GValue itm = G_VALUE_INIT;
+
+      g_value_init (&itm, G_TYPE_DOUBLE);
+      g_value_set_double (&itm, matrix[out * in_channels + in]);
+      gst_value_array_append_value (&row, &itm);
+      g_value_unset (&itm);
+    }
+    gst_value_array_append_value (&v, &row);
+    g_value_unset (&row);
+  }
+  g_object_set_property (G_OBJECT (element), "matrix", &v);
+  g_value_unset (&v);
+}
+
+static gdouble
+get_sample (GstAudioFormat format, gconstpointer data, guint idx)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_F32:
+      return ((const gfloat *) data)[idx];
+    case GST_AUDIO_FORMAT_F64:
+      return ((const gdouble *) data)[idx];
+    case GST_AUDIO_FORMAT_S16:
+      return ((const gint16 *) data)[idx];
+    case GST_AUDIO_FORMAT_S32:
+      return ((const gint32 *) data)[idx];
+    default:
+      g_assert_not_reached ();
+      return 0.0;
+  }
+}
+
+/* @value is in the range [-1, 1] */
+static void
+set_sample (GstAudioFormat format, gpointer data, guint idx, gdouble value)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_F32:
+      ((gfloat *) data)[idx] = value;
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      ((gdouble *) data)[idx] = value;
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      ((gint16 *) data)[idx] = lrint (value * G_MAXINT16);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      ((gint32 *) data)[idx] = lrint (value * G_MAXINT32);
+      break;
+    default:
+      g_assert_not_reached ();
+  }
+}
+
+static GstHarness *
+setup_mix_matrix (GstAudioFormat format, const gdouble * matrix,
+    guint in_channels, guint out_channels)
+{
+  GstHarness *h;
+  gchar *in_caps, *out_caps;
+  const gchar *fmt = gst_audio_format_to_string (format);
+
+  h = gst_harness_new ("audiomixmatrix");
+  g_object_set (h->element, "in-channels", in_channels, "out-channels",
+      out_channels, NULL);
+  set_matrix (h->element, matrix, in_channels, out_channels);
+
+  in_caps = g_strdup_printf ("audio/x-raw, format=%s, rate=48000, "
+      "channels=%u, layout=interleaved, channel-mask=(bitmask)0x0", fmt,
+      in_channels);
+  out_caps = g_strdup_printf ("audio/x-raw, format=%s, rate=48000, "
+      "channels=%u, layout=interleaved, channel-mask=(bitmask)0x0", fmt,
+      out_channels);
+  gst_harness_set_caps_str (h, in_caps, out_caps);
+  g_free (in_caps);
+  g_free (out_caps);
+
+  return h;
+}
+
+/* pushes @input, with the samples as in set_sample(), and compares the
+ * output with a plain matrix multiplication */
+static void
+check_mix (GstHarness * h, GstAudioFormat format, const gdouble * matrix,
+    guint in_channels, guint out_channels, const gdouble * input)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  guint bps = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8;
+  GstBuffer *inbuf, *outbuf;
+  GstMapInfo inmap, outmap;
+  gdouble tolerance;
+  guint n, in, out;
+
+  switch (format) {
+    case GST_AUDIO_FORMAT_F32:
+      tolerance = 1e-5;
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      tolerance = 1e-12;
+      break;
+    default:
+      /* rounding of the float accumulation */
+      tolerance = 1.0;
+      break;
+  }
+
+  inbuf = gst_buffer_new_allocate (NULL, N_SAMPLES * in_channels * bps, NULL);
+  fail_unless (gst_buffer_map (inbuf, &inmap, GST_MAP_WRITE));
+  for (n = 0; n < N_SAMPLES * in_channels; n++)
+    set_sample (format, inmap.data, n, input[n]);
+  gst_buffer_unmap (inbuf, &inmap);
+
+  fail_unless_equals_int (gst_harness_push (h, gst_buffer_ref (inbuf)),
+      GST_FLOW_OK);
+  outbuf = gst_harness_pull (h);
+  fail_unless (outbuf != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (outbuf),
+      N_SAMPLES * out_channels * bps);
+
+  fail_unless (gst_buffer_map (inbuf, &inmap, GST_MAP_READ));
+  fail_unless (gst_buffer_map (outbuf, &outmap, GST_MAP_READ));
+  for (n = 0; n < N_SAMPLES; n++) {
+    for (out = 0; out < out_channels; out++) {
+      gdouble expected = 0.0, actual;
+
+      for (in = 0; in < in_channels; in++)
+        expected += matrix[out * in_channels + in] *
+            get_sample (format, inmap.data, n * in_channels + in);
+
+      if (format == GST_AUDIO_FORMAT_S16)
+        expected = rint (CLAMP (expected, G_MININT16, G_MAXINT16));
+      else if (format == GST_AUDIO_FORMAT_S32)
+        expected = rint (CLAMP (expected, G_MININT32, G_MAXINT32));
+
+      actual = get_sample (format, outmap.data, n * out_channels + out);
+      if (fabs (actual - expected) > tolerance)
+        fail ("%s: sample %u channel %u is %f instead of %f",
+            gst_audio_format_to_string (format), n, out, actual, expected);
+    }
+  }
+  gst_buffer_unmap (outbuf, &outmap);
+  gst_buffer_unmap (inbuf, &inmap);
+
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (inbuf);
+}
+
+static gdouble *
+random_input (GRand * rand, guint channels, gdouble range)
+{
+  gdouble *input = g_new (gdouble, N_SAMPLES * channels);
+  guint n;
+
+  for (n = 0; n < N_SAMPLES * channels; n++)
+    input[n] = g_rand_double_range (rand, -range, range);
+
+  return input;
+}
+
+static void
+run_mix (const gdouble * matrix, guint in_channels, guint out_channels,
+    gdouble range)
+{
+  GRand *rand = g_rand_new_with_seed (in_channels * 1000 + out_channels);
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    GstHarness *h;
+    gdouble *input = random_input (rand, in_channels, range);
+
+    h = setup_mix_matrix (formats[i], matrix, in_channels, out_channels);
+    check_mix (h, formats[i], matrix, in_channels, out_channels, input);
+    gst_harness_teardown (h);
+    g_free (input);
+  }
+
+  g_rand_free (rand);
+}
+
+static gdouble *
+random_matrix (guint in_channels, guint out_channels)
+{
+  GRand *rand = g_rand_new_with_seed (in_channels * out_channels);
+  gdouble *matrix = g_new (gdouble, in_channels * out_channels);
+  guint i;
+
+  /* all coefficients non-zero, so that the dense mixing is used */
+  for (i = 0; i < in_channels * out_channels; i++) {
+    matrix[i] = g_rand_double_range (rand, 0.05, 1.0);
+    if (g_rand_boolean (rand))
+      matrix[i] = -matrix[i];
+  }
+  g_rand_free (rand);
+
+  return matrix;
+}
+
+/* output frames shorter than, equal to and longer than the SIMD width, so
+ * that the vectorized loops and their tails are all covered */
+GST_START_TEST (test_dense)
+{
+  static const guint channels[][2] = {
+    {1, 1}, {2, 2}, {6, 5}, {3, 8}, {4, 16}, {3, 19}, {8, 1}
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (channels); i++) {
+    gdouble *matrix = random_matrix (channels[i][0], channels[i][1]);
+
+    GST_DEBUG ("mixing %u to %u channels", channels[i][0], channels[i][1]);
+    run_mix (matrix, channels[i][0], channels[i][1], 0.25);
+    g_free (matrix);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_sparse)
+{
+  /* routing with a few downmixed channels, 10 of 64 coefficients */
+  static const gdouble matrix[] = {
+    1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+    0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+    0.5, 0.5, 0.7, 0.0, 0.0, 0.0, 0.0, 0.0,
+    0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+    0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0,
+    0.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0,
+    0.0, 0.0, 0.0, 0.3, 0.0, 0.0, 0.6, 0.0,
+    0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.25,
+  };
+
+  run_mix (matrix, 8, 8, 0.5);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_clipping)
+{
+  /* 4 of 4 coefficients, dense */
+  static const gdouble dense[] = {
+    1.0, 1.0,
+    -1.0, -1.0,
+  };
+  /* 4 of 16 coefficients, sparse */
+  static const gdouble sparse[] = {
+    1.0, 1.0, 0.0, 0.0,
+    0.0, 0.0, 0.0, 0.0,
+    0.0, 0.0, 0.0, 0.0,
+    0.0, 0.0, -1.0, -1.0,
+  };
+  static const GstAudioFormat int_formats[] = {
+    GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S32
+  };
+  gdouble input[N_SAMPLES * 4];
+  guint i, n;
+
+  /* close to full scale, so that most sums overflow in both directions */
+  for (n = 0; n < N_SAMPLES * 4; n++)
+    input[n] = (n % 3 == 0 ? -0.9 : 0.8) + 0.001 * (n % 7);
+
+  for (i = 0; i < G_N_ELEMENTS (int_formats); i++) {
+    GstHarness *h;
+
+    h = setup_mix_matrix (int_formats[i], dense, 2, 2);
+    check_mix (h, int_formats[i], dense, 2, 2, input);
+    gst_harness_teardown (h);
+
+    h = setup_mix_matrix (int_formats[i], sparse, 4, 4);
+    check_mix (h, int_formats[i], sparse, 4, 4, input);
+    gst_harness_teardown (h);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_matrix_change)
+{
+  /* 1 of 4 coefficients, sparse */
+  static const gdouble route[] = {
+    0.0, 1.0,
+    0.0, 0.0,
+  };
+  GRand *rand = g_rand_new_with_seed (42);
+  gdouble *input = random_input (rand, 2, 0.5);
+  gdouble *matrix = random_matrix (2, 2);
+  GstHarness *h;
+
+  /* switch from dense to sparse mixing while streaming */
+  h = setup_mix_matrix (GST_AUDIO_FORMAT_F32, matrix, 2, 2);
+  check_mix (h, GST_AUDIO_FORMAT_F32, matrix, 2, 2, input);
+  set_matrix (h->element, route, 2, 2);
+  check_mix (h, GST_AUDIO_FORMAT_F32, route, 2, 2, input);
+  set_matrix (h->element, matrix, 2, 2);
+  check_mix (h, GST_AUDIO_FORMAT_F32, matrix, 2, 2, input);
+  gst_harness_teardown (h);
+
+  g_free (matrix);
+  g_free (input);
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+static Suite *
+audiomixmatrix_suite (void)
+{
+  Suite *s = suite_create ("audiomixmatrix");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_dense);
+  tcase_add_test (tc_chain, test_sparse);
+  tcase_add_test (tc_chain, test_clipping);
+  tcase_add_test (tc_chain, test_matrix_change);
+
+  return s;
+}
+
+GST_CHECK_MAIN (audiomixmatrix);
@@ -750,6 +750,63 @@ GST_START_TEST
 
 GST_END_TEST;
 
+/*
+ * Test that contiguous SegmentTimeline S entries with the same duration are
+ * folded into a single entry
+ */
+GST_START_TEST (dash_mpdparser_segmentTimeline_compaction)
+{
+  GstMPDPeriodNode *periodNode;
+  GstMPDSegmentListNode *segmentList;
+  GstMPDSegmentTimelineNode *segmentTimeline;
+  GstMPDSNode *sNode;
+  const gchar *xml =
+      "<?xml version=\"1.0\"?>"
+      "<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\""
+      "     profiles=\"urn:mpeg:dash:profile:isoff-main:2011\">"
+      "  <Period>"
+      "    <SegmentList>"
+      "      <SegmentTimeline>"
+      "        <S t=\"1\" d=\"2\" r=\"1\"/>"
+      "        <S d=\"2\"/>"
+      "        <S t=\"7\" d=\"2\"/>"
+      "        <S d=\"3\"/>"
+      "        <S t=\"20\" d=\"3\"/>"
+      "      </SegmentTimeline></SegmentList></Period></MPD>";
+
+  gboolean ret;
+  GstMPDClient *mpdclient = gst_mpd_client_new ();
+
+  ret = gst_mpd_client_parse (mpdclient, xml, (gint) strlen (xml));
+  assert_equals_int (ret, TRUE);
+
+  periodNode = (GstMPDPeriodNode *) mpdclient->mpd_root_node->Periods->data;
+  segmentList = periodNode->SegmentList;
+  segmentTimeline =
+      GST_MPD_MULT_SEGMENT_BASE_NODE (segmentList)->SegmentTimeline;
+  assert_equals_int (g_queue_get_length (&segmentTimeline->S), 3);
+
+  sNode = (GstMPDSNode *) g_queue_peek_nth (&segmentTimeline->S, 0);
+  assert_equals_uint64 (sNode->t, 1);
+  assert_equals_uint64 (sNode->d, 2);
+  assert_equals_int (sNode->r, 3);
+
+  sNode = (GstMPDSNode *) g_queue_peek_nth (&segmentTimeline->S, 1);
+  assert_equals_uint64 (sNode->t, 0);
+  assert_equals_uint64 (sNode->d, 3);
+  assert_equals_int (sNode->r, 0);
+
+  /* Not contiguous with the previous entry */
+  sNode = (GstMPDSNode *) g_queue_peek_nth (&segmentTimeline->S, 2);
+  assert_equals_uint64 (sNode->t, 20);
+  assert_equals_uint64 (sNode->d, 3);
+  assert_equals_int (sNode->r, 0);
+
+  gst_mpd_client_free (mpdclient);
+}
+
+GST_END_TEST;
+
 /*
  * Test parsing Period SegmentList MultipleSegmentBaseType BitstreamSwitching
  * attributes
@@ -6512,6 +6569,7 @@ dash_suite (void)
       dash_mpdparser_period_segmentList_multipleSegmentBaseType_segmentTimeline);
   tcase_add_test (tc_simpleMPD,
       dash_mpdparser_period_segmentList_multipleSegmentBaseType_segmentTimeline_s);
+  tcase_add_test (tc_simpleMPD, dash_mpdparser_segmentTimeline_compaction);
   tcase_add_test (tc_simpleMPD,
       dash_mpdparser_period_segmentList_multipleSegmentBaseType_bitstreamSwitching);
   tcase_add_test (tc_simpleMPD, dash_mpdparser_period_segmentList_segmentURL);
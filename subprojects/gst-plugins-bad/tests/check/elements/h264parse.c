@@ -1242,6 +1242,67 @@ GST_START_TEST (test_parse_sei_closedcaptions)
 
 GST_END_TEST;
 
+/* converting to byte-stream should not copy slices but share their memory
+ * with the input */
+GST_START_TEST (test_parse_avc_to_bytestream_shares_slices)
+{
+  GstHarness *h;
+  GstBuffer *in_buf, *buf;
+  GstMapInfo in_map, map;
+  GstMemory *mem;
+  guint idx, length;
+  gsize skip, size;
+  const guint8 idr_header[] = {
+    0x65, 0x88, 0x84, 0x00, 0x10, 0xff, 0xfe, 0xf6, 0xf0, 0xfe, 0x05, 0x36
+  };
+  const gsize slice_size = 2000;
+  const guint8 start_code[] = { 0x00, 0x00, 0x00, 0x01 };
+
+  h = gst_harness_new ("h264parse");
+
+  gst_harness_set_src_caps_str (h,
+      "video/x-h264, stream-format=(string)avc, alignment=(string)au,"
+      " codec_data=(buffer)014d4015ffe10017674d4015eca4bf2e0220000003002ee6b28001e2c5b2c001000468ebecb2,"
+      " width=(int)32, height=(int)24, framerate=(fraction)30/1,"
+      " pixel-aspect-ratio=(fraction)1/1");
+  gst_harness_set_sink_caps_str (h,
+      "video/x-h264, stream-format=(string)byte-stream, alignment=(string)au");
+
+  in_buf = gst_buffer_new_and_alloc (4 + slice_size);
+  gst_buffer_map (in_buf, &in_map, GST_MAP_WRITE);
+  GST_WRITE_UINT32_BE (in_map.data, slice_size);
+  memset (in_map.data + 4, 0xa5, slice_size);
+  memcpy (in_map.data + 4, idr_header, sizeof (idr_header));
+  gst_buffer_unmap (in_buf, &in_map);
+
+  gst_buffer_map (gst_buffer_ref (in_buf), &in_map, GST_MAP_READ);
+  fail_unless_equals_int (gst_harness_push (h, in_buf), GST_FLOW_OK);
+
+  buf = gst_harness_pull (h);
+  size = gst_buffer_get_size (buf);
+  fail_unless (size > 4 + slice_size);
+  fail_unless (gst_buffer_memcmp (buf, size - slice_size - 4, start_code,
+          4) == 0);
+  fail_unless (gst_buffer_memcmp (buf, size - slice_size, in_map.data + 4,
+          slice_size) == 0);
+
+  fail_unless (gst_buffer_find_memory (buf, size - slice_size, slice_size,
+          &idx, &length, &skip));
+  fail_unless_equals_int (length, 1);
+  mem = gst_buffer_peek_memory (buf, idx);
+  fail_unless (gst_memory_map (mem, &map, GST_MAP_READ));
+  fail_unless (map.data + skip == in_map.data + 4);
+  gst_memory_unmap (mem, &map);
+
+  gst_buffer_unref (buf);
+  gst_buffer_unmap (in_buf, &in_map);
+  gst_buffer_unref (in_buf);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_parse_skip_to_4bytes_sc)
 {
   GstHarness *h;
@@ -1572,6 +1633,7 @@ main (int argc, char **argv)
     s = suite_create ("h264parse");
     suite_add_tcase (s, tc_chain);
     tcase_add_test (tc_chain, test_parse_sei_closedcaptions);
+    tcase_add_test (tc_chain, test_parse_avc_to_bytestream_shares_slices);
     tcase_add_test (tc_chain, test_parse_compatible_caps);
     tcase_add_test (tc_chain, test_parse_skip_to_4bytes_sc);
     tcase_add_test (tc_chain, test_parse_aud_insert);
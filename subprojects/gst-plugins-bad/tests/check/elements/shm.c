@@ -26,6 +26,10 @@
 
 #include <gst/gst.h>
 #include <gst/check/gstcheck.h>
+#include <gst/allocators/gstfdmemory.h>
+
+#include <glib/gstdio.h>
+#include <unistd.h>
 
 
 static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
@@ -169,6 +173,63 @@ GST_START_TEST (test_shm_alloc)
 
 GST_END_TEST;
 
+GST_START_TEST (test_shm_pass_fds)
+{
+  GstAllocator *alloc;
+  GstBuffer *buf;
+  GstMemory *mem;
+  GstMapInfo map;
+  GstSegment segment;
+  gchar *filename = NULL;
+  guint8 data[1000];
+  gint fd;
+  guint i;
+
+  g_object_set (sink, "pass-fds", TRUE, NULL);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("test"));
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  for (i = 0; i < sizeof (data); i++)
+    data[i] = i % 251;
+
+  fd = g_file_open_tmp (NULL, &filename, NULL);
+  fail_unless (fd >= 0);
+  g_unlink (filename);
+  g_free (filename);
+  fail_unless (write (fd, data, sizeof (data)) == sizeof (data));
+
+  alloc = gst_fd_allocator_new ();
+  mem = gst_fd_allocator_alloc (alloc, fd, sizeof (data),
+      GST_FD_MEMORY_FLAG_NONE);
+  gst_object_unref (alloc);
+
+  /* only send a part of the memory */
+  gst_memory_resize (mem, 10, sizeof (data) - 20);
+  buf = gst_buffer_new ();
+  gst_buffer_append_memory (buf, mem);
+
+  fail_unless (gst_pad_push (srcpad, buf) == GST_FLOW_OK);
+
+  g_mutex_lock (&check_mutex);
+  while (buffers == NULL)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+  fail_unless (g_list_length (buffers) == 1);
+
+  buf = buffers->data;
+  fail_unless_equals_int (gst_buffer_get_size (buf), sizeof (data) - 20);
+  fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+  fail_unless (memcmp (map.data, data + 10, map.size) == 0);
+  gst_buffer_unmap (buf, &map);
+
+  gst_check_drop_buffers ();
+  teardown_shm ();
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_shm_live)
 {
   GstElement *producer, *consumer;
@@ -239,6 +300,7 @@ shm_suite (void)
   tcase_add_checked_fixture (tc, setup_shm, NULL);
   tcase_add_test (tc, test_shm_sysmem_alloc);
   tcase_add_test (tc, test_shm_alloc);
+  tcase_add_test (tc, test_shm_pass_fds);
   suite_add_tcase (s, tc);
 
   tc = tcase_create ("shm2");
@@ -0,0 +1,96 @@
+/* GStreamer
+ *
+ * unit test for vah264enc
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+
+#define NUM_FRAMES 30
+
+GST_START_TEST (async_depth)
+{
+  GstHarness *h;
+  GstElement *enc;
+  GstBuffer *buf;
+  GstClockTime last_dts = GST_CLOCK_TIME_NONE;
+  guint async_depth, i;
+
+  h = gst_harness_new_parse ("videotestsrc num-buffers=" G_STRINGIFY
+      (NUM_FRAMES) " ! video/x-raw, format=(string)NV12, width=(int)320, "
+      "height=(int)240, framerate=(fraction)30/1 ! "
+      "vah264enc name=enc b-frames=2 async-depth=4");
+  ck_assert (h);
+
+  enc = gst_bin_get_by_name (GST_BIN (h->element), "enc");
+  ck_assert (enc);
+
+  gst_harness_play (h);
+
+  /* can't be changed anymore, the surfaces were allocated for it */
+  g_object_set (enc, "async-depth", 1, NULL);
+  g_object_get (enc, "async-depth", &async_depth, NULL);
+  fail_unless_equals_int (async_depth, 4);
+
+  /* the frames kept in flight are all output in order when draining */
+  for (i = 0; i < NUM_FRAMES; i++) {
+    buf = gst_harness_pull (h);
+    ck_assert (buf);
+    ck_assert (GST_BUFFER_DTS_IS_VALID (buf));
+    if (GST_CLOCK_TIME_IS_VALID (last_dts))
+      ck_assert (GST_BUFFER_DTS (buf) > last_dts);
+    last_dts = GST_BUFFER_DTS (buf);
+    gst_buffer_unref (buf);
+  }
+
+  fail_unless (gst_harness_try_pull (h) == NULL);
+
+  gst_object_unref (enc);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+int
+main (int argc, char **argv)
+{
+  GstElement *enc;
+  Suite *s;
+  TCase *tc_chain;
+
+  gst_check_init (&argc, &argv);
+
+  enc = gst_element_factory_make ("vah264enc", NULL);
+  if (!enc)
+    return EXIT_SUCCESS;        /* not available vah264enc */
+  gst_object_unref (enc);
+
+  s = suite_create ("vah264enc");
+  tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, async_depth);
+
+  return gst_check_run_suite (s, "vah264enc", __FILE__);
+}
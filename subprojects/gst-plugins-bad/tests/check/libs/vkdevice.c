@@ -55,6 +55,35 @@ GST_START_TEST (test_device_new)
 
 GST_END_TEST;
 
+GST_START_TEST (test_device_select_queue)
+{
+  GstVulkanDevice *device;
+  GstVulkanQueue *queue;
+  VkQueueFlags flags;
+
+  device = gst_vulkan_device_new_with_index (instance, 0);
+  fail_unless (gst_vulkan_device_open (device, NULL));
+
+  queue = gst_vulkan_device_select_queue (device, VK_QUEUE_GRAPHICS_BIT);
+  fail_unless (queue != NULL);
+  flags = device->physical_device->queue_family_props[queue->family].queueFlags;
+  fail_unless ((flags & VK_QUEUE_GRAPHICS_BIT) != 0);
+  gst_object_unref (queue);
+
+  /* every queue family has a queue */
+  queue = gst_vulkan_device_select_queue (device, VK_QUEUE_TRANSFER_BIT);
+  if (queue) {
+    flags =
+        device->physical_device->queue_family_props[queue->family].queueFlags;
+    fail_unless ((flags & VK_QUEUE_TRANSFER_BIT) != 0);
+    gst_object_unref (queue);
+  }
+
+  gst_object_unref (device);
+}
+
+GST_END_TEST;
+
 static Suite *
 vkdevice_suite (void)
 {
@@ -71,6 +100,7 @@ vkdevice_suite (void)
   gst_object_unref (instance);
   if (have_instance) {
     tcase_add_test (tc_basic, test_device_new);
+    tcase_add_test (tc_basic, test_device_select_queue);
   }
 
   return s;
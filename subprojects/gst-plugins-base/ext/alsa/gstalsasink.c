@@ -61,6 +61,8 @@
 #define DEFAULT_DEVICE		"default"
 #define DEFAULT_DEVICE_NAME	""
 #define DEFAULT_CARD_NAME	""
+#define DEFAULT_USE_MMAP	FALSE
+#define DEFAULT_TIMER_SCHEDULING	FALSE
 #define SPDIF_PERIOD_SIZE 1536
 #define SPDIF_BUFFER_SIZE 15360
 
@@ -70,6 +72,8 @@ enum
   PROP_DEVICE,
   PROP_DEVICE_NAME,
   PROP_CARD_NAME,
+  PROP_USE_MMAP,
+  PROP_TIMER_SCHEDULING,
   PROP_LAST
 };
 
@@ -195,6 +199,36 @@ gst_alsasink_class_init (GstAlsaSinkClass * klass)
           "Human-readable name of the sound card", DEFAULT_CARD_NAME,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_DOC_SHOW_DEFAULT));
+
+  /**
+   * GstAlsaSink:use-mmap:
+   *
+   * Access the device buffer through mmap and copy the ringbuffer segments
+   * directly into it instead of going through snd_pcm_writei(). Falls back to
+   * read/write access when the device does not support mmap.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Write to the device buffer through mmap", DEFAULT_USE_MMAP,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAlsaSink:timer-scheduling:
+   *
+   * Wake up based on the device position and a timer instead of waiting for
+   * period interrupts. Period wakeups are disabled when the device allows it
+   * and the ringbuffer segments follow #GstAudioBaseSink:latency-time, so
+   * they can be smaller than the hardware period.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_TIMER_SCHEDULING,
+      g_param_spec_boolean ("timer-scheduling", "Timer scheduling",
+          "Use timer based wakeups instead of period interrupts",
+          DEFAULT_TIMER_SCHEDULING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -214,6 +248,12 @@ gst_alsasink_set_property (GObject * object, guint prop_id,
         sink->device = g_strdup (DEFAULT_DEVICE);
       }
       break;
+    case PROP_USE_MMAP:
+      sink->use_mmap = g_value_get_boolean (value);
+      break;
+    case PROP_TIMER_SCHEDULING:
+      sink->timer_scheduling = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -242,6 +282,12 @@ gst_alsasink_get_property (GObject * object, guint prop_id,
           gst_alsa_find_card_name (GST_OBJECT_CAST (sink),
               sink->device, SND_PCM_STREAM_PLAYBACK));
       break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, sink->use_mmap);
+      break;
+    case PROP_TIMER_SCHEDULING:
+      g_value_set_boolean (value, sink->timer_scheduling);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -259,6 +305,8 @@ gst_alsasink_init (GstAlsaSink * alsasink)
   alsasink->is_paused = FALSE;
   alsasink->after_paused = FALSE;
   alsasink->hw_support_pause = FALSE;
+  alsasink->use_mmap = DEFAULT_USE_MMAP;
+  alsasink->timer_scheduling = DEFAULT_TIMER_SCHEDULING;
   g_mutex_init (&alsasink->alsa_lock);
   g_mutex_init (&alsasink->delay_lock);
 
@@ -438,6 +486,11 @@ set_hwparams (GstAlsaSink * alsa)
   /* choose all parameters */
   CHECK (snd_pcm_hw_params_any (alsa->handle, params), no_config);
   /* set the interleaved read/write format */
+  if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED &&
+      snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access) < 0) {
+    GST_WARNING_OBJECT (alsa, "mmap access not supported, using read/write");
+    alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  }
   CHECK (snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access),
       wrong_access);
   /* set the sample format */
@@ -460,6 +513,16 @@ set_hwparams (GstAlsaSink * alsa)
   rrate = alsa->rate;
   CHECK (snd_pcm_hw_params_set_rate_near (alsa->handle, params, &rrate, NULL),
       no_rate);
+#if GST_CHECK_ALSA_VERSION(1,0,24)
+  /* we wake up on our own timer, no need for period interrupts */
+  if (alsa->timer_scheduling &&
+      (err = snd_pcm_hw_params_set_period_wakeup (alsa->handle, params,
+              0)) < 0) {
+    GST_DEBUG_OBJECT (alsa, "Unable to disable period wakeups: %s",
+        snd_strerror (err));
+    snd_pcm_hw_params_set_period_wakeup (alsa->handle, params, 1);
+  }
+#endif
 #ifndef GST_DISABLE_GST_DEBUG
   /* get and dump some limits */
   {
@@ -846,7 +909,8 @@ alsasink_parse_spec (GstAlsaSink * alsa, GstAudioRingBufferSpec * spec)
   alsa->channels = GST_AUDIO_INFO_CHANNELS (&spec->info);
   alsa->buffer_time = spec->buffer_time;
   alsa->period_time = spec->latency_time;
-  alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  alsa->access = alsa->use_mmap ? SND_PCM_ACCESS_MMAP_INTERLEAVED :
+      SND_PCM_ACCESS_RW_INTERLEAVED;
 
   if (spec->type == GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW && alsa->channels < 9)
     gst_audio_ring_buffer_set_channel_positions (GST_AUDIO_BASE_SINK
@@ -918,8 +982,20 @@ gst_alsasink_prepare (GstAudioSink * asink, GstAudioRingBufferSpec * spec)
   CHECK (set_swparams (alsa), sw_params_failed);
 
   alsa->bpf = GST_AUDIO_INFO_BPF (&spec->info);
-  spec->segsize = alsa->period_size * alsa->bpf;
-  spec->segtotal = alsa->buffer_size / alsa->period_size;
+  if (alsa->timer_scheduling && !alsa->iec958) {
+    snd_pcm_uframes_t segment_size;
+
+    /* we don't depend on period interrupts, so segments can follow the
+     * requested latency even when the hardware period is larger */
+    segment_size = gst_util_uint64_scale_int (spec->latency_time, alsa->rate,
+        G_USEC_PER_SEC);
+    segment_size = CLAMP (segment_size, 1, alsa->period_size);
+    spec->segsize = segment_size * alsa->bpf;
+    spec->segtotal = alsa->buffer_size / segment_size;
+  } else {
+    spec->segsize = alsa->period_size * alsa->bpf;
+    spec->segtotal = alsa->buffer_size / alsa->period_size;
+  }
 
   {
     snd_output_t *out_buf = NULL;
@@ -1035,6 +1111,72 @@ xrun_recovery (GstAlsaSink * alsa, snd_pcm_t * handle, gint err)
   return err;
 }
 
+/* Waits until @frames frames can be written. With timer based scheduling we
+ * sleep for the time the device needs to play the missing frames instead of
+ * waiting for the next period interrupt. Returns a negative error code or a
+ * positive value when writing can proceed. */
+static gint
+gst_alsasink_wait (GstAlsaSink * alsa, snd_pcm_uframes_t frames)
+{
+  snd_pcm_sframes_t avail;
+
+  if (!alsa->timer_scheduling)
+    return snd_pcm_wait (alsa->handle, (4 * alsa->period_time / 1000));
+
+  /* before the device is started the buffer is still being filled */
+  if (snd_pcm_state (alsa->handle) != SND_PCM_STATE_RUNNING)
+    return 1;
+
+  avail = snd_pcm_avail_update (alsa->handle);
+  if (avail < 0)
+    return avail;
+
+  if (avail < frames)
+    g_usleep (MAX (gst_util_uint64_scale_int (frames - avail,
+                G_USEC_PER_SEC, alsa->rate), 100));
+
+  return 1;
+}
+
+static snd_pcm_sframes_t
+gst_alsasink_mmap_write (GstAlsaSink * alsa, const guint8 * data,
+    snd_pcm_uframes_t frames)
+{
+  const snd_pcm_channel_area_t *areas;
+  snd_pcm_uframes_t offset, size, start_threshold;
+  snd_pcm_sframes_t avail, committed;
+  guint8 *dest;
+  gint err;
+
+  avail = snd_pcm_avail_update (alsa->handle);
+  if (avail <= 0)
+    return avail;
+
+  size = MIN (frames, avail);
+  if ((err = snd_pcm_mmap_begin (alsa->handle, &areas, &offset, &size)) < 0)
+    return err;
+
+  /* interleaved access, all channels share the first area */
+  dest = (guint8 *) areas[0].addr + areas[0].first / 8 +
+      offset * areas[0].step / 8;
+  memcpy (dest, data, size * alsa->bpf);
+
+  committed = snd_pcm_mmap_commit (alsa->handle, offset, size);
+  if (committed < 0)
+    return committed;
+
+  /* unlike snd_pcm_writei(), committing doesn't start the device when the
+   * start threshold is reached */
+  start_threshold = (alsa->buffer_size / alsa->period_size) * alsa->period_size;
+  if (snd_pcm_state (alsa->handle) == SND_PCM_STATE_PREPARED &&
+      alsa->buffer_size - (avail - committed) >= start_threshold) {
+    if ((err = snd_pcm_start (alsa->handle)) < 0)
+      return err;
+  }
+
+  return committed;
+}
+
 static gint
 gst_alsasink_write (GstAudioSink * asink, gpointer data, guint length)
 {
@@ -1061,14 +1203,17 @@ gst_alsasink_write (GstAudioSink * asink, gpointer data, guint length)
 
   GST_ALSA_SINK_LOCK (asink);
   while (cptr > 0) {
-    /* start by doing a blocking wait for free space. Set the timeout
-     * to 4 times the period time */
-    err = snd_pcm_wait (alsa->handle, (4 * alsa->period_time / 1000));
+    /* start by waiting for free space, either blocking with a timeout of
+     * 4 times the period time or on our own timer */
+    err = gst_alsasink_wait (alsa, cptr);
     if (err < 0) {
       GST_DEBUG_OBJECT (asink, "wait error, %d", err);
     } else {
       GST_DELAY_SINK_LOCK (asink);
-      err = snd_pcm_writei (alsa->handle, ptr, cptr);
+      if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+        err = gst_alsasink_mmap_write (alsa, ptr, cptr);
+      else
+        err = snd_pcm_writei (alsa->handle, ptr, cptr);
       GST_DELAY_SINK_UNLOCK (asink);
     }
 
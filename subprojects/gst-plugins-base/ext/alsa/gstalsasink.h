@@ -79,6 +79,9 @@ struct _GstAlsaSink {
   gboolean hw_support_pause;
   snd_pcm_sframes_t pos_in_buffer;
 
+  gboolean use_mmap;
+  gboolean timer_scheduling;
+
   GMutex alsa_lock;
   GMutex delay_lock;
 };
@@ -58,6 +58,8 @@
 #define DEFAULT_PROP_DEVICE_NAME	  ""
 #define DEFAULT_PROP_CARD_NAME	          ""
 #define DEFAULT_PROP_USE_DRIVER_TIMESTAMP TRUE
+#define DEFAULT_PROP_USE_MMAP		  FALSE
+#define DEFAULT_PROP_TIMER_SCHEDULING	  FALSE
 
 enum
 {
@@ -66,6 +68,8 @@ enum
   PROP_DEVICE_NAME,
   PROP_CARD_NAME,
   PROP_USE_DRIVER_TIMESTAMP,
+  PROP_USE_MMAP,
+  PROP_TIMER_SCHEDULING,
   PROP_LAST
 };
 
@@ -182,6 +186,36 @@ gst_alsasrc_class_init (GstAlsaSrcClass * klass)
           "Use driver timestamps or the pipeline clock timestamps",
           DEFAULT_PROP_USE_DRIVER_TIMESTAMP,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAlsaSrc:use-mmap:
+   *
+   * Access the device buffer through mmap and copy the captured frames
+   * directly out of it instead of going through snd_pcm_readi(). Falls back
+   * to read/write access when the device does not support mmap.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Read from the device buffer through mmap", DEFAULT_PROP_USE_MMAP,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAlsaSrc:timer-scheduling:
+   *
+   * Wake up based on the device position and a timer instead of waiting for
+   * period interrupts. Period wakeups are disabled when the device allows it
+   * and the ringbuffer segments follow #GstAudioBaseSrc:latency-time, so
+   * they can be smaller than the hardware period.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_TIMER_SCHEDULING,
+      g_param_spec_boolean ("timer-scheduling", "Timer scheduling",
+          "Use timer based wakeups instead of period interrupts",
+          DEFAULT_PROP_TIMER_SCHEDULING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -205,6 +239,12 @@ gst_alsasrc_set_property (GObject * object, guint prop_id,
       src->use_driver_timestamps = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (src);
       break;
+    case PROP_USE_MMAP:
+      src->use_mmap = g_value_get_boolean (value);
+      break;
+    case PROP_TIMER_SCHEDULING:
+      src->timer_scheduling = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -238,6 +278,12 @@ gst_alsasrc_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, src->use_driver_timestamps);
       GST_OBJECT_UNLOCK (src);
       break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, src->use_mmap);
+      break;
+    case PROP_TIMER_SCHEDULING:
+      g_value_set_boolean (value, src->timer_scheduling);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -299,6 +345,8 @@ gst_alsasrc_init (GstAlsaSrc * alsasrc)
   alsasrc->cached_caps = NULL;
   alsasrc->driver_timestamps = FALSE;
   alsasrc->use_driver_timestamps = DEFAULT_PROP_USE_DRIVER_TIMESTAMP;
+  alsasrc->use_mmap = DEFAULT_PROP_USE_MMAP;
+  alsasrc->timer_scheduling = DEFAULT_PROP_TIMER_SCHEDULING;
 
   g_mutex_init (&alsasrc->alsa_lock);
 }
@@ -376,6 +424,11 @@ set_hwparams (GstAlsaSrc * alsa)
   /* choose all parameters */
   CHECK (snd_pcm_hw_params_any (alsa->handle, params), no_config);
   /* set the interleaved read/write format */
+  if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED &&
+      snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access) < 0) {
+    GST_WARNING_OBJECT (alsa, "mmap access not supported, using read/write");
+    alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  }
   CHECK (snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access),
       wrong_access);
   /* set the sample format */
@@ -390,6 +443,16 @@ set_hwparams (GstAlsaSrc * alsa)
       no_rate);
   if (rrate != alsa->rate)
     goto rate_match;
+#if GST_CHECK_ALSA_VERSION(1,0,24)
+  /* we wake up on our own timer, no need for period interrupts */
+  if (alsa->timer_scheduling &&
+      (err = snd_pcm_hw_params_set_period_wakeup (alsa->handle, params,
+              0)) < 0) {
+    GST_DEBUG_OBJECT (alsa, "Unable to disable period wakeups: %s",
+        snd_strerror (err));
+    snd_pcm_hw_params_set_period_wakeup (alsa->handle, params, 1);
+  }
+#endif
 
 #ifndef GST_DISABLE_GST_DEBUG
   /* get and dump some limits */
@@ -750,7 +813,8 @@ alsasrc_parse_spec (GstAlsaSrc * alsa, GstAudioRingBufferSpec * spec)
   alsa->channels = GST_AUDIO_INFO_CHANNELS (&spec->info);
   alsa->buffer_time = spec->buffer_time;
   alsa->period_time = spec->latency_time;
-  alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  alsa->access = alsa->use_mmap ? SND_PCM_ACCESS_MMAP_INTERLEAVED :
+      SND_PCM_ACCESS_RW_INTERLEAVED;
 
   if (spec->type == GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW && alsa->channels < 9)
     gst_audio_ring_buffer_set_channel_positions (GST_AUDIO_BASE_SRC
@@ -807,15 +871,33 @@ gst_alsasrc_prepare (GstAudioSrc * asrc, GstAudioRingBufferSpec * spec)
   if (!alsasrc_parse_spec (alsa, spec))
     goto spec_parse;
 
-  CHECK (snd_pcm_nonblock (alsa->handle, 0), non_block);
+  /* timer based scheduling polls the device and must not block in
+   * snd_pcm_readi() */
+  CHECK (snd_pcm_nonblock (alsa->handle, alsa->timer_scheduling ? 1 : 0),
+      non_block);
 
   CHECK (set_hwparams (alsa), hw_params_failed);
   CHECK (set_swparams (alsa), sw_params_failed);
   CHECK (snd_pcm_prepare (alsa->handle), prepare_failed);
 
   alsa->bpf = GST_AUDIO_INFO_BPF (&spec->info);
-  spec->segsize = alsa->period_size * alsa->bpf;
-  spec->segtotal = alsa->buffer_size / alsa->period_size;
+  if (alsa->timer_scheduling) {
+    snd_pcm_uframes_t segment_size;
+
+    /* we don't depend on period interrupts, so segments can follow the
+     * requested latency even when the hardware period is larger */
+    segment_size = gst_util_uint64_scale_int (spec->latency_time, alsa->rate,
+        G_USEC_PER_SEC);
+    segment_size = CLAMP (segment_size, 1, alsa->period_size);
+    spec->segsize = segment_size * alsa->bpf;
+    spec->segtotal = alsa->buffer_size / segment_size;
+    alsa->segment_time =
+        gst_util_uint64_scale_int (segment_size, G_USEC_PER_SEC, alsa->rate);
+  } else {
+    spec->segsize = alsa->period_size * alsa->bpf;
+    spec->segtotal = alsa->buffer_size / alsa->period_size;
+    alsa->segment_time = alsa->period_time;
+  }
 
   {
     snd_output_t *out_buf = NULL;
@@ -982,7 +1064,7 @@ gst_alsasrc_get_timestamp (GstAlsaSrc * asrc)
 
   /* compensate for the fact that we really need the timestamp of the
    * previously read data segment */
-  timestamp -= asrc->period_time * 1000;
+  timestamp -= asrc->segment_time * 1000;
 
   snd_pcm_status_free (status);
 
@@ -992,6 +1074,72 @@ gst_alsasrc_get_timestamp (GstAlsaSrc * asrc)
   return timestamp;
 }
 
+/* Waits until @frames frames can be read. With timer based scheduling we
+ * sleep for the time the device needs to capture the missing frames instead
+ * of waiting for the next period interrupt. Returns a negative error code or
+ * a positive value when reading can proceed. */
+static gint
+gst_alsasrc_wait (GstAlsaSrc * alsa, snd_pcm_uframes_t frames)
+{
+  snd_pcm_sframes_t avail;
+  gint err;
+
+  /* unlike snd_pcm_readi(), mmap access doesn't start the device */
+  if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED &&
+      snd_pcm_state (alsa->handle) == SND_PCM_STATE_PREPARED) {
+    if ((err = snd_pcm_start (alsa->handle)) < 0)
+      return err;
+  }
+
+  if (!alsa->timer_scheduling) {
+    /* snd_pcm_readi() does a blocking wait by itself */
+    if (alsa->access != SND_PCM_ACCESS_MMAP_INTERLEAVED)
+      return 1;
+    return snd_pcm_wait (alsa->handle, (4 * alsa->period_time / 1000));
+  }
+
+  if (snd_pcm_state (alsa->handle) != SND_PCM_STATE_RUNNING)
+    return 1;
+
+  avail = snd_pcm_avail_update (alsa->handle);
+  if (avail < 0)
+    return avail;
+
+  if (avail < frames)
+    g_usleep (MAX (gst_util_uint64_scale_int (frames - avail,
+                G_USEC_PER_SEC, alsa->rate), 100));
+
+  return 1;
+}
+
+static snd_pcm_sframes_t
+gst_alsasrc_mmap_read (GstAlsaSrc * alsa, guint8 * data,
+    snd_pcm_uframes_t frames)
+{
+  const snd_pcm_channel_area_t *areas;
+  snd_pcm_uframes_t offset, size;
+  snd_pcm_sframes_t avail;
+  const guint8 *src;
+  gint err;
+
+  avail = snd_pcm_avail_update (alsa->handle);
+  if (avail < 0)
+    return avail;
+  if (avail == 0)
+    return -EAGAIN;
+
+  size = MIN (frames, avail);
+  if ((err = snd_pcm_mmap_begin (alsa->handle, &areas, &offset, &size)) < 0)
+    return err;
+
+  /* interleaved access, all channels share the first area */
+  src = (const guint8 *) areas[0].addr + areas[0].first / 8 +
+      offset * areas[0].step / 8;
+  memcpy (data, src, size * alsa->bpf);
+
+  return snd_pcm_mmap_commit (alsa->handle, offset, size);
+}
+
 static guint
 gst_alsasrc_read (GstAudioSrc * asrc, gpointer data, guint length,
     GstClockTime * timestamp)
@@ -1007,7 +1155,15 @@ gst_alsasrc_read (GstAudioSrc * asrc, gpointer data, guint length,
 
   GST_ALSA_SRC_LOCK (asrc);
   while (cptr > 0) {
-    if ((err = snd_pcm_readi (alsa->handle, ptr, cptr)) < 0) {
+    err = gst_alsasrc_wait (alsa, cptr);
+    if (err >= 0) {
+      if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+        err = gst_alsasrc_mmap_read (alsa, ptr, cptr);
+      else
+        err = snd_pcm_readi (alsa->handle, ptr, cptr);
+    }
+
+    if (err < 0) {
       if (err == -EAGAIN) {
         GST_DEBUG_OBJECT (asrc, "Read error: %s", snd_strerror (err));
         continue;
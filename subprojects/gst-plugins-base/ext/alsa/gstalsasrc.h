@@ -70,6 +70,11 @@ struct _GstAlsaSrc {
   guint                 period_time;
   snd_pcm_uframes_t     buffer_size;
   snd_pcm_uframes_t     period_size;
+  /* duration of a ringbuffer segment in microseconds */
+  guint                 segment_time;
+
+  gboolean              use_mmap;
+  gboolean              timer_scheduling;
 
   GMutex                alsa_lock;
 };
@@ -803,8 +803,25 @@ static gboolean gst_gl_download_element_src_event (GstBaseTransform * bt,
     GstEvent * event);
 static gboolean gst_gl_download_element_propose_allocation (GstBaseTransform *
     bt, GstQuery * decide_query, GstQuery * query);
+static GstFlowReturn
+gst_gl_download_element_generate_output (GstBaseTransform * bt,
+    GstBuffer ** outbuf);
+static gboolean gst_gl_download_element_query (GstBaseTransform * bt,
+    GstPadDirection direction, GstQuery * query);
+static void gst_gl_download_element_set_property (GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec);
+static void gst_gl_download_element_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec);
 static void gst_gl_download_element_finalize (GObject * object);
 
+#define DEFAULT_DOWNLOAD_DELAY 0
+
+enum
+{
+  PROP_0,
+  PROP_DOWNLOAD_DELAY,
+};
+
 #define GST_CAPS_FEATURE_MEMORY_NVMM "memory:NVMM"
 
 #if GST_GL_HAVE_PLATFORM_EGL && defined(HAVE_NVMM)
@@ -853,9 +870,34 @@ gst_gl_download_element_class_init (GstGLDownloadElementClass * klass)
   bt_class->src_event = gst_gl_download_element_src_event;
   bt_class->propose_allocation = gst_gl_download_element_propose_allocation;
   bt_class->transform_meta = gst_gl_download_element_transform_meta;
+  bt_class->generate_output = gst_gl_download_element_generate_output;
+  bt_class->query = gst_gl_download_element_query;
 
   bt_class->passthrough_on_same_caps = TRUE;
 
+  object_class->set_property = gst_gl_download_element_set_property;
+  object_class->get_property = gst_gl_download_element_get_property;
+
+  /**
+   * GstGLDownloadElement:download-delay:
+   *
+   * Number of frames the output is delayed by when downloading to system
+   * memory through PBOs. The download of a frame is started when it is
+   * received and the frame is only pushed once this many newer frames were
+   * received, so the readback completes in the background and mapping the
+   * frame doesn't stall the GL pipeline. This adds as many frames of
+   * latency.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (object_class, PROP_DOWNLOAD_DELAY,
+      g_param_spec_uint ("download-delay", "Download delay",
+          "Number of frames to delay the output by to let PBO downloads "
+          "complete asynchronously (0 = disabled)", 0, 16,
+          DEFAULT_DOWNLOAD_DELAY,
+          GST_PARAM_MUTABLE_READY | G_PARAM_READWRITE |
+          G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (element_class,
       &gst_gl_download_element_src_pad_template);
   gst_element_class_add_static_pad_template (element_class,
@@ -873,6 +915,81 @@ gst_gl_download_element_init (GstGLDownloadElement * download)
 {
   gst_base_transform_set_prefer_passthrough (GST_BASE_TRANSFORM (download),
       TRUE);
+
+  download->download_delay = DEFAULT_DOWNLOAD_DELAY;
+  g_queue_init (&download->pending);
+}
+
+static void
+gst_gl_download_element_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstGLDownloadElement *dl = GST_GL_DOWNLOAD_ELEMENT (object);
+
+  switch (prop_id) {
+    case PROP_DOWNLOAD_DELAY:
+      GST_OBJECT_LOCK (dl);
+      dl->download_delay = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (dl);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_gl_download_element_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstGLDownloadElement *dl = GST_GL_DOWNLOAD_ELEMENT (object);
+
+  switch (prop_id) {
+    case PROP_DOWNLOAD_DELAY:
+      GST_OBJECT_LOCK (dl);
+      g_value_set_uint (value, dl->download_delay);
+      GST_OBJECT_UNLOCK (dl);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static guint
+gst_gl_download_element_get_download_delay (GstGLDownloadElement * dl)
+{
+  guint delay;
+
+  GST_OBJECT_LOCK (dl);
+  delay = dl->download_delay;
+  GST_OBJECT_UNLOCK (dl);
+
+  return delay;
+}
+
+static GstFlowReturn
+gst_gl_download_element_drain (GstGLDownloadElement * dl)
+{
+  GstBaseTransform *bt = GST_BASE_TRANSFORM (dl);
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBuffer *buffer;
+
+  while ((buffer = g_queue_pop_head (&dl->pending))) {
+    if (ret == GST_FLOW_OK)
+      ret = gst_pad_push (bt->srcpad, buffer);
+    else
+      gst_buffer_unref (buffer);
+  }
+
+  return ret;
+}
+
+static void
+gst_gl_download_element_clear_pending (GstGLDownloadElement * dl)
+{
+  g_queue_foreach (&dl->pending, (GFunc) gst_buffer_unref, NULL);
+  g_queue_clear (&dl->pending);
 }
 
 static gboolean
@@ -898,6 +1015,8 @@ gst_gl_download_element_stop (GstBaseTransform * bt)
     dl->dmabuf_allocator = NULL;
   }
 
+  gst_gl_download_element_clear_pending (dl);
+
   return TRUE;
 }
 
@@ -1335,6 +1454,49 @@ gst_gl_download_element_prepare_output_buffer (GstBaseTransform * bt,
   return GST_FLOW_OK;
 }
 
+static void
+_flush_gl (GstGLContext * context, gpointer data)
+{
+  context->gl_vtable->Flush ();
+}
+
+static GstFlowReturn
+gst_gl_download_element_generate_output (GstBaseTransform * bt,
+    GstBuffer ** outbuf)
+{
+  GstGLDownloadElement *dl = GST_GL_DOWNLOAD_ELEMENT (bt);
+  GstFlowReturn ret;
+  guint delay;
+
+  ret = GST_BASE_TRANSFORM_CLASS (parent_class)->generate_output (bt, outbuf);
+  if (ret != GST_FLOW_OK || *outbuf == NULL)
+    return ret;
+
+  delay = gst_gl_download_element_get_download_delay (dl);
+  if (dl->mode != GST_GL_DOWNLOAD_MODE_PBO_TRANSFERS || delay == 0) {
+    if (g_queue_is_empty (&dl->pending))
+      return ret;
+
+    /* keep the order with the frames delayed previously */
+    g_queue_push_tail (&dl->pending, *outbuf);
+    *outbuf = NULL;
+    return gst_gl_download_element_drain (dl);
+  }
+
+  /* make sure the readbacks are submitted now instead of whenever the
+   * frame gets mapped */
+  gst_gl_context_thread_add (GST_GL_BASE_FILTER (bt)->context,
+      (GstGLContextThreadFunc) _flush_gl, NULL);
+
+  g_queue_push_tail (&dl->pending, *outbuf);
+  *outbuf = NULL;
+
+  if (g_queue_get_length (&dl->pending) > delay)
+    *outbuf = g_queue_pop_head (&dl->pending);
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_gl_download_element_transform (GstBaseTransform * bt,
     GstBuffer * inbuf, GstBuffer * outbuf)
@@ -1342,6 +1504,43 @@ gst_gl_download_element_transform (GstBaseTransform * bt,
   return GST_FLOW_OK;
 }
 
+static gboolean
+gst_gl_download_element_query (GstBaseTransform * bt,
+    GstPadDirection direction, GstQuery * query)
+{
+  GstGLDownloadElement *dl = GST_GL_DOWNLOAD_ELEMENT (bt);
+  gboolean ret;
+
+  ret = GST_BASE_TRANSFORM_CLASS (parent_class)->query (bt, direction, query);
+
+  if (ret && direction == GST_PAD_SRC &&
+      GST_QUERY_TYPE (query) == GST_QUERY_LATENCY) {
+    guint delay = gst_gl_download_element_get_download_delay (dl);
+    GstClockTime min, max, latency = 0;
+    gboolean live;
+    GstCaps *caps;
+    GstVideoInfo info;
+
+    caps = gst_pad_get_current_caps (bt->sinkpad);
+    if (delay > 0 && caps && gst_video_info_from_caps (&info, caps) &&
+        info.fps_n > 0) {
+      latency = gst_util_uint64_scale_int (delay * GST_SECOND, info.fps_d,
+          info.fps_n);
+    }
+    gst_clear_caps (&caps);
+
+    if (latency > 0) {
+      gst_query_parse_latency (query, &live, &min, &max);
+      min += latency;
+      if (max != GST_CLOCK_TIME_NONE)
+        max += latency;
+      gst_query_set_latency (query, live, min, max);
+    }
+  }
+
+  return ret;
+}
+
 static gboolean
 gst_gl_download_element_transform_meta (GstBaseTransform * bt,
     GstBuffer * outbuf, GstMeta * meta, GstBuffer * inbuf)
@@ -1376,9 +1575,23 @@ gst_gl_download_element_sink_event (GstBaseTransform * bt, GstEvent * event)
 {
   GstGLDownloadElement *dl = GST_GL_DOWNLOAD_ELEMENT (bt);
 
-  /* Retry exporting whenever we have new caps from upstream */
-  if (GST_EVENT_TYPE (event) == GST_EVENT_CAPS)
-    g_atomic_int_set (&dl->try_dmabuf_exports, TRUE);
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+      /* Retry exporting whenever we have new caps from upstream */
+      g_atomic_int_set (&dl->try_dmabuf_exports, TRUE);
+      /* fallthrough */
+    case GST_EVENT_EOS:
+    case GST_EVENT_SEGMENT:
+    case GST_EVENT_GAP:
+      /* frames in the old format or segment go out first */
+      gst_gl_download_element_drain (dl);
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      gst_gl_download_element_clear_pending (dl);
+      break;
+    default:
+      break;
+  }
 
   return GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (bt, event);
 }
@@ -1454,7 +1667,10 @@ gst_gl_download_element_propose_allocation (GstBaseTransform * bt,
     gst_object_unref (pool);
     goto config_failed;
   }
-  gst_query_add_allocation_pool (query, pool, size, 1, 0);
+  /* the delayed frames are held on top of the one being processed */
+  gst_query_add_allocation_pool (query, pool, size,
+      1 + gst_gl_download_element_get_download_delay (GST_GL_DOWNLOAD_ELEMENT
+          (bt)), 0);
 
   gst_object_unref (pool);
   return TRUE;
@@ -1482,5 +1698,7 @@ gst_gl_download_element_finalize (GObject * object)
     download->dmabuf_allocator = NULL;
   }
 
+  gst_gl_download_element_clear_pending (download);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
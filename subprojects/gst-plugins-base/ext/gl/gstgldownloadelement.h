@@ -55,6 +55,10 @@ struct _GstGLDownloadElement
   gboolean try_dmabuf_exports;
   GstAllocator * dmabuf_allocator;
   gboolean add_videometa;
+
+  /* buffers with a pending PBO download */
+  guint download_delay;
+  GQueue pending;
 };
 
 struct _GstGLDownloadElementClass
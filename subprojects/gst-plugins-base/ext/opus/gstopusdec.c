@@ -55,6 +55,31 @@
 GST_DEBUG_CATEGORY_STATIC (opusdec_debug);
 #define GST_CAT_DEFAULT opusdec_debug
 
+/* number of packets decoded to prime the decoder state of a worker, the same
+ * amount that is recommended to decode after a seek */
+#define WORKER_PREROLL 4
+
+/* a decoder state for decoding a batch of packets in parallel, with a copy of
+ * the stream configuration */
+typedef struct
+{
+  OpusMSDecoder *state;
+
+  guint32 sample_rate;
+  guint n_channels;
+  GstAudioChannelPosition opus_pos[64];
+  GstAudioChannelPosition position[64];
+
+  gboolean apply_gain;
+  double r128_gain_volume;
+
+  GstBuffer *streamheader;
+  GstBuffer *vorbiscomment;
+
+  guint64 leftover_plc_duration;
+  GstClockTime last_known_buffer_duration;
+} GstOpusDecWorker;
+
 static GstStaticPadTemplate opus_dec_src_factory =
 GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
@@ -111,6 +136,12 @@ static void gst_opus_dec_get_property (GObject * object, guint prop_id,
 static void gst_opus_dec_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
 static GstCaps *gst_opus_dec_getcaps (GstAudioDecoder * dec, GstCaps * filter);
+static gpointer gst_opus_dec_create_worker (GstAudioDecoder * dec,
+    guint * preroll);
+static GstFlowReturn gst_opus_dec_decode_frames (GstAudioDecoder * dec,
+    gpointer worker, GstBufferList * frames, guint preroll,
+    GstBufferList * output);
+static void gst_opus_dec_free_worker (GstAudioDecoder * dec, gpointer worker);
 
 
 static void
@@ -132,6 +163,9 @@ gst_opus_dec_class_init (GstOpusDecClass * klass)
   adclass->handle_frame = GST_DEBUG_FUNCPTR (gst_opus_dec_handle_frame);
   adclass->set_format = GST_DEBUG_FUNCPTR (gst_opus_dec_set_format);
   adclass->getcaps = GST_DEBUG_FUNCPTR (gst_opus_dec_getcaps);
+  adclass->create_worker = GST_DEBUG_FUNCPTR (gst_opus_dec_create_worker);
+  adclass->decode_frames = GST_DEBUG_FUNCPTR (gst_opus_dec_decode_frames);
+  adclass->free_worker = GST_DEBUG_FUNCPTR (gst_opus_dec_free_worker);
 
   gst_element_class_add_static_pad_template (element_class,
       &opus_dec_src_factory);
@@ -990,6 +1024,214 @@ gst_opus_dec_handle_frame (GstAudioDecoder * adec, GstBuffer * buf)
   return res;
 }
 
+static gpointer
+gst_opus_dec_create_worker (GstAudioDecoder * adec, guint * preroll)
+{
+  GstOpusDec *dec = GST_OPUS_DEC (adec);
+  GstOpusDecWorker *worker;
+  int err;
+
+  /* the headers and the first packet set up the stream, and with FEC the
+   * packets depend on the next one */
+  if (dec->state == NULL || dec->packetno < 2 || dec->use_inband_fec)
+    return NULL;
+
+  worker = g_new0 (GstOpusDecWorker, 1);
+  worker->state =
+      opus_multistream_decoder_create (dec->sample_rate, dec->n_channels,
+      dec->n_streams, dec->n_stereo_streams, dec->channel_mapping, &err);
+  if (!worker->state || err != OPUS_OK) {
+    GST_WARNING_OBJECT (dec, "Failed to create worker decoder (%d): %s", err,
+        opus_strerror (err));
+    g_free (worker);
+    return NULL;
+  }
+#ifdef OPUS_SET_PHASE_INVERSION_DISABLED_REQUEST
+  opus_multistream_decoder_ctl (worker->state,
+      OPUS_SET_PHASE_INVERSION_DISABLED (!dec->phase_inversion));
+#endif
+
+  worker->sample_rate = dec->sample_rate;
+  worker->n_channels = dec->n_channels;
+  memcpy (worker->opus_pos, dec->opus_pos, sizeof (dec->opus_pos));
+  memcpy (worker->position, dec->info.position, sizeof (dec->info.position));
+  worker->apply_gain = dec->apply_gain && dec->r128_gain;
+  worker->r128_gain_volume = dec->r128_gain_volume;
+  if (dec->streamheader && dec->vorbiscomment) {
+    worker->streamheader = gst_buffer_ref (dec->streamheader);
+    worker->vorbiscomment = gst_buffer_ref (dec->vorbiscomment);
+  }
+  worker->last_known_buffer_duration = dec->last_known_buffer_duration;
+
+  *preroll = WORKER_PREROLL;
+
+  return worker;
+}
+
+static void
+gst_opus_dec_free_worker (GstAudioDecoder * adec, gpointer data)
+{
+  GstOpusDecWorker *worker = data;
+
+  opus_multistream_decoder_destroy (worker->state);
+  gst_buffer_replace (&worker->streamheader, NULL);
+  gst_buffer_replace (&worker->vorbiscomment, NULL);
+  g_free (worker);
+}
+
+/* decodes @buf like opus_dec_chain_parse_data() without FEC, but into a
+ * newly allocated buffer as this runs outside of the streaming thread. An
+ * empty buffer is returned if there is nothing to output */
+static GstFlowReturn
+gst_opus_dec_worker_decode (GstOpusDec * dec, GstOpusDecWorker * worker,
+    GstBuffer * buf, GstBuffer ** outbuf)
+{
+  GstAudioClippingMeta *cmeta;
+  GstMapInfo map, omap;
+  guint8 *data = NULL;
+  gsize size = 0;
+  guint bpf = 2 * worker->n_channels;
+  int samples, n;
+
+  *outbuf = NULL;
+
+  if ((worker->streamheader && memcmp_buffers (worker->streamheader, buf))
+      || (worker->vorbiscomment
+          && memcmp_buffers (worker->vorbiscomment, buf))) {
+    *outbuf = gst_buffer_new ();
+    return GST_FLOW_OK;
+  }
+
+  if (gst_buffer_get_size (buf) == 0) {
+    GstClockTime const opus_plc_alignment = 2500 * GST_USECOND;
+    GstClockTime aligned_missing_duration;
+    GstClockTime missing_duration = GST_BUFFER_DURATION (buf);
+
+    if (!GST_CLOCK_TIME_IS_VALID (missing_duration) || missing_duration == 0) {
+      if (GST_CLOCK_TIME_IS_VALID (worker->last_known_buffer_duration))
+        missing_duration = worker->last_known_buffer_duration;
+      else
+        missing_duration = 20 * GST_MSECOND;
+    }
+
+    missing_duration += worker->leftover_plc_duration;
+    aligned_missing_duration =
+        ((missing_duration +
+            opus_plc_alignment / 2) / opus_plc_alignment) * opus_plc_alignment;
+    worker->leftover_plc_duration =
+        missing_duration - aligned_missing_duration;
+
+    GST_OBJECT_LOCK (dec);
+    dec->num_gap++;
+    GST_OBJECT_UNLOCK (dec);
+
+    if (aligned_missing_duration < opus_plc_alignment) {
+      *outbuf = gst_buffer_new ();
+      return GST_FLOW_OK;
+    }
+
+    samples =
+        gst_util_uint64_scale_int (aligned_missing_duration,
+        worker->sample_rate, GST_SECOND);
+
+    GST_OBJECT_LOCK (dec);
+    dec->plc_num_samples += samples;
+    dec->plc_duration += aligned_missing_duration;
+    GST_OBJECT_UNLOCK (dec);
+  } else {
+    gst_buffer_map (buf, &map, GST_MAP_READ);
+    data = map.data;
+    size = map.size;
+    worker->last_known_buffer_duration = packet_duration_opus (data, size);
+    samples = 120 * worker->sample_rate / 1000;
+  }
+
+  *outbuf = gst_buffer_new_allocate (NULL, samples * bpf, NULL);
+  gst_buffer_map (*outbuf, &omap, GST_MAP_WRITE);
+  n = opus_multistream_decode (worker->state, data, size,
+      (gint16 *) omap.data, samples, 0);
+  gst_buffer_unmap (*outbuf, &omap);
+  if (data != NULL)
+    gst_buffer_unmap (buf, &map);
+
+  if (n < 0) {
+    GST_WARNING_OBJECT (dec, "Decoding error (%d): %s", n, opus_strerror (n));
+    gst_buffer_replace (outbuf, NULL);
+    return GST_FLOW_ERROR;
+  }
+  gst_buffer_set_size (*outbuf, n * bpf);
+
+  cmeta = gst_buffer_get_audio_clipping_meta (buf);
+  if (cmeta && cmeta->start) {
+    guint skip = MIN (cmeta->start * worker->sample_rate / 48000, n);
+
+    gst_buffer_resize (*outbuf, skip * bpf, -1);
+  }
+  if (cmeta && cmeta->end) {
+    guint skip = MIN (cmeta->end * worker->sample_rate / 48000, n);
+    gsize outsize = gst_buffer_get_size (*outbuf);
+
+    gst_buffer_resize (*outbuf, 0, outsize > skip * bpf ?
+        outsize - skip * bpf : 0);
+  }
+
+  if (gst_buffer_get_size (*outbuf) == 0)
+    return GST_FLOW_OK;
+
+  if (worker->opus_pos[0] != GST_AUDIO_CHANNEL_POSITION_INVALID) {
+    gst_audio_buffer_reorder_channels (*outbuf, GST_AUDIO_FORMAT_S16,
+        worker->n_channels, worker->opus_pos, worker->position);
+  }
+
+  if (worker->apply_gain) {
+    double volume = worker->r128_gain_volume;
+    gint16 *out;
+    gsize i;
+
+    gst_buffer_map (*outbuf, &omap, GST_MAP_READWRITE);
+    out = (gint16 *) omap.data;
+    for (i = 0; i < omap.size / 2; ++i) {
+      int sample = (int) (out[i] * volume + 0.5);
+      out[i] = sample < -32768 ? -32768 : sample > 32767 ? 32767 : sample;
+    }
+    gst_buffer_unmap (*outbuf, &omap);
+  }
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_opus_dec_decode_frames (GstAudioDecoder * adec, gpointer data,
+    GstBufferList * frames, guint preroll, GstBufferList * output)
+{
+  GstOpusDec *dec = GST_OPUS_DEC (adec);
+  GstOpusDecWorker *worker = data;
+  guint i, n = gst_buffer_list_length (frames);
+
+  for (i = 0; i < n; i++) {
+    GstBuffer *outbuf;
+    GstFlowReturn ret;
+
+    ret = gst_opus_dec_worker_decode (dec, worker,
+        gst_buffer_list_get (frames, i), &outbuf);
+    /* preroll packets only prime the decoder state */
+    if (i < preroll) {
+      gst_buffer_replace (&outbuf, NULL);
+      continue;
+    }
+    if (ret != GST_FLOW_OK)
+      return ret;
+
+    gst_buffer_list_add (output, outbuf);
+
+    GST_OBJECT_LOCK (dec);
+    dec->num_pushed++;
+    GST_OBJECT_UNLOCK (dec);
+  }
+
+  return GST_FLOW_OK;
+}
+
 /* Called with object lock hold */
 static guint32
 get_bandwidth (GstOpusDec * self)
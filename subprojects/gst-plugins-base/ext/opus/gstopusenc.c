@@ -391,6 +391,9 @@ gst_opus_enc_init (GstOpusEnc * enc)
   enc->packet_loss_percentage = DEFAULT_PACKET_LOSS_PERCENT;
   enc->max_payload_size = DEFAULT_MAX_PAYLOAD_SIZE;
   enc->audio_type = DEFAULT_AUDIO_TYPE;
+
+  /* push the packets encoded from one input buffer together */
+  gst_audio_encoder_set_output_buffer_list (GST_AUDIO_ENCODER (enc), TRUE);
 }
 
 static gboolean
@@ -415,6 +418,9 @@ gst_opus_enc_stop (GstAudioEncoder * benc)
     opus_multistream_encoder_destroy (enc->state);
     enc->state = NULL;
   }
+  g_free (enc->scratch);
+  enc->scratch = NULL;
+  enc->scratch_size = 0;
   gst_tag_setter_reset_tags (GST_TAG_SETTER (enc));
 
   return TRUE;
@@ -436,7 +442,8 @@ gst_opus_enc_setup_base_class (GstOpusEnc * enc, GstAudioEncoder * benc)
       gst_opus_enc_get_latency (enc), gst_opus_enc_get_latency (enc));
   gst_audio_encoder_set_frame_samples_min (benc, enc->frame_samples);
   gst_audio_encoder_set_frame_samples_max (benc, enc->frame_samples);
-  gst_audio_encoder_set_frame_max (benc, 1);
+  /* take all complete frames at once to encode them in one go */
+  gst_audio_encoder_set_frame_max (benc, 0);
 }
 
 static gint
@@ -924,6 +931,46 @@ gst_opus_enc_sink_getcaps (GstAudioEncoder * benc, GstCaps * filter)
   return caps;
 }
 
+static GstFlowReturn
+gst_opus_enc_encode_frame (GstOpusEnc * enc, const guint8 * data,
+    gint frame_samples, guint max_payload_size, GstBuffer ** outbuf)
+{
+  gsize max_size = max_payload_size * enc->n_channels;
+  gint outsize;
+
+  if (enc->scratch_size < max_size) {
+    enc->scratch = g_realloc (enc->scratch, max_size);
+    enc->scratch_size = max_size;
+  }
+
+  outsize =
+      opus_multistream_encode (enc->state, (const gint16 *) data,
+      frame_samples, enc->scratch, max_size);
+
+  if (outsize < 0) {
+    GST_ELEMENT_ERROR (enc, STREAM, ENCODE, (NULL),
+        ("Encoding failed (%d): %s", outsize, opus_strerror (outsize)));
+    return GST_FLOW_ERROR;
+  } else if (outsize > max_payload_size) {
+    GST_ELEMENT_ERROR (enc, STREAM, ENCODE, (NULL),
+        ("Encoded size %d is higher than max payload size (%d bytes)",
+            outsize, max_payload_size));
+    return GST_FLOW_ERROR;
+  }
+
+  GST_DEBUG_OBJECT (enc, "Output packet is %u bytes", outsize);
+  *outbuf =
+      gst_audio_encoder_allocate_output_buffer (GST_AUDIO_ENCODER (enc),
+      outsize);
+  if (!*outbuf)
+    return GST_FLOW_ERROR;
+  gst_buffer_fill (*outbuf, 0, enc->scratch, outsize);
+
+  return GST_FLOW_OK;
+}
+
+/* encodes all frames in @buf before finishing them, as finishing a frame
+ * invalidates the input data */
 static GstFlowReturn
 gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buf)
 {
@@ -931,11 +978,12 @@ gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buf)
   gsize bsize, size;
   gsize bytes;
   gint ret = GST_FLOW_OK;
+  GstFlowReturn flow = GST_FLOW_OK;
   GstMapInfo map;
-  GstMapInfo omap;
-  gint outsize;
-  GstBuffer *outbuf;
   guint64 trim_start = 0, trim_end = 0;
+  GstBuffer **outbufs = NULL;
+  gint *out_samples = NULL;
+  guint i, n_frames = 1, n_encoded = 0;
 
   guint max_payload_size;
   gint frame_samples, input_samples, output_samples;
@@ -987,24 +1035,7 @@ gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buf)
     } else {
       data = bdata;
       size = bsize;
-
-      /* Adjust for lookahead here */
-      if (enc->pending_lookahead) {
-        guint scaled_lookahead =
-            enc->pending_lookahead * enc->sample_rate / 48000;
-
-        if (input_samples > scaled_lookahead) {
-          output_samples = input_samples - scaled_lookahead;
-          trim_start = enc->pending_lookahead;
-          enc->pending_lookahead = 0;
-        } else {
-          trim_start = ((guint64) input_samples) * 48000 / enc->sample_rate;
-          enc->pending_lookahead -= trim_start;
-          output_samples = 0;
-        }
-      } else {
-        output_samples = input_samples;
-      }
+      n_frames = size / bytes;
     }
   } else {
     if (enc->encoded_samples < enc->consumed_samples) {
@@ -1028,61 +1059,83 @@ gst_opus_enc_encode (GstOpusEnc * enc, GstBuffer * buf)
     }
   }
 
-  g_assert (size == bytes);
+  g_assert (size == n_frames * bytes);
 
-  outbuf =
-      gst_audio_encoder_allocate_output_buffer (GST_AUDIO_ENCODER (enc),
-      max_payload_size * enc->n_channels);
-  if (!outbuf)
-    goto done;
+  GST_DEBUG_OBJECT (enc, "encoding %u frames of %d samples (%d bytes)",
+      n_frames, frame_samples, (int) bytes);
 
-  GST_DEBUG_OBJECT (enc, "encoding %d samples (%d bytes)",
-      frame_samples, (int) bytes);
+  outbufs = g_new (GstBuffer *, n_frames);
+  out_samples = g_new (gint, n_frames);
 
-  if (trim_start || trim_end) {
-    GST_DEBUG_OBJECT (enc,
-        "Adding trim-start %" G_GUINT64_FORMAT " trim-end %" G_GUINT64_FORMAT,
-        trim_start, trim_end);
-    gst_buffer_add_audio_clipping_meta (outbuf, GST_FORMAT_DEFAULT, trim_start,
-        trim_end);
-  }
+  for (i = 0; i < n_frames; i++) {
+    GstBuffer *outbuf;
 
-  gst_buffer_map (outbuf, &omap, GST_MAP_WRITE);
+    /* Adjust for lookahead here */
+    if (bdata && !mdata) {
+      trim_start = 0;
+      if (enc->pending_lookahead) {
+        guint scaled_lookahead =
+            enc->pending_lookahead * enc->sample_rate / 48000;
 
-  outsize =
-      opus_multistream_encode (enc->state, (const gint16 *) data,
-      frame_samples, omap.data, max_payload_size * enc->n_channels);
+        if (input_samples > scaled_lookahead) {
+          output_samples = input_samples - scaled_lookahead;
+          trim_start = enc->pending_lookahead;
+          enc->pending_lookahead = 0;
+        } else {
+          trim_start = ((guint64) input_samples) * 48000 / enc->sample_rate;
+          enc->pending_lookahead -= trim_start;
+          output_samples = 0;
+        }
+      } else {
+        output_samples = input_samples;
+      }
+    }
 
-  gst_buffer_unmap (outbuf, &omap);
+    ret = gst_opus_enc_encode_frame (enc, data + i * bytes, frame_samples,
+        max_payload_size, &outbuf);
+    if (ret != GST_FLOW_OK)
+      break;
 
-  if (outsize < 0) {
-    GST_ELEMENT_ERROR (enc, STREAM, ENCODE, (NULL),
-        ("Encoding failed (%d): %s", outsize, opus_strerror (outsize)));
-    ret = GST_FLOW_ERROR;
-    goto done;
-  } else if (outsize > max_payload_size) {
-    GST_ELEMENT_ERROR (enc, STREAM, ENCODE, (NULL),
-        ("Encoded size %d is higher than max payload size (%d bytes)",
-            outsize, max_payload_size));
-    ret = GST_FLOW_ERROR;
-    goto done;
-  }
+    if (trim_start || trim_end) {
+      GST_DEBUG_OBJECT (enc,
+          "Adding trim-start %" G_GUINT64_FORMAT " trim-end %"
+          G_GUINT64_FORMAT, trim_start, trim_end);
+      gst_buffer_add_audio_clipping_meta (outbuf, GST_FORMAT_DEFAULT,
+          trim_start, trim_end);
+    }
 
-  GST_DEBUG_OBJECT (enc, "Output packet is %u bytes", outsize);
-  gst_buffer_set_size (outbuf, outsize);
+    outbufs[n_encoded] = outbuf;
+    out_samples[n_encoded] = output_samples;
+    n_encoded++;
+
+    enc->encoded_samples += output_samples;
+    enc->consumed_samples += input_samples;
+  }
 
+  if (bdata) {
+    gst_buffer_unmap (buf, &map);
+    bdata = NULL;
+  }
 
-  ret =
-      gst_audio_encoder_finish_frame (GST_AUDIO_ENCODER (enc), outbuf,
-      output_samples);
-  enc->encoded_samples += output_samples;
-  enc->consumed_samples += input_samples;
+  for (i = 0; i < n_encoded; i++) {
+    if (flow == GST_FLOW_OK) {
+      flow =
+          gst_audio_encoder_finish_frame (GST_AUDIO_ENCODER (enc), outbufs[i],
+          out_samples[i]);
+    } else {
+      gst_buffer_unref (outbufs[i]);
+    }
+  }
+  if (ret == GST_FLOW_OK)
+    ret = flow;
 
 done:
 
   if (bdata)
     gst_buffer_unmap (buf, &map);
 
+  g_free (outbufs);
+  g_free (out_samples);
   g_free (mdata);
 
   return ret;
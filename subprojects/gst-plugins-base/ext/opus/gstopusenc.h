@@ -87,6 +87,11 @@ struct _GstOpusEnc {
   guint8                encoding_channel_mapping[256];
   guint8                decoding_channel_mapping[256];
   guint8                n_stereo_streams;
+
+  /* packets are encoded into scratch and copied into output buffers of
+   * their actual size */
+  guint8               *scratch;
+  gsize                 scratch_size;
 };
 
 struct _GstOpusEncClass {
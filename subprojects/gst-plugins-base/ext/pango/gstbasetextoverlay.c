@@ -76,6 +76,41 @@
 #define MINIMUM_OUTLINE_OFFSET 1.0
 #define DEFAULT_SCALE_BASIS    640
 
+/* Rendered text images are shared between all overlays and kept for a while,
+ * so that text showing up again, in the same overlay or in another one with
+ * the same settings, is not rendered again */
+#define TEXT_IMAGE_CACHE_SIZE  256
+
+G_LOCK_DEFINE_STATIC (text_image_cache);
+static GHashTable *text_image_cache;
+static GQueue text_image_cache_lru = G_QUEUE_INIT;
+static guint text_image_cache_users;
+
+/* Part of the rendered text. Simple single line text is split in one cell per
+ * character, so that only the characters that changed are rendered again
+ * and the other overlay rectangles are kept */
+typedef struct
+{
+  GstBuffer *image;
+  /* horizontal position and width in the complete text image */
+  gint x;
+  gint width;
+  /* the rectangle of the last composition and its position */
+  GstVideoOverlayRectangle *rectangle;
+  gint xpos, ypos;
+} GstBaseTextOverlayCell;
+
+typedef struct
+{
+  gint x;
+  gint width;
+  /* bytes of the text rendered in the column */
+  gint index;
+  gint len;
+  /* unrounded position of the first character */
+  gdouble origin;
+} GstBaseTextOverlayColumn;
+
 enum
 {
   PROP_0,
@@ -657,10 +692,15 @@ gst_base_text_overlay_finalize (GObject * object)
     overlay->composition = NULL;
   }
 
-  if (overlay->text_image) {
-    gst_buffer_unref (overlay->text_image);
-    overlay->text_image = NULL;
+  g_array_unref (overlay->text_cells);
+
+  G_LOCK (text_image_cache);
+  if (--text_image_cache_users == 0 && text_image_cache) {
+    g_queue_clear (&text_image_cache_lru);
+    g_hash_table_unref (text_image_cache);
+    text_image_cache = NULL;
   }
+  G_UNLOCK (text_image_cache);
 
   if (overlay->layout) {
     g_object_unref (overlay->layout);
@@ -683,6 +723,14 @@ gst_base_text_overlay_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+static void
+gst_base_text_overlay_cell_clear (GstBaseTextOverlayCell * cell)
+{
+  gst_buffer_unref (cell->image);
+  if (cell->rectangle)
+    gst_video_overlay_rectangle_unref (cell->rectangle);
+}
+
 static void
 gst_base_text_overlay_init (GstBaseTextOverlay * overlay,
     GstBaseTextOverlayClass * klass)
@@ -765,7 +813,13 @@ gst_base_text_overlay_init (GstBaseTextOverlay * overlay,
 
   overlay->default_text = g_strdup (DEFAULT_PROP_TEXT);
   overlay->need_render = TRUE;
-  overlay->text_image = NULL;
+  overlay->text_cells = g_array_new (FALSE, TRUE,
+      sizeof (GstBaseTextOverlayCell));
+  g_array_set_clear_func (overlay->text_cells,
+      (GDestroyNotify) gst_base_text_overlay_cell_clear);
+  G_LOCK (text_image_cache);
+  text_image_cache_users++;
+  G_UNLOCK (text_image_cache);
   overlay->use_vertical_render = DEFAULT_PROP_VERTICAL_RENDER;
   overlay->scale_mode = DEFAULT_PROP_SCALE_MODE;
   overlay->scale_par_n = DEFAULT_PROP_SCALE_PAR_N;
@@ -1652,9 +1706,11 @@ static inline void
 gst_base_text_overlay_set_composition (GstBaseTextOverlay * overlay)
 {
   gint xpos, ypos;
-  GstVideoOverlayRectangle *rectangle;
+  GstBaseTextOverlayCell *cell;
+  GstVideoOverlayComposition *composition = NULL;
+  guint i;
 
-  if (overlay->text_image && overlay->text_width != 1) {
+  if (overlay->text_cells->len > 0 && overlay->text_width != 1) {
     gint render_width, render_height;
 
     gst_base_text_overlay_get_pos (overlay, &xpos, &ypos);
@@ -1668,27 +1724,44 @@ gst_base_text_overlay_set_composition (GstBaseTextOverlay * overlay)
         overlay->text_width, overlay->text_height, render_width,
         render_height, xpos, ypos);
 
-    gst_buffer_add_video_meta (overlay->text_image, GST_VIDEO_FRAME_FLAG_NONE,
-        GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB,
-        overlay->text_width, overlay->text_height);
-
-    rectangle = gst_video_overlay_rectangle_new_raw (overlay->text_image,
-        xpos, ypos, render_width, render_height,
-        GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA);
+    if (overlay->upstream_composition)
+      composition =
+          gst_video_overlay_composition_copy (overlay->upstream_composition);
 
-    if (overlay->composition)
-      gst_video_overlay_composition_unref (overlay->composition);
+    for (i = 0; i < overlay->text_cells->len; i++) {
+      cell = &g_array_index (overlay->text_cells, GstBaseTextOverlayCell, i);
+
+      /* keep the rectangles of unchanged cells, with the pixels downstream
+       * converted for them */
+      if (!cell->rectangle || cell->xpos != xpos || cell->ypos != ypos) {
+        if (cell->rectangle)
+          gst_video_overlay_rectangle_unref (cell->rectangle);
+
+        /* cells are only used without render scaling, the whole text image
+         * is scaled to the render size */
+        if (overlay->text_cells->len > 1) {
+          cell->rectangle = gst_video_overlay_rectangle_new_raw (cell->image,
+              xpos + cell->x, ypos, cell->width, render_height,
+              GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA);
+        } else {
+          cell->rectangle = gst_video_overlay_rectangle_new_raw (cell->image,
+              xpos, ypos, render_width, render_height,
+              GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA);
+        }
+        cell->xpos = xpos;
+        cell->ypos = ypos;
+      }
 
-    if (overlay->upstream_composition) {
-      overlay->composition =
-          gst_video_overlay_composition_copy (overlay->upstream_composition);
-      gst_video_overlay_composition_add_rectangle (overlay->composition,
-          rectangle);
-    } else {
-      overlay->composition = gst_video_overlay_composition_new (rectangle);
+      if (composition)
+        gst_video_overlay_composition_add_rectangle (composition,
+            cell->rectangle);
+      else
+        composition = gst_video_overlay_composition_new (cell->rectangle);
     }
 
-    gst_video_overlay_rectangle_unref (rectangle);
+    if (overlay->composition)
+      gst_video_overlay_composition_unref (overlay->composition);
+    overlay->composition = composition;
 
   } else if (overlay->composition) {
     gst_video_overlay_composition_unref (overlay->composition);
@@ -1696,6 +1769,52 @@ gst_base_text_overlay_set_composition (GstBaseTextOverlay * overlay)
   }
 }
 
+static GstBuffer *
+gst_base_text_overlay_cache_lookup (const gchar * key)
+{
+  GstBuffer *image = NULL;
+  GList *link;
+
+  G_LOCK (text_image_cache);
+  if (text_image_cache)
+    image = g_hash_table_lookup (text_image_cache, key);
+  if (image) {
+    link = g_queue_find_custom (&text_image_cache_lru, key,
+        (GCompareFunc) g_strcmp0);
+    g_queue_unlink (&text_image_cache_lru, link);
+    g_queue_push_tail_link (&text_image_cache_lru, link);
+    gst_buffer_ref (image);
+  }
+  G_UNLOCK (text_image_cache);
+
+  return image;
+}
+
+static void
+gst_base_text_overlay_cache_insert (const gchar * key, GstBuffer * image)
+{
+  gchar *cache_key;
+
+  G_LOCK (text_image_cache);
+  if (!text_image_cache)
+    text_image_cache = g_hash_table_new_full (g_str_hash, g_str_equal,
+        g_free, (GDestroyNotify) gst_buffer_unref);
+
+  /* another overlay might have rendered it in the meantime */
+  if (!g_hash_table_contains (text_image_cache, key)) {
+    if (g_hash_table_size (text_image_cache) >= TEXT_IMAGE_CACHE_SIZE) {
+      gchar *old = g_queue_pop_head (&text_image_cache_lru);
+
+      g_hash_table_remove (text_image_cache, old);
+    }
+
+    cache_key = g_strdup (key);
+    g_queue_push_tail (&text_image_cache_lru, cache_key);
+    g_hash_table_insert (text_image_cache, cache_key, gst_buffer_ref (image));
+  }
+  G_UNLOCK (text_image_cache);
+}
+
 static gboolean
 gst_text_overlay_filter_foreground_attr (PangoAttribute * attr, gpointer data)
 {
@@ -1706,24 +1825,222 @@ gst_text_overlay_filter_foreground_attr (PangoAttribute * attr, gpointer data)
   }
 }
 
+/* draws the text of the layout with shadow and outline */
 static void
-gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
-    const gchar * string, gint textlen)
+gst_base_text_overlay_draw_layout (GstBaseTextOverlay * overlay, cairo_t * cr)
+{
+  double a, r, g, b;
+
+  /* FIXME: We use show_layout everywhere except for the surface
+   * because it's really faster and internally does all kinds of
+   * caching. Unfortunately we have to paint to a cairo path for
+   * the outline and this is slow. Once Pango supports user fonts
+   * we should use them, see
+   * https://bugzilla.gnome.org/show_bug.cgi?id=598695
+   *
+   * Idea would the be, to create a cairo user font that
+   * does shadow, outline, text painting in the
+   * render_glyph function.
+   */
+
+  /* draw shadow text */
+  if (overlay->draw_shadow) {
+    PangoAttrList *origin_attr, *filtered_attr, *temp_attr;
+
+    /* Store a ref on the original attributes for later restoration */
+    origin_attr =
+        pango_attr_list_ref (pango_layout_get_attributes (overlay->layout));
+    /* Take a copy of the original attributes, because pango_attr_list_filter
+     * modifies the passed list */
+    temp_attr = pango_attr_list_copy (origin_attr);
+    filtered_attr =
+        pango_attr_list_filter (temp_attr,
+        gst_text_overlay_filter_foreground_attr, NULL);
+    pango_attr_list_unref (temp_attr);
+
+    cairo_save (cr);
+    cairo_translate (cr, overlay->shadow_offset, overlay->shadow_offset);
+    cairo_set_source_rgba (cr, 0.0, 0.0, 0.0, 0.5);
+    pango_layout_set_attributes (overlay->layout, filtered_attr);
+    pango_cairo_show_layout (cr, overlay->layout);
+    pango_layout_set_attributes (overlay->layout, origin_attr);
+    pango_attr_list_unref (filtered_attr);
+    pango_attr_list_unref (origin_attr);
+    cairo_restore (cr);
+  }
+
+  /* draw outline text */
+  if (overlay->draw_outline) {
+    a = (overlay->outline_color >> 24) & 0xff;
+    r = (overlay->outline_color >> 16) & 0xff;
+    g = (overlay->outline_color >> 8) & 0xff;
+    b = (overlay->outline_color >> 0) & 0xff;
+
+    cairo_save (cr);
+    cairo_set_source_rgba (cr, r / 255.0, g / 255.0, b / 255.0, a / 255.0);
+    cairo_set_line_width (cr, overlay->outline_offset);
+    pango_cairo_layout_path (cr, overlay->layout);
+    cairo_stroke (cr);
+    cairo_restore (cr);
+  }
+
+  a = (overlay->color >> 24) & 0xff;
+  r = (overlay->color >> 16) & 0xff;
+  g = (overlay->color >> 8) & 0xff;
+  b = (overlay->color >> 0) & 0xff;
+
+  /* draw text */
+  cairo_save (cr);
+  cairo_set_source_rgba (cr, r / 255.0, g / 255.0, b / 255.0, a / 255.0);
+  pango_cairo_show_layout (cr, overlay->layout);
+  cairo_restore (cr);
+}
+
+/* renders the part of the text image starting at @x */
+static GstBuffer *
+gst_base_text_overlay_render_image (GstBaseTextOverlay * overlay,
+    const cairo_matrix_t * matrix, gint x, gint width, gint height)
 {
   cairo_t *cr;
   cairo_surface_t *surface;
+  cairo_matrix_t cairo_matrix = *matrix;
+  GstBuffer *buffer;
+  GstMapInfo map;
+
+  GST_LOG_OBJECT (overlay, "rendering %dx%d at %d", width, height, x);
+
+  buffer = gst_buffer_new_and_alloc (4 * width * height);
+
+  gst_buffer_map (buffer, &map, GST_MAP_READWRITE);
+  surface = cairo_image_surface_create_for_data (map.data,
+      CAIRO_FORMAT_ARGB32, width, height, width * 4);
+  cr = cairo_create (surface);
+
+  /* clear surface */
+  cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+  cairo_paint (cr);
+
+  cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+
+  /* apply transformations */
+  cairo_matrix.x0 -= x;
+  cairo_set_matrix (cr, &cairo_matrix);
+
+  gst_base_text_overlay_draw_layout (overlay, cr);
+
+  cairo_destroy (cr);
+  cairo_surface_destroy (surface);
+  gst_buffer_unmap (buffer, &map);
+
+  gst_buffer_add_video_meta (buffer, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB, width, height);
+
+  return buffer;
+}
+
+/* Splits the text image in one column per character of a simple horizontal
+ * single line text. Returns FALSE if the text can only be rendered as a
+ * whole */
+static gboolean
+gst_base_text_overlay_get_columns (GstBaseTextOverlay * overlay,
+    const cairo_matrix_t * matrix, const gchar * string, gint width,
+    GArray ** columns)
+{
+  GstBaseTextOverlayColumn *last = NULL;
+  const gchar *text, *p;
+
+  *columns = g_array_new (FALSE, TRUE, sizeof (GstBaseTextOverlayColumn));
+
+  /* markup could change the rendering without changing the characters */
+  if (overlay->use_vertical_render || overlay->render_scale != 1.0 ||
+      strchr (string, '<') ||
+      pango_layout_get_line_count (overlay->layout) != 1)
+    return FALSE;
+
+  text = pango_layout_get_text (overlay->layout);
+
+  for (p = text; *p; p = g_utf8_next_char (p)) {
+    GstBaseTextOverlayColumn column;
+    PangoRectangle pos;
+    gdouble x, y = 0.0;
+
+    pango_layout_index_to_pos (overlay->layout, p - text, &pos);
+    x = (gdouble) pos.x / PANGO_SCALE;
+    cairo_matrix_transform_point (matrix, &x, &y);
+
+    column.x = last ? CLAMP ((gint) floor (x + 0.5), 0, width) : 0;
+    column.width = 0;
+    column.index = p - text;
+    column.len = g_utf8_next_char (p) - p;
+    column.origin = x;
+
+    if (last) {
+      /* right to left text */
+      if (column.x < last->x)
+        return FALSE;
+
+      if (column.x == last->x) {
+        last->len += column.len;
+        continue;
+      }
+      last->width = column.x - last->x;
+    }
+
+    g_array_append_val (*columns, column);
+    last = &g_array_index (*columns, GstBaseTextOverlayColumn,
+        (*columns)->len - 1);
+  }
+
+  if (!last || last->x >= width)
+    return FALSE;
+  last->width = width - last->x;
+
+  return (*columns)->len > 1;
+}
+
+/* describes everything but the text and the column that changes the
+ * rendered image */
+static gchar *
+gst_base_text_overlay_get_render_key (GstBaseTextOverlay * overlay,
+    const cairo_matrix_t * m, gint height)
+{
+  const PangoFontDescription *desc;
+  gchar *font, *key;
+
+  desc = pango_layout_get_font_description (overlay->layout);
+  if (!desc)
+    desc = pango_context_get_font_description (overlay->pango_context);
+  font = pango_font_description_to_string (desc);
+
+  key = g_strdup_printf ("%s|%08x|%08x|%d|%d|%f|%f|%d|%d|%f|%f,%f,%f,%f,%f,%f"
+      "|%d", font, overlay->color, overlay->outline_color,
+      overlay->draw_shadow, overlay->draw_outline, overlay->shadow_offset,
+      overlay->outline_offset, pango_layout_get_width (overlay->layout),
+      pango_layout_get_alignment (overlay->layout),
+      pango_cairo_context_get_resolution (overlay->pango_context), m->xx,
+      m->yx, m->xy, m->yy, m->x0, m->y0, height);
+  g_free (font);
+
+  return key;
+}
+
+static void
+gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
+    const gchar * string, gint textlen)
+{
   PangoRectangle ink_rect, logical_rect;
   cairo_matrix_t cairo_matrix;
   gint unscaled_width, unscaled_height;
   gint width, height;
   gboolean full_width = FALSE;
   double scalef_x = 1.0, scalef_y = 1.0;
-  double a, r, g, b;
   gdouble shadow_offset = 0.0;
   gdouble outline_offset = 0.0;
   gint xpad = 0, ypad = 0;
-  GstBuffer *buffer;
-  GstMapInfo map;
+  GArray *columns, *cells;
+  gchar *render_key;
+  const gchar *text;
+  guint i;
 
   if (overlay->auto_adjust_size) {
     /* 640 pixel is default */
@@ -1933,92 +2250,79 @@ gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
       ceil (outline_offset / 2.0l) - ink_rect.x,
       ceil (outline_offset / 2.0l) - ink_rect.y);
 
-  /* reallocate overlay buffer */
-  buffer = gst_buffer_new_and_alloc (4 * width * height);
-  gst_buffer_replace (&overlay->text_image, buffer);
-  gst_buffer_unref (buffer);
+  if (!gst_base_text_overlay_get_columns (overlay, &cairo_matrix, string,
+          width, &columns)) {
+    GstBaseTextOverlayColumn column = { 0, width, 0, textlen, 0.0 };
 
-  gst_buffer_map (buffer, &map, GST_MAP_READWRITE);
-  surface = cairo_image_surface_create_for_data (map.data,
-      CAIRO_FORMAT_ARGB32, width, height, width * 4);
-  cr = cairo_create (surface);
+    g_array_set_size (columns, 0);
+    g_array_append_val (columns, column);
+  }
 
-  /* clear surface */
-  cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
-  cairo_paint (cr);
+  render_key = gst_base_text_overlay_get_render_key (overlay, &cairo_matrix,
+      height);
+  text = columns->len > 1 ? pango_layout_get_text (overlay->layout) : string;
 
-  cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+  cells = g_array_sized_new (FALSE, TRUE, sizeof (GstBaseTextOverlayCell),
+      columns->len);
+  g_array_set_clear_func (cells,
+      (GDestroyNotify) gst_base_text_overlay_cell_clear);
 
-  /* apply transformations */
-  cairo_set_matrix (cr, &cairo_matrix);
+  for (i = 0; i < columns->len; i++) {
+    GstBaseTextOverlayColumn *column, *prev, *next;
+    GstBaseTextOverlayCell cell = { NULL, };
+    gint start, end;
+    gchar *key;
+    guint j;
 
-  /* FIXME: We use show_layout everywhere except for the surface
-   * because it's really faster and internally does all kinds of
-   * caching. Unfortunately we have to paint to a cairo path for
-   * the outline and this is slow. Once Pango supports user fonts
-   * we should use them, see
-   * https://bugzilla.gnome.org/show_bug.cgi?id=598695
-   *
-   * Idea would the be, to create a cairo user font that
-   * does shadow, outline, text painting in the
-   * render_glyph function.
-   */
+    column = &g_array_index (columns, GstBaseTextOverlayColumn, i);
+    prev = i > 0 ? column - 1 : column;
+    next = i + 1 < columns->len ? column + 1 : column;
 
-  /* draw shadow text */
-  if (overlay->draw_shadow) {
-    PangoAttrList *origin_attr, *filtered_attr, *temp_attr;
+    /* glyphs can reach into the neighbouring columns, so these are part of
+     * what is rendered into a column */
+    start = prev->index;
+    end = next->index + next->len;
 
-    /* Store a ref on the original attributes for later restoration */
-    origin_attr =
-        pango_attr_list_ref (pango_layout_get_attributes (overlay->layout));
-    /* Take a copy of the original attributes, because pango_attr_list_filter
-     * modifies the passed list */
-    temp_attr = pango_attr_list_copy (origin_attr);
-    filtered_attr =
-        pango_attr_list_filter (temp_attr,
-        gst_text_overlay_filter_foreground_attr, NULL);
-    pango_attr_list_unref (temp_attr);
+    key = g_strdup_printf ("%s|%d+%d@%.3f|%.*s", render_key, column->x,
+        column->width, column->origin, end - start, text + start);
 
-    cairo_save (cr);
-    cairo_translate (cr, overlay->shadow_offset, overlay->shadow_offset);
-    cairo_set_source_rgba (cr, 0.0, 0.0, 0.0, 0.5);
-    pango_layout_set_attributes (overlay->layout, filtered_attr);
-    pango_cairo_show_layout (cr, overlay->layout);
-    pango_layout_set_attributes (overlay->layout, origin_attr);
-    pango_attr_list_unref (filtered_attr);
-    pango_attr_list_unref (origin_attr);
-    cairo_restore (cr);
-  }
+    cell.image = gst_base_text_overlay_cache_lookup (key);
+    if (!cell.image) {
+      cell.image = gst_base_text_overlay_render_image (overlay, &cairo_matrix,
+          column->x, column->width, height);
+      gst_base_text_overlay_cache_insert (key, cell.image);
+    } else {
+      GST_LOG_OBJECT (overlay, "reusing image of %.*s", column->len,
+          text + column->index);
+    }
+    g_free (key);
 
-  /* draw outline text */
-  if (overlay->draw_outline) {
-    a = (overlay->outline_color >> 24) & 0xff;
-    r = (overlay->outline_color >> 16) & 0xff;
-    g = (overlay->outline_color >> 8) & 0xff;
-    b = (overlay->outline_color >> 0) & 0xff;
+    cell.x = column->x;
+    cell.width = column->width;
 
-    cairo_save (cr);
-    cairo_set_source_rgba (cr, r / 255.0, g / 255.0, b / 255.0, a / 255.0);
-    cairo_set_line_width (cr, overlay->outline_offset);
-    pango_cairo_layout_path (cr, overlay->layout);
-    cairo_stroke (cr);
-    cairo_restore (cr);
+    /* take the rectangle of the same image from the previous text */
+    for (j = 0; j < overlay->text_cells->len; j++) {
+      GstBaseTextOverlayCell *old =
+          &g_array_index (overlay->text_cells, GstBaseTextOverlayCell, j);
+
+      if (old->image == cell.image && old->x == cell.x && old->rectangle) {
+        cell.rectangle = old->rectangle;
+        cell.xpos = old->xpos;
+        cell.ypos = old->ypos;
+        old->rectangle = NULL;
+        break;
+      }
+    }
+
+    g_array_append_val (cells, cell);
   }
 
-  a = (overlay->color >> 24) & 0xff;
-  r = (overlay->color >> 16) & 0xff;
-  g = (overlay->color >> 8) & 0xff;
-  b = (overlay->color >> 0) & 0xff;
+  g_array_unref (overlay->text_cells);
+  overlay->text_cells = cells;
 
-  /* draw text */
-  cairo_save (cr);
-  cairo_set_source_rgba (cr, r / 255.0, g / 255.0, b / 255.0, a / 255.0);
-  pango_cairo_show_layout (cr, overlay->layout);
-  cairo_restore (cr);
+  g_array_unref (columns);
+  g_free (render_key);
 
-  cairo_destroy (cr);
-  cairo_surface_destroy (surface);
-  gst_buffer_unmap (buffer, &map);
   if (width != 0)
     overlay->text_width = width;
   if (height != 0)
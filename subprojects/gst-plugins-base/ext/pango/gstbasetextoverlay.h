@@ -198,7 +198,7 @@ struct _GstBaseTextOverlay {
 
     /* rendering state */
     gboolean                 need_render;
-    GstBuffer               *text_image;
+    GArray                  *text_cells;  /* GstBaseTextOverlayCell */
 
     /* dimension relative to witch the render is done, this is the stream size
      * or a portion of the window_size (adapted to aspect ratio) */
@@ -207,7 +207,7 @@ struct _GstBaseTextOverlay {
     /* This is (render_width / width) uses to convert to stream scale */
     gdouble                  render_scale;
 
-    /* dimension of text_image, the physical dimension */
+    /* dimension of the text image, the physical dimension */
     guint                    text_width;
     guint                    text_height;
 
@@ -0,0 +1,395 @@
+/* GStreamer NUMA aware system memory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gstnumamemory
+ * @title: GstNumaAllocator
+ * @short_description: System memory allocated on a NUMA node
+ * @see_also: #GstMemory, #GstBufferPool
+ *
+ * A #GstNumaAllocator allocates system memory that is placed on a given NUMA
+ * node, or on the node of the thread doing the allocation if
+ * %GST_NUMA_NODE_ANY is used. Placing buffers on the node of the threads
+ * processing them avoids the memory traffic between sockets on multi-socket
+ * machines.
+ *
+ * With %GST_NUMA_ALLOCATOR_FLAG_HUGE_PAGES, allocations of at least the huge
+ * page size, like large video frames, are backed by huge pages to reduce TLB
+ * misses.
+ *
+ * The memory is readable and writable like the default system memory. Buffer
+ * pools use it when it is configured with
+ * gst_buffer_pool_config_set_allocator() together with the
+ * #GstAllocationParams of the allocation, for example from the
+ * propose_allocation or decide_allocation implementation of an element.
+ *
+ * Node binding is only implemented on Linux. On other systems the memory is
+ * placed according to the default policy of the system.
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstnumamemory.h"
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+GST_DEBUG_CATEGORY_STATIC (gst_numamemory_debug);
+#define GST_CAT_DEFAULT gst_numamemory_debug
+
+/* from linux/mempolicy.h, prefer the node but fall back to others when it
+ * is out of memory */
+#define NUMA_MPOL_PREFERRED 1
+
+/* size of the huge pages used for transparent huge pages on most
+ * architectures */
+#define NUMA_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+#define ROUND_UP(size, align) (((size) + (align) - 1) & ~((gsize) (align) - 1))
+
+struct _GstNumaAllocator
+{
+  GstAllocator parent;
+
+  gint node;
+  GstNumaAllocatorFlags flags;
+  gsize page_size;
+};
+
+typedef struct
+{
+  GstMemory mem;
+
+  gpointer data;
+  gsize alloc_size;
+  gint node;
+} GstNumaMemory;
+
+G_DEFINE_TYPE (GstNumaAllocator, gst_numa_allocator, GST_TYPE_ALLOCATOR);
+
+static gint
+gst_numa_get_current_node (void)
+{
+#if defined (__linux__) && defined (SYS_getcpu)
+  unsigned int cpu, node;
+
+  if (syscall (SYS_getcpu, &cpu, &node, NULL) == 0)
+    return node;
+#endif
+
+  return GST_NUMA_NODE_ANY;
+}
+
+static gboolean
+gst_numa_bind (gpointer data, gsize size, gint node)
+{
+#if defined (__linux__) && defined (SYS_mbind)
+  unsigned long mask[16] = { 0, };
+  const guint bits = 8 * sizeof (unsigned long);
+
+  /* the kernel only looks at maxnode - 1 bits */
+  if (node >= G_N_ELEMENTS (mask) * bits - 1)
+    return FALSE;
+
+  mask[node / bits] |= 1UL << (node % bits);
+
+  if (syscall (SYS_mbind, data, size, NUMA_MPOL_PREFERRED, mask,
+          (unsigned long) (G_N_ELEMENTS (mask) * bits), 0) == 0)
+    return TRUE;
+
+  GST_WARNING ("could not bind %p to node %d: %s", data, node,
+      g_strerror (errno));
+#endif
+
+  return FALSE;
+}
+
+static GstMemory *
+gst_numa_allocator_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+#ifdef HAVE_MMAP
+  GstNumaAllocator *self = GST_NUMA_ALLOCATOR (allocator);
+  GstNumaMemory *mem;
+  gsize maxsize, alloc_size;
+  gpointer data = NULL;
+  gboolean huge;
+  gint node;
+
+  maxsize = size + params->prefix + params->padding;
+
+  /* mmap returns page aligned memory */
+  if (params->align >= self->page_size) {
+    GST_WARNING_OBJECT (self, "alignment %" G_GSIZE_FORMAT " not supported",
+        params->align + 1);
+    return NULL;
+  }
+
+  huge = (self->flags & GST_NUMA_ALLOCATOR_FLAG_HUGE_PAGES)
+      && maxsize >= NUMA_HUGE_PAGE_SIZE;
+
+  if (huge) {
+    alloc_size = ROUND_UP (maxsize, NUMA_HUGE_PAGE_SIZE);
+#ifdef MAP_HUGETLB
+    data = mmap (NULL, alloc_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data == MAP_FAILED) {
+      GST_LOG_OBJECT (self, "no hugetlb pages for %" G_GSIZE_FORMAT " bytes",
+          alloc_size);
+      data = NULL;
+    }
+#endif
+  } else {
+    alloc_size = ROUND_UP (maxsize, self->page_size);
+  }
+
+  if (data == NULL) {
+    data = mmap (NULL, alloc_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      GST_WARNING_OBJECT (self, "mmap of %" G_GSIZE_FORMAT " bytes failed: %s",
+          alloc_size, g_strerror (errno));
+      return NULL;
+    }
+#ifdef MADV_HUGEPAGE
+    if (huge)
+      madvise (data, alloc_size, MADV_HUGEPAGE);
+#endif
+  }
+
+  /* bind before the pages are touched for the first time */
+  node = self->node != GST_NUMA_NODE_ANY ? self->node :
+      gst_numa_get_current_node ();
+  if (node != GST_NUMA_NODE_ANY && !gst_numa_bind (data, alloc_size, node))
+    node = GST_NUMA_NODE_ANY;
+
+  mem = g_slice_new (GstNumaMemory);
+  /* anonymous mappings are zero filled */
+  gst_memory_init (GST_MEMORY_CAST (mem), params->flags |
+      GST_MEMORY_FLAG_ZERO_PREFIXED | GST_MEMORY_FLAG_ZERO_PADDED, allocator,
+      NULL, maxsize, params->align, params->prefix, size);
+  mem->data = data;
+  mem->alloc_size = alloc_size;
+  mem->node = node;
+
+  GST_LOG_OBJECT (self, "%p: allocated %" G_GSIZE_FORMAT " bytes on node %d",
+      mem, alloc_size, node);
+
+  return GST_MEMORY_CAST (mem);
+#else /* !HAVE_MMAP */
+  return NULL;
+#endif
+}
+
+static void
+gst_numa_allocator_free (GstAllocator * allocator, GstMemory * gmem)
+{
+  GstNumaMemory *mem = (GstNumaMemory *) gmem;
+
+#ifdef HAVE_MMAP
+  if (gmem->parent == NULL)
+    munmap (mem->data, mem->alloc_size);
+#endif
+
+  GST_LOG ("%p: freed", mem);
+  g_slice_free (GstNumaMemory, mem);
+}
+
+static gpointer
+gst_numa_mem_map (GstMemory * gmem, gsize maxsize, GstMapFlags flags)
+{
+  return ((GstNumaMemory *) gmem)->data;
+}
+
+static void
+gst_numa_mem_unmap (GstMemory * gmem)
+{
+}
+
+static GstMemory *
+gst_numa_mem_share (GstMemory * gmem, gssize offset, gssize size)
+{
+  GstNumaMemory *mem = (GstNumaMemory *) gmem;
+  GstNumaMemory *sub;
+  GstMemory *parent;
+
+  /* find the real parent */
+  if ((parent = gmem->parent) == NULL)
+    parent = gmem;
+
+  if (size == -1)
+    size = gmem->size - offset;
+
+  sub = g_slice_new (GstNumaMemory);
+  /* the shared memory is always readonly */
+  gst_memory_init (GST_MEMORY_CAST (sub), GST_MINI_OBJECT_FLAGS (parent) |
+      GST_MINI_OBJECT_FLAG_LOCK_READONLY, gmem->allocator, parent,
+      gmem->maxsize, gmem->align, gmem->offset + offset, size);
+  sub->data = mem->data;
+  sub->alloc_size = mem->alloc_size;
+  sub->node = mem->node;
+
+  return GST_MEMORY_CAST (sub);
+}
+
+static GstMemory *
+gst_numa_mem_copy (GstMemory * gmem, gssize offset, gssize size)
+{
+  GstNumaMemory *mem = (GstNumaMemory *) gmem;
+  GstAllocationParams params = { 0, gmem->align, 0, 0, };
+  GstMemory *copy;
+
+  if (size == -1)
+    size = gmem->size > offset ? gmem->size - offset : 0;
+
+  copy = gst_allocator_alloc (gmem->allocator, size, &params);
+  if (copy == NULL)
+    return NULL;
+
+  memcpy (((GstNumaMemory *) copy)->data,
+      (guint8 *) mem->data + gmem->offset + offset, size);
+
+  return copy;
+}
+
+static void
+gst_numa_allocator_class_init (GstNumaAllocatorClass * klass)
+{
+  GstAllocatorClass *allocator_class = (GstAllocatorClass *) klass;
+
+  allocator_class->alloc = gst_numa_allocator_alloc;
+  allocator_class->free = gst_numa_allocator_free;
+
+  GST_DEBUG_CATEGORY_INIT (gst_numamemory_debug, "numamemory", 0,
+      "GstNumaMemory and GstNumaAllocator");
+}
+
+static void
+gst_numa_allocator_init (GstNumaAllocator * allocator)
+{
+  GstAllocator *alloc = GST_ALLOCATOR_CAST (allocator);
+
+  alloc->mem_type = GST_ALLOCATOR_NUMA;
+
+  alloc->mem_map = gst_numa_mem_map;
+  alloc->mem_unmap = gst_numa_mem_unmap;
+  alloc->mem_share = gst_numa_mem_share;
+  alloc->mem_copy = gst_numa_mem_copy;
+
+  allocator->node = GST_NUMA_NODE_ANY;
+#ifdef HAVE_MMAP
+  allocator->page_size = sysconf (_SC_PAGESIZE);
+#endif
+}
+
+/**
+ * gst_numa_allocator_new:
+ * @node: the NUMA node to allocate memory on, or %GST_NUMA_NODE_ANY to use
+ *     the node of the thread doing the allocation
+ * @flags: #GstNumaAllocatorFlags
+ *
+ * Create a new NUMA aware system memory allocator.
+ *
+ * Returns: (transfer full) (nullable): a new #GstNumaAllocator, or %NULL if
+ *    the allocator isn't available. Use gst_object_unref() to release the
+ *    allocator after usage.
+ *
+ * Since: 1.22
+ */
+GstAllocator *
+gst_numa_allocator_new (gint node, GstNumaAllocatorFlags flags)
+{
+#ifdef HAVE_MMAP
+  GstNumaAllocator *alloc;
+
+  g_return_val_if_fail (node >= GST_NUMA_NODE_ANY, NULL);
+
+  alloc = g_object_new (GST_TYPE_NUMA_ALLOCATOR, NULL);
+  gst_object_ref_sink (alloc);
+
+  alloc->node = node;
+  alloc->flags = flags;
+
+  return GST_ALLOCATOR_CAST (alloc);
+#else /* !HAVE_MMAP */
+  return NULL;
+#endif
+}
+
+/**
+ * gst_numa_allocator_get_node:
+ * @allocator: a #GstNumaAllocator
+ *
+ * Returns: the NUMA node @allocator allocates memory on, or
+ *    %GST_NUMA_NODE_ANY if it uses the node of the allocating thread
+ *
+ * Since: 1.22
+ */
+gint
+gst_numa_allocator_get_node (GstNumaAllocator * allocator)
+{
+  g_return_val_if_fail (GST_IS_NUMA_ALLOCATOR (allocator), GST_NUMA_NODE_ANY);
+
+  return allocator->node;
+}
+
+/**
+ * gst_is_numa_memory:
+ * @mem: a #GstMemory
+ *
+ * Returns: %TRUE if @mem was allocated by a #GstNumaAllocator
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_is_numa_memory (GstMemory * mem)
+{
+  g_return_val_if_fail (mem != NULL, FALSE);
+
+  return gst_memory_is_type (mem, GST_ALLOCATOR_NUMA);
+}
+
+/**
+ * gst_numa_memory_get_node:
+ * @mem: a #GstMemory allocated by a #GstNumaAllocator
+ *
+ * Returns: the NUMA node @mem was bound to, or %GST_NUMA_NODE_ANY if it
+ *    could not be bound
+ *
+ * Since: 1.22
+ */
+gint
+gst_numa_memory_get_node (GstMemory * mem)
+{
+  g_return_val_if_fail (gst_is_numa_memory (mem), GST_NUMA_NODE_ANY);
+
+  return ((GstNumaMemory *) mem)->node;
+}
@@ -0,0 +1,81 @@
+/* GStreamer NUMA aware system memory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_NUMA_MEMORY_H__
+#define __GST_NUMA_MEMORY_H__
+
+#include <gst/gst.h>
+#include <gst/allocators/allocators-prelude.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GST_ALLOCATOR_NUMA:
+ *
+ * The memory type of memory allocated by a #GstNumaAllocator.
+ *
+ * Since: 1.22
+ */
+#define GST_ALLOCATOR_NUMA "NumaMemory"
+
+/**
+ * GST_NUMA_NODE_ANY:
+ *
+ * Node number to allocate memory on the NUMA node of the allocating thread.
+ *
+ * Since: 1.22
+ */
+#define GST_NUMA_NODE_ANY (-1)
+
+/**
+ * GstNumaAllocatorFlags:
+ * @GST_NUMA_ALLOCATOR_FLAG_NONE: no flag
+ * @GST_NUMA_ALLOCATOR_FLAG_HUGE_PAGES: back large allocations with huge
+ *     pages, from the hugetlb pool if possible and otherwise with transparent
+ *     huge pages.
+ *
+ * Flags to control the allocations of a #GstNumaAllocator.
+ *
+ * Since: 1.22
+ */
+typedef enum {
+  GST_NUMA_ALLOCATOR_FLAG_NONE = 0,
+  GST_NUMA_ALLOCATOR_FLAG_HUGE_PAGES = (1 << 0),
+} GstNumaAllocatorFlags;
+
+#define GST_TYPE_NUMA_ALLOCATOR (gst_numa_allocator_get_type())
+GST_ALLOCATORS_API
+G_DECLARE_FINAL_TYPE (GstNumaAllocator, gst_numa_allocator, GST,
+    NUMA_ALLOCATOR, GstAllocator)
+
+GST_ALLOCATORS_API
+GstAllocator *  gst_numa_allocator_new       (gint node,
+                                              GstNumaAllocatorFlags flags);
+
+GST_ALLOCATORS_API
+gint            gst_numa_allocator_get_node  (GstNumaAllocator * allocator);
+
+GST_ALLOCATORS_API
+gboolean        gst_is_numa_memory           (GstMemory * mem);
+
+GST_ALLOCATORS_API
+gint            gst_numa_memory_get_node     (GstMemory * mem);
+
+G_END_DECLS
+
+#endif /* __GST_NUMA_MEMORY_H__ */
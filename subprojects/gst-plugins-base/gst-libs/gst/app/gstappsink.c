@@ -133,6 +133,12 @@ struct _GstAppSinkPrivate
   gboolean is_eos;
   gboolean buffer_lists_supported;
 
+  /* readable while buffers are queued or EOS was reached, only created
+   * once the application asks for the pollfd */
+  GstPoll *poll;
+  GPollFD pollfd;
+  gboolean poll_signalled;
+
   Callbacks *callbacks;
 
   GstSample *sample;
@@ -610,6 +616,8 @@ gst_app_sink_finalize (GObject * obj)
   g_mutex_clear (&priv->mutex);
   g_cond_clear (&priv->cond);
   gst_queue_array_free (priv->queue);
+  if (priv->poll)
+    gst_poll_free (priv->poll);
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -718,6 +726,27 @@ gst_app_sink_unlock_stop (GstBaseSink * bsink)
   return TRUE;
 }
 
+/* must be called with the mutex held, makes the pollfd readable as long as
+ * there is something the application can pull */
+static void
+gst_app_sink_update_pollfd (GstAppSink * appsink)
+{
+  GstAppSinkPrivate *priv = appsink->priv;
+  gboolean readable;
+
+  if (priv->poll == NULL)
+    return;
+
+  readable = priv->num_buffers > 0 || priv->is_eos;
+
+  if (readable && !priv->poll_signalled) {
+    priv->poll_signalled = gst_poll_write_control (priv->poll);
+  } else if (!readable && priv->poll_signalled) {
+    if (gst_poll_read_control (priv->poll))
+      priv->poll_signalled = FALSE;
+  }
+}
+
 static void
 gst_app_sink_flush_unlocked (GstAppSink * appsink)
 {
@@ -732,6 +761,7 @@ gst_app_sink_flush_unlocked (GstAppSink * appsink)
   priv->num_buffers = 0;
   priv->num_events = 0;
   gst_caps_replace (&priv->last_caps, NULL);
+  gst_app_sink_update_pollfd (appsink);
   g_cond_signal (&priv->cond);
 }
 
@@ -820,6 +850,7 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
       g_mutex_lock (&priv->mutex);
       GST_DEBUG_OBJECT (appsink, "receiving EOS");
       priv->is_eos = TRUE;
+      gst_app_sink_update_pollfd (appsink);
       g_cond_signal (&priv->cond);
       g_mutex_unlock (&priv->mutex);
 
@@ -973,6 +1004,7 @@ dequeue_object (GstAppSink * appsink)
   if (GST_IS_BUFFER (obj) || GST_IS_BUFFER_LIST (obj)) {
     GST_DEBUG_OBJECT (appsink, "dequeued buffer/list %p", obj);
     priv->num_buffers--;
+    gst_app_sink_update_pollfd (appsink);
   } else if (GST_IS_EVENT (obj)) {
     GstEvent *event = GST_EVENT_CAST (obj);
 
@@ -1086,6 +1118,7 @@ restart:
   /* we need to ref the buffer/list when pushing it in the queue */
   gst_queue_array_push_tail (priv->queue, gst_mini_object_ref (data));
   priv->num_buffers++;
+  gst_app_sink_update_pollfd (appsink);
 
   if ((priv->wait_status & APP_WAITING))
     g_cond_signal (&priv->cond);
@@ -1961,6 +1994,153 @@ not_started:
   }
 }
 
+/**
+ * gst_app_sink_try_pull_samples:
+ * @appsink: a #GstAppSink
+ * @samples: (out caller-allocates) (array length=n_samples) (transfer full):
+ *     an array of at least @n_samples #GstSample pointers to fill
+ * @n_samples: the maximum number of samples to pull
+ * @timeout: the maximum amount of time to wait for the first sample
+ *
+ * This function blocks until at least one sample or EOS becomes available or
+ * the appsink element is set to the READY/NULL state or the timeout expires,
+ * like gst_app_sink_try_pull_sample(). It then takes up to @n_samples of the
+ * queued samples at once, which is cheaper than pulling them one by one when
+ * a lot of small buffers are queued.
+ *
+ * Serialized events queued in between the samples are handled like
+ * gst_app_sink_try_pull_sample() does and are not returned.
+ *
+ * Returns: the number of samples stored in @samples, 0 when the appsink is
+ * stopped or EOS or the timeout expires. Call gst_sample_unref() on each of
+ * them after usage.
+ *
+ * Since: 1.22
+ */
+guint
+gst_app_sink_try_pull_samples (GstAppSink * appsink, GstSample ** samples,
+    guint n_samples, GstClockTime timeout)
+{
+  GstAppSinkPrivate *priv;
+  gboolean timeout_valid;
+  gint64 end_time;
+  guint n = 0;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), 0);
+  g_return_val_if_fail (samples != NULL || n_samples == 0, 0);
+
+  if (n_samples == 0)
+    return 0;
+
+  timeout_valid = GST_CLOCK_TIME_IS_VALID (timeout);
+
+  if (timeout_valid)
+    end_time =
+        g_get_monotonic_time () + timeout / (GST_SECOND / G_TIME_SPAN_SECOND);
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+  gst_buffer_replace (&priv->preroll_buffer, NULL);
+
+  while (TRUE) {
+    GST_DEBUG_OBJECT (appsink, "trying to grab %u samples", n_samples);
+    if (!priv->started)
+      goto done;
+
+    if (priv->num_buffers > 0)
+      break;
+
+    if (priv->is_eos)
+      goto done;
+
+    /* nothing to return, wait */
+    GST_DEBUG_OBJECT (appsink, "waiting for a sample");
+    priv->wait_status |= APP_WAITING;
+    if (timeout_valid) {
+      if (!g_cond_wait_until (&priv->cond, &priv->mutex, end_time)) {
+        GST_DEBUG_OBJECT (appsink, "timeout expired, return 0");
+        priv->wait_status &= ~APP_WAITING;
+        goto done;
+      }
+    } else {
+      g_cond_wait (&priv->cond, &priv->mutex);
+    }
+    priv->wait_status &= ~APP_WAITING;
+  }
+
+  while (n < n_samples && priv->num_buffers > 0) {
+    GstMiniObject *obj = dequeue_object (appsink);
+
+    if (GST_IS_BUFFER (obj)) {
+      priv->sample = gst_sample_make_writable (priv->sample);
+      gst_sample_set_buffer_list (priv->sample, NULL);
+      gst_sample_set_buffer (priv->sample, GST_BUFFER_CAST (obj));
+      samples[n++] = gst_sample_ref (priv->sample);
+    } else if (GST_IS_BUFFER_LIST (obj)) {
+      priv->sample = gst_sample_make_writable (priv->sample);
+      gst_sample_set_buffer (priv->sample, NULL);
+      gst_sample_set_buffer_list (priv->sample, GST_BUFFER_LIST_CAST (obj));
+      samples[n++] = gst_sample_ref (priv->sample);
+    }
+    gst_mini_object_unref (obj);
+  }
+
+  GST_DEBUG_OBJECT (appsink, "pulled %u samples", n);
+
+  if ((priv->wait_status & STREAM_WAITING))
+    g_cond_signal (&priv->cond);
+
+done:
+  g_mutex_unlock (&priv->mutex);
+
+  return n;
+}
+
+/**
+ * gst_app_sink_get_pollfd:
+ * @appsink: a #GstAppSink
+ * @fd: (out): A GPollFD to fill
+ *
+ * Gets a file descriptor which can be used to get notified about samples
+ * being available with functions like g_poll(), and allows integration into
+ * other event loops based on file descriptors instead of using the callbacks
+ * or signals. The POLLIN / %G_IO_IN event is set as long as samples are
+ * queued or EOS was reached. The file descriptor is only created on the
+ * first call and stays valid for the lifetime of @appsink.
+ *
+ * Warning: NEVER read or write anything to the returned fd but only use it
+ * for getting notifications via g_poll() or similar and then use the normal
+ * GstAppSink API, e.g. gst_app_sink_try_pull_samples() with a timeout of 0.
+ *
+ * Since: 1.22
+ */
+void
+gst_app_sink_get_pollfd (GstAppSink * appsink, GPollFD * fd)
+{
+  GstAppSinkPrivate *priv;
+
+  g_return_if_fail (GST_IS_APP_SINK (appsink));
+  g_return_if_fail (fd != NULL);
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+  if (priv->poll == NULL) {
+    priv->poll = gst_poll_new_timer ();
+    if (priv->poll == NULL) {
+      g_mutex_unlock (&priv->mutex);
+      g_critical ("Can't create a poll for %s", GST_OBJECT_NAME (appsink));
+      return;
+    }
+    gst_poll_get_read_gpollfd (priv->poll, &priv->pollfd);
+    /* samples may be queued already */
+    gst_app_sink_update_pollfd (appsink);
+  }
+  *fd = priv->pollfd;
+  g_mutex_unlock (&priv->mutex);
+}
+
 /**
  * gst_app_sink_set_callbacks: (skip)
  * @appsink: a #GstAppSink
@@ -180,6 +180,13 @@ GstSample *     gst_app_sink_try_pull_sample  (GstAppSink *appsink, GstClockTime
 GST_APP_API
 GstMiniObject * gst_app_sink_try_pull_object    (GstAppSink *appsink, GstClockTime timeout);
 
+GST_APP_API
+guint           gst_app_sink_try_pull_samples (GstAppSink *appsink, GstSample **samples,
+                                               guint n_samples, GstClockTime timeout);
+
+GST_APP_API
+void            gst_app_sink_get_pollfd       (GstAppSink *appsink, GPollFD *fd);
+
 GST_APP_API
 void            gst_app_sink_set_callbacks    (GstAppSink * appsink,
                                                GstAppSinkCallbacks *callbacks,
@@ -0,0 +1,190 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-format-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined(__AVX2__)
+#include <immintrin.h>
+
+void
+audio_format_unpack_s16_avx2 (gint32 * d, const gint16 * s, gint len)
+{
+  const __m256i low = _mm256_set1_epi32 (0xffff);
+  const __m256i sign = _mm256_set1_epi32 (0x8000);
+  gint i = 0;
+
+  /* the 16 bits are repeated in the low half to use the full range */
+  for (; i + 8 <= len; i += 8) {
+    __m256i v =
+        _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i *) (s + i)));
+    __m256i l = _mm256_xor_si256 (_mm256_and_si256 (v, low), sign);
+
+    _mm256_storeu_si256 ((__m256i *) (d + i),
+        _mm256_or_si256 (_mm256_slli_epi32 (v, 16), l));
+  }
+  for (; i < len; i++)
+    d[i] = ((guint32) (guint16) s[i] << 16) | ((guint16) s[i] ^ 0x8000);
+}
+
+void
+audio_format_unpack_s16_trunc_avx2 (gint32 * d, const gint16 * s, gint len)
+{
+  gint i = 0;
+
+  for (; i + 8 <= len; i += 8) {
+    __m256i v =
+        _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i *) (s + i)));
+
+    _mm256_storeu_si256 ((__m256i *) (d + i), _mm256_slli_epi32 (v, 16));
+  }
+  for (; i < len; i++)
+    d[i] = (guint32) (guint16) s[i] << 16;
+}
+
+void
+audio_format_pack_s16_avx2 (gint16 * d, const gint32 * s, gint len)
+{
+  gint i = 0;
+
+  for (; i + 16 <= len; i += 16) {
+    __m256i a = _mm256_srai_epi32 (_mm256_loadu_si256 ((const __m256i *)
+            (s + i)), 16);
+    __m256i b = _mm256_srai_epi32 (_mm256_loadu_si256 ((const __m256i *)
+            (s + i + 8)), 16);
+
+    /* packs works per 128 bit lane, put the quadwords back in order */
+    _mm256_storeu_si256 ((__m256i *) (d + i),
+        _mm256_permute4x64_epi64 (_mm256_packs_epi32 (a, b), 0xd8));
+  }
+  for (; i < len; i++)
+    d[i] = s[i] >> 16;
+}
+
+void
+audio_format_unpack_s24_32_avx2 (gint32 * d, const gint32 * s, gint len)
+{
+  gint i = 0;
+
+  for (; i + 8 <= len; i += 8) {
+    __m256i v = _mm256_loadu_si256 ((const __m256i *) (s + i));
+
+    _mm256_storeu_si256 ((__m256i *) (d + i), _mm256_slli_epi32 (v, 8));
+  }
+  for (; i < len; i++)
+    d[i] = (guint32) s[i] << 8;
+}
+
+void
+audio_format_pack_s24_32_avx2 (gint32 * d, const gint32 * s, gint len)
+{
+  gint i = 0;
+
+  for (; i + 8 <= len; i += 8) {
+    __m256i v = _mm256_loadu_si256 ((const __m256i *) (s + i));
+
+    _mm256_storeu_si256 ((__m256i *) (d + i), _mm256_srai_epi32 (v, 8));
+  }
+  for (; i < len; i++)
+    d[i] = s[i] >> 8;
+}
+
+/* 8 packed 24 bit samples are read as two 16 byte loads at offsets 0 and 12,
+ * of which only the lower 12 bytes are used. The loops stop early enough to
+ * not read or write past the end. */
+void
+audio_format_unpack_s24_avx2 (gint32 * d, const guint8 * s, gint len)
+{
+  const __m256i shuf = _mm256_setr_epi8 (-1, 0, 1, 2, -1, 3, 4, 5,
+      -1, 6, 7, 8, -1, 9, 10, 11, -1, 0, 1, 2, -1, 3, 4, 5,
+      -1, 6, 7, 8, -1, 9, 10, 11);
+  gint i = 0;
+
+  for (; i + 10 <= len; i += 8) {
+    const guint8 *p = s + i * 3;
+    __m256i v =
+        _mm256_inserti128_si256 (_mm256_castsi128_si256 (_mm_loadu_si128
+            ((const __m128i *) p)), _mm_loadu_si128 ((const __m128i *) (p +
+                12)), 1);
+
+    _mm256_storeu_si256 ((__m256i *) (d + i), _mm256_shuffle_epi8 (v, shuf));
+  }
+  for (; i < len; i++) {
+    const guint8 *p = s + i * 3;
+
+    d[i] = (guint32) (p[0] | (p[1] << 8) | (p[2] << 16)) << 8;
+  }
+}
+
+void
+audio_format_pack_s24_avx2 (guint8 * d, const gint32 * s, gint len)
+{
+  const __m256i shuf = _mm256_setr_epi8 (1, 2, 3, 5, 6, 7, 9, 10,
+      11, 13, 14, 15, -1, -1, -1, -1, 1, 2, 3, 5, 6, 7, 9, 10,
+      11, 13, 14, 15, -1, -1, -1, -1);
+  gint i = 0;
+
+  for (; i + 10 <= len; i += 8) {
+    guint8 *p = d + i * 3;
+    __m256i v = _mm256_shuffle_epi8 (_mm256_loadu_si256 ((const __m256i *)
+            (s + i)), shuf);
+
+    /* the upper 4 bytes of each store are overwritten by the next one */
+    _mm_storeu_si128 ((__m128i *) p, _mm256_castsi256_si128 (v));
+    _mm_storeu_si128 ((__m128i *) (p + 12), _mm256_extracti128_si256 (v, 1));
+  }
+  for (; i < len; i++) {
+    guint8 *p = d + i * 3;
+    guint32 v = (guint32) s[i] >> 8;
+
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+  }
+}
+
+void
+audio_format_unpack_f32_avx2 (gdouble * d, const gfloat * s, gint len)
+{
+  gint i = 0;
+
+  for (; i + 4 <= len; i += 4)
+    _mm256_storeu_pd (d + i, _mm256_cvtps_pd (_mm_loadu_ps (s + i)));
+  for (; i < len; i++)
+    d[i] = s[i];
+}
+
+void
+audio_format_pack_f32_avx2 (gfloat * d, const gdouble * s, gint len)
+{
+  gint i = 0;
+
+  for (; i + 8 <= len; i += 8) {
+    __m128 a = _mm256_cvtpd_ps (_mm256_loadu_pd (s + i));
+    __m128 b = _mm256_cvtpd_ps (_mm256_loadu_pd (s + i + 4));
+
+    _mm256_storeu_ps (d + i, _mm256_set_m128 (b, a));
+  }
+  for (; i < len; i++)
+    d[i] = s[i];
+}
+#endif
@@ -0,0 +1,50 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef AUDIO_FORMAT_X86_AVX2_H
+#define AUDIO_FORMAT_X86_AVX2_H
+
+#include <glib.h>
+
+/* native endian pack and unpack functions, same results as the ORC and C
+ * versions in audio-format.c */
+G_GNUC_INTERNAL
+void audio_format_unpack_s16_avx2 (gint32 * d, const gint16 * s, gint len);
+G_GNUC_INTERNAL
+void audio_format_unpack_s16_trunc_avx2 (gint32 * d, const gint16 * s,
+    gint len);
+G_GNUC_INTERNAL
+void audio_format_pack_s16_avx2 (gint16 * d, const gint32 * s, gint len);
+
+G_GNUC_INTERNAL
+void audio_format_unpack_s24_32_avx2 (gint32 * d, const gint32 * s, gint len);
+G_GNUC_INTERNAL
+void audio_format_pack_s24_32_avx2 (gint32 * d, const gint32 * s, gint len);
+
+G_GNUC_INTERNAL
+void audio_format_unpack_s24_avx2 (gint32 * d, const guint8 * s, gint len);
+G_GNUC_INTERNAL
+void audio_format_pack_s24_avx2 (guint8 * d, const gint32 * s, gint len);
+
+G_GNUC_INTERNAL
+void audio_format_unpack_f32_avx2 (gdouble * d, const gfloat * s, gint len);
+G_GNUC_INTERNAL
+void audio_format_pack_f32_avx2 (gfloat * d, const gdouble * s, gint len);
+
+#endif /* AUDIO_FORMAT_X86_AVX2_H */
@@ -215,6 +215,53 @@ static void pack_ ##name (const GstAudioFormatInfo *info,               \
     MAKE_ORC_PACK_UNPACK (f64le, f64le)
 #define PACK_F64BE GST_AUDIO_FORMAT_F64, unpack_f64be, pack_f64be
     MAKE_ORC_PACK_UNPACK (f64be, f64be)
+
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN && defined (HAVE_IMMINTRIN_H) && \
+    defined (HAVE_AVX2) && (defined (__GNUC__) || defined (__clang__))
+#include "audio-format-x86-avx2.h"
+#define HAVE_AUDIO_FORMAT_AVX2 1
+
+/* set in gst_audio_format_get_info() when the CPU supports AVX2, the
+ * formats below fall back to the ORC and C versions otherwise */
+static gboolean use_avx2 = FALSE;
+
+#define MAKE_AVX2_PACK_UNPACK(fmt,unpack_func,unpack_trunc_func,pack_func) \
+static void unpack_ ##fmt ##_avx2 (const GstAudioFormatInfo *info,    \
+    GstAudioPackFlags flags, gpointer dest,                             \
+    gconstpointer data, gint length) {                                  \
+  if (!use_avx2)                                                        \
+    unpack_ ##fmt (info, flags, dest, data, length);                    \
+  else if (flags & GST_AUDIO_PACK_FLAG_TRUNCATE_RANGE)                  \
+    unpack_trunc_func (dest, data, length);                             \
+  else                                                                  \
+    unpack_func (dest, data, length);                                   \
+}                                                                       \
+static void pack_ ##fmt ##_avx2 (const GstAudioFormatInfo *info,      \
+    GstAudioPackFlags flags, gconstpointer src,                         \
+    gpointer data, gint length) {                                       \
+  if (use_avx2)                                                         \
+    pack_func (data, src, length);                                      \
+  else                                                                  \
+    pack_ ##fmt (info, flags, src, data, length);                       \
+}
+
+#undef PACK_S16LE
+#define PACK_S16LE GST_AUDIO_FORMAT_S32, unpack_s16le_avx2, pack_s16le_avx2
+MAKE_AVX2_PACK_UNPACK (s16le, audio_format_unpack_s16_avx2,
+    audio_format_unpack_s16_trunc_avx2, audio_format_pack_s16_avx2)
+#undef PACK_S24_32LE
+#define PACK_S24_32LE GST_AUDIO_FORMAT_S32, unpack_s24_32le_avx2, pack_s24_32le_avx2
+    MAKE_AVX2_PACK_UNPACK (s24_32le, audio_format_unpack_s24_32_avx2,
+    audio_format_unpack_s24_32_avx2, audio_format_pack_s24_32_avx2)
+#undef PACK_S24LE
+#define PACK_S24LE GST_AUDIO_FORMAT_S32, unpack_s24le_avx2, pack_s24le_avx2
+    MAKE_AVX2_PACK_UNPACK (s24le, audio_format_unpack_s24_avx2,
+    audio_format_unpack_s24_avx2, audio_format_pack_s24_avx2)
+#undef PACK_F32LE
+#define PACK_F32LE GST_AUDIO_FORMAT_F64, unpack_f32le_avx2, pack_f32le_avx2
+    MAKE_AVX2_PACK_UNPACK (f32le, audio_format_unpack_f32_avx2,
+    audio_format_unpack_f32_avx2, audio_format_pack_f32_avx2)
+#endif
 #define SINT (GST_AUDIO_FORMAT_FLAG_INTEGER | GST_AUDIO_FORMAT_FLAG_SIGNED)
 #define SINT_PACK (SINT | GST_AUDIO_FORMAT_FLAG_UNPACK)
 #define UINT (GST_AUDIO_FORMAT_FLAG_INTEGER)
@@ -448,6 +495,19 @@ gst_audio_format_get_info (GstAudioFormat format)
 {
   g_return_val_if_fail ((gint) format < G_N_ELEMENTS (formats), NULL);
 
+#ifdef HAVE_AUDIO_FORMAT_AVX2
+  {
+    static gsize init = 0;
+
+    if (g_once_init_enter (&init)) {
+      /* ORC has no AVX2 target flag, so ask the CPU directly */
+      __builtin_cpu_init ();
+      use_avx2 = __builtin_cpu_supports ("avx2");
+      g_once_init_leave (&init, 1);
+    }
+  }
+#endif
+
   return &formats[format];
 }
 
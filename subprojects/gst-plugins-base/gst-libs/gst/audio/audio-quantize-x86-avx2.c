@@ -0,0 +1,54 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-quantize-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined(__AVX2__)
+#include <immintrin.h>
+
+/* Steps the 8 xorshift generators in @state in parallel, this produces the
+ * same numbers as fill_random_c() in audio-quantize.c */
+void
+audio_quantize_fill_random_avx2 (guint32 * state, guint32 * r, gint len)
+{
+  __m256i x = _mm256_loadu_si256 ((const __m256i *) state);
+  gint i = 0, j;
+
+  for (; i + 8 <= len; i += 8) {
+    x = _mm256_xor_si256 (x, _mm256_slli_epi32 (x, 13));
+    x = _mm256_xor_si256 (x, _mm256_srli_epi32 (x, 17));
+    x = _mm256_xor_si256 (x, _mm256_slli_epi32 (x, 5));
+    _mm256_storeu_si256 ((__m256i *) (r + i), x);
+  }
+  _mm256_storeu_si256 ((__m256i *) state, x);
+
+  for (j = 0; i < len; i++, j++) {
+    guint32 v = state[j];
+
+    v ^= v << 13;
+    v ^= v >> 17;
+    v ^= v << 5;
+    r[i] = state[j] = v;
+  }
+}
+#endif
@@ -0,0 +1,28 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef AUDIO_QUANTIZE_X86_AVX2_H
+#define AUDIO_QUANTIZE_X86_AVX2_H
+
+#include <glib.h>
+
+G_GNUC_INTERNAL
+void audio_quantize_fill_random_avx2 (guint32 * state, guint32 * r, gint len);
+
+#endif /* AUDIO_QUANTIZE_X86_AVX2_H */
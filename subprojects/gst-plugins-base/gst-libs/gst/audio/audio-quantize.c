@@ -36,9 +36,21 @@
 #include "gstaudiopack.h"
 #include "audio-quantize.h"
 
+#if defined (HAVE_IMMINTRIN_H) && defined (HAVE_AVX2) && \
+    (defined (__GNUC__) || defined (__clang__))
+#include "audio-quantize-x86-avx2.h"
+#define HAVE_QUANTIZE_AVX2 1
+#endif
+
 typedef void (*QuantizeFunc) (GstAudioQuantize * quant, const gpointer src,
     gpointer dst, gint count);
 
+/* number of independent random generators, matches the 8 32-bit values in
+ * an AVX2 register */
+#define QUANTIZE_RANDOM_LANES 8
+/* number of random values generated per call */
+#define RANDOM_BLOCK 256
+
 struct _GstAudioQuantize
 {
   GstAudioDitherMethod dither;
@@ -54,7 +66,8 @@ struct _GstAudioQuantize
 
   /* last random number generated per channel for hifreq TPDF dither */
   gpointer last_random;
-  guint32 random_state;
+  /* independent generators, one per SIMD lane */
+  guint32 random_state[QUANTIZE_RANDOM_LANES];
   /* contains the past quantization errors, error[channels][count] */
   guint error_size;
   gpointer error_buf;
@@ -97,24 +110,51 @@ gst_audio_quantize_quantize_int_none_none (GstAudioQuantize * quant,
 static inline guint32
 gst_fast_random_uint32 (guint32 * state)
 {
-  guint64 x = *state;
+  guint32 x = *state;
   x ^= x << 13;
   x ^= x >> 17;
   x ^= x << 5;
   return (*state = x);
 }
 
-static inline gint32
-gst_fast_random_int32 (guint32 * state)
+/* Fills @r with @len random numbers from QUANTIZE_RANDOM_LANES generators,
+ * the generators are stepped in lock-step so that the compiler can keep them
+ * in one SIMD register. The AVX2 version must produce the same numbers. */
+static void
+fill_random_c (guint32 * state, guint32 * r, gint len)
 {
-  return (gint32) gst_fast_random_uint32 (state);
+  gint i = 0, j;
+
+  for (; i + QUANTIZE_RANDOM_LANES <= len; i += QUANTIZE_RANDOM_LANES) {
+    for (j = 0; j < QUANTIZE_RANDOM_LANES; j++)
+      r[i + j] = gst_fast_random_uint32 (&state[j]);
+  }
+  for (j = 0; i < len; i++, j++)
+    r[i] = gst_fast_random_uint32 (&state[j]);
 }
 
-/* Assuming dither == 2^n,
- * returns one of 2^(n+1) possible random values:
- * -dither <= retval < dither */
-#define RANDOM_INT_DITHER(state, dither)                                       \
-  (- dither + (gst_fast_random_int32 (state) & ((dither << 1) - 1)))
+static void (*fill_random) (guint32 * state, guint32 * r, gint len) =
+    fill_random_c;
+
+/* Assuming dither == 2^n, adds one of 2^(n+1) possible random values
+ * -dither <= val < dither to each of the @len values in @d */
+static void
+add_random_dither (GstAudioQuantize * quant, gint32 * d, gint len,
+    gint32 dither)
+{
+  guint32 r[RANDOM_BLOCK], mask = (dither << 1) - 1;
+
+  while (len > 0) {
+    gint i, n = MIN (len, RANDOM_BLOCK);
+
+    fill_random (quant->random_state, r, n);
+    for (i = 0; i < n; i++)
+      d[i] += (gint32) (r[i] & mask) - dither;
+
+    d += n;
+    len -= n;
+  }
+}
 
 static void
 setup_dither_buf (GstAudioQuantize * quant, gint samples)
@@ -146,26 +186,34 @@ setup_dither_buf (GstAudioQuantize * quant, gint samples)
     case GST_AUDIO_DITHER_RPDF:
       dither = 1 << (shift);
       for (i = 0; i < len; i++)
-        d[i] = bias + RANDOM_INT_DITHER (&quant->random_state, dither);
+        d[i] = bias;
+      add_random_dither (quant, d, len, dither);
       break;
 
     case GST_AUDIO_DITHER_TPDF:
       dither = 1 << (shift - 1);
       for (i = 0; i < len; i++)
-        d[i] =
-            bias + RANDOM_INT_DITHER (&quant->random_state,
-            dither) + RANDOM_INT_DITHER (&quant->random_state, dither);
+        d[i] = bias;
+      add_random_dither (quant, d, len, dither);
+      add_random_dither (quant, d, len, dither);
       break;
 
     case GST_AUDIO_DITHER_TPDF_HF:
     {
       gint32 tmp, *last_random = quant->last_random;
+      guint32 r[RANDOM_BLOCK], mask;
+      gint j, n;
 
       dither = 1 << (shift - 1);
-      for (i = 0; i < len; i++) {
-        tmp = RANDOM_INT_DITHER (&quant->random_state, dither);
-        d[i] = bias + tmp - last_random[i % stride];
-        last_random[i % stride] = tmp;
+      mask = (dither << 1) - 1;
+      for (i = 0; i < len; i += n) {
+        n = MIN (len - i, RANDOM_BLOCK);
+        fill_random (quant->random_state, r, n);
+        for (j = 0; j < n; j++) {
+          tmp = (gint32) (r[j] & mask) - dither;
+          d[i + j] = bias + tmp - last_random[(i + j) % stride];
+          last_random[(i + j) % stride] = tmp;
+        }
       }
       break;
     }
@@ -370,11 +418,30 @@ gst_audio_quantize_setup_noise_shaping (GstAudioQuantize * quant)
   return;
 }
 
+/* splitmix64 finalizer, see https://prng.di.unimi.it/splitmix64.c */
+static guint64
+splitmix64 (guint64 x)
+{
+  x = (x ^ (x >> 30)) * G_GUINT64_CONSTANT (0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * G_GUINT64_CONSTANT (0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
 static void
 gst_audio_quantize_setup_dither (GstAudioQuantize * quant)
 {
-  /* Some non-zero number */
-  quant->random_state = 0xc2d6038f;
+  guint64 seed;
+  gint i;
+
+  /* Each lane gets its own seed. Seeding them with consecutive outputs of
+   * one generator would make every lane the previous one delayed by a
+   * step. */
+  seed = G_GUINT64_CONSTANT (0xc2d6038f);
+  for (i = 0; i < QUANTIZE_RANDOM_LANES; i++) {
+    seed += G_GUINT64_CONSTANT (0x9e3779b97f4a7c15);
+    /* xorshift must not be seeded with 0 */
+    quant->random_state[i] = (splitmix64 (seed) >> 32) | 1;
+  }
 
   switch (quant->dither) {
     case GST_AUDIO_DITHER_TPDF_HF:
@@ -406,6 +473,23 @@ gst_audio_quantize_setup_quantize_func (GstAudioQuantize * quant)
   quant->quantize = quantize_funcs[index];
 }
 
+static void
+gst_audio_quantize_init_simd (void)
+{
+  static gsize init = 0;
+
+  if (g_once_init_enter (&init)) {
+#ifdef HAVE_QUANTIZE_AVX2
+    /* ORC has no AVX2 target flag, so ask the CPU directly */
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx2")) {
+      fill_random = audio_quantize_fill_random_avx2;
+    }
+#endif
+    g_once_init_leave (&init, 1);
+  }
+}
+
 static gint
 count_power (guint v)
 {
@@ -446,6 +530,8 @@ gst_audio_quantize_new (GstAudioDitherMethod dither,
   g_return_val_if_fail (format == GST_AUDIO_FORMAT_S32, NULL);
   g_return_val_if_fail (channels > 0, NULL);
 
+  gst_audio_quantize_init_simd ();
+
   quant = g_slice_new0 (GstAudioQuantize);
   quant->dither = dither;
   quant->ns = ns;
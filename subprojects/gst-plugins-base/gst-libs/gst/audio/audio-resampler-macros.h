@@ -54,24 +54,27 @@ DECL_GET_TAPS_INTERPOLATE_FUNC (gfloat, cubic);
 DECL_GET_TAPS_INTERPOLATE_FUNC (gdouble, cubic);
 
 
+/* Resamples the blocks @first up to @last and returns the number of consumed
+ * input samples and the new phase, without updating the resampler state.
+ * Different ranges of blocks can be processed at the same time because of
+ * that. */
 #define DECL_RESAMPLE_FUNC(type,inter,channels,arch)                    \
 void                                                                    \
 resample_ ##type## _ ##inter## _ ##channels## _ ##arch (GstAudioResampler * resampler,      \
     gpointer in[], gsize in_len,  gpointer out[], gsize out_len,        \
-    gsize * consumed)
+    gint first, gint last, gsize * consumed, gint * phase)
 
 #define MAKE_RESAMPLE_FUNC(type,inter,channels,arch)            \
 DECL_RESAMPLE_FUNC (type, inter, channels, arch)                \
 {                                                               \
   gint c, di = 0;                                               \
   gint n_taps = resampler->n_taps;                              \
-  gint blocks = resampler->blocks;                              \
   gint ostride = resampler->ostride;                            \
   gint taps_stride = resampler->taps_stride;                    \
   gint samp_index = 0;                                          \
   gint samp_phase = 0;                                          \
                                                                 \
-  for (c = 0; c < blocks; c++) {                                \
+  for (c = first; c < last; c++) {                              \
     type *ip = in[c];                                           \
     type *op = ostride == 1 ? out[c] : (type *)out[0] + c;      \
                                                                 \
@@ -94,9 +97,7 @@ DECL_RESAMPLE_FUNC (type, inter, channels, arch)                \
           (in_len - samp_index) * sizeof(type) * channels);     \
   }                                                             \
   *consumed = samp_index - resampler->samp_index;               \
-                                                                \
-  resampler->samp_index = 0;                                    \
-  resampler->samp_phase = samp_phase;                           \
+  *phase = samp_phase;                                          \
 }
 
 #define DECL_RESAMPLE_FUNC_STATIC(type,inter,channels,arch)     \
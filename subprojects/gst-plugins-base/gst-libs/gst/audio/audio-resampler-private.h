@@ -45,10 +45,15 @@ typedef void (*ConvertTapsFunc) (gdouble * tmp_taps, gpointer taps,
 typedef void (*InterpolateFunc) (gpointer o, const gpointer a, gint len,
     const gpointer icoeff, gint astride);
 typedef void (*ResampleFunc) (GstAudioResampler * resampler, gpointer in[],
-    gsize in_len, gpointer out[], gsize out_len, gsize * consumed);
+    gsize in_len, gpointer out[], gsize out_len, gint first, gint last,
+    gsize * consumed, gint * phase);
 typedef void (*DeinterleaveFunc) (GstAudioResampler * resampler,
     gpointer * sbuf, gpointer in[], gsize in_frames);
 
+typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
+typedef struct _ResampleTask ResampleTask;
+typedef struct _ResamplerTable ResamplerTable;
+
 struct _GstAudioResampler
 {
   GstAudioResamplerMethod method;
@@ -72,6 +77,12 @@ struct _GstAudioResampler
   /* for cubic */
   gdouble b, c;
 
+  /* minimum phase prototype of the sinc filter, shared */
+  gboolean minimum_phase;
+  ResamplerTable *min_phase;
+  /* number of history samples before the output sample in the filter */
+  gint taps_delay;
+
   /* temp taps */
   gpointer tmp_taps;
 
@@ -79,17 +90,18 @@ struct _GstAudioResampler
   gint oversample;
   gint n_taps;
   gpointer taps;
-  gpointer taps_mem;
   gsize taps_stride;
   gint n_phases;
-  gint alloc_taps;
-  gint alloc_phases;
+  ResamplerTable *taps_table;
 
-  /* cached taps */
+  /* cached taps, either private and filled on demand or complete and
+   * shared in @cached_table */
   gpointer *cached_phases;
+  gint n_cached_phases;
   gpointer cached_taps;
   gpointer cached_taps_mem;
   gsize cached_taps_stride;
+  ResamplerTable *cached_table;
 
   ConvertTapsFunc convert_taps;
   InterpolateFunc interpolate;
@@ -108,6 +120,11 @@ struct _GstAudioResampler
   gsize samples_len;
   gsize samples_avail;
   gpointer *sbuf;
+
+  /* resampling groups of channels in parallel */
+  GstParallelizedTaskRunner *runner;
+  ResampleTask *tasks;
+  ResampleTask **tasks_p;
 };
 
 #endif /* __GST_AUDIO_RESAMPLER_PRIVATE_H__ */
@@ -0,0 +1,216 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined(__AVX2__)
+#include <immintrin.h>
+
+/* The filter tables are only aligned to 16 bytes, so all loads are
+ * unaligned. The loops read as many samples past @len as the SSE versions. */
+
+static inline void
+store_hsum_ps (gfloat * o, __m256 sum)
+{
+  __m128 s = _mm_add_ps (_mm256_castps256_ps128 (sum),
+      _mm256_extractf128_ps (sum, 1));
+
+  s = _mm_add_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_add_ss (s, _mm_shuffle_ps (s, s, 0x55));
+  _mm_store_ss (o, s);
+}
+
+static inline void
+store_hsum_pd (gdouble * o, __m256d sum)
+{
+  __m128d s = _mm_add_pd (_mm256_castpd256_pd128 (sum),
+      _mm256_extractf128_pd (sum, 1));
+
+  s = _mm_add_sd (s, _mm_unpackhi_pd (s, s));
+  _mm_store_sd (o, s);
+}
+
+static inline void
+inner_product_gfloat_full_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    sum =
+        _mm256_add_ps (sum, _mm256_mul_ps (_mm256_loadu_ps (a + i),
+            _mm256_loadu_ps (b + i)));
+  }
+  store_hsum_ps (o, sum);
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[2], t;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_add_ps (sum[0], _mm256_mul_ps (t,
+            _mm256_loadu_ps (c[0] + i)));
+    sum[1] = _mm256_add_ps (sum[1], _mm256_mul_ps (t,
+            _mm256_loadu_ps (c[1] + i)));
+  }
+  sum[0] = _mm256_mul_ps (_mm256_sub_ps (sum[0], sum[1]),
+      _mm256_broadcast_ss (icoeff));
+  sum[0] = _mm256_add_ps (sum[0], sum[1]);
+  store_hsum_ps (o, sum[0]);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_add_ps (sum[0], _mm256_mul_ps (t,
+            _mm256_loadu_ps (c[0] + i)));
+    sum[1] = _mm256_add_ps (sum[1], _mm256_mul_ps (t,
+            _mm256_loadu_ps (c[1] + i)));
+    sum[2] = _mm256_add_ps (sum[2], _mm256_mul_ps (t,
+            _mm256_loadu_ps (c[2] + i)));
+    sum[3] = _mm256_add_ps (sum[3], _mm256_mul_ps (t,
+            _mm256_loadu_ps (c[3] + i)));
+  }
+  sum[0] = _mm256_mul_ps (sum[0], _mm256_broadcast_ss (icoeff + 0));
+  sum[1] = _mm256_mul_ps (sum[1], _mm256_broadcast_ss (icoeff + 1));
+  sum[2] = _mm256_mul_ps (sum[2], _mm256_broadcast_ss (icoeff + 2));
+  sum[3] = _mm256_mul_ps (sum[3], _mm256_broadcast_ss (icoeff + 3));
+  sum[0] = _mm256_add_ps (sum[0], sum[1]);
+  sum[2] = _mm256_add_ps (sum[2], sum[3]);
+  sum[0] = _mm256_add_ps (sum[0], sum[2]);
+  store_hsum_ps (o, sum[0]);
+}
+
+static inline void
+inner_product_gdouble_full_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[2];
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 8) {
+    sum[0] =
+        _mm256_add_pd (sum[0], _mm256_mul_pd (_mm256_loadu_pd (a + i + 0),
+            _mm256_loadu_pd (b + i + 0)));
+    sum[1] =
+        _mm256_add_pd (sum[1], _mm256_mul_pd (_mm256_loadu_pd (a + i + 4),
+            _mm256_loadu_pd (b + i + 4)));
+  }
+  store_hsum_pd (o, _mm256_add_pd (sum[0], sum[1]));
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[2], t;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_add_pd (sum[0], _mm256_mul_pd (t,
+            _mm256_loadu_pd (c[0] + i)));
+    sum[1] = _mm256_add_pd (sum[1], _mm256_mul_pd (t,
+            _mm256_loadu_pd (c[1] + i)));
+  }
+  sum[0] = _mm256_mul_pd (_mm256_sub_pd (sum[0], sum[1]),
+      _mm256_broadcast_sd (icoeff));
+  sum[0] = _mm256_add_pd (sum[0], sum[1]);
+  store_hsum_pd (o, sum[0]);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_add_pd (sum[0], _mm256_mul_pd (t,
+            _mm256_loadu_pd (c[0] + i)));
+    sum[1] = _mm256_add_pd (sum[1], _mm256_mul_pd (t,
+            _mm256_loadu_pd (c[1] + i)));
+    sum[2] = _mm256_add_pd (sum[2], _mm256_mul_pd (t,
+            _mm256_loadu_pd (c[2] + i)));
+    sum[3] = _mm256_add_pd (sum[3], _mm256_mul_pd (t,
+            _mm256_loadu_pd (c[3] + i)));
+  }
+  sum[0] = _mm256_mul_pd (sum[0], _mm256_broadcast_sd (icoeff + 0));
+  sum[1] = _mm256_mul_pd (sum[1], _mm256_broadcast_sd (icoeff + 1));
+  sum[2] = _mm256_mul_pd (sum[2], _mm256_broadcast_sd (icoeff + 2));
+  sum[3] = _mm256_mul_pd (sum[3], _mm256_broadcast_sd (icoeff + 3));
+  sum[0] = _mm256_add_pd (sum[0], sum[1]);
+  sum[2] = _mm256_add_pd (sum[2], sum[3]);
+  sum[0] = _mm256_add_pd (sum[0], sum[2]);
+  store_hsum_pd (o, sum[0]);
+}
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx2);
+
+#endif
@@ -21,6 +21,7 @@
 #include "audio-resampler-x86-sse.h"
 #include "audio-resampler-x86-sse2.h"
 #include "audio-resampler-x86-sse41.h"
+#include "audio-resampler-x86-avx2.h"
 
 static void
 audio_resampler_check_x86 (const gchar *option)
@@ -69,3 +70,27 @@ audio_resampler_check_x86 (const gchar *option)
 #endif
   }
 }
+
+static void
+audio_resampler_check_x86_avx2 (void)
+{
+#if defined (HAVE_IMMINTRIN_H) && defined (HAVE_AVX2) && \
+    (defined (__GNUC__) || defined (__clang__))
+  /* ORC has no AVX2 target flag, so ask the CPU directly */
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2")) {
+    GST_DEBUG ("enable AVX2 optimisations");
+    resample_gfloat_full_1 = resample_gfloat_full_1_avx2;
+    resample_gfloat_linear_1 = resample_gfloat_linear_1_avx2;
+    resample_gfloat_cubic_1 = resample_gfloat_cubic_1_avx2;
+
+    resample_gdouble_full_1 = resample_gdouble_full_1_avx2;
+    resample_gdouble_linear_1 = resample_gdouble_linear_1_avx2;
+    resample_gdouble_cubic_1 = resample_gdouble_cubic_1_avx2;
+  } else {
+    GST_DEBUG ("AVX2 not supported by CPU");
+  }
+#else
+  GST_DEBUG ("AVX2 optimisations not enabled");
+#endif
+}
@@ -48,6 +48,9 @@ GST_DEBUG_CATEGORY_STATIC (audio_resampler_debug);
  * #GstAudioResampler is a structure which holds the information
  * required to perform various kinds of resampling filtering.
  *
+ * The filter tables are shared between all resamplers in the process that
+ * use the same filter parameters.
+ *
  */
 
 static const gint oversample_qualities[] = {
@@ -105,6 +108,8 @@ static const BlackmanQualityMap blackman_qualities[] = {
 #define DEFAULT_OPT_FILTER_INTERPOLATION GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC
 #define DEFAULT_OPT_FILTER_OVERSAMPLE 8
 #define DEFAULT_OPT_MAX_PHASE_ERROR 0.1
+#define DEFAULT_OPT_THREADS 1
+#define DEFAULT_OPT_MINIMUM_PHASE FALSE
 
 static gdouble
 get_opt_double (GstStructure * options, const gchar * name, gdouble def)
@@ -124,6 +129,24 @@ get_opt_int (GstStructure * options, const gchar * name, gint def)
   return res;
 }
 
+static guint
+get_opt_uint (GstStructure * options, const gchar * name, guint def)
+{
+  guint res;
+  if (!options || !gst_structure_get_uint (options, name, &res))
+    res = def;
+  return res;
+}
+
+static gboolean
+get_opt_boolean (GstStructure * options, const gchar * name, gboolean def)
+{
+  gboolean res;
+  if (!options || !gst_structure_get_boolean (options, name, &res))
+    res = def;
+  return res;
+}
+
 static gint
 get_opt_enum (GstStructure * options, const gchar * name, GType type, gint def)
 {
@@ -160,6 +183,10 @@ get_opt_enum (GstStructure * options, const gchar * name, GType type, gint def)
     GST_AUDIO_RESAMPLER_OPT_FILTER_OVERSAMPLE, DEFAULT_OPT_FILTER_OVERSAMPLE)
 #define GET_OPT_MAX_PHASE_ERROR(options) get_opt_double(options, \
     GST_AUDIO_RESAMPLER_OPT_MAX_PHASE_ERROR, DEFAULT_OPT_MAX_PHASE_ERROR)
+#define GET_OPT_THREADS(options) get_opt_uint(options, \
+    GST_AUDIO_RESAMPLER_OPT_THREADS, DEFAULT_OPT_THREADS)
+#define GET_OPT_MINIMUM_PHASE(options) get_opt_boolean(options, \
+    GST_AUDIO_RESAMPLER_OPT_MINIMUM_PHASE, DEFAULT_OPT_MINIMUM_PHASE)
 
 #include "dbesi0.c"
 #define bessel dbesi0
@@ -288,12 +315,331 @@ static ConvertTapsFunc convert_taps_funcs[] = {
 #define convert_taps_gfloat   convert_taps_funcs[2]
 #define convert_taps_gdouble  convert_taps_funcs[3]
 
+/* Filter tables only depend on the parameters that went into them, so they
+ * are kept in a process-wide cache and shared between all resamplers with
+ * the same configuration. Tables are only ever read after they were added
+ * to the cache. Unused tables are kept around until the cache grows beyond
+ * TABLE_CACHE_MAX_SIZE so that a sequence of short lived resamplers does
+ * not need to recalculate them. */
+struct _ResamplerTable
+{
+  gchar *key;
+  gint ref_count;               /* protected by table_cache_lock */
+  gsize size;
+  gpointer mem;
+  /* for minimum phase prototypes */
+  gint resolution;
+  gint delay;
+};
+
+#define TABLE_CACHE_MAX_SIZE (16 * 1024 * 1024)
+
+static GMutex table_cache_lock;
+static GHashTable *table_cache;
+/* most recently used first */
+static GQueue table_cache_lru = G_QUEUE_INIT;
+static gsize table_cache_size;
+
+static void
+resampler_table_free (ResamplerTable * table)
+{
+  g_free (table->key);
+  g_free (table->mem);
+  g_slice_free (ResamplerTable, table);
+}
+
+/* takes ownership of @key and returns a new reference or %NULL */
+static ResamplerTable *
+table_cache_lookup (gchar * key)
+{
+  ResamplerTable *table = NULL;
+
+  g_mutex_lock (&table_cache_lock);
+  if (table_cache)
+    table = g_hash_table_lookup (table_cache, key);
+  if (table) {
+    table->ref_count++;
+    g_queue_remove (&table_cache_lru, table);
+    g_queue_push_head (&table_cache_lru, table);
+  }
+  g_mutex_unlock (&table_cache_lock);
+
+  GST_DEBUG ("%s table %s", table ? "reusing" : "no cached", key);
+  g_free (key);
+
+  return table;
+}
+
+/* takes ownership of @key and @mem */
+static ResamplerTable *
+resampler_table_new (gchar * key, gpointer mem, gsize size)
+{
+  ResamplerTable *table = g_slice_new0 (ResamplerTable);
+
+  table->key = key;
+  table->mem = mem;
+  table->size = size;
+
+  return table;
+}
+
+/* takes ownership of @table and returns a new reference to the cached
+ * table. When another thread added the same table in the meantime, @table is
+ * freed and the existing table is returned. */
+static ResamplerTable *
+table_cache_insert (ResamplerTable * table)
+{
+  ResamplerTable *existing;
+  GList *l, *prev;
+
+  g_mutex_lock (&table_cache_lock);
+  if (table_cache == NULL)
+    table_cache = g_hash_table_new (g_str_hash, g_str_equal);
+
+  existing = g_hash_table_lookup (table_cache, table->key);
+  if (existing) {
+    resampler_table_free (table);
+    existing->ref_count++;
+    g_mutex_unlock (&table_cache_lock);
+    return existing;
+  }
+
+  /* one reference for the cache and one for the caller */
+  table->ref_count = 2;
+  g_hash_table_insert (table_cache, table->key, table);
+  g_queue_push_head (&table_cache_lru, table);
+  table_cache_size += table->size;
+
+  GST_DEBUG ("added table %s of %" G_GSIZE_FORMAT " bytes, cache size %"
+      G_GSIZE_FORMAT, table->key, table->size, table_cache_size);
+
+  /* evict unused tables, least recently used first */
+  for (l = table_cache_lru.tail; l && table_cache_size > TABLE_CACHE_MAX_SIZE;
+      l = prev) {
+    ResamplerTable *t = l->data;
+
+    prev = l->prev;
+    if (t->ref_count > 1)
+      continue;
+
+    GST_DEBUG ("evicting table %s", t->key);
+    g_hash_table_remove (table_cache, t->key);
+    g_queue_delete_link (&table_cache_lru, l);
+    table_cache_size -= t->size;
+    resampler_table_free (t);
+  }
+  g_mutex_unlock (&table_cache_lock);
+
+  return table;
+}
+
+static void
+table_cache_release (ResamplerTable * table)
+{
+  if (table == NULL)
+    return;
+
+  g_mutex_lock (&table_cache_lock);
+  table->ref_count--;
+  g_mutex_unlock (&table_cache_lock);
+}
+
+/* the key contains everything the taps are calculated from, @n_phases is 0
+ * for the interpolated filter table */
+static gchar *
+make_table_key (GstAudioResampler * resampler, gint n_phases)
+{
+  return g_strdup_printf ("taps:%d:%d:%d:%.17g:%.17g:%.17g:%.17g:%d:%d:%d:%d",
+      resampler->method, resampler->format_index, resampler->n_taps,
+      resampler->cutoff, resampler->kaiser_beta, resampler->b, resampler->c,
+      resampler->minimum_phase, resampler->filter_interpolation,
+      resampler->oversample, n_phases);
+}
+
+/* in-place radix-2 FFT of @n complex values, @n must be a power of 2 */
+static void
+fft_complex (gdouble * data, gint n, gboolean inverse)
+{
+  gint i, j, k, m;
+
+  for (i = 1, j = 0; i < n; i++) {
+    gint bit = n >> 1;
+
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+
+    if (i < j) {
+      gdouble t;
+
+      t = data[2 * i];
+      data[2 * i] = data[2 * j];
+      data[2 * j] = t;
+      t = data[2 * i + 1];
+      data[2 * i + 1] = data[2 * j + 1];
+      data[2 * j + 1] = t;
+    }
+  }
+
+  for (m = 2; m <= n; m <<= 1) {
+    gdouble theta = (inverse ? 2.0 : -2.0) * G_PI / m;
+    gdouble wr = cos (theta), wi = sin (theta);
+
+    for (k = 0; k < n; k += m) {
+      gdouble cr = 1.0, ci = 0.0;
+
+      for (j = 0; j < m / 2; j++) {
+        gdouble *a = &data[2 * (k + j)], *b = &data[2 * (k + j + m / 2)];
+        gdouble tr, ti, t;
+
+        tr = b[0] * cr - b[1] * ci;
+        ti = b[0] * ci + b[1] * cr;
+        b[0] = a[0] - tr;
+        b[1] = a[1] - ti;
+        a[0] += tr;
+        a[1] += ti;
+
+        t = cr;
+        cr = cr * wr - ci * wi;
+        ci = t * wi + ci * wr;
+      }
+    }
+  }
+
+  if (inverse) {
+    for (i = 0; i < 2 * n; i++)
+      data[i] /= n;
+  }
+}
+
+static inline gdouble
+get_sinc_tap (GstAudioResampler * resampler, gdouble x)
+{
+  if (resampler->method == GST_AUDIO_RESAMPLER_METHOD_KAISER)
+    return get_kaiser_tap (x, resampler->n_taps, resampler->cutoff,
+        resampler->kaiser_beta);
+  else
+    return get_blackman_nuttall_tap (x, resampler->n_taps, resampler->cutoff);
+}
+
+/* Calculate the minimum phase version of the sinc filter with the
+ * homomorphic method: fold the real cepstrum of the oversampled filter onto
+ * positive quefrencies and transform back. The result is sampled with
+ * @resolution points per tap, starting at the newest sample. */
+static ResamplerTable *
+get_min_phase_table (GstAudioResampler * resampler)
+{
+  ResamplerTable *table;
+  gint i, n, len, resolution, n_taps = resampler->n_taps, delay;
+  gdouble *buf, *proto, max = 0.0, floor_mag, sum = 0.0, moment = 0.0;
+  gchar *key;
+
+  key = g_strdup_printf ("min-phase:%d:%d:%.17g:%.17g", resampler->method,
+      n_taps, resampler->cutoff, resampler->kaiser_beta);
+  if ((table = table_cache_lookup (g_strdup (key)))) {
+    g_free (key);
+    return table;
+  }
+
+  /* longer filters have a lower cutoff and need less oversampling */
+  resolution = CLAMP (16384 / n_taps, 8, 128);
+  len = n_taps * resolution;
+  /* zero pad to reduce aliasing of the cepstrum */
+  n = 1;
+  while (n < 8 * len)
+    n <<= 1;
+
+  buf = g_new0 (gdouble, 2 * n);
+  for (i = 0; i < len; i++)
+    buf[2 * i] = get_sinc_tap (resampler,
+        (gdouble) i / resolution - n_taps / 2);
+
+  /* log magnitude, limited to -200dB */
+  fft_complex (buf, n, FALSE);
+  for (i = 0; i < n; i++) {
+    buf[2 * i] = hypot (buf[2 * i], buf[2 * i + 1]);
+    buf[2 * i + 1] = 0.0;
+    max = MAX (max, buf[2 * i]);
+  }
+  floor_mag = max * 1e-10;
+  for (i = 0; i < n; i++)
+    buf[2 * i] = log (MAX (buf[2 * i], floor_mag));
+
+  /* real cepstrum, folded */
+  fft_complex (buf, n, TRUE);
+  for (i = 0; i < n; i++) {
+    if (i > 0 && i < n / 2)
+      buf[2 * i] *= 2.0;
+    else if (i > n / 2)
+      buf[2 * i] = 0.0;
+    buf[2 * i + 1] = 0.0;
+  }
+
+  /* back to the spectrum and the impulse response */
+  fft_complex (buf, n, FALSE);
+  for (i = 0; i < n; i++) {
+    gdouble mag = exp (buf[2 * i]), phase = buf[2 * i + 1];
+
+    buf[2 * i] = mag * cos (phase);
+    buf[2 * i + 1] = mag * sin (phase);
+  }
+  fft_complex (buf, n, TRUE);
+
+  proto = g_new (gdouble, len);
+  for (i = 0; i < len; i++) {
+    proto[i] = buf[2 * i];
+    sum += proto[i];
+    moment += proto[i] * i;
+  }
+  g_free (buf);
+
+  /* the group delay at DC, in taps */
+  delay = ceil (moment / sum / resolution);
+  delay = CLAMP (delay, 0, n_taps - 1);
+
+  GST_DEBUG ("minimum phase filter with %d taps, delay %d, resolution %d",
+      n_taps, delay, resolution);
+
+  table = resampler_table_new (key, proto, len * sizeof (gdouble));
+  table->resolution = resolution;
+  table->delay = delay;
+
+  return table_cache_insert (table);
+}
+
+/* @x is the position as for the linear phase filter, the minimum phase
+ * filter starts at the newest sample and is shifted by its delay */
+static inline gdouble
+get_min_phase_tap (GstAudioResampler * resampler, gdouble x)
+{
+  ResamplerTable *table = resampler->min_phase;
+  const gdouble *proto = table->mem;
+  gint len = resampler->n_taps * table->resolution, idx;
+  gdouble pos, frac;
+
+  pos = (resampler->n_taps / 2 - x) * table->resolution;
+  if (pos < 0.0 || pos >= len - 1)
+    return 0.0;
+
+  idx = (gint) pos;
+  frac = pos - idx;
+
+  return proto[idx] + (proto[idx + 1] - proto[idx]) * frac;
+}
+
 static void
 make_taps (GstAudioResampler * resampler, gdouble * res, gdouble x, gint n_taps)
 {
   gdouble weight = 0.0, *tmp_taps = resampler->tmp_taps;
   gint i;
 
+  if (resampler->min_phase) {
+    for (i = 0; i < n_taps; i++)
+      weight += tmp_taps[i] = get_min_phase_tap (resampler, x + i);
+    resampler->convert_taps (tmp_taps, res, weight, n_taps);
+    return;
+  }
+
   switch (resampler->method) {
     case GST_AUDIO_RESAMPLER_METHOD_NEAREST:
       break;
@@ -554,6 +900,7 @@ DECL_GET_TAPS_FULL_FUNC(type)
       }                                                                         \
     }                                                                           \
     resampler->cached_phases[phase] = res;                                      \
+    resampler->n_cached_phases++;                                               \
   }                                                                             \
   *samp_index += resampler->samp_inc;                                           \
   *samp_phase += resampler->samp_frac;                                          \
@@ -874,11 +1221,148 @@ audio_resampler_init (void)
         }
       }
     }
+#ifdef CHECK_X86
+    audio_resampler_check_x86_avx2 ();
+#endif
 #endif
     g_once_init_leave (&init_gonce, 1);
   }
 }
 
+typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
+
+struct _GstParallelizedTaskRunner
+{
+  GstTaskPool *pool;
+  guint n_threads;
+  gpointer *tasks;
+};
+
+static GstParallelizedTaskRunner *
+gst_parallelized_task_runner_new (guint n_threads)
+{
+  GstParallelizedTaskRunner *self;
+
+  self = g_new0 (GstParallelizedTaskRunner, 1);
+  self->pool = gst_shared_task_pool_new ();
+  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
+      n_threads - 1);
+  gst_task_pool_prepare (self->pool, NULL);
+  self->n_threads = n_threads;
+  self->tasks = g_new0 (gpointer, n_threads);
+
+  return self;
+}
+
+static void
+gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
+{
+  gst_task_pool_cleanup (self->pool);
+  gst_object_unref (self->pool);
+  g_free (self->tasks);
+  g_free (self);
+}
+
+/* Calls @func with each of the first @n_tasks entries of @task_data, up to
+ * the number of threads of the runner. One of them is run in the current
+ * thread and all of them are finished when this returns. */
+static void
+gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
+    GstParallelizedTaskFunc func, gpointer * task_data, guint n_tasks)
+{
+  guint i;
+
+  g_assert (n_tasks <= self->n_threads);
+
+  for (i = 1; i < n_tasks; i++) {
+    self->tasks[i] = gst_task_pool_push (self->pool, func, task_data[i], NULL);
+    /* run it here if the pool could not take it */
+    if (self->tasks[i] == NULL)
+      func (task_data[i]);
+  }
+
+  func (task_data[0]);
+
+  for (i = 1; i < n_tasks; i++) {
+    if (self->tasks[i])
+      gst_task_pool_join (self->pool, self->tasks[i]);
+    self->tasks[i] = NULL;
+  }
+}
+
+struct _ResampleTask
+{
+  GstAudioResampler *resampler;
+  gpointer *in;
+  gsize in_len;
+  gpointer *out;
+  gsize out_len;
+  gint first, last;
+  gsize consumed;
+  gint phase;
+};
+
+static void
+resample_task (ResampleTask * task)
+{
+  GstAudioResampler *resampler = task->resampler;
+
+  resampler->resample (resampler, task->in, task->in_len, task->out,
+      task->out_len, task->first, task->last, &task->consumed, &task->phase);
+}
+
+/* resample all blocks, using the configured threads for groups of blocks */
+static void
+resample_blocks (GstAudioResampler * resampler, gpointer in[], gsize in_len,
+    gpointer out[], gsize out_len, gsize * consumed)
+{
+  gint blocks = resampler->blocks;
+  gint first = 0, phase = resampler->samp_phase;
+
+  if (resampler->runner == NULL) {
+    resampler->resample (resampler, in, in_len, out, out_len, 0, blocks,
+        consumed, &phase);
+  } else {
+    guint i, n_tasks;
+
+    /* the full filter table is filled while resampling, do the first block
+     * on its own until the table is complete so that the threads only read
+     * from it */
+    if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL &&
+        resampler->method != GST_AUDIO_RESAMPLER_METHOD_NEAREST &&
+        resampler->in_rate != resampler->out_rate &&
+        resampler->n_cached_phases < resampler->n_phases) {
+      resampler->resample (resampler, in, in_len, out, out_len, 0, 1,
+          consumed, &phase);
+      first = 1;
+    }
+
+    n_tasks = MIN (resampler->runner->n_threads, blocks - first);
+    for (i = 0; i < n_tasks; i++) {
+      ResampleTask *task = &resampler->tasks[i];
+
+      task->resampler = resampler;
+      task->in = in;
+      task->in_len = in_len;
+      task->out = out;
+      task->out_len = out_len;
+      task->first = first + (blocks - first) * i / n_tasks;
+      task->last = first + (blocks - first) * (i + 1) / n_tasks;
+    }
+    if (n_tasks > 0) {
+      gst_parallelized_task_runner_run (resampler->runner,
+          (GstParallelizedTaskFunc) resample_task,
+          (gpointer *) resampler->tasks_p, n_tasks);
+      /* all blocks consume the same amount and end on the same phase */
+      *consumed = resampler->tasks[0].consumed;
+      phase = resampler->tasks[0].phase;
+    }
+  }
+
+  resampler->samp_index = 0;
+  resampler->samp_phase = phase;
+}
+
 #define MAKE_DEINTERLEAVE_FUNC(type)                                    \
 static void                                                             \
 deinterleave_ ##type (GstAudioResampler * resampler, gpointer sbuf[],   \
@@ -968,25 +1452,52 @@ calculate_kaiser_params (GstAudioResampler * resampler)
 }
 
 static void
-alloc_taps_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
-    gint n_phases)
+alloc_tmp_taps (GstAudioResampler * resampler, gint n_taps)
 {
-  if (resampler->alloc_taps >= n_taps && resampler->alloc_phases >= n_phases)
-    return;
-
-  GST_DEBUG ("allocate bps %d n_taps %d n_phases %d", bps, n_taps, n_phases);
-
   resampler->tmp_taps =
       g_realloc_n (resampler->tmp_taps, n_taps, sizeof (gdouble));
+}
+
+/* calculates the interpolated filter table or takes it from the cache */
+static void
+setup_taps_table (GstAudioResampler * resampler, gint bps, gint n_taps,
+    gint n_phases)
+{
+  ResamplerTable *table;
+  gchar *key;
+  gsize size;
+  gint i;
+
+  table_cache_release (resampler->taps_table);
 
   resampler->taps_stride = GST_ROUND_UP_32 (bps * (n_taps + TAPS_OVERREAD));
+  size = n_phases * resampler->taps_stride + ALIGN - 1;
+
+  key = make_table_key (resampler, 0);
+  table = table_cache_lookup (g_strdup (key));
+  if (table == NULL) {
+    gpointer mem;
+
+    GST_DEBUG ("allocate bps %d n_taps %d n_phases %d", bps, n_taps,
+        n_phases);
+
+    alloc_tmp_taps (resampler, n_taps);
+    mem = g_malloc0 (size);
+    resampler->taps = MEM_ALIGN ((gint8 *) mem, ALIGN);
 
-  g_free (resampler->taps_mem);
-  resampler->taps_mem =
-      g_malloc0 (n_phases * resampler->taps_stride + ALIGN - 1);
-  resampler->taps = MEM_ALIGN ((gint8 *) resampler->taps_mem, ALIGN);
-  resampler->alloc_taps = n_taps;
-  resampler->alloc_phases = n_phases;
+    for (i = 0; i < n_phases; i++) {
+      gdouble x = -(n_taps / 2) + i / (gdouble) resampler->oversample;
+      gpointer taps = (gint8 *) resampler->taps + i * resampler->taps_stride;
+
+      make_taps (resampler, taps, x, n_taps);
+    }
+    table = table_cache_insert (resampler_table_new (key, mem, size));
+  } else {
+    g_free (key);
+  }
+
+  resampler->taps_table = table;
+  resampler->taps = MEM_ALIGN ((gint8 *) table->mem, ALIGN);
 }
 
 static void
@@ -995,8 +1506,7 @@ alloc_cache_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
 {
   gsize phases_size;
 
-  resampler->tmp_taps =
-      g_realloc_n (resampler->tmp_taps, n_taps, sizeof (gdouble));
+  alloc_tmp_taps (resampler, n_taps);
 
   resampler->cached_taps_stride =
       GST_ROUND_UP_32 (bps * (n_taps + TAPS_OVERREAD));
@@ -1010,6 +1520,76 @@ alloc_cache_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
   resampler->cached_taps =
       MEM_ALIGN ((gint8 *) resampler->cached_taps_mem + phases_size, ALIGN);
   resampler->cached_phases = resampler->cached_taps_mem;
+  resampler->n_cached_phases = 0;
+}
+
+#define FILL_CACHED_TAPS(type)                                  \
+G_STMT_START {                                                  \
+  type icoeff[4];                                               \
+  for (i = 0; i < n_phases; i++) {                              \
+    gint samp_index = 0, samp_phase = i;                        \
+    get_taps_##type##_full (resampler, &samp_index,             \
+        &samp_phase, icoeff);                                   \
+  }                                                             \
+} G_STMT_END
+
+/* sets up the cache of the full filter table. Tables below the memory
+ * threshold are calculated completely and shared, larger ones are private
+ * and filled on demand. Must be called after setup_functions(). */
+static void
+setup_cached_taps (GstAudioResampler * resampler)
+{
+  gint i, bps = resampler->bps, n_taps = resampler->n_taps;
+  gint n_phases = resampler->n_phases;
+  ResamplerTable *table = NULL;
+  gsize stride, size;
+  gchar *key = NULL;
+
+  table_cache_release (resampler->cached_table);
+  resampler->cached_table = NULL;
+  g_free (resampler->cached_taps_mem);
+  resampler->cached_taps_mem = NULL;
+
+  stride = GST_ROUND_UP_32 (bps * (n_taps + TAPS_OVERREAD));
+  size = sizeof (gpointer) * n_phases + n_phases * stride + ALIGN - 1;
+
+  if (n_phases * stride <= resampler->filter_threshold) {
+    key = make_table_key (resampler, n_phases);
+    table = table_cache_lookup (g_strdup (key));
+  }
+
+  if (table == NULL) {
+    alloc_cache_mem (resampler, bps, n_taps, n_phases);
+    if (key == NULL)
+      return;
+
+    switch (resampler->format_index) {
+      case 0:
+        FILL_CACHED_TAPS (gint16);
+        break;
+      case 1:
+        FILL_CACHED_TAPS (gint32);
+        break;
+      case 2:
+        FILL_CACHED_TAPS (gfloat);
+        break;
+      case 3:
+        FILL_CACHED_TAPS (gdouble);
+        break;
+    }
+    table = table_cache_insert (resampler_table_new (key,
+            resampler->cached_taps_mem, size));
+    resampler->cached_taps_mem = NULL;
+  } else {
+    g_free (key);
+  }
+
+  resampler->cached_table = table;
+  resampler->cached_taps_stride = stride;
+  resampler->cached_phases = table->mem;
+  resampler->cached_taps =
+      MEM_ALIGN ((gint8 *) table->mem + sizeof (gpointer) * n_phases, ALIGN);
+  resampler->n_cached_phases = n_phases;
 }
 
 static void
@@ -1107,16 +1687,28 @@ resampler_calculate_taps (GstAudioResampler * resampler)
         gst_util_uint64_scale_int (resampler->n_taps, in_rate, out_rate);
   }
 
+  table_cache_release (resampler->min_phase);
+  resampler->min_phase = NULL;
+
   if (sinc_table) {
     resampler->n_taps = GST_ROUND_UP_8 (resampler->n_taps);
     resampler->filter_mode = GET_OPT_FILTER_MODE (resampler->options);
     resampler->filter_threshold =
         GET_OPT_FILTER_MODE_THRESHOLD (resampler->options);
     filter_interpolation = GET_OPT_FILTER_INTERPOLATION (resampler->options);
-
+    resampler->minimum_phase = GET_OPT_MINIMUM_PHASE (resampler->options);
   } else {
     resampler->filter_mode = GST_AUDIO_RESAMPLER_FILTER_MODE_FULL;
     filter_interpolation = GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE;
+    resampler->minimum_phase = FALSE;
+  }
+
+  if (resampler->minimum_phase) {
+    resampler->min_phase = get_min_phase_table (resampler);
+    /* only the filter delay needs to be looked ahead */
+    resampler->taps_delay = resampler->n_taps - 1 - resampler->min_phase->delay;
+  } else {
+    resampler->taps_delay = resampler->n_taps / 2 - 1;
   }
 
   /* calculate oversampling for interpolated filter */
@@ -1175,18 +1767,9 @@ resampler_calculate_taps (GstAudioResampler * resampler)
 
   resampler->filter_interpolation = filter_interpolation;
 
-  if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL &&
-      resampler->method != GST_AUDIO_RESAMPLER_METHOD_NEAREST) {
-    GST_DEBUG ("setting up filter cache");
-    resampler->n_phases = out_rate;
-    alloc_cache_mem (resampler, bps, n_taps, out_rate);
-  }
-
   if (resampler->filter_interpolation !=
       GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE) {
-    gint i, isize;
-    gdouble x;
-    gpointer taps;
+    gint isize;
 
     switch (resampler->filter_interpolation) {
       default:
@@ -1200,13 +1783,11 @@ resampler_calculate_taps (GstAudioResampler * resampler)
         break;
     }
 
-    alloc_taps_mem (resampler, bps, n_taps, oversample + isize);
-
-    for (i = 0; i < oversample + isize; i++) {
-      x = -(n_taps / 2) + i / (gdouble) oversample;
-      taps = (gint8 *) resampler->taps + i * resampler->taps_stride;
-      make_taps (resampler, taps, x, n_taps);
-    }
+    setup_taps_table (resampler, bps, n_taps, oversample + isize);
+  } else {
+    table_cache_release (resampler->taps_table);
+    resampler->taps_table = NULL;
+    resampler->taps = NULL;
   }
 }
 
@@ -1355,6 +1936,7 @@ gst_audio_resampler_new (GstAudioResamplerMethod method,
   GstAudioResampler *resampler;
   const GstAudioFormatInfo *info;
   GstStructure *def_options = NULL;
+  guint n_threads;
 
   g_return_val_if_fail (method >= GST_AUDIO_RESAMPLER_METHOD_NEAREST
       && method <= GST_AUDIO_RESAMPLER_METHOD_KAISER, NULL);
@@ -1421,6 +2003,22 @@ gst_audio_resampler_new (GstAudioResamplerMethod method,
   gst_audio_resampler_update (resampler, in_rate, out_rate, options);
   gst_audio_resampler_reset (resampler);
 
+  n_threads = GET_OPT_THREADS (options);
+  if (n_threads == 0 || n_threads > g_get_num_processors ())
+    n_threads = g_get_num_processors ();
+  /* we split up the channels between the threads */
+  n_threads = MIN (n_threads, resampler->blocks);
+  if (n_threads > 1) {
+    guint i;
+
+    GST_DEBUG ("resampling with %u threads", n_threads);
+    resampler->runner = gst_parallelized_task_runner_new (n_threads);
+    resampler->tasks = g_new0 (ResampleTask, n_threads);
+    resampler->tasks_p = g_new0 (ResampleTask *, n_threads);
+    for (i = 0; i < n_threads; i++)
+      resampler->tasks_p[i] = &resampler->tasks[i];
+  }
+
   if (def_options)
     gst_structure_free (def_options);
 
@@ -1476,15 +2074,16 @@ gst_audio_resampler_reset (GstAudioResampler * resampler)
     gint c, blocks, bpf;
 
     bpf = resampler->bps * resampler->inc;
-    bytes = (resampler->n_taps / 2) * bpf;
+    bytes = (resampler->taps_delay + 1) * bpf;
     blocks = resampler->blocks;
 
     for (c = 0; c < blocks; c++)
       memset (resampler->sbuf[c], 0, bytes);
   }
-  /* half of the filter is filled with 0 */
+  /* the history before the output sample is filled with 0, this is half of
+   * the filter for linear phase filters */
   resampler->samp_index = 0;
-  resampler->samples_avail = resampler->n_taps / 2 - 1;
+  resampler->samples_avail = resampler->taps_delay;
 }
 
 /**
@@ -1507,7 +2106,7 @@ gboolean
 gst_audio_resampler_update (GstAudioResampler * resampler,
     gint in_rate, gint out_rate, GstStructure * options)
 {
-  gint gcd, samp_phase, old_n_taps;
+  gint gcd, samp_phase, old_n_taps, old_taps_delay;
   gdouble max_error;
 
   g_return_val_if_fail (resampler != NULL, FALSE);
@@ -1571,11 +2170,13 @@ gst_audio_resampler_update (GstAudioResampler * resampler,
     resampler->options = gst_structure_copy (options);
 
     old_n_taps = resampler->n_taps;
+    old_taps_delay = resampler->taps_delay;
 
     resampler_calculate_taps (resampler);
     resampler_dump (resampler);
 
-    if (old_n_taps > 0 && old_n_taps != resampler->n_taps) {
+    if (old_n_taps > 0 && (old_n_taps != resampler->n_taps ||
+            old_taps_delay != resampler->taps_delay)) {
       gpointer *sbuf;
       gint i, bpf, bytes, soff, doff, diff;
 
@@ -1585,9 +2186,10 @@ gst_audio_resampler_update (GstAudioResampler * resampler,
       bytes = resampler->samples_avail * bpf;
       soff = doff = resampler->samp_index * bpf;
 
-      diff = ((gint) resampler->n_taps - old_n_taps) / 2;
+      diff = resampler->taps_delay - old_taps_delay;
 
-      GST_DEBUG ("taps %d->%d, %d", old_n_taps, resampler->n_taps, diff);
+      GST_DEBUG ("taps %d->%d, delay %d->%d", old_n_taps, resampler->n_taps,
+          old_taps_delay, resampler->taps_delay);
 
       if (diff < 0) {
         /* diff < 0, decrease taps, adjust source */
@@ -1606,13 +2208,15 @@ gst_audio_resampler_update (GstAudioResampler * resampler,
 
       resampler->samples_avail += diff;
     }
-  } else if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL) {
+  }
+  setup_functions (resampler);
+
+  if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL &&
+      resampler->method != GST_AUDIO_RESAMPLER_METHOD_NEAREST) {
     GST_DEBUG ("setting up filter cache");
     resampler->n_phases = resampler->out_rate;
-    alloc_cache_mem (resampler, resampler->bps, resampler->n_taps,
-        resampler->n_phases);
+    setup_cached_taps (resampler);
   }
-  setup_functions (resampler);
 
   return TRUE;
 }
@@ -1629,10 +2233,16 @@ gst_audio_resampler_free (GstAudioResampler * resampler)
   g_return_if_fail (resampler != NULL);
 
   g_free (resampler->cached_taps_mem);
-  g_free (resampler->taps_mem);
+  table_cache_release (resampler->cached_table);
+  table_cache_release (resampler->taps_table);
+  table_cache_release (resampler->min_phase);
   g_free (resampler->tmp_taps);
   g_free (resampler->samples);
   g_free (resampler->sbuf);
+  if (resampler->runner)
+    gst_parallelized_task_runner_free (resampler->runner);
+  g_free (resampler->tasks);
+  g_free (resampler->tasks_p);
   if (resampler->options)
     gst_structure_free (resampler->options);
   g_slice_free (GstAudioResampler, resampler);
@@ -1723,7 +2333,7 @@ gst_audio_resampler_get_max_latency (GstAudioResampler * resampler)
 {
   g_return_val_if_fail (resampler != NULL, 0);
 
-  return resampler->n_taps / 2;
+  return resampler->n_taps - 1 - resampler->taps_delay;
 }
 
 /**
@@ -1788,8 +2398,7 @@ gst_audio_resampler_resample (GstAudioResampler * resampler,
   }
 
   /* resample all channels */
-  resampler->resample (resampler, sbuf, samples_avail, out, out_frames,
-      &consumed);
+  resample_blocks (resampler, sbuf, samples_avail, out, out_frames, &consumed);
 
   GST_LOG ("in %" G_GSIZE_FORMAT ", avail %" G_GSIZE_FORMAT ", consumed %"
       G_GSIZE_FORMAT, in_frames, samples_avail, consumed);
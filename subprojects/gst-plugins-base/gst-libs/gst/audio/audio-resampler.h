@@ -164,6 +164,29 @@ typedef enum {
  */
 #define GST_AUDIO_RESAMPLER_OPT_MAX_PHASE_ERROR "GstAudioResampler.max-phase-error"
 
+/**
+ * GST_AUDIO_RESAMPLER_OPT_THREADS:
+ *
+ * G_TYPE_UINT: maximum number of threads to use for resampling. The channels
+ * are split up between the threads. 0 uses one thread per CPU core.
+ * 1 is the default.
+ *
+ * Since: 1.22
+ */
+#define GST_AUDIO_RESAMPLER_OPT_THREADS "GstAudioResampler.threads"
+
+/**
+ * GST_AUDIO_RESAMPLER_OPT_MINIMUM_PHASE:
+ *
+ * G_TYPE_BOOLEAN: use a minimum phase version of the sinc filter. This
+ * trades the linear phase response of the filter for a much lower latency.
+ * Only used with the sinc based methods.
+ * %FALSE is the default.
+ *
+ * Since: 1.22
+ */
+#define GST_AUDIO_RESAMPLER_OPT_MINIMUM_PHASE "GstAudioResampler.minimum-phase"
+
 /**
  * GstAudioResamplerMethod:
  * @GST_AUDIO_RESAMPLER_METHOD_NEAREST: Duplicates the samples when
@@ -50,6 +50,10 @@ struct _GstAudioBaseSinkPrivate
   GstAudioBaseSinkSlaveMethod slave_method;
   /* running average of clock skew */
   GstClockTimeDiff avg_skew;
+  /* integral of the skew in seconds^2 and the time of the last observation
+   * for the PI slaving */
+  gdouble pi_integral;
+  GstClockTime pi_last_etime;
   /* the number of samples we aligned last time */
   gint64 last_align;
 
@@ -1042,6 +1046,8 @@ gst_audio_base_sink_reset_sync (GstAudioBaseSink * sink)
   sink->priv->eos_time = -1;
   sink->priv->discont_time = -1;
   sink->priv->avg_skew = -1;
+  sink->priv->pi_integral = 0.0;
+  sink->priv->pi_last_etime = GST_CLOCK_TIME_NONE;
   sink->priv->last_align = 0;
 }
 
@@ -1526,6 +1532,95 @@ gst_audio_base_sink_skew_slaving (GstAudioBaseSink * sink,
   *srender_stop = render_stop;
 }
 
+/* gains of the PI controller in 1/s and 1/s^2, this is critically damped
+ * with a time constant of 4 seconds */
+#define PI_KP 0.5
+#define PI_KI (PI_KP * PI_KP / 4.0)
+/* maximum rate correction */
+#define PI_MAX_CORRECTION 0.005
+
+/* algorithm that resamples with a rate from a PI controller. The skew
+ * between where the external clock maps to and the internal clock is
+ * measured for every buffer, and the rate is corrected continuously so that
+ * the skew goes to 0 without jumps in the playout pointer. The mapping is
+ * re-anchored at the current time for every new rate. */
+static void
+gst_audio_base_sink_pi_slaving (GstAudioBaseSink * sink,
+    GstClockTime render_start, GstClockTime render_stop,
+    GstClockTime * srender_start, GstClockTime * srender_stop)
+{
+  GstAudioBaseSinkPrivate *priv = sink->priv;
+  GstClockTime cinternal, cexternal, crate_num, crate_denom;
+  GstClockTime etime, itime, mtime;
+  GstClockTimeDiff skew, mdrift;
+  gdouble error, dt, correction;
+
+  gst_clock_get_calibration (sink->provided_clock, &cinternal, &cexternal,
+      &crate_num, &crate_denom);
+  if (crate_num == 0)
+    crate_denom = crate_num = 1;
+
+  /* sample clocks and figure out clock skew */
+  etime = gst_clock_get_time (GST_ELEMENT_CLOCK (sink));
+  itime = gst_audio_clock_get_time (GST_AUDIO_CLOCK (sink->provided_clock));
+  itime =
+      gst_audio_clock_adjust (GST_AUDIO_CLOCK (sink->provided_clock), itime);
+
+  /* where the external time is mapped to with the current rate, positive
+   * skew means that the device consumes samples faster than the master */
+  mtime = clock_convert_external (etime, cinternal, cexternal, crate_num,
+      crate_denom);
+  skew = GST_CLOCK_DIFF (mtime, itime);
+
+  mdrift = priv->drift_tolerance * 1000;
+  if (priv->avg_skew == -1 || ABS (skew) > mdrift) {
+    /* first observation or too far off to correct smoothly, resync at the
+     * current time */
+    if (priv->avg_skew != -1)
+      GST_WARNING_OBJECT (sink, "resync, clock skew %" GST_STIME_FORMAT
+          " > %" GST_STIME_FORMAT, GST_STIME_ARGS (skew),
+          GST_STIME_ARGS (mdrift));
+    if (ABS (skew) > mdrift) {
+      mtime = itime;
+      crate_num = crate_denom = 1;
+      sink->next_sample = -1;
+      priv->pi_integral = 0.0;
+    }
+    priv->avg_skew = GST_CLOCK_DIFF (mtime, itime);
+    dt = 0.0;
+  } else {
+    priv->avg_skew = (31 * priv->avg_skew + skew) / 32;
+    dt = gst_guint64_to_gdouble (etime - priv->pi_last_etime) / GST_SECOND;
+  }
+  priv->pi_last_etime = etime;
+
+  error = (gdouble) priv->avg_skew / GST_SECOND;
+  priv->pi_integral += error * dt;
+  /* limit the integral to what can be corrected to avoid windup */
+  priv->pi_integral = CLAMP (priv->pi_integral,
+      -PI_MAX_CORRECTION / PI_KI, PI_MAX_CORRECTION / PI_KI);
+
+  correction = PI_KP * error + PI_KI * priv->pi_integral;
+  correction = CLAMP (correction, -PI_MAX_CORRECTION, PI_MAX_CORRECTION);
+
+  GST_DEBUG_OBJECT (sink, "skew %" GST_STIME_FORMAT " avg %" GST_STIME_FORMAT
+      " correction %f ppm", GST_STIME_ARGS (skew),
+      GST_STIME_ARGS (priv->avg_skew), correction * 1e6);
+
+  /* internal time advances by rate_denom / rate_num per external time */
+  cinternal = mtime;
+  cexternal = etime;
+  crate_num = GST_SECOND;
+  crate_denom = GST_SECOND + (GstClockTimeDiff) (correction * GST_SECOND);
+  gst_clock_set_calibration (sink->provided_clock, cinternal, cexternal,
+      crate_num, crate_denom);
+
+  *srender_start = clock_convert_external (render_start, cinternal, cexternal,
+      crate_num, crate_denom);
+  *srender_stop = clock_convert_external (render_stop, cinternal, cexternal,
+      crate_num, crate_denom);
+}
+
 /* apply the clock offset but do no slaving otherwise */
 static void
 gst_audio_base_sink_none_slaving (GstAudioBaseSink * sink,
@@ -1571,6 +1666,10 @@ gst_audio_base_sink_handle_slaving (GstAudioBaseSink * sink,
       gst_audio_base_sink_custom_slaving (sink, render_start, render_stop,
           srender_start, srender_stop);
       break;
+    case GST_AUDIO_BASE_SINK_SLAVE_PI:
+      gst_audio_base_sink_pi_slaving (sink, render_start, render_stop,
+          srender_start, srender_stop);
+      break;
     default:
       g_warning ("unknown slaving method %d", sink->priv->slave_method);
       break;
@@ -1689,6 +1788,7 @@ gst_audio_base_sink_sync_latency (GstBaseSink * bsink, GstMiniObject * obj)
     case GST_AUDIO_BASE_SINK_SLAVE_SKEW:
     case GST_AUDIO_BASE_SINK_SLAVE_NONE:
     case GST_AUDIO_BASE_SINK_SLAVE_CUSTOM:
+    case GST_AUDIO_BASE_SINK_SLAVE_PI:
     default:
       break;
   }
@@ -2119,7 +2219,8 @@ gst_audio_base_sink_render (GstBaseSink * bsink, GstBuffer * buf)
 
   /* only align stop if we are not slaved to resample */
   if (G_UNLIKELY (slaved
-          && sink->priv->slave_method == GST_AUDIO_BASE_SINK_SLAVE_RESAMPLE)) {
+          && (sink->priv->slave_method == GST_AUDIO_BASE_SINK_SLAVE_RESAMPLE
+              || sink->priv->slave_method == GST_AUDIO_BASE_SINK_SLAVE_PI))) {
     GST_DEBUG_OBJECT (sink, "no stop time align needed: we are slaved");
     goto no_align;
   }
@@ -87,6 +87,8 @@ G_BEGIN_DECLS
  * drifts too much.
  * @GST_AUDIO_BASE_SINK_SLAVE_NONE: No adjustment is done.
  * @GST_AUDIO_BASE_SINK_SLAVE_CUSTOM: Use custom clock slaving algorithm (Since: 1.6)
+ * @GST_AUDIO_BASE_SINK_SLAVE_PI: Resample with a rate that is continuously
+ * adjusted by a PI controller on the clock skew (Since: 1.22)
  *
  * Different possible clock slaving algorithms used when the internal audio
  * clock is not selected as the pipeline master clock.
@@ -96,7 +98,8 @@ typedef enum
   GST_AUDIO_BASE_SINK_SLAVE_RESAMPLE,
   GST_AUDIO_BASE_SINK_SLAVE_SKEW,
   GST_AUDIO_BASE_SINK_SLAVE_NONE,
-  GST_AUDIO_BASE_SINK_SLAVE_CUSTOM
+  GST_AUDIO_BASE_SINK_SLAVE_CUSTOM,
+  GST_AUDIO_BASE_SINK_SLAVE_PI
 } GstAudioBaseSinkSlaveMethod;
 
 typedef struct _GstAudioBaseSink GstAudioBaseSink;
@@ -117,6 +117,24 @@
  *      PLC, it should also accept NULL data in @handle_frame and provide for
  *      data for indicated duration.
  *
+ * ## Parallel decoding
+ *
+ * Subclasses whose frames can be decoded independently, possibly after
+ * priming a fresh decoder state with a few preceding frames, can implement
+ * @create_worker, @decode_frames and @free_worker. If
+ * #GstAudioDecoder:decode-threads is not 1, the base class then collects
+ * frames into batches instead of passing them to @handle_frame, and decodes
+ * the batches on a pool of threads. The decoded buffers are finished in input
+ * order as if the subclass had called gst_audio_decoder_finish_frame() for
+ * every frame. Whenever @create_worker returns %NULL, all pending batches are
+ * finished and frames are passed to @handle_frame again.
+ *
+ * Batching delays the output by up to a full batch of frames while decoding,
+ * so the latency reported by the base class is increased accordingly as soon
+ * as the duration of the decoded frames is known. Output buffers of
+ * @decode_frames that are flagged with %GST_BUFFER_FLAG_CORRUPTED count as
+ * decoding errors like GST_AUDIO_DECODER_ERROR() does.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -143,7 +161,8 @@ enum
   PROP_LATENCY,
   PROP_TOLERANCE,
   PROP_PLC,
-  PROP_MAX_ERRORS
+  PROP_MAX_ERRORS,
+  PROP_DECODE_THREADS
 };
 
 #define DEFAULT_LATENCY    0
@@ -152,6 +171,10 @@ enum
 #define DEFAULT_DRAINABLE  TRUE
 #define DEFAULT_NEEDS_FORMAT  FALSE
 #define DEFAULT_MAX_ERRORS GST_AUDIO_DECODER_MAX_ERRORS
+#define DEFAULT_DECODE_THREADS 1
+
+/* number of frames decoded together by a worker */
+#define BATCH_FRAMES 32
 
 typedef struct _GstAudioDecoderContext
 {
@@ -185,6 +208,18 @@ typedef struct _GstAudioDecoderContext
   GstAllocationParams params;
 } GstAudioDecoderContext;
 
+typedef struct _GstAudioDecoderBatch
+{
+  gpointer worker;
+  /* preroll frames followed by the frames to decode */
+  GstBufferList *frames;
+  guint preroll;
+  GstBufferList *output;
+  GstFlowReturn ret;
+  /* with batch_lock */
+  gboolean done;
+} GstAudioDecoderBatch;
+
 struct _GstAudioDecoderPrivate
 {
   /* activation status */
@@ -272,6 +307,22 @@ struct _GstAudioDecoderPrivate
 
   /* flags */
   gboolean use_default_pad_acceptcaps;
+
+  /* parallel decoding */
+  guint decode_threads;         /* with LOCK */
+  GThreadPool *pool;
+  /* protects the done flag of the batches */
+  GMutex batch_lock;
+  GCond batch_cond;
+  /* submitted batches in decoding order */
+  GQueue batches;
+  /* batch that is still collecting frames */
+  GstAudioDecoderBatch *batch;
+  /* most recent frames, to prime the worker of the next batch */
+  GQueue history;
+  guint preroll;
+  /* duration of the last decoded frame, for the batching latency */
+  GstClockTime batch_frame_duration;    /* with LOCK */
 };
 
 /* cached quark to avoid contention on the global quark table lock */
@@ -327,6 +378,9 @@ static gboolean gst_audio_decoder_transform_meta_default (GstAudioDecoder *
 static GstFlowReturn
 gst_audio_decoder_finish_frame_or_subframe (GstAudioDecoder * dec,
     GstBuffer * buf, gint frames);
+static GstFlowReturn gst_audio_decoder_finish_batches (GstAudioDecoder * dec,
+    gboolean wait);
+static void gst_audio_decoder_discard_batches (GstAudioDecoder * dec);
 
 static GstElementClass *parent_class = NULL;
 static gint private_offset = 0;
@@ -429,6 +483,28 @@ gst_audio_decoder_class_init (GstAudioDecoderClass * klass)
           -1, G_MAXINT, DEFAULT_MAX_ERRORS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioDecoder:decode-threads:
+   *
+   * Number of threads used to decode batches of frames in parallel, 0 uses
+   * one thread per processor and 1 disables parallel decoding. This only has
+   * an effect if the subclass implements
+   * #GstAudioDecoderClass.create_worker() and
+   * #GstAudioDecoderClass.decode_frames().
+   *
+   * Parallel decoding adds the duration of one batch of frames to the
+   * minimum latency, and of all batches that can be pending to the maximum
+   * latency.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_DECODE_THREADS,
+      g_param_spec_uint ("decode-threads", "Decode threads",
+          "Number of threads for decoding frames in parallel "
+          "(0 = number of processors, 1 = no parallel decoding)",
+          0, G_MAXINT, DEFAULT_DECODE_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   audiodecoder_class->sink_event =
       GST_DEBUG_FUNCPTR (gst_audio_decoder_sink_eventfunc);
   audiodecoder_class->src_event =
@@ -489,6 +565,10 @@ gst_audio_decoder_init (GstAudioDecoder * dec, GstAudioDecoderClass * klass)
   dec->priv->adapter = gst_adapter_new ();
   dec->priv->adapter_out = gst_adapter_new ();
   g_queue_init (&dec->priv->frames);
+  g_queue_init (&dec->priv->batches);
+  g_queue_init (&dec->priv->history);
+  g_mutex_init (&dec->priv->batch_lock);
+  g_cond_init (&dec->priv->batch_cond);
 
   g_rec_mutex_init (&dec->stream_lock);
 
@@ -499,6 +579,8 @@ gst_audio_decoder_init (GstAudioDecoder * dec, GstAudioDecoderClass * klass)
   dec->priv->drainable = DEFAULT_DRAINABLE;
   dec->priv->needs_format = DEFAULT_NEEDS_FORMAT;
   dec->priv->max_errors = GST_AUDIO_DECODER_MAX_ERRORS;
+  dec->priv->decode_threads = DEFAULT_DECODE_THREADS;
+  dec->priv->batch_frame_duration = GST_CLOCK_TIME_NONE;
 
   /* init state */
   dec->priv->ctx.min_latency = 0;
@@ -514,11 +596,18 @@ gst_audio_decoder_reset (GstAudioDecoder * dec, gboolean full)
 
   GST_AUDIO_DECODER_STREAM_LOCK (dec);
 
+  gst_audio_decoder_discard_batches (dec);
+
   if (full) {
     dec->priv->active = FALSE;
+    if (dec->priv->pool) {
+      g_thread_pool_free (dec->priv->pool, FALSE, TRUE);
+      dec->priv->pool = NULL;
+    }
     GST_OBJECT_LOCK (dec);
     dec->priv->bytes_in = 0;
     dec->priv->samples_out = 0;
+    dec->priv->batch_frame_duration = GST_CLOCK_TIME_NONE;
     GST_OBJECT_UNLOCK (dec);
     dec->priv->agg = -1;
     dec->priv->error_count = 0;
@@ -591,7 +680,12 @@ gst_audio_decoder_finalize (GObject * object)
   if (dec->priv->adapter_out) {
     g_object_unref (dec->priv->adapter_out);
   }
+  if (dec->priv->pool) {
+    g_thread_pool_free (dec->priv->pool, FALSE, TRUE);
+  }
 
+  g_mutex_clear (&dec->priv->batch_lock);
+  g_cond_clear (&dec->priv->batch_cond);
   g_rec_mutex_clear (&dec->stream_lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -1594,6 +1688,289 @@ subframe_without_pending_input_frame:
   }
 }
 
+static void
+gst_audio_decoder_batch_free (GstAudioDecoder * dec,
+    GstAudioDecoderBatch * batch)
+{
+  GstAudioDecoderClass *klass = GST_AUDIO_DECODER_GET_CLASS (dec);
+
+  if (batch->worker && klass->free_worker)
+    klass->free_worker (dec, batch->worker);
+  gst_buffer_list_unref (batch->frames);
+  gst_buffer_list_unref (batch->output);
+  g_free (batch);
+}
+
+static void
+gst_audio_decoder_batch_func (GstAudioDecoderBatch * batch,
+    GstAudioDecoder * dec)
+{
+  GstAudioDecoderClass *klass = GST_AUDIO_DECODER_GET_CLASS (dec);
+
+  batch->ret = klass->decode_frames (dec, batch->worker, batch->frames,
+      batch->preroll, batch->output);
+  if (klass->free_worker)
+    klass->free_worker (dec, batch->worker);
+  batch->worker = NULL;
+
+  g_mutex_lock (&dec->priv->batch_lock);
+  batch->done = TRUE;
+  g_cond_broadcast (&dec->priv->batch_cond);
+  g_mutex_unlock (&dec->priv->batch_lock);
+}
+
+static guint
+gst_audio_decoder_get_decode_threads (GstAudioDecoder * dec)
+{
+  guint threads;
+
+  GST_OBJECT_LOCK (dec);
+  threads = dec->priv->decode_threads;
+  GST_OBJECT_UNLOCK (dec);
+
+  return threads == 0 ? g_get_num_processors () : threads;
+}
+
+static void
+gst_audio_decoder_submit_batch (GstAudioDecoder * dec)
+{
+  GstAudioDecoderPrivate *priv = dec->priv;
+  GstAudioDecoderBatch *batch = priv->batch;
+  GError *err = NULL;
+
+  priv->batch = NULL;
+  g_queue_push_tail (&priv->batches, batch);
+
+  GST_LOG_OBJECT (dec, "submitting batch of %u frames, %u preroll",
+      gst_buffer_list_length (batch->frames) - batch->preroll, batch->preroll);
+
+  if (priv->pool == NULL) {
+    priv->pool = g_thread_pool_new ((GFunc) gst_audio_decoder_batch_func, dec,
+        gst_audio_decoder_get_decode_threads (dec), FALSE, &err);
+    if (priv->pool == NULL) {
+      GST_WARNING_OBJECT (dec, "failed to create thread pool: %s",
+          err->message);
+      g_clear_error (&err);
+    }
+  }
+
+  if (priv->pool == NULL || !g_thread_pool_push (priv->pool, batch, NULL))
+    gst_audio_decoder_batch_func (batch, dec);
+}
+
+/* drops @frames frames that will not be finished from the frame queue */
+static void
+gst_audio_decoder_drop_frames (GstAudioDecoder * dec, guint frames)
+{
+  while (frames-- && dec->priv->frames.length)
+    gst_buffer_unref (g_queue_pop_head (&dec->priv->frames));
+  dec->priv->ctx.delay = dec->priv->frames.length;
+}
+
+/* updates the batching latency from the duration of a decoded frame */
+static void
+gst_audio_decoder_update_batch_latency (GstAudioDecoder * dec, GstBuffer * buf)
+{
+  GstAudioInfo *info = &dec->priv->ctx.info;
+  GstClockTime duration;
+  gboolean changed;
+
+  if (info->bpf == 0 || info->rate == 0)
+    return;
+
+  duration = gst_util_uint64_scale_int (gst_buffer_get_size (buf) / info->bpf,
+      GST_SECOND, info->rate);
+
+  GST_OBJECT_LOCK (dec);
+  changed = dec->priv->batch_frame_duration != duration;
+  dec->priv->batch_frame_duration = duration;
+  GST_OBJECT_UNLOCK (dec);
+
+  if (changed) {
+    GST_DEBUG_OBJECT (dec, "batching frames of %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (duration));
+    gst_element_post_message (GST_ELEMENT (dec),
+        gst_message_new_latency (GST_OBJECT (dec)));
+  }
+}
+
+static GstFlowReturn
+gst_audio_decoder_output_batch (GstAudioDecoder * dec,
+    GstAudioDecoderBatch * batch)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  gboolean have_duration = FALSE;
+  guint i, n;
+
+  n = gst_buffer_list_length (batch->frames) - batch->preroll;
+
+  if (batch->ret != GST_FLOW_OK || gst_buffer_list_length (batch->output) != n) {
+    GST_AUDIO_DECODER_ERROR (dec, 1, STREAM, DECODE, (NULL),
+        ("Failed to decode batch of %u frames: %s", n,
+            gst_flow_get_name (batch->ret)), ret);
+    if (ret == GST_FLOW_OK)
+      ret = gst_audio_decoder_finish_frame (dec, NULL, n);
+    else
+      gst_audio_decoder_drop_frames (dec, n);
+    return ret;
+  }
+
+  for (i = 0; i < n; i++) {
+    GstBuffer *buf = gst_buffer_list_get (batch->output, i);
+
+    if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_CORRUPTED)) {
+      GST_AUDIO_DECODER_ERROR (dec, 1, STREAM, DECODE, (NULL),
+          ("Failed to decode frame %u of batch", i), ret);
+      if (ret != GST_FLOW_OK) {
+        gst_audio_decoder_drop_frames (dec, n - i);
+        break;
+      }
+      buf = NULL;
+    } else if (gst_buffer_get_size (buf) > 0) {
+      if (!have_duration) {
+        gst_audio_decoder_update_batch_latency (dec, buf);
+        have_duration = TRUE;
+      }
+      buf = gst_buffer_ref (buf);
+    } else {
+      buf = NULL;
+    }
+
+    ret = gst_audio_decoder_finish_frame (dec, buf, 1);
+    if (ret != GST_FLOW_OK) {
+      GST_DEBUG_OBJECT (dec, "flow %s, dropping rest of batch",
+          gst_flow_get_name (ret));
+      gst_audio_decoder_drop_frames (dec, n - i - 1);
+      break;
+    }
+  }
+
+  return ret;
+}
+
+/* Finishes the frames of all decoded batches at the head of the queue. If
+ * @wait, the batch still collecting frames is submitted and all batches are
+ * waited for, otherwise this only blocks if too many batches are pending. */
+static GstFlowReturn
+gst_audio_decoder_finish_batches (GstAudioDecoder * dec, gboolean wait)
+{
+  GstAudioDecoderPrivate *priv = dec->priv;
+  GstAudioDecoderBatch *batch;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint max_pending = 2 * gst_audio_decoder_get_decode_threads (dec);
+
+  if (wait && priv->batch)
+    gst_audio_decoder_submit_batch (dec);
+
+  while ((batch = g_queue_peek_head (&priv->batches))) {
+    g_mutex_lock (&priv->batch_lock);
+    if (!batch->done && !wait && priv->batches.length < max_pending) {
+      g_mutex_unlock (&priv->batch_lock);
+      break;
+    }
+    while (!batch->done)
+      g_cond_wait (&priv->batch_cond, &priv->batch_lock);
+    g_mutex_unlock (&priv->batch_lock);
+
+    g_queue_pop_head (&priv->batches);
+    if (ret == GST_FLOW_OK) {
+      ret = gst_audio_decoder_output_batch (dec, batch);
+    } else {
+      gst_audio_decoder_drop_frames (dec,
+          gst_buffer_list_length (batch->frames) - batch->preroll);
+    }
+    gst_audio_decoder_batch_free (dec, batch);
+  }
+
+  return ret;
+}
+
+/* waits for all submitted batches and drops them without output, the frame
+ * queue is cleared by the caller */
+static void
+gst_audio_decoder_discard_batches (GstAudioDecoder * dec)
+{
+  GstAudioDecoderPrivate *priv = dec->priv;
+  GstAudioDecoderBatch *batch;
+
+  if (priv->batch) {
+    gst_audio_decoder_batch_free (dec, priv->batch);
+    priv->batch = NULL;
+  }
+
+  while ((batch = g_queue_pop_head (&priv->batches))) {
+    g_mutex_lock (&priv->batch_lock);
+    while (!batch->done)
+      g_cond_wait (&priv->batch_cond, &priv->batch_lock);
+    g_mutex_unlock (&priv->batch_lock);
+    gst_audio_decoder_batch_free (dec, batch);
+  }
+
+  g_queue_foreach (&priv->history, (GFunc) gst_buffer_unref, NULL);
+  g_queue_clear (&priv->history);
+}
+
+/* adds @buffer to a batch for parallel decoding, returns FALSE if the frame
+ * has to be passed to handle_frame instead */
+static gboolean
+gst_audio_decoder_batch_frame (GstAudioDecoder * dec,
+    GstAudioDecoderClass * klass, GstBuffer * buffer, GstFlowReturn * ret)
+{
+  GstAudioDecoderPrivate *priv = dec->priv;
+  GstAudioDecoderBatch *batch;
+  GList *l;
+
+  if (dec->input_segment.rate < 0.0)
+    return FALSE;
+
+  GST_OBJECT_LOCK (dec);
+  if (priv->decode_threads == 1) {
+    GST_OBJECT_UNLOCK (dec);
+    return FALSE;
+  }
+  GST_OBJECT_UNLOCK (dec);
+
+  if (priv->batch == NULL) {
+    guint preroll = 0;
+    gpointer worker;
+
+    worker = klass->create_worker (dec, &preroll);
+    if (worker == NULL) {
+      GST_LOG_OBJECT (dec, "subclass can't decode in parallel");
+      /* the next batch can't be primed with frames decoded serially */
+      g_queue_foreach (&priv->history, (GFunc) gst_buffer_unref, NULL);
+      g_queue_clear (&priv->history);
+      return FALSE;
+    }
+
+    batch = g_new0 (GstAudioDecoderBatch, 1);
+    batch->worker = worker;
+    batch->preroll = MIN (preroll, priv->history.length);
+    batch->frames = gst_buffer_list_new_sized (batch->preroll + BATCH_FRAMES);
+    batch->output = gst_buffer_list_new_sized (BATCH_FRAMES);
+    l = g_queue_peek_nth_link (&priv->history,
+        priv->history.length - batch->preroll);
+    for (; l; l = l->next)
+      gst_buffer_list_add (batch->frames, gst_buffer_ref (l->data));
+    priv->preroll = preroll;
+    priv->batch = batch;
+  }
+  batch = priv->batch;
+
+  gst_buffer_list_add (batch->frames, gst_buffer_ref (buffer));
+
+  g_queue_push_tail (&priv->history, gst_buffer_ref (buffer));
+  while (priv->history.length > priv->preroll)
+    gst_buffer_unref (g_queue_pop_head (&priv->history));
+
+  if (gst_buffer_list_length (batch->frames) - batch->preroll >= BATCH_FRAMES)
+    gst_audio_decoder_submit_batch (dec);
+
+  *ret = gst_audio_decoder_finish_batches (dec, FALSE);
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_audio_decoder_handle_frame (GstAudioDecoder * dec,
     GstAudioDecoderClass * klass, GstBuffer * buffer)
@@ -1634,6 +2011,21 @@ gst_audio_decoder_handle_frame (GstAudioDecoder * dec,
     GST_LOG_OBJECT (dec, "providing subclass with NULL frame");
   }
 
+  if (buffer && klass->create_worker && klass->decode_frames) {
+    GstFlowReturn ret;
+
+    if (gst_audio_decoder_batch_frame (dec, klass, buffer, &ret))
+      return ret;
+  }
+
+  /* the subclass can only continue after all batched frames */
+  if (dec->priv->batch || dec->priv->batches.length) {
+    GstFlowReturn ret = gst_audio_decoder_finish_batches (dec, TRUE);
+
+    if (ret != GST_FLOW_OK)
+      return ret;
+  }
+
   return klass->handle_frame (dec, buffer);
 }
 
@@ -1778,12 +2170,20 @@ gst_audio_decoder_drain (GstAudioDecoder * dec)
     GST_WARNING_OBJECT (dec, "audio decoder push buffers failed");
     goto drain_failed;
   }
+  /* and output all frames that were decoded in parallel */
+  ret = gst_audio_decoder_finish_batches (dec, TRUE);
+  if (ret != GST_FLOW_OK) {
+    GST_WARNING_OBJECT (dec, "audio decoder parallel decoding failed");
+    goto drain_failed;
+  }
   /* ensure all output sent */
   ret = gst_audio_decoder_output (dec, NULL);
   if (ret != GST_FLOW_OK)
     GST_WARNING_OBJECT (dec, "audio decoder output failed");
 
 drain_failed:
+  gst_audio_decoder_discard_batches (dec);
+
   /* everything should be away now */
   if (dec->priv->frames.length) {
     /* not fatal/impossible though if subclass/codec eats stuff */
@@ -2339,6 +2739,16 @@ gst_audio_decoder_sink_eventfunc (GstAudioDecoder * dec, GstEvent * event)
 {
   gboolean ret;
 
+  /* serialized events have to go after the frames that are being decoded in
+   * parallel */
+  if (GST_EVENT_IS_SERIALIZED (event)
+      && GST_EVENT_TYPE (event) != GST_EVENT_FLUSH_STOP) {
+    GST_AUDIO_DECODER_STREAM_LOCK (dec);
+    if (dec->priv->batch || dec->priv->batches.length)
+      gst_audio_decoder_finish_batches (dec, TRUE);
+    GST_AUDIO_DECODER_STREAM_UNLOCK (dec);
+  }
+
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_STREAM_START:
       GST_AUDIO_DECODER_STREAM_LOCK (dec);
@@ -3039,6 +3449,22 @@ gst_audio_decoder_src_query_default (GstAudioDecoder * dec, GstQuery * query)
           max_latency = -1;
         else
           max_latency += dec->priv->ctx.max_latency;
+
+        /* a frame waits for its batch to fill up, and for all batches that
+         * are pending in front of it */
+        if (dec->priv->decode_threads != 1
+            && GST_CLOCK_TIME_IS_VALID (dec->priv->batch_frame_duration)) {
+          GstClockTime batch_latency =
+              BATCH_FRAMES * dec->priv->batch_frame_duration;
+          guint threads = dec->priv->decode_threads;
+
+          if (threads == 0)
+            threads = g_get_num_processors ();
+
+          min_latency += batch_latency;
+          if (max_latency != -1)
+            max_latency += (2 * threads + 1) * batch_latency;
+        }
         GST_OBJECT_UNLOCK (dec);
 
         gst_query_set_latency (query, live, min_latency, max_latency);
@@ -3081,6 +3507,11 @@ gst_audio_decoder_stop (GstAudioDecoder * dec)
 
   klass = GST_AUDIO_DECODER_GET_CLASS (dec);
 
+  /* the subclass may free what the workers use */
+  GST_AUDIO_DECODER_STREAM_LOCK (dec);
+  gst_audio_decoder_discard_batches (dec);
+  GST_AUDIO_DECODER_STREAM_UNLOCK (dec);
+
   if (klass->stop) {
     ret = klass->stop (dec);
   }
@@ -3138,6 +3569,11 @@ gst_audio_decoder_get_property (GObject * object, guint prop_id,
     case PROP_MAX_ERRORS:
       g_value_set_int (value, gst_audio_decoder_get_max_errors (dec));
       break;
+    case PROP_DECODE_THREADS:
+      GST_OBJECT_LOCK (dec);
+      g_value_set_uint (value, dec->priv->decode_threads);
+      GST_OBJECT_UNLOCK (dec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3165,6 +3601,11 @@ gst_audio_decoder_set_property (GObject * object, guint prop_id,
     case PROP_MAX_ERRORS:
       gst_audio_decoder_set_max_errors (dec, g_value_get_int (value));
       break;
+    case PROP_DECODE_THREADS:
+      GST_OBJECT_LOCK (dec);
+      dec->priv->decode_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (dec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -253,6 +253,24 @@ struct _GstAudioDecoder
  *                  tags and meta with only the "audio" tag. subclasses can
  *                  implement this method and return %TRUE if the metadata is to be
  *                  copied. Since: 1.6
+ * @create_worker: Optional. Called from the streaming thread to create the
+ *                  state for decoding a batch of frames independently of the
+ *                  decoder, or %NULL if the current frames can't be decoded
+ *                  that way. @preroll can be set to the number of preceding
+ *                  frames that need to be decoded to prime a new decoder state.
+ *                  Together with @decode_frames this enables parallel
+ *                  decoding with #GstAudioDecoder:decode-threads. Since: 1.22
+ * @decode_frames: Optional. Called from a worker thread to decode @frames with
+ *                  the state created by @create_worker. The first @preroll
+ *                  frames only prime the state and produce no output. For every
+ *                  other frame exactly one buffer, which may be empty, has to
+ *                  be added to @output. Frames that failed to decode are
+ *                  marked by flagging their buffer with
+ *                  %GST_BUFFER_FLAG_CORRUPTED and are counted as decoding
+ *                  errors by the base class. This must not call any
+ *                  #GstAudioDecoder API. Since: 1.22
+ * @free_worker: Optional. Called from a worker thread to free the state
+ *                  created by @create_worker. Since: 1.22
  *
  * Subclasses can override any of the available virtual methods or not, as
  * needed. At minimum @handle_frame (and likely @set_format) needs to be
@@ -315,8 +333,32 @@ struct _GstAudioDecoderClass
   gboolean      (*transform_meta)     (GstAudioDecoder *enc, GstBuffer *outbuf,
                                        GstMeta *meta, GstBuffer *inbuf);
 
+  /**
+   * GstAudioDecoderClass::create_worker:
+   * @preroll: (out):
+   *
+   * Since: 1.22
+   */
+  gpointer      (*create_worker)      (GstAudioDecoder *dec, guint *preroll);
+
+  /**
+   * GstAudioDecoderClass::decode_frames:
+   *
+   * Since: 1.22
+   */
+  GstFlowReturn (*decode_frames)      (GstAudioDecoder *dec, gpointer worker,
+                                       GstBufferList *frames, guint preroll,
+                                       GstBufferList *output);
+
+  /**
+   * GstAudioDecoderClass::free_worker:
+   *
+   * Since: 1.22
+   */
+  void          (*free_worker)        (GstAudioDecoder *dec, gpointer worker);
+
   /*< private >*/
-  gpointer       _gst_reserved[GST_PADDING_LARGE - 4];
+  gpointer       _gst_reserved[GST_PADDING_LARGE - 7];
 };
 
 GST_AUDIO_API
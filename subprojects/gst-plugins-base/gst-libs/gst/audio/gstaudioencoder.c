@@ -228,6 +228,12 @@ struct _GstAudioEncoderPrivate
   gboolean granule;
   gboolean hard_min;
   gboolean drainable;
+  gboolean output_buffer_list;
+
+  /* buffers collected while handing data to the subclass, and the first
+   * error that occurred when pushing them */
+  GstBufferList *output_list;
+  GstFlowReturn output_list_ret;
 
   /* upstream stream tags (global tags are passed through as-is) */
   GstTagList *upstream_tags;
@@ -583,9 +589,49 @@ close_failed:
   }
 }
 
+/* pushes the buffers that were collected so far */
+static GstFlowReturn
+gst_audio_encoder_push_output_list (GstAudioEncoder * enc)
+{
+  GstAudioEncoderPrivate *priv = enc->priv;
+  GstBufferList *list = priv->output_list;
+  GstFlowReturn ret;
+
+  if (list == NULL || gst_buffer_list_length (list) == 0)
+    return priv->output_list_ret;
+
+  GST_LOG_OBJECT (enc, "pushing list of %u buffers",
+      gst_buffer_list_length (list));
+
+  priv->output_list = gst_buffer_list_new ();
+  ret = gst_pad_push_list (enc->srcpad, list);
+  if (priv->output_list_ret == GST_FLOW_OK)
+    priv->output_list_ret = ret;
+
+  return priv->output_list_ret;
+}
+
+/* pushes @buf or adds it to the output list if one is being collected */
+static GstFlowReturn
+gst_audio_encoder_push_buffer (GstAudioEncoder * enc, GstBuffer * buf)
+{
+  GstAudioEncoderPrivate *priv = enc->priv;
+
+  if (priv->output_list) {
+    gst_buffer_list_add (priv->output_list, buf);
+    return priv->output_list_ret;
+  }
+
+  return gst_pad_push (enc->srcpad, buf);
+}
+
 static gboolean
 gst_audio_encoder_push_event (GstAudioEncoder * enc, GstEvent * event)
 {
+  /* keep serialized events after the buffers that were encoded before */
+  if (GST_EVENT_IS_SERIALIZED (event) && enc->priv->output_list)
+    gst_audio_encoder_push_output_list (enc);
+
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_SEGMENT:{
       GstSegment seg;
@@ -808,6 +854,9 @@ gst_audio_encoder_finish_frame (GstAudioEncoder * enc, GstBuffer * buf,
 
   needs_reconfigure = gst_pad_check_reconfigure (enc->srcpad);
   if (G_UNLIKELY (ctx->output_caps_changed || needs_reconfigure)) {
+    /* buffers encoded so far have to go out with the previous caps */
+    if (priv->output_list)
+      gst_audio_encoder_push_output_list (enc);
     if (!gst_audio_encoder_negotiate_unlocked (enc)) {
       gst_pad_mark_reconfigure (enc->srcpad);
       if (GST_PAD_IS_FLUSHING (enc->srcpad))
@@ -946,7 +995,7 @@ gst_audio_encoder_finish_frame (GstAudioEncoder * enc, GstBuffer * buf,
         priv->bytes_out += size;
         GST_OBJECT_UNLOCK (enc);
 
-        ret = gst_pad_push (enc->srcpad, tmpbuf);
+        ret = gst_audio_encoder_push_buffer (enc, tmpbuf);
         if (ret != GST_FLOW_OK) {
           GST_WARNING_OBJECT (enc, "pushing header returned %s",
               gst_flow_get_name (ret));
@@ -1040,7 +1089,7 @@ gst_audio_encoder_finish_frame (GstAudioEncoder * enc, GstBuffer * buf,
         GST_TIME_ARGS (GST_BUFFER_PTS (buf)),
         GST_TIME_ARGS (GST_BUFFER_DURATION (buf)));
 
-    ret = gst_pad_push (enc->srcpad, buf);
+    ret = gst_audio_encoder_push_buffer (enc, buf);
     GST_LOG_OBJECT (enc, "buffer pushed: %s", gst_flow_get_name (ret));
 
     /* Now push the events that followed after the buffer got into the
@@ -1095,6 +1144,7 @@ gst_audio_encoder_push_buffers (GstAudioEncoder * enc, gboolean force)
   gint av, need;
   GstBuffer *buf;
   GstFlowReturn ret = GST_FLOW_OK;
+  gboolean collect;
 
   klass = GST_AUDIO_ENCODER_GET_CLASS (enc);
 
@@ -1103,6 +1153,13 @@ gst_audio_encoder_push_buffers (GstAudioEncoder * enc, gboolean force)
   priv = enc->priv;
   ctx = &enc->priv->ctx;
 
+  /* collect the output of this round to push it as one list */
+  collect = priv->output_buffer_list && priv->output_list == NULL;
+  if (collect) {
+    priv->output_list = gst_buffer_list_new ();
+    priv->output_list_ret = GST_FLOW_OK;
+  }
+
   while (ret == GST_FLOW_OK) {
 
     buf = NULL;
@@ -1189,6 +1246,15 @@ gst_audio_encoder_push_buffers (GstAudioEncoder * enc, gboolean force)
     }
   }
 
+  if (collect) {
+    GstFlowReturn list_ret = gst_audio_encoder_push_output_list (enc);
+
+    gst_buffer_list_unref (priv->output_list);
+    priv->output_list = NULL;
+    if (ret == GST_FLOW_OK)
+      ret = list_ret;
+  }
+
   return ret;
 }
 
@@ -2707,6 +2773,58 @@ gst_audio_encoder_get_drainable (GstAudioEncoder * enc)
   return result;
 }
 
+/**
+ * gst_audio_encoder_set_output_buffer_list:
+ * @enc: a #GstAudioEncoder
+ * @enabled: new state
+ *
+ * Configures whether the encoded buffers are pushed downstream one by one
+ * or collected and pushed as one #GstBufferList per input buffer. The
+ * latter reduces the per-buffer overhead downstream for encoders that
+ * produce many small packets from each input buffer, see
+ * gst_audio_encoder_set_frame_max().
+ *
+ * MT safe.
+ *
+ * Since: 1.22
+ */
+void
+gst_audio_encoder_set_output_buffer_list (GstAudioEncoder * enc,
+    gboolean enabled)
+{
+  g_return_if_fail (GST_IS_AUDIO_ENCODER (enc));
+
+  GST_OBJECT_LOCK (enc);
+  enc->priv->output_buffer_list = enabled;
+  GST_OBJECT_UNLOCK (enc);
+}
+
+/**
+ * gst_audio_encoder_get_output_buffer_list:
+ * @enc: a #GstAudioEncoder
+ *
+ * Queries whether encoded buffers are pushed downstream as buffer lists.
+ *
+ * Returns: TRUE if encoded buffers are pushed as buffer lists.
+ *
+ * MT safe.
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_audio_encoder_get_output_buffer_list (GstAudioEncoder * enc)
+{
+  gboolean result;
+
+  g_return_val_if_fail (GST_IS_AUDIO_ENCODER (enc), FALSE);
+
+  GST_OBJECT_LOCK (enc);
+  result = enc->priv->output_buffer_list;
+  GST_OBJECT_UNLOCK (enc);
+
+  return result;
+}
+
 /**
  * gst_audio_encoder_merge_tags:
  * @enc: a #GstAudioEncoder
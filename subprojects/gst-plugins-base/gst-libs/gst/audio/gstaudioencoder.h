@@ -362,6 +362,13 @@ void            gst_audio_encoder_set_drainable (GstAudioEncoder * enc,
 GST_AUDIO_API
 gboolean        gst_audio_encoder_get_drainable (GstAudioEncoder * enc);
 
+GST_AUDIO_API
+void            gst_audio_encoder_set_output_buffer_list (GstAudioEncoder * enc,
+                                                          gboolean enabled);
+
+GST_AUDIO_API
+gboolean        gst_audio_encoder_get_output_buffer_list (GstAudioEncoder * enc);
+
 GST_AUDIO_API
 void            gst_audio_encoder_get_allocator (GstAudioEncoder * enc,
                                                  GstAllocator ** allocator,
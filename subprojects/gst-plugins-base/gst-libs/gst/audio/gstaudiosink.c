@@ -47,6 +47,12 @@
  * All scheduling of samples and timestamps is done in this base class
  * together with #GstAudioBaseSink using a default implementation of a
  * #GstAudioRingBuffer that uses threads.
+ *
+ * By default a complete ringbuffer segment is written to the device at a
+ * time. The #GstAudioSink:write-time property makes the ringbuffer thread
+ * write smaller chunks instead so that the device is kept filled at a finer
+ * granularity than the segment size. The delay reported by the device is then
+ * corrected for the part of the current segment that was already written.
  */
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -90,6 +96,8 @@ struct _GstAudioSinkRingBuffer
 
   gboolean running;
   gint queuedseg;
+  /* bytes of the current segment already written to the device */
+  gint partial;
 
   GCond cond;
 };
@@ -108,6 +116,17 @@ static void gst_audio_sink_ring_buffer_finalize (GObject * object);
 
 static GstAudioRingBufferClass *ring_parent_class = NULL;
 
+struct _GstAudioSinkPrivate
+{
+  /* maximum write size in microseconds, 0 for complete segments */
+  guint64 write_time;
+};
+
+typedef struct _GstAudioSinkPrivate GstAudioSinkPrivate;
+
+static GstAudioSinkPrivate *gst_audio_sink_get_instance_private (GstAudioSink *
+    self);
+
 static gboolean gst_audio_sink_ring_buffer_open_device (GstAudioRingBuffer *
     buf);
 static gboolean gst_audio_sink_ring_buffer_close_device (GstAudioRingBuffer *
@@ -191,6 +210,31 @@ gst_audio_sink_ring_buffer_class_init (GstAudioSinkRingBufferClass * klass)
 
 typedef gint (*WriteFunc) (GstAudioSink * sink, gpointer data, guint length);
 
+/* number of bytes to write to the device at once for a segment of @len
+ * bytes, always a multiple of the frame size */
+static gint
+gst_audio_sink_get_write_size (GstAudioSink * sink, GstAudioRingBuffer * buf,
+    gint len)
+{
+  GstAudioSinkPrivate *priv = gst_audio_sink_get_instance_private (sink);
+  guint64 write_time;
+  gint bpf, rate, size;
+
+  GST_OBJECT_LOCK (sink);
+  write_time = priv->write_time;
+  GST_OBJECT_UNLOCK (sink);
+
+  bpf = GST_AUDIO_INFO_BPF (&buf->spec.info);
+  rate = GST_AUDIO_INFO_RATE (&buf->spec.info);
+  if (write_time == 0 || bpf == 0 || rate == 0)
+    return len;
+
+  size = gst_util_uint64_scale_int (write_time, rate, G_USEC_PER_SEC) * bpf;
+  size = MAX (size, bpf);
+
+  return MIN (size, len);
+}
+
 /* this internal thread does nothing else but write samples to the audio device.
  * It will write each segment in the ringbuffer and will update the play
  * pointer.
@@ -234,7 +278,7 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
   gst_element_post_message (GST_ELEMENT_CAST (sink), message);
 
   while (TRUE) {
-    gint left, len;
+    gint left, len, chunk;
     guint8 *readptr;
     gint readseg;
 
@@ -242,9 +286,11 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
     if (gst_audio_ring_buffer_prepare_read (buf, &readseg, &readptr, &len)) {
       gint written;
 
+      chunk = gst_audio_sink_get_write_size (sink, buf, len);
+
       left = len;
       do {
-        written = writefunc (sink, readptr, left);
+        written = writefunc (sink, readptr, MIN (left, chunk));
         GST_LOG_OBJECT (sink, "transferred %d bytes of %d from segment %d",
             written, left, readseg);
         if (written < 0 || written > left) {
@@ -260,10 +306,12 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
         }
         left -= written;
         readptr += written;
+        g_atomic_int_add (&abuf->partial, written);
       } while (left > 0);
 
       /* clear written samples */
       gst_audio_ring_buffer_clear (buf, readseg);
+      g_atomic_int_set (&abuf->partial, 0);
 
       /* we wrote one segment */
       gst_audio_ring_buffer_advance (buf, 1);
@@ -323,6 +371,7 @@ gst_audio_sink_ring_buffer_init (GstAudioSinkRingBuffer * ringbuffer,
 {
   ringbuffer->running = FALSE;
   ringbuffer->queuedseg = 0;
+  ringbuffer->partial = 0;
 
   g_cond_init (&ringbuffer->cond);
 }
@@ -608,9 +657,11 @@ gst_audio_sink_ring_buffer_stop (GstAudioRingBuffer * buf)
 static guint
 gst_audio_sink_ring_buffer_delay (GstAudioRingBuffer * buf)
 {
+  GstAudioSinkRingBuffer *abuf = GST_AUDIO_SINK_RING_BUFFER_CAST (buf);
   GstAudioSink *sink;
   GstAudioSinkClass *csink;
-  guint res = 0;
+  guint res = 0, partial;
+  gint bpf;
 
   sink = GST_AUDIO_SINK (GST_OBJECT_PARENT (buf));
   csink = GST_AUDIO_SINK_GET_CLASS (sink);
@@ -618,6 +669,14 @@ gst_audio_sink_ring_buffer_delay (GstAudioRingBuffer * buf)
   if (csink->delay)
     res = csink->delay (sink);
 
+  /* the samples of a partially written segment are counted in the device
+   * delay but the segment is not yet marked as done in the ringbuffer */
+  bpf = GST_AUDIO_INFO_BPF (&buf->spec.info);
+  if (bpf > 0) {
+    partial = g_atomic_int_get (&abuf->partial) / bpf;
+    res = res > partial ? res - partial : 0;
+  }
+
   return res;
 }
 
@@ -635,6 +694,8 @@ gst_audio_sink_ring_buffer_clear_all (GstAudioRingBuffer * buf)
     csink->extension->clear_all (sink);
   }
 
+  g_atomic_int_set (&GST_AUDIO_SINK_RING_BUFFER_CAST (buf)->partial, 0);
+
   /* chain up to the parent implementation */
   ring_parent_class->clear_all (buf);
 }
@@ -646,13 +707,17 @@ enum
   LAST_SIGNAL
 };
 
+#define DEFAULT_WRITE_TIME 0
+
 enum
 {
   ARG_0,
+  ARG_WRITE_TIME,
 };
 
 #define _do_init \
     GST_DEBUG_CATEGORY_INIT (gst_audio_sink_debug, "audiosink", 0, "audiosink element"); \
+    G_ADD_PRIVATE (GstAudioSink); \
     g_type_add_class_private (g_define_type_id, \
         sizeof (GstAudioSinkClassExtension));
 #define gst_audio_sink_parent_class parent_class
@@ -661,14 +726,39 @@ G_DEFINE_TYPE_WITH_CODE (GstAudioSink, gst_audio_sink,
 
 static GstAudioRingBuffer *gst_audio_sink_create_ringbuffer (GstAudioBaseSink *
     sink);
+static void gst_audio_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_audio_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static void
 gst_audio_sink_class_init (GstAudioSinkClass * klass)
 {
+  GObjectClass *gobject_class;
   GstAudioBaseSinkClass *gstaudiobasesink_class;
 
+  gobject_class = (GObjectClass *) klass;
   gstaudiobasesink_class = (GstAudioBaseSinkClass *) klass;
 
+  gobject_class->set_property = gst_audio_sink_set_property;
+  gobject_class->get_property = gst_audio_sink_get_property;
+
+  /**
+   * GstAudioSink:write-time:
+   *
+   * The maximum amount of audio in microseconds that is written to the device
+   * at once. With 0 every ringbuffer segment is written completely. Smaller
+   * values keep the device filled at a finer granularity than the segment
+   * size and make the delay of the device more precise.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, ARG_WRITE_TIME,
+      g_param_spec_uint64 ("write-time", "Write Time",
+          "Maximum time to write to the device at once in microseconds "
+          "(0 = complete segments)", 0, G_MAXINT64, DEFAULT_WRITE_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstaudiobasesink_class->create_ringbuffer =
       GST_DEBUG_FUNCPTR (gst_audio_sink_create_ringbuffer);
 
@@ -681,6 +771,47 @@ gst_audio_sink_class_init (GstAudioSinkClass * klass)
 static void
 gst_audio_sink_init (GstAudioSink * audiosink)
 {
+  GstAudioSinkPrivate *priv = gst_audio_sink_get_instance_private (audiosink);
+
+  priv->write_time = DEFAULT_WRITE_TIME;
+}
+
+static void
+gst_audio_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstAudioSink *sink = GST_AUDIO_SINK (object);
+  GstAudioSinkPrivate *priv = gst_audio_sink_get_instance_private (sink);
+
+  switch (prop_id) {
+    case ARG_WRITE_TIME:
+      GST_OBJECT_LOCK (sink);
+      priv->write_time = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_audio_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstAudioSink *sink = GST_AUDIO_SINK (object);
+  GstAudioSinkPrivate *priv = gst_audio_sink_get_instance_private (sink);
+
+  switch (prop_id) {
+    case ARG_WRITE_TIME:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_uint64 (value, priv->write_time);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
 }
 
 static GstAudioRingBuffer *
@@ -0,0 +1,533 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#include "gstfftf32-x86-sse.h"
+
+#if defined (HAVE_XMMINTRIN_H) && defined(__SSE__)
+#include <xmmintrin.h>
+
+/* This is the KissFFT mixed radix algorithm (see kiss_fft_f32.c and
+ * kiss_fftr_f32.c) with every scalar replaced by a vector of four floats,
+ * so that four independent transforms are computed in parallel. The
+ * twiddles are shared and get broadcast to all lanes. */
+
+#define MAXFACTORS 32
+
+typedef struct
+{
+  __m128 r, i;
+} GstFFTF32Cpx4;
+
+struct _GstFFTF32SSE
+{
+  gint len;
+  gint ncfft;
+  gboolean inverse;
+  gint factors[2 * MAXFACTORS];
+
+  /* ncfft twiddles followed by ncfft / 2 super twiddles */
+  GstFFTF32Complex *twiddles;
+  GstFFTF32Complex *super_twiddles;
+
+  /* 16 byte aligned scratch buffers of ncfft elements */
+  gpointer mem;
+  GstFFTF32Cpx4 *tmpbuf;
+  GstFFTF32Cpx4 *outbuf;
+};
+
+#define C4_ADD(res, a, b) G_STMT_START {        \
+  (res).r = _mm_add_ps ((a).r, (b).r);          \
+  (res).i = _mm_add_ps ((a).i, (b).i);          \
+} G_STMT_END
+
+#define C4_SUB(res, a, b) G_STMT_START {        \
+  (res).r = _mm_sub_ps ((a).r, (b).r);          \
+  (res).i = _mm_sub_ps ((a).i, (b).i);          \
+} G_STMT_END
+
+/* multiply by a twiddle, @m may alias @a */
+#define C4_MUL(m, a, tw) G_STMT_START {                                  \
+  __m128 _tr = _mm_set1_ps ((tw).r), _ti = _mm_set1_ps ((tw).i);        \
+  __m128 _ar = (a).r, _ai = (a).i;                                      \
+  (m).r = _mm_sub_ps (_mm_mul_ps (_ar, _tr), _mm_mul_ps (_ai, _ti));    \
+  (m).i = _mm_add_ps (_mm_mul_ps (_ar, _ti), _mm_mul_ps (_ai, _tr));    \
+} G_STMT_END
+
+static void
+bfly2 (GstFFTF32Cpx4 * Fout, gsize fstride, const GstFFTF32SSE * self,
+    gint m)
+{
+  GstFFTF32Cpx4 *Fout2 = Fout + m;
+  const GstFFTF32Complex *tw1 = self->twiddles;
+  GstFFTF32Cpx4 t;
+
+  do {
+    C4_MUL (t, *Fout2, *tw1);
+    tw1 += fstride;
+    C4_SUB (*Fout2, *Fout, t);
+    C4_ADD (*Fout, *Fout, t);
+    ++Fout2;
+    ++Fout;
+  } while (--m);
+}
+
+static void
+bfly3 (GstFFTF32Cpx4 * Fout, gsize fstride, const GstFFTF32SSE * self,
+    gint m)
+{
+  gint k = m;
+  const gint m2 = 2 * m;
+  const GstFFTF32Complex *tw1, *tw2;
+  GstFFTF32Cpx4 s0, s1, s2, s3;
+  __m128 half = _mm_set1_ps (0.5f);
+  __m128 epi3 = _mm_set1_ps (self->twiddles[fstride * m].i);
+
+  tw1 = tw2 = self->twiddles;
+
+  do {
+    C4_MUL (s1, Fout[m], *tw1);
+    C4_MUL (s2, Fout[m2], *tw2);
+
+    C4_ADD (s3, s1, s2);
+    C4_SUB (s0, s1, s2);
+    tw1 += fstride;
+    tw2 += fstride * 2;
+
+    Fout[m].r = _mm_sub_ps (Fout->r, _mm_mul_ps (s3.r, half));
+    Fout[m].i = _mm_sub_ps (Fout->i, _mm_mul_ps (s3.i, half));
+
+    s0.r = _mm_mul_ps (s0.r, epi3);
+    s0.i = _mm_mul_ps (s0.i, epi3);
+
+    C4_ADD (*Fout, *Fout, s3);
+
+    Fout[m2].r = _mm_add_ps (Fout[m].r, s0.i);
+    Fout[m2].i = _mm_sub_ps (Fout[m].i, s0.r);
+
+    Fout[m].r = _mm_sub_ps (Fout[m].r, s0.i);
+    Fout[m].i = _mm_add_ps (Fout[m].i, s0.r);
+
+    ++Fout;
+  } while (--k);
+}
+
+static void
+bfly4 (GstFFTF32Cpx4 * Fout, gsize fstride, const GstFFTF32SSE * self,
+    gint m)
+{
+  const GstFFTF32Complex *tw1, *tw2, *tw3;
+  GstFFTF32Cpx4 s0, s1, s2, s3, s4, s5;
+  gint k = m;
+  const gint m2 = 2 * m;
+  const gint m3 = 3 * m;
+
+  tw3 = tw2 = tw1 = self->twiddles;
+
+  do {
+    C4_MUL (s0, Fout[m], *tw1);
+    C4_MUL (s1, Fout[m2], *tw2);
+    C4_MUL (s2, Fout[m3], *tw3);
+
+    C4_SUB (s5, *Fout, s1);
+    C4_ADD (*Fout, *Fout, s1);
+    C4_ADD (s3, s0, s2);
+    C4_SUB (s4, s0, s2);
+    C4_SUB (Fout[m2], *Fout, s3);
+    tw1 += fstride;
+    tw2 += fstride * 2;
+    tw3 += fstride * 3;
+    C4_ADD (*Fout, *Fout, s3);
+
+    if (self->inverse) {
+      Fout[m].r = _mm_sub_ps (s5.r, s4.i);
+      Fout[m].i = _mm_add_ps (s5.i, s4.r);
+      Fout[m3].r = _mm_add_ps (s5.r, s4.i);
+      Fout[m3].i = _mm_sub_ps (s5.i, s4.r);
+    } else {
+      Fout[m].r = _mm_add_ps (s5.r, s4.i);
+      Fout[m].i = _mm_sub_ps (s5.i, s4.r);
+      Fout[m3].r = _mm_sub_ps (s5.r, s4.i);
+      Fout[m3].i = _mm_add_ps (s5.i, s4.r);
+    }
+    ++Fout;
+  } while (--k);
+}
+
+static void
+bfly5 (GstFFTF32Cpx4 * Fout, gsize fstride, const GstFFTF32SSE * self,
+    gint m)
+{
+  GstFFTF32Cpx4 *Fout0, *Fout1, *Fout2, *Fout3, *Fout4;
+  GstFFTF32Cpx4 s0, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12;
+  const GstFFTF32Complex *tw = self->twiddles;
+  __m128 yar, yai, ybr, ybi;
+  gint u;
+
+  yar = _mm_set1_ps (tw[fstride * m].r);
+  yai = _mm_set1_ps (tw[fstride * m].i);
+  ybr = _mm_set1_ps (tw[fstride * 2 * m].r);
+  ybi = _mm_set1_ps (tw[fstride * 2 * m].i);
+
+  Fout0 = Fout;
+  Fout1 = Fout0 + m;
+  Fout2 = Fout0 + 2 * m;
+  Fout3 = Fout0 + 3 * m;
+  Fout4 = Fout0 + 4 * m;
+
+  for (u = 0; u < m; ++u) {
+    s0 = *Fout0;
+
+    C4_MUL (s1, *Fout1, tw[u * fstride]);
+    C4_MUL (s2, *Fout2, tw[2 * u * fstride]);
+    C4_MUL (s3, *Fout3, tw[3 * u * fstride]);
+    C4_MUL (s4, *Fout4, tw[4 * u * fstride]);
+
+    C4_ADD (s7, s1, s4);
+    C4_SUB (s10, s1, s4);
+    C4_ADD (s8, s2, s3);
+    C4_SUB (s9, s2, s3);
+
+    Fout0->r = _mm_add_ps (Fout0->r, _mm_add_ps (s7.r, s8.r));
+    Fout0->i = _mm_add_ps (Fout0->i, _mm_add_ps (s7.i, s8.i));
+
+    s5.r = _mm_add_ps (s0.r,
+        _mm_add_ps (_mm_mul_ps (s7.r, yar), _mm_mul_ps (s8.r, ybr)));
+    s5.i = _mm_add_ps (s0.i,
+        _mm_add_ps (_mm_mul_ps (s7.i, yar), _mm_mul_ps (s8.i, ybr)));
+
+    s6.r = _mm_add_ps (_mm_mul_ps (s10.i, yai), _mm_mul_ps (s9.i, ybi));
+    s6.i = _mm_sub_ps (_mm_setzero_ps (),
+        _mm_add_ps (_mm_mul_ps (s10.r, yai), _mm_mul_ps (s9.r, ybi)));
+
+    C4_SUB (*Fout1, s5, s6);
+    C4_ADD (*Fout4, s5, s6);
+
+    s11.r = _mm_add_ps (s0.r,
+        _mm_add_ps (_mm_mul_ps (s7.r, ybr), _mm_mul_ps (s8.r, yar)));
+    s11.i = _mm_add_ps (s0.i,
+        _mm_add_ps (_mm_mul_ps (s7.i, ybr), _mm_mul_ps (s8.i, yar)));
+    s12.r = _mm_sub_ps (_mm_mul_ps (s9.i, yai), _mm_mul_ps (s10.i, ybi));
+    s12.i = _mm_sub_ps (_mm_mul_ps (s10.r, ybi), _mm_mul_ps (s9.r, yai));
+
+    C4_ADD (*Fout2, s11, s12);
+    C4_SUB (*Fout3, s11, s12);
+
+    ++Fout0;
+    ++Fout1;
+    ++Fout2;
+    ++Fout3;
+    ++Fout4;
+  }
+}
+
+static void
+work (GstFFTF32Cpx4 * Fout, const GstFFTF32Cpx4 * f, gsize fstride,
+    const gint * factors, const GstFFTF32SSE * self)
+{
+  GstFFTF32Cpx4 *Fout_beg = Fout;
+  const gint p = *factors++;    /* the radix  */
+  const gint m = *factors++;    /* stage's fft length/p */
+  const GstFFTF32Cpx4 *Fout_end = Fout + p * m;
+
+  if (m == 1) {
+    do {
+      *Fout = *f;
+      f += fstride;
+    } while (++Fout != Fout_end);
+  } else {
+    do {
+      work (Fout, f, fstride * p, factors, self);
+      f += fstride;
+    } while ((Fout += m) != Fout_end);
+  }
+
+  Fout = Fout_beg;
+
+  switch (p) {
+    case 2:
+      bfly2 (Fout, fstride, self, m);
+      break;
+    case 3:
+      bfly3 (Fout, fstride, self, m);
+      break;
+    case 4:
+      bfly4 (Fout, fstride, self, m);
+      break;
+    case 5:
+      bfly5 (Fout, fstride, self, m);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+/* same factorization as kf_factor(), fails for radices without a
+ * butterfly */
+static gboolean
+factor (gint n, gint * facbuf)
+{
+  gint p = 4;
+  gdouble floor_sqrt = floor (sqrt ((gdouble) n));
+
+  do {
+    while (n % p) {
+      switch (p) {
+        case 4:
+          p = 2;
+          break;
+        case 2:
+          p = 3;
+          break;
+        default:
+          p += 2;
+          break;
+      }
+      if (p > floor_sqrt)
+        p = n;
+    }
+    if (p < 2 || p > 5)
+      return FALSE;
+    n /= p;
+    *facbuf++ = p;
+    *facbuf++ = n;
+  } while (n > 1);
+
+  return TRUE;
+}
+
+GstFFTF32SSE *
+gst_fft_f32_sse_new (gint len, gboolean inverse)
+{
+  GstFFTF32SSE *self;
+  gint i, ncfft = len / 2;
+  gint factors[2 * MAXFACTORS];
+
+  if (ncfft < 2 || !factor (ncfft, factors))
+    return NULL;
+
+  self = g_new0 (GstFFTF32SSE, 1);
+  self->len = len;
+  self->ncfft = ncfft;
+  self->inverse = inverse;
+  memcpy (self->factors, factors, sizeof (factors));
+
+  self->twiddles = g_new (GstFFTF32Complex, ncfft + ncfft / 2);
+  self->super_twiddles = self->twiddles + ncfft;
+  for (i = 0; i < ncfft; i++) {
+    gdouble phase = -2 * G_PI * i / ncfft;
+
+    if (inverse)
+      phase *= -1;
+    self->twiddles[i].r = cos (phase);
+    self->twiddles[i].i = sin (phase);
+  }
+  for (i = 0; i < ncfft / 2; i++) {
+    gdouble phase = -G_PI * ((gdouble) (i + 1) / ncfft + .5);
+
+    if (inverse)
+      phase *= -1;
+    self->super_twiddles[i].r = cos (phase);
+    self->super_twiddles[i].i = sin (phase);
+  }
+
+  self->mem = g_malloc (2 * ncfft * sizeof (GstFFTF32Cpx4) + 15);
+  self->tmpbuf = (GstFFTF32Cpx4 *) (((guintptr) self->mem + 15) & ~15);
+  self->outbuf = self->tmpbuf + ncfft;
+
+  return self;
+}
+
+void
+gst_fft_f32_sse_free (GstFFTF32SSE * self)
+{
+  g_free (self->twiddles);
+  g_free (self->mem);
+  g_free (self);
+}
+
+/* stores lane n of @r and @i as element @k of the n-th output */
+static inline void
+store_freq_x4 (GstFFTF32Complex * freqdata, gint stride, gint k, __m128 r,
+    __m128 i)
+{
+  __m128 lo = _mm_unpacklo_ps (r, i);
+  __m128 hi = _mm_unpackhi_ps (r, i);
+
+  _mm_storel_pi ((__m64 *) (freqdata + k), lo);
+  _mm_storeh_pi ((__m64 *) (freqdata + stride + k), lo);
+  _mm_storel_pi ((__m64 *) (freqdata + 2 * stride + k), hi);
+  _mm_storeh_pi ((__m64 *) (freqdata + 3 * stride + k), hi);
+}
+
+static inline GstFFTF32Cpx4
+load_freq_x4 (const GstFFTF32Complex * freqdata, gint stride, gint k)
+{
+  GstFFTF32Cpx4 res;
+  __m128 lo = _mm_setzero_ps (), hi = _mm_setzero_ps ();
+
+  lo = _mm_loadl_pi (lo, (const __m64 *) (freqdata + k));
+  lo = _mm_loadh_pi (lo, (const __m64 *) (freqdata + stride + k));
+  hi = _mm_loadl_pi (hi, (const __m64 *) (freqdata + 2 * stride + k));
+  hi = _mm_loadh_pi (hi, (const __m64 *) (freqdata + 3 * stride + k));
+
+  res.r = _mm_shuffle_ps (lo, hi, _MM_SHUFFLE (2, 0, 2, 0));
+  res.i = _mm_shuffle_ps (lo, hi, _MM_SHUFFLE (3, 1, 3, 1));
+
+  return res;
+}
+
+/*
+ * gst_fft_f32_sse_fft_x4:
+ * @self: the plan
+ * @timedata: four consecutive blocks of @len time domain samples
+ * @freqdata: four consecutive blocks of @len/2 + 1 frequency domain samples
+ *
+ * Performs the forward FFT of the four blocks, like kiss_fftr_f32().
+ */
+void
+gst_fft_f32_sse_fft_x4 (GstFFTF32SSE * self, const gfloat * timedata,
+    GstFFTF32Complex * freqdata)
+{
+  const gint len = self->len, ncfft = self->ncfft, stride = ncfft + 1;
+  const gfloat *t0 = timedata, *t1 = t0 + len, *t2 = t1 + len, *t3 = t2 + len;
+  GstFFTF32Cpx4 *in = self->tmpbuf, *out = self->outbuf;
+  GstFFTF32Cpx4 fpk, fpnk, f1k, f2k, tw;
+  __m128 half = _mm_set1_ps (0.5f);
+  gint j, k;
+
+  /* deinterleave the real input into complex pairs, one transform per
+   * lane */
+  for (j = 0; j < len / 4; j++) {
+    __m128 a0 = _mm_loadu_ps (t0 + 4 * j);
+    __m128 a1 = _mm_loadu_ps (t1 + 4 * j);
+    __m128 a2 = _mm_loadu_ps (t2 + 4 * j);
+    __m128 a3 = _mm_loadu_ps (t3 + 4 * j);
+
+    _MM_TRANSPOSE4_PS (a0, a1, a2, a3);
+    in[2 * j].r = a0;
+    in[2 * j].i = a1;
+    in[2 * j + 1].r = a2;
+    in[2 * j + 1].i = a3;
+  }
+  for (k = 2 * j; k < ncfft; k++) {
+    in[k].r = _mm_setr_ps (t0[2 * k], t1[2 * k], t2[2 * k], t3[2 * k]);
+    in[k].i = _mm_setr_ps (t0[2 * k + 1], t1[2 * k + 1], t2[2 * k + 1],
+        t3[2 * k + 1]);
+  }
+
+  work (out, in, 1, self->factors, self);
+
+  store_freq_x4 (freqdata, stride, 0, _mm_add_ps (out[0].r, out[0].i),
+      _mm_setzero_ps ());
+  store_freq_x4 (freqdata, stride, ncfft, _mm_sub_ps (out[0].r, out[0].i),
+      _mm_setzero_ps ());
+
+  for (k = 1; k <= ncfft / 2; ++k) {
+    fpk = out[k];
+    fpnk.r = out[ncfft - k].r;
+    fpnk.i = _mm_sub_ps (_mm_setzero_ps (), out[ncfft - k].i);
+
+    C4_ADD (f1k, fpk, fpnk);
+    C4_SUB (f2k, fpk, fpnk);
+    C4_MUL (tw, f2k, self->super_twiddles[k - 1]);
+
+    store_freq_x4 (freqdata, stride, k,
+        _mm_mul_ps (_mm_add_ps (f1k.r, tw.r), half),
+        _mm_mul_ps (_mm_add_ps (f1k.i, tw.i), half));
+    store_freq_x4 (freqdata, stride, ncfft - k,
+        _mm_mul_ps (_mm_sub_ps (f1k.r, tw.r), half),
+        _mm_mul_ps (_mm_sub_ps (tw.i, f1k.i), half));
+  }
+}
+
+/*
+ * gst_fft_f32_sse_inverse_fft_x4:
+ * @self: the plan
+ * @freqdata: four consecutive blocks of @len/2 + 1 frequency domain samples
+ * @timedata: four consecutive blocks of @len time domain samples
+ *
+ * Performs the inverse FFT of the four blocks, like kiss_fftri_f32().
+ */
+void
+gst_fft_f32_sse_inverse_fft_x4 (GstFFTF32SSE * self,
+    const GstFFTF32Complex * freqdata, gfloat * timedata)
+{
+  const gint len = self->len, ncfft = self->ncfft, stride = ncfft + 1;
+  gfloat *t0 = timedata, *t1 = t0 + len, *t2 = t1 + len, *t3 = t2 + len;
+  GstFFTF32Cpx4 *in = self->tmpbuf, *out = self->outbuf;
+  GstFFTF32Cpx4 fk, fnkc, fek, fok, tmp, f0, fn;
+  gint j, k;
+
+  f0 = load_freq_x4 (freqdata, stride, 0);
+  fn = load_freq_x4 (freqdata, stride, ncfft);
+  in[0].r = _mm_add_ps (f0.r, fn.r);
+  in[0].i = _mm_sub_ps (f0.r, fn.r);
+
+  for (k = 1; k <= ncfft / 2; ++k) {
+    fk = load_freq_x4 (freqdata, stride, k);
+    fnkc = load_freq_x4 (freqdata, stride, ncfft - k);
+    fnkc.i = _mm_sub_ps (_mm_setzero_ps (), fnkc.i);
+
+    C4_ADD (fek, fk, fnkc);
+    C4_SUB (tmp, fk, fnkc);
+    C4_MUL (fok, tmp, self->super_twiddles[k - 1]);
+    C4_ADD (in[k], fek, fok);
+    in[ncfft - k].r = _mm_sub_ps (fek.r, fok.r);
+    in[ncfft - k].i = _mm_sub_ps (fok.i, fek.i);
+  }
+
+  work (out, in, 1, self->factors, self);
+
+  /* interleave the complex pairs back into real output */
+  for (j = 0; j < len / 4; j++) {
+    __m128 a0 = out[2 * j].r;
+    __m128 a1 = out[2 * j].i;
+    __m128 a2 = out[2 * j + 1].r;
+    __m128 a3 = out[2 * j + 1].i;
+
+    _MM_TRANSPOSE4_PS (a0, a1, a2, a3);
+    _mm_storeu_ps (t0 + 4 * j, a0);
+    _mm_storeu_ps (t1 + 4 * j, a1);
+    _mm_storeu_ps (t2 + 4 * j, a2);
+    _mm_storeu_ps (t3 + 4 * j, a3);
+  }
+  for (k = 2 * j; k < ncfft; k++) {
+    gfloat r[4], i[4];
+
+    _mm_storeu_ps (r, out[k].r);
+    _mm_storeu_ps (i, out[k].i);
+    t0[2 * k] = r[0];
+    t1[2 * k] = r[1];
+    t2[2 * k] = r[2];
+    t3[2 * k] = r[3];
+    t0[2 * k + 1] = i[0];
+    t1[2 * k + 1] = i[1];
+    t2[2 * k + 1] = i[2];
+    t3[2 * k + 1] = i[3];
+  }
+}
+
+#endif
@@ -0,0 +1,50 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_FFT_F32_X86_SSE_H__
+#define __GST_FFT_F32_X86_SSE_H__
+
+#include <glib.h>
+
+#include "gstfftf32.h"
+
+G_BEGIN_DECLS
+
+/* Real FFT running four transforms of the same length at once, one per SSE
+ * lane. Only lengths whose half is a product of 2, 3 and 5 are supported. */
+typedef struct _GstFFTF32SSE GstFFTF32SSE;
+
+G_GNUC_INTERNAL
+GstFFTF32SSE * gst_fft_f32_sse_new         (gint len, gboolean inverse);
+
+G_GNUC_INTERNAL
+void           gst_fft_f32_sse_fft_x4      (GstFFTF32SSE * self,
+                                            const gfloat * timedata,
+                                            GstFFTF32Complex * freqdata);
+
+G_GNUC_INTERNAL
+void           gst_fft_f32_sse_inverse_fft_x4 (GstFFTF32SSE * self,
+                                            const GstFFTF32Complex * freqdata,
+                                            gfloat * timedata);
+
+G_GNUC_INTERNAL
+void           gst_fft_f32_sse_free        (GstFFTF32SSE * self);
+
+G_END_DECLS
+
+#endif /* __GST_FFT_F32_X86_SSE_H__ */
@@ -29,6 +29,11 @@
 #include "gstfft.h"
 #include "gstfftf32.h"
 
+#if defined (HAVE_XMMINTRIN_H) && defined (HAVE_SSE)
+#define USE_SSE
+#include "gstfftf32-x86-sse.h"
+#endif
+
 /**
  * SECTION:gstfftf32
  * @title: GstFFTF32
@@ -60,6 +65,11 @@
  * length of the FFT. This also has to be taken into account when calculation
  * the magnitude of the frequency data.
  *
+ * When the same transform has to be done on several buffers, for example on
+ * every channel of a multichannel stream, gst_fft_f32_fft_batch() and
+ * gst_fft_f32_inverse_fft_batch() should be used. On x86 CPUs with SSE they
+ * compute four transforms at once.
+ *
  */
 
 struct _GstFFTF32
@@ -67,8 +77,27 @@ struct _GstFFTF32
   void *cfg;
   gboolean inverse;
   gint len;
+#ifdef USE_SSE
+  GstFFTF32SSE *sse;
+#endif
 };
 
+#ifdef USE_SSE
+static gboolean
+gst_fft_f32_have_sse (void)
+{
+#if defined (__x86_64__) || defined (_M_X64)
+  /* part of the x86-64 baseline */
+  return TRUE;
+#elif defined (__GNUC__) || defined (__clang__)
+  __builtin_cpu_init ();
+  return __builtin_cpu_supports ("sse");
+#else
+  return FALSE;
+#endif
+}
+#endif
+
 /**
  * gst_fft_f32_new: (skip)
  * @len: Length of the FFT in the time domain
@@ -104,6 +133,11 @@ gst_fft_f32_new (gint len, gboolean inverse)
   self->inverse = inverse;
   self->len = len;
 
+#ifdef USE_SSE
+  if (gst_fft_f32_have_sse ())
+    self->sse = gst_fft_f32_sse_new (len, inverse);
+#endif
+
   return self;
 }
 
@@ -160,6 +194,90 @@ gst_fft_f32_inverse_fft (GstFFTF32 * self, const GstFFTF32Complex * freqdata,
   kiss_fftri_f32 (self->cfg, (kiss_fft_f32_cpx *) freqdata, timedata);
 }
 
+/**
+ * gst_fft_f32_fft_batch:
+ * @self: #GstFFTF32 instance for this call
+ * @timedata: Buffer of the samples in the time domain
+ * @freqdata: Target buffer for the samples in the frequency domain
+ * @n_transforms: Number of transforms to perform
+ *
+ * This performs the FFT on @n_transforms consecutive blocks of @len samples
+ * in @timedata and puts the results as consecutive blocks of @len/2 + 1
+ * samples in @freqdata, with @len being the parameter specified while
+ * allocating the #GstFFTF32 instance with gst_fft_f32_new().
+ *
+ * The result is the same as calling gst_fft_f32_fft() on every block, but
+ * several blocks are processed in parallel where the CPU allows it.
+ *
+ * Since: 1.22
+ */
+void
+gst_fft_f32_fft_batch (GstFFTF32 * self, const gfloat * timedata,
+    GstFFTF32Complex * freqdata, guint n_transforms)
+{
+  guint n = 0;
+
+  g_return_if_fail (self);
+  g_return_if_fail (!self->inverse);
+  g_return_if_fail (timedata || n_transforms == 0);
+  g_return_if_fail (freqdata || n_transforms == 0);
+
+#ifdef USE_SSE
+  if (self->sse) {
+    for (; n + 4 <= n_transforms; n += 4)
+      gst_fft_f32_sse_fft_x4 (self->sse, timedata + n * self->len,
+          freqdata + n * (self->len / 2 + 1));
+  }
+#endif
+
+  for (; n < n_transforms; n++)
+    kiss_fftr_f32 (self->cfg, timedata + n * self->len,
+        (kiss_fft_f32_cpx *) freqdata + n * (self->len / 2 + 1));
+}
+
+/**
+ * gst_fft_f32_inverse_fft_batch:
+ * @self: #GstFFTF32 instance for this call
+ * @freqdata: Buffer of the samples in the frequency domain
+ * @timedata: Target buffer for the samples in the time domain
+ * @n_transforms: Number of transforms to perform
+ *
+ * This performs the inverse FFT on @n_transforms consecutive blocks of
+ * @len/2 + 1 samples in @freqdata and puts the results as consecutive blocks
+ * of @len samples in @timedata, with @len being the parameter specified while
+ * allocating the #GstFFTF32 instance with gst_fft_f32_new().
+ *
+ * The result is the same as calling gst_fft_f32_inverse_fft() on every
+ * block, but several blocks are processed in parallel where the CPU allows
+ * it.
+ *
+ * Since: 1.22
+ */
+void
+gst_fft_f32_inverse_fft_batch (GstFFTF32 * self,
+    const GstFFTF32Complex * freqdata, gfloat * timedata, guint n_transforms)
+{
+  guint n = 0;
+
+  g_return_if_fail (self);
+  g_return_if_fail (self->inverse);
+  g_return_if_fail (timedata || n_transforms == 0);
+  g_return_if_fail (freqdata || n_transforms == 0);
+
+#ifdef USE_SSE
+  if (self->sse) {
+    for (; n + 4 <= n_transforms; n += 4)
+      gst_fft_f32_sse_inverse_fft_x4 (self->sse,
+          freqdata + n * (self->len / 2 + 1), timedata + n * self->len);
+  }
+#endif
+
+  for (; n < n_transforms; n++)
+    kiss_fftri_f32 (self->cfg,
+        (kiss_fft_f32_cpx *) freqdata + n * (self->len / 2 + 1),
+        timedata + n * self->len);
+}
+
 /**
  * gst_fft_f32_free:
  * @self: #GstFFTF32 instance for this call
@@ -170,6 +288,10 @@ gst_fft_f32_inverse_fft (GstFFTF32 * self, const GstFFTF32Complex * freqdata,
 void
 gst_fft_f32_free (GstFFTF32 * self)
 {
+#ifdef USE_SSE
+  if (self->sse)
+    gst_fft_f32_sse_free (self->sse);
+#endif
   g_free (self);
 }
 
@@ -63,6 +63,14 @@ GST_FFT_API
 void          gst_fft_f32_inverse_fft   (GstFFTF32 *self, const GstFFTF32Complex *freqdata,
                                          gfloat *timedata);
 
+GST_FFT_API
+void          gst_fft_f32_fft_batch     (GstFFTF32 *self, const gfloat *timedata,
+                                         GstFFTF32Complex *freqdata, guint n_transforms);
+
+GST_FFT_API
+void          gst_fft_f32_inverse_fft_batch (GstFFTF32 *self, const GstFFTF32Complex *freqdata,
+                                         gfloat *timedata, guint n_transforms);
+
 GST_FFT_API
 void          gst_fft_f32_window        (GstFFTF32 *self, gfloat *timedata, GstFFTWindow window);
 
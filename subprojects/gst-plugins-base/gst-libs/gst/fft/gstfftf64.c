@@ -160,6 +160,72 @@ gst_fft_f64_inverse_fft (GstFFTF64 * self, const GstFFTF64Complex * freqdata,
   kiss_fftri_f64 (self->cfg, (kiss_fft_f64_cpx *) freqdata, timedata);
 }
 
+/**
+ * gst_fft_f64_fft_batch:
+ * @self: #GstFFTF64 instance for this call
+ * @timedata: Buffer of the samples in the time domain
+ * @freqdata: Target buffer for the samples in the frequency domain
+ * @n_transforms: Number of transforms to perform
+ *
+ * This performs the FFT on @n_transforms consecutive blocks of @len samples
+ * in @timedata and puts the results as consecutive blocks of @len/2 + 1
+ * samples in @freqdata, with @len being the parameter specified while
+ * allocating the #GstFFTF64 instance with gst_fft_f64_new().
+ *
+ * The result is the same as calling gst_fft_f64_fft() on every block.
+ *
+ * Since: 1.22
+ */
+void
+gst_fft_f64_fft_batch (GstFFTF64 * self, const gdouble * timedata,
+    GstFFTF64Complex * freqdata, guint n_transforms)
+{
+  guint n;
+
+  g_return_if_fail (self);
+  g_return_if_fail (!self->inverse);
+  g_return_if_fail (timedata || n_transforms == 0);
+  g_return_if_fail (freqdata || n_transforms == 0);
+
+  for (n = 0; n < n_transforms; n++)
+    kiss_fftr_f64 (self->cfg, timedata + n * self->len,
+        (kiss_fft_f64_cpx *) freqdata + n * (self->len / 2 + 1));
+}
+
+/**
+ * gst_fft_f64_inverse_fft_batch:
+ * @self: #GstFFTF64 instance for this call
+ * @freqdata: Buffer of the samples in the frequency domain
+ * @timedata: Target buffer for the samples in the time domain
+ * @n_transforms: Number of transforms to perform
+ *
+ * This performs the inverse FFT on @n_transforms consecutive blocks of
+ * @len/2 + 1 samples in @freqdata and puts the results as consecutive blocks
+ * of @len samples in @timedata, with @len being the parameter specified while
+ * allocating the #GstFFTF64 instance with gst_fft_f64_new().
+ *
+ * The result is the same as calling gst_fft_f64_inverse_fft() on every
+ * block.
+ *
+ * Since: 1.22
+ */
+void
+gst_fft_f64_inverse_fft_batch (GstFFTF64 * self,
+    const GstFFTF64Complex * freqdata, gdouble * timedata, guint n_transforms)
+{
+  guint n;
+
+  g_return_if_fail (self);
+  g_return_if_fail (self->inverse);
+  g_return_if_fail (timedata || n_transforms == 0);
+  g_return_if_fail (freqdata || n_transforms == 0);
+
+  for (n = 0; n < n_transforms; n++)
+    kiss_fftri_f64 (self->cfg,
+        (kiss_fft_f64_cpx *) freqdata + n * (self->len / 2 + 1),
+        timedata + n * self->len);
+}
+
 /**
  * gst_fft_f64_free:
  * @self: #GstFFTF64 instance for this call
@@ -549,17 +549,12 @@ gst_gl_base_filter_find_gl_context_unlocked (GstGLBaseFilter * filter)
   if (!filter->context) {
     GST_OBJECT_LOCK (filter->display);
     do {
-      if (filter->context)
-        gst_object_unref (filter->context);
+      gst_clear_object (&filter->context);
       /* just get a GL context.  we don't care */
-      filter->context =
-          gst_gl_display_get_gl_context_for_thread (filter->display, NULL);
-      if (!filter->context) {
-        if (!gst_gl_display_create_context (filter->display,
-                filter->priv->other_context, &filter->context, &error)) {
-          GST_OBJECT_UNLOCK (filter->display);
-          goto context_error;
-        }
+      if (!gst_gl_display_ensure_context (filter->display,
+              filter->priv->other_context, &filter->context, &error)) {
+        GST_OBJECT_UNLOCK (filter->display);
+        goto context_error;
       }
     } while (!gst_gl_display_add_context (filter->display, filter->context));
     GST_OBJECT_UNLOCK (filter->display);
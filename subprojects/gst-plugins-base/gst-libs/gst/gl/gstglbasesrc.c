@@ -563,14 +563,10 @@ gst_gl_base_src_find_gl_context_unlocked (GstGLBaseSrc * src)
         src->context = NULL;
       }
       /* just get a GL context.  we don't care */
-      src->context =
-          gst_gl_display_get_gl_context_for_thread (src->display, NULL);
-      if (!src->context) {
-        if (!gst_gl_display_create_context (src->display,
-                src->priv->other_context, &src->context, &error)) {
-          GST_OBJECT_UNLOCK (src->display);
-          goto context_error;
-        }
+      if (!gst_gl_display_ensure_context (src->display,
+              src->priv->other_context, &src->context, &error)) {
+        GST_OBJECT_UNLOCK (src->display);
+        goto context_error;
       }
     } while (!gst_gl_display_add_context (src->display, src->context));
     GST_OBJECT_UNLOCK (src->display);
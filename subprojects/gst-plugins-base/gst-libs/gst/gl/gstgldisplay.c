@@ -103,6 +103,8 @@ struct _GstGLDisplayPrivate
   GstGLAPI gl_api;
 
   GList *contexts;
+  guint context_pool_size;
+  guint next_pool_context;
 
   GThread *event_thread;
 
@@ -189,6 +191,15 @@ gst_gl_display_init (GstGLDisplay * display)
 
   display->type = GST_GL_DISPLAY_TYPE_ANY;
   display->priv->gl_api = GST_GL_API_ANY;
+  display->priv->context_pool_size = 1;
+
+  {
+    const gchar *pool_size = g_getenv ("GST_GL_CONTEXT_POOL_SIZE");
+
+    if (pool_size)
+      display->priv->context_pool_size =
+          MAX (1, g_ascii_strtoull (pool_size, NULL, 10));
+  }
 
   g_mutex_init (&display->priv->thread_lock);
   g_cond_init (&display->priv->thread_cond);
@@ -873,6 +884,133 @@ gst_gl_display_get_gl_context_for_thread (GstGLDisplay * display,
   return context;
 }
 
+/**
+ * gst_gl_display_set_context_pool_size:
+ * @display: a #GstGLDisplay
+ * @size: the maximum number of #GstGLContext's to create
+ *
+ * Sets how many #GstGLContext's gst_gl_display_ensure_context() creates
+ * before it hands out the existing ones again. All the contexts share
+ * resources with each other, each runs its own GL thread, so elements using
+ * different contexts no longer serialize their GL work on a single thread.
+ *
+ * The default is 1, or the value of the `GST_GL_CONTEXT_POOL_SIZE`
+ * environment variable.
+ *
+ * Must be called with the object lock held.
+ *
+ * Since: 1.22
+ */
+void
+gst_gl_display_set_context_pool_size (GstGLDisplay * display, guint size)
+{
+  g_return_if_fail (GST_IS_GL_DISPLAY (display));
+  g_return_if_fail (size > 0);
+
+  display->priv->context_pool_size = size;
+}
+
+/**
+ * gst_gl_display_get_context_pool_size:
+ * @display: a #GstGLDisplay
+ *
+ * Must be called with the object lock held.
+ *
+ * Returns: the maximum number of #GstGLContext's created by
+ *     gst_gl_display_ensure_context()
+ *
+ * Since: 1.22
+ */
+guint
+gst_gl_display_get_context_pool_size (GstGLDisplay * display)
+{
+  g_return_val_if_fail (GST_IS_GL_DISPLAY (display), 0);
+
+  return display->priv->context_pool_size;
+}
+
+/**
+ * gst_gl_display_ensure_context:
+ * @display: a #GstGLDisplay
+ * @other_context: (transfer none) (nullable): other #GstGLContext to share
+ *     resources with
+ * @p_context: (transfer full) (out): resulting #GstGLContext
+ * @error: (allow-none): resulting #GError
+ *
+ * Retrieves a #GstGLContext for an element that did not find one to share
+ * with its neighbours. While there are less contexts in @display than the
+ * pool size set with gst_gl_display_set_context_pool_size(), a new context
+ * sharing with @other_context, or with the existing contexts, is created.
+ * Otherwise the existing contexts are returned in turn.
+ *
+ * The resulting context still needs to be added with
+ * gst_gl_display_add_context().
+ *
+ * Must be called with the object lock held.
+ *
+ * Returns: whether a context could be retrieved or created.
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_gl_display_ensure_context (GstGLDisplay * display,
+    GstGLContext * other_context, GstGLContext ** p_context, GError ** error)
+{
+  GstGLContext *context;
+  GList *l, *contexts = NULL;
+  guint n_contexts;
+
+  g_return_val_if_fail (GST_IS_GL_DISPLAY (display), FALSE);
+  g_return_val_if_fail (p_context != NULL, FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  if (display->priv->context_pool_size <= 1) {
+    *p_context = _get_gl_context_for_thread_unlocked (display, NULL);
+    if (*p_context)
+      return TRUE;
+
+    return gst_gl_display_create_context (display, other_context, p_context,
+        error);
+  }
+
+  /* drops the dead contexts from the list */
+  context = _get_gl_context_for_thread_unlocked (display, NULL);
+  gst_clear_object (&context);
+
+  for (l = display->priv->contexts; l; l = l->next) {
+    context = g_weak_ref_get (l->data);
+    if (context)
+      contexts = g_list_prepend (contexts, context);
+  }
+  contexts = g_list_reverse (contexts);
+  n_contexts = g_list_length (contexts);
+
+  if (n_contexts < display->priv->context_pool_size) {
+    gboolean ret;
+
+    if (!other_context && contexts)
+      other_context = contexts->data;
+
+    GST_DEBUG_OBJECT (display, "creating pool context %u of %u", n_contexts + 1,
+        display->priv->context_pool_size);
+    ret = gst_gl_display_create_context (display, other_context, p_context,
+        error);
+    g_list_free_full (contexts, gst_object_unref);
+
+    return ret;
+  }
+
+  context = g_list_nth_data (contexts,
+      display->priv->next_pool_context++ % n_contexts);
+  *p_context = gst_object_ref (context);
+  g_list_free_full (contexts, gst_object_unref);
+
+  GST_DEBUG_OBJECT (display, "returning pool context %" GST_PTR_FORMAT,
+      *p_context);
+
+  return TRUE;
+}
+
 static gboolean
 _check_collision (GstGLContext * context, GstGLContext * collision)
 {
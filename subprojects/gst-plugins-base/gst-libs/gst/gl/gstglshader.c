@@ -23,6 +23,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include "gl.h"
 #include "gstglshader.h"
 #include "gstglsl_private.h"
@@ -32,11 +34,20 @@
  * @title: GstGLShader
  * @short_description: object representing an OpenGL shader program
  * @see_also: #GstGLSLStage
+ *
+ * If the `GST_GL_SHADER_CACHE_DIR` environment variable points to a directory
+ * and the GL implementation supports program binaries, linked programs are
+ * stored in that directory and later links of the same sources on the same GL
+ * implementation load the stored binary instead of compiling the stages
+ * again.
  */
 
 #ifndef GLhandleARB
 #define GLhandleARB GLuint
 #endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
 
 #define USING_OPENGL(context) (gst_gl_context_check_gl_version (context, GST_GL_API_OPENGL, 1, 0))
 #define USING_OPENGL3(context) (gst_gl_context_check_gl_version (context, GST_GL_API_OPENGL3, 3, 1))
@@ -79,6 +90,11 @@ struct _GstGLShaderPrivate
   gboolean linked;
   GHashTable *uniform_locations;
 
+  /* stages whose compilation is deferred to link time so that a program
+   * binary from the cache can be used instead, see _program_cache_dir() */
+  GList *pending_stages;
+  GString *attribute_bindings;
+
   GstGLSLFuncs vtable;
 };
 
@@ -128,6 +144,7 @@ gst_gl_shader_finalize (GObject * object)
 
   priv->program_handle = 0;
   g_hash_table_destroy (priv->uniform_locations);
+  g_string_free (priv->attribute_bindings, TRUE);
 
   if (shader->context) {
     gst_object_unref (shader->context);
@@ -195,6 +212,7 @@ gst_gl_shader_init (GstGLShader * self)
   priv->linked = FALSE;
   priv->uniform_locations =
       g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  priv->attribute_bindings = g_string_new (NULL);
 }
 
 static int
@@ -222,6 +240,164 @@ _get_uniform_location (GstGLShader * shader, const gchar * name)
   return location;
 }
 
+static const gchar *
+_program_cache_dir (GstGLContext * context)
+{
+  const GstGLFuncs *gl = context->gl_vtable;
+  const gchar *dir;
+
+  if (!gl->GetProgramBinary || !gl->ProgramBinary)
+    return NULL;
+
+  dir = g_getenv ("GST_GL_SHADER_CACHE_DIR");
+  if (!dir || !dir[0])
+    return NULL;
+
+  return dir;
+}
+
+/* call with the object lock held */
+static gchar *
+_get_program_cache_filename (GstGLShader * shader)
+{
+  const GstGLFuncs *gl = shader->context->gl_vtable;
+  const GLenum strings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+  const gchar *dir;
+  GChecksum *checksum;
+  gchar *basename, *filename;
+  GList *elem;
+  guint i;
+
+  if (!(dir = _program_cache_dir (shader->context)))
+    return NULL;
+
+  checksum = g_checksum_new (G_CHECKSUM_SHA256);
+
+  /* a binary is only valid for the GL implementation that produced it */
+  for (i = 0; i < G_N_ELEMENTS (strings); i++) {
+    const gchar *str = (const gchar *) gl->GetString (strings[i]);
+
+    g_checksum_update (checksum, (const guchar *) (str ? str : ""), -1);
+    g_checksum_update (checksum, (const guchar *) "", 1);
+  }
+
+  for (elem = shader->priv->stages; elem; elem = elem->next)
+    _gst_glsl_stage_checksum_update (elem->data, checksum);
+  for (elem = shader->priv->pending_stages; elem; elem = elem->next)
+    _gst_glsl_stage_checksum_update (elem->data, checksum);
+
+  g_checksum_update (checksum,
+      (const guchar *) shader->priv->attribute_bindings->str,
+      shader->priv->attribute_bindings->len);
+
+  basename = g_strdup_printf ("%s.bin", g_checksum_get_string (checksum));
+  filename = g_build_filename (dir, basename, NULL);
+  g_checksum_free (checksum);
+  g_free (basename);
+
+  return filename;
+}
+
+/* call with the object lock held */
+static gboolean
+_load_program_binary (GstGLShader * shader, const gchar * filename)
+{
+  const GstGLFuncs *gl = shader->context->gl_vtable;
+  GstGLShaderPrivate *priv = shader->priv;
+  GLint status = GL_FALSE;
+  guint32 format;
+  gchar *contents;
+  gsize length;
+
+  if (!g_file_get_contents (filename, &contents, &length, NULL))
+    return FALSE;
+
+  if (length <= sizeof (format)) {
+    g_free (contents);
+    return FALSE;
+  }
+
+  memcpy (&format, contents, sizeof (format));
+  gl->ProgramBinary (priv->program_handle, format, contents + sizeof (format),
+      length - sizeof (format));
+  g_free (contents);
+
+  /* fails e.g. after a driver update, the program is then linked as usual */
+  priv->vtable.GetProgramiv (priv->program_handle, GL_LINK_STATUS, &status);
+  if (status != GL_TRUE) {
+    GST_INFO_OBJECT (shader, "Ignoring incompatible program binary %s",
+        filename);
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (shader, "Loaded program %u from %s", priv->program_handle,
+      filename);
+
+  return TRUE;
+}
+
+/* call with the object lock held */
+static void
+_save_program_binary (GstGLShader * shader, const gchar * filename)
+{
+  const GstGLFuncs *gl = shader->context->gl_vtable;
+  GstGLShaderPrivate *priv = shader->priv;
+  GError *error = NULL;
+  GLint length = 0;
+  GLenum format = 0;
+  gchar *contents, *dir;
+  guint32 format32;
+
+  priv->vtable.GetProgramiv (priv->program_handle, GL_PROGRAM_BINARY_LENGTH,
+      &length);
+  if (length <= 0)
+    return;
+
+  contents = g_malloc (sizeof (format32) + length);
+  gl->GetProgramBinary (priv->program_handle, length, &length, &format,
+      contents + sizeof (format32));
+  if (length <= 0) {
+    g_free (contents);
+    return;
+  }
+  format32 = format;
+  memcpy (contents, &format32, sizeof (format32));
+
+  dir = g_path_get_dirname (filename);
+  g_mkdir_with_parents (dir, 0755);
+  g_free (dir);
+
+  if (!g_file_set_contents (filename, contents, sizeof (format32) + length,
+          &error)) {
+    GST_WARNING_OBJECT (shader, "Failed to store program binary: %s",
+        error->message);
+    g_clear_error (&error);
+  } else {
+    GST_DEBUG_OBJECT (shader, "Stored program %u in %s", priv->program_handle,
+        filename);
+  }
+
+  g_free (contents);
+}
+
+/* With the program cache enabled, compiling is deferred until link time as
+ * it is not needed if a program binary is found. */
+static gboolean
+_defer_stage_compile (GstGLShader * shader, GstGLSLStage * stage)
+{
+  if (!_program_cache_dir (shader->context))
+    return FALSE;
+
+  GST_OBJECT_LOCK (shader);
+  if (!g_list_find (shader->priv->pending_stages, stage))
+    shader->priv->pending_stages =
+        g_list_append (shader->priv->pending_stages,
+        gst_object_ref_sink (stage));
+  GST_OBJECT_UNLOCK (shader);
+
+  return TRUE;
+}
+
 static GstGLShader *
 _new_with_stages_va_list (GstGLContext * context, GError ** error,
     va_list varargs)
@@ -242,6 +418,9 @@ _new_with_stages_va_list (GstGLContext * context, GError ** error,
       continue;
     }
 
+    if (_defer_stage_compile (shader, stage))
+      continue;
+
     if (!gst_glsl_stage_compile (stage, error)) {
       gst_object_unref (stage);
       to_unref_and_out = TRUE;
@@ -445,6 +624,14 @@ gst_gl_shader_detach_unlocked (GstGLShader * shader, GstGLSLStage * stage)
   if (!shader->priv->program_handle)
     return;
 
+  elem = g_list_find (shader->priv->pending_stages, stage);
+  if (elem) {
+    shader->priv->pending_stages =
+        g_list_delete_link (shader->priv->pending_stages, elem);
+    gst_object_unref (stage);
+    return;
+  }
+
   elem = g_list_find (shader->priv->stages, stage);
   if (!elem) {
     GST_FIXME_OBJECT (shader, "Could not find stage %p in shader %p", stage,
@@ -598,6 +785,10 @@ gst_gl_shader_attach (GstGLShader * shader, GstGLSLStage * stage)
  *
  * Compiles @stage and attaches it to @shader.
  *
+ * If the program cache is enabled (see the `GST_GL_SHADER_CACHE_DIR`
+ * environment variable), compiling is deferred and compilation errors are
+ * reported by gst_gl_shader_link() instead.
+ *
  * Note: must be called in the GL thread
  *
  * Returns: whether @stage could be compiled and attached to @shader
@@ -610,6 +801,9 @@ gst_gl_shader_compile_attach_stage (GstGLShader * shader, GstGLSLStage * stage,
 {
   g_return_val_if_fail (GST_IS_GLSL_STAGE (stage), FALSE);
 
+  if (_defer_stage_compile (shader, stage))
+    return TRUE;
+
   if (!gst_glsl_stage_compile (stage, error)) {
     return FALSE;
   }
@@ -644,6 +838,7 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
   gchar info_buffer[2048];
   GLint status = GL_FALSE;
   gint len = 0;
+  gchar *cache_filename;
   gboolean ret;
   GList *elem;
 
@@ -675,11 +870,49 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
 
   GST_TRACE ("shader created %u", shader->priv->program_handle);
 
+  cache_filename = _get_program_cache_filename (shader);
+  if (cache_filename && _load_program_binary (shader, cache_filename)) {
+    g_free (cache_filename);
+    ret = priv->linked = TRUE;
+    GST_OBJECT_UNLOCK (shader);
+
+    g_object_notify (G_OBJECT (shader), "linked");
+
+    return ret;
+  }
+
+  /* cache miss, compile the deferred stages */
+  while (priv->pending_stages) {
+    GstGLSLStage *stage = priv->pending_stages->data;
+
+    priv->pending_stages =
+        g_list_delete_link (priv->pending_stages, priv->pending_stages);
+
+    if (!gst_glsl_stage_compile (stage, error)) {
+      gst_object_unref (stage);
+      GST_OBJECT_UNLOCK (shader);
+      g_free (cache_filename);
+      return FALSE;
+    }
+
+    if (!gst_gl_shader_attach_unlocked (shader, stage)) {
+      g_set_error (error, GST_GLSL_ERROR, GST_GLSL_ERROR_COMPILE,
+          "Failed to attach shader %" GST_PTR_FORMAT "to program %"
+          GST_PTR_FORMAT, stage, shader);
+      gst_object_unref (stage);
+      GST_OBJECT_UNLOCK (shader);
+      g_free (cache_filename);
+      return FALSE;
+    }
+    gst_object_unref (stage);
+  }
+
   for (elem = shader->priv->stages; elem; elem = elem->next) {
     GstGLSLStage *stage = elem->data;
 
     if (!gst_glsl_stage_compile (stage, error)) {
       GST_OBJECT_UNLOCK (shader);
+      g_free (cache_filename);
       return FALSE;
     }
 
@@ -688,6 +921,7 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
           "Failed to attach shader %" GST_PTR_FORMAT "to program %"
           GST_PTR_FORMAT, stage, shader);
       GST_OBJECT_UNLOCK (shader);
+      g_free (cache_filename);
       return FALSE;
     }
   }
@@ -708,11 +942,17 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
         "Shader Linking failed:\n%s", info_buffer);
     ret = priv->linked = FALSE;
     GST_OBJECT_UNLOCK (shader);
+    g_free (cache_filename);
     return ret;
   } else if (len > 1) {
     GST_FIXME ("shader link log:\n%s", info_buffer);
   }
 
+  if (cache_filename) {
+    _save_program_binary (shader, cache_filename);
+    g_free (cache_filename);
+  }
+
   ret = priv->linked = TRUE;
   GST_OBJECT_UNLOCK (shader);
 
@@ -752,6 +992,9 @@ gst_gl_shader_release_unlocked (GstGLShader * shader)
   g_list_free_full (shader->priv->stages, (GDestroyNotify) gst_object_unref);
   shader->priv->stages = NULL;
 
+  g_list_free_full (priv->pending_stages, (GDestroyNotify) gst_object_unref);
+  priv->pending_stages = NULL;
+
   priv->linked = FALSE;
   g_hash_table_remove_all (priv->uniform_locations);
 
@@ -1306,6 +1549,9 @@ gst_gl_shader_bind_attribute_location (GstGLShader * shader, GLuint index,
 
   shader->context->gl_vtable->BindAttribLocation (shader->priv->program_handle,
       index, name);
+
+  g_string_append_printf (shader->priv->attribute_bindings, "%u:%s;", index,
+      name);
 }
 
 /**
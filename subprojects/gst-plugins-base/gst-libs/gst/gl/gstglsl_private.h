@@ -63,6 +63,8 @@ G_GNUC_INTERNAL gchar *
 _gst_glsl_mangle_shader (const gchar * str, guint shader_type, GstGLTextureTarget from,
     GstGLTextureTarget to, GstGLContext * context, GstGLSLVersion * version, GstGLSLProfile * profile);
 
+G_GNUC_INTERNAL void _gst_glsl_stage_checksum_update (GstGLSLStage * stage, GChecksum * checksum);
+
 G_END_DECLS
 
 #endif /* __GST_GLSL_PRIVATE_H__ */
@@ -565,3 +565,21 @@ gst_glsl_stage_compile (GstGLSLStage * stage, GError ** error)
 
   return data.result;
 }
+
+/* hashes everything that influences the compiled result of @stage */
+void
+_gst_glsl_stage_checksum_update (GstGLSLStage * stage, GChecksum * checksum)
+{
+  guint32 header[3];
+  gint i;
+
+  header[0] = stage->priv->type;
+  header[1] = stage->priv->version;
+  header[2] = stage->priv->profile;
+  g_checksum_update (checksum, (const guchar *) header, sizeof (header));
+
+  for (i = 0; i < stage->priv->n_strings; i++) {
+    g_checksum_update (checksum, (const guchar *) stage->priv->strings[i], -1);
+    g_checksum_update (checksum, (const guchar *) "", 1);
+  }
+}
@@ -144,10 +144,26 @@ struct _GstDiscovererPrivate
   gulong source_chg_id;
   gulong element_added_id;
   gulong bus_cb_id;
+  gulong autoplug_continue_id;
 
   gboolean use_cache;
+  gboolean headers_only;
+
+  /* Parallel discovery in async mode, see the max-parallel property */
+  guint max_parallel;
+  GPtrArray *workers;
+  GSource *dispatch_source;
+  gboolean workers_running;
 };
 
+/* A child discoverer running one URI at a time for its parent */
+typedef struct
+{
+  GstDiscoverer *parent;
+  GstDiscoverer *dc;
+  gboolean busy;
+} DiscovererWorker;
+
 #define DISCO_LOCK(dc) g_mutex_lock (&dc->priv->lock);
 #define DISCO_UNLOCK(dc) g_mutex_unlock (&dc->priv->lock);
 
@@ -180,12 +196,16 @@ enum
 
 #define DEFAULT_PROP_TIMEOUT 15 * GST_SECOND
 #define DEFAULT_PROP_USE_CACHE FALSE
+#define DEFAULT_PROP_MAX_PARALLEL 1
+#define DEFAULT_PROP_HEADERS_ONLY FALSE
 
 enum
 {
   PROP_0,
   PROP_TIMEOUT,
-  PROP_USE_CACHE
+  PROP_USE_CACHE,
+  PROP_MAX_PARALLEL,
+  PROP_HEADERS_ONLY
 };
 
 static guint gst_discoverer_signals[LAST_SIGNAL] = { 0 };
@@ -204,6 +224,8 @@ static void uridecodebin_no_more_pads_cb (GstElement * uridecodebin,
     GstDiscoverer * dc);
 static void uridecodebin_source_changed_cb (GstElement * uridecodebin,
     GParamSpec * pspec, GstDiscoverer * dc);
+static gboolean uridecodebin_autoplug_continue_cb (GstElement * uridecodebin,
+    GstPad * pad, GstCaps * caps, GstDiscoverer * dc);
 
 static void gst_discoverer_dispose (GObject * dc);
 static void gst_discoverer_finalize (GObject * dc);
@@ -264,6 +286,46 @@ gst_discoverer_class_init (GstDiscovererClass * klass)
           DEFAULT_PROP_USE_CACHE,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDiscoverer:max-parallel:
+   *
+   * The maximum number of URIs discovered concurrently in asynchronous mode.
+   *
+   * When bigger than 1, gst_discoverer_start() creates that many internal
+   * discovery pipelines, each of them being reused from one URI to the next.
+   * URIs queued with gst_discoverer_discover_uri_async() are handed to the
+   * first idle pipeline, so #GstDiscoverer::discovered is not necessarily
+   * emitted in the order the URIs were queued.
+   *
+   * Changing this property only has an effect on the next
+   * gst_discoverer_start(). Synchronous discovery is not affected.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_PARALLEL,
+      g_param_spec_uint ("max-parallel", "Max parallel",
+          "Maximum number of URIs discovered concurrently in async mode",
+          1, 256, DEFAULT_PROP_MAX_PARALLEL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDiscoverer:headers-only:
+   *
+   * Stop plugging elements once a stream has been parsed instead of
+   * decoding it. This makes discovery much cheaper, at the cost of only
+   * reporting the information that is available in the parsed caps (for
+   * example the bit depth of raw video will be missing).
+   *
+   * Results of such discoveries are not written to the cache.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_HEADERS_ONLY,
+      g_param_spec_boolean ("headers-only", "Headers only",
+          "Do not decode streams, only parse them",
+          DEFAULT_PROP_HEADERS_ONLY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /* signals */
   /**
    * GstDiscoverer::finished:
@@ -350,6 +412,8 @@ gst_discoverer_init (GstDiscoverer * dc)
 
   dc->priv->timeout = DEFAULT_PROP_TIMEOUT;
   dc->priv->use_cache = DEFAULT_PROP_USE_CACHE;
+  dc->priv->max_parallel = DEFAULT_PROP_MAX_PARALLEL;
+  dc->priv->headers_only = DEFAULT_PROP_HEADERS_ONLY;
   dc->priv->async = FALSE;
 
   g_mutex_init (&dc->priv->lock);
@@ -387,6 +451,9 @@ gst_discoverer_init (GstDiscoverer * dc)
   dc->priv->source_chg_id =
       g_signal_connect_object (dc->priv->uridecodebin, "notify::source",
       G_CALLBACK (uridecodebin_source_changed_cb), dc, 0);
+  dc->priv->autoplug_continue_id =
+      g_signal_connect_object (dc->priv->uridecodebin, "autoplug-continue",
+      G_CALLBACK (uridecodebin_autoplug_continue_cb), dc, 0);
 
   GST_LOG_OBJECT (dc, "Getting pipeline bus");
   dc->priv->bus = gst_pipeline_get_bus ((GstPipeline *) dc->priv->pipeline);
@@ -448,6 +515,7 @@ gst_discoverer_dispose (GObject * obj)
     DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->no_more_pads_id);
     DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->source_chg_id);
     DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->element_added_id);
+    DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->autoplug_continue_id);
     DISCONNECT_SIGNAL (dc->priv->bus, dc->priv->bus_cb_id);
 
     /* pipeline was set to NULL in _reset */
@@ -495,6 +563,16 @@ gst_discoverer_set_property (GObject * object, guint prop_id,
       dc->priv->use_cache = g_value_get_boolean (value);
       DISCO_UNLOCK (dc);
       break;
+    case PROP_MAX_PARALLEL:
+      DISCO_LOCK (dc);
+      dc->priv->max_parallel = g_value_get_uint (value);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_HEADERS_ONLY:
+      DISCO_LOCK (dc);
+      dc->priv->headers_only = g_value_get_boolean (value);
+      DISCO_UNLOCK (dc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -518,6 +596,16 @@ gst_discoverer_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, dc->priv->use_cache);
       DISCO_UNLOCK (dc);
       break;
+    case PROP_MAX_PARALLEL:
+      DISCO_LOCK (dc);
+      g_value_set_uint (value, dc->priv->max_parallel);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_HEADERS_ONLY:
+      DISCO_LOCK (dc);
+      g_value_set_boolean (value, dc->priv->headers_only);
+      DISCO_UNLOCK (dc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -763,6 +851,33 @@ uridecodebin_no_more_pads_cb (GstElement * uridecodebin, GstDiscoverer * dc)
   DISCO_UNLOCK (dc);
 }
 
+static gboolean
+uridecodebin_autoplug_continue_cb (GstElement * uridecodebin, GstPad * pad,
+    GstCaps * caps, GstDiscoverer * dc)
+{
+  GstStructure *st;
+  gboolean headers_only, parsed = FALSE, framed = FALSE;
+
+  DISCO_LOCK (dc);
+  headers_only = dc->priv->headers_only;
+  DISCO_UNLOCK (dc);
+
+  if (!headers_only || gst_caps_get_size (caps) == 0)
+    return TRUE;
+
+  /* Parsed streams carry all the information we can report without
+   * decoding them, expose them as-is */
+  st = gst_caps_get_structure (caps, 0);
+  gst_structure_get_boolean (st, "parsed", &parsed);
+  gst_structure_get_boolean (st, "framed", &framed);
+  if (parsed || framed) {
+    GST_DEBUG_OBJECT (dc, "Not decoding %" GST_PTR_FORMAT, caps);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 static void
 uridecodebin_pad_removed_cb (GstElement * uridecodebin, GstPad * pad,
     GstDiscoverer * dc)
@@ -1509,7 +1624,8 @@ discoverer_collect (GstDiscoverer * dc)
     }
   }
 
-  if (dc->priv->use_cache && dc->priv->current_info->cachefile &&
+  if (dc->priv->use_cache && !dc->priv->headers_only &&
+      dc->priv->current_info->cachefile &&
       dc->priv->current_info->result == GST_DISCOVERER_OK) {
     GVariant *variant = gst_discoverer_info_to_variant (dc->priv->current_info,
         GST_DISCOVERER_SERIALIZE_ALL);
@@ -2425,6 +2541,172 @@ out:
   return sinfo;
 }
 
+/* Parallel discovery */
+
+static void
+worker_free (DiscovererWorker * worker)
+{
+  g_signal_handlers_disconnect_matched (worker->dc, G_SIGNAL_MATCH_DATA, 0, 0,
+      NULL, NULL, worker);
+  gst_discoverer_stop (worker->dc);
+  g_object_unref (worker->dc);
+  g_free (worker);
+}
+
+/* Hands pending URIs to idle workers, emits finished once all of them are
+ * idle and there is nothing left to do */
+static gboolean
+dispatch_to_workers (GstDiscoverer * dc)
+{
+  gboolean busy = FALSE;
+  guint i;
+
+  DISCO_LOCK (dc);
+  if (dc->priv->dispatch_source) {
+    g_source_unref (dc->priv->dispatch_source);
+    dc->priv->dispatch_source = NULL;
+  }
+  DISCO_UNLOCK (dc);
+
+  if (!dc->priv->workers)
+    return G_SOURCE_REMOVE;
+
+  for (i = 0; i < dc->priv->workers->len; i++) {
+    DiscovererWorker *worker = g_ptr_array_index (dc->priv->workers, i);
+    gchar *uri = NULL;
+
+    if (!worker->busy) {
+      DISCO_LOCK (dc);
+      if (dc->priv->pending_uris) {
+        uri = dc->priv->pending_uris->data;
+        dc->priv->pending_uris =
+            g_list_delete_link (dc->priv->pending_uris,
+            dc->priv->pending_uris);
+      }
+      DISCO_UNLOCK (dc);
+
+      if (uri) {
+        if (!dc->priv->workers_running) {
+          dc->priv->workers_running = TRUE;
+          g_signal_emit (dc, gst_discoverer_signals[SIGNAL_STARTING], 0);
+        }
+
+        GST_DEBUG_OBJECT (dc, "Handing %s to worker %u", uri, i);
+        worker->busy = TRUE;
+        gst_discoverer_discover_uri_async (worker->dc, uri);
+        g_free (uri);
+      }
+    }
+
+    busy |= worker->busy;
+  }
+
+  if (!busy && dc->priv->workers_running) {
+    dc->priv->workers_running = FALSE;
+    g_signal_emit (dc, gst_discoverer_signals[SIGNAL_FINISHED], 0);
+  }
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_dispatch_to_workers (GstDiscoverer * dc)
+{
+  GSource *source;
+
+  DISCO_LOCK (dc);
+  if (!dc->priv->dispatch_source) {
+    source = g_idle_source_new ();
+    g_source_set_callback (source, (GSourceFunc) dispatch_to_workers,
+        gst_object_ref (dc), gst_object_unref);
+    g_source_attach (source, dc->priv->ctx);
+    dc->priv->dispatch_source = source;
+  }
+  DISCO_UNLOCK (dc);
+}
+
+static void
+worker_discovered_cb (GstDiscoverer * worker_dc, GstDiscovererInfo * info,
+    GError * err, DiscovererWorker * worker)
+{
+  GstDiscoverer *dc = worker->parent;
+
+  g_signal_emit (dc, gst_discoverer_signals[SIGNAL_DISCOVERED], 0, info, err);
+
+  /* The worker is still wrapping up the current URI at this point, so feed
+   * it the next one from the main loop */
+  worker->busy = FALSE;
+  schedule_dispatch_to_workers (dc);
+}
+
+static void
+worker_source_setup_cb (GstDiscoverer * worker_dc, GstElement * source,
+    DiscovererWorker * worker)
+{
+  g_signal_emit (worker->parent, gst_discoverer_signals[SIGNAL_SOURCE_SETUP],
+      0, source);
+}
+
+static gboolean
+start_workers (GstDiscoverer * dc)
+{
+  guint i, n_workers;
+  GstClockTime timeout;
+  gboolean use_cache, headers_only;
+
+  DISCO_LOCK (dc);
+  n_workers = dc->priv->max_parallel;
+  timeout = dc->priv->timeout;
+  use_cache = dc->priv->use_cache;
+  headers_only = dc->priv->headers_only;
+  DISCO_UNLOCK (dc);
+
+  if (n_workers < 2)
+    return FALSE;
+
+  GST_DEBUG_OBJECT (dc, "Starting %u workers", n_workers);
+
+  dc->priv->workers =
+      g_ptr_array_new_with_free_func ((GDestroyNotify) worker_free);
+  for (i = 0; i < n_workers; i++) {
+    DiscovererWorker *worker = g_new0 (DiscovererWorker, 1);
+
+    /* The parent outlives its workers, no need for a ref */
+    worker->parent = dc;
+    worker->dc = g_object_new (GST_TYPE_DISCOVERER, "timeout", timeout,
+        "use-cache", use_cache, "headers-only", headers_only, NULL);
+    g_signal_connect (worker->dc, "discovered",
+        G_CALLBACK (worker_discovered_cb), worker);
+    g_signal_connect (worker->dc, "source-setup",
+        G_CALLBACK (worker_source_setup_cb), worker);
+    gst_discoverer_start (worker->dc);
+
+    g_ptr_array_add (dc->priv->workers, worker);
+  }
+
+  schedule_dispatch_to_workers (dc);
+
+  return TRUE;
+}
+
+static void
+stop_workers (GstDiscoverer * dc)
+{
+  DISCO_LOCK (dc);
+  if (dc->priv->dispatch_source) {
+    g_source_destroy (dc->priv->dispatch_source);
+    g_source_unref (dc->priv->dispatch_source);
+    dc->priv->dispatch_source = NULL;
+  }
+  DISCO_UNLOCK (dc);
+
+  if (dc->priv->workers) {
+    g_ptr_array_unref (dc->priv->workers);
+    dc->priv->workers = NULL;
+  }
+  dc->priv->workers_running = FALSE;
+}
+
 /**
  * gst_discoverer_start:
  * @discoverer: A #GstDiscoverer
@@ -2464,7 +2746,8 @@ gst_discoverer_start (GstDiscoverer * discoverer)
   discoverer->priv->bus_source = source;
   discoverer->priv->ctx = g_main_context_ref (ctx);
 
-  start_discovering (discoverer);
+  if (!start_workers (discoverer))
+    start_discovering (discoverer);
   GST_DEBUG_OBJECT (discoverer, "Started");
 }
 
@@ -2514,6 +2797,7 @@ gst_discoverer_stop (GstDiscoverer * discoverer)
     g_source_unref (discoverer->priv->bus_source);
     discoverer->priv->bus_source = NULL;
   }
+  stop_workers (discoverer);
   /* Unref main context */
   if (discoverer->priv->ctx) {
     g_main_context_unref (discoverer->priv->ctx);
@@ -2557,7 +2841,9 @@ gst_discoverer_discover_uri_async (GstDiscoverer * discoverer,
       g_list_append (discoverer->priv->pending_uris, g_strdup (uri));
   DISCO_UNLOCK (discoverer);
 
-  if (can_run)
+  if (discoverer->priv->workers)
+    schedule_dispatch_to_workers (discoverer);
+  else if (can_run)
     start_discovering (discoverer);
 
   return TRUE;
@@ -0,0 +1,817 @@
+/* GStreamer
+ *
+ * gstqoscontroller.c: QoS driven degradation of pipelines
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gstqoscontroller
+ * @title: GstQosController
+ * @short_description: Degrade live pipelines gracefully under CPU pressure
+ *
+ * The elements of a pipeline react to QoS on their own, mostly by dropping
+ * late frames. #GstQosController instead aggregates the QoS messages posted on
+ * the bus of a pipeline and, when the pipeline cannot keep up, drives
+ * degradation knobs registered by the application: properties of elements
+ * that trade quality for processing time, like the preset of an encoder, the
+ * `skip-loop-filter` property of the libav video decoders or the caps of a
+ * capsfilter limiting the output framerate of a mixer.
+ *
+ * Each knob has a list of levels, from the normal value to the most degraded
+ * one, and a priority. The knobs with the lowest priority are degraded first
+ * and restored last.
+ *
+ * The pipeline is degraded by one step when the share of dropped buffers
+ * exceeds #GstQosController:degrade-threshold or the jitter reported by the
+ * sinks exceeds #GstQosController:max-jitter for
+ * #GstQosController:degrade-intervals consecutive intervals. It is restored by
+ * one step when buffers are on time and the share of dropped buffers is below
+ * #GstQosController:recover-threshold for #GstQosController:recover-intervals
+ * consecutive intervals. The different thresholds and the longer recovery
+ * period avoid oscillating between two levels.
+ *
+ * QoS messages are only posted by elements with QoS enabled, e.g. sinks with
+ * the `qos` property set to %TRUE.
+ *
+ * |[<!-- language="C" -->
+ * GstQosController *controller =
+ *     gst_qos_controller_new (GST_PIPELINE (pipeline));
+ * GValue levels = G_VALUE_INIT;
+ *
+ * g_value_init (&levels, GST_TYPE_ARRAY);
+ * gst_value_deserialize (&levels, "< default, non-ref, all >");
+ * gst_qos_controller_add_knob (controller, decoder, "skip-loop-filter", 0,
+ *     &levels);
+ * g_value_unset (&levels);
+ *
+ * g_value_init (&levels, GST_TYPE_ARRAY);
+ * gst_value_deserialize (&levels, "< medium, faster, ultrafast >");
+ * gst_qos_controller_add_knob (controller, encoder, "speed-preset", 1,
+ *     &levels);
+ * g_value_unset (&levels);
+ * ]|
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstqoscontroller.h"
+
+GST_DEBUG_CATEGORY_STATIC (qos_controller_debug);
+#define GST_CAT_DEFAULT qos_controller_debug
+
+#define DEFAULT_INTERVAL (GST_SECOND)
+#define DEFAULT_DEGRADE_THRESHOLD 0.05
+#define DEFAULT_RECOVER_THRESHOLD 0.0
+#define DEFAULT_MAX_JITTER (20 * GST_MSECOND)
+#define DEFAULT_DEGRADE_INTERVALS 2
+#define DEFAULT_RECOVER_INTERVALS 10
+
+enum
+{
+  PROP_0,
+  PROP_PIPELINE,
+  PROP_INTERVAL,
+  PROP_DEGRADE_THRESHOLD,
+  PROP_RECOVER_THRESHOLD,
+  PROP_MAX_JITTER,
+  PROP_DEGRADE_INTERVALS,
+  PROP_RECOVER_INTERVALS,
+  PROP_LEVEL,
+};
+
+typedef struct
+{
+  GWeakRef element;
+  gchar *property_name;
+  gint priority;
+  /* the values of the property, from normal to most degraded */
+  GValue *levels;
+  guint n_levels;
+  guint level;
+} GstQosKnob;
+
+typedef struct
+{
+  /* the element posting the QoS messages, the stats are keyed by its
+   * address, which may be reused once it is gone */
+  GWeakRef source;
+  guint64 processed;
+  guint64 dropped;
+} GstQosSourceStats;
+
+struct _GstQosController
+{
+  GstObject parent;
+
+  GWeakRef pipeline;
+  GstBus *bus;
+  gulong sync_message_id;
+
+  GstClock *clock;
+  GstClockID clock_id;
+
+  /* properties, protected by the object lock */
+  GstClockTime interval;
+  gdouble degrade_threshold;
+  gdouble recover_threshold;
+  gint64 max_jitter;
+  guint degrade_intervals;
+  guint recover_intervals;
+
+  /* protected by the object lock */
+  GList *knobs;
+  guint level;
+
+  /* statistics of the current interval, protected by the object lock */
+  GHashTable *sources;
+  guint64 processed;
+  guint64 dropped;
+  gint64 jitter;
+  gboolean have_jitter;
+
+  guint overloaded_count;
+  guint healthy_count;
+};
+
+struct _GstQosControllerClass
+{
+  GstObjectClass parent_class;
+};
+
+#define gst_qos_controller_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstQosController, gst_qos_controller,
+    GST_TYPE_OBJECT, GST_DEBUG_CATEGORY_INIT (qos_controller_debug,
+        "qoscontroller", 0, "QoS controller"));
+
+static GParamSpec *level_pspec;
+
+static void
+gst_qos_knob_free (GstQosKnob * knob)
+{
+  guint i;
+
+  g_weak_ref_clear (&knob->element);
+  g_free (knob->property_name);
+  for (i = 0; i < knob->n_levels; i++)
+    g_value_unset (&knob->levels[i]);
+  g_free (knob->levels);
+  g_free (knob);
+}
+
+static void
+gst_qos_source_stats_free (GstQosSourceStats * stats)
+{
+  g_weak_ref_clear (&stats->source);
+  g_free (stats);
+}
+
+/* returns TRUE for the stats of elements that are gone, the others are
+ * collected in @alive to be unreffed without holding the lock */
+static gboolean
+source_is_gone (gpointer key, GstQosSourceStats * stats, GList ** alive)
+{
+  GObject *source = g_weak_ref_get (&stats->source);
+
+  if (!source)
+    return TRUE;
+
+  *alive = g_list_prepend (*alive, source);
+  return FALSE;
+}
+
+static gint
+compare_knobs (gconstpointer a, gconstpointer b)
+{
+  const GstQosKnob *ka = a, *kb = b;
+
+  return ka->priority - kb->priority;
+}
+
+static void
+on_qos_message (GstBus * bus, GstMessage * message, GstQosController * self)
+{
+  GstQosSourceStats *stats;
+  GstFormat format;
+  guint64 processed, dropped;
+  gint64 jitter;
+  gdouble proportion;
+  gint quality;
+
+  gst_message_parse_qos_values (message, &jitter, &proportion, &quality);
+  gst_message_parse_qos_stats (message, &format, &processed, &dropped);
+
+  GST_LOG_OBJECT (self, "QoS from %s: jitter %" G_GINT64_FORMAT
+      ", processed %" G_GUINT64_FORMAT ", dropped %" G_GUINT64_FORMAT,
+      GST_MESSAGE_SRC_NAME (message), jitter, processed, dropped);
+
+  GST_OBJECT_LOCK (self);
+  if (!self->have_jitter || jitter > self->jitter) {
+    self->jitter = jitter;
+    self->have_jitter = TRUE;
+  }
+
+  /* the counters are cumulative per element, -1 when unknown */
+  if (processed != (guint64) - 1 && dropped != (guint64) - 1) {
+    GstObject *src = GST_MESSAGE_SRC (message);
+    GObject *source = NULL;
+
+    stats = g_hash_table_lookup (self->sources, src);
+    if (!stats) {
+      stats = g_new0 (GstQosSourceStats, 1);
+      g_weak_ref_init (&stats->source, src);
+      g_hash_table_insert (self->sources, src, stats);
+    } else if ((source = g_weak_ref_get (&stats->source)) != (GObject *) src) {
+      /* a new element at the address of one that is gone */
+      g_weak_ref_set (&stats->source, src);
+      stats->processed = stats->dropped = 0;
+    }
+    /* never the last reference, the message holds one to src */
+    if (source)
+      g_object_unref (source);
+
+    if (processed >= stats->processed && dropped >= stats->dropped) {
+      self->processed += processed - stats->processed;
+      self->dropped += dropped - stats->dropped;
+    }
+    stats->processed = processed;
+    stats->dropped = dropped;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+/* Finds the first knob that can still be degraded one level down, or the
+ * last degraded knob one level up, and stores its new level in @level. The
+ * levels are only updated once the value got applied. Call with the object
+ * lock held */
+static GstQosKnob *
+step_knobs (GstQosController * self, gboolean degrade, guint * level)
+{
+  GList *node;
+
+  if (degrade) {
+    for (node = self->knobs; node; node = node->next) {
+      GstQosKnob *knob = node->data;
+
+      if (knob->level + 1 < knob->n_levels) {
+        *level = knob->level + 1;
+        return knob;
+      }
+    }
+  } else {
+    for (node = g_list_last (self->knobs); node; node = node->prev) {
+      GstQosKnob *knob = node->data;
+
+      if (knob->level > 0) {
+        *level = knob->level - 1;
+        return knob;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+static void
+free_weak_ref (GWeakRef * ref)
+{
+  g_weak_ref_clear (ref);
+  g_free (ref);
+}
+
+static gboolean
+evaluate (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  GstQosController *self;
+  GstQosKnob *knob = NULL;
+  GstElement *element = NULL;
+  GValue value = G_VALUE_INIT;
+  gchar *property_name = NULL;
+  gdouble drop_ratio = 0.0;
+  gboolean overloaded, healthy, degrade = FALSE;
+  GList *alive = NULL;
+  guint level = 0;
+
+  /* dispose can't wait for a running callback, so only a weak reference is
+   * passed to the clock */
+  self = g_weak_ref_get (user_data);
+  if (!self)
+    return TRUE;
+
+  GST_OBJECT_LOCK (self);
+  g_hash_table_foreach_remove (self->sources, (GHRFunc) source_is_gone,
+      &alive);
+
+  if (self->processed + self->dropped > 0)
+    drop_ratio = (gdouble) self->dropped / (self->processed + self->dropped);
+
+  overloaded = drop_ratio > self->degrade_threshold ||
+      (self->have_jitter && self->jitter > self->max_jitter);
+  healthy = drop_ratio <= self->recover_threshold &&
+      (!self->have_jitter || self->jitter <= 0);
+
+  GST_DEBUG_OBJECT (self, "dropped %.1f%%, max jitter %" G_GINT64_FORMAT
+      ", overloaded %d, healthy %d", drop_ratio * 100.0,
+      self->have_jitter ? self->jitter : 0, overloaded, healthy);
+
+  self->processed = self->dropped = 0;
+  self->have_jitter = FALSE;
+
+  if (overloaded) {
+    self->healthy_count = 0;
+    if (++self->overloaded_count >= self->degrade_intervals) {
+      self->overloaded_count = 0;
+      degrade = TRUE;
+      knob = step_knobs (self, TRUE, &level);
+    }
+  } else if (healthy) {
+    self->overloaded_count = 0;
+    if (++self->healthy_count >= self->recover_intervals) {
+      self->healthy_count = 0;
+      knob = step_knobs (self, FALSE, &level);
+    }
+  } else {
+    self->overloaded_count = self->healthy_count = 0;
+  }
+
+  if (knob) {
+    element = g_weak_ref_get (&knob->element);
+    property_name = g_strdup (knob->property_name);
+    g_value_init (&value, G_VALUE_TYPE (&knob->levels[level]));
+    g_value_copy (&knob->levels[level], &value);
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  g_list_free_full (alive, g_object_unref);
+
+  if (!knob) {
+    gst_object_unref (self);
+    return TRUE;
+  }
+
+  /* the element may post QoS messages synchronously while being reconfigured,
+   * so don't hold the lock */
+  if (element) {
+    gchar *str = gst_value_serialize (&value);
+
+    GST_INFO_OBJECT (self, "setting %s:%s to %s", GST_ELEMENT_NAME (element),
+        property_name, str);
+    g_free (str);
+
+    g_object_set_property (G_OBJECT (element), property_name, &value);
+    gst_object_unref (element);
+  }
+  g_value_unset (&value);
+  g_free (property_name);
+
+  /* only publish the level once it is applied. Knobs are never removed and
+   * only changed from here, so @knob is still valid */
+  GST_OBJECT_LOCK (self);
+  knob->level = level;
+  if (degrade)
+    self->level++;
+  else
+    self->level--;
+  GST_OBJECT_UNLOCK (self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), level_pspec);
+  gst_object_unref (self);
+
+  return TRUE;
+}
+
+static void
+gst_qos_controller_constructed (GObject * object)
+{
+  GstQosController *self = GST_QOS_CONTROLLER (object);
+  GstElement *pipeline = g_weak_ref_get (&self->pipeline);
+  GWeakRef *ref;
+
+  G_OBJECT_CLASS (parent_class)->constructed (object);
+
+  if (!pipeline) {
+    g_critical ("GstQosController needs a pipeline");
+    return;
+  }
+
+  /* sync messages don't interfere with the bus watch of the application */
+  self->bus = gst_element_get_bus (pipeline);
+  gst_bus_enable_sync_message_emission (self->bus);
+  self->sync_message_id = g_signal_connect (self->bus, "sync-message::qos",
+      G_CALLBACK (on_qos_message), self);
+  gst_object_unref (pipeline);
+
+  self->clock = gst_system_clock_obtain ();
+  self->clock_id = gst_clock_new_periodic_id (self->clock,
+      gst_clock_get_time (self->clock) + self->interval, self->interval);
+  ref = g_new0 (GWeakRef, 1);
+  g_weak_ref_init (ref, self);
+  gst_clock_id_wait_async (self->clock_id, evaluate, ref,
+      (GDestroyNotify) free_weak_ref);
+}
+
+static void
+gst_qos_controller_dispose (GObject * object)
+{
+  GstQosController *self = GST_QOS_CONTROLLER (object);
+
+  if (self->clock_id) {
+    gst_clock_id_unschedule (self->clock_id);
+    gst_clock_id_unref (self->clock_id);
+    self->clock_id = NULL;
+  }
+  gst_clear_object (&self->clock);
+
+  if (self->bus) {
+    g_signal_handler_disconnect (self->bus, self->sync_message_id);
+    gst_bus_disable_sync_message_emission (self->bus);
+    gst_clear_object (&self->bus);
+  }
+
+  G_OBJECT_CLASS (parent_class)->dispose (object);
+}
+
+static void
+gst_qos_controller_finalize (GObject * object)
+{
+  GstQosController *self = GST_QOS_CONTROLLER (object);
+
+  g_weak_ref_clear (&self->pipeline);
+  g_list_free_full (self->knobs, (GDestroyNotify) gst_qos_knob_free);
+  g_hash_table_unref (self->sources);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_qos_controller_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstQosController *self = GST_QOS_CONTROLLER (object);
+
+  switch (prop_id) {
+    case PROP_PIPELINE:
+      g_weak_ref_set (&self->pipeline, g_value_get_object (value));
+      break;
+    case PROP_INTERVAL:
+      self->interval = g_value_get_uint64 (value);
+      break;
+    case PROP_DEGRADE_THRESHOLD:
+      GST_OBJECT_LOCK (self);
+      self->degrade_threshold = g_value_get_double (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_RECOVER_THRESHOLD:
+      GST_OBJECT_LOCK (self);
+      self->recover_threshold = g_value_get_double (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_MAX_JITTER:
+      GST_OBJECT_LOCK (self);
+      self->max_jitter = g_value_get_int64 (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_DEGRADE_INTERVALS:
+      GST_OBJECT_LOCK (self);
+      self->degrade_intervals = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_RECOVER_INTERVALS:
+      GST_OBJECT_LOCK (self);
+      self->recover_intervals = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_qos_controller_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstQosController *self = GST_QOS_CONTROLLER (object);
+
+  switch (prop_id) {
+    case PROP_PIPELINE:
+      g_value_take_object (value, g_weak_ref_get (&self->pipeline));
+      break;
+    case PROP_INTERVAL:
+      g_value_set_uint64 (value, self->interval);
+      break;
+    case PROP_DEGRADE_THRESHOLD:
+      GST_OBJECT_LOCK (self);
+      g_value_set_double (value, self->degrade_threshold);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_RECOVER_THRESHOLD:
+      GST_OBJECT_LOCK (self);
+      g_value_set_double (value, self->recover_threshold);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_MAX_JITTER:
+      GST_OBJECT_LOCK (self);
+      g_value_set_int64 (value, self->max_jitter);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_DEGRADE_INTERVALS:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint (value, self->degrade_intervals);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_RECOVER_INTERVALS:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint (value, self->recover_intervals);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_LEVEL:
+      g_value_set_uint (value, gst_qos_controller_get_level (self));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_qos_controller_class_init (GstQosControllerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->constructed = gst_qos_controller_constructed;
+  gobject_class->dispose = gst_qos_controller_dispose;
+  gobject_class->finalize = gst_qos_controller_finalize;
+  gobject_class->set_property = gst_qos_controller_set_property;
+  gobject_class->get_property = gst_qos_controller_get_property;
+
+  /**
+   * GstQosController:pipeline:
+   *
+   * The pipeline whose QoS messages are aggregated.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_PIPELINE,
+      g_param_spec_object ("pipeline", "Pipeline",
+          "The pipeline whose QoS messages are aggregated", GST_TYPE_PIPELINE,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQosController:interval:
+   *
+   * The interval over which QoS statistics are aggregated, in nanoseconds.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_INTERVAL,
+      g_param_spec_uint64 ("interval", "Interval",
+          "Interval over which QoS statistics are aggregated (in ns)",
+          GST_MSECOND, G_MAXUINT64, DEFAULT_INTERVAL,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQosController:degrade-threshold:
+   *
+   * The share of dropped buffers above which an interval is overloaded.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_DEGRADE_THRESHOLD,
+      g_param_spec_double ("degrade-threshold", "Degrade threshold",
+          "Share of dropped buffers above which an interval is overloaded",
+          0.0, 1.0, DEFAULT_DEGRADE_THRESHOLD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQosController:recover-threshold:
+   *
+   * The share of dropped buffers up to which an interval is healthy.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_RECOVER_THRESHOLD,
+      g_param_spec_double ("recover-threshold", "Recover threshold",
+          "Share of dropped buffers up to which an interval is healthy",
+          0.0, 1.0, DEFAULT_RECOVER_THRESHOLD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQosController:max-jitter:
+   *
+   * The jitter reported in QoS messages above which an interval is
+   * overloaded, in nanoseconds.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_JITTER,
+      g_param_spec_int64 ("max-jitter", "Maximum jitter",
+          "Jitter above which an interval is overloaded (in ns)",
+          0, G_MAXINT64, DEFAULT_MAX_JITTER,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQosController:degrade-intervals:
+   *
+   * The number of consecutive overloaded intervals after which the pipeline
+   * is degraded by one step.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_DEGRADE_INTERVALS,
+      g_param_spec_uint ("degrade-intervals", "Degrade intervals",
+          "Number of consecutive overloaded intervals before degrading",
+          1, G_MAXUINT, DEFAULT_DEGRADE_INTERVALS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQosController:recover-intervals:
+   *
+   * The number of consecutive healthy intervals after which the pipeline is
+   * restored by one step.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_RECOVER_INTERVALS,
+      g_param_spec_uint ("recover-intervals", "Recover intervals",
+          "Number of consecutive healthy intervals before recovering",
+          1, G_MAXUINT, DEFAULT_RECOVER_INTERVALS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQosController:level:
+   *
+   * The number of degradation steps currently applied to the knobs.
+   *
+   * Since: 1.22
+   */
+  level_pspec = g_param_spec_uint ("level", "Level",
+      "Number of degradation steps currently applied", 0, G_MAXUINT, 0,
+      G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+  g_object_class_install_property (gobject_class, PROP_LEVEL, level_pspec);
+}
+
+static void
+gst_qos_controller_init (GstQosController * self)
+{
+  g_weak_ref_init (&self->pipeline, NULL);
+
+  self->interval = DEFAULT_INTERVAL;
+  self->degrade_threshold = DEFAULT_DEGRADE_THRESHOLD;
+  self->recover_threshold = DEFAULT_RECOVER_THRESHOLD;
+  self->max_jitter = DEFAULT_MAX_JITTER;
+  self->degrade_intervals = DEFAULT_DEGRADE_INTERVALS;
+  self->recover_intervals = DEFAULT_RECOVER_INTERVALS;
+
+  /* only used as keys, the elements are never dereferenced. The stats of
+   * elements that are gone are removed in evaluate() */
+  self->sources = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) gst_qos_source_stats_free);
+}
+
+/**
+ * gst_qos_controller_new:
+ * @pipeline: a #GstPipeline
+ *
+ * Creates a controller aggregating the QoS messages posted on the bus of
+ * @pipeline. The controller doesn't keep @pipeline alive.
+ *
+ * Returns: (transfer full): a new #GstQosController
+ *
+ * Since: 1.22
+ */
+GstQosController *
+gst_qos_controller_new (GstPipeline * pipeline)
+{
+  GstQosController *controller;
+
+  g_return_val_if_fail (GST_IS_PIPELINE (pipeline), NULL);
+
+  controller = g_object_new (GST_TYPE_QOS_CONTROLLER, "pipeline", pipeline,
+      NULL);
+  gst_object_ref_sink (controller);
+
+  return controller;
+}
+
+/**
+ * gst_qos_controller_add_knob:
+ * @controller: a #GstQosController
+ * @element: the #GstElement to degrade
+ * @property_name: the name of a writable property of @element
+ * @priority: the priority of the knob, knobs with a lower priority are
+ *     degraded first and restored last
+ * @levels: a #GST_TYPE_ARRAY of values of @property_name, from the normal
+ *     value to the most degraded one
+ *
+ * Registers a degradation knob. The property is set to the first value of
+ * @levels, and to the following ones as the pipeline gets degraded. Values
+ * that are not of the type of the property, e.g. strings for enums, are
+ * converted with gst_value_deserialize().
+ *
+ * Returns: %TRUE if the knob was registered
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_qos_controller_add_knob (GstQosController * controller,
+    GstElement * element, const gchar * property_name, gint priority,
+    const GValue * levels)
+{
+  GParamSpec *pspec;
+  GstQosKnob *knob;
+  guint i;
+
+  g_return_val_if_fail (GST_IS_QOS_CONTROLLER (controller), FALSE);
+  g_return_val_if_fail (GST_IS_ELEMENT (element), FALSE);
+  g_return_val_if_fail (property_name != NULL, FALSE);
+  g_return_val_if_fail (GST_VALUE_HOLDS_ARRAY (levels), FALSE);
+  g_return_val_if_fail (gst_value_array_get_size (levels) > 0, FALSE);
+
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (element),
+      property_name);
+  if (!pspec || !(pspec->flags & G_PARAM_WRITABLE)) {
+    GST_WARNING_OBJECT (controller, "%s has no writable property %s",
+        GST_ELEMENT_NAME (element), property_name);
+    return FALSE;
+  }
+
+  knob = g_new0 (GstQosKnob, 1);
+  g_weak_ref_init (&knob->element, element);
+  knob->property_name = g_strdup (property_name);
+  knob->priority = priority;
+  knob->n_levels = gst_value_array_get_size (levels);
+  knob->levels = g_new0 (GValue, knob->n_levels);
+
+  for (i = 0; i < knob->n_levels; i++) {
+    const GValue *level = gst_value_array_get_value (levels, i);
+    gboolean ok;
+
+    g_value_init (&knob->levels[i], pspec->value_type);
+    if (G_VALUE_HOLDS_STRING (level) && pspec->value_type != G_TYPE_STRING)
+      ok = gst_value_deserialize (&knob->levels[i],
+          g_value_get_string (level));
+    else
+      ok = g_value_transform (level, &knob->levels[i]);
+
+    if (!ok) {
+      GST_WARNING_OBJECT (controller, "invalid level %u for %s:%s", i,
+          GST_ELEMENT_NAME (element), property_name);
+      knob->n_levels = i + 1;
+      gst_qos_knob_free (knob);
+      return FALSE;
+    }
+  }
+
+  g_object_set_property (G_OBJECT (element), property_name, &knob->levels[0]);
+
+  GST_OBJECT_LOCK (controller);
+  controller->knobs = g_list_insert_sorted (controller->knobs, knob,
+      compare_knobs);
+  GST_OBJECT_UNLOCK (controller);
+
+  return TRUE;
+}
+
+/**
+ * gst_qos_controller_get_level:
+ * @controller: a #GstQosController
+ *
+ * Returns: the number of degradation steps currently applied to the knobs,
+ *     0 when the pipeline runs at full quality
+ *
+ * Since: 1.22
+ */
+guint
+gst_qos_controller_get_level (GstQosController * controller)
+{
+  guint level;
+
+  g_return_val_if_fail (GST_IS_QOS_CONTROLLER (controller), 0);
+
+  GST_OBJECT_LOCK (controller);
+  level = controller->level;
+  GST_OBJECT_UNLOCK (controller);
+
+  return level;
+}
@@ -0,0 +1,59 @@
+/* GStreamer
+ *
+ * gstqoscontroller.h: QoS driven degradation of pipelines
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_QOS_CONTROLLER_H__
+#define __GST_QOS_CONTROLLER_H__
+
+#include <gst/gst.h>
+#include <gst/pbutils/pbutils-prelude.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_QOS_CONTROLLER \
+  (gst_qos_controller_get_type ())
+#define GST_QOS_CONTROLLER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_QOS_CONTROLLER,GstQosController))
+#define GST_IS_QOS_CONTROLLER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_QOS_CONTROLLER))
+
+typedef struct _GstQosController GstQosController;
+typedef struct _GstQosControllerClass GstQosControllerClass;
+
+GST_PBUTILS_API
+GType              gst_qos_controller_get_type (void);
+
+GST_PBUTILS_API
+GstQosController * gst_qos_controller_new (GstPipeline * pipeline);
+
+GST_PBUTILS_API
+gboolean           gst_qos_controller_add_knob (GstQosController * controller,
+                                                GstElement * element,
+                                                const gchar * property_name,
+                                                gint priority,
+                                                const GValue * levels);
+
+GST_PBUTILS_API
+guint              gst_qos_controller_get_level (GstQosController * controller);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstQosController, gst_object_unref)
+
+G_END_DECLS
+
+#endif /* __GST_QOS_CONTROLLER_H__ */
@@ -32,6 +32,7 @@
 #include <gst/pbutils/encoding-profile.h>
 #include <gst/pbutils/encoding-target.h>
 #include <gst/pbutils/gstaudiovisualizer.h>
+#include <gst/pbutils/gstqoscontroller.h>
 
 G_BEGIN_DECLS
 
@@ -78,6 +78,10 @@ struct _GstRTPBasePayloadPrivate
 
   /* array of GstRTPHeaderExtension's * */
   GPtrArray *header_exts;
+
+  gboolean access_unit_lists;
+  /* packets of the current access unit that were not pushed yet */
+  GstBufferList *au_list;
 };
 
 /* RTPBasePayload signals and args */
@@ -112,6 +116,7 @@ static guint gst_rtp_base_payload_signals[LAST_SIGNAL] = { 0 };
 #define DEFAULT_ONVIF_NO_RATE_CONTROL   FALSE
 #define DEFAULT_SCALE_RTPTIME           TRUE
 #define DEFAULT_AUTO_HEADER_EXTENSION   TRUE
+#define DEFAULT_ACCESS_UNIT_LISTS       FALSE
 
 #define RTP_HEADER_EXT_ONE_BYTE_MAX_SIZE 16
 #define RTP_HEADER_EXT_TWO_BYTE_MAX_SIZE 256
@@ -137,6 +142,7 @@ enum
   PROP_ONVIF_NO_RATE_CONTROL,
   PROP_SCALE_RTPTIME,
   PROP_AUTO_HEADER_EXTENSION,
+  PROP_ACCESS_UNIT_LISTS,
   PROP_LAST
 };
 
@@ -176,6 +182,8 @@ static gboolean gst_rtp_base_payload_negotiate (GstRTPBasePayload * payload);
 static void gst_rtp_base_payload_add_extension (GstRTPBasePayload * payload,
     GstRTPHeaderExtension * ext);
 static void gst_rtp_base_payload_clear_extensions (GstRTPBasePayload * payload);
+static GstFlowReturn gst_rtp_base_payload_finish_access_unit (GstRTPBasePayload
+    * payload);
 
 static GstElementClass *parent_class = NULL;
 static gint private_offset = 0;
@@ -442,6 +450,28 @@ gst_rtp_base_payload_class_init (GstRTPBasePayloadClass * klass)
           DEFAULT_AUTO_HEADER_EXTENSION,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTPBasePayload:access-unit-lists:
+   *
+   * Collect all packets of an access unit and push them downstream as one
+   * #GstBufferList, instead of pushing them as they are produced by the
+   * subclass. An access unit ends with a packet that has the marker bit set,
+   * or when a packet with a different RTP timestamp is pushed. Pending
+   * packets are also pushed before any serialized event.
+   *
+   * This allows sinks to send all packets of a video frame at once, e.g. with
+   * the "gso" property of udpsink. Payloaders that fragment an access unit
+   * into MTU sized packets produce runs of packets of the same size for it.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass),
+      PROP_ACCESS_UNIT_LISTS, g_param_spec_boolean ("access-unit-lists",
+          "Access unit lists",
+          "Push the packets of each access unit as one buffer list",
+          DEFAULT_ACCESS_UNIT_LISTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstRTPBasePayload::add-extension:
    * @object: the #GstRTPBasePayload
@@ -555,6 +585,7 @@ gst_rtp_base_payload_init (GstRTPBasePayload * rtpbasepayload, gpointer g_class)
   rtpbasepayload->priv->onvif_no_rate_control = DEFAULT_ONVIF_NO_RATE_CONTROL;
   rtpbasepayload->priv->scale_rtptime = DEFAULT_SCALE_RTPTIME;
   rtpbasepayload->priv->auto_hdr_ext = DEFAULT_AUTO_HEADER_EXTENSION;
+  rtpbasepayload->priv->access_unit_lists = DEFAULT_ACCESS_UNIT_LISTS;
 
   rtpbasepayload->media = NULL;
   rtpbasepayload->encoding_name = NULL;
@@ -614,6 +645,11 @@ gst_rtp_base_payload_sink_event_default (GstRTPBasePayload * rtpbasepayload,
   GstObject *parent = GST_OBJECT_CAST (rtpbasepayload);
   gboolean res = FALSE;
 
+  /* the packets of the current access unit go before any serialized event */
+  if (rtpbasepayload->priv->au_list && GST_EVENT_IS_SERIALIZED (event) &&
+      GST_EVENT_TYPE (event) != GST_EVENT_FLUSH_STOP)
+    gst_rtp_base_payload_finish_access_unit (rtpbasepayload);
+
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_FLUSH_START:
       res = gst_pad_event_default (rtpbasepayload->sinkpad, parent, event);
@@ -622,6 +658,7 @@ gst_rtp_base_payload_sink_event_default (GstRTPBasePayload * rtpbasepayload,
       res = gst_pad_event_default (rtpbasepayload->sinkpad, parent, event);
       gst_segment_init (&rtpbasepayload->segment, GST_FORMAT_UNDEFINED);
       gst_event_replace (&rtpbasepayload->priv->pending_segment, NULL);
+      g_clear_pointer (&rtpbasepayload->priv->au_list, gst_buffer_list_unref);
       break;
     case GST_EVENT_CAPS:
     {
@@ -1966,6 +2003,78 @@ no_rate:
   }
 }
 
+/* Pushes the packets collected for the current access unit, if any. */
+static GstFlowReturn
+gst_rtp_base_payload_finish_access_unit (GstRTPBasePayload * payload)
+{
+  GstBufferList *list = payload->priv->au_list;
+
+  if (list == NULL)
+    return GST_FLOW_OK;
+
+  payload->priv->au_list = NULL;
+
+  GST_LOG_OBJECT (payload, "pushing access unit of %u packets",
+      gst_buffer_list_length (list));
+
+  if (G_UNLIKELY (payload->priv->pending_segment)) {
+    gst_pad_push_event (payload->srcpad, payload->priv->pending_segment);
+    payload->priv->pending_segment = FALSE;
+    payload->priv->delay_segment = FALSE;
+  }
+
+  return gst_pad_push_list (payload->srcpad, list);
+}
+
+/* Adds the prepared buffer or list @obj to the current access unit. The
+ * access unit is pushed when it ends with a packet that has the marker bit
+ * set, or before @obj if @obj has a different RTP timestamp than the packets
+ * collected so far, which all have @prev_rtptime. */
+static GstFlowReturn
+gst_rtp_base_payload_collect (GstRTPBasePayload * payload, gpointer obj,
+    gboolean is_list, guint32 prev_rtptime)
+{
+  GstRTPBasePayloadPrivate *priv = payload->priv;
+  GstFlowReturn res = GST_FLOW_OK, last_res;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  gboolean marker = FALSE;
+  guint len;
+
+  if (priv->au_list && payload->timestamp != prev_rtptime)
+    res = gst_rtp_base_payload_finish_access_unit (payload);
+
+  if (priv->au_list == NULL)
+    priv->au_list = gst_buffer_list_new ();
+
+  if (is_list) {
+    GstBufferList *list = GST_BUFFER_LIST_CAST (obj);
+    guint i;
+
+    len = gst_buffer_list_length (list);
+    for (i = 0; i < len; i++)
+      gst_buffer_list_add (priv->au_list,
+          gst_buffer_ref (gst_buffer_list_get (list, i)));
+    gst_buffer_list_unref (list);
+  } else {
+    gst_buffer_list_add (priv->au_list, GST_BUFFER_CAST (obj));
+  }
+
+  len = gst_buffer_list_length (priv->au_list);
+  if (len > 0 && gst_rtp_buffer_map (gst_buffer_list_get (priv->au_list,
+              len - 1), GST_MAP_READ, &rtp)) {
+    marker = gst_rtp_buffer_get_marker (&rtp);
+    gst_rtp_buffer_unmap (&rtp);
+  }
+
+  if (marker) {
+    last_res = gst_rtp_base_payload_finish_access_unit (payload);
+    if (res == GST_FLOW_OK)
+      res = last_res;
+  }
+
+  return res;
+}
+
 /**
  * gst_rtp_base_payload_push_list:
  * @payload: a #GstRTPBasePayload
@@ -1983,10 +2092,20 @@ gst_rtp_base_payload_push_list (GstRTPBasePayload * payload,
     GstBufferList * list)
 {
   GstFlowReturn res;
+  guint32 rtptime = payload->timestamp;
 
   res = gst_rtp_base_payload_prepare_push (payload, list, TRUE);
 
   if (G_LIKELY (res == GST_FLOW_OK)) {
+    if (payload->priv->access_unit_lists)
+      return gst_rtp_base_payload_collect (payload, list, TRUE, rtptime);
+
+    res = gst_rtp_base_payload_finish_access_unit (payload);
+    if (G_UNLIKELY (res != GST_FLOW_OK)) {
+      gst_buffer_list_unref (list);
+      return res;
+    }
+
     if (G_UNLIKELY (payload->priv->pending_segment)) {
       gst_pad_push_event (payload->srcpad, payload->priv->pending_segment);
       payload->priv->pending_segment = FALSE;
@@ -2016,10 +2135,20 @@ GstFlowReturn
 gst_rtp_base_payload_push (GstRTPBasePayload * payload, GstBuffer * buffer)
 {
   GstFlowReturn res;
+  guint32 rtptime = payload->timestamp;
 
   res = gst_rtp_base_payload_prepare_push (payload, buffer, FALSE);
 
   if (G_LIKELY (res == GST_FLOW_OK)) {
+    if (payload->priv->access_unit_lists)
+      return gst_rtp_base_payload_collect (payload, buffer, FALSE, rtptime);
+
+    res = gst_rtp_base_payload_finish_access_unit (payload);
+    if (G_UNLIKELY (res != GST_FLOW_OK)) {
+      gst_buffer_unref (buffer);
+      return res;
+    }
+
     if (G_UNLIKELY (payload->priv->pending_segment)) {
       gst_pad_push_event (payload->srcpad, payload->priv->pending_segment);
       payload->priv->pending_segment = FALSE;
@@ -2172,6 +2301,9 @@ gst_rtp_base_payload_set_property (GObject * object, guint prop_id,
     case PROP_AUTO_HEADER_EXTENSION:
       priv->auto_hdr_ext = g_value_get_boolean (value);
       break;
+    case PROP_ACCESS_UNIT_LISTS:
+      priv->access_unit_lists = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2248,6 +2380,9 @@ gst_rtp_base_payload_get_property (GObject * object, guint prop_id,
     case PROP_AUTO_HEADER_EXTENSION:
       g_value_set_boolean (value, priv->auto_hdr_ext);
       break;
+    case PROP_ACCESS_UNIT_LISTS:
+      g_value_set_boolean (value, priv->access_unit_lists);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2310,6 +2445,7 @@ gst_rtp_base_payload_change_state (GstElement * element,
       break;
     case GST_STATE_CHANGE_PAUSED_TO_READY:
       gst_event_replace (&rtpbasepayload->priv->pending_segment, NULL);
+      g_clear_pointer (&rtpbasepayload->priv->au_list, gst_buffer_list_unref);
       break;
     default:
       break;
@@ -89,6 +89,15 @@ typedef struct
   guint coutl;
 } DecodeCtx;
 
+/* a chunk of data read from the socket in one go. Interleaved data messages
+ * reference it for their payload, so it is only reused once they are gone */
+typedef struct
+{
+  gint refcount;
+  guint size;
+  guint8 *data;
+} ReadChunk;
+
 typedef struct
 {
   /* If %TRUE we only own data and none of the
@@ -188,6 +197,12 @@ struct _GstRTSPConnection
   gchar *initial_buffer;
   gsize initial_buffer_offset;
 
+  /* buffered reads, see gst_rtsp_connection_set_read_buffer_size() */
+  guint read_buffer_size;
+  ReadChunk *read_chunk;
+  guint read_pos;               /* first unconsumed byte in read_chunk */
+  guint read_len;               /* valid bytes in read_chunk */
+
   gboolean remember_session_id; /* remember the session id or not */
 
   /* Session state */
@@ -1399,6 +1414,120 @@ writev_bytes (GOutputStream * stream, GOutputVector * vectors, gint n_vectors,
 }
 #endif
 
+static ReadChunk *
+read_chunk_new (guint size)
+{
+  ReadChunk *chunk = g_new (ReadChunk, 1);
+
+  chunk->refcount = 1;
+  chunk->size = size;
+  chunk->data = g_malloc (size);
+
+  return chunk;
+}
+
+static void
+read_chunk_unref (ReadChunk * chunk)
+{
+  if (g_atomic_int_dec_and_test (&chunk->refcount)) {
+    g_free (chunk->data);
+    g_free (chunk);
+  }
+}
+
+static void
+clear_read_chunk (GstRTSPConnection * conn)
+{
+  if (conn->read_chunk) {
+    read_chunk_unref (conn->read_chunk);
+    conn->read_chunk = NULL;
+  }
+  conn->read_pos = conn->read_len = 0;
+}
+
+static gssize
+read_stream (GstRTSPConnection * conn, guint8 * buffer, gsize count,
+    gboolean block, GError ** err)
+{
+  if (block)
+    return g_input_stream_read (conn->input_stream, (gchar *) buffer,
+        count, conn->may_cancel ? conn->cancellable : NULL, err);
+  else
+    return g_pollable_input_stream_read_nonblocking (G_POLLABLE_INPUT_STREAM
+        (conn->input_stream), (gchar *) buffer, count,
+        conn->may_cancel ? conn->cancellable : NULL, err);
+}
+
+/* serve @count bytes from the read chunk, refilling it with a single read of
+ * up to read_buffer_size bytes when it is empty */
+static gssize
+read_buffered (GstRTSPConnection * conn, guint8 * buffer, gsize count,
+    gboolean block, GError ** err)
+{
+  gsize avail = conn->read_len - conn->read_pos;
+
+  if (avail == 0) {
+    gssize r;
+
+    /* no point in copying twice */
+    if (count >= conn->read_buffer_size)
+      return read_stream (conn, buffer, count, block, err);
+
+    /* data messages might still reference the old chunk */
+    if (conn->read_chunk == NULL ||
+        conn->read_chunk->size != conn->read_buffer_size ||
+        g_atomic_int_get (&conn->read_chunk->refcount) > 1) {
+      clear_read_chunk (conn);
+      conn->read_chunk = read_chunk_new (conn->read_buffer_size);
+    }
+    conn->read_pos = conn->read_len = 0;
+
+    r = read_stream (conn, conn->read_chunk->data, conn->read_buffer_size,
+        block, err);
+    if (r <= 0)
+      return r;
+
+    conn->read_len = avail = r;
+  }
+
+  count = MIN (count, avail);
+  memcpy (buffer, &conn->read_chunk->data[conn->read_pos], count);
+  conn->read_pos += count;
+
+  return count;
+}
+
+/* wrap the next @size buffered bytes in a buffer without copying them, or
+ * return %NULL if they are not all buffered yet */
+static GstBuffer *
+take_buffered (GstRTSPConnection * conn, guint size)
+{
+  GstBuffer *buffer;
+
+  if (conn->read_chunk == NULL || conn->initial_buffer != NULL ||
+      conn->ctxp != NULL || conn->read_len - conn->read_pos < size)
+    return NULL;
+
+  /* don't keep a mostly empty chunk alive for as long as the payloads are
+   * used, nothing references it yet so it can still be moved */
+  if (g_atomic_int_get (&conn->read_chunk->refcount) == 1 &&
+      conn->read_len < conn->read_chunk->size / 2) {
+    conn->read_chunk->data = g_realloc (conn->read_chunk->data,
+        conn->read_len);
+    conn->read_chunk->size = conn->read_len;
+  }
+
+  g_atomic_int_inc (&conn->read_chunk->refcount);
+  buffer = gst_buffer_new ();
+  gst_buffer_append_memory (buffer,
+      gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY,
+          conn->read_chunk->data, conn->read_chunk->size, conn->read_pos, size,
+          conn->read_chunk, (GDestroyNotify) read_chunk_unref));
+  conn->read_pos += size;
+
+  return buffer;
+}
+
 static gint
 fill_raw_bytes (GstRTSPConnection * conn, guint8 * buffer, guint size,
     gboolean block, GError ** err)
@@ -1422,13 +1551,10 @@ fill_raw_bytes (GstRTSPConnection * conn, guint8 * buffer, guint size,
   if (G_LIKELY (size > (guint) out)) {
     gssize r;
     gsize count = size - out;
-    if (block)
-      r = g_input_stream_read (conn->input_stream, (gchar *) & buffer[out],
-          count, conn->may_cancel ? conn->cancellable : NULL, err);
+    if (conn->read_buffer_size > 0 || conn->read_pos < conn->read_len)
+      r = read_buffered (conn, &buffer[out], count, block, err);
     else
-      r = g_pollable_input_stream_read_nonblocking (G_POLLABLE_INPUT_STREAM
-          (conn->input_stream), (gchar *) & buffer[out], count,
-          conn->may_cancel ? conn->cancellable : NULL, err);
+      r = read_stream (conn, &buffer[out], count, block, err);
 
     if (G_UNLIKELY (r < 0)) {
       if (out == 0) {
@@ -2495,6 +2621,19 @@ build_next (GstRTSPBuilder * builder, GstRTSPMessage * message,
         gst_rtsp_message_init_data (message, builder->buffer[1]);
 
         builder->body_len = (builder->buffer[2] << 8) | builder->buffer[3];
+
+        if (conn->read_buffer_size > 0) {
+          GstBuffer *body = take_buffered (conn, builder->body_len);
+
+          /* the whole payload was read already, share it */
+          if (body) {
+            gst_rtsp_message_take_body_buffer (message, body);
+            builder->body_len = 0;
+            builder->state = STATE_END;
+            break;
+          }
+        }
+
         builder->body_data = g_malloc (builder->body_len + 1);
         builder->body_data[builder->body_len] = '\0';
         builder->offset = 0;
@@ -2892,6 +3031,8 @@ gst_rtsp_connection_close (GstRTSPConnection * conn)
   conn->initial_buffer = NULL;
   conn->initial_buffer_offset = 0;
 
+  clear_read_chunk (conn);
+
   conn->write_socket = NULL;
   conn->read_socket = NULL;
   conn->write_socket_used = FALSE;
@@ -2982,6 +3123,12 @@ gst_rtsp_connection_poll_usec (GstRTSPConnection * conn, GstRTSPEvent events,
   g_return_val_if_fail (conn->read_socket != NULL, GST_RTSP_EINVAL);
   g_return_val_if_fail (conn->write_socket != NULL, GST_RTSP_EINVAL);
 
+  /* buffered data can be read right away */
+  if ((events & GST_RTSP_EV_READ) && conn->read_pos < conn->read_len) {
+    *revents = GST_RTSP_EV_READ;
+    return GST_RTSP_OK;
+  }
+
   ctx = g_main_context_new ();
 
   /* configure timeout if any */
@@ -3383,6 +3530,36 @@ gst_rtsp_connection_set_content_length_limit (GstRTSPConnection * conn,
   conn->content_length_limit = limit;
 }
 
+/**
+ * gst_rtsp_connection_set_read_buffer_size:
+ * @conn: a #GstRTSPConnection
+ * @size: size of the read buffer in bytes, or 0 to disable buffering
+ *
+ * Configure @conn to read up to @size bytes from the socket at once and to
+ * serve subsequent reads from that buffer, which saves a few system calls per
+ * interleaved data message.
+ *
+ * Data messages that are completely buffered are returned by
+ * gst_rtsp_connection_receive() with a body buffer (see
+ * gst_rtsp_message_get_body_buffer()) that shares memory with the read
+ * buffer. Unlike the default body, it has no trailing '\0'.
+ *
+ * Buffered data is not dispatched by a #GstRTSPWatch, so this should only be
+ * enabled on connections that are read with gst_rtsp_connection_receive() or
+ * gst_rtsp_connection_read().
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_connection_set_read_buffer_size (GstRTSPConnection * conn,
+    guint size)
+{
+  g_return_if_fail (conn != NULL);
+
+  /* data that was already read is still served from the current chunk */
+  conn->read_buffer_size = size;
+}
+
 /**
  * gst_rtsp_connection_get_url:
  * @conn: a #GstRTSPConnection
@@ -3653,6 +3830,17 @@ gst_rtsp_connection_do_tunnel (GstRTSPConnection * conn,
     conn->initial_buffer = conn2->initial_buffer;
     conn2->initial_buffer = NULL;
     conn->initial_buffer_offset = conn2->initial_buffer_offset;
+
+    if (ts1 == TUNNEL_STATE_GET) {
+      /* anything buffered on the POST channel is ours now */
+      clear_read_chunk (conn);
+      conn->read_buffer_size = conn2->read_buffer_size;
+      conn->read_chunk = conn2->read_chunk;
+      conn->read_pos = conn2->read_pos;
+      conn->read_len = conn2->read_len;
+      conn2->read_chunk = NULL;
+      conn2->read_pos = conn2->read_len = 0;
+    }
   }
 
   /* we need base64 decoding for the readfd */
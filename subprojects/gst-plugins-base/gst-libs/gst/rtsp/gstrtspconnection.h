@@ -194,6 +194,11 @@ GST_RTSP_API
 void               gst_rtsp_connection_set_content_length_limit (GstRTSPConnection *conn,
                                                                  guint limit);
 
+/* buffered reads */
+GST_RTSP_API
+void               gst_rtsp_connection_set_read_buffer_size (GstRTSPConnection *conn,
+                                                             guint size);
+
 /* accessors */
 
 GST_RTSP_API
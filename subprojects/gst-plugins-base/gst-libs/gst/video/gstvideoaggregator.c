@@ -436,6 +436,9 @@ struct _GstVideoAggregatorConvertPadPrivate
   /* caps used for conversion if needed */
   GstVideoInfo conversion_info;
   GstBuffer *converted_buffer;
+  /* input buffer converted_buffer was converted from, kept so that a frame
+   * that is aggregated again doesn't need to be converted again */
+  GstBuffer *converted_input;
 
   /* The following fields are accessed from the property setters / getters,
    * and as such are protected with the object lock */
@@ -455,6 +458,9 @@ gst_video_aggregator_convert_pad_finalize (GObject * o)
     gst_video_converter_free (vaggpad->priv->convert);
   vaggpad->priv->convert = NULL;
 
+  gst_clear_buffer (&vaggpad->priv->converted_buffer);
+  gst_clear_buffer (&vaggpad->priv->converted_input);
+
   if (vaggpad->priv->converter_config)
     gst_structure_free (vaggpad->priv->converter_config);
   vaggpad->priv->converter_config = NULL;
@@ -473,6 +479,36 @@ static void
   GST_OBJECT_UNLOCK (pad);
 }
 
+/* maps the result of the last conversion into @prepared_frame if @buffer is
+ * the buffer that was converted last time, e.g. because a pad didn't get a
+ * new frame since the last aggregation */
+static gboolean
+gst_video_aggregator_convert_pad_reuse_converted (GstVideoAggregatorConvertPad
+    * pad, GstBuffer * buffer, GstVideoFrame * prepared_frame)
+{
+  if (!pad->priv->convert || !pad->priv->converted_buffer
+      || pad->priv->converted_input != buffer)
+    return FALSE;
+
+  if (!gst_video_frame_map (prepared_frame, &pad->priv->conversion_info,
+          pad->priv->converted_buffer, GST_MAP_READ))
+    return FALSE;
+
+  GST_LOG_OBJECT (pad, "reusing converted frame for %" GST_PTR_FORMAT,
+      buffer);
+
+  return TRUE;
+}
+
+/* drops the result of the last conversion */
+static void
+gst_video_aggregator_convert_pad_clear_converted (GstVideoAggregatorConvertPad
+    * pad)
+{
+  gst_clear_buffer (&pad->priv->converted_buffer);
+  gst_clear_buffer (&pad->priv->converted_input);
+}
+
 static gboolean
 gst_video_aggregator_convert_pad_prepare_frame (GstVideoAggregatorPad * vpad,
     GstVideoAggregator * vagg, GstBuffer * buffer,
@@ -501,6 +537,7 @@ gst_video_aggregator_convert_pad_prepare_frame (GstVideoAggregatorPad * vpad,
     if (pad->priv->convert)
       gst_video_converter_free (pad->priv->convert);
     pad->priv->convert = NULL;
+    gst_video_aggregator_convert_pad_clear_converted (pad);
 
     if (!gst_video_info_is_equal (&vpad->info, &pad->priv->conversion_info)) {
       pad->priv->convert =
@@ -524,6 +561,11 @@ gst_video_aggregator_convert_pad_prepare_frame (GstVideoAggregatorPad * vpad,
   }
   GST_OBJECT_UNLOCK (pad);
 
+  if (gst_video_aggregator_convert_pad_reuse_converted (pad, buffer,
+          prepared_frame))
+    return TRUE;
+  gst_video_aggregator_convert_pad_clear_converted (pad);
+
   if (!gst_video_frame_map (&frame, &vpad->info, buffer, GST_MAP_READ)) {
     GST_WARNING_OBJECT (vagg, "Could not map input buffer");
     return FALSE;
@@ -552,6 +594,7 @@ gst_video_aggregator_convert_pad_prepare_frame (GstVideoAggregatorPad * vpad,
 
     gst_video_converter_frame (pad->priv->convert, &frame, &converted_frame);
     pad->priv->converted_buffer = converted_buf;
+    pad->priv->converted_input = gst_buffer_ref (buffer);
     gst_video_frame_unmap (&frame);
     *prepared_frame = converted_frame;
   } else {
@@ -572,10 +615,10 @@ gst_video_aggregator_convert_pad_clean_frame (GstVideoAggregatorPad * vpad,
     memset (prepared_frame, 0, sizeof (GstVideoFrame));
   }
 
-  if (pad->priv->converted_buffer) {
-    gst_buffer_unref (pad->priv->converted_buffer);
-    pad->priv->converted_buffer = NULL;
-  }
+  /* the converted buffer is kept around in case the same input buffer is
+   * aggregated again */
+  if (!pad->priv->converted_input)
+    gst_clear_buffer (&pad->priv->converted_buffer);
 }
 
 static void
@@ -791,6 +834,7 @@ static void
     if (pad->priv->convert)
       gst_video_converter_free (pad->priv->convert);
     pad->priv->convert = NULL;
+    gst_video_aggregator_convert_pad_clear_converted (pad);
 
     if (!gst_video_info_is_equal (&vpad->info, &pad->priv->conversion_info)) {
       GstStructure *conv_config;
@@ -822,6 +866,11 @@ static void
   }
   GST_OBJECT_UNLOCK (pad);
 
+  if (gst_video_aggregator_convert_pad_reuse_converted (pad, buffer,
+          prepared_frame))
+    return;
+  gst_video_aggregator_convert_pad_clear_converted (pad);
+
   if (!gst_video_frame_map (&pcp_priv->src_frame, &vpad->info, buffer,
           GST_MAP_READ)) {
     GST_WARNING_OBJECT (vagg, "Could not map input buffer");
@@ -853,6 +902,7 @@ static void
     gst_video_converter_frame (pad->priv->convert, &pcp_priv->src_frame,
         prepared_frame);
     pad->priv->converted_buffer = converted_buf;
+    pad->priv->converted_input = gst_buffer_ref (buffer);
     pcp_priv->is_converting = TRUE;
   } else {
     *prepared_frame = pcp_priv->src_frame;
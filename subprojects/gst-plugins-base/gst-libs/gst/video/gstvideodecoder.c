@@ -458,6 +458,11 @@ struct _GstVideoDecoderPrivate
   /* flags */
   gboolean use_default_pad_acceptcaps;
 
+  /* parallel decoding, see gst_video_decoder_queue_parallel_frame() */
+  guint parallel_threads;
+  GstTaskPool *task_pool;
+  GQueue parallel_frames;       /* Protected with STREAM_LOCK */
+
 #ifndef GST_DISABLE_DEBUG
   /* Diagnostic time for reporting the time
    * from flush to first output */
@@ -546,6 +551,11 @@ static void gst_video_decoder_copy_metas (GstVideoDecoder * decoder,
 static void gst_video_decoder_request_sync_point_internal (GstVideoDecoder *
     dec, GstClockTime deadline, GstVideoDecoderRequestSyncPointFlags flags);
 
+static GstFlowReturn gst_video_decoder_push_parallel_frames (GstVideoDecoder *
+    decoder, guint max_pending);
+static void gst_video_decoder_clear_parallel_frames (GstVideoDecoder *
+    decoder);
+
 /* we can't use G_DEFINE_ABSTRACT_TYPE because we need the klass in the _init
  * method to get to the padtemplates */
 GType
@@ -766,6 +776,8 @@ gst_video_decoder_init (GstVideoDecoder * decoder, GstVideoDecoderClass * klass)
 
   g_queue_init (&decoder->priv->frames);
   g_queue_init (&decoder->priv->timestamps);
+  g_queue_init (&decoder->priv->parallel_frames);
+  decoder->priv->parallel_threads = 1;
 
   /* properties */
   decoder->priv->do_qos = DEFAULT_QOS;
@@ -966,6 +978,11 @@ gst_video_decoder_finalize (GObject * object)
     decoder->priv->allocator = NULL;
   }
 
+  if (decoder->priv->task_pool) {
+    gst_task_pool_cleanup (decoder->priv->task_pool);
+    gst_clear_object (&decoder->priv->task_pool);
+  }
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -1042,6 +1059,9 @@ gst_video_decoder_flush (GstVideoDecoder * dec, gboolean hard)
 
   GST_LOG_OBJECT (dec, "flush hard %d", hard);
 
+  /* Wait for frames that are still being decoded and discard them */
+  gst_video_decoder_clear_parallel_frames (dec);
+
   /* Inform subclass */
   if (klass->reset) {
     GST_FIXME_OBJECT (dec, "GstVideoDecoder::reset() is deprecated");
@@ -1177,12 +1197,24 @@ gst_video_decoder_drain_out (GstVideoDecoder * dec, gboolean at_eos)
   GstFlowReturn ret = GST_FLOW_OK;
 
   if (dec->input_segment.rate > 0.0) {
+    GstFlowReturn parallel_ret;
+
     /* Forward mode, if unpacketized, give the child class
      * a final chance to flush out packets */
     if (!priv->packetized) {
       ret = gst_video_decoder_parse_available (dec, TRUE, FALSE);
     }
 
+    /* Push out all frames that are still being decoded in parallel, in
+     * front of anything the subclass still has to output */
+    parallel_ret = gst_video_decoder_push_parallel_frames (dec, 0);
+    if (parallel_ret != GST_FLOW_OK)
+      gst_video_decoder_clear_parallel_frames (dec);
+    if (ret == GST_FLOW_OK)
+      ret = parallel_ret;
+    if (ret != GST_FLOW_OK)
+      return ret;
+
     if (at_eos) {
       if (decoder_class->finish)
         ret = decoder_class->finish (dec);
@@ -2694,6 +2726,14 @@ gst_video_decoder_flush_parse (GstVideoDecoder * dec, gboolean at_eos)
       if (res != GST_FLOW_OK)
         goto done;
 
+      /* frames decoded in parallel are queued for reverse output when they
+       * are finished, so that has to happen before the output is sent */
+      res = gst_video_decoder_push_parallel_frames (dec, 0);
+      if (res != GST_FLOW_OK) {
+        gst_video_decoder_clear_parallel_frames (dec);
+        goto done;
+      }
+
       /* We need to tell the subclass to drain now.
        * We prefer the drain vfunc, but for backward-compat
        * we use a finish() vfunc if drain isn't implemented */
@@ -2881,6 +2921,14 @@ gst_video_decoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
       gboolean stopped = TRUE;
 
+      GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+      gst_video_decoder_clear_parallel_frames (decoder);
+      if (decoder->priv->task_pool) {
+        gst_task_pool_cleanup (decoder->priv->task_pool);
+        gst_clear_object (&decoder->priv->task_pool);
+      }
+      GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
       if (decoder_class->stop)
         stopped = decoder_class->stop (decoder);
 
@@ -3588,6 +3636,234 @@ gst_video_decoder_finish_subframe (GstVideoDecoder * decoder,
   return GST_FLOW_OK;
 }
 
+/* Frame queued for decoding from a worker thread, see
+ * gst_video_decoder_queue_parallel_frame() */
+typedef struct
+{
+  GstVideoDecoder *decoder;
+  GstVideoCodecFrame *frame;
+  gpointer handle;
+  GstFlowReturn ret;
+  /* set once decode_parallel() returned */
+  gint done;
+  /* too late according to QoS, dropped without decoding */
+  gboolean skip;
+} GstVideoDecoderParallelFrame;
+
+static void
+gst_video_decoder_parallel_func (GstVideoDecoderParallelFrame * pframe)
+{
+  GstVideoDecoderClass *decoder_class =
+      GST_VIDEO_DECODER_GET_CLASS (pframe->decoder);
+
+  pframe->ret = decoder_class->decode_parallel (pframe->decoder,
+      pframe->frame);
+  g_atomic_int_set (&pframe->done, TRUE);
+}
+
+/* With stream lock. Returns %FALSE if @block is %FALSE and the frame is still
+ * being decoded */
+static gboolean
+gst_video_decoder_wait_parallel_frame (GstVideoDecoder * decoder,
+    GstVideoDecoderParallelFrame * pframe, gboolean block)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+
+  if (pframe->handle) {
+    if (block) {
+      gst_task_pool_join (priv->task_pool, pframe->handle);
+    } else if (g_atomic_int_get (&pframe->done)) {
+      gst_task_pool_dispose_handle (priv->task_pool, pframe->handle);
+    } else {
+      return FALSE;
+    }
+    pframe->handle = NULL;
+  }
+
+  return TRUE;
+}
+
+/* With stream lock, takes ownership of @pframe */
+static GstFlowReturn
+gst_video_decoder_finish_parallel_frame (GstVideoDecoder * decoder,
+    GstVideoDecoderParallelFrame * pframe)
+{
+  GstVideoCodecFrame *frame = pframe->frame;
+  GstFlowReturn ret = pframe->ret;
+  gboolean skip = pframe->skip;
+
+  g_free (pframe);
+
+  if (skip) {
+    GST_DEBUG_OBJECT (decoder, "dropping late frame %u without decoding",
+        frame->system_frame_number);
+    return gst_video_decoder_drop_frame (decoder, frame);
+  }
+
+  if (ret == GST_FLOW_OK)
+    return gst_video_decoder_finish_frame (decoder, frame);
+
+  GST_DEBUG_OBJECT (decoder, "failed to decode frame %u: %s",
+      frame->system_frame_number, gst_flow_get_name (ret));
+  gst_video_decoder_drop_frame (decoder, frame);
+
+  if (ret == GST_FLOW_ERROR) {
+    GST_VIDEO_DECODER_ERROR (decoder, 1, STREAM, DECODE, (NULL),
+        ("Failed to decode frame"), ret);
+  }
+
+  return ret;
+}
+
+/* With stream lock. Finishes the decoded frames at the head of the queue in
+ * order, waiting for frames until at most @max_pending are left */
+static GstFlowReturn
+gst_video_decoder_push_parallel_frames (GstVideoDecoder * decoder,
+    guint max_pending)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstVideoDecoderParallelFrame *pframe;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  while ((pframe = g_queue_peek_head (&priv->parallel_frames))) {
+    gboolean block = priv->parallel_frames.length > max_pending;
+
+    if (!gst_video_decoder_wait_parallel_frame (decoder, pframe, block))
+      break;
+
+    g_queue_pop_head (&priv->parallel_frames);
+    ret = gst_video_decoder_finish_parallel_frame (decoder, pframe);
+    if (ret != GST_FLOW_OK)
+      break;
+  }
+
+  return ret;
+}
+
+/* With stream lock. Waits for all frames to be decoded and releases them
+ * without pushing them downstream */
+static void
+gst_video_decoder_clear_parallel_frames (GstVideoDecoder * decoder)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstVideoDecoderParallelFrame *pframe;
+
+  while ((pframe = g_queue_pop_head (&priv->parallel_frames))) {
+    gst_video_decoder_wait_parallel_frame (decoder, pframe, TRUE);
+    gst_video_decoder_release_frame (decoder, pframe->frame);
+    g_free (pframe);
+  }
+}
+
+/* With stream lock */
+static guint
+gst_video_decoder_get_n_parallel_threads (GstVideoDecoder * decoder)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  guint n_threads = priv->parallel_threads;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  if (n_threads > 1 && priv->task_pool == NULL) {
+    GError *err = NULL;
+
+    priv->task_pool = gst_shared_task_pool_new ();
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+        (priv->task_pool), n_threads);
+    gst_task_pool_prepare (priv->task_pool, &err);
+    if (err) {
+      GST_WARNING_OBJECT (decoder, "failed to prepare task pool: %s",
+          err->message);
+      g_clear_error (&err);
+      gst_clear_object (&priv->task_pool);
+    }
+  }
+
+  return priv->task_pool ? n_threads : 1;
+}
+
+/**
+ * gst_video_decoder_queue_parallel_frame:
+ * @decoder: a #GstVideoDecoder
+ * @frame: (transfer full): the #GstVideoCodecFrame to decode
+ *
+ * Queues @frame to be decoded from a worker thread by
+ * #GstVideoDecoderClass.decode_parallel(). This can be used by decoders for
+ * intra-only formats, or in general for frames that can be decoded
+ * independently of each other, instead of decoding and finishing them from
+ * #GstVideoDecoderClass.handle_frame().
+ *
+ * Up to the number of threads configured with
+ * gst_video_decoder_set_parallel_threads() frames are decoded at the same
+ * time. Decoded frames are finished with gst_video_decoder_finish_frame() in
+ * the order in which they were queued, and frames that failed to decode are
+ * dropped. Frames that are already late according to QoS (see
+ * gst_video_decoder_get_max_decode_time()) are dropped without decoding them.
+ *
+ * If the subclass needs an output buffer it must allocate it before queueing
+ * the frame, e.g. with gst_video_decoder_allocate_output_frame(), as well as
+ * do any other processing that requires the stream lock. Once a frame was
+ * queued this way, all following frames should be queued as well until the
+ * decoder is drained or flushed.
+ *
+ * Returns: a #GstFlowReturn resulting from finishing previously decoded
+ *     frames, usually GST_FLOW_OK.
+ *
+ * Since: 1.22
+ */
+GstFlowReturn
+gst_video_decoder_queue_parallel_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstVideoDecoderParallelFrame *pframe;
+  GstFlowReturn ret;
+  guint n_threads;
+
+  g_return_val_if_fail (decoder_class->decode_parallel != NULL,
+      GST_FLOW_ERROR);
+
+  GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+
+  n_threads = gst_video_decoder_get_n_parallel_threads (decoder);
+
+  pframe = g_new0 (GstVideoDecoderParallelFrame, 1);
+  pframe->decoder = decoder;
+  pframe->frame = frame;
+
+  if (priv->do_qos && gst_video_decoder_get_max_decode_time (decoder,
+          frame) < 0) {
+    pframe->skip = TRUE;
+    pframe->done = TRUE;
+  } else if (n_threads > 1) {
+    GError *err = NULL;
+
+    GST_LOG_OBJECT (decoder, "queueing frame %u for decoding",
+        frame->system_frame_number);
+    pframe->handle = gst_task_pool_push (priv->task_pool,
+        (GstTaskPoolFunction) gst_video_decoder_parallel_func, pframe, &err);
+    if (err) {
+      GST_WARNING_OBJECT (decoder, "failed to push decoding task: %s",
+          err->message);
+      g_clear_error (&err);
+      pframe->handle = NULL;
+      gst_video_decoder_parallel_func (pframe);
+    }
+  } else {
+    gst_video_decoder_parallel_func (pframe);
+  }
+
+  g_queue_push_tail (&priv->parallel_frames, pframe);
+
+  ret = gst_video_decoder_push_parallel_frames (decoder, n_threads);
+
+  GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
+  return ret;
+}
+
 /* With stream lock, takes the frame reference */
 static GstFlowReturn
 gst_video_decoder_clip_and_push_buf (GstVideoDecoder * decoder, GstBuffer * buf)
@@ -5353,3 +5629,58 @@ gst_video_decoder_get_needs_sync_point (GstVideoDecoder * dec)
 
   return result;
 }
+
+/**
+ * gst_video_decoder_set_parallel_threads:
+ * @dec: a #GstVideoDecoder
+ * @n_threads: the maximum number of frames to decode at the same time
+ *
+ * Configures how many frames queued with
+ * gst_video_decoder_queue_parallel_frame() are decoded at the same time. 0
+ * uses one thread per CPU core and 1 decodes all frames from the streaming
+ * thread, which is the default.
+ *
+ * Using more threads increases the latency of the decoder by up to
+ * @n_threads - 1 frames, which the subclass should take into account in its
+ * latency reported with gst_video_decoder_set_latency().
+ *
+ * Since: 1.22
+ */
+void
+gst_video_decoder_set_parallel_threads (GstVideoDecoder * dec, guint n_threads)
+{
+  g_return_if_fail (GST_IS_VIDEO_DECODER (dec));
+
+  GST_VIDEO_DECODER_STREAM_LOCK (dec);
+  dec->priv->parallel_threads = n_threads;
+  if (dec->priv->task_pool) {
+    if (n_threads == 0)
+      n_threads = g_get_num_processors ();
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+        (dec->priv->task_pool), MAX (n_threads, 1));
+  }
+  GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
+}
+
+/**
+ * gst_video_decoder_get_parallel_threads:
+ * @dec: a #GstVideoDecoder
+ *
+ * Returns: the number of threads configured with
+ *     gst_video_decoder_set_parallel_threads().
+ *
+ * Since: 1.22
+ */
+guint
+gst_video_decoder_get_parallel_threads (GstVideoDecoder * dec)
+{
+  guint result;
+
+  g_return_val_if_fail (GST_IS_VIDEO_DECODER (dec), 1);
+
+  GST_VIDEO_DECODER_STREAM_LOCK (dec);
+  result = dec->priv->parallel_threads;
+  GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
+
+  return result;
+}
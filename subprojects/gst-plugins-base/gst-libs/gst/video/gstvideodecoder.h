@@ -358,8 +358,25 @@ struct _GstVideoDecoderClass
                                         GstClockTime timestamp,
                                         GstClockTime duration);
 
+  /**
+   * GstVideoDecoderClass::decode_parallel:
+   * @decoder: The #GstVideoDecoder
+   * @frame: (transfer none): The frame to decode
+   *
+   * Decodes a frame queued with gst_video_decoder_queue_parallel_frame()
+   * into its output buffer. Called from a worker thread, possibly for
+   * several frames at the same time, and must not call any #GstVideoDecoder
+   * API that takes the stream lock.
+   *
+   * Returns: %GST_FLOW_OK if the frame was decoded, an error otherwise.
+   *
+   * Since: 1.22
+   */
+  GstFlowReturn (*decode_parallel) (GstVideoDecoder *decoder,
+                                    GstVideoCodecFrame *frame);
+
   /*< private >*/
-  gpointer padding[GST_PADDING_LARGE-7];
+  gpointer padding[GST_PADDING_LARGE-8];
 };
 
 /**
@@ -432,6 +449,13 @@ void     gst_video_decoder_set_needs_sync_point (GstVideoDecoder * dec,
 GST_VIDEO_API
 gboolean gst_video_decoder_get_needs_sync_point (GstVideoDecoder * dec);
 
+GST_VIDEO_API
+void     gst_video_decoder_set_parallel_threads (GstVideoDecoder * dec,
+                                                 guint n_threads);
+
+GST_VIDEO_API
+guint    gst_video_decoder_get_parallel_threads (GstVideoDecoder * dec);
+
 GST_VIDEO_API
 void     gst_video_decoder_set_latency (GstVideoDecoder *decoder,
 					GstClockTime min_latency,
@@ -527,6 +551,10 @@ GST_VIDEO_API
 GstFlowReturn    gst_video_decoder_drop_subframe (GstVideoDecoder *dec,
                                                GstVideoCodecFrame *frame);
 
+GST_VIDEO_API
+GstFlowReturn    gst_video_decoder_queue_parallel_frame (GstVideoDecoder *decoder,
+                                                        GstVideoCodecFrame *frame);
+
 GST_VIDEO_API
 void             gst_video_decoder_request_sync_point (GstVideoDecoder *dec,
                                                        GstVideoCodecFrame *frame,
@@ -28,6 +28,11 @@
  * The videofilter will by default enable QoS on the parent GstBaseTransform
  * to implement frame dropping.
  *
+ * Subclasses whose processing of a row only depends on the same row of the
+ * input can call gst_video_filter_process_slices() from their
+ * transform_frame() or transform_frame_ip() implementation to have the
+ * frame split into horizontal slices that are processed in parallel.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -40,11 +45,34 @@
 #include <gst/video/gstvideometa.h>
 #include <gst/video/gstvideopool.h>
 
+#include "gstvideoutilsprivate.h"
+
 GST_DEBUG_CATEGORY_STATIC (gst_video_filter_debug);
 #define GST_CAT_DEFAULT gst_video_filter_debug
 
+/* Frames are only split when every slice gets at least this many rows */
+#define MIN_SLICE_ROWS 32
+
+struct _GstVideoFilterPrivate
+{
+  /* created on first use, only accessed from the streaming thread */
+  GstParallelizedTaskRunner *slice_runner;
+};
+
+typedef struct
+{
+  GstVideoFilter *filter;
+  GstVideoFilterSliceFunc func;
+  gpointer user_data;
+
+  GstVideoFrame in_frame;
+  GstVideoFrame out_frame;
+  gboolean in_place;
+  gboolean empty;
+} GstVideoFilterSlice;
+
 #define gst_video_filter_parent_class parent_class
-G_DEFINE_ABSTRACT_TYPE (GstVideoFilter, gst_video_filter,
+G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GstVideoFilter, gst_video_filter,
     GST_TYPE_BASE_TRANSFORM);
 
 /* cached quark to avoid contention on the global quark table lock */
@@ -364,15 +392,197 @@ gst_video_filter_transform_meta (GstBaseTransform * trans, GstBuffer * outbuf,
       meta, inbuf);
 }
 
+/* Returns the row alignment slices of @frame must respect, or 0 when the
+ * frame can't be split into slices */
+static guint
+gst_video_filter_slice_alignment (const GstVideoFrame * frame)
+{
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  guint c, max_sub = 0, align;
+
+  if (GST_VIDEO_FORMAT_INFO_IS_TILED (finfo) ||
+      GST_VIDEO_FORMAT_INFO_HAS_PALETTE (finfo))
+    return 0;
+
+  for (c = 0; c < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); c++)
+    max_sub = MAX (max_sub, GST_VIDEO_FORMAT_INFO_H_SUB (finfo, c));
+
+  align = 1 << max_sub;
+
+  /* keep both fields of interleaved frames in the same slice */
+  if (GST_VIDEO_INFO_IS_INTERLACED (&frame->info) &&
+      GST_VIDEO_INFO_INTERLACE_MODE (&frame->info) !=
+      GST_VIDEO_INTERLACE_MODE_ALTERNATE)
+    align *= 2;
+
+  return align;
+}
+
+/* Make @view a view of the rows [@y, @y + @height) of @frame */
+static void
+gst_video_filter_slice_view (GstVideoFrame * view, const GstVideoFrame * frame,
+    guint y, guint height)
+{
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  guint c, p;
+
+  *view = *frame;
+  GST_VIDEO_INFO_HEIGHT (&view->info) = height;
+
+  for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (frame); p++) {
+    guint sub = 0;
+
+    for (c = 0; c < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); c++) {
+      if (GST_VIDEO_FORMAT_INFO_PLANE (finfo, c) == p) {
+        sub = GST_VIDEO_FORMAT_INFO_H_SUB (finfo, c);
+        break;
+      }
+    }
+
+    view->data[p] = (guint8 *) frame->data[p] +
+        (y >> sub) * GST_VIDEO_FRAME_PLANE_STRIDE (frame, p);
+  }
+}
+
+static void
+gst_video_filter_slice_task (GstVideoFilterSlice * slice)
+{
+  if (slice->empty)
+    return;
+
+  slice->func (slice->filter,
+      slice->in_place ? &slice->out_frame : &slice->in_frame,
+      &slice->out_frame, slice->user_data);
+}
+
+/**
+ * gst_video_filter_process_slices:
+ * @filter: a #GstVideoFilter
+ * @in_frame: the input frame
+ * @out_frame: the output frame, or the same as @in_frame for in-place
+ *   processing
+ * @func: (scope call): the function processing one slice
+ * @user_data: user data passed to @func
+ *
+ * Splits @out_frame into horizontal slices and calls @func for each of them
+ * from a pool of threads, blocking until all slices are done. This can be
+ * used by subclasses whose processing is row-separable, i.e. every output
+ * row only depends on the same row of the input.
+ *
+ * The frames are processed in a single call to @func when they are too small
+ * to be worth splitting, when their heights differ or when their layout does
+ * not allow splitting them, e.g. for tiled formats.
+ *
+ * This function must only be called from the streaming thread.
+ *
+ * Since: 1.22
+ */
+void
+gst_video_filter_process_slices (GstVideoFilter * filter,
+    GstVideoFrame * in_frame, GstVideoFrame * out_frame,
+    GstVideoFilterSliceFunc func, gpointer user_data)
+{
+  GstVideoFilterPrivate *priv;
+  GstVideoFilterSlice *slices;
+  gpointer *tasks;
+  gboolean in_place;
+  guint height, align, n_threads, n_slices, slice_height, i;
+
+  g_return_if_fail (GST_IS_VIDEO_FILTER (filter));
+  g_return_if_fail (in_frame != NULL);
+  g_return_if_fail (out_frame != NULL);
+  g_return_if_fail (func != NULL);
+
+  priv = filter->priv;
+  in_place = in_frame == out_frame;
+  height = GST_VIDEO_FRAME_HEIGHT (out_frame);
+
+  align = gst_video_filter_slice_alignment (out_frame);
+  if (!in_place && align != 0) {
+    guint in_align = gst_video_filter_slice_alignment (in_frame);
+
+    if (in_align == 0 || GST_VIDEO_FRAME_HEIGHT (in_frame) != height)
+      align = 0;
+    else
+      align = MAX (align, in_align);
+  }
+
+  n_threads = g_get_num_processors ();
+  n_slices = MIN (n_threads, height / MIN_SLICE_ROWS);
+
+  if (n_slices < 2 || align == 0) {
+    func (filter, in_frame, out_frame, user_data);
+    return;
+  }
+
+  if (!priv->slice_runner)
+    priv->slice_runner = gst_parallelized_task_runner_new (n_threads, NULL,
+        FALSE);
+
+  /* the runner always runs one task per thread, surplus ones are empty */
+  n_threads = gst_parallelized_task_runner_get_n_threads (priv->slice_runner);
+  n_slices = MIN (n_slices, n_threads);
+
+  slice_height = (height + n_slices - 1) / n_slices;
+  slice_height = GST_ROUND_UP_N (slice_height, align);
+
+  slices = g_new (GstVideoFilterSlice, n_threads);
+  tasks = g_newa (gpointer, n_threads);
+
+  for (i = 0; i < n_threads; i++) {
+    GstVideoFilterSlice *slice = &slices[i];
+    guint y = i * slice_height;
+
+    slice->filter = filter;
+    slice->func = func;
+    slice->user_data = user_data;
+    slice->in_place = in_place;
+    slice->empty = y >= height;
+
+    if (!slice->empty) {
+      guint h = MIN (slice_height, height - y);
+
+      gst_video_filter_slice_view (&slice->out_frame, out_frame, y, h);
+      if (!in_place)
+        gst_video_filter_slice_view (&slice->in_frame, in_frame, y, h);
+    }
+
+    tasks[i] = slice;
+  }
+
+  GST_LOG_OBJECT (filter, "processing %u rows in slices of %u rows", height,
+      slice_height);
+
+  gst_parallelized_task_runner_run (priv->slice_runner,
+      (GstParallelizedTaskFunc) gst_video_filter_slice_task, tasks);
+
+  g_free (slices);
+}
+
+static void
+gst_video_filter_finalize (GObject * object)
+{
+  GstVideoFilter *filter = GST_VIDEO_FILTER (object);
+
+  if (filter->priv->slice_runner)
+    gst_parallelized_task_runner_free (filter->priv->slice_runner);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 static void
 gst_video_filter_class_init (GstVideoFilterClass * g_class)
 {
+  GObjectClass *gobject_class;
   GstBaseTransformClass *trans_class;
   GstVideoFilterClass *klass;
 
   klass = (GstVideoFilterClass *) g_class;
+  gobject_class = (GObjectClass *) klass;
   trans_class = (GstBaseTransformClass *) klass;
 
+  gobject_class->finalize = gst_video_filter_finalize;
+
   trans_class->set_caps = GST_DEBUG_FUNCPTR (gst_video_filter_set_caps);
   trans_class->propose_allocation =
       GST_DEBUG_FUNCPTR (gst_video_filter_propose_allocation);
@@ -400,6 +610,8 @@ gst_video_filter_init (GstVideoFilter * instance)
 
   GST_DEBUG_OBJECT (videofilter, "gst_video_filter_init");
 
+  videofilter->priv = gst_video_filter_get_instance_private (videofilter);
+
   videofilter->negotiated = FALSE;
   /* enable QoS */
   gst_base_transform_set_qos_enabled (GST_BASE_TRANSFORM (videofilter), TRUE);
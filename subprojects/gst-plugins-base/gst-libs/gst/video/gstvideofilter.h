@@ -28,6 +28,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstVideoFilter GstVideoFilter;
 typedef struct _GstVideoFilterClass GstVideoFilterClass;
+typedef struct _GstVideoFilterPrivate GstVideoFilterPrivate;
 
 #define GST_TYPE_VIDEO_FILTER \
   (gst_video_filter_get_type())
@@ -51,7 +52,9 @@ struct _GstVideoFilter {
   GstVideoInfo out_info;
 
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING];
+  GstVideoFilterPrivate *priv;
+
+  gpointer _gst_reserved[GST_PADDING - 1];
 };
 
 /**
@@ -79,9 +82,35 @@ struct _GstVideoFilterClass {
   gpointer _gst_reserved[GST_PADDING];
 };
 
+/**
+ * GstVideoFilterSliceFunc:
+ * @filter: a #GstVideoFilter
+ * @in_frame: the input rows of the slice
+ * @out_frame: the output rows of the slice
+ * @user_data: user data passed to gst_video_filter_process_slices()
+ *
+ * Processes one horizontal slice of a frame. @in_frame and @out_frame are
+ * views on the original frames that only cover the rows of the slice, so
+ * they can be processed exactly like complete frames. For in-place
+ * processing both point to the same view.
+ *
+ * Since: 1.22
+ */
+typedef void (*GstVideoFilterSliceFunc) (GstVideoFilter * filter,
+                                         GstVideoFrame * in_frame,
+                                         GstVideoFrame * out_frame,
+                                         gpointer user_data);
+
 GST_VIDEO_API
 GType gst_video_filter_get_type (void);
 
+GST_VIDEO_API
+void gst_video_filter_process_slices (GstVideoFilter * filter,
+                                      GstVideoFrame * in_frame,
+                                      GstVideoFrame * out_frame,
+                                      GstVideoFilterSliceFunc func,
+                                      gpointer user_data);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstVideoFilter, gst_object_unref)
 
 G_END_DECLS
@@ -21,6 +21,7 @@
 #endif
 
 #include "gstvideometa.h"
+#include "gstvideoutilsprivate.h"
 
 #include <string.h>
 
@@ -259,6 +260,87 @@ default_unmap (GstVideoMeta * meta, guint plane, GstMapInfo * info)
   return TRUE;
 }
 
+/* Maps all planes of @meta. With the default map functions, planes that live
+ * in the same memory range as a previous plane reuse its mapping instead of
+ * mapping the memory again. Those planes are set in @shared and must not be
+ * unmapped. Returns %FALSE with nothing mapped on error. */
+gboolean
+__gst_video_meta_map_planes (GstVideoMeta * meta, GstMapInfo * map,
+    gpointer * data, gint * stride, GstMapFlags flags, guint * shared)
+{
+  GstBuffer *buffer = meta->buffer;
+  guint idx[GST_VIDEO_MAX_PLANES], length[GST_VIDEO_MAX_PLANES];
+  gsize skip;
+  guint i, j, n_mem;
+
+  *shared = 0;
+
+  if (meta->map != default_map || meta->unmap != default_unmap) {
+    for (i = 0; i < meta->n_planes; i++) {
+      if (!gst_video_meta_map (meta, i, &map[i], &data[i], &stride[i], flags)) {
+        while (i-- > 0)
+          gst_video_meta_unmap (meta, i, &map[i]);
+        return FALSE;
+      }
+    }
+    return TRUE;
+  }
+
+  n_mem = gst_buffer_n_memory (buffer);
+
+  for (i = 0; i < meta->n_planes; i++) {
+    gsize offset = meta->offset[i];
+
+    if (n_mem == 1) {
+      GstMemory *mem = gst_buffer_peek_memory (buffer, 0);
+
+      if (offset >= mem->size)
+        goto no_memory;
+      idx[i] = 0;
+      length[i] = 1;
+      skip = offset;
+    } else if (!gst_buffer_find_memory (buffer, offset, 1, &idx[i], &length[i],
+            &skip)) {
+      goto no_memory;
+    }
+
+    stride[i] = meta->stride[i];
+
+    for (j = 0; j < i; j++) {
+      if (idx[j] == idx[i] && length[j] == length[i] && !(*shared & (1 << j)))
+        break;
+    }
+
+    if (j < i) {
+      map[i] = map[j];
+      *shared |= 1 << i;
+    } else if (!gst_buffer_map_range (buffer, idx[i], length[i], &map[i], flags)) {
+      GST_ERROR ("cannot map memory range %u-%u", idx[i], length[i]);
+      goto failed;
+    }
+    data[i] = (guint8 *) map[i].data + skip;
+  }
+
+  return TRUE;
+
+  /* ERRORS */
+no_memory:
+  {
+    GST_ERROR ("plane %u, no memory at offset %" G_GSIZE_FORMAT, i,
+        meta->offset[i]);
+    goto failed;
+  }
+failed:
+  {
+    while (i-- > 0) {
+      if (!(*shared & (1 << i)))
+        gst_buffer_unmap (buffer, &map[i]);
+    }
+    *shared = 0;
+    return FALSE;
+  }
+}
+
 /**
  * gst_buffer_add_video_meta:
  * @buffer: a #GstBuffer
@@ -23,6 +23,10 @@
 #include "gst/video/gstvideometa.h"
 #include "gst/video/gstvideopool.h"
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 
 GST_DEBUG_CATEGORY_STATIC (gst_video_pool_debug);
 #define GST_CAT_DEFAULT gst_video_pool_debug
@@ -38,8 +42,23 @@ GST_DEBUG_CATEGORY_STATIC (gst_video_pool_debug);
  * Allows configuration of video-specific requirements such as
  * stride alignments or pixel padding, and can also be configured
  * to automatically add #GstVideoMeta to the buffers.
+ *
+ * To avoid page faults on the first access of new frames,
+ * %GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT makes the pool touch the memory of
+ * the buffers it allocates, including the min-buffers allocated when the
+ * pool is activated, and %GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES requests
+ * huge pages for large frames. With %GST_BUFFER_POOL_OPTION_VIDEO_KEEP_WARM,
+ * the memory of the buffers is kept when the pool is deactivated and reused
+ * after it is configured again for caps of the same or a smaller size.
  */
 
+/* pages are touched with this stride for prefaulting, if the system pages
+ * are bigger some pages are touched more than once */
+#define PREFAULT_PAGE_SIZE 4096
+
+/* memory that is not at least this big can't contain a huge page */
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
 /**
  * gst_buffer_pool_config_set_video_alignment:
  * @config: a #GstStructure
@@ -103,6 +122,14 @@ struct _GstVideoBufferPoolPrivate
   gboolean need_alignment;
   GstAllocator *allocator;
   GstAllocationParams params;
+
+  gboolean prefault;
+  gboolean huge_pages;
+  gboolean keep_warm;
+
+  /* GstMemory of the buffers freed while stopping with keep_warm */
+  GQueue warm_memory;
+  gboolean stopping;
 };
 
 static void gst_video_buffer_pool_finalize (GObject * object);
@@ -115,11 +142,89 @@ static const gchar **
 video_buffer_pool_get_options (GstBufferPool * pool)
 {
   static const gchar *options[] = { GST_BUFFER_POOL_OPTION_VIDEO_META,
-    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT, NULL
+    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT,
+    GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT,
+    GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES,
+    GST_BUFFER_POOL_OPTION_VIDEO_KEEP_WARM, NULL
   };
   return options;
 }
 
+static void
+video_buffer_pool_clear_warm_memory (GstVideoBufferPool * vpool)
+{
+  GstMemory *mem;
+
+  while ((mem = g_queue_pop_head (&vpool->priv->warm_memory)))
+    gst_memory_unref (mem);
+}
+
+/* returns a kept memory that can hold a frame of the current configuration,
+ * resized to it */
+static GstMemory *
+video_buffer_pool_take_warm_memory (GstVideoBufferPool * vpool)
+{
+  GstVideoBufferPoolPrivate *priv = vpool->priv;
+  gsize maxsize;
+  GList *l;
+
+  maxsize = priv->params.prefix + priv->info.size + priv->params.padding;
+
+  for (l = priv->warm_memory.head; l; l = l->next) {
+    GstMemory *mem = l->data;
+
+    if (mem->maxsize < maxsize || (mem->align & priv->params.align)
+        != priv->params.align)
+      continue;
+
+    g_queue_delete_link (&priv->warm_memory, l);
+    gst_memory_resize (mem, (gssize) priv->params.prefix - (gssize) mem->offset,
+        priv->info.size);
+    GST_MINI_OBJECT_FLAG_UNSET (mem, GST_MEMORY_FLAG_ZERO_PREFIXED |
+        GST_MEMORY_FLAG_ZERO_PADDED);
+
+    return mem;
+  }
+
+  return NULL;
+}
+
+static void
+video_buffer_pool_prepare_memory (GstVideoBufferPool * vpool,
+    GstBuffer * buffer)
+{
+  GstVideoBufferPoolPrivate *priv = vpool->priv;
+  GstMapInfo map;
+  gsize i;
+
+  if (!gst_buffer_map (buffer, &map, GST_MAP_WRITE)) {
+    GST_WARNING_OBJECT (vpool, "failed to map buffer for prefaulting");
+    return;
+  }
+#if defined (HAVE_MMAP) && defined (MADV_HUGEPAGE)
+  /* must be done before the pages are touched */
+  if (priv->huge_pages && map.size >= HUGE_PAGE_SIZE) {
+    guintptr start = GPOINTER_TO_SIZE (map.data);
+    guintptr end = start + map.size;
+
+    /* only whole huge pages inside the memory can be used */
+    start = (start + HUGE_PAGE_SIZE - 1) & ~((guintptr) HUGE_PAGE_SIZE - 1);
+    end &= ~((guintptr) HUGE_PAGE_SIZE - 1);
+    if (end > start && madvise (GSIZE_TO_POINTER (start), end - start,
+            MADV_HUGEPAGE) != 0)
+      GST_DEBUG_OBJECT (vpool, "no transparent huge pages for %p", map.data);
+  }
+#endif
+
+  if (priv->prefault) {
+    /* writing a byte per page makes the kernel map all of them now */
+    for (i = 0; i < map.size; i += PREFAULT_PAGE_SIZE)
+      ((volatile guint8 *) map.data)[i] = 0;
+  }
+
+  gst_buffer_unmap (buffer, &map);
+}
+
 static gboolean
 video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
 {
@@ -154,6 +259,12 @@ video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
 
   GST_LOG_OBJECT (pool, "%dx%d, caps %" GST_PTR_FORMAT, width, height, caps);
 
+  /* the kept memory is only reused with the same allocator */
+  if (allocator != priv->allocator ||
+      !gst_buffer_pool_config_has_option (config,
+          GST_BUFFER_POOL_OPTION_VIDEO_KEEP_WARM))
+    video_buffer_pool_clear_warm_memory (vpool);
+
   priv->params = params;
   if (priv->allocator)
     gst_object_unref (priv->allocator);
@@ -165,6 +276,13 @@ video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
       gst_buffer_pool_config_has_option (config,
       GST_BUFFER_POOL_OPTION_VIDEO_META);
 
+  priv->prefault = gst_buffer_pool_config_has_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT);
+  priv->huge_pages = gst_buffer_pool_config_has_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES);
+  priv->keep_warm = gst_buffer_pool_config_has_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_KEEP_WARM);
+
   /* parse extra alignment info */
   priv->need_alignment = gst_buffer_pool_config_has_option (config,
       GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT);
@@ -247,11 +365,27 @@ video_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
 
   GST_DEBUG_OBJECT (pool, "alloc %" G_GSIZE_FORMAT, info->size);
 
+  if (priv->warm_memory.length > 0) {
+    GstMemory *mem = video_buffer_pool_take_warm_memory (vpool);
+
+    if (mem) {
+      GST_DEBUG_OBJECT (pool, "reusing kept memory %p", mem);
+      *buffer = gst_buffer_new ();
+      gst_buffer_append_memory (*buffer, mem);
+      goto done_alloc;
+    }
+  }
+
   *buffer =
       gst_buffer_new_allocate (priv->allocator, info->size, &priv->params);
   if (*buffer == NULL)
     goto no_memory;
 
+  if (priv->prefault || priv->huge_pages)
+    video_buffer_pool_prepare_memory (vpool, *buffer);
+
+done_alloc:
+
   if (priv->add_videometa) {
     GST_DEBUG_OBJECT (pool, "adding GstVideoMeta");
 
@@ -271,6 +405,62 @@ no_memory:
   }
 }
 
+static void
+video_buffer_pool_free (GstBufferPool * pool, GstBuffer * buffer)
+{
+  GstVideoBufferPool *vpool = GST_VIDEO_BUFFER_POOL_CAST (pool);
+  GstVideoBufferPoolPrivate *priv = vpool->priv;
+
+  /* keep the memory of the buffers that are freed when deactivating so
+   * they can be reused after a renegotiation */
+  if (priv->stopping && priv->keep_warm && gst_buffer_n_memory (buffer) == 1) {
+    GstMemory *mem = gst_buffer_get_memory (buffer, 0);
+
+    gst_buffer_unref (buffer);
+
+    if (GST_MINI_OBJECT_REFCOUNT_VALUE (mem) == 1 && mem->parent == NULL
+        && !GST_MEMORY_IS_READONLY (mem)) {
+      g_queue_push_tail (&priv->warm_memory, mem);
+    } else {
+      gst_memory_unref (mem);
+    }
+    return;
+  }
+
+  GST_BUFFER_POOL_CLASS (parent_class)->free_buffer (pool, buffer);
+}
+
+static gboolean
+video_buffer_pool_start (GstBufferPool * pool)
+{
+  GstVideoBufferPool *vpool = GST_VIDEO_BUFFER_POOL_CAST (pool);
+  gboolean ret;
+
+  ret = GST_BUFFER_POOL_CLASS (parent_class)->start (pool);
+
+  /* the min-buffers allocated at start took what they could use */
+  if (vpool->priv->warm_memory.length > 0) {
+    GST_DEBUG_OBJECT (pool, "dropping %u unused kept memories",
+        vpool->priv->warm_memory.length);
+    video_buffer_pool_clear_warm_memory (vpool);
+  }
+
+  return ret;
+}
+
+static gboolean
+video_buffer_pool_stop (GstBufferPool * pool)
+{
+  GstVideoBufferPool *vpool = GST_VIDEO_BUFFER_POOL_CAST (pool);
+  gboolean ret;
+
+  vpool->priv->stopping = TRUE;
+  ret = GST_BUFFER_POOL_CLASS (parent_class)->stop (pool);
+  vpool->priv->stopping = FALSE;
+
+  return ret;
+}
+
 /**
  * gst_video_buffer_pool_new:
  *
@@ -303,6 +493,9 @@ gst_video_buffer_pool_class_init (GstVideoBufferPoolClass * klass)
   gstbufferpool_class->get_options = video_buffer_pool_get_options;
   gstbufferpool_class->set_config = video_buffer_pool_set_config;
   gstbufferpool_class->alloc_buffer = video_buffer_pool_alloc;
+  gstbufferpool_class->free_buffer = video_buffer_pool_free;
+  gstbufferpool_class->start = video_buffer_pool_start;
+  gstbufferpool_class->stop = video_buffer_pool_stop;
 
   GST_DEBUG_CATEGORY_INIT (gst_video_pool_debug, "videopool", 0,
       "videopool object");
@@ -312,6 +505,7 @@ static void
 gst_video_buffer_pool_init (GstVideoBufferPool * pool)
 {
   pool->priv = gst_video_buffer_pool_get_instance_private (pool);
+  g_queue_init (&pool->priv->warm_memory);
 }
 
 static void
@@ -322,6 +516,8 @@ gst_video_buffer_pool_finalize (GObject * object)
 
   GST_LOG_OBJECT (pool, "finalize video buffer pool %p", pool);
 
+  video_buffer_pool_clear_warm_memory (pool);
+
   if (priv->allocator)
     gst_object_unref (priv->allocator);
 
@@ -45,6 +45,41 @@ G_BEGIN_DECLS
  */
 #define GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT "GstBufferPoolOptionVideoAlignment"
 
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT:
+ *
+ * A bufferpool option to touch the memory of newly allocated buffers so that
+ * the page faults happen when the buffers are allocated, usually when the
+ * pool is activated, and not when they are first written to.
+ *
+ * Since: 1.22
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT "GstBufferPoolOptionVideoPrefault"
+
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES:
+ *
+ * A bufferpool option to request transparent huge pages for the memory of
+ * large buffers. This is only a hint and has no effect on systems without
+ * transparent huge pages.
+ *
+ * Since: 1.22
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES "GstBufferPoolOptionVideoHugePages"
+
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_KEEP_WARM:
+ *
+ * A bufferpool option to keep the memory of the buffers when the pool is
+ * deactivated. When the pool is activated again with a configuration using
+ * the same allocator, the kept memory that is big enough for the new
+ * configuration is reused instead of allocated again, which avoids freeing
+ * and faulting in frames on renegotiations to compatible caps.
+ *
+ * Since: 1.22
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_KEEP_WARM "GstBufferPoolOptionVideoKeepWarm"
+
 /* setting a bufferpool config */
 
 GST_VIDEO_API
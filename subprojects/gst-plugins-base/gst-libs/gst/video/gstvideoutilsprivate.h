@@ -46,6 +46,36 @@ gboolean __gst_video_rawvideo_convert (GstVideoCodecState * state, GstFormat src
                                        gint64 src_value, GstFormat * dest_format,
                                        gint64 * dest_value);
 
+/* Video meta mapping */
+G_GNUC_INTERNAL
+gboolean __gst_video_meta_map_planes (GstVideoMeta * meta, GstMapInfo * map,
+                                      gpointer * data, gint * stride,
+                                      GstMapFlags flags, guint * shared);
+
+/* Parallelized task execution */
+typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
+
+typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
+
+G_GNUC_INTERNAL
+GstParallelizedTaskRunner * gst_parallelized_task_runner_new (guint n_threads,
+                                                              GstTaskPool * pool,
+                                                              gboolean async_tasks);
+
+G_GNUC_INTERNAL
+void gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self);
+
+G_GNUC_INTERNAL
+void gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
+                                       GstParallelizedTaskFunc func,
+                                       gpointer * task_data);
+
+G_GNUC_INTERNAL
+void gst_parallelized_task_runner_finish (GstParallelizedTaskRunner * self);
+
+G_GNUC_INTERNAL
+guint gst_parallelized_task_runner_get_n_threads (GstParallelizedTaskRunner * self);
+
 G_END_DECLS
 
 #endif
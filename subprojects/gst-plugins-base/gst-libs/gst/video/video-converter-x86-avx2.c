@@ -0,0 +1,131 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-converter-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (__AVX2__)
+
+#include <string.h>
+#include <immintrin.h>
+
+/* Converts the 3 10 bit components in each 32 bit word to 8 bit and packs
+ * them in the lower 3 bytes of the word */
+static inline __m256i
+v210_words_to_u8 (__m256i w)
+{
+  const __m256i mask0 = _mm256_set1_epi32 (0xff);
+  const __m256i mask1 = _mm256_set1_epi32 (0xff00);
+  const __m256i mask2 = _mm256_set1_epi32 (0xff0000);
+
+  return _mm256_or_si256 (_mm256_or_si256 (_mm256_and_si256 (_mm256_srli_epi32
+              (w, 2), mask0), _mm256_and_si256 (_mm256_srli_epi32 (w, 4),
+              mask1)), _mm256_and_si256 (_mm256_srli_epi32 (w, 6), mask2));
+}
+
+/* Handles two v210 blocks (12 pixels) of two lines per iteration. Writes up
+ * to 2 luma and 1 chroma samples past the last converted pixel, which the
+ * caller overwrites when converting the rest of the line. Returns the number
+ * of converted pixels. */
+gint
+video_converter_v210_I420_avx2 (guint8 * d_y1, guint8 * d_y2, guint8 * d_u,
+    guint8 * d_v, const guint8 * s1, const guint8 * s2, gint width)
+{
+  /* per block: Y0-Y5 in bytes 0-5, U0 U2 U4 in bytes 8-10 and V0 V2 V4 in
+   * bytes 12-14 */
+  const __m256i shuf = _mm256_setr_epi8 (1, 4, 6, 9, 12, 14, -1, -1,
+      0, 5, 10, -1, 2, 8, 13, -1,
+      1, 4, 6, 9, 12, 14, -1, -1,
+      0, 5, 10, -1, 2, 8, 13, -1);
+  const __m256i mask7f = _mm256_set1_epi8 (0x7f);
+  gint j;
+
+  for (j = 0; j + 16 <= width; j += 12) {
+    __m256i a, b, c;
+    __m128i lo, hi;
+    guint32 t;
+
+    a = _mm256_loadu_si256 ((const __m256i *) (s1 + (j / 12) * 32));
+    b = _mm256_loadu_si256 ((const __m256i *) (s2 + (j / 12) * 32));
+
+    a = _mm256_shuffle_epi8 (v210_words_to_u8 (a), shuf);
+    b = _mm256_shuffle_epi8 (v210_words_to_u8 (b), shuf);
+
+    /* (a + b) / 2 without overflowing the bytes */
+    c = _mm256_add_epi8 (_mm256_and_si256 (a, b),
+        _mm256_and_si256 (_mm256_srli_epi16 (_mm256_xor_si256 (a, b), 1),
+            mask7f));
+
+    lo = _mm256_castsi256_si128 (a);
+    hi = _mm256_extracti128_si256 (a, 1);
+    _mm_storel_epi64 ((__m128i *) (d_y1 + j), lo);
+    _mm_storel_epi64 ((__m128i *) (d_y1 + j + 6), hi);
+
+    lo = _mm256_castsi256_si128 (b);
+    hi = _mm256_extracti128_si256 (b, 1);
+    _mm_storel_epi64 ((__m128i *) (d_y2 + j), lo);
+    _mm_storel_epi64 ((__m128i *) (d_y2 + j + 6), hi);
+
+    lo = _mm256_castsi256_si128 (c);
+    hi = _mm256_extracti128_si256 (c, 1);
+    t = _mm_extract_epi32 (lo, 2);
+    memcpy (d_u + j / 2, &t, 4);
+    t = _mm_extract_epi32 (hi, 2);
+    memcpy (d_u + j / 2 + 3, &t, 4);
+    t = _mm_extract_epi32 (lo, 3);
+    memcpy (d_v + j / 2, &t, 4);
+    t = _mm_extract_epi32 (hi, 3);
+    memcpy (d_v + j / 2 + 3, &t, 4);
+  }
+
+  return j;
+}
+
+void
+video_converter_interleave_uv_avx2 (guint8 * d, const guint8 * u,
+    const guint8 * v, gint width)
+{
+  gint i;
+
+  for (i = 0; i + 32 <= width; i += 32) {
+    __m256i tu, tv, lo, hi;
+
+    tu = _mm256_loadu_si256 ((const __m256i *) (u + i));
+    tv = _mm256_loadu_si256 ((const __m256i *) (v + i));
+
+    /* the unpacks work per 128 bit lane, put the lanes back in order */
+    lo = _mm256_unpacklo_epi8 (tu, tv);
+    hi = _mm256_unpackhi_epi8 (tu, tv);
+
+    _mm256_storeu_si256 ((__m256i *) (d + 2 * i),
+        _mm256_permute2x128_si256 (lo, hi, 0x20));
+    _mm256_storeu_si256 ((__m256i *) (d + 2 * i + 32),
+        _mm256_permute2x128_si256 (lo, hi, 0x31));
+  }
+
+  for (; i < width; i++) {
+    d[2 * i] = u[i];
+    d[2 * i + 1] = v[i];
+  }
+}
+
+#endif
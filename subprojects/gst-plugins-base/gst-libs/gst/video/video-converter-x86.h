@@ -0,0 +1,38 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "video-converter-x86-avx2.h"
+
+static void
+video_converter_check_x86 (void)
+{
+#if defined (HAVE_AVX2) && (defined (__GNUC__) || defined (__clang__))
+  /* ORC has no AVX2 target flag, so ask the CPU directly */
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2")) {
+    GST_DEBUG ("enable AVX2 optimisations");
+    convert_v210_I420_lines = video_converter_v210_I420_avx2;
+    interleave_uv = video_converter_interleave_uv_avx2;
+  } else {
+    GST_DEBUG ("AVX2 not supported by CPU");
+  }
+#else
+  GST_DEBUG ("AVX2 optimisations not enabled");
+#endif
+}
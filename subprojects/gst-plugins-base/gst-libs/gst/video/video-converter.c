@@ -37,6 +37,7 @@
 #include <gst/base/base.h>
 
 #include "video-orc.h"
+#include "gstvideoutilsprivate.h"
 
 /**
  * SECTION:videoconverter
@@ -116,172 +117,44 @@ ensure_debug_category (void)
 #define ensure_debug_category() /* NOOP */
 #endif /* GST_DISABLE_GST_DEBUG */
 
-typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
-
-typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
-typedef struct _GstParallelizedWorkItem GstParallelizedWorkItem;
-
-struct _GstParallelizedWorkItem
-{
-  GstParallelizedTaskRunner *self;
-  GstParallelizedTaskFunc func;
-  gpointer user_data;
-};
-
-struct _GstParallelizedTaskRunner
-{
-  GstTaskPool *pool;
-  gboolean own_pool;
-  guint n_threads;
-
-  GstQueueArray *tasks;
-  GstQueueArray *work_items;
-
-  GMutex lock;
-
-  gboolean async_tasks;
-};
-
-static void
-gst_parallelized_task_thread_func (gpointer data)
-{
-  GstParallelizedTaskRunner *runner = data;
-  GstParallelizedWorkItem *work_item;
-
-  g_mutex_lock (&runner->lock);
-  work_item = gst_queue_array_pop_head (runner->work_items);
-  g_mutex_unlock (&runner->lock);
-
-  g_assert (work_item != NULL);
-  g_assert (work_item->func != NULL);
-
-
-  work_item->func (work_item->user_data);
-  if (runner->async_tasks)
-    g_free (work_item);
-}
+/* Line functions of the fastpaths that have hand-vectorized versions for
+ * instruction sets ORC can't target. They are selected once at runtime.
+ *
+ * convert_v210_I420_lines converts a prefix of two lines and returns the
+ * number of converted pixels, the rest is converted with plain C. */
+static gint (*convert_v210_I420_lines) (guint8 * d_y1, guint8 * d_y2,
+    guint8 * d_u, guint8 * d_v, const guint8 * s1, const guint8 * s2,
+    gint width) = NULL;
 
 static void
-gst_parallelized_task_runner_join (GstParallelizedTaskRunner * self)
+interleave_uv_c (guint8 * d, const guint8 * u, const guint8 * v, gint width)
 {
-  gboolean joined = FALSE;
+  gint i;
 
-  while (!joined) {
-    g_mutex_lock (&self->lock);
-    if (!(joined = gst_queue_array_is_empty (self->tasks))) {
-      gpointer task = gst_queue_array_pop_head (self->tasks);
-      g_mutex_unlock (&self->lock);
-      gst_task_pool_join (self->pool, task);
-    } else {
-      g_mutex_unlock (&self->lock);
-    }
+  for (i = 0; i < width; i++) {
+    d[2 * i] = u[i];
+    d[2 * i + 1] = v[i];
   }
 }
 
-static void
-gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-
-  gst_queue_array_free (self->work_items);
-  gst_queue_array_free (self->tasks);
-  if (self->own_pool)
-    gst_task_pool_cleanup (self->pool);
-  gst_object_unref (self->pool);
-  g_mutex_clear (&self->lock);
-  g_free (self);
-}
-
-static GstParallelizedTaskRunner *
-gst_parallelized_task_runner_new (guint n_threads, GstTaskPool * pool,
-    gboolean async_tasks)
-{
-  GstParallelizedTaskRunner *self;
-
-  if (n_threads == 0)
-    n_threads = g_get_num_processors ();
-
-  self = g_new0 (GstParallelizedTaskRunner, 1);
-
-  if (pool) {
-    self->pool = g_object_ref (pool);
-    self->own_pool = FALSE;
-
-    /* No reason to split up the work between more threads than the
-     * pool can spawn */
-    if (GST_IS_SHARED_TASK_POOL (pool))
-      n_threads =
-          MIN (n_threads,
-          gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool)));
-  } else {
-    self->pool = gst_shared_task_pool_new ();
-    self->own_pool = TRUE;
-    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
-        n_threads);
-    gst_task_pool_prepare (self->pool, NULL);
-  }
-
-  self->tasks = gst_queue_array_new (n_threads);
-  self->work_items = gst_queue_array_new (n_threads);
-
-  self->n_threads = n_threads;
-
-  g_mutex_init (&self->lock);
+static void (*interleave_uv) (guint8 * d, const guint8 * u, const guint8 * v,
+    gint width) = interleave_uv_c;
 
-  /* Set when scheduling a job */
-  self->async_tasks = async_tasks;
-
-  return self;
-}
-
-static void
-gst_parallelized_task_runner_finish (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-}
+#if defined (__i386__) || defined (__x86_64__)
+# define CHECK_X86
+# include "video-converter-x86.h"
+#endif
 
 static void
-gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
-    GstParallelizedTaskFunc func, gpointer * task_data)
+video_converter_init_simd (void)
 {
-  guint n_threads = self->n_threads;
-
-  if (n_threads > 1 || self->async_tasks) {
-    guint i = 0;
-    g_mutex_lock (&self->lock);
-    if (!self->async_tasks) {
-      /* if not async, perform one of the functions in the current thread */
-      i = 1;
-    }
-    for (; i < n_threads; i++) {
-      gpointer task;
-      GstParallelizedWorkItem *work_item;
-
-      if (!self->async_tasks)
-        work_item = g_newa (GstParallelizedWorkItem, 1);
-      else
-        work_item = g_new0 (GstParallelizedWorkItem, 1);
-
-      work_item->self = self;
-      work_item->func = func;
-      work_item->user_data = task_data[i];
-      gst_queue_array_push_tail (self->work_items, work_item);
-
-      task =
-          gst_task_pool_push (self->pool, gst_parallelized_task_thread_func,
-          self, NULL);
+  static gsize init_gonce = 0;
 
-      /* The return value of push() is unfortunately nullable, and we can't deal with that */
-      g_assert (task != NULL);
-      gst_queue_array_push_tail (self->tasks, task);
-    }
-    g_mutex_unlock (&self->lock);
-  }
-
-  if (!self->async_tasks) {
-    func (task_data[0]);
-
-    gst_parallelized_task_runner_finish (self);
+  if (g_once_init_enter (&init_gonce)) {
+#ifdef CHECK_X86
+    video_converter_check_x86 ();
+#endif
+    g_once_init_leave (&init_gonce, 1);
   }
 }
 
@@ -2333,6 +2206,8 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
   g_return_val_if_fail (in_info->interlace_mode == out_info->interlace_mode,
       NULL);
 
+  video_converter_init_simd ();
+
   convert = g_slice_new0 (GstVideoConverter);
 
   fin = in_info->finfo;
@@ -3880,7 +3755,11 @@ convert_v210_I420_task (FConvertTask * task)
     s1 = FRAME_GET_LINE (task->src, l1);
     s2 = FRAME_GET_LINE (task->src, l2);
 
-    for (j = 0; j < task->width; j += 6) {
+    j = 0;
+    if (convert_v210_I420_lines)
+      j = convert_v210_I420_lines (d_y1, d_y2, d_u, d_v, s1, s2, task->width);
+
+    for (; j < task->width; j += 6) {
       a0 = GST_READ_UINT32_LE (s1 + (j / 6) * 16 + 0);
       a1 = GST_READ_UINT32_LE (s1 + (j / 6) * 16 + 4);
       a2 = GST_READ_UINT32_LE (s1 + (j / 6) * 16 + 8);
@@ -4035,6 +3914,67 @@ typedef struct
   MatrixData *data;
 } FConvertPlaneTask;
 
+static void
+convert_I420_NV12_task (FConvertPlaneTask * task)
+{
+  gint i;
+
+  for (i = 0; i < task->height; i++) {
+    memcpy (task->d + 2 * i * task->dstride, task->s + 2 * i * task->sstride,
+        task->width);
+    memcpy (task->d + (2 * i + 1) * task->dstride,
+        task->s + (2 * i + 1) * task->sstride, task->width);
+    interleave_uv (task->du + i * task->dustride, task->su + i * task->sustride,
+        task->sv + i * task->svstride, (task->width + 1) / 2);
+  }
+}
+
+static void
+convert_I420_NV12 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  gint width = convert->in_width;
+  gint height = convert->in_height / 2;
+  FConvertPlaneTask *tasks;
+  FConvertPlaneTask **tasks_p;
+  gint n_threads;
+  gint lines_per_thread;
+  gint i;
+
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = convert->tasks[0] =
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+  tasks_p = convert->tasks_p[0] =
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+
+  /* in chroma lines, each task also copies the two matching luma lines */
+  lines_per_thread = (height + n_threads - 1) / n_threads;
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].sstride = FRAME_GET_Y_STRIDE (src);
+    tasks[i].sustride = FRAME_GET_U_STRIDE (src);
+    tasks[i].svstride = FRAME_GET_V_STRIDE (src);
+    tasks[i].dstride = FRAME_GET_PLANE_STRIDE (dest, 0);
+    tasks[i].dustride = FRAME_GET_PLANE_STRIDE (dest, 1);
+
+    tasks[i].s = FRAME_GET_Y_LINE (src, 2 * i * lines_per_thread);
+    tasks[i].su = FRAME_GET_U_LINE (src, i * lines_per_thread);
+    tasks[i].sv = FRAME_GET_V_LINE (src, i * lines_per_thread);
+    tasks[i].d = FRAME_GET_PLANE_LINE (dest, 0, 2 * i * lines_per_thread);
+    tasks[i].du = FRAME_GET_PLANE_LINE (dest, 1, i * lines_per_thread);
+
+    tasks[i].width = width;
+    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = MIN (tasks[i].height, height);
+    tasks[i].height -= i * lines_per_thread;
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner,
+      (GstParallelizedTaskFunc) convert_I420_NV12_task, (gpointer) tasks_p);
+}
+
 static void
 convert_YUY2_AYUV_task (FConvertPlaneTask * task)
 {
@@ -7969,6 +7909,12 @@ static const VideoTransform transforms[] = {
   {GST_VIDEO_FORMAT_YVU9, GST_VIDEO_FORMAT_YVU9, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
 
+  /* planar -> semiplanar */
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 1, convert_I420_NV12},
+  {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 1, convert_I420_NV12},
+
   /* sempiplanar -> semiplanar */
   {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
@@ -30,9 +30,14 @@
 #include "video-frame.h"
 #include "video-tile.h"
 #include "gstvideometa.h"
+#include "gstvideoutilsprivate.h"
 
 #define CAT_PERFORMANCE video_frame_get_perf_category()
 
+/* bitmask of the planes that share the mapping of a previous plane */
+#define GET_SHARED_PLANES(f)    GPOINTER_TO_UINT ((f)->_gst_reserved[0])
+#define SET_SHARED_PLANES(f,s)  ((f)->_gst_reserved[0] = GUINT_TO_POINTER (s))
+
 static inline GstDebugCategory *
 video_frame_get_perf_category (void)
 {
@@ -71,6 +76,7 @@ gst_video_frame_map_id (GstVideoFrame * frame, const GstVideoInfo * info,
     GstBuffer * buffer, gint id, GstMapFlags flags)
 {
   GstVideoMeta *meta;
+  guint shared;
   gint i;
 
   g_return_val_if_fail (frame != NULL, FALSE);
@@ -99,12 +105,14 @@ gst_video_frame_map_id (GstVideoFrame * frame, const GstVideoInfo * info,
     frame->id = meta->id;
     frame->flags = meta->flags;
 
-    for (i = 0; i < meta->n_planes; i++) {
+    for (i = 0; i < meta->n_planes; i++)
       frame->info.offset[i] = meta->offset[i];
-      if (!gst_video_meta_map (meta, i, &frame->map[i], &frame->data[i],
-              &frame->info.stride[i], flags))
-        goto frame_map_failed;
-    }
+
+    /* planes in the same memory, usually all of them, are only mapped once */
+    if (!__gst_video_meta_map_planes (meta, frame->map, frame->data,
+            frame->info.stride, flags, &shared))
+      goto frame_map_failed;
+    SET_SHARED_PLANES (frame, shared);
   } else {
     /* no metadata, we really need to have the metadata when the id is
      * specified. */
@@ -113,6 +121,7 @@ gst_video_frame_map_id (GstVideoFrame * frame, const GstVideoInfo * info,
 
     frame->id = id;
     frame->flags = 0;
+    SET_SHARED_PLANES (frame, 0);
 
     if (!gst_buffer_map (buffer, &frame->map[0], flags))
       goto map_failed;
@@ -165,9 +174,7 @@ no_metadata:
   }
 frame_map_failed:
   {
-    GST_ERROR ("failed to map video frame plane %d", i);
-    while (--i >= 0)
-      gst_video_meta_unmap (meta, i, &frame->map[i]);
+    GST_ERROR ("failed to map video frame");
     memset (frame, 0, sizeof (GstVideoFrame));
     return FALSE;
   }
@@ -267,7 +274,12 @@ gst_video_frame_unmap (GstVideoFrame * frame)
   flags = frame->map[0].flags;
 
   if (meta) {
+    guint shared = GET_SHARED_PLANES (frame);
+
     for (i = 0; i < frame->info.finfo->n_planes; i++) {
+      /* these reuse the mapping of a previous plane */
+      if (shared & (1 << i))
+        continue;
       gst_video_meta_unmap (meta, i, &frame->map[i]);
     }
   } else {
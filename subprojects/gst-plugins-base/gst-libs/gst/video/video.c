@@ -253,3 +253,139 @@ gst_video_orientation_from_tag (GstTagList * taglist,
 
   return ret;
 }
+
+#define GST_VIDEO_PREFERRED_SIZE_QUERY_NAME "GstVideoPreferredSize"
+
+/**
+ * gst_video_query_new_preferred_size:
+ *
+ * Creates a new custom downstream query asking for the smallest video size
+ * that is still useful downstream. Elements that scale down to a fixed size,
+ * like videoscale, answer it with their output size. A decoder that can
+ * decode at a reduced resolution (e.g. JPEG DCT scaling or libav lowres) can
+ * then skip producing full resolution frames that are immediately scaled
+ * down again.
+ *
+ * The answer is only a hint: the caps negotiated afterwards still have to be
+ * accepted downstream.
+ *
+ * Returns: (transfer full): a new #GstQuery
+ *
+ * Since: 1.22
+ */
+GstQuery *
+gst_video_query_new_preferred_size (void)
+{
+  return gst_query_new_custom (GST_QUERY_CUSTOM,
+      gst_structure_new_empty (GST_VIDEO_PREFERRED_SIZE_QUERY_NAME));
+}
+
+/**
+ * gst_video_query_is_preferred_size:
+ * @query: a #GstQuery
+ *
+ * Checks if @query was created with gst_video_query_new_preferred_size().
+ *
+ * Returns: %TRUE if @query is a preferred size query
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_video_query_is_preferred_size (GstQuery * query)
+{
+  const GstStructure *s;
+
+  g_return_val_if_fail (GST_IS_QUERY (query), FALSE);
+
+  if (GST_QUERY_TYPE (query) != GST_QUERY_CUSTOM)
+    return FALSE;
+
+  s = gst_query_get_structure (query);
+
+  return s && gst_structure_has_name (s, GST_VIDEO_PREFERRED_SIZE_QUERY_NAME);
+}
+
+/**
+ * gst_video_query_set_preferred_size:
+ * @query: a preferred size #GstQuery
+ * @width: the preferred width
+ * @height: the preferred height
+ *
+ * Answers @query with the smallest size that is useful downstream.
+ *
+ * Since: 1.22
+ */
+void
+gst_video_query_set_preferred_size (GstQuery * query, gint width, gint height)
+{
+  GstStructure *s;
+
+  g_return_if_fail (gst_video_query_is_preferred_size (query));
+  g_return_if_fail (width > 0 && height > 0);
+
+  s = gst_query_writable_structure (query);
+  gst_structure_set (s, "width", G_TYPE_INT, width, "height", G_TYPE_INT,
+      height, NULL);
+}
+
+/**
+ * gst_video_query_parse_preferred_size:
+ * @query: a preferred size #GstQuery
+ * @width: (out) (optional): the preferred width
+ * @height: (out) (optional): the preferred height
+ *
+ * Parses the answer of a preferred size query.
+ *
+ * Returns: %TRUE if @query was answered
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_video_query_parse_preferred_size (GstQuery * query, gint * width,
+    gint * height)
+{
+  const GstStructure *s;
+  gint w, h;
+
+  g_return_val_if_fail (gst_video_query_is_preferred_size (query), FALSE);
+
+  s = gst_query_get_structure (query);
+  if (!gst_structure_get_int (s, "width", &w) ||
+      !gst_structure_get_int (s, "height", &h))
+    return FALSE;
+
+  if (width)
+    *width = w;
+  if (height)
+    *height = h;
+
+  return TRUE;
+}
+
+/**
+ * gst_video_peer_query_preferred_size:
+ * @pad: a source #GstPad
+ * @width: (out) (optional): the preferred width
+ * @height: (out) (optional): the preferred height
+ *
+ * Convenience function sending a preferred size query to the peer of @pad.
+ *
+ * Returns: %TRUE if downstream answered with a preferred size
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_video_peer_query_preferred_size (GstPad * pad, gint * width, gint * height)
+{
+  GstQuery *query;
+  gboolean ret;
+
+  g_return_val_if_fail (GST_IS_PAD (pad), FALSE);
+
+  query = gst_video_query_new_preferred_size ();
+  ret = gst_pad_peer_query (pad, query) &&
+      gst_video_query_parse_preferred_size (query, width, height);
+  gst_query_unref (query);
+
+  return ret;
+}
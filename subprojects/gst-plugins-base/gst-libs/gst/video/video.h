@@ -172,6 +172,29 @@ GST_VIDEO_API
 gboolean gst_video_orientation_from_tag (GstTagList * taglist,
                                          GstVideoOrientationMethod * method);
 
+/* preferred output size hint */
+
+GST_VIDEO_API
+GstQuery *    gst_video_query_new_preferred_size   (void);
+
+GST_VIDEO_API
+gboolean      gst_video_query_is_preferred_size    (GstQuery * query);
+
+GST_VIDEO_API
+void          gst_video_query_set_preferred_size   (GstQuery * query,
+                                                    gint       width,
+                                                    gint       height);
+
+GST_VIDEO_API
+gboolean      gst_video_query_parse_preferred_size (GstQuery * query,
+                                                    gint     * width,
+                                                    gint     * height);
+
+GST_VIDEO_API
+gboolean      gst_video_peer_query_preferred_size  (GstPad * pad,
+                                                    gint   * width,
+                                                    gint   * height);
+
 G_END_DECLS
 
 #include <gst/video/colorbalancechannel.h>
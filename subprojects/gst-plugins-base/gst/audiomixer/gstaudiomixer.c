@@ -60,6 +60,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include "gstaudiomixerelements.h"
 #include "gstaudiomixerorc.h"
 
@@ -137,6 +139,16 @@ gst_audiomixer_pad_set_property (GObject * object, guint prop_id,
   }
 }
 
+static void
+gst_audiomixer_pad_finalize (GObject * object)
+{
+  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (object);
+
+  g_free (pad->volumes);
+
+  G_OBJECT_CLASS (gst_audiomixer_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_audiomixer_pad_class_init (GstAudioMixerPadClass * klass)
 {
@@ -144,6 +156,7 @@ gst_audiomixer_pad_class_init (GstAudioMixerPadClass * klass)
 
   gobject_class->set_property = gst_audiomixer_pad_set_property;
   gobject_class->get_property = gst_audiomixer_pad_get_property;
+  gobject_class->finalize = gst_audiomixer_pad_finalize;
 
   g_object_class_install_property (gobject_class, PROP_PAD_VOLUME,
       g_param_spec_double ("volume", "Volume", "Volume of this pad",
@@ -283,6 +296,108 @@ gst_audiomixer_release_pad (GstElement * element, GstPad * pad)
   GST_ELEMENT_CLASS (parent_class)->release_pad (element, pad);
 }
 
+/* Mixing with one volume per frame, used when the pad volume is controlled.
+ * Unsigned samples are biased around the middle of their range. */
+#define DEFINE_ADD_CONTROLLED_VOLUME(name,type,bias,min,max) \
+static void \
+add_controlled_volume_##name (type * out, const type * in, \
+    const gdouble * volumes, gint channels, guint num_frames) \
+{ \
+  guint i; \
+  gint c; \
+  \
+  for (i = 0; i < num_frames; i++) { \
+    gdouble volume = volumes[i]; \
+    \
+    for (c = 0; c < channels; c++) { \
+      gdouble val = ((gdouble) *out - (bias)) + \
+          ((gdouble) *in - (bias)) * volume; \
+      \
+      *out = (type) (CLAMP (val, (min), (max)) + (bias)); \
+      out++; \
+      in++; \
+    } \
+  } \
+}
+
+#define DEFINE_ADD_CONTROLLED_VOLUME_FLOAT(name,type) \
+static void \
+add_controlled_volume_##name (type * out, const type * in, \
+    const gdouble * volumes, gint channels, guint num_frames) \
+{ \
+  guint i; \
+  gint c; \
+  \
+  for (i = 0; i < num_frames; i++) { \
+    type volume = volumes[i]; \
+    \
+    for (c = 0; c < channels; c++) \
+      out[c] += in[c] * volume; \
+    out += channels; \
+    in += channels; \
+  } \
+}
+
+DEFINE_ADD_CONTROLLED_VOLUME (u8, guint8, 128.0, -128.0, 127.0);
+DEFINE_ADD_CONTROLLED_VOLUME (s8, gint8, 0.0, G_MININT8, G_MAXINT8);
+DEFINE_ADD_CONTROLLED_VOLUME (u16, guint16, 32768.0, -32768.0, 32767.0);
+DEFINE_ADD_CONTROLLED_VOLUME (s16, gint16, 0.0, G_MININT16, G_MAXINT16);
+DEFINE_ADD_CONTROLLED_VOLUME (u32, guint32, 2147483648.0, -2147483648.0,
+    2147483647.0);
+DEFINE_ADD_CONTROLLED_VOLUME (s32, gint32, 0.0, G_MININT32, G_MAXINT32);
+DEFINE_ADD_CONTROLLED_VOLUME_FLOAT (f32, gfloat);
+DEFINE_ADD_CONTROLLED_VOLUME_FLOAT (f64, gdouble);
+
+/* Returns one volume per frame starting at @in_offset of @inbuf if the
+ * volume of @pad is controlled, or %NULL to use the current volume for the
+ * whole block. Must be called without the pad lock held. */
+static const gdouble *
+gst_audiomixer_pad_get_controlled_volumes (GstAudioMixerPad * pad,
+    GstBuffer * inbuf, guint in_offset, guint num_frames, gint rate)
+{
+  GstControlBinding *binding;
+  GstClockTime stream_time;
+  gdouble volume;
+  gboolean res;
+  guint i;
+
+  binding = gst_object_get_control_binding (GST_OBJECT (pad), "volume");
+  if (!binding)
+    return NULL;
+
+  if (gst_control_binding_is_disabled (binding)) {
+    gst_object_unref (binding);
+    return NULL;
+  }
+
+  GST_OBJECT_LOCK (pad);
+  stream_time = gst_segment_to_stream_time (&GST_AGGREGATOR_PAD (pad)->segment,
+      GST_FORMAT_TIME, GST_BUFFER_PTS (inbuf));
+  volume = pad->volume;
+  GST_OBJECT_UNLOCK (pad);
+
+  if (!GST_CLOCK_TIME_IS_VALID (stream_time)) {
+    gst_object_unref (binding);
+    return NULL;
+  }
+  stream_time += gst_util_uint64_scale_int (in_offset, GST_SECOND, rate);
+
+  if (pad->volumes_count < num_frames) {
+    pad->volumes = g_renew (gdouble, pad->volumes, num_frames);
+    pad->volumes_count = num_frames;
+  }
+
+  /* frames without a control value keep the current volume */
+  for (i = 0; i < num_frames; i++)
+    pad->volumes[i] = volume;
+
+  res = gst_control_binding_get_value_array (binding, stream_time,
+      gst_util_uint64_scale_int (1, GST_SECOND, rate), num_frames,
+      pad->volumes);
+  gst_object_unref (binding);
+
+  return res ? pad->volumes : NULL;
+}
 
 static gboolean
 gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
@@ -295,11 +410,16 @@ gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
   gint bpf;
   GstAggregator *agg = GST_AGGREGATOR (aagg);
   GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  const gdouble *volumes;
+
+  /* the input is already converted to the output format */
+  volumes = gst_audiomixer_pad_get_controlled_volumes (pad, inbuf, in_offset,
+      num_frames, GST_AUDIO_INFO_RATE (&srcpad->info));
 
   GST_OBJECT_LOCK (aagg);
   GST_OBJECT_LOCK (aaggpad);
 
-  if (pad->mute || pad->volume < G_MINDOUBLE) {
+  if (pad->mute || (!volumes && pad->volume < G_MINDOUBLE)) {
     GST_DEBUG_OBJECT (pad, "Skipping muted pad");
     GST_OBJECT_UNLOCK (aaggpad);
     GST_OBJECT_UNLOCK (aagg);
@@ -313,8 +433,49 @@ gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
   GST_LOG_OBJECT (pad, "mixing %u bytes at offset %u from offset %u",
       num_frames * bpf, out_offset * bpf, in_offset * bpf);
 
-  /* further buffers, need to add them */
-  if (pad->volume == 1.0) {
+  if (volumes) {
+    gpointer out = outmap.data + out_offset * bpf;
+    gconstpointer in = inmap.data + in_offset * bpf;
+    gint channels = srcpad->info.channels;
+
+    /* the volume changes over the block, apply it per frame */
+    switch (srcpad->info.finfo->format) {
+      case GST_AUDIO_FORMAT_U8:
+        add_controlled_volume_u8 (out, in, volumes, channels, num_frames);
+        break;
+      case GST_AUDIO_FORMAT_S8:
+        add_controlled_volume_s8 (out, in, volumes, channels, num_frames);
+        break;
+      case GST_AUDIO_FORMAT_U16:
+        add_controlled_volume_u16 (out, in, volumes, channels, num_frames);
+        break;
+      case GST_AUDIO_FORMAT_S16:
+        add_controlled_volume_s16 (out, in, volumes, channels, num_frames);
+        break;
+      case GST_AUDIO_FORMAT_U32:
+        add_controlled_volume_u32 (out, in, volumes, channels, num_frames);
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        add_controlled_volume_s32 (out, in, volumes, channels, num_frames);
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        add_controlled_volume_f32 (out, in, volumes, channels, num_frames);
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        add_controlled_volume_f64 (out, in, volumes, channels, num_frames);
+        break;
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+  } else if (pad->volume == 1.0 && GST_BUFFER_FLAG_IS_SET (outbuf,
+          GST_BUFFER_FLAG_GAP)) {
+    /* nothing was mixed into the output yet, so it only contains silence and
+     * adding to it would give back the input unchanged */
+    memcpy (outmap.data + out_offset * bpf, inmap.data + in_offset * bpf,
+        num_frames * bpf);
+  } else if (pad->volume == 1.0) {
+    /* further buffers, need to add them */
     switch (srcpad->info.finfo->format) {
       case GST_AUDIO_FORMAT_U8:
         audiomixer_orc_add_u8 ((gpointer) (outmap.data + out_offset * bpf),
@@ -55,6 +55,11 @@ struct _GstAudioMixerPad {
   gint volume_i16;
   gint volume_i8;
   gboolean mute;
+
+  /* per-frame volumes if the volume is controlled, only accessed from the
+   * streaming thread */
+  gdouble *volumes;
+  guint volumes_count;
 };
 
 G_END_DECLS
@@ -70,6 +70,8 @@ GST_DEBUG_CATEGORY (audio_resample_debug);
 #define DEFAULT_SINC_FILTER_MODE GST_AUDIO_RESAMPLER_FILTER_MODE_AUTO
 #define DEFAULT_SINC_FILTER_AUTO_THRESHOLD (1*1048576)
 #define DEFAULT_SINC_FILTER_INTERPOLATION GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC
+#define DEFAULT_N_THREADS 1
+#define DEFAULT_MINIMUM_PHASE FALSE
 
 enum
 {
@@ -78,7 +80,9 @@ enum
   PROP_RESAMPLE_METHOD,
   PROP_SINC_FILTER_MODE,
   PROP_SINC_FILTER_AUTO_THRESHOLD,
-  PROP_SINC_FILTER_INTERPOLATION
+  PROP_SINC_FILTER_INTERPOLATION,
+  PROP_N_THREADS,
+  PROP_MINIMUM_PHASE
 };
 
 #define SUPPORTED_CAPS \
@@ -184,6 +188,35 @@ gst_audio_resample_class_init (GstAudioResampleClass * klass)
           DEFAULT_SINC_FILTER_INTERPOLATION,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioResample:n-threads:
+   *
+   * Maximum number of threads to resample with. The channels are split up
+   * between the threads, which helps with streams with many channels.
+   * 0 uses one thread per CPU core.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use", 0, G_MAXUINT,
+          DEFAULT_N_THREADS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioResample:minimum-phase:
+   *
+   * Use a minimum phase filter. This reduces the latency of the sinc based
+   * methods to a few samples at the cost of a non-linear phase response.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MINIMUM_PHASE,
+      g_param_spec_boolean ("minimum-phase", "Minimum phase",
+          "Use a low latency minimum phase filter", DEFAULT_MINIMUM_PHASE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class,
       &gst_audio_resample_src_template);
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -236,6 +269,8 @@ gst_audio_resample_init (GstAudioResample * resample)
   resample->sinc_filter_mode = DEFAULT_SINC_FILTER_MODE;
   resample->sinc_filter_auto_threshold = DEFAULT_SINC_FILTER_AUTO_THRESHOLD;
   resample->sinc_filter_interpolation = DEFAULT_SINC_FILTER_INTERPOLATION;
+  resample->n_threads = DEFAULT_N_THREADS;
+  resample->minimum_phase = DEFAULT_MINIMUM_PHASE;
 
   gst_base_transform_set_gap_aware (trans, TRUE);
   gst_pad_set_query_function (trans->srcpad, gst_audio_resample_query);
@@ -387,7 +422,9 @@ make_options (GstAudioResample * resample, GstAudioInfo * in,
       G_TYPE_UINT, resample->sinc_filter_auto_threshold,
       GST_AUDIO_RESAMPLER_OPT_FILTER_INTERPOLATION,
       GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION,
-      resample->sinc_filter_interpolation, NULL);
+      resample->sinc_filter_interpolation, GST_AUDIO_RESAMPLER_OPT_THREADS,
+      G_TYPE_UINT, resample->n_threads, GST_AUDIO_RESAMPLER_OPT_MINIMUM_PHASE,
+      G_TYPE_BOOLEAN, resample->minimum_phase, NULL);
 
   return options;
 }
@@ -1088,6 +1125,15 @@ gst_audio_resample_set_property (GObject * object, guint prop_id,
       resample->sinc_filter_interpolation = g_value_get_enum (value);
       gst_audio_resample_update_state (resample, NULL, NULL);
       break;
+    case PROP_N_THREADS:
+      /* only used when a new resampler is created */
+      resample->n_threads = g_value_get_uint (value);
+      break;
+    case PROP_MINIMUM_PHASE:
+      /* FIXME locking! */
+      resample->minimum_phase = g_value_get_boolean (value);
+      gst_audio_resample_update_state (resample, NULL, NULL);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1118,6 +1164,12 @@ gst_audio_resample_get_property (GObject * object, guint prop_id,
     case PROP_SINC_FILTER_INTERPOLATION:
       g_value_set_enum (value, resample->sinc_filter_interpolation);
       break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, resample->n_threads);
+      break;
+    case PROP_MINIMUM_PHASE:
+      g_value_set_boolean (value, resample->minimum_phase);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
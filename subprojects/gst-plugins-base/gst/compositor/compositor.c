@@ -92,6 +92,8 @@
 
 #include <string.h>
 
+#include <gst/allocators/gstdmabuf.h>
+
 #include "compositor.h"
 
 #ifdef DISABLE_ORC
@@ -116,7 +118,9 @@ static GstStaticPadTemplate src_factory = GST_STATIC_PAD_TEMPLATE ("src",
 static GstStaticPadTemplate sink_factory = GST_STATIC_PAD_TEMPLATE ("sink_%u",
     GST_PAD_SINK,
     GST_PAD_REQUEST,
-    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL))
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL) ";"
+        GST_VIDEO_CAPS_MAKE_WITH_FEATURES (GST_CAPS_FEATURE_MEMORY_DMABUF,
+            GST_VIDEO_FORMATS_ALL))
     );
 
 static void gst_compositor_child_proxy_init (gpointer g_iface,
@@ -648,6 +652,16 @@ gst_compositor_pad_create_conversion_info (GstVideoAggregatorConvertPad * pad,
   }
 }
 
+static void
+gst_compositor_pad_finalize (GObject * object)
+{
+  GstCompositorPad *pad = GST_COMPOSITOR_PAD (object);
+
+  gst_clear_buffer (&pad->damage_buffer);
+
+  G_OBJECT_CLASS (gst_compositor_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_compositor_pad_class_init (GstCompositorPadClass * klass)
 {
@@ -659,6 +673,7 @@ gst_compositor_pad_class_init (GstCompositorPadClass * klass)
 
   gobject_class->set_property = gst_compositor_pad_set_property;
   gobject_class->get_property = gst_compositor_pad_get_property;
+  gobject_class->finalize = gst_compositor_pad_finalize;
 
   g_object_class_install_property (gobject_class, PROP_PAD_XPOS,
       g_param_spec_int ("xpos", "X Position", "X Position of the picture",
@@ -721,6 +736,7 @@ gst_compositor_pad_init (GstCompositorPad * compo_pad)
   compo_pad->width = DEFAULT_PAD_WIDTH;
   compo_pad->height = DEFAULT_PAD_HEIGHT;
   compo_pad->sizing_policy = DEFAULT_PAD_SIZING_POLICY;
+  compo_pad->damage_index = -1;
 }
 
 
@@ -728,6 +744,7 @@ gst_compositor_pad_init (GstCompositorPad * compo_pad)
 #define DEFAULT_BACKGROUND COMPOSITOR_BACKGROUND_CHECKER
 #define DEFAULT_ZERO_SIZE_IS_UNSCALED TRUE
 #define DEFAULT_MAX_THREADS 0
+#define DEFAULT_DAMAGE_TRACKING FALSE
 
 enum
 {
@@ -736,6 +753,7 @@ enum
   PROP_ZERO_SIZE_IS_UNSCALED,
   PROP_MAX_THREADS,
   PROP_IGNORE_INACTIVE_PADS,
+  PROP_DAMAGE_TRACKING,
 };
 
 static void
@@ -758,6 +776,11 @@ gst_compositor_get_property (GObject * object,
       g_value_set_boolean (value,
           gst_aggregator_get_ignore_inactive_pads (GST_AGGREGATOR (object)));
       break;
+    case PROP_DAMAGE_TRACKING:
+      GST_OBJECT_LOCK (self);
+      g_value_set_boolean (value, self->damage_tracking);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -772,7 +795,10 @@ gst_compositor_set_property (GObject * object,
 
   switch (prop_id) {
     case PROP_BACKGROUND:
+      GST_OBJECT_LOCK (self);
       self->background = g_value_get_enum (value);
+      self->damage_all = TRUE;
+      GST_OBJECT_UNLOCK (self);
       break;
     case PROP_ZERO_SIZE_IS_UNSCALED:
       self->zero_size_is_unscaled = g_value_get_boolean (value);
@@ -784,6 +810,12 @@ gst_compositor_set_property (GObject * object,
       gst_aggregator_set_ignore_inactive_pads (GST_AGGREGATOR (object),
           g_value_get_boolean (value));
       break;
+    case PROP_DAMAGE_TRACKING:
+      GST_OBJECT_LOCK (self);
+      self->damage_tracking = g_value_get_boolean (value);
+      self->damage_all = TRUE;
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1213,6 +1245,10 @@ _negotiated_caps (GstAggregator * agg, GstCaps * caps)
     return FALSE;
   }
 
+  GST_OBJECT_LOCK (compositor);
+  gst_clear_buffer (&compositor->last_output);
+  GST_OBJECT_UNLOCK (compositor);
+
   if (compositor->max_threads == 0)
     n_threads = g_get_num_processors ();
   else
@@ -1375,6 +1411,93 @@ blend_pads (struct CompositeTask *comp)
   }
 }
 
+static void
+composite_lines (GstCompositor * compositor, GstVideoFrame * outframe,
+    struct CompositePadInfo *pads_info, guint n_pads, gboolean draw_background,
+    guint line_start, guint line_end)
+{
+  guint i, n_threads, lines_per_thread;
+  struct CompositeTask *tasks;
+  struct CompositeTask **tasks_p;
+
+  n_threads = compositor->blend_runner->n_threads;
+
+  tasks = g_newa (struct CompositeTask, n_threads);
+  tasks_p = g_newa (struct CompositeTask *, n_threads);
+
+  lines_per_thread = (line_end - line_start + n_threads - 1) / n_threads;
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].compositor = compositor;
+    tasks[i].n_pads = n_pads;
+    tasks[i].pads_info = pads_info;
+    tasks[i].out_frame = outframe;
+    tasks[i].draw_background = draw_background;
+    /* This is a dumb split of the work by number of output lines.
+     * If there is a section of the output that reads from a lot of source
+     * pads, then that thread will consume more time. Maybe tracking and
+     * splitting on the source fill rate would produce better results. */
+    tasks[i].dst_line_start =
+        MIN (line_start + i * lines_per_thread, line_end);
+    tasks[i].dst_line_end =
+        MIN (line_start + (i + 1) * lines_per_thread, line_end);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (compositor->blend_runner,
+      (GstParallelizedTaskFunc) blend_pads, (gpointer *) tasks_p);
+}
+
+static void
+mark_damaged_lines (guint8 * damaged, gint height,
+    const GstVideoRectangle * rect)
+{
+  gint start, end;
+
+  if (rect->w <= 0 || rect->h <= 0)
+    return;
+
+  start = CLAMP (rect->y, 0, height);
+  end = CLAMP (rect->y + rect->h, 0, height);
+  if (end > start)
+    memset (damaged + start, 1, end - start);
+}
+
+/* compares what will be composited for @pad with what was composited into
+ * the last output frame and marks the lines that changed in @damaged */
+static void
+update_pad_damage (GstCompositorPad * pad, GstVideoFrame * prepared_frame,
+    gint index, guint8 * damaged, gint height)
+{
+  GstBuffer *buffer = NULL;
+  GstVideoRectangle rect = { 0, };
+
+  if (prepared_frame) {
+    buffer =
+        gst_video_aggregator_pad_get_current_buffer (GST_VIDEO_AGGREGATOR_PAD
+        (pad));
+    rect.x = pad->xpos + pad->x_offset;
+    rect.y = pad->ypos + pad->y_offset;
+    rect.w = GST_VIDEO_FRAME_WIDTH (prepared_frame);
+    rect.h = GST_VIDEO_FRAME_HEIGHT (prepared_frame);
+  }
+
+  if (buffer != pad->damage_buffer || rect.x != pad->damage_rect.x
+      || rect.y != pad->damage_rect.y || rect.w != pad->damage_rect.w
+      || rect.h != pad->damage_rect.h || pad->alpha != pad->damage_alpha
+      || pad->op != pad->damage_op || index != pad->damage_index) {
+    mark_damaged_lines (damaged, height, &pad->damage_rect);
+    mark_damaged_lines (damaged, height, &rect);
+  }
+
+  gst_buffer_replace (&pad->damage_buffer, buffer);
+  pad->damage_rect = rect;
+  pad->damage_alpha = pad->alpha;
+  pad->damage_op = pad->op;
+  pad->damage_index = index;
+}
+
 static GstFlowReturn
 gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
 {
@@ -1385,6 +1508,9 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
   guint drawn_a_pad = FALSE;
   struct CompositePadInfo *pads_info;
   guint i, n_pads = 0;
+  guint out_height;
+  guint8 *damaged = NULL;
+  gboolean use_damage = FALSE;
 
   if (!gst_video_frame_map (&out_frame, &vagg->info, outbuf, GST_MAP_WRITE)) {
     GST_WARNING_OBJECT (vagg, "Could not map output buffer");
@@ -1392,6 +1518,7 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
   }
 
   outframe = &out_frame;
+  out_height = GST_VIDEO_FRAME_HEIGHT (outframe);
 
   /* If one of the frames to be composited completely obscures the background,
    * don't bother drawing the background at all. We can also always use the
@@ -1400,6 +1527,10 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
   draw_background = _should_draw_background (vagg);
 
   GST_OBJECT_LOCK (vagg);
+  if (compositor->damage_tracking)
+    damaged = g_malloc0 (out_height);
+
+  i = 0;
   for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next) {
     GstVideoAggregatorPad *pad = l->data;
     GstVideoFrame *prepared_frame =
@@ -1407,6 +1538,12 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
 
     if (prepared_frame)
       n_pads++;
+
+    if (damaged)
+      update_pad_damage (GST_COMPOSITOR_PAD (pad), prepared_frame, i++,
+          damaged, out_height);
+    else
+      gst_clear_buffer (&GST_COMPOSITOR_PAD (pad)->damage_buffer);
   }
 
   /* If no prepared frame, we should draw background unconditionally in order
@@ -1414,6 +1551,31 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
   if (n_pads == 0)
     draw_background = TRUE;
 
+  if (damaged && compositor->last_output && !compositor->damage_all
+      && draw_background == compositor->last_draw_background) {
+    guint n_damaged = 0;
+
+    for (i = 0; i < out_height; i++)
+      n_damaged += damaged[i];
+
+    /* copying the last frame is only worth it if most of it stays */
+    use_damage = n_damaged < out_height / 2;
+    GST_LOG_OBJECT (vagg, "%u of %u lines damaged", n_damaged, out_height);
+  }
+
+  if (use_damage) {
+    GstVideoFrame last_frame;
+
+    if (gst_video_frame_map (&last_frame, &vagg->info, compositor->last_output,
+            GST_MAP_READ)) {
+      gst_video_frame_copy (outframe, &last_frame);
+      gst_video_frame_unmap (&last_frame);
+    } else {
+      GST_WARNING_OBJECT (vagg, "Could not map last output buffer");
+      use_damage = FALSE;
+    }
+  }
+
   pads_info = g_newa (struct CompositePadInfo, n_pads);
   n_pads = 0;
 
@@ -1444,7 +1606,7 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
        * background, and @prepared_frame has the same format, height, and width
        * as @outframe, then we can just copy it as-is. Subsequent pads (if any)
        * will be composited on top of it. */
-      if (!drawn_a_pad && !draw_background &&
+      if (!use_damage && !drawn_a_pad && !draw_background &&
           frames_can_copy (prepared_frame, outframe)) {
         gst_video_frame_copy (outframe, prepared_frame);
       } else {
@@ -1457,39 +1619,36 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
     }
   }
 
-  {
-    guint n_threads, lines_per_thread;
-    guint out_height;
-    struct CompositeTask *tasks;
-    struct CompositeTask **tasks_p;
-
-    n_threads = compositor->blend_runner->n_threads;
-
-    tasks = g_newa (struct CompositeTask, n_threads);
-    tasks_p = g_newa (struct CompositeTask *, n_threads);
-
-    out_height = GST_VIDEO_FRAME_HEIGHT (outframe);
-    lines_per_thread = (out_height + n_threads - 1) / n_threads;
-
-    for (i = 0; i < n_threads; i++) {
-      tasks[i].compositor = compositor;
-      tasks[i].n_pads = n_pads;
-      tasks[i].pads_info = pads_info;
-      tasks[i].out_frame = outframe;
-      tasks[i].draw_background = draw_background;
-      /* This is a dumb split of the work by number of output lines.
-       * If there is a section of the output that reads from a lot of source
-       * pads, then that thread will consume more time. Maybe tracking and
-       * splitting on the source fill rate would produce better results. */
-      tasks[i].dst_line_start = i * lines_per_thread;
-      tasks[i].dst_line_end = MIN ((i + 1) * lines_per_thread, out_height);
-
-      tasks_p[i] = &tasks[i];
+  if (use_damage) {
+    guint start = 0;
+
+    /* blend again every run of damaged lines */
+    while (start < out_height) {
+      guint end;
+
+      if (!damaged[start]) {
+        start++;
+        continue;
+      }
+      for (end = start + 1; end < out_height && damaged[end]; end++);
+
+      composite_lines (compositor, outframe, pads_info, n_pads,
+          draw_background, start, end);
+      start = end;
     }
+  } else {
+    composite_lines (compositor, outframe, pads_info, n_pads, draw_background,
+        0, out_height);
+  }
 
-    gst_parallelized_task_runner_run (compositor->blend_runner,
-        (GstParallelizedTaskFunc) blend_pads, (gpointer *) tasks_p);
+  if (damaged) {
+    gst_buffer_replace (&compositor->last_output, outbuf);
+    compositor->last_draw_background = draw_background;
+    compositor->damage_all = FALSE;
+  } else {
+    gst_clear_buffer (&compositor->last_output);
   }
+  g_free (damaged);
 
   GST_OBJECT_UNLOCK (vagg);
 
@@ -1532,6 +1691,10 @@ gst_compositor_release_pad (GstElement * element, GstPad * pad)
 
   GST_DEBUG_OBJECT (compositor, "release pad %s:%s", GST_DEBUG_PAD_NAME (pad));
 
+  GST_OBJECT_LOCK (compositor);
+  compositor->damage_all = TRUE;
+  GST_OBJECT_UNLOCK (compositor);
+
   gst_child_proxy_child_removed (GST_CHILD_PROXY (compositor), G_OBJECT (pad),
       GST_OBJECT_NAME (pad));
 
@@ -1611,10 +1774,92 @@ _src_event (GstAggregator * agg, GstEvent * event)
   return GST_AGGREGATOR_CLASS (parent_class)->src_event (agg, event);
 }
 
+static gboolean
+_caps_has_dmabuf (GstCaps * caps)
+{
+  return gst_caps_features_contains (gst_caps_get_features (caps, 0),
+      GST_CAPS_FEATURE_MEMORY_DMABUF);
+}
+
+/* DMABuf memory can be mapped like system memory, so we accept it for
+ * everything we accept in system memory. The blending then reads the frames
+ * directly from the mapped DMABuf, without copying them first. */
+static GstCaps *
+_caps_add_dmabuf (GstCaps * caps)
+{
+  GstCaps *dmabuf_caps;
+  guint i, n;
+
+  dmabuf_caps = gst_caps_copy (caps);
+  n = gst_caps_get_size (dmabuf_caps);
+  for (i = 0; i < n; i++) {
+    gst_caps_set_features (dmabuf_caps, i,
+        gst_caps_features_new (GST_CAPS_FEATURE_MEMORY_DMABUF, NULL));
+  }
+
+  return gst_caps_merge (caps, dmabuf_caps);
+}
+
 static gboolean
 _sink_query (GstAggregator * agg, GstAggregatorPad * bpad, GstQuery * query)
 {
   switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:{
+      GstCaps *filter, *caps;
+      GstQuery *sysmem_query;
+
+      /* the base class only knows about system memory, ask it without our
+       * filter so that DMABuf filters don't turn into empty caps */
+      gst_query_parse_caps (query, &filter);
+      sysmem_query = gst_query_new_caps (NULL);
+      if (!GST_AGGREGATOR_CLASS (parent_class)->sink_query (agg, bpad,
+              sysmem_query)) {
+        gst_query_unref (sysmem_query);
+        return FALSE;
+      }
+
+      gst_query_parse_caps_result (sysmem_query, &caps);
+      caps = _caps_add_dmabuf (gst_caps_ref (caps));
+      gst_query_unref (sysmem_query);
+
+      if (filter) {
+        GstCaps *tmp =
+            gst_caps_intersect_full (filter, caps, GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+
+      return TRUE;
+    }
+    case GST_QUERY_ACCEPT_CAPS:{
+      GstCaps *caps;
+      GstQuery *sysmem_query;
+      gboolean result;
+
+      gst_query_parse_accept_caps (query, &caps);
+      if (!_caps_has_dmabuf (caps))
+        break;
+
+      caps = gst_caps_copy (caps);
+      gst_caps_set_features (caps, 0, NULL);
+      sysmem_query = gst_query_new_accept_caps (caps);
+      gst_caps_unref (caps);
+
+      if (!GST_AGGREGATOR_CLASS (parent_class)->sink_query (agg, bpad,
+              sysmem_query)) {
+        gst_query_unref (sysmem_query);
+        return FALSE;
+      }
+
+      gst_query_parse_accept_caps_result (sysmem_query, &result);
+      gst_query_set_accept_caps_result (query, result);
+      gst_query_unref (sysmem_query);
+
+      return TRUE;
+    }
     case GST_QUERY_ALLOCATION:{
       GstCaps *caps;
       GstVideoInfo info;
@@ -1630,6 +1875,13 @@ _sink_query (GstAggregator * agg, GstAggregatorPad * bpad, GstQuery * query)
       if (!gst_video_info_from_caps (&info, caps))
         return FALSE;
 
+      /* upstream allocates the DMABuf memory, we only need the video meta
+       * for its strides and plane offsets */
+      if (_caps_has_dmabuf (caps)) {
+        gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+        return TRUE;
+      }
+
       size = GST_VIDEO_INFO_SIZE (&info);
 
       pool = gst_video_buffer_pool_new ();
@@ -1649,8 +1901,10 @@ _sink_query (GstAggregator * agg, GstAggregatorPad * bpad, GstQuery * query)
       return TRUE;
     }
     default:
-      return GST_AGGREGATOR_CLASS (parent_class)->sink_query (agg, bpad, query);
+      break;
   }
+
+  return GST_AGGREGATOR_CLASS (parent_class)->sink_query (agg, bpad, query);
 }
 
 static void
@@ -1661,6 +1915,7 @@ gst_compositor_finalize (GObject * object)
   if (compositor->blend_runner)
     gst_parallelized_task_runner_free (compositor->blend_runner);
   compositor->blend_runner = NULL;
+  gst_clear_buffer (&compositor->last_output);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -1724,6 +1979,24 @@ gst_compositor_class_init (GstCompositorClass * klass)
           GST_PARAM_MUTABLE_READY | G_PARAM_READWRITE |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * compositor:damage-tracking:
+   *
+   * Only blend the lines of the output that changed since the previous
+   * output frame and copy the others from it. Lines change when a pad gets
+   * a new buffer, or when its position, size, alpha, operator or stacking
+   * order changes. This is useful when most of the inputs are static, but
+   * it keeps a reference to the previous output frame, so downstream
+   * elements have to copy it to write into it.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_DAMAGE_TRACKING,
+      g_param_spec_boolean ("damage-tracking", "Damage tracking",
+          "Only blend the parts of the output that changed since the "
+          "previous frame", DEFAULT_DAMAGE_TRACKING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &src_factory, GST_TYPE_AGGREGATOR_PAD);
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
@@ -1766,6 +2039,7 @@ gst_compositor_init (GstCompositor * self)
   self->background = DEFAULT_BACKGROUND;
   self->zero_size_is_unscaled = DEFAULT_ZERO_SIZE_IS_UNSCALED;
   self->max_threads = DEFAULT_MAX_THREADS;
+  self->damage_tracking = DEFAULT_DAMAGE_TRACKING;
 }
 
 /* GstChildProxy implementation */
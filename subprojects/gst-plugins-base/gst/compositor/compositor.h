@@ -145,6 +145,13 @@ struct _GstCompositor
   FillColorFunction fill_color;
 
   GstParallelizedTaskRunner *blend_runner;
+
+  /* damage tracking: only the lines that changed since the last output
+   * frame are blended again, the rest is copied from last_output */
+  gboolean damage_tracking;
+  GstBuffer *last_output;
+  gboolean last_draw_background;
+  gboolean damage_all;
 };
 
 /**
@@ -168,6 +175,14 @@ struct _GstCompositorPad
    * keep-aspect-ratio */
   gint x_offset;
   gint y_offset;
+
+  /* what was composited for this pad into the last output frame, for
+   * damage tracking */
+  GstBuffer *damage_buffer;
+  GstVideoRectangle damage_rect;
+  gdouble damage_alpha;
+  GstCompositorOperator damage_op;
+  gint damage_index;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (compositor);
@@ -268,6 +268,11 @@ struct _GstDecodebin3
 
   /* Properties */
   GstCaps *caps;
+  GstClockTime decoder_cache_time;
+
+  /* List of DecoderCacheEntry for decoders that were recently released and
+   * are kept in READY for reuse. Protected by the object lock */
+  GList *decoder_cache;
 };
 
 struct _GstDecodebin3Class
@@ -378,9 +383,12 @@ typedef struct _PendingPad
 enum
 {
   PROP_0,
-  PROP_CAPS
+  PROP_CAPS,
+  PROP_DECODER_CACHE_TIME
 };
 
+#define DEFAULT_DECODER_CACHE_TIME 0
+
 /* signals */
 enum
 {
@@ -511,6 +519,8 @@ static void reconfigure_output_stream (DecodebinOutputStream * output,
     MultiQueueSlot * slot);
 static void free_output_stream (GstDecodebin3 * dbin,
     DecodebinOutputStream * output);
+static void release_decoder (GstDecodebin3 * dbin, GstElement * decoder);
+static void decoder_cache_clear (GstDecodebin3 * dbin);
 static DecodebinOutputStream *create_output_stream (GstDecodebin3 * dbin,
     GstStreamType type);
 
@@ -562,6 +572,23 @@ gst_decodebin3_class_init (GstDecodebin3Class * klass)
           "The caps on which to stop decoding. (NULL = default)",
           GST_TYPE_CAPS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDecodebin3:decoder-cache-time:
+   *
+   * Time during which decoders that are not needed anymore, for example after
+   * switching to a track with different caps, are kept around in the READY
+   * state. If a later stream switch needs a decoder that accepts the new caps
+   * one of those is reused instead of creating and initializing a new one.
+   * 0 disables the cache.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_klass, PROP_DECODER_CACHE_TIME,
+      g_param_spec_uint64 ("decoder-cache-time", "Decoder cache time",
+          "Time to keep unused decoders around for reuse in ns (0 = disabled)",
+          0, G_MAXUINT64, DEFAULT_DECODER_CACHE_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /* FIXME : ADD SIGNALS ! */
   /**
    * GstDecodebin3::select-stream
@@ -645,6 +672,7 @@ gst_decodebin3_init (GstDecodebin3 * dbin)
   g_mutex_init (&dbin->input_lock);
 
   dbin->caps = gst_static_caps_get (&default_raw_caps);
+  dbin->decoder_cache_time = DEFAULT_DECODER_CACHE_TIME;
 
   GST_OBJECT_FLAG_SET (dbin, GST_BIN_FLAG_STREAMS_AWARE);
 }
@@ -666,6 +694,7 @@ gst_decodebin3_dispose (GObject * object)
   g_list_free (dbin->to_activate);
   g_list_free (dbin->pending_select_streams);
   g_clear_object (&dbin->collection);
+  decoder_cache_clear (dbin);
 
   free_input (dbin, dbin->main_input);
 
@@ -696,6 +725,11 @@ gst_decodebin3_set_property (GObject * object, guint prop_id,
       dbin->caps = g_value_dup_boxed (value);
       GST_OBJECT_UNLOCK (dbin);
       break;
+    case PROP_DECODER_CACHE_TIME:
+      GST_OBJECT_LOCK (dbin);
+      dbin->decoder_cache_time = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (dbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -715,6 +749,11 @@ gst_decodebin3_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_boxed (value, dbin->caps);
       GST_OBJECT_UNLOCK (dbin);
       break;
+    case PROP_DECODER_CACHE_TIME:
+      GST_OBJECT_LOCK (dbin);
+      g_value_set_uint64 (value, dbin->decoder_cache_time);
+      GST_OBJECT_UNLOCK (dbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2293,16 +2332,117 @@ have_factory (GstDecodebin3 * dbin, GstCaps * caps,
 }
 #endif
 
+/* Process-wide cache of the decoder factory that last handled a media type.
+ * Restarting on a stream of an already seen type (e.g. when zapping) tries
+ * that decoder first, skipping the factory list filtering and any decoder
+ * that failed to open before it. Cleared when the registry changes. */
+static GMutex decoder_hints_lock;
+static GHashTable *decoder_hints = NULL;
+static guint32 decoder_hints_cookie = 0;
+
+/* Returns the interned name of the hinted decoder factory for @caps */
+static const gchar *
+decoder_hint_lookup (GstCaps * caps)
+{
+  const gchar *res = NULL;
+  guint32 cookie;
+
+  if (gst_caps_get_size (caps) != 1)
+    return NULL;
+
+  cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
+
+  g_mutex_lock (&decoder_hints_lock);
+  if (decoder_hints) {
+    if (decoder_hints_cookie != cookie)
+      g_hash_table_remove_all (decoder_hints);
+    else
+      res = g_hash_table_lookup (decoder_hints,
+          GUINT_TO_POINTER (gst_structure_get_name_id (gst_caps_get_structure
+                  (caps, 0))));
+  }
+  g_mutex_unlock (&decoder_hints_lock);
+
+  return res;
+}
+
+static void
+decoder_hint_store (GstCaps * caps, GstElementFactory * factory)
+{
+  GQuark type;
+
+  if (gst_caps_get_size (caps) != 1)
+    return;
+
+  type = gst_structure_get_name_id (gst_caps_get_structure (caps, 0));
+
+  g_mutex_lock (&decoder_hints_lock);
+  if (!decoder_hints)
+    decoder_hints = g_hash_table_new (NULL, NULL);
+  decoder_hints_cookie =
+      gst_registry_get_feature_list_cookie (gst_registry_get ());
+  if (factory)
+    g_hash_table_insert (decoder_hints, GUINT_TO_POINTER (type),
+        (gpointer) g_intern_string (gst_plugin_feature_get_name (factory)));
+  else
+    g_hash_table_remove (decoder_hints, GUINT_TO_POINTER (type));
+  g_mutex_unlock (&decoder_hints_lock);
+}
+
+/* Returns the hinted decoder factory for @caps, if it can still handle
+ * them, as a single entry list */
 static GList *
-create_decoder_factory_list (GstDecodebin3 * dbin, GstCaps * caps)
+create_decoder_hint_list (GstDecodebin3 * dbin, GstCaps * caps,
+    const gchar ** hint_name)
 {
-  GList *res;
+  GstElementFactory *factory;
+  const gchar *name;
+
+  *hint_name = NULL;
+  name = decoder_hint_lookup (caps);
+  if (!name)
+    return NULL;
+
+  factory = gst_element_factory_find (name);
+  if (!factory)
+    return NULL;
+
+  if (!gst_element_factory_can_sink_any_caps (factory, caps)) {
+    gst_object_unref (factory);
+    return NULL;
+  }
+
+  GST_DEBUG_OBJECT (dbin, "Trying decoder '%s' first for %" GST_PTR_FORMAT,
+      name, caps);
+  *hint_name = name;
+  return g_list_prepend (NULL, factory);
+}
+
+/* @exclude: name of a factory to leave out of the list */
+static GList *
+create_decoder_factory_list (GstDecodebin3 * dbin, GstCaps * caps,
+    const gchar * exclude)
+{
+  GList *res, *tmp;
 
   g_mutex_lock (&dbin->factories_lock);
   gst_decode_bin_update_factories_list (dbin);
   res = gst_element_factory_list_filter (dbin->decoder_factories,
       caps, GST_PAD_SINK, TRUE);
   g_mutex_unlock (&dbin->factories_lock);
+
+  if (exclude) {
+    for (tmp = res; tmp; tmp = tmp->next) {
+      GstPluginFeature *feature = tmp->data;
+
+      if (g_str_equal (gst_plugin_feature_get_name (feature), exclude)) {
+        res = g_list_delete_link (res, tmp);
+        gst_object_unref (feature);
+        break;
+      }
+    }
+  }
+
   return res;
 }
 
@@ -2324,6 +2464,129 @@ keyframe_waiter_probe (GstPad * pad, GstPadProbeInfo * info,
   return GST_PAD_PROBE_DROP;
 }
 
+typedef struct
+{
+  GstElement *decoder;
+  /* monotonic time after which the decoder is dropped */
+  gint64 expiry;
+} DecoderCacheEntry;
+
+static void
+decoder_cache_entry_free (DecoderCacheEntry * entry)
+{
+  gst_element_set_state (entry->decoder, GST_STATE_NULL);
+  gst_object_unref (entry->decoder);
+  g_free (entry);
+}
+
+/* Call with the object lock. Returns the expired entries which must be freed
+ * outside of the lock */
+static GList *
+decoder_cache_steal_expired (GstDecodebin3 * dbin, gint64 now)
+{
+  GList *tmp, *next, *expired = NULL;
+
+  for (tmp = dbin->decoder_cache; tmp; tmp = next) {
+    DecoderCacheEntry *entry = tmp->data;
+
+    next = tmp->next;
+    if (entry->expiry > now)
+      continue;
+
+    dbin->decoder_cache = g_list_delete_link (dbin->decoder_cache, tmp);
+    expired = g_list_prepend (expired, entry);
+  }
+
+  return expired;
+}
+
+static void
+decoder_cache_clear (GstDecodebin3 * dbin)
+{
+  GList *entries;
+
+  GST_OBJECT_LOCK (dbin);
+  entries = dbin->decoder_cache;
+  dbin->decoder_cache = NULL;
+  GST_OBJECT_UNLOCK (dbin);
+
+  g_list_free_full (entries, (GDestroyNotify) decoder_cache_entry_free);
+}
+
+/* Removes @decoder from the bin, and either keeps it in READY in the decoder
+ * cache or shuts it down */
+static void
+release_decoder (GstDecodebin3 * dbin, GstElement * decoder)
+{
+  DecoderCacheEntry *entry;
+  GstClockTime cache_time;
+  GList *expired;
+  gint64 now = g_get_monotonic_time ();
+
+  GST_OBJECT_LOCK (dbin);
+  cache_time = dbin->decoder_cache_time;
+  expired = decoder_cache_steal_expired (dbin, now);
+  GST_OBJECT_UNLOCK (dbin);
+
+  g_list_free_full (expired, (GDestroyNotify) decoder_cache_entry_free);
+
+  gst_element_set_locked_state (decoder, TRUE);
+
+  if (cache_time == 0 || gst_element_set_state (decoder,
+          GST_STATE_READY) == GST_STATE_CHANGE_FAILURE) {
+    gst_element_set_state (decoder, GST_STATE_NULL);
+    gst_bin_remove ((GstBin *) dbin, decoder);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (dbin, "Keeping decoder '%s' for reuse",
+      GST_ELEMENT_NAME (decoder));
+
+  gst_object_ref (decoder);
+  gst_bin_remove ((GstBin *) dbin, decoder);
+
+  entry = g_new0 (DecoderCacheEntry, 1);
+  entry->decoder = decoder;
+  entry->expiry = now + GST_TIME_AS_USECONDS (cache_time);
+
+  GST_OBJECT_LOCK (dbin);
+  dbin->decoder_cache = g_list_prepend (dbin->decoder_cache, entry);
+  GST_OBJECT_UNLOCK (dbin);
+}
+
+/* Returns a cached decoder accepting @caps, most recently released first */
+static GstElement *
+take_cached_decoder (GstDecodebin3 * dbin, GstCaps * caps)
+{
+  GList *tmp, *expired;
+  GstElement *decoder = NULL;
+
+  GST_OBJECT_LOCK (dbin);
+  expired = decoder_cache_steal_expired (dbin, g_get_monotonic_time ());
+  for (tmp = dbin->decoder_cache; tmp; tmp = tmp->next) {
+    DecoderCacheEntry *entry = tmp->data;
+    GstPad *sinkpad = gst_element_get_static_pad (entry->decoder, "sink");
+    gboolean accepted = FALSE;
+
+    if (sinkpad) {
+      accepted = gst_pad_query_accept_caps (sinkpad, caps);
+      gst_object_unref (sinkpad);
+    }
+
+    if (accepted) {
+      decoder = entry->decoder;
+      g_free (entry);
+      dbin->decoder_cache = g_list_delete_link (dbin->decoder_cache, tmp);
+      break;
+    }
+  }
+  GST_OBJECT_UNLOCK (dbin);
+
+  g_list_free_full (expired, (GDestroyNotify) decoder_cache_entry_free);
+
+  return decoder;
+}
+
 static void
 reconfigure_output_stream (DecodebinOutputStream * output,
     MultiQueueSlot * slot)
@@ -2391,10 +2654,7 @@ reconfigure_output_stream (DecodebinOutputStream * output,
       goto cleanup;
     }
 
-    gst_element_set_locked_state (output->decoder, TRUE);
-    gst_element_set_state (output->decoder, GST_STATE_NULL);
-
-    gst_bin_remove ((GstBin *) dbin, output->decoder);
+    release_decoder (dbin, output->decoder);
     output->decoder = NULL;
     output->decoder_latency = GST_CLOCK_TIME_NONE;
   } else if (output->linked) {
@@ -2413,12 +2673,63 @@ reconfigure_output_stream (DecodebinOutputStream * output,
 
   /* If a decoder is required, create one */
   if (needs_decoder) {
-    GList *factories, *next_factory;
+    GList *factories = NULL, *next_factory = NULL;
+    const gchar *hint_name = NULL;
+
+    /* Prefer a recently released decoder that accepts the new caps, it is
+     * already initialized */
+    output->decoder = take_cached_decoder (dbin, new_caps);
+    if (output->decoder) {
+      GST_DEBUG_OBJECT (dbin, "Reusing cached decoder '%s'",
+          GST_ELEMENT_NAME (output->decoder));
+      if (!gst_bin_add ((GstBin *) dbin, output->decoder)) {
+        GST_WARNING_OBJECT (dbin, "could not add cached decoder to pipeline");
+        gst_element_set_state (output->decoder, GST_STATE_NULL);
+        gst_object_unref (output->decoder);
+        output->decoder = NULL;
+      } else {
+        gst_object_unref (output->decoder);
+        gst_element_set_locked_state (output->decoder, FALSE);
+        output->decoder_sink =
+            gst_element_get_static_pad (output->decoder, "sink");
+        output->decoder_src =
+            gst_element_get_static_pad (output->decoder, "src");
+        if (output->type & GST_STREAM_TYPE_VIDEO) {
+          GST_DEBUG_OBJECT (dbin, "Adding keyframe-waiter probe");
+          output->drop_probe_id =
+              gst_pad_add_probe (slot->src_pad, GST_PAD_PROBE_TYPE_BUFFER,
+              (GstPadProbeCallback) keyframe_waiter_probe, output, NULL);
+        }
+        if (gst_pad_link_full (slot->src_pad, output->decoder_sink,
+                GST_PAD_LINK_CHECK_NOTHING) != GST_PAD_LINK_OK) {
+          GST_ERROR_OBJECT (dbin, "could not link to %s:%s",
+              GST_DEBUG_PAD_NAME (output->decoder_sink));
+          gst_caps_unref (new_caps);
+          goto cleanup;
+        }
+      }
+    }
 
-    factories = next_factory = create_decoder_factory_list (dbin, new_caps);
+    if (!output->decoder) {
+      factories = next_factory =
+          create_decoder_hint_list (dbin, new_caps, &hint_name);
+      if (!factories)
+        factories = next_factory =
+            create_decoder_factory_list (dbin, new_caps, NULL);
+    }
     while (!output->decoder) {
       gboolean decoder_failed = FALSE;
 
+      /* The hinted decoder didn't work out, forget it and go through the
+       * other candidates */
+      if (!next_factory && hint_name) {
+        decoder_hint_store (new_caps, NULL);
+        gst_plugin_feature_list_free (factories);
+        factories = next_factory =
+            create_decoder_factory_list (dbin, new_caps, hint_name);
+        hint_name = NULL;
+      }
+
       /* If we don't have a decoder yet, instantiate one */
       if (next_factory) {
         output->decoder = gst_element_factory_create ((GstElementFactory *)
@@ -2489,6 +2800,9 @@ reconfigure_output_stream (DecodebinOutputStream * output,
       next_factory = next_factory->next;
     }
     gst_plugin_feature_list_free (factories);
+
+    if (!hint_name)
+      decoder_hint_store (new_caps, gst_element_get_factory (output->decoder));
   } else {
     output->decoder_src = gst_object_ref (slot->src_pad);
     output->decoder_sink = NULL;
@@ -3130,11 +3444,8 @@ free_output_stream (GstDecodebin3 * dbin, DecodebinOutputStream * output)
   if (output->src_exposed) {
     gst_element_remove_pad ((GstElement *) dbin, output->src_pad);
   }
-  if (output->decoder) {
-    gst_element_set_locked_state (output->decoder, TRUE);
-    gst_element_set_state (output->decoder, GST_STATE_NULL);
-    gst_bin_remove ((GstBin *) dbin, output->decoder);
-  }
+  if (output->decoder)
+    release_decoder (dbin, output->decoder);
   g_free (output);
 }
 
@@ -3165,6 +3476,7 @@ gst_decodebin3_change_state (GstElement * element, GstStateChange transition)
       }
       g_list_free (dbin->output_streams);
       dbin->output_streams = NULL;
+      decoder_cache_clear (dbin);
       /* Free multiqueue slots */
       for (tmp = dbin->slots; tmp; tmp = tmp->next) {
         MultiQueueSlot *slot = (MultiQueueSlot *) tmp->data;
@@ -932,17 +932,27 @@ gst_raw_video_parse_process (GstRawBaseParse * raw_base_parse,
     return FALSE;
   }
 
-  /* Allocate the output memory our required alignment */
-  *processed_data = out_data = gst_buffer_new_allocate (NULL,
-      GST_VIDEO_INFO_SIZE (video_info), &alloc_params);
-  gst_buffer_fill (*processed_data, 0, map_info.data,
-      GST_VIDEO_INFO_SIZE (video_info));
-  gst_buffer_unmap (in_data, &map_info);
-
-  /* And copy the metadata */
-  gst_buffer_copy_into (*processed_data, in_data,
-      GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0,
-      GST_VIDEO_INFO_SIZE (video_info));
+  if (gst_buffer_n_memory (in_data) == 1 &&
+      ((guintptr) map_info.data & alloc_params.align) == 0) {
+    /* The frame already is one block with our required alignment, e.g. when
+     * it comes from a memory mapped file, so share it instead of copying */
+    gst_buffer_unmap (in_data, &map_info);
+    *processed_data = out_data = gst_buffer_copy_region (in_data,
+        GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS |
+        GST_BUFFER_COPY_MEMORY, 0, GST_VIDEO_INFO_SIZE (video_info));
+  } else {
+    /* Allocate the output memory our required alignment */
+    *processed_data = out_data = gst_buffer_new_allocate (NULL,
+        GST_VIDEO_INFO_SIZE (video_info), &alloc_params);
+    gst_buffer_fill (*processed_data, 0, map_info.data,
+        GST_VIDEO_INFO_SIZE (video_info));
+    gst_buffer_unmap (in_data, &map_info);
+
+    /* And copy the metadata */
+    gst_buffer_copy_into (*processed_data, in_data,
+        GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0,
+        GST_VIDEO_INFO_SIZE (video_info));
+  }
 
   if (config_ptr->interlaced) {
     GST_BUFFER_FLAG_SET (out_data, GST_VIDEO_BUFFER_FLAG_INTERLACED);
@@ -117,6 +117,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 
 #include "gsttcpelements.h"
@@ -647,6 +648,62 @@ ioctl_failed:
   }
 }
 
+/* the most buffers and memories we send in one gathered write */
+#define GATHER_MAX_BUFFERS 16
+#define GATHER_MAX_VECTORS 64
+
+/* Map the memories of the buffers in @sending into @vec, starting at
+ * @offset in the first buffer. A buffer is only added when all of its
+ * memories fit. Returns the number of vectors and their total size in
+ * @size. */
+static guint
+map_sending_iovec (GSList * sending, gsize offset, struct iovec *vec,
+    GstMapInfo * maps, gssize * size)
+{
+  guint n_vecs = 0;
+
+  *size = 0;
+  for (; sending; sending = sending->next) {
+    GstBuffer *buf = GST_BUFFER (sending->data);
+    guint i, n_mem = gst_buffer_n_memory (buf);
+
+    if (n_mem > GATHER_MAX_VECTORS - n_vecs)
+      break;
+
+    for (i = 0; i < n_mem; i++) {
+      GstMemory *mem = gst_buffer_peek_memory (buf, i);
+      GstMapInfo *map = &maps[n_vecs];
+
+      if (!gst_memory_map (mem, map, GST_MAP_READ))
+        g_error ("Unable to map memory %p.  This should never happen.", mem);
+
+      /* skip what was already written of the first buffer */
+      if (offset >= map->size) {
+        offset -= map->size;
+        gst_memory_unmap (mem, map);
+        continue;
+      }
+
+      vec[n_vecs].iov_base = map->data + offset;
+      vec[n_vecs].iov_len = map->size - offset;
+      *size += vec[n_vecs].iov_len;
+      offset = 0;
+      n_vecs++;
+    }
+  }
+
+  return n_vecs;
+}
+
+static void
+unmap_iovec (GstMapInfo * maps, guint n_vecs)
+{
+  guint i;
+
+  for (i = 0; i < n_vecs; i++)
+    gst_memory_unmap (maps[i].memory, &maps[i]);
+}
+
 /* Handle a write on a client,
  * which indicates a read request from a client.
  *
@@ -677,8 +734,6 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
   gboolean flushing;
   GstClockTime now, now_monotonic;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
-  GstMultiHandleSinkClass *mhsinkclass =
-      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
   GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
   int fd = mhclient->handle.fd;
 
@@ -686,7 +741,7 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
 
   more = TRUE;
   do {
-    gint maxsize;
+    gssize maxsize;
 
     now = g_get_real_time () * GST_USECOND;
     now_monotonic = g_get_monotonic_time () * GST_USECOND;
@@ -706,9 +761,6 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
         return TRUE;
       } else {
         /* client can pick a buffer from the global queue */
-        GstBuffer *buf;
-        GstClockTime timestamp;
-
         /* for new connections, we need to find a good spot in the
          * bufqueue to start streaming from */
         if (mhclient->new_connection && !flushing) {
@@ -731,26 +783,7 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
         if (mhclient->flushcount == 0)
           goto flushed;
 
-        /* grab buffer */
-        buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
-        mhclient->bufpos--;
-
-        /* update stats */
-        timestamp = GST_BUFFER_TIMESTAMP (buf);
-        if (mhclient->first_buffer_ts == GST_CLOCK_TIME_NONE)
-          mhclient->first_buffer_ts = timestamp;
-        if (timestamp != -1)
-          mhclient->last_buffer_ts = timestamp;
-
-        /* decrease flushcount */
-        if (mhclient->flushcount != -1)
-          mhclient->flushcount--;
-
-        GST_LOG_OBJECT (sink, "%s client %p at position %d",
-            mhclient->debug, client, mhclient->bufpos);
-
-        /* queueing a buffer will ref it */
-        mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
+        gst_multi_handle_sink_client_queue_next (mhsink, mhclient);
 
         /* need to start from the first byte for this new buffer */
         mhclient->bufoffset = 0;
@@ -761,31 +794,35 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
     if (mhclient->sending) {
       ssize_t wrote;
       GstBuffer *head;
-      GstMapInfo info;
-      guint8 *data;
+      struct iovec vec[GATHER_MAX_VECTORS];
+      GstMapInfo maps[GATHER_MAX_VECTORS];
+      guint n_vecs;
 
-      /* pick first buffer from list */
-      head = GST_BUFFER (mhclient->sending->data);
+      /* pick up the other buffers that are ready, they are written along
+       * with the first one */
+      gst_multi_handle_sink_client_queue_ready (mhsink, mhclient,
+          GATHER_MAX_BUFFERS);
 
-      if (!gst_buffer_map (head, &info, GST_MAP_READ))
-        g_return_val_if_reached (FALSE);
-
-      data = info.data;
-      maxsize = info.size - mhclient->bufoffset;
+      n_vecs = map_sending_iovec (mhclient->sending, mhclient->bufoffset, vec,
+          maps, &maxsize);
 
       /* FIXME: specific */
-      /* try to write the complete buffer */
+      /* try to write the complete buffers */
 #ifdef MSG_NOSIGNAL
 #define FLAGS MSG_NOSIGNAL
 #else
 #define FLAGS 0
 #endif
       if (client->is_socket) {
-        wrote = send (fd, data + mhclient->bufoffset, maxsize, FLAGS);
+        struct msghdr msg = { 0, };
+
+        msg.msg_iov = vec;
+        msg.msg_iovlen = n_vecs;
+        wrote = sendmsg (fd, &msg, FLAGS);
       } else {
-        wrote = write (fd, data + mhclient->bufoffset, maxsize);
+        wrote = writev (fd, vec, n_vecs);
       }
-      gst_buffer_unmap (head, &info);
+      unmap_iovec (maps, n_vecs);
 
       if (wrote < 0) {
         /* hmm error.. */
@@ -798,20 +835,34 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
           goto write_error;
         }
       } else {
+        gsize left = wrote;
+
         if (wrote < maxsize) {
           /* partial write means that the client cannot read more and we should
            * stop sending more */
           GST_LOG_OBJECT (sink,
               "partial write on %s of %" G_GSSIZE_FORMAT " bytes",
               mhclient->debug, wrote);
-          mhclient->bufoffset += wrote;
           more = FALSE;
-        } else {
+        }
+
+        /* drop the buffers that were completely written */
+        while (mhclient->sending) {
+          gsize head_left;
+
+          head = GST_BUFFER (mhclient->sending->data);
+          head_left = gst_buffer_get_size (head) - mhclient->bufoffset;
+          if (left < head_left) {
+            mhclient->bufoffset += left;
+            break;
+          }
+
           /* complete buffer was written, we can proceed to the next one */
           mhclient->sending = g_slist_remove (mhclient->sending, head);
           gst_buffer_unref (head);
           /* make sure we start from byte 0 for the next buffer */
           mhclient->bufoffset = 0;
+          left -= head_left;
         }
         /* update stats */
         mhclient->bytes_sent += wrote;
@@ -1531,6 +1531,61 @@ gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
   return result;
 }
 
+/* take the buffer at the client position in the global queue and add it
+ * to the buffers the client is sending. The client only takes a ref on
+ * the buffer, the data is never copied. */
+void
+gst_multi_handle_sink_client_queue_next (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client)
+{
+  GstMultiHandleSinkClass *mhsinkclass = GST_MULTI_HANDLE_SINK_GET_CLASS (sink);
+  GstBuffer *buf;
+  GstClockTime timestamp;
+
+  g_return_if_fail (client->bufpos >= 0);
+
+  /* grab buffer */
+  buf = g_array_index (sink->bufqueue, GstBuffer *, client->bufpos);
+  client->bufpos--;
+
+  /* update stats */
+  timestamp = GST_BUFFER_TIMESTAMP (buf);
+  if (client->first_buffer_ts == GST_CLOCK_TIME_NONE)
+    client->first_buffer_ts = timestamp;
+  if (timestamp != -1)
+    client->last_buffer_ts = timestamp;
+
+  /* decrease flushcount */
+  if (client->flushcount != -1)
+    client->flushcount--;
+
+  GST_LOG_OBJECT (sink, "%s client %p at position %d",
+      client->debug, client, client->bufpos);
+
+  /* queueing a buffer will ref it */
+  mhsinkclass->client_queue_buffer (sink, client, buf);
+}
+
+/* queue more of the buffers the client has not picked from the global
+ * queue yet, so that they can all go out in a single gathered write.
+ * Stops once the client has @max_buffers buffers to send. */
+void
+gst_multi_handle_sink_client_queue_ready (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client, guint max_buffers)
+{
+  guint n_sending;
+
+  if (client->new_connection)
+    return;
+
+  n_sending = g_slist_length (client->sending);
+  while (n_sending < max_buffers && client->bufpos >= 0
+      && client->flushcount != 0) {
+    gst_multi_handle_sink_client_queue_next (sink, client);
+    n_sending = g_slist_length (client->sending);
+  }
+}
+
 /* calculate the new position for a client after recovery. This function
  * does not update the client position but merely returns the required
  * position.
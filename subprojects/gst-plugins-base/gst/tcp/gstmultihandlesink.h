@@ -183,6 +183,12 @@ gint gst_multi_handle_sink_setup_dscp_client (GstMultiHandleSink * sink, GstMult
 gint
 gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
     GstMultiHandleClient * client);
+void
+gst_multi_handle_sink_client_queue_next (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client);
+void
+gst_multi_handle_sink_client_queue_ready (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client, guint max_buffers);
 
 /**
  * GstMultiHandleSink:
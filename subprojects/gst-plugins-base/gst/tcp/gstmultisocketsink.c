@@ -774,22 +774,47 @@ gst_buffer_get_cmsg_list (GstBuffer * buf, GSocketControlMessage ** msgs,
 
 #define CMSG_MAX 255
 
+/* the most buffers and memories we send in one gathered write */
+#define GATHER_MAX_BUFFERS 16
+#define GATHER_MAX_VECTORS 64
+
+/* Write as much as possible of the buffers in @sending, starting at
+ * @bufoffset in the first one, with a single sendmsg(). Only the control
+ * messages of the first buffer are sent, so gathering stops at the next
+ * buffer that has some. */
 static gssize
 gst_multi_socket_sink_write (GstMultiSocketSink * sink,
-    GSocket * sock, GstBuffer * buffer, gsize bufoffset,
+    GSocket * sock, GSList * sending, gsize bufoffset,
     GCancellable * cancellable, GError ** err)
 {
-  GstMapInfo maps[8];
-  GOutputVector vec[8];
+  GstMapInfo maps[GATHER_MAX_VECTORS];
+  GOutputVector vec[GATHER_MAX_VECTORS];
   guint mems_mapped;
   gssize wrote;
   GSocketControlMessage *cmsgs[CMSG_MAX];
   gsize msg_count;
+  GstBuffer *buffer = GST_BUFFER (sending->data);
 
-  mems_mapped = map_n_memory_output_vector (buffer, bufoffset, vec, maps, 8);
+  mems_mapped = map_n_memory_output_vector (buffer, bufoffset, vec, maps,
+      GATHER_MAX_VECTORS);
 
   msg_count = gst_buffer_get_cmsg_list (buffer, cmsgs, CMSG_MAX);
 
+  for (sending = sending->next; sending; sending = sending->next) {
+    buffer = GST_BUFFER (sending->data);
+
+    if (gst_buffer_get_size (buffer) == 0)
+      continue;
+    /* never send a buffer partially mapped, nor with the wrong cmsgs */
+    if (gst_buffer_n_memory (buffer) > GATHER_MAX_VECTORS - mems_mapped)
+      break;
+    if (gst_buffer_get_meta (buffer, GST_NET_CONTROL_MESSAGE_META_API_TYPE))
+      break;
+
+    mems_mapped += map_n_memory_output_vector (buffer, 0, vec + mems_mapped,
+        maps + mems_mapped, GATHER_MAX_VECTORS - mems_mapped);
+  }
+
   wrote =
       g_socket_send_message (sock, NULL, vec, mems_mapped, cmsgs, msg_count, 0,
       cancellable, err);
@@ -829,8 +854,6 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
   GError *err = NULL;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
   GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
-  GstMultiHandleSinkClass *mhsinkclass =
-      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
 
 
   now = g_get_real_time () * GST_USECOND;
@@ -854,9 +877,6 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
         return TRUE;
       } else {
         /* client can pick a buffer from the global queue */
-        GstBuffer *buf;
-        GstClockTime timestamp;
-
         /* for new connections, we need to find a good spot in the
          * bufqueue to start streaming from */
         if (mhclient->new_connection && !flushing) {
@@ -878,26 +898,7 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
         if (mhclient->flushcount == 0)
           goto flushed;
 
-        /* grab buffer */
-        buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
-        mhclient->bufpos--;
-
-        /* update stats */
-        timestamp = GST_BUFFER_TIMESTAMP (buf);
-        if (mhclient->first_buffer_ts == GST_CLOCK_TIME_NONE)
-          mhclient->first_buffer_ts = timestamp;
-        if (timestamp != -1)
-          mhclient->last_buffer_ts = timestamp;
-
-        /* decrease flushcount */
-        if (mhclient->flushcount != -1)
-          mhclient->flushcount--;
-
-        GST_LOG_OBJECT (sink, "%s client %p at position %d",
-            mhclient->debug, client, mhclient->bufpos);
-
-        /* queueing a buffer will ref it */
-        mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
+        gst_multi_handle_sink_client_queue_next (mhsink, mhclient);
 
         /* need to start from the first byte for this new buffer */
         mhclient->bufoffset = 0;
@@ -909,11 +910,13 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
       gssize wrote;
       GstBuffer *head;
 
-      /* pick first buffer from list */
-      head = GST_BUFFER (mhclient->sending->data);
+      /* pick up the other buffers that are ready, they are written along
+       * with the first one */
+      gst_multi_handle_sink_client_queue_ready (mhsink, mhclient,
+          GATHER_MAX_BUFFERS);
 
-      wrote = gst_multi_socket_sink_write (sink, mhclient->handle.socket, head,
-          mhclient->bufoffset, sink->cancellable, &err);
+      wrote = gst_multi_socket_sink_write (sink, mhclient->handle.socket,
+          mhclient->sending, mhclient->bufoffset, sink->cancellable, &err);
 
       if (wrote < 0) {
         /* hmm error.. */
@@ -929,13 +932,24 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           goto write_error;
         }
       } else {
-        if (wrote < (gst_buffer_get_size (head) - mhclient->bufoffset)) {
-          /* partial write, try again now */
-          GST_LOG_OBJECT (sink,
-              "partial write on %p of %" G_GSSIZE_FORMAT " bytes",
-              mhclient->handle.socket, wrote);
-          mhclient->bufoffset += wrote;
-        } else {
+        gsize left = wrote;
+
+        /* drop the buffers that were completely written */
+        while (mhclient->sending) {
+          gsize head_left;
+
+          head = GST_BUFFER (mhclient->sending->data);
+          head_left = gst_buffer_get_size (head) - mhclient->bufoffset;
+
+          if (left < head_left) {
+            /* partial write, try again now */
+            GST_LOG_OBJECT (sink,
+                "partial write on %p of %" G_GSSIZE_FORMAT " bytes",
+                mhclient->handle.socket, wrote);
+            mhclient->bufoffset += left;
+            break;
+          }
+
           if (sink->send_dispatched) {
             gst_pad_push_event (GST_BASE_SINK_PAD (mhsink),
                 gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
@@ -948,6 +962,7 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           gst_buffer_unref (head);
           /* make sure we start from byte 0 for the next buffer */
           mhclient->bufoffset = 0;
+          left -= head_left;
         }
         /* update stats */
         mhclient->bytes_sent += wrote;
@@ -47,6 +47,10 @@
  * ]|
  *  Decode an Ogg/Theora and display the video with a width of 100.
  *
+ * A #GstVideoCropMeta on the input buffers is applied while converting, so
+ * upstream elements like videocrop or decoders can describe a crop without
+ * copying the image first.
+ *
  * Since: 1.22
  */
 
@@ -80,6 +84,7 @@
 
 #include <gst/video/gstvideometa.h>
 #include <gst/video/gstvideopool.h>
+#include <gst/allocators/gstdmabuf.h>
 
 #include "gstvideoconvertscale.h"
 
@@ -104,6 +109,10 @@ typedef struct
   gdouble alpha_value;
 
   GstVideoConverter *convert;
+  /* the input region @convert reads, changed by the crop meta of the input
+   * buffers. The frame size is the size of the whole image */
+  gint src_x, src_y, src_width, src_height;
+  gint frame_width, frame_height;
 
   gint borders_h;
   gint borders_w;
@@ -252,6 +261,13 @@ static GstCaps *gst_video_convert_scale_fixate_caps (GstBaseTransform * base,
 static gboolean gst_video_convert_scale_transform_meta (GstBaseTransform *
     trans, GstBuffer * outbuf, GstMeta * meta, GstBuffer * inbuf);
 
+static gboolean gst_video_convert_scale_propose_allocation (GstBaseTransform
+    * trans, GstQuery * decide_query, GstQuery * query);
+static gboolean gst_video_convert_scale_decide_allocation (GstBaseTransform *
+    trans, GstQuery * query);
+static gboolean gst_video_convert_scale_query (GstBaseTransform * trans,
+    GstPadDirection direction, GstQuery * query);
+
 static gboolean gst_video_convert_scale_set_info (GstVideoFilter * filter,
     GstCaps * in, GstVideoInfo * in_info, GstCaps * out,
     GstVideoInfo * out_info);
@@ -263,9 +279,6 @@ static void gst_video_convert_scale_set_property (GObject * object,
 static void gst_video_convert_scale_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec);
 
-static GstCapsFeatures *features_format_interlaced,
-    *features_format_interlaced_sysmem;
-
 static gboolean
 gst_video_convert_scale_filter_meta (GstBaseTransform * trans, GstQuery * query,
     GType api, const GstStructure * params)
@@ -292,13 +305,6 @@ gst_video_convert_scale_class_init (GstVideoConvertScaleClass * klass)
       "videoconvertscale element");
   GST_DEBUG_CATEGORY_GET (CAT_PERFORMANCE, "GST_PERFORMANCE");
 
-  features_format_interlaced =
-      gst_caps_features_new (GST_CAPS_FEATURE_FORMAT_INTERLACED, NULL);
-  features_format_interlaced_sysmem =
-      gst_caps_features_copy (features_format_interlaced);
-  gst_caps_features_add (features_format_interlaced_sysmem,
-      GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY);
-
   _colorspace_quark = g_quark_from_static_string ("colorspace");
 
   gobject_class->finalize =
@@ -403,6 +409,11 @@ gst_video_convert_scale_class_init (GstVideoConvertScaleClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_convert_scale_src_event);
   trans_class->transform_meta =
       GST_DEBUG_FUNCPTR (gst_video_convert_scale_transform_meta);
+  trans_class->propose_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_convert_scale_propose_allocation);
+  trans_class->decide_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_convert_scale_decide_allocation);
+  trans_class->query = GST_DEBUG_FUNCPTR (gst_video_convert_scale_query);
 
   filter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_convert_scale_set_info);
   filter_class->transform_frame =
@@ -573,6 +584,48 @@ gst_video_convert_scale_get_property (GObject * object, guint prop_id,
   GST_OBJECT_UNLOCK (object);
 }
 
+/* Caps features we can convert: system memory and DMABuf memory, which can
+ * be mapped like system memory, both optionally with interlaced content */
+static gboolean
+gst_video_convert_scale_features_are_convertible (GstCapsFeatures * features)
+{
+  guint i, n;
+
+  if (gst_caps_features_is_any (features))
+    return FALSE;
+
+  n = gst_caps_features_get_size (features);
+  for (i = 0; i < n; i++) {
+    const gchar *feature = gst_caps_features_get_nth (features, i);
+
+    if (strcmp (feature, GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY) &&
+        strcmp (feature, GST_CAPS_FEATURE_MEMORY_DMABUF) &&
+        strcmp (feature, GST_CAPS_FEATURE_FORMAT_INTERLACED))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Returns @features with the memory feature swapped between system memory
+ * and DMABuf memory */
+static GstCapsFeatures *
+gst_video_convert_scale_features_swap_memory (GstCapsFeatures * features)
+{
+  GstCapsFeatures *ret = gst_caps_features_copy (features);
+
+  if (gst_caps_features_contains (ret, GST_CAPS_FEATURE_MEMORY_DMABUF)) {
+    gst_caps_features_remove (ret, GST_CAPS_FEATURE_MEMORY_DMABUF);
+    if (gst_caps_features_get_size (ret) == 0)
+      gst_caps_features_add (ret, GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY);
+  } else {
+    gst_caps_features_remove (ret, GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY);
+    gst_caps_features_add (ret, GST_CAPS_FEATURE_MEMORY_DMABUF);
+  }
+
+  return ret;
+}
+
 static GstCaps *
 gst_video_convert_caps_remove_format_and_rangify_size_info (GstVideoConvertScale
     * self, GstCaps * caps)
@@ -597,12 +650,9 @@ gst_video_convert_caps_remove_format_and_rangify_size_info (GstVideoConvertScale
 
     structure = gst_structure_copy (structure);
     /* Only remove format info for the cases when we can actually convert */
-    if (!gst_caps_features_is_any (features)
-        && (gst_caps_features_is_equal (features,
-                GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY)
-            || gst_caps_features_is_equal (features, features_format_interlaced)
-            || gst_caps_features_is_equal (features,
-                features_format_interlaced_sysmem))) {
+    if (gst_video_convert_scale_features_are_convertible (features)) {
+      GstCapsFeatures *other_features;
+      gboolean is_dmabuf;
 
       if (priv->scales) {
         gst_structure_set (structure, "width", GST_TYPE_INT_RANGE, 1, G_MAXINT,
@@ -618,6 +668,25 @@ gst_video_convert_caps_remove_format_and_rangify_size_info (GstVideoConvertScale
         gst_structure_remove_fields (structure, "format", "colorimetry",
             "chroma-site", NULL);
       }
+
+      /* We can convert between system memory and DMABuf memory too. System
+       * memory goes first, as we can only output DMABuf memory into a pool
+       * provided by downstream */
+      other_features = gst_video_convert_scale_features_swap_memory (features);
+      is_dmabuf =
+          gst_caps_features_contains (features, GST_CAPS_FEATURE_MEMORY_DMABUF);
+
+      if (is_dmabuf) {
+        gst_caps_append_structure_full (ret, gst_structure_copy (structure),
+            other_features);
+        gst_caps_append_structure_full (ret, structure,
+            gst_caps_features_copy (features));
+      } else {
+        gst_caps_append_structure_full (ret, gst_structure_copy (structure),
+            gst_caps_features_copy (features));
+        gst_caps_append_structure_full (ret, structure, other_features);
+      }
+      continue;
     }
     gst_caps_append_structure_full (ret, structure,
         gst_caps_features_copy (features));
@@ -656,7 +725,8 @@ gst_video_convert_scale_transform_caps (GstBaseTransform * trans,
     GstCapsFeatures *f = gst_caps_get_features (ret, i);
 
     if (!f || gst_caps_features_is_any (f) ||
-        gst_caps_features_is_equal (f, GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY))
+        gst_caps_features_is_equal (f, GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY)
+        || gst_video_convert_scale_features_are_convertible (f))
       continue;
 
     for (j = 0; j < gst_caps_features_get_size (f); j++) {
@@ -675,6 +745,60 @@ gst_video_convert_scale_transform_caps (GstBaseTransform * trans,
   return ret;
 }
 
+static gboolean
+gst_video_convert_scale_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query)
+{
+  GstCaps *caps;
+
+  gst_query_parse_allocation (query, &caps, NULL);
+
+  /* if we are not passthrough, we apply the crop meta while converting */
+  if (decide_query) {
+    GST_DEBUG_OBJECT (trans, "Advertising video meta and crop meta support");
+    gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+    gst_query_add_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE, NULL);
+  }
+
+  /* Upstream allocates the DMABuf memory, we read it through the video meta
+   * with whatever strides and plane offsets it uses */
+  if (decide_query && caps && gst_caps_features_contains
+      (gst_caps_get_features (caps, 0), GST_CAPS_FEATURE_MEMORY_DMABUF))
+    return TRUE;
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->propose_allocation (trans,
+      decide_query, query);
+}
+
+static gboolean
+gst_video_convert_scale_decide_allocation (GstBaseTransform * trans,
+    GstQuery * query)
+{
+  GstCaps *outcaps;
+
+  gst_query_parse_allocation (query, &outcaps, NULL);
+
+  /* We can't allocate DMABuf memory ourselves, only write into the buffers
+   * of a pool provided by downstream */
+  if (outcaps && gst_caps_features_contains (gst_caps_get_features (outcaps,
+              0), GST_CAPS_FEATURE_MEMORY_DMABUF)) {
+    GstBufferPool *pool = NULL;
+
+    if (gst_query_get_n_allocation_pools (query) > 0)
+      gst_query_parse_nth_allocation_pool (query, 0, &pool, NULL, NULL, NULL);
+
+    if (!pool) {
+      GST_WARNING_OBJECT (trans, "Downstream provided no pool for DMABuf "
+          "output caps %" GST_PTR_FORMAT, outcaps);
+      return FALSE;
+    }
+    gst_object_unref (pool);
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->decide_allocation (trans,
+      query);
+}
+
 static gboolean
 gst_video_convert_scale_transform_meta (GstBaseTransform * trans,
     GstBuffer * outbuf, GstMeta * meta, GstBuffer * inbuf)
@@ -690,6 +814,10 @@ gst_video_convert_scale_transform_meta (GstBaseTransform * trans,
     GST_META_TAG_VIDEO_SIZE_STR,
   };
 
+  /* the crop was applied while converting */
+  if (info->api == GST_VIDEO_CROP_META_API_TYPE)
+    return FALSE;
+
   tags = gst_meta_api_type_get_tags (info->api);
 
   /* No specific tags, we are good to copy */
@@ -905,6 +1033,10 @@ gst_video_convert_scale_set_info (GstVideoFilter * filter, GstCaps * in,
     priv->convert = gst_video_converter_new (in_info, out_info, options);
     if (priv->convert == NULL)
       goto no_convert;
+
+    priv->src_x = priv->src_y = 0;
+    priv->frame_width = priv->src_width = GST_VIDEO_INFO_WIDTH (in_info);
+    priv->frame_height = priv->src_height = GST_VIDEO_INFO_HEIGHT (in_info);
   }
 
   GST_DEBUG_OBJECT (filter, "converting format %s -> %s",
@@ -1755,15 +1887,84 @@ gst_video_convert_scale_fixate_caps (GstBaseTransform * base,
     (gpointer)(((guint8*)(GST_VIDEO_FRAME_PLANE_DATA (frame, 0))) + \
      GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0) * (line))
 
+/* Makes the converter read the given region of frames of the given size.
+ * Crops rarely change, so the converter is only recreated when they do */
+static gboolean
+gst_video_convert_scale_set_src_region (GstVideoFilter * filter, gint x,
+    gint y, gint width, gint height, gint frame_width, gint frame_height)
+{
+  GstVideoConvertScalePrivate *priv = PRIV (filter);
+  GstVideoConverter *convert;
+  GstStructure *config;
+  GstVideoInfo in_info;
+
+  if (x == priv->src_x && y == priv->src_y && width == priv->src_width &&
+      height == priv->src_height && frame_width == priv->frame_width &&
+      frame_height == priv->frame_height)
+    return TRUE;
+
+  GST_DEBUG_OBJECT (filter, "converting region %dx%d at %d,%d of %dx%d",
+      width, height, x, y, frame_width, frame_height);
+
+  in_info = filter->in_info;
+  in_info.width = frame_width;
+  in_info.height = frame_height;
+
+  config = gst_structure_copy (gst_video_converter_get_config (priv->convert));
+  gst_structure_set (config,
+      GST_VIDEO_CONVERTER_OPT_SRC_X, G_TYPE_INT, x,
+      GST_VIDEO_CONVERTER_OPT_SRC_Y, G_TYPE_INT, y,
+      GST_VIDEO_CONVERTER_OPT_SRC_WIDTH, G_TYPE_INT, width,
+      GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT, G_TYPE_INT, height, NULL);
+
+  convert = gst_video_converter_new (&in_info, &filter->out_info, config);
+  if (convert == NULL) {
+    GST_ERROR_OBJECT (filter, "could not create converter for the crop");
+    return FALSE;
+  }
+
+  gst_video_converter_free (priv->convert);
+  priv->convert = convert;
+  priv->src_x = x;
+  priv->src_y = y;
+  priv->src_width = width;
+  priv->src_height = height;
+  priv->frame_width = frame_width;
+  priv->frame_height = frame_height;
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_video_convert_scale_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame)
 {
   GstVideoConvertScalePrivate *priv = PRIV (filter);
+  GstVideoCropMeta *crop;
   GstFlowReturn ret = GST_FLOW_OK;
 
   GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, filter, "doing video scaling");
 
+  crop = gst_buffer_get_video_crop_meta (in_frame->buffer);
+  if (crop && crop->width > 0 && crop->height > 0 &&
+      crop->x + crop->width <= GST_VIDEO_FRAME_WIDTH (in_frame) &&
+      crop->y + crop->height <= GST_VIDEO_FRAME_HEIGHT (in_frame)) {
+    if (!gst_video_convert_scale_set_src_region (filter, crop->x, crop->y,
+            crop->width, crop->height, GST_VIDEO_FRAME_WIDTH (in_frame),
+            GST_VIDEO_FRAME_HEIGHT (in_frame)))
+      return GST_FLOW_ERROR;
+  } else {
+    if (crop)
+      GST_WARNING_OBJECT (filter, "ignoring invalid crop meta");
+
+    if (!gst_video_convert_scale_set_src_region (filter, 0, 0,
+            GST_VIDEO_INFO_WIDTH (&filter->in_info),
+            GST_VIDEO_INFO_HEIGHT (&filter->in_info),
+            GST_VIDEO_INFO_WIDTH (&filter->in_info),
+            GST_VIDEO_INFO_HEIGHT (&filter->in_info)))
+      return GST_FLOW_ERROR;
+  }
+
   gst_video_converter_frame (priv->convert, in_frame, out_frame);
 
   return ret;
@@ -1801,6 +2002,43 @@ gst_video_convert_scale_src_event (GstBaseTransform * trans, GstEvent * event)
   return ret;
 }
 
+/* Answers preferred size queries from upstream decoders with the output size
+ * when downstream restricts it to a fixed size, so that a decoder supporting
+ * reduced resolution decoding does not produce frames we scale down anyway */
+static gboolean
+gst_video_convert_scale_query (GstBaseTransform * trans,
+    GstPadDirection direction, GstQuery * query)
+{
+  GstVideoConvertScalePrivate *priv = PRIV (trans);
+
+  if (direction == GST_PAD_SINK && priv->scales &&
+      gst_video_query_is_preferred_size (query)) {
+    GstCaps *peercaps;
+    gboolean ret = FALSE;
+
+    peercaps = gst_pad_peer_query_caps (GST_BASE_TRANSFORM_SRC_PAD (trans),
+        NULL);
+    if (gst_caps_get_size (peercaps) == 1) {
+      GstStructure *s = gst_caps_get_structure (peercaps, 0);
+      gint width, height;
+
+      if (gst_structure_get_int (s, "width", &width) &&
+          gst_structure_get_int (s, "height", &height)) {
+        GST_DEBUG_OBJECT (trans, "preferred size %dx%d", width, height);
+        gst_video_query_set_preferred_size (query, width, height);
+        ret = TRUE;
+      }
+    }
+    gst_caps_unref (peercaps);
+
+    if (ret)
+      return TRUE;
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->query (trans, direction,
+      query);
+}
+
 void
 gst_video_convert_scale_set_scales (GstVideoConvertScale * self,
     gboolean scales)
@@ -57,6 +57,14 @@
  * certain factor. It must not be confused with framerate. Think of rate as
  * speed and framerate as flow.
  *
+ * Duplicated frames are never copied: they share the memory of the frame they
+ * repeat and only carry their own timestamps, offsets and metadata. They are
+ * also flagged with %GST_BUFFER_FLAG_GAP so downstream elements can skip
+ * processing them again. When frames only ever need to be dropped, setting
+ * #GstVideoRate:drop-only removes the one frame of latency the element
+ * otherwise introduces to decide which input frame is closest to each output
+ * timestamp.
+ *
  * ## Example pipelines
  * |[
  * gst-launch-1.0 -v uridecodebin uri=file:///path/to/video.ogg ! videoconvert ! videoscale ! videorate ! video/x-raw,framerate=15/1 ! autovideosink
@@ -61,6 +61,8 @@ GST_DEBUG_CATEGORY_STATIC (video_test_src_debug);
 #define DEFAULT_FOREGROUND_COLOR   0xffffffff
 #define DEFAULT_BACKGROUND_COLOR   0xff000000
 #define DEFAULT_HORIZONTAL_SPEED   0
+#define DEFAULT_N_THREADS          1
+#define DEFAULT_CACHED_FRAMES      0
 
 enum
 {
@@ -86,6 +88,8 @@ enum
   PROP_ANIMATION_MODE,
   PROP_MOTION_TYPE,
   PROP_FLIP,
+  PROP_N_THREADS,
+  PROP_CACHED_FRAMES,
   PROP_LAST
 };
 
@@ -362,6 +366,40 @@ gst_video_test_src_class_init (GstVideoTestSrcClass * klass)
           G_MININT32, G_MAXINT32, DEFAULT_HORIZONTAL_SPEED,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoTestSrc:n-threads:
+   *
+   * Maximum number of threads used to render a frame. The frame is split
+   * into bands of lines that are rendered in parallel. The ball and
+   * smpte-rp-219 patterns are always rendered by a single thread.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use (0 = number of processors)",
+          0, G_MAXUINT, DEFAULT_N_THREADS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoTestSrc:cached-frames:
+   *
+   * Number of frames to render once and then cycle through instead of
+   * rendering every frame, or 0 to render all frames. Output buffers are
+   * still copies of the cached frames, which makes this useful for
+   * throughput tests where the cost of rendering the pattern would
+   * otherwise dominate.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHED_FRAMES,
+      g_param_spec_uint ("cached-frames", "Cached Frames",
+          "Number of pre-rendered frames to cycle through (0 = disabled)",
+          0, G_MAXUINT16, DEFAULT_CACHED_FRAMES,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "Video test source", "Source/Video",
       "Creates a test video stream", "David A. Schleef <ds@schleef.org>");
@@ -396,6 +434,8 @@ gst_video_test_src_init (GstVideoTestSrc * src)
   src->background_color = DEFAULT_BACKGROUND_COLOR;
   src->horizontal_speed = DEFAULT_HORIZONTAL_SPEED;
   src->random_state = 0;
+  src->n_threads = DEFAULT_N_THREADS;
+  src->n_cached_frames = DEFAULT_CACHED_FRAMES;
 
   /* we operate in time */
   gst_base_src_set_format (GST_BASE_SRC (src), GST_FORMAT_TIME);
@@ -574,6 +614,33 @@ gst_video_test_src_is_static_pattern (GstVideoTestSrc * videotestsrc)
   return TRUE;
 }
 
+static gboolean
+gst_video_test_src_is_sliced_pattern (GstVideoTestSrc * videotestsrc)
+{
+  switch (videotestsrc->pattern_type) {
+      /* These paint the whole frame at once */
+    case GST_VIDEO_TEST_SRC_BALL:
+    case GST_VIDEO_TEST_SRC_SMPTE_RP_219:
+      return FALSE;
+    default:
+      break;
+  }
+
+  return TRUE;
+}
+
+static void
+gst_video_test_src_clear_frame_cache (GstVideoTestSrc * src)
+{
+  guint i;
+
+  for (i = 0; i < src->frame_cache_size; i++)
+    gst_clear_buffer (&src->frame_cache[i]);
+  g_free (src->frame_cache);
+  src->frame_cache = NULL;
+  src->frame_cache_size = 0;
+}
+
 static void
 gst_video_test_src_set_pattern (GstVideoTestSrc * videotestsrc,
     int pattern_type)
@@ -739,6 +806,14 @@ gst_video_test_src_set_property (GObject * object, guint prop_id,
     case PROP_FLIP:
       src->flip = g_value_get_boolean (value);
       break;
+    case PROP_N_THREADS:
+      src->n_threads = g_value_get_uint (value);
+      invalidate = FALSE;
+      break;
+    case PROP_CACHED_FRAMES:
+      src->n_cached_frames = g_value_get_uint (value);
+      invalidate = FALSE;
+      break;
     default:
       break;
   }
@@ -747,6 +822,7 @@ gst_video_test_src_set_property (GObject * object, guint prop_id,
     /* Property change invalidated the current pattern - check if it's static now or not */
     src->have_static_pattern = gst_video_test_src_is_static_pattern (src);
     gst_clear_buffer (&src->cached);
+    gst_video_test_src_clear_frame_cache (src);
   }
 }
 
@@ -820,6 +896,12 @@ gst_video_test_src_get_property (GObject * object, guint prop_id,
     case PROP_FLIP:
       g_value_set_boolean (value, src->flip);
       break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, src->n_threads);
+      break;
+    case PROP_CACHED_FRAMES:
+      g_value_set_uint (value, src->n_cached_frames);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -938,15 +1020,88 @@ gst_video_test_src_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
   return GST_BASE_SRC_CLASS (parent_class)->decide_allocation (bsrc, query);
 }
 
+static void
+gst_video_test_src_free_slices (GstVideoTestSrc * src)
+{
+  guint i, j;
+
+  for (i = 0; i < src->n_slices; i++) {
+    GstVideoTestSrcSlice *slice = &src->slices[i];
+
+    g_free (slice->tmpline);
+    g_free (slice->tmpline2);
+    g_free (slice->tmpline_u8);
+    g_free (slice->tmpline_u16);
+
+    for (j = 0; j < src->n_lines; j++)
+      g_free (slice->lines[j]);
+    g_free (slice->lines);
+  }
+  g_free (src->slices);
+  src->slices = NULL;
+  src->n_slices = 0;
+}
+
+/* Must be called with the new info, n_lines and offset already set */
+static void
+gst_video_test_src_alloc_slices (GstVideoTestSrc * src, guint n_threads)
+{
+  gint width = GST_VIDEO_INFO_WIDTH (&src->info);
+  gint height = GST_VIDEO_INFO_HEIGHT (&src->info);
+  guint n_lines = src->n_lines;
+  gint slice_height;
+  guint i, j;
+
+  /* Every slice but the last one needs to cover a multiple of n_lines so
+   * that each slice subsamples and packs its own group of lines */
+  n_threads = CLAMP (n_threads, 1, MAX (height / n_lines, 1));
+  slice_height = (height + n_threads - 1) / n_threads;
+  slice_height = ((slice_height + n_lines - 1) / n_lines) * n_lines;
+
+  src->n_slices = (height + slice_height - 1) / slice_height;
+  src->n_slices = MAX (src->n_slices, 1);
+  src->slices = g_new0 (GstVideoTestSrcSlice, src->n_slices);
+
+  for (i = 0; i < src->n_slices; i++) {
+    GstVideoTestSrcSlice *slice = &src->slices[i];
+
+    slice->src = src;
+    slice->y_start = i * slice_height;
+    slice->y_end = MIN ((i + 1) * slice_height, height);
+
+    slice->tmpline_u8 = g_malloc (width + 8);
+    slice->tmpline = g_malloc ((width + 8) * 4);
+    slice->tmpline2 = g_malloc ((width + 8) * 4);
+    slice->tmpline_u16 = g_malloc ((width + 16) * 8);
+
+    slice->lines = g_malloc (sizeof (gpointer) * n_lines);
+    for (j = 0; j < n_lines; j++)
+      slice->lines[j] = g_malloc ((width + 16) * 8);
+  }
+
+  if (src->n_slices > 1) {
+    if (src->task_pool == NULL) {
+      src->task_pool = gst_shared_task_pool_new ();
+      gst_task_pool_prepare (src->task_pool, NULL);
+    }
+    /* the first slice is rendered by the streaming thread */
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+        (src->task_pool), src->n_slices - 1);
+  }
+
+  GST_DEBUG_OBJECT (src, "rendering with %u slices of %d lines",
+      src->n_slices, slice_height);
+}
+
 static gboolean
 gst_video_test_src_setcaps (GstBaseSrc * bsrc, GstCaps * caps)
 {
   const GstStructure *structure;
   GstVideoTestSrc *videotestsrc;
   GstVideoInfo info;
-  guint i;
   guint n_lines;
   gint offset;
+  guint n_threads;
 
   videotestsrc = GST_VIDEO_TEST_SRC (bsrc);
 
@@ -987,9 +1142,7 @@ gst_video_test_src_setcaps (GstBaseSrc * bsrc, GstCaps * caps)
       info.chroma_site, 0, info.finfo->unpack_format, -info.finfo->w_sub[2],
       -info.finfo->h_sub[2]);
 
-  for (i = 0; i < videotestsrc->n_lines; i++)
-    g_free (videotestsrc->lines[i]);
-  g_free (videotestsrc->lines);
+  gst_video_test_src_free_slices (videotestsrc);
 
   if (videotestsrc->subsample != NULL) {
     gst_video_chroma_resample_get_info (videotestsrc->subsample,
@@ -999,9 +1152,6 @@ gst_video_test_src_setcaps (GstBaseSrc * bsrc, GstCaps * caps)
     offset = 0;
   }
 
-  videotestsrc->lines = g_malloc (sizeof (gpointer) * n_lines);
-  for (i = 0; i < n_lines; i++)
-    videotestsrc->lines[i] = g_malloc ((info.width + 16) * 8);
   videotestsrc->n_lines = n_lines;
   videotestsrc->offset = offset;
 
@@ -1011,14 +1161,10 @@ gst_video_test_src_setcaps (GstBaseSrc * bsrc, GstCaps * caps)
   GST_DEBUG_OBJECT (videotestsrc, "size %dx%d, %d/%d fps",
       info.width, info.height, info.fps_n, info.fps_d);
 
-  g_free (videotestsrc->tmpline);
-  g_free (videotestsrc->tmpline2);
-  g_free (videotestsrc->tmpline_u8);
-  g_free (videotestsrc->tmpline_u16);
-  videotestsrc->tmpline_u8 = g_malloc (info.width + 8);
-  videotestsrc->tmpline = g_malloc ((info.width + 8) * 4);
-  videotestsrc->tmpline2 = g_malloc ((info.width + 8) * 4);
-  videotestsrc->tmpline_u16 = g_malloc ((info.width + 16) * 8);
+  n_threads = videotestsrc->n_threads;
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  gst_video_test_src_alloc_slices (videotestsrc, n_threads);
 
   videotestsrc->accum_rtime += videotestsrc->running_time;
   videotestsrc->accum_frames += videotestsrc->n_frames;
@@ -1027,6 +1173,7 @@ gst_video_test_src_setcaps (GstBaseSrc * bsrc, GstCaps * caps)
   videotestsrc->n_frames = 0;
 
   gst_clear_buffer (&videotestsrc->cached);
+  gst_video_test_src_clear_frame_cache (videotestsrc);
 
   GST_OBJECT_UNLOCK (videotestsrc);
 
@@ -1195,6 +1342,62 @@ gst_video_test_src_is_seekable (GstBaseSrc * psrc)
   return TRUE;
 }
 
+static void
+gst_video_test_src_render_slice (gpointer user_data)
+{
+  GstVideoTestSrcSlice *slice = user_data;
+
+  slice->src->make_image (slice->src, slice->pts, slice->frame, slice);
+}
+
+static void
+gst_video_test_src_make_image (GstVideoTestSrc * src, GstClockTime pts,
+    GstVideoFrame * frame)
+{
+  gpointer *ids;
+  guint i;
+
+  if (src->n_slices == 1 || !gst_video_test_src_is_sliced_pattern (src)) {
+    GstVideoTestSrcSlice slice = src->slices[0];
+
+    slice.y_start = 0;
+    slice.y_end = GST_VIDEO_FRAME_HEIGHT (frame);
+    slice.random_state = src->random_state;
+
+    src->make_image (src, pts, frame, &slice);
+
+    src->random_state = slice.random_state;
+    return;
+  }
+
+  for (i = 0; i < src->n_slices; i++) {
+    GstVideoTestSrcSlice *slice = &src->slices[i];
+
+    slice->frame = frame;
+    slice->pts = pts;
+    /* The first slice continues the same random sequence as when rendering
+     * with a single thread, the others get their own */
+    slice->random_state = src->random_state ^ (i * 0x9e3779b9);
+  }
+
+  ids = g_newa (gpointer, src->n_slices);
+  for (i = 1; i < src->n_slices; i++) {
+    ids[i] = gst_task_pool_push (src->task_pool,
+        gst_video_test_src_render_slice, &src->slices[i], NULL);
+    if (ids[i] == NULL)
+      gst_video_test_src_render_slice (&src->slices[i]);
+  }
+
+  gst_video_test_src_render_slice (&src->slices[0]);
+
+  for (i = 1; i < src->n_slices; i++) {
+    if (ids[i] != NULL)
+      gst_task_pool_join (src->task_pool, ids[i]);
+  }
+
+  src->random_state = src->slices[0].random_state;
+}
+
 static GstFlowReturn
 fill_image (GstPushSrc * psrc, GstBuffer * buffer)
 {
@@ -1221,7 +1424,7 @@ fill_image (GstPushSrc * psrc, GstBuffer * buffer)
   if (!gst_video_frame_map (&frame, &src->info, buffer, GST_MAP_WRITE))
     goto invalid_frame;
 
-  src->make_image (src, GST_BUFFER_PTS (buffer), &frame);
+  gst_video_test_src_make_image (src, GST_BUFFER_PTS (buffer), &frame);
 
   if ((pal = gst_video_format_get_palette (GST_VIDEO_FRAME_FORMAT (&frame),
               &palsize))) {
@@ -1247,6 +1450,25 @@ invalid_frame:
   }
 }
 
+static gboolean
+gst_video_test_src_copy_frame (GstVideoTestSrc * src, GstBuffer * cached,
+    GstBuffer * buffer)
+{
+  GstVideoFrame sframe, dframe;
+  gboolean ret = FALSE;
+
+  if (!gst_video_frame_map (&sframe, &src->info, cached, GST_MAP_READ))
+    return FALSE;
+
+  if (gst_video_frame_map (&dframe, &src->info, buffer, GST_MAP_WRITE)) {
+    ret = gst_video_frame_copy (&dframe, &sframe);
+    gst_video_frame_unmap (&dframe);
+  }
+  gst_video_frame_unmap (&sframe);
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_video_test_src_fill (GstPushSrc * psrc, GstBuffer * buffer)
 {
@@ -1260,8 +1482,6 @@ gst_video_test_src_fill (GstPushSrc * psrc, GstBuffer * buffer)
   gst_object_sync_values (GST_OBJECT (src), pts);
 
   if (src->have_static_pattern) {
-    GstVideoFrame sframe, dframe;
-
     if (src->cached == NULL) {
       src->cached = gst_buffer_new_allocate (NULL, src->info.size, NULL);
 
@@ -1276,14 +1496,32 @@ gst_video_test_src_fill (GstPushSrc * psrc, GstBuffer * buffer)
      * be consistent with other sources. This should make things clear for
      * cases where downstream cannot queue the same buffer twice (such as v4l2)
      */
-    gst_video_frame_map (&sframe, &src->info, src->cached, GST_MAP_READ);
-    gst_video_frame_map (&dframe, &src->info, buffer, GST_MAP_WRITE);
-
-    if (!gst_video_frame_copy (&dframe, &sframe))
+    if (!gst_video_test_src_copy_frame (src, src->cached, buffer))
       goto copy_failed;
+  } else if (src->n_cached_frames > 0 && src->n_frames >= 0) {
+    guint idx;
 
-    gst_video_frame_unmap (&sframe);
-    gst_video_frame_unmap (&dframe);
+    if (src->frame_cache == NULL) {
+      src->frame_cache_size = src->n_cached_frames;
+      src->frame_cache = g_new0 (GstBuffer *, src->frame_cache_size);
+    }
+
+    idx = src->n_frames % src->frame_cache_size;
+    if (src->frame_cache[idx] == NULL) {
+      src->frame_cache[idx] =
+          gst_buffer_new_allocate (NULL, src->info.size, NULL);
+
+      ret = fill_image (GST_PUSH_SRC (src), src->frame_cache[idx]);
+      if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+        gst_clear_buffer (&src->frame_cache[idx]);
+        goto fill_failed;
+      }
+    } else {
+      GST_LOG_OBJECT (src, "Reusing pre-rendered frame %u", idx);
+    }
+
+    if (!gst_video_test_src_copy_frame (src, src->frame_cache[idx], buffer))
+      goto copy_failed;
   } else {
     ret = fill_image (GST_PUSH_SRC (src), buffer);
     if (G_UNLIKELY (ret != GST_FLOW_OK))
@@ -1363,27 +1601,21 @@ static gboolean
 gst_video_test_src_stop (GstBaseSrc * basesrc)
 {
   GstVideoTestSrc *src = GST_VIDEO_TEST_SRC (basesrc);
-  guint i;
 
-  g_free (src->tmpline);
-  src->tmpline = NULL;
-  g_free (src->tmpline2);
-  src->tmpline2 = NULL;
-  g_free (src->tmpline_u8);
-  src->tmpline_u8 = NULL;
-  g_free (src->tmpline_u16);
-  src->tmpline_u16 = NULL;
   if (src->subsample)
     gst_video_chroma_resample_free (src->subsample);
   src->subsample = NULL;
 
-  for (i = 0; i < src->n_lines; i++)
-    g_free (src->lines[i]);
-  g_free (src->lines);
+  gst_video_test_src_free_slices (src);
   src->n_lines = 0;
-  src->lines = NULL;
+
+  if (src->task_pool) {
+    gst_task_pool_cleanup (src->task_pool);
+    gst_clear_object (&src->task_pool);
+  }
 
   gst_clear_buffer (&src->cached);
+  gst_video_test_src_clear_frame_cache (src);
 
   return TRUE;
 }
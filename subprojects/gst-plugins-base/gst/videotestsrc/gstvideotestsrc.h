@@ -132,6 +132,32 @@ typedef enum {
   GST_VIDEO_TEST_SRC_HSWEEP
 } GstVideoTestSrcMotionType;
 
+typedef struct _GstVideoTestSrcSlice GstVideoTestSrcSlice;
+
+/* scratch state for rendering one band of lines, one per thread */
+struct _GstVideoTestSrcSlice {
+  GstVideoTestSrc *src;
+
+  /* set for each frame before rendering */
+  GstVideoFrame *frame;
+  GstClockTime pts;
+
+  /* lines [y_start, y_end) of the frame */
+  gint y_start;
+  gint y_end;
+
+  /* temporary AYUV/ARGB scanline */
+  guint8 *tmpline_u8;
+  guint8 *tmpline;
+  guint8 *tmpline2;
+  guint16 *tmpline_u16;
+
+  gpointer *lines;
+
+  /* smpte & snow */
+  guint random_state;
+};
+
 /**
  * GstVideoTestSrc:
  *
@@ -195,21 +221,27 @@ struct _GstVideoTestSrc {
   GstVideoTestSrcMotionType motion_type;
   gboolean flip;
 
-  void (*make_image) (GstVideoTestSrc *v, GstClockTime pts, GstVideoFrame *frame);
-
-  /* temporary AYUV/ARGB scanline */
-  guint8 *tmpline_u8;
-  guint8 *tmpline;
-  guint8 *tmpline2;
-  guint16 *tmpline_u16;
+  void (*make_image) (GstVideoTestSrc *v, GstClockTime pts, GstVideoFrame *frame,
+      GstVideoTestSrcSlice *slice);
 
   guint n_lines;
   gint offset;
-  gpointer *lines;
+
+  /* slice threading, only used when the pattern renders each line
+   * independently of the others */
+  guint n_threads;
+  GstVideoTestSrcSlice *slices;
+  guint n_slices;
+  GstTaskPool *task_pool;
 
   /* cached buffer used for static patterns that don't change */
   GstBuffer *cached;
   gboolean have_static_pattern;
+
+  /* pre-rendered frames that are cycled through instead of rendering */
+  guint n_cached_frames;
+  GstBuffer **frame_cache;
+  guint frame_cache_size;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (videotestsrc);
@@ -201,7 +201,8 @@ static void convert_hline_bayer (paintinfo * p, GstVideoFrame * frame, int y);
    FIX(0.045847*224.0/255.0) * b1 + (ONE_HALF << shift) - 1) >> (SCALEBITS + shift)) + 128)
 
 static void
-videotestsrc_setup_paintinfo (GstVideoTestSrc * v, paintinfo * p, int w, int h)
+videotestsrc_setup_paintinfo (GstVideoTestSrc * v, GstVideoTestSrcSlice * slice,
+    paintinfo * p, int w, int h)
 {
   gint a, r, g, b;
   gint width;
@@ -226,13 +227,15 @@ videotestsrc_setup_paintinfo (GstVideoTestSrc * v, paintinfo * p, int w, int h)
       p->paint_tmpline = paint_tmpline_AYUV;
     }
   }
-  p->tmpline = v->tmpline;
-  p->tmpline2 = v->tmpline2;
-  p->tmpline_u8 = v->tmpline_u8;
-  p->tmpline_u16 = v->tmpline_u16;
+  p->tmpline = slice->tmpline;
+  p->tmpline2 = slice->tmpline2;
+  p->tmpline_u8 = slice->tmpline_u8;
+  p->tmpline_u16 = slice->tmpline_u16;
   p->n_lines = v->n_lines;
   p->offset = v->offset;
-  p->lines = v->lines;
+  p->lines = slice->lines;
+  p->y_start = slice->y_start;
+  p->y_end = slice->y_end;
   p->x_offset = (v->horizontal_speed * v->n_frames) % width;
   if (p->x_offset < 0)
     p->x_offset += width;
@@ -376,7 +379,7 @@ videotestsrc_blend_line (GstVideoTestSrc * v, guint8 * dest,
 
 void
 gst_video_test_src_smpte (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   int y1, y2;
@@ -385,13 +388,13 @@ gst_video_test_src_smpte (GstVideoTestSrc * v, GstClockTime pts,
   paintinfo *p = &pi;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   y1 = 2 * h / 3;
   y2 = 3 * h / 4;
 
   /* color bars */
-  for (j = 0; j < y1; j++) {
+  for (j = p->y_start; j < MIN (y1, p->y_end); j++) {
     for (i = 0; i < 7; i++) {
       int x1 = i * w / 7;
       int x2 = (i + 1) * w / 7;
@@ -403,7 +406,7 @@ gst_video_test_src_smpte (GstVideoTestSrc * v, GstClockTime pts,
   }
 
   /* inverse blue bars */
-  for (j = y1; j < y2; j++) {
+  for (j = MAX (y1, p->y_start); j < MIN (y2, p->y_end); j++) {
     for (i = 0; i < 7; i++) {
       int x1 = i * w / 7;
       int x2 = (i + 1) * w / 7;
@@ -420,7 +423,7 @@ gst_video_test_src_smpte (GstVideoTestSrc * v, GstClockTime pts,
     videotestsrc_convert_tmpline (p, frame, j);
   }
 
-  for (j = y2; j < h; j++) {
+  for (j = MAX (y2, p->y_start); j < p->y_end; j++) {
     /* -I, white, Q regions */
     for (i = 0; i < 3; i++) {
       int x1 = i * w / 6;
@@ -463,7 +466,7 @@ gst_video_test_src_smpte (GstVideoTestSrc * v, GstClockTime pts,
       p->color = &color;
 
       for (i = x1; i < w; i++) {
-        int y = random_char (&v->random_state);
+        int y = random_char (&slice->random_state);
         p->tmpline_u8[i] = y;
       }
       videotestsrc_blend_line (v, p->tmpline, p->tmpline_u8,
@@ -477,7 +480,7 @@ gst_video_test_src_smpte (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_smpte_rp_219 (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   /* heights */
   int b, b1;
@@ -495,7 +498,7 @@ gst_video_test_src_smpte_rp_219 (GstVideoTestSrc * v, GstClockTime pts,
   a = frame->info.width;
   b = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, a, b);
+  videotestsrc_setup_paintinfo (v, slice, p, a, b);
   p->colors = vts_colors_bt709_ycbcr_rp_219;
 
   /* heights */
@@ -811,7 +814,7 @@ gst_video_test_src_smpte_rp_219 (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_smpte75 (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   int j;
@@ -819,7 +822,7 @@ gst_video_test_src_smpte75 (GstVideoTestSrc * v, GstClockTime pts,
   paintinfo *p = &pi;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
   if (v->info.colorimetry.matrix == GST_VIDEO_COLOR_MATRIX_BT601) {
     p->colors = vts_colors_bt601_ycbcr_75;
   } else {
@@ -827,7 +830,7 @@ gst_video_test_src_smpte75 (GstVideoTestSrc * v, GstClockTime pts,
   }
 
   /* color bars */
-  for (j = 0; j < h; j++) {
+  for (j = p->y_start; j < p->y_end; j++) {
     for (i = 0; i < 7; i++) {
       int x1 = i * w / 7;
       int x2 = (i + 1) * w / 7;
@@ -841,7 +844,7 @@ gst_video_test_src_smpte75 (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_smpte100 (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   int j;
@@ -849,10 +852,10 @@ gst_video_test_src_smpte100 (GstVideoTestSrc * v, GstClockTime pts,
   paintinfo *p = &pi;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   /* color bars */
-  for (j = 0; j < h; j++) {
+  for (j = p->y_start; j < p->y_end; j++) {
     for (i = 0; i < 7; i++) {
       int x1 = i * w / 7;
       int x2 = (i + 1) * w / 7;
@@ -866,16 +869,16 @@ gst_video_test_src_smpte100 (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_bar (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int j;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
-  for (j = 0; j < h; j++) {
+  for (j = p->y_start; j < p->y_end; j++) {
     /* use fixed size for now */
     int x2 = w / 7;
 
@@ -889,7 +892,7 @@ gst_video_test_src_bar (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_snow (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   int j;
@@ -898,14 +901,14 @@ gst_video_test_src_snow (GstVideoTestSrc * v, GstClockTime pts,
   struct vts_color_struct color;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   color = p->colors[COLOR_BLACK];
   p->color = &color;
 
-  for (j = 0; j < h; j++) {
+  for (j = p->y_start; j < p->y_end; j++) {
     for (i = 0; i < w; i++) {
-      int y = random_char (&v->random_state);
+      int y = random_char (&slice->random_state);
       p->tmpline_u8[i] = y;
     }
     videotestsrc_blend_line (v, p->tmpline, p->tmpline_u8,
@@ -916,14 +919,14 @@ gst_video_test_src_snow (GstVideoTestSrc * v, GstClockTime pts,
 
 static void
 gst_video_test_src_unicolor (GstVideoTestSrc * v, GstVideoFrame * frame,
-    int color_index)
+    GstVideoTestSrcSlice * slice, int color_index)
 {
   int i;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   p->color = p->colors + color_index;
   if (color_index == COLOR_BLACK) {
@@ -933,7 +936,7 @@ gst_video_test_src_unicolor (GstVideoTestSrc * v, GstVideoFrame * frame,
     p->color = &p->foreground_color;
   }
 
-  for (i = 0; i < h; i++) {
+  for (i = p->y_start; i < p->y_end; i++) {
     p->paint_tmpline (p, 0, w);
     videotestsrc_convert_tmpline (p, frame, i);
   }
@@ -941,49 +944,49 @@ gst_video_test_src_unicolor (GstVideoTestSrc * v, GstVideoFrame * frame,
 
 void
 gst_video_test_src_black (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
-  gst_video_test_src_unicolor (v, frame, COLOR_BLACK);
+  gst_video_test_src_unicolor (v, frame, slice, COLOR_BLACK);
 }
 
 void
 gst_video_test_src_white (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
-  gst_video_test_src_unicolor (v, frame, COLOR_WHITE);
+  gst_video_test_src_unicolor (v, frame, slice, COLOR_WHITE);
 }
 
 void
 gst_video_test_src_red (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
-  gst_video_test_src_unicolor (v, frame, COLOR_RED);
+  gst_video_test_src_unicolor (v, frame, slice, COLOR_RED);
 }
 
 void
 gst_video_test_src_green (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
-  gst_video_test_src_unicolor (v, frame, COLOR_GREEN);
+  gst_video_test_src_unicolor (v, frame, slice, COLOR_GREEN);
 }
 
 void
 gst_video_test_src_blue (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
-  gst_video_test_src_unicolor (v, frame, COLOR_BLUE);
+  gst_video_test_src_unicolor (v, frame, slice, COLOR_BLUE);
 }
 
 void
 gst_video_test_src_blink (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   if (v->n_frames & 1) {
     p->color = &p->foreground_color;
@@ -991,7 +994,7 @@ gst_video_test_src_blink (GstVideoTestSrc * v, GstClockTime pts,
     p->color = &p->background_color;
   }
 
-  for (i = 0; i < h; i++) {
+  for (i = p->y_start; i < p->y_end; i++) {
     p->paint_tmpline (p, 0, w);
     videotestsrc_convert_tmpline (p, frame, i);
   }
@@ -999,18 +1002,18 @@ gst_video_test_src_blink (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_solid (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   p->color = &p->foreground_color;
 
-  for (i = 0; i < h; i++) {
+  for (i = p->y_start; i < p->y_end; i++) {
     p->paint_tmpline (p, 0, w);
     videotestsrc_convert_tmpline (p, frame, i);
   }
@@ -1018,16 +1021,16 @@ gst_video_test_src_solid (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_checkers1 (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int x, y;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
-  for (y = 0; y < h; y++) {
+  for (y = p->y_start; y < p->y_end; y++) {
     for (x = 0; x < w; x++) {
       if ((x ^ y) & 1) {
         p->color = p->colors + COLOR_GREEN;
@@ -1042,16 +1045,16 @@ gst_video_test_src_checkers1 (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_checkers2 (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int x, y;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
-  for (y = 0; y < h; y++) {
+  for (y = p->y_start; y < p->y_end; y++) {
     for (x = 0; x < w; x += 2) {
       guint len = MIN (2, w - x);
 
@@ -1068,16 +1071,16 @@ gst_video_test_src_checkers2 (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_checkers4 (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int x, y;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
-  for (y = 0; y < h; y++) {
+  for (y = p->y_start; y < p->y_end; y++) {
     for (x = 0; x < w; x += 4) {
       guint len = MIN (4, w - x);
 
@@ -1094,16 +1097,16 @@ gst_video_test_src_checkers4 (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_checkers8 (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int x, y;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
-  for (y = 0; y < h; y++) {
+  for (y = p->y_start; y < p->y_end; y++) {
     for (x = 0; x < w; x += 8) {
       guint len = MIN (8, w - x);
 
@@ -1156,7 +1159,7 @@ static const guint8 sine_table[256] = {
 
 void
 gst_video_test_src_zoneplate (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   int j;
@@ -1182,7 +1185,7 @@ gst_video_test_src_zoneplate (GstVideoTestSrc * v, GstClockTime pts,
   int scale_kxy = 0xffff / (w / 2);
   int scale_kx2 = 0xffff / w;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   color = p->colors[COLOR_BLACK];
   p->color = &color;
@@ -1225,11 +1228,11 @@ gst_video_test_src_zoneplate (GstVideoTestSrc * v, GstClockTime pts,
 #endif
 
   /* optimised version, with original code shown in comments */
-  accum_ky = 0;
-  accum_kyt = 0;
+  accum_ky = v->ky * p->y_start;
+  accum_kyt = v->kyt * t * p->y_start;
   kt = v->kt * t;
   kt2 = v->kt2 * t * t;
-  for (j = 0, y = yreset; j < h; j++, y++) {
+  for (j = p->y_start, y = yreset + p->y_start; j < p->y_end; j++, y++) {
     accum_kx = 0;
     accum_kxt = 0;
     accum_ky += v->ky;
@@ -1272,7 +1275,7 @@ gst_video_test_src_zoneplate (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_chromazoneplate (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   int j;
@@ -1299,7 +1302,7 @@ gst_video_test_src_chromazoneplate (GstVideoTestSrc * v, GstClockTime pts,
   int scale_kxy = 0xffff / (w / 2);
   int scale_kx2 = 0xffff / w;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   color = p->colors[COLOR_BLACK];
   p->color = &color;
@@ -1312,11 +1315,11 @@ gst_video_test_src_chromazoneplate (GstVideoTestSrc * v, GstClockTime pts,
    */
 
   /* optimised version, with original code shown in comments */
-  accum_ky = 0;
-  accum_kyt = 0;
+  accum_ky = v->ky * p->y_start;
+  accum_kyt = v->kyt * t * p->y_start;
   kt = v->kt * t;
   kt2 = v->kt2 * t * t;
-  for (j = 0, y = yreset; j < h; j++, y++) {
+  for (j = p->y_start, y = yreset + p->y_start; j < p->y_end; j++, y++) {
     accum_kx = 0;
     accum_kxt = 0;
     accum_ky += v->ky;
@@ -1367,7 +1370,7 @@ gst_video_test_src_chromazoneplate (GstVideoTestSrc * v, GstClockTime pts,
 #undef SCALE_AMPLITUDE
 void
 gst_video_test_src_circular (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   int j;
@@ -1378,13 +1381,13 @@ gst_video_test_src_circular (GstVideoTestSrc * v, GstClockTime pts,
 
   int d;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   for (i = 1; i < 8; i++) {
     freq[i] = 200 * pow (2.0, -(i - 1) / 4.0);
   }
 
-  for (j = 0; j < h; j++) {
+  for (j = p->y_start; j < p->y_end; j++) {
     for (i = 0; i < w; i++) {
       double dist;
       int seg;
@@ -1408,7 +1411,7 @@ gst_video_test_src_circular (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_gamut (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int x, y;
   paintinfo pi = PAINT_INFO_INIT;
@@ -1417,9 +1420,9 @@ gst_video_test_src_gamut (GstVideoTestSrc * v, GstClockTime pts,
   struct vts_color_struct yuv_secondary;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
-  for (y = 0; y < h; y++) {
+  for (y = p->y_start; y < p->y_end; y++) {
     int region = (y * 4) / h;
 
     switch (region) {
@@ -1461,7 +1464,7 @@ gst_video_test_src_gamut (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_ball (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   int radius = 20;
@@ -1526,7 +1529,7 @@ gst_video_test_src_ball (GstVideoTestSrc * v, GstClockTime pts,
   }
 
   /* draw ball on frame */
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
   for (i = 0; i < h; i++) {
     if (i < y - radius || i > y + radius) {
       memset (p->tmpline_u8, 0, w);
@@ -1710,7 +1713,7 @@ convert_hline_bayer (paintinfo * p, GstVideoFrame * frame, int y)
 
 void
 gst_video_test_src_pinwheel (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   int j;
@@ -1723,7 +1726,7 @@ gst_video_test_src_pinwheel (GstVideoTestSrc * v, GstClockTime pts,
   double c[20];
   double s[20];
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   color = p->colors[COLOR_BLACK];
   p->color = &color;
@@ -1734,7 +1737,7 @@ gst_video_test_src_pinwheel (GstVideoTestSrc * v, GstClockTime pts,
     s[k] = sin (theta);
   }
 
-  for (j = 0; j < h; j++) {
+  for (j = p->y_start; j < p->y_end; j++) {
     for (i = 0; i < w; i++) {
       double v;
       v = 0;
@@ -1761,7 +1764,7 @@ gst_video_test_src_pinwheel (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_spokes (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   int j;
@@ -1774,7 +1777,7 @@ gst_video_test_src_spokes (GstVideoTestSrc * v, GstClockTime pts,
   double c[20];
   double s[20];
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   color = p->colors[COLOR_BLACK];
   p->color = &color;
@@ -1785,7 +1788,7 @@ gst_video_test_src_spokes (GstVideoTestSrc * v, GstClockTime pts,
     s[k] = sin (theta);
   }
 
-  for (j = 0; j < h; j++) {
+  for (j = p->y_start; j < p->y_end; j++) {
     for (i = 0; i < w; i++) {
       double v;
       v = 0;
@@ -1813,7 +1816,7 @@ gst_video_test_src_spokes (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_gradient (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   int j;
@@ -1822,12 +1825,12 @@ gst_video_test_src_gradient (GstVideoTestSrc * v, GstClockTime pts,
   struct vts_color_struct color;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   color = p->colors[COLOR_BLACK];
   p->color = &color;
 
-  for (j = 0; j < h; j++) {
+  for (j = p->y_start; j < p->y_end; j++) {
     int y = j * 255.0 / h;
     for (i = 0; i < w; i++) {
       p->tmpline_u8[i] = y;
@@ -1840,7 +1843,7 @@ gst_video_test_src_gradient (GstVideoTestSrc * v, GstClockTime pts,
 
 void
 gst_video_test_src_colors (GstVideoTestSrc * v, GstClockTime pts,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, GstVideoTestSrcSlice * slice)
 {
   int i;
   int j;
@@ -1849,12 +1852,12 @@ gst_video_test_src_colors (GstVideoTestSrc * v, GstClockTime pts,
   struct vts_color_struct color;
   int w = frame->info.width, h = frame->info.height;
 
-  videotestsrc_setup_paintinfo (v, p, w, h);
+  videotestsrc_setup_paintinfo (v, slice, p, w, h);
 
   color = p->colors[COLOR_BLACK];
   p->color = &color;
 
-  for (j = 0; j < h; j++) {
+  for (j = p->y_start; j < p->y_end; j++) {
     for (i = 0; i < w; i++) {
       p->tmpline[i * 4 + 0] = 0xff;
       p->tmpline[i * 4 + 1] = ((i * 4096) / w) % 256;
@@ -714,6 +714,90 @@ GST_START_TEST (test_pull_sample_refcounts)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pull_samples)
+{
+  GstElement *sink;
+  GstSample *samples[4] = { NULL, };
+  GPollFD pollfd;
+  guint i, n;
+
+  sink = setup_appsink ();
+  gst_app_sink_get_pollfd (GST_APP_SINK (sink), &pollfd);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  pollfd.events = G_IO_IN;
+  fail_unless_equals_int (g_poll (&pollfd, 1, 0), 0);
+
+  for (i = 0; i < 3; i++) {
+    GstBuffer *buffer = gst_buffer_new_and_alloc (i + 1);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* the fd is readable while samples are queued */
+  fail_unless_equals_int (g_poll (&pollfd, 1, 0), 1);
+
+  n = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), samples, 2, 0);
+  fail_unless_equals_int (n, 2);
+  fail_unless_equals_int (gst_buffer_get_size (gst_sample_get_buffer
+          (samples[0])), 1);
+  fail_unless_equals_int (gst_buffer_get_size (gst_sample_get_buffer
+          (samples[1])), 2);
+  fail_unless_equals_int (g_poll (&pollfd, 1, 0), 1);
+
+  n = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), samples + 2, 2, 0);
+  fail_unless_equals_int (n, 1);
+  fail_unless_equals_int (gst_buffer_get_size (gst_sample_get_buffer
+          (samples[2])), 3);
+  fail_unless (samples[3] == NULL);
+
+  /* nothing left */
+  fail_unless_equals_int (g_poll (&pollfd, 1, 0), 0);
+  fail_unless_equals_int (gst_app_sink_try_pull_samples (GST_APP_SINK (sink),
+          samples + 3, 1, 0), 0);
+
+  for (i = 0; i < 3; i++)
+    gst_sample_unref (samples[i]);
+
+  /* EOS makes the fd readable too */
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  fail_unless_equals_int (g_poll (&pollfd, 1, 0), 1);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
+/* the poll is only created when asked for, and then reflects the samples
+ * that were queued before */
+GST_START_TEST (test_pollfd_after_samples)
+{
+  GstElement *sink;
+  GstSample *sample;
+  GPollFD pollfd;
+
+  sink = setup_appsink ();
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  fail_unless (gst_pad_push (mysrcpad,
+          gst_buffer_new_and_alloc (1)) == GST_FLOW_OK);
+
+  gst_app_sink_get_pollfd (GST_APP_SINK (sink), &pollfd);
+  pollfd.events = G_IO_IN;
+  fail_unless_equals_int (g_poll (&pollfd, 1, 0), 1);
+
+  sample = gst_app_sink_pull_sample (GST_APP_SINK (sink));
+  fail_unless (sample != NULL);
+  gst_sample_unref (sample);
+  fail_unless_equals_int (g_poll (&pollfd, 1, 0), 0);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
 static gboolean
 new_event_cb (GstAppSink * appsink, gpointer callback_data)
 {
@@ -1089,6 +1173,8 @@ appsink_suite (void)
   tcase_add_test (tc_chain, test_pull_preroll);
   tcase_add_test (tc_chain, test_do_not_care_preroll);
   tcase_add_test (tc_chain, test_pull_sample_refcounts);
+  tcase_add_test (tc_chain, test_pull_samples);
+  tcase_add_test (tc_chain, test_pollfd_after_samples);
   tcase_add_test (tc_chain, test_event_callback);
   tcase_add_test (tc_chain, test_event_signals);
   tcase_add_test (tc_chain, test_event_paused);
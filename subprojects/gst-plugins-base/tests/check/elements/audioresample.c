@@ -1260,6 +1260,144 @@ GST_START_TEST (test_fft)
 
 GST_END_TEST;
 
+static void
+check_threaded_resampler (GstAudioFormat format,
+    GstAudioResamplerFilterMode filter_mode)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  const gint channels = 16, in_frames = 1024;
+  GstAudioResampler *resampler[2];
+  gpointer in, out[2];
+  gsize out_frames;
+  gint i, n, bpf;
+
+  /* the same resampler once in the current thread and once with the channels
+   * split up between threads */
+  for (i = 0; i < 2; i++) {
+    GstStructure *options = gst_structure_new_empty ("options");
+
+    gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+        GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, 48000, 44100, options);
+    gst_structure_set (options,
+        GST_AUDIO_RESAMPLER_OPT_FILTER_MODE,
+        GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE, filter_mode,
+        GST_AUDIO_RESAMPLER_OPT_THREADS, G_TYPE_UINT, i == 0 ? 1 : 4, NULL);
+    resampler[i] = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+        0, format, channels, 48000, 44100, options);
+    fail_unless (resampler[i] != NULL);
+    gst_structure_free (options);
+  }
+
+  bpf = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8 * channels;
+  in = g_malloc (in_frames * bpf);
+  for (i = 0; i < in_frames * channels; i++) {
+    if (format == GST_AUDIO_FORMAT_F32)
+      ((gfloat *) in)[i] = sin (i * 0.01 + i % channels);
+    else
+      ((gint16 *) in)[i] = 16384 * sin (i * 0.01 + i % channels);
+  }
+
+  /* a few buffers so that the history and the filter cache are used */
+  for (n = 0; n < 4; n++) {
+    out_frames = gst_audio_resampler_get_out_frames (resampler[0], in_frames);
+    fail_unless_equals_int (out_frames,
+        gst_audio_resampler_get_out_frames (resampler[1], in_frames));
+
+    for (i = 0; i < 2; i++) {
+      out[i] = g_malloc0 (out_frames * bpf);
+      gst_audio_resampler_resample (resampler[i], &in, in_frames, &out[i],
+          out_frames);
+    }
+    fail_unless (memcmp (out[0], out[1], out_frames * bpf) == 0);
+
+    g_free (out[0]);
+    g_free (out[1]);
+  }
+
+  g_free (in);
+  gst_audio_resampler_free (resampler[0]);
+  gst_audio_resampler_free (resampler[1]);
+}
+
+GST_START_TEST (test_threads)
+{
+  check_threaded_resampler (GST_AUDIO_FORMAT_F32,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_FULL);
+  check_threaded_resampler (GST_AUDIO_FORMAT_F32,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED);
+  check_threaded_resampler (GST_AUDIO_FORMAT_S16,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_FULL);
+  check_threaded_resampler (GST_AUDIO_FORMAT_S16,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED);
+}
+
+GST_END_TEST;
+
+static GstAudioResampler *
+make_kaiser_resampler (GstAudioResamplerFilterMode filter_mode,
+    gboolean minimum_phase)
+{
+  GstStructure *options = gst_structure_new_empty ("options");
+  GstAudioResampler *resampler;
+
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, 48000, 44100, options);
+  gst_structure_set (options,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_MODE,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE, filter_mode,
+      GST_AUDIO_RESAMPLER_OPT_MINIMUM_PHASE, G_TYPE_BOOLEAN, minimum_phase,
+      NULL);
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      0, GST_AUDIO_FORMAT_F64, 1, 48000, 44100, options);
+  fail_unless (resampler != NULL);
+  gst_structure_free (options);
+
+  return resampler;
+}
+
+static void
+check_minimum_phase (GstAudioResamplerFilterMode filter_mode)
+{
+  GstAudioResampler *linear, *minimum;
+  const gint in_frames = 4800;
+  gdouble *in, *out, peak = 0.0;
+  gsize out_frames;
+  gint i;
+
+  linear = make_kaiser_resampler (filter_mode, FALSE);
+  minimum = make_kaiser_resampler (filter_mode, TRUE);
+
+  fail_unless (gst_audio_resampler_get_max_latency (minimum) <
+      gst_audio_resampler_get_max_latency (linear) / 2);
+
+  /* a 1kHz sine passes the filter unchanged */
+  in = g_new (gdouble, in_frames);
+  for (i = 0; i < in_frames; i++)
+    in[i] = sin (2.0 * G_PI * 1000.0 * i / 48000.0);
+
+  out_frames = gst_audio_resampler_get_out_frames (minimum, in_frames);
+  out = g_new0 (gdouble, out_frames);
+  gst_audio_resampler_resample (minimum, (gpointer *) & in, in_frames,
+      (gpointer *) & out, out_frames);
+
+  for (i = out_frames / 2; i < out_frames; i++)
+    peak = MAX (peak, fabs (out[i]));
+  fail_unless (fabs (peak - 1.0) < 0.01, "peak %f", peak);
+
+  g_free (in);
+  g_free (out);
+  gst_audio_resampler_free (linear);
+  gst_audio_resampler_free (minimum);
+}
+
+GST_START_TEST (test_minimum_phase)
+{
+  check_minimum_phase (GST_AUDIO_RESAMPLER_FILTER_MODE_FULL);
+  check_minimum_phase (GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED);
+}
+
+GST_END_TEST;
+
 static Suite *
 audioresample_suite (void)
 {
@@ -1275,6 +1413,8 @@ audioresample_suite (void)
   tcase_add_test (tc_chain, test_live_switch_downstream);
   tcase_add_test (tc_chain, test_timestamp_drift);
   tcase_add_test (tc_chain, test_fft);
+  tcase_add_test (tc_chain, test_threads);
+  tcase_add_test (tc_chain, test_minimum_phase);
 
 #ifndef GST_DISABLE_PARSE
   tcase_set_timeout (tc_chain, 360);
@@ -47,7 +47,9 @@ static GMainLoop *main_loop;
 static GstCaps *
 _compositor_get_all_supported_caps (void)
 {
-  return gst_caps_from_string (GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL));
+  return gst_caps_from_string (GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL) ";"
+      GST_VIDEO_CAPS_MAKE_WITH_FEATURES ("memory:DMABuf",
+          GST_VIDEO_FORMATS_ALL));
 }
 
 static GstCaps *
@@ -71,8 +73,9 @@ _compositor_get_non_alpha_supported_caps (void)
       gst_value_list_append_value (&nonalpha_formats, v1);
   }
 
-  gst_structure_set_value (gst_caps_get_structure (all_caps, 0), "format",
-      &nonalpha_formats);
+  for (j = 0; j < gst_caps_get_size (all_caps); j++)
+    gst_structure_set_value (gst_caps_get_structure (all_caps, j), "format",
+        &nonalpha_formats);
 
   g_value_unset (&all_formats);
   g_value_unset (&nonalpha_formats);
@@ -515,11 +518,21 @@ GST_START_TEST (test_caps_query)
   restriction_caps =
       gst_caps_from_string ("video/x-raw, interlace-mode=(string)interleaved");
   g_object_set (capsfilter, "caps", restriction_caps, NULL);
+  gst_caps_unref (restriction_caps);
+  restriction_caps =
+      gst_caps_from_string ("video/x-raw, interlace-mode=(string)interleaved; "
+      "video/x-raw(memory:DMABuf), interlace-mode=(string)interleaved");
   caps = gst_pad_query_caps (sinkpad, NULL);
   fail_unless (gst_caps_is_subset (caps, restriction_caps));
   gst_caps_unref (caps);
   gst_caps_unref (restriction_caps);
 
+  /* DMABuf input is accepted for every format accepted in system memory */
+  caps = gst_caps_from_string ("video/x-raw(memory:DMABuf), format=I420, "
+      "width=100, height=100, framerate=1/1, interlace-mode=interleaved");
+  fail_unless (gst_pad_query_accept_caps (sinkpad, caps));
+  gst_caps_unref (caps);
+
   gst_element_set_state (pipeline, GST_STATE_NULL);
   gst_element_release_request_pad (compositor, sinkpad);
   gst_object_unref (sinkpad);
@@ -2323,6 +2336,87 @@ GST_START_TEST (test_gap_events)
 
 GST_END_TEST;
 
+static GstBuffer *
+create_damage_test_buffer (guint8 value, GstClockTime pts)
+{
+  GstBuffer *buf;
+  GstMapInfo info;
+
+  buf = gst_buffer_new_allocate (NULL, 2 * 4, NULL);
+  gst_buffer_map (buf, &info, GST_MAP_WRITE);
+  memset (info.data, value, info.size);
+  info.data[3] = info.data[7] = 255;
+  gst_buffer_unmap (buf, &info);
+
+  GST_BUFFER_PTS (buf) = pts;
+  GST_BUFFER_DURATION (buf) = 40 * GST_MSECOND;
+
+  return buf;
+}
+
+GST_START_TEST (test_damage_tracking)
+{
+  GstBuffer *buf;
+  GstElement *comp = gst_element_factory_make ("compositor", NULL);
+  GstHarness *h = gst_harness_new_with_element (comp, "sink_%u", "src");
+  GstPad *pad;
+  GstMapInfo info;
+  guint8 background;
+  gint i;
+
+  g_object_set (comp, "background", 1, "damage-tracking", TRUE, NULL);
+
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw, format=RGBA, width=1, height=2, framerate=25/1");
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw, format=RGBA, width=1, height=16, framerate=25/1");
+
+  pad = gst_element_get_static_pad (comp, "sink_0");
+
+  gst_harness_play (h);
+
+  gst_harness_push (h, create_damage_test_buffer (42, 0));
+  buf = gst_harness_pull (h);
+  gst_buffer_map (buf, &info, GST_MAP_READ);
+  fail_unless_equals_int (info.data[0], 42);
+  fail_unless_equals_int (info.data[4], 42);
+  background = info.data[15 * 4];
+  fail_if (background == 42);
+  gst_buffer_unmap (buf, &info);
+  gst_buffer_unref (buf);
+
+  /* only the lines of the pad change */
+  gst_harness_push (h, create_damage_test_buffer (84, 40 * GST_MSECOND));
+  buf = gst_harness_pull (h);
+  gst_buffer_map (buf, &info, GST_MAP_READ);
+  fail_unless_equals_int (info.data[0], 84);
+  fail_unless_equals_int (info.data[4], 84);
+  for (i = 2; i < 16; i++)
+    fail_unless_equals_int (info.data[i * 4], background);
+  gst_buffer_unmap (buf, &info);
+  gst_buffer_unref (buf);
+
+  /* moving the pad damages its old and new lines */
+  g_object_set (pad, "ypos", 10, NULL);
+  gst_harness_push (h, create_damage_test_buffer (84, 80 * GST_MSECOND));
+  buf = gst_harness_pull (h);
+  gst_buffer_map (buf, &info, GST_MAP_READ);
+  for (i = 0; i < 16; i++) {
+    if (i == 10 || i == 11)
+      fail_unless_equals_int (info.data[i * 4], 84);
+    else
+      fail_unless_equals_int (info.data[i * 4], background);
+  }
+  gst_buffer_unmap (buf, &info);
+  gst_buffer_unref (buf);
+
+  gst_object_unref (pad);
+  gst_harness_teardown (h);
+  gst_object_unref (comp);
+}
+
+GST_END_TEST;
+
 static GstBuffer *expected_selected_buffer = NULL;
 
 static void
@@ -2556,6 +2650,7 @@ compositor_suite (void)
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3);
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3_unlinked_1);
   tcase_add_test (tc_chain, test_gap_events);
+  tcase_add_test (tc_chain, test_damage_tracking);
   tcase_add_test (tc_chain, test_signals);
   tcase_add_test (tc_chain, test_reverse);
 
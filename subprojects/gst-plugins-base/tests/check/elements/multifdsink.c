@@ -562,6 +562,75 @@ GST_START_TEST (test_burst_client_bytes)
 
 GST_END_TEST;
 
+static GstBuffer *
+gst_new_buffer_two_memories (int i)
+{
+  GstBuffer *buffer = gst_new_buffer (i);
+  GstBuffer *tail;
+
+  /* split the 16 bytes over two memories */
+  tail = gst_buffer_copy_region (buffer, GST_BUFFER_COPY_MEMORY, 8, 8);
+  gst_buffer_resize (buffer, 0, 8);
+  return gst_buffer_append (buffer, tail);
+}
+
+/* a bursting client gets all of its queued buffers, each made of several
+ * memories, in order */
+GST_START_TEST (test_burst_client_gathered)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  int pfd[2];
+  gint i;
+
+  sink = setup_multifdsink ();
+  g_object_set (sink, "bytes-min", 160, NULL);
+  g_object_set (sink, "sync-method", 3, NULL);  /* 3 = burst */
+  g_object_set (sink, "burst-format", GST_FORMAT_BYTES, NULL);
+  g_object_set (sink, "burst-value", (guint64) 160, NULL);
+
+  fail_if (pipe (pfd) == -1);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  for (i = 0; i < 9; i++) {
+    GstBuffer *buffer = gst_new_buffer_two_memories (i);
+
+    fail_unless_equals_int (gst_buffer_n_memory (buffer), 2);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  g_signal_emit_by_name (sink, "add", pfd[1]);
+  fail_unless_num_handles (sink, 1);
+
+  /* push last buffer to make the client fd ready for reading */
+  fail_unless (gst_pad_push (mysrcpad,
+          gst_new_buffer_two_memories (9)) == GST_FLOW_OK);
+
+  fail_unless_read ("client", pfd[0], 16, "deadbee00000000");
+  fail_unless_read ("client", pfd[0], 16, "deadbee00000001");
+  fail_unless_read ("client", pfd[0], 16, "deadbee00000002");
+  fail_unless_read ("client", pfd[0], 16, "deadbee00000003");
+  fail_unless_read ("client", pfd[0], 16, "deadbee00000004");
+  fail_unless_read ("client", pfd[0], 16, "deadbee00000005");
+  fail_unless_read ("client", pfd[0], 16, "deadbee00000006");
+  fail_unless_read ("client", pfd[0], 16, "deadbee00000007");
+  fail_unless_read ("client", pfd[0], 16, "deadbee00000008");
+  fail_unless_read ("client", pfd[0], 16, "deadbee00000009");
+  wait_bytes_served (sink, 160);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multifdsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
 /* keep 100 bytes and burst 80 bytes to clients */
 GST_START_TEST (test_burst_client_bytes_keyframe)
 {
@@ -963,6 +1032,7 @@ multifdsink_suite (void)
   tcase_add_test (tc_chain, test_streamheader);
   tcase_add_test (tc_chain, test_change_streamheader);
   tcase_add_test (tc_chain, test_burst_client_bytes);
+  tcase_add_test (tc_chain, test_burst_client_gathered);
   tcase_add_test (tc_chain, test_burst_client_bytes_keyframe);
   tcase_add_test (tc_chain, test_burst_client_bytes_with_keyframe);
   tcase_add_test (tc_chain, test_client_next_keyframe);
@@ -24,8 +24,11 @@
 #include "config.h"
 #endif
 
+#include <math.h>
+
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstharness.h>
+#include <gst/audio/audio.h>
 
 #if G_BYTE_ORDER == G_BIG_ENDIAN
 #define AFORMAT "S16BE"
@@ -488,6 +491,90 @@ GST_START_TEST (test_opus_decode_plc_timestamps_with_fec)
 
 GST_END_TEST;
 
+#define ENCODE_SAMPLES (10 * 960 + 500)
+
+/* encodes ENCODE_SAMPLES of a tone pushed in buffers of @samples_per_buffer
+ * and returns the harness holding the output */
+static GstHarness *
+encode_tone (guint samples_per_buffer)
+{
+  GstHarness *h = gst_harness_new ("opusenc");
+  guint offset = 0;
+
+  gst_harness_set_src_caps_str (h, AUDIO_CAPS_STRING);
+
+  while (offset < ENCODE_SAMPLES) {
+    guint i, n = MIN (samples_per_buffer, ENCODE_SAMPLES - offset);
+    GstBuffer *buf = gst_buffer_new_and_alloc (n * 2);
+    GstMapInfo map;
+    gint16 *samples;
+
+    gst_buffer_map (buf, &map, GST_MAP_WRITE);
+    samples = (gint16 *) map.data;
+    for (i = 0; i < n; i++)
+      samples[i] = 8000 * sin (2 * G_PI * 440 * (offset + i) / 48000.0);
+    gst_buffer_unmap (buf, &map);
+
+    GST_BUFFER_PTS (buf) =
+        gst_util_uint64_scale_int (offset, GST_SECOND, 48000);
+    GST_BUFFER_DURATION (buf) =
+        gst_util_uint64_scale_int (n, GST_SECOND, 48000);
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+    offset += n;
+  }
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  return h;
+}
+
+/* encoding all frames of an input buffer at once must produce the same
+ * packets as encoding them one by one */
+GST_START_TEST (test_opus_encode_frames_at_once)
+{
+  GstHarness *h_once, *h_single;
+  guint n;
+
+  h_once = encode_tone (ENCODE_SAMPLES);
+  h_single = encode_tone (960);
+
+  n = gst_harness_buffers_in_queue (h_single);
+  fail_unless (n > ENCODE_SAMPLES / 960);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h_once), n);
+
+  while (n--) {
+    GstBuffer *once = gst_harness_pull (h_once);
+    GstBuffer *single = gst_harness_pull (h_single);
+    GstAudioClippingMeta *meta_once, *meta_single;
+    GstMapInfo map;
+
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (once),
+        GST_BUFFER_PTS (single));
+    fail_unless_equals_uint64 (GST_BUFFER_DURATION (once),
+        GST_BUFFER_DURATION (single));
+
+    gst_buffer_map (single, &map, GST_MAP_READ);
+    fail_unless (gst_buffer_memcmp (once, 0, map.data, map.size) == 0);
+    fail_unless_equals_int (gst_buffer_get_size (once), map.size);
+    gst_buffer_unmap (single, &map);
+
+    meta_once = gst_buffer_get_audio_clipping_meta (once);
+    meta_single = gst_buffer_get_audio_clipping_meta (single);
+    fail_unless ((meta_once == NULL) == (meta_single == NULL));
+    if (meta_once) {
+      fail_unless_equals_uint64 (meta_once->start, meta_single->start);
+      fail_unless_equals_uint64 (meta_once->end, meta_single->end);
+    }
+
+    gst_buffer_unref (once);
+    gst_buffer_unref (single);
+  }
+
+  gst_harness_teardown (h_once);
+  gst_harness_teardown (h_single);
+}
+
+GST_END_TEST;
+
 static Suite *
 opus_suite (void)
 {
@@ -499,6 +586,7 @@ opus_suite (void)
   tcase_add_test (tc_chain, test_opus_encode_nothing);
   tcase_add_test (tc_chain, test_opus_decode_nothing);
   tcase_add_test (tc_chain, test_opus_encode_samples);
+  tcase_add_test (tc_chain, test_opus_encode_frames_at_once);
   tcase_add_test (tc_chain, test_opus_encode_properties);
   tcase_add_test (tc_chain, test_opusdec_getcaps);
   tcase_add_test (tc_chain, test_opus_decode_plc_timestamps_with_fec);
@@ -618,6 +618,71 @@ GST_START_TEST (test_video_passthrough_with_feature)
 
 GST_END_TEST;
 
+GST_START_TEST (test_video_render_changed_characters)
+{
+  GstElement *textoverlay;
+  GstBuffer *inbuffer;
+  GstCaps *incaps;
+  GstVideoOverlayCompositionMeta *comp_meta;
+  GstVideoOverlayComposition *comp;
+  GstVideoOverlayRectangle *first, *last;
+
+  textoverlay = setup_textoverlay_with_templates (&video_srctemplate,
+      NULL, &sinktemplate_with_features, TRUE);
+
+  /* left aligned, so that the unchanged characters stay in place */
+  g_object_set (textoverlay, "text", "XLX", "halignment", 0, NULL);
+
+  fail_unless (gst_element_set_state (textoverlay,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  incaps = create_video_caps (VIDEO_CAPS_STRING);
+  gst_check_setup_events_textoverlay (myvideosrcpad, textoverlay, incaps,
+      GST_FORMAT_TIME, "video");
+  inbuffer = create_black_buffer (incaps);
+  GST_BUFFER_TIMESTAMP (inbuffer) = 0;
+  GST_BUFFER_DURATION (inbuffer) = GST_SECOND / 10;
+  fail_unless (gst_pad_push (myvideosrcpad, inbuffer) == GST_FLOW_OK);
+
+  /* one rectangle per character */
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  comp_meta = gst_buffer_get_video_overlay_composition_meta (buffers->data);
+  fail_unless (comp_meta != NULL);
+  comp = comp_meta->overlay;
+  fail_unless_equals_int (gst_video_overlay_composition_n_rectangles (comp),
+      3);
+  first = gst_video_overlay_composition_get_rectangle (comp, 0);
+  last = gst_video_overlay_composition_get_rectangle (comp, 2);
+
+  g_object_set (textoverlay, "text", "XLL", NULL);
+
+  inbuffer = create_black_buffer (incaps);
+  GST_BUFFER_TIMESTAMP (inbuffer) = GST_SECOND / 10;
+  GST_BUFFER_DURATION (inbuffer) = GST_SECOND / 10;
+  fail_unless (gst_pad_push (myvideosrcpad, inbuffer) == GST_FLOW_OK);
+  gst_caps_unref (incaps);
+
+  /* only the changed character was rendered again */
+  fail_unless_equals_int (g_list_length (buffers), 2);
+  comp_meta =
+      gst_buffer_get_video_overlay_composition_meta (buffers->next->data);
+  fail_unless (comp_meta != NULL);
+  comp = comp_meta->overlay;
+  fail_unless_equals_int (gst_video_overlay_composition_n_rectangles (comp),
+      3);
+  fail_unless (gst_video_overlay_composition_get_rectangle (comp, 0) == first);
+  fail_unless (gst_video_overlay_composition_get_rectangle (comp, 2) != last);
+
+  g_list_foreach (buffers, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+
+  cleanup_textoverlay (textoverlay);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_passthrough_with_feature_and_unsupported_caps)
 {
   GstElement *textoverlay;
@@ -1148,6 +1213,7 @@ textoverlay_suite (void)
 
   tcase_add_test (tc_chain, test_video_passthrough);
   tcase_add_test (tc_chain, test_video_passthrough_with_feature);
+  tcase_add_test (tc_chain, test_video_render_changed_characters);
   tcase_add_test (tc_chain,
       test_video_passthrough_with_feature_and_unsupported_caps);
   tcase_add_test (tc_chain,
@@ -159,6 +159,69 @@ GST_START_TEST (test_negotiate_alternate)
 
 GST_END_TEST;
 
+GST_START_TEST (test_crop_meta)
+{
+  GstHarness *h;
+  GstBuffer *buffer;
+  GstVideoCropMeta *crop;
+  GstMapInfo map;
+  gint x, y;
+
+  h = gst_harness_new ("videoconvert");
+
+  /* 4x4 image of which only the bottom right 2x2 pixels are shown */
+  buffer = gst_buffer_new_and_alloc (4 * 4 * 4);
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  for (y = 0; y < 4; y++) {
+    for (x = 0; x < 4; x++) {
+      guint8 *p = map.data + y * 16 + x * 4;
+
+      p[0] = x * 16 + y;
+      p[1] = 1;
+      p[2] = 2;
+      p[3] = 255;
+    }
+  }
+  gst_buffer_unmap (buffer, &map);
+
+  gst_buffer_add_video_meta (buffer, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_RGBA, 4, 4);
+  crop = gst_buffer_add_video_crop_meta (buffer);
+  crop->x = 2;
+  crop->y = 2;
+  crop->width = 2;
+  crop->height = 2;
+
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw,format=RGBA,width=2,height=2,framerate=30/1");
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw,format=BGRA,width=2,height=2,framerate=30/1");
+  fail_unless_equals_int (gst_harness_push (h, buffer), GST_FLOW_OK);
+
+  buffer = gst_harness_pull (h);
+  fail_unless (buffer != NULL);
+  fail_if (gst_buffer_get_video_crop_meta (buffer));
+
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.size, 2 * 2 * 4);
+  for (y = 0; y < 2; y++) {
+    for (x = 0; x < 2; x++) {
+      guint8 *p = map.data + y * 8 + x * 4;
+
+      fail_unless_equals_int (p[0], 2);
+      fail_unless_equals_int (p[1], 1);
+      fail_unless_equals_int (p[2], (x + 2) * 16 + y + 2);
+      fail_unless_equals_int (p[3], 255);
+    }
+  }
+  gst_buffer_unmap (buffer, &map);
+  gst_buffer_unref (buffer);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 videoconvert_suite (void)
 {
@@ -169,6 +232,7 @@ videoconvert_suite (void)
 
   tcase_add_test (tc_chain, test_template_formats);
   tcase_add_test (tc_chain, test_negotiate_alternate);
+  tcase_add_test (tc_chain, test_crop_meta);
 
   return s;
 }
@@ -1589,6 +1589,49 @@ GST_START_TEST (test_nopts_in_middle)
 
 GST_END_TEST;
 
+/* duplicates must share the memory of the frame they repeat */
+GST_START_TEST (test_duplicates_share_memory)
+{
+  GstElement *videorate;
+  GstBuffer *first, *second, *out, *dup;
+  GstCaps *caps;
+
+  videorate = setup_videorate ();
+  fail_unless (gst_element_set_state (videorate,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  first = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (first) = 0;
+  gst_buffer_memset (first, 0, 1, 4);
+  caps = gst_caps_from_string (VIDEO_CAPS_STRING);
+  gst_check_setup_events (mysrcpad, videorate, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+  fail_unless (gst_pad_push (mysrcpad, first) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 0);
+
+  /* three output frames later, so the first frame gets duplicated once */
+  second = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (second) = GST_SECOND * 3 / 25;
+  gst_buffer_memset (second, 0, 2, 4);
+  fail_unless (gst_pad_push (mysrcpad, second) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 2);
+  assert_videorate_stats (videorate, "second", 2, 2, 0, 1);
+
+  out = buffers->data;
+  dup = buffers->next->data;
+  fail_unless (out != dup);
+  fail_if (GST_BUFFER_FLAG_IS_SET (out, GST_BUFFER_FLAG_GAP));
+  fail_unless (GST_BUFFER_FLAG_IS_SET (dup, GST_BUFFER_FLAG_GAP));
+  fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (dup), GST_SECOND / 25);
+  fail_unless (gst_buffer_peek_memory (out, 0) ==
+      gst_buffer_peek_memory (dup, 0));
+
+  cleanup_videorate (videorate);
+}
+
+GST_END_TEST;
+
 static Suite *
 videorate_suite (void)
 {
@@ -1615,6 +1658,7 @@ videorate_suite (void)
   tcase_add_loop_test (tc_chain, test_query_position, 0,
       G_N_ELEMENTS (position_tests));
   tcase_add_test (tc_chain, test_nopts_in_middle);
+  tcase_add_test (tc_chain, test_duplicates_share_memory);
 
   return s;
 }
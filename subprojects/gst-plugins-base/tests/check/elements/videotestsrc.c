@@ -594,7 +594,95 @@ GST_START_TEST (test_patterns_are_deterministic)
 
 GST_END_TEST;
 
+static GstHarness *
+setup_videotestsrc_harness (const gchar * caps)
+{
+  GstHarness *h;
+
+  h = gst_harness_new_parse ("videotestsrc pattern=zone-plate kt=1 kx2=20 "
+      "ky2=20");
+  gst_harness_set_sink_caps_str (h, caps);
+  gst_harness_set_blocking_push_mode (h);
+
+  return h;
+}
+
+GST_START_TEST (test_n_threads)
+{
+  /* odd height with subsampled chroma so the last slice is a partial one */
+  const gchar *caps_str[] = {
+    "video/x-raw,format=I420,width=320,height=241,framerate=30/1",
+    "video/x-raw,format=AYUV,width=320,height=240,framerate=30/1",
+  };
+  const gchar *patterns[] = { "smpte75", "zone-plate", "gradient", "ball" };
+  gint c, i, frame;
+
+  for (c = 0; c < G_N_ELEMENTS (caps_str); c++) {
+    for (i = 0; i < G_N_ELEMENTS (patterns); i++) {
+      GstHarness *h[2];
+
+      h[0] = setup_videotestsrc_harness (caps_str[c]);
+      h[1] = setup_videotestsrc_harness (caps_str[c]);
+      gst_util_set_object_arg (G_OBJECT (h[0]->element), "pattern",
+          patterns[i]);
+      gst_util_set_object_arg (G_OBJECT (h[1]->element), "pattern",
+          patterns[i]);
+      g_object_set (h[1]->element, "n-threads", 4, NULL);
+      gst_harness_play (h[0]);
+      gst_harness_play (h[1]);
+
+      for (frame = 0; frame < 2; frame++) {
+        GstBuffer *buf1 = gst_harness_pull (h[0]);
+        GstBuffer *buf2 = gst_harness_pull (h[1]);
+        gchar *checksum1 = get_buffer_checksum (buf1);
+        gchar *checksum2 = get_buffer_checksum (buf2);
+
+        fail_unless_equals_string (checksum1, checksum2);
+
+        g_free (checksum1);
+        g_free (checksum2);
+        gst_buffer_unref (buf1);
+        gst_buffer_unref (buf2);
+      }
+
+      gst_harness_teardown (h[0]);
+      gst_harness_teardown (h[1]);
+    }
+  }
+}
 
+GST_END_TEST;
+
+GST_START_TEST (test_cached_frames)
+{
+  GstHarness *h;
+  gchar *checksums[4];
+  gint i;
+
+  h = setup_videotestsrc_harness
+      ("video/x-raw,format=I420,width=320,height=240,framerate=30/1");
+  g_object_set (h->element, "cached-frames", 2, NULL);
+  gst_harness_play (h);
+
+  for (i = 0; i < G_N_ELEMENTS (checksums); i++) {
+    GstBuffer *buf = gst_harness_pull (h);
+
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buf), i);
+    checksums[i] = get_buffer_checksum (buf);
+    gst_buffer_unref (buf);
+  }
+
+  /* the pattern is animated, but only the first two frames get rendered */
+  fail_if (g_str_equal (checksums[0], checksums[1]));
+  fail_unless_equals_string (checksums[0], checksums[2]);
+  fail_unless_equals_string (checksums[1], checksums[3]);
+
+  for (i = 0; i < G_N_ELEMENTS (checksums); i++)
+    g_free (checksums[i]);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
 
 /* FIXME: add tests for YUV formats */
 
@@ -618,6 +706,8 @@ videotestsrc_suite (void)
   tcase_add_test (tc_chain, test_backward_playback);
   tcase_add_test (tc_chain, test_duration_query);
   tcase_add_test (tc_chain, test_patterns_are_deterministic);
+  tcase_add_test (tc_chain, test_n_threads);
+  tcase_add_test (tc_chain, test_cached_frames);
 
   return s;
 }
@@ -28,6 +28,7 @@
 #include <fcntl.h>
 #include <gst/allocators/gstdmabuf.h>
 #include <gst/allocators/gstfdmemory.h>
+#include <gst/allocators/gstnumamemory.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -101,6 +102,62 @@ GST_START_TEST (test_fdmem)
 
 GST_END_TEST;
 
+GST_START_TEST (test_numamem)
+{
+  GstAllocationParams params = { 0, 63, 16, 16, };
+  GstAllocator *alloc;
+  GstMemory *mem, *sub, *copy;
+  GstMapInfo info;
+
+  alloc = gst_numa_allocator_new (GST_NUMA_NODE_ANY,
+      GST_NUMA_ALLOCATOR_FLAG_HUGE_PAGES);
+  fail_unless (alloc);
+  fail_unless_equals_int (gst_numa_allocator_get_node (GST_NUMA_ALLOCATOR
+          (alloc)), GST_NUMA_NODE_ANY);
+
+  /* big enough to be backed by huge pages */
+  mem = gst_allocator_alloc (alloc, 4 * 1024 * 1024, &params);
+  fail_unless (mem);
+  fail_unless (gst_is_numa_memory (mem));
+  fail_unless (gst_numa_memory_get_node (mem) >= GST_NUMA_NODE_ANY);
+  fail_unless_equals_int (mem->offset, 16);
+  fail_unless (GST_MEMORY_IS_ZERO_PREFIXED (mem));
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+  fail_unless (((guintptr) info.data - 16) % 64 == 0);
+  fail_unless (info.data[5] == 0);
+  info.data[5] = 'X';
+  gst_memory_unmap (mem, &info);
+
+  sub = gst_memory_share (mem, 5, 10);
+  fail_unless (gst_memory_map (sub, &info, GST_MAP_READ));
+  fail_unless (info.data[0] == 'X');
+  gst_memory_unmap (sub, &info);
+
+  copy = gst_memory_copy (sub, 0, -1);
+  fail_unless (gst_is_numa_memory (copy));
+  fail_unless_equals_int (copy->size, 10);
+  fail_unless (gst_memory_map (copy, &info, GST_MAP_READ));
+  fail_unless (info.data[0] == 'X');
+  gst_memory_unmap (copy, &info);
+
+  gst_memory_unref (copy);
+  gst_memory_unref (sub);
+  gst_memory_unref (mem);
+
+  /* the node reported by an explicitly bound allocator */
+  gst_object_unref (alloc);
+  alloc = gst_numa_allocator_new (0, GST_NUMA_ALLOCATOR_FLAG_NONE);
+  fail_unless_equals_int (gst_numa_allocator_get_node (GST_NUMA_ALLOCATOR
+          (alloc)), 0);
+  mem = gst_allocator_alloc (alloc, 100, NULL);
+  fail_unless (mem);
+  gst_memory_unref (mem);
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
 static Suite *
 allocators_suite (void)
 {
@@ -110,6 +167,7 @@ allocators_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_dmabuf);
   tcase_add_test (tc_chain, test_fdmem);
+  tcase_add_test (tc_chain, test_numamem);
 
   return s;
 }
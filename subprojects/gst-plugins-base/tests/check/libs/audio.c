@@ -29,6 +29,7 @@
 
 #include <gst/audio/audio.h>
 #include <string.h>
+#include <math.h>
 
 static GstBuffer *
 make_buffer (guint8 ** _data)
@@ -987,6 +988,66 @@ GST_START_TEST (test_fill_silence)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pack_unpack)
+{
+  GstAudioFormat f;
+  gint i, len;
+  guint8 data[64 * 8 + 16], packed[64 * 8 + 16];
+  gdouble unpacked[64];
+
+  /* unpacking and packing again gives the original samples, also for
+   * lengths that end up in the scalar tails of the SIMD versions. The bytes
+   * after the samples are not touched. */
+  for (f = GST_AUDIO_FORMAT_S8; f <= GST_AUDIO_FORMAT_F32BE; f++) {
+    const GstAudioFormatInfo *finfo = gst_audio_format_get_info (f);
+    gint bps = finfo->width / 8;
+
+    if (finfo->width != finfo->depth && finfo->width != 32)
+      continue;
+
+    for (len = 1; len <= 64; len++) {
+      for (i = 0; i < len * bps; i++)
+        data[i] = g_random_int ();
+      if (finfo->width != finfo->depth) {
+        /* the padding byte of 24 in 32 bit samples is the sign extension */
+        gint hi = finfo->endianness == G_LITTLE_ENDIAN ? 3 : 0;
+        gint next = finfo->endianness == G_LITTLE_ENDIAN ? 2 : 1;
+
+        for (i = 0; i < len; i++) {
+          guint8 *p = data + i * 4;
+
+          if (GST_AUDIO_FORMAT_INFO_IS_SIGNED (finfo))
+            p[hi] = (p[next] & 0x80) ? 0xff : 0x00;
+          else
+            p[hi] = 0x00;
+        }
+      }
+      if (GST_AUDIO_FORMAT_INFO_IS_FLOAT (finfo)) {
+        for (i = 0; i < len; i++) {
+          gfloat v = g_random_double_range (-1.0, 1.0);
+          guint32 u;
+
+          memcpy (&u, &v, 4);
+          if (finfo->endianness != G_BYTE_ORDER)
+            u = GUINT32_SWAP_LE_BE (u);
+          memcpy (data + i * 4, &u, 4);
+        }
+      }
+      memset (packed, 0xa5, sizeof (packed));
+
+      finfo->unpack_func (finfo, 0, unpacked, data, len);
+      finfo->pack_func (finfo, 0, unpacked, packed, len);
+
+      fail_unless (memcmp (data, packed, len * bps) == 0,
+          "format %s, %d samples", finfo->name, len);
+      for (i = len * bps; i < sizeof (packed); i++)
+        fail_unless_equals_int (packed[i], 0xa5);
+    }
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_stream_align)
 {
   GstAudioStreamAlign *align;
@@ -1578,6 +1639,77 @@ GST_START_TEST (test_audio_make_raw_caps)
 
 GST_END_TEST;
 
+#define DITHER_SAMPLES (64 * 1024)
+#define DITHER_QUANTIZER (1 << 16)
+
+/* quantizes silence with @dither and checks the mean and variance of the
+ * result and that samples more than @min_lag apart are uncorrelated */
+static void
+check_dither (GstAudioDitherMethod dither, gdouble variance, gint min_lag)
+{
+  GstAudioQuantize *quant;
+  gint32 *in, *out;
+  gpointer in_ptr[1], out_ptr[1];
+  gdouble mean = 0.0, var = 0.0;
+  gint i, lag;
+
+  quant = gst_audio_quantize_new (dither, GST_AUDIO_NOISE_SHAPING_NONE, 0,
+      GST_AUDIO_FORMAT_S32, 1, DITHER_QUANTIZER);
+  fail_unless (quant != NULL);
+
+  in = g_new0 (gint32, DITHER_SAMPLES);
+  out = g_new0 (gint32, DITHER_SAMPLES);
+  in_ptr[0] = in;
+  out_ptr[0] = out;
+  gst_audio_quantize_samples (quant, in_ptr, out_ptr, DITHER_SAMPLES);
+
+  for (i = 0; i < DITHER_SAMPLES; i++) {
+    fail_unless_equals_int (out[i] % DITHER_QUANTIZER, 0);
+    mean += out[i] / DITHER_QUANTIZER;
+  }
+  mean /= DITHER_SAMPLES;
+  for (i = 0; i < DITHER_SAMPLES; i++) {
+    gdouble v = out[i] / DITHER_QUANTIZER - mean;
+    var += v * v;
+  }
+  var /= DITHER_SAMPLES;
+
+  GST_DEBUG ("dither %d: mean %f variance %f", dither, mean, var);
+  fail_unless (fabs (mean) < 0.02);
+  fail_unless (fabs (var - variance) < 0.02);
+
+  /* the generators run in 8 lanes, check that no lane repeats another one */
+  for (lag = min_lag; lag <= 32; lag++) {
+    gdouble cov = 0.0;
+
+    for (i = 0; i + lag < DITHER_SAMPLES; i++)
+      cov += (out[i] / DITHER_QUANTIZER - mean) *
+          (out[i + lag] / DITHER_QUANTIZER - mean);
+    cov /= DITHER_SAMPLES - lag;
+
+    GST_DEBUG ("dither %d: correlation at lag %d: %f", dither, lag,
+        cov / var);
+    fail_unless (fabs (cov / var) < 0.05);
+  }
+
+  g_free (in);
+  g_free (out);
+  gst_audio_quantize_free (quant);
+}
+
+GST_START_TEST (test_quantize_dither)
+{
+  /* silence plus the quantizer bias ends up in one of -1, 0 and 1 times the
+   * quantizer. RPDF hits them with 1/4, 1/2 and 1/4, TPDF with 1/8, 3/4 and
+   * 1/8 */
+  check_dither (GST_AUDIO_DITHER_RPDF, 0.5, 1);
+  check_dither (GST_AUDIO_DITHER_TPDF, 0.25, 1);
+  /* high frequency TPDF is correlated with the previous sample by design */
+  check_dither (GST_AUDIO_DITHER_TPDF_HF, 0.25, 2);
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -1611,11 +1743,13 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_audio_format_s8);
   tcase_add_test (tc_chain, test_audio_format_u8);
   tcase_add_test (tc_chain, test_fill_silence);
+  tcase_add_test (tc_chain, test_pack_unpack);
   tcase_add_test (tc_chain, test_stream_align);
   tcase_add_test (tc_chain, test_stream_align_reverse);
   tcase_add_test (tc_chain, test_audio_buffer_and_audio_meta);
   tcase_add_test (tc_chain, test_audio_info_from_caps);
   tcase_add_test (tc_chain, test_audio_make_raw_caps);
+  tcase_add_test (tc_chain, test_quantize_dither);
 
   return s;
 }
@@ -75,6 +75,10 @@ struct _GstAudioDecoderTester
   gboolean output_too_many_frames;
   gboolean delay_decoding;
   GstBuffer *prev_buf;
+
+  /* frames that fail to decode in parallel, -1 for none */
+  gint64 corrupt_frame;
+  guint preroll;
 };
 
 struct _GstAudioDecoderTesterClass
@@ -198,6 +202,71 @@ gst_audio_decoder_tester_handle_frame (GstAudioDecoder * dec,
   return ret;
 }
 
+/* the worker checks that it was primed with the frames preceding its batch */
+typedef struct
+{
+  GstAudioDecoderTester *tester;
+  guint64 next;
+  gboolean primed;
+} GstAudioDecoderTesterWorker;
+
+static gpointer
+gst_audio_decoder_tester_create_worker (GstAudioDecoder * dec,
+    guint * preroll)
+{
+  GstAudioDecoderTester *tester = (GstAudioDecoderTester *) dec;
+  GstAudioDecoderTesterWorker *worker;
+
+  if (tester->setoutputformat_on_decoding || tester->delay_decoding)
+    return NULL;
+
+  worker = g_new0 (GstAudioDecoderTesterWorker, 1);
+  worker->tester = tester;
+  *preroll = tester->preroll;
+
+  return worker;
+}
+
+static GstFlowReturn
+gst_audio_decoder_tester_decode_frames (GstAudioDecoder * dec, gpointer data,
+    GstBufferList * frames, guint preroll, GstBufferList * output)
+{
+  GstAudioDecoderTesterWorker *worker = data;
+  guint i, n = gst_buffer_list_length (frames);
+
+  for (i = 0; i < n; i++) {
+    GstBuffer *buffer = gst_buffer_list_get (frames, i);
+    GstBuffer *output_buffer;
+    guint64 num;
+
+    g_assert (gst_buffer_extract (buffer, 0, &num, sizeof (num))
+        == sizeof (num));
+    g_assert (!worker->primed || num == worker->next);
+    worker->primed = TRUE;
+    worker->next = num + 1;
+
+    if (i < preroll)
+      continue;
+
+    /* the output is SE32LE stereo 44100 Hz */
+    output_buffer = gst_buffer_new_allocate (NULL, sizeof (num), NULL);
+    gst_buffer_fill (output_buffer, 0, &num, sizeof (num));
+    if (worker->tester->corrupt_frame == (gint64) num) {
+      gst_buffer_set_size (output_buffer, 0);
+      GST_BUFFER_FLAG_SET (output_buffer, GST_BUFFER_FLAG_CORRUPTED);
+    }
+    gst_buffer_list_add (output, output_buffer);
+  }
+
+  return GST_FLOW_OK;
+}
+
+static void
+gst_audio_decoder_tester_free_worker (GstAudioDecoder * dec, gpointer worker)
+{
+  g_free (worker);
+}
+
 static void
 gst_audio_decoder_tester_class_init (GstAudioDecoderTesterClass * klass)
 {
@@ -223,11 +292,15 @@ gst_audio_decoder_tester_class_init (GstAudioDecoderTesterClass * klass)
   audiosink_class->flush = gst_audio_decoder_tester_flush;
   audiosink_class->handle_frame = gst_audio_decoder_tester_handle_frame;
   audiosink_class->set_format = gst_audio_decoder_tester_set_format;
+  audiosink_class->create_worker = gst_audio_decoder_tester_create_worker;
+  audiosink_class->decode_frames = gst_audio_decoder_tester_decode_frames;
+  audiosink_class->free_worker = gst_audio_decoder_tester_free_worker;
 }
 
 static void
 gst_audio_decoder_tester_init (GstAudioDecoderTester * tester)
 {
+  tester->corrupt_frame = -1;
 }
 
 static GstHarness *
@@ -1136,6 +1209,185 @@ GST_START_TEST (audiodecoder_plc_on_gap_event_with_delay)
 
 GST_END_TEST;
 
+/* number of frames the base class decodes together */
+#define BATCH_FRAMES 32
+#define NUM_PARALLEL_BUFFERS (3 * BATCH_FRAMES + 5)
+
+static void
+check_parallel_output (GstHarness * h, guint64 start, guint64 end,
+    guint64 skip)
+{
+  guint64 i;
+
+  for (i = start; i < end; i++) {
+    GstBuffer *buffer;
+    guint64 num;
+
+    if (i == skip)
+      continue;
+
+    buffer = gst_harness_pull (h);
+    fail_unless (gst_buffer_extract (buffer, 0, &num, sizeof (num))
+        == sizeof (num));
+    fail_unless_equals_uint64 (num, i);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer),
+        gst_util_uint64_scale_round (i, GST_SECOND, TEST_MSECS_PER_SAMPLE));
+    fail_unless_equals_uint64 (GST_BUFFER_DURATION (buffer),
+        gst_util_uint64_scale_round (1, GST_SECOND, TEST_MSECS_PER_SAMPLE));
+    gst_buffer_unref (buffer);
+  }
+}
+
+static void
+_audiodecoder_parallel_decoding (guint threads, guint preroll)
+{
+  GstHarness *h = setup_audiodecodertester (NULL, NULL);
+  GstAudioDecoderTester *tester = (GstAudioDecoderTester *) h->element;
+  guint64 i;
+
+  g_object_set (h->element, "decode-threads", threads, NULL);
+  tester->preroll = preroll;
+
+  for (i = 0; i < NUM_PARALLEL_BUFFERS; i++) {
+    fail_unless_equals_int (gst_harness_push (h, create_test_buffer (i)),
+        GST_FLOW_OK);
+
+    /* serialized events are forwarded after all preceding frames */
+    if (i == BATCH_FRAMES + 3) {
+      fail_unless (gst_harness_push_event (h,
+              gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM,
+                  gst_structure_new_empty ("test"))));
+      fail_unless_equals_int (gst_harness_buffers_received (h), i + 1);
+    }
+  }
+  fail_unless (gst_harness_buffers_received (h) < NUM_PARALLEL_BUFFERS);
+
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+  fail_unless_equals_int (gst_harness_buffers_received (h),
+      NUM_PARALLEL_BUFFERS);
+
+  check_parallel_output (h, 0, NUM_PARALLEL_BUFFERS, -1);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 0);
+
+  gst_harness_teardown (h);
+}
+
+GST_START_TEST (audiodecoder_parallel_decoding)
+{
+  _audiodecoder_parallel_decoding (4, 0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (audiodecoder_parallel_decoding_auto_threads)
+{
+  _audiodecoder_parallel_decoding (0, 0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (audiodecoder_parallel_decoding_preroll)
+{
+  _audiodecoder_parallel_decoding (4, 3);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (audiodecoder_parallel_decoding_flush)
+{
+  GstHarness *h = setup_audiodecodertester (NULL, NULL);
+  GstSegment segment;
+  guint64 i;
+
+  g_object_set (h->element, "decode-threads", 4, NULL);
+
+  for (i = 0; i < BATCH_FRAMES + 5; i++)
+    fail_unless_equals_int (gst_harness_push (h, create_test_buffer (i)),
+        GST_FLOW_OK);
+
+  /* pending batches are dropped */
+  fail_unless (gst_harness_push_event (h, gst_event_new_flush_start ()));
+  fail_unless (gst_harness_push_event (h, gst_event_new_flush_stop (TRUE)));
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_harness_push_event (h, gst_event_new_segment (&segment)));
+  while (gst_harness_buffers_in_queue (h))
+    gst_buffer_unref (gst_harness_pull (h));
+
+  for (i = 0; i < BATCH_FRAMES + 5; i++)
+    fail_unless_equals_int (gst_harness_push (h, create_test_buffer (i)),
+        GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  check_parallel_output (h, 0, BATCH_FRAMES + 5, -1);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 0);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+static void
+_audiodecoder_parallel_decoding_error (gint max_errors, guint expected)
+{
+  GstHarness *h = setup_audiodecodertester (NULL, NULL);
+  GstAudioDecoderTester *tester = (GstAudioDecoderTester *) h->element;
+  guint64 i;
+
+  g_object_set (h->element, "decode-threads", 2, NULL);
+  gst_audio_decoder_set_max_errors (GST_AUDIO_DECODER (h->element),
+      max_errors);
+  tester->corrupt_frame = 5;
+
+  for (i = 0; i < BATCH_FRAMES; i++)
+    fail_unless_equals_int (gst_harness_push (h, create_test_buffer (i)),
+        GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h,
+          gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM,
+              gst_structure_new_empty ("test"))));
+
+  fail_unless_equals_int (gst_harness_buffers_received (h), expected);
+  check_parallel_output (h, 0, expected + 1, 5);
+
+  gst_harness_teardown (h);
+}
+
+GST_START_TEST (audiodecoder_parallel_decoding_error)
+{
+  /* the failed frame is counted as a decoding error and skipped */
+  _audiodecoder_parallel_decoding_error (-1, BATCH_FRAMES - 1);
+  /* too many errors drop the rest of the batch */
+  _audiodecoder_parallel_decoding_error (0, 5);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (audiodecoder_parallel_decoding_latency)
+{
+  GstHarness *h = setup_audiodecodertester (NULL, NULL);
+  GstClockTime dur =
+      gst_util_uint64_scale_int (1, GST_SECOND, TEST_MSECS_PER_SAMPLE);
+  guint64 i;
+
+  g_object_set (h->element, "decode-threads", 4, NULL);
+  fail_unless_equals_uint64 (gst_harness_query_latency (h), 0);
+
+  for (i = 0; i < BATCH_FRAMES; i++)
+    fail_unless_equals_int (gst_harness_push (h, create_test_buffer (i)),
+        GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  /* a frame is delayed until its batch is full */
+  fail_unless_equals_uint64 (gst_harness_query_latency (h),
+      BATCH_FRAMES * dur);
+
+  g_object_set (h->element, "decode-threads", 1, NULL);
+  fail_unless_equals_uint64 (gst_harness_query_latency (h), 0);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_audiodecoder_suite (void)
 {
@@ -1166,6 +1418,13 @@ gst_audiodecoder_suite (void)
   tcase_add_test (tc, audiodecoder_plc_on_gap_event);
   tcase_add_test (tc, audiodecoder_plc_on_gap_event_with_delay);
 
+  tcase_add_test (tc, audiodecoder_parallel_decoding);
+  tcase_add_test (tc, audiodecoder_parallel_decoding_auto_threads);
+  tcase_add_test (tc, audiodecoder_parallel_decoding_preroll);
+  tcase_add_test (tc, audiodecoder_parallel_decoding_flush);
+  tcase_add_test (tc, audiodecoder_parallel_decoding_error);
+  tcase_add_test (tc, audiodecoder_parallel_decoding_latency);
+
   return s;
 }
 
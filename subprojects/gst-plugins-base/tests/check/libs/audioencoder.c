@@ -31,6 +31,10 @@
 #define TEST_AUDIO_RATE 44100
 #define TEST_AUDIO_CHANNELS 2
 #define TEST_AUDIO_FORMAT "S16LE"
+#define TEST_AUDIO_BPF (2 * TEST_AUDIO_CHANNELS)
+
+/* samples per frame when the tester is set up to encode frames */
+#define TEST_FRAME_SAMPLES (TEST_AUDIO_RATE / 4)
 
 #define GST_AUDIO_ENCODER_TESTER_TYPE gst_audio_encoder_tester_get_type()
 static GType gst_audio_encoder_tester_get_type (void);
@@ -41,6 +45,12 @@ typedef struct _GstAudioEncoderTesterClass GstAudioEncoderTesterClass;
 struct _GstAudioEncoderTester
 {
   GstAudioEncoder parent;
+
+  /* encode each TEST_FRAME_SAMPLES frame into a buffer holding its index */
+  gboolean frames;
+  guint64 out_num;
+  /* index of the frame that gets new output caps, or -1 */
+  gint64 caps_change_at;
 };
 
 struct _GstAudioEncoderTesterClass
@@ -76,6 +86,42 @@ gst_audio_encoder_tester_set_format (GstAudioEncoder * enc, GstAudioInfo * info)
   return TRUE;
 }
 
+static GstFlowReturn
+gst_audio_encoder_tester_handle_frames (GstAudioEncoder * enc,
+    GstBuffer * buffer)
+{
+  GstAudioEncoderTester *tester = (GstAudioEncoderTester *) enc;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i, n_frames;
+
+  n_frames = gst_buffer_get_size (buffer) / (TEST_FRAME_SAMPLES *
+      TEST_AUDIO_BPF);
+
+  for (i = 0; i < n_frames && ret == GST_FLOW_OK; i++) {
+    GstBuffer *output_buffer;
+    guint64 *data;
+
+    if (tester->out_num == tester->caps_change_at) {
+      GstCaps *caps;
+
+      caps = gst_caps_new_simple ("audio/x-test-custom", "rate", G_TYPE_INT,
+          TEST_AUDIO_RATE, "channels", G_TYPE_INT, TEST_AUDIO_CHANNELS,
+          "changed", G_TYPE_BOOLEAN, TRUE, NULL);
+      gst_audio_encoder_set_output_format (enc, caps);
+      gst_caps_unref (caps);
+    }
+
+    data = g_new (guint64, 1);
+    *data = tester->out_num++;
+    output_buffer = gst_buffer_new_wrapped (data, sizeof (guint64));
+
+    ret = gst_audio_encoder_finish_frame (enc, output_buffer,
+        TEST_FRAME_SAMPLES);
+  }
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_audio_encoder_tester_handle_frame (GstAudioEncoder * enc,
     GstBuffer * buffer)
@@ -88,6 +134,9 @@ gst_audio_encoder_tester_handle_frame (GstAudioEncoder * enc,
   if (buffer == NULL)
     return GST_FLOW_OK;
 
+  if (((GstAudioEncoderTester *) enc)->frames)
+    return gst_audio_encoder_tester_handle_frames (enc, buffer);
+
   gst_buffer_map (buffer, &map, GST_MAP_READ);
   input_num = *((guint64 *) map.data);
   gst_buffer_unmap (buffer, &map);
@@ -131,6 +180,7 @@ gst_audio_encoder_tester_class_init (GstAudioEncoderTesterClass * klass)
 static void
 gst_audio_encoder_tester_init (GstAudioEncoderTester * tester)
 {
+  tester->caps_change_at = -1;
 }
 
 static GstHarness *
@@ -164,6 +214,96 @@ setup_audioencodertester (void)
   return h;
 }
 
+/* sets up the tester to encode all complete frames of each input buffer at
+ * once and push the output as buffer lists */
+static GstHarness *
+setup_audioencodertester_frames (gint64 caps_change_at)
+{
+  GstHarness *h = setup_audioencodertester ();
+  GstAudioEncoder *enc = GST_AUDIO_ENCODER (h->element);
+
+  ((GstAudioEncoderTester *) enc)->frames = TRUE;
+  ((GstAudioEncoderTester *) enc)->caps_change_at = caps_change_at;
+  gst_audio_encoder_set_frame_samples_min (enc, TEST_FRAME_SAMPLES);
+  gst_audio_encoder_set_frame_samples_max (enc, TEST_FRAME_SAMPLES);
+  gst_audio_encoder_set_frame_max (enc, 0);
+  gst_audio_encoder_set_output_buffer_list (enc, TRUE);
+
+  return h;
+}
+
+/* logs what the encoder pushes: "L<n>" for lists, "B" for single buffers,
+ * and the name of caps and custom events */
+static GstPadProbeReturn
+log_output (GstPad * pad, GstPadProbeInfo * info, GString * log)
+{
+  if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    g_string_append_printf (log, "L%u ",
+        gst_buffer_list_length (GST_PAD_PROBE_INFO_BUFFER_LIST (info)));
+  } else if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    g_string_append (log, "B ");
+  } else {
+    GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+
+    if (GST_EVENT_TYPE (event) == GST_EVENT_CAPS)
+      g_string_append (log, "caps ");
+    else if (GST_EVENT_TYPE (event) == GST_EVENT_CUSTOM_DOWNSTREAM)
+      g_string_append_printf (log, "%s ",
+          gst_structure_get_name (gst_event_get_structure (event)));
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GString *
+add_output_log (GstHarness * h)
+{
+  GString *log = g_string_new (NULL);
+  GstPad *srcpad = gst_element_get_static_pad (h->element, "src");
+
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BUFFER |
+      GST_PAD_PROBE_TYPE_BUFFER_LIST | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+      (GstPadProbeCallback) log_output, log, NULL);
+  gst_object_unref (srcpad);
+
+  return log;
+}
+
+/* returns a buffer with the silence from frame @start to @end */
+static GstBuffer *
+create_frames_buffer (gdouble start, gdouble end)
+{
+  guint64 offset = start * TEST_FRAME_SAMPLES;
+  gsize size = ((guint64) (end * TEST_FRAME_SAMPLES) - offset) * TEST_AUDIO_BPF;
+  GstBuffer *buffer = gst_buffer_new_wrapped (g_malloc0 (size), size);
+
+  GST_BUFFER_PTS (buffer) =
+      gst_util_uint64_scale_int (offset, GST_SECOND, TEST_AUDIO_RATE);
+
+  return buffer;
+}
+
+/* pulls @n buffers and checks that they hold the frame indices in order */
+static void
+check_frames_output (GstHarness * h, guint n)
+{
+  guint64 i;
+
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), n);
+  for (i = 0; i < n; i++) {
+    GstBuffer *buffer = gst_harness_pull (h);
+    GstMapInfo map;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    gst_buffer_unmap (buffer, &map);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer),
+        gst_util_uint64_scale_int (i * TEST_FRAME_SAMPLES, GST_SECOND,
+            TEST_AUDIO_RATE));
+    gst_buffer_unref (buffer);
+  }
+}
+
 static GstBuffer *
 create_test_buffer (guint64 num)
 {
@@ -395,6 +535,77 @@ GST_START_TEST (audioencoder_events_before_eos)
 
 GST_END_TEST;
 
+/* the frames encoded from each input buffer are pushed as one list */
+GST_START_TEST (audioencoder_output_buffer_list)
+{
+  GstHarness *h = setup_audioencodertester_frames (-1);
+  GString *log = add_output_log (h);
+  guint i;
+
+  for (i = 0; i < 3; i++)
+    fail_unless (gst_harness_push (h,
+            create_frames_buffer (i * 4, (i + 1) * 4)) == GST_FLOW_OK);
+  fail_unless_equals_string (log->str, "caps L4 L4 L4 ");
+
+  check_frames_output (h, 12);
+
+  g_string_free (log, TRUE);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+/* serialized events that arrived after data of the current input buffer are
+ * pushed after the frames encoded from that data, and before the others */
+GST_START_TEST (audioencoder_output_buffer_list_events)
+{
+  GstHarness *h = setup_audioencodertester_frames (-1);
+  GString *log = add_output_log (h);
+
+  /* half a frame stays in the adapter */
+  fail_unless (gst_harness_push (h, create_frames_buffer (0, 3.5)) ==
+      GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h,
+          gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM,
+              gst_structure_new_empty ("test"))));
+  fail_unless (gst_harness_push (h, create_frames_buffer (3.5, 7)) ==
+      GST_FLOW_OK);
+  fail_unless_equals_string (log->str, "caps L3 L1 test L3 ");
+
+  check_frames_output (h, 7);
+
+  g_string_free (log, TRUE);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+/* the frames encoded before new output caps are pushed before them */
+GST_START_TEST (audioencoder_output_buffer_list_caps)
+{
+  GstHarness *h = setup_audioencodertester_frames (6);
+  GString *log = add_output_log (h);
+  GstCaps *caps;
+
+  fail_unless (gst_harness_push (h, create_frames_buffer (0, 4)) ==
+      GST_FLOW_OK);
+  fail_unless (gst_harness_push (h, create_frames_buffer (4, 8)) ==
+      GST_FLOW_OK);
+  fail_unless_equals_string (log->str, "caps L4 L2 caps L2 ");
+
+  caps = gst_pad_get_current_caps (h->sinkpad);
+  fail_unless (gst_structure_has_field (gst_caps_get_structure (caps, 0),
+          "changed"));
+  gst_caps_unref (caps);
+
+  check_frames_output (h, 8);
+
+  g_string_free (log, TRUE);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_audioencoder_suite (void)
 {
@@ -407,6 +618,9 @@ gst_audioencoder_suite (void)
   tcase_add_test (tc, audioencoder_tags_before_eos);
   tcase_add_test (tc, audioencoder_events_before_eos);
   tcase_add_test (tc, audioencoder_flush_events);
+  tcase_add_test (tc, audioencoder_output_buffer_list);
+  tcase_add_test (tc, audioencoder_output_buffer_list_events);
+  tcase_add_test (tc, audioencoder_output_buffer_list_caps);
 
   return s;
 }
@@ -373,6 +373,75 @@ GST_START_TEST (test_disco_async_custom_context)
 
 GST_END_TEST;
 
+typedef struct _ParallelTestData
+{
+  gchar *uri;
+  GMainLoop *loop;
+  guint n_discovered;
+  guint n_ok;
+} ParallelTestData;
+
+static void
+parallel_discovered_cb (GstDiscoverer * discoverer,
+    GstDiscovererInfo * info, GError * err, ParallelTestData * data)
+{
+  fail_unless_equals_string (data->uri, gst_discoverer_info_get_uri (info));
+
+  data->n_discovered++;
+  if (gst_discoverer_info_get_result (info) == GST_DISCOVERER_OK)
+    data->n_ok++;
+}
+
+static void
+parallel_finished_cb (GstDiscoverer * discoverer, ParallelTestData * data)
+{
+  g_main_loop_quit (data->loop);
+}
+
+#define N_PARALLEL_URIS 6
+
+GST_START_TEST (test_disco_async_parallel)
+{
+  GstDiscoverer *dc;
+  GError *err = NULL;
+  ParallelTestData data = { 0, };
+  gchar *path =
+      g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+  guint i;
+
+  data.uri = gst_filename_to_uri (path, &err);
+  fail_unless (err == NULL);
+  g_free (path);
+
+  data.loop = g_main_loop_new (NULL, FALSE);
+
+  dc = gst_discoverer_new (30 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+  g_object_set (dc, "max-parallel", 3, NULL);
+
+  g_signal_connect (dc, "discovered", G_CALLBACK (parallel_discovered_cb),
+      &data);
+  g_signal_connect (dc, "finished", G_CALLBACK (parallel_finished_cb), &data);
+
+  gst_discoverer_start (dc);
+  for (i = 0; i < N_PARALLEL_URIS; i++)
+    fail_unless (gst_discoverer_discover_uri_async (dc, data.uri) == TRUE);
+
+  g_main_loop_run (data.loop);
+
+  fail_unless_equals_int (data.n_discovered, N_PARALLEL_URIS);
+  if (have_theora && have_ogg)
+    fail_unless_equals_int (data.n_ok, N_PARALLEL_URIS);
+
+  gst_discoverer_stop (dc);
+  g_object_unref (dc);
+  g_free (data.uri);
+  g_main_loop_unref (data.loop);
+}
+
+GST_END_TEST;
+
 static Suite *
 discoverer_suite (void)
 {
@@ -394,6 +463,7 @@ discoverer_suite (void)
   tcase_add_test (tc_chain, test_disco_serializing);
   tcase_add_test (tc_chain, test_disco_async);
   tcase_add_test (tc_chain, test_disco_async_custom_context);
+  tcase_add_test (tc_chain, test_disco_async_parallel);
   return s;
 }
 
@@ -401,6 +401,68 @@ GST_START_TEST (test_f32_22050hz)
 
 GST_END_TEST;
 
+static void
+check_f32_batch (gint len)
+{
+  gint i, n, nfreq = len / 2 + 1;
+  gfloat *in, *out_time;
+  GstFFTF32Complex *out, *ref;
+  GstFFTF32 *ctx, *inverse_ctx;
+
+  /* 7 transforms to also cover the ones that are not done in parallel */
+  in = g_new (gfloat, 7 * len);
+  out_time = g_new (gfloat, 7 * len);
+  out = g_new (GstFFTF32Complex, 7 * nfreq);
+  ref = g_new (GstFFTF32Complex, nfreq);
+  ctx = gst_fft_f32_new (len, FALSE);
+  inverse_ctx = gst_fft_f32_new (len, TRUE);
+
+  for (i = 0; i < 7 * len; i++)
+    in[i] = sin (2.0 * G_PI * (i / len + 1) * 10.0 * (i % len) / len);
+
+  gst_fft_f32_fft_batch (ctx, in, out, 7);
+
+  for (n = 0; n < 7; n++) {
+    gst_fft_f32_fft (ctx, in + n * len, ref);
+    for (i = 0; i < nfreq; i++) {
+      fail_unless (fabs (out[n * nfreq + i].r - ref[i].r) < 1e-2,
+          "length %d, transform %d, bin %d: %f != %f", len, n, i,
+          out[n * nfreq + i].r, ref[i].r);
+      fail_unless (fabs (out[n * nfreq + i].i - ref[i].i) < 1e-2,
+          "length %d, transform %d, bin %d: %f != %f", len, n, i,
+          out[n * nfreq + i].i, ref[i].i);
+    }
+  }
+
+  gst_fft_f32_inverse_fft_batch (inverse_ctx, out, out_time, 7);
+
+  for (i = 0; i < 7 * len; i++)
+    fail_unless (fabs (out_time[i] / len - in[i]) < 1e-4,
+        "length %d, sample %d: %f != %f", len, i, out_time[i] / len, in[i]);
+
+  gst_fft_f32_free (ctx);
+  gst_fft_f32_free (inverse_ctx);
+  g_free (in);
+  g_free (out_time);
+  g_free (out);
+  g_free (ref);
+}
+
+GST_START_TEST (test_f32_batch)
+{
+  /* radix 2 and 4 only */
+  check_f32_batch (2048);
+  /* 500 and 3000 complex points, with radix 3 and 5 stages */
+  check_f32_batch (1000);
+  check_f32_batch (6000);
+  /* odd number of complex points, 375 = 3 * 5^3 and 135 = 3^3 * 5, where
+   * the real-to-complex split has no middle bin of its own */
+  check_f32_batch (750);
+  check_f32_batch (270);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_f64_0hz)
 {
   gint i;
@@ -521,6 +583,49 @@ GST_START_TEST (test_f64_22050hz)
 
 GST_END_TEST;
 
+GST_START_TEST (test_f64_batch)
+{
+  gint i, n;
+  gdouble *in, *out_time;
+  GstFFTF64Complex *out, *ref;
+  GstFFTF64 *ctx, *inverse_ctx;
+
+  /* 7 transforms to also cover the ones that are not done in parallel */
+  in = g_new (gdouble, 7 * 2048);
+  out_time = g_new (gdouble, 7 * 2048);
+  out = g_new (GstFFTF64Complex, 7 * 1025);
+  ref = g_new (GstFFTF64Complex, 1025);
+  ctx = gst_fft_f64_new (2048, FALSE);
+  inverse_ctx = gst_fft_f64_new (2048, TRUE);
+
+  for (i = 0; i < 7 * 2048; i++)
+    in[i] = sin (2.0 * G_PI * (i / 2048 + 1) * 100.0 * (i % 2048) / 2048.0);
+
+  gst_fft_f64_fft_batch (ctx, in, out, 7);
+
+  for (n = 0; n < 7; n++) {
+    gst_fft_f64_fft (ctx, in + n * 2048, ref);
+    for (i = 0; i < 1025; i++) {
+      fail_unless (fabs (out[n * 1025 + i].r - ref[i].r) < 1e-8);
+      fail_unless (fabs (out[n * 1025 + i].i - ref[i].i) < 1e-8);
+    }
+  }
+
+  gst_fft_f64_inverse_fft_batch (inverse_ctx, out, out_time, 7);
+
+  for (i = 0; i < 7 * 2048; i++)
+    fail_unless (fabs (out_time[i] / 2048.0 - in[i]) < 1e-10);
+
+  gst_fft_f64_free (ctx);
+  gst_fft_f64_free (inverse_ctx);
+  g_free (in);
+  g_free (out_time);
+  g_free (out);
+  g_free (ref);
+}
+
+GST_END_TEST;
+
 static Suite *
 fft_suite (void)
 {
@@ -541,6 +646,8 @@ fft_suite (void)
   tcase_add_test (tc_chain, test_f64_0hz);
   tcase_add_test (tc_chain, test_f64_11025hz);
   tcase_add_test (tc_chain, test_f64_22050hz);
+  tcase_add_test (tc_chain, test_f32_batch);
+  tcase_add_test (tc_chain, test_f64_batch);
 
   return s;
 }
@@ -724,6 +724,41 @@ GST_START_TEST (test_display_list_readd)
 
 GST_END_TEST;
 
+GST_START_TEST (test_display_context_pool)
+{
+  GstGLContext *c1 = NULL, *c2 = NULL, *c3 = NULL;
+  GError *error = NULL;
+
+  GST_OBJECT_LOCK (display);
+  gst_gl_display_set_context_pool_size (display, 2);
+  fail_unless_equals_int (gst_gl_display_get_context_pool_size (display), 2);
+
+  fail_unless (gst_gl_display_ensure_context (display, NULL, &c1, &error));
+  fail_if (error != NULL, "Error creating context %s\n",
+      error ? error->message : "Unknown Error");
+  fail_unless (gst_gl_display_add_context (display, c1));
+
+  /* a second context sharing with the first one */
+  fail_unless (gst_gl_display_ensure_context (display, NULL, &c2, &error));
+  fail_if (error != NULL, "Error creating context %s\n",
+      error ? error->message : "Unknown Error");
+  fail_unless (gst_gl_display_add_context (display, c2));
+  fail_unless (c1 != c2);
+  fail_unless (gst_gl_context_can_share (c1, c2));
+
+  /* the pool is full, an existing context is returned */
+  fail_unless (gst_gl_display_ensure_context (display, NULL, &c3, &error));
+  fail_unless (c3 == c1 || c3 == c2);
+  fail_unless (gst_gl_display_add_context (display, c3));
+  GST_OBJECT_UNLOCK (display);
+
+  gst_object_unref (c1);
+  gst_object_unref (c2);
+  gst_object_unref (c3);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_gl_context_suite (void)
 {
@@ -740,6 +775,7 @@ gst_gl_context_suite (void)
   tcase_add_test (tc_chain, test_display_list);
   tcase_add_test (tc_chain, test_display_list_remove);
   tcase_add_test (tc_chain, test_display_list_readd);
+  tcase_add_test (tc_chain, test_display_context_pool);
 
   return s;
 }
@@ -51,6 +51,7 @@
 #include <gst/pbutils/encoding-target.h>
 #include <gst/pbutils/gstdiscoverer.h>
 #include <gst/pbutils/gstpluginsbaseversion.h>
+#include <gst/pbutils/gstqoscontroller.h>
 #include <gst/pbutils/install-plugins.h>
 #include <gst/pbutils/missing-plugins.h>
 #include <gst/pbutils/pbutils-enumtypes.h>
@@ -0,0 +1,171 @@
+/* GStreamer unit test for GstQosController
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/pbutils/pbutils.h>
+
+static void
+add_knob (GstQosController * controller, GstElement * element,
+    const gchar * property, gint priority, const gchar * levels_str)
+{
+  GValue levels = G_VALUE_INIT;
+
+  g_value_init (&levels, GST_TYPE_ARRAY);
+  fail_unless (gst_value_deserialize (&levels, levels_str));
+  fail_unless (gst_qos_controller_add_knob (controller, element, property,
+          priority, &levels));
+  g_value_unset (&levels);
+}
+
+static void
+post_qos (GstElement * sink, guint64 processed, guint64 dropped)
+{
+  GstMessage *msg;
+
+  msg = gst_message_new_qos (GST_OBJECT (sink), TRUE, 0, 0, 0, 0);
+  gst_message_set_qos_values (msg, 0, 1.0, 1000000);
+  gst_message_set_qos_stats (msg, GST_FORMAT_BUFFERS, processed, dropped);
+  fail_unless (gst_element_post_message (sink, msg));
+}
+
+/* posts QoS messages with 1/3 dropped buffers until @level is reached */
+static gboolean
+overload_until (GstQosController * controller, GstElement * sink,
+    guint64 * processed, guint level)
+{
+  gint i;
+
+  for (i = 0; i < 500; i++) {
+    if (gst_qos_controller_get_level (controller) == level)
+      return TRUE;
+    *processed += 10;
+    post_qos (sink, *processed, *processed / 2);
+    g_usleep (G_USEC_PER_SEC / 100);
+  }
+  return FALSE;
+}
+
+static gboolean
+wait_for_level (GstQosController * controller, guint level)
+{
+  gint i;
+
+  for (i = 0; i < 500; i++) {
+    if (gst_qos_controller_get_level (controller) == level)
+      return TRUE;
+    g_usleep (G_USEC_PER_SEC / 100);
+  }
+  return FALSE;
+}
+
+GST_START_TEST (test_degrade_and_recover)
+{
+  GstQosController *controller;
+  GstElement *pipe, *identity, *sink;
+  guint64 processed = 0, max_lateness;
+  guint sleep_time;
+
+  pipe = gst_pipeline_new (NULL);
+  identity = gst_element_factory_make ("identity", NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  gst_bin_add_many (GST_BIN (pipe), identity, sink, NULL);
+
+  controller = g_object_new (GST_TYPE_QOS_CONTROLLER, "pipeline", pipe,
+      "interval", 10 * GST_MSECOND, NULL);
+  gst_object_ref_sink (controller);
+  g_object_set (controller, "degrade-intervals", 1, "recover-intervals", 2,
+      NULL);
+
+  /* the lower priority knob is degraded first */
+  add_knob (controller, sink, "max-lateness", 1, "< -1, 1000 >");
+  add_knob (controller, identity, "sleep-time", 0, "< 0, 1000, 2000 >");
+  fail_unless_equals_int (gst_qos_controller_get_level (controller), 0);
+
+  fail_unless (overload_until (controller, sink, &processed, 2));
+  g_object_get (identity, "sleep-time", &sleep_time, NULL);
+  g_object_get (sink, "max-lateness", &max_lateness, NULL);
+  fail_unless_equals_int (sleep_time, 2000);
+  fail_unless_equals_int64 (max_lateness, -1);
+
+  fail_unless (overload_until (controller, sink, &processed, 3));
+  g_object_get (sink, "max-lateness", &max_lateness, NULL);
+  fail_unless_equals_int64 (max_lateness, 1000);
+
+  /* without QoS messages the pipeline is healthy and gets restored in the
+   * reverse order */
+  fail_unless (wait_for_level (controller, 2));
+  g_object_get (sink, "max-lateness", &max_lateness, NULL);
+  fail_unless_equals_int64 (max_lateness, -1);
+  fail_unless (wait_for_level (controller, 0));
+  g_object_get (identity, "sleep-time", &sleep_time, NULL);
+  fail_unless_equals_int (sleep_time, 0);
+
+  gst_object_unref (controller);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_invalid_knob)
+{
+  GstQosController *controller;
+  GstElement *pipe, *identity;
+  GValue levels = G_VALUE_INIT;
+
+  pipe = gst_pipeline_new (NULL);
+  identity = gst_element_factory_make ("identity", NULL);
+  gst_bin_add (GST_BIN (pipe), identity);
+
+  controller = gst_qos_controller_new (GST_PIPELINE (pipe));
+
+  g_value_init (&levels, GST_TYPE_ARRAY);
+  fail_unless (gst_value_deserialize (&levels, "< 0, 1000 >"));
+  fail_if (gst_qos_controller_add_knob (controller, identity, "no-such-prop",
+          0, &levels));
+  g_value_unset (&levels);
+
+  g_value_init (&levels, GST_TYPE_ARRAY);
+  fail_unless (gst_value_deserialize (&levels, "< 0, not-a-number >"));
+  fail_if (gst_qos_controller_add_knob (controller, identity, "sleep-time",
+          0, &levels));
+  g_value_unset (&levels);
+
+  gst_object_unref (controller);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static Suite *
+qos_controller_suite (void)
+{
+  Suite *s = suite_create ("qoscontroller");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_degrade_and_recover);
+  tcase_add_test (tc_chain, test_invalid_knob);
+
+  return s;
+}
+
+GST_CHECK_MAIN (qos_controller);
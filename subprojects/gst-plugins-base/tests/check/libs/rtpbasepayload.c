@@ -1993,6 +1993,63 @@ GST_START_TEST (rtp_base_payload_segment_time)
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+count_lists_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  guint *lengths = user_data;
+
+  lengths[lengths[0] + 1] =
+      gst_buffer_list_length (GST_PAD_PROBE_INFO_BUFFER_LIST (info));
+  lengths[0]++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* Test that the packets of an access unit are pushed as one list, which is
+ * finished either by a packet with a new timestamp or by a serialized event */
+GST_START_TEST (rtp_base_payload_access_unit_lists)
+{
+  State *state;
+  GstPad *pad;
+  guint lengths[4] = { 0, };
+
+  state = create_payloader ("application/x-rtp", &sinktmpl,
+      "access-unit-lists", TRUE, "timestamp-offset", 0, NULL);
+
+  pad = gst_element_get_static_pad (state->element, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER_LIST, count_lists_probe,
+      lengths, NULL);
+  gst_object_unref (pad);
+
+  set_state (state, GST_STATE_PLAYING);
+
+  push_buffer (state, "pts", 0 * GST_SECOND, NULL);
+  push_buffer (state, "pts", 0 * GST_SECOND, NULL);
+  push_buffer (state, "pts", 0 * GST_SECOND, NULL);
+  validate_buffers_received (0);
+
+  push_buffer (state, "pts", 1 * GST_SECOND, NULL);
+  validate_buffers_received (3);
+
+  fail_unless (gst_pad_push_event (state->srcpad, gst_event_new_eos ()));
+  validate_buffers_received (4);
+
+  set_state (state, GST_STATE_NULL);
+
+  fail_unless_equals_int (lengths[0], 2);
+  fail_unless_equals_int (lengths[1], 3);
+  fail_unless_equals_int (lengths[2], 1);
+
+  validate_buffer (0, "pts", 0 * GST_SECOND, "rtptime", 0, NULL);
+  validate_buffer (2, "pts", 0 * GST_SECOND, "rtptime", 0, NULL);
+  validate_buffer (3, "pts", 1 * GST_SECOND, "rtptime", DEFAULT_CLOCK_RATE,
+      NULL);
+
+  destroy_payloader (state);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (rtp_base_payload_one_byte_hdr_ext)
 {
   GstRTPHeaderExtension *ext;
@@ -2349,6 +2406,7 @@ rtp_basepayloading_suite (void)
   tcase_add_test (tc_chain, rtp_base_payload_max_framerate_attribute);
 
   tcase_add_test (tc_chain, rtp_base_payload_segment_time);
+  tcase_add_test (tc_chain, rtp_base_payload_access_unit_lists);
 
   tcase_add_test (tc_chain, rtp_base_payload_one_byte_hdr_ext);
   tcase_add_test (tc_chain, rtp_base_payload_two_byte_hdr_ext);
@@ -928,6 +928,90 @@ GST_START_TEST (test_rtspconnection_send_receive_content_length)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtspconnection_read_buffer)
+{
+  GSocketConnection *input_conn = NULL;
+  GSocketConnection *output_conn = NULL;
+  GSocket *input_sock;
+  GSocket *output_sock;
+  GstRTSPConnection *rtsp_output_conn;
+  GstRTSPConnection *rtsp_input_conn;
+  GstRTSPMessage *msg;
+  GstRTSPStatusCode code;
+  GstBuffer *body;
+  guint8 payload[] = { 0x80, 0x60, 0x01, 0x02, 0x03 };
+  guint8 channel;
+  gint i;
+
+  create_connection (&input_conn, &output_conn);
+  input_sock = g_socket_connection_get_socket (input_conn);
+  fail_unless (input_sock != NULL);
+  output_sock = g_socket_connection_get_socket (output_conn);
+  fail_unless (output_sock != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (input_sock, "127.0.0.1",
+          4444, NULL, &rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (rtsp_input_conn != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (output_sock, "127.0.0.1",
+          4444, NULL, &rtsp_output_conn) == GST_RTSP_OK);
+  fail_unless (rtsp_output_conn != NULL);
+
+  /* two data messages followed by a response */
+  for (i = 0; i < 2; i++) {
+    fail_unless (gst_rtsp_message_new_data (&msg, i) == GST_RTSP_OK);
+    fail_unless (gst_rtsp_message_set_body (msg, payload,
+            sizeof (payload)) == GST_RTSP_OK);
+    fail_unless (gst_rtsp_connection_send (rtsp_output_conn, msg,
+            NULL) == GST_RTSP_OK);
+    fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+  }
+  fail_unless (gst_rtsp_message_new_response (&msg, GST_RTSP_STS_OK, NULL,
+          NULL) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_add_header (msg, GST_RTSP_HDR_CSEQ,
+          "1") == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_send (rtsp_output_conn, msg,
+          NULL) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+
+  gst_rtsp_connection_set_read_buffer_size (rtsp_input_conn, 4096);
+
+  /* the payloads are shared with the read buffer */
+  for (i = 0; i < 2; i++) {
+    fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+    fail_unless (gst_rtsp_connection_receive (rtsp_input_conn, msg,
+            NULL) == GST_RTSP_OK);
+    fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_DATA);
+    fail_unless (gst_rtsp_message_parse_data (msg, &channel) == GST_RTSP_OK);
+    fail_unless_equals_int (channel, i);
+    fail_unless (gst_rtsp_message_has_body_buffer (msg));
+    fail_unless (gst_rtsp_message_steal_body_buffer (msg,
+            &body) == GST_RTSP_OK);
+    fail_unless_equals_int (gst_buffer_get_size (body), sizeof (payload));
+    fail_unless (gst_buffer_memcmp (body, 0, payload, sizeof (payload)) == 0);
+    gst_buffer_unref (body);
+    fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+  }
+
+  fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_receive (rtsp_input_conn, msg,
+          NULL) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_parse_response (msg, &code, NULL,
+          NULL) == GST_RTSP_OK);
+  fail_unless (code == GST_RTSP_STS_OK);
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+
+  fail_unless (gst_rtsp_connection_close (rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_close (rtsp_output_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_output_conn) == GST_RTSP_OK);
+
+  g_object_unref (input_conn);
+  g_object_unref (output_conn);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtspconnection_suite (void)
 {
@@ -944,6 +1028,7 @@ rtspconnection_suite (void)
   tcase_add_test (tc_chain, test_rtspconnection_backlog);
   tcase_add_test (tc_chain, test_rtspconnection_ip);
   tcase_add_test (tc_chain, test_rtspconnection_send_receive_content_length);
+  tcase_add_test (tc_chain, test_rtspconnection_read_buffer);
 
   return s;
 }
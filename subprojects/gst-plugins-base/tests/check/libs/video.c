@@ -2794,6 +2794,149 @@ GST_START_TEST (test_video_convert)
 
 GST_END_TEST;
 
+GST_START_TEST (test_video_convert_I420_NV12)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoConverter *convert;
+  GstMapInfo map;
+  gint i, j;
+
+  /* odd width to also cover the tail of the vectorized line functions */
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_I420, 99,
+          20));
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < (gint) map.size; i++)
+    map.data[i] = i * 7;
+  gst_buffer_unmap (inbuffer, &map);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_NV12, 99,
+          20));
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 3, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  for (i = 0; i < 20; i++) {
+    const guint8 *sy = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (&inframe, 0) +
+        GST_VIDEO_FRAME_COMP_STRIDE (&inframe, 0) * i;
+    const guint8 *dy = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&outframe, 0) +
+        GST_VIDEO_FRAME_PLANE_STRIDE (&outframe, 0) * i;
+
+    fail_unless (memcmp (sy, dy, 99) == 0);
+  }
+
+  for (i = 0; i < 10; i++) {
+    const guint8 *su = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (&inframe, 1) +
+        GST_VIDEO_FRAME_COMP_STRIDE (&inframe, 1) * i;
+    const guint8 *sv = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (&inframe, 2) +
+        GST_VIDEO_FRAME_COMP_STRIDE (&inframe, 2) * i;
+    const guint8 *duv = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&outframe, 1) +
+        GST_VIDEO_FRAME_PLANE_STRIDE (&outframe, 1) * i;
+
+    for (j = 0; j < 50; j++) {
+      fail_unless_equals_int (duv[2 * j], su[j]);
+      fail_unless_equals_int (duv[2 * j + 1], sv[j]);
+    }
+  }
+
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_convert_v210_I420)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoConverter *convert;
+  GstMapInfo map;
+  gint i, j;
+
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_v210, 100,
+          4));
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < (gint) map.size / 4; i++)
+    GST_WRITE_UINT32_LE (map.data + 4 * i, (i * 2654435761u) & 0x3fffffff);
+  gst_buffer_unmap (inbuffer, &map);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_I420, 100,
+          4));
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  for (i = 0; i < 4; i++) {
+    const guint8 *s = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&inframe, 0) +
+        GST_VIDEO_FRAME_PLANE_STRIDE (&inframe, 0) * i;
+    const guint8 *dy = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (&outframe, 0) +
+        GST_VIDEO_FRAME_COMP_STRIDE (&outframe, 0) * i;
+
+    /* the luma samples are at these component positions in each block */
+    for (j = 0; j < 100; j++) {
+      static const gint pos[6] = { 1, 3, 5, 7, 9, 11 };
+      gint c = (j / 6) * 12 + pos[j % 6];
+      guint32 w = GST_READ_UINT32_LE (s + (c / 3) * 4);
+
+      fail_unless_equals_int (dy[j], ((w >> (10 * (c % 3))) & 0x3ff) >> 2);
+    }
+  }
+
+  for (i = 0; i < 2; i++) {
+    const guint8 *s1 = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&inframe, 0) +
+        GST_VIDEO_FRAME_PLANE_STRIDE (&inframe, 0) * (2 * i);
+    const guint8 *s2 = s1 + GST_VIDEO_FRAME_PLANE_STRIDE (&inframe, 0);
+    const guint8 *du = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (&outframe, 1) +
+        GST_VIDEO_FRAME_COMP_STRIDE (&outframe, 1) * i;
+    const guint8 *dv = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (&outframe, 2) +
+        GST_VIDEO_FRAME_COMP_STRIDE (&outframe, 2) * i;
+
+    /* the chroma samples are at these component positions in each block,
+     * each averaged over the two lines */
+    for (j = 0; j < 50; j++) {
+      static const gint upos[3] = { 0, 4, 8 };
+      static const gint vpos[3] = { 2, 6, 10 };
+      gint cu = (j / 3) * 12 + upos[j % 3];
+      gint cv = (j / 3) * 12 + vpos[j % 3];
+      guint32 u1 = GST_READ_UINT32_LE (s1 + (cu / 3) * 4);
+      guint32 u2 = GST_READ_UINT32_LE (s2 + (cu / 3) * 4);
+      guint32 v1 = GST_READ_UINT32_LE (s1 + (cv / 3) * 4);
+      guint32 v2 = GST_READ_UINT32_LE (s2 + (cv / 3) * 4);
+
+      u1 = ((u1 >> (10 * (cu % 3))) & 0x3ff) >> 2;
+      u2 = ((u2 >> (10 * (cu % 3))) & 0x3ff) >> 2;
+      v1 = ((v1 >> (10 * (cv % 3))) & 0x3ff) >> 2;
+      v2 = ((v2 >> (10 * (cv % 3))) & 0x3ff) >> 2;
+
+      fail_unless_equals_int (du[j], (u1 + u2) / 2);
+      fail_unless_equals_int (dv[j], (v1 + v2) / 2);
+    }
+  }
+
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_convert_multithreading)
 {
   GstVideoInfo ininfo, outinfo;
@@ -3925,6 +4068,64 @@ GST_START_TEST (test_video_meta_align)
   gst_buffer_unref (buf);
 }
 
+GST_END_TEST;
+static void
+check_frame_map_planes (GstBuffer * buf, GstVideoInfo * info)
+{
+  GstVideoFrame frame;
+  guint i;
+
+  fail_unless (gst_video_frame_map (&frame, info, buf, GST_MAP_READ));
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (info); i++) {
+    fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&frame, i) != NULL);
+    fail_unless_equals_int (GST_VIDEO_FRAME_PLANE_STRIDE (&frame, i),
+        GST_VIDEO_INFO_PLANE_STRIDE (info, i));
+  }
+  gst_video_frame_unmap (&frame);
+
+  /* this fails if a mapping of the previous map was leaked */
+  fail_unless (gst_video_frame_map (&frame, info, buf, GST_MAP_WRITE));
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (info); i++)
+    memset (GST_VIDEO_FRAME_PLANE_DATA (&frame, i), i + 1,
+        GST_VIDEO_FRAME_PLANE_STRIDE (&frame, i));
+  gst_video_frame_unmap (&frame);
+
+  fail_unless (gst_video_frame_map (&frame, info, buf, GST_MAP_READ));
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (info); i++)
+    fail_unless_equals_int (((guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame,
+                i))[0], i + 1);
+  gst_video_frame_unmap (&frame);
+}
+
+GST_START_TEST (test_video_frame_map_meta)
+{
+  GstVideoInfo info;
+  GstBuffer *buf;
+  guint i;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 64, 48);
+
+  /* all planes in one memory */
+  buf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&info), NULL);
+  gst_buffer_add_video_meta_full (buf, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_I420, 64, 48, 3, info.offset, info.stride);
+  check_frame_map_planes (buf, &info);
+  gst_buffer_unref (buf);
+
+  /* one memory per plane */
+  buf = gst_buffer_new ();
+  for (i = 0; i < 3; i++) {
+    gsize end = i < 2 ? info.offset[i + 1] : GST_VIDEO_INFO_SIZE (&info);
+
+    gst_buffer_append_memory (buf, gst_allocator_alloc (NULL,
+            end - info.offset[i], NULL));
+  }
+  gst_buffer_add_video_meta_full (buf, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_I420, 64, 48, 3, info.offset, info.stride);
+  check_frame_map_planes (buf, &info);
+  gst_buffer_unref (buf);
+}
+
 GST_END_TEST;
 
 GST_START_TEST (test_video_flags)
@@ -4043,6 +4244,90 @@ GST_START_TEST (test_video_extrapolate_stride)
 GST_END_TEST;
 
 
+static GstStructure *
+get_video_pool_config (GstBufferPool * pool, gint width, gint height)
+{
+  GstStructure *config;
+  GstVideoInfo info;
+  GstCaps *caps;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, width, height);
+  caps = gst_video_info_to_caps (&info);
+
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, info.size, 2, 0);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_KEEP_WARM);
+  gst_caps_unref (caps);
+
+  return config;
+}
+
+GST_START_TEST (test_video_pool_keep_warm)
+{
+  GstBufferPool *pool;
+  GstBuffer *buf1, *buf2, *buf;
+  GstMemory *mem1, *mem2;
+
+  pool = gst_video_buffer_pool_new ();
+  fail_unless (gst_buffer_pool_set_config (pool,
+          get_video_pool_config (pool, 640, 480)));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf1,
+          NULL) == GST_FLOW_OK);
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf2,
+          NULL) == GST_FLOW_OK);
+  mem1 = gst_buffer_peek_memory (buf1, 0);
+  mem2 = gst_buffer_peek_memory (buf2, 0);
+  gst_buffer_unref (buf1);
+  gst_buffer_unref (buf2);
+
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+
+  /* the memory of the bigger frames is reused for the smaller ones */
+  fail_unless (gst_buffer_pool_set_config (pool,
+          get_video_pool_config (pool, 320, 240)));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf,
+          NULL) == GST_FLOW_OK);
+  fail_unless (gst_buffer_peek_memory (buf, 0) == mem1 ||
+      gst_buffer_peek_memory (buf, 0) == mem2);
+  fail_unless_equals_int (gst_buffer_get_size (buf), 320 * 240 * 3 / 2);
+  gst_buffer_unref (buf);
+
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_preferred_size_query)
+{
+  GstQuery *query;
+  gint width = 0, height = 0;
+
+  query = gst_video_query_new_preferred_size ();
+  fail_unless (gst_video_query_is_preferred_size (query));
+  fail_if (gst_video_query_parse_preferred_size (query, &width, &height));
+
+  gst_video_query_set_preferred_size (query, 160, 120);
+  fail_unless (gst_video_query_parse_preferred_size (query, &width, &height));
+  fail_unless_equals_int (width, 160);
+  fail_unless_equals_int (height, 120);
+  gst_query_unref (query);
+
+  query = gst_query_new_custom (GST_QUERY_CUSTOM,
+      gst_structure_new_empty ("foo"));
+  fail_if (gst_video_query_is_preferred_size (query));
+  gst_query_unref (query);
+}
+
+GST_END_TEST;
+
 static Suite *
 video_suite (void)
 {
@@ -4083,6 +4368,8 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_color_convert_other);
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
+  tcase_add_test (tc_chain, test_video_convert_I420_NV12);
+  tcase_add_test (tc_chain, test_video_convert_v210_I420);
   tcase_add_test (tc_chain, test_video_convert_multithreading);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
@@ -4095,9 +4382,12 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_format_info_plane_to_components);
   tcase_add_test (tc_chain, test_video_info_align);
   tcase_add_test (tc_chain, test_video_meta_align);
+  tcase_add_test (tc_chain, test_video_frame_map_meta);
   tcase_add_test (tc_chain, test_video_flags);
   tcase_add_test (tc_chain, test_video_make_raw_caps);
   tcase_add_test (tc_chain, test_video_extrapolate_stride);
+  tcase_add_test (tc_chain, test_video_pool_keep_warm);
+  tcase_add_test (tc_chain, test_video_preferred_size_query);
 
   return s;
 }
@@ -83,6 +83,7 @@ struct _GstVideoDecoderTester
   guint64 last_kf_num;
   gboolean set_output_state;
   gboolean subframe_mode;
+  gboolean parallel;
 };
 
 struct _GstVideoDecoderTesterClass
@@ -149,6 +150,16 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
   gboolean last_subframe = GST_BUFFER_FLAG_IS_SET (frame->input_buffer,
       GST_VIDEO_BUFFER_FLAG_MARKER);
 
+  if (dectester->parallel) {
+    /* the output is gray8, filled in from decode_parallel() */
+    size = TEST_VIDEO_WIDTH * TEST_VIDEO_HEIGHT;
+    frame->output_buffer = gst_buffer_new_wrapped (g_malloc0 (size), size);
+    frame->pts = GST_BUFFER_PTS (frame->input_buffer);
+    frame->duration = GST_BUFFER_DURATION (frame->input_buffer);
+
+    return gst_video_decoder_queue_parallel_frame (dec, frame);
+  }
+
   if (gst_video_decoder_get_subframe_mode (dec) && !last_subframe) {
     if (!GST_CLOCK_TIME_IS_VALID (frame->pts))
       return gst_video_decoder_drop_subframe (dec, frame);
@@ -199,6 +210,25 @@ done:
   return GST_FLOW_OK;
 }
 
+static GstFlowReturn
+gst_video_decoder_tester_decode_parallel (GstVideoDecoder * dec,
+    GstVideoCodecFrame * frame)
+{
+  GstMapInfo in_map, out_map;
+
+  gst_buffer_map (frame->input_buffer, &in_map, GST_MAP_READ);
+  gst_buffer_map (frame->output_buffer, &out_map, GST_MAP_WRITE);
+
+  /* take a little while so that frames finish out of order */
+  g_usleep (g_random_int_range (0, 1000));
+  memcpy (out_map.data, in_map.data, sizeof (guint64));
+
+  gst_buffer_unmap (frame->output_buffer, &out_map);
+  gst_buffer_unmap (frame->input_buffer, &in_map);
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_video_decoder_tester_parse (GstVideoDecoder * decoder,
     GstVideoCodecFrame * frame, GstAdapter * adapter, gboolean at_eos)
@@ -236,6 +266,8 @@ gst_video_decoder_tester_class_init (GstVideoDecoderTesterClass * klass)
   videodecoder_class->stop = gst_video_decoder_tester_stop;
   videodecoder_class->flush = gst_video_decoder_tester_flush;
   videodecoder_class->handle_frame = gst_video_decoder_tester_handle_frame;
+  videodecoder_class->decode_parallel =
+      gst_video_decoder_tester_decode_parallel;
   videodecoder_class->set_format = gst_video_decoder_tester_set_format;
   videodecoder_class->parse = gst_video_decoder_tester_parse;
 }
@@ -383,6 +415,62 @@ GST_START_TEST (videodecoder_playback)
 GST_END_TEST;
 
 
+GST_START_TEST (videodecoder_playback_parallel)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+
+  ((GstVideoDecoderTester *) dec)->parallel = TRUE;
+  gst_video_decoder_set_parallel_threads (GST_VIDEO_DECODER (dec), 4);
+  fail_unless_equals_int (gst_video_decoder_get_parallel_threads
+      (GST_VIDEO_DECODER (dec)), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* all frames must be output in the order in which they were queued */
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer),
+        gst_util_uint64_scale_round (i, GST_SECOND * TEST_VIDEO_FPS_D,
+            TEST_VIDEO_FPS_N));
+    gst_buffer_unmap (buffer, &map);
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
 GST_START_TEST (videodecoder_playback_with_events)
 {
   GstSegment segment;
@@ -776,7 +864,7 @@ GST_START_TEST (videodecoder_first_data_is_gap)
 GST_END_TEST;
 
 static void
-videodecoder_backwards_playback (gboolean subframe)
+videodecoder_backwards_playback (gboolean subframe, gboolean parallel)
 {
   GstSegment segment;
   GstBuffer *buffer;
@@ -795,6 +883,11 @@ videodecoder_backwards_playback (gboolean subframe)
     gst_video_decoder_set_subframe_mode (GST_VIDEO_DECODER (dec), TRUE);
   }
 
+  if (parallel) {
+    ((GstVideoDecoderTester *) dec)->parallel = TRUE;
+    gst_video_decoder_set_parallel_threads (GST_VIDEO_DECODER (dec), 4);
+  }
+
   gst_pad_set_active (mysrcpad, TRUE);
   gst_element_set_state (dec, GST_STATE_PLAYING);
   gst_pad_set_active (mysinkpad, TRUE);
@@ -869,14 +962,21 @@ videodecoder_backwards_playback (gboolean subframe)
 
 GST_START_TEST (videodecoder_backwards_playback_normal)
 {
-  videodecoder_backwards_playback (FALSE);
+  videodecoder_backwards_playback (FALSE, FALSE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (videodecoder_backwards_playback_parallel)
+{
+  videodecoder_backwards_playback (FALSE, TRUE);
 }
 
 GST_END_TEST;
 
 GST_START_TEST (videodecoder_backwards_playback_subframes)
 {
-  videodecoder_backwards_playback (TRUE);
+  videodecoder_backwards_playback (TRUE, FALSE);
 }
 
 GST_END_TEST;
@@ -1570,12 +1670,14 @@ gst_videodecoder_suite (void)
   tcase_add_test (tc, videodecoder_query_caps_with_custom_getcaps);
 
   tcase_add_test (tc, videodecoder_playback);
+  tcase_add_test (tc, videodecoder_playback_parallel);
   tcase_add_test (tc, videodecoder_playback_with_events);
   tcase_add_test (tc, videodecoder_playback_first_frames_not_decoded);
   tcase_add_test (tc, videodecoder_buffer_after_segment);
   tcase_add_test (tc, videodecoder_first_data_is_gap);
 
   tcase_add_test (tc, videodecoder_backwards_playback_normal);
+  tcase_add_test (tc, videodecoder_backwards_playback_parallel);
   tcase_add_test (tc, videodecoder_backwards_playback_subframes);
   tcase_add_test (tc, videodecoder_backwards_buffer_after_segment);
   tcase_add_test (tc, videodecoder_flush_events);
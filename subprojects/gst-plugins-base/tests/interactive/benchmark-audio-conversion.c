@@ -0,0 +1,178 @@
+/* GStreamer audio format conversion benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#define DEFAULT_CHANNELS 2
+#define DEFAULT_FRAMES 4096
+
+#define DEFAULT_DURATION 0.5
+
+/* the formats that are benchmarked when none are given */
+static const GstAudioFormat default_formats[] = {
+  GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S24, GST_AUDIO_FORMAT_S24_32,
+  GST_AUDIO_FORMAT_S32, GST_AUDIO_FORMAT_F32, GST_AUDIO_FORMAT_F64,
+};
+
+static void
+do_benchmark_conversion (const GstAudioFormatInfo * infinfo,
+    const GstAudioFormatInfo * outfinfo, gint channels, gint frames,
+    GstAudioDitherMethod dither, GstAudioNoiseShapingMethod ns,
+    gdouble max_duration, GTimer * timer)
+{
+  GstAudioInfo ininfo, outinfo;
+  GstAudioConverter *convert;
+  GstStructure *config;
+  gpointer in, out;
+  gdouble elapsed, frames_sec;
+  gint count;
+
+  gst_audio_info_set_format (&ininfo, infinfo->format, 48000, channels, NULL);
+  gst_audio_info_set_format (&outinfo, outfinfo->format, 48000, channels,
+      NULL);
+
+  config = gst_structure_new ("config",
+      GST_AUDIO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_AUDIO_DITHER_METHOD,
+      dither, GST_AUDIO_CONVERTER_OPT_NOISE_SHAPING_METHOD,
+      GST_TYPE_AUDIO_NOISE_SHAPING_METHOD, ns, NULL);
+  convert = gst_audio_converter_new (0, &ininfo, &outinfo, config);
+  if (convert == NULL) {
+    gst_println ("%s -> %s not supported", infinfo->name, outfinfo->name);
+    return;
+  }
+
+  in = g_malloc (frames * GST_AUDIO_INFO_BPF (&ininfo));
+  out = g_malloc (frames * GST_AUDIO_INFO_BPF (&outinfo));
+  gst_audio_format_info_fill_silence (infinfo, in,
+      frames * GST_AUDIO_INFO_BPF (&ininfo));
+
+  /* warmup */
+  gst_audio_converter_samples (convert, 0, &in, frames, &out, frames);
+
+  count = 0;
+  g_timer_start (timer);
+  while (TRUE) {
+    gst_audio_converter_samples (convert, 0, &in, frames, &out, frames);
+
+    count++;
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= max_duration)
+      break;
+  }
+
+  frames_sec = count * (gdouble) frames / elapsed;
+
+  gst_println ("%8.2f Mframes/sec %s -> %s, %d channels, %d/%.5f",
+      frames_sec / 1e6, infinfo->name, outfinfo->name, channels, count,
+      elapsed);
+
+  gst_audio_converter_free (convert);
+  g_free (in);
+  g_free (out);
+}
+
+static void
+do_benchmark_conversions (const gchar * in_format, const gchar * out_format,
+    gint channels, gint frames, GstAudioDitherMethod dither,
+    GstAudioNoiseShapingMethod ns, gdouble max_duration)
+{
+  GstAudioFormat in_formats[G_N_ELEMENTS (default_formats)];
+  GstAudioFormat out_formats[G_N_ELEMENTS (default_formats)];
+  gint i, j, n_in = 0, n_out = 0;
+  GTimer *timer;
+
+  if (in_format)
+    in_formats[n_in++] = gst_audio_format_from_string (in_format);
+  if (out_format)
+    out_formats[n_out++] = gst_audio_format_from_string (out_format);
+
+  for (i = 0; i < G_N_ELEMENTS (default_formats); i++) {
+    if (!in_format)
+      in_formats[n_in++] = default_formats[i];
+    if (!out_format)
+      out_formats[n_out++] = default_formats[i];
+  }
+
+  if ((in_format && in_formats[0] == GST_AUDIO_FORMAT_UNKNOWN) ||
+      (out_format && out_formats[0] == GST_AUDIO_FORMAT_UNKNOWN)) {
+    gst_printerrln ("unknown format");
+    return;
+  }
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < n_in; i++) {
+    for (j = 0; j < n_out; j++) {
+      do_benchmark_conversion (gst_audio_format_get_info (in_formats[i]),
+          gst_audio_format_get_info (out_formats[j]), channels, frames,
+          dither, ns, max_duration, timer);
+    }
+  }
+
+  g_timer_destroy (timer);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gint channels = DEFAULT_CHANNELS;
+  gint frames = DEFAULT_FRAMES;
+  gint dither = GST_AUDIO_DITHER_TPDF;
+  gint ns = GST_AUDIO_NOISE_SHAPING_NONE;
+  gdouble max_dur = DEFAULT_DURATION;
+  gchar *from_fmt = NULL;
+  gchar *to_fmt = NULL;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"channels", 'c', 0, G_OPTION_ARG_INT, &channels, "Channels", NULL},
+    {"frames", 'n', 0, G_OPTION_ARG_INT, &frames, "Frames per conversion",
+        NULL},
+    {"from-format", 'f', 0, G_OPTION_ARG_STRING, &from_fmt, "From Format",
+        NULL},
+    {"to-format", 't', 0, G_OPTION_ARG_STRING, &to_fmt, "To Format", NULL},
+    {"dither", 0, 0, G_OPTION_ARG_INT, &dither,
+        "Dither method (0 = none, 1 = rpdf, 2 = tpdf, 3 = tpdf-hf)", NULL},
+    {"noise-shaping", 0, 0, G_OPTION_ARG_INT, &ns,
+        "Noise shaping method (0 = none, 1 = error-feedback, 2 = simple, "
+          "3 = medium, 4 = high)", NULL},
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
+        "Benchmark duration for each run (in seconds)", NULL},
+    {NULL}
+  };
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  do_benchmark_conversions (from_fmt, to_fmt, channels, frames, dither, ns,
+      max_dur);
+  return 0;
+}
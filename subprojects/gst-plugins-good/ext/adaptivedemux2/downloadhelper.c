@@ -27,6 +27,11 @@ GST_DEBUG_CATEGORY_EXTERN (adaptivedemux2_debug);
 
 #define CHUNK_BUFFER_SIZE 32768
 
+/* Allow the streams to keep several fragment requests in flight towards the
+ * same server when prefetching. With libsoup 3 these are multiplexed over a
+ * single connection when the server speaks HTTP/2 */
+#define MAX_CONNS_PER_HOST 8
+
 typedef struct DownloadHelperTransfer DownloadHelperTransfer;
 
 struct DownloadHelper
@@ -611,7 +616,8 @@ downloadhelper_new (GstAdaptiveDemuxClock * clock)
 
   /* Set 10 second timeout. Any longer is likely
    * an attempt to reuse an already closed connection */
-  dh->session = _soup_session_new_with_options ("timeout", 10, NULL);
+  dh->session = _soup_session_new_with_options ("timeout", 10,
+      "max-conns-per-host", MAX_CONNS_PER_HOST, NULL);
 
   return dh;
 }
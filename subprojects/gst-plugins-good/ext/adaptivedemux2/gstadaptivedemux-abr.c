@@ -0,0 +1,122 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstadaptivedemux.h"
+#include "gstadaptivedemux-private.h"
+
+GST_DEBUG_CATEGORY_EXTERN (adaptivedemux2_debug);
+#define GST_CAT_DEFAULT adaptivedemux2_debug
+
+/* Size of the buffer-based rate map when no high watermark is configured */
+#define DEFAULT_BUFFER_BASED_CUSHION (10 * GST_SECOND)
+
+/* Throughput: a fraction of the measured download rate */
+static guint64
+abr_throughput_get_target_bitrate (GstAdaptiveDemux2Stream * stream,
+    const GstAdaptiveDemuxAbrStats * stats)
+{
+  guint64 target;
+
+  target = MIN (stats->download_rate, G_MAXUINT) *
+      stats->bandwidth_target_ratio;
+
+  GST_DEBUG_OBJECT (stream, "Bitrate after target ratio limit (%0.2f): %"
+      G_GUINT64_FORMAT, stats->bandwidth_target_ratio, target);
+
+  return target;
+}
+
+/* Buffer-based: below the reservoir (the low watermark, or at least one
+ * fragment) the lowest bitrate is used. Above it, the target grows linearly
+ * with the buffer level up to the average download rate, reached at the high
+ * watermark. The buffer absorbs throughput variations, so the rate is not
+ * scaled by the bandwidth target ratio */
+static guint64
+abr_buffer_based_get_target_bitrate (GstAdaptiveDemux2Stream * stream,
+    const GstAdaptiveDemuxAbrStats * stats)
+{
+  GstClockTime reservoir, cushion_end;
+  guint64 target;
+
+  /* Nothing is buffered yet, start from the throughput estimate */
+  if (!GST_CLOCK_TIME_IS_VALID (stats->level_time))
+    return abr_throughput_get_target_bitrate (stream, stats);
+
+  reservoir = stats->low_watermark_time;
+  if (GST_CLOCK_TIME_IS_VALID (stats->fragment_duration))
+    reservoir = MAX (reservoir, stats->fragment_duration);
+
+  cushion_end = stats->high_watermark_time;
+  if (cushion_end <= reservoir)
+    cushion_end = reservoir + DEFAULT_BUFFER_BASED_CUSHION;
+
+  if (stats->level_time <= reservoir)
+    target = 0;
+  else if (stats->level_time >= cushion_end)
+    target = stats->average_bitrate;
+  else
+    target = gst_util_uint64_scale (stats->average_bitrate,
+        stats->level_time - reservoir, cushion_end - reservoir);
+
+  GST_DEBUG_OBJECT (stream, "Buffer level %" GST_TIME_FORMAT " (reservoir %"
+      GST_TIME_FORMAT ", cushion end %" GST_TIME_FORMAT "), target bitrate %"
+      G_GUINT64_FORMAT, GST_TIME_ARGS (stats->level_time),
+      GST_TIME_ARGS (reservoir), GST_TIME_ARGS (cushion_end), target);
+
+  return target;
+}
+
+static const GstAdaptiveDemuxAbrController abr_controllers[] = {
+  [GST_ADAPTIVE_DEMUX_ABR_THROUGHPUT] = {
+        "throughput", abr_throughput_get_target_bitrate},
+  [GST_ADAPTIVE_DEMUX_ABR_BUFFER_BASED] = {
+        "buffer-based", abr_buffer_based_get_target_bitrate},
+};
+
+const GstAdaptiveDemuxAbrController *
+gst_adaptive_demux_abr_get_controller (GstAdaptiveDemuxAbrAlgorithm algorithm)
+{
+  g_return_val_if_fail (algorithm < G_N_ELEMENTS (abr_controllers), NULL);
+
+  return &abr_controllers[algorithm];
+}
+
+GType
+gst_adaptive_demux_abr_algorithm_get_type (void)
+{
+  static gsize abr_algorithm_type = 0;
+  static const GEnumValue algorithms[] = {
+    {GST_ADAPTIVE_DEMUX_ABR_THROUGHPUT,
+        "Select the bitrate from the measured download rate", "throughput"},
+    {GST_ADAPTIVE_DEMUX_ABR_BUFFER_BASED,
+        "Select the bitrate from the buffered level", "buffer-based"},
+    {0, NULL, NULL},
+  };
+
+  if (g_once_init_enter (&abr_algorithm_type)) {
+    GType tmp = g_enum_register_static ("GstAdaptiveDemux2AbrAlgorithm",
+        algorithms);
+    g_once_init_leave (&abr_algorithm_type, tmp);
+  }
+
+  return (GType) abr_algorithm_type;
+}
@@ -235,4 +235,37 @@ GstFlowReturn            gst_adaptive_demux_period_combine_stream_flows (GstAdap
 
 gboolean                 gst_adaptive_demux_period_has_pending_tracks (GstAdaptiveDemuxPeriod * period);
 
+/* Bitrate adaptation */
+typedef struct _GstAdaptiveDemuxAbrStats GstAdaptiveDemuxAbrStats;
+typedef struct _GstAdaptiveDemuxAbrController GstAdaptiveDemuxAbrController;
+
+/* Per-stream input of the bitrate adaptation, gathered after each
+ * fragment download */
+struct _GstAdaptiveDemuxAbrStats
+{
+  guint64 last_bitrate;          /* Download rate of the last fragment */
+  guint64 average_bitrate;       /* Average over NUM_LOOKBACK_FRAGMENTS */
+  guint64 download_rate;         /* Conservative estimate of both */
+  gfloat bandwidth_target_ratio;
+
+  GstClockTime level_time;       /* Lowest level of the stream tracks, or
+                                  * GST_CLOCK_TIME_NONE if there are none */
+  GstClockTime fragment_duration;
+  GstClockTime low_watermark_time;
+  GstClockTime high_watermark_time;
+};
+
+struct _GstAdaptiveDemuxAbrController
+{
+  const gchar *name;
+
+  /* Returns the bitrate the stream should use for the next fragments, before
+   * the min-bitrate/max-bitrate limits are applied */
+  guint64 (*get_target_bitrate) (GstAdaptiveDemux2Stream * stream,
+                                 const GstAdaptiveDemuxAbrStats * stats);
+};
+
+const GstAdaptiveDemuxAbrController *
+                         gst_adaptive_demux_abr_get_controller (GstAdaptiveDemuxAbrAlgorithm algorithm);
+
 #endif
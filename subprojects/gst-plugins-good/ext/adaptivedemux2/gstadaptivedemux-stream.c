@@ -53,6 +53,20 @@ gst_adaptive_demux2_stream_class_init (GstAdaptiveDemux2StreamClass * klass)
 
 static GType tsdemux_type = 0;
 
+typedef struct _GstAdaptiveDemux2StreamPrefetch GstAdaptiveDemux2StreamPrefetch;
+
+/* An upcoming fragment downloaded ahead of time */
+struct _GstAdaptiveDemux2StreamPrefetch
+{
+  /* The location as provided by the sub-class, the download request
+   * might adjust its range */
+  gchar *uri;
+  gint64 range_start;
+  gint64 range_end;
+
+  DownloadRequest *request;
+};
+
 static void
 gst_adaptive_demux2_stream_init (GstAdaptiveDemux2Stream * stream)
 {
@@ -63,6 +77,9 @@ gst_adaptive_demux2_stream_init (GstAdaptiveDemux2Stream * stream)
   stream->fragment_bitrates =
       g_malloc0 (sizeof (guint64) * NUM_LOOKBACK_FRAGMENTS);
 
+  stream->busy_start = GST_CLOCK_TIME_NONE;
+  stream->busy_end = GST_CLOCK_TIME_NONE;
+
   gst_segment_init (&stream->parse_segment, GST_FORMAT_TIME);
 }
 
@@ -82,6 +99,18 @@ gst_adaptive_demux2_stream_finalize (GObject * object)
   if (stream->download_request)
     download_request_unref (stream->download_request);
 
+  while (stream->prefetches) {
+    GstAdaptiveDemux2StreamPrefetch *prefetch = stream->prefetches->data;
+
+    download_request_set_callbacks (prefetch->request, NULL, NULL, NULL, NULL,
+        NULL);
+    download_request_unref (prefetch->request);
+    g_free (prefetch->uri);
+    g_free (prefetch);
+    stream->prefetches =
+        g_list_delete_link (stream->prefetches, stream->prefetches);
+  }
+
   stream->cancelled = TRUE;
   g_clear_error (&stream->last_error);
 
@@ -1191,6 +1220,29 @@ update_stream_bitrate (GstAdaptiveDemux2Stream * stream,
   if (last_download_duration < 2 * stream->last_download_time)
     last_download_duration = stream->last_download_time;
 
+  /* When prefetching, several downloads share the link and each of them
+   * only sees part of the bandwidth. Measure the data received over the
+   * whole window during which the downloads overlapped instead */
+  if (GST_CLOCK_TIME_IS_VALID (stream->busy_end)
+      && GST_CLOCK_TIME_IS_VALID (request->download_request_time)
+      && request->download_request_time < stream->busy_end
+      && stream->busy_downloads <= stream->demux->max_prefetch_fragments) {
+    stream->busy_start =
+        MIN (stream->busy_start, request->download_request_time);
+    stream->busy_end = MAX (stream->busy_end, request->download_end_time);
+    stream->busy_bytes += fragment_bytes_downloaded;
+    stream->busy_downloads++;
+
+    fragment_bytes_downloaded = stream->busy_bytes;
+    last_download_duration =
+        GST_CLOCK_DIFF (stream->busy_start, stream->busy_end);
+  } else {
+    stream->busy_start = request->download_request_time;
+    stream->busy_end = request->download_end_time;
+    stream->busy_bytes = fragment_bytes_downloaded;
+    stream->busy_downloads = 1;
+  }
+
   if (last_download_duration > 0) {
     stream->last_bitrate =
         gst_util_uint64_scale (fragment_bytes_downloaded,
@@ -1263,9 +1315,12 @@ on_download_complete (DownloadRequest * request, DownloadRequestState state,
       "Stream %p %s download for %s is complete with state %d",
       stream, uritype (stream), request->uri, request->state);
 
-  /* Update bitrate for fragment downloads */
-  if (!stream->downloading_header && !stream->downloading_index)
+  /* Update bitrate for fragment downloads. Prefetches that completed before
+   * being used were already accounted for */
+  if (!stream->downloading_header && !stream->downloading_index
+      && !stream->download_from_prefetch)
     update_stream_bitrate (stream, request);
+  stream->download_from_prefetch = FALSE;
 
   buffer = download_request_take_buffer (request);
   if (buffer)
@@ -1326,6 +1381,263 @@ gst_adaptive_demux2_stream_begin_download_uri (GstAdaptiveDemux * demux,
   return GST_FLOW_OK;
 }
 
+static void
+gst_adaptive_demux2_stream_prefetch_free (GstAdaptiveDemux2Stream * stream,
+    GstAdaptiveDemux2StreamPrefetch * prefetch)
+{
+  DownloadRequest *request = prefetch->request;
+
+  /* Make sure no callback fires for a prefetch that is gone */
+  download_request_set_callbacks (request, NULL, NULL, NULL, NULL, NULL);
+  downloadhelper_cancel_request (stream->demux->download_helper, request);
+  download_request_unref (request);
+
+  g_free (prefetch->uri);
+  g_free (prefetch);
+}
+
+static void
+gst_adaptive_demux2_stream_clear_prefetches (GstAdaptiveDemux2Stream * stream)
+{
+  while (stream->prefetches) {
+    gst_adaptive_demux2_stream_prefetch_free (stream,
+        stream->prefetches->data);
+    stream->prefetches =
+        g_list_delete_link (stream->prefetches, stream->prefetches);
+  }
+}
+
+static guint64
+gst_adaptive_demux2_stream_get_prefetched_bytes (GstAdaptiveDemux2Stream *
+    stream)
+{
+  guint64 size = 0;
+  GList *iter;
+
+  for (iter = stream->prefetches; iter; iter = iter->next) {
+    GstAdaptiveDemux2StreamPrefetch *prefetch = iter->data;
+
+    download_request_lock (prefetch->request);
+    size += prefetch->request->content_received;
+    download_request_unlock (prefetch->request);
+  }
+
+  return size;
+}
+
+static void
+on_prefetch_finished (DownloadRequest * request, DownloadRequestState state,
+    GstAdaptiveDemux2Stream * stream)
+{
+  GST_DEBUG_OBJECT (stream,
+      "Prefetch of %s finished with state %d http status %u", request->uri,
+      state, request->status_code);
+
+  /* Account for the bandwidth now, while the download timing is accurate */
+  if (state == DOWNLOAD_REQUEST_STATE_COMPLETE)
+    update_stream_bitrate (stream, request);
+}
+
+/* must be called from the scheduler context
+ *
+ * Tops up the downloads of the fragments following the current one */
+static void
+gst_adaptive_demux2_stream_submit_prefetches (GstAdaptiveDemux2Stream * stream)
+{
+  GstAdaptiveDemux *demux = stream->demux;
+  GstAdaptiveDemuxClass *klass = GST_ADAPTIVE_DEMUX_GET_CLASS (demux);
+  guint max_fragments, distance;
+  guint64 max_size;
+
+  if (klass->stream_get_prefetch_fragment == NULL)
+    return;
+
+  GST_OBJECT_LOCK (demux);
+  max_fragments = demux->max_prefetch_fragments;
+  max_size = demux->max_prefetch_cache_size;
+  GST_OBJECT_UNLOCK (demux);
+
+  for (distance = g_list_length (stream->prefetches) + 1;
+      distance <= max_fragments; distance++) {
+    GstAdaptiveDemux2StreamPrefetch *prefetch;
+    gchar *uri = NULL;
+    gint64 range_start = 0, range_end = -1;
+
+    if (gst_adaptive_demux2_stream_get_prefetched_bytes (stream) >= max_size) {
+      GST_LOG_OBJECT (stream, "Prefetch cache is full");
+      break;
+    }
+
+    if (!klass->stream_get_prefetch_fragment (stream, distance, &uri,
+            &range_start, &range_end))
+      break;
+
+    GST_DEBUG_OBJECT (stream,
+        "Prefetching fragment +%u %s range %" G_GINT64_FORMAT "-%"
+        G_GINT64_FORMAT, distance, uri, range_start, range_end);
+
+    prefetch = g_new0 (GstAdaptiveDemux2StreamPrefetch, 1);
+    prefetch->uri = uri;
+    prefetch->range_start = range_start;
+    prefetch->range_end = range_end;
+    prefetch->request =
+        download_request_new_uri_range (uri, range_start, range_end);
+
+    download_request_set_callbacks (prefetch->request,
+        (DownloadRequestEventCallback) on_prefetch_finished,
+        (DownloadRequestEventCallback) on_prefetch_finished,
+        NULL, NULL, stream);
+
+    if (!downloadhelper_submit_request (demux->download_helper,
+            demux->manifest_uri, DOWNLOAD_FLAG_NONE, prefetch->request,
+            NULL)) {
+      gst_adaptive_demux2_stream_prefetch_free (stream, prefetch);
+      break;
+    }
+
+    stream->prefetches = g_list_append (stream->prefetches, prefetch);
+  }
+}
+
+/* Drops the prefetches preceding the given fragment and returns the one
+ * matching it, if any */
+static GstAdaptiveDemux2StreamPrefetch *
+gst_adaptive_demux2_stream_take_prefetch (GstAdaptiveDemux2Stream * stream,
+    const gchar * uri, gint64 range_start, gint64 range_end)
+{
+  GstAdaptiveDemux2StreamPrefetch *prefetch;
+  GList *iter;
+
+  for (iter = stream->prefetches; iter; iter = iter->next) {
+    prefetch = iter->data;
+
+    if (prefetch->range_start == range_start
+        && prefetch->range_end == range_end && g_str_equal (prefetch->uri, uri))
+      break;
+  }
+
+  if (iter == NULL) {
+    /* Seek or bitrate switch, none of the prefetches are of any use */
+    gst_adaptive_demux2_stream_clear_prefetches (stream);
+    return NULL;
+  }
+
+  while (stream->prefetches != iter) {
+    gst_adaptive_demux2_stream_prefetch_free (stream,
+        stream->prefetches->data);
+    stream->prefetches =
+        g_list_delete_link (stream->prefetches, stream->prefetches);
+  }
+  stream->prefetches = g_list_delete_link (stream->prefetches, iter);
+
+  return prefetch;
+}
+
+static gboolean
+gst_adaptive_demux2_stream_complete_prefetch_cb (GstAdaptiveDemux2Stream *
+    stream)
+{
+  DownloadRequest *request = stream->download_request;
+
+  stream->pending_cb_id = 0;
+
+  download_request_lock (request);
+  on_download_complete (request, request->state, stream);
+  download_request_unlock (request);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* must be called from the scheduler context
+ *
+ * Makes the prefetch request the current fragment download. Returns FALSE if
+ * the prefetch failed and the fragment has to be downloaded again */
+static gboolean
+gst_adaptive_demux2_stream_use_prefetch (GstAdaptiveDemux2Stream * stream,
+    GstAdaptiveDemux2StreamPrefetch * prefetch)
+{
+  GstAdaptiveDemux *demux = stream->demux;
+  DownloadRequest *request = prefetch->request;
+  gboolean complete;
+
+  download_request_lock (request);
+  if (request->state == DOWNLOAD_REQUEST_STATE_ERROR ||
+      (!request->in_use && request->state != DOWNLOAD_REQUEST_STATE_COMPLETE)) {
+    download_request_unlock (request);
+    GST_DEBUG_OBJECT (stream, "Prefetch of %s failed, downloading again",
+        prefetch->uri);
+    gst_adaptive_demux2_stream_prefetch_free (stream, prefetch);
+    return FALSE;
+  }
+
+  complete = !request->in_use;
+
+  GST_DEBUG_OBJECT (stream, "Using %s prefetch of %s",
+      complete ? "completed" : "ongoing", prefetch->uri);
+
+  /* From now on, the remaining data and completion are handled like any
+   * other fragment download */
+  download_request_set_callbacks (request,
+      (DownloadRequestEventCallback) on_download_complete,
+      (DownloadRequestEventCallback) on_download_error,
+      (DownloadRequestEventCallback) on_download_cancellation,
+      (DownloadRequestEventCallback) on_download_progress, stream);
+  download_request_unlock (request);
+
+  download_request_unref (stream->download_request);
+  stream->download_request = request;
+  g_free (prefetch->uri);
+  g_free (prefetch);
+
+  stream->download_active = TRUE;
+
+  if (complete) {
+    stream->download_from_prefetch = TRUE;
+
+    g_assert (stream->pending_cb_id == 0);
+    stream->pending_cb_id =
+        gst_adaptive_demux_loop_call (demux->priv->scheduler_task,
+        (GSourceFunc) gst_adaptive_demux2_stream_complete_prefetch_cb,
+        gst_object_ref (stream), (GDestroyNotify) gst_object_unref);
+  }
+
+  return TRUE;
+}
+
+/* must be called from the scheduler context */
+static GstFlowReturn
+gst_adaptive_demux2_stream_begin_download_fragment (GstAdaptiveDemux *
+    demux, GstAdaptiveDemux2Stream * stream, const gchar * uri,
+    gint64 range_start, gint64 range_end)
+{
+  GstAdaptiveDemux2StreamPrefetch *prefetch;
+  GstFlowReturn ret = GST_FLOW_OK;
+  gboolean prefetched = FALSE;
+
+  prefetch =
+      gst_adaptive_demux2_stream_take_prefetch (stream, uri, range_start,
+      range_end);
+
+  if (prefetch != NULL) {
+    if (!gst_adaptive_demux2_stream_create_parser (stream)) {
+      gst_adaptive_demux2_stream_prefetch_free (stream, prefetch);
+      return GST_FLOW_ERROR;
+    }
+    prefetched = gst_adaptive_demux2_stream_use_prefetch (stream, prefetch);
+  }
+
+  if (!prefetched) {
+    ret =
+        gst_adaptive_demux2_stream_begin_download_uri (demux, stream, uri,
+        range_start, range_end);
+  }
+
+  if (ret == GST_FLOW_OK)
+    gst_adaptive_demux2_stream_submit_prefetches (stream);
+
+  return ret;
+}
+
 /* must be called from the scheduler context */
 static GstFlowReturn
 gst_adaptive_demux2_stream_download_fragment (GstAdaptiveDemux2Stream * stream)
@@ -1408,6 +1720,7 @@ gst_adaptive_demux2_stream_download_fragment (GstAdaptiveDemux2Stream * stream)
     GST_DEBUG_OBJECT (stream,
         "Starting chunked download %s %" G_GINT64_FORMAT "-%" G_GINT64_FORMAT,
         url, range_start, chunk_end);
+    gst_adaptive_demux2_stream_clear_prefetches (stream);
     return gst_adaptive_demux2_stream_begin_download_uri (demux, stream, url,
         range_start, chunk_end);
   }
@@ -1415,8 +1728,8 @@ gst_adaptive_demux2_stream_download_fragment (GstAdaptiveDemux2Stream * stream)
   /* regular single chunk download */
   stream->fragment.chunk_size = 0;
 
-  return gst_adaptive_demux2_stream_begin_download_uri (demux, stream, url,
-      stream->fragment.range_start, stream->fragment.range_end);
+  return gst_adaptive_demux2_stream_begin_download_fragment (demux, stream,
+      url, stream->fragment.range_start, stream->fragment.range_end);
 
 no_url_error:
   {
@@ -1928,6 +2241,9 @@ gst_adaptive_demux2_stream_stop (GstAdaptiveDemux2Stream * stream)
   stream->downloading_header = stream->downloading_index = FALSE;
   stream->download_request = download_request_new ();
   stream->download_active = FALSE;
+  stream->download_from_prefetch = FALSE;
+
+  gst_adaptive_demux2_stream_clear_prefetches (stream);
 }
 
 gboolean
@@ -129,6 +129,11 @@ GST_DEBUG_CATEGORY_EXTERN (adaptivedemux2_debug);
 #define DEFAULT_CURRENT_LEVEL_TIME_VIDEO 0
 #define DEFAULT_CURRENT_LEVEL_TIME_AUDIO 0
 
+#define DEFAULT_MAX_PREFETCH_FRAGMENTS 0
+#define DEFAULT_MAX_PREFETCH_CACHE_SIZE (16 * 1024 * 1024)
+
+#define DEFAULT_ABR_ALGORITHM GST_ADAPTIVE_DEMUX_ABR_THROUGHPUT
+
 #define GST_API_GET_LOCK(d) (&(GST_ADAPTIVE_DEMUX_CAST(d)->priv->api_lock))
 #define GST_API_LOCK(d)   g_mutex_lock (GST_API_GET_LOCK (d));
 #define GST_API_UNLOCK(d) g_mutex_unlock (GST_API_GET_LOCK (d));
@@ -149,6 +154,9 @@ enum
   PROP_BUFFERING_LOW_WATERMARK_FRAGMENTS,
   PROP_CURRENT_LEVEL_TIME_VIDEO,
   PROP_CURRENT_LEVEL_TIME_AUDIO,
+  PROP_MAX_PREFETCH_FRAGMENTS,
+  PROP_MAX_PREFETCH_CACHE_SIZE,
+  PROP_ABR_ALGORITHM,
   PROP_LAST
 };
 
@@ -335,6 +343,15 @@ gst_adaptive_demux_set_property (GObject * object, guint prop_id,
     case PROP_BUFFERING_LOW_WATERMARK_FRAGMENTS:
       demux->buffering_low_watermark_fragments = g_value_get_double (value);
       break;
+    case PROP_MAX_PREFETCH_FRAGMENTS:
+      demux->max_prefetch_fragments = g_value_get_uint (value);
+      break;
+    case PROP_MAX_PREFETCH_CACHE_SIZE:
+      demux->max_prefetch_cache_size = g_value_get_uint64 (value);
+      break;
+    case PROP_ABR_ALGORITHM:
+      demux->abr_algorithm = g_value_get_enum (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -391,6 +408,15 @@ gst_adaptive_demux_get_property (GObject * object, guint prop_id,
     case PROP_CURRENT_LEVEL_TIME_AUDIO:
       g_value_set_uint64 (value, demux->current_level_time_audio);
       break;
+    case PROP_MAX_PREFETCH_FRAGMENTS:
+      g_value_set_uint (value, demux->max_prefetch_fragments);
+      break;
+    case PROP_MAX_PREFETCH_CACHE_SIZE:
+      g_value_set_uint64 (value, demux->max_prefetch_cache_size);
+      break;
+    case PROP_ABR_ALGORITHM:
+      g_value_set_enum (value, demux->abr_algorithm);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -519,6 +545,61 @@ gst_adaptive_demux_class_init (GstAdaptiveDemuxClass * klass)
           G_PARAM_READABLE | GST_PARAM_MUTABLE_PLAYING |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAdaptiveDemux2:max-prefetch-fragments:
+   *
+   * Number of upcoming fragments of each stream that are downloaded while
+   * the current one is still in progress. Keeping several requests in
+   * flight hides the round trip time of each request on high latency
+   * links. Only used by sub-classes that can provide upcoming fragment
+   * locations.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_PREFETCH_FRAGMENTS,
+      g_param_spec_uint ("max-prefetch-fragments",
+          "Maximum prefetched fragments",
+          "Number of upcoming fragments to download ahead of time per stream "
+          "(0=disable)", 0, G_MAXUINT, DEFAULT_MAX_PREFETCH_FRAGMENTS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAdaptiveDemux2:max-prefetch-cache-size:
+   *
+   * Maximum amount of prefetched data held in memory for each stream. No
+   * new prefetch is started while the data of pending prefetches exceeds
+   * this size.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_PREFETCH_CACHE_SIZE,
+      g_param_spec_uint64 ("max-prefetch-cache-size",
+          "Maximum prefetch cache size (bytes)",
+          "Maximum amount of prefetched data to keep in memory per stream "
+          "(in bytes)", 0, G_MAXUINT64, DEFAULT_MAX_PREFETCH_CACHE_SIZE,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAdaptiveDemux2:abr-algorithm:
+   *
+   * Algorithm used to select the bitrate of the next fragments when
+   * #GstAdaptiveDemux2:connection-bitrate is not set. The buffer-based
+   * algorithm uses the lowest bitrate while the buffered level is below
+   * #GstAdaptiveDemux2:low-watermark-time, and increases it with the level
+   * up to the measured download rate at
+   * #GstAdaptiveDemux2:high-watermark-time.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_ABR_ALGORITHM,
+      g_param_spec_enum ("abr-algorithm", "ABR algorithm",
+          "Algorithm used to select the bitrate",
+          GST_TYPE_ADAPTIVE_DEMUX_ABR_ALGORITHM, DEFAULT_ABR_ALGORITHM,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class,
       &gst_adaptive_demux_audiosrc_template);
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -539,6 +620,7 @@ gst_adaptive_demux_class_init (GstAdaptiveDemuxClass * klass)
       gst_adaptive_demux_requires_periodical_playlist_update_default;
   klass->stream_update_tracks = gst_adaptive_demux2_stream_update_tracks;
   gst_type_mark_as_plugin_api (GST_TYPE_ADAPTIVE_DEMUX, 0);
+  gst_type_mark_as_plugin_api (GST_TYPE_ADAPTIVE_DEMUX_ABR_ALGORITHM, 0);
 }
 
 static void
@@ -592,7 +674,10 @@ gst_adaptive_demux_init (GstAdaptiveDemux * demux,
   /* Properties */
   demux->bandwidth_target_ratio = DEFAULT_BANDWIDTH_TARGET_RATIO;
   demux->connection_speed = DEFAULT_CONNECTION_BITRATE;
+  demux->abr_algorithm = DEFAULT_ABR_ALGORITHM;
   demux->min_bitrate = DEFAULT_MIN_BITRATE;
+  demux->max_prefetch_fragments = DEFAULT_MAX_PREFETCH_FRAGMENTS;
+  demux->max_prefetch_cache_size = DEFAULT_MAX_PREFETCH_CACHE_SIZE;
   demux->max_bitrate = DEFAULT_MAX_BITRATE;
 
   demux->max_buffering_time = DEFAULT_MAX_BUFFERING_TIME;
@@ -2976,6 +3061,28 @@ _update_average_bitrate (GstAdaptiveDemux * demux,
   return stream->moving_bitrate / stream->moving_index;
 }
 
+/* Lowest buffered level of the stream tracks */
+static GstClockTime
+gst_adaptive_demux2_stream_get_level_time (GstAdaptiveDemux * demux,
+    GstAdaptiveDemux2Stream * stream)
+{
+  GstClockTime level_time = GST_CLOCK_TIME_NONE;
+  GList *iter;
+
+  TRACKS_LOCK (demux);
+  for (iter = stream->tracks; iter; iter = iter->next) {
+    GstAdaptiveDemuxTrack *track = (GstAdaptiveDemuxTrack *) iter->data;
+
+    if (!track->selected)
+      continue;
+    if (!GST_CLOCK_TIME_IS_VALID (level_time) || track->level_time < level_time)
+      level_time = track->level_time;
+  }
+  TRACKS_UNLOCK (demux);
+
+  return level_time;
+}
+
 static guint64
 gst_adaptive_demux2_stream_update_current_bitrate (GstAdaptiveDemux * demux,
     GstAdaptiveDemux2Stream * stream)
@@ -2983,6 +3090,8 @@ gst_adaptive_demux2_stream_update_current_bitrate (GstAdaptiveDemux * demux,
   guint64 average_bitrate;
   guint64 fragment_bitrate;
   guint connection_speed, min_bitrate, max_bitrate, target_download_rate;
+  const GstAdaptiveDemuxAbrController *abr;
+  GstAdaptiveDemuxAbrStats stats;
 
   fragment_bitrate = stream->last_bitrate;
   GST_DEBUG_OBJECT (stream, "Download bitrate is : %" G_GUINT64_FORMAT " bps",
@@ -3013,6 +3122,14 @@ gst_adaptive_demux2_stream_update_current_bitrate (GstAdaptiveDemux * demux,
   connection_speed = demux->connection_speed;
   min_bitrate = demux->min_bitrate;
   max_bitrate = demux->max_bitrate;
+  abr = gst_adaptive_demux_abr_get_controller (demux->abr_algorithm);
+  stats.bandwidth_target_ratio = demux->bandwidth_target_ratio;
+  stats.low_watermark_time = demux->buffering_low_watermark_time;
+  stats.high_watermark_time = demux->buffering_high_watermark_time;
+  if (demux->max_buffering_time > 0)
+    stats.high_watermark_time =
+        MIN (stats.high_watermark_time, demux->max_buffering_time);
+  stats.download_rate = stream->current_download_rate;
   GST_OBJECT_UNLOCK (demux);
 
   if (connection_speed) {
@@ -3021,14 +3138,18 @@ gst_adaptive_demux2_stream_update_current_bitrate (GstAdaptiveDemux * demux,
     return connection_speed;
   }
 
-  /* No explicit connection_speed, so choose the new variant to use as a
-   * fraction of the measured download rate */
+  /* No explicit connection_speed, so let the ABR algorithm choose the new
+   * variant to use from the stream statistics */
+  stats.last_bitrate = fragment_bitrate;
+  stats.average_bitrate = average_bitrate;
+  stats.level_time = gst_adaptive_demux2_stream_get_level_time (demux, stream);
+  stats.fragment_duration = stream->fragment.duration;
+
   target_download_rate =
-      CLAMP (stream->current_download_rate, 0,
-      G_MAXUINT) * demux->bandwidth_target_ratio;
+      MIN (abr->get_target_bitrate (stream, &stats), G_MAXUINT);
 
-  GST_DEBUG_OBJECT (stream, "Bitrate after target ratio limit (%0.2f): %u",
-      demux->bandwidth_target_ratio, target_download_rate);
+  GST_DEBUG_OBJECT (stream, "Bitrate selected by %s algorithm: %u",
+      abr->name, target_download_rate);
 
 #if 0
   /* Debugging code, modulate the bitrate every few fragments */
@@ -107,6 +107,25 @@ typedef GstObjectClass GstAdaptiveDemux2StreamClass;
 
 typedef enum _GstAdaptiveDemux2StreamState GstAdaptiveDemux2StreamState;
 
+/**
+ * GstAdaptiveDemux2AbrAlgorithm:
+ * @GST_ADAPTIVE_DEMUX_ABR_THROUGHPUT: Select the bitrate from the measured
+ *   download rate, scaled by #GstAdaptiveDemux2:bandwidth-target-ratio
+ * @GST_ADAPTIVE_DEMUX_ABR_BUFFER_BASED: Select the bitrate from the buffered
+ *   level of the stream, between the low and high watermarks
+ *
+ * Algorithm used to pick the bitrate of the next fragment.
+ *
+ * Since: 1.22
+ */
+typedef enum {
+  GST_ADAPTIVE_DEMUX_ABR_THROUGHPUT,
+  GST_ADAPTIVE_DEMUX_ABR_BUFFER_BASED,
+} GstAdaptiveDemuxAbrAlgorithm;
+
+#define GST_TYPE_ADAPTIVE_DEMUX_ABR_ALGORITHM \
+  (gst_adaptive_demux_abr_algorithm_get_type())
+
 typedef struct _GstAdaptiveDemux2StreamFragment GstAdaptiveDemux2StreamFragment;
 typedef struct _GstAdaptiveDemuxTrack GstAdaptiveDemuxTrack;
 typedef struct _GstAdaptiveDemuxPeriod GstAdaptiveDemuxPeriod;
@@ -312,6 +331,19 @@ struct _GstAdaptiveDemux2Stream
   /* persistent, reused download request for fragment data */
   DownloadRequest *download_request;
 
+  /* Upcoming fragments being downloaded ahead of time
+   * (GstAdaptiveDemux2StreamPrefetch) */
+  GList *prefetches;
+  /* TRUE if the current fragment was completely served from a prefetch */
+  gboolean download_from_prefetch;
+
+  /* Window of overlapping fragment downloads, used to estimate the
+   * aggregated bitrate when prefetching */
+  GstClockTime busy_start;
+  GstClockTime busy_end;
+  guint64 busy_bytes;
+  guint busy_downloads;
+
   GstAdaptiveDemux2StreamState state;
   guint pending_cb_id;
   gboolean download_active;
@@ -426,6 +458,12 @@ struct _GstAdaptiveDemux
 
   guint current_download_rate; /* Current estimate of download bitrate */
 
+  GstAdaptiveDemuxAbrAlgorithm abr_algorithm; /* Bitrate selection algorithm */
+
+  /* Prefetching */
+  guint max_prefetch_fragments; /* Fragments to download ahead per stream */
+  guint64 max_prefetch_cache_size; /* Bytes of prefetched data per stream */
+
   /* Buffering levels */
   GstClockTime max_buffering_time;
   GstClockTime buffering_high_watermark_time;
@@ -635,6 +673,26 @@ struct _GstAdaptiveDemuxClass
    */
   GstClockTime (*stream_get_fragment_waiting_time) (GstAdaptiveDemux2Stream * stream);
 
+  /**
+   * stream_get_prefetch_fragment:
+   * @stream: #GstAdaptiveDemux2Stream
+   * @distance: how many fragments after the current one (starting at 1)
+   * @uri: (out) (transfer full): the URI of the fragment
+   * @range_start: (out): the start of the byte range of the fragment
+   * @range_end: (out): the end of the byte range of the fragment, or -1
+   *
+   * Optional. Provides the location of an upcoming fragment, without
+   * advancing the stream, so that the base class can download it ahead of
+   * time when #GstAdaptiveDemux:max-prefetch-fragments is set.
+   *
+   * Returns: %TRUE if the fragment is known, %FALSE otherwise
+   */
+  gboolean      (*stream_get_prefetch_fragment) (GstAdaptiveDemux2Stream * stream,
+                                                 guint distance,
+                                                 gchar ** uri,
+                                                 gint64 * range_start,
+                                                 gint64 * range_end);
+
   /**
    * start_fragment:
    * @demux: #GstAdaptiveDemux
@@ -726,6 +784,8 @@ GType    gst_adaptive_demux_ng_get_type (void);
 
 GType    gst_adaptive_demux2_stream_get_type (void);
 
+GType    gst_adaptive_demux_abr_algorithm_get_type (void);
+
 gboolean gst_adaptive_demux2_add_stream (GstAdaptiveDemux *demux,
 					 GstAdaptiveDemux2Stream *stream);
 
@@ -128,6 +128,9 @@ static GstFlowReturn gst_hls_demux_advance_fragment (GstAdaptiveDemux2Stream *
     stream);
 static GstFlowReturn gst_hls_demux_update_fragment_info (GstAdaptiveDemux2Stream
     * stream);
+static gboolean
+gst_hls_demux_stream_get_prefetch_fragment (GstAdaptiveDemux2Stream * stream,
+    guint distance, gchar ** uri, gint64 * range_start, gint64 * range_end);
 static gboolean gst_hls_demux_stream_can_start (GstAdaptiveDemux * demux,
     GstAdaptiveDemux2Stream * stream);
 static void gst_hls_demux_stream_update_tracks (GstAdaptiveDemux * demux,
@@ -273,6 +276,8 @@ gst_hls_demux2_class_init (GstHLSDemux2Class * klass)
   adaptivedemux_class->stream_advance_fragment = gst_hls_demux_advance_fragment;
   adaptivedemux_class->stream_update_fragment_info =
       gst_hls_demux_update_fragment_info;
+  adaptivedemux_class->stream_get_prefetch_fragment =
+      gst_hls_demux_stream_get_prefetch_fragment;
   adaptivedemux_class->stream_select_bitrate = gst_hls_demux_select_bitrate;
   adaptivedemux_class->stream_can_start = gst_hls_demux_stream_can_start;
   adaptivedemux_class->stream_update_tracks =
@@ -1540,16 +1545,23 @@ gst_hls_demux_finish_fragment (GstAdaptiveDemux * demux,
     if (hls_stream->pending_decrypted_buffer) {
       if (hls_stream->current_key) {
         GstMapInfo info;
-        gssize unpadded_size;
+        gssize unpadded_size = -1;
 
         /* Handle pkcs7 unpadding here */
-        gst_buffer_map (hls_stream->pending_decrypted_buffer, &info,
-            GST_MAP_READ);
-        unpadded_size = info.size - info.data[info.size - 1];
-        gst_buffer_unmap (hls_stream->pending_decrypted_buffer, &info);
-
-        gst_buffer_resize (hls_stream->pending_decrypted_buffer, 0,
-            unpadded_size);
+        if (gst_buffer_map (hls_stream->pending_decrypted_buffer, &info,
+                GST_MAP_READ)) {
+          guint8 padding = info.size > 0 ? info.data[info.size - 1] : 0;
+
+          if (padding > 0 && padding <= 16 && padding <= info.size)
+            unpadded_size = info.size - padding;
+          else
+            GST_WARNING_OBJECT (stream, "Invalid padding size %u", padding);
+          gst_buffer_unmap (hls_stream->pending_decrypted_buffer, &info);
+        }
+
+        if (unpadded_size >= 0)
+          gst_buffer_resize (hls_stream->pending_decrypted_buffer, 0,
+              unpadded_size);
       }
 
       ret =
@@ -1743,6 +1755,7 @@ download_media_playlist (GstHLSDemux * demux, gchar * uri, GError ** err,
   gchar *playlist_data;
   GstHLSMediaPlaylist *playlist = NULL;
   gchar *base_uri;
+  gchar *request_uri = NULL;
   gboolean playlist_uri_change = FALSE;
 
   adaptive_demux = GST_ADAPTIVE_DEMUX (demux);
@@ -1754,21 +1767,33 @@ download_media_playlist (GstHLSDemux * demux, gchar * uri, GError ** err,
 
   if (!playlist_uri_change) {
     GST_LOG_OBJECT (demux, "Updating the playlist");
+
+    /* Ask for a delta update if the server supports it. The skipped segments
+     * will be taken from the current playlist */
+    if (GST_HLS_MEDIA_PLAYLIST_IS_LIVE (current) && current->skip_boundary > 0
+        && strstr (uri, "_HLS_skip=") == NULL)
+      request_uri = g_strdup_printf ("%s%c_HLS_skip=YES", uri,
+          strchr (uri, '?') ? '&' : '?');
   }
 
+retry:
   download =
       downloadhelper_fetch_uri (adaptive_demux->download_helper,
-      uri, main_uri, DOWNLOAD_FLAG_COMPRESS | DOWNLOAD_FLAG_FORCE_REFRESH, err);
+      request_uri ? request_uri : uri, main_uri,
+      DOWNLOAD_FLAG_COMPRESS | DOWNLOAD_FLAG_FORCE_REFRESH, err);
 
-  if (download == NULL)
+  if (download == NULL) {
+    g_free (request_uri);
     return NULL;
+  }
 
   /* Set the base URI of the playlist to the redirect target if any */
   if (download->redirect_permanent && download->redirect_uri) {
     uri = g_strdup (download->redirect_uri);
     base_uri = NULL;
   } else {
-    uri = g_strdup (download->uri);
+    /* Keep the playlist URI without the delta update directive */
+    uri = g_strdup (request_uri ? uri : download->uri);
     base_uri = g_strdup (download->redirect_uri);
   }
 
@@ -1806,7 +1831,19 @@ download_media_playlist (GstHLSDemux * demux, gchar * uri, GError ** err,
     playlist->reloaded = TRUE;
     g_free (playlist_data);
   } else {
-    playlist = gst_hls_media_playlist_parse (playlist_data, uri, base_uri);
+    playlist =
+        gst_hls_media_playlist_parse_with_reference (playlist_data, uri,
+        base_uri, playlist_uri_change ? NULL : current);
+    if (!playlist && request_uri) {
+      /* The delta update might refer to segments we don't have anymore, try
+       * again with the full playlist */
+      GST_DEBUG_OBJECT (demux, "Couldn't parse delta update, retrying");
+      g_clear_pointer (&request_uri, g_free);
+      g_free (base_uri);
+      g_free (uri);
+      uri = current->uri;
+      goto retry;
+    }
     if (!playlist) {
       GST_WARNING_OBJECT (demux, "Couldn't parse playlist");
       if (err)
@@ -1818,6 +1855,7 @@ download_media_playlist (GstHLSDemux * demux, gchar * uri, GError ** err,
 out:
   g_free (uri);
   g_free (base_uri);
+  g_free (request_uri);
 
   return playlist;
 }
@@ -2129,6 +2167,36 @@ gst_hls_demux_update_fragment_info (GstAdaptiveDemux2Stream * stream)
   return GST_FLOW_OK;
 }
 
+static gboolean
+gst_hls_demux_stream_get_prefetch_fragment (GstAdaptiveDemux2Stream * stream,
+    guint distance, gchar ** uri, gint64 * range_start, gint64 * range_end)
+{
+  GstHLSDemuxStream *hlsdemux_stream = GST_HLS_DEMUX_STREAM_CAST (stream);
+  GstM3U8MediaSegment *file;
+
+  if (hlsdemux_stream->playlist == NULL
+      || hlsdemux_stream->current_segment == NULL
+      || hlsdemux_stream->pending_advance)
+    return FALSE;
+
+  file = gst_hls_media_playlist_get_fragment_after (hlsdemux_stream->playlist,
+      hlsdemux_stream->current_segment, distance,
+      stream->demux->segment.rate > 0);
+  if (file == NULL)
+    return FALSE;
+
+  *uri = g_strdup (file->uri);
+  *range_start = file->offset;
+  if (file->size != -1)
+    *range_end = file->offset + file->size - 1;
+  else
+    *range_end = -1;
+
+  gst_m3u8_media_segment_unref (file);
+
+  return TRUE;
+}
+
 static gboolean
 gst_hls_demux_stream_can_start (GstAdaptiveDemux * demux,
     GstAdaptiveDemux2Stream * stream)
@@ -2572,42 +2640,37 @@ gst_hls_demux_stream_decrypt_end (GstHLSDemuxStream * stream)
 }
 #endif
 
+/* Decrypts @buffer in place. The buffers coming from the download helper
+ * are not shared with anyone else, so this normally neither allocates nor
+ * copies. All crypto backends support identical input and output pointers */
 static GstBuffer *
 gst_hls_demux_decrypt_fragment (GstHLSDemux * demux, GstHLSDemuxStream * stream,
-    GstBuffer * encrypted_buffer, GError ** err)
+    GstBuffer * buffer, GError ** err)
 {
-  GstBuffer *decrypted_buffer = NULL;
-  GstMapInfo encrypted_info, decrypted_info;
+  GstMapInfo info;
 
-  decrypted_buffer =
-      gst_buffer_new_allocate (NULL, gst_buffer_get_size (encrypted_buffer),
-      NULL);
+  buffer = gst_buffer_make_writable (buffer);
 
-  gst_buffer_map (encrypted_buffer, &encrypted_info, GST_MAP_READ);
-  gst_buffer_map (decrypted_buffer, &decrypted_info, GST_MAP_WRITE);
+  if (!gst_buffer_map (buffer, &info, GST_MAP_READWRITE))
+    goto map_error;
 
-  if (!decrypt_fragment (stream, encrypted_info.size,
-          encrypted_info.data, decrypted_info.data))
+  if (!decrypt_fragment (stream, info.size, info.data, info.data)) {
+    gst_buffer_unmap (buffer, &info);
     goto decrypt_error;
+  }
 
+  gst_buffer_unmap (buffer, &info);
 
-  gst_buffer_unmap (decrypted_buffer, &decrypted_info);
-  gst_buffer_unmap (encrypted_buffer, &encrypted_info);
-
-  gst_buffer_unref (encrypted_buffer);
-
-  return decrypted_buffer;
+  return buffer;
 
+map_error:
+  GST_ERROR_OBJECT (demux, "Failed to map fragment");
 decrypt_error:
   GST_ERROR_OBJECT (demux, "Failed to decrypt fragment");
   g_set_error (err, GST_STREAM_ERROR, GST_STREAM_ERROR_DECRYPT,
       "Failed to decrypt fragment");
 
-  gst_buffer_unmap (decrypted_buffer, &decrypted_info);
-  gst_buffer_unmap (encrypted_buffer, &encrypted_info);
-
-  gst_buffer_unref (encrypted_buffer);
-  gst_buffer_unref (decrypted_buffer);
+  gst_buffer_unref (buffer);
 
   return NULL;
 }
@@ -437,10 +437,111 @@ gst_hls_media_playlist_postprocess_pdt (GstHLSMediaPlaylist * self)
   }
 }
 
+/* Returns the segment of @playlist with sequence number @sequence, or NULL.
+ * Segments are contiguous, except for a reference segment which might have
+ * been inserted before the first one by gst_hls_media_playlist_sync_to_segment() */
+static GstM3U8MediaSegment *
+gst_hls_media_playlist_find_by_sequence (GstHLSMediaPlaylist * playlist,
+    gint64 sequence)
+{
+  gint64 idx = sequence - playlist->media_sequence;
+  gint64 last = idx + 1;
+  GstM3U8MediaSegment *segment;
+
+  for (idx = MAX (idx, 0); idx <= last && idx < playlist->segments->len; idx++) {
+    segment = g_ptr_array_index (playlist->segments, idx);
+    if (segment->sequence == sequence)
+      return segment;
+  }
+
+  return NULL;
+}
+
+/* Checks whether the segment with the same sequence number in @reference is
+ * identical to the one described by the other arguments, and returns a new
+ * reference to it if so. @line is the (unresolved) URI line of the playlist.
+ *
+ * This avoids re-creating thousands of unchanged segments every time a large
+ * live playlist is refreshed. */
+static GstM3U8MediaSegment *
+gst_hls_media_playlist_reuse_segment (GstHLSMediaPlaylist * reference,
+    const gchar * line, gint64 sequence, GstClockTime duration, gint64 dsn,
+    gboolean discont, const gchar * key, const guint8 * iv, gint64 size,
+    gint64 offset, GDateTime * datetime, GstM3U8InitFile * init_file)
+{
+  GstM3U8MediaSegment *segment;
+  gsize line_len, uri_len;
+  guint8 seg_iv[16] = { 0, };
+
+  segment = gst_hls_media_playlist_find_by_sequence (reference, sequence);
+  if (segment == NULL)
+    return NULL;
+
+  if (segment->duration != duration || segment->discont != discont
+      || segment->discont_sequence != dsn)
+    return NULL;
+
+  /* Only relative URIs are matched against the end of the resolved one, others
+   * need to go through the regular URI resolution */
+  if (line[0] == '/' || strstr (line, "://") != NULL)
+    return NULL;
+  line_len = strlen (line);
+  uri_len = strlen (segment->uri);
+  if (uri_len <= line_len || segment->uri[uri_len - line_len - 1] != '/'
+      || strcmp (segment->uri + uri_len - line_len, line) != 0)
+    return NULL;
+
+  if (size == -1)
+    offset = 0;
+  else if (offset == -1)
+    offset = 0;
+  if (segment->size != size || segment->offset != offset)
+    return NULL;
+
+  if (g_strcmp0 (segment->key, key) != 0)
+    return NULL;
+  if (key) {
+    if (iv == NULL) {
+      GST_WRITE_UINT32_BE (seg_iv + 12, sequence);
+      iv = seg_iv;
+    }
+    if (memcmp (segment->iv, iv, sizeof (seg_iv)) != 0)
+      return NULL;
+  }
+
+  if (datetime && (segment->datetime == NULL
+          || !g_date_time_equal (segment->datetime, datetime)))
+    return NULL;
+
+  if (init_file) {
+    if (segment->init_file == NULL
+        || g_strcmp0 (segment->init_file->uri, init_file->uri) != 0
+        || segment->init_file->size != init_file->size
+        || segment->init_file->offset != init_file->offset)
+      return NULL;
+  } else if (segment->init_file) {
+    return NULL;
+  }
+
+  return gst_m3u8_media_segment_ref (segment);
+}
+
 /* Parse and create a new GstHLSMediaPlaylist */
 GstHLSMediaPlaylist *
 gst_hls_media_playlist_parse (gchar * data, const gchar * uri,
     const gchar * base_uri)
+{
+  return gst_hls_media_playlist_parse_with_reference (data, uri, base_uri,
+      NULL);
+}
+
+/* Parse and create a new GstHLSMediaPlaylist, which is an update of
+ * @reference. Segments which are unchanged from @reference are shared instead
+ * of being re-created, and segments omitted from a delta update (EXT-X-SKIP)
+ * are taken from it. */
+GstHLSMediaPlaylist *
+gst_hls_media_playlist_parse_with_reference (gchar * data, const gchar * uri,
+    const gchar * base_uri, GstHLSMediaPlaylist * reference)
 {
   gchar *input_data = data;
   GstHLSMediaPlaylist *self;
@@ -457,6 +558,9 @@ gst_hls_media_playlist_parse (gchar * data, const gchar * uri,
   GDateTime *date_time = NULL;
   GstM3U8InitFile *last_init_file = NULL;
   GstM3U8MediaSegment *previous = NULL;
+  gboolean can_reuse;
+  gboolean invalid_skip = FALSE;
+  guint reused = 0;
 
   GST_LOG ("uri: %s", uri);
   GST_LOG ("base_uri: %s", base_uri);
@@ -476,6 +580,11 @@ gst_hls_media_playlist_parse (gchar * data, const gchar * uri,
 
   self = gst_hls_media_playlist_new (uri, base_uri);
 
+  /* Segment URIs can only be compared if they are resolved the same way */
+  can_reuse = reference != NULL
+      && !g_strcmp0 (reference->base_uri ? reference->base_uri : reference->uri,
+      self->base_uri ? self->base_uri : self->uri);
+
   /* Store a copy of the data */
   self->last_data = g_strdup (data);
 
@@ -499,6 +608,31 @@ gst_hls_media_playlist_parse (gchar * data, const gchar * uri,
         goto next_line;
       }
 
+      if (can_reuse) {
+        GstM3U8MediaSegment *file;
+
+        file = gst_hls_media_playlist_reuse_segment (reference, data,
+            mediasequence, duration, dsn, discontinuity, current_key,
+            have_iv ? iv : NULL, size, offset, date_time, last_init_file);
+        if (file) {
+          mediasequence++;
+          self->duration += duration;
+          if (date_time)
+            g_date_time_unref (date_time);
+          g_free (title);
+
+          date_time = NULL;
+          duration = 0;
+          title = NULL;
+          discontinuity = FALSE;
+          size = offset = -1;
+          g_ptr_array_add (self->segments, file);
+          previous = file;
+          reused++;
+          goto next_line;
+        }
+      }
+
       data = uri_join (self->base_uri ? self->base_uri : self->uri, data);
 
       /* Let's check this is not a bogus duplicate entry */
@@ -615,6 +749,63 @@ gst_hls_media_playlist_parse (gchar * data, const gchar * uri,
         date_time = g_date_time_new_from_iso8601 (data + 25, NULL);
         if (date_time)
           self->ext_x_pdt_present = TRUE;
+      } else if (g_str_has_prefix (data_ext_x, "SERVER-CONTROL:")) {
+        gchar *v, *a;
+
+        data = data + 22;
+        while (data != NULL && parse_attributes (&data, &a, &v)) {
+          gdouble fval;
+
+          if (g_str_equal (a, "CAN-SKIP-UNTIL")
+              && double_from_string (v, NULL, &fval) && fval > 0)
+            self->skip_boundary = fval * (gdouble) GST_SECOND;
+        }
+      } else if (g_str_has_prefix (data_ext_x, "SKIP:")) {
+        gchar *v, *a;
+        gint64 skipped = -1, i;
+
+        data = data + 12;
+        while (data != NULL && parse_attributes (&data, &a, &v)) {
+          if (g_str_equal (a, "SKIPPED-SEGMENTS"))
+            int64_from_string (v, NULL, &skipped);
+        }
+
+        /* The skipped segments are the first ones of the playlist, they have
+         * to be present in the playlist being updated */
+        if (skipped <= 0 || self->segments->len > 0 || reference == NULL) {
+          GST_WARNING ("Invalid EXT-X-SKIP of %" G_GINT64_FORMAT
+              " segments", skipped);
+          invalid_skip = TRUE;
+          break;
+        }
+
+        for (i = 0; i < skipped; i++) {
+          GstM3U8MediaSegment *file =
+              gst_hls_media_playlist_find_by_sequence (reference,
+              mediasequence);
+
+          if (file == NULL) {
+            GST_WARNING ("Skipped segment %" G_GINT64_FORMAT
+                " not present in previous playlist", mediasequence);
+            invalid_skip = TRUE;
+            break;
+          }
+
+          self->duration += file->duration;
+          if (file->key)
+            self->ext_x_key_present = TRUE;
+          if (file->datetime)
+            self->ext_x_pdt_present = TRUE;
+          g_ptr_array_add (self->segments, gst_m3u8_media_segment_ref (file));
+          previous = file;
+          mediasequence++;
+        }
+        if (invalid_skip)
+          break;
+
+        /* EXT-X-DISCONTINUITY-SEQUENCE applies to the first skipped segment */
+        dsn = previous->discont_sequence;
+        reused += skipped;
       } else if (g_str_has_prefix (data_ext_x, "ALLOW-CACHE:")) {
         self->allowcache = g_ascii_strcasecmp (data + 19, "YES") == 0;
       } else if (g_str_has_prefix (data_ext_x, "KEY:")) {
@@ -745,12 +936,25 @@ gst_hls_media_playlist_parse (gchar * data, const gchar * uri,
   if (last_init_file)
     gst_m3u8_init_file_unref (last_init_file);
 
+  if (invalid_skip) {
+    GST_WARNING ("Invalid delta playlist update");
+    if (date_time)
+      g_date_time_unref (date_time);
+    g_free (title);
+    gst_hls_media_playlist_unref (self);
+    return NULL;
+  }
+
   if (self->segments->len == 0) {
     GST_ERROR ("Invalid media playlist, it does not contain any media files");
     gst_hls_media_playlist_unref (self);
     return NULL;
   }
 
+  if (reference)
+    GST_DEBUG ("Re-used %u of %u segments from previous playlist", reused,
+        self->segments->len);
+
   /* Now go over the parsed data to ensure MSN and/or PDT are set */
   if (self->ext_x_pdt_present)
     gst_hls_media_playlist_postprocess_pdt (self);
@@ -1212,6 +1416,39 @@ out:
   return file;
 }
 
+/* Returns the segment @distance positions after (or before, when going
+ * backward) @current, without changing the playlist position */
+GstM3U8MediaSegment *
+gst_hls_media_playlist_get_fragment_after (GstHLSMediaPlaylist * m3u8,
+    GstM3U8MediaSegment * current, guint distance, gboolean forward)
+{
+  GstM3U8MediaSegment *file = NULL;
+  guint idx;
+
+  g_return_val_if_fail (m3u8 != NULL, NULL);
+  g_return_val_if_fail (current != NULL, NULL);
+
+  GST_HLS_MEDIA_PLAYLIST_LOCK (m3u8);
+
+  if (!g_ptr_array_find (m3u8->segments, current, &idx))
+    goto out;
+
+  if (forward && distance < m3u8->segments->len - idx) {
+    file =
+        gst_m3u8_media_segment_ref (g_ptr_array_index (m3u8->segments,
+            idx + distance));
+  } else if (!forward && distance <= idx) {
+    file =
+        gst_m3u8_media_segment_ref (g_ptr_array_index (m3u8->segments,
+            idx - distance));
+  }
+
+out:
+  GST_HLS_MEDIA_PLAYLIST_UNLOCK (m3u8);
+
+  return file;
+}
+
 GstClockTime
 gst_hls_media_playlist_get_duration (GstHLSMediaPlaylist * m3u8)
 {
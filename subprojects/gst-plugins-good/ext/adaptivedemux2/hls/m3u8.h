@@ -93,6 +93,9 @@ struct _GstHLSMediaPlaylist
 
   gboolean allowcache;		/* deprecated EXT-X-ALLOW-CACHE */
 
+  GstClockTime skip_boundary;	/* EXT-X-SERVER-CONTROL CAN-SKIP-UNTIL, or 0
+				   if delta updates are not supported */
+
   /* Overview of contained media segments */
   gboolean ext_x_key_present;	/* a valid EXT-X-KEY is present on at least one
 				   media segment */
@@ -174,6 +177,12 @@ gst_hls_media_playlist_parse (gchar        * data,
 			      const gchar  * uri,
 			      const gchar  * base_uri);
 
+GstHLSMediaPlaylist *
+gst_hls_media_playlist_parse_with_reference (gchar               * data,
+					     const gchar         * uri,
+					     const gchar         * base_uri,
+					     GstHLSMediaPlaylist * reference);
+
 void
 gst_hls_media_playlist_recalculate_stream_time (GstHLSMediaPlaylist *playlist,
 						GstM3U8MediaSegment *anchor);
@@ -192,6 +201,12 @@ gst_hls_media_playlist_advance_fragment     (GstHLSMediaPlaylist * m3u8,
 					     GstM3U8MediaSegment * current,
 					     gboolean  forward);
 
+GstM3U8MediaSegment *
+gst_hls_media_playlist_get_fragment_after   (GstHLSMediaPlaylist * m3u8,
+					     GstM3U8MediaSegment * current,
+					     guint     distance,
+					     gboolean  forward);
+
 GstM3U8MediaSegment *
 gst_hls_media_playlist_get_starting_segment (GstHLSMediaPlaylist *self);
 
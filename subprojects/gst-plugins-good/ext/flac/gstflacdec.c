@@ -114,6 +114,13 @@ static gboolean gst_flac_dec_start (GstAudioDecoder * dec);
 static gboolean gst_flac_dec_stop (GstAudioDecoder * dec);
 static GstFlowReturn gst_flac_dec_handle_frame (GstAudioDecoder * audio_dec,
     GstBuffer * buf);
+static gpointer gst_flac_dec_create_worker (GstAudioDecoder * audio_dec,
+    guint * preroll);
+static GstFlowReturn gst_flac_dec_decode_frames (GstAudioDecoder * audio_dec,
+    gpointer worker, GstBufferList * frames, guint preroll,
+    GstBufferList * output);
+static void gst_flac_dec_free_worker (GstAudioDecoder * audio_dec,
+    gpointer worker);
 
 G_DEFINE_TYPE (GstFlacDec, gst_flac_dec, GST_TYPE_AUDIO_DECODER);
 GST_ELEMENT_REGISTER_DEFINE_WITH_CODE (flacdec, "flacdec", GST_RANK_PRIMARY,
@@ -167,6 +174,12 @@ gst_flac_dec_class_init (GstFlacDecClass * klass)
   audiodecoder_class->set_format = GST_DEBUG_FUNCPTR (gst_flac_dec_set_format);
   audiodecoder_class->handle_frame =
       GST_DEBUG_FUNCPTR (gst_flac_dec_handle_frame);
+  audiodecoder_class->create_worker =
+      GST_DEBUG_FUNCPTR (gst_flac_dec_create_worker);
+  audiodecoder_class->decode_frames =
+      GST_DEBUG_FUNCPTR (gst_flac_dec_decode_frames);
+  audiodecoder_class->free_worker =
+      GST_DEBUG_FUNCPTR (gst_flac_dec_free_worker);
 
   gst_element_class_add_static_pad_template (gstelement_class,
       &flac_dec_src_factory);
@@ -590,6 +603,89 @@ gst_flac_dec_read_stream (const FLAC__StreamDecoder * decoder,
   return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
 }
 
+/* maps a FLAC sample depth to the width and depth of the output format */
+static gboolean
+gst_flac_dec_get_width (guint depth, guint * width, guint * gdepth)
+{
+  switch (depth) {
+    case 8:
+      *gdepth = *width = 8;
+      break;
+    case 12:
+    case 16:
+      *gdepth = *width = 16;
+      break;
+    case 20:
+    case 24:
+      *gdepth = 24;
+      *width = 32;
+      break;
+    case 32:
+      *gdepth = *width = 32;
+      break;
+    default:
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* interleaves and reorders the decoded channels into @data */
+static void
+gst_flac_dec_interleave (guint8 * data, const FLAC__int32 * const buffer[],
+    guint samples, guint channels, guint width, guint gdepth, guint depth,
+    const gint * reorder_map)
+{
+  guint i, j;
+
+  if (width == 8) {
+    gint8 *outbuffer = (gint8 *) data;
+
+    g_assert (gdepth == 8 && depth == 8);
+    for (i = 0; i < samples; i++) {
+      for (j = 0; j < channels; j++) {
+        *outbuffer++ = (gint8) buffer[reorder_map[j]][i];
+      }
+    }
+  } else if (width == 16) {
+    gint16 *outbuffer = (gint16 *) data;
+
+    if (gdepth != depth) {
+      for (i = 0; i < samples; i++) {
+        for (j = 0; j < channels; j++) {
+          *outbuffer++ =
+              (gint16) (buffer[reorder_map[j]][i] << (gdepth - depth));
+        }
+      }
+    } else {
+      for (i = 0; i < samples; i++) {
+        for (j = 0; j < channels; j++) {
+          *outbuffer++ = (gint16) buffer[reorder_map[j]][i];
+        }
+      }
+    }
+  } else if (width == 32) {
+    gint32 *outbuffer = (gint32 *) data;
+
+    if (gdepth != depth) {
+      for (i = 0; i < samples; i++) {
+        for (j = 0; j < channels; j++) {
+          *outbuffer++ =
+              (gint32) (buffer[reorder_map[j]][i] << (gdepth - depth));
+        }
+      }
+    } else {
+      for (i = 0; i < samples; i++) {
+        for (j = 0; j < channels; j++) {
+          *outbuffer++ = (gint32) buffer[reorder_map[j]][i];
+        }
+      }
+    }
+  } else {
+    g_assert_not_reached ();
+  }
+}
+
 static FLAC__StreamDecoderWriteStatus
 gst_flac_dec_write (GstFlacDec * flacdec, const FLAC__Frame * frame,
     const FLAC__int32 * const buffer[])
@@ -601,7 +697,6 @@ gst_flac_dec_write (GstFlacDec * flacdec, const FLAC__Frame * frame,
   guint sample_rate = frame->header.sample_rate;
   guint channels = frame->header.channels;
   guint samples = frame->header.blocksize;
-  guint j, i;
   GstMapInfo map;
   gboolean caps_changed;
   GstAudioChannelPosition chanpos[8];
@@ -619,26 +714,10 @@ gst_flac_dec_write (GstFlacDec * flacdec, const FLAC__Frame * frame,
     depth = flacdec->depth;
   }
 
-  switch (depth) {
-    case 8:
-      gdepth = width = 8;
-      break;
-    case 12:
-    case 16:
-      gdepth = width = 16;
-      break;
-    case 20:
-    case 24:
-      gdepth = 24;
-      width = 32;
-      break;
-    case 32:
-      gdepth = width = 32;
-      break;
-    default:
-      GST_ERROR_OBJECT (flacdec, "unsupported depth %d", depth);
-      ret = GST_FLOW_ERROR;
-      goto done;
+  if (!gst_flac_dec_get_width (depth, &width, &gdepth)) {
+    GST_ERROR_OBJECT (flacdec, "unsupported depth %d", depth);
+    ret = GST_FLOW_ERROR;
+    goto done;
   }
 
   if (sample_rate == 0) {
@@ -682,55 +761,8 @@ gst_flac_dec_write (GstFlacDec * flacdec, const FLAC__Frame * frame,
       gst_buffer_new_allocate (NULL, samples * channels * (width / 8), NULL);
 
   gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
-  if (width == 8) {
-    gint8 *outbuffer = (gint8 *) map.data;
-    gint *reorder_map = flacdec->channel_reorder_map;
-
-    g_assert (gdepth == 8 && depth == 8);
-    for (i = 0; i < samples; i++) {
-      for (j = 0; j < channels; j++) {
-        *outbuffer++ = (gint8) buffer[reorder_map[j]][i];
-      }
-    }
-  } else if (width == 16) {
-    gint16 *outbuffer = (gint16 *) map.data;
-    gint *reorder_map = flacdec->channel_reorder_map;
-
-    if (gdepth != depth) {
-      for (i = 0; i < samples; i++) {
-        for (j = 0; j < channels; j++) {
-          *outbuffer++ =
-              (gint16) (buffer[reorder_map[j]][i] << (gdepth - depth));
-        }
-      }
-    } else {
-      for (i = 0; i < samples; i++) {
-        for (j = 0; j < channels; j++) {
-          *outbuffer++ = (gint16) buffer[reorder_map[j]][i];
-        }
-      }
-    }
-  } else if (width == 32) {
-    gint32 *outbuffer = (gint32 *) map.data;
-    gint *reorder_map = flacdec->channel_reorder_map;
-
-    if (gdepth != depth) {
-      for (i = 0; i < samples; i++) {
-        for (j = 0; j < channels; j++) {
-          *outbuffer++ =
-              (gint32) (buffer[reorder_map[j]][i] << (gdepth - depth));
-        }
-      }
-    } else {
-      for (i = 0; i < samples; i++) {
-        for (j = 0; j < channels; j++) {
-          *outbuffer++ = (gint32) buffer[reorder_map[j]][i];
-        }
-      }
-    }
-  } else {
-    g_assert_not_reached ();
-  }
+  gst_flac_dec_interleave (map.data, buffer, samples, channels, width, gdepth,
+      depth, flacdec->channel_reorder_map);
   gst_buffer_unmap (outbuf, &map);
 
   GST_DEBUG_OBJECT (flacdec, "pushing %d samples", samples);
@@ -848,3 +880,209 @@ gst_flac_dec_handle_frame (GstAudioDecoder * audio_dec, GstBuffer * buf)
 
   return dec->last_flow;
 }
+
+/* a decoder for decoding a batch of frames in parallel, set up with the
+ * stream headers and the output format of the streaming thread decoder */
+typedef struct
+{
+  GstFlacDec *dec;
+  FLAC__StreamDecoder *decoder;
+  GstAdapter *adapter;
+
+  GstAudioInfo info;
+  gint channel_reorder_map[8];
+  gint depth;
+
+  /* output of the frame that is being decoded */
+  GstBuffer *outbuf;
+  gboolean error;
+  gboolean not_negotiated;
+} GstFlacDecWorker;
+
+static FLAC__StreamDecoderReadStatus
+gst_flac_dec_worker_read (const FLAC__StreamDecoder * decoder,
+    FLAC__byte buffer[], size_t * bytes, void *client_data)
+{
+  GstFlacDecWorker *worker = client_data;
+  guint len;
+
+  len = MIN (gst_adapter_available (worker->adapter), *bytes);
+  if (len == 0)
+    return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
+
+  gst_adapter_copy (worker->adapter, buffer, 0, len);
+  gst_adapter_flush (worker->adapter, len);
+  *bytes = len;
+
+  return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
+}
+
+static FLAC__StreamDecoderWriteStatus
+gst_flac_dec_worker_write (const FLAC__StreamDecoder * decoder,
+    const FLAC__Frame * frame,
+    const FLAC__int32 * const buffer[], void *client_data)
+{
+  GstFlacDecWorker *worker = client_data;
+  guint depth = frame->header.bits_per_sample;
+  guint sample_rate = frame->header.sample_rate;
+  guint channels = frame->header.channels;
+  guint samples = frame->header.blocksize;
+  guint width, gdepth;
+  GstMapInfo map;
+
+  if (depth == 0)
+    depth = worker->depth;
+  if (sample_rate == 0)
+    sample_rate = worker->info.rate;
+
+  /* format changes need to be negotiated by the streaming thread */
+  if (!gst_flac_dec_get_width (depth, &width, &gdepth)
+      || depth != worker->depth
+      || sample_rate != GST_AUDIO_INFO_RATE (&worker->info)
+      || width != GST_AUDIO_INFO_WIDTH (&worker->info)
+      || gdepth != GST_AUDIO_INFO_DEPTH (&worker->info)
+      || channels != GST_AUDIO_INFO_CHANNELS (&worker->info)) {
+    GST_WARNING_OBJECT (worker->dec, "format changed in parallel decoding");
+    worker->not_negotiated = TRUE;
+    return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+  }
+
+  gst_buffer_replace (&worker->outbuf, NULL);
+  worker->outbuf =
+      gst_buffer_new_allocate (NULL, samples * channels * (width / 8), NULL);
+  gst_buffer_map (worker->outbuf, &map, GST_MAP_WRITE);
+  gst_flac_dec_interleave (map.data, buffer, samples, channels, width, gdepth,
+      depth, worker->channel_reorder_map);
+  gst_buffer_unmap (worker->outbuf, &map);
+
+  return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+}
+
+static void
+gst_flac_dec_worker_metadata (const FLAC__StreamDecoder * decoder,
+    const FLAC__StreamMetadata * metadata, void *client_data)
+{
+  /* already handled by the streaming thread decoder */
+}
+
+static void
+gst_flac_dec_worker_error (const FLAC__StreamDecoder * decoder,
+    FLAC__StreamDecoderErrorStatus status, void *client_data)
+{
+  GstFlacDecWorker *worker = client_data;
+
+  /* reported by the base class once the frame is finished */
+  GST_DEBUG_OBJECT (worker->dec, "decoding error %d", status);
+  worker->error = TRUE;
+}
+
+static void
+gst_flac_dec_free_worker (GstAudioDecoder * audio_dec, gpointer data)
+{
+  GstFlacDecWorker *worker = data;
+
+  FLAC__stream_decoder_delete (worker->decoder);
+  g_object_unref (worker->adapter);
+  gst_buffer_replace (&worker->outbuf, NULL);
+  g_free (worker);
+}
+
+static gpointer
+gst_flac_dec_create_worker (GstAudioDecoder * audio_dec, guint * preroll)
+{
+  GstFlacDec *dec = GST_FLAC_DEC (audio_dec);
+  GstFlacDecWorker *worker;
+  const GValue *headers;
+  GstCaps *caps;
+  guint i, num;
+
+  /* in-stream headers and resyncing are handled by the streaming thread */
+  if (!dec->got_headers || dec->do_resync || dec->info.rate == 0)
+    return NULL;
+
+  caps = gst_pad_get_current_caps (GST_AUDIO_DECODER_SINK_PAD (dec));
+  if (caps == NULL)
+    return NULL;
+
+  worker = g_new0 (GstFlacDecWorker, 1);
+  worker->dec = dec;
+  worker->adapter = gst_adapter_new ();
+  worker->info = dec->info;
+  memcpy (worker->channel_reorder_map, dec->channel_reorder_map,
+      sizeof (dec->channel_reorder_map));
+  worker->depth = dec->depth;
+
+  headers = gst_structure_get_value (gst_caps_get_structure (caps, 0),
+      "streamheader");
+  num = headers ? gst_value_array_get_size (headers) : 0;
+  for (i = 0; i < num; ++i) {
+    const GValue *header_val = gst_value_array_get_value (headers, i);
+
+    if (GST_VALUE_HOLDS_BUFFER (header_val))
+      gst_adapter_push (worker->adapter, g_value_dup_boxed (header_val));
+  }
+  gst_caps_unref (caps);
+
+  worker->decoder = FLAC__stream_decoder_new ();
+  FLAC__stream_decoder_set_md5_checking (worker->decoder, false);
+  if (FLAC__stream_decoder_init_stream (worker->decoder,
+          gst_flac_dec_worker_read, NULL, NULL, NULL, NULL,
+          gst_flac_dec_worker_write, gst_flac_dec_worker_metadata,
+          gst_flac_dec_worker_error, worker)
+      != FLAC__STREAM_DECODER_INIT_STATUS_OK
+      || !FLAC__stream_decoder_process_until_end_of_metadata (worker->decoder)) {
+    GST_WARNING_OBJECT (dec, "failed to set up worker decoder");
+    gst_flac_dec_free_worker (audio_dec, worker);
+    return NULL;
+  }
+  gst_adapter_clear (worker->adapter);
+
+  /* FLAC frames don't depend on each other */
+  *preroll = 0;
+
+  return worker;
+}
+
+static GstFlowReturn
+gst_flac_dec_decode_frames (GstAudioDecoder * audio_dec, gpointer data,
+    GstBufferList * frames, guint preroll, GstBufferList * output)
+{
+  GstFlacDecWorker *worker = data;
+  guint i, n = gst_buffer_list_length (frames);
+
+  for (i = 0; i < n; i++) {
+    gst_adapter_push (worker->adapter,
+        gst_buffer_ref (gst_buffer_list_get (frames, i)));
+
+    worker->error = FALSE;
+    if (!FLAC__stream_decoder_process_single (worker->decoder)) {
+      GST_DEBUG_OBJECT (worker->dec, "process_single failed");
+      gst_adapter_clear (worker->adapter);
+      FLAC__stream_decoder_flush (worker->decoder);
+      worker->error = TRUE;
+    }
+
+    if (worker->not_negotiated)
+      return GST_FLOW_NOT_NEGOTIATED;
+
+    if (i < preroll) {
+      gst_buffer_replace (&worker->outbuf, NULL);
+      continue;
+    }
+
+    /* frames that failed to decode are marked for the base class to count
+     * them against max-errors */
+    if (worker->error || worker->outbuf == NULL) {
+      GstBuffer *buf = gst_buffer_new ();
+
+      GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_CORRUPTED);
+      gst_buffer_list_add (output, buf);
+      gst_buffer_replace (&worker->outbuf, NULL);
+    } else {
+      gst_buffer_list_add (output, worker->outbuf);
+      worker->outbuf = NULL;
+    }
+  }
+
+  return GST_FLOW_OK;
+}
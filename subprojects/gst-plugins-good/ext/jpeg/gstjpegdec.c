@@ -57,12 +57,14 @@
 
 #define JPEG_DEFAULT_IDCT_METHOD	JDCT_FASTEST
 #define JPEG_DEFAULT_MAX_ERRORS 	0
+#define JPEG_DEFAULT_DCT_SCALING	TRUE
 
 enum
 {
   PROP_0,
   PROP_IDCT_METHOD,
-  PROP_MAX_ERRORS
+  PROP_MAX_ERRORS,
+  PROP_DCT_SCALING
 };
 
 /* *INDENT-OFF* */
@@ -165,6 +167,26 @@ gst_jpeg_dec_class_init (GstJpegDecClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_DEPRECATED));
 #endif
 
+  /**
+   * GstJpegDec:dct-scaling:
+   *
+   * If downstream does not accept the coded size of the image but accepts
+   * 1/2, 1/4 or 1/8 of it, let libjpeg scale the image down while decoding.
+   * This is considerably faster than decoding at full size and scaling
+   * afterwards, e.g. when generating thumbnails.
+   *
+   * The same happens if downstream accepts the coded size but answers a
+   * preferred size query (see gst_video_query_new_preferred_size()) with a
+   * smaller size, as videoscale does when its output size is fixed.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_DCT_SCALING,
+      g_param_spec_boolean ("dct-scaling", "DCT Scaling",
+          "Decode at 1/2, 1/4 or 1/8 size if downstream only accepts "
+          "such a smaller size", JPEG_DEFAULT_DCT_SCALING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (element_class,
       &gst_jpeg_dec_src_pad_template);
   gst_element_class_add_static_pad_template (element_class,
@@ -278,6 +300,7 @@ gst_jpeg_dec_init (GstJpegDec * dec)
   /* init properties */
   dec->idct_method = JPEG_DEFAULT_IDCT_METHOD;
   dec->max_errors = JPEG_DEFAULT_MAX_ERRORS;
+  dec->dct_scaling = JPEG_DEFAULT_DCT_SCALING;
 
   gst_video_decoder_set_use_default_pad_acceptcaps (GST_VIDEO_DECODER_CAST
       (dec), TRUE);
@@ -859,6 +882,69 @@ gst_jpeg_dec_decode_indirect (GstJpegDec * dec, GstVideoFrame * frame, gint r_v,
   }
 }
 
+/* Scaled images are decoded with jpeg_read_scanlines(), as in raw mode
+ * libjpeg does not keep the chroma subsampling when scaling */
+static void
+gst_jpeg_dec_decode_scaled (GstJpegDec * dec, GstVideoFrame * frame,
+    guint field, guint num_fields)
+{
+  guchar *rows[2];
+  gint i, j, c, x;
+  gint width, height;
+  gint n_comps, jpeg_comps;
+
+  GST_DEBUG_OBJECT (dec, "decoding at 1/%u scale", dec->cinfo.scale_denom);
+
+  width = GST_VIDEO_FRAME_WIDTH (frame);
+  height = GST_VIDEO_FRAME_HEIGHT (frame) / num_fields;
+  n_comps = GST_VIDEO_FRAME_N_COMPONENTS (frame);
+  jpeg_comps = dec->cinfo.output_components;
+
+  if (G_UNLIKELY (!gst_jpeg_dec_ensure_buffers (dec,
+              GST_ROUND_UP_32 (width * jpeg_comps))))
+    return;
+
+  for (i = 0; i < height; i += 2) {
+    gint n_rows = MIN (2, height - i);
+
+    for (j = 0; j < n_rows; j++) {
+      if (G_UNLIKELY (!jpeg_read_scanlines (&dec->cinfo, &dec->idr_y[j], 1)))
+        GST_INFO_OBJECT (dec, "jpeg_read_scanlines() returned 0");
+    }
+    rows[0] = dec->idr_y[0];
+    rows[1] = dec->idr_y[n_rows - 1];
+
+    for (c = 0; c < n_comps; c++) {
+      guint8 *base = GST_VIDEO_FRAME_COMP_DATA (frame, c);
+      gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, c);
+      gint rstride = GST_VIDEO_FRAME_COMP_STRIDE (frame, c) * num_fields;
+
+      if (field == 2)
+        base += GST_VIDEO_FRAME_COMP_STRIDE (frame, c);
+
+      if (GST_VIDEO_FRAME_COMP_WIDTH (frame, c) == width) {
+        for (j = 0; j < n_rows; j++) {
+          guint8 *dest = base + (i + j) * rstride;
+
+          for (x = 0; x < width; x++)
+            dest[x * pstride] = rows[j][x * jpeg_comps + c];
+        }
+      } else {
+        /* I420 chroma, average each 2x2 block of decoded samples */
+        guint8 *dest = base + (i / 2) * rstride;
+
+        for (x = 0; x < GST_VIDEO_FRAME_COMP_WIDTH (frame, c); x++) {
+          gint x0 = (2 * x) * jpeg_comps + c;
+          gint x1 = MIN (2 * x + 1, width - 1) * jpeg_comps + c;
+
+          dest[x * pstride] = (rows[0][x0] + rows[0][x1] + rows[1][x0] +
+              rows[1][x1] + 2) / 4;
+        }
+      }
+    }
+  }
+}
+
 static GstFlowReturn
 gst_jpeg_dec_decode_direct (GstJpegDec * dec, GstVideoFrame * frame,
     guint field, guint num_fields)
@@ -1139,6 +1225,79 @@ gst_jpeg_dec_negotiate (GstJpegDec * dec, gint width, gint height, gint clrspc,
   GST_DEBUG_OBJECT (dec, "max_h_samp_factor=%d", dec->cinfo.max_h_samp_factor);
 }
 
+static gboolean
+gst_jpeg_dec_caps_accept_size (GstCaps * caps, gint width, gint height)
+{
+  GstCaps *size_caps;
+  gboolean ret;
+
+  size_caps = gst_caps_new_simple ("video/x-raw", "width", G_TYPE_INT, width,
+      "height", G_TYPE_INT, height, NULL);
+  ret = gst_caps_can_intersect (caps, size_caps);
+  gst_caps_unref (size_caps);
+
+  return ret;
+}
+
+/* Returns the largest DCT scaling denominator for which downstream accepts
+ * the decoded size, or 1 if downstream accepts the full size. If the full
+ * size is accepted but downstream prefers a smaller size, e.g. because it
+ * scales down to a thumbnail, the largest denominator that still produces at
+ * least the preferred size is used instead */
+static guint
+gst_jpeg_dec_get_scale_denom (GstJpegDec * dec)
+{
+  GstPad *srcpad = GST_VIDEO_DECODER_SRC_PAD (dec);
+  GstCaps *peer_caps;
+  gint width = dec->cinfo.image_width;
+  gint height = dec->cinfo.image_height;
+  gint pref_width, pref_height;
+  guint denom, ret = 1;
+
+  if (!g_atomic_int_get (&dec->dct_scaling))
+    return 1;
+
+  peer_caps = gst_pad_peer_query_caps (srcpad, NULL);
+  if (gst_caps_is_empty (peer_caps))
+    goto done;
+
+  if (gst_caps_is_any (peer_caps) ||
+      gst_jpeg_dec_caps_accept_size (peer_caps, width, height)) {
+    if (!gst_video_peer_query_preferred_size (srcpad, &pref_width,
+            &pref_height))
+      goto done;
+
+    for (denom = 2; denom <= 8; denom *= 2) {
+      gint w = (width + denom - 1) / denom;
+      gint h = (height + denom - 1) / denom;
+
+      if (w < pref_width || h < pref_height)
+        break;
+      if (gst_caps_is_any (peer_caps) ||
+          gst_jpeg_dec_caps_accept_size (peer_caps, w, h))
+        ret = denom;
+    }
+
+    GST_DEBUG_OBJECT (dec, "downstream prefers %dx%d, decoding at 1/%u size",
+        pref_width, pref_height, ret);
+    goto done;
+  }
+
+  for (denom = 2; denom <= 8; denom *= 2) {
+    if (gst_jpeg_dec_caps_accept_size (peer_caps, (width + denom - 1) / denom,
+            (height + denom - 1) / denom)) {
+      GST_DEBUG_OBJECT (dec, "downstream accepts 1/%u scaled size", denom);
+      ret = denom;
+      break;
+    }
+  }
+
+done:
+  gst_caps_unref (peer_caps);
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_jpeg_dec_prepare_decode (GstJpegDec * dec)
 {
@@ -1188,6 +1347,8 @@ gst_jpeg_dec_prepare_decode (GstJpegDec * dec)
   dec->cinfo.do_fancy_upsampling = FALSE;
   dec->cinfo.do_block_smoothing = FALSE;
   dec->cinfo.dct_method = dec->idct_method;
+  dec->cinfo.scale_num = 1;
+  dec->cinfo.scale_denom = gst_jpeg_dec_get_scale_denom (dec);
 #ifdef JCS_EXTENSIONS
   gst_jpeg_turbo_parse_ext_fmt_convert (dec, NULL);
   if (dec->format_convert) {
@@ -1197,7 +1358,7 @@ gst_jpeg_dec_prepare_decode (GstJpegDec * dec)
 #endif
   {
     dec->cinfo.out_color_space = dec->cinfo.jpeg_color_space;
-    dec->cinfo.raw_data_out = TRUE;
+    dec->cinfo.raw_data_out = (dec->cinfo.scale_denom == 1);
   }
 
   GST_LOG_OBJECT (dec, "starting decompress");
@@ -1284,7 +1445,13 @@ gst_jpeg_dec_decode (GstJpegDec * dec, GstVideoFrame * vframe, guint width,
 {
   GstFlowReturn ret = GST_FLOW_OK;
 
-  if (dec->cinfo.jpeg_color_space == JCS_RGB) {
+  if (!dec->cinfo.raw_data_out
+#ifdef JCS_EXTENSIONS
+      && !dec->format_convert
+#endif
+      ) {
+    gst_jpeg_dec_decode_scaled (dec, vframe, field, num_fields);
+  } else if (dec->cinfo.jpeg_color_space == JCS_RGB) {
     gst_jpeg_dec_decode_rgb (dec, vframe, field, num_fields);
   } else if (dec->cinfo.jpeg_color_space == JCS_GRAYSCALE) {
     gst_jpeg_dec_decode_grayscale (dec, vframe, field, num_fields);
@@ -1686,6 +1853,9 @@ gst_jpeg_dec_set_property (GObject * object, guint prop_id,
       g_atomic_int_set (&dec->max_errors, g_value_get_int (value));
       break;
 #endif
+    case PROP_DCT_SCALING:
+      g_atomic_int_set (&dec->dct_scaling, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1709,6 +1879,9 @@ gst_jpeg_dec_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_int (value, g_atomic_int_get (&dec->max_errors));
       break;
 #endif
+    case PROP_DCT_SCALING:
+      g_value_set_boolean (value, g_atomic_int_get (&dec->dct_scaling));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
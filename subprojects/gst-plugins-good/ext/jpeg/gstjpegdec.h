@@ -89,6 +89,7 @@ struct _GstJpegDec {
   /* properties */
   gint     idct_method;
   gint     max_errors;  /* ATOMIC */
+  gboolean dct_scaling; /* ATOMIC */
 
   struct jpeg_decompress_struct cinfo;
   struct GstJpegDecErrorMgr     jerr;
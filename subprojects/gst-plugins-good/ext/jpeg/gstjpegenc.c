@@ -56,6 +56,10 @@ GST_DEBUG_CATEGORY_STATIC (jpegenc_debug);
 #define JPEG_DEFAULT_SMOOTHING 0
 #define JPEG_DEFAULT_IDCT_METHOD	JDCT_FASTEST
 #define JPEG_DEFAULT_SNAPSHOT		FALSE
+#define JPEG_DEFAULT_MAX_THREADS	1
+
+/* Minimum number of MCU rows per slice when slice-threading */
+#define MIN_SLICE_MCU_ROWS 8
 
 /* JpegEnc signals and args */
 enum
@@ -70,12 +74,42 @@ enum
   PROP_QUALITY,
   PROP_SMOOTHING,
   PROP_IDCT_METHOD,
-  PROP_SNAPSHOT
+  PROP_SNAPSHOT,
+  PROP_MAX_THREADS
+};
+
+/* One horizontal band of the image, encoded with its own libjpeg context
+ * into a complete JPEG image. The entropy coded segments of all slices are
+ * then joined with restart markers into a single image. */
+struct _GstJpegEncSlice
+{
+  GstJpegEnc *jpegenc;
+
+  struct jpeg_compress_struct cinfo;
+  struct jpeg_error_mgr jerr;
+  struct jpeg_destination_mgr jdest;
+
+  /* the jpeg line buffer */
+  guchar **line[3];
+  /* indirect encoding line buffers */
+  guchar *row[3][4 * DCTSIZE];
+
+  /* first line of the slice in the input frame */
+  gint first_line;
+  guchar *base[3], *end[3];
+  guint stride[3];
+
+  /* encoded image of the slice and offset of its entropy coded data */
+  guint8 *data;
+  gsize size;
+  gsize len;
+  gsize scan;
 };
 
 static void gst_jpegenc_finalize (GObject * object);
 
 static void gst_jpegenc_resync (GstJpegEnc * jpegenc);
+static void gst_jpegenc_free_slices (GstJpegEnc * jpegenc);
 static void gst_jpegenc_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
 static void gst_jpegenc_get_property (GObject * object, guint prop_id,
@@ -167,6 +201,23 @@ gst_jpegenc_class_init (GstJpegEncClass * klass)
           "Send EOS after encoding a frame, useful for snapshots",
           JPEG_DEFAULT_SNAPSHOT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstJpegEnc:max-threads:
+   *
+   * Maximum number of threads to split the encoding of each frame between
+   * (0 = auto). With more than one thread the frame is encoded in
+   * horizontal slices that are separated by restart markers.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_uint ("max-threads", "Max Threads",
+          "Maximum number of threads to encode each frame with, using "
+          "restart markers between slices (0 = auto)", 0, G_MAXINT,
+          JPEG_DEFAULT_MAX_THREADS,
+          GST_PARAM_MUTABLE_READY | G_PARAM_READWRITE |
+          G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (element_class,
       &gst_jpegenc_sink_pad_template);
   gst_element_class_add_static_pad_template (element_class,
@@ -243,19 +294,16 @@ gst_jpegenc_flush_destination (j_compress_ptr cinfo)
   return TRUE;
 }
 
+/* Pushes the first @memory_size bytes of the output memory downstream */
 static void
-gst_jpegenc_term_destination (j_compress_ptr cinfo)
+gst_jpegenc_finish_output (GstJpegEnc * jpegenc, gsize memory_size)
 {
   GstBuffer *outbuf;
-  GstJpegEnc *jpegenc = (GstJpegEnc *) (cinfo->client_data);
-  gsize memory_size = jpegenc->output_map.size - jpegenc->jdest.free_in_buffer;
   GstByteReader reader =
       GST_BYTE_READER_INIT (jpegenc->output_map.data, memory_size);
   guint16 marker;
   gint sof_marker = -1;
 
-  GST_DEBUG_OBJECT (jpegenc, "gst_jpegenc_chain: term_source");
-
   /* Find the SOF marker */
   while (gst_byte_reader_get_uint16_be (&reader, &marker)) {
     /* SOF marker */
@@ -297,6 +345,41 @@ gst_jpegenc_term_destination (j_compress_ptr cinfo)
   jpegenc->current_frame = NULL;
 }
 
+static void
+gst_jpegenc_term_destination (j_compress_ptr cinfo)
+{
+  GstJpegEnc *jpegenc = (GstJpegEnc *) (cinfo->client_data);
+
+  GST_DEBUG_OBJECT (jpegenc, "gst_jpegenc_chain: term_source");
+
+  gst_jpegenc_finish_output (jpegenc,
+      jpegenc->output_map.size - jpegenc->jdest.free_in_buffer);
+}
+
+static boolean
+gst_jpegenc_slice_flush_destination (j_compress_ptr cinfo)
+{
+  GstJpegEncSlice *slice = (GstJpegEncSlice *) (cinfo->client_data);
+  gsize old_size = slice->size;
+
+  /* The whole buffer was filled, make it twice as big */
+  slice->size *= 2;
+  slice->data = g_realloc (slice->data, slice->size);
+
+  slice->jdest.next_output_byte = slice->data + old_size;
+  slice->jdest.free_in_buffer = slice->size - old_size;
+
+  return TRUE;
+}
+
+static void
+gst_jpegenc_slice_term_destination (j_compress_ptr cinfo)
+{
+  GstJpegEncSlice *slice = (GstJpegEncSlice *) (cinfo->client_data);
+
+  slice->len = slice->size - slice->jdest.free_in_buffer;
+}
+
 static void
 gst_jpegenc_init (GstJpegEnc * jpegenc)
 {
@@ -319,6 +402,7 @@ gst_jpegenc_init (GstJpegEnc * jpegenc)
   jpegenc->smoothing = JPEG_DEFAULT_SMOOTHING;
   jpegenc->idct_method = JPEG_DEFAULT_IDCT_METHOD;
   jpegenc->snapshot = JPEG_DEFAULT_SNAPSHOT;
+  jpegenc->max_threads = JPEG_DEFAULT_MAX_THREADS;
 }
 
 static void
@@ -327,6 +411,7 @@ gst_jpegenc_finalize (GObject * object)
   GstJpegEnc *filter = GST_JPEGENC (object);
 
   jpeg_destroy_compress (&filter->cinfo);
+  gst_jpegenc_free_slices (filter);
 
   if (filter->input_state)
     gst_video_codec_state_unref (filter->input_state);
@@ -384,12 +469,151 @@ gst_jpegenc_set_format (GstVideoEncoder * encoder, GstVideoCodecState * state)
   return TRUE;
 }
 
+static void
+gst_jpegenc_setup_cinfo (GstJpegEnc * jpegenc, j_compress_ptr cinfo,
+    gint height, guchar ** line[3], guchar * row[3][4 * DCTSIZE])
+{
+  GstVideoInfo *info = &jpegenc->input_state->info;
+  gint width = GST_VIDEO_INFO_WIDTH (info);
+  gint i, j;
+
+  cinfo->image_width = width;
+  cinfo->image_height = height;
+  cinfo->input_components = jpegenc->channels;
+
+  if (GST_VIDEO_INFO_IS_RGB (info)) {
+    cinfo->in_color_space = JCS_RGB;
+  } else if (GST_VIDEO_INFO_IS_GRAY (info)) {
+    cinfo->in_color_space = JCS_GRAYSCALE;
+  } else {
+    cinfo->in_color_space = JCS_YCbCr;
+  }
+
+  jpeg_set_defaults (cinfo);
+  cinfo->raw_data_in = TRUE;
+  /* duh, libjpeg maps RGB to YUV ... and don't expect some conversion */
+  if (cinfo->in_color_space == JCS_RGB)
+    jpeg_set_colorspace (cinfo, JCS_RGB);
+
+  /* image dimension info */
+  for (i = 0; i < jpegenc->channels; i++) {
+    cinfo->comp_info[i].h_samp_factor = jpegenc->h_samp[i];
+    cinfo->comp_info[i].v_samp_factor = jpegenc->v_samp[i];
+    g_free (line[i]);
+    line[i] = g_new (guchar *, jpegenc->v_max_samp * DCTSIZE);
+    if (!jpegenc->planar) {
+      for (j = 0; j < jpegenc->v_max_samp * DCTSIZE; j++) {
+        g_free (row[i][j]);
+        row[i][j] = g_malloc (width);
+        line[i][j] = row[i][j];
+      }
+    }
+  }
+
+  jpeg_suppress_tables (cinfo, TRUE);
+}
+
+static void
+gst_jpegenc_free_slices (GstJpegEnc * jpegenc)
+{
+  guint i, j, k;
+
+  for (i = 0; i < jpegenc->n_slices; i++) {
+    GstJpegEncSlice *slice = &jpegenc->slices[i];
+
+    jpeg_destroy_compress (&slice->cinfo);
+    for (j = 0; j < 3; j++) {
+      g_free (slice->line[j]);
+      for (k = 0; k < 4 * DCTSIZE; k++)
+        g_free (slice->row[j][k]);
+    }
+    g_free (slice->data);
+  }
+  g_free (jpegenc->slices);
+  jpegenc->slices = NULL;
+  jpegenc->n_slices = 0;
+
+  if (jpegenc->slice_pool) {
+    gst_task_pool_cleanup (jpegenc->slice_pool);
+    gst_object_unref (jpegenc->slice_pool);
+    jpegenc->slice_pool = NULL;
+  }
+}
+
+static void
+gst_jpegenc_setup_slices (GstJpegEnc * jpegenc)
+{
+  GstVideoInfo *info = &jpegenc->input_state->info;
+  gint width = GST_VIDEO_INFO_WIDTH (info);
+  gint height = GST_VIDEO_INFO_HEIGHT (info);
+  guint n_threads, n_slices, i;
+  guint mcu_width, mcu_height, mcus_per_row, mcu_rows, rows_per_slice;
+
+  gst_jpegenc_free_slices (jpegenc);
+
+  GST_OBJECT_LOCK (jpegenc);
+  n_threads = jpegenc->max_threads;
+  GST_OBJECT_UNLOCK (jpegenc);
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  mcu_width = jpegenc->h_max_samp * DCTSIZE;
+  mcu_height = jpegenc->v_max_samp * DCTSIZE;
+  mcus_per_row = (width + mcu_width - 1) / mcu_width;
+  mcu_rows = (height + mcu_height - 1) / mcu_height;
+
+  n_slices = MIN (n_threads, mcu_rows / MIN_SLICE_MCU_ROWS);
+  if (n_slices <= 1)
+    return;
+
+  rows_per_slice = (mcu_rows + n_slices - 1) / n_slices;
+  /* The restart interval is stored in 16 bits */
+  rows_per_slice = MIN (rows_per_slice, G_MAXUINT16 / mcus_per_row);
+  n_slices = (mcu_rows + rows_per_slice - 1) / rows_per_slice;
+
+  GST_DEBUG_OBJECT (jpegenc, "encoding in %u slices of %u MCU rows", n_slices,
+      rows_per_slice);
+
+  jpegenc->restart_interval = rows_per_slice * mcus_per_row;
+  jpegenc->n_slices = n_slices;
+  jpegenc->slices = g_new0 (GstJpegEncSlice, n_slices);
+
+  for (i = 0; i < n_slices; i++) {
+    GstJpegEncSlice *slice = &jpegenc->slices[i];
+
+    slice->jpegenc = jpegenc;
+    slice->first_line = i * rows_per_slice * mcu_height;
+
+    slice->cinfo.err = jpeg_std_error (&slice->jerr);
+    jpeg_create_compress (&slice->cinfo);
+
+    slice->jdest.init_destination = gst_jpegenc_init_destination;
+    slice->jdest.empty_output_buffer = gst_jpegenc_slice_flush_destination;
+    slice->jdest.term_destination = gst_jpegenc_slice_term_destination;
+    slice->cinfo.dest = &slice->jdest;
+    slice->cinfo.client_data = slice;
+
+    gst_jpegenc_setup_cinfo (jpegenc, &slice->cinfo,
+        MIN (rows_per_slice * mcu_height, height - slice->first_line),
+        slice->line, slice->row);
+
+    slice->size = jpegenc->bufsize / n_slices;
+    slice->data = g_malloc (slice->size);
+  }
+
+  jpegenc->slice_pool = gst_shared_task_pool_new ();
+  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+      (jpegenc->slice_pool), n_threads);
+  gst_task_pool_prepare (jpegenc->slice_pool, NULL);
+}
+
 static void
 gst_jpegenc_resync (GstJpegEnc * jpegenc)
 {
   GstVideoInfo *info;
   gint width, height;
-  gint i, j;
+  gint i;
 
   GST_DEBUG_OBJECT (jpegenc, "resync");
 
@@ -398,60 +622,255 @@ gst_jpegenc_resync (GstJpegEnc * jpegenc)
 
   info = &jpegenc->input_state->info;
 
-  jpegenc->cinfo.image_width = width = GST_VIDEO_INFO_WIDTH (info);
-  jpegenc->cinfo.image_height = height = GST_VIDEO_INFO_HEIGHT (info);
-  jpegenc->cinfo.input_components = jpegenc->channels;
+  width = GST_VIDEO_INFO_WIDTH (info);
+  height = GST_VIDEO_INFO_HEIGHT (info);
 
   GST_DEBUG_OBJECT (jpegenc, "width %d, height %d", width, height);
   GST_DEBUG_OBJECT (jpegenc, "format %d", GST_VIDEO_INFO_FORMAT (info));
 
   if (GST_VIDEO_INFO_IS_RGB (info)) {
     GST_DEBUG_OBJECT (jpegenc, "RGB");
-    jpegenc->cinfo.in_color_space = JCS_RGB;
   } else if (GST_VIDEO_INFO_IS_GRAY (info)) {
     GST_DEBUG_OBJECT (jpegenc, "gray");
-    jpegenc->cinfo.in_color_space = JCS_GRAYSCALE;
   } else {
     GST_DEBUG_OBJECT (jpegenc, "YUV");
-    jpegenc->cinfo.in_color_space = JCS_YCbCr;
   }
 
   /* input buffer size as max output */
   jpegenc->bufsize = GST_VIDEO_INFO_SIZE (info);
-  jpeg_set_defaults (&jpegenc->cinfo);
-  jpegenc->cinfo.raw_data_in = TRUE;
-  /* duh, libjpeg maps RGB to YUV ... and don't expect some conversion */
-  if (jpegenc->cinfo.in_color_space == JCS_RGB)
-    jpeg_set_colorspace (&jpegenc->cinfo, JCS_RGB);
 
   GST_DEBUG_OBJECT (jpegenc, "h_max_samp=%d, v_max_samp=%d",
       jpegenc->h_max_samp, jpegenc->v_max_samp);
-  /* image dimension info */
   for (i = 0; i < jpegenc->channels; i++) {
     GST_DEBUG_OBJECT (jpegenc, "comp %i: h_samp=%d, v_samp=%d", i,
         jpegenc->h_samp[i], jpegenc->v_samp[i]);
-    jpegenc->cinfo.comp_info[i].h_samp_factor = jpegenc->h_samp[i];
-    jpegenc->cinfo.comp_info[i].v_samp_factor = jpegenc->v_samp[i];
-    g_free (jpegenc->line[i]);
-    jpegenc->line[i] = g_new (guchar *, jpegenc->v_max_samp * DCTSIZE);
-    if (!jpegenc->planar) {
-      for (j = 0; j < jpegenc->v_max_samp * DCTSIZE; j++) {
-        g_free (jpegenc->row[i][j]);
-        jpegenc->row[i][j] = g_malloc (width);
-        jpegenc->line[i][j] = jpegenc->row[i][j];
-      }
-    }
   }
 
+  gst_jpegenc_setup_cinfo (jpegenc, &jpegenc->cinfo, height, jpegenc->line,
+      jpegenc->row);
+
   /* guard against a potential error in gst_jpegenc_term_destination
      which occurs iff bufsize % 4 < free_space_remaining */
   jpegenc->bufsize = GST_ROUND_UP_4 (jpegenc->bufsize);
 
-  jpeg_suppress_tables (&jpegenc->cinfo, TRUE);
+  gst_jpegenc_setup_slices (jpegenc);
 
   GST_DEBUG_OBJECT (jpegenc, "resync done");
 }
 
+static void
+gst_jpegenc_configure (GstJpegEnc * jpegenc, j_compress_ptr cinfo)
+{
+  /* prepare for raw input */
+#if JPEG_LIB_VERSION >= 70
+  cinfo->do_fancy_downsampling = FALSE;
+#endif
+
+  GST_OBJECT_LOCK (jpegenc);
+  cinfo->smoothing_factor = jpegenc->smoothing;
+  cinfo->dct_method = jpegenc->idct_method;
+  jpeg_set_quality (cinfo, jpegenc->quality, TRUE);
+  GST_OBJECT_UNLOCK (jpegenc);
+}
+
+static void
+gst_jpegenc_write_lines (GstJpegEnc * jpegenc, j_compress_ptr cinfo,
+    guchar ** line[3], guchar * base[3], guchar * end[3], guint stride[3],
+    guint height)
+{
+  guint i;
+  gint j, k;
+
+  if (jpegenc->planar) {
+    for (i = 0; i < height; i += jpegenc->v_max_samp * DCTSIZE) {
+      for (k = 0; k < jpegenc->channels; k++) {
+        for (j = 0; j < jpegenc->v_samp[k] * DCTSIZE; j++) {
+          line[k][j] = base[k];
+          if (base[k] + stride[k] < end[k])
+            base[k] += stride[k];
+        }
+      }
+      jpeg_write_raw_data (cinfo, line, jpegenc->v_max_samp * DCTSIZE);
+    }
+  } else {
+    for (i = 0; i < height; i += jpegenc->v_max_samp * DCTSIZE) {
+      for (k = 0; k < jpegenc->channels; k++) {
+        for (j = 0; j < jpegenc->v_samp[k] * DCTSIZE; j++) {
+          guchar *src, *dst;
+          gint l;
+
+          /* ouch, copy line */
+          src = base[k];
+          dst = line[k][j];
+          for (l = jpegenc->cwidth[k]; l > 0; l--) {
+            *dst = *src;
+            src += jpegenc->inc[k];
+            dst++;
+          }
+          if (base[k] + stride[k] < end[k])
+            base[k] += stride[k];
+        }
+      }
+      jpeg_write_raw_data (cinfo, line, jpegenc->v_max_samp * DCTSIZE);
+    }
+  }
+}
+
+static void
+gst_jpegenc_encode_slice (GstJpegEncSlice * slice)
+{
+  slice->jdest.next_output_byte = slice->data;
+  slice->jdest.free_in_buffer = slice->size;
+
+  jpeg_start_compress (&slice->cinfo, TRUE);
+  gst_jpegenc_write_lines (slice->jpegenc, &slice->cinfo, slice->line,
+      slice->base, slice->end, slice->stride, slice->cinfo.image_height);
+  jpeg_finish_compress (&slice->cinfo);
+}
+
+static void
+gst_jpegenc_encode_slices (GstJpegEnc * jpegenc, guchar * base[3],
+    guchar * end[3], guint stride[3])
+{
+  gpointer *tasks;
+  guint i;
+  gint k;
+
+  tasks = g_newa (gpointer, jpegenc->n_slices);
+
+  for (i = 0; i < jpegenc->n_slices; i++) {
+    GstJpegEncSlice *slice = &jpegenc->slices[i];
+
+    gst_jpegenc_configure (jpegenc, &slice->cinfo);
+
+    for (k = 0; k < jpegenc->channels; k++) {
+      slice->base[k] = base[k] + (slice->first_line * jpegenc->v_samp[k] /
+          jpegenc->v_max_samp) * stride[k];
+      slice->end[k] = end[k];
+      slice->stride[k] = stride[k];
+    }
+  }
+
+  for (i = 1; i < jpegenc->n_slices; i++) {
+    tasks[i] = gst_task_pool_push (jpegenc->slice_pool,
+        (GstTaskPoolFunction) gst_jpegenc_encode_slice, &jpegenc->slices[i],
+        NULL);
+    /* Only returns NULL if the pool was not prepared */
+    g_assert (tasks[i] != NULL);
+  }
+
+  gst_jpegenc_encode_slice (&jpegenc->slices[0]);
+
+  for (i = 1; i < jpegenc->n_slices; i++)
+    gst_task_pool_join (jpegenc->slice_pool, tasks[i]);
+}
+
+/* Finds the SOF and SOS markers and the start of the entropy coded data */
+static gboolean
+gst_jpegenc_find_scan (const guint8 * data, gsize size, gsize * sof,
+    gsize * sos, gsize * scan)
+{
+  GstByteReader reader = GST_BYTE_READER_INIT (data, size);
+  guint8 prefix, marker;
+  guint16 len;
+
+  /* SOI */
+  if (!gst_byte_reader_skip (&reader, 2))
+    return FALSE;
+
+  while (gst_byte_reader_get_uint8 (&reader, &prefix) && prefix == 0xff &&
+      gst_byte_reader_get_uint8 (&reader, &marker) &&
+      gst_byte_reader_get_uint16_be (&reader, &len) && len >= 2) {
+    gsize pos = gst_byte_reader_get_pos (&reader) - 4;
+
+    if (marker >= 0xc0 && marker <= 0xcf && marker != 0xc4 && marker != 0xc8
+        && marker != 0xcc)
+      *sof = pos;
+
+    if (marker == 0xda) {
+      *sos = pos;
+      *scan = pos + 2 + len;
+      /* the scan is followed by the EOI marker */
+      return *scan + 2 <= size;
+    }
+
+    if (!gst_byte_reader_skip (&reader, len - 2))
+      return FALSE;
+  }
+
+  return FALSE;
+}
+
+/* Joins the slices into one image. The headers of the first slice are used
+ * with the height of the full image and a DRI marker, followed by the
+ * entropy coded data of all slices separated by RSTn markers. Each slice
+ * starts with fresh DC predictions and ends byte aligned, exactly what a
+ * decoder expects after a restart marker. */
+static gboolean
+gst_jpegenc_assemble_slices (GstJpegEnc * jpegenc, gsize * memory_size)
+{
+  GstJpegEncSlice *first = &jpegenc->slices[0];
+  static GstAllocationParams params = { 0, 0, 0, 3, };
+  gsize sof = 0, sos, scan, size;
+  guint8 *p;
+  guint i;
+
+  if (!gst_jpegenc_find_scan (first->data, first->len, &sof, &sos, &scan)
+      || sof == 0)
+    return FALSE;
+
+  /* headers, DRI and EOI */
+  size = scan + 6 + 2;
+  for (i = 0; i < jpegenc->n_slices; i++) {
+    GstJpegEncSlice *slice = &jpegenc->slices[i];
+    gsize slice_sof, slice_sos;
+
+    if (!gst_jpegenc_find_scan (slice->data, slice->len, &slice_sof,
+            &slice_sos, &slice->scan))
+      return FALSE;
+
+    /* RSTn and entropy coded data without EOI */
+    size += (i > 0 ? 2 : 0) + slice->len - 2 - slice->scan;
+  }
+
+  jpegenc->output_mem = gst_allocator_alloc (NULL, size, &params);
+  gst_memory_map (jpegenc->output_mem, &jpegenc->output_map, GST_MAP_READWRITE);
+  p = jpegenc->output_map.data;
+
+  memcpy (p, first->data, sos);
+  GST_WRITE_UINT16_BE (p + sof + 5, jpegenc->cinfo.image_height);
+  p += sos;
+
+  p[0] = 0xff;
+  p[1] = 0xdd;
+  GST_WRITE_UINT16_BE (p + 2, 4);
+  GST_WRITE_UINT16_BE (p + 4, jpegenc->restart_interval);
+  p += 6;
+
+  memcpy (p, first->data + sos, scan - sos);
+  p += scan - sos;
+
+  for (i = 0; i < jpegenc->n_slices; i++) {
+    GstJpegEncSlice *slice = &jpegenc->slices[i];
+    gsize len = slice->len - 2 - slice->scan;
+
+    if (i > 0) {
+      p[0] = 0xff;
+      p[1] = 0xd0 + ((i - 1) & 7);
+      p += 2;
+    }
+    memcpy (p, slice->data + slice->scan, len);
+    p += len;
+  }
+
+  p[0] = 0xff;
+  p[1] = 0xd9;
+
+  *memory_size = size;
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_jpegenc_handle_frame (GstVideoEncoder * encoder, GstVideoCodecFrame * frame)
 {
@@ -459,7 +878,7 @@ gst_jpegenc_handle_frame (GstVideoEncoder * encoder, GstVideoCodecFrame * frame)
   guint height;
   guchar *base[3], *end[3];
   guint stride[3];
-  gint i, j, k;
+  gint i;
   static GstAllocationParams params = { 0, 0, 0, 3, };
 
   jpegenc = GST_JPEGENC (encoder);
@@ -483,62 +902,36 @@ gst_jpegenc_handle_frame (GstVideoEncoder * encoder, GstVideoCodecFrame * frame)
   }
 
   jpegenc->res = GST_FLOW_OK;
+
+  if (jpegenc->n_slices > 1) {
+    gsize memory_size;
+
+    GST_LOG_OBJECT (jpegenc, "compressing %u slices", jpegenc->n_slices);
+
+    gst_jpegenc_encode_slices (jpegenc, base, end, stride);
+    if (!gst_jpegenc_assemble_slices (jpegenc, &memory_size))
+      goto assemble_failed;
+    gst_jpegenc_finish_output (jpegenc, memory_size);
+
+    GST_LOG_OBJECT (jpegenc, "compressing done");
+
+    return (jpegenc->snapshot) ? GST_FLOW_EOS : jpegenc->res;
+  }
+
   jpegenc->output_mem = gst_allocator_alloc (NULL, jpegenc->bufsize, &params);
   gst_memory_map (jpegenc->output_mem, &jpegenc->output_map, GST_MAP_READWRITE);
 
   jpegenc->jdest.next_output_byte = jpegenc->output_map.data;
   jpegenc->jdest.free_in_buffer = jpegenc->output_map.size;
 
-  /* prepare for raw input */
-#if JPEG_LIB_VERSION >= 70
-  jpegenc->cinfo.do_fancy_downsampling = FALSE;
-#endif
-
-  GST_OBJECT_LOCK (jpegenc);
-  jpegenc->cinfo.smoothing_factor = jpegenc->smoothing;
-  jpegenc->cinfo.dct_method = jpegenc->idct_method;
-  jpeg_set_quality (&jpegenc->cinfo, jpegenc->quality, TRUE);
-  GST_OBJECT_UNLOCK (jpegenc);
+  gst_jpegenc_configure (jpegenc, &jpegenc->cinfo);
 
   jpeg_start_compress (&jpegenc->cinfo, TRUE);
 
   GST_LOG_OBJECT (jpegenc, "compressing");
 
-  if (jpegenc->planar) {
-    for (i = 0; i < height; i += jpegenc->v_max_samp * DCTSIZE) {
-      for (k = 0; k < jpegenc->channels; k++) {
-        for (j = 0; j < jpegenc->v_samp[k] * DCTSIZE; j++) {
-          jpegenc->line[k][j] = base[k];
-          if (base[k] + stride[k] < end[k])
-            base[k] += stride[k];
-        }
-      }
-      jpeg_write_raw_data (&jpegenc->cinfo, jpegenc->line,
-          jpegenc->v_max_samp * DCTSIZE);
-    }
-  } else {
-    for (i = 0; i < height; i += jpegenc->v_max_samp * DCTSIZE) {
-      for (k = 0; k < jpegenc->channels; k++) {
-        for (j = 0; j < jpegenc->v_samp[k] * DCTSIZE; j++) {
-          guchar *src, *dst;
-          gint l;
-
-          /* ouch, copy line */
-          src = base[k];
-          dst = jpegenc->line[k][j];
-          for (l = jpegenc->cwidth[k]; l > 0; l--) {
-            *dst = *src;
-            src += jpegenc->inc[k];
-            dst++;
-          }
-          if (base[k] + stride[k] < end[k])
-            base[k] += stride[k];
-        }
-      }
-      jpeg_write_raw_data (&jpegenc->cinfo, jpegenc->line,
-          jpegenc->v_max_samp * DCTSIZE);
-    }
-  }
+  gst_jpegenc_write_lines (jpegenc, &jpegenc->cinfo, jpegenc->line, base, end,
+      stride, height);
 
   /* This will ensure that gst_jpegenc_term_destination is called */
   jpeg_finish_compress (&jpegenc->cinfo);
@@ -551,6 +944,14 @@ invalid_frame:
     GST_WARNING_OBJECT (jpegenc, "invalid frame received");
     return gst_video_encoder_finish_frame (encoder, frame);
   }
+assemble_failed:
+  {
+    gst_video_frame_unmap (&jpegenc->current_vframe);
+    jpegenc->current_frame = NULL;
+    GST_ELEMENT_ERROR (jpegenc, STREAM, ENCODE, (NULL),
+        ("Failed to assemble the encoded slices"));
+    return GST_FLOW_ERROR;
+  }
 }
 
 static gboolean
@@ -585,6 +986,9 @@ gst_jpegenc_set_property (GObject * object, guint prop_id,
     case PROP_SNAPSHOT:
       jpegenc->snapshot = g_value_get_boolean (value);
       break;
+    case PROP_MAX_THREADS:
+      jpegenc->max_threads = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -616,6 +1020,9 @@ gst_jpegenc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_SNAPSHOT:
       g_value_set_boolean (value, jpegenc->snapshot);
       break;
+    case PROP_MAX_THREADS:
+      g_value_set_uint (value, jpegenc->max_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -656,5 +1063,7 @@ gst_jpegenc_stop (GstVideoEncoder * benc)
     }
   }
 
+  gst_jpegenc_free_slices (enc);
+
   return TRUE;
 }
@@ -48,6 +48,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstJpegEnc GstJpegEnc;
 typedef struct _GstJpegEncClass GstJpegEncClass;
+typedef struct _GstJpegEncSlice GstJpegEncSlice;
 
 struct _GstJpegEnc
 {
@@ -87,6 +88,13 @@ struct _GstJpegEnc
   gint smoothing;
   gint idct_method;
   gboolean snapshot;
+  guint max_threads;
+
+  /* slice-threaded encoding */
+  GstTaskPool *slice_pool;
+  GstJpegEncSlice *slices;
+  guint n_slices;
+  guint restart_interval;
 
   GstMemory *output_mem;
   GstMapInfo output_map;
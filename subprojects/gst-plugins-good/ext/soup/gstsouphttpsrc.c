@@ -160,6 +160,71 @@ gst_soup_session_class_init (GstSoupSessionClass * klass)
   gclass->finalize = gst_soup_session_finalize;
 }
 
+/* Process-wide session used by all the elements that have the pooled-session
+ * property set, whatever pipeline they are in. It is kept for a while after
+ * its last user went away, so that short-lived elements created in a row can
+ * reuse its warm connections (and multiplex over them with HTTP/2 when
+ * using libsoup 3) instead of paying the TCP and TLS handshakes each time */
+#define SESSION_POOL_IDLE_TIMEOUT (30 * G_TIME_SPAN_SECOND)
+
+static GMutex session_pool_lock;
+static GstSoupSession *session_pool;
+static guint session_pool_users;
+static gint64 session_pool_idle_since;
+
+static GstSoupSession *
+gst_soup_session_pool_acquire (void)
+{
+  GstSoupSession *sess = NULL, *expired = NULL;
+
+  g_mutex_lock (&session_pool_lock);
+  if (session_pool && session_pool_users == 0 &&
+      g_get_monotonic_time () - session_pool_idle_since >
+      SESSION_POOL_IDLE_TIMEOUT) {
+    expired = session_pool;
+    session_pool = NULL;
+  }
+
+  if (session_pool) {
+    sess = g_object_ref (session_pool);
+    session_pool_users++;
+  }
+  g_mutex_unlock (&session_pool_lock);
+
+  /* joins the session thread, don't hold the lock for that */
+  if (expired)
+    g_object_unref (expired);
+
+  return sess;
+}
+
+/* Returns FALSE if another session got pooled in the meantime */
+static gboolean
+gst_soup_session_pool_add (GstSoupSession * sess)
+{
+  gboolean ret = FALSE;
+
+  g_mutex_lock (&session_pool_lock);
+  if (session_pool == NULL) {
+    session_pool = g_object_ref (sess);
+    session_pool_users = 1;
+    ret = TRUE;
+  }
+  g_mutex_unlock (&session_pool_lock);
+
+  return ret;
+}
+
+static void
+gst_soup_session_pool_release (void)
+{
+  g_mutex_lock (&session_pool_lock);
+  g_assert (session_pool_users > 0);
+  if (--session_pool_users == 0)
+    session_pool_idle_since = g_get_monotonic_time ();
+  g_mutex_unlock (&session_pool_lock);
+}
+
 GST_DEBUG_CATEGORY_STATIC (souphttpsrc_debug);
 #define GST_CAT_DEFAULT souphttpsrc_debug
 
@@ -196,6 +261,8 @@ enum
   PROP_RETRIES,
   PROP_METHOD,
   PROP_TLS_INTERACTION,
+  PROP_POOLED_SESSION,
+  PROP_POOL_MAX_CONNS_PER_HOST,
 };
 
 #define DEFAULT_USER_AGENT           "GStreamer souphttpsrc " PACKAGE_VERSION " "
@@ -211,6 +278,8 @@ enum
 #define DEFAULT_TIMEOUT              15
 #define DEFAULT_RETRIES              3
 #define DEFAULT_SOUP_METHOD          NULL
+#define DEFAULT_POOLED_SESSION       FALSE
+#define DEFAULT_POOL_MAX_CONNS_PER_HOST 0
 
 #define GROW_BLOCKSIZE_LIMIT 1
 #define GROW_BLOCKSIZE_COUNT 1
@@ -497,6 +566,41 @@ gst_soup_http_src_class_init (GstSoupHTTPSrcClass * klass)
           "The HTTP method to use (GET, HEAD, OPTIONS, etc)",
           DEFAULT_SOUP_METHOD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+ /**
+   * GstSoupHTTPSrc::pooled-session:
+   *
+   * If set to %TRUE, souphttpsrc uses a session shared by all the souphttpsrc
+   * elements of the process that have this property set, instead of only the
+   * ones of the same pipeline. Connections, including their TLS state, are
+   * kept alive in that session for a while after the last element stopped
+   * using it so that new elements connecting to the same servers can reuse
+   * them. As with sessions shared through #GstContext, this only applies to
+   * elements that use the default timeout, TLS and proxy settings and no
+   * cookies.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_POOLED_SESSION,
+      g_param_spec_boolean ("pooled-session", "Pooled session",
+          "Use a session shared by the whole process", DEFAULT_POOLED_SESSION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+ /**
+   * GstSoupHTTPSrc::pool-max-conns-per-host:
+   *
+   * Maximum number of connections the pooled session opens to a single
+   * server, which limits the number of requests in flight towards it over
+   * HTTP/1.1. Only used by the element creating the pooled session.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_POOL_MAX_CONNS_PER_HOST,
+      g_param_spec_uint ("pool-max-conns-per-host",
+          "Pool maximum connections per host",
+          "Maximum number of connections per host of the pooled session "
+          "(0 = unlimited)", 0, G_MAXINT, DEFAULT_POOL_MAX_CONNS_PER_HOST,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &srctemplate);
 
   gst_element_class_set_static_metadata (gstelement_class, "HTTP client source",
@@ -582,6 +686,8 @@ gst_soup_http_src_init (GstSoupHTTPSrc * src)
   src->tls_interaction = DEFAULT_TLS_INTERACTION;
   src->max_retries = DEFAULT_RETRIES;
   src->method = DEFAULT_SOUP_METHOD;
+  src->pooled_session = DEFAULT_POOLED_SESSION;
+  src->pool_max_conns_per_host = DEFAULT_POOL_MAX_CONNS_PER_HOST;
   src->minimum_blocksize = gst_base_src_get_blocksize (GST_BASE_SRC_CAST (src));
   proxy = g_getenv ("http_proxy");
   if (!gst_soup_http_src_set_proxy (src, proxy)) {
@@ -754,6 +860,12 @@ gst_soup_http_src_set_property (GObject * object, guint prop_id,
       g_free (src->method);
       src->method = g_value_dup_string (value);
       break;
+    case PROP_POOLED_SESSION:
+      src->pooled_session = g_value_get_boolean (value);
+      break;
+    case PROP_POOL_MAX_CONNS_PER_HOST:
+      src->pool_max_conns_per_host = g_value_get_uint (value);
+      break;
     case PROP_SSL_CA_FILE:
       if (gst_soup_loader_get_api_version () == 2) {
         g_free (src->ssl_ca_file);
@@ -849,6 +961,12 @@ gst_soup_http_src_get_property (GObject * object, guint prop_id,
     case PROP_METHOD:
       g_value_set_string (value, src->method);
       break;
+    case PROP_POOLED_SESSION:
+      g_value_set_boolean (value, src->pooled_session);
+      break;
+    case PROP_POOL_MAX_CONNS_PER_HOST:
+      g_value_set_uint (value, src->pool_max_conns_per_host);
+      break;
     case PROP_SSL_CA_FILE:
       if (gst_soup_loader_get_api_version () == 2)
         g_value_set_string (value, src->ssl_ca_file);
@@ -984,9 +1102,13 @@ thread_func (gpointer user_data)
   GstSoupHTTPSrc *src = user_data;
   GstSoupSession *session = src->session;
   GMainContext *ctx;
+  gint max_conns_per_host = src->session_is_shared ? G_MAXINT : 2;
 
   GST_DEBUG_OBJECT (src, "thread start");
 
+  if (src->session_is_pooled && src->pool_max_conns_per_host > 0)
+    max_conns_per_host = src->pool_max_conns_per_host;
+
   ctx = g_main_loop_get_context (session->loop);
 
   g_main_context_push_thread_default (ctx);
@@ -999,7 +1121,7 @@ thread_func (gpointer user_data)
       "timeout", src->timeout, "tls-interaction", src->tls_interaction,
       /* Unset the limit the number of maximum allowed connections */
       "max-conns", src->session_is_shared ? G_MAXINT : 10,
-      "max-conns-per-host", src->session_is_shared ? G_MAXINT : 2, NULL);
+      "max-conns-per-host", max_conns_per_host, NULL);
   g_assert (session->session);
 
   if (gst_soup_loader_get_api_version () == 3) {
@@ -1139,6 +1261,7 @@ gst_soup_http_src_session_open (GstSoupHTTPSrc * src)
   GST_OBJECT_LOCK (src);
 
   src->session_is_shared = can_share;
+  src->session_is_pooled = FALSE;
 
   if (src->external_session && can_share) {
     GST_DEBUG_OBJECT (src, "Using external session %p", src->external_session);
@@ -1148,6 +1271,15 @@ gst_soup_http_src_session_open (GstSoupHTTPSrc * src)
       g_signal_connect (src->session->session, "authenticate",
           G_CALLBACK (gst_soup_http_src_authenticate_cb_2), src);
     }
+  } else if (can_share && src->pooled_session
+      && (src->session = gst_soup_session_pool_acquire ())) {
+    GST_DEBUG_OBJECT (src, "Using pooled session %p", src->session);
+    src->session_is_pooled = TRUE;
+    /* for soup2, connect another authenticate handler; see thread_func */
+    if (gst_soup_loader_get_api_version () < 3) {
+      g_signal_connect (src->session->session, "authenticate",
+          G_CALLBACK (gst_soup_http_src_authenticate_cb_2), src);
+    }
   } else {
     GMainContext *ctx;
     GSource *source;
@@ -1159,6 +1291,10 @@ gst_soup_http_src_session_open (GstSoupHTTPSrc * src)
 
     GST_DEBUG_OBJECT (src, "Created session %p", src->session);
 
+    /* Only the session settings matter from here on, so it's fine if
+     * another element gets the pooled session before our thread is up */
+    src->session_is_pooled = can_share && src->pooled_session;
+
     ctx = g_main_context_new ();
 
     src->session->loop = g_main_loop_new (ctx, FALSE);
@@ -1181,6 +1317,9 @@ gst_soup_http_src_session_open (GstSoupHTTPSrc * src)
     while (!g_main_loop_is_running (src->session->loop))
       g_cond_wait (&src->session_cond, &src->session_mutex);
     GST_DEBUG_OBJECT (src, "Soup thread started");
+
+    if (src->session_is_pooled)
+      src->session_is_pooled = gst_soup_session_pool_add (src->session);
   }
 
   GST_OBJECT_UNLOCK (src);
@@ -1205,6 +1344,7 @@ gst_soup_http_src_session_open (GstSoupHTTPSrc * src)
 
 err:
   g_clear_object (&src->session);
+  src->session_is_pooled = FALSE;
   GST_ELEMENT_ERROR (src, LIBRARY, INIT, (NULL), ("Failed to create session"));
   GST_OBJECT_UNLOCK (src);
 
@@ -1267,6 +1407,11 @@ gst_soup_http_src_session_close (GstSoupHTTPSrc * src)
 
   /* finally dispose of our reference from the gst thread */
   g_object_unref (sess);
+
+  if (src->session_is_pooled) {
+    gst_soup_session_pool_release ();
+    src->session_is_pooled = FALSE;
+  }
 }
 
 static void
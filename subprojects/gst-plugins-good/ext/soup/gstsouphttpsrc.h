@@ -64,6 +64,7 @@ struct _GstSoupHTTPSrc {
   gchar **cookies;             /* HTTP request cookies. */
   GstSoupSession *session;     /* Libsoup session wrapper. */
   gboolean session_is_shared;
+  gboolean session_is_pooled;  /* session is the process-wide pooled one */
   GstSoupSession *external_session; /* Shared via GstContext */
   SoupMessage *msg;            /* Request message. */
   gint retry_count;            /* Number of retries since we received data */
@@ -86,6 +87,8 @@ struct _GstSoupHTTPSrc {
                                 * handled as an error or EOS when the content
                                 * size is unknown */
   gboolean keep_alive;         /* Use keep-alive sessions */
+  gboolean pooled_session;     /* Use the process-wide session */
+  guint pool_max_conns_per_host; /* Per-host limit of the pooled session */
   gboolean ssl_strict;
   gchar *ssl_ca_file;
   gboolean ssl_use_system_ca_file;
@@ -1506,6 +1506,7 @@ gst_aac_parse_start (GstBaseParse * parse)
   GST_DEBUG ("start");
   aacparse->frame_samples = 1024;
   gst_base_parse_set_min_frame_size (GST_BASE_PARSE (aacparse), ADTS_MAX_SIZE);
+  gst_base_parse_set_max_batch_frames (parse, AUDIOPARSERS_MAX_BATCH_FRAMES);
   aacparse->sent_codec_tag = FALSE;
   aacparse->last_parsed_channels = 0;
   aacparse->last_parsed_sample_rate = 0;
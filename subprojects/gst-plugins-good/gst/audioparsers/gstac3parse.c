@@ -242,6 +242,7 @@ gst_ac3_parse_start (GstBaseParse * parse)
   GST_DEBUG_OBJECT (parse, "starting");
 
   gst_ac3_parse_reset (ac3parse);
+  gst_base_parse_set_max_batch_frames (parse, AUDIOPARSERS_MAX_BATCH_FRAMES);
 
   return TRUE;
 }
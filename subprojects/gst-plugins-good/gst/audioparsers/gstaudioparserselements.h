@@ -25,6 +25,9 @@
 
 G_BEGIN_DECLS
 
+/* frames parsed from one input buffer are pushed as a buffer list */
+#define AUDIOPARSERS_MAX_BATCH_FRAMES 32
+
 GST_ELEMENT_REGISTER_DECLARE (aacparse);
 GST_ELEMENT_REGISTER_DECLARE (amrparse);
 GST_ELEMENT_REGISTER_DECLARE (ac3parse);
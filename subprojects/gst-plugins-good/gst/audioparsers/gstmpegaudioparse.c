@@ -344,6 +344,7 @@ gst_mpeg_audio_parse_start (GstBaseParse * parse)
   GstMpegAudioParse *mp3parse = GST_MPEG_AUDIO_PARSE (parse);
 
   gst_base_parse_set_min_frame_size (GST_BASE_PARSE (mp3parse), MIN_FRAME_SIZE);
+  gst_base_parse_set_max_batch_frames (parse, AUDIOPARSERS_MAX_BATCH_FRAMES);
   GST_DEBUG_OBJECT (parse, "starting");
 
   gst_mpeg_audio_parse_reset (mp3parse);
@@ -186,10 +186,16 @@ static GstStaticPadTemplate audio_sink_factory =
 
 static void gst_avi_mux_pad_reset (GstAviPad * avipad, gboolean free);
 
-static GstFlowReturn gst_avi_mux_collect_pads (GstCollectPads * pads,
-    GstAviMux * avimux);
-static gboolean gst_avi_mux_handle_event (GstCollectPads * pad,
-    GstCollectData * data, GstEvent * event, gpointer user_data);
+static GstFlowReturn gst_avi_mux_aggregate (GstAggregator * agg,
+    gboolean timeout);
+static GstClockTime gst_avi_mux_get_next_time (GstAggregator * agg);
+static GstBuffer *gst_avi_mux_clip (GstAggregator * agg,
+    GstAggregatorPad * agg_pad, GstBuffer * buf);
+static gboolean gst_avi_mux_handle_event (GstAggregator * agg,
+    GstAggregatorPad * agg_pad, GstEvent * event);
+static gboolean gst_avi_mux_stop (GstAggregator * agg);
+static GstAggregatorPad *gst_avi_mux_create_new_pad (GstAggregator * agg,
+    GstPadTemplate * templ, const gchar * req_name, const GstCaps * caps);
 static GstPad *gst_avi_mux_request_new_pad (GstElement * element,
     GstPadTemplate * templ, const gchar * name, const GstCaps * caps);
 static void gst_avi_mux_release_pad (GstElement * element, GstPad * pad);
@@ -197,11 +203,11 @@ static void gst_avi_mux_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec);
 static void gst_avi_mux_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec);
-static GstStateChangeReturn gst_avi_mux_change_state (GstElement * element,
-    GstStateChange transition);
+
+G_DEFINE_TYPE (GstAviMuxPad, gst_avi_mux_pad, GST_TYPE_AGGREGATOR_PAD);
 
 #define gst_avi_mux_parent_class parent_class
-G_DEFINE_TYPE_WITH_CODE (GstAviMux, gst_avi_mux, GST_TYPE_ELEMENT,
+G_DEFINE_TYPE_WITH_CODE (GstAviMux, gst_avi_mux, GST_TYPE_AGGREGATOR,
     G_IMPLEMENT_INTERFACE (GST_TYPE_TAG_SETTER, NULL));
 GST_ELEMENT_REGISTER_DEFINE_WITH_CODE (avimux, "avimux", GST_RANK_PRIMARY,
     GST_TYPE_AVI_MUX, avi_element_init (plugin));
@@ -228,19 +234,29 @@ gst_avi_mux_finalize (GObject * object)
   g_free (mux->idx);
   mux->idx = NULL;
 
-  gst_object_unref (mux->collect);
-
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+static void
+gst_avi_mux_pad_class_init (GstAviMuxPadClass * klass)
+{
+}
+
+static void
+gst_avi_mux_pad_init (GstAviMuxPad * pad)
+{
+}
+
 static void
 gst_avi_mux_class_init (GstAviMuxClass * klass)
 {
   GObjectClass *gobject_class;
   GstElementClass *gstelement_class;
+  GstAggregatorClass *gstagg_class;
 
   gobject_class = (GObjectClass *) klass;
   gstelement_class = (GstElementClass *) klass;
+  gstagg_class = (GstAggregatorClass *) klass;
 
   GST_DEBUG_CATEGORY_INIT (avimux_debug, "avimux", 0, "Muxer for AVI streams");
 
@@ -256,13 +272,24 @@ gst_avi_mux_class_init (GstAviMuxClass * klass)
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_avi_mux_request_new_pad);
   gstelement_class->release_pad = GST_DEBUG_FUNCPTR (gst_avi_mux_release_pad);
-  gstelement_class->change_state = GST_DEBUG_FUNCPTR (gst_avi_mux_change_state);
 
-  gst_element_class_add_static_pad_template (gstelement_class, &src_factory);
-  gst_element_class_add_static_pad_template (gstelement_class,
-      &audio_sink_factory);
-  gst_element_class_add_static_pad_template (gstelement_class,
-      &video_sink_factory);
+  gstagg_class->aggregate = GST_DEBUG_FUNCPTR (gst_avi_mux_aggregate);
+  gstagg_class->get_next_time = GST_DEBUG_FUNCPTR (gst_avi_mux_get_next_time);
+  gstagg_class->clip = GST_DEBUG_FUNCPTR (gst_avi_mux_clip);
+  gstagg_class->sink_event = GST_DEBUG_FUNCPTR (gst_avi_mux_handle_event);
+  gstagg_class->create_new_pad = GST_DEBUG_FUNCPTR (gst_avi_mux_create_new_pad);
+  gstagg_class->stop = GST_DEBUG_FUNCPTR (gst_avi_mux_stop);
+  /* caps are fixed by the src template and set when the header is written */
+  gstagg_class->negotiate = NULL;
+
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &src_factory, GST_TYPE_AGGREGATOR_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &audio_sink_factory, GST_TYPE_AVI_MUX_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &video_sink_factory, GST_TYPE_AVI_MUX_PAD);
+
+  gst_type_mark_as_plugin_api (GST_TYPE_AVI_MUX_PAD, 0);
 
   gst_element_class_set_static_metadata (gstelement_class, "Avi muxer",
       "Codec/Muxer",
@@ -335,8 +362,8 @@ gst_avi_mux_reset (GstAviMux * avimux)
     node = node->next;
 
     gst_avi_mux_pad_reset (avipad, FALSE);
-    /* if this pad has collectdata, keep it, otherwise dump it completely */
-    if (avipad->collect)
+    /* if this pad still exists, keep it, otherwise dump it completely */
+    if (avipad->pad)
       newlist = g_slist_append (newlist, avipad);
     else {
       gst_avi_mux_pad_reset (avipad, TRUE);
@@ -344,7 +371,7 @@ gst_avi_mux_reset (GstAviMux * avimux)
     }
   }
 
-  /* free the old list of sinkpads, only keep the real collecting ones */
+  /* free the old list of sinkpads, only keep the ones still present */
   g_slist_free (avimux->sinkpads);
   avimux->sinkpads = newlist;
 
@@ -372,21 +399,9 @@ gst_avi_mux_reset (GstAviMux * avimux)
 static void
 gst_avi_mux_init (GstAviMux * avimux)
 {
-  avimux->srcpad = gst_pad_new_from_static_template (&src_factory, "src");
-  gst_pad_use_fixed_caps (avimux->srcpad);
-  gst_element_add_pad (GST_ELEMENT (avimux), avimux->srcpad);
-
   /* property */
   avimux->enable_large_avi = DEFAULT_BIGFILE;
 
-  avimux->collect = gst_collect_pads_new ();
-  gst_collect_pads_set_function (avimux->collect,
-      (GstCollectPadsFunction) (GST_DEBUG_FUNCPTR (gst_avi_mux_collect_pads)),
-      avimux);
-  gst_collect_pads_set_event_function (avimux->collect,
-      (GstCollectPadsEventFunction) (GST_DEBUG_FUNCPTR
-          (gst_avi_mux_handle_event)), avimux);
-
   /* set to clean state */
   gst_avi_mux_reset (avimux);
 }
@@ -396,7 +411,6 @@ gst_avi_mux_vidsink_set_caps (GstPad * pad, GstCaps * vscaps)
 {
   GstAviMux *avimux;
   GstAviVideoPad *avipad;
-  GstAviCollectData *collect_pad;
   GstStructure *structure;
   const gchar *mimetype;
   const GValue *fps, *par;
@@ -409,9 +423,7 @@ gst_avi_mux_vidsink_set_caps (GstPad * pad, GstCaps * vscaps)
   avimux = GST_AVI_MUX (gst_pad_get_parent (pad));
 
   /* find stream data */
-  collect_pad = (GstAviCollectData *) gst_pad_get_element_private (pad);
-  g_assert (collect_pad);
-  avipad = (GstAviVideoPad *) collect_pad->avipad;
+  avipad = (GstAviVideoPad *) GST_AVI_MUX_PAD (pad)->avipad;
   g_assert (avipad);
   g_assert (avipad->parent.is_video);
   g_assert (avipad->parent.hdr.type == GST_MAKE_FOURCC ('v', 'i', 'd', 's'));
@@ -818,7 +830,6 @@ gst_avi_mux_audsink_set_caps (GstPad * pad, GstCaps * vscaps)
 {
   GstAviMux *avimux;
   GstAviAudioPad *avipad;
-  GstAviCollectData *collect_pad;
   GstStructure *structure;
   const gchar *mimetype;
   const GValue *codec_data;
@@ -827,9 +838,7 @@ gst_avi_mux_audsink_set_caps (GstPad * pad, GstCaps * vscaps)
   avimux = GST_AVI_MUX (gst_pad_get_parent (pad));
 
   /* find stream data */
-  collect_pad = (GstAviCollectData *) gst_pad_get_element_private (pad);
-  g_assert (collect_pad);
-  avipad = (GstAviAudioPad *) collect_pad->avipad;
+  avipad = (GstAviAudioPad *) GST_AVI_MUX_PAD (pad)->avipad;
   g_assert (avipad);
   g_assert (!avipad->parent.is_video);
   g_assert (avipad->parent.hdr.type == GST_MAKE_FOURCC ('a', 'u', 'd', 's'));
@@ -1048,7 +1057,7 @@ gst_avi_mux_request_new_pad (GstElement * element,
     GstPadTemplate * templ, const gchar * req_name, const GstCaps * caps)
 {
   GstAviMux *avimux;
-  GstPad *newpad;
+  GstAviMuxPad *newpad;
   GstAviPad *avipad;
   GstElementClass *klass;
   gchar *name = NULL;
@@ -1082,8 +1091,6 @@ gst_avi_mux_request_new_pad (GstElement * element,
     avipad = g_malloc0 (sizeof (GstAviAudioPad));
     avipad->is_video = FALSE;
     avipad->hdr.type = GST_MAKE_FOURCC ('a', 'u', 'd', 's');
-    /* audio goes last */
-    avimux->sinkpads = g_slist_append (avimux->sinkpads, avipad);
   } else if (templ == gst_element_class_get_pad_template (klass, "video_%u")) {
     /* though streams are pretty generic and relatively self-contained,
      * some video info goes in a single avi header -and therefore mux struct-
@@ -1099,25 +1106,33 @@ gst_avi_mux_request_new_pad (GstElement * element,
     avipad = g_malloc0 (sizeof (GstAviVideoPad));
     avipad->is_video = TRUE;
     avipad->hdr.type = GST_MAKE_FOURCC ('v', 'i', 'd', 's');
-    /* video goes first */
-    avimux->sinkpads = g_slist_prepend (avimux->sinkpads, avipad);
   } else
     goto wrong_template;
 
-  newpad = gst_pad_new_from_template (templ, pad_name);
+  newpad = (GstAviMuxPad *)
+      GST_ELEMENT_CLASS (parent_class)->request_new_pad (element, templ,
+      pad_name, caps);
+  if (newpad == NULL || GST_OBJECT_PARENT (newpad) != GST_OBJECT (avimux))
+    goto pad_add_failed;
 
-  avipad->collect = gst_collect_pads_add_pad (avimux->collect,
-      newpad, sizeof (GstAviCollectData), NULL, TRUE);
-  ((GstAviCollectData *) (avipad->collect))->avipad = avipad;
+  newpad->avipad = avipad;
+  avipad->pad = GST_AGGREGATOR_PAD (newpad);
 
-  if (!gst_element_add_pad (element, newpad))
-    goto pad_add_failed;
+  GST_OBJECT_LOCK (avimux);
+  if (avipad->is_video) {
+    /* video goes first */
+    avimux->sinkpads = g_slist_prepend (avimux->sinkpads, avipad);
+  } else {
+    /* audio goes last */
+    avimux->sinkpads = g_slist_append (avimux->sinkpads, avipad);
+  }
+  GST_OBJECT_UNLOCK (avimux);
 
   g_free (name);
 
   GST_DEBUG_OBJECT (newpad, "Added new request pad");
 
-  return newpad;
+  return GST_PAD (newpad);
 
   /* ERRORS */
 wrong_direction:
@@ -1143,43 +1158,66 @@ too_many_video_pads:
 pad_add_failed:
   {
     GST_WARNING_OBJECT (avimux, "Adding the new pad '%s' failed", pad_name);
+    if (avipad->is_video)
+      avimux->video_pads--;
     g_free (name);
-    gst_object_unref (newpad);
+    g_free (avipad);
+    if (newpad)
+      gst_object_unref (newpad);
     return NULL;
   }
 }
 
+static GstAggregatorPad *
+gst_avi_mux_create_new_pad (GstAggregator * agg,
+    GstPadTemplate * templ, const gchar * req_name, const GstCaps * caps)
+{
+  return g_object_new (GST_TYPE_AVI_MUX_PAD, "name", req_name,
+      "direction", templ->direction, "template", templ, NULL);
+}
+
 static void
 gst_avi_mux_release_pad (GstElement * element, GstPad * pad)
 {
   GstAviMux *avimux = GST_AVI_MUX (element);
+  GstAviPad *avipad = NULL;
   GSList *node;
 
-  node = avimux->sinkpads;
-  while (node) {
-    GstAviPad *avipad = (GstAviPad *) node->data;
+  GST_OBJECT_LOCK (avimux);
+  for (node = avimux->sinkpads; node; node = node->next) {
+    GstAviPad *p = (GstAviPad *) node->data;
 
-    if (avipad->collect->pad == pad) {
-      /* pad count should not be adjusted,
-       * as it also represent number of streams present */
-      avipad->collect = NULL;
-      GST_DEBUG_OBJECT (avimux, "removed pad '%s'", GST_PAD_NAME (pad));
-      gst_collect_pads_remove_pad (avimux->collect, pad);
-      gst_element_remove_pad (element, pad);
-      /* if not started yet, we can remove any sign this pad ever existed */
-      /* in this case _start will take care of the real pad count */
-      if (avimux->write_header) {
-        avimux->sinkpads = g_slist_remove (avimux->sinkpads, avipad);
-        gst_avi_mux_pad_reset (avipad, TRUE);
-        g_free (avipad);
-      }
-      return;
+    if (p->pad == GST_AGGREGATOR_PAD (pad)) {
+      avipad = p;
+      break;
     }
+  }
 
-    node = node->next;
+  if (avipad == NULL) {
+    GST_OBJECT_UNLOCK (avimux);
+    g_warning ("Unknown pad %s", GST_PAD_NAME (pad));
+    return;
   }
 
-  g_warning ("Unknown pad %s", GST_PAD_NAME (pad));
+  /* pad count should not be adjusted,
+   * as it also represent number of streams present */
+  avipad->pad = NULL;
+  GST_AVI_MUX_PAD (pad)->avipad = NULL;
+  /* if not started yet, we can remove any sign this pad ever existed */
+  /* in this case _start will take care of the real pad count */
+  if (avimux->write_header)
+    avimux->sinkpads = g_slist_remove (avimux->sinkpads, avipad);
+  else
+    avipad = NULL;
+  GST_OBJECT_UNLOCK (avimux);
+
+  GST_DEBUG_OBJECT (avimux, "removed pad '%s'", GST_PAD_NAME (pad));
+  GST_ELEMENT_CLASS (parent_class)->release_pad (element, pad);
+
+  if (avipad) {
+    gst_avi_mux_pad_reset (avipad, TRUE);
+    g_free (avipad);
+  }
 }
 
 static inline guint
@@ -1636,7 +1674,8 @@ gst_avi_mux_write_avix_index (GstAviMux * avimux, GstAviPad * avipad,
   gst_buffer_resize (buffer, 0, size);
 
   /* send */
-  if ((res = gst_pad_push (avimux->srcpad, buffer)) != GST_FLOW_OK)
+  res = gst_aggregator_finish_buffer (GST_AGGREGATOR (avimux), buffer);
+  if (res != GST_FLOW_OK)
     return res;
 
   /* keep track of this in superindex (if room) ... */
@@ -1711,7 +1750,7 @@ gst_avi_mux_write_index (GstAviMux * avimux)
       avimux->idx_index * sizeof (gst_riff_index_entry));
   gst_buffer_unmap (buffer, &map);
 
-  res = gst_pad_push (avimux->srcpad, buffer);
+  res = gst_aggregator_finish_buffer (GST_AGGREGATOR (avimux), buffer);
   if (res != GST_FLOW_OK)
     return res;
 
@@ -1726,7 +1765,7 @@ gst_avi_mux_write_index (GstAviMux * avimux)
 
   avimux->total_data += size + 8;
 
-  res = gst_pad_push (avimux->srcpad, buffer);
+  res = gst_aggregator_finish_buffer (GST_AGGREGATOR (avimux), buffer);
   if (res != GST_FLOW_OK)
     return res;
 
@@ -1765,16 +1804,16 @@ gst_avi_mux_bigfile (GstAviMux * avimux, gboolean last)
     /* search back */
     segment.start = avimux->avix_start;
     segment.time = avimux->avix_start;
-    gst_pad_push_event (avimux->srcpad, gst_event_new_segment (&segment));
+    gst_aggregator_update_segment (GST_AGGREGATOR (avimux), &segment);
 
     /* rewrite AVIX header */
     header = gst_avi_mux_riff_get_avix_header (avimux->datax_size);
-    res = gst_pad_push (avimux->srcpad, header);
+    res = gst_aggregator_finish_buffer (GST_AGGREGATOR (avimux), header);
 
     /* go back to current location, at least try */
     segment.start = avimux->total_data;
     segment.time = avimux->total_data;
-    gst_pad_push_event (avimux->srcpad, gst_event_new_segment (&segment));
+    gst_aggregator_update_segment (GST_AGGREGATOR (avimux), &segment);
 
     if (res != GST_FLOW_OK)
       return res;
@@ -1810,7 +1849,7 @@ gst_avi_mux_bigfile (GstAviMux * avimux, gboolean last)
   /* avix_start is used as base offset for the odml index chunk */
   avimux->idx_offset = avimux->total_data - avimux->avix_start;
 
-  return gst_pad_push (avimux->srcpad, header);
+  return gst_aggregator_finish_buffer (GST_AGGREGATOR (avimux), header);
 }
 
 /* enough header blabla now, let's go on to actually writing the headers */
@@ -1865,21 +1904,14 @@ gst_avi_mux_start_file (GstAviMux * avimux)
     }
   }
 
-  /* stream-start (FIXME: create id based on input ids) */
-  {
-    gchar s_id[32];
-
-    g_snprintf (s_id, sizeof (s_id), "avimux-%08x", g_random_int ());
-    gst_pad_push_event (avimux->srcpad, gst_event_new_stream_start (s_id));
-  }
-
-  caps = gst_pad_get_pad_template_caps (avimux->srcpad);
-  gst_pad_set_caps (avimux->srcpad, caps);
+  /* stream-start is sent by the aggregator before the first buffer */
+  caps = gst_pad_get_pad_template_caps (GST_AGGREGATOR_SRC_PAD (avimux));
+  gst_aggregator_set_src_caps (GST_AGGREGATOR (avimux), caps);
   gst_caps_unref (caps);
 
   /* let downstream know we think in BYTES and expect to do seeking later on */
   gst_segment_init (&segment, GST_FORMAT_BYTES);
-  gst_pad_push_event (avimux->srcpad, gst_event_new_segment (&segment));
+  gst_aggregator_update_segment (GST_AGGREGATOR (avimux), &segment);
 
   /* header */
   avimux->avi_hdr.streams = g_slist_length (avimux->sinkpads);
@@ -1888,7 +1920,7 @@ gst_avi_mux_start_file (GstAviMux * avimux)
   header = gst_avi_mux_riff_get_avi_header (avimux);
   avimux->total_data += gst_buffer_get_size (header);
 
-  res = gst_pad_push (avimux->srcpad, header);
+  res = gst_aggregator_finish_buffer (GST_AGGREGATOR (avimux), header);
 
   avimux->idx_offset = avimux->total_data;
 
@@ -1973,18 +2005,18 @@ gst_avi_mux_stop_file (GstAviMux * avimux)
 
   /* seek and rewrite the header */
   gst_segment_init (&segment, GST_FORMAT_BYTES);
-  gst_pad_push_event (avimux->srcpad, gst_event_new_segment (&segment));
+  gst_aggregator_update_segment (GST_AGGREGATOR (avimux), &segment);
 
   /* the first error survives */
   header = gst_avi_mux_riff_get_avi_header (avimux);
   if (res == GST_FLOW_OK)
-    res = gst_pad_push (avimux->srcpad, header);
+    res = gst_aggregator_finish_buffer (GST_AGGREGATOR (avimux), header);
   else
-    gst_pad_push (avimux->srcpad, header);
+    gst_aggregator_finish_buffer (GST_AGGREGATOR (avimux), header);
 
   segment.start = avimux->total_data;
   segment.time = avimux->total_data;
-  gst_pad_push_event (avimux->srcpad, gst_event_new_segment (&segment));
+  gst_aggregator_update_segment (GST_AGGREGATOR (avimux), &segment);
 
   avimux->write_header = TRUE;
 
@@ -1999,40 +2031,46 @@ gst_avi_mux_restart_file (GstAviMux * avimux)
   if ((res = gst_avi_mux_stop_file (avimux)) != GST_FLOW_OK)
     return res;
 
-  gst_pad_push_event (avimux->srcpad, gst_event_new_eos ());
+  gst_pad_push_event (GST_AGGREGATOR_SRC_PAD (avimux), gst_event_new_eos ());
+
+  /* a new stream-start is needed to get downstream out of EOS again */
+  {
+    gchar s_id[32];
+
+    g_snprintf (s_id, sizeof (s_id), "avimux-%08x", g_random_int ());
+    gst_pad_push_event (GST_AGGREGATOR_SRC_PAD (avimux),
+        gst_event_new_stream_start (s_id));
+  }
 
   return gst_avi_mux_start_file (avimux);
 }
 
 /* handle events (search) */
 static gboolean
-gst_avi_mux_handle_event (GstCollectPads * pads, GstCollectData * data,
-    GstEvent * event, gpointer user_data)
+gst_avi_mux_handle_event (GstAggregator * agg, GstAggregatorPad * agg_pad,
+    GstEvent * event)
 {
   GstAviMux *avimux;
   gboolean ret = TRUE;
 
-  avimux = GST_AVI_MUX (user_data);
+  avimux = GST_AVI_MUX (agg);
 
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_CAPS:
     {
       GstCaps *caps;
-      GstAviCollectData *collect_pad;
-      GstAviVideoPad *avipad;
+      GstAviPad *avipad;
 
       gst_event_parse_caps (event, &caps);
 
       /* find stream data */
-      collect_pad = (GstAviCollectData *) data;
-      g_assert (collect_pad);
-      avipad = (GstAviVideoPad *) collect_pad->avipad;
+      avipad = GST_AVI_MUX_PAD (agg_pad)->avipad;
       g_assert (avipad);
 
-      if (avipad->parent.is_video) {
-        ret = gst_avi_mux_vidsink_set_caps (data->pad, caps);
+      if (avipad->is_video) {
+        ret = gst_avi_mux_vidsink_set_caps (GST_PAD (agg_pad), caps);
       } else {
-        ret = gst_avi_mux_audsink_set_caps (data->pad, caps);
+        ret = gst_avi_mux_audsink_set_caps (GST_PAD (agg_pad), caps);
       }
       gst_event_unref (event);
       event = NULL;
@@ -2054,7 +2092,8 @@ gst_avi_mux_handle_event (GstCollectPads * pads, GstCollectData * data,
   }
 
   if (event != NULL)
-    return gst_collect_pads_event_default (pads, data, event, FALSE);
+    return GST_AGGREGATOR_CLASS (parent_class)->sink_event (agg, agg_pad,
+        event);
 
   return ret;
 }
@@ -2068,7 +2107,7 @@ gst_avi_mux_send_pad_data (GstAviMux * avimux, gulong num_bytes)
   buffer = gst_buffer_new_and_alloc (num_bytes);
   gst_buffer_memset (buffer, 0, 0, num_bytes);
 
-  return gst_pad_push (avimux->srcpad, buffer);
+  return gst_aggregator_finish_buffer (GST_AGGREGATOR (avimux), buffer);
 }
 
 #define gst_avi_mux_is_uncompressed(fourcc)		\
@@ -2134,24 +2173,17 @@ gst_avi_mux_invert (GstAviPad * avipad, GstBuffer * buf)
 }
 
 /* do buffer */
+/* takes ownership of @data, which already carries running time (see
+ * gst_avi_mux_clip()) */
 static GstFlowReturn
-gst_avi_mux_do_buffer (GstAviMux * avimux, GstAviPad * avipad)
+gst_avi_mux_do_buffer (GstAviMux * avimux, GstAviPad * avipad,
+    GstBuffer * data)
 {
   GstFlowReturn res;
-  GstBuffer *data, *header;
+  GstBuffer *header;
   gulong total_size, pad_bytes = 0;
   guint flags;
   gsize datasize;
-  GstClockTime time;
-
-  data = gst_collect_pads_pop (avimux->collect, avipad->collect);
-  /* arrange downstream running time */
-  time = gst_segment_to_running_time (&avipad->collect->segment,
-      GST_FORMAT_TIME, GST_BUFFER_TIMESTAMP (data));
-  if (time != GST_BUFFER_TIMESTAMP (data)) {
-    data = gst_buffer_make_writable (data);
-    GST_BUFFER_TIMESTAMP (data) = time;
-  }
 
   /* Prepend a special buffer to the first one for some formats */
   if (avipad->is_video) {
@@ -2253,11 +2285,13 @@ gst_avi_mux_do_buffer (GstAviMux * avimux, GstAviPad * avipad)
   /* send buffers */
   GST_LOG_OBJECT (avimux, "pushing buffers: head, data");
 
-  if ((res = gst_pad_push (avimux->srcpad, header)) != GST_FLOW_OK)
+  res = gst_aggregator_finish_buffer (GST_AGGREGATOR (avimux), header);
+  if (res != GST_FLOW_OK)
     goto done;
 
   gst_buffer_ref (data);
-  if ((res = gst_pad_push (avimux->srcpad, data)) != GST_FLOW_OK)
+  res = gst_aggregator_finish_buffer (GST_AGGREGATOR (avimux), data);
+  if (res != GST_FLOW_OK)
     goto done;
 
   if (pad_bytes) {
@@ -2274,71 +2308,80 @@ done:
   return res;
 }
 
-/* pick the oldest buffer from the pads and push it */
-static GstFlowReturn
-gst_avi_mux_do_one_buffer (GstAviMux * avimux)
+/* Returns the pad with the oldest queued buffer, or %NULL if no pad has
+ * data. The aggregator pad of the returned pad is stored reffed in @agg_pad.
+ * Video is delayed by half a second so that audio gets interleaved ahead of
+ * it, and pads without timestamps are always picked first. */
+static GstAviPad *
+gst_avi_mux_find_best_pad (GstAviMux * avimux, GstAggregatorPad ** agg_pad,
+    GstClockTime * best_time)
 {
-  GstAviPad *avipad, *best_pad;
+  GstAviPad *best_pad = NULL;
   GSList *node;
-  GstBuffer *buffer;
-  GstClockTime time, best_time, delay;
 
-  node = avimux->sinkpads;
-  best_pad = NULL;
-  best_time = GST_CLOCK_TIME_NONE;
-  for (; node; node = node->next) {
-    avipad = (GstAviPad *) node->data;
+  *best_time = GST_CLOCK_TIME_NONE;
+
+  GST_OBJECT_LOCK (avimux);
+  for (node = avimux->sinkpads; node; node = node->next) {
+    GstAviPad *avipad = (GstAviPad *) node->data;
+    GstBuffer *buffer;
+    GstClockTime time, delay;
 
-    if (!avipad->collect)
+    if (!avipad->pad)
       continue;
 
-    buffer = gst_collect_pads_peek (avimux->collect, avipad->collect);
+    buffer = gst_aggregator_pad_peek_buffer (avipad->pad);
     if (!buffer)
       continue;
     time = GST_BUFFER_TIMESTAMP (buffer);
     gst_buffer_unref (buffer);
 
-    /* invalid should pass */
-    if (G_LIKELY (GST_CLOCK_TIME_IS_VALID (time))) {
-      time = gst_segment_to_running_time (&avipad->collect->segment,
-          GST_FORMAT_TIME, time);
-      if (G_UNLIKELY (!GST_CLOCK_TIME_IS_VALID (time))) {
-        GST_DEBUG_OBJECT (avimux, "clipping buffer on pad %s outside segment",
-            GST_PAD_NAME (avipad->collect->pad));
-        buffer = gst_collect_pads_pop (avimux->collect, avipad->collect);
-        gst_buffer_unref (buffer);
-        return GST_FLOW_OK;
-      }
-    }
-
     delay = avipad->is_video ? GST_SECOND / 2 : 0;
 
     /* invalid timestamp buffers pass first,
      * these are probably initialization buffers */
     if (best_pad == NULL || !GST_CLOCK_TIME_IS_VALID (time)
-        || (GST_CLOCK_TIME_IS_VALID (best_time) && time + delay < best_time)) {
+        || (GST_CLOCK_TIME_IS_VALID (*best_time)
+            && time + delay < *best_time)) {
       best_pad = avipad;
-      best_time = time + delay;
+      *best_time = GST_CLOCK_TIME_IS_VALID (time) ? time + delay : time;
     }
   }
 
-  if (best_pad) {
-    GST_LOG_OBJECT (avimux, "selected pad %s with time %" GST_TIME_FORMAT,
-        GST_PAD_NAME (best_pad->collect->pad), GST_TIME_ARGS (best_time));
+  if (best_pad)
+    *agg_pad = gst_object_ref (best_pad->pad);
+  GST_OBJECT_UNLOCK (avimux);
 
-    return gst_avi_mux_do_buffer (avimux, best_pad);
-  } else {
-    /* simply finish off the file and send EOS */
-    gst_avi_mux_stop_file (avimux);
-    gst_pad_push_event (avimux->srcpad, gst_event_new_eos ());
-    return GST_FLOW_EOS;
+  return best_pad;
+}
+
+static gboolean
+gst_avi_mux_are_all_pads_eos (GstAviMux * avimux)
+{
+  GList *l;
+  gboolean ret = TRUE;
+
+  GST_OBJECT_LOCK (avimux);
+  for (l = GST_ELEMENT (avimux)->sinkpads; l; l = l->next) {
+    if (!gst_aggregator_pad_is_eos (GST_AGGREGATOR_PAD (l->data))) {
+      ret = FALSE;
+      break;
+    }
   }
+  GST_OBJECT_UNLOCK (avimux);
 
+  return ret;
 }
 
+/* pick the oldest buffer from the pads and push it */
 static GstFlowReturn
-gst_avi_mux_collect_pads (GstCollectPads * pads, GstAviMux * avimux)
+gst_avi_mux_aggregate (GstAggregator * agg, gboolean timeout)
 {
+  GstAviMux *avimux = GST_AVI_MUX (agg);
+  GstAggregatorPad *agg_pad = NULL;
+  GstAviPad *best_pad;
+  GstClockTime best_time;
+  GstBuffer *buffer;
   GstFlowReturn res;
 
   if (G_UNLIKELY (avimux->write_header)) {
@@ -2346,9 +2389,84 @@ gst_avi_mux_collect_pads (GstCollectPads * pads, GstAviMux * avimux)
       return res;
   }
 
-  return gst_avi_mux_do_one_buffer (avimux);
+  best_pad = gst_avi_mux_find_best_pad (avimux, &agg_pad, &best_time);
+
+  if (best_pad) {
+    GST_LOG_OBJECT (avimux, "selected pad %s with time %" GST_TIME_FORMAT,
+        GST_PAD_NAME (agg_pad), GST_TIME_ARGS (best_time));
+
+    buffer = gst_aggregator_pad_pop_buffer (agg_pad);
+    gst_object_unref (agg_pad);
+
+    /* the pad was flushed in the meantime */
+    if (!buffer)
+      return GST_FLOW_OK;
+
+    /* GAP events are turned into empty buffers by the aggregator, they only
+     * served to advance the pad */
+    if (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_GAP) &&
+        gst_buffer_get_size (buffer) == 0) {
+      gst_buffer_unref (buffer);
+      return GST_FLOW_OK;
+    }
+
+    return gst_avi_mux_do_buffer (avimux, best_pad, buffer);
+  } else if (gst_avi_mux_are_all_pads_eos (avimux)) {
+    /* simply finish off the file, the aggregator sends EOS */
+    gst_avi_mux_stop_file (avimux);
+    return GST_FLOW_EOS;
+  }
+
+  /* timeout without any data on any pad */
+  return GST_FLOW_OK;
 }
 
+static GstClockTime
+gst_avi_mux_get_next_time (GstAggregator * agg)
+{
+  GstAggregatorPad *agg_pad = NULL;
+  GstClockTime best_time;
+
+  if (gst_avi_mux_find_best_pad (GST_AVI_MUX (agg), &agg_pad, &best_time))
+    gst_object_unref (agg_pad);
+
+  return best_time;
+}
+
+/* arrange downstream running time, buffers outside the segment are dropped */
+static GstBuffer *
+gst_avi_mux_clip (GstAggregator * agg, GstAggregatorPad * agg_pad,
+    GstBuffer * buf)
+{
+  GstClockTime time;
+
+  /* invalid should pass */
+  if (!GST_CLOCK_TIME_IS_VALID (GST_BUFFER_TIMESTAMP (buf)))
+    return buf;
+
+  time = gst_segment_to_running_time (&agg_pad->segment, GST_FORMAT_TIME,
+      GST_BUFFER_TIMESTAMP (buf));
+  if (G_UNLIKELY (!GST_CLOCK_TIME_IS_VALID (time))) {
+    GST_DEBUG_OBJECT (agg_pad, "clipping buffer outside segment");
+    gst_buffer_unref (buf);
+    return NULL;
+  }
+
+  if (time != GST_BUFFER_TIMESTAMP (buf)) {
+    buf = gst_buffer_make_writable (buf);
+    GST_BUFFER_TIMESTAMP (buf) = time;
+  }
+
+  return buf;
+}
+
+static gboolean
+gst_avi_mux_stop (GstAggregator * agg)
+{
+  gst_avi_mux_reset (GST_AVI_MUX (agg));
+
+  return TRUE;
+}
 
 static void
 gst_avi_mux_get_property (GObject * object,
@@ -2385,44 +2503,3 @@ gst_avi_mux_set_property (GObject * object,
       break;
   }
 }
-
-static GstStateChangeReturn
-gst_avi_mux_change_state (GstElement * element, GstStateChange transition)
-{
-  GstAviMux *avimux;
-  GstStateChangeReturn ret;
-
-  avimux = GST_AVI_MUX (element);
-
-  switch (transition) {
-    case GST_STATE_CHANGE_READY_TO_PAUSED:
-      gst_collect_pads_start (avimux->collect);
-      break;
-    case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
-      break;
-    case GST_STATE_CHANGE_PAUSED_TO_READY:
-      gst_collect_pads_stop (avimux->collect);
-      break;
-    default:
-      break;
-  }
-
-  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
-  if (ret == GST_STATE_CHANGE_FAILURE)
-    goto done;
-
-  switch (transition) {
-    case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
-      break;
-    case GST_STATE_CHANGE_PAUSED_TO_READY:
-      gst_avi_mux_reset (avimux);
-      break;
-    case GST_STATE_CHANGE_READY_TO_NULL:
-      break;
-    default:
-      break;
-  }
-
-done:
-  return ret;
-}
@@ -23,7 +23,7 @@
 
 
 #include <gst/gst.h>
-#include <gst/base/gstcollectpads.h>
+#include <gst/base/gstaggregator.h>
 #include <gst/riff/riff-ids.h>
 #include <gst/audio/audio.h>
 #include "avi-ids.h"
@@ -41,6 +41,17 @@ G_BEGIN_DECLS
 #define GST_IS_AVI_MUX_CLASS(klass) \
   (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_AVI_MUX))
 
+#define GST_TYPE_AVI_MUX_PAD \
+  (gst_avi_mux_pad_get_type())
+#define GST_AVI_MUX_PAD(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_AVI_MUX_PAD,GstAviMuxPad))
+#define GST_AVI_MUX_PAD_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_AVI_MUX_PAD,GstAviMuxPadClass))
+#define GST_IS_AVI_MUX_PAD(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_AVI_MUX_PAD))
+#define GST_IS_AVI_MUX_PAD_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_AVI_MUX_PAD))
+
 #define GST_AVI_INDEX_OF_INDEXES     0
 #define GST_AVI_INDEX_OF_CHUNKS      1
 
@@ -68,6 +79,8 @@ typedef struct _gst_riff_strh_full {
 typedef struct _GstAviPad GstAviPad;
 typedef struct _GstAviMux GstAviMux;
 typedef struct _GstAviMuxClass GstAviMuxClass;
+typedef struct _GstAviMuxPad GstAviMuxPad;
+typedef struct _GstAviMuxPadClass GstAviMuxPadClass;
 
 typedef GstFlowReturn (*GstAviPadHook) (GstAviMux * avi, GstAviPad * avipad,
                                         GstBuffer * buffer);
@@ -75,7 +88,7 @@ typedef GstFlowReturn (*GstAviPadHook) (GstAviMux * avi, GstAviPad * avipad,
 struct _GstAviPad {
   /* do not extend, link to it */
   /* is NULL if original sink request pad has been removed */
-  GstCollectData *collect;
+  GstAggregatorPad *pad;
 
   /* type */
   gboolean is_video;
@@ -140,23 +153,23 @@ typedef struct _GstAviAudioPad {
   GstBuffer *auds_codec_data;
 } GstAviAudioPad;
 
-typedef struct _GstAviCollectData {
-  /* extend the CollectData */
-  GstCollectData collect;
+struct _GstAviMuxPad {
+  GstAggregatorPad parent;
 
   GstAviPad      *avipad;
-} GstAviCollectData;
+};
+
+struct _GstAviMuxPadClass {
+  GstAggregatorPadClass parent_class;
+};
 
 struct _GstAviMux {
-  GstElement element;
+  GstAggregator aggregator;
 
-  /* pads */
-  GstPad              *srcpad;
   /* sinkpads, video first */
   GSList              *sinkpads;
   /* video restricted to 1 pad */
   guint               video_pads, audio_pads;
-  GstCollectPads     *collect;
 
   /* the AVI header */
   /* still some single stream video data in mux struct */
@@ -198,10 +211,11 @@ struct _GstAviMux {
 };
 
 struct _GstAviMuxClass {
-  GstElementClass parent_class;
+  GstAggregatorClass parent_class;
 };
 
 GType gst_avi_mux_get_type(void);
+GType gst_avi_mux_pad_get_type(void);
 
 G_END_DECLS
 
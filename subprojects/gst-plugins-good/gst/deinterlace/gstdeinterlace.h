@@ -197,6 +197,9 @@ struct _GstDeinterlace
   gboolean need_more;
   gboolean have_eos;
   gboolean telecine_tc_warned;
+
+  /* property value, 0 = auto */
+  guint max_threads;
 };
 
 struct _GstDeinterlaceClass
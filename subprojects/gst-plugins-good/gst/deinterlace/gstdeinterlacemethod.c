@@ -29,6 +29,120 @@
 G_DEFINE_ABSTRACT_TYPE (GstDeinterlaceMethod, gst_deinterlace_method,
     GST_TYPE_OBJECT);
 
+/* copied from video-converter.c */
+static void
+gst_parallelized_task_thread_func (gpointer data)
+{
+  GstParallelizedTaskRunner *runner = data;
+  gint idx;
+
+  g_mutex_lock (&runner->lock);
+  idx = runner->n_todo--;
+  g_assert (runner->n_todo >= -1);
+  g_mutex_unlock (&runner->lock);
+
+  g_assert (runner->func != NULL);
+
+  runner->func (runner->task_data[idx]);
+}
+
+static void
+gst_parallelized_task_runner_join (GstParallelizedTaskRunner * self)
+{
+  gboolean joined = FALSE;
+
+  while (!joined) {
+    g_mutex_lock (&self->lock);
+    if (!(joined = gst_queue_array_is_empty (self->tasks))) {
+      gpointer task = gst_queue_array_pop_head (self->tasks);
+      g_mutex_unlock (&self->lock);
+      gst_task_pool_join (self->pool, task);
+    } else {
+      g_mutex_unlock (&self->lock);
+    }
+  }
+}
+
+static void
+gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
+{
+  gst_parallelized_task_runner_join (self);
+
+  gst_queue_array_free (self->tasks);
+  gst_task_pool_cleanup (self->pool);
+  gst_object_unref (self->pool);
+  g_mutex_clear (&self->lock);
+  g_free (self);
+}
+
+static GstParallelizedTaskRunner *
+gst_parallelized_task_runner_new (guint n_threads)
+{
+  GstParallelizedTaskRunner *self;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  self = g_new0 (GstParallelizedTaskRunner, 1);
+
+  self->pool = gst_shared_task_pool_new ();
+  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
+      n_threads);
+  gst_task_pool_prepare (self->pool, NULL);
+
+  self->tasks = gst_queue_array_new (n_threads);
+
+  self->n_threads = n_threads;
+
+  self->n_todo = -1;
+  g_mutex_init (&self->lock);
+
+  /* Set when scheduling a job */
+  self->func = NULL;
+  self->task_data = NULL;
+
+  return self;
+}
+
+static void
+gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
+    GstParallelizedTaskFunc func, gpointer * task_data)
+{
+  guint n_threads = self->n_threads;
+
+  self->func = func;
+  self->task_data = task_data;
+
+  if (n_threads > 1) {
+    guint i;
+
+    g_mutex_lock (&self->lock);
+    /* perform one of the functions in the current thread */
+    self->n_todo = self->n_threads - 2;
+    for (i = 1; i < n_threads; i++) {
+      gpointer task =
+          gst_task_pool_push (self->pool, gst_parallelized_task_thread_func,
+          self, NULL);
+
+      /* The return value of push() is nullable but NULL is only returned
+       * with the shared task pool when gst_task_pool_prepare() has not been
+       * called and would thus be a programming error that we should hard-fail
+       * on.
+       */
+      g_assert (task != NULL);
+      gst_queue_array_push_tail (self->tasks, task);
+    }
+    g_mutex_unlock (&self->lock);
+  }
+
+  self->func (self->task_data[self->n_threads - 1]);
+
+  gst_parallelized_task_runner_join (self);
+
+  self->func = NULL;
+  self->task_data = NULL;
+}
+
 gboolean
 gst_deinterlace_method_supported (GType type, GstVideoFormat format, gint width,
     gint height)
@@ -108,6 +222,8 @@ gst_deinterlace_method_setup_impl (GstDeinterlaceMethod * self,
 {
   GstDeinterlaceMethodClass *klass = GST_DEINTERLACE_METHOD_GET_CLASS (self);
 
+  guint n_threads;
+
   self->vinfo = vinfo;
 
   self->deinterlace_frame = NULL;
@@ -115,6 +231,24 @@ gst_deinterlace_method_setup_impl (GstDeinterlaceMethod * self,
   if (GST_VIDEO_INFO_FORMAT (self->vinfo) == GST_VIDEO_FORMAT_UNKNOWN)
     return;
 
+  if (self->max_threads == 0)
+    n_threads = g_get_num_processors ();
+  else
+    n_threads = self->max_threads;
+
+  /* Magic number of 200 lines */
+  if (GST_VIDEO_INFO_HEIGHT (vinfo) / n_threads < 200)
+    n_threads = (GST_VIDEO_INFO_HEIGHT (vinfo) + 199) / 200;
+  if (n_threads < 1)
+    n_threads = 1;
+
+  if (self->runner && self->runner->n_threads != n_threads) {
+    gst_parallelized_task_runner_free (self->runner);
+    self->runner = NULL;
+  }
+  if (!self->runner && n_threads > 1)
+    self->runner = gst_parallelized_task_runner_new (n_threads);
+
   switch (GST_VIDEO_INFO_FORMAT (self->vinfo)) {
     case GST_VIDEO_FORMAT_YUY2:
       self->deinterlace_frame = klass->deinterlace_frame_yuy2;
@@ -177,9 +311,26 @@ gst_deinterlace_method_setup_impl (GstDeinterlaceMethod * self,
   }
 }
 
+static void
+gst_deinterlace_method_finalize (GObject * object)
+{
+  GstDeinterlaceMethod *self = GST_DEINTERLACE_METHOD (object);
+
+  if (self->runner) {
+    gst_parallelized_task_runner_free (self->runner);
+    self->runner = NULL;
+  }
+
+  G_OBJECT_CLASS (gst_deinterlace_method_parent_class)->finalize (object);
+}
+
 static void
 gst_deinterlace_method_class_init (GstDeinterlaceMethodClass * klass)
 {
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->finalize = gst_deinterlace_method_finalize;
+
   klass->setup = gst_deinterlace_method_setup_impl;
   klass->supported = gst_deinterlace_method_supported_impl;
 }
@@ -216,6 +367,64 @@ gst_deinterlace_method_get_latency (GstDeinterlaceMethod * self)
   return klass->latency;
 }
 
+typedef struct
+{
+  GstDeinterlaceMethod *self;
+  GstDeinterlaceMethodLinesFunction func;
+  gpointer user_data;
+  gint line_start, line_end;
+} LinesTask;
+
+static void
+gst_deinterlace_method_lines_task (LinesTask * task)
+{
+  if (task->line_start < task->line_end)
+    task->func (task->self, task->user_data, task->line_start,
+        task->line_end);
+}
+
+/* Splits the @n_lines lines of a plane into one slice per worker thread
+ * and calls @func for each of them. Slices always start on an even line
+ * so that both lines of a frame line pair are handled by the same call. */
+void
+gst_deinterlace_method_process_lines (GstDeinterlaceMethod * self,
+    gint n_lines, GstDeinterlaceMethodLinesFunction func, gpointer user_data)
+{
+  gint i, n_threads, lines_per_thread;
+  LinesTask *tasks;
+  LinesTask **tasks_p;
+
+  if (n_lines <= 0)
+    return;
+
+  if (!self->runner) {
+    func (self, user_data, 0, n_lines);
+    return;
+  }
+
+  n_threads = self->runner->n_threads;
+
+  tasks = g_newa (LinesTask, n_threads);
+  tasks_p = g_newa (LinesTask *, n_threads);
+
+  lines_per_thread = (n_lines + n_threads - 1) / n_threads;
+  lines_per_thread = GST_ROUND_UP_2 (lines_per_thread);
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].self = self;
+    tasks[i].func = func;
+    tasks[i].user_data = user_data;
+    tasks[i].line_start = MIN (i * lines_per_thread, n_lines);
+    tasks[i].line_end = MIN ((i + 1) * lines_per_thread, n_lines);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (self->runner,
+      (GstParallelizedTaskFunc) gst_deinterlace_method_lines_task,
+      (gpointer *) tasks_p);
+}
+
 G_DEFINE_ABSTRACT_TYPE (GstDeinterlaceSimpleMethod,
     gst_deinterlace_simple_method, GST_TYPE_DEINTERLACE_METHOD);
 
@@ -374,101 +583,6 @@ get_line (LinesGetter * lg, gint field_offset, guint plane, gint line,
   return data;
 }
 
-static void
-gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
-    method, const GstDeinterlaceField * history, guint history_count,
-    GstVideoFrame * outframe, gint cur_field_idx)
-{
-  GstDeinterlaceSimpleMethod *self = GST_DEINTERLACE_SIMPLE_METHOD (method);
-#ifndef G_DISABLE_ASSERT
-  GstDeinterlaceMethodClass *dm_class = GST_DEINTERLACE_METHOD_GET_CLASS (self);
-#endif
-  GstDeinterlaceScanlineData scanlines;
-  guint cur_field_flags;
-  gint i;
-  gint frame_height, frame_width;
-  LinesGetter lg = { history, history_count, cur_field_idx };
-  GstVideoFrame *framep, *frame0, *frame1, *frame2;
-
-  g_assert (self->interpolate_scanline_packed != NULL);
-  g_assert (self->copy_scanline_packed != NULL);
-
-  frame_height = GST_VIDEO_FRAME_HEIGHT (outframe);
-  frame_width = GST_VIDEO_FRAME_PLANE_STRIDE (outframe, 0);
-
-  frame0 = history[cur_field_idx].frame;
-  frame_width = MIN (frame_width, GST_VIDEO_FRAME_PLANE_STRIDE (frame0, 0));
-  cur_field_flags = history[cur_field_idx].flags;
-
-  framep = (cur_field_idx > 0 ? history[cur_field_idx - 1].frame : NULL);
-  if (framep)
-    frame_width = MIN (frame_width, GST_VIDEO_FRAME_PLANE_STRIDE (framep, 0));
-
-  g_assert (dm_class->fields_required <= 5);
-
-  frame1 =
-      (cur_field_idx + 1 <
-      history_count ? history[cur_field_idx + 1].frame : NULL);
-  if (frame1)
-    frame_width = MIN (frame_width, GST_VIDEO_FRAME_PLANE_STRIDE (frame1, 0));
-
-  frame2 =
-      (cur_field_idx + 2 <
-      history_count ? history[cur_field_idx + 2].frame : NULL);
-  if (frame2)
-    frame_width = MIN (frame_width, GST_VIDEO_FRAME_PLANE_STRIDE (frame2, 0));
-
-#define LINE(x,i) (((guint8*)GST_VIDEO_FRAME_PLANE_DATA((x),0)) + i * \
-    GST_VIDEO_FRAME_PLANE_STRIDE((x),0))
-
-  for (i = 0; i < frame_height; i++) {
-    memset (&scanlines, 0, sizeof (scanlines));
-    scanlines.bottom_field = (cur_field_flags == PICTURE_INTERLACED_BOTTOM);
-
-    if (!((i & 1) ^ scanlines.bottom_field)) {
-      /* copying */
-      scanlines.tp = get_line (&lg, -1, 0, i, -1);
-      scanlines.bp = get_line (&lg, -1, 0, i, 1);
-
-      scanlines.tt0 = get_line (&lg, 0, 0, i, -2);
-      scanlines.m0 = get_line (&lg, 0, 0, i, 0);
-      scanlines.bb0 = get_line (&lg, 0, 0, i, 2);
-
-      scanlines.t1 = get_line (&lg, 1, 0, i, -1);
-      scanlines.b1 = get_line (&lg, 1, 0, i, 1);
-
-      scanlines.tt2 = get_line (&lg, 2, 0, i, -2);
-      scanlines.m2 = get_line (&lg, 2, 0, i, 0);
-      scanlines.bb2 = get_line (&lg, 2, 0, i, 2);
-
-      self->copy_scanline_packed (self, LINE (outframe, i), &scanlines,
-          frame_width);
-    } else {
-      /* interpolating */
-      scanlines.tp2 = get_line (&lg, -2, 0, i, -1);
-      scanlines.bp2 = get_line (&lg, -2, 0, i, 1);
-
-      scanlines.ttp = get_line (&lg, -1, 0, i, -2);
-      scanlines.mp = get_line (&lg, -1, 0, i, 0);
-      scanlines.bbp = get_line (&lg, -1, 0, i, 2);
-
-      scanlines.t0 = get_line (&lg, 0, 0, i, -1);
-      scanlines.b0 = get_line (&lg, 0, 0, i, 1);
-
-      scanlines.tt1 = get_line (&lg, 1, 0, i, -2);
-      scanlines.m1 = get_line (&lg, 1, 0, i, 0);
-      scanlines.bb1 = get_line (&lg, 1, 0, i, 2);
-
-      scanlines.t2 = get_line (&lg, 2, 0, i, -1);
-      scanlines.b2 = get_line (&lg, 2, 0, i, 1);
-
-      self->interpolate_scanline_packed (self, LINE (outframe, i), &scanlines,
-          frame_width);
-    }
-#undef LINE
-  }
-}
-
 static void
     gst_deinterlace_simple_method_interpolate_scanline_planar_y
     (GstDeinterlaceSimpleMethod * self, guint8 * out,
@@ -517,31 +631,34 @@ gst_deinterlace_simple_method_copy_scanline_planar_v (GstDeinterlaceSimpleMethod
   memcpy (out, scanlines->m0, size);
 }
 
+typedef struct
+{
+  GstVideoFrame *dest;
+  LinesGetter *lg;
+  guint cur_field_flags;
+  gint plane;
+  gint width;
+  GstDeinterlaceSimpleMethodFunction copy_scanline;
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline;
+} PlaneData;
+
 static void
-    gst_deinterlace_simple_method_deinterlace_frame_planar_plane
-    (GstDeinterlaceSimpleMethod * self, GstVideoFrame * dest,
-    LinesGetter * lg,
-    guint cur_field_flags, gint plane,
-    GstDeinterlaceSimpleMethodFunction copy_scanline,
-    GstDeinterlaceSimpleMethodFunction interpolate_scanline)
+gst_deinterlace_simple_method_deinterlace_lines (GstDeinterlaceMethod *
+    method, PlaneData * data, gint line_start, gint line_end)
 {
+  GstDeinterlaceSimpleMethod *self = GST_DEINTERLACE_SIMPLE_METHOD (method);
   GstDeinterlaceScanlineData scanlines;
+  LinesGetter *lg = data->lg;
+  gint plane = data->plane;
   gint i;
-  gint frame_height, frame_width;
-
-  frame_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, plane);
-  frame_width = GST_VIDEO_FRAME_COMP_WIDTH (dest, plane) *
-      GST_VIDEO_FRAME_COMP_PSTRIDE (dest, plane);
-
-  g_assert (interpolate_scanline != NULL);
-  g_assert (copy_scanline != NULL);
 
 #define LINE(x,i) (((guint8*)GST_VIDEO_FRAME_PLANE_DATA((x),plane)) + i * \
     GST_VIDEO_FRAME_PLANE_STRIDE((x),plane))
 
-  for (i = 0; i < frame_height; i++) {
+  for (i = line_start; i < line_end; i++) {
     memset (&scanlines, 0, sizeof (scanlines));
-    scanlines.bottom_field = (cur_field_flags == PICTURE_INTERLACED_BOTTOM);
+    scanlines.bottom_field =
+        (data->cur_field_flags == PICTURE_INTERLACED_BOTTOM);
 
     if (!((i & 1) ^ scanlines.bottom_field)) {
       /* copying */
@@ -559,7 +676,8 @@ static void
       scanlines.m2 = get_line (lg, 2, plane, i, 0);
       scanlines.bb2 = get_line (lg, 2, plane, i, 2);
 
-      copy_scanline (self, LINE (dest, i), &scanlines, frame_width);
+      data->copy_scanline (self, LINE (data->dest, i), &scanlines,
+          data->width);
     } else {
       /* interpolating */
       scanlines.tp2 = get_line (lg, -2, plane, i, -1);
@@ -579,12 +697,105 @@ static void
       scanlines.t2 = get_line (lg, 2, plane, i, -1);
       scanlines.b2 = get_line (lg, 2, plane, i, 1);
 
-      interpolate_scanline (self, LINE (dest, i), &scanlines, frame_width);
+      data->interpolate_scanline (self, LINE (data->dest, i), &scanlines,
+          data->width);
     }
 #undef LINE
   }
 }
 
+static void
+    gst_deinterlace_simple_method_deinterlace_plane
+    (GstDeinterlaceSimpleMethod * self, GstVideoFrame * dest,
+    LinesGetter * lg, guint cur_field_flags, gint plane, gint width,
+    GstDeinterlaceSimpleMethodFunction copy_scanline,
+    GstDeinterlaceSimpleMethodFunction interpolate_scanline)
+{
+  PlaneData data;
+
+  g_assert (interpolate_scanline != NULL);
+  g_assert (copy_scanline != NULL);
+
+  data.dest = dest;
+  data.lg = lg;
+  data.cur_field_flags = cur_field_flags;
+  data.plane = plane;
+  data.width = width;
+  data.copy_scanline = copy_scanline;
+  data.interpolate_scanline = interpolate_scanline;
+
+  /* Every output line only depends on the input fields, so the lines can be
+   * processed in parallel */
+  gst_deinterlace_method_process_lines (GST_DEINTERLACE_METHOD (self),
+      GST_VIDEO_FRAME_COMP_HEIGHT (dest, plane),
+      (GstDeinterlaceMethodLinesFunction)
+      gst_deinterlace_simple_method_deinterlace_lines, &data);
+}
+
+static void
+    gst_deinterlace_simple_method_deinterlace_frame_planar_plane
+    (GstDeinterlaceSimpleMethod * self, GstVideoFrame * dest,
+    LinesGetter * lg,
+    guint cur_field_flags, gint plane,
+    GstDeinterlaceSimpleMethodFunction copy_scanline,
+    GstDeinterlaceSimpleMethodFunction interpolate_scanline)
+{
+  gint frame_width;
+
+  frame_width = GST_VIDEO_FRAME_COMP_WIDTH (dest, plane) *
+      GST_VIDEO_FRAME_COMP_PSTRIDE (dest, plane);
+
+  gst_deinterlace_simple_method_deinterlace_plane (self, dest, lg,
+      cur_field_flags, plane, frame_width, copy_scanline,
+      interpolate_scanline);
+}
+
+static void
+gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
+    method, const GstDeinterlaceField * history, guint history_count,
+    GstVideoFrame * outframe, gint cur_field_idx)
+{
+  GstDeinterlaceSimpleMethod *self = GST_DEINTERLACE_SIMPLE_METHOD (method);
+#ifndef G_DISABLE_ASSERT
+  GstDeinterlaceMethodClass *dm_class = GST_DEINTERLACE_METHOD_GET_CLASS (self);
+#endif
+  guint cur_field_flags;
+  gint frame_width;
+  LinesGetter lg = { history, history_count, cur_field_idx };
+  GstVideoFrame *framep, *frame0, *frame1, *frame2;
+
+  g_assert (self->interpolate_scanline_packed != NULL);
+  g_assert (self->copy_scanline_packed != NULL);
+
+  frame_width = GST_VIDEO_FRAME_PLANE_STRIDE (outframe, 0);
+
+  frame0 = history[cur_field_idx].frame;
+  frame_width = MIN (frame_width, GST_VIDEO_FRAME_PLANE_STRIDE (frame0, 0));
+  cur_field_flags = history[cur_field_idx].flags;
+
+  framep = (cur_field_idx > 0 ? history[cur_field_idx - 1].frame : NULL);
+  if (framep)
+    frame_width = MIN (frame_width, GST_VIDEO_FRAME_PLANE_STRIDE (framep, 0));
+
+  g_assert (dm_class->fields_required <= 5);
+
+  frame1 =
+      (cur_field_idx + 1 <
+      history_count ? history[cur_field_idx + 1].frame : NULL);
+  if (frame1)
+    frame_width = MIN (frame_width, GST_VIDEO_FRAME_PLANE_STRIDE (frame1, 0));
+
+  frame2 =
+      (cur_field_idx + 2 <
+      history_count ? history[cur_field_idx + 2].frame : NULL);
+  if (frame2)
+    frame_width = MIN (frame_width, GST_VIDEO_FRAME_PLANE_STRIDE (frame2, 0));
+
+  gst_deinterlace_simple_method_deinterlace_plane (self, outframe, &lg,
+      cur_field_flags, 0, frame_width, self->copy_scanline_packed,
+      self->interpolate_scanline_packed);
+}
+
 static void
 gst_deinterlace_simple_method_deinterlace_frame_planar (GstDeinterlaceMethod *
     method, const GstDeinterlaceField * history, guint history_count,
@@ -23,6 +23,7 @@
 
 #include <gst/gst.h>
 #include <gst/video/video.h>
+#include <gst/base/base.h>
 
 #if defined(HAVE_GCC_ASM) && defined(HAVE_ORC)
 #if defined(HAVE_CPU_I386) || defined(HAVE_CPU_X86_64)
@@ -43,6 +44,25 @@ G_BEGIN_DECLS
 typedef struct _GstDeinterlaceMethod GstDeinterlaceMethod;
 typedef struct _GstDeinterlaceMethodClass GstDeinterlaceMethodClass;
 
+/* copied from video-converter.c */
+typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
+
+typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
+
+struct _GstParallelizedTaskRunner
+{
+  GstTaskPool *pool;
+  guint n_threads;
+
+  GstQueueArray *tasks;
+
+  GstParallelizedTaskFunc func;
+  gpointer *task_data;
+
+  GMutex lock;
+  gint n_todo;
+};
+
 
 #define PICTURE_PROGRESSIVE 0
 #define PICTURE_INTERLACED_BOTTOM 1
@@ -66,12 +86,22 @@ typedef void (*GstDeinterlaceMethodDeinterlaceFunction) (
     GstDeinterlaceMethod *self, const GstDeinterlaceField *history,
     guint history_count, GstVideoFrame *outframe, int cur_field_idx);
 
+/* Processes the lines [line_start, line_end) of one plane */
+typedef void (*GstDeinterlaceMethodLinesFunction) (
+    GstDeinterlaceMethod *self, gpointer user_data, gint line_start,
+    gint line_end);
+
 struct _GstDeinterlaceMethod {
   GstObject parent;
 
   GstVideoInfo *vinfo;
 
   GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame;
+
+  /* Maximum number of worker threads, 0 = auto. Set by the element
+   * before setup() */
+  guint max_threads;
+  GstParallelizedTaskRunner *runner;
 };
 
 struct _GstDeinterlaceMethodClass {
@@ -113,6 +143,8 @@ void gst_deinterlace_method_deinterlace_frame (GstDeinterlaceMethod * self, cons
     int cur_field_idx);
 gint gst_deinterlace_method_get_fields_required (GstDeinterlaceMethod * self);
 gint gst_deinterlace_method_get_latency (GstDeinterlaceMethod * self);
+void gst_deinterlace_method_process_lines (GstDeinterlaceMethod * self, gint n_lines,
+    GstDeinterlaceMethodLinesFunction func, gpointer user_data);
 
 #define GST_TYPE_DEINTERLACE_SIMPLE_METHOD		(gst_deinterlace_simple_method_get_type ())
 #define GST_IS_DEINTERLACE_SIMPLE_METHOD(obj)		(G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_DEINTERLACE_SIMPLE_METHOD))
@@ -469,198 +469,134 @@ greedyh_scanline_C_uyvy (GstDeinterlaceMethodGreedyH * self, const guint8 * L1,
   }
 }
 
-static void
-greedyh_scanline_C_planar_y (GstDeinterlaceMethodGreedyH * self,
-    const guint8 * L1, const guint8 * L2, const guint8 * L3, const guint8 * L2P,
-    guint8 * Dest, gint width)
+/* Per-pixel kernel of the planar scanline functions. The neighbouring L1/L3
+ * pixels are passed in explicitly instead of being carried over from the
+ * previous iteration, so the loop over the inner pixels of a line has no
+ * dependency between iterations and no branches and can be vectorized by
+ * the compiler */
+static inline guint8
+greedyh_planar_pixel (guint8 l1, guint8 l1__1, guint8 l1_1, guint8 l3,
+    guint8 l3__1, guint8 l3_1, guint8 l2, guint8 lp2, guint max_comb,
+    guint motion_threshold, guint motion_sense, gboolean luma)
 {
-  gint Pos;
-  guint8 l1, l1_1, l3, l3_1;
-  guint8 avg, avg_1;
-  guint8 avg__1 = 0;
+  guint8 avg, avg_1, avg__1;
   guint8 avg_s;
   guint8 avg_sc;
   guint8 best;
   guint16 mov;
   guint8 out;
-  guint8 l2, lp2;
   guint8 l2_diff, lp2_diff;
   guint8 min, max;
-  guint max_comb = self->max_comb;
-  guint motion_sense = self->motion_sense;
-  guint motion_threshold = self->motion_threshold;
-
-  for (Pos = 0; Pos < width; Pos++) {
-    l1 = L1[0];
-    l3 = L3[0];
-
-    if (Pos == width - 1) {
-      l1_1 = l1;
-      l3_1 = l3;
-    } else {
-      l1_1 = L1[1];
-      l3_1 = L3[1];
-    }
 
-    /* Average of L1 and L3 */
-    avg = (l1 + l3) / 2;
+  /* Average of L1 and L3 */
+  avg = (l1 + l3) / 2;
 
-    if (Pos == 0) {
-      avg__1 = avg;
-    }
+  /* Average of previous L1 and previous L3 */
+  avg__1 = (l1__1 + l3__1) / 2;
 
-    /* Average of next L1 and next L3 */
-    avg_1 = (l1_1 + l3_1) / 2;
+  /* Average of next L1 and next L3 */
+  avg_1 = (l1_1 + l3_1) / 2;
 
-    /* Calculate average of one pixel forward and previous */
-    avg_s = (avg__1 + avg_1) / 2;
+  /* Calculate average of one pixel forward and previous */
+  avg_s = (avg__1 + avg_1) / 2;
 
-    /* Calculate average of center and surrounding pixels */
-    avg_sc = (avg + avg_s) / 2;
+  /* Calculate average of center and surrounding pixels */
+  avg_sc = (avg + avg_s) / 2;
 
-    /* move forward */
-    avg__1 = avg;
+  /* Get best L2/L2P, i.e. least diff from above average */
+  l2_diff = ABS (l2 - avg_sc);
 
-    /* Get best L2/L2P, i.e. least diff from above average */
-    l2 = L2[0];
-    lp2 = L2P[0];
+  lp2_diff = ABS (lp2 - avg_sc);
 
-    l2_diff = ABS (l2 - avg_sc);
+  if (l2_diff > lp2_diff)
+    best = lp2;
+  else
+    best = l2;
 
-    lp2_diff = ABS (lp2 - avg_sc);
+  /* Clip this best L2/L2P by L1/L3 and allow to differ by GreedyMaxComb */
+  max = MAX (l1, l3);
+  min = MIN (l1, l3);
 
-    if (l2_diff > lp2_diff)
-      best = lp2;
-    else
-      best = l2;
+  if (max < 256 - max_comb)
+    max += max_comb;
+  else
+    max = 255;
 
-    /* Clip this best L2/L2P by L1/L3 and allow to differ by GreedyMaxComb */
-    max = MAX (l1, l3);
-    min = MIN (l1, l3);
+  if (min > max_comb)
+    min -= max_comb;
+  else
+    min = 0;
 
-    if (max < 256 - max_comb)
-      max += max_comb;
-    else
-      max = 255;
+  out = CLAMP (best, min, max);
 
-    if (min > max_comb)
-      min -= max_comb;
-    else
-      min = 0;
+  if (!luma)
+    return out;
 
-    out = CLAMP (best, min, max);
+  /* Do motion compensation for luma, i.e. how much
+   * the weave pixel differs */
+  mov = ABS (l2 - lp2);
+  if (mov > motion_threshold)
+    mov -= motion_threshold;
+  else
+    mov = 0;
 
-    /* Do motion compensation for luma, i.e. how much
-     * the weave pixel differs */
-    mov = ABS (l2 - lp2);
-    if (mov > motion_threshold)
-      mov -= motion_threshold;
-    else
-      mov = 0;
+  mov = mov * motion_sense;
+  if (mov > 256)
+    mov = 256;
 
-    mov = mov * motion_sense;
-    if (mov > 256)
-      mov = 256;
+  /* Weighted sum on clipped weave pixel and average */
+  out = (out * (256 - mov) + avg_sc * mov) / 256;
 
-    /* Weighted sum on clipped weave pixel and average */
-    out = (out * (256 - mov) + avg_sc * mov) / 256;
-
-    Dest[0] = out;
-
-    Dest += 1;
-    L1 += 1;
-    L2 += 1;
-    L3 += 1;
-    L2P += 1;
-  }
+  return out;
 }
 
-static void
-greedyh_scanline_C_planar_uv (GstDeinterlaceMethodGreedyH * self,
+static inline void
+greedyh_scanline_C_planar (GstDeinterlaceMethodGreedyH * self,
     const guint8 * L1, const guint8 * L2, const guint8 * L3, const guint8 * L2P,
-    guint8 * Dest, gint width)
+    guint8 * Dest, gint width, gboolean luma)
 {
-  gint Pos;
-  guint8 l1, l1_1, l3, l3_1;
-  guint8 avg, avg_1;
-  guint8 avg__1 = 0;
-  guint8 avg_s;
-  guint8 avg_sc;
-  guint8 best;
-  guint8 out;
-  guint8 l2, lp2;
-  guint8 l2_diff, lp2_diff;
-  guint8 min, max;
+  gint Pos, last;
   guint max_comb = self->max_comb;
+  guint motion_sense = self->motion_sense;
+  guint motion_threshold = self->motion_threshold;
 
-  for (Pos = 0; Pos < width; Pos++) {
-    l1 = L1[0];
-    l3 = L3[0];
-
-    if (Pos == width - 1) {
-      l1_1 = l1;
-      l3_1 = l3;
-    } else {
-      l1_1 = L1[1];
-      l3_1 = L3[1];
-    }
-
-    /* Average of L1 and L3 */
-    avg = (l1 + l3) / 2;
-
-    if (Pos == 0) {
-      avg__1 = avg;
-    }
-
-    /* Average of next L1 and next L3 */
-    avg_1 = (l1_1 + l3_1) / 2;
-
-    /* Calculate average of one pixel forward and previous */
-    avg_s = (avg__1 + avg_1) / 2;
-
-    /* Calculate average of center and surrounding pixels */
-    avg_sc = (avg + avg_s) / 2;
-
-    /* move forward */
-    avg__1 = avg;
-
-    /* Get best L2/L2P, i.e. least diff from above average */
-    l2 = L2[0];
-    lp2 = L2P[0];
-
-    l2_diff = ABS (l2 - avg_sc);
-
-    lp2_diff = ABS (lp2 - avg_sc);
-
-    if (l2_diff > lp2_diff)
-      best = lp2;
-    else
-      best = l2;
+  if (width <= 0)
+    return;
 
-    /* Clip this best L2/L2P by L1/L3 and allow to differ by GreedyMaxComb */
-    max = MAX (l1, l3);
-    min = MIN (l1, l3);
+  last = width - 1;
 
-    if (max < 256 - max_comb)
-      max += max_comb;
-    else
-      max = 255;
+  /* The first and last pixel use themselves as missing neighbour */
+  Dest[0] = greedyh_planar_pixel (L1[0], L1[0], L1[MIN (1, last)], L3[0],
+      L3[0], L3[MIN (1, last)], L2[0], L2P[0], max_comb, motion_threshold,
+      motion_sense, luma);
 
-    if (min > max_comb)
-      min -= max_comb;
-    else
-      min = 0;
+  for (Pos = 1; Pos < last; Pos++) {
+    Dest[Pos] = greedyh_planar_pixel (L1[Pos], L1[Pos - 1], L1[Pos + 1],
+        L3[Pos], L3[Pos - 1], L3[Pos + 1], L2[Pos], L2P[Pos], max_comb,
+        motion_threshold, motion_sense, luma);
+  }
 
-    out = CLAMP (best, min, max);
+  if (last > 0) {
+    Dest[last] = greedyh_planar_pixel (L1[last], L1[last - 1], L1[last],
+        L3[last], L3[last - 1], L3[last], L2[last], L2P[last], max_comb,
+        motion_threshold, motion_sense, luma);
+  }
+}
 
-    Dest[0] = out;
+static void
+greedyh_scanline_C_planar_y (GstDeinterlaceMethodGreedyH * self,
+    const guint8 * L1, const guint8 * L2, const guint8 * L3, const guint8 * L2P,
+    guint8 * Dest, gint width)
+{
+  greedyh_scanline_C_planar (self, L1, L2, L3, L2P, Dest, width, TRUE);
+}
 
-    Dest += 1;
-    L1 += 1;
-    L2 += 1;
-    L3 += 1;
-    L2P += 1;
-  }
+static void
+greedyh_scanline_C_planar_uv (GstDeinterlaceMethodGreedyH * self,
+    const guint8 * L1, const guint8 * L2, const guint8 * L3, const guint8 * L2P,
+    guint8 * Dest, gint width)
+{
+  greedyh_scanline_C_planar (self, L1, L2, L3, L2P, Dest, width, FALSE);
 }
 
 #ifdef BUILD_X86_ASM
@@ -716,6 +652,43 @@ greedyh_scanline_C_planar_uv (GstDeinterlaceMethodGreedyH * self,
 
 #endif
 
+typedef struct
+{
+  ScanlineFunction scanline;
+  guint8 *Dest;
+  const guint8 *L1;
+  const guint8 *L2;
+  const guint8 *L2P;
+  gint RowStride;
+} GreedyHPlane;
+
+static void
+deinterlace_frame_di_greedyh_lines (GstDeinterlaceMethod * method,
+    GreedyHPlane * plane, gint line_start, gint line_end)
+{
+  GstDeinterlaceMethodGreedyH *self = GST_DEINTERLACE_METHOD_GREEDY_H (method);
+  gint RowStride = plane->RowStride;
+  gint Pitch = RowStride * 2;
+  guint8 *Dest = plane->Dest + line_start * Pitch;
+  const guint8 *L1 = plane->L1 + line_start * Pitch;
+  const guint8 *L2 = plane->L2 + line_start * Pitch;
+  const guint8 *L3 = L1 + Pitch;
+  const guint8 *L2P = plane->L2P + line_start * Pitch;
+  gint Line;
+
+  for (Line = line_start; Line < line_end; ++Line) {
+    plane->scanline (self, L1, L2, L3, L2P, Dest, RowStride);
+    Dest += RowStride;
+    memcpy (Dest, L3, RowStride);
+    Dest += RowStride;
+
+    L1 += Pitch;
+    L2 += Pitch;
+    L3 += Pitch;
+    L2P += Pitch;
+  }
+}
+
 static void
 deinterlace_frame_di_greedyh_plane (GstDeinterlaceMethodGreedyH * self,
     const GstDeinterlaceField * history, guint history_count,
@@ -728,10 +701,9 @@ deinterlace_frame_di_greedyh_plane (GstDeinterlaceMethodGreedyH * self,
   gint Pitch = RowStride * 2;
   const guint8 *L1;             // ptr to Line1, of 3
   const guint8 *L2;             // ptr to Line2, the weave line
-  const guint8 *L3;             // ptr to Line3
   const guint8 *L2P;            // ptr to prev Line2
   gint InfoIsOdd;
-  gint Line;
+  GreedyHPlane lines;
 
   L1 = GST_VIDEO_FRAME_COMP_DATA (history[cur_field_idx].frame, plane);
   if (history[cur_field_idx].flags & PICTURE_INTERLACED_BOTTOM)
@@ -741,7 +713,6 @@ deinterlace_frame_di_greedyh_plane (GstDeinterlaceMethodGreedyH * self,
   if (history[cur_field_idx + 1].flags & PICTURE_INTERLACED_BOTTOM)
     L2 += RowStride;
 
-  L3 = L1 + Pitch;
   L2P = GST_VIDEO_FRAME_COMP_DATA (history[cur_field_idx - 1].frame, plane);
   if (history[cur_field_idx - 1].flags & PICTURE_INTERLACED_BOTTOM)
     L2P += RowStride;
@@ -766,20 +737,24 @@ deinterlace_frame_di_greedyh_plane (GstDeinterlaceMethodGreedyH * self,
     L2P += Pitch;
   }
 
-  for (Line = 0; Line < (FieldHeight - 1); ++Line) {
-    scanline (self, L1, L2, L3, L2P, Dest, RowStride);
-    Dest += RowStride;
-    memcpy (Dest, L3, RowStride);
-    Dest += RowStride;
+  // each pair of output lines only depends on the input fields, so the
+  // pairs can be processed in parallel
+  lines.scanline = scanline;
+  lines.Dest = Dest;
+  lines.L1 = L1;
+  lines.L2 = L2;
+  lines.L2P = L2P;
+  lines.RowStride = RowStride;
 
-    L1 += Pitch;
-    L2 += Pitch;
-    L3 += Pitch;
-    L2P += Pitch;
-  }
+  gst_deinterlace_method_process_lines (GST_DEINTERLACE_METHOD (self),
+      FieldHeight - 1,
+      (GstDeinterlaceMethodLinesFunction) deinterlace_frame_di_greedyh_lines,
+      &lines);
 
   if (InfoIsOdd) {
-    memcpy (Dest, L2, RowStride);
+    gint Line = MAX (FieldHeight - 1, 0);
+
+    memcpy (Dest + Line * Pitch, L2 + Line * Pitch, RowStride);
   }
 }
 
@@ -798,6 +773,8 @@ deinterlace_frame_di_greedyh_packed (GstDeinterlaceMethod * method,
 
     backup_method = g_object_new (gst_deinterlace_method_linear_get_type (),
         NULL);
+    /* Only used for a few frames, don't spawn worker threads for it */
+    backup_method->max_threads = 1;
 
     gst_deinterlace_method_setup (backup_method, method->vinfo);
     gst_deinterlace_method_deinterlace_frame (backup_method,
@@ -841,6 +818,8 @@ deinterlace_frame_di_greedyh_planar (GstDeinterlaceMethod * method,
 
     backup_method = g_object_new (gst_deinterlace_method_linear_get_type (),
         NULL);
+    /* Only used for a few frames, don't spawn worker threads for it */
+    backup_method->max_threads = 1;
 
     gst_deinterlace_method_setup (backup_method, method->vinfo);
     gst_deinterlace_method_deinterlace_frame (backup_method,
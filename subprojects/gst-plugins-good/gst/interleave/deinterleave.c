@@ -45,6 +45,9 @@
  * In most cases a queue and an audioconvert element should be added after each source pad
  * before further processing of the audio data.
  *
+ * Non-interleaved input is split without copying, every source pad gets the
+ * memory of its plane.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 filesrc location=/path/to/file.mp3 ! decodebin ! audioconvert ! "audio/x-raw,channels=2 ! deinterleave name=d  d.src_0 ! queue ! audioconvert ! vorbisenc ! oggmux ! filesink location=channel1.ogg  d.src_1 ! queue ! audioconvert ! vorbisenc ! oggmux ! filesink location=channel2.ogg
@@ -66,6 +69,7 @@
 #include <string.h>
 #include "gstinterleaveelements.h"
 #include "deinterleave.h"
+#include "interleaveorc.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_deinterleave_debug);
 #define GST_CAT_DEFAULT gst_deinterleave_debug
@@ -84,7 +88,12 @@ static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_STATIC_CAPS ("audio/x-raw, "
         "format = (string) " GST_AUDIO_FORMATS_ALL ", "
         "rate = (int) [ 1, MAX ], "
-        "channels = (int) [ 1, MAX ], layout = (string) interleaved"));
+        "channels = (int) [ 1, MAX ], "
+        "layout = (string) {interleaved, non-interleaved}"));
+
+/* Number of frames deinterleaved at once, small enough for the input block to
+ * stay in the cache while it is distributed over all channels */
+#define DEINTERLEAVE_BLOCK_FRAMES 256
 
 #define MAKE_FUNC(type) \
 static void deinterleave_##type (guint##type *out, guint##type *in, \
@@ -115,6 +124,31 @@ deinterleave_24 (guint8 * out, guint8 * in, guint stride, guint nframes)
   }
 }
 
+/* Splits stereo frames into two channels. Returns FALSE if there is no ORC
+ * kernel for the sample width */
+static gboolean
+deinterleave_2ch (guint8 * out0, guint8 * out1, const guint8 * in,
+    guint width, guint nframes)
+{
+  switch (width) {
+    case 1:
+      deinterleave_orc_2ch_8 (out0, out1, in, nframes);
+      break;
+    case 2:
+      deinterleave_orc_2ch_16 ((guint16 *) out0, (guint16 *) out1,
+          (const guint16 *) in, nframes);
+      break;
+    case 4:
+      deinterleave_orc_2ch_32 ((guint32 *) out0, (guint32 *) out1,
+          (const guint32 *) in, nframes);
+      break;
+    default:
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
 #define gst_deinterleave_parent_class parent_class
 G_DEFINE_TYPE (GstDeinterleave, gst_deinterleave, GST_TYPE_ELEMENT);
 GST_ELEMENT_REGISTER_DEFINE (deinterleave, "deinterleave",
@@ -455,7 +489,9 @@ gst_deinterleave_sink_setcaps (GstDeinterleave * self, GstCaps * caps)
   /* Get srcpad caps */
   srccaps = gst_caps_copy (caps);
   s = gst_caps_get_structure (srccaps, 0);
-  gst_structure_set (s, "channels", G_TYPE_INT, 1, NULL);
+  /* mono is the same in both layouts */
+  gst_structure_set (s, "channels", G_TYPE_INT, 1, "layout", G_TYPE_STRING,
+      "interleaved", NULL);
   gst_structure_remove_field (s, "channel-mask");
 
   /* If we already have pads, update the caps otherwise
@@ -512,6 +548,8 @@ __remove_channels (GstCaps * caps)
     s = gst_caps_get_structure (caps, i);
     gst_structure_remove_field (s, "channel-mask");
     gst_structure_remove_field (s, "channels");
+    /* the layout is converted too */
+    gst_structure_remove_field (s, "layout");
   }
 }
 
@@ -833,15 +871,19 @@ gst_deinterleave_process (GstDeinterleave * self, GstBuffer * buf)
 {
   GstFlowReturn ret = GST_FLOW_OK;
   guint channels = GST_AUDIO_INFO_CHANNELS (&self->audio_info);
+  guint width = GST_AUDIO_INFO_WIDTH (&self->audio_info) / 8;
+  gboolean planar = GST_AUDIO_INFO_LAYOUT (&self->audio_info) ==
+      GST_AUDIO_LAYOUT_NON_INTERLEAVED;
+  GstAudioMeta *meta = planar ? gst_buffer_get_audio_meta (buf) : NULL;
   guint pads_pushed = 0, buffers_allocated = 0;
-  guint nframes =
-      gst_buffer_get_size (buf) / channels /
-      (GST_AUDIO_INFO_WIDTH (&self->audio_info) / 8);
-  guint bufsize = nframes * (GST_AUDIO_INFO_WIDTH (&self->audio_info) / 8);
-  guint i;
+  guint nframes = meta ? meta->samples :
+      gst_buffer_get_size (buf) / channels / width;
+  guint bufsize = nframes * width;
+  guint i, offset;
   GList *srcs;
   GstBuffer **buffers_out = g_new0 (GstBuffer *, channels);
-  guint8 *in, *out;
+  GstMapInfo *write_infos = NULL;
+  guint8 *in;
   GstMapInfo read_info;
   GList *pending_events, *l;
 
@@ -864,11 +906,18 @@ gst_deinterleave_process (GstDeinterleave * self, GstBuffer * buf)
     g_list_free (pending_events);
   }
 
-  gst_buffer_map (buf, &read_info, GST_MAP_READ);
-
-  /* Allocate buffers */
+  /* Allocate buffers. Planes of non-interleaved input are already laid out
+   * like the mono output, so they are shared instead of copied */
   for (srcs = self->srcpads, i = 0; srcs; srcs = srcs->next, i++) {
-    buffers_out[i] = gst_buffer_new_allocate (NULL, bufsize, NULL);
+    if (planar) {
+      gsize plane_offset = meta ? meta->offsets[i] : i * bufsize;
+
+      buffers_out[i] = gst_buffer_copy_region (buf, GST_BUFFER_COPY_FLAGS |
+          GST_BUFFER_COPY_TIMESTAMPS | GST_BUFFER_COPY_MEMORY, plane_offset,
+          bufsize);
+    } else {
+      buffers_out[i] = gst_buffer_new_allocate (NULL, bufsize, NULL);
+    }
 
     /* Make sure we got a correct buffer. The only other case we allow
      * here is an unliked pad */
@@ -879,8 +928,9 @@ gst_deinterleave_process (GstDeinterleave * self, GstBuffer * buf)
       goto alloc_buffer_bad_size;
 
     if (buffers_out[i]) {
-      gst_buffer_copy_into (buffers_out[i], buf, GST_BUFFER_COPY_METADATA, 0,
-          -1);
+      if (!planar)
+        gst_buffer_copy_into (buffers_out[i], buf, GST_BUFFER_COPY_METADATA,
+            0, -1);
       buffers_allocated++;
     }
   }
@@ -893,19 +943,41 @@ gst_deinterleave_process (GstDeinterleave * self, GstBuffer * buf)
     goto done;
   }
 
-  /* deinterleave */
+  /* deinterleave. Stereo is split in one pass, everything else in blocks of
+   * frames so that the input stays in the cache while it is distributed over
+   * all channels */
+  if (!planar) {
+    gst_buffer_map (buf, &read_info, GST_MAP_READ);
+    write_infos = g_new0 (GstMapInfo, channels);
+    for (i = 0; i < channels; i++)
+      gst_buffer_map (buffers_out[i], &write_infos[i], GST_MAP_WRITE);
+
+    if (channels == 2 && deinterleave_2ch (write_infos[0].data,
+            write_infos[1].data, read_info.data, width, nframes)) {
+      GST_LOG_OBJECT (self, "deinterleaved stereo with ORC");
+    } else {
+      for (offset = 0; offset < nframes; offset += DEINTERLEAVE_BLOCK_FRAMES) {
+        guint frames = MIN (DEINTERLEAVE_BLOCK_FRAMES, nframes - offset);
+
+        in = (guint8 *) read_info.data + offset * channels * width;
+        for (i = 0; i < channels; i++) {
+          self->func (write_infos[i].data + offset * width, in, channels,
+              frames);
+          in += width;
+        }
+      }
+    }
+
+    for (i = 0; i < channels; i++)
+      gst_buffer_unmap (buffers_out[i], &write_infos[i]);
+    g_free (write_infos);
+    gst_buffer_unmap (buf, &read_info);
+  }
+
   for (srcs = self->srcpads, i = 0; srcs; srcs = srcs->next, i++) {
     GstPad *pad = (GstPad *) srcs->data;
-    GstMapInfo write_info;
 
-    in = (guint8 *) read_info.data;
-    in += i * (GST_AUDIO_INFO_WIDTH (&self->audio_info) / 8);
     if (buffers_out[i]) {
-      gst_buffer_map (buffers_out[i], &write_info, GST_MAP_WRITE);
-      out = (guint8 *) write_info.data;
-      self->func (out, in, channels, nframes);
-      gst_buffer_unmap (buffers_out[i], &write_info);
-
       ret = gst_pad_push (pad, buffers_out[i]);
       buffers_out[i] = NULL;
       if (ret == GST_FLOW_OK)
@@ -924,7 +996,6 @@ gst_deinterleave_process (GstDeinterleave * self, GstBuffer * buf)
   GST_DEBUG_OBJECT (self, "Pushed on %d pads", pads_pushed);
 
 done:
-  gst_buffer_unmap (buf, &read_info);
   gst_buffer_unref (buf);
   g_free (buffers_out);
   return ret;
@@ -948,7 +1019,6 @@ push_failed:
   }
 clean_buffers:
   {
-    gst_buffer_unmap (buf, &read_info);
     for (i = 0; i < channels; i++) {
       if (buffers_out[i])
         gst_buffer_unref (buffers_out[i]);
@@ -45,6 +45,9 @@
  *
  * The channel number of every sinkpad in the out can be retrieved from the "channel" property of the pad.
  *
+ * This element waits for data on all sinkpads and is not suited for live
+ * sources, use audiointerleave for those.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 filesrc location=file.mp3 ! decodebin ! audioconvert ! "audio/x-raw,channels=2" ! deinterleave name=d  interleave name=i ! audioconvert ! wavenc ! filesink location=test.wav    d.src_0 ! queue ! audioconvert ! i.sink_1    d.src_1 ! queue ! audioconvert ! i.sink_0
@@ -72,6 +75,7 @@
 #include <string.h>
 #include "gstinterleaveelements.h"
 #include "interleave.h"
+#include "interleaveorc.h"
 
 #include <gst/audio/audio.h>
 #include <gst/audio/audio-enumtypes.h>
@@ -128,6 +132,42 @@ interleave_24 (guint8 * out, guint8 * in, guint stride, guint nframes)
   }
 }
 
+/* Interleaves two complete channels into stereo frames. Returns FALSE if
+ * there is no ORC kernel for the sample width */
+static gboolean
+interleave_2ch (guint8 * out, const guint8 * in0, const guint8 * in1,
+    gint width, guint nframes)
+{
+  switch (width) {
+    case 1:
+      interleave_orc_2ch_8 (out, in0, in1, nframes);
+      break;
+    case 2:
+      interleave_orc_2ch_16 ((guint16 *) out, (const guint16 *) in0,
+          (const guint16 *) in1, nframes);
+      break;
+    case 4:
+      interleave_orc_2ch_32 ((guint32 *) out, (const guint32 *) in0,
+          (const guint32 *) in1, nframes);
+      break;
+    default:
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Number of frames interleaved at once, small enough for the output block to
+ * stay in the cache while all channels are written into it */
+#define INTERLEAVE_BLOCK_FRAMES 256
+
+typedef struct
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  guint8 *out;
+} GstInterleaveInput;
+
 typedef struct
 {
   GstPad parent;
@@ -1178,10 +1218,11 @@ gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
   GSList *collected;
   guint nsamples;
   guint ncollected = 0;
-  gboolean empty = TRUE;
   gint width = self->width / 8;
   GstMapInfo write_info;
   GstClockTime timestamp = -1;
+  GstInterleaveInput *inputs;
+  guint i, n_inputs = 0, offset;
 
   size = gst_collect_pads_available (pads);
   if (size == 0)
@@ -1207,13 +1248,12 @@ gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
   }
 
   gst_buffer_map (outbuf, &write_info, GST_MAP_WRITE);
-  memset (write_info.data, 0, size * self->channels);
+
+  inputs = g_new0 (GstInterleaveInput, g_slist_length (pads->data));
 
   for (collected = pads->data; collected != NULL; collected = collected->next) {
     GstCollectData *cdata;
     GstBuffer *inbuf;
-    guint8 *outdata;
-    GstMapInfo input_info;
     gint channel;
 
     cdata = (GstCollectData *) collected->data;
@@ -1221,31 +1261,57 @@ gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
     inbuf = gst_collect_pads_take_buffer (pads, cdata, size);
     if (inbuf == NULL) {
       GST_DEBUG_OBJECT (cdata->pad, "No buffer available");
-      goto next;
+      continue;
     }
     ncollected++;
 
     if (timestamp == -1)
       timestamp = GST_BUFFER_TIMESTAMP (inbuf);
 
-    if (GST_BUFFER_FLAG_IS_SET (inbuf, GST_BUFFER_FLAG_GAP))
-      goto next;
+    if (GST_BUFFER_FLAG_IS_SET (inbuf, GST_BUFFER_FLAG_GAP)) {
+      gst_buffer_unref (inbuf);
+      continue;
+    }
 
-    empty = FALSE;
     channel = GST_INTERLEAVE_PAD_CAST (cdata->pad)->channel;
     if (self->channels <= 64 && self->channel_mask) {
       channel = self->default_channels_ordering_map[channel];
     }
-    outdata = write_info.data + width * channel;
 
-    gst_buffer_map (inbuf, &input_info, GST_MAP_READ);
-    self->func (outdata, input_info.data, self->channels, nsamples);
-    gst_buffer_unmap (inbuf, &input_info);
+    inputs[n_inputs].buffer = inbuf;
+    inputs[n_inputs].out = write_info.data + width * channel;
+    gst_buffer_map (inbuf, &inputs[n_inputs].map, GST_MAP_READ);
+    n_inputs++;
+  }
 
-  next:
-    if (inbuf)
-      gst_buffer_unref (inbuf);
+  /* Only silence the output if some channels are not written below */
+  if (n_inputs < self->channels)
+    memset (write_info.data, 0, size * self->channels);
+
+  /* Two complete channels are merged in one pass, everything else is
+   * interleaved in blocks of frames so that the output block stays in the
+   * cache while all channels are written into it */
+  if (n_inputs == 2 && self->channels == 2 &&
+      interleave_2ch (write_info.data,
+          inputs[inputs[0].out == write_info.data ? 0 : 1].map.data,
+          inputs[inputs[0].out == write_info.data ? 1 : 0].map.data, width,
+          nsamples)) {
+    GST_LOG_OBJECT (self, "interleaved stereo with ORC");
+  } else {
+    for (offset = 0; offset < nsamples; offset += INTERLEAVE_BLOCK_FRAMES) {
+      guint frames = MIN (INTERLEAVE_BLOCK_FRAMES, nsamples - offset);
+
+      for (i = 0; i < n_inputs; i++)
+        self->func (inputs[i].out + offset * width * self->channels,
+            inputs[i].map.data + offset * width, self->channels, frames);
+    }
+  }
+
+  for (i = 0; i < n_inputs; i++) {
+    gst_buffer_unmap (inputs[i].buffer, &inputs[i].map);
+    gst_buffer_unref (inputs[i].buffer);
   }
+  g_free (inputs);
 
   if (ncollected == 0) {
     gst_buffer_unmap (outbuf, &write_info);
@@ -1319,7 +1385,7 @@ gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
   GST_BUFFER_DURATION (outbuf) =
       self->timestamp - GST_BUFFER_TIMESTAMP (outbuf);
 
-  if (empty)
+  if (n_inputs == 0)
     GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
 
   gst_buffer_unmap (outbuf, &write_info);
@@ -331,6 +331,7 @@ enum
   PROP_START_GAP_THRESHOLD,
   PROP_FORCE_CREATE_TIMECODE_TRAK,
   PROP_FRAGMENT_MODE,
+  PROP_CHUNK_DURATION,
 };
 
 /* some spare for header size as well */
@@ -358,6 +359,7 @@ enum
 #define DEFAULT_START_GAP_THRESHOLD 0
 #define DEFAULT_FORCE_CREATE_TIMECODE_TRAK FALSE
 #define DEFAULT_FRAGMENT_MODE GST_QT_MUX_FRAGMENT_DASH_OR_MSS
+#define DEFAULT_CHUNK_DURATION 0
 
 static void gst_qt_mux_finalize (GObject * object);
 
@@ -620,6 +622,30 @@ gst_qt_mux_class_init (GstQTMuxClass * klass)
           GST_TYPE_QT_MUX_FRAGMENT_MODE, DEFAULT_FRAGMENT_MODE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstBaseQTMux:chunk-duration:
+   *
+   * Split each fragment into chunks of this duration in ms, as used for
+   * low-latency CMAF.  Every chunk is written as its own 'moof' and 'mdat'
+   * pair and pushed downstream as soon as it is complete, so only the
+   * samples of the current chunk are kept in memory.
+   *
+   * The 'moof' buffer of a chunk that starts a new fragment is pushed without
+   * the %GST_BUFFER_FLAG_DELTA_UNIT flag, the 'moof' of every following chunk
+   * of the same fragment has the flag set.  The last buffer of each chunk
+   * carries %GST_BUFFER_FLAG_MARKER.
+   *
+   * Only used when 'fragment-duration' is greater than 0 and 'fragment-mode'
+   * is "dash-or-mss".  0 disables chunking.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_CHUNK_DURATION,
+      g_param_spec_uint ("chunk-duration", "Chunk duration",
+          "Chunk durations in ms inside each fragment (0 = one chunk per "
+          "fragment)", 0, G_MAXUINT32, DEFAULT_CHUNK_DURATION,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_qt_mux_request_new_pad);
   gstelement_class->release_pad = GST_DEBUG_FUNCPTR (gst_qt_mux_release_pad);
@@ -678,6 +704,7 @@ gst_qt_mux_pad_reset (GstQTMuxPad * qtpad)
     atom_traf_free (qtpad->traf);
     qtpad->traf = NULL;
   }
+  qtpad->fragment_start = TRUE;
   atom_array_clear (&qtpad->fragment_buffers);
   if (qtpad->samples)
     g_array_unref (qtpad->samples);
@@ -3039,6 +3066,12 @@ gst_qt_mux_start_file (GstQTMux * qtmux)
         && qtmux->fragment_mode == GST_QT_MUX_FRAGMENT_DASH_OR_MSS) {
       qtmux->fragment_mode = GST_QT_MUX_FRAGMENT_STREAMABLE;
     }
+    if (qtmux->chunk_duration > 0
+        && qtmux->fragment_mode ==
+        GST_QT_MUX_FRAGMENT_FIRST_MOOV_THEN_FINALISE) {
+      GST_WARNING_OBJECT (qtmux, "chunk-duration is not supported in "
+          "first-moov-then-finalise fragment mode, ignoring");
+    }
   } else if (qtmux->fast_start) {
     qtmux->mux_mode = GST_QT_MUX_MODE_FAST_START;
   } else if (reserved_max_duration != GST_CLOCK_TIME_NONE) {
@@ -4231,19 +4264,26 @@ gst_qt_mux_pad_fragment_add_buffer (GstQTMux * qtmux, GstQTMuxPad * pad,
 {
   GstFlowReturn ret = GST_FLOW_OK;
   guint index = 0;
+  gboolean chunked, new_fragment;
 
   GST_LOG_OBJECT (pad, "%p %u %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT,
       pad->traf, force, qtmux->current_chunk_offset, chunk_offset);
 
+  chunked = qtmux->chunk_duration > 0 &&
+      qtmux->fragment_mode != GST_QT_MUX_FRAGMENT_FIRST_MOOV_THEN_FINALISE;
+
   /* setup if needed */
   if (G_UNLIKELY (!pad->traf || force))
     goto init;
 
 flush:
   /* flush pad fragment if threshold reached,
-   * or at new keyframe if we should be minding those in the first place */
-  if (G_UNLIKELY (force || (sync && pad->sync) ||
-          pad->fragment_duration < (gint64) delta)) {
+   * or at new keyframe if we should be minding those in the first place,
+   * or only the current chunk of the fragment if its threshold was reached */
+  new_fragment = force || (sync && pad->sync) ||
+      pad->fragment_duration < (gint64) delta;
+  if (G_UNLIKELY (new_fragment || (chunked
+              && pad->chunk_duration < (gint64) delta))) {
 
     if (qtmux->fragment_mode == GST_QT_MUX_FRAGMENT_FIRST_MOOV_THEN_FINALISE) {
       if (qtmux->fragment_sequence == 0) {
@@ -4410,6 +4450,17 @@ flush:
       if (pad->tfra)
         atom_tfra_update_offset (pad->tfra, qtmux->header_size);
 
+      if (chunked && atom_array_get_len (&pad->fragment_buffers) > 0) {
+        guint last = atom_array_get_len (&pad->fragment_buffers) - 1;
+        GstBuffer **last_buf = &atom_array_index (&pad->fragment_buffers, last);
+
+        /* let downstream know where fragments and chunks start and end */
+        if (!pad->fragment_start)
+          GST_BUFFER_FLAG_SET (moof_buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+        *last_buf = gst_buffer_make_writable (*last_buf);
+        GST_BUFFER_FLAG_SET (*last_buf, GST_BUFFER_FLAG_MARKER);
+      }
+
       GST_LOG_OBJECT (qtmux, "writing moof size %" G_GSIZE_FORMAT,
           gst_buffer_get_size (moof_buffer));
       ret =
@@ -4441,6 +4492,7 @@ flush:
     }
     atom_array_clear (&pad->fragment_buffers);
     qtmux->fragment_sequence++;
+    pad->fragment_start = new_fragment;
     force = FALSE;
   }
 
@@ -4469,11 +4521,21 @@ init:
   } else if (G_UNLIKELY (!pad->traf)) {
     GstClockTime first_dts = 0, current_dts;
     gint64 first_qt_dts;
-    GST_LOG_OBJECT (pad, "setting up new fragment");
     pad->traf = atom_traf_new (qtmux->context, atom_trak_get_id (pad->trak));
-    atom_array_init (&pad->fragment_buffers, 512);
-    pad->fragment_duration = gst_util_uint64_scale (qtmux->fragment_duration,
-        atom_trak_get_timescale (pad->trak), 1000);
+    if (chunked) {
+      GST_LOG_OBJECT (pad, "setting up new chunk");
+      /* a chunk only spans a few samples, keep the reserve small */
+      atom_array_init (&pad->fragment_buffers, 16);
+      pad->chunk_duration = gst_util_uint64_scale (qtmux->chunk_duration,
+          atom_trak_get_timescale (pad->trak), 1000);
+    } else {
+      atom_array_init (&pad->fragment_buffers, 512);
+    }
+    if (pad->fragment_start) {
+      GST_LOG_OBJECT (pad, "setting up new fragment");
+      pad->fragment_duration = gst_util_uint64_scale (qtmux->fragment_duration,
+          atom_trak_get_timescale (pad->trak), 1000);
+    }
 
     if (G_UNLIKELY (qtmux->mfra && !pad->tfra)) {
       pad->tfra = atom_tfra_new (qtmux->context, atom_trak_get_id (pad->trak));
@@ -4529,6 +4591,7 @@ init:
     atom_array_append (&pad->fragment_buffers, g_steal_pointer (&buf), 256);
   }
   pad->fragment_duration -= delta;
+  pad->chunk_duration -= delta;
 
   if (pad->tfra) {
     guint32 sn = atom_traf_get_sample_num (pad->traf);
@@ -7192,6 +7255,9 @@ gst_qt_mux_get_property (GObject * object,
       g_value_set_enum (value, mode);
       break;
     }
+    case PROP_CHUNK_DURATION:
+      g_value_set_uint (value, qtmux->chunk_duration);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -7292,6 +7358,9 @@ gst_qt_mux_set_property (GObject * object,
         qtmux->fragment_mode = mode;
       break;
     }
+    case PROP_CHUNK_DURATION:
+      qtmux->chunk_duration = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
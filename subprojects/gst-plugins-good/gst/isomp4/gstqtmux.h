@@ -155,6 +155,10 @@ struct _GstQTMuxPad
   ATOM_ARRAY (GstBuffer *) fragment_buffers;
   /* running fragment duration */
   gint64 fragment_duration;
+  /* running chunk duration, in chunked mode */
+  gint64 chunk_duration;
+  /* whether the current traf starts a new fragment, in chunked mode */
+  gboolean fragment_start;
   /* optional fragment index book-keeping */
   AtomTFRA *tfra;
 
@@ -308,6 +312,7 @@ struct _GstQTMux
   gchar *fast_start_file_path;
   gchar *moov_recov_file_path;
   guint32 fragment_duration;
+  guint32 chunk_duration;
   /* Whether or not to work in 'streamable' mode and not
    * seek to rewrite headers - only valid for fragmented
    * mode. Deprecated */
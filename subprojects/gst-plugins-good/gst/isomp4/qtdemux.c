@@ -87,6 +87,8 @@
 
 /* if the sample index is larger than this, something is likely wrong */
 #define QTDEMUX_MAX_SAMPLE_INDEX_SIZE (200*1024*1024)
+/* number of sample table entries allocated at once for moov samples */
+#define QTDEMUX_SAMPLES_CHUNK 4096
 
 /* For converting qt creation times to unix epoch times */
 #define QTDEMUX_SECONDS_PER_DAY (60 * 60 * 24)
@@ -1748,11 +1750,12 @@ gst_qtdemux_find_sample (GstQTDemux * qtdemux, gint64 byte_pos, gboolean fw,
       i = 0;
       inc = 1;
     } else {
-      i = str->n_samples - 1;
+      i = str->n_samples_alloc - 1;
       inc = -1;
     }
 
-    for (; (i >= 0) && (i < str->n_samples); i += inc) {
+    /* entries that are not allocated yet have not been parsed either */
+    for (; (i >= 0) && (i < str->n_samples_alloc); i += inc) {
       if (str->samples[i].size == 0)
         continue;
 
@@ -2507,6 +2510,7 @@ gst_qtdemux_stream_flush_samples_data (QtDemuxStream * stream)
 {
   g_free (stream->samples);
   stream->samples = NULL;
+  stream->n_samples_alloc = 0;
   gst_qtdemux_stbl_free (stream);
 
   /* fragments */
@@ -3386,6 +3390,7 @@ qtdemux_parse_trun (GstQTDemux * qtdemux, GstByteReader * trun,
         stream->n_samples + samples_count);
   if (stream->samples == NULL)
     goto out_of_memory;
+  stream->n_samples_alloc = stream->n_samples + samples_count;
 
   if (qtdemux->fragment_start != -1) {
     timestamp = GSTTIME_TO_QTSTREAMTIME (stream, qtdemux->fragment_start);
@@ -5432,7 +5437,7 @@ gst_qtdemux_sync_streams (GstQTDemux * demux)
         continue;
     } else {
       /* push mode is byte position based */
-      if (stream->n_samples &&
+      if (stream->n_samples && stream->n_samples == stream->n_samples_alloc &&
           stream->samples[stream->n_samples - 1].offset >= demux->offset)
         continue;
     }
@@ -6345,6 +6350,7 @@ gst_qtdemux_do_fragmented_seek (GstQTDemux * qtdemux)
     g_free (stream->samples);
     stream->samples = NULL;
     stream->n_samples = 0;
+    stream->n_samples_alloc = 0;
     stream->stbl_index = -1;    /* no samples have yet been parsed */
     stream->sample_index = -1;
 
@@ -9360,6 +9366,40 @@ qtdemux_merge_sample_table (GstQTDemux * qtdemux, QtDemuxStream * stream)
 }
 
 /* initialise bytereaders for stbl sub-atoms */
+/* make sure the sample table of @stream has room for sample @n, new entries
+ * are zeroed */
+static gboolean
+qtdemux_stream_grow_samples (GstQTDemux * qtdemux, QtDemuxStream * stream,
+    guint32 n)
+{
+  QtDemuxSample *samples;
+  guint32 n_alloc;
+
+  if (n < stream->n_samples_alloc)
+    return TRUE;
+
+  n_alloc = MAX (stream->n_samples_alloc * 2, QTDEMUX_SAMPLES_CHUNK);
+  n_alloc = MAX (n_alloc, n + 1);
+  n_alloc = MIN (n_alloc, stream->n_samples);
+
+  GST_DEBUG_OBJECT (qtdemux, "allocating n_samples %u of %u * %u (%.2f MB)",
+      n_alloc, stream->n_samples, (guint) sizeof (QtDemuxSample),
+      n_alloc * sizeof (QtDemuxSample) / (1024.0 * 1024.0));
+
+  samples = g_try_renew (QtDemuxSample, stream->samples, n_alloc);
+  if (!samples) {
+    GST_WARNING_OBJECT (qtdemux, "failed to allocate %d samples", n_alloc);
+    return FALSE;
+  }
+  memset (samples + stream->n_samples_alloc, 0,
+      (n_alloc - stream->n_samples_alloc) * sizeof (QtDemuxSample));
+
+  stream->samples = samples;
+  stream->n_samples_alloc = n_alloc;
+
+  return TRUE;
+}
+
 static gboolean
 qtdemux_stbl_init (GstQTDemux * qtdemux, QtDemuxStream * stream, GNode * stbl)
 {
@@ -9655,10 +9695,6 @@ qtdemux_stbl_init (GstQTDemux * qtdemux, QtDemuxStream * stream, GNode * stbl)
   }
 
 done:
-  GST_DEBUG_OBJECT (qtdemux, "allocating n_samples %u * %u (%.2f MB)",
-      stream->n_samples, (guint) sizeof (QtDemuxSample),
-      stream->n_samples * sizeof (QtDemuxSample) / (1024.0 * 1024.0));
-
   if (stream->n_samples >=
       QTDEMUX_MAX_SAMPLE_INDEX_SIZE / sizeof (QtDemuxSample)) {
     GST_WARNING_OBJECT (qtdemux, "not allocating index of %d samples, would "
@@ -9667,13 +9703,11 @@ done:
     return FALSE;
   }
 
+  /* only allocate the first entries, the table is grown as the samples
+   * get parsed */
   g_assert (stream->samples == NULL);
-  stream->samples = g_try_new0 (QtDemuxSample, stream->n_samples);
-  if (!stream->samples) {
-    GST_WARNING_OBJECT (qtdemux, "failed to allocate %d samples",
-        stream->n_samples);
+  if (!qtdemux_stream_grow_samples (qtdemux, stream, 0))
     return FALSE;
-  }
 
   return TRUE;
 
@@ -9734,6 +9768,9 @@ qtdemux_parse_samples (GstQTDemux * qtdemux, QtDemuxStream * stream, guint32 n)
     goto done;
   }
 
+  if (!qtdemux_stream_grow_samples (qtdemux, stream, n))
+    goto out_of_memory;
+
   /* pointer to the sample table */
   samples = stream->samples;
 
@@ -9989,7 +10026,13 @@ done3:
           /* note that the first sample is index 1, not 0 */
           guint32 index;
 
-          index = gst_byte_reader_get_uint32_be_unchecked (&stream->stss);
+          index = gst_byte_reader_peek_uint32_be_unchecked (&stream->stss);
+
+          /* the entry is not allocated yet, leave it for a later call */
+          if (G_UNLIKELY (index > stream->n_samples_alloc
+                  && index <= n_samples))
+            break;
+          gst_byte_reader_skip_unchecked (&stream->stss, 4);
 
           if (G_LIKELY (index > 0 && index <= n_samples)) {
             index -= 1;
@@ -10019,7 +10062,13 @@ done3:
             /* note that the first sample is index 1, not 0 */
             guint32 index;
 
-            index = gst_byte_reader_get_uint32_be_unchecked (&stream->stps);
+            index = gst_byte_reader_peek_uint32_be_unchecked (&stream->stps);
+
+            /* the entry is not allocated yet, leave it for a later call */
+            if (G_UNLIKELY (index > stream->n_samples_alloc
+                    && index <= n_samples))
+              break;
+            gst_byte_reader_skip_unchecked (&stream->stps, 4);
 
             if (G_LIKELY (index > 0 && index <= n_samples)) {
               index -= 1;
@@ -10132,6 +10181,13 @@ corrupt_file:
         (_("This file is corrupt and cannot be played.")), (NULL));
     return FALSE;
   }
+out_of_memory:
+  {
+    GST_OBJECT_UNLOCK (qtdemux);
+    GST_ELEMENT_ERROR (qtdemux, RESOURCE, FAILED, (NULL),
+        ("failed to allocate sample table for %u samples", n + 1));
+    return FALSE;
+  }
 }
 
 /* collect all segment info for @stream.
@@ -357,6 +357,8 @@ struct _QtDemuxStream
   /* our samples */
   guint32 n_samples;
   QtDemuxSample *samples;
+  guint32 n_samples_alloc;      /* allocated entries in samples, the table is
+                                 * grown as it gets parsed */
   gboolean all_keyframe;        /* TRUE when all samples are keyframes (no stss) */
   guint32 n_samples_moof;       /* sample count in a moof */
   guint64 duration_moof;        /* duration in timescale of a moof, used for figure out
@@ -43,6 +43,18 @@
  * * #GValueArray of #gdouble `rms`: the Root Mean Square (or average power) level in dB
  *   for each channel
  *
+ * If the #GstLevel:loudness property is %TRUE, the message also contains the
+ * loudness as defined by EBU R128, summed up over all channels:
+ *
+ * * #gdouble `momentary-loudness`: the loudness of the last 400ms in LUFS
+ * * #gdouble `short-term-loudness`: the loudness of the last 3s in LUFS
+ * * #gdouble `integrated-loudness`: the gated loudness since the start of
+ *   the stream in LUFS
+ *
+ * Applications that monitor many streams can disable the
+ * #GstLevel:post-messages property and poll the #GstLevel:levels property
+ * instead, which holds the same fields for the last interval.
+ *
  * ## Example application
  *
  * {{ tests/examples/level/level-example.c }}
@@ -76,7 +88,7 @@ GST_STATIC_PAD_TEMPLATE ("sink",
     GST_STATIC_CAPS ("audio/x-raw, "
         "format = (string) { S8, " GST_AUDIO_NE (S16) ", " GST_AUDIO_NE (S32)
         ", " GST_AUDIO_NE (F32) "," GST_AUDIO_NE (F64) " },"
-        "layout = (string) interleaved, "
+        "layout = (string) { interleaved, non-interleaved }, "
         "rate = (int) [ 1, MAX ], " "channels = (int) [ 1, MAX ]")
     );
 
@@ -87,7 +99,7 @@ GST_STATIC_PAD_TEMPLATE ("src",
     GST_STATIC_CAPS ("audio/x-raw, "
         "format = (string) { S8, " GST_AUDIO_NE (S16) ", " GST_AUDIO_NE (S32)
         ", " GST_AUDIO_NE (F32) "," GST_AUDIO_NE (F64) " },"
-        "layout = (string) interleaved, "
+        "layout = (string) { interleaved, non-interleaved }, "
         "rate = (int) [ 1, MAX ], " "channels = (int) [ 1, MAX ]")
     );
 
@@ -100,6 +112,8 @@ enum
   PROP_PEAK_TTL,
   PROP_PEAK_FALLOFF,
   PROP_AUDIO_LEVEL_META,
+  PROP_LOUDNESS,
+  PROP_LEVELS,
 };
 
 #define gst_level_parent_class parent_class
@@ -121,6 +135,8 @@ static void gst_level_post_message (GstLevel * filter);
 static gboolean gst_level_sink_event (GstBaseTransform * trans,
     GstEvent * event);
 static void gst_level_recalc_interval_frames (GstLevel * level);
+static void gst_level_setup_loudness (GstLevel * filter);
+static GstStructure *gst_level_structure_new (GstLevel * level);
 
 static void
 gst_level_class_init (GstLevelClass * klass)
@@ -184,6 +200,32 @@ gst_level_class_init (GstLevelClass * klass)
       g_param_spec_boolean ("audio-level-meta", "Audio Level Meta",
           "Set GstAudioLevelMeta on buffers", FALSE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstLevel:loudness:
+   *
+   * If %TRUE, measure the momentary, short-term and integrated loudness as
+   * defined by EBU R128 and add them to the level messages. Changing this
+   * restarts the measurement.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_LOUDNESS,
+      g_param_spec_boolean ("loudness", "Loudness",
+          "Measure EBU R128 loudness", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstLevel:levels:
+   *
+   * The measurements of the last interval as a #GstStructure with the same
+   * fields as the `level` message, or %NULL if no interval has passed yet.
+   * This is updated whether or not #GstLevel:post-messages is enabled.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_LEVELS,
+      g_param_spec_boxed ("levels", "Levels",
+          "The measurements of the last interval", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
   GST_DEBUG_CATEGORY_INIT (level_debug, "level", 0, "Level calculation");
 
@@ -221,6 +263,15 @@ gst_level_init (GstLevel * filter)
   filter->decay_peak = NULL;
   filter->decay_peak_base = NULL;
   filter->decay_peak_age = NULL;
+  filter->block_CS = NULL;
+  filter->levels_rms = NULL;
+  filter->levels_peak = NULL;
+  filter->levels_decay = NULL;
+  filter->kw_state = NULL;
+  filter->kw_weight = NULL;
+  filter->kw_CS = NULL;
+  filter->kw_hist_count = NULL;
+  filter->kw_hist_energy = NULL;
 
   gst_audio_info_init (&filter->info);
 
@@ -231,6 +282,7 @@ gst_level_init (GstLevel * filter)
   filter->post_messages = TRUE;
 
   filter->process = NULL;
+  filter->k_weight = NULL;
 
   gst_base_transform_set_gap_aware (GST_BASE_TRANSFORM (filter), TRUE);
   configure_passthrough (filter, filter->audio_level_meta);
@@ -247,6 +299,15 @@ gst_level_finalize (GObject * obj)
   g_free (filter->decay_peak);
   g_free (filter->decay_peak_base);
   g_free (filter->decay_peak_age);
+  g_free (filter->block_CS);
+  g_free (filter->levels_rms);
+  g_free (filter->levels_peak);
+  g_free (filter->levels_decay);
+  g_free (filter->kw_state);
+  g_free (filter->kw_weight);
+  g_free (filter->kw_CS);
+  g_free (filter->kw_hist_count);
+  g_free (filter->kw_hist_energy);
 
   filter->CS = NULL;
   filter->peak = NULL;
@@ -254,6 +315,15 @@ gst_level_finalize (GObject * obj)
   filter->decay_peak = NULL;
   filter->decay_peak_base = NULL;
   filter->decay_peak_age = NULL;
+  filter->block_CS = NULL;
+  filter->levels_rms = NULL;
+  filter->levels_peak = NULL;
+  filter->levels_decay = NULL;
+  filter->kw_state = NULL;
+  filter->kw_weight = NULL;
+  filter->kw_CS = NULL;
+  filter->kw_hist_count = NULL;
+  filter->kw_hist_energy = NULL;
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -291,6 +361,12 @@ gst_level_set_property (GObject * object, guint prop_id,
       configure_passthrough (filter, g_value_get_boolean (value));
       GST_OBJECT_LOCK (filter);
       break;
+    case PROP_LOUDNESS:
+      filter->loudness = g_value_get_boolean (value);
+      if (GST_AUDIO_INFO_RATE (&filter->info)) {
+        gst_level_setup_loudness (filter);
+      }
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -325,6 +401,12 @@ gst_level_get_property (GObject * object, guint prop_id,
     case PROP_AUDIO_LEVEL_META:
       g_value_set_boolean (value, filter->audio_level_meta);
       break;
+    case PROP_LOUDNESS:
+      g_value_set_boolean (value, filter->loudness);
+      break;
+    case PROP_LEVELS:
+      g_value_take_boxed (value, gst_level_structure_new (filter));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -334,90 +416,392 @@ gst_level_get_property (GObject * object, guint prop_id,
 }
 
 
-/* process one (interleaved) channel of incoming samples
- * calculate square sum of samples
- * normalize and average over number of samples
- * returns a normalized cumulative square value, which can be averaged
- * to return the average power as a double between 0 and 1
- * also returns the normalized peak power (square of the highest amplitude)
+/* process a block of incoming samples for all channels at once
+ * calculate square sum of samples for each channel
+ * returns in NCS the normalized cumulative square values, which can be
+ * averaged to return the average power as a double between 0 and 1
+ * also returns in NPS the normalized peak power (square of the highest
+ * amplitude) of each channel
  *
- * caller must assure num is a multiple of channels
- * samples for multiple channels are interleaved
- * input sample data enters in *in_data and is not modified
+ * planes contains the first plane only for interleaved data, and one plane
+ * per channel otherwise. offset and num are in frames
+ * input sample data is not modified
  * this filter only accepts signed audio data, so mid level is always 0
  *
+ * interleaved data is walked frame by frame, accumulating into independent
+ * per-channel sums, and planar data with several partial sums, so that the
+ * compiler can vectorize both without reordering additions
+ *
  * for integers, this code considers the non-existent positive max value to be
  * full-scale; so max-1 will not map to 1.0
  */
 
-#define DEFINE_INT_LEVEL_CALCULATOR(TYPE, RESOLUTION)                         \
-static void inline                                                            \
-gst_level_calculate_##TYPE (gpointer data, guint num, guint channels,         \
-                            gdouble *NCS, gdouble *NPS)                       \
+#define DEFINE_LEVEL_CALCULATOR(TYPE, NORMALIZER)                             \
+static void                                                                   \
+gst_level_calculate_##TYPE (gpointer * planes, guint offset, guint num,       \
+                            guint channels, gdouble *NCS, gdouble *NPS)       \
 {                                                                             \
-  TYPE * in = (TYPE *)data;                                                   \
-  register guint j;                                                           \
-  gdouble squaresum = 0.0;           /* square sum of the input samples */    \
-  register gdouble square = 0.0;     /* Square */                             \
-  register gdouble peaksquare = 0.0; /* Peak Square Sample */                 \
-  gdouble normalizer;                /* divisor to get a [-1.0, 1.0] range */ \
+  const TYPE *in = ((const TYPE *) planes[0]) + offset * channels;            \
+  const gdouble normalizer = (NORMALIZER);                                    \
+  guint i, c;                                                                 \
                                                                               \
-  /* *NCS = 0.0; Normalized Cumulative Square */                              \
-  /* *NPS = 0.0; Normalized Peak Square */                                    \
+  for (c = 0; c < channels; c++) {                                            \
+    NCS[c] = 0.0;                                                             \
+    NPS[c] = 0.0;                                                             \
+  }                                                                           \
+                                                                              \
+  for (i = 0; i < num; i++, in += channels) {                                 \
+    for (c = 0; c < channels; c++) {                                          \
+      gdouble square = ((gdouble) in[c]) * in[c];                             \
                                                                               \
-  for (j = 0; j < num; j += channels) {                                       \
-    square = ((gdouble) in[j]) * in[j];                                       \
-    if (square > peaksquare) peaksquare = square;                             \
-    squaresum += square;                                                      \
+      NCS[c] += square;                                                       \
+      NPS[c] = MAX (NPS[c], square);                                          \
+    }                                                                         \
   }                                                                           \
                                                                               \
-  normalizer = (gdouble) (G_GINT64_CONSTANT(1) << (RESOLUTION * 2));          \
-  *NCS = squaresum / normalizer;                                              \
-  *NPS = peaksquare / normalizer;                                             \
+  for (c = 0; c < channels; c++) {                                            \
+    NCS[c] /= normalizer;                                                     \
+    NPS[c] /= normalizer;                                                     \
+  }                                                                           \
+}                                                                             \
+                                                                              \
+static void                                                                   \
+gst_level_calculate_planar_##TYPE (gpointer * planes, guint offset,           \
+                            guint num, guint channels,                        \
+                            gdouble *NCS, gdouble *NPS)                       \
+{                                                                             \
+  const gdouble normalizer = (NORMALIZER);                                    \
+  guint i, c;                                                                 \
+                                                                              \
+  for (c = 0; c < channels; c++) {                                            \
+    const TYPE *in = ((const TYPE *) planes[c]) + offset;                     \
+    gdouble sum[4] = { 0.0, 0.0, 0.0, 0.0 };                                  \
+    gdouble peak[4] = { 0.0, 0.0, 0.0, 0.0 };                                 \
+                                                                              \
+    for (i = 0; i + 4 <= num; i += 4) {                                       \
+      guint k;                                                                \
+                                                                              \
+      for (k = 0; k < 4; k++) {                                               \
+        gdouble square = ((gdouble) in[i + k]) * in[i + k];                   \
+                                                                              \
+        sum[k] += square;                                                     \
+        peak[k] = MAX (peak[k], square);                                      \
+      }                                                                       \
+    }                                                                         \
+    for (; i < num; i++) {                                                    \
+      gdouble square = ((gdouble) in[i]) * in[i];                             \
+                                                                              \
+      sum[0] += square;                                                       \
+      peak[0] = MAX (peak[0], square);                                        \
+    }                                                                         \
+                                                                              \
+    NCS[c] = ((sum[0] + sum[1]) + (sum[2] + sum[3])) / normalizer;            \
+    NPS[c] = MAX (MAX (peak[0], peak[1]), MAX (peak[2], peak[3])) /           \
+        normalizer;                                                           \
+  }                                                                           \
 }
 
-DEFINE_INT_LEVEL_CALCULATOR (gint32, 31);
-DEFINE_INT_LEVEL_CALCULATOR (gint16, 15);
-DEFINE_INT_LEVEL_CALCULATOR (gint8, 7);
+#define INT_NORMALIZER(RESOLUTION) \
+    ((gdouble) (G_GINT64_CONSTANT (1) << ((RESOLUTION) * 2)))
 
-/* FIXME: use orc to calculate squaresums? */
-#define DEFINE_FLOAT_LEVEL_CALCULATOR(TYPE)                                   \
-static void inline                                                            \
-gst_level_calculate_##TYPE (gpointer data, guint num, guint channels,         \
-                            gdouble *NCS, gdouble *NPS)                       \
+DEFINE_LEVEL_CALCULATOR (gint32, INT_NORMALIZER (31));
+DEFINE_LEVEL_CALCULATOR (gint16, INT_NORMALIZER (15));
+DEFINE_LEVEL_CALCULATOR (gint8, INT_NORMALIZER (7));
+DEFINE_LEVEL_CALCULATOR (gfloat, 1.0);
+DEFINE_LEVEL_CALCULATOR (gdouble, 1.0);
+
+/* EBU R128 / ITU-R BS.1770 loudness
+ *
+ * each channel is K-weighted by a high shelf and a high pass biquad and the
+ * weighted power is summed up in 100ms sub-blocks. Momentary loudness is
+ * measured over the last 4 and short-term loudness over the last 30
+ * sub-blocks. For the integrated loudness every 400ms block (overlapping by
+ * 75%) above the absolute gate is added to a histogram with 0.1 LU bins, so
+ * the relative gate can be applied at any time without keeping all blocks
+ * around.
+ */
+#define LOUDNESS_MOMENTARY_BLOCKS 4
+#define LOUDNESS_SHORT_TERM_BLOCKS 30
+#define LOUDNESS_ABSOLUTE_GATE -70.0
+#define LOUDNESS_RELATIVE_GATE -10.0
+#define LOUDNESS_HIST_BINS 1000 /* -70 LUFS to +30 LUFS */
+
+#define DEFINE_K_WEIGHT(TYPE, NORMALIZER)                                     \
+static void                                                                   \
+gst_level_k_weight_##TYPE (GstLevel * filter, gpointer * planes,              \
+                           guint offset, guint num)                           \
 {                                                                             \
-  TYPE * in = (TYPE *)data;                                                   \
-  register guint j;                                                           \
-  gdouble squaresum = 0.0;           /* square sum of the input samples */    \
-  register gdouble square = 0.0;     /* Square */                             \
-  register gdouble peaksquare = 0.0; /* Peak Square Sample */                 \
+  const gdouble scale = 1.0 / (NORMALIZER);                                   \
+  const gdouble *s1 = filter->kw_coeffs[0], *s2 = filter->kw_coeffs[1];       \
+  guint channels = GST_AUDIO_INFO_CHANNELS (&filter->info);                   \
+  gboolean interleaved =                                                      \
+      GST_AUDIO_INFO_LAYOUT (&filter->info) == GST_AUDIO_LAYOUT_INTERLEAVED;  \
+  guint stride = interleaved ? channels : 1;                                  \
+  guint i, c;                                                                 \
                                                                               \
-  /* *NCS = 0.0; Normalized Cumulative Square */                              \
-  /* *NPS = 0.0; Normalized Peak Square */                                    \
+  for (c = 0; c < channels; c++) {                                            \
+    const TYPE *in;                                                           \
+    gdouble *z = &filter->kw_state[c * 4];                                    \
+    gdouble z0 = z[0], z1 = z[1], z2 = z[2], z3 = z[3];                       \
+    gdouble squaresum = 0.0;                                                  \
                                                                               \
-  /* orc_level_squaresum_f64(&squaresum,in,num); */                           \
-  for (j = 0; j < num; j += channels) {                                       \
-    square = ((gdouble) in[j]) * in[j];                                       \
-    if (square > peaksquare) peaksquare = square;                             \
-    squaresum += square;                                                      \
-  }                                                                           \
+    if (filter->kw_weight[c] == 0.0)                                          \
+      continue;                                                               \
                                                                               \
-  *NCS = squaresum;                                                           \
-  *NPS = peaksquare;                                                          \
+    if (interleaved)                                                          \
+      in = ((const TYPE *) planes[0]) + offset * channels + c;                \
+    else                                                                      \
+      in = ((const TYPE *) planes[c]) + offset;                               \
+                                                                              \
+    for (i = 0; i < num; i++, in += stride) {                                 \
+      gdouble x = *in * scale, y;                                             \
+                                                                              \
+      /* transposed direct form II */                                         \
+      y = s1[0] * x + z0;                                                     \
+      z0 = s1[1] * x - s1[3] * y + z1;                                        \
+      z1 = s1[2] * x - s1[4] * y;                                             \
+      x = y;                                                                  \
+      y = s2[0] * x + z2;                                                     \
+      z2 = s2[1] * x - s2[3] * y + z3;                                        \
+      z3 = s2[2] * x - s2[4] * y;                                             \
+                                                                              \
+      squaresum += y * y;                                                     \
+    }                                                                         \
+                                                                              \
+    z[0] = z0;                                                                \
+    z[1] = z1;                                                                \
+    z[2] = z2;                                                                \
+    z[3] = z3;                                                                \
+    filter->kw_CS[c] += squaresum;                                            \
+  }                                                                           \
 }
 
-DEFINE_FLOAT_LEVEL_CALCULATOR (gfloat);
-DEFINE_FLOAT_LEVEL_CALCULATOR (gdouble);
+/* the loudness is measured on amplitudes, so the square root of the
+ * normalizer used for the power above */
+DEFINE_K_WEIGHT (gint32, (gdouble) (G_GINT64_CONSTANT (1) << 31));
+DEFINE_K_WEIGHT (gint16, (gdouble) (1 << 15));
+DEFINE_K_WEIGHT (gint8, (gdouble) (1 << 7));
+DEFINE_K_WEIGHT (gfloat, 1.0);
+DEFINE_K_WEIGHT (gdouble, 1.0);
 
-/* we would need stride to deinterleave also
-static void inline
-gst_level_calculate_gdouble (gpointer data, guint num, guint channels,
-                            gdouble *NCS, gdouble *NPS)
+static gdouble
+gst_level_energy_to_lufs (gdouble energy)
 {
-  orc_level_squaresum_f64(NCS,(gdouble *)data,num);
-  *NPS = 0.0;
+  return -0.691 + 10 * log10 (energy + EPSILON);
+}
+
+/* called with object lock */
+static void
+gst_level_reset_loudness (GstLevel * filter)
+{
+  gint channels = GST_AUDIO_INFO_CHANNELS (&filter->info);
+
+  if (filter->kw_state)
+    memset (filter->kw_state, 0, sizeof (gdouble) * 4 * channels);
+  if (filter->kw_CS)
+    memset (filter->kw_CS, 0, sizeof (gdouble) * channels);
+  filter->kw_frames = 0;
+  filter->kw_block_idx = 0;
+  filter->kw_n_blocks = 0;
+  memset (filter->kw_blocks, 0, sizeof (filter->kw_blocks));
+
+  if (!filter->loudness_active)
+    return;
+
+  if (filter->kw_hist_count == NULL) {
+    filter->kw_hist_count = g_new0 (guint64, LOUDNESS_HIST_BINS);
+    filter->kw_hist_energy = g_new0 (gdouble, LOUDNESS_HIST_BINS);
+  } else {
+    memset (filter->kw_hist_count, 0, sizeof (guint64) * LOUDNESS_HIST_BINS);
+    memset (filter->kw_hist_energy, 0, sizeof (gdouble) * LOUDNESS_HIST_BINS);
+  }
+}
+
+/* called with object lock, from set_caps */
+static void
+gst_level_setup_loudness (GstLevel * filter)
+{
+  GstAudioInfo *info = &filter->info;
+  gint i, channels = GST_AUDIO_INFO_CHANNELS (info);
+  gint rate = GST_AUDIO_INFO_RATE (info);
+  gdouble f0, G, Q, K, Vh, Vb, a0;
+
+  g_free (filter->kw_state);
+  g_free (filter->kw_weight);
+  g_free (filter->kw_CS);
+  filter->kw_state = g_new0 (gdouble, 4 * channels);
+  filter->kw_weight = g_new (gdouble, channels);
+  filter->kw_CS = g_new0 (gdouble, channels);
+
+  for (i = 0; i < channels; i++) {
+    GstAudioChannelPosition pos = GST_AUDIO_CHANNEL_POSITION_NONE;
+
+    if (i < 64 && !GST_AUDIO_INFO_IS_UNPOSITIONED (info))
+      pos = GST_AUDIO_INFO_POSITION (info, i);
+
+    switch (pos) {
+      case GST_AUDIO_CHANNEL_POSITION_LFE1:
+      case GST_AUDIO_CHANNEL_POSITION_LFE2:
+        filter->kw_weight[i] = 0.0;
+        break;
+      case GST_AUDIO_CHANNEL_POSITION_REAR_LEFT:
+      case GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT:
+      case GST_AUDIO_CHANNEL_POSITION_SIDE_LEFT:
+      case GST_AUDIO_CHANNEL_POSITION_SIDE_RIGHT:
+      case GST_AUDIO_CHANNEL_POSITION_SURROUND_LEFT:
+      case GST_AUDIO_CHANNEL_POSITION_SURROUND_RIGHT:
+        filter->kw_weight[i] = 1.41;
+        break;
+      default:
+        filter->kw_weight[i] = 1.0;
+        break;
+    }
+  }
+
+  filter->kw_block_frames = MAX (rate / 10, 1);
+
+  /* the high pass corner is the highest frequency of the filters, the
+   * bilinear transform only works below nyquist */
+  filter->loudness_active = filter->loudness && rate > 2 * 1682;
+  if (filter->loudness && !filter->loudness_active)
+    GST_WARNING_OBJECT (filter, "sample rate %d too low for loudness", rate);
+
+  /* high shelf, modelling the acoustic effect of the head */
+  f0 = 1681.974450955533;
+  G = 3.999843853973347;
+  Q = 0.7071752369554196;
+  K = tan (G_PI * f0 / rate);
+  Vh = pow (10.0, G / 20.0);
+  Vb = pow (Vh, 0.4996667741545416);
+  a0 = 1.0 + K / Q + K * K;
+  filter->kw_coeffs[0][0] = (Vh + Vb * K / Q + K * K) / a0;
+  filter->kw_coeffs[0][1] = 2.0 * (K * K - Vh) / a0;
+  filter->kw_coeffs[0][2] = (Vh - Vb * K / Q + K * K) / a0;
+  filter->kw_coeffs[0][3] = 2.0 * (K * K - 1.0) / a0;
+  filter->kw_coeffs[0][4] = (1.0 - K / Q + K * K) / a0;
+
+  /* revised low-frequency B-curve high pass */
+  f0 = 38.13547087602444;
+  Q = 0.5003270373238773;
+  K = tan (G_PI * f0 / rate);
+  a0 = 1.0 + K / Q + K * K;
+  filter->kw_coeffs[1][0] = 1.0;
+  filter->kw_coeffs[1][1] = -2.0;
+  filter->kw_coeffs[1][2] = 1.0;
+  filter->kw_coeffs[1][3] = 2.0 * (K * K - 1.0) / a0;
+  filter->kw_coeffs[1][4] = (1.0 - K / Q + K * K) / a0;
+
+  gst_level_reset_loudness (filter);
+}
+
+/* called with object lock, returns the mean energy of the last @n
+ * sub-blocks, or of all of them if there are less */
+static gdouble
+gst_level_loudness_window (GstLevel * filter, guint n)
+{
+  gdouble energy = 0.0;
+  guint i, idx;
+
+  n = MIN (n, filter->kw_n_blocks);
+  if (n == 0)
+    return 0.0;
+
+  idx = filter->kw_block_idx;
+  for (i = 0; i < n; i++) {
+    idx = (idx + LOUDNESS_SHORT_TERM_BLOCKS - 1) % LOUDNESS_SHORT_TERM_BLOCKS;
+    energy += filter->kw_blocks[idx];
+  }
+
+  return energy / n;
+}
+
+/* called with object lock when a sub-block is complete */
+static void
+gst_level_finish_loudness_block (GstLevel * filter)
+{
+  gint i, channels = GST_AUDIO_INFO_CHANNELS (&filter->info);
+  gdouble energy = 0.0, lufs;
+  gint bin;
+
+  for (i = 0; i < channels; i++) {
+    energy += filter->kw_weight[i] * filter->kw_CS[i];
+    filter->kw_CS[i] = 0.0;
+  }
+  energy /= filter->kw_frames;
+  filter->kw_frames = 0;
+
+  filter->kw_blocks[filter->kw_block_idx] = energy;
+  filter->kw_block_idx =
+      (filter->kw_block_idx + 1) % LOUDNESS_SHORT_TERM_BLOCKS;
+  if (filter->kw_n_blocks < LOUDNESS_SHORT_TERM_BLOCKS)
+    filter->kw_n_blocks++;
+
+  if (filter->kw_n_blocks < LOUDNESS_MOMENTARY_BLOCKS)
+    return;
+
+  /* gate the 400ms block ending here */
+  energy = gst_level_loudness_window (filter, LOUDNESS_MOMENTARY_BLOCKS);
+  lufs = gst_level_energy_to_lufs (energy);
+  if (lufs < LOUDNESS_ABSOLUTE_GATE)
+    return;
+
+  bin = (gint) ((lufs - LOUDNESS_ABSOLUTE_GATE) * 10.0);
+  bin = CLAMP (bin, 0, LOUDNESS_HIST_BINS - 1);
+  filter->kw_hist_count[bin]++;
+  filter->kw_hist_energy[bin] += energy;
+}
+
+/* called with object lock */
+static gdouble
+gst_level_integrated_loudness (GstLevel * filter)
+{
+  guint64 count = 0;
+  gdouble energy = 0.0, gate;
+  gint i, start;
+
+  for (i = 0; i < LOUDNESS_HIST_BINS; i++) {
+    count += filter->kw_hist_count[i];
+    energy += filter->kw_hist_energy[i];
+  }
+  if (count == 0)
+    return gst_level_energy_to_lufs (0.0);
+
+  gate = gst_level_energy_to_lufs (energy / count) + LOUDNESS_RELATIVE_GATE;
+  start = (gint) ceil ((gate - LOUDNESS_ABSOLUTE_GATE) * 10.0);
+  start = CLAMP (start, 0, LOUDNESS_HIST_BINS - 1);
+
+  count = 0;
+  energy = 0.0;
+  for (i = start; i < LOUDNESS_HIST_BINS; i++) {
+    count += filter->kw_hist_count[i];
+    energy += filter->kw_hist_energy[i];
+  }
+  if (count == 0)
+    return gst_level_energy_to_lufs (0.0);
+
+  return gst_level_energy_to_lufs (energy / count);
+}
+
+/* called with object lock, K-weights @num frames starting at @offset and
+ * finishes all sub-blocks on the way. @planes is %NULL for gaps */
+static void
+gst_level_process_loudness (GstLevel * filter, gpointer * planes,
+    guint offset, guint num)
+{
+  while (num > 0) {
+    guint n = MIN (num, filter->kw_block_frames - filter->kw_frames);
+
+    if (planes)
+      filter->k_weight (filter, planes, offset, n);
+
+    filter->kw_frames += n;
+    offset += n;
+    num -= n;
+
+    if (filter->kw_frames == filter->kw_block_frames)
+      gst_level_finish_loudness_block (filter);
+  }
 }
-*/
 
 /* called with object lock */
 static void
@@ -450,37 +834,53 @@ gst_level_set_caps (GstBaseTransform * trans, GstCaps * in, GstCaps * out)
   GstLevel *filter = GST_LEVEL (trans);
   GstAudioInfo info;
   gint i, channels;
+  gboolean planar;
 
   if (!gst_audio_info_from_caps (&info, in))
     return FALSE;
 
   GST_OBJECT_LOCK (filter);
 
+  channels = GST_AUDIO_INFO_CHANNELS (&info);
+
+  /* mono interleaved data is a single plane as well */
+  planar = GST_AUDIO_INFO_LAYOUT (&info) == GST_AUDIO_LAYOUT_NON_INTERLEAVED
+      || channels == 1;
+
   switch (GST_AUDIO_INFO_FORMAT (&info)) {
     case GST_AUDIO_FORMAT_S8:
-      filter->process = gst_level_calculate_gint8;
+      filter->process = planar ? gst_level_calculate_planar_gint8 :
+          gst_level_calculate_gint8;
+      filter->k_weight = gst_level_k_weight_gint8;
       break;
     case GST_AUDIO_FORMAT_S16:
-      filter->process = gst_level_calculate_gint16;
+      filter->process = planar ? gst_level_calculate_planar_gint16 :
+          gst_level_calculate_gint16;
+      filter->k_weight = gst_level_k_weight_gint16;
       break;
     case GST_AUDIO_FORMAT_S32:
-      filter->process = gst_level_calculate_gint32;
+      filter->process = planar ? gst_level_calculate_planar_gint32 :
+          gst_level_calculate_gint32;
+      filter->k_weight = gst_level_k_weight_gint32;
       break;
     case GST_AUDIO_FORMAT_F32:
-      filter->process = gst_level_calculate_gfloat;
+      filter->process = planar ? gst_level_calculate_planar_gfloat :
+          gst_level_calculate_gfloat;
+      filter->k_weight = gst_level_k_weight_gfloat;
       break;
     case GST_AUDIO_FORMAT_F64:
-      filter->process = gst_level_calculate_gdouble;
+      filter->process = planar ? gst_level_calculate_planar_gdouble :
+          gst_level_calculate_gdouble;
+      filter->k_weight = gst_level_k_weight_gdouble;
       break;
     default:
       filter->process = NULL;
+      filter->k_weight = NULL;
       break;
   }
 
   filter->info = info;
 
-  channels = GST_AUDIO_INFO_CHANNELS (&info);
-
   /* allocate channel variable arrays */
   g_free (filter->CS);
   g_free (filter->peak);
@@ -488,6 +888,10 @@ gst_level_set_caps (GstBaseTransform * trans, GstCaps * in, GstCaps * out)
   g_free (filter->decay_peak);
   g_free (filter->decay_peak_base);
   g_free (filter->decay_peak_age);
+  g_free (filter->block_CS);
+  g_free (filter->levels_rms);
+  g_free (filter->levels_peak);
+  g_free (filter->levels_decay);
   filter->CS = g_new (gdouble, channels);
   filter->peak = g_new (gdouble, channels);
   filter->last_peak = g_new (gdouble, channels);
@@ -495,6 +899,11 @@ gst_level_set_caps (GstBaseTransform * trans, GstCaps * in, GstCaps * out)
   filter->decay_peak_base = g_new (gdouble, channels);
 
   filter->decay_peak_age = g_new (GstClockTime, channels);
+  filter->block_CS = g_new (gdouble, channels);
+  filter->levels_rms = g_new (gdouble, channels);
+  filter->levels_peak = g_new (gdouble, channels);
+  filter->levels_decay = g_new (gdouble, channels);
+  filter->have_levels = FALSE;
 
   for (i = 0; i < channels; ++i) {
     filter->CS[i] = filter->peak[i] = filter->last_peak[i] =
@@ -503,6 +912,7 @@ gst_level_set_caps (GstBaseTransform * trans, GstCaps * in, GstCaps * out)
   }
 
   gst_level_recalc_interval_frames (filter);
+  gst_level_setup_loudness (filter);
 
   GST_OBJECT_UNLOCK (filter);
   return TRUE;
@@ -513,79 +923,69 @@ gst_level_start (GstBaseTransform * trans)
 {
   GstLevel *filter = GST_LEVEL (trans);
 
+  GST_OBJECT_LOCK (filter);
   filter->num_frames = 0;
   filter->message_ts = GST_CLOCK_TIME_NONE;
+  filter->have_levels = FALSE;
+  gst_level_reset_loudness (filter);
+  GST_OBJECT_UNLOCK (filter);
 
   return TRUE;
 }
 
-static GstMessage *
-gst_level_message_new (GstLevel * level, GstClockTime timestamp,
-    GstClockTime duration)
+static void
+gst_level_structure_take_array (GstStructure * s, const gchar * field,
+    const gdouble * values, gint n)
 {
-  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (level);
-  GstStructure *s;
+  GValueArray *arr;
   GValue v = { 0, };
-  GstClockTime endtime, running_time, stream_time;
+  gint i;
 
-  running_time = gst_segment_to_running_time (&trans->segment, GST_FORMAT_TIME,
-      timestamp);
-  stream_time = gst_segment_to_stream_time (&trans->segment, GST_FORMAT_TIME,
-      timestamp);
-  /* endtime is for backwards compatibility */
-  endtime = stream_time + duration;
-
-  s = gst_structure_new ("level",
-      "endtime", GST_TYPE_CLOCK_TIME, endtime,
-      "timestamp", G_TYPE_UINT64, timestamp,
-      "stream-time", G_TYPE_UINT64, stream_time,
-      "running-time", G_TYPE_UINT64, running_time,
-      "duration", G_TYPE_UINT64, duration, NULL);
-
-  g_value_init (&v, G_TYPE_VALUE_ARRAY);
-  g_value_take_boxed (&v, g_value_array_new (0));
-  gst_structure_take_value (s, "rms", &v);
-
-  g_value_init (&v, G_TYPE_VALUE_ARRAY);
-  g_value_take_boxed (&v, g_value_array_new (0));
-  gst_structure_take_value (s, "peak", &v);
+  arr = g_value_array_new (n);
+  g_value_init (&v, G_TYPE_DOUBLE);
+  for (i = 0; i < n; i++) {
+    g_value_set_double (&v, values[i]);
+    g_value_array_append (arr, &v);     /* copies by value */
+  }
+  g_value_unset (&v);
 
   g_value_init (&v, G_TYPE_VALUE_ARRAY);
-  g_value_take_boxed (&v, g_value_array_new (0));
-  gst_structure_take_value (s, "decay", &v);
-
-  return gst_message_new_element (GST_OBJECT (level), s);
+  g_value_take_boxed (&v, arr);
+  gst_structure_take_value (s, field, &v);
 }
 
-static void
-gst_level_message_append_channel (GstMessage * m, gdouble rms, gdouble peak,
-    gdouble decay)
+/* called with object lock, creates the structure for the level message from
+ * the results of the last interval */
+static GstStructure *
+gst_level_structure_new (GstLevel * level)
 {
-  const GValue *array_val;
   GstStructure *s;
-  GValueArray *arr;
-  GValue v = { 0, };
-
-  g_value_init (&v, G_TYPE_DOUBLE);
+  gint channels = GST_AUDIO_INFO_CHANNELS (&level->info);
 
-  s = (GstStructure *) gst_message_get_structure (m);
+  if (!level->have_levels)
+    return NULL;
 
-  array_val = gst_structure_get_value (s, "rms");
-  arr = (GValueArray *) g_value_get_boxed (array_val);
-  g_value_set_double (&v, rms);
-  g_value_array_append (arr, &v);       /* copies by value */
-
-  array_val = gst_structure_get_value (s, "peak");
-  arr = (GValueArray *) g_value_get_boxed (array_val);
-  g_value_set_double (&v, peak);
-  g_value_array_append (arr, &v);       /* copies by value */
-
-  array_val = gst_structure_get_value (s, "decay");
-  arr = (GValueArray *) g_value_get_boxed (array_val);
-  g_value_set_double (&v, decay);
-  g_value_array_append (arr, &v);       /* copies by value */
+  /* endtime is for backwards compatibility */
+  s = gst_structure_new ("level",
+      "endtime", GST_TYPE_CLOCK_TIME,
+      level->levels_stream_time + level->levels_duration,
+      "timestamp", G_TYPE_UINT64, level->levels_ts,
+      "stream-time", G_TYPE_UINT64, level->levels_stream_time,
+      "running-time", G_TYPE_UINT64, level->levels_running_time,
+      "duration", G_TYPE_UINT64, level->levels_duration, NULL);
+
+  gst_level_structure_take_array (s, "rms", level->levels_rms, channels);
+  gst_level_structure_take_array (s, "peak", level->levels_peak, channels);
+  gst_level_structure_take_array (s, "decay", level->levels_decay, channels);
+
+  if (level->loudness_active) {
+    gst_structure_set (s,
+        "momentary-loudness", G_TYPE_DOUBLE, level->levels_momentary,
+        "short-term-loudness", G_TYPE_DOUBLE, level->levels_short_term,
+        "integrated-loudness", G_TYPE_DOUBLE, level->levels_integrated, NULL);
+  }
 
-  g_value_unset (&v);
+  return s;
 }
 
 static void
@@ -610,36 +1010,35 @@ static GstFlowReturn
 gst_level_transform_ip (GstBaseTransform * trans, GstBuffer * in)
 {
   GstLevel *filter;
-  GstMapInfo map;
-  guint8 *in_data;
-  gsize in_size;
-  gdouble CS;
+  GstAudioBuffer abuf;
   guint i;
-  guint num_frames;
+  guint num_frames, offset = 0;
   guint num_int_samples = 0;    /* number of interleaved samples
                                  * ie. total count for all channels combined */
-  guint block_size, block_int_size;     /* we subdivide buffers to not skip message
-                                         * intervals */
+  guint block_size;             /* we subdivide buffers to not skip message
+                                 * intervals */
   GstClockTimeDiff falloff_time;
-  gint channels, rate, bps;
+  gint channels, rate;
+  gboolean gap;
   gdouble CS_tot = 0;           /* Total Cumulative Square on all samples */
 
   filter = GST_LEVEL (trans);
 
   channels = GST_AUDIO_INFO_CHANNELS (&filter->info);
-  bps = GST_AUDIO_INFO_BPS (&filter->info);
   rate = GST_AUDIO_INFO_RATE (&filter->info);
 
-  gst_buffer_map (in, &map, GST_MAP_READ);
-  in_data = map.data;
-  in_size = map.size;
+  if (!gst_audio_buffer_map (&abuf, &filter->info, in, GST_MAP_READ)) {
+    GST_ELEMENT_ERROR (filter, STREAM, FAILED, (NULL),
+        ("Failed to map buffer"));
+    return GST_FLOW_ERROR;
+  }
 
-  num_int_samples = in_size / bps;
+  num_frames = abuf.n_samples;
+  num_int_samples = num_frames * channels;
+  gap = GST_BUFFER_FLAG_IS_SET (in, GST_BUFFER_FLAG_GAP);
 
   GST_LOG_OBJECT (filter, "analyzing %u sample frames at ts %" GST_TIME_FORMAT,
-      num_int_samples, GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (in)));
-
-  g_return_val_if_fail (num_int_samples % channels == 0, GST_FLOW_ERROR);
+      num_frames, GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (in)));
 
   GST_OBJECT_LOCK (filter);
 
@@ -651,21 +1050,26 @@ gst_level_transform_ip (GstBaseTransform * trans, GstBuffer * in)
     filter->message_ts = GST_BUFFER_TIMESTAMP (in);
   }
 
-  num_frames = num_int_samples / channels;
   while (num_frames > 0) {
     block_size = filter->interval_frames - filter->num_frames;
     block_size = MIN (block_size, num_frames);
-    block_int_size = block_size * channels;
+
+    if (!gap) {
+      filter->process (abuf.planes, offset, block_size, channels,
+          filter->block_CS, filter->peak);
+    }
+    if (filter->loudness_active) {
+      gst_level_process_loudness (filter, gap ? NULL : abuf.planes, offset,
+          block_size);
+    }
 
     for (i = 0; i < channels; ++i) {
-      if (!GST_BUFFER_FLAG_IS_SET (in, GST_BUFFER_FLAG_GAP)) {
-        filter->process (in_data + (bps * i), block_int_size, channels, &CS,
-            &filter->peak[i]);
-        CS_tot += CS;
+      if (!gap) {
+        CS_tot += filter->block_CS[i];
         GST_LOG_OBJECT (filter,
             "[%d]: cumulative squares %lf, over %d samples/%d channels",
-            i, CS, block_int_size, channels);
-        filter->CS[i] += CS;
+            i, filter->block_CS[i], block_size * channels, channels);
+        filter->CS[i] += filter->block_CS[i];
       } else {
         filter->peak[i] = 0.0;
       }
@@ -715,7 +1119,7 @@ gst_level_transform_ip (GstBaseTransform * trans, GstBuffer * in)
         filter->decay_peak_age[i] = G_GINT64_CONSTANT (0);
       }
     }
-    in_data += block_size * bps * channels;
+    offset += block_size;
 
     filter->num_frames += block_size;
     num_frames -= block_size;
@@ -726,7 +1130,7 @@ gst_level_transform_ip (GstBaseTransform * trans, GstBuffer * in)
     }
   }
 
-  gst_buffer_unmap (in, &map);
+  gst_audio_buffer_unmap (&abuf);
 
   if (filter->audio_level_meta) {
     gdouble RMS = sqrt (CS_tot / num_int_samples);
@@ -743,6 +1147,7 @@ gst_level_transform_ip (GstBaseTransform * trans, GstBuffer * in)
 static void
 gst_level_post_message (GstLevel * filter)
 {
+  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (filter);
   guint i;
   gint channels, rate, frames = filter->num_frames;
   GstClockTime duration;
@@ -751,55 +1156,82 @@ gst_level_post_message (GstLevel * filter)
   rate = GST_AUDIO_INFO_RATE (&filter->info);
   duration = GST_FRAMES_TO_CLOCK_TIME (frames, rate);
 
-  if (filter->post_messages) {
-    GstMessage *m =
-        gst_level_message_new (filter, filter->message_ts, duration);
+  GST_LOG_OBJECT (filter,
+      "message: ts %" GST_TIME_FORMAT ", duration %" GST_TIME_FORMAT
+      ", num_frames %d", GST_TIME_ARGS (filter->message_ts),
+      GST_TIME_ARGS (duration), frames);
 
+  filter->levels_ts = filter->message_ts;
+  filter->levels_duration = duration;
+  filter->levels_running_time =
+      gst_segment_to_running_time (&trans->segment, GST_FORMAT_TIME,
+      filter->message_ts);
+  filter->levels_stream_time =
+      gst_segment_to_stream_time (&trans->segment, GST_FORMAT_TIME,
+      filter->message_ts);
+
+  for (i = 0; i < channels; ++i) {
+    gdouble RMS;
+    gdouble RMSdB, peakdB, decaydB;
+
+    RMS = sqrt (filter->CS[i] / frames);
+    GST_LOG_OBJECT (filter,
+        "message: channel %d, CS %f, RMS %f", i, filter->CS[i], RMS);
+    GST_LOG_OBJECT (filter,
+        "message: last_peak: %f, decay_peak: %f",
+        filter->last_peak[i], filter->decay_peak[i]);
+    /* RMS values are calculated in amplitude, so 20 * log 10 */
+    RMSdB = 20 * log10 (RMS + EPSILON);
+    /* peak values are square sums, ie. power, so 10 * log 10 */
+    peakdB = 10 * log10 (filter->last_peak[i] + EPSILON);
+    decaydB = 10 * log10 (filter->decay_peak[i] + EPSILON);
+
+    if (filter->decay_peak[i] < filter->last_peak[i]) {
+      /* this can happen in certain cases, for example when
+       * the last peak is between decay_peak and decay_peak_base */
+      GST_DEBUG_OBJECT (filter,
+          "message: decay peak dB %f smaller than last peak dB %f, copying",
+          decaydB, peakdB);
+      filter->decay_peak[i] = filter->last_peak[i];
+    }
     GST_LOG_OBJECT (filter,
-        "message: ts %" GST_TIME_FORMAT ", duration %" GST_TIME_FORMAT
-        ", num_frames %d", GST_TIME_ARGS (filter->message_ts),
-        GST_TIME_ARGS (duration), frames);
+        "message: RMS %f dB, peak %f dB, decay %f dB",
+        RMSdB, peakdB, decaydB);
 
-    for (i = 0; i < channels; ++i) {
-      gdouble RMS;
-      gdouble RMSdB, peakdB, decaydB;
+    filter->levels_rms[i] = RMSdB;
+    filter->levels_peak[i] = peakdB;
+    filter->levels_decay[i] = decaydB;
 
-      RMS = sqrt (filter->CS[i] / frames);
-      GST_LOG_OBJECT (filter,
-          "message: channel %d, CS %f, RMS %f", i, filter->CS[i], RMS);
-      GST_LOG_OBJECT (filter,
-          "message: last_peak: %f, decay_peak: %f",
-          filter->last_peak[i], filter->decay_peak[i]);
-      /* RMS values are calculated in amplitude, so 20 * log 10 */
-      RMSdB = 20 * log10 (RMS + EPSILON);
-      /* peak values are square sums, ie. power, so 10 * log 10 */
-      peakdB = 10 * log10 (filter->last_peak[i] + EPSILON);
-      decaydB = 10 * log10 (filter->decay_peak[i] + EPSILON);
-
-      if (filter->decay_peak[i] < filter->last_peak[i]) {
-        /* this can happen in certain cases, for example when
-         * the last peak is between decay_peak and decay_peak_base */
-        GST_DEBUG_OBJECT (filter,
-            "message: decay peak dB %f smaller than last peak dB %f, copying",
-            decaydB, peakdB);
-        filter->decay_peak[i] = filter->last_peak[i];
-      }
-      GST_LOG_OBJECT (filter,
-          "message: RMS %f dB, peak %f dB, decay %f dB",
-          RMSdB, peakdB, decaydB);
+    /* reset cumulative and normal peak */
+    filter->CS[i] = 0.0;
+    filter->last_peak[i] = 0.0;
+  }
 
-      gst_level_message_append_channel (m, RMSdB, peakdB, decaydB);
+  if (filter->loudness_active) {
+    filter->levels_momentary =
+        gst_level_energy_to_lufs (gst_level_loudness_window (filter,
+            LOUDNESS_MOMENTARY_BLOCKS));
+    filter->levels_short_term =
+        gst_level_energy_to_lufs (gst_level_loudness_window (filter,
+            LOUDNESS_SHORT_TERM_BLOCKS));
+    filter->levels_integrated = gst_level_integrated_loudness (filter);
+    GST_LOG_OBJECT (filter,
+        "message: momentary %f LUFS, short-term %f LUFS, integrated %f LUFS",
+        filter->levels_momentary, filter->levels_short_term,
+        filter->levels_integrated);
+  }
 
-      /* reset cumulative and normal peak */
-      filter->CS[i] = 0.0;
-      filter->last_peak[i] = 0.0;
-    }
+  filter->have_levels = TRUE;
+
+  if (filter->post_messages) {
+    GstMessage *m = gst_message_new_element (GST_OBJECT (filter),
+        gst_level_structure_new (filter));
 
     GST_OBJECT_UNLOCK (filter);
     gst_element_post_message (GST_ELEMENT (filter), m);
     GST_OBJECT_LOCK (filter);
-
   }
+
   filter->num_frames -= frames;
   filter->message_ts += duration;
 }
@@ -808,12 +1240,17 @@ gst_level_post_message (GstLevel * filter)
 static gboolean
 gst_level_sink_event (GstBaseTransform * trans, GstEvent * event)
 {
-  if (GST_EVENT_TYPE (event) == GST_EVENT_EOS) {
-    GstLevel *filter = GST_LEVEL (trans);
+  GstLevel *filter = GST_LEVEL (trans);
 
+  if (GST_EVENT_TYPE (event) == GST_EVENT_EOS) {
     GST_OBJECT_LOCK (filter);
     gst_level_post_message (filter);
     GST_OBJECT_UNLOCK (filter);
+  } else if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP) {
+    /* the integrated loudness restarts after a seek */
+    GST_OBJECT_LOCK (filter);
+    gst_level_reset_loudness (filter);
+    GST_OBJECT_UNLOCK (filter);
   }
 
   return GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (trans, event);
@@ -62,6 +62,7 @@ struct _GstLevel {
   gdouble decay_peak_ttl;       /* time to live for peak in nanoseconds */
   gdouble decay_peak_falloff;   /* falloff in dB/sec */
   gboolean audio_level_meta; /* whether or not generate GstAudioLevelMeta */
+  gboolean loudness;            /* whether or not to measure EBU R128 loudness */
 
   GstAudioInfo info;
   gint num_frames;              /* frame count (1 sample per channel)
@@ -76,8 +77,37 @@ struct _GstLevel {
   gdouble *decay_peak;          /* running decaying normalized Peak */
   gdouble *decay_peak_base;     /* value of last peak we are decaying from */
   GstClockTime *decay_peak_age; /* age of last peak */
-
-  void (*process)(gpointer, guint, guint, gdouble*, gdouble*);
+  gdouble *block_CS;            /* normalized Cumulative Square over block */
+
+  /* results of the last interval, in dB */
+  gboolean have_levels;
+  GstClockTime levels_ts;
+  GstClockTime levels_stream_time;
+  GstClockTime levels_running_time;
+  GstClockTime levels_duration;
+  gdouble *levels_rms;
+  gdouble *levels_peak;
+  gdouble *levels_decay;
+  gdouble levels_momentary;     /* in LUFS */
+  gdouble levels_short_term;
+  gdouble levels_integrated;
+
+  /* EBU R128 loudness state */
+  gboolean loudness_active;     /* loudness enabled and possible at this rate */
+  gdouble kw_coeffs[2][5];      /* K-weighting biquads, b0, b1, b2, a1, a2 */
+  gdouble *kw_state;            /* 2 biquads with 2 delays per channel */
+  gdouble *kw_weight;           /* per-channel weighting */
+  gdouble *kw_CS;               /* K-weighted Cumulative Square over sub-block */
+  guint kw_block_frames;        /* frames in a 100ms sub-block */
+  guint kw_frames;              /* frames in the current sub-block */
+  gdouble kw_blocks[30];        /* energy of the last 3s of sub-blocks */
+  guint kw_block_idx;
+  guint kw_n_blocks;
+  guint64 *kw_hist_count;       /* gated 400ms blocks per 0.1 LU */
+  gdouble *kw_hist_energy;
+
+  void (*process)(gpointer *, guint, guint, guint, gdouble*, gdouble*);
+  void (*k_weight)(GstLevel *, gpointer *, guint, guint);
 };
 
 struct _GstLevelClass {
@@ -26,6 +26,7 @@
 #include <glib.h>
 #include <gst/gst.h>
 #include <gst/base/gstbytewriter.h>
+#include <gst/base/gstaggregator.h>
 
 G_BEGIN_DECLS
 
@@ -45,7 +46,8 @@ G_BEGIN_DECLS
 typedef struct _GstEbmlWrite {
   GstObject object;
 
-  GstPad *srcpad;
+  /* not reffed, the aggregator owns the writer */
+  GstAggregator *aggregator;
   guint64 pos;
   guint64 last_pos;
   GstClockTime timestamp;
@@ -70,7 +72,7 @@ typedef struct _GstEbmlWriteClass {
 
 GType   gst_ebml_write_get_type      (void);
 
-GstEbmlWrite *gst_ebml_write_new     (GstPad *srcpad);
+GstEbmlWrite *gst_ebml_write_new     (GstAggregator *aggregator);
 void    gst_ebml_write_reset         (GstEbmlWrite *ebml);
 
 GstFlowReturn gst_ebml_last_write_result (GstEbmlWrite *ebml);
@@ -332,6 +332,11 @@ gst_matroska_demux_reset (GstElement * element)
     demux->clusters = NULL;
   }
 
+  if (demux->cluster_times) {
+    g_array_unref (demux->cluster_times);
+    demux->cluster_times = NULL;
+  }
+
   g_list_foreach (demux->seek_parsed,
       (GFunc) gst_matroska_read_common_free_parsed_el, NULL);
   g_list_free (demux->seek_parsed);
@@ -2079,6 +2084,104 @@ gst_matroska_demux_move_to_entry (GstMatroskaDemux * demux,
   return TRUE;
 }
 
+/* upper bound of the cluster times table, half of the entries are dropped
+ * when it is full so that the table still covers the whole file */
+#define MAX_CLUSTER_TIMES 8192
+
+typedef struct
+{
+  guint64 offset;
+  GstClockTime time;
+} GstMatroskaClusterTime;
+
+static gint
+gst_matroska_cluster_time_compare (GstMatroskaClusterTime * c1,
+    guint64 * offset)
+{
+  if (c1->offset < *offset)
+    return -1;
+  else if (c1->offset > *offset)
+    return 1;
+  else
+    return 0;
+}
+
+/* remember the time of the cluster at @offset for later seeks */
+static void
+gst_matroska_demux_add_cluster_time (GstMatroskaDemux * demux,
+    guint64 offset, GstClockTime time)
+{
+  GstMatroskaClusterTime entry, *prev;
+  guint idx = 0;
+
+  if (!GST_CLOCK_TIME_IS_VALID (time))
+    return;
+
+  if (G_UNLIKELY (!demux->cluster_times))
+    demux->cluster_times =
+        g_array_sized_new (FALSE, FALSE, sizeof (GstMatroskaClusterTime), 256);
+
+  prev = gst_util_array_binary_search (demux->cluster_times->data,
+      demux->cluster_times->len, sizeof (GstMatroskaClusterTime),
+      (GCompareDataFunc) gst_matroska_cluster_time_compare,
+      GST_SEARCH_MODE_BEFORE, &offset, NULL);
+  if (prev) {
+    if (prev->offset == offset)
+      return;
+    idx = prev - (GstMatroskaClusterTime *) demux->cluster_times->data + 1;
+  }
+
+  if (demux->cluster_times->len >= MAX_CLUSTER_TIMES) {
+    GstMatroskaClusterTime *entries;
+    guint i;
+
+    GST_DEBUG_OBJECT (demux, "cluster times table full, thinning out");
+    entries = (GstMatroskaClusterTime *) demux->cluster_times->data;
+    for (i = 0; 2 * i < demux->cluster_times->len; i++)
+      entries[i] = entries[2 * i];
+    g_array_set_size (demux->cluster_times, i);
+    idx = (idx + 1) / 2;
+  }
+
+  entry.offset = offset;
+  entry.time = time;
+  g_array_insert_val (demux->cluster_times, idx, entry);
+}
+
+/* narrow down the range [@apos, @opos] to search for @time in with the
+ * clusters seen so far */
+static void
+gst_matroska_demux_narrow_search (GstMatroskaDemux * demux, GstClockTime time,
+    gint64 * apos, GstClockTime * atime, gint64 * opos, GstClockTime * otime)
+{
+  GstMatroskaClusterTime *entries;
+  guint i;
+
+  if (!demux->cluster_times || !GST_CLOCK_TIME_IS_VALID (time))
+    return;
+
+  entries = (GstMatroskaClusterTime *) demux->cluster_times->data;
+  for (i = 0; i < demux->cluster_times->len; i++) {
+    if (entries[i].time > time)
+      break;
+  }
+
+  if (i > 0 && entries[i - 1].offset >= *apos &&
+      entries[i - 1].offset <= *opos && entries[i - 1].time >= *atime) {
+    *apos = entries[i - 1].offset;
+    *atime = entries[i - 1].time;
+  }
+  if (i < demux->cluster_times->len && entries[i].offset >= *apos &&
+      (*otime <= time || entries[i].offset <= *opos)) {
+    *opos = entries[i].offset;
+    *otime = entries[i].time;
+  }
+
+  GST_DEBUG_OBJECT (demux, "narrowed search for %" GST_TIME_FORMAT
+      " to %" G_GINT64_FORMAT " - %" G_GINT64_FORMAT " using %u known clusters",
+      GST_TIME_ARGS (time), *apos, *opos, demux->cluster_times->len);
+}
+
 static gint
 gst_matroska_cluster_compare (gint64 * i1, gint64 * i2)
 {
@@ -2565,6 +2668,10 @@ gst_matroska_demux_search_pos (GstMatroskaDemux * demux, GstClockTime time)
   otime = MAX (otime, atime);
   opos = MAX (opos, apos);
 
+  /* start from the closest clusters seen so far */
+  gst_matroska_demux_narrow_search (demux, time, &apos, &atime, &opos,
+      &otime);
+
   maxpos = gst_matroska_read_common_get_length (&demux->common);
 
   /* invariants;
@@ -5739,6 +5846,8 @@ gst_matroska_demux_parse_id (GstMatroskaDemux * demux, guint32 id,
             goto parse_failed;
           GST_DEBUG_OBJECT (demux, "ClusterTimeCode: %" G_GUINT64_FORMAT, num);
           demux->cluster_time = num;
+          gst_matroska_demux_add_cluster_time (demux, demux->cluster_offset,
+              demux->cluster_time * demux->common.time_scale);
           /* track last cluster */
           if (demux->cluster_offset > demux->last_cluster_offset) {
             demux->last_cluster_offset = demux->cluster_offset;
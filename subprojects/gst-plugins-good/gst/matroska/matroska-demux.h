@@ -76,6 +76,10 @@ typedef struct _GstMatroskaDemux {
   /* cluster positions (optional) */
   GArray                  *clusters;
 
+  /* offsets and times of clusters seen so far, to narrow down the search
+   * when seeking without cues */
+  GArray                  *cluster_times;
+
   /* keeping track of playback position */
   GstClockTime             last_stop_end;
   GstClockTime             stream_start_time;
@@ -225,23 +225,26 @@ static void gst_matroska_mux_class_init (GstMatroskaMuxClass * klass);
 static void gst_matroska_mux_init (GstMatroskaMux * mux, gpointer g_class);
 static void gst_matroska_mux_finalize (GObject * object);
 
-/* Pads collected callback */
-static GstFlowReturn gst_matroska_mux_handle_buffer (GstCollectPads * pads,
-    GstCollectData * data, GstBuffer * buf, gpointer user_data);
-static gboolean gst_matroska_mux_handle_sink_event (GstCollectPads * pads,
-    GstCollectData * data, GstEvent * event, gpointer user_data);
+/* GstAggregator vmethods */
+static GstFlowReturn gst_matroska_mux_aggregate (GstAggregator * agg,
+    gboolean timeout);
+static GstClockTime gst_matroska_mux_get_next_time (GstAggregator * agg);
+static GstBuffer *gst_matroska_mux_clip_running_time (GstAggregator * agg,
+    GstAggregatorPad * agg_pad, GstBuffer * buf);
+static gboolean gst_matroska_mux_handle_sink_event (GstAggregator * agg,
+    GstAggregatorPad * agg_pad, GstEvent * event);
+static gboolean gst_matroska_mux_handle_src_event (GstAggregator * agg,
+    GstEvent * event);
+static GstAggregatorPad *gst_matroska_mux_create_new_pad (GstAggregator * agg,
+    GstPadTemplate * templ, const gchar * req_name, const GstCaps * caps);
+static gboolean gst_matroska_mux_start_agg (GstAggregator * agg);
+static gboolean gst_matroska_mux_stop_agg (GstAggregator * agg);
 
 /* pad functions */
-static gboolean gst_matroska_mux_handle_src_event (GstPad * pad,
-    GstObject * parent, GstEvent * event);
 static GstPad *gst_matroska_mux_request_new_pad (GstElement * element,
     GstPadTemplate * templ, const gchar * name, const GstCaps * caps);
 static void gst_matroska_mux_release_pad (GstElement * element, GstPad * pad);
 
-/* gst internal change state handler */
-static GstStateChangeReturn
-gst_matroska_mux_change_state (GstElement * element, GstStateChange transition);
-
 /* gobject bla bla */
 static void gst_matroska_mux_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec);
@@ -293,7 +296,7 @@ gst_matroska_mux_get_type (void)
     };
     const GInterfaceInfo iface_info = { NULL };
 
-    object_type = g_type_register_static (GST_TYPE_ELEMENT,
+    object_type = g_type_register_static (GST_TYPE_AGGREGATOR,
         "GstMatroskaMux", &object_info, (GTypeFlags) 0);
 
     g_type_add_interface_static (object_type, GST_TYPE_TAG_SETTER, &iface_info);
@@ -311,17 +314,20 @@ gst_matroska_mux_class_init (GstMatroskaMuxClass * klass)
 {
   GObjectClass *gobject_class;
   GstElementClass *gstelement_class;
+  GstAggregatorClass *gstagg_class;
 
   gobject_class = (GObjectClass *) klass;
   gstelement_class = (GstElementClass *) klass;
-
-  gst_element_class_add_static_pad_template (gstelement_class,
-      &videosink_templ);
-  gst_element_class_add_static_pad_template (gstelement_class,
-      &audiosink_templ);
-  gst_element_class_add_static_pad_template (gstelement_class,
-      &subtitlesink_templ);
-  gst_element_class_add_static_pad_template (gstelement_class, &src_templ);
+  gstagg_class = (GstAggregatorClass *) klass;
+
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &videosink_templ, GST_TYPE_MATROSKA_MUX_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &audiosink_templ, GST_TYPE_MATROSKA_MUX_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &subtitlesink_templ, GST_TYPE_MATROSKA_MUX_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &src_templ, GST_TYPE_AGGREGATOR_PAD);
   gst_element_class_set_static_metadata (gstelement_class, "Matroska muxer",
       "Codec/Muxer",
       "Muxes video/audio/subtitle streams into a matroska stream",
@@ -397,13 +403,28 @@ gst_matroska_mux_class_init (GstMatroskaMuxClass * klass)
           G_MAXUINT64, DEFAULT_CLUSTER_TIMESTAMP_OFFSET,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
-  gstelement_class->change_state =
-      GST_DEBUG_FUNCPTR (gst_matroska_mux_change_state);
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_matroska_mux_request_new_pad);
   gstelement_class->release_pad =
       GST_DEBUG_FUNCPTR (gst_matroska_mux_release_pad);
 
+  gstagg_class->aggregate = GST_DEBUG_FUNCPTR (gst_matroska_mux_aggregate);
+  gstagg_class->get_next_time =
+      GST_DEBUG_FUNCPTR (gst_matroska_mux_get_next_time);
+  gstagg_class->clip = GST_DEBUG_FUNCPTR (gst_matroska_mux_clip_running_time);
+  gstagg_class->sink_event =
+      GST_DEBUG_FUNCPTR (gst_matroska_mux_handle_sink_event);
+  gstagg_class->src_event =
+      GST_DEBUG_FUNCPTR (gst_matroska_mux_handle_src_event);
+  gstagg_class->create_new_pad =
+      GST_DEBUG_FUNCPTR (gst_matroska_mux_create_new_pad);
+  gstagg_class->start = GST_DEBUG_FUNCPTR (gst_matroska_mux_start_agg);
+  gstagg_class->stop = GST_DEBUG_FUNCPTR (gst_matroska_mux_stop_agg);
+  /* caps are set from the muxed streams once the headers are written */
+  gstagg_class->negotiate = NULL;
+
+  gst_type_mark_as_plugin_api (GST_TYPE_MATROSKA_MUX_PAD, 0);
+
   parent_class = g_type_class_peek_parent (klass);
 }
 
@@ -418,28 +439,17 @@ enum
   PROP_PAD_FRAME_DURATION
 };
 
-typedef struct
-{
-  GstPad parent;
-  gboolean frame_duration;
-  gboolean frame_duration_user;
-} GstMatroskamuxPad;
-
-typedef GstPadClass GstMatroskamuxPadClass;
+G_DEFINE_TYPE (GstMatroskaMuxPad, gst_matroska_mux_pad,
+    GST_TYPE_AGGREGATOR_PAD);
 
-GType gst_matroskamux_pad_get_type (void);
-G_DEFINE_TYPE (GstMatroskamuxPad, gst_matroskamux_pad, GST_TYPE_PAD);
-
-#define GST_TYPE_MATROSKAMUX_PAD (gst_matroskamux_pad_get_type())
-#define GST_MATROSKAMUX_PAD(pad) (G_TYPE_CHECK_INSTANCE_CAST((pad),GST_TYPE_MATROSKAMUX_PAD,GstMatroskamuxPad))
-#define GST_MATROSKAMUX_PAD_CAST(pad) ((GstMatroskamuxPad *) pad)
-#define GST_IS_MATROSKAMUX_PAD(pad) (G_TYPE_CHECK_INSTANCE_TYPE((pad),GST_TYPE_MATROSKAMUX_PAD))
+static void gst_matroska_pad_reset (GstMatroskaMuxPad * mux_pad,
+    gboolean full);
 
 static void
-gst_matroskamux_pad_get_property (GObject * object, guint prop_id,
+gst_matroska_mux_pad_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec)
 {
-  GstMatroskamuxPad *pad = GST_MATROSKAMUX_PAD (object);
+  GstMatroskaMuxPad *pad = GST_MATROSKA_MUX_PAD (object);
 
   switch (prop_id) {
     case PROP_PAD_FRAME_DURATION:
@@ -452,10 +462,10 @@ gst_matroskamux_pad_get_property (GObject * object, guint prop_id,
 }
 
 static void
-gst_matroskamux_pad_set_property (GObject * object, guint prop_id,
+gst_matroska_mux_pad_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
 {
-  GstMatroskamuxPad *pad = GST_MATROSKAMUX_PAD (object);
+  GstMatroskaMuxPad *pad = GST_MATROSKA_MUX_PAD (object);
 
   switch (prop_id) {
     case PROP_PAD_FRAME_DURATION:
@@ -469,12 +479,21 @@ gst_matroskamux_pad_set_property (GObject * object, guint prop_id,
 }
 
 static void
-gst_matroskamux_pad_class_init (GstMatroskamuxPadClass * klass)
+gst_matroska_mux_pad_finalize (GObject * object)
+{
+  gst_matroska_pad_reset (GST_MATROSKA_MUX_PAD (object), TRUE);
+
+  G_OBJECT_CLASS (gst_matroska_mux_pad_parent_class)->finalize (object);
+}
+
+static void
+gst_matroska_mux_pad_class_init (GstMatroskaMuxPadClass * klass)
 {
   GObjectClass *gobject_class = (GObjectClass *) klass;
 
-  gobject_class->set_property = gst_matroskamux_pad_set_property;
-  gobject_class->get_property = gst_matroskamux_pad_get_property;
+  gobject_class->set_property = gst_matroska_mux_pad_set_property;
+  gobject_class->get_property = gst_matroska_mux_pad_get_property;
+  gobject_class->finalize = gst_matroska_mux_pad_finalize;
 
   g_object_class_install_property (gobject_class, PROP_PAD_FRAME_DURATION,
       g_param_spec_boolean ("frame-duration", "Frame duration",
@@ -483,7 +502,7 @@ gst_matroskamux_pad_class_init (GstMatroskamuxPadClass * klass)
 }
 
 static void
-gst_matroskamux_pad_init (GstMatroskamuxPad * pad)
+gst_matroska_mux_pad_init (GstMatroskaMuxPad * pad)
 {
   pad->frame_duration = DEFAULT_PAD_FRAME_DURATION;
   pad->frame_duration_user = FALSE;
@@ -496,25 +515,9 @@ gst_matroskamux_pad_init (GstMatroskamuxPad * pad)
 static void
 gst_matroska_mux_init (GstMatroskaMux * mux, gpointer g_class)
 {
-  GstPadTemplate *templ;
-
-  templ =
-      gst_element_class_get_pad_template (GST_ELEMENT_CLASS (g_class), "src");
-  mux->srcpad = gst_pad_new_from_template (templ, "src");
-
-  gst_pad_set_event_function (mux->srcpad, gst_matroska_mux_handle_src_event);
-  gst_element_add_pad (GST_ELEMENT (mux), mux->srcpad);
-  gst_pad_use_fixed_caps (mux->srcpad);
+  gst_pad_use_fixed_caps (GST_AGGREGATOR_SRC_PAD (mux));
 
-  mux->collect = gst_collect_pads_new ();
-  gst_collect_pads_set_clip_function (mux->collect,
-      GST_DEBUG_FUNCPTR (gst_collect_pads_clip_running_time), mux);
-  gst_collect_pads_set_buffer_function (mux->collect,
-      GST_DEBUG_FUNCPTR (gst_matroska_mux_handle_buffer), mux);
-  gst_collect_pads_set_event_function (mux->collect,
-      GST_DEBUG_FUNCPTR (gst_matroska_mux_handle_sink_event), mux);
-
-  mux->ebml_write = gst_ebml_write_new (mux->srcpad);
+  mux->ebml_write = gst_ebml_write_new (GST_AGGREGATOR (mux));
   mux->doctype = GST_MATROSKA_DOCTYPE_MATROSKA;
 
   /* property defaults */
@@ -553,7 +556,6 @@ gst_matroska_mux_finalize (GObject * object)
 
   gst_event_replace (&mux->force_key_unit_event, NULL);
 
-  gst_object_unref (mux->collect);
   gst_object_unref (mux->ebml_write);
   g_free (mux->writing_app);
   g_clear_pointer (&mux->creation_time, g_date_time_unref);
@@ -584,42 +586,42 @@ gst_matroska_mux_create_uid (GstMatroskaMux * mux)
 
 /**
  * gst_matroska_pad_reset:
- * @collect_pad: the #GstMatroskaPad
+ * @mux_pad: the #GstMatroskaMuxPad
  *
- * Reset and/or release resources of a matroska collect pad.
+ * Reset and/or release resources of a matroska sink pad.
  */
 static void
-gst_matroska_pad_reset (GstMatroskaPad * collect_pad, gboolean full)
+gst_matroska_pad_reset (GstMatroskaMuxPad * mux_pad, gboolean full)
 {
   gchar *name = NULL;
   GstMatroskaTrackType type = 0;
 
   /* free track information */
-  if (collect_pad->track != NULL) {
+  if (mux_pad->track != NULL) {
     /* retrieve for optional later use */
-    name = collect_pad->track->name;
-    type = collect_pad->track->type;
+    name = mux_pad->track->name;
+    type = mux_pad->track->type;
     /* extra for video */
     if (type == GST_MATROSKA_TRACK_TYPE_VIDEO) {
       GstMatroskaTrackVideoContext *ctx =
-          (GstMatroskaTrackVideoContext *) collect_pad->track;
+          (GstMatroskaTrackVideoContext *) mux_pad->track;
 
       if (ctx->dirac_unit) {
         gst_buffer_unref (ctx->dirac_unit);
         ctx->dirac_unit = NULL;
       }
     }
-    g_free (collect_pad->track->codec_id);
-    g_free (collect_pad->track->codec_name);
+    g_free (mux_pad->track->codec_id);
+    g_free (mux_pad->track->codec_name);
     if (full)
-      g_free (collect_pad->track->name);
-    g_free (collect_pad->track->language);
-    g_free (collect_pad->track->codec_priv);
-    g_free (collect_pad->track);
-    collect_pad->track = NULL;
-    if (collect_pad->tags) {
-      gst_tag_list_unref (collect_pad->tags);
-      collect_pad->tags = NULL;
+      g_free (mux_pad->track->name);
+    g_free (mux_pad->track->language);
+    g_free (mux_pad->track->codec_priv);
+    g_free (mux_pad->track);
+    mux_pad->track = NULL;
+    if (mux_pad->tags) {
+      gst_tag_list_unref (mux_pad->tags);
+      mux_pad->tags = NULL;
     }
   }
 
@@ -647,30 +649,17 @@ gst_matroska_pad_reset (GstMatroskaPad * collect_pad, gboolean full)
 
     context->type = type;
     context->name = name;
-    context->uid = gst_matroska_mux_create_uid (collect_pad->mux);
+    context->uid = gst_matroska_mux_create_uid (mux_pad->mux);
     /* TODO: check default values for the context */
     context->flags = GST_MATROSKA_TRACK_ENABLED | GST_MATROSKA_TRACK_DEFAULT;
-    collect_pad->track = context;
-    collect_pad->start_ts = GST_CLOCK_TIME_NONE;
-    collect_pad->end_ts = GST_CLOCK_TIME_NONE;
-    collect_pad->tags = gst_tag_list_new_empty ();
-    gst_tag_list_set_scope (collect_pad->tags, GST_TAG_SCOPE_STREAM);
+    mux_pad->track = context;
+    mux_pad->start_ts = GST_CLOCK_TIME_NONE;
+    mux_pad->end_ts = GST_CLOCK_TIME_NONE;
+    mux_pad->tags = gst_tag_list_new_empty ();
+    gst_tag_list_set_scope (mux_pad->tags, GST_TAG_SCOPE_STREAM);
   }
 }
 
-/**
- * gst_matroska_pad_free:
- * @collect_pad: the #GstMatroskaPad
- *
- * Release resources of a matroska collect pad.
- */
-static void
-gst_matroska_pad_free (GstPad * collect_pad)
-{
-  gst_matroska_pad_reset ((GstMatroskaPad *) collect_pad, TRUE);
-}
-
-
 /**
  * gst_matroska_mux_reset:
  * @element: #GstMatroskaMux that should be reset.
@@ -681,7 +670,7 @@ static void
 gst_matroska_mux_reset (GstElement * element)
 {
   GstMatroskaMux *mux = GST_MATROSKA_MUX (element);
-  GSList *walk;
+  GList *walk;
 
   /* reset EBML write */
   gst_ebml_write_reset (mux->ebml_write);
@@ -691,13 +680,13 @@ gst_matroska_mux_reset (GstElement * element)
 
   /* clean up existing streams */
 
-  for (walk = mux->collect->data; walk; walk = g_slist_next (walk)) {
-    GstMatroskaPad *collect_pad;
+  for (walk = element->sinkpads; walk; walk = g_list_next (walk)) {
+    GstMatroskaMuxPad *mux_pad;
 
-    collect_pad = (GstMatroskaPad *) walk->data;
+    mux_pad = GST_MATROSKA_MUX_PAD (walk->data);
 
-    /* reset collect pad to pristine state */
-    gst_matroska_pad_reset (collect_pad, FALSE);
+    /* reset sink pad to pristine state */
+    gst_matroska_pad_reset (mux_pad, FALSE);
   }
 
   /* reset indexes */
@@ -731,7 +720,7 @@ gst_matroska_mux_reset (GstElement * element)
 
 /**
  * gst_matroska_mux_handle_src_event:
- * @pad: Pad which received the event.
+ * @agg: #GstMatroskaMux
  * @event: Received event.
  *
  * handle events - copied from oggmux without understanding
@@ -739,22 +728,18 @@ gst_matroska_mux_reset (GstElement * element)
  * Returns: %TRUE on success.
  */
 static gboolean
-gst_matroska_mux_handle_src_event (GstPad * pad, GstObject * parent,
-    GstEvent * event)
+gst_matroska_mux_handle_src_event (GstAggregator * agg, GstEvent * event)
 {
-  GstEventType type;
-
-  type = event ? GST_EVENT_TYPE (event) : GST_EVENT_UNKNOWN;
-
-  switch (type) {
+  switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_SEEK:
       /* disable seeking for now */
+      gst_event_unref (event);
       return FALSE;
     default:
       break;
   }
 
-  return gst_pad_event_default (pad, parent, event);
+  return GST_AGGREGATOR_CLASS (parent_class)->src_event (agg, event);
 }
 
 
@@ -808,7 +793,8 @@ gst_matroska_mux_build_vobsub_private (GstMatroskaTrackContext * context,
 
 /**
  * gst_matroska_mux_handle_sink_event:
- * @pad: Pad which received the event.
+ * @agg: #GstMatroskaMux
+ * @agg_pad: Pad which received the event.
  * @event: Received event.
  *
  * handle events - informational ones like tags
@@ -816,30 +802,29 @@ gst_matroska_mux_build_vobsub_private (GstMatroskaTrackContext * context,
  * Returns: %TRUE on success.
  */
 static gboolean
-gst_matroska_mux_handle_sink_event (GstCollectPads * pads,
-    GstCollectData * data, GstEvent * event, gpointer user_data)
+gst_matroska_mux_handle_sink_event (GstAggregator * agg,
+    GstAggregatorPad * agg_pad, GstEvent * event)
 {
-  GstMatroskaPad *collect_pad;
+  GstMatroskaMuxPad *mux_pad;
   GstMatroskaTrackContext *context;
   GstMatroskaMux *mux;
   GstPad *pad;
   GstTagList *list;
   gboolean ret = TRUE;
 
-  mux = GST_MATROSKA_MUX (user_data);
-  collect_pad = (GstMatroskaPad *) data;
-  pad = data->pad;
-  context = collect_pad->track;
+  mux = GST_MATROSKA_MUX (agg);
+  mux_pad = GST_MATROSKA_MUX_PAD (agg_pad);
+  pad = GST_PAD (agg_pad);
+  context = mux_pad->track;
   g_assert (context);
 
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_CAPS:{
       GstCaps *caps;
 
-      collect_pad = (GstMatroskaPad *) gst_pad_get_element_private (pad);
       gst_event_parse_caps (event, &caps);
 
-      ret = collect_pad->capsfunc (pad, caps);
+      ret = mux_pad->capsfunc (pad, caps);
       gst_event_unref (event);
       event = NULL;
       break;
@@ -872,7 +857,7 @@ gst_matroska_mux_handle_sink_event (GstCollectPads * pads,
         gchar *title = NULL;
 
         /* Stream specific tags */
-        gst_tag_list_insert (collect_pad->tags, list, GST_TAG_MERGE_REPLACE);
+        gst_tag_list_insert (mux_pad->tags, list, GST_TAG_MERGE_REPLACE);
 
         /* If the tags contain a title, update the context name to write it there */
         if (gst_tag_list_get_string (list, GST_TAG_TITLE, &title)) {
@@ -884,7 +869,7 @@ gst_matroska_mux_handle_sink_event (GstCollectPads * pads,
       }
 
       gst_event_unref (event);
-      /* handled this, don't want collectpads to forward it downstream */
+      /* handled this, don't want the aggregator to forward it downstream */
       event = NULL;
       ret = TRUE;
       break;
@@ -911,7 +896,7 @@ gst_matroska_mux_handle_sink_event (GstCollectPads * pads,
       }
 
       gst_event_unref (event);
-      /* handled this, don't want collectpads to forward it downstream */
+      /* handled this, don't want the aggregator to forward it downstream */
       event = NULL;
       break;
     }
@@ -958,7 +943,8 @@ gst_matroska_mux_handle_sink_event (GstCollectPads * pads,
 
 break_hard:
   if (event != NULL)
-    return gst_collect_pads_event_default (pads, data, event, FALSE);
+    return GST_AGGREGATOR_CLASS (parent_class)->sink_event (agg, agg_pad,
+        event);
 
   return ret;
 }
@@ -1102,7 +1088,7 @@ gst_matroska_mux_video_pad_setcaps (GstPad * pad, GstCaps * caps)
   GstMatroskaTrackContext *context = NULL;
   GstMatroskaTrackVideoContext *videocontext;
   GstMatroskaMux *mux;
-  GstMatroskaPad *collect_pad;
+  GstMatroskaMuxPad *mux_pad;
   GstStructure *structure;
   const gchar *mimetype;
   const gchar *interlace_mode, *s;
@@ -1116,9 +1102,9 @@ gst_matroska_mux_video_pad_setcaps (GstPad * pad, GstCaps * caps)
   mux = GST_MATROSKA_MUX (GST_PAD_PARENT (pad));
 
   /* find context */
-  collect_pad = (GstMatroskaPad *) gst_pad_get_element_private (pad);
-  g_assert (collect_pad);
-  context = collect_pad->track;
+  mux_pad = GST_MATROSKA_MUX_PAD (pad);
+  g_assert (mux_pad);
+  context = mux_pad->track;
   g_assert (context);
   g_assert (context->type == GST_MATROSKA_TRACK_TYPE_VIDEO);
   videocontext = (GstMatroskaTrackVideoContext *) context;
@@ -1169,7 +1155,7 @@ gst_matroska_mux_video_pad_setcaps (GstPad * pad, GstCaps * caps)
   videocontext->pixel_width = width;
   videocontext->pixel_height = height;
 
-  if (GST_MATROSKAMUX_PAD_CAST (pad)->frame_duration
+  if (mux_pad->frame_duration
       && gst_structure_get_fraction (structure, "framerate", &fps_n, &fps_d)
       && fps_n > 0) {
     context->default_duration =
@@ -1987,7 +1973,7 @@ gst_matroska_mux_audio_pad_setcaps (GstPad * pad, GstCaps * caps)
   GstMatroskaTrackContext *context = NULL;
   GstMatroskaTrackAudioContext *audiocontext;
   GstMatroskaMux *mux;
-  GstMatroskaPad *collect_pad;
+  GstMatroskaMuxPad *mux_pad;
   const gchar *mimetype;
   gint samplerate = 0, channels = 0;
   GstStructure *structure;
@@ -2015,9 +2001,9 @@ gst_matroska_mux_audio_pad_setcaps (GstPad * pad, GstCaps * caps)
   }
 
   /* find context */
-  collect_pad = (GstMatroskaPad *) gst_pad_get_element_private (pad);
-  g_assert (collect_pad);
-  context = collect_pad->track;
+  mux_pad = GST_MATROSKA_MUX_PAD (pad);
+  g_assert (mux_pad);
+  context = mux_pad->track;
   g_assert (context);
   g_assert (context->type == GST_MATROSKA_TRACK_TYPE_AUDIO);
   audiocontext = (GstMatroskaTrackAudioContext *) context;
@@ -2429,8 +2415,7 @@ gst_matroska_mux_subtitle_pad_setcaps (GstPad * pad, GstCaps * caps)
   GstMatroskaTrackContext *context = NULL;
   GstMatroskaTrackSubtitleContext *scontext;
   GstMatroskaMux *mux;
-  GstMatroskaPad *collect_pad;
-  GstCollectData *data;
+  GstMatroskaMuxPad *mux_pad;
   const gchar *mimetype;
   GstStructure *structure;
   const GValue *value = NULL;
@@ -2457,11 +2442,10 @@ gst_matroska_mux_subtitle_pad_setcaps (GstPad * pad, GstCaps * caps)
   }
 
   /* find context */
-  collect_pad = (GstMatroskaPad *) gst_pad_get_element_private (pad);
-  g_assert (collect_pad);
-  data = (GstCollectData *) (collect_pad);
+  mux_pad = GST_MATROSKA_MUX_PAD (pad);
+  g_assert (mux_pad);
 
-  context = collect_pad->track;
+  context = mux_pad->track;
   g_assert (context);
   g_assert (context->type == GST_MATROSKA_TRACK_TYPE_SUBTITLE);
   scontext = (GstMatroskaTrackSubtitleContext *) context;
@@ -2536,13 +2520,6 @@ gst_matroska_mux_subtitle_pad_setcaps (GstPad * pad, GstCaps * caps)
   GST_DEBUG_OBJECT (pad, "codec_id %s, codec data size %" G_GSIZE_FORMAT,
       GST_STR_NULL (context->codec_id), context->codec_priv_size);
 
-  /* This pad is sparse. Now that we have caps on it, we can tell collectpads
-   * not to actually wait for data when muxing */
-  GST_COLLECT_PADS_STREAM_LOCK (mux->collect);
-  GST_COLLECT_PADS_STATE_UNSET (data, GST_COLLECT_PADS_STATE_LOCKED);
-  gst_collect_pads_set_waiting (mux->collect, data, FALSE);
-  GST_COLLECT_PADS_STREAM_UNLOCK (mux->collect);
-
 exit:
 
   return ret;
@@ -2573,8 +2550,7 @@ gst_matroska_mux_request_new_pad (GstElement * element,
 {
   GstElementClass *klass = GST_ELEMENT_GET_CLASS (element);
   GstMatroskaMux *mux = GST_MATROSKA_MUX (element);
-  GstMatroskaPad *collect_pad;
-  GstMatroskamuxPad *newpad;
+  GstMatroskaMuxPad *mux_pad;
   gchar *name = NULL;
   const gchar *pad_name = NULL;
   GstMatroskaCapsFunc capsfunc = NULL;
@@ -2582,6 +2558,11 @@ gst_matroska_mux_request_new_pad (GstElement * element,
   gint pad_id;
   const gchar *id = NULL;
 
+  if (mux->state != GST_MATROSKA_MUX_STATE_START) {
+    GST_WARNING_OBJECT (mux, "Not providing request pad after stream start.");
+    return NULL;
+  }
+
   if (templ == gst_element_class_get_pad_template (klass, "audio_%u")) {
     /* don't mix named and unnamed pads, if the pad already exists we fail when
      * trying to add it */
@@ -2631,45 +2612,50 @@ gst_matroska_mux_request_new_pad (GstElement * element,
     return NULL;
   }
 
-  newpad = g_object_new (GST_TYPE_MATROSKAMUX_PAD,
-      "name", pad_name, "direction", templ->direction, "template", templ, NULL);
-
-  gst_matroskamux_pad_init (newpad);
-  collect_pad = (GstMatroskaPad *)
-      gst_collect_pads_add_pad (mux->collect, GST_PAD (newpad),
-      sizeof (GstMatroskaPad),
-      (GstCollectDataDestroyNotify) gst_matroska_pad_free, TRUE);
+  mux_pad = (GstMatroskaMuxPad *)
+      GST_ELEMENT_CLASS (parent_class)->request_new_pad (element, templ,
+      pad_name, caps);
+  if (mux_pad == NULL || GST_OBJECT_PARENT (mux_pad) != GST_OBJECT (mux))
+    goto pad_add_failed;
 
-  collect_pad->mux = mux;
-  collect_pad->track = context;
-  gst_matroska_pad_reset (collect_pad, FALSE);
+  mux_pad->mux = mux;
+  mux_pad->track = context;
+  gst_matroska_pad_reset (mux_pad, FALSE);
   if (id)
-    gst_matroska_mux_set_codec_id (collect_pad->track, id);
-  collect_pad->track->dts_only = FALSE;
+    gst_matroska_mux_set_codec_id (mux_pad->track, id);
+  mux_pad->track->dts_only = FALSE;
 
-  collect_pad->capsfunc = capsfunc;
-  gst_pad_set_active (GST_PAD (newpad), TRUE);
-  if (!gst_element_add_pad (element, GST_PAD (newpad)))
-    goto pad_add_failed;
+  mux_pad->capsfunc = capsfunc;
 
   g_free (name);
 
   mux->num_streams++;
 
-  GST_DEBUG_OBJECT (newpad, "Added new request pad");
+  GST_DEBUG_OBJECT (mux_pad, "Added new request pad");
 
-  return GST_PAD (newpad);
+  return GST_PAD (mux_pad);
 
   /* ERROR cases */
 pad_add_failed:
   {
     GST_WARNING_OBJECT (mux, "Adding the new pad '%s' failed", pad_name);
     g_free (name);
-    gst_object_unref (newpad);
+    if (mux_pad)
+      gst_object_unref (mux_pad);
+    g_free (context->name);
+    g_free (context);
     return NULL;
   }
 }
 
+static GstAggregatorPad *
+gst_matroska_mux_create_new_pad (GstAggregator * agg,
+    GstPadTemplate * templ, const gchar * req_name, const GstCaps * caps)
+{
+  return g_object_new (GST_TYPE_MATROSKA_MUX_PAD, "name", req_name,
+      "direction", templ->direction, "template", templ, NULL);
+}
+
 /**
  * gst_matroska_mux_release_pad:
  * @element: #GstMatroskaMux.
@@ -2680,39 +2666,25 @@ pad_add_failed:
 static void
 gst_matroska_mux_release_pad (GstElement * element, GstPad * pad)
 {
-  GstMatroskaMux *mux;
-  GSList *walk;
-
-  mux = GST_MATROSKA_MUX (GST_PAD_PARENT (pad));
-
-  for (walk = mux->collect->data; walk; walk = g_slist_next (walk)) {
-    GstCollectData *cdata = (GstCollectData *) walk->data;
-    GstMatroskaPad *collect_pad = (GstMatroskaPad *) cdata;
-
-    if (cdata->pad == pad) {
-      /*
-       * observed duration, this will remain GST_CLOCK_TIME_NONE
-       * only if the pad is reset
-       */
-      GstClockTime collected_duration = GST_CLOCK_TIME_NONE;
-
-      if (GST_CLOCK_TIME_IS_VALID (collect_pad->start_ts) &&
-          GST_CLOCK_TIME_IS_VALID (collect_pad->end_ts)) {
-        collected_duration =
-            GST_CLOCK_DIFF (collect_pad->start_ts, collect_pad->end_ts);
-      }
-
-      if (GST_CLOCK_TIME_IS_VALID (collected_duration)
-          && mux->duration < collected_duration)
-        mux->duration = collected_duration;
+  GstMatroskaMux *mux = GST_MATROSKA_MUX (element);
+  GstMatroskaMuxPad *mux_pad = GST_MATROSKA_MUX_PAD (pad);
+  /*
+   * observed duration, this will remain GST_CLOCK_TIME_NONE
+   * only if the pad is reset
+   */
+  GstClockTime collected_duration = GST_CLOCK_TIME_NONE;
 
-      break;
-    }
+  if (GST_CLOCK_TIME_IS_VALID (mux_pad->start_ts) &&
+      GST_CLOCK_TIME_IS_VALID (mux_pad->end_ts)) {
+    collected_duration = GST_CLOCK_DIFF (mux_pad->start_ts, mux_pad->end_ts);
   }
 
-  gst_collect_pads_remove_pad (mux->collect, pad);
-  if (gst_element_remove_pad (element, pad))
-    mux->num_streams--;
+  if (GST_CLOCK_TIME_IS_VALID (collected_duration)
+      && mux->duration < collected_duration)
+    mux->duration = collected_duration;
+
+  GST_ELEMENT_CLASS (parent_class)->release_pad (element, pad);
+  mux->num_streams--;
 }
 
 static void
@@ -3137,7 +3109,7 @@ gst_matroska_mux_write_chapter_edition (GstMatroskaMux * mux,
  * Start a new matroska file (write headers etc...)
  */
 static void
-gst_matroska_mux_start (GstMatroskaMux * mux, GstMatroskaPad * first_pad,
+gst_matroska_mux_start (GstMatroskaMux * mux, GstMatroskaMuxPad * first_pad,
     GstBuffer * first_pad_buf)
 {
   GstEbmlWrite *ebml = mux->ebml_write;
@@ -3152,14 +3124,13 @@ gst_matroska_mux_start (GstMatroskaMux * mux, GstMatroskaPad * first_pad,
   const gchar *media_type;
   gboolean audio_only;
   guint64 master, child;
-  GSList *collected;
+  GList *l;
   int i;
   guint tracknum = 1;
   GstClockTime earliest_time = GST_CLOCK_TIME_NONE;
   GstClockTime duration = 0;
   guint32 segment_uid[4];
   gint64 time;
-  gchar s_id[32];
   GstToc *toc;
 
   /* if not streaming, check if downstream is seekable */
@@ -3168,7 +3139,7 @@ gst_matroska_mux_start (GstMatroskaMux * mux, GstMatroskaPad * first_pad,
     GstQuery *query;
 
     query = gst_query_new_seeking (GST_FORMAT_BYTES);
-    if (gst_pad_peer_query (mux->srcpad, query)) {
+    if (gst_pad_peer_query (GST_AGGREGATOR_SRC_PAD (mux), query)) {
       gst_query_parse_seeking (query, NULL, &seekable, NULL, NULL);
       GST_INFO_OBJECT (mux, "downstream is %sseekable", seekable ? "" : "not ");
     } else {
@@ -3186,10 +3157,6 @@ gst_matroska_mux_start (GstMatroskaMux * mux, GstMatroskaPad * first_pad,
     gst_query_unref (query);
   }
 
-  /* stream-start (FIXME: create id based on input ids) */
-  g_snprintf (s_id, sizeof (s_id), "matroskamux-%08x", g_random_int ());
-  gst_pad_push_event (mux->srcpad, gst_event_new_stream_start (s_id));
-
   /* output caps */
   audio_only = mux->num_v_streams == 0 && mux->num_a_streams > 0;
   if (mux->is_webm) {
@@ -3198,7 +3165,7 @@ gst_matroska_mux_start (GstMatroskaMux * mux, GstMatroskaPad * first_pad,
     media_type = (audio_only) ? "audio/x-matroska" : "video/x-matroska";
   }
   ebml->caps = gst_caps_new_empty_simple (media_type);
-  gst_pad_set_caps (mux->srcpad, ebml->caps);
+  gst_aggregator_set_src_caps (GST_AGGREGATOR (mux), ebml->caps);
   /* we start with a EBML header */
   doctype = mux->doctype;
   GST_INFO_OBJECT (ebml, "DocType: %s, Version: %d",
@@ -3268,14 +3235,13 @@ gst_matroska_mux_start (GstMatroskaMux * mux, GstMatroskaPad * first_pad,
   mux->duration_pos = ebml->pos;
   /* get duration */
   if (!mux->ebml_write->streamable) {
-    for (collected = mux->collect->data; collected;
-        collected = g_slist_next (collected)) {
-      GstMatroskaPad *collect_pad;
+    for (l = GST_ELEMENT (mux)->sinkpads; l; l = l->next) {
+      GstMatroskaMuxPad *mux_pad;
       GstPad *thepad;
       gint64 trackduration;
 
-      collect_pad = (GstMatroskaPad *) collected->data;
-      thepad = collect_pad->collect.pad;
+      mux_pad = (GstMatroskaMuxPad *) l->data;
+      thepad = GST_PAD (mux_pad);
 
       /* Query the total length of the track. */
       GST_DEBUG_OBJECT (thepad, "querying peer duration");
@@ -3309,15 +3275,14 @@ gst_matroska_mux_start (GstMatroskaMux * mux, GstMatroskaPad * first_pad,
   mux->tracks_pos = ebml->pos;
   master = gst_ebml_write_master_start (ebml, GST_MATROSKA_ID_TRACKS);
 
-  for (collected = mux->collect->data; collected;
-      collected = g_slist_next (collected)) {
-    GstMatroskaPad *collect_pad;
+  for (l = GST_ELEMENT (mux)->sinkpads; l; l = l->next) {
+    GstMatroskaMuxPad *mux_pad;
     GstBuffer *buf;
 
-    collect_pad = (GstMatroskaPad *) collected->data;
+    mux_pad = (GstMatroskaMuxPad *) l->data;
 
     /* This will cause an error at a later time */
-    if (collect_pad->track->codec_id == NULL)
+    if (mux_pad->track->codec_id == NULL)
       continue;
 
     /* Find the smallest timestamp so we can offset all streams by this to
@@ -3325,13 +3290,13 @@ gst_matroska_mux_start (GstMatroskaMux * mux, GstMatroskaPad * first_pad,
     if (mux->offset_to_zero) {
       GstClockTime ts;
 
-      if (collect_pad == first_pad)
+      if (mux_pad == first_pad)
         buf = first_pad_buf ? gst_buffer_ref (first_pad_buf) : NULL;
       else
-        buf = gst_collect_pads_peek (mux->collect, collected->data);
+        buf = gst_aggregator_pad_peek_buffer (GST_AGGREGATOR_PAD (mux_pad));
 
       if (buf) {
-        ts = gst_matroska_track_get_buffer_timestamp (collect_pad->track, buf);
+        ts = gst_matroska_track_get_buffer_timestamp (mux_pad->track, buf);
 
         if (earliest_time == GST_CLOCK_TIME_NONE)
           earliest_time = ts;
@@ -3346,27 +3311,27 @@ gst_matroska_mux_start (GstMatroskaMux * mux, GstMatroskaPad * first_pad,
     /* For audio tracks, use the first buffers duration as the default
      * duration if we didn't get any better idea from the caps event already
      */
-    if (collect_pad->track->type == GST_MATROSKA_TRACK_TYPE_AUDIO &&
-        collect_pad->track->default_duration == 0) {
-      if (collect_pad == first_pad)
+    if (mux_pad->track->type == GST_MATROSKA_TRACK_TYPE_AUDIO &&
+        mux_pad->track->default_duration == 0) {
+      if (mux_pad == first_pad)
         buf = first_pad_buf ? gst_buffer_ref (first_pad_buf) : NULL;
       else
-        buf = gst_collect_pads_peek (mux->collect, collected->data);
+        buf = gst_aggregator_pad_peek_buffer (GST_AGGREGATOR_PAD (mux_pad));
 
       if (buf && GST_BUFFER_DURATION_IS_VALID (buf))
-        collect_pad->track->default_duration =
-            GST_BUFFER_DURATION (buf) + collect_pad->track->codec_delay;
+        mux_pad->track->default_duration =
+            GST_BUFFER_DURATION (buf) + mux_pad->track->codec_delay;
       if (buf)
         gst_buffer_unref (buf);
     }
 
-    collect_pad->track->num = tracknum++;
+    mux_pad->track->num = tracknum++;
     child = gst_ebml_write_master_start (ebml, GST_MATROSKA_ID_TRACKENTRY);
-    gst_matroska_mux_track_header (mux, collect_pad->track);
+    gst_matroska_mux_track_header (mux, mux_pad->track);
     gst_ebml_write_master_finish (ebml, child);
     /* some remaining pad/track setup */
-    collect_pad->default_duration_scaled =
-        gst_util_uint64_scale (collect_pad->track->default_duration,
+    mux_pad->default_duration_scaled =
+        gst_util_uint64_scale (mux_pad->track->default_duration,
         1, mux->time_scale);
   }
   gst_ebml_write_master_finish (ebml, master);
@@ -3528,7 +3493,8 @@ gst_matroska_mux_write_simple_tag (const GstTagList * list, const gchar * tag,
 }
 
 static void
-gst_matroska_mux_write_stream_tags (GstMatroskaMux * mux, GstMatroskaPad * mpad)
+gst_matroska_mux_write_stream_tags (GstMatroskaMux * mux,
+    GstMatroskaMuxPad * mpad)
 {
   guint64 master_tag, master_targets;
   GstEbmlWrite *ebml;
@@ -3552,27 +3518,27 @@ gst_matroska_mux_write_stream_tags (GstMatroskaMux * mux, GstMatroskaPad * mpad)
 static void
 gst_matroska_mux_write_streams_tags (GstMatroskaMux * mux)
 {
-  GSList *walk;
+  GList *walk;
 
-  for (walk = mux->collect->data; walk; walk = g_slist_next (walk)) {
-    GstMatroskaPad *collect_pad;
+  for (walk = GST_ELEMENT (mux)->sinkpads; walk; walk = walk->next) {
+    GstMatroskaMuxPad *mux_pad;
 
-    collect_pad = (GstMatroskaPad *) walk->data;
+    mux_pad = (GstMatroskaMuxPad *) walk->data;
 
-    gst_matroska_mux_write_stream_tags (mux, collect_pad);
+    gst_matroska_mux_write_stream_tags (mux, mux_pad);
   }
 }
 
 static gboolean
 gst_matroska_mux_streams_have_tags (GstMatroskaMux * mux)
 {
-  GSList *walk;
+  GList *walk;
 
-  for (walk = mux->collect->data; walk; walk = g_slist_next (walk)) {
-    GstMatroskaPad *collect_pad;
+  for (walk = GST_ELEMENT (mux)->sinkpads; walk; walk = walk->next) {
+    GstMatroskaMuxPad *mux_pad;
 
-    collect_pad = (GstMatroskaPad *) walk->data;
-    if (!gst_matroska_mux_tag_list_is_empty (collect_pad->tags))
+    mux_pad = (GstMatroskaMuxPad *) walk->data;
+    if (!gst_matroska_mux_tag_list_is_empty (mux_pad->tags))
       return TRUE;
   }
   return FALSE;
@@ -3633,7 +3599,7 @@ gst_matroska_mux_finish (GstMatroskaMux * mux)
   GstEbmlWrite *ebml = mux->ebml_write;
   guint64 pos;
   guint64 duration = 0;
-  GSList *collected;
+  GList *l;
   const GstTagList *tags, *toc_tags;
   const GstToc *toc;
   gboolean has_main_tags, toc_has_tags = FALSE;
@@ -3779,32 +3745,31 @@ gst_matroska_mux_finish (GstMatroskaMux * mux)
    */
   duration = mux->duration;
   pos = ebml->pos;
-  for (collected = mux->collect->data; collected;
-      collected = g_slist_next (collected)) {
-    GstMatroskaPad *collect_pad;
+  for (l = GST_ELEMENT (mux)->sinkpads; l; l = l->next) {
+    GstMatroskaMuxPad *mux_pad;
     /*
      * observed duration, this will never remain GST_CLOCK_TIME_NONE
      * since this means buffer without timestamps that is not possible
      */
     GstClockTime collected_duration = GST_CLOCK_TIME_NONE;
 
-    collect_pad = (GstMatroskaPad *) collected->data;
+    mux_pad = (GstMatroskaMuxPad *) l->data;
 
     GST_DEBUG_OBJECT (mux,
         "Pad %" GST_PTR_FORMAT " start ts %" GST_TIME_FORMAT
-        " end ts %" GST_TIME_FORMAT, collect_pad,
-        GST_TIME_ARGS (collect_pad->start_ts),
-        GST_TIME_ARGS (collect_pad->end_ts));
+        " end ts %" GST_TIME_FORMAT, mux_pad,
+        GST_TIME_ARGS (mux_pad->start_ts),
+        GST_TIME_ARGS (mux_pad->end_ts));
 
-    if (GST_CLOCK_TIME_IS_VALID (collect_pad->start_ts) &&
-        GST_CLOCK_TIME_IS_VALID (collect_pad->end_ts)) {
+    if (GST_CLOCK_TIME_IS_VALID (mux_pad->start_ts) &&
+        GST_CLOCK_TIME_IS_VALID (mux_pad->end_ts)) {
       collected_duration =
-          GST_CLOCK_DIFF (collect_pad->start_ts, collect_pad->end_ts);
-      GST_DEBUG_OBJECT (collect_pad->collect.pad,
+          GST_CLOCK_DIFF (mux_pad->start_ts, mux_pad->end_ts);
+      GST_DEBUG_OBJECT (GST_PAD (mux_pad),
           "final track duration: %" GST_TIME_FORMAT,
           GST_TIME_ARGS (collected_duration));
     } else {
-      GST_WARNING_OBJECT (collect_pad->collect.pad,
+      GST_WARNING_OBJECT (GST_PAD (mux_pad),
           "unable to get final track duration");
     }
     if (GST_CLOCK_TIME_IS_VALID (collected_duration) &&
@@ -3874,10 +3839,10 @@ gst_matroska_mux_create_buffer_header (GstMatroskaTrackContext * track,
 
 static GstBuffer *
 gst_matroska_mux_handle_dirac_packet (GstMatroskaMux * mux,
-    GstMatroskaPad * collect_pad, GstBuffer * buf)
+    GstMatroskaMuxPad * mux_pad, GstBuffer * buf)
 {
   GstMatroskaTrackVideoContext *ctx =
-      (GstMatroskaTrackVideoContext *) collect_pad->track;
+      (GstMatroskaTrackVideoContext *) mux_pad->track;
   GstMapInfo map;
   guint8 *data;
   gsize size;
@@ -3969,21 +3934,22 @@ gst_matroska_mux_stop_streamheader (GstMatroskaMux * mux)
   g_value_unset (&streamheader);
   gst_caps_replace (&ebml->caps, caps);
   gst_buffer_unref (streamheader_buffer);
-  gst_pad_set_caps (mux->srcpad, caps);
+  gst_aggregator_set_src_caps (GST_AGGREGATOR (mux), caps);
   gst_caps_unref (caps);
 }
 
 /**
  * gst_matroska_mux_write_data:
  * @mux: #GstMatroskaMux
- * @collect_pad: #GstMatroskaPad with the data
+ * @mux_pad: #GstMatroskaMuxPad with the data
  *
- * Write collected data (called from gst_matroska_mux_collected).
+ * Write collected data (called from gst_matroska_mux_aggregate).
  *
- * Returns: Result of the gst_pad_push issued to write the data.
+ * Returns: Result of the gst_aggregator_finish_buffer() issued to write
+ * the data.
  */
 static GstFlowReturn
-gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
+gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaMuxPad * mux_pad,
     GstBuffer * buf)
 {
   GstEbmlWrite *ebml = mux->ebml_write;
@@ -3999,30 +3965,26 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
   gboolean is_audio_only = FALSE;
   gboolean is_min_duration_reached = FALSE;
   gboolean is_max_duration_exceeded = FALSE;
-  GstMatroskamuxPad *pad;
   gint flags = 0;
   GstClockTime buffer_timestamp;
   GstAudioClippingMeta *cmeta = NULL;
 
-  /* write data */
-  pad = GST_MATROSKAMUX_PAD_CAST (collect_pad->collect.pad);
-
   /* vorbis/theora headers are retrieved from caps and put in CodecPrivate */
-  if (collect_pad->track->xiph_headers_to_skip > 0) {
-    --collect_pad->track->xiph_headers_to_skip;
+  if (mux_pad->track->xiph_headers_to_skip > 0) {
+    --mux_pad->track->xiph_headers_to_skip;
     if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_HEADER)) {
-      GST_LOG_OBJECT (collect_pad->collect.pad, "dropping streamheader buffer");
+      GST_LOG_OBJECT (GST_PAD (mux_pad), "dropping streamheader buffer");
       gst_buffer_unref (buf);
       return GST_FLOW_OK;
     }
   }
 
   /* for dirac we have to queue up everything up to a picture unit */
-  if (!strcmp (collect_pad->track->codec_id, GST_MATROSKA_CODEC_ID_VIDEO_DIRAC)) {
-    buf = gst_matroska_mux_handle_dirac_packet (mux, collect_pad, buf);
+  if (!strcmp (mux_pad->track->codec_id, GST_MATROSKA_CODEC_ID_VIDEO_DIRAC)) {
+    buf = gst_matroska_mux_handle_dirac_packet (mux, mux_pad, buf);
     if (!buf)
       return GST_FLOW_OK;
-  } else if (!strcmp (collect_pad->track->codec_id,
+  } else if (!strcmp (mux_pad->track->codec_id,
           GST_MATROSKA_CODEC_ID_VIDEO_PRORES)) {
     /* Remove the 'Frame container atom' header' */
     buf = gst_buffer_make_writable (buf);
@@ -4030,7 +3992,7 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
   }
 
   buffer_timestamp =
-      gst_matroska_track_get_buffer_timestamp (collect_pad->track, buf);
+      gst_matroska_track_get_buffer_timestamp (mux_pad->track, buf);
   if (buffer_timestamp >= mux->earliest_time) {
     buffer_timestamp -= mux->earliest_time;
   } else {
@@ -4042,34 +4004,34 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
   /* TODO: maybe calculate a timestamp by using the previous timestamp
    * and default duration */
   if (!GST_CLOCK_TIME_IS_VALID (buffer_timestamp)) {
-    GST_WARNING_OBJECT (collect_pad->collect.pad,
+    GST_WARNING_OBJECT (GST_PAD (mux_pad),
         "Invalid buffer timestamp; dropping buffer");
     gst_buffer_unref (buf);
     return GST_FLOW_OK;
   }
 
-  if (!strcmp (collect_pad->track->codec_id, GST_MATROSKA_CODEC_ID_AUDIO_OPUS)
-      && collect_pad->track->codec_delay) {
+  if (!strcmp (mux_pad->track->codec_id, GST_MATROSKA_CODEC_ID_AUDIO_OPUS)
+      && mux_pad->track->codec_delay) {
     /* All timestamps should include the codec delay */
-    if (buffer_timestamp > collect_pad->track->codec_delay) {
-      buffer_timestamp += collect_pad->track->codec_delay;
+    if (buffer_timestamp > mux_pad->track->codec_delay) {
+      buffer_timestamp += mux_pad->track->codec_delay;
     } else {
       buffer_timestamp = 0;
-      duration_diff = collect_pad->track->codec_delay - buffer_timestamp;
+      duration_diff = mux_pad->track->codec_delay - buffer_timestamp;
     }
   }
 
   /* set the timestamp for outgoing buffers */
   ebml->timestamp = buffer_timestamp;
 
-  if (collect_pad->track->type == GST_MATROSKA_TRACK_TYPE_VIDEO) {
+  if (mux_pad->track->type == GST_MATROSKA_TRACK_TYPE_VIDEO) {
     if (!GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT)) {
       GST_LOG_OBJECT (mux, "have video keyframe, ts=%" GST_TIME_FORMAT,
           GST_TIME_ARGS (buffer_timestamp));
       is_video_keyframe = TRUE;
     } else if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DECODE_ONLY) &&
-        (!strcmp (collect_pad->track->codec_id, GST_MATROSKA_CODEC_ID_VIDEO_VP8)
-            || !strcmp (collect_pad->track->codec_id,
+        (!strcmp (mux_pad->track->codec_id, GST_MATROSKA_CODEC_ID_VIDEO_VP8)
+            || !strcmp (mux_pad->track->codec_id,
                 GST_MATROSKA_CODEC_ID_VIDEO_VP9))) {
       GST_LOG_OBJECT (mux,
           "have VP8 video invisible frame, " "ts=%" GST_TIME_FORMAT,
@@ -4082,7 +4044,7 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
    * related arithmetic, so apply the timestamp offset if we have one */
   buffer_timestamp += mux->cluster_timestamp_offset;
 
-  is_audio_only = (collect_pad->track->type == GST_MATROSKA_TRACK_TYPE_AUDIO) &&
+  is_audio_only = (mux_pad->track->type == GST_MATROSKA_TRACK_TYPE_AUDIO) &&
       (mux->num_streams == 1);
   is_min_duration_reached = (mux->min_cluster_duration == 0
       || (buffer_timestamp > mux->cluster_time
@@ -4104,7 +4066,8 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
 
       /* Forward the GstForceKeyUnit event after finishing the cluster */
       if (mux->force_key_unit_event) {
-        gst_pad_push_event (mux->srcpad, mux->force_key_unit_event);
+        gst_pad_push_event (GST_AGGREGATOR_SRC_PAD (mux),
+            mux->force_key_unit_event);
         mux->force_key_unit_event = NULL;
       }
       cluster_time_scaled =
@@ -4169,7 +4132,7 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
 
     if (mux->min_index_interval != 0) {
       for (last_idx = mux->num_indexes - 1; last_idx >= 0; last_idx--) {
-        if (mux->index[last_idx].track == collect_pad->track->num)
+        if (mux->index[last_idx].track == mux_pad->track->num)
           break;
       }
     }
@@ -4187,20 +4150,20 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
 
       idx->pos = mux->cluster_pos;
       idx->time = buffer_timestamp;
-      idx->track = collect_pad->track->num;
+      idx->track = mux_pad->track->num;
     }
   }
 
   /* Check if the duration differs from the default duration. */
   write_duration = FALSE;
   block_duration = 0;
-  if (pad->frame_duration && GST_BUFFER_DURATION_IS_VALID (buf)) {
+  if (mux_pad->frame_duration && GST_BUFFER_DURATION_IS_VALID (buf)) {
     block_duration = GST_BUFFER_DURATION (buf) + duration_diff;
     block_duration = gst_util_uint64_scale (block_duration, 1, mux->time_scale);
 
     /* small difference should be ok. */
-    if (block_duration > collect_pad->default_duration_scaled + 1 ||
-        block_duration < collect_pad->default_duration_scaled - 1) {
+    if (block_duration > mux_pad->default_duration_scaled + 1 ||
+        block_duration < mux_pad->default_duration_scaled - 1) {
       write_duration = TRUE;
     }
   }
@@ -4225,7 +4188,7 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
   if (is_video_invisible)
     flags |= 0x08;
 
-  if (!strcmp (collect_pad->track->codec_id, GST_MATROSKA_CODEC_ID_AUDIO_OPUS)) {
+  if (!strcmp (mux_pad->track->codec_id, GST_MATROSKA_CODEC_ID_AUDIO_OPUS)) {
     cmeta = gst_buffer_get_audio_clipping_meta (buf);
     g_assert (!cmeta || cmeta->format == GST_FORMAT_DEFAULT);
 
@@ -4239,7 +4202,7 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
       flags |= 0x80;
 
     hdr =
-        gst_matroska_mux_create_buffer_header (collect_pad->track,
+        gst_matroska_mux_create_buffer_header (mux_pad->track,
         relative_timestamp, flags);
     gst_ebml_write_set_cache (ebml, 0x40);
     gst_ebml_write_buffer_header (ebml, GST_MATROSKA_ID_SIMPLEBLOCK,
@@ -4255,12 +4218,12 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
      * but avoids seek and minizes pushing */
     blockgroup = gst_ebml_write_master_start (ebml, GST_MATROSKA_ID_BLOCKGROUP);
     hdr =
-        gst_matroska_mux_create_buffer_header (collect_pad->track,
+        gst_matroska_mux_create_buffer_header (mux_pad->track,
         relative_timestamp, flags);
     if (write_duration)
       gst_ebml_write_uint (ebml, GST_MATROSKA_ID_BLOCKDURATION, block_duration);
 
-    if (!strcmp (collect_pad->track->codec_id, GST_MATROSKA_CODEC_ID_AUDIO_OPUS)
+    if (!strcmp (mux_pad->track->codec_id, GST_MATROSKA_CODEC_ID_AUDIO_OPUS)
         && cmeta) {
       /* Start clipping is done via header and CodecDelay */
       if (cmeta->end) {
@@ -4284,27 +4247,25 @@ gst_matroska_mux_write_data (GstMatroskaMux * mux, GstMatroskaPad * collect_pad,
 
 /**
  * gst_matroska_mux_handle_buffer:
- * @pads: #GstCollectPads
- * @uuser_data: #GstMatroskaMux
+ * @mux: #GstMatroskaMux
+ * @best: #GstMatroskaMuxPad the buffer was taken from, or %NULL at EOS
+ * @buf: (transfer full) (nullable): the buffer to mux
  *
- * Collectpads callback.
+ * Write the headers if needed, then mux @buf or finish the file.
  *
  * Returns: #GstFlowReturn
  */
 static GstFlowReturn
-gst_matroska_mux_handle_buffer (GstCollectPads * pads, GstCollectData * data,
-    GstBuffer * buf, gpointer user_data)
+gst_matroska_mux_handle_buffer (GstMatroskaMux * mux, GstMatroskaMuxPad * best,
+    GstBuffer * buf)
 {
   GstClockTime buffer_timestamp;
-  GstMatroskaMux *mux = GST_MATROSKA_MUX (user_data);
   GstEbmlWrite *ebml = mux->ebml_write;
-  GstMatroskaPad *best = (GstMatroskaPad *) data;
   GstFlowReturn ret = GST_FLOW_OK;
-  GST_DEBUG_OBJECT (mux, "Collected pads");
 
   /* start with a header */
   if (mux->state == GST_MATROSKA_MUX_STATE_START) {
-    if (mux->collect->data == NULL) {
+    if (GST_ELEMENT (mux)->sinkpads == NULL) {
       GST_ELEMENT_ERROR (mux, STREAM, MUX, (NULL),
           ("No input streams configured"));
       return GST_FLOW_ERROR;
@@ -4324,13 +4285,14 @@ gst_matroska_mux_handle_buffer (GstCollectPads * pads, GstCollectData * data,
     } else {
       GST_DEBUG_OBJECT (mux, "... but streamable, nothing to finish");
     }
-    gst_pad_push_event (mux->srcpad, gst_event_new_eos ());
+    /* the aggregator sends EOS downstream */
     ret = GST_FLOW_EOS;
     goto exit;
   }
 
   if (best->track->codec_id == NULL) {
-    GST_ERROR_OBJECT (best->collect.pad, "No codec-id for pad");
+    GST_ERROR_OBJECT (GST_PAD (best), "No codec-id for pad");
+    gst_buffer_unref (buf);
     ret = GST_FLOW_NOT_NEGOTIATED;
     goto exit;
   }
@@ -4348,7 +4310,7 @@ gst_matroska_mux_handle_buffer (GstCollectPads * pads, GstCollectData * data,
     buffer_timestamp = 0;
   }
 
-  GST_DEBUG_OBJECT (best->collect.pad, "best pad - buffer ts %"
+  GST_DEBUG_OBJECT (GST_PAD (best), "best pad - buffer ts %"
       GST_TIME_FORMAT " dur %" GST_TIME_FORMAT,
       GST_TIME_ARGS (buffer_timestamp),
       GST_TIME_ARGS (GST_BUFFER_DURATION (buf)));
@@ -4380,53 +4342,184 @@ exit:
 }
 
 
-/**
- * gst_matroska_mux_change_state:
- * @element: #GstMatroskaMux
- * @transition: State change transition.
- *
- * Change the muxer state.
- *
- * Returns: #GstStateChangeReturn
- */
-static GstStateChangeReturn
-gst_matroska_mux_change_state (GstElement * element, GstStateChange transition)
+/* Returns the pad with the oldest queued buffer, reffed, or %NULL if no pad
+ * has data. Pads without timestamps are always picked first. */
+static GstMatroskaMuxPad *
+gst_matroska_mux_find_best_pad (GstMatroskaMux * mux, GstClockTime * best_time)
 {
-  GstStateChangeReturn ret;
-  GstMatroskaMux *mux = GST_MATROSKA_MUX (element);
+  GstMatroskaMuxPad *best = NULL;
+  GList *l;
 
-  switch (transition) {
-    case GST_STATE_CHANGE_NULL_TO_READY:
-      break;
-    case GST_STATE_CHANGE_READY_TO_PAUSED:
-      gst_collect_pads_start (mux->collect);
-      break;
-    case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
-      break;
-    case GST_STATE_CHANGE_PAUSED_TO_READY:
-      gst_collect_pads_stop (mux->collect);
-      break;
-    default:
+  *best_time = GST_CLOCK_TIME_NONE;
+
+  GST_OBJECT_LOCK (mux);
+  for (l = GST_ELEMENT (mux)->sinkpads; l; l = l->next) {
+    GstMatroskaMuxPad *mux_pad = (GstMatroskaMuxPad *) l->data;
+    GstBuffer *buf;
+    GstClockTime ts;
+
+    buf = gst_aggregator_pad_peek_buffer (GST_AGGREGATOR_PAD (mux_pad));
+    if (!buf)
+      continue;
+
+    ts = GST_BUFFER_DTS_OR_PTS (buf);
+    gst_buffer_unref (buf);
+
+    if (!GST_CLOCK_TIME_IS_VALID (ts)) {
+      gst_object_replace ((GstObject **) & best, GST_OBJECT (mux_pad));
+      *best_time = GST_CLOCK_TIME_NONE;
       break;
+    }
+
+    if (best == NULL || ts < *best_time) {
+      gst_object_replace ((GstObject **) & best, GST_OBJECT (mux_pad));
+      *best_time = ts;
+    }
   }
+  GST_OBJECT_UNLOCK (mux);
 
-  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+  return best;
+}
 
-  switch (transition) {
-    case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
-      break;
-    case GST_STATE_CHANGE_PAUSED_TO_READY:
-      gst_matroska_mux_reset (GST_ELEMENT (mux));
-      break;
-    case GST_STATE_CHANGE_READY_TO_NULL:
-      break;
-    default:
+static gboolean
+gst_matroska_mux_are_all_pads_eos (GstMatroskaMux * mux)
+{
+  GList *l;
+  gboolean ret = TRUE;
+
+  GST_OBJECT_LOCK (mux);
+  for (l = GST_ELEMENT (mux)->sinkpads; l; l = l->next) {
+    if (!gst_aggregator_pad_is_eos (GST_AGGREGATOR_PAD (l->data))) {
+      ret = FALSE;
       break;
+    }
   }
+  GST_OBJECT_UNLOCK (mux);
 
   return ret;
 }
 
+static GstFlowReturn
+gst_matroska_mux_aggregate (GstAggregator * agg, gboolean timeout)
+{
+  GstMatroskaMux *mux = GST_MATROSKA_MUX (agg);
+  GstMatroskaMuxPad *best;
+  GstClockTime best_time;
+  GstBuffer *buf = NULL;
+  GstFlowReturn ret;
+
+  best = gst_matroska_mux_find_best_pad (mux, &best_time);
+
+  if (best) {
+    buf = gst_aggregator_pad_pop_buffer (GST_AGGREGATOR_PAD (best));
+
+    /* the pad was flushed in the meantime */
+    if (!buf) {
+      gst_object_unref (best);
+      return GST_FLOW_OK;
+    }
+
+    /* GAP events are turned into empty buffers by the aggregator, they only
+     * served to advance the pad */
+    if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_GAP) &&
+        gst_buffer_get_size (buf) == 0) {
+      GST_LOG_OBJECT (best, "Dropping gap buffer %" GST_PTR_FORMAT, buf);
+      gst_buffer_unref (buf);
+      gst_object_unref (best);
+      return GST_FLOW_OK;
+    }
+  } else if (!gst_matroska_mux_are_all_pads_eos (mux)) {
+    /* timeout without any data on any pad */
+    return GST_FLOW_OK;
+  }
+
+  GST_DEBUG_OBJECT (mux, "Muxing buffer from pad %" GST_PTR_FORMAT, best);
+
+  ret = gst_matroska_mux_handle_buffer (mux, best, buf);
+
+  if (best)
+    gst_object_unref (best);
+
+  return ret;
+}
+
+static GstClockTime
+gst_matroska_mux_get_next_time (GstAggregator * agg)
+{
+  GstMatroskaMuxPad *best;
+  GstClockTime best_time;
+
+  /* Let the aggregator time out once the oldest queued buffer is due, so that
+   * live streams are not stalled by sparse pads */
+  best = gst_matroska_mux_find_best_pad (GST_MATROSKA_MUX (agg), &best_time);
+  if (best)
+    gst_object_unref (best);
+
+  return best_time;
+}
+
+static GstBuffer *
+gst_matroska_mux_clip_running_time (GstAggregator * agg,
+    GstAggregatorPad * agg_pad, GstBuffer * buf)
+{
+  GstBuffer *outbuf = buf;
+
+  /* invalid left alone and passed */
+  if (G_LIKELY (GST_CLOCK_TIME_IS_VALID (GST_BUFFER_DTS_OR_PTS (buf)))) {
+    GstClockTime time;
+    GstClockTime buf_dts, abs_dts;
+    gint dts_sign;
+
+    time = GST_BUFFER_PTS (buf);
+
+    if (GST_CLOCK_TIME_IS_VALID (time)) {
+      time =
+          gst_segment_to_running_time (&agg_pad->segment, GST_FORMAT_TIME,
+          time);
+      if (G_UNLIKELY (!GST_CLOCK_TIME_IS_VALID (time))) {
+        GST_DEBUG_OBJECT (agg_pad, "clipping buffer on pad outside segment %"
+            GST_TIME_FORMAT, GST_TIME_ARGS (GST_BUFFER_PTS (buf)));
+        gst_buffer_unref (buf);
+        return NULL;
+      }
+    }
+
+    GST_LOG_OBJECT (agg_pad, "buffer pts %" GST_TIME_FORMAT " -> %"
+        GST_TIME_FORMAT " running time",
+        GST_TIME_ARGS (GST_BUFFER_PTS (buf)), GST_TIME_ARGS (time));
+    outbuf = gst_buffer_make_writable (buf);
+    GST_BUFFER_PTS (outbuf) = time;
+
+    dts_sign = gst_segment_to_running_time_full (&agg_pad->segment,
+        GST_FORMAT_TIME, GST_BUFFER_DTS (outbuf), &abs_dts);
+    buf_dts = GST_BUFFER_DTS (outbuf);
+    if (dts_sign > 0)
+      GST_BUFFER_DTS (outbuf) = abs_dts;
+    else
+      GST_BUFFER_DTS (outbuf) = GST_CLOCK_TIME_NONE;
+
+    GST_LOG_OBJECT (agg_pad, "buffer dts %" GST_TIME_FORMAT " -> %"
+        GST_TIME_FORMAT " running time", GST_TIME_ARGS (buf_dts),
+        GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
+  }
+
+  return outbuf;
+}
+
+static gboolean
+gst_matroska_mux_start_agg (GstAggregator * agg)
+{
+  return TRUE;
+}
+
+static gboolean
+gst_matroska_mux_stop_agg (GstAggregator * agg)
+{
+  gst_matroska_mux_reset (GST_ELEMENT (agg));
+
+  return TRUE;
+}
+
 static void
 gst_matroska_mux_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec)
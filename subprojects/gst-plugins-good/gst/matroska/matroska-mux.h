@@ -24,7 +24,7 @@
 #define __GST_MATROSKA_MUX_H__
 
 #include <gst/gst.h>
-#include <gst/base/gstcollectpads.h>
+#include <gst/base/gstaggregator.h>
 
 #include "ebml-write.h"
 #include "matroska-ids.h"
@@ -53,6 +53,15 @@ typedef struct _GstMatroskaMetaSeekIndex {
   guint64  pos;
 } GstMatroskaMetaSeekIndex;
 
+#define GST_TYPE_MATROSKA_MUX_PAD \
+  (gst_matroska_mux_pad_get_type ())
+#define GST_MATROSKA_MUX_PAD(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_MATROSKA_MUX_PAD, GstMatroskaMuxPad))
+#define GST_MATROSKA_MUX_PAD_CAST(obj) \
+  ((GstMatroskaMuxPad *) (obj))
+#define GST_IS_MATROSKA_MUX_PAD(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_MATROSKA_MUX_PAD))
+
 typedef gboolean (*GstMatroskaCapsFunc) (GstPad *pad, GstCaps *caps);
 
 typedef struct _GstMatroskaMux GstMatroskaMux;
@@ -60,7 +69,12 @@ typedef struct _GstMatroskaMux GstMatroskaMux;
 /* all information needed for one matroska stream */
 typedef struct
 {
-  GstCollectData collect;       /* we extend the CollectData */
+  GstAggregatorPad parent;
+
+  /* properties */
+  gboolean frame_duration;
+  gboolean frame_duration_user;
+
   GstMatroskaCapsFunc capsfunc;
   GstMatroskaTrackContext *track;
 
@@ -72,17 +86,15 @@ typedef struct
   GstClockTime end_ts;    /* last timestamp + (if available) duration */
   guint64 default_duration_scaled;
 }
-GstMatroskaPad;
+GstMatroskaMuxPad;
 
+typedef GstAggregatorPadClass GstMatroskaMuxPadClass;
 
 struct _GstMatroskaMux {
-  GstElement     element;
+  GstAggregator  aggregator;
 
   /* < private > */
 
-  /* pads */
-  GstPad        *srcpad;
-  GstCollectPads *collect;
   GstEbmlWrite *ebml_write;
 
   guint          num_streams,
@@ -150,10 +162,11 @@ struct _GstMatroskaMux {
 };
 
 typedef struct _GstMatroskaMuxClass {
-  GstElementClass parent;
+  GstAggregatorClass parent;
 } GstMatroskaMuxClass;
 
 GType   gst_matroska_mux_get_type (void);
+GType   gst_matroska_mux_pad_get_type (void);
 
 G_END_DECLS
 
@@ -85,11 +85,12 @@ gst_webm_mux_class_init (GstWebMMuxClass * klass)
 {
   GstElementClass *gstelement_class = (GstElementClass *) klass;
 
-  gst_element_class_add_static_pad_template (gstelement_class,
-      &webm_videosink_templ);
-  gst_element_class_add_static_pad_template (gstelement_class,
-      &webm_audiosink_templ);
-  gst_element_class_add_static_pad_template (gstelement_class, &webm_src_templ);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &webm_videosink_templ, GST_TYPE_MATROSKA_MUX_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &webm_audiosink_templ, GST_TYPE_MATROSKA_MUX_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
+      &webm_src_templ, GST_TYPE_AGGREGATOR_PAD);
   gst_element_class_set_static_metadata (gstelement_class, "WebM muxer",
       "Codec/Muxer",
       "Muxes video and audio streams into a WebM stream",
@@ -0,0 +1,328 @@
+/* GStreamer File Prefetching Utility Functions
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Reads upcoming files of a sequence in a pool of worker threads so that the
+ * streaming thread does not stall on file I/O, and optionally keeps the most
+ * recently read files around so that looping over a short sequence does not
+ * hit the disk again. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstfileprefetcher.h"
+
+GST_DEBUG_CATEGORY_STATIC (file_prefetcher_debug);
+#define GST_CAT_DEFAULT file_prefetcher_debug
+
+typedef struct
+{
+  gchar *filename;
+
+  /* protected by the prefetcher lock */
+  GstBuffer *buffer;
+  GError *error;
+  gboolean done;
+  /* set when the entry was dropped while a worker still owns it, the worker
+   * frees it then */
+  gboolean cancelled;
+  /* link in the LRU list if the entry is cached */
+  GList *lru_link;
+} GstFilePrefetchEntry;
+
+struct _GstFilePrefetcher
+{
+  GstObject *parent;
+
+  GMutex lock;
+  GCond cond;
+  GThreadPool *pool;
+
+  /* filename -> GstFilePrefetchEntry */
+  GHashTable *entries;
+
+  /* cached entries, most recently used first */
+  GQueue lru;
+  guint64 cache_size;
+  guint64 cached_bytes;
+};
+
+static void
+gst_file_prefetch_entry_free (GstFilePrefetchEntry * entry)
+{
+  g_free (entry->filename);
+  gst_clear_buffer (&entry->buffer);
+  g_clear_error (&entry->error);
+  g_free (entry);
+}
+
+static GstBuffer *
+gst_file_prefetcher_load (const gchar * filename, GError ** error)
+{
+  gchar *data;
+  gsize size;
+
+  if (!g_file_get_contents (filename, &data, &size, error))
+    return NULL;
+
+  return gst_buffer_new_wrapped (data, size);
+}
+
+static void
+gst_file_prefetcher_worker (GstFilePrefetchEntry * entry,
+    GstFilePrefetcher * prefetcher)
+{
+  GstBuffer *buffer;
+  GError *error = NULL;
+  gboolean cancelled;
+
+  g_mutex_lock (&prefetcher->lock);
+  cancelled = entry->cancelled;
+  g_mutex_unlock (&prefetcher->lock);
+
+  if (cancelled) {
+    gst_file_prefetch_entry_free (entry);
+    return;
+  }
+
+  GST_LOG_OBJECT (prefetcher->parent, "prefetching %s", entry->filename);
+  buffer = gst_file_prefetcher_load (entry->filename, &error);
+
+  g_mutex_lock (&prefetcher->lock);
+  if (entry->cancelled) {
+    g_mutex_unlock (&prefetcher->lock);
+    gst_clear_buffer (&buffer);
+    g_clear_error (&error);
+    gst_file_prefetch_entry_free (entry);
+    return;
+  }
+  entry->buffer = buffer;
+  entry->error = error;
+  entry->done = TRUE;
+  g_cond_broadcast (&prefetcher->cond);
+  g_mutex_unlock (&prefetcher->lock);
+}
+
+/* call with the lock held, takes ownership of @entry */
+static void
+gst_file_prefetcher_drop_entry (GstFilePrefetcher * prefetcher,
+    GstFilePrefetchEntry * entry)
+{
+  g_hash_table_steal (prefetcher->entries, entry->filename);
+
+  if (entry->lru_link) {
+    prefetcher->cached_bytes -= gst_buffer_get_size (entry->buffer);
+    g_queue_delete_link (&prefetcher->lru, entry->lru_link);
+    entry->lru_link = NULL;
+  }
+
+  if (entry->done)
+    gst_file_prefetch_entry_free (entry);
+  else
+    entry->cancelled = TRUE;
+}
+
+/* call with the lock held */
+static void
+gst_file_prefetcher_cache_entry (GstFilePrefetcher * prefetcher,
+    GstFilePrefetchEntry * entry)
+{
+  gsize size = gst_buffer_get_size (entry->buffer);
+
+  if (entry->lru_link) {
+    g_queue_unlink (&prefetcher->lru, entry->lru_link);
+    g_queue_push_head_link (&prefetcher->lru, entry->lru_link);
+    return;
+  }
+
+  if (size > prefetcher->cache_size) {
+    gst_file_prefetcher_drop_entry (prefetcher, entry);
+    return;
+  }
+
+  while (prefetcher->cached_bytes + size > prefetcher->cache_size) {
+    GstFilePrefetchEntry *oldest = g_queue_peek_tail (&prefetcher->lru);
+
+    GST_LOG_OBJECT (prefetcher->parent, "evicting %s", oldest->filename);
+    gst_file_prefetcher_drop_entry (prefetcher, oldest);
+  }
+
+  g_queue_push_head (&prefetcher->lru, entry);
+  entry->lru_link = prefetcher->lru.head;
+  prefetcher->cached_bytes += size;
+}
+
+GstFilePrefetcher *
+gst_file_prefetcher_new (GstObject * parent, guint n_threads,
+    guint64 cache_size)
+{
+  GstFilePrefetcher *prefetcher;
+
+  GST_DEBUG_CATEGORY_INIT (file_prefetcher_debug, "fileprefetcher", 0,
+      "multifile prefetching");
+
+  prefetcher = g_new0 (GstFilePrefetcher, 1);
+  prefetcher->parent = parent;
+  g_mutex_init (&prefetcher->lock);
+  g_cond_init (&prefetcher->cond);
+  prefetcher->entries = g_hash_table_new (g_str_hash, g_str_equal);
+  g_queue_init (&prefetcher->lru);
+  prefetcher->cache_size = cache_size;
+
+  if (n_threads > 0)
+    prefetcher->pool =
+        g_thread_pool_new ((GFunc) gst_file_prefetcher_worker, prefetcher,
+        n_threads, FALSE, NULL);
+
+  return prefetcher;
+}
+
+void
+gst_file_prefetcher_free (GstFilePrefetcher * prefetcher)
+{
+  GHashTableIter iter;
+  GstFilePrefetchEntry *entry;
+
+  g_mutex_lock (&prefetcher->lock);
+  g_hash_table_iter_init (&iter, prefetcher->entries);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & entry)) {
+    g_hash_table_iter_steal (&iter);
+    if (entry->done)
+      gst_file_prefetch_entry_free (entry);
+    else
+      entry->cancelled = TRUE;
+  }
+  g_queue_clear (&prefetcher->lru);
+  g_mutex_unlock (&prefetcher->lock);
+
+  /* waits for running workers, which free their cancelled entries */
+  if (prefetcher->pool)
+    g_thread_pool_free (prefetcher->pool, FALSE, TRUE);
+
+  g_hash_table_unref (prefetcher->entries);
+  g_cond_clear (&prefetcher->cond);
+  g_mutex_clear (&prefetcher->lock);
+  g_free (prefetcher);
+}
+
+static gboolean
+gst_file_prefetcher_is_wanted (const gchar * filename, const gchar * current,
+    gchar ** next_filenames)
+{
+  if (g_str_equal (filename, current))
+    return TRUE;
+
+  return next_filenames && g_strv_contains ((const gchar * const *)
+      next_filenames, filename);
+}
+
+/**
+ * gst_file_prefetcher_read:
+ * @prefetcher: a #GstFilePrefetcher
+ * @filename: the file to read now
+ * @next_filenames: (nullable): %NULL-terminated list of the files that will
+ *   be read next, in order
+ * @error: return location for a #GError
+ *
+ * Returns the contents of @filename, waiting for a pending background read of
+ * it or reading it synchronously, and queues background reads for
+ * @next_filenames. Pending reads that are not in @next_filenames anymore are
+ * dropped.
+ *
+ * Returns: (transfer full) (nullable): the file contents or %NULL on error
+ */
+GstBuffer *
+gst_file_prefetcher_read (GstFilePrefetcher * prefetcher,
+    const gchar * filename, gchar ** next_filenames, GError ** error)
+{
+  GHashTableIter iter;
+  GstFilePrefetchEntry *entry;
+  GstBuffer *buffer = NULL;
+  guint i;
+
+  g_mutex_lock (&prefetcher->lock);
+
+  /* drop stale prefetches, e.g. after a seek or a direction change */
+  g_hash_table_iter_init (&iter, prefetcher->entries);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & entry)) {
+    if (entry->lru_link
+        || gst_file_prefetcher_is_wanted (entry->filename, filename,
+            next_filenames))
+      continue;
+
+    GST_LOG_OBJECT (prefetcher->parent, "dropping prefetch of %s",
+        entry->filename);
+    g_hash_table_iter_steal (&iter);
+    if (entry->done)
+      gst_file_prefetch_entry_free (entry);
+    else
+      entry->cancelled = TRUE;
+  }
+
+  for (i = 0; prefetcher->pool && next_filenames && next_filenames[i]; i++) {
+    GstFilePrefetchEntry *next;
+
+    if (g_hash_table_contains (prefetcher->entries, next_filenames[i]))
+      continue;
+
+    next = g_new0 (GstFilePrefetchEntry, 1);
+    next->filename = g_strdup (next_filenames[i]);
+    g_hash_table_insert (prefetcher->entries, next->filename, next);
+    g_thread_pool_push (prefetcher->pool, next, NULL);
+  }
+
+  entry = g_hash_table_lookup (prefetcher->entries, filename);
+  if (!entry) {
+    g_mutex_unlock (&prefetcher->lock);
+
+    buffer = gst_file_prefetcher_load (filename, error);
+    if (!buffer || prefetcher->cache_size == 0)
+      return buffer;
+
+    g_mutex_lock (&prefetcher->lock);
+    if (!g_hash_table_contains (prefetcher->entries, filename)) {
+      entry = g_new0 (GstFilePrefetchEntry, 1);
+      entry->filename = g_strdup (filename);
+      entry->buffer = gst_buffer_ref (buffer);
+      entry->done = TRUE;
+      g_hash_table_insert (prefetcher->entries, entry->filename, entry);
+      gst_file_prefetcher_cache_entry (prefetcher, entry);
+    }
+    g_mutex_unlock (&prefetcher->lock);
+
+    return buffer;
+  }
+
+  while (!entry->done)
+    g_cond_wait (&prefetcher->cond, &prefetcher->lock);
+
+  if (entry->error) {
+    g_propagate_error (error, g_steal_pointer (&entry->error));
+    gst_file_prefetcher_drop_entry (prefetcher, entry);
+  } else {
+    buffer = gst_buffer_ref (entry->buffer);
+    if (prefetcher->cache_size > 0)
+      gst_file_prefetcher_cache_entry (prefetcher, entry);
+    else
+      gst_file_prefetcher_drop_entry (prefetcher, entry);
+  }
+
+  g_mutex_unlock (&prefetcher->lock);
+
+  return buffer;
+}
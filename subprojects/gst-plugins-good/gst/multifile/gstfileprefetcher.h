@@ -0,0 +1,39 @@
+/* GStreamer File Prefetching Utility Functions
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_FILE_PREFETCHER_H__
+#define __GST_FILE_PREFETCHER_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstFilePrefetcher GstFilePrefetcher;
+
+G_GNUC_INTERNAL
+GstFilePrefetcher * gst_file_prefetcher_new (GstObject * parent, guint n_threads, guint64 cache_size);
+
+G_GNUC_INTERNAL
+void gst_file_prefetcher_free (GstFilePrefetcher * prefetcher);
+
+G_GNUC_INTERNAL
+GstBuffer * gst_file_prefetcher_read (GstFilePrefetcher * prefetcher, const gchar * filename, gchar ** next_filenames, GError ** error);
+
+G_END_DECLS
+
+#endif /* __GST_FILE_PREFETCHER_H__ */
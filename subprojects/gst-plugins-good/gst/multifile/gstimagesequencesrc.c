@@ -54,6 +54,8 @@
 
 static GstFlowReturn gst_image_sequence_src_create (GstPushSrc * src,
     GstBuffer ** buffer);
+static gboolean gst_image_sequence_src_start (GstBaseSrc * src);
+static gboolean gst_image_sequence_src_stop (GstBaseSrc * src);
 
 
 static void gst_image_sequence_src_set_property (GObject * object,
@@ -86,13 +88,17 @@ enum
   PROP_LOCATION,
   PROP_START_INDEX,
   PROP_STOP_INDEX,
-  PROP_FRAMERATE
+  PROP_FRAMERATE,
+  PROP_PREFETCH,
+  PROP_CACHE_SIZE
 };
 
 #define DEFAULT_LOCATION "%05d"
 #define DEFAULT_START_INDEX 0
 #define DEFAULT_STOP_INDEX -1
 #define DEFAULT_FRAMERATE 30
+#define DEFAULT_PREFETCH 0
+#define DEFAULT_CACHE_SIZE 0
 
 /* Call with LOCK taken */
 static gboolean
@@ -320,6 +326,38 @@ gst_image_sequence_src_class_init (GstImageSequenceSrcClass * klass)
           1, 1, G_MAXINT, 1, DEFAULT_FRAMERATE, 1,
           G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstImageSequenceSrc:prefetch:
+   *
+   * Number of upcoming images to read ahead in background threads while the
+   * current one is being pushed downstream. 0 reads every image in the
+   * streaming thread when it is needed.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_PREFETCH,
+      g_param_spec_uint ("prefetch", "Prefetch",
+          "Number of upcoming images to read ahead in parallel (0 = disabled)",
+          0, 64, DEFAULT_PREFETCH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstImageSequenceSrc:cache-size:
+   *
+   * Maximum number of bytes of image files to keep in memory after they have
+   * been read, so that seeking back into recently played parts of the
+   * sequence does not read the files again. 0 disables the cache.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_SIZE,
+      g_param_spec_uint64 ("cache-size", "Cache Size",
+          "Maximum number of bytes of read images to keep in memory "
+          "(0 = disabled)", 0, G_MAXUINT64, DEFAULT_CACHE_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gobject_class->finalize = gst_image_sequence_src_finalize;
   gobject_class->dispose = gst_image_sequence_src_dispose;
 
@@ -327,6 +365,8 @@ gst_image_sequence_src_class_init (GstImageSequenceSrcClass * klass)
   gstbasesrc_class->query = gst_image_sequence_src_query;
   gstbasesrc_class->is_seekable = is_seekable;
   gstbasesrc_class->do_seek = do_seek;
+  gstbasesrc_class->start = gst_image_sequence_src_start;
+  gstbasesrc_class->stop = gst_image_sequence_src_stop;
 
   gstpushsrc_class->create = gst_image_sequence_src_create;
 
@@ -359,6 +399,37 @@ gst_image_sequence_src_init (GstImageSequenceSrc * self)
   self->n_frames = 0;
   self->fps_n = 30;
   self->fps_d = 1;
+  self->prefetch = DEFAULT_PREFETCH;
+  self->cache_size = DEFAULT_CACHE_SIZE;
+}
+
+static gboolean
+gst_image_sequence_src_start (GstBaseSrc * src)
+{
+  GstImageSequenceSrc *self = GST_IMAGE_SEQUENCE_SRC (src);
+
+  LOCK (self);
+  if (self->prefetch > 0 || self->cache_size > 0)
+    self->prefetcher = gst_file_prefetcher_new (GST_OBJECT (self),
+        self->prefetch, self->cache_size);
+  UNLOCK (self);
+
+  return TRUE;
+}
+
+static gboolean
+gst_image_sequence_src_stop (GstBaseSrc * src)
+{
+  GstImageSequenceSrc *self = GST_IMAGE_SEQUENCE_SRC (src);
+
+  LOCK (self);
+  if (self->prefetcher) {
+    gst_file_prefetcher_free (self->prefetcher);
+    self->prefetcher = NULL;
+  }
+  UNLOCK (self);
+
+  return TRUE;
 }
 
 static GstCaps *
@@ -444,6 +515,12 @@ gst_image_sequence_src_set_property (GObject * object, guint prop_id,
       self->fps_n = gst_value_get_fraction_numerator (value);
       self->fps_d = gst_value_get_fraction_denominator (value);
       break;
+    case PROP_PREFETCH:
+      self->prefetch = g_value_get_uint (value);
+      break;
+    case PROP_CACHE_SIZE:
+      self->cache_size = g_value_get_uint64 (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -474,6 +551,12 @@ gst_image_sequence_src_get_property (GObject * object, guint prop_id,
       GST_DEBUG_OBJECT (self, "Set (framerate) property to (%d/%d)",
           self->fps_n, self->fps_d);
       break;
+    case PROP_PREFETCH:
+      g_value_set_uint (value, self->prefetch);
+      break;
+    case PROP_CACHE_SIZE:
+      g_value_set_uint64 (value, self->cache_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -565,6 +648,27 @@ gst_image_sequence_src_get_filename (GstImageSequenceSrc * self)
   return filename;
 }
 
+/* Call with LOCK, returns the file names of the images that follow the
+ * current index in playback direction */
+static gchar **
+gst_image_sequence_src_get_next_filenames (GstImageSequenceSrc * self)
+{
+  gchar **filenames;
+  gint index = self->index;
+  guint i, n = 0;
+
+  filenames = g_new0 (gchar *, self->prefetch + 1);
+  for (i = 0; i < self->prefetch; i++) {
+    index += self->reverse ? -1 : 1;
+    if (index < self->start_index ||
+        (self->stop_index > 0 && index > self->stop_index))
+      break;
+    filenames[n++] = g_strdup_printf (self->path, index);
+  }
+
+  return filenames;
+}
+
 static GstFlowReturn
 gst_image_sequence_src_create (GstPushSrc * src, GstBuffer ** buffer)
 {
@@ -572,8 +676,9 @@ gst_image_sequence_src_create (GstPushSrc * src, GstBuffer ** buffer)
   gsize size;
   gchar *data;
   gchar *filename;
+  gchar **next_filenames = NULL;
+  GstFilePrefetcher *prefetcher;
   GstBuffer *buf;
-  gboolean ret;
   GError *error = NULL;
   gint fps_n, fps_d, start_index, stop_index;
 
@@ -597,16 +702,30 @@ gst_image_sequence_src_create (GstPushSrc * src, GstBuffer ** buffer)
   filename = gst_image_sequence_src_get_filename (self);
   fps_n = self->fps_n;
   fps_d = self->fps_d;
+  prefetcher = self->prefetcher;
+  if (prefetcher)
+    next_filenames = gst_image_sequence_src_get_next_filenames (self);
   UNLOCK (self);
 
-  if (!filename)
+  if (!filename) {
+    g_strfreev (next_filenames);
     goto handle_error;
+  }
 
-  ret = g_file_get_contents (filename, &data, &size, &error);
-  if (!ret)
-    goto handle_error;
+  if (prefetcher) {
+    buf = gst_file_prefetcher_read (prefetcher, filename, next_filenames,
+        &error);
+    g_strfreev (next_filenames);
+    if (!buf)
+      goto handle_error;
 
-  buf = gst_buffer_new_wrapped_full (0, data, size, 0, size, NULL, g_free);
+    buf = gst_buffer_make_writable (buf);
+  } else {
+    if (!g_file_get_contents (filename, &data, &size, &error))
+      goto handle_error;
+
+    buf = gst_buffer_new_wrapped_full (0, data, size, 0, size, NULL, g_free);
+  }
 
   if (!self->caps) {
     GstCaps *caps;
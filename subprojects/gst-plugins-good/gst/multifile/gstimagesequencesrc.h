@@ -24,6 +24,8 @@
 #include <gst/gst.h>
 #include <gst/base/gstpushsrc.h>
 
+#include "gstfileprefetcher.h"
+
 G_BEGIN_DECLS
 
 #define GST_TYPE_IMAGE_SEQUENCE_SRC (gst_image_sequence_src_get_type())
@@ -47,6 +49,10 @@ struct _GstImageSequenceSrc
   GstCaps *caps;
 
   gint fps_n, fps_d;
+
+  guint prefetch;
+  guint64 cache_size;
+  GstFilePrefetcher *prefetcher;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (imagesequencesrc);
@@ -50,6 +50,8 @@
 
 static GstFlowReturn gst_multi_file_src_create (GstPushSrc * src,
     GstBuffer ** buffer);
+static gboolean gst_multi_file_src_start (GstBaseSrc * src);
+static gboolean gst_multi_file_src_stop (GstBaseSrc * src);
 
 static void gst_multi_file_src_dispose (GObject * object);
 
@@ -80,11 +82,15 @@ enum
   PROP_START_INDEX,
   PROP_STOP_INDEX,
   PROP_CAPS,
-  PROP_LOOP
+  PROP_LOOP,
+  PROP_PREFETCH,
+  PROP_CACHE_SIZE
 };
 
 #define DEFAULT_LOCATION "%05d"
 #define DEFAULT_INDEX 0
+#define DEFAULT_PREFETCH 0
+#define DEFAULT_CACHE_SIZE 0
 
 #define gst_multi_file_src_parent_class parent_class
 G_DEFINE_TYPE_WITH_CODE (GstMultiFileSrc, gst_multi_file_src, GST_TYPE_PUSH_SRC,
@@ -181,12 +187,46 @@ gst_multi_file_src_class_init (GstMultiFileSrcClass * klass)
           "Whether to repeat from the beginning when all files have been read.",
           FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiFileSrc:prefetch:
+   *
+   * Number of upcoming files to read ahead in background threads while the
+   * current one is being pushed downstream. 0 reads every file in the
+   * streaming thread when it is needed.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_PREFETCH,
+      g_param_spec_uint ("prefetch", "Prefetch",
+          "Number of upcoming files to read ahead in parallel (0 = disabled)",
+          0, 64, DEFAULT_PREFETCH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstMultiFileSrc:cache-size:
+   *
+   * Maximum number of bytes of file contents to keep in memory after they
+   * have been read, so that looping over a sequence that fits into the cache
+   * does not read the files again. 0 disables the cache.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_SIZE,
+      g_param_spec_uint64 ("cache-size", "Cache Size",
+          "Maximum number of bytes of read files to keep in memory "
+          "(0 = disabled)", 0, G_MAXUINT64, DEFAULT_CACHE_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gobject_class->dispose = gst_multi_file_src_dispose;
 
   gstbasesrc_class->get_caps = gst_multi_file_src_getcaps;
   gstbasesrc_class->query = gst_multi_file_src_query;
   gstbasesrc_class->is_seekable = is_seekable;
   gstbasesrc_class->do_seek = do_seek;
+  gstbasesrc_class->start = gst_multi_file_src_start;
+  gstbasesrc_class->stop = gst_multi_file_src_stop;
 
   gstpushsrc_class->create = gst_multi_file_src_create;
 
@@ -209,7 +249,34 @@ gst_multi_file_src_init (GstMultiFileSrc * multifilesrc)
   multifilesrc->filename = g_strdup (DEFAULT_LOCATION);
   multifilesrc->successful_read = FALSE;
   multifilesrc->fps_n = multifilesrc->fps_d = -1;
+  multifilesrc->prefetch = DEFAULT_PREFETCH;
+  multifilesrc->cache_size = DEFAULT_CACHE_SIZE;
+}
+
+static gboolean
+gst_multi_file_src_start (GstBaseSrc * src)
+{
+  GstMultiFileSrc *multifilesrc = GST_MULTI_FILE_SRC (src);
+
+  if (multifilesrc->prefetch > 0 || multifilesrc->cache_size > 0)
+    multifilesrc->prefetcher =
+        gst_file_prefetcher_new (GST_OBJECT (multifilesrc),
+        multifilesrc->prefetch, multifilesrc->cache_size);
 
+  return TRUE;
+}
+
+static gboolean
+gst_multi_file_src_stop (GstBaseSrc * src)
+{
+  GstMultiFileSrc *multifilesrc = GST_MULTI_FILE_SRC (src);
+
+  if (multifilesrc->prefetcher) {
+    gst_file_prefetcher_free (multifilesrc->prefetcher);
+    multifilesrc->prefetcher = NULL;
+  }
+
+  return TRUE;
 }
 
 static void
@@ -349,6 +416,12 @@ gst_multi_file_src_set_property (GObject * object, guint prop_id,
     case PROP_LOOP:
       src->loop = g_value_get_boolean (value);
       break;
+    case PROP_PREFETCH:
+      src->prefetch = g_value_get_uint (value);
+      break;
+    case PROP_CACHE_SIZE:
+      src->cache_size = g_value_get_uint64 (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -380,6 +453,12 @@ gst_multi_file_src_get_property (GObject * object, guint prop_id,
     case PROP_LOOP:
       g_value_set_boolean (value, src->loop);
       break;
+    case PROP_PREFETCH:
+      g_value_set_uint (value, src->prefetch);
+      break;
+    case PROP_CACHE_SIZE:
+      g_value_set_uint64 (value, src->cache_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -397,15 +476,65 @@ gst_multi_file_src_get_filename (GstMultiFileSrc * multifilesrc)
   return filename;
 }
 
+/* file names of the files that follow the current index */
+static gchar **
+gst_multi_file_src_get_next_filenames (GstMultiFileSrc * multifilesrc)
+{
+  gchar **filenames;
+  gint index = multifilesrc->index;
+  guint i, n = 0;
+
+  filenames = g_new0 (gchar *, multifilesrc->prefetch + 1);
+  for (i = 0; i < multifilesrc->prefetch; i++) {
+    index++;
+    if (multifilesrc->stop_index != -1 && index > multifilesrc->stop_index) {
+      if (!multifilesrc->loop)
+        break;
+      index = multifilesrc->start_index;
+    }
+    if (index == multifilesrc->index)
+      break;
+    filenames[n++] = g_strdup_printf (multifilesrc->filename, index);
+  }
+
+  return filenames;
+}
+
+static GstBuffer *
+gst_multi_file_src_read_file (GstMultiFileSrc * multifilesrc,
+    const gchar * filename, GError ** error)
+{
+  GstBuffer *buf;
+  gchar **next_filenames;
+  gsize size;
+  gchar *data;
+
+  if (multifilesrc->prefetcher) {
+    next_filenames = gst_multi_file_src_get_next_filenames (multifilesrc);
+    buf = gst_file_prefetcher_read (multifilesrc->prefetcher, filename,
+        next_filenames, error);
+    g_strfreev (next_filenames);
+
+    return buf ? gst_buffer_make_writable (buf) : NULL;
+  }
+
+  if (!g_file_get_contents (filename, &data, &size, error))
+    return NULL;
+
+  buf = gst_buffer_new ();
+  gst_buffer_append_memory (buf,
+      gst_memory_new_wrapped (0, data, size, 0, size, data, g_free));
+
+  return buf;
+}
+
 static GstFlowReturn
 gst_multi_file_src_create (GstPushSrc * src, GstBuffer ** buffer)
 {
   GstMultiFileSrc *multifilesrc;
   gsize size;
-  gchar *data;
   gchar *filename;
   GstBuffer *buf;
-  gboolean ret;
   GError *error = NULL;
 
   multifilesrc = GST_MULTI_FILE_SRC (src);
@@ -426,8 +555,8 @@ gst_multi_file_src_create (GstPushSrc * src, GstBuffer ** buffer)
 
   GST_DEBUG_OBJECT (multifilesrc, "reading from file \"%s\".", filename);
 
-  ret = g_file_get_contents (filename, &data, &size, &error);
-  if (!ret) {
+  buf = gst_multi_file_src_read_file (multifilesrc, filename, &error);
+  if (!buf) {
     if (multifilesrc->successful_read) {
       /* If we've read at least one buffer successfully, not finding the
        * next file is EOS. */
@@ -440,8 +569,8 @@ gst_multi_file_src_create (GstPushSrc * src, GstBuffer ** buffer)
         multifilesrc->index = multifilesrc->start_index;
 
         filename = gst_multi_file_src_get_filename (multifilesrc);
-        ret = g_file_get_contents (filename, &data, &size, &error);
-        if (!ret) {
+        buf = gst_multi_file_src_read_file (multifilesrc, filename, &error);
+        if (!buf) {
           g_free (filename);
           if (error != NULL)
             g_error_free (error);
@@ -459,9 +588,7 @@ gst_multi_file_src_create (GstPushSrc * src, GstBuffer ** buffer)
   multifilesrc->successful_read = TRUE;
   multifilesrc->index++;
 
-  buf = gst_buffer_new ();
-  gst_buffer_append_memory (buf,
-      gst_memory_new_wrapped (0, data, size, 0, size, data, g_free));
+  size = gst_buffer_get_size (buf);
   GST_BUFFER_OFFSET (buf) = multifilesrc->offset;
   GST_BUFFER_OFFSET_END (buf) = multifilesrc->offset + size;
   multifilesrc->offset += size;
@@ -25,6 +25,8 @@
 #include <gst/gst.h>
 #include <gst/base/gstpushsrc.h>
 
+#include "gstfileprefetcher.h"
+
 G_BEGIN_DECLS
 
 #define GST_TYPE_MULTI_FILE_SRC \
@@ -58,6 +60,10 @@ struct _GstMultiFileSrc
   gboolean successful_read;
 
   gint fps_n, fps_d;
+
+  guint prefetch;
+  guint64 cache_size;
+  GstFilePrefetcher *prefetcher;
 };
 
 struct _GstMultiFileSrcClass
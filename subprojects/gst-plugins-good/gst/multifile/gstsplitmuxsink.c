@@ -45,6 +45,9 @@
  * next fragment. For that reason, instead of muxer and sink objects, the
  * muxer-factory and sink-factory properties are used to construct the new
  * objects, together with muxer-properties and sink-properties.
+ * With the fragment-pool-size property, these muxer and sink pairs are
+ * created and linked ahead of time from a background thread, so that starting
+ * a new fragment does not need to construct any element.
  *
  * ## Example pipelines
  * |[
@@ -119,7 +122,8 @@ enum
   PROP_SINK_FACTORY,
   PROP_SINK_PRESET,
   PROP_SINK_PROPERTIES,
-  PROP_MUXERPAD_MAP
+  PROP_MUXERPAD_MAP,
+  PROP_FRAGMENT_POOL_SIZE
 };
 
 #define DEFAULT_MAX_SIZE_TIME       0
@@ -134,6 +138,7 @@ enum
 #define DEFAULT_RESET_MUXER TRUE
 #define DEFAULT_ASYNC_FINALIZE FALSE
 #define DEFAULT_START_INDEX 0
+#define DEFAULT_FRAGMENT_POOL_SIZE 0
 
 typedef struct _AsyncEosHelper
 {
@@ -475,6 +480,22 @@ gst_splitmux_sink_class_init (GstSplitMuxSinkClass * klass)
           GST_TYPE_STRUCTURE,
           (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 
+  /**
+   * GstSplitMuxSink:fragment-pool-size
+   *
+   * Number of muxer and sink pairs to create and link ahead of time from a
+   * background thread, so that switching to a new fragment only has to pick
+   * one from the pool. This only has an effect in `async-finalize=TRUE` mode.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_FRAGMENT_POOL_SIZE,
+      g_param_spec_uint ("fragment-pool-size", "Fragment pool size",
+          "Number of muxer/sink pairs to prepare ahead of time. "
+          "Valid only for async-finalize = TRUE",
+          0, 32, DEFAULT_FRAGMENT_POOL_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstSplitMuxSink::format-location:
    * @splitmux: the #GstSplitMuxSink
@@ -616,6 +637,8 @@ gst_splitmux_sink_init (GstSplitMuxSink * splitmux)
   splitmux->muxer_properties = NULL;
   splitmux->sink_factory = g_strdup (DEFAULT_SINK);
   splitmux->sink_properties = NULL;
+  splitmux->fragment_pool_size = DEFAULT_FRAGMENT_POOL_SIZE;
+  g_queue_init (&splitmux->fragment_pool);
 
   GST_OBJECT_FLAG_SET (splitmux, GST_ELEMENT_FLAG_SINK);
   splitmux->split_requested = FALSE;
@@ -667,6 +690,9 @@ gst_splitmux_sink_finalize (GObject * object)
   g_queue_clear (&splitmux->out_cmd_q);
   g_queue_foreach (&splitmux->pending_input_gops, (GFunc) input_gop_free, NULL);
   g_queue_clear (&splitmux->pending_input_gops);
+  /* The pooled elements themselves were released with the bin children */
+  g_queue_foreach (&splitmux->fragment_pool, (GFunc) g_free, NULL);
+  g_queue_clear (&splitmux->fragment_pool);
 
   g_clear_pointer (&splitmux->fragment_start_tc, gst_video_time_code_free);
 
@@ -919,6 +945,11 @@ gst_splitmux_sink_set_property (GObject * object, guint prop_id,
       GST_SPLITMUX_UNLOCK (splitmux);
       break;
     }
+    case PROP_FRAGMENT_POOL_SIZE:
+      GST_SPLITMUX_LOCK (splitmux);
+      splitmux->fragment_pool_size = g_value_get_uint (value);
+      GST_SPLITMUX_UNLOCK (splitmux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1037,6 +1068,11 @@ gst_splitmux_sink_get_property (GObject * object, guint prop_id,
       gst_value_set_structure (value, splitmux->muxerpad_map);
       GST_SPLITMUX_UNLOCK (splitmux);
       break;
+    case PROP_FRAGMENT_POOL_SIZE:
+      GST_SPLITMUX_LOCK (splitmux);
+      g_value_set_uint (value, splitmux->fragment_pool_size);
+      GST_SPLITMUX_UNLOCK (splitmux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1993,6 +2029,124 @@ _send_event (const GValue * value, gpointer user_data)
   gst_pad_send_event (pad, gst_event_ref (ev));
 }
 
+typedef struct _FragmentElements
+{
+  GstElement *muxer;
+  GstElement *sink;
+} FragmentElements;
+
+/* Creates a new muxer and sink pair from the configured factories, in
+ * locked state and linked together. Used in async-finalize mode */
+static gboolean
+create_fragment_elements (GstSplitMuxSink * splitmux, const gchar * prefix,
+    guint id, GstElement ** muxer_out, GstElement ** sink_out)
+{
+  GstElement *muxer, *sink;
+  gchar *name;
+
+  name = g_strdup_printf ("%ssink_%u", prefix, id);
+  sink = create_element (splitmux, splitmux->sink_factory, name, TRUE);
+  g_free (name);
+  if (sink == NULL)
+    return FALSE;
+
+  if (splitmux->sink_preset && GST_IS_PRESET (sink))
+    gst_preset_load_preset (GST_PRESET (sink), splitmux->sink_preset);
+  if (splitmux->sink_properties)
+    gst_structure_foreach (splitmux->sink_properties,
+        _set_property_from_structure, sink);
+  g_signal_emit (splitmux, signals[SIGNAL_SINK_ADDED], 0, sink);
+
+  name = g_strdup_printf ("%smuxer_%u", prefix, id);
+  muxer = create_element (splitmux, splitmux->muxer_factory, name, TRUE);
+  g_free (name);
+  if (muxer == NULL) {
+    gst_bin_remove (GST_BIN (splitmux), sink);
+    return FALSE;
+  }
+
+  if (g_object_class_find_property (G_OBJECT_GET_CLASS (sink),
+          "async") != NULL) {
+    /* async child elements are causing state change races and weird
+     * failures, so let's try and turn that off */
+    g_object_set (sink, "async", FALSE, NULL);
+  }
+  if (splitmux->muxer_preset && GST_IS_PRESET (muxer))
+    gst_preset_load_preset (GST_PRESET (muxer), splitmux->muxer_preset);
+  if (splitmux->muxer_properties)
+    gst_structure_foreach (splitmux->muxer_properties,
+        _set_property_from_structure, muxer);
+  g_signal_emit (splitmux, signals[SIGNAL_MUXER_ADDED], 0, muxer);
+
+  gst_element_link (muxer, sink);
+
+  *muxer_out = muxer;
+  *sink_out = sink;
+  return TRUE;
+}
+
+static void
+fragment_elements_free (FragmentElements * elements, GstSplitMuxSink * splitmux)
+{
+  gst_bin_remove (GST_BIN (splitmux), elements->muxer);
+  gst_bin_remove (GST_BIN (splitmux), elements->sink);
+  g_free (elements);
+}
+
+/* Runs from a background thread to top up the pool of muxer and sink
+ * pairs, so that start_next_fragment() doesn't have to create them */
+static void
+fill_fragment_pool (GstSplitMuxSink * splitmux, gpointer user_data)
+{
+  GST_SPLITMUX_LOCK (splitmux);
+  while (splitmux->output_state != SPLITMUX_OUTPUT_STATE_STOPPED &&
+      g_queue_get_length (&splitmux->fragment_pool) <
+      splitmux->fragment_pool_size) {
+    FragmentElements *elements = g_new0 (FragmentElements, 1);
+    guint id = splitmux->fragment_pool_id++;
+    gboolean created;
+
+    GST_SPLITMUX_UNLOCK (splitmux);
+    created = create_fragment_elements (splitmux, "pool_", id,
+        &elements->muxer, &elements->sink);
+    GST_SPLITMUX_LOCK (splitmux);
+
+    if (!created) {
+      GST_WARNING_OBJECT (splitmux, "Could not prepare muxer/sink pair");
+      g_free (elements);
+      break;
+    }
+
+    if (splitmux->output_state == SPLITMUX_OUTPUT_STATE_STOPPED) {
+      /* Shut down while we were creating them */
+      GST_SPLITMUX_UNLOCK (splitmux);
+      fragment_elements_free (elements, splitmux);
+      GST_SPLITMUX_LOCK (splitmux);
+      break;
+    }
+
+    GST_DEBUG_OBJECT (splitmux, "Prepared muxer %" GST_PTR_FORMAT
+        " and sink %" GST_PTR_FORMAT, elements->muxer, elements->sink);
+    g_queue_push_tail (&splitmux->fragment_pool, elements);
+  }
+  splitmux->fragment_pool_filling = FALSE;
+  GST_SPLITMUX_UNLOCK (splitmux);
+}
+
+/* Called with lock held */
+static void
+schedule_fragment_pool_fill (GstSplitMuxSink * splitmux)
+{
+  if (!splitmux->async_finalize || splitmux->fragment_pool_filling ||
+      g_queue_get_length (&splitmux->fragment_pool) >=
+      splitmux->fragment_pool_size)
+    return;
+
+  splitmux->fragment_pool_filling = TRUE;
+  gst_element_call_async (GST_ELEMENT_CAST (splitmux),
+      (GstElementCallAsyncFunc) fill_fragment_pool, NULL, NULL);
+}
+
 /* Called with lock held when a fragment
  * reaches EOS and it is time to restart
  * a new fragment
@@ -2028,51 +2182,28 @@ start_next_fragment (GstSplitMuxSink * splitmux, MqStreamCtx * ctx)
   if (splitmux->async_finalize) {
     if (splitmux->muxed_out_bytes > 0
         || splitmux->fragment_id != splitmux->start_index) {
-      gchar *newname;
+      FragmentElements *elements;
       GstElement *new_sink, *new_muxer;
 
       GST_DEBUG_OBJECT (splitmux, "Starting fragment %u",
           splitmux->fragment_id);
       g_list_foreach (splitmux->contexts, (GFunc) block_context, splitmux);
-      newname = g_strdup_printf ("sink_%u", splitmux->fragment_id);
       GST_SPLITMUX_LOCK (splitmux);
-      if ((splitmux->sink =
-              create_element (splitmux, splitmux->sink_factory, newname,
-                  TRUE)) == NULL)
+      elements = g_queue_pop_head (&splitmux->fragment_pool);
+      if (elements) {
+        GST_DEBUG_OBJECT (splitmux, "Using prepared muxer %" GST_PTR_FORMAT,
+            elements->muxer);
+        new_muxer = elements->muxer;
+        new_sink = elements->sink;
+        g_free (elements);
+      } else if (!create_fragment_elements (splitmux, "",
+              splitmux->fragment_id, &new_muxer, &new_sink)) {
         goto fail;
-      if (splitmux->sink_preset && GST_IS_PRESET (splitmux->sink))
-        gst_preset_load_preset (GST_PRESET (splitmux->sink),
-            splitmux->sink_preset);
-      if (splitmux->sink_properties)
-        gst_structure_foreach (splitmux->sink_properties,
-            _set_property_from_structure, splitmux->sink);
-      splitmux->active_sink = splitmux->sink;
-      g_signal_emit (splitmux, signals[SIGNAL_SINK_ADDED], 0, splitmux->sink);
-      g_free (newname);
-      newname = g_strdup_printf ("muxer_%u", splitmux->fragment_id);
-      if ((splitmux->muxer =
-              create_element (splitmux, splitmux->muxer_factory, newname,
-                  TRUE)) == NULL)
-        goto fail;
-      if (g_object_class_find_property (G_OBJECT_GET_CLASS (splitmux->sink),
-              "async") != NULL) {
-        /* async child elements are causing state change races and weird
-         * failures, so let's try and turn that off */
-        g_object_set (splitmux->sink, "async", FALSE, NULL);
       }
-      if (splitmux->muxer_preset && GST_IS_PRESET (splitmux->muxer))
-        gst_preset_load_preset (GST_PRESET (splitmux->muxer),
-            splitmux->muxer_preset);
-      if (splitmux->muxer_properties)
-        gst_structure_foreach (splitmux->muxer_properties,
-            _set_property_from_structure, splitmux->muxer);
-      g_signal_emit (splitmux, signals[SIGNAL_MUXER_ADDED], 0, splitmux->muxer);
-      g_free (newname);
-      new_sink = splitmux->sink;
-      new_muxer = splitmux->muxer;
+      splitmux->sink = splitmux->active_sink = new_sink;
+      splitmux->muxer = new_muxer;
       GST_SPLITMUX_UNLOCK (splitmux);
       g_list_foreach (splitmux->contexts, (GFunc) relink_context, splitmux);
-      gst_element_link (new_muxer, new_sink);
 
       if (g_object_get_qdata ((GObject *) sink, EOS_FROM_US)) {
         if (GPOINTER_TO_INT (g_object_get_qdata ((GObject *) sink,
@@ -2153,6 +2284,7 @@ start_next_fragment (GstSplitMuxSink * splitmux, MqStreamCtx * ctx)
   GST_SPLITMUX_STATE_UNLOCK (splitmux);
   splitmux->switching_fragment = FALSE;
   do_async_done (splitmux);
+  schedule_fragment_pool_fill (splitmux);
 
   splitmux->ready_for_output = TRUE;
 
@@ -3981,7 +4113,9 @@ gst_splitmux_sink_change_state (GstElement * element, GstStateChange transition)
       g_atomic_int_set (&(splitmux->split_requested), FALSE);
       g_atomic_int_set (&(splitmux->do_split_next_gop), FALSE);
       /* Fall through */
-    case GST_STATE_CHANGE_READY_TO_NULL:
+    case GST_STATE_CHANGE_READY_TO_NULL:{
+      GQueue pool = G_QUEUE_INIT;
+
       GST_SPLITMUX_STATE_LOCK (splitmux);
       splitmux->shutdown = TRUE;
       GST_SPLITMUX_STATE_UNLOCK (splitmux);
@@ -3995,8 +4129,15 @@ gst_splitmux_sink_change_state (GstElement * element, GstStateChange transition)
           "State change -> NULL or READY. Waking threads");
       GST_SPLITMUX_BROADCAST_INPUT (splitmux);
       GST_SPLITMUX_BROADCAST_OUTPUT (splitmux);
+      pool = splitmux->fragment_pool;
+      g_queue_init (&splitmux->fragment_pool);
       GST_SPLITMUX_UNLOCK (splitmux);
+
+      /* Drop the unused prepared muxer/sink pairs */
+      g_queue_foreach (&pool, (GFunc) fragment_elements_free, splitmux);
+      g_queue_clear (&pool);
       break;
+    }
     default:
       break;
   }
@@ -4018,6 +4159,7 @@ gst_splitmux_sink_change_state (GstElement * element, GstStateChange transition)
        * sink */
       GST_SPLITMUX_LOCK (splitmux);
       do_async_start (splitmux);
+      schedule_fragment_pool_fill (splitmux);
       GST_SPLITMUX_UNLOCK (splitmux);
       ret = GST_STATE_CHANGE_ASYNC;
       break;
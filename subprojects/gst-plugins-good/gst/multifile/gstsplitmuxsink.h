@@ -220,6 +220,11 @@ struct _GstSplitMuxSink
   gchar *sink_factory;
   gchar *sink_preset;
   GstStructure *sink_properties;
+  /* Muxer and sink pairs created ahead of time for async finalize */
+  guint fragment_pool_size;
+  GQueue fragment_pool;
+  guint fragment_pool_id;
+  gboolean fragment_pool_filling;
 
   GstStructure *muxerpad_map;
 };
@@ -236,6 +236,7 @@ gst_rtp_h264_depay_reset (GstRtpH264Depay * rtph264depay, gboolean hard)
   rtph264depay->last_keyframe = FALSE;
   rtph264depay->last_ts = 0;
   rtph264depay->current_fu_type = 0;
+  rtph264depay->fu_n_memory = 0;
   rtph264depay->new_codec_data = FALSE;
   g_ptr_array_set_size (rtph264depay->sps, 0);
   g_ptr_array_set_size (rtph264depay->pps, 0);
@@ -894,6 +895,40 @@ gst_rtp_h264_depay_allocate_output_buffer (GstRtpH264Depay * depay, gsize size)
   return buffer;
 }
 
+/* Output the NALs of the AU without copying them, unless downstream asked for
+ * memory from its own allocator or there are too many memories to fit in one
+ * buffer without merging them anyway. */
+static GstBuffer *
+gst_rtp_h264_depay_wrap_au (GstRtpH264Depay * rtph264depay, GstBufferList * list)
+{
+  GstBuffer *outbuf;
+  guint b, n_bufs, n_mem = 0;
+
+  if (rtph264depay->allocator != NULL)
+    return NULL;
+
+  n_bufs = gst_buffer_list_length (list);
+  for (b = 0; b < n_bufs; ++b)
+    n_mem += gst_buffer_n_memory (gst_buffer_list_get (list, b));
+
+  if (n_mem > gst_buffer_get_max_memory ())
+    return NULL;
+
+  outbuf = gst_buffer_new ();
+  for (b = 0; b < n_bufs; ++b) {
+    GstBuffer *buf = gst_buffer_list_get (list, b);
+    guint m;
+
+    for (m = 0; m < gst_buffer_n_memory (buf); ++m)
+      gst_buffer_append_memory (outbuf,
+          gst_memory_ref (gst_buffer_peek_memory (buf, m)));
+
+    gst_rtp_copy_video_meta (rtph264depay, outbuf, buf);
+  }
+
+  return outbuf;
+}
+
 static GstBuffer *
 gst_rtp_h264_complete_au (GstRtpH264Depay * rtph264depay,
     GstClockTime * out_timestamp, gboolean * out_keyframe)
@@ -908,15 +943,21 @@ gst_rtp_h264_complete_au (GstRtpH264Depay * rtph264depay,
   GST_DEBUG_OBJECT (rtph264depay, "taking completed AU");
   outsize = gst_adapter_available (rtph264depay->picture_adapter);
 
-  outbuf = gst_rtp_h264_depay_allocate_output_buffer (rtph264depay, outsize);
+  list = gst_adapter_take_buffer_list (rtph264depay->picture_adapter, outsize);
 
-  if (outbuf == NULL)
-    return NULL;
+  outbuf = gst_rtp_h264_depay_wrap_au (rtph264depay, list);
+  if (outbuf != NULL) {
+    gst_buffer_list_unref (list);
+    goto done;
+  }
 
-  if (!gst_buffer_map (outbuf, &outmap, GST_MAP_WRITE))
-    return NULL;
+  outbuf = gst_rtp_h264_depay_allocate_output_buffer (rtph264depay, outsize);
 
-  list = gst_adapter_take_buffer_list (rtph264depay->picture_adapter, outsize);
+  if (outbuf == NULL || !gst_buffer_map (outbuf, &outmap, GST_MAP_WRITE)) {
+    gst_clear_buffer (&outbuf);
+    gst_buffer_list_unref (list);
+    return NULL;
+  }
 
   n_bufs = gst_buffer_list_length (list);
   for (b = 0; b < n_bufs; ++b) {
@@ -942,6 +983,7 @@ gst_rtp_h264_complete_au (GstRtpH264Depay * rtph264depay,
   gst_buffer_list_unref (list);
   gst_buffer_unmap (outbuf, &outmap);
 
+done:
   *out_timestamp = rtph264depay->last_ts;
   *out_keyframe = rtph264depay->last_keyframe;
 
@@ -990,16 +1032,17 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
 {
   GstRTPBaseDepayload *depayload = GST_RTP_BASE_DEPAYLOAD (rtph264depay);
   gint nal_type;
-  GstMapInfo map;
+  guint8 header[6] = { 0, };
   GstBuffer *outbuf = NULL;
   GstClockTime out_timestamp;
   gboolean keyframe, out_keyframe;
 
-  gst_buffer_map (nal, &map, GST_MAP_READ);
-  if (G_UNLIKELY (map.size < 5))
+  /* only look at the prefix and the first bytes of the NAL, mapping would
+   * merge NALs made of several memories */
+  if (G_UNLIKELY (gst_buffer_extract (nal, 0, header, sizeof (header)) < 5))
     goto short_nal;
 
-  nal_type = map.data[4] & 0x1f;
+  nal_type = header[4] & 0x1f;
   GST_DEBUG_OBJECT (rtph264depay, "handle NAL type %d", nal_type);
 
   keyframe = NAL_TYPE_IS_KEY (nal_type);
@@ -1012,7 +1055,6 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
       gst_rtp_h264_depay_add_sps_pps (rtph264depay,
           gst_buffer_copy_region (nal, GST_BUFFER_COPY_ALL,
               4, gst_buffer_get_size (nal) - 4));
-      gst_buffer_unmap (nal, &map);
       gst_buffer_unref (nal);
       return;
     } else if (rtph264depay->sps->len == 0 || rtph264depay->pps->len == 0) {
@@ -1023,7 +1065,6 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
           gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
               gst_structure_new ("GstForceKeyUnit",
                   "all-headers", G_TYPE_BOOLEAN, TRUE, NULL)));
-      gst_buffer_unmap (nal, &map);
       gst_buffer_unref (nal);
       return;
     }
@@ -1049,7 +1090,7 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
     if (nal_type == 1 || nal_type == 2 || nal_type == 5) {
       /* we have a picture start */
       start = TRUE;
-      if (map.data[5] & 0x80) {
+      if (header[5] & 0x80) {
         /* first_mb_in_slice == 0 completes a picture */
         complete = TRUE;
       }
@@ -1067,7 +1108,6 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
             &out_keyframe);
     }
     /* add to adapter */
-    gst_buffer_unmap (nal, &map);
 
     if (!rtph264depay->picture_start && start && out_keyframe)
       rtph264depay->waiting_for_keyframe = FALSE;
@@ -1085,7 +1125,6 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
     /* no merge, output is input nal */
     GST_DEBUG_OBJECT (depayload, "using NAL as output");
     outbuf = nal;
-    gst_buffer_unmap (nal, &map);
   }
 
   if (outbuf) {
@@ -1106,7 +1145,6 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
 short_nal:
   {
     GST_WARNING_OBJECT (depayload, "dropping short NAL");
-    gst_buffer_unmap (nal, &map);
     gst_buffer_unref (nal);
     return;
   }
@@ -1116,27 +1154,31 @@ static void
 gst_rtp_h264_finish_fragmentation_unit (GstRtpH264Depay * rtph264depay)
 {
   guint outsize;
-  GstMapInfo map;
+  guint8 prefix[4];
   GstBuffer *outbuf;
 
+  /* the fragments reference the RTP packets, keep them as separate memories
+   * and only write the prefix into the header we allocated */
   outsize = gst_adapter_available (rtph264depay->adapter);
-  outbuf = gst_adapter_take_buffer (rtph264depay->adapter, outsize);
+  if (rtph264depay->fu_n_memory <= gst_buffer_get_max_memory ()) {
+    outbuf = gst_adapter_take_buffer_fast (rtph264depay->adapter, outsize);
+  } else {
+    /* too many fragments to keep each in its own memory, adding them to one
+     * buffer would merge memories again and again, so copy them once */
+    outbuf = gst_adapter_take_buffer (rtph264depay->adapter, outsize);
+  }
 
-  gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
   GST_DEBUG_OBJECT (rtph264depay, "output %d bytes", outsize);
 
   if (rtph264depay->byte_stream) {
-    memcpy (map.data, sync_bytes, sizeof (sync_bytes));
+    memcpy (prefix, sync_bytes, sizeof (sync_bytes));
   } else {
-    outsize -= 4;
-    map.data[0] = (outsize >> 24);
-    map.data[1] = (outsize >> 16);
-    map.data[2] = (outsize >> 8);
-    map.data[3] = (outsize);
+    GST_WRITE_UINT32_BE (prefix, outsize - 4);
   }
-  gst_buffer_unmap (outbuf, &map);
+  gst_buffer_fill (outbuf, 0, prefix, sizeof (prefix));
 
   rtph264depay->current_fu_type = 0;
+  rtph264depay->fu_n_memory = 0;
 
   gst_rtp_h264_depay_handle_nal (rtph264depay, outbuf,
       rtph264depay->fu_timestamp, rtph264depay->fu_marker);
@@ -1159,6 +1201,7 @@ gst_rtp_h264_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
     gst_adapter_clear (rtph264depay->adapter);
     rtph264depay->wait_start = TRUE;
     rtph264depay->current_fu_type = 0;
+    rtph264depay->fu_n_memory = 0;
     rtph264depay->last_fu_seqnum = 0;
 
     if (rtph264depay->merge && rtph264depay->wait_for_keyframe) {
@@ -1319,7 +1362,7 @@ gst_rtp_h264_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
 
         if (S) {
           /* NAL unit starts here */
-          guint8 nal_header;
+          guint8 header[sizeof (sync_bytes) + 1];
 
           /* If a new FU unit started, while still processing an older one.
            * Assume that the remote payloader is buggy (doesn't set the end
@@ -1328,33 +1371,33 @@ gst_rtp_h264_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
             gst_rtp_h264_finish_fragmentation_unit (rtph264depay);
 
           rtph264depay->current_fu_type = nal_unit_type;
+          rtph264depay->fu_n_memory = 0;
           rtph264depay->fu_timestamp = timestamp;
           rtph264depay->last_fu_seqnum = gst_rtp_buffer_get_seq (rtp);
 
           rtph264depay->wait_start = FALSE;
 
-          /* reconstruct NAL header */
-          nal_header = (payload[0] & 0xe0) | (payload[1] & 0x1f);
-
-          /* strip type header, keep FU header, we'll reuse it to reconstruct
-           * the NAL header. */
-          payload += 1;
-          payload_len -= 1;
+          /* reconstruct NAL header, the sync bytes are fixed up when the
+           * fragmentation unit is finished */
+          memcpy (header, sync_bytes, sizeof (sync_bytes));
+          header[sizeof (sync_bytes)] =
+              (payload[0] & 0xe0) | (payload[1] & 0x1f);
 
-          nalu_size = payload_len;
-          outsize = nalu_size + sizeof (sync_bytes);
-          outbuf = gst_buffer_new_and_alloc (outsize);
+          /* strip off FU indicator and FU header bytes, the fragment data
+           * references the RTP packet memory */
+          payload += 2;
+          payload_len -= 2;
 
-          gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
-          memcpy (map.data + sizeof (sync_bytes), payload, nalu_size);
-          map.data[sizeof (sync_bytes)] = nal_header;
-          gst_buffer_unmap (outbuf, &map);
+          outsize = payload_len + sizeof (header);
+          outbuf = gst_rtp_utils_new_payload_slice (rtp, header,
+              sizeof (header), payload, payload_len);
 
           gst_rtp_copy_video_meta (rtph264depay, outbuf, rtp->buffer);
 
           GST_DEBUG_OBJECT (rtph264depay, "queueing %d bytes", outsize);
 
           /* and assemble in the adapter */
+          rtph264depay->fu_n_memory += gst_buffer_n_memory (outbuf);
           gst_adapter_push (rtph264depay->adapter, outbuf);
         } else {
           if (rtph264depay->current_fu_type == 0) {
@@ -1381,14 +1424,15 @@ gst_rtp_h264_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
           payload_len -= 2;
 
           outsize = payload_len;
-          outbuf = gst_buffer_new_and_alloc (outsize);
-          gst_buffer_fill (outbuf, 0, payload, outsize);
+          outbuf = gst_rtp_utils_new_payload_slice (rtp, NULL, 0, payload,
+              payload_len);
 
           gst_rtp_copy_video_meta (rtph264depay, outbuf, rtp->buffer);
 
           GST_DEBUG_OBJECT (rtph264depay, "queueing %d bytes", outsize);
 
           /* and assemble in the adapter */
+          rtph264depay->fu_n_memory += gst_buffer_n_memory (outbuf);
           gst_adapter_push (rtph264depay->adapter, outbuf);
         }
 
@@ -177,6 +177,7 @@ gst_rtp_h265_depay_reset (GstRtpH265Depay * rtph265depay, gboolean hard)
   rtph265depay->last_keyframe = FALSE;
   rtph265depay->last_ts = 0;
   rtph265depay->current_fu_type = 0;
+  rtph265depay->fu_n_memory = 0;
   rtph265depay->new_codec_data = FALSE;
   g_ptr_array_set_size (rtph265depay->vps, 0);
   g_ptr_array_set_size (rtph265depay->sps, 0);
@@ -965,6 +966,40 @@ gst_rtp_h265_depay_allocate_output_buffer (GstRtpH265Depay * depay, gsize size)
   return buffer;
 }
 
+/* Output the NALs of the AU without copying them, unless downstream asked for
+ * memory from its own allocator or there are too many memories to fit in one
+ * buffer without merging them anyway. */
+static GstBuffer *
+gst_rtp_h265_depay_wrap_au (GstRtpH265Depay * rtph265depay, GstBufferList * list)
+{
+  GstBuffer *outbuf;
+  guint b, n_bufs, n_mem = 0;
+
+  if (rtph265depay->allocator != NULL)
+    return NULL;
+
+  n_bufs = gst_buffer_list_length (list);
+  for (b = 0; b < n_bufs; ++b)
+    n_mem += gst_buffer_n_memory (gst_buffer_list_get (list, b));
+
+  if (n_mem > gst_buffer_get_max_memory ())
+    return NULL;
+
+  outbuf = gst_buffer_new ();
+  for (b = 0; b < n_bufs; ++b) {
+    GstBuffer *buf = gst_buffer_list_get (list, b);
+    guint m;
+
+    for (m = 0; m < gst_buffer_n_memory (buf); ++m)
+      gst_buffer_append_memory (outbuf,
+          gst_memory_ref (gst_buffer_peek_memory (buf, m)));
+
+    gst_rtp_copy_video_meta (rtph265depay, outbuf, buf);
+  }
+
+  return outbuf;
+}
+
 static GstBuffer *
 gst_rtp_h265_complete_au (GstRtpH265Depay * rtph265depay,
     GstClockTime * out_timestamp, gboolean * out_keyframe)
@@ -979,15 +1014,21 @@ gst_rtp_h265_complete_au (GstRtpH265Depay * rtph265depay,
   GST_DEBUG_OBJECT (rtph265depay, "taking completed AU");
   outsize = gst_adapter_available (rtph265depay->picture_adapter);
 
-  outbuf = gst_rtp_h265_depay_allocate_output_buffer (rtph265depay, outsize);
+  list = gst_adapter_take_buffer_list (rtph265depay->picture_adapter, outsize);
 
-  if (outbuf == NULL)
-    return NULL;
+  outbuf = gst_rtp_h265_depay_wrap_au (rtph265depay, list);
+  if (outbuf != NULL) {
+    gst_buffer_list_unref (list);
+    goto done;
+  }
 
-  if (!gst_buffer_map (outbuf, &outmap, GST_MAP_WRITE))
-    return NULL;
+  outbuf = gst_rtp_h265_depay_allocate_output_buffer (rtph265depay, outsize);
 
-  list = gst_adapter_take_buffer_list (rtph265depay->picture_adapter, outsize);
+  if (outbuf == NULL || !gst_buffer_map (outbuf, &outmap, GST_MAP_WRITE)) {
+    gst_clear_buffer (&outbuf);
+    gst_buffer_list_unref (list);
+    return NULL;
+  }
 
   n_bufs = gst_buffer_list_length (list);
   for (b = 0; b < n_bufs; ++b) {
@@ -1013,6 +1054,7 @@ gst_rtp_h265_complete_au (GstRtpH265Depay * rtph265depay,
   gst_buffer_list_unref (list);
   gst_buffer_unmap (outbuf, &outmap);
 
+done:
   *out_timestamp = rtph265depay->last_ts;
   *out_keyframe = rtph265depay->last_keyframe;
 
@@ -1089,16 +1131,17 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
 {
   GstRTPBaseDepayload *depayload = GST_RTP_BASE_DEPAYLOAD (rtph265depay);
   gint nal_type;
-  GstMapInfo map;
+  guint8 header[7] = { 0, };
   GstBuffer *outbuf = NULL;
   GstClockTime out_timestamp;
   gboolean keyframe, out_keyframe;
 
-  gst_buffer_map (nal, &map, GST_MAP_READ);
-  if (G_UNLIKELY (map.size < 5))
+  /* only look at the prefix and the first bytes of the NAL, mapping would
+   * merge NALs made of several memories */
+  if (G_UNLIKELY (gst_buffer_extract (nal, 0, header, sizeof (header)) < 5))
     goto short_nal;
 
-  nal_type = (map.data[4] >> 1) & 0x3f;
+  nal_type = (header[4] >> 1) & 0x3f;
   GST_DEBUG_OBJECT (rtph265depay, "handle NAL type %d (RTP marker bit %d)",
       nal_type, marker);
 
@@ -1112,7 +1155,6 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
       gst_rtp_h265_depay_add_vps_sps_pps (rtph265depay,
           gst_buffer_copy_region (nal, GST_BUFFER_COPY_ALL,
               4, gst_buffer_get_size (nal) - 4));
-      gst_buffer_unmap (nal, &map);
       gst_buffer_unref (nal);
       return;
     } else if (rtph265depay->sps->len == 0 || rtph265depay->pps->len == 0) {
@@ -1123,7 +1165,6 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
           gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
               gst_structure_new ("GstForceKeyUnit",
                   "all-headers", G_TYPE_BOOLEAN, TRUE, NULL)));
-      gst_buffer_unmap (nal, &map);
       gst_buffer_unref (nal);
       return;
     }
@@ -1142,7 +1183,7 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
       if (NAL_TYPE_IS_CODED_SLICE_SEGMENT (nal_type)) {
         /* A NAL unit (X) ends an access unit if the next-occurring VCL NAL unit (Y) has the high-order bit of the first byte after its NAL unit header equal to 1 */
         start = TRUE;
-        if (((map.data[6] >> 7) & 0x01) == 1) {
+        if (((header[6] >> 7) & 0x01) == 1) {
           complete = TRUE;
         }
       } else if ((nal_type >= 32 && nal_type <= 35)
@@ -1158,7 +1199,6 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
             &out_keyframe);
     }
     /* add to adapter */
-    gst_buffer_unmap (nal, &map);
 
     GST_DEBUG_OBJECT (depayload, "adding NAL to picture adapter");
     gst_adapter_push (rtph265depay->picture_adapter, nal);
@@ -1173,7 +1213,6 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
     /* no merge, output is input nal */
     GST_DEBUG_OBJECT (depayload, "using NAL as output");
     outbuf = nal;
-    gst_buffer_unmap (nal, &map);
   }
 
   if (outbuf) {
@@ -1187,7 +1226,6 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
 short_nal:
   {
     GST_WARNING_OBJECT (depayload, "dropping short NAL");
-    gst_buffer_unmap (nal, &map);
     gst_buffer_unref (nal);
     return;
   }
@@ -1197,25 +1235,33 @@ static void
 gst_rtp_h265_finish_fragmentation_unit (GstRtpH265Depay * rtph265depay)
 {
   guint outsize;
-  GstMapInfo map;
+  guint8 prefix[4];
   GstBuffer *outbuf;
 
   outsize = gst_adapter_available (rtph265depay->adapter);
   g_assert (outsize >= 4);
 
-  outbuf = gst_adapter_take_buffer (rtph265depay->adapter, outsize);
+  /* the fragments reference the RTP packets, keep them as separate memories
+   * and only write the prefix into the header we allocated */
+  if (rtph265depay->fu_n_memory <= gst_buffer_get_max_memory ()) {
+    outbuf = gst_adapter_take_buffer_fast (rtph265depay->adapter, outsize);
+  } else {
+    /* too many fragments to keep each in its own memory, adding them to one
+     * buffer would merge memories again and again, so copy them once */
+    outbuf = gst_adapter_take_buffer (rtph265depay->adapter, outsize);
+  }
 
-  gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
   GST_DEBUG_OBJECT (rtph265depay, "output %d bytes", outsize);
 
   if (rtph265depay->byte_stream) {
-    memcpy (map.data, sync_bytes, sizeof (sync_bytes));
+    memcpy (prefix, sync_bytes, sizeof (sync_bytes));
   } else {
-    GST_WRITE_UINT32_BE (map.data, outsize - 4);
+    GST_WRITE_UINT32_BE (prefix, outsize - 4);
   }
-  gst_buffer_unmap (outbuf, &map);
+  gst_buffer_fill (outbuf, 0, prefix, sizeof (prefix));
 
   rtph265depay->current_fu_type = 0;
+  rtph265depay->fu_n_memory = 0;
 
   gst_rtp_h265_depay_handle_nal (rtph265depay, outbuf,
       rtph265depay->fu_timestamp, rtph265depay->fu_marker);
@@ -1235,6 +1281,7 @@ gst_rtp_h265_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
     gst_adapter_clear (rtph265depay->adapter);
     rtph265depay->wait_start = TRUE;
     rtph265depay->current_fu_type = 0;
+    rtph265depay->fu_n_memory = 0;
     rtph265depay->last_fu_seqnum = 0;
   }
 
@@ -1422,6 +1469,7 @@ gst_rtp_h265_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
 #endif
 
         if (S) {
+          guint8 header[sizeof (sync_bytes) + 2];
 
           GST_DEBUG_OBJECT (rtph265depay, "Start of Fragmentation Unit");
 
@@ -1432,6 +1480,7 @@ gst_rtp_h265_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
             gst_rtp_h265_finish_fragmentation_unit (rtph265depay);
 
           rtph265depay->current_fu_type = nal_unit_type;
+          rtph265depay->fu_n_memory = 0;
           rtph265depay->fu_timestamp = timestamp;
           rtph265depay->last_fu_seqnum = gst_rtp_buffer_get_seq (rtp);
 
@@ -1442,33 +1491,26 @@ gst_rtp_h265_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
               ((payload[0] & 0x3f) << 9) | (nuh_layer_id << 3) |
               nuh_temporal_id_plus1;
 
-          /* go back one byte so we can copy the payload + two bytes more in the front which
-           * will be overwritten by the nal_header
-           */
-          payload -= 1;
-          payload_len += 1;
+          /* the prefix is fixed up in finish_fragmentation_unit() */
+          memcpy (header, sync_bytes, sizeof (sync_bytes));
+          header[4] = nal_header >> 8;
+          header[5] = nal_header & 0xff;
 
-          nalu_size = payload_len;
-          outsize = nalu_size + sizeof (sync_bytes);
-          outbuf = gst_buffer_new_and_alloc (outsize);
+          /* strip off FU header byte, the fragment data references the RTP
+           * packet memory */
+          payload += 1;
+          payload_len -= 1;
 
-          gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
-          if (rtph265depay->byte_stream) {
-            GST_WRITE_UINT32_BE (map.data, 0x00000001);
-          } else {
-            /* will be fixed up in finish_fragmentation_unit() */
-            GST_WRITE_UINT32_BE (map.data, 0xffffffff);
-          }
-          memcpy (map.data + sizeof (sync_bytes), payload, nalu_size);
-          map.data[4] = nal_header >> 8;
-          map.data[5] = nal_header & 0xff;
-          gst_buffer_unmap (outbuf, &map);
+          outsize = payload_len + sizeof (header);
+          outbuf = gst_rtp_utils_new_payload_slice (rtp, header,
+              sizeof (header), payload, payload_len);
 
           gst_rtp_copy_video_meta (rtph265depay, outbuf, rtp->buffer);
 
           GST_DEBUG_OBJECT (rtph265depay, "queueing %d bytes", outsize);
 
           /* and assemble in the adapter */
+          rtph265depay->fu_n_memory += gst_buffer_n_memory (outbuf);
           gst_adapter_push (rtph265depay->adapter, outbuf);
         } else {
           if (rtph265depay->current_fu_type == 0) {
@@ -1498,14 +1540,15 @@ gst_rtp_h265_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
           payload_len -= 1;
 
           outsize = payload_len;
-          outbuf = gst_buffer_new_and_alloc (outsize);
-          gst_buffer_fill (outbuf, 0, payload, outsize);
+          outbuf = gst_rtp_utils_new_payload_slice (rtp, NULL, 0, payload,
+              payload_len);
 
           gst_rtp_copy_video_meta (rtph265depay, outbuf, rtp->buffer);
 
           GST_DEBUG_OBJECT (rtph265depay, "queueing %d bytes", outsize);
 
           /* and assemble in the adapter */
+          rtph265depay->fu_n_memory += gst_buffer_n_memory (outbuf);
           gst_adapter_push (rtph265depay->adapter, outbuf);
         }
 
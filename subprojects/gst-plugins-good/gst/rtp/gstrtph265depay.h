@@ -73,6 +73,7 @@ struct _GstRtpH265Depay
 
   /* Work around broken payloaders wrt. Fragmentation Units */
   guint8 current_fu_type;
+  guint fu_n_memory;            /* memories queued in the adapter */
   guint16 last_fu_seqnum;
   GstClockTime fu_timestamp;
   gboolean fu_marker;
@@ -127,6 +127,39 @@ gst_rtp_drop_non_video_meta (gpointer element, GstBuffer * buf)
   gst_rtp_drop_meta (element, buf, rtp_quark_meta_tag_video);
 }
 
+/* Returns a buffer with a copy of @header followed by @size bytes of the
+ * payload of @rtp starting at @data. The payload bytes are not copied, the
+ * buffer references the memory of the RTP packet. */
+GstBuffer *
+gst_rtp_utils_new_payload_slice (GstRTPBuffer * rtp, const guint8 * header,
+    guint header_len, const guint8 * data, guint size)
+{
+  guint8 *payload = gst_rtp_buffer_get_payload (rtp);
+  GstBuffer *outbuf;
+  guint offset;
+
+  g_return_val_if_fail (data >= payload, NULL);
+
+  offset = data - payload;
+  g_return_val_if_fail (offset + size <= gst_rtp_buffer_get_payload_len (rtp),
+      NULL);
+
+  if (header_len > 0)
+    outbuf = gst_buffer_new_memdup (header, header_len);
+  else
+    outbuf = gst_buffer_new ();
+
+  if (size > 0) {
+    GstBuffer *slice;
+
+    slice = gst_buffer_copy_region (rtp->buffer, GST_BUFFER_COPY_MEMORY,
+        gst_rtp_buffer_get_header_len (rtp) + offset, size);
+    outbuf = gst_buffer_append (outbuf, slice);
+  }
+
+  return outbuf;
+}
+
 /* Stolen from bad/gst/mpegtsdemux/payloader_parsers.c */
 /* variable length Exp-Golomb parsing according to H.265 spec section 9.2*/
 gboolean
@@ -22,6 +22,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstbitreader.h>
+#include <gst/rtp/gstrtpbuffer.h>
 
 G_BEGIN_DECLS
 
@@ -43,6 +44,9 @@ void gst_rtp_drop_non_audio_meta (gpointer element, GstBuffer * buf);
 G_GNUC_INTERNAL
 void gst_rtp_drop_non_video_meta (gpointer element, GstBuffer * buf);
 
+G_GNUC_INTERNAL
+GstBuffer * gst_rtp_utils_new_payload_slice (GstRTPBuffer * rtp, const guint8 * header, guint header_len, const guint8 * data, guint size);
+
 G_GNUC_INTERNAL
 gboolean gst_rtp_read_golomb (GstBitReader * br, guint32 * value);
 
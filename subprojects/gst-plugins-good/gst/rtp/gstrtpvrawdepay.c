@@ -181,6 +181,38 @@ gst_rtp_vraw_depay_negotiate_pool (GstRtpVRawDepay * depay, GstCaps * caps,
   return GST_FLOW_OK;
 }
 
+/* UYVP has the layout of the RTP payload and only needs a copy, only output
+ * v210 when downstream can't handle UYVP */
+static GstVideoFormat
+gst_rtp_vraw_depay_get_422_10_format (GstRTPBaseDepayload * depayload)
+{
+  GstVideoFormat format = GST_VIDEO_FORMAT_UYVP;
+  GstCaps *filter, *peercaps;
+
+  filter =
+      gst_caps_from_string ("video/x-raw, format = (string) { UYVP, v210 }");
+  peercaps =
+      gst_pad_peer_query_caps (GST_RTP_BASE_DEPAYLOAD_SRCPAD (depayload),
+      filter);
+  gst_caps_unref (filter);
+
+  if (!gst_caps_is_empty (peercaps)) {
+    const gchar *str;
+
+    peercaps = gst_caps_fixate (peercaps);
+    str = gst_structure_get_string (gst_caps_get_structure (peercaps, 0),
+        "format");
+    if (g_strcmp0 (str, "v210") == 0)
+      format = GST_VIDEO_FORMAT_v210;
+  }
+  gst_caps_unref (peercaps);
+
+  GST_DEBUG_OBJECT (depayload, "using %s for 10-bit 4:2:2",
+      gst_video_format_to_string (format));
+
+  return format;
+}
+
 static gboolean
 gst_rtp_vraw_depay_setcaps (GstRTPBaseDepayload * depayload, GstCaps * caps)
 {
@@ -243,7 +275,7 @@ gst_rtp_vraw_depay_setcaps (GstRTPBaseDepayload * depayload, GstCaps * caps)
       format = GST_VIDEO_FORMAT_UYVY;
       pgroup = 4;
     } else if (depth == 10) {
-      format = GST_VIDEO_FORMAT_UYVP;
+      format = gst_rtp_vraw_depay_get_422_10_format (depayload);
       pgroup = 5;
     } else
       goto unknown_format;
@@ -323,6 +355,66 @@ no_bufferpool:
   }
 }
 
+static inline const guint8 *
+read_pgroup_10 (const guint8 * src, guint32 * c)
+{
+  c[0] = (src[0] << 2) | (src[1] >> 6);
+  c[1] = ((src[1] & 0x3f) << 4) | (src[2] >> 4);
+  c[2] = ((src[2] & 0x0f) << 6) | (src[3] >> 2);
+  c[3] = ((src[3] & 0x03) << 8) | src[4];
+
+  return src + 5;
+}
+
+static inline void
+set_v210_component (guint8 * line, guint c, guint32 val)
+{
+  guint8 *p = line + (c / 3) * 4;
+  guint shift = 10 * (c % 3);
+  guint32 w = GST_READ_UINT32_LE (p);
+
+  w = (w & ~(0x3ff << shift)) | (val << shift);
+  GST_WRITE_UINT32_LE (p, w);
+}
+
+/* Unpack @pairs 4:2:2 10-bit pgroups into a v210 line starting at pixel @x.
+ * Three pgroups fill a whole 16-byte v210 block which is written at once,
+ * only the unaligned head and tail need read-modify-write. */
+static void
+unpack_v210_pgroups (guint8 * line, const guint8 * src, guint x, guint pairs)
+{
+  guint c = x * 2;
+  guint32 v[12];
+  guint i;
+
+  while (pairs > 0 && c % 12 != 0) {
+    src = read_pgroup_10 (src, v);
+    for (i = 0; i < 4; i++)
+      set_v210_component (line, c + i, v[i]);
+    c += 4;
+    pairs--;
+  }
+
+  for (; pairs >= 3; pairs -= 3, c += 12) {
+    guint8 *d = line + (c / 3) * 4;
+
+    src = read_pgroup_10 (src, v);
+    src = read_pgroup_10 (src, v + 4);
+    src = read_pgroup_10 (src, v + 8);
+
+    GST_WRITE_UINT32_LE (d, v[0] | (v[1] << 10) | (v[2] << 20));
+    GST_WRITE_UINT32_LE (d + 4, v[3] | (v[4] << 10) | (v[5] << 20));
+    GST_WRITE_UINT32_LE (d + 8, v[6] | (v[7] << 10) | (v[8] << 20));
+    GST_WRITE_UINT32_LE (d + 12, v[9] | (v[10] << 10) | (v[11] << 20));
+  }
+
+  for (; pairs > 0; pairs--, c += 4) {
+    src = read_pgroup_10 (src, v);
+    for (i = 0; i < 4; i++)
+      set_v210_component (line, c + i, v[i]);
+  }
+}
+
 static GstBuffer *
 gst_rtp_vraw_depay_process_packet (GstRTPBaseDepayload * depayload,
     GstRTPBuffer * rtp)
@@ -484,6 +576,11 @@ gst_rtp_vraw_depay_process_packet (GstRTPBaseDepayload * depayload,
 
         memcpy (datap, payload, plen);
         break;
+      case GST_VIDEO_FORMAT_v210:
+        datap = p0 + (line * ystride);
+
+        unpack_v210_pgroups (datap, payload, offs, plen / pgroup);
+        break;
       case GST_VIDEO_FORMAT_AYUV:
       {
         gint i;
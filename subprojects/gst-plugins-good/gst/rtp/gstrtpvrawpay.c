@@ -45,7 +45,8 @@ static GstStaticPadTemplate gst_rtp_vraw_pay_sink_template =
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS ("video/x-raw, "
-        "format = (string) { RGB, RGBA, BGR, BGRA, AYUV, UYVY, I420, Y41B, UYVP }, "
+        "format = (string) { RGB, RGBA, BGR, BGRA, AYUV, UYVY, I420, Y41B, UYVP, "
+        "v210 }, "
         "width = (int) [ 1, 32767 ], " "height = (int) [ 1, 32767 ]; ")
     );
 
@@ -206,6 +207,7 @@ gst_rtp_vraw_pay_setcaps (GstRTPBasePayload * payload, GstCaps * caps)
       xinc = yinc = 2;
       break;
     case GST_VIDEO_FORMAT_UYVP:
+    case GST_VIDEO_FORMAT_v210:
       samplingstr = "YCbCr-4:2:2";
       pgroup = 5;
       xinc = 2;
@@ -261,6 +263,67 @@ unknown_format:
   }
 }
 
+/* Write the 4 10-bit components of a 4:2:2 pgroup as 5 big-endian bytes */
+static inline guint8 *
+write_pgroup_10 (guint8 * dest, guint32 c0, guint32 c1, guint32 c2, guint32 c3)
+{
+  dest[0] = c0 >> 2;
+  dest[1] = ((c0 & 0x03) << 6) | (c1 >> 4);
+  dest[2] = ((c1 & 0x0f) << 4) | (c2 >> 6);
+  dest[3] = ((c2 & 0x3f) << 2) | (c3 >> 8);
+  dest[4] = c3 & 0xff;
+
+  return dest + 5;
+}
+
+static inline guint32
+v210_component (const guint8 * line, guint c)
+{
+  return (GST_READ_UINT32_LE (line + (c / 3) * 4) >> (10 * (c % 3))) & 0x3ff;
+}
+
+/* Pack @pairs pixel pairs of a v210 line starting at pixel @x into 4:2:2
+ * 10-bit pgroups. v210 stores the components in the same Cb Y Cr Y order,
+ * three per 32-bit word, so whole 6-pixel blocks are repacked at once and
+ * only the unaligned head and tail go component by component. */
+static void
+pack_v210_pgroups (guint8 * dest, const guint8 * line, guint x, guint pairs)
+{
+  guint c = x * 2;
+
+  /* head until the next 6-pixel block */
+  while (pairs > 0 && c % 12 != 0) {
+    dest = write_pgroup_10 (dest, v210_component (line, c),
+        v210_component (line, c + 1), v210_component (line, c + 2),
+        v210_component (line, c + 3));
+    c += 4;
+    pairs--;
+  }
+
+  /* 16 bytes of v210 are 3 pgroups */
+  for (; pairs >= 3; pairs -= 3, c += 12) {
+    const guint8 *s = line + (c / 3) * 4;
+    guint32 w0 = GST_READ_UINT32_LE (s);
+    guint32 w1 = GST_READ_UINT32_LE (s + 4);
+    guint32 w2 = GST_READ_UINT32_LE (s + 8);
+    guint32 w3 = GST_READ_UINT32_LE (s + 12);
+
+    dest = write_pgroup_10 (dest, w0 & 0x3ff, (w0 >> 10) & 0x3ff,
+        (w0 >> 20) & 0x3ff, w1 & 0x3ff);
+    dest = write_pgroup_10 (dest, (w1 >> 10) & 0x3ff, (w1 >> 20) & 0x3ff,
+        w2 & 0x3ff, (w2 >> 10) & 0x3ff);
+    dest = write_pgroup_10 (dest, (w2 >> 20) & 0x3ff, w3 & 0x3ff,
+        (w3 >> 10) & 0x3ff, (w3 >> 20) & 0x3ff);
+  }
+
+  /* tail */
+  for (; pairs > 0; pairs--, c += 4) {
+    dest = write_pgroup_10 (dest, v210_component (line, c),
+        v210_component (line, c + 1), v210_component (line, c + 2),
+        v210_component (line, c + 3));
+  }
+}
+
 static GstFlowReturn
 gst_rtp_vraw_pay_handle_buffer (GstRTPBasePayload * payload, GstBuffer * buffer)
 {
@@ -495,6 +558,10 @@ gst_rtp_vraw_pay_handle_buffer (GstRTPBasePayload * payload, GstBuffer * buffer)
             memcpy (outdata, p0 + (lin * ystride) + (offs * pgroup), length);
             outdata += length;
             break;
+          case GST_VIDEO_FORMAT_v210:
+            pack_v210_pgroups (outdata, p0 + (lin * ystride), offs, pixels);
+            outdata += length;
+            break;
           case GST_VIDEO_FORMAT_AYUV:
           {
             gint i;
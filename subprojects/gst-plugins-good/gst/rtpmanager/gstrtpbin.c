@@ -347,6 +347,7 @@ enum
 #define DEFAULT_RTP_PROFILE          GST_RTP_PROFILE_AVP
 #define DEFAULT_NTP_TIME_SOURCE      GST_RTP_NTP_TIME_SOURCE_NTP
 #define DEFAULT_RTCP_SYNC_SEND_TIME  TRUE
+#define DEFAULT_RTCP_SHARED_SCHEDULER FALSE
 #define DEFAULT_MAX_RTCP_RTP_TIME_DIFF 1000
 #define DEFAULT_MAX_DROPOUT_TIME     60000
 #define DEFAULT_MAX_MISORDER_TIME    2000
@@ -389,6 +390,7 @@ enum
   PROP_TS_OFFSET_SMOOTHING_FACTOR,
   PROP_FEC_DECODERS,
   PROP_FEC_ENCODERS,
+  PROP_RTCP_SHARED_SCHEDULER,
 };
 
 #define GST_RTP_BIN_RTCP_SYNC_TYPE (gst_rtp_bin_rtcp_sync_get_type())
@@ -768,7 +770,7 @@ create_session (GstRtpBin * rtpbin, gint id)
   g_object_set (demux, "max-streams", rtpbin->max_streams, NULL);
   g_object_set (session, "sdes", rtpbin->sdes, "rtp-profile",
       rtpbin->rtp_profile, "rtcp-sync-send-time", rtpbin->rtcp_sync_send_time,
-      NULL);
+      "rtcp-shared-scheduler", rtpbin->rtcp_shared_scheduler, NULL);
   if (rtpbin->use_pipeline_clock)
     g_object_set (session, "use-pipeline-clock", rtpbin->use_pipeline_clock,
         NULL);
@@ -2980,6 +2982,23 @@ gst_rtp_bin_class_init (GstRtpBinClass * klass)
           "fec-encoders='fec,0=\"rtpst2022-1-fecenc\\ rows\\=5\\ columns\\=5\";'",
           GST_TYPE_STRUCTURE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRtpBin:rtcp-shared-scheduler:
+   *
+   * Handle the RTCP timeouts of the sessions with a scheduler shared by all
+   * sessions of the process instead of one RTCP thread per session. See
+   * #GstRtpSession:rtcp-shared-scheduler.
+   *
+   * Changes only apply to sessions the next time they start.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_RTCP_SHARED_SCHEDULER,
+      g_param_spec_boolean ("rtcp-shared-scheduler", "RTCP Shared Scheduler",
+          "Use a process-wide scheduler and worker pool for RTCP instead of "
+          "a thread per session", DEFAULT_RTCP_SHARED_SCHEDULER,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state = GST_DEBUG_FUNCPTR (gst_rtp_bin_change_state);
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_rtp_bin_request_new_pad);
@@ -3058,6 +3077,7 @@ gst_rtp_bin_init (GstRtpBin * rtpbin)
   rtpbin->rtp_profile = DEFAULT_RTP_PROFILE;
   rtpbin->ntp_time_source = DEFAULT_NTP_TIME_SOURCE;
   rtpbin->rtcp_sync_send_time = DEFAULT_RTCP_SYNC_SEND_TIME;
+  rtpbin->rtcp_shared_scheduler = DEFAULT_RTCP_SHARED_SCHEDULER;
   rtpbin->max_rtcp_rtp_time_diff = DEFAULT_MAX_RTCP_RTP_TIME_DIFF;
   rtpbin->max_dropout_time = DEFAULT_MAX_DROPOUT_TIME;
   rtpbin->max_misorder_time = DEFAULT_MAX_MISORDER_TIME;
@@ -3409,6 +3429,20 @@ gst_rtp_bin_set_property (GObject * object, guint prop_id,
     case PROP_FEC_ENCODERS:
       gst_rtp_bin_set_fec_encoders_struct (rtpbin, g_value_get_boxed (value));
       break;
+    case PROP_RTCP_SHARED_SCHEDULER:{
+      GSList *sessions;
+      GST_RTP_BIN_LOCK (rtpbin);
+      rtpbin->rtcp_shared_scheduler = g_value_get_boolean (value);
+      for (sessions = rtpbin->sessions; sessions;
+          sessions = g_slist_next (sessions)) {
+        GstRtpBinSession *session = (GstRtpBinSession *) sessions->data;
+
+        g_object_set (G_OBJECT (session->session),
+            "rtcp-shared-scheduler", rtpbin->rtcp_shared_scheduler, NULL);
+      }
+      GST_RTP_BIN_UNLOCK (rtpbin);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3518,6 +3552,9 @@ gst_rtp_bin_get_property (GObject * object, guint prop_id,
     case PROP_FEC_ENCODERS:
       g_value_take_boxed (value, gst_rtp_bin_get_fec_encoders_struct (rtpbin));
       break;
+    case PROP_RTCP_SHARED_SCHEDULER:
+      g_value_set_boolean (value, rtpbin->rtcp_shared_scheduler);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -138,7 +138,7 @@ static GstStateChangeReturn gst_rtp_pt_demux_change_state (GstElement * element,
     GstStateChange transition);
 static void gst_rtp_pt_demux_clear_pt_map (GstRtpPtDemux * rtpdemux);
 
-static GstPad *find_pad_for_pt (GstRtpPtDemux * rtpdemux, guint8 pt);
+static GstPad *find_pad_for_pt (GstRtpPtDemux * rtpdemux, guint16 pt);
 
 static gboolean gst_rtp_pt_demux_src_event (GstPad * pad, GstObject * parent,
     GstEvent * event);
@@ -378,17 +378,11 @@ gst_rtp_pt_demux_clear_pt_map (GstRtpPtDemux * rtpdemux)
 static gboolean
 need_caps_for_pt (GstRtpPtDemux * rtpdemux, guint8 pt)
 {
-  GSList *walk;
   gboolean ret = FALSE;
 
   GST_OBJECT_LOCK (rtpdemux);
-  for (walk = rtpdemux->srcpads; walk; walk = g_slist_next (walk)) {
-    GstRtpPtDemuxPad *pad = walk->data;
-
-    if (pad->pt == pt) {
-      ret = pad->newcaps;
-    }
-  }
+  if (rtpdemux->pt_pads[pt])
+    ret = rtpdemux->pt_pads[pt]->newcaps;
   GST_OBJECT_UNLOCK (rtpdemux);
 
   return ret;
@@ -398,17 +392,9 @@ need_caps_for_pt (GstRtpPtDemux * rtpdemux, guint8 pt)
 static void
 clear_newcaps_for_pt (GstRtpPtDemux * rtpdemux, guint8 pt)
 {
-  GSList *walk;
-
   GST_OBJECT_LOCK (rtpdemux);
-  for (walk = rtpdemux->srcpads; walk; walk = g_slist_next (walk)) {
-    GstRtpPtDemuxPad *pad = walk->data;
-
-    if (pad->pt == pt) {
-      pad->newcaps = FALSE;
-      break;
-    }
-  }
+  if (rtpdemux->pt_pads[pt])
+    rtpdemux->pt_pads[pt]->newcaps = FALSE;
   GST_OBJECT_UNLOCK (rtpdemux);
 }
 
@@ -500,6 +486,7 @@ gst_rtp_pt_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
     gst_object_ref (srcpad);
     GST_OBJECT_LOCK (rtpdemux);
     rtpdemux->srcpads = g_slist_append (rtpdemux->srcpads, rtpdemuxpad);
+    rtpdemux->pt_pads[pt] = rtpdemuxpad;
     GST_OBJECT_UNLOCK (rtpdemux);
 
     gst_pad_set_active (srcpad, TRUE);
@@ -581,20 +568,17 @@ no_caps:
 }
 
 static GstPad *
-find_pad_for_pt (GstRtpPtDemux * rtpdemux, guint8 pt)
+find_pad_for_pt (GstRtpPtDemux * rtpdemux, guint16 pt)
 {
   GstPad *respad = NULL;
-  GSList *walk;
 
-  GST_OBJECT_LOCK (rtpdemux);
-  for (walk = rtpdemux->srcpads; walk; walk = g_slist_next (walk)) {
-    GstRtpPtDemuxPad *pad = walk->data;
+  /* last_pt is 0xFFFF when nothing was received yet */
+  if (pt >= G_N_ELEMENTS (rtpdemux->pt_pads))
+    return NULL;
 
-    if (pad->pt == pt) {
-      respad = gst_object_ref (pad->pad);
-      break;
-    }
-  }
+  GST_OBJECT_LOCK (rtpdemux);
+  if (rtpdemux->pt_pads[pt])
+    respad = gst_object_ref (rtpdemux->pt_pads[pt]->pad);
   GST_OBJECT_UNLOCK (rtpdemux);
 
   return respad;
@@ -696,6 +680,7 @@ static gboolean
 gst_rtp_pt_demux_setup (GstRtpPtDemux * ptdemux)
 {
   ptdemux->srcpads = NULL;
+  memset (ptdemux->pt_pads, 0, sizeof (ptdemux->pt_pads));
   ptdemux->last_pt = 0xFFFF;
 
   return TRUE;
@@ -713,6 +698,7 @@ gst_rtp_pt_demux_release (GstRtpPtDemux * ptdemux)
   GST_OBJECT_LOCK (ptdemux);
   tmppads = ptdemux->srcpads;
   ptdemux->srcpads = NULL;
+  memset (ptdemux->pt_pads, 0, sizeof (ptdemux->pt_pads));
   GST_OBJECT_UNLOCK (ptdemux);
 
   for (walk = tmppads; walk; walk = g_slist_next (walk)) {
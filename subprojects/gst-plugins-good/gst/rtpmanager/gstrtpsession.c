@@ -223,6 +223,7 @@ enum
 #define DEFAULT_RTP_PROFILE          GST_RTP_PROFILE_AVP
 #define DEFAULT_NTP_TIME_SOURCE      GST_RTP_NTP_TIME_SOURCE_NTP
 #define DEFAULT_RTCP_SYNC_SEND_TIME  TRUE
+#define DEFAULT_RTCP_SHARED_SCHEDULER FALSE
 
 enum
 {
@@ -244,7 +245,8 @@ enum
   PROP_TWCC_STATS,
   PROP_RTP_PROFILE,
   PROP_NTP_TIME_SOURCE,
-  PROP_RTCP_SYNC_SEND_TIME
+  PROP_RTCP_SYNC_SEND_TIME,
+  PROP_RTCP_SHARED_SCHEDULER
 };
 
 #define GST_RTP_SESSION_LOCK(sess)   g_mutex_lock (&(sess)->priv->lock)
@@ -268,6 +270,13 @@ struct _GstRtpSessionPrivate
   gboolean thread_stopped;
   gboolean wait_send;
 
+  /* property, and whether the running RTCP timeouts are handled by the
+   * shared scheduler instead of the thread */
+  gboolean rtcp_shared_scheduler;
+  gboolean shared_scheduler;
+  /* a timeout is queued on, or running in the shared pool */
+  gboolean rtcp_pending;
+
   /* caps mapping */
   GHashTable *ptmap;
 
@@ -810,6 +819,25 @@ gst_rtp_session_class_init (GstRtpSessionClass * klass)
           DEFAULT_RTCP_SYNC_SEND_TIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRtpSession:rtcp-shared-scheduler:
+   *
+   * Handle the RTCP timeouts of this session with a scheduler shared by all
+   * sessions of the process, instead of a dedicated RTCP thread.  The
+   * timeouts of all sessions are waited for on the system clock and the
+   * RTCP packets are generated from a small pool of worker threads.
+   *
+   * This is useful when running many sessions in the same process.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_RTCP_SHARED_SCHEDULER,
+      g_param_spec_boolean ("rtcp-shared-scheduler", "RTCP Shared Scheduler",
+          "Use a process-wide scheduler and worker pool for RTCP instead of "
+          "a thread per session", DEFAULT_RTCP_SHARED_SCHEDULER,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_rtp_session_change_state);
   gstelement_class->request_new_pad =
@@ -865,6 +893,7 @@ gst_rtp_session_init (GstRtpSession * rtpsession)
   rtpsession->priv->session = rtp_session_new ();
   rtpsession->priv->use_pipeline_clock = DEFAULT_USE_PIPELINE_CLOCK;
   rtpsession->priv->rtcp_sync_send_time = DEFAULT_RTCP_SYNC_SEND_TIME;
+  rtpsession->priv->rtcp_shared_scheduler = DEFAULT_RTCP_SHARED_SCHEDULER;
 
   /* configure callbacks */
   rtp_session_set_callbacks (rtpsession->priv->session, &callbacks, rtpsession);
@@ -982,6 +1011,11 @@ gst_rtp_session_set_property (GObject * object, guint prop_id,
     case PROP_RTCP_SYNC_SEND_TIME:
       priv->rtcp_sync_send_time = g_value_get_boolean (value);
       break;
+    case PROP_RTCP_SHARED_SCHEDULER:
+      GST_RTP_SESSION_LOCK (rtpsession);
+      priv->rtcp_shared_scheduler = g_value_get_boolean (value);
+      GST_RTP_SESSION_UNLOCK (rtpsession);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1061,6 +1095,11 @@ gst_rtp_session_get_property (GObject * object, guint prop_id,
     case PROP_RTCP_SYNC_SEND_TIME:
       g_value_set_boolean (value, priv->rtcp_sync_send_time);
       break;
+    case PROP_RTCP_SHARED_SCHEDULER:
+      GST_RTP_SESSION_LOCK (rtpsession);
+      g_value_set_boolean (value, priv->rtcp_shared_scheduler);
+      GST_RTP_SESSION_UNLOCK (rtpsession);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1140,6 +1179,142 @@ get_current_times (GstRtpSession * rtpsession, GstClockTime * running_time,
     *ntpnstime = ntpns;
 }
 
+/* The shared RTCP scheduler: the timeouts of all sessions using it are waited
+ * for asynchronously on the system clock, which multiplexes them on a single
+ * thread, and are then handled by a process-wide pool of worker threads.
+ * rtp_session_next_timeout() still computes the randomized RTCP intervals. */
+static void rtcp_shared_timeout_func (GstRtpSession * rtpsession,
+    gpointer user_data);
+
+static GThreadPool *
+rtcp_shared_get_pool (void)
+{
+  static GThreadPool *pool = NULL;
+
+  if (g_once_init_enter (&pool)) {
+    GThreadPool *new_pool;
+
+    new_pool = g_thread_pool_new ((GFunc) rtcp_shared_timeout_func, NULL,
+        g_get_num_processors (), FALSE, NULL);
+    g_once_init_leave (&pool, new_pool);
+  }
+
+  return pool;
+}
+
+/* must be called with GST_RTP_SESSION_LOCK */
+static void
+rtcp_shared_dispatch_unlocked (GstRtpSession * rtpsession)
+{
+  rtpsession->priv->rtcp_pending = TRUE;
+  g_thread_pool_push (rtcp_shared_get_pool (), gst_object_ref (rtpsession),
+      NULL);
+}
+
+static void
+rtcp_shared_weak_ref_free (GWeakRef * ref)
+{
+  g_weak_ref_clear (ref);
+  g_free (ref);
+}
+
+static gboolean
+rtcp_shared_clock_cb (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  GstRtpSession *rtpsession = g_weak_ref_get ((GWeakRef *) user_data);
+
+  if (rtpsession == NULL)
+    return TRUE;
+
+  GST_RTP_SESSION_LOCK (rtpsession);
+  /* ignore timeouts that were unscheduled in the meantime */
+  if (rtpsession->priv->id == id) {
+    gst_clock_id_unref (id);
+    rtpsession->priv->id = NULL;
+    rtcp_shared_dispatch_unlocked (rtpsession);
+  }
+  GST_RTP_SESSION_UNLOCK (rtpsession);
+
+  gst_object_unref (rtpsession);
+
+  return TRUE;
+}
+
+/* must be called with GST_RTP_SESSION_LOCK */
+static void
+rtcp_shared_schedule_unlocked (GstRtpSession * rtpsession,
+    GstClockTime current_time)
+{
+  GstRtpSessionPrivate *priv = rtpsession->priv;
+  GstClockTime next_timeout;
+  GWeakRef *ref;
+
+  next_timeout = rtp_session_next_timeout (priv->session, current_time);
+
+  GST_DEBUG_OBJECT (rtpsession, "next check time %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (next_timeout));
+
+  /* no more timeouts, the session ended */
+  if (next_timeout == GST_CLOCK_TIME_NONE) {
+    priv->thread_stopped = TRUE;
+    return;
+  }
+
+  ref = g_new (GWeakRef, 1);
+  g_weak_ref_init (ref, rtpsession);
+  priv->id = gst_clock_new_single_shot_id (priv->sysclock, next_timeout);
+  gst_clock_id_wait_async (priv->id, rtcp_shared_clock_cb, ref,
+      (GDestroyNotify) rtcp_shared_weak_ref_free);
+}
+
+/* must be called with GST_RTP_SESSION_LOCK */
+static void
+rtcp_shared_start_unlocked (GstRtpSession * rtpsession)
+{
+  GstClockTime current_time;
+
+  current_time = gst_clock_get_time (rtpsession->priv->sysclock);
+
+  GST_DEBUG_OBJECT (rtpsession, "starting at %" GST_TIME_FORMAT
+      " on the shared RTCP scheduler", GST_TIME_ARGS (current_time));
+  rtpsession->priv->session->start_time = current_time;
+
+  rtcp_shared_schedule_unlocked (rtpsession, current_time);
+}
+
+static void
+rtcp_shared_timeout_func (GstRtpSession * rtpsession, gpointer user_data)
+{
+  GstRtpSessionPrivate *priv = rtpsession->priv;
+  GstClockTime current_time;
+  GstClockTime running_time;
+  guint64 ntpnstime;
+
+  GST_RTP_SESSION_LOCK (rtpsession);
+  if (!priv->stop_thread) {
+    current_time = gst_clock_get_time (priv->sysclock);
+    get_current_times (rtpsession, &running_time, &ntpnstime);
+
+    /* perform actions, we ignore result. Release lock because it might push. */
+    GST_RTP_SESSION_UNLOCK (rtpsession);
+    rtp_session_on_timeout (priv->session, current_time, ntpnstime,
+        running_time);
+    GST_RTP_SESSION_LOCK (rtpsession);
+
+    if (!priv->stop_thread)
+      rtcp_shared_schedule_unlocked (rtpsession, current_time);
+  }
+  if (priv->stop_thread)
+    priv->thread_stopped = TRUE;
+  priv->rtcp_pending = FALSE;
+  /* wake up join_rtcp_thread() */
+  g_cond_broadcast (&priv->cond);
+  GST_RTP_SESSION_UNLOCK (rtpsession);
+
+  gst_object_unref (rtpsession);
+}
+
 /* must be called with GST_RTP_SESSION_LOCK */
 static void
 signal_waiting_rtcp_thread_unlocked (GstRtpSession * rtpsession)
@@ -1148,6 +1323,10 @@ signal_waiting_rtcp_thread_unlocked (GstRtpSession * rtpsession)
     GST_LOG_OBJECT (rtpsession, "signal RTCP thread");
     rtpsession->priv->wait_send = FALSE;
     GST_RTP_SESSION_SIGNAL (rtpsession);
+
+    if (rtpsession->priv->shared_scheduler &&
+        !rtpsession->priv->thread_stopped && !rtpsession->priv->stop_thread)
+      rtcp_shared_start_unlocked (rtpsession);
   }
 }
 
@@ -1246,11 +1425,20 @@ start_rtcp_thread (GstRtpSession * rtpsession)
      * anymore. */
     if (rtpsession->priv->thread)
       g_thread_join (rtpsession->priv->thread);
-    /* only create a new thread if the old one was stopped. Otherwise we can
-     * just reuse the currently running one. */
-    rtpsession->priv->thread = g_thread_try_new ("rtpsession-rtcp",
-        (GThreadFunc) rtcp_thread, rtpsession, &error);
+    rtpsession->priv->thread = NULL;
     rtpsession->priv->thread_stopped = FALSE;
+    rtpsession->priv->shared_scheduler =
+        rtpsession->priv->rtcp_shared_scheduler;
+    if (rtpsession->priv->shared_scheduler) {
+      /* like the thread, wait for data before starting */
+      if (!rtpsession->priv->wait_send)
+        rtcp_shared_start_unlocked (rtpsession);
+    } else {
+      /* only create a new thread if the old one was stopped. Otherwise we can
+       * just reuse the currently running one. */
+      rtpsession->priv->thread = g_thread_try_new ("rtpsession-rtcp",
+          (GThreadFunc) rtcp_thread, rtpsession, &error);
+    }
   }
   GST_RTP_SESSION_UNLOCK (rtpsession);
 
@@ -1274,6 +1462,15 @@ stop_rtcp_thread (GstRtpSession * rtpsession)
   signal_waiting_rtcp_thread_unlocked (rtpsession);
   if (rtpsession->priv->id)
     gst_clock_id_unschedule (rtpsession->priv->id);
+  if (rtpsession->priv->shared_scheduler) {
+    if (rtpsession->priv->id) {
+      gst_clock_id_unref (rtpsession->priv->id);
+      rtpsession->priv->id = NULL;
+    }
+    /* a running timeout marks the session stopped when done */
+    if (!rtpsession->priv->rtcp_pending)
+      rtpsession->priv->thread_stopped = TRUE;
+  }
   GST_RTP_SESSION_UNLOCK (rtpsession);
 }
 
@@ -1293,6 +1490,9 @@ join_rtcp_thread (GstRtpSession * rtpsession)
      * is supposed to not concurrently call start and join. */
     rtpsession->priv->thread = NULL;
   }
+  /* wait for the shared scheduler to be done with this session */
+  while (rtpsession->priv->rtcp_pending)
+    GST_RTP_SESSION_WAIT (rtpsession);
   GST_RTP_SESSION_UNLOCK (rtpsession);
 }
 
@@ -1725,8 +1925,15 @@ gst_rtp_session_reconsider (RTPSession * sess, gpointer user_data)
 
   GST_RTP_SESSION_LOCK (rtpsession);
   GST_DEBUG_OBJECT (rtpsession, "unlock timer for reconsideration");
-  if (rtpsession->priv->id)
+  if (rtpsession->priv->id) {
     gst_clock_id_unschedule (rtpsession->priv->id);
+    if (rtpsession->priv->shared_scheduler) {
+      /* the thread would handle the timeout now, do the same */
+      gst_clock_id_unref (rtpsession->priv->id);
+      rtpsession->priv->id = NULL;
+      rtcp_shared_dispatch_unlocked (rtpsession);
+    }
+  }
   GST_RTP_SESSION_UNLOCK (rtpsession);
 }
 
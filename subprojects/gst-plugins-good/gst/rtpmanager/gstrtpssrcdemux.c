@@ -126,6 +126,8 @@ static void gst_rtp_ssrc_demux_clear_ssrc (GstRtpSsrcDemux * demux,
     guint32 ssrc);
 
 /* sinkpad stuff */
+static GstFlowReturn gst_rtp_ssrc_demux_chain_list (GstPad * pad,
+    GstObject * parent, GstBufferList * list);
 static GstFlowReturn gst_rtp_ssrc_demux_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buf);
 static gboolean gst_rtp_ssrc_demux_sink_event (GstPad * pad, GstObject * parent,
@@ -163,15 +165,7 @@ typedef struct
 static GstRtpSsrcDemuxPads *
 find_demux_pads_for_ssrc (GstRtpSsrcDemux * demux, guint32 ssrc)
 {
-  GSList *walk;
-
-  for (walk = demux->srcpads; walk; walk = g_slist_next (walk)) {
-    GstRtpSsrcDemuxPads *pad = (GstRtpSsrcDemuxPads *) walk->data;
-
-    if (pad->ssrc == ssrc)
-      return pad;
-  }
-  return NULL;
+  return g_hash_table_lookup (demux->ssrc_pads, GUINT_TO_POINTER (ssrc));
 }
 
 /* returns a reference to the pad if found, %NULL otherwise */
@@ -286,8 +280,14 @@ find_or_create_demux_pad_for_ssrc (GstRtpSsrcDemux * demux, guint32 ssrc,
   GstPad *retpad;
   guint num_streams;
 
+  /* known SSRCs only need the object lock */
+  retpad = get_demux_pad_for_ssrc (demux, ssrc, padtype);
+  if (retpad != NULL)
+    return retpad;
+
   INTERNAL_STREAM_LOCK (demux);
 
+  /* the other streaming thread might have created it in the meantime */
   retpad = get_demux_pad_for_ssrc (demux, ssrc, padtype);
   if (retpad != NULL) {
     INTERNAL_STREAM_UNLOCK (demux);
@@ -322,6 +322,7 @@ find_or_create_demux_pad_for_ssrc (GstRtpSsrcDemux * demux, guint32 ssrc,
 
   GST_OBJECT_LOCK (demux);
   demux->srcpads = g_slist_prepend (demux->srcpads, dpads);
+  g_hash_table_insert (demux->ssrc_pads, GUINT_TO_POINTER (ssrc), dpads);
   GST_OBJECT_UNLOCK (demux);
 
   gst_pad_set_query_function (rtp_pad, gst_rtp_ssrc_demux_src_query);
@@ -480,6 +481,7 @@ gst_rtp_ssrc_demux_class_init (GstRtpSsrcDemuxClass * klass)
       "rtpssrcdemux", 0, "RTP SSRC demuxer");
 
   GST_DEBUG_REGISTER_FUNCPTR (gst_rtp_ssrc_demux_chain);
+  GST_DEBUG_REGISTER_FUNCPTR (gst_rtp_ssrc_demux_chain_list);
   GST_DEBUG_REGISTER_FUNCPTR (gst_rtp_ssrc_demux_rtcp_chain);
 }
 
@@ -492,6 +494,8 @@ gst_rtp_ssrc_demux_init (GstRtpSsrcDemux * demux)
       gst_pad_new_from_template (gst_element_class_get_pad_template (klass,
           "sink"), "sink");
   gst_pad_set_chain_function (demux->rtp_sink, gst_rtp_ssrc_demux_chain);
+  gst_pad_set_chain_list_function (demux->rtp_sink,
+      gst_rtp_ssrc_demux_chain_list);
   gst_pad_set_event_function (demux->rtp_sink, gst_rtp_ssrc_demux_sink_event);
   gst_pad_set_iterate_internal_links_function (demux->rtp_sink,
       gst_rtp_ssrc_demux_iterate_internal_links_sink);
@@ -507,6 +511,7 @@ gst_rtp_ssrc_demux_init (GstRtpSsrcDemux * demux)
   gst_element_add_pad (GST_ELEMENT_CAST (demux), demux->rtcp_sink);
 
   demux->max_streams = DEFAULT_MAX_STREAMS;
+  demux->ssrc_pads = g_hash_table_new (NULL, NULL);
 
   g_rec_mutex_init (&demux->padlock);
 }
@@ -526,6 +531,7 @@ gst_rtp_ssrc_demux_pads_free (GstRtpSsrcDemuxPads * dpads)
 static void
 gst_rtp_ssrc_demux_reset (GstRtpSsrcDemux * demux)
 {
+  g_hash_table_remove_all (demux->ssrc_pads);
   g_slist_free_full (demux->srcpads,
       (GDestroyNotify) gst_rtp_ssrc_demux_pads_free);
   demux->srcpads = NULL;
@@ -549,6 +555,7 @@ gst_rtp_ssrc_demux_finalize (GObject * object)
   GstRtpSsrcDemux *demux;
 
   demux = GST_RTP_SSRC_DEMUX (object);
+  g_hash_table_destroy (demux->ssrc_pads);
   g_rec_mutex_clear (&demux->padlock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -569,6 +576,7 @@ gst_rtp_ssrc_demux_clear_ssrc (GstRtpSsrcDemux * demux, guint32 ssrc)
   GST_DEBUG_OBJECT (demux, "clearing pad for SSRC %08x", ssrc);
 
   demux->srcpads = g_slist_remove (demux->srcpads, dpads);
+  g_hash_table_remove (demux->ssrc_pads, GUINT_TO_POINTER (ssrc));
   GST_OBJECT_UNLOCK (demux);
 
   g_signal_emit (G_OBJECT (demux),
@@ -648,42 +656,34 @@ gst_rtp_ssrc_demux_sink_event (GstPad * pad, GstObject * parent,
   return fdata.res;
 }
 
+/* push either @buf or @list to the pad of @ssrc, creating it if needed */
 static GstFlowReturn
-gst_rtp_ssrc_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
+gst_rtp_ssrc_demux_push (GstRtpSsrcDemux * demux, guint32 ssrc,
+    PadType padtype, GstBuffer * buf, GstBufferList * list)
 {
   GstFlowReturn ret;
-  GstRtpSsrcDemux *demux;
-  guint32 ssrc;
-  GstRTPBuffer rtp = { NULL };
   GstPad *srcpad;
 
-  demux = GST_RTP_SSRC_DEMUX (parent);
-
-  if (!gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp))
-    goto invalid_payload;
-
-  ssrc = gst_rtp_buffer_get_ssrc (&rtp);
-  gst_rtp_buffer_unmap (&rtp);
-
-  GST_DEBUG_OBJECT (demux, "received buffer of SSRC %08x", ssrc);
-
-  srcpad = find_or_create_demux_pad_for_ssrc (demux, ssrc, RTP_PAD);
+  srcpad = find_or_create_demux_pad_for_ssrc (demux, ssrc, padtype);
   if (srcpad == NULL)
     goto create_failed;
 
   if (!GST_PAD_STICKIES_SENT (srcpad)) {
-    forward_initial_events (demux, ssrc, srcpad, RTP_PAD);
+    forward_initial_events (demux, ssrc, srcpad, padtype);
     GST_PAD_SET_STICKIES_SENT (srcpad);
   }
 
   /* push to srcpad */
-  ret = gst_pad_push (srcpad, buf);
+  if (buf)
+    ret = gst_pad_push (srcpad, buf);
+  else
+    ret = gst_pad_push_list (srcpad, list);
 
   if (ret != GST_FLOW_OK) {
     GstPad *active_pad;
 
     /* check if the ssrc still there, may have been removed */
-    active_pad = get_demux_pad_for_ssrc (demux, ssrc, RTP_PAD);
+    active_pad = get_demux_pad_for_ssrc (demux, ssrc, padtype);
 
     if (active_pad == NULL || active_pad != srcpad) {
       /* SSRC was removed during the push ... ignore the error */
@@ -698,15 +698,12 @@ gst_rtp_ssrc_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   return ret;
 
   /* ERRORS */
-invalid_payload:
-  {
-    GST_DEBUG_OBJECT (demux, "Dropping invalid RTP packet");
-    gst_buffer_unref (buf);
-    return GST_FLOW_OK;
-  }
 create_failed:
   {
-    gst_buffer_unref (buf);
+    if (buf)
+      gst_buffer_unref (buf);
+    else
+      gst_buffer_list_unref (list);
     GST_WARNING_OBJECT (demux,
         "Dropping buffer SSRC %08x. "
         "Max streams number reached (%u)", ssrc, demux->max_streams);
@@ -714,16 +711,116 @@ create_failed:
   }
 }
 
+static GstFlowReturn
+gst_rtp_ssrc_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
+{
+  GstRtpSsrcDemux *demux;
+  guint32 ssrc;
+  GstRTPBuffer rtp = { NULL };
+
+  demux = GST_RTP_SSRC_DEMUX (parent);
+
+  if (!gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp))
+    goto invalid_payload;
+
+  ssrc = gst_rtp_buffer_get_ssrc (&rtp);
+  gst_rtp_buffer_unmap (&rtp);
+
+  GST_DEBUG_OBJECT (demux, "received buffer of SSRC %08x", ssrc);
+
+  return gst_rtp_ssrc_demux_push (demux, ssrc, RTP_PAD, buf, NULL);
+
+  /* ERRORS */
+invalid_payload:
+  {
+    GST_DEBUG_OBJECT (demux, "Dropping invalid RTP packet");
+    gst_buffer_unref (buf);
+    return GST_FLOW_OK;
+  }
+}
+
+typedef struct
+{
+  guint32 ssrc;
+  GstBufferList *list;
+} SsrcBufferList;
+
+/* split the list by SSRC in one pass and push one list per SSRC */
+static GstFlowReturn
+gst_rtp_ssrc_demux_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstRtpSsrcDemux *demux;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GArray *lists;
+  guint i, j, len;
+
+  demux = GST_RTP_SSRC_DEMUX (parent);
+
+  len = gst_buffer_list_length (list);
+  lists = g_array_new (FALSE, FALSE, sizeof (SsrcBufferList));
+
+  for (i = 0; i < len; i++) {
+    GstBuffer *buf = gst_buffer_list_get (list, i);
+    GstRTPBuffer rtp = { NULL };
+    SsrcBufferList *slist = NULL;
+    guint32 ssrc;
+
+    if (!gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp)) {
+      GST_DEBUG_OBJECT (demux, "Dropping invalid RTP packet");
+      continue;
+    }
+
+    ssrc = gst_rtp_buffer_get_ssrc (&rtp);
+    gst_rtp_buffer_unmap (&rtp);
+
+    /* packets of one SSRC usually come in runs, look from the end */
+    for (j = lists->len; j > 0; j--) {
+      if (g_array_index (lists, SsrcBufferList, j - 1).ssrc == ssrc) {
+        slist = &g_array_index (lists, SsrcBufferList, j - 1);
+        break;
+      }
+    }
+    if (slist == NULL) {
+      SsrcBufferList new_slist = { ssrc, gst_buffer_list_new () };
+
+      g_array_append_val (lists, new_slist);
+      slist = &g_array_index (lists, SsrcBufferList, lists->len - 1);
+    }
+
+    gst_buffer_list_add (slist->list, gst_buffer_ref (buf));
+  }
+
+  gst_buffer_list_unref (list);
+
+  GST_DEBUG_OBJECT (demux, "received list of %u buffers for %u SSRCs", len,
+      lists->len);
+
+  for (j = 0; j < lists->len; j++) {
+    SsrcBufferList *slist = &g_array_index (lists, SsrcBufferList, j);
+    GstFlowReturn push_ret;
+
+    push_ret = gst_rtp_ssrc_demux_push (demux, slist->ssrc, RTP_PAD, NULL,
+        slist->list);
+
+    /* still deliver to the other SSRCs, report the first error */
+    if (ret == GST_FLOW_OK)
+      ret = push_ret;
+  }
+
+  g_array_free (lists, TRUE);
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_rtp_ssrc_demux_rtcp_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buf)
 {
-  GstFlowReturn ret;
   GstRtpSsrcDemux *demux;
   guint32 ssrc;
   GstRTCPPacket packet;
   GstRTCPBuffer rtcp = { NULL, };
-  GstPad *srcpad;
 
   demux = GST_RTP_SSRC_DEMUX (parent);
 
@@ -762,34 +859,7 @@ gst_rtp_ssrc_demux_rtcp_chain (GstPad * pad, GstObject * parent,
 
   GST_DEBUG_OBJECT (demux, "received RTCP of SSRC %08x", ssrc);
 
-  srcpad = find_or_create_demux_pad_for_ssrc (demux, ssrc, RTCP_PAD);
-  if (srcpad == NULL)
-    goto create_failed;
-
-  if (!GST_PAD_STICKIES_SENT (srcpad)) {
-    forward_initial_events (demux, ssrc, srcpad, RTCP_PAD);
-    GST_PAD_SET_STICKIES_SENT (srcpad);
-  }
-
-  /* push to srcpad */
-  ret = gst_pad_push (srcpad, buf);
-
-  if (ret != GST_FLOW_OK) {
-    GstPad *active_pad;
-
-    /* check if the ssrc still there, may have been removed */
-    active_pad = get_demux_pad_for_ssrc (demux, ssrc, RTCP_PAD);
-    if (active_pad == NULL || active_pad != srcpad) {
-      /* SSRC was removed during the push ... ignore the error */
-      ret = GST_FLOW_OK;
-    }
-
-    g_clear_object (&active_pad);
-  }
-
-  gst_object_unref (srcpad);
-
-  return ret;
+  return gst_rtp_ssrc_demux_push (demux, ssrc, RTCP_PAD, buf, NULL);
 
   /* ERRORS */
 invalid_rtcp:
@@ -804,14 +874,6 @@ unexpected_rtcp:
     gst_buffer_unref (buf);
     return GST_FLOW_OK;
   }
-create_failed:
-  {
-    gst_buffer_unref (buf);
-    GST_WARNING_OBJECT (demux,
-        "Dropping buffer SSRC %08x. "
-        "Max streams number reached (%u)", ssrc, demux->max_streams);
-    return GST_FLOW_OK;
-  }
 }
 
 static GstRtpSsrcDemuxPads *
@@ -40,6 +40,7 @@ struct _GstRtpSsrcDemux
 
   GRecMutex padlock;
   GSList *srcpads;
+  GHashTable *ssrc_pads;        /* SSRC -> entry of srcpads */
   guint max_streams;
 };
 
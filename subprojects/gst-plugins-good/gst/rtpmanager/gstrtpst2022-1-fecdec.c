@@ -87,6 +87,7 @@
 #include <gst/rtp/gstrtpbuffer.h>
 
 #include "gstrtpst2022-1-fecdec.h"
+#include "gstrtputils.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_rtpst_2022_1_fecdec_debug);
 #define GST_CAT_DEFAULT gst_rtpst_2022_1_fecdec_debug
@@ -147,6 +148,10 @@ struct _GstRTPST_2022_1_FecDec
   GstClockTime size_time;
   GstClockTime max_arrival_time;
   GstClockTime max_fec_arrival_time[2];
+
+  /* Set while a media buffer list is being handled, recovered packets
+   * are then appended to it instead of being pushed one by one */
+  GstBufferList *pending_list;
 };
 
 #define RTP_CAPS "application/x-rtp"
@@ -370,26 +375,6 @@ done:
   return ret;
 }
 
-static void
-_xor_mem (guint8 * restrict dst, const guint8 * restrict src, gsize length)
-{
-  guint i;
-
-  for (i = 0; i < (length / sizeof (guint64)); ++i) {
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-    GST_WRITE_UINT64_LE (dst,
-        GST_READ_UINT64_LE (dst) ^ GST_READ_UINT64_LE (src));
-#else
-    GST_WRITE_UINT64_BE (dst,
-        GST_READ_UINT64_BE (dst) ^ GST_READ_UINT64_BE (src));
-#endif
-    dst += sizeof (guint64);
-    src += sizeof (guint64);
-  }
-  for (i = 0; i < (length % sizeof (guint64)); ++i)
-    dst[i] ^= src[i];
-}
-
 static GstFlowReturn
 xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec, GList * packets,
     guint16 seqnum)
@@ -442,7 +427,7 @@ xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec, GList * packets,
     Item *item = (Item *) tmp->data;
 
     gst_rtp_buffer_map (item->buffer, GST_MAP_READ, &media_rtp);
-    _xor_mem (xored, gst_rtp_buffer_get_payload (&media_rtp),
+    gst_rtp_xor_mem (xored, gst_rtp_buffer_get_payload (&media_rtp),
         MIN (gst_rtp_buffer_get_payload_len (&media_rtp), xored_payload_len));
     xored_timestamp ^= gst_rtp_buffer_get_timestamp (&media_rtp);
     xored_pt ^= gst_rtp_buffer_get_payload_type (&media_rtp);
@@ -481,7 +466,9 @@ xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec, GList * packets,
   ret = store_media_item (dec, &rtp, item);
   gst_rtp_buffer_unmap (&rtp);
 
-  if (ret == GST_FLOW_OK) {
+  if (ret == GST_FLOW_OK && dec->pending_list) {
+    gst_buffer_list_add (dec->pending_list, buffer);
+  } else if (ret == GST_FLOW_OK) {
     /* Unlocking here is safe */
     GST_OBJECT_UNLOCK (dec);
     ret = gst_pad_push (dec->srcpad, buffer);
@@ -750,6 +737,52 @@ error:
   goto done;
 }
 
+static GstFlowReturn
+gst_rtpst_2022_1_fecdec_sink_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstRTPST_2022_1_FecDec *dec = GST_RTPST_2022_1_FECDEC_CAST (parent);
+  GstBufferList *out;
+  guint i, len;
+
+  len = gst_buffer_list_length (list);
+
+  GST_OBJECT_LOCK (dec);
+  dec->pending_list = gst_buffer_list_new_sized (len);
+
+  for (i = 0; i < len; i++) {
+    GstBuffer *buffer = gst_buffer_list_get (list, i);
+    GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+
+    if (!gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp)) {
+      GST_WARNING_OBJECT (pad, "Chained buffer isn't valid RTP");
+      continue;
+    }
+
+    dec->max_arrival_time =
+        MAX (dec->max_arrival_time, GST_BUFFER_DTS_OR_PTS (buffer));
+    trim_items (dec);
+    /* Recovered packets, if any, get appended before this one */
+    store_media (dec, &rtp, buffer);
+    gst_rtp_buffer_unmap (&rtp);
+
+    gst_buffer_list_add (dec->pending_list, gst_buffer_ref (buffer));
+  }
+
+  out = dec->pending_list;
+  dec->pending_list = NULL;
+  GST_OBJECT_UNLOCK (dec);
+
+  gst_buffer_list_unref (list);
+
+  if (gst_buffer_list_length (out) == 0) {
+    gst_buffer_list_unref (out);
+    return GST_FLOW_OK;
+  }
+
+  return gst_pad_push_list (dec->srcpad, out);
+}
+
 static gboolean
 gst_rtpst_2022_1_fecdec_src_event (GstPad * pad, GstObject * parent,
     GstEvent * event)
@@ -1002,6 +1035,8 @@ gst_rtpst_2022_1_fecdec_init (GstRTPST_2022_1_FecDec * dec)
   dec->sinkpad = gst_pad_new_from_static_template (&sink_template, "sink");
   GST_PAD_SET_PROXY_CAPS (dec->sinkpad);
   gst_pad_set_chain_function (dec->sinkpad, gst_rtpst_2022_1_fecdec_sink_chain);
+  gst_pad_set_chain_list_function (dec->sinkpad,
+      gst_rtpst_2022_1_fecdec_sink_chain_list);
   gst_pad_set_event_function (dec->sinkpad,
       GST_DEBUG_FUNCPTR (gst_2d_fec_sink_event));
   gst_pad_set_iterate_internal_links_function (dec->sinkpad,
@@ -69,6 +69,7 @@
 #include <gst/rtp/gstrtpbuffer.h>
 
 #include "gstrtpst2022-1-fecenc.h"
+#include "gstrtputils.h"
 
 #if !GLIB_CHECK_VERSION(2, 60, 0)
 #define g_queue_clear_full queue_clear_full
@@ -122,6 +123,10 @@ typedef struct
 
   guint16 payload_len;
   guint n_packets;
+
+  /* Allocated size of xored_payload, kept across FEC packets so that
+   * the payload buffer is only reallocated when it needs to grow */
+  gsize payload_alloc;
 } FecPacket;
 
 struct _GstRTPST_2022_1_FecEncClass
@@ -232,24 +237,26 @@ free_fec_packet (FecPacket * packet)
   g_free (packet);
 }
 
+/* Resets @fec for the next matrix while keeping its payload storage */
 static void
-_xor_mem (guint8 * restrict dst, const guint8 * restrict src, gsize length)
+fec_packet_clear (FecPacket * fec)
 {
-  guint i;
-
-  for (i = 0; i < (length / sizeof (guint64)); ++i) {
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-    GST_WRITE_UINT64_LE (dst,
-        GST_READ_UINT64_LE (dst) ^ GST_READ_UINT64_LE (src));
-#else
-    GST_WRITE_UINT64_BE (dst,
-        GST_READ_UINT64_BE (dst) ^ GST_READ_UINT64_BE (src));
-#endif
-    dst += sizeof (guint64);
-    src += sizeof (guint64);
-  }
-  for (i = 0; i < (length % sizeof (guint64)); ++i)
-    dst[i] ^= src[i];
+  guint8 *xored_payload = fec->xored_payload;
+  gsize payload_alloc = fec->payload_alloc;
+
+  memset (fec, 0x00, sizeof (FecPacket));
+  fec->xored_payload = xored_payload;
+  fec->payload_alloc = payload_alloc;
+}
+
+static void
+fec_packet_ensure_payload (FecPacket * fec, gsize size)
+{
+  if (fec->payload_alloc >= size)
+    return;
+
+  fec->xored_payload = g_realloc (fec->xored_payload, size);
+  fec->payload_alloc = size;
 }
 
 static void
@@ -264,15 +271,14 @@ fec_packet_update (FecPacket * fec, GstRTPBuffer * rtp)
     fec->xored_marker = gst_rtp_buffer_get_marker (rtp);
     fec->xored_padding = gst_rtp_buffer_get_padding (rtp);
     fec->xored_extension = gst_rtp_buffer_get_extension (rtp);
-    fec->xored_payload = g_malloc (sizeof (guint8) * fec->payload_len);
+    fec_packet_ensure_payload (fec, fec->payload_len);
     memcpy (fec->xored_payload, gst_rtp_buffer_get_payload (rtp),
         fec->payload_len);
   } else {
     guint plen = gst_rtp_buffer_get_payload_len (rtp);
 
     if (fec->payload_len < plen) {
-      fec->xored_payload =
-          g_realloc (fec->xored_payload, sizeof (guint8) * plen);
+      fec_packet_ensure_payload (fec, plen);
       memset (fec->xored_payload + fec->payload_len, 0,
           plen - fec->payload_len);
       fec->payload_len = plen;
@@ -284,7 +290,7 @@ fec_packet_update (FecPacket * fec, GstRTPBuffer * rtp)
     fec->xored_marker ^= gst_rtp_buffer_get_marker (rtp);
     fec->xored_padding ^= gst_rtp_buffer_get_padding (rtp);
     fec->xored_extension ^= gst_rtp_buffer_get_extension (rtp);
-    _xor_mem (fec->xored_payload, gst_rtp_buffer_get_payload (rtp), plen);
+    gst_rtp_xor_mem (fec->xored_payload, gst_rtp_buffer_get_payload (rtp), plen);
   }
 
   fec->n_packets += 1;
@@ -387,12 +393,13 @@ queue_fec_packet (GstRTPST_2022_1_FecEnc * enc, FecPacket * fec, gboolean row)
   }
 }
 
-static GstFlowReturn
-gst_rtpst_2022_1_fecenc_sink_chain (GstPad * pad, GstObject * parent,
+/* Updates the FEC matrix with @buffer and pushes out any FEC packets
+ * that are due, but doesn't push @buffer itself */
+static gboolean
+gst_rtpst_2022_1_fecenc_handle_buffer (GstRTPST_2022_1_FecEnc * enc,
     GstBuffer * buffer)
 {
-  GstRTPST_2022_1_FecEnc *enc = GST_RTPST_2022_1_FECENC_CAST (parent);
-  GstFlowReturn ret = GST_FLOW_OK;
+  GstFlowReturn ret;
   GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
 
   if (!gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp)) {
@@ -432,8 +439,7 @@ gst_rtpst_2022_1_fecenc_sink_chain (GstPad * pad, GstObject * parent,
     fec_packet_update (enc->row, &rtp);
     if (enc->row->n_packets == enc->l) {
       queue_fec_packet (enc, enc->row, TRUE);
-      g_free (enc->row->xored_payload);
-      memset (enc->row, 0x00, sizeof (FecPacket));
+      fec_packet_clear (enc->row);
     }
   }
 
@@ -443,8 +449,7 @@ gst_rtpst_2022_1_fecenc_sink_chain (GstPad * pad, GstObject * parent,
     fec_packet_update (column, &rtp);
     if (column->n_packets == enc->d) {
       queue_fec_packet (enc, column, FALSE);
-      g_free (column->xored_payload);
-      memset (column, 0x00, sizeof (FecPacket));
+      fec_packet_clear (column);
     }
 
     enc->current_column++;
@@ -480,17 +485,48 @@ gst_rtpst_2022_1_fecenc_sink_chain (GstPad * pad, GstObject * parent,
   }
   GST_OBJECT_UNLOCK (enc);
 
-  ret = gst_pad_push (enc->srcpad, buffer);
-
-done:
-  return ret;
+  return TRUE;
 
 error:
   if (rtp.buffer)
     gst_rtp_buffer_unmap (&rtp);
-  gst_buffer_unref (buffer);
-  ret = GST_FLOW_ERROR;
-  goto done;
+  return FALSE;
+}
+
+static GstFlowReturn
+gst_rtpst_2022_1_fecenc_sink_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstRTPST_2022_1_FecEnc *enc = GST_RTPST_2022_1_FECENC_CAST (parent);
+
+  if (!gst_rtpst_2022_1_fecenc_handle_buffer (enc, buffer)) {
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
+
+  return gst_pad_push (enc->srcpad, buffer);
+}
+
+static GstFlowReturn
+gst_rtpst_2022_1_fecenc_sink_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstRTPST_2022_1_FecEnc *enc = GST_RTPST_2022_1_FECENC_CAST (parent);
+  guint i, len;
+
+  len = gst_buffer_list_length (list);
+
+  for (i = 0; i < len; i++) {
+    if (!gst_rtpst_2022_1_fecenc_handle_buffer (enc,
+            gst_buffer_list_get (list, i))) {
+      gst_buffer_list_unref (list);
+      return GST_FLOW_ERROR;
+    }
+  }
+
+  /* FEC packets are pushed as they become due, the media packets can all
+   * go downstream in one go */
+  return gst_pad_push_list (enc->srcpad, list);
 }
 
 static GstIterator *
@@ -639,8 +675,7 @@ gst_rtpst_2022_1_fecenc_set_property (GObject * object, guint prop_id,
         if (enc->columns) {
           for (i = 0; i < enc->l; i++) {
             FecPacket *column = g_ptr_array_index (enc->columns, i);
-            g_free (column->xored_payload);
-            memset (column, 0x00, sizeof (FecPacket));
+            fec_packet_clear (column);
           }
         }
         enc->current_column = 0;
@@ -785,6 +820,8 @@ gst_rtpst_2022_1_fecenc_init (GstRTPST_2022_1_FecEnc * enc)
   enc->sinkpad = gst_pad_new_from_static_template (&sink_template, "sink");
   GST_PAD_SET_PROXY_CAPS (enc->sinkpad);
   gst_pad_set_chain_function (enc->sinkpad, gst_rtpst_2022_1_fecenc_sink_chain);
+  gst_pad_set_chain_list_function (enc->sinkpad,
+      gst_rtpst_2022_1_fecenc_sink_chain_list);
   gst_pad_set_event_function (enc->sinkpad,
       GST_DEBUG_FUNCPTR (gst_2d_fec_sink_event));
   gst_pad_set_iterate_internal_links_function (enc->sinkpad,
@@ -19,6 +19,16 @@
 
 #include "gstrtputils.h"
 
+#include <string.h>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HAVE_SSE2_XOR 1
+#elif defined (__ARM_NEON) && defined (__aarch64__)
+#include <arm_neon.h>
+#define HAVE_NEON_XOR 1
+#endif
+
 guint8
 gst_rtp_get_extmap_id_for_attribute (const GstStructure * s,
     const gchar * ext_name)
@@ -42,3 +52,53 @@ gst_rtp_get_extmap_id_for_attribute (const GstStructure * s,
   }
   return extmap_id;
 }
+
+/* XORs @length bytes of @src into @dst, as needed to generate and apply
+ * SMPTE 2022-1 FEC. Neither pointer needs to be aligned. */
+void
+gst_rtp_xor_mem (guint8 * dst, const guint8 * src, gsize length)
+{
+  gsize i = 0;
+
+#if defined (HAVE_SSE2_XOR)
+  for (; i + 64 <= length; i += 64) {
+    __m128i d0 = _mm_loadu_si128 ((const __m128i *) (dst + i));
+    __m128i d1 = _mm_loadu_si128 ((const __m128i *) (dst + i + 16));
+    __m128i d2 = _mm_loadu_si128 ((const __m128i *) (dst + i + 32));
+    __m128i d3 = _mm_loadu_si128 ((const __m128i *) (dst + i + 48));
+
+    d0 = _mm_xor_si128 (d0, _mm_loadu_si128 ((const __m128i *) (src + i)));
+    d1 = _mm_xor_si128 (d1, _mm_loadu_si128 ((const __m128i *) (src + i + 16)));
+    d2 = _mm_xor_si128 (d2, _mm_loadu_si128 ((const __m128i *) (src + i + 32)));
+    d3 = _mm_xor_si128 (d3, _mm_loadu_si128 ((const __m128i *) (src + i + 48)));
+
+    _mm_storeu_si128 ((__m128i *) (dst + i), d0);
+    _mm_storeu_si128 ((__m128i *) (dst + i + 16), d1);
+    _mm_storeu_si128 ((__m128i *) (dst + i + 32), d2);
+    _mm_storeu_si128 ((__m128i *) (dst + i + 48), d3);
+  }
+
+  for (; i + 16 <= length; i += 16) {
+    __m128i d = _mm_loadu_si128 ((const __m128i *) (dst + i));
+
+    d = _mm_xor_si128 (d, _mm_loadu_si128 ((const __m128i *) (src + i)));
+    _mm_storeu_si128 ((__m128i *) (dst + i), d);
+  }
+#elif defined (HAVE_NEON_XOR)
+  for (; i + 16 <= length; i += 16)
+    vst1q_u8 (dst + i, veorq_u8 (vld1q_u8 (dst + i), vld1q_u8 (src + i)));
+#endif
+
+  /* The byte order doesn't matter for XOR */
+  for (; i + 8 <= length; i += 8) {
+    guint64 d, s;
+
+    memcpy (&d, dst + i, sizeof (d));
+    memcpy (&s, src + i, sizeof (s));
+    d ^= s;
+    memcpy (dst + i, &d, sizeof (d));
+  }
+
+  for (; i < length; i++)
+    dst[i] ^= src[i];
+}
@@ -29,6 +29,9 @@ G_BEGIN_DECLS
 G_GNUC_INTERNAL guint8
 gst_rtp_get_extmap_id_for_attribute (const GstStructure * s, const gchar * ext_name);
 
+G_GNUC_INTERNAL void
+gst_rtp_xor_mem (guint8 * dst, const guint8 * src, gsize length);
+
 G_END_DECLS
 
 #endif /* __GST_RTP_UTILS_H__ */
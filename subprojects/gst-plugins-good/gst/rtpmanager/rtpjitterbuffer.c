@@ -30,6 +30,10 @@ GST_DEBUG_CATEGORY_STATIC (rtp_jitter_buffer_debug);
 #define MAX_WINDOW	RTP_JITTER_BUFFER_MAX_WINDOW
 #define MAX_TIME	(2 * GST_SECOND)
 
+/* Size bounds of the seqnum index, the upper bound covers all seqnums */
+#define INDEX_MIN_SIZE	1024
+#define INDEX_MAX_SIZE	65536
+
 /* signals and args */
 enum
 {
@@ -678,6 +682,80 @@ no_skew:
   return out_time;
 }
 
+static inline RTPJitterBufferItem *
+index_lookup (RTPJitterBuffer * jbuf, guint16 seqnum)
+{
+  RTPJitterBufferItem *item;
+
+  if (G_UNLIKELY (jbuf->index == NULL))
+    return NULL;
+
+  item = jbuf->index[seqnum & jbuf->index_mask];
+  if (item && item->seqnum == seqnum)
+    return item;
+
+  return NULL;
+}
+
+/* Returns FALSE if two queued items end up in the same slot */
+static gboolean
+index_rebuild (RTPJitterBuffer * jbuf, guint size)
+{
+  GList *l;
+
+  GST_DEBUG ("resizing seqnum index to %u", size);
+
+  g_free (jbuf->index);
+  jbuf->index = g_new0 (RTPJitterBufferItem *, size);
+  jbuf->index_mask = size - 1;
+
+  for (l = jbuf->packets.head; l; l = l->next) {
+    RTPJitterBufferItem *item = (RTPJitterBufferItem *) l;
+    guint slot;
+
+    if (item->seqnum == -1)
+      continue;
+
+    slot = item->seqnum & jbuf->index_mask;
+    if (jbuf->index[slot] != NULL)
+      return FALSE;
+    jbuf->index[slot] = item;
+  }
+
+  return TRUE;
+}
+
+static void
+index_add (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item)
+{
+  guint size;
+
+  if (G_UNLIKELY (jbuf->index == NULL))
+    index_rebuild (jbuf, INDEX_MIN_SIZE);
+
+  /* grow until the seqnum span of the queued items fits. With one slot per
+   * possible seqnum there can't be any collision anymore */
+  size = jbuf->index_mask + 1;
+  while (jbuf->index[item->seqnum & jbuf->index_mask] != NULL
+      && size < INDEX_MAX_SIZE) {
+    do {
+      size *= 2;
+    } while (!index_rebuild (jbuf, size) && size < INDEX_MAX_SIZE);
+  }
+
+  jbuf->index[item->seqnum & jbuf->index_mask] = item;
+}
+
+static inline void
+index_remove (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item)
+{
+  if (item->seqnum == -1 || jbuf->index == NULL)
+    return;
+
+  if (jbuf->index[item->seqnum & jbuf->index_mask] == item)
+    jbuf->index[item->seqnum & jbuf->index_mask] = NULL;
+}
+
 static void
 queue_do_insert (RTPJitterBuffer * jbuf, GList * list, GList * item)
 {
@@ -1046,8 +1124,9 @@ static gboolean
 rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
     gboolean * head, gint * percent)
 {
-  GList *list, *event = NULL;
-  guint16 seqnum;
+  GList *list;
+  RTPJitterBufferItem *last, *next;
+  guint16 seqnum, qseq;
 
   g_return_val_if_fail (jbuf != NULL, FALSE);
   g_return_val_if_fail (item != NULL, FALSE);
@@ -1060,43 +1139,32 @@ rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
 
   seqnum = item->seqnum;
 
-  /* loop the list to skip strictly larger seqnum buffers */
-  for (; list; list = g_list_previous (list)) {
-    guint16 qseq;
-    gint gap;
-    RTPJitterBufferItem *qitem = (RTPJitterBufferItem *) list;
-
-    if (qitem->seqnum == -1) {
-      /* keep a pointer to the first consecutive event if not already
-       * set. we will insert the packet after the event if we can't find
-       * a packet with lower sequence number before the event. */
-      if (event == NULL)
-        event = list;
-      continue;
-    }
-
-    qseq = qitem->seqnum;
-
-    /* compare the new seqnum to the one in the buffer */
-    gap = gst_rtp_buffer_compare_seqnum (seqnum, qseq);
-
-    /* we hit a packet with the same seqnum, notify a duplicate */
-    if (G_UNLIKELY (gap == 0))
-      goto duplicate;
-
-    /* seqnum > qseq, we can stop looking */
-    if (G_LIKELY (gap < 0))
-      break;
-
-    /* if we've found a packet with greater sequence number, cleanup the
-     * event pointer as the packet will be inserted before the event */
-    event = NULL;
-  }
-
-  /* if event is set it means that packets before the event had smaller
-   * sequence number, so we will insert our packet after the event */
-  if (event)
-    list = event;
+  /* we already have a packet with the same seqnum, notify a duplicate */
+  if (G_UNLIKELY (index_lookup (jbuf, seqnum)))
+    goto duplicate;
+
+  /* find the last packet, skipping events at the tail */
+  for (last = (RTPJitterBufferItem *) list; last && last->seqnum == -1;
+      last = (RTPJitterBufferItem *) last->prev);
+
+  /* It's more likely that the packet goes after all queued packets, and
+   * after any event that follows them */
+  if (G_LIKELY (last == NULL
+          || gst_rtp_buffer_compare_seqnum (seqnum, last->seqnum) < 0))
+    goto insert;
+
+  /* Otherwise the packet goes right before the packet with the next higher
+   * seqnum, and so after any event preceding that one. The last packet has a
+   * higher seqnum, so this lookup terminates. */
+  qseq = seqnum;
+  do {
+    qseq++;
+    next = index_lookup (jbuf, qseq);
+  } while (next == NULL);
+  list = next->prev;
+
+insert:
+  index_add (jbuf, item);
 
 append:
   queue_do_insert (jbuf, list, (GList *) item);
@@ -1299,6 +1367,7 @@ rtp_jitter_buffer_pop (RTPJitterBuffer * jbuf, gint * percent)
     else
       queue->tail = NULL;
     queue->length--;
+    index_remove (jbuf, (RTPJitterBufferItem *) item);
   }
 
   /* buffering mode, update buffer stats */
@@ -1355,6 +1424,8 @@ rtp_jitter_buffer_flush (RTPJitterBuffer * jbuf, GFunc free_func,
 
   while ((item = g_queue_pop_head_link (&jbuf->packets)))
     free_func ((RTPJitterBufferItem *) item, user_data);
+
+  g_clear_pointer (&jbuf->index, g_free);
 }
 
 /**
@@ -74,6 +74,9 @@ struct _RTPJitterBuffer {
   GObject        object;
 
   GQueue         packets;
+  /* ring of the items in packets, indexed by seqnum */
+  RTPJitterBufferItem **index;
+  guint          index_mask;
 
   RTPJitterBufferMode mode;
 
@@ -24,12 +24,33 @@
 
 #include "rtptimerqueue.h"
 
+/* The timers are kept in a sorted list, which the jitterbuffer walks in
+ * order. To avoid walking that list when inserting or rescheduling, timer
+ * wheels of different granularity keep an anchor timer for each time slot in
+ * use. A new position is then searched from the closest anchor found in the
+ * wheels. Level 0 slots are ~1ms wide and cover ~1s, level 1 slots are ~34ms
+ * wide and cover ~34s. */
+#define RTP_TIMER_WHEEL_LEVELS 2
+#define RTP_TIMER_WHEEL_SLOTS 1024
+#define RTP_TIMER_WHEEL_BITS (GLIB_SIZEOF_LONG * 8)
+#define RTP_TIMER_WHEEL_WORDS (RTP_TIMER_WHEEL_SLOTS / RTP_TIMER_WHEEL_BITS)
+
+static const guint rtp_timer_wheel_shift[RTP_TIMER_WHEEL_LEVELS] = { 20, 25 };
+
+typedef struct
+{
+  guint shift;
+  gulong used[RTP_TIMER_WHEEL_WORDS];
+  RtpTimer *slots[RTP_TIMER_WHEEL_SLOTS];
+} RtpTimerWheel;
+
 struct _RtpTimerQueue
 {
   GObject parent;
 
   GQueue timers;
   GHashTable *hashtable;
+  RtpTimerWheel wheels[RTP_TIMER_WHEEL_LEVELS];
 };
 
 G_DEFINE_TYPE (RtpTimerQueue, rtp_timer_queue, G_TYPE_OBJECT);
@@ -68,6 +89,9 @@ rtp_timer_is_later (RtpTimer * timer, RtpTimer * next)
 
     if (timer->timeout > next->timeout)
       return TRUE;
+  } else if (GST_CLOCK_TIME_IS_VALID (timer->timeout)) {
+    /* timers without timeout are always at the head */
+    return TRUE;
   }
 
   if (timer->timeout == next->timeout &&
@@ -98,82 +122,6 @@ rtp_timer_is_sooner (RtpTimer * timer, RtpTimer * prev)
   return FALSE;
 }
 
-static inline gboolean
-rtp_timer_is_closer_to_head (RtpTimer * timer, RtpTimer * head)
-{
-  RtpTimer *prev = rtp_timer_get_prev (timer);
-  GstClockTimeDiff prev_delta = 0;
-  GstClockTimeDiff head_delta = 0;
-
-  if (prev == NULL)
-    return FALSE;
-
-  if (rtp_timer_is_sooner (timer, head))
-    return TRUE;
-
-  if (rtp_timer_is_later (timer, prev))
-    return FALSE;
-
-  if (prev->timeout == head->timeout) {
-    gint prev_gap, head_gap;
-
-    prev_gap = gst_rtp_buffer_compare_seqnum (timer->seqnum, prev->seqnum);
-    head_gap = gst_rtp_buffer_compare_seqnum (head->seqnum, timer->seqnum);
-
-    if (head_gap < prev_gap)
-      return TRUE;
-  }
-
-  if (GST_CLOCK_TIME_IS_VALID (timer->timeout) &&
-      GST_CLOCK_TIME_IS_VALID (head->timeout)) {
-    prev_delta = GST_CLOCK_DIFF (timer->timeout, prev->timeout);
-    head_delta = GST_CLOCK_DIFF (head->timeout, timer->timeout);
-
-    if (head_delta < prev_delta)
-      return TRUE;
-  }
-
-  return FALSE;
-}
-
-static inline gboolean
-rtp_timer_is_closer_to_tail (RtpTimer * timer, RtpTimer * tail)
-{
-  RtpTimer *next = rtp_timer_get_next (timer);
-  GstClockTimeDiff tail_delta = 0;
-  GstClockTimeDiff next_delta = 0;
-
-  if (next == NULL)
-    return FALSE;
-
-  if (rtp_timer_is_later (timer, tail))
-    return TRUE;
-
-  if (rtp_timer_is_sooner (timer, next))
-    return FALSE;
-
-  if (tail->timeout == next->timeout) {
-    gint tail_gap, next_gap;
-
-    tail_gap = gst_rtp_buffer_compare_seqnum (timer->seqnum, tail->seqnum);
-    next_gap = gst_rtp_buffer_compare_seqnum (next->seqnum, timer->seqnum);
-
-    if (tail_gap < next_gap)
-      return TRUE;
-  }
-
-  if (GST_CLOCK_TIME_IS_VALID (timer->timeout) &&
-      GST_CLOCK_TIME_IS_VALID (next->timeout)) {
-    tail_delta = GST_CLOCK_DIFF (timer->timeout, tail->timeout);
-    next_delta = GST_CLOCK_DIFF (next->timeout, timer->timeout);
-
-    if (tail_delta < next_delta)
-      return TRUE;
-  }
-
-  return FALSE;
-}
-
 static inline RtpTimer *
 rtp_timer_queue_get_tail (RtpTimerQueue * queue)
 {
@@ -288,10 +236,187 @@ rtp_timer_queue_insert_head (RtpTimerQueue * queue, RtpTimer * timer)
     rtp_timer_queue_insert_before (queue, it, timer);
 }
 
+static inline guint64
+rtp_timer_wheel_tick (RtpTimerWheel * wheel, RtpTimer * timer)
+{
+  return timer->wheel_timeout >> wheel->shift;
+}
+
+static void
+rtp_timer_wheel_add (RtpTimerWheel * wheel, RtpTimer * timer)
+{
+  guint64 tick = rtp_timer_wheel_tick (wheel, timer);
+  guint index = tick % RTP_TIMER_WHEEL_SLOTS;
+  RtpTimer *anchor = wheel->slots[index];
+
+  /* on collision keep the nearest slot, and the latest timer of a slot */
+  if (anchor) {
+    guint64 anchor_tick = rtp_timer_wheel_tick (wheel, anchor);
+
+    if (anchor_tick < tick)
+      return;
+    if (anchor_tick == tick && !rtp_timer_is_later (timer, anchor))
+      return;
+  }
+
+  wheel->slots[index] = timer;
+  wheel->used[index / RTP_TIMER_WHEEL_BITS] |=
+      1UL << (index % RTP_TIMER_WHEEL_BITS);
+}
+
+static inline gboolean
+rtp_timer_wheel_same_slot (RtpTimerWheel * wheel, RtpTimer * timer,
+    guint64 tick)
+{
+  return timer && GST_CLOCK_TIME_IS_VALID (timer->wheel_timeout) &&
+      rtp_timer_wheel_tick (wheel, timer) == tick;
+}
+
+static void
+rtp_timer_wheel_remove (RtpTimerWheel * wheel, RtpTimer * timer)
+{
+  guint64 tick = rtp_timer_wheel_tick (wheel, timer);
+  guint index = tick % RTP_TIMER_WHEEL_SLOTS;
+  RtpTimer *prev, *next;
+
+  if (wheel->slots[index] != timer)
+    return;
+
+  /* hand the slot over to a neighbour in the same slot, if any */
+  prev = rtp_timer_get_prev (timer);
+  next = rtp_timer_get_next (timer);
+  if (rtp_timer_wheel_same_slot (wheel, prev, tick)) {
+    wheel->slots[index] = prev;
+  } else if (rtp_timer_wheel_same_slot (wheel, next, tick)) {
+    wheel->slots[index] = next;
+  } else {
+    wheel->slots[index] = NULL;
+    wheel->used[index / RTP_TIMER_WHEEL_BITS] &=
+        ~(1UL << (index % RTP_TIMER_WHEEL_BITS));
+  }
+}
+
+/* Returns the queued timer of the closest slot before a timer expiring at
+ * @timeout, that sorts before such a timer, or %NULL */
+static RtpTimer *
+rtp_timer_wheel_find (RtpTimerWheel * wheel, GstClockTime timeout)
+{
+  guint64 tick = timeout >> wheel->shift;
+  guint index = tick % RTP_TIMER_WHEEL_SLOTS;
+  gint word = index / RTP_TIMER_WHEEL_BITS;
+  gint bit = index % RTP_TIMER_WHEEL_BITS + 1;
+  guint i;
+
+  /* the first word is visited twice, as the wheel wraps around */
+  for (i = 0; i <= RTP_TIMER_WHEEL_WORDS; i++) {
+    gulong used = wheel->used[word];
+
+    while ((bit = g_bit_nth_msf (used, bit)) != -1) {
+      RtpTimer *anchor = wheel->slots[word * RTP_TIMER_WHEEL_BITS + bit];
+      guint64 anchor_tick = rtp_timer_wheel_tick (wheel, anchor);
+
+      /* ignore anchors from other turns of the wheel, and as timeouts may be
+       * changed in place by the jitterbuffer, only trust the current timeout
+       * of the anchor */
+      if (anchor_tick <= tick && tick - anchor_tick < RTP_TIMER_WHEEL_SLOTS &&
+          GST_CLOCK_TIME_IS_VALID (anchor->timeout) &&
+          anchor->timeout <= timeout)
+        return anchor;
+    }
+
+    word = (word + RTP_TIMER_WHEEL_WORDS - 1) % RTP_TIMER_WHEEL_WORDS;
+    bit = -1;
+  }
+
+  return NULL;
+}
+
+static void
+rtp_timer_queue_index (RtpTimerQueue * queue, RtpTimer * timer)
+{
+  guint i;
+
+  timer->wheel_timeout = timer->timeout;
+  if (!GST_CLOCK_TIME_IS_VALID (timer->wheel_timeout))
+    return;
+
+  for (i = 0; i < RTP_TIMER_WHEEL_LEVELS; i++)
+    rtp_timer_wheel_add (&queue->wheels[i], timer);
+}
+
+static void
+rtp_timer_queue_unindex (RtpTimerQueue * queue, RtpTimer * timer)
+{
+  guint i;
+
+  if (!GST_CLOCK_TIME_IS_VALID (timer->wheel_timeout))
+    return;
+
+  for (i = 0; i < RTP_TIMER_WHEEL_LEVELS; i++)
+    rtp_timer_wheel_remove (&queue->wheels[i], timer);
+  timer->wheel_timeout = GST_CLOCK_TIME_NONE;
+}
+
+static void
+rtp_timer_queue_unlink (RtpTimerQueue * queue, RtpTimer * timer)
+{
+  rtp_timer_queue_unindex (queue, timer);
+  g_queue_unlink (&queue->timers, (GList *) timer);
+}
+
+/* Insert @timer at its sorted position, walking from a nearby anchor taken
+ * from the timer wheels whenever possible */
+static void
+rtp_timer_queue_insert_sorted (RtpTimerQueue * queue, RtpTimer * timer)
+{
+  RtpTimer *tail = rtp_timer_queue_get_tail (queue);
+  RtpTimer *it = NULL;
+  guint i;
+
+  if (!GST_CLOCK_TIME_IS_VALID (timer->timeout)) {
+    rtp_timer_queue_insert_head (queue, timer);
+    goto done;
+  }
+
+  /* most timers are scheduled after all the others */
+  if (tail && GST_CLOCK_TIME_IS_VALID (tail->timeout) &&
+      rtp_timer_is_later (timer, tail)) {
+    rtp_timer_queue_insert_after (queue, tail, timer);
+    goto done;
+  }
+
+  for (i = 0; i < RTP_TIMER_WHEEL_LEVELS; i++) {
+    RtpTimer *anchor = rtp_timer_wheel_find (&queue->wheels[i],
+        timer->timeout);
+
+    if (anchor && (!it || anchor->timeout > it->timeout))
+      it = anchor;
+  }
+
+  if (it == NULL) {
+    rtp_timer_queue_insert_tail (queue, timer);
+  } else if (rtp_timer_is_later (timer, it)) {
+    while (rtp_timer_is_later (timer, rtp_timer_get_next (it)))
+      it = rtp_timer_get_next (it);
+    rtp_timer_queue_insert_after (queue, it, timer);
+  } else {
+    while (rtp_timer_is_sooner (timer, rtp_timer_get_prev (it)))
+      it = rtp_timer_get_prev (it);
+    rtp_timer_queue_insert_before (queue, it, timer);
+  }
+
+done:
+  rtp_timer_queue_index (queue, timer);
+}
+
 static void
 rtp_timer_queue_init (RtpTimerQueue * queue)
 {
+  guint i;
+
   queue->hashtable = g_hash_table_new (NULL, NULL);
+  for (i = 0; i < RTP_TIMER_WHEEL_LEVELS; i++)
+    queue->wheels[i].shift = rtp_timer_wheel_shift[i];
 }
 
 static void
@@ -394,9 +519,9 @@ rtp_timer_queue_new (void)
  * @timer: (transfer full): the #RtpTimer to insert
  *
  * Insert a timer into the queue. Earliest timer are at the head and then
- * timer are sorted by seqnum (smaller seqnum first). This function is o(n)
- * but it is expected that most timers added are schedule later, in which case
- * the insertion will be faster.
+ * timer are sorted by seqnum (smaller seqnum first). The position is looked
+ * up through the timer wheels, this function is o(1) unless many timers
+ * share the same millisecond.
  *
  * Returns: %FALSE if a timer with the same seqnum already existed
  */
@@ -411,10 +536,7 @@ rtp_timer_queue_insert (RtpTimerQueue * queue, RtpTimer * timer)
     return FALSE;
   }
 
-  if (timer->timeout == -1)
-    rtp_timer_queue_insert_head (queue, timer);
-  else
-    rtp_timer_queue_insert_tail (queue, timer);
+  rtp_timer_queue_insert_sorted (queue, timer);
 
   g_hash_table_insert (queue->hashtable,
       GINT_TO_POINTER (timer->seqnum), timer);
@@ -429,49 +551,30 @@ rtp_timer_queue_insert (RtpTimerQueue * queue, RtpTimer * timer)
  * @timer: the #RtpTimer to reschedule
  *
  * This function moves @timer inside the queue to put it back to it's new
- * location. This function is o(n) but it is assumed that nearby modification
- * of the timeout will occure.
+ * location. Like rtp_timer_queue_insert(), this function is o(1) unless many
+ * timers share the same millisecond.
  *
  * Returns: %TRUE if the timer was moved
  */
 gboolean
 rtp_timer_queue_reschedule (RtpTimerQueue * queue, RtpTimer * timer)
 {
-  RtpTimer *it = timer;
-
   g_return_val_if_fail (timer->queued == TRUE, FALSE);
 
-  if (rtp_timer_is_closer_to_head (timer, rtp_timer_queue_get_head (queue))) {
-    g_queue_unlink (&queue->timers, (GList *) timer);
-    rtp_timer_queue_insert_head (queue, timer);
-    return TRUE;
-  }
-
-  while (rtp_timer_is_sooner (timer, rtp_timer_get_prev (it)))
-    it = rtp_timer_get_prev (it);
-
-  if (it != timer) {
-    g_queue_unlink (&queue->timers, (GList *) timer);
-    rtp_timer_queue_insert_before (queue, it, timer);
-    return TRUE;
+  if (!rtp_timer_is_sooner (timer, rtp_timer_get_prev (timer)) &&
+      !rtp_timer_is_later (timer, rtp_timer_get_next (timer))) {
+    /* still in order, only the slot may have changed */
+    if (timer->wheel_timeout != timer->timeout) {
+      rtp_timer_queue_unindex (queue, timer);
+      rtp_timer_queue_index (queue, timer);
+    }
+    return FALSE;
   }
 
-  if (rtp_timer_is_closer_to_tail (timer, rtp_timer_queue_get_tail (queue))) {
-    g_queue_unlink (&queue->timers, (GList *) timer);
-    rtp_timer_queue_insert_tail (queue, timer);
-    return TRUE;
-  }
+  rtp_timer_queue_unlink (queue, timer);
+  rtp_timer_queue_insert_sorted (queue, timer);
 
-  while (rtp_timer_is_later (timer, rtp_timer_get_next (it)))
-    it = rtp_timer_get_next (it);
-
-  if (it != timer) {
-    g_queue_unlink (&queue->timers, (GList *) timer);
-    rtp_timer_queue_insert_after (queue, it, timer);
-    return TRUE;
-  }
-
-  return FALSE;
+  return TRUE;
 }
 
 /**
@@ -487,7 +590,7 @@ rtp_timer_queue_unschedule (RtpTimerQueue * queue, RtpTimer * timer)
 {
   g_return_if_fail (timer->queued == TRUE);
 
-  g_queue_unlink (&queue->timers, (GList *) timer);
+  rtp_timer_queue_unlink (queue, timer);
   g_hash_table_remove (queue->hashtable, GINT_TO_POINTER (timer->seqnum));
   timer->queued = FALSE;
 }
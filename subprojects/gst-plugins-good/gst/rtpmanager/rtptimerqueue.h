@@ -68,6 +68,9 @@ typedef struct
   GstClockTime rtx_last;
   guint num_rtx_retry;
   guint num_rtx_received;
+
+  /* timeout the timer is indexed with in the timer wheels */
+  GstClockTime wheel_timeout;
 } RtpTimer;
 
 void         rtp_timer_free (RtpTimer * timer);
@@ -312,6 +312,10 @@ gst_rtsp_backchannel_get_type (void)
 #define DEFAULT_IS_LIVE TRUE
 #define DEFAULT_IGNORE_X_SERVER_REPLY FALSE
 
+/* read interleaved data in chunks of this size, the RTP and RTCP packets
+ * then reference the chunk instead of being copied */
+#define INTERLEAVED_READ_BUFFER_SIZE (64 * 1024)
+
 enum
 {
   PROP_0,
@@ -5463,6 +5467,7 @@ gst_rtspsrc_handle_data (GstRTSPSrc * src, GstRTSPMessage * message)
   GstPad *outpad = NULL;
   guint8 *data;
   guint size;
+  guint8 second_byte;
   GstBuffer *buf;
   gboolean is_rtcp;
 
@@ -5482,13 +5487,23 @@ gst_rtspsrc_handle_data (GstRTSPSrc * src, GstRTSPMessage * message)
     is_rtcp = FALSE;
   }
 
-  /* take a look at the body to figure out what we have */
-  gst_rtsp_message_get_body (message, &data, &size);
-  if (size < 2)
-    goto invalid_length;
+  /* take a look at the body to figure out what we have, without copying a
+   * body buffer shared with the connection's read buffer */
+  if (gst_rtsp_message_has_body_buffer (message)) {
+    GstBuffer *body;
+
+    gst_rtsp_message_get_body_buffer (message, &body);
+    if (gst_buffer_extract (body, 1, &second_byte, 1) != 1)
+      goto invalid_length;
+  } else {
+    gst_rtsp_message_get_body (message, &data, &size);
+    if (size < 2)
+      goto invalid_length;
+    second_byte = data[1];
+  }
 
   /* channels are not correct on some servers, do extra check */
-  if (data[1] >= 200 && data[1] <= 204) {
+  if (second_byte >= 200 && second_byte <= 204) {
     /* hmm RTCP message switch to the RTCP pad of the same stream. */
     outpad = stream->channelpad[1];
     is_rtcp = TRUE;
@@ -5499,14 +5514,19 @@ gst_rtspsrc_handle_data (GstRTSPSrc * src, GstRTSPMessage * message)
     goto unknown_stream;
 
   /* take the message body for further processing */
-  gst_rtsp_message_steal_body (message, &data, &size);
+  if (gst_rtsp_message_has_body_buffer (message)) {
+    gst_rtsp_message_steal_body_buffer (message, &buf);
+    size = gst_buffer_get_size (buf);
+  } else {
+    gst_rtsp_message_steal_body (message, &data, &size);
 
-  /* strip the trailing \0 */
-  size -= 1;
+    /* strip the trailing \0 */
+    size -= 1;
 
-  buf = gst_buffer_new ();
-  gst_buffer_append_memory (buf,
-      gst_memory_new_wrapped (0, data, size, 0, size, data, g_free));
+    buf = gst_buffer_new ();
+    gst_buffer_append_memory (buf,
+        gst_memory_new_wrapped (0, data, size, 0, size, data, g_free));
+  }
 
   /* don't need message anymore */
   gst_rtsp_message_unset (message);
@@ -5697,6 +5717,9 @@ gst_rtspsrc_loop_interleaved (GstRTSPSrc * src)
   GstRTSPResult res;
   GstFlowReturn ret = GST_FLOW_OK;
 
+  gst_rtsp_connection_set_read_buffer_size (src->conninfo.connection,
+      INTERLEAVED_READ_BUFFER_SIZE);
+
   while (TRUE) {
     gst_rtsp_message_unset (&message);
 
@@ -218,13 +218,17 @@ gst_spectrum_alloc_channel_data (GstSpectrum * spectrum)
   GST_DEBUG_OBJECT (spectrum, "allocating data for %d channels",
       spectrum->num_channels);
 
+  spectrum->fft_ctx = gst_fft_f32_new (nfft, FALSE);
+  spectrum->input_tmp = g_new0 (gfloat, nfft * spectrum->num_channels);
+  spectrum->freqdata = g_new0 (GstFFTF32Complex,
+      bands * spectrum->num_channels);
+
   spectrum->channel_data = g_new (GstSpectrumChannel, spectrum->num_channels);
   for (i = 0; i < spectrum->num_channels; i++) {
     cd = &spectrum->channel_data[i];
-    cd->fft_ctx = gst_fft_f32_new (nfft, FALSE);
     cd->input = g_new0 (gfloat, nfft);
-    cd->input_tmp = g_new0 (gfloat, nfft);
-    cd->freqdata = g_new0 (GstFFTF32Complex, bands);
+    cd->input_tmp = spectrum->input_tmp + i * nfft;
+    cd->freqdata = spectrum->freqdata + i * bands;
     cd->spect_magnitude = g_new0 (gfloat, bands);
     cd->spect_phase = g_new0 (gfloat, bands);
   }
@@ -242,16 +246,19 @@ gst_spectrum_free_channel_data (GstSpectrum * spectrum)
 
     for (i = 0; i < spectrum->num_channels; i++) {
       cd = &spectrum->channel_data[i];
-      if (cd->fft_ctx)
-        gst_fft_f32_free (cd->fft_ctx);
       g_free (cd->input);
-      g_free (cd->input_tmp);
-      g_free (cd->freqdata);
       g_free (cd->spect_magnitude);
       g_free (cd->spect_phase);
     }
     g_free (spectrum->channel_data);
     spectrum->channel_data = NULL;
+
+    gst_fft_f32_free (spectrum->fft_ctx);
+    spectrum->fft_ctx = NULL;
+    g_free (spectrum->input_tmp);
+    spectrum->input_tmp = NULL;
+    g_free (spectrum->freqdata);
+    spectrum->freqdata = NULL;
   }
 }
 
@@ -713,26 +720,30 @@ gst_spectrum_message_new (GstSpectrum * spectrum, GstClockTime timestamp,
 }
 
 static void
-gst_spectrum_run_fft (GstSpectrum * spectrum, GstSpectrumChannel * cd,
+gst_spectrum_prepare_fft (GstSpectrum * spectrum, GstSpectrumChannel * cd,
     guint input_pos)
 {
   guint i;
-  guint bands = spectrum->bands;
-  guint nfft = 2 * bands - 2;
-  gint threshold = spectrum->threshold;
+  guint nfft = 2 * spectrum->bands - 2;
   gfloat *input = cd->input;
   gfloat *input_tmp = cd->input_tmp;
-  gfloat *spect_magnitude = cd->spect_magnitude;
-  gfloat *spect_phase = cd->spect_phase;
-  GstFFTF32Complex *freqdata = cd->freqdata;
-  GstFFTF32 *fft_ctx = cd->fft_ctx;
 
   for (i = 0; i < nfft; i++)
     input_tmp[i] = input[(input_pos + i) % nfft];
 
-  gst_fft_f32_window (fft_ctx, input_tmp, GST_FFT_WINDOW_HAMMING);
+  gst_fft_f32_window (spectrum->fft_ctx, input_tmp, GST_FFT_WINDOW_HAMMING);
+}
 
-  gst_fft_f32_fft (fft_ctx, input_tmp, freqdata);
+static void
+gst_spectrum_accumulate_fft (GstSpectrum * spectrum, GstSpectrumChannel * cd)
+{
+  guint i;
+  guint bands = spectrum->bands;
+  guint nfft = 2 * bands - 2;
+  gint threshold = spectrum->threshold;
+  gfloat *spect_magnitude = cd->spect_magnitude;
+  gfloat *spect_phase = cd->spect_phase;
+  GstFFTF32Complex *freqdata = cd->freqdata;
 
   if (spectrum->message_magnitude) {
     gdouble val;
@@ -896,7 +907,13 @@ gst_spectrum_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
         (have_full_interval && !spectrum->num_fft)) {
       for (c = 0; c < output_channels; c++) {
         cd = &spectrum->channel_data[c];
-        gst_spectrum_run_fft (spectrum, cd, input_pos);
+        gst_spectrum_prepare_fft (spectrum, cd, input_pos);
+      }
+      gst_fft_f32_fft_batch (spectrum->fft_ctx, spectrum->input_tmp,
+          spectrum->freqdata, output_channels);
+      for (c = 0; c < output_channels; c++) {
+        cd = &spectrum->channel_data[c];
+        gst_spectrum_accumulate_fft (spectrum, cd);
       }
       spectrum->num_fft++;
     }
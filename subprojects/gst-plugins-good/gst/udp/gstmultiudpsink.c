@@ -42,6 +42,22 @@
 #include <sys/socket.h>
 #endif
 
+#ifdef __linux__
+#include <time.h>
+#include <netinet/udp.h>
+#include <linux/net_tstamp.h>
+#endif
+
+#if defined (SO_TXTIME) && defined (SCM_TXTIME) && defined (SOF_TXTIME_REPORT_ERRORS)
+#define HAVE_SO_TXTIME 1
+#endif
+
+#if defined (UDP_SEGMENT) && defined (SOL_UDP)
+#define HAVE_UDP_SEGMENT 1
+/* maximum number of segments the kernel accepts in one send */
+#define UDP_MAX_SEGMENTS 64
+#endif
+
 #include <gio/gnetworking.h>
 
 #include "gst/net/net.h"
@@ -92,6 +108,9 @@ enum
 #define DEFAULT_BUFFER_SIZE        0
 #define DEFAULT_BIND_ADDRESS       NULL
 #define DEFAULT_BIND_PORT          0
+#define DEFAULT_TXTIME_PACING      FALSE
+#define DEFAULT_TXTIME_PACKET_SPREAD 0
+#define DEFAULT_GSO                FALSE
 
 enum
 {
@@ -114,7 +133,10 @@ enum
   PROP_SEND_DUPLICATES,
   PROP_BUFFER_SIZE,
   PROP_BIND_ADDRESS,
-  PROP_BIND_PORT
+  PROP_BIND_PORT,
+  PROP_TXTIME_PACING,
+  PROP_TXTIME_PACKET_SPREAD,
+  PROP_GSO
 };
 
 static void gst_multiudpsink_finalize (GObject * object);
@@ -351,6 +373,70 @@ gst_multiudpsink_class_init (GstMultiUDPSinkClass * klass)
           "Port to bind the socket to", 0, G_MAXUINT16,
           DEFAULT_BIND_PORT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiUDPSink:txtime-pacing:
+   *
+   * Let the kernel transmit each packet at a given time with SO_TXTIME,
+   * instead of sending it as soon as possible. The transmit time is derived
+   * from the buffer running time, like for synchronisation, plus
+   * #GstMultiUDPSink:txtime-packet-spread for every following packet with the
+   * same timestamp. Transmit times use %CLOCK_TAI, as required by the ETF
+   * queueing discipline that should be configured on the outgoing interface.
+   *
+   * Packets have to be handed to the kernel before their transmit time, so
+   * this is usually combined with a #GstBaseSink:render-delay at least as
+   * big as the ETF delta. Packets that are already late are sent
+   * immediately.
+   *
+   * This is only supported on Linux, and needs the CAP_NET_ADMIN capability.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_TXTIME_PACING,
+      g_param_spec_boolean ("txtime-pacing", "Transmit time pacing",
+          "Schedule the transmission of each packet with SO_TXTIME",
+          DEFAULT_TXTIME_PACING, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiUDPSink:txtime-packet-spread:
+   *
+   * Time in nanoseconds between the transmit times of consecutive packets
+   * with the same timestamp when #GstMultiUDPSink:txtime-pacing is enabled.
+   * For constant bitrate streams this is usually the frame duration divided
+   * by the number of packets per frame.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_TXTIME_PACKET_SPREAD,
+      g_param_spec_uint64 ("txtime-packet-spread", "Transmit time packet spread",
+          "Time between the transmission of packets with the same timestamp "
+          "(in ns)", 0, G_MAXUINT64, DEFAULT_TXTIME_PACKET_SPREAD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiUDPSink:gso:
+   *
+   * Use UDP generic segmentation offload (UDP_SEGMENT) to send runs of
+   * consecutive packets of the same size to a client with a single send
+   * operation. The last packet of a run may be shorter. This considerably
+   * reduces the per-packet cost when many packets are rendered at once,
+   * e.g. when a payloader pushes all packets of a video frame as one
+   * buffer list, see #GstRTPBasePayload:access-unit-lists.
+   *
+   * Packets must not be bigger than the MTU of the outgoing interface. If the
+   * kernel refuses a segmented send, GSO is disabled again. It is not used
+   * together with #GstMultiUDPSink:txtime-pacing, where every packet has its
+   * own transmit time.
+   *
+   * This is only supported on Linux 4.18 or newer.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_GSO,
+      g_param_spec_boolean ("gso", "GSO",
+          "Send runs of equally sized packets with UDP segmentation offload",
+          DEFAULT_GSO, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &sink_template);
 
   gst_element_class_set_static_metadata (gstelement_class, "UDP packet sender",
@@ -419,6 +505,9 @@ gst_multiudpsink_init (GstMultiUDPSink * sink)
   sink->qos_dscp = DEFAULT_QOS_DSCP;
   sink->send_duplicates = DEFAULT_SEND_DUPLICATES;
   sink->multi_iface = g_strdup (DEFAULT_MULTICAST_IFACE);
+  sink->txtime_pacing = DEFAULT_TXTIME_PACING;
+  sink->txtime_packet_spread = DEFAULT_TXTIME_PACKET_SPREAD;
+  sink->gso = DEFAULT_GSO;
 
   gst_multiudpsink_create_cancellable (sink);
 
@@ -524,6 +613,7 @@ static void
 gst_multiudpsink_finalize (GObject * object)
 {
   GstMultiUDPSink *sink;
+  guint i;
 
   sink = GST_MULTIUDPSINK (object);
 
@@ -557,6 +647,14 @@ gst_multiudpsink_finalize (GObject * object)
   sink->maps = NULL;
   g_free (sink->messages);
   sink->messages = NULL;
+  for (i = 0; i < sink->n_txtime_msgs; i++)
+    g_object_unref (sink->txtime_msgs[i]);
+  g_free (sink->txtime_msgs);
+  sink->txtime_msgs = NULL;
+  for (i = 0; i < sink->n_gso_msgs; i++)
+    g_object_unref (sink->gso_msgs[i]);
+  g_free (sink->gso_msgs);
+  sink->gso_msgs = NULL;
 
   g_free (sink->bind_address);
   sink->bind_address = NULL;
@@ -634,6 +732,329 @@ gst_udp_address_get_string (GSocketAddress * addr, gchar * s, gsize size)
   return s;
 }
 
+#ifdef HAVE_SO_TXTIME
+/* SCM_TXTIME control message carrying the transmit time of a packet, so that
+ * it can be passed along with g_socket_send_messages() */
+typedef struct
+{
+  GSocketControlMessage parent;
+
+  guint64 txtime;
+} GstUDPTxTimeMessage;
+
+typedef struct
+{
+  GSocketControlMessageClass parent_class;
+} GstUDPTxTimeMessageClass;
+
+static GType gst_udp_txtime_message_get_type (void);
+G_DEFINE_TYPE (GstUDPTxTimeMessage, gst_udp_txtime_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_udp_txtime_message_get_size (GSocketControlMessage * msg)
+{
+  return sizeof (guint64);
+}
+
+static int
+gst_udp_txtime_message_get_level (GSocketControlMessage * msg)
+{
+  return SOL_SOCKET;
+}
+
+static int
+gst_udp_txtime_message_get_msg_type (GSocketControlMessage * msg)
+{
+  return SCM_TXTIME;
+}
+
+static void
+gst_udp_txtime_message_serialize (GSocketControlMessage * msg, gpointer data)
+{
+  guint64 txtime = ((GstUDPTxTimeMessage *) msg)->txtime;
+
+  memcpy (data, &txtime, sizeof (guint64));
+}
+
+static void
+gst_udp_txtime_message_class_init (GstUDPTxTimeMessageClass * klass)
+{
+  GSocketControlMessageClass *scm_class = (GSocketControlMessageClass *) klass;
+
+  scm_class->get_size = gst_udp_txtime_message_get_size;
+  scm_class->get_level = gst_udp_txtime_message_get_level;
+  scm_class->get_type = gst_udp_txtime_message_get_msg_type;
+  scm_class->serialize = gst_udp_txtime_message_serialize;
+}
+
+static void
+gst_udp_txtime_message_init (GstUDPTxTimeMessage * msg)
+{
+}
+
+static gboolean
+gst_multiudpsink_setup_txtime (GstMultiUDPSink * sink, GSocket * socket)
+{
+  struct sock_txtime cfg = { CLOCK_TAI, 0 };
+
+  if (socket == NULL)
+    return TRUE;
+
+  if (setsockopt (g_socket_get_fd (socket), SOL_SOCKET, SO_TXTIME, &cfg,
+          sizeof (cfg)) < 0) {
+    GST_ELEMENT_WARNING (sink, RESOURCE, SETTINGS, (NULL),
+        ("setsockopt SO_TXTIME failed, not pacing packets: %s",
+            strerror (errno)));
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Attaches a transmit time to each of the first @num_buffers messages.
+ * Consecutive buffers with the same timestamp get a transmit time
+ * txtime-packet-spread apart. */
+static void
+gst_multiudpsink_set_txtimes (GstMultiUDPSink * sink, GstBuffer ** buffers,
+    guint num_buffers, GstOutputMessage * msgs)
+{
+  GstBaseSink *bsink = GST_BASE_SINK_CAST (sink);
+  GstClock *clock;
+  GstClockTime base_time, latency, now;
+  GstClockTimeDiff ts_offset;
+  struct timespec now_tai;
+  guint i;
+
+  if (bsink->segment.format != GST_FORMAT_TIME)
+    return;
+
+  GST_OBJECT_LOCK (sink);
+  if ((clock = GST_ELEMENT_CLOCK (sink)) == NULL) {
+    GST_OBJECT_UNLOCK (sink);
+    GST_LOG_OBJECT (sink, "no clock, not setting transmit times");
+    return;
+  }
+  gst_object_ref (clock);
+  base_time = GST_ELEMENT_CAST (sink)->base_time;
+  GST_OBJECT_UNLOCK (sink);
+
+  latency = gst_base_sink_get_latency (bsink);
+  ts_offset = gst_base_sink_get_ts_offset (bsink);
+
+  now = gst_clock_get_time (clock);
+  clock_gettime (CLOCK_TAI, &now_tai);
+  gst_object_unref (clock);
+
+  /* ensure we have a control message for each buffer */
+  if (sink->n_txtime_msgs < num_buffers) {
+    guint n = GST_ROUND_UP_16 (num_buffers);
+
+    sink->txtime_msgs = g_renew (GSocketControlMessage *, sink->txtime_msgs, n);
+    for (i = sink->n_txtime_msgs; i < n; i++)
+      sink->txtime_msgs[i] =
+          g_object_new (gst_udp_txtime_message_get_type (), NULL);
+    sink->n_txtime_msgs = n;
+  }
+
+  for (i = 0; i < num_buffers; ++i) {
+    GstClockTime ts = GST_BUFFER_DTS_OR_PTS (buffers[i]);
+    GstClockTime clock_time;
+
+    if (GST_CLOCK_TIME_IS_VALID (ts) && ts != sink->txtime_last_ts) {
+      GstClockTime running_time;
+
+      running_time = gst_segment_to_running_time (&bsink->segment,
+          GST_FORMAT_TIME, ts);
+      if (!GST_CLOCK_TIME_IS_VALID (running_time))
+        continue;
+
+      sink->txtime_last_ts = ts;
+      sink->txtime_anchor = running_time + base_time + latency;
+      if (ts_offset < 0 && -ts_offset > sink->txtime_anchor)
+        sink->txtime_anchor = 0;
+      else
+        sink->txtime_anchor += ts_offset;
+      sink->txtime_packet = 0;
+    } else if (GST_CLOCK_TIME_IS_VALID (sink->txtime_anchor)) {
+      sink->txtime_packet++;
+    } else {
+      continue;
+    }
+
+    clock_time = sink->txtime_anchor +
+        sink->txtime_packet * sink->txtime_packet_spread;
+
+    /* late packets are sent right away */
+    if (clock_time <= now) {
+      GST_LOG_OBJECT (sink, "packet is late by %" GST_STIME_FORMAT,
+          GST_STIME_ARGS (GST_CLOCK_DIFF (clock_time, now)));
+      continue;
+    }
+
+    ((GstUDPTxTimeMessage *) sink->txtime_msgs[i])->txtime =
+        GST_TIMESPEC_TO_TIME (now_tai) + GST_CLOCK_DIFF (now, clock_time);
+    msgs[i].control_messages = &sink->txtime_msgs[i];
+    msgs[i].num_control_messages = 1;
+  }
+}
+#endif
+
+#ifdef HAVE_UDP_SEGMENT
+/* UDP_SEGMENT control message carrying the segment size of a message, so that
+ * it can be passed along with g_socket_send_messages() */
+typedef struct
+{
+  GSocketControlMessage parent;
+
+  guint16 gso_size;
+} GstUDPSegmentMessage;
+
+typedef struct
+{
+  GSocketControlMessageClass parent_class;
+} GstUDPSegmentMessageClass;
+
+static GType gst_udp_segment_message_get_type (void);
+G_DEFINE_TYPE (GstUDPSegmentMessage, gst_udp_segment_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_udp_segment_message_get_size (GSocketControlMessage * msg)
+{
+  return sizeof (guint16);
+}
+
+static int
+gst_udp_segment_message_get_level (GSocketControlMessage * msg)
+{
+  return SOL_UDP;
+}
+
+static int
+gst_udp_segment_message_get_msg_type (GSocketControlMessage * msg)
+{
+  return UDP_SEGMENT;
+}
+
+static void
+gst_udp_segment_message_serialize (GSocketControlMessage * msg, gpointer data)
+{
+  guint16 gso_size = ((GstUDPSegmentMessage *) msg)->gso_size;
+
+  memcpy (data, &gso_size, sizeof (guint16));
+}
+
+static void
+gst_udp_segment_message_class_init (GstUDPSegmentMessageClass * klass)
+{
+  GSocketControlMessageClass *scm_class = (GSocketControlMessageClass *) klass;
+
+  scm_class->get_size = gst_udp_segment_message_get_size;
+  scm_class->get_level = gst_udp_segment_message_get_level;
+  scm_class->get_type = gst_udp_segment_message_get_msg_type;
+  scm_class->serialize = gst_udp_segment_message_serialize;
+}
+
+static void
+gst_udp_segment_message_init (GstUDPSegmentMessage * msg)
+{
+}
+
+static gboolean
+gst_udp_message_is_segmented (GstOutputMessage * msg)
+{
+  return msg->num_control_messages > 0 &&
+      G_TYPE_CHECK_INSTANCE_TYPE (msg->control_messages[0],
+      gst_udp_segment_message_get_type ());
+}
+
+/* Checks whether the kernel supports UDP_SEGMENT on @socket. This does not
+ * enable segmentation for every send yet, that is done per message. */
+static gboolean
+gst_multiudpsink_setup_gso (GstMultiUDPSink * sink, GSocket * socket)
+{
+  int gso_size = 0;
+
+  if (socket == NULL)
+    return TRUE;
+
+  if (setsockopt (g_socket_get_fd (socket), SOL_UDP, UDP_SEGMENT, &gso_size,
+          sizeof (gso_size)) < 0) {
+    GST_ELEMENT_WARNING (sink, RESOURCE, SETTINGS, (NULL),
+        ("UDP segmentation offload is not supported: %s", strerror (errno)));
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Merges runs of consecutive messages of the same size into a single message
+ * that the kernel splits again into packets of that size. The last message
+ * of a run may be shorter. The vectors of consecutive messages are adjacent
+ * in the scratch array, so merging only means extending the first message.
+ * Returns the new number of messages. */
+static guint
+gst_multiudpsink_coalesce_gso (GstMultiUDPSink * sink, GstOutputMessage * msgs,
+    guint num_msgs)
+{
+  guint i, j, n, num_out = 0, num_gso = 0;
+
+  /* ensure we have a control message for each possible run */
+  if (sink->n_gso_msgs < num_msgs / 2) {
+    n = GST_ROUND_UP_16 (num_msgs / 2);
+
+    sink->gso_msgs = g_renew (GSocketControlMessage *, sink->gso_msgs, n);
+    for (i = sink->n_gso_msgs; i < n; i++)
+      sink->gso_msgs[i] =
+          g_object_new (gst_udp_segment_message_get_type (), NULL);
+    sink->n_gso_msgs = n;
+  }
+
+  for (i = 0; i < num_msgs; i = j) {
+    gsize seg_size = gst_udp_calc_message_size (&msgs[i]);
+    gsize total = seg_size;
+    guint num_vectors;
+
+    for (j = i + 1; j < num_msgs && j - i < UDP_MAX_SEGMENTS; j++) {
+      gsize size;
+
+      if (seg_size == 0 || seg_size > G_MAXUINT16)
+        break;
+
+      size = gst_udp_calc_message_size (&msgs[j]);
+      if (size == 0 || size > seg_size || total + size > UDP_MAX_SIZE)
+        break;
+
+      total += size;
+      if (size < seg_size) {
+        j++;
+        break;
+      }
+    }
+
+    n = j - i;
+    num_vectors = msgs[j - 1].vectors + msgs[j - 1].num_vectors -
+        msgs[i].vectors;
+
+    msgs[num_out] = msgs[i];
+    if (n > 1) {
+      GST_LOG_OBJECT (sink, "sending %u packets of %" G_GSIZE_FORMAT
+          " bytes at once", n, seg_size);
+
+      ((GstUDPSegmentMessage *) sink->gso_msgs[num_gso])->gso_size = seg_size;
+      msgs[num_out].num_vectors = num_vectors;
+      msgs[num_out].control_messages = &sink->gso_msgs[num_gso];
+      msgs[num_out].num_control_messages = 1;
+      num_gso++;
+    }
+    num_out++;
+  }
+
+  return num_out;
+}
+#endif
+
 /* Wrapper around g_socket_send_messages() plus error handling (ignoring).
  * Returns FALSE if we got cancelled, otherwise TRUE. */
 static GstFlowReturn
@@ -687,6 +1108,17 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
               ("Reason: %s", err ? err->message : "unknown reason"));
           sent_max_size_warning = FALSE;
         }
+#ifdef HAVE_UDP_SEGMENT
+      } else if (gst_udp_message_is_segmented (msg)) {
+        /* e.g. the packets are bigger than the MTU or the device can't
+         * checksum them, just send them one by one from now on */
+        if (sink->gso_active) {
+          GST_ELEMENT_WARNING (sink, RESOURCE, WRITE, (NULL),
+              ("Error sending segmented UDP packets, disabling GSO: %s",
+                  (err != NULL) ? err->message : "unknown reason"));
+          sink->gso_active = FALSE;
+        }
+#endif
       } else {
         GST_ELEMENT_WARNING (sink, RESOURCE, WRITE,
             ("Error sending UDP packets"), ("client %s, reason: %s",
@@ -725,7 +1157,7 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
   GstMapInfo *map_infos;
   GstFlowReturn flow_ret;
   guint num_addr_v4, num_addr_v6;
-  guint num_addr, num_msgs;
+  guint num_addr, num_msgs, num_buf_msgs;
   guint i, j, mem;
   gsize size = 0;
   GList *l;
@@ -796,15 +1228,28 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
     mem += mem_nums[i];
   }
 
+#ifdef HAVE_SO_TXTIME
+  if (sink->txtime_active)
+    gst_multiudpsink_set_txtimes (sink, buffers, num_buffers, msgs);
+#endif
+
+  num_buf_msgs = num_buffers;
+#ifdef HAVE_UDP_SEGMENT
+  if (sink->gso_active && num_buffers > 1)
+    num_buf_msgs = gst_multiudpsink_coalesce_gso (sink, msgs, num_buffers);
+#endif
+  num_msgs = num_addr * num_buf_msgs;
+
   /* FIXME: how about some locking? (there wasn't any before either, but..) */
   sink->bytes_to_serve += size;
 
-  /* now copy the pre-filled num_buffer messages over to the next num_buffer
-   * messages for the next client, where we also change the target address */
+  /* now copy the pre-filled num_buf_msgs messages over to the next
+   * num_buf_msgs messages for the next client, where we also change the
+   * target address */
   for (i = 1; i < num_addr; ++i) {
-    for (j = 0; j < num_buffers; ++j) {
-      msgs[i * num_buffers + j] = msgs[j];
-      msgs[i * num_buffers + j].address = clients[i]->addr;
+    for (j = 0; j < num_buf_msgs; ++j) {
+      msgs[i * num_buf_msgs + j] = msgs[j];
+      msgs[i * num_buf_msgs + j].address = clients[i]->addr;
     }
   }
 
@@ -815,8 +1260,8 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
     flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket_v6,
         msgs, num_msgs);
   } else {
-    guint num_msgs_v4 = num_buffers * num_addr_v4;
-    guint num_msgs_v6 = num_buffers * num_addr_v6;
+    guint num_msgs_v4 = num_buf_msgs * num_addr_v4;
+    guint num_msgs_v6 = num_buf_msgs * num_addr_v6;
 
     /* our client list is sorted with IPv4 clients first and IPv6 ones last */
     flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket,
@@ -838,15 +1283,15 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
   for (i = 0; i < num_addr; ++i) {
     GstUDPClient *client = clients[i];
 
-    for (j = 0; j < num_buffers; ++j) {
+    for (j = 0; j < num_buf_msgs; ++j) {
       gsize bytes_sent;
 
-      bytes_sent = msgs[i * num_buffers + j].bytes_sent;
+      bytes_sent = msgs[i * num_buf_msgs + j].bytes_sent;
 
       client->bytes_sent += bytes_sent;
-      client->packets_sent++;
       sink->bytes_served += bytes_sent;
     }
+    client->packets_sent += num_buffers;
     gst_udp_client_unref (client);
   }
 
@@ -1094,6 +1539,15 @@ gst_multiudpsink_set_property (GObject * object, guint prop_id,
     case PROP_BIND_PORT:
       udpsink->bind_port = g_value_get_int (value);
       break;
+    case PROP_TXTIME_PACING:
+      udpsink->txtime_pacing = g_value_get_boolean (value);
+      break;
+    case PROP_TXTIME_PACKET_SPREAD:
+      udpsink->txtime_packet_spread = g_value_get_uint64 (value);
+      break;
+    case PROP_GSO:
+      udpsink->gso = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1167,6 +1621,15 @@ gst_multiudpsink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_BIND_PORT:
       g_value_set_int (value, udpsink->bind_port);
       break;
+    case PROP_TXTIME_PACING:
+      g_value_set_boolean (value, udpsink->txtime_pacing);
+      break;
+    case PROP_TXTIME_PACKET_SPREAD:
+      g_value_set_uint64 (value, udpsink->txtime_packet_spread);
+      break;
+    case PROP_GSO:
+      g_value_set_boolean (value, udpsink->gso);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1440,6 +1903,35 @@ gst_multiudpsink_start (GstBaseSink * bsink)
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket);
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket_v6);
 
+  sink->txtime_active = FALSE;
+  if (sink->txtime_pacing) {
+#ifdef HAVE_SO_TXTIME
+    /* sending a SCM_TXTIME message on a socket without SO_TXTIME fails, so
+     * only pace packets if all sockets could be configured */
+    sink->txtime_active =
+        gst_multiudpsink_setup_txtime (sink, sink->used_socket) &&
+        gst_multiudpsink_setup_txtime (sink, sink->used_socket_v6);
+#else
+    GST_ELEMENT_WARNING (sink, RESOURCE, SETTINGS, (NULL),
+        ("Transmit time pacing is not supported on this platform"));
+#endif
+  }
+  sink->txtime_last_ts = GST_CLOCK_TIME_NONE;
+  sink->txtime_anchor = GST_CLOCK_TIME_NONE;
+  sink->txtime_packet = 0;
+
+  sink->gso_active = FALSE;
+  if (sink->gso && !sink->txtime_active) {
+#ifdef HAVE_UDP_SEGMENT
+    sink->gso_active =
+        gst_multiudpsink_setup_gso (sink, sink->used_socket) &&
+        gst_multiudpsink_setup_gso (sink, sink->used_socket_v6);
+#else
+    GST_ELEMENT_WARNING (sink, RESOURCE, SETTINGS, (NULL),
+        ("UDP segmentation offload is not supported on this platform"));
+#endif
+  }
+
   /* look for multicast clients and join multicast groups appropriately
      set also ttl and multicast loopback delivery appropriately  */
   for (clients = sink->clients; clients; clients = g_list_next (clients)) {
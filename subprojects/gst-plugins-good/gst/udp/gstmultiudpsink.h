@@ -81,6 +81,19 @@ struct _GstMultiUDPSink {
   guint             n_maps;
   GstOutputMessage *messages;
   guint             n_messages;
+  GSocketControlMessage **txtime_msgs;
+  guint             n_txtime_msgs;
+  GSocketControlMessage **gso_msgs;
+  guint             n_gso_msgs;
+
+  /* transmit time pacing state */
+  gboolean          txtime_active;
+  GstClockTime      txtime_last_ts;
+  GstClockTime      txtime_anchor;
+  guint             txtime_packet;
+
+  /* UDP segmentation offload state */
+  gboolean          gso_active;
 
   /* properties */
   guint64        bytes_to_serve;
@@ -102,6 +115,9 @@ struct _GstMultiUDPSink {
   gint           buffer_size;
   gchar         *bind_address;
   gint           bind_port;
+  gboolean       txtime_pacing;
+  guint64        txtime_packet_spread;
+  gboolean       gso;
 };
 
 struct _GstMultiUDPSinkClass {
@@ -570,6 +570,9 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
 #define UDP_DEFAULT_LOOP               TRUE
 #define UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS TRUE
 #define UDP_DEFAULT_MTU                (1492)
+#define UDP_DEFAULT_BATCH_SIZE         1
+#define UDP_DEFAULT_BATCH_TIMEOUT      0
+#define UDP_MAX_BATCH_SIZE             1024
 
 enum
 {
@@ -593,6 +596,8 @@ enum
   PROP_RETRIEVE_SENDER_ADDRESS,
   PROP_MTU,
   PROP_SOCKET_TIMESTAMP,
+  PROP_BATCH_SIZE,
+  PROP_BATCH_TIMEOUT,
 };
 
 static void gst_udpsrc_uri_handler_init (gpointer g_iface, gpointer iface_data);
@@ -601,7 +606,9 @@ static GstCaps *gst_udpsrc_getcaps (GstBaseSrc * src, GstCaps * filter);
 static gboolean gst_udpsrc_close (GstUDPSrc * src);
 static gboolean gst_udpsrc_unlock (GstBaseSrc * bsrc);
 static gboolean gst_udpsrc_unlock_stop (GstBaseSrc * bsrc);
+static GstFlowReturn gst_udpsrc_create (GstPushSrc * psrc, GstBuffer ** buf);
 static GstFlowReturn gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf);
+static void gst_udpsrc_free_batch_slots (GstUDPSrc * src);
 
 static void gst_udpsrc_finalize (GObject * object);
 
@@ -779,6 +786,41 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
           GST_SOCKET_TIMESTAMP_MODE, GST_SOCKET_TIMESTAMP_MODE_REALTIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstUDPSrc:batch-size:
+   *
+   * Maximum number of packets to receive with a single system call and to
+   * push downstream together in one #GstBufferList. With a value of 1 every
+   * packet is received and pushed separately.
+   *
+   * Packets larger than #GstUDPSrc:mtu are truncated when receiving in
+   * batches, so the mtu should be set accordingly.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch Size",
+          "Maximum number of packets to receive at once and push downstream "
+          "as a buffer list (1 = no batching)", 1, UDP_MAX_BATCH_SIZE,
+          UDP_DEFAULT_BATCH_SIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstUDPSrc:batch-timeout:
+   *
+   * Maximum time in nanoseconds to wait for further packets once the first
+   * packet of a batch was received, before pushing out an incomplete batch.
+   * With 0 only the packets that are already queued on the socket are taken
+   * into the batch. Only used if #GstUDPSrc:batch-size is bigger than 1.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_TIMEOUT,
+      g_param_spec_uint64 ("batch-timeout", "Batch Timeout",
+          "Maximum time in nanoseconds to wait for a batch to fill up after "
+          "its first packet (0 = only take the packets already queued)", 0,
+          G_MAXUINT64, UDP_DEFAULT_BATCH_TIMEOUT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &src_template);
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -794,6 +836,7 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
   gstbasesrc_class->get_caps = gst_udpsrc_getcaps;
   gstbasesrc_class->decide_allocation = gst_udpsrc_decide_allocation;
 
+  gstpushsrc_class->create = gst_udpsrc_create;
   gstpushsrc_class->fill = gst_udpsrc_fill;
 
   gst_type_mark_as_plugin_api (GST_TYPE_SOCKET_TIMESTAMP_MODE, 0);
@@ -821,6 +864,8 @@ gst_udpsrc_init (GstUDPSrc * udpsrc)
   udpsrc->loop = UDP_DEFAULT_LOOP;
   udpsrc->retrieve_sender_address = UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS;
   udpsrc->mtu = UDP_DEFAULT_MTU;
+  udpsrc->batch_size = UDP_DEFAULT_BATCH_SIZE;
+  udpsrc->batch_timeout = UDP_DEFAULT_BATCH_TIMEOUT;
 
   /* configure basesrc to be a live source */
   gst_base_src_set_live (GST_BASE_SRC (udpsrc), TRUE);
@@ -863,6 +908,8 @@ gst_udpsrc_finalize (GObject * object)
     gst_memory_unref (udpsrc->extra_mem);
   udpsrc->extra_mem = NULL;
 
+  gst_udpsrc_free_batch_slots (udpsrc);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -912,6 +959,142 @@ gst_udpsrc_free_cancellable (GstUDPSrc * src)
   src->cancellable = NULL;
 }
 
+static gboolean
+gst_udpsrc_want_control_messages (GstUDPSrc * udpsrc)
+{
+  gboolean ret;
+
+  /* optimization: use messages only in multicast mode and
+   * if we can't let the kernel do the filtering for us */
+  ret =
+      g_inet_address_get_is_multicast (g_inet_socket_address_get_address
+      (udpsrc->addr));
+#ifdef IP_MULTICAST_ALL
+  if (g_inet_address_get_family (g_inet_socket_address_get_address
+          (udpsrc->addr)) == G_SOCKET_FAMILY_IPV4)
+    ret = FALSE;
+#endif
+#ifdef SO_TIMESTAMPNS
+  if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
+    ret = TRUE;
+#endif
+
+  return ret;
+}
+
+/* Checks the control messages received along with a packet, and applies the
+ * socket timestamp to @outbuf if there is one. Returns TRUE if the packet
+ * was sent to a different multicast address than ours and should be dropped.
+ * Takes ownership of @msgs. */
+static gboolean
+gst_udpsrc_process_control_messages (GstUDPSrc * udpsrc, GstBuffer * outbuf,
+    GSocketControlMessage ** msgs, gint n_msgs)
+{
+  GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
+  gboolean skip_packet = FALSE;
+  gsize iaddr_size = g_inet_address_get_native_size (iaddr);
+  const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
+  gint i;
+
+  for (i = 0; i < n_msgs && !skip_packet; i++) {
+#ifdef IP_PKTINFO
+    if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef IPV6_PKTINFO
+    if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef IP_RECVDSTADDR
+    if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
+      GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef SO_TIMESTAMPNS
+    if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
+      GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
+      GstClock *clock;
+      GstClockTime socket_ts;
+
+      socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
+      GST_TRACE_OBJECT (udpsrc,
+          "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
+          GST_TIME_ARGS (socket_ts));
+
+      clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+      if (clock != NULL) {
+        gint64 adjust_dts, cur_sys_time, delta;
+        GstClockTime base_time, cur_gst_clk_time, running_time;
+
+        /*
+         * We use g_get_real_time as the time reference for SCM timestamps
+         * is always CLOCK_REALTIME.
+         */
+        cur_sys_time = g_get_real_time () * GST_USECOND;
+        cur_gst_clk_time = gst_clock_get_time (clock);
+
+        delta = (gint64) cur_sys_time - (gint64) socket_ts;
+        if (delta < 0) {
+          /*
+           * The current system time will always be greater than the SCM
+           * timestamp as the packet would have been timestamped at least
+           * some clock cycles before. If it is not, then the system time
+           * was adjusted. Since we cannot rely on the delta calculation in
+           * such a case, set the DTS to current pipeline clock when this
+           * happens.
+           */
+          GST_LOG_OBJECT (udpsrc,
+              "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
+          GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
+        } else {
+          base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+          running_time = cur_gst_clk_time - base_time;
+          adjust_dts = (gint64) running_time - delta;
+          /*
+           * If the system time was adjusted much further ahead, we might
+           * end up with delta > cur_gst_clk_time. Set the DTS to current
+           * pipeline clock for this scenario as well.
+           */
+          if (adjust_dts < 0) {
+            GST_LOG_OBJECT (udpsrc,
+                "Current system time much ahead in time, setting DTS to pipeline clock");
+            GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
+          } else {
+            GST_BUFFER_DTS (outbuf) = adjust_dts;
+            GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
+                GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
+          }
+        }
+        g_object_unref (clock);
+      } else {
+        GST_ERROR_OBJECT (udpsrc, "Failed to get element clock, not setting DTS");
+      }
+    }
+#endif
+  }
+
+  for (i = 0; i < n_msgs; i++) {
+    g_object_unref (msgs[i]);
+  }
+  g_free (msgs);
+
+  return skip_packet;
+}
+
 static GstFlowReturn
 gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
 {
@@ -925,27 +1108,14 @@ gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
   gsize offset;
   GSocketControlMessage **msgs = NULL;
   GSocketControlMessage ***p_msgs;
-  gint n_msgs = 0, i;
+  gint n_msgs = 0;
   GstMapInfo info;
   GstMapInfo extra_info;
   GInputVector ivec[2];
 
   udpsrc = GST_UDPSRC_CAST (psrc);
 
-  /* optimization: use messages only in multicast mode and
-   * if we can't let the kernel do the filtering for us */
-  p_msgs =
-      (g_inet_address_get_is_multicast (g_inet_socket_address_get_address
-          (udpsrc->addr))) ? &msgs : NULL;
-#ifdef IP_MULTICAST_ALL
-  if (g_inet_address_get_family (g_inet_socket_address_get_address
-          (udpsrc->addr)) == G_SOCKET_FAMILY_IPV4)
-    p_msgs = NULL;
-#endif
-#ifdef SO_TIMESTAMPNS
-  if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
-    p_msgs = &msgs;
-#endif
+  p_msgs = gst_udpsrc_want_control_messages (udpsrc) ? &msgs : NULL;
 
   /* Retrieve sender address unless we've been configured not to do so */
   p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
@@ -1040,109 +1210,7 @@ retry:
   /* Retry if multicast and the destination address is not ours. We don't want
    * to receive arbitrary packets */
   if (p_msgs) {
-    GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
-    gboolean skip_packet = FALSE;
-    gsize iaddr_size = g_inet_address_get_native_size (iaddr);
-    const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
-
-    for (i = 0; i < n_msgs && !skip_packet; i++) {
-#ifdef IP_PKTINFO
-      if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef IPV6_PKTINFO
-      if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef IP_RECVDSTADDR
-      if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
-        GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef SO_TIMESTAMPNS
-      if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
-        GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
-        GstClock *clock;
-        GstClockTime socket_ts;
-
-        socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
-        GST_TRACE_OBJECT (udpsrc,
-            "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
-            GST_TIME_ARGS (socket_ts));
-
-        clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
-        if (clock != NULL) {
-          gint64 adjust_dts, cur_sys_time, delta;
-          GstClockTime base_time, cur_gst_clk_time, running_time;
-
-          /*
-           * We use g_get_real_time as the time reference for SCM timestamps
-           * is always CLOCK_REALTIME.
-           */
-          cur_sys_time = g_get_real_time () * GST_USECOND;
-          cur_gst_clk_time = gst_clock_get_time (clock);
-
-          delta = (gint64) cur_sys_time - (gint64) socket_ts;
-          if (delta < 0) {
-            /*
-             * The current system time will always be greater than the SCM
-             * timestamp as the packet would have been timestamped at least
-             * some clock cycles before. If it is not, then the system time
-             * was adjusted. Since we cannot rely on the delta calculation in
-             * such a case, set the DTS to current pipeline clock when this
-             * happens.
-             */
-            GST_LOG_OBJECT (udpsrc,
-                "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
-            GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-          } else {
-            base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
-            running_time = cur_gst_clk_time - base_time;
-            adjust_dts = (gint64) running_time - delta;
-            /*
-             * If the system time was adjusted much further ahead, we might
-             * end up with delta > cur_gst_clk_time. Set the DTS to current
-             * pipeline clock for this scenario as well.
-             */
-            if (adjust_dts < 0) {
-              GST_LOG_OBJECT (udpsrc,
-                  "Current system time much ahead in time, setting DTS to pipeline clock");
-              GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-            } else {
-              GST_BUFFER_DTS (outbuf) = adjust_dts;
-              GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
-                  GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
-            }
-          }
-          g_object_unref (clock);
-        } else {
-          GST_ERROR_OBJECT (udpsrc,
-              "Failed to get element clock, not setting DTS");
-        }
-      }
-#endif
-    }
-
-    for (i = 0; i < n_msgs; i++) {
-      g_object_unref (msgs[i]);
-    }
-    g_free (msgs);
-
-    if (skip_packet) {
+    if (gst_udpsrc_process_control_messages (udpsrc, outbuf, msgs, n_msgs)) {
       GST_DEBUG_OBJECT (udpsrc,
           "Dropping packet for a different multicast address");
       goto retry;
@@ -1234,6 +1302,340 @@ skip_error:
   }
 }
 
+static void
+gst_udpsrc_free_batch_slots (GstUDPSrc * src)
+{
+  guint i;
+
+  for (i = 0; i < src->n_batch_slots; i++) {
+    if (src->batch_slots[i].buffer)
+      gst_buffer_unref (src->batch_slots[i].buffer);
+  }
+  g_free (src->batch_slots);
+  src->batch_slots = NULL;
+  g_free (src->batch_msgs);
+  src->batch_msgs = NULL;
+  src->n_batch_slots = 0;
+}
+
+/* Makes sure every batch slot has a mapped buffer from the pool. Buffers
+ * that were not filled by the previous batch are kept in their slot and
+ * reused, so we only acquire as many buffers as were pushed out last time */
+static GstFlowReturn
+gst_udpsrc_prepare_batch_slots (GstUDPSrc * udpsrc, guint batch_size)
+{
+  GstBufferPool *pool;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i;
+
+  if (udpsrc->n_batch_slots != batch_size) {
+    gst_udpsrc_free_batch_slots (udpsrc);
+    udpsrc->batch_slots = g_new0 (GstUDPSrcBatchSlot, batch_size);
+    udpsrc->batch_msgs = g_new0 (GInputMessage, batch_size);
+    udpsrc->n_batch_slots = batch_size;
+  }
+
+  pool = gst_base_src_get_buffer_pool (GST_BASE_SRC_CAST (udpsrc));
+  if (pool == NULL)
+    return GST_FLOW_NOT_NEGOTIATED;
+
+  for (i = 0; i < batch_size; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+
+    if (slot->buffer == NULL) {
+      ret = gst_buffer_pool_acquire_buffer (pool, &slot->buffer, NULL);
+      if (ret != GST_FLOW_OK)
+        break;
+    } else {
+      /* might have been set from the socket timestamp of a dropped packet */
+      GST_BUFFER_DTS (slot->buffer) = GST_CLOCK_TIME_NONE;
+    }
+    if (!gst_buffer_map (slot->buffer, &slot->map, GST_MAP_READWRITE)) {
+      gst_buffer_unref (slot->buffer);
+      slot->buffer = NULL;
+      ret = GST_FLOW_ERROR;
+      break;
+    }
+    slot->vec.buffer = slot->map.data;
+    slot->vec.size = slot->map.size;
+  }
+
+  /* unmap again what we managed to map so far */
+  if (ret != GST_FLOW_OK) {
+    while (i-- > 0)
+      gst_buffer_unmap (udpsrc->batch_slots[i].buffer,
+          &udpsrc->batch_slots[i].map);
+  }
+
+  gst_object_unref (pool);
+
+  return ret;
+}
+
+/* Receives up to batch-size packets, starting at slot @first, with a single
+ * g_socket_receive_messages() call. Returns the number of packets received
+ * or -1 on error */
+static gint
+gst_udpsrc_receive_batch (GstUDPSrc * udpsrc, guint first, guint batch_size,
+    gboolean want_ctrl_msgs, GError ** err)
+{
+  gboolean blocking;
+  guint i;
+  gint res;
+
+  for (i = first; i < batch_size; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+    GInputMessage *msg = &udpsrc->batch_msgs[i];
+
+    slot->addr = NULL;
+    slot->ctrl_msgs = NULL;
+    slot->n_ctrl_msgs = 0;
+    slot->drop = FALSE;
+
+    msg->address = udpsrc->retrieve_sender_address ? &slot->addr : NULL;
+    msg->vectors = &slot->vec;
+    msg->num_vectors = 1;
+    msg->bytes_received = 0;
+    msg->flags = G_SOCKET_MSG_NONE;
+    msg->control_messages = want_ctrl_msgs ? &slot->ctrl_msgs : NULL;
+    msg->num_control_messages = want_ctrl_msgs ? &slot->n_ctrl_msgs : NULL;
+  }
+
+  /* In blocking mode g_socket_receive_messages() only returns once all
+   * requested messages were received. We already waited for the socket to
+   * become readable, so only take what is queued right now */
+  blocking = g_socket_get_blocking (udpsrc->used_socket);
+  if (blocking)
+    g_socket_set_blocking (udpsrc->used_socket, FALSE);
+
+  res = g_socket_receive_messages (udpsrc->used_socket,
+      &udpsrc->batch_msgs[first], batch_size - first, G_SOCKET_MSG_NONE,
+      udpsrc->cancellable, err);
+
+  if (blocking)
+    g_socket_set_blocking (udpsrc->used_socket, TRUE);
+
+  for (i = first; res > 0 && i < first + res; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+
+#ifdef MSG_TRUNC
+    if (udpsrc->batch_msgs[i].flags & MSG_TRUNC)
+      GST_WARNING_OBJECT (udpsrc, "Packet truncated to %" G_GSIZE_FORMAT
+          " bytes, increase the mtu property", slot->vec.size);
+#endif
+
+    if (slot->ctrl_msgs && gst_udpsrc_process_control_messages (udpsrc,
+            slot->buffer, slot->ctrl_msgs, (gint) slot->n_ctrl_msgs)) {
+      GST_DEBUG_OBJECT (udpsrc,
+          "Dropping packet for a different multicast address");
+      slot->drop = TRUE;
+    }
+    slot->ctrl_msgs = NULL;
+    slot->n_ctrl_msgs = 0;
+  }
+
+  return res;
+}
+
+/* In batch mode we receive as many packets as possible with one
+ * g_socket_receive_messages() call (recvmmsg() where available) and push
+ * them downstream in one go as a buffer list */
+static GstFlowReturn
+gst_udpsrc_create (GstPushSrc * psrc, GstBuffer ** buf)
+{
+  GstUDPSrc *udpsrc;
+  GstBufferList *list;
+  GstFlowReturn ret;
+  GError *err = NULL;
+  GstClockTime dts;
+  gboolean want_ctrl_msgs;
+  gint64 deadline;
+  guint batch_size, n_received, i;
+  gint res = 0;
+
+  udpsrc = GST_UDPSRC_CAST (psrc);
+
+  batch_size = udpsrc->batch_size;
+  if (batch_size <= 1)
+    return GST_PUSH_SRC_CLASS (parent_class)->create (psrc, buf);
+
+  want_ctrl_msgs = gst_udpsrc_want_control_messages (udpsrc);
+
+retry:
+  ret = gst_udpsrc_prepare_batch_slots (udpsrc, batch_size);
+  if (ret != GST_FLOW_OK)
+    return ret;
+
+  n_received = 0;
+  deadline = -1;
+  dts = GST_CLOCK_TIME_NONE;
+  while (n_received < batch_size) {
+    gint64 timeout;
+
+    if (n_received == 0) {
+      timeout = udpsrc->timeout ? udpsrc->timeout / 1000 : -1;
+    } else if (deadline == -1) {
+      break;
+    } else {
+      timeout = deadline - g_get_monotonic_time ();
+      if (timeout <= 0)
+        break;
+    }
+
+    GST_LOG_OBJECT (udpsrc, "doing select, timeout %" G_GINT64_FORMAT, timeout);
+
+    if (!g_socket_condition_timed_wait (udpsrc->used_socket, G_IO_IN | G_IO_PRI,
+            timeout, udpsrc->cancellable, &err)) {
+      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY)
+          || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        goto stopped;
+      } else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT)) {
+        g_clear_error (&err);
+        /* out of time for this batch, push what we have */
+        if (n_received > 0)
+          break;
+        /* timeout, post element message */
+        gst_element_post_message (GST_ELEMENT_CAST (udpsrc),
+            gst_message_new_element (GST_OBJECT_CAST (udpsrc),
+                gst_structure_new ("GstUDPSrcTimeout",
+                    "timeout", G_TYPE_UINT64, udpsrc->timeout, NULL)));
+        continue;
+      } else {
+        goto select_error;
+      }
+    }
+
+    res = gst_udpsrc_receive_batch (udpsrc, n_received, batch_size,
+        want_ctrl_msgs, &err);
+
+    if (G_UNLIKELY (res < 0)) {
+      /* See gst_udpsrc_fill() for why these are ignored */
+      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE) ||
+          g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED) ||
+          g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+        g_clear_error (&err);
+        continue;
+      }
+      goto receive_error;
+    }
+
+    if (n_received == 0) {
+      if (udpsrc->batch_timeout > 0)
+        deadline = g_get_monotonic_time () + udpsrc->batch_timeout / 1000;
+
+      /* basesrc only timestamps the first buffer of the list, so timestamp
+       * all of them with the running time of the first packet here */
+      if (gst_base_src_get_do_timestamp (GST_BASE_SRC_CAST (udpsrc))) {
+        GstClock *clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+
+        if (clock) {
+          GstClockTime now = gst_clock_get_time (clock);
+          GstClockTime base_time =
+              gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+
+          if (now > base_time)
+            dts = now - base_time;
+          gst_object_unref (clock);
+        }
+      }
+    }
+
+    n_received += res;
+  }
+
+  GST_LOG_OBJECT (udpsrc, "received batch of %u packets", n_received);
+
+  for (i = 0; i < batch_size; i++)
+    gst_buffer_unmap (udpsrc->batch_slots[i].buffer,
+        &udpsrc->batch_slots[i].map);
+
+  list = gst_buffer_list_new_sized (n_received);
+
+  for (i = 0; i < n_received; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+    gsize size = udpsrc->batch_msgs[i].bytes_received;
+    gsize offset = udpsrc->skip_first_bytes;
+
+    if (slot->drop) {
+      g_clear_object (&slot->addr);
+      continue;
+    }
+
+    if (G_UNLIKELY (offset > 0 && size < offset))
+      goto skip_error;
+
+    gst_buffer_resize (slot->buffer, offset, size - offset);
+
+    if (slot->addr) {
+      gst_buffer_add_net_address_meta (slot->buffer, slot->addr);
+      g_object_unref (slot->addr);
+      slot->addr = NULL;
+    }
+
+    if (!GST_BUFFER_DTS_IS_VALID (slot->buffer))
+      GST_BUFFER_DTS (slot->buffer) = dts;
+
+    gst_buffer_list_add (list, slot->buffer);
+    slot->buffer = NULL;
+  }
+
+  if (gst_buffer_list_length (list) == 0) {
+    gst_buffer_list_unref (list);
+    goto retry;
+  }
+
+  gst_base_src_submit_buffer_list (GST_BASE_SRC_CAST (udpsrc), list);
+  *buf = NULL;
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+select_error:
+  {
+    for (i = 0; i < batch_size; i++)
+      gst_buffer_unmap (udpsrc->batch_slots[i].buffer,
+          &udpsrc->batch_slots[i].map);
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("select error: %s", err->message));
+    g_clear_error (&err);
+    return GST_FLOW_ERROR;
+  }
+stopped:
+  {
+    for (i = 0; i < batch_size; i++)
+      gst_buffer_unmap (udpsrc->batch_slots[i].buffer,
+          &udpsrc->batch_slots[i].map);
+    GST_DEBUG ("stop called");
+    g_clear_error (&err);
+    return GST_FLOW_FLUSHING;
+  }
+receive_error:
+  {
+    for (i = 0; i < batch_size; i++)
+      gst_buffer_unmap (udpsrc->batch_slots[i].buffer,
+          &udpsrc->batch_slots[i].map);
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      g_clear_error (&err);
+      return GST_FLOW_FLUSHING;
+    } else {
+      GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+          ("receive error %d: %s", res, err->message));
+      g_clear_error (&err);
+      return GST_FLOW_ERROR;
+    }
+  }
+skip_error:
+  {
+    for (; i < n_received; i++)
+      g_clear_object (&udpsrc->batch_slots[i].addr);
+    gst_buffer_list_unref (list);
+    GST_ELEMENT_ERROR (udpsrc, STREAM, DECODE, (NULL),
+        ("UDP buffer to small to skip header"));
+    return GST_FLOW_ERROR;
+  }
+}
+
 static gboolean
 gst_udpsrc_set_uri (GstUDPSrc * src, const gchar * uri, GError ** error)
 {
@@ -1374,6 +1776,12 @@ gst_udpsrc_set_property (GObject * object, guint prop_id, const GValue * value,
     case PROP_SOCKET_TIMESTAMP:
       udpsrc->socket_timestamp_mode = g_value_get_enum (value);
       break;
+    case PROP_BATCH_SIZE:
+      udpsrc->batch_size = g_value_get_uint (value);
+      break;
+    case PROP_BATCH_TIMEOUT:
+      udpsrc->batch_timeout = g_value_get_uint64 (value);
+      break;
     default:
       break;
   }
@@ -1440,6 +1848,12 @@ gst_udpsrc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_SOCKET_TIMESTAMP:
       g_value_set_enum (value, udpsrc->socket_timestamp_mode);
       break;
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, udpsrc->batch_size);
+      break;
+    case PROP_BATCH_TIMEOUT:
+      g_value_set_uint64 (value, udpsrc->batch_timeout);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1929,6 +2343,9 @@ gst_udpsrc_change_state (GstElement * element, GstStateChange transition)
     goto failure;
 
   switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_udpsrc_free_batch_slots (src);
+      break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       gst_udpsrc_close (src);
       break;
@@ -59,6 +59,17 @@ typedef enum
   GST_SOCKET_TIMESTAMP_MODE_REALTIME
 } GstSocketTimestampMode;
 
+/* Per-datagram scratch space for batched receiving */
+typedef struct {
+  GstBuffer  *buffer;
+  GstMapInfo  map;
+  GInputVector vec;
+  GSocketAddress *addr;
+  GSocketControlMessage **ctrl_msgs;
+  guint       n_ctrl_msgs;
+  gboolean    drop;
+} GstUDPSrcBatchSlot;
+
 struct _GstUDPSrc {
   GstPushSrc parent;
 
@@ -96,6 +107,13 @@ struct _GstUDPSrc {
   /* Extra memory for buffers with a size superior to max_packet_size */
   GstMemory *extra_mem;
 
+  /* batched receiving, only used if batch_size > 1 */
+  guint      batch_size;
+  guint64    batch_timeout;
+  guint      n_batch_slots;
+  GstUDPSrcBatchSlot *batch_slots;
+  GInputMessage *batch_msgs;
+
   gchar     *uri;
 };
 
@@ -48,6 +48,11 @@
  * properties manually because they will be overridden if the caps change,
  * but nothing stops you from doing so.
  *
+ * When the image is only cropped, without changing the format or the alpha
+ * value, and downstream supports #GstVideoCropMeta and #GstVideoMeta, no
+ * pixels are copied and the crop is only described by a #GstVideoCropMeta on
+ * the input buffer.
+ *
  * Sample pipeline:
  * |[
  * gst-launch-1.0 videotestsrc ! videobox autocrop=true ! \
@@ -2428,6 +2433,10 @@ static gboolean gst_video_box_src_event (GstBaseTransform * trans,
 
 static gboolean gst_video_box_set_info (GstVideoFilter * vfilter, GstCaps * in,
     GstVideoInfo * in_info, GstCaps * out, GstVideoInfo * out_info);
+static gboolean gst_video_box_decide_allocation (GstBaseTransform * trans,
+    GstQuery * query);
+static GstFlowReturn gst_video_box_transform_ip (GstBaseTransform * trans,
+    GstBuffer * buf);
 static GstFlowReturn gst_video_box_transform_frame (GstVideoFilter * vfilter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame);
 
@@ -2522,6 +2531,10 @@ gst_video_box_class_init (GstVideoBoxClass * klass)
   trans_class->transform_caps =
       GST_DEBUG_FUNCPTR (gst_video_box_transform_caps);
   trans_class->src_event = GST_DEBUG_FUNCPTR (gst_video_box_src_event);
+  trans_class->decide_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_box_decide_allocation);
+  trans_class->transform_ip = GST_DEBUG_FUNCPTR (gst_video_box_transform_ip);
+  trans_class->transform_ip_on_passthrough = FALSE;
 
   vfilter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_box_set_info);
   vfilter_class->transform_frame =
@@ -2990,6 +3003,29 @@ bail:
   }
 }
 
+/* whether the output is only a sub-region of the input, with all pixels
+ * unchanged */
+static gboolean
+gst_video_box_is_crop_only (GstVideoBox * video_box)
+{
+  const GstVideoFormatInfo *finfo;
+
+  if (video_box->in_format != video_box->out_format ||
+      video_box->in_sdtv != video_box->out_sdtv)
+    return FALSE;
+
+  if (video_box->box_left < 0 || video_box->box_right < 0 ||
+      video_box->box_top < 0 || video_box->box_bottom < 0)
+    return FALSE;
+
+  finfo = gst_video_format_get_info (video_box->in_format);
+  if (finfo && GST_VIDEO_FORMAT_INFO_HAS_ALPHA (finfo) &&
+      video_box->alpha != 1.0)
+    return FALSE;
+
+  return TRUE;
+}
+
 static gboolean
 gst_video_box_recalc_transform (GstVideoBox * video_box)
 {
@@ -3005,10 +3041,20 @@ gst_video_box_recalc_transform (GstVideoBox * video_box)
     GST_LOG_OBJECT (video_box, "we are using passthrough");
     gst_base_transform_set_passthrough (GST_BASE_TRANSFORM_CAST (video_box),
         TRUE);
+  } else if (video_box->use_crop_meta
+      && gst_video_box_is_crop_only (video_box)) {
+    GST_LOG_OBJECT (video_box, "we are doing in-place transform using crop "
+        "meta");
+    gst_base_transform_set_passthrough (GST_BASE_TRANSFORM_CAST (video_box),
+        FALSE);
+    gst_base_transform_set_in_place (GST_BASE_TRANSFORM_CAST (video_box),
+        TRUE);
   } else {
     GST_LOG_OBJECT (video_box, "we are not using passthrough");
     gst_base_transform_set_passthrough (GST_BASE_TRANSFORM_CAST (video_box),
         FALSE);
+    gst_base_transform_set_in_place (GST_BASE_TRANSFORM_CAST (video_box),
+        FALSE);
   }
   return res;
 }
@@ -3183,6 +3229,22 @@ gst_video_box_set_info (GstVideoFilter * vfilter, GstCaps * in,
   return ret;
 }
 
+static gboolean
+gst_video_box_decide_allocation (GstBaseTransform * trans, GstQuery * query)
+{
+  GstVideoBox *video_box = GST_VIDEO_BOX (trans);
+
+  g_mutex_lock (&video_box->mutex);
+  video_box->use_crop_meta = (gst_query_find_allocation_meta (query,
+          GST_VIDEO_CROP_META_API_TYPE, NULL) &&
+      gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL));
+  gst_video_box_recalc_transform (video_box);
+  g_mutex_unlock (&video_box->mutex);
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->decide_allocation (trans,
+      query);
+}
+
 static gboolean
 gst_video_box_src_event (GstBaseTransform * trans, GstEvent * event)
 {
@@ -3223,7 +3285,10 @@ gst_video_box_process (GstVideoBox * video_box, GstVideoFrame * in,
   guint b_alpha = CLAMP (video_box->border_alpha * 256, 0, 255);
   guint i_alpha = CLAMP (video_box->alpha * 256, 0, 255);
   GstVideoBoxFill fill_type = video_box->fill_type;
-  gint br, bl, bt, bb, crop_w, crop_h;
+  gint br, bl, bt, bb, crop_w, crop_h, in_height;
+
+  /* the frames might only be a slice of the complete frames */
+  in_height = GST_VIDEO_FRAME_HEIGHT (in);
 
   crop_h = 0;
   crop_w = 0;
@@ -3244,13 +3309,13 @@ gst_video_box_process (GstVideoBox * video_box, GstVideoFrame * in,
   }
 
   if (bb >= 0 && bt >= 0) {
-    crop_h = video_box->in_height - (bb + bt);
+    crop_h = in_height - (bb + bt);
   } else if (bb >= 0 && bt < 0) {
-    crop_h = video_box->in_height - (bb);
+    crop_h = in_height - (bb);
   } else if (bb < 0 && bt >= 0) {
-    crop_h = video_box->in_height - (bt);
+    crop_h = in_height - (bt);
   } else if (bb < 0 && bt < 0) {
-    crop_h = video_box->in_height;
+    crop_h = in_height;
   }
 
   GST_DEBUG_OBJECT (video_box, "Borders are: L:%d, R:%d, T:%d, B:%d", bl, br,
@@ -3310,6 +3375,14 @@ gst_video_box_before_transform (GstBaseTransform * trans, GstBuffer * in)
     gst_object_sync_values (GST_OBJECT (video_box), stream_time);
 }
 
+/* called with the mutex held by the streaming thread */
+static void
+gst_video_box_process_slice (GstVideoFilter * vfilter, GstVideoFrame * in,
+    GstVideoFrame * out, gpointer user_data)
+{
+  gst_video_box_process (GST_VIDEO_BOX (vfilter), in, out);
+}
+
 static GstFlowReturn
 gst_video_box_transform_frame (GstVideoFilter * vfilter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame)
@@ -3317,8 +3390,46 @@ gst_video_box_transform_frame (GstVideoFilter * vfilter,
   GstVideoBox *video_box = GST_VIDEO_BOX (vfilter);
 
   g_mutex_lock (&video_box->mutex);
-  gst_video_box_process (video_box, in_frame, out_frame);
+  /* without top and bottom borders every output row only depends on the
+   * same input row */
+  if (video_box->box_top == 0 && video_box->box_bottom == 0)
+    gst_video_filter_process_slices (vfilter, in_frame, out_frame,
+        gst_video_box_process_slice, NULL);
+  else
+    gst_video_box_process (video_box, in_frame, out_frame);
+  g_mutex_unlock (&video_box->mutex);
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_video_box_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
+{
+  GstVideoBox *video_box = GST_VIDEO_BOX (trans);
+  GstVideoFilter *vfilter = GST_VIDEO_FILTER (trans);
+  GstVideoCropMeta *crop_meta;
+
+  GST_LOG_OBJECT (trans, "Transforming in-place");
+
+  /* The video meta is required since the caps width/height are smaller than
+   * the image in the buffer */
+  if (!gst_buffer_get_video_meta (buf)) {
+    gst_buffer_add_video_meta (buf, GST_VIDEO_FRAME_FLAG_NONE,
+        GST_VIDEO_INFO_FORMAT (&vfilter->in_info),
+        GST_VIDEO_INFO_WIDTH (&vfilter->in_info),
+        GST_VIDEO_INFO_HEIGHT (&vfilter->in_info));
+  }
+
+  crop_meta = gst_buffer_get_video_crop_meta (buf);
+  if (!crop_meta)
+    crop_meta = gst_buffer_add_video_crop_meta (buf);
+
+  g_mutex_lock (&video_box->mutex);
+  crop_meta->x += video_box->box_left;
+  crop_meta->y += video_box->box_top;
+  crop_meta->width = video_box->out_width;
+  crop_meta->height = video_box->out_height;
   g_mutex_unlock (&video_box->mutex);
+
   return GST_FLOW_OK;
 }
 
@@ -78,6 +78,9 @@ struct _GstVideoBox
 
   gboolean autocrop;
 
+  /* downstream supports GstVideoCropMeta and GstVideoMeta */
+  gboolean use_crop_meta;
+
   void (*fill) (GstVideoBoxFill fill_type, guint b_alpha, GstVideoFrame *dest, gboolean sdtv);
   void (*copy) (guint i_alpha, GstVideoFrame * dest, gboolean dest_sdtv, gint dest_x, gint dest_y, GstVideoFrame * src, gboolean src_sdtv, gint src_x, gint src_y, gint w, gint h);
 };
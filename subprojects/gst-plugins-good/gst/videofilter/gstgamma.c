@@ -392,6 +392,16 @@ gst_gamma_before_transform (GstBaseTransform * base, GstBuffer * outbuf)
     gst_object_sync_values (GST_OBJECT (gamma), stream_time);
 }
 
+/* called with the object lock held by the streaming thread */
+static void
+gst_gamma_process_slice (GstVideoFilter * vfilter, GstVideoFrame * in_frame,
+    GstVideoFrame * out_frame, gpointer user_data)
+{
+  GstGamma *gamma = GST_GAMMA (vfilter);
+
+  gamma->process (gamma, out_frame);
+}
+
 static GstFlowReturn
 gst_gamma_transform_frame_ip (GstVideoFilter * vfilter, GstVideoFrame * frame)
 {
@@ -401,7 +411,8 @@ gst_gamma_transform_frame_ip (GstVideoFilter * vfilter, GstVideoFrame * frame)
     goto not_negotiated;
 
   GST_OBJECT_LOCK (gamma);
-  gamma->process (gamma, frame);
+  gst_video_filter_process_slices (vfilter, frame, frame,
+      gst_gamma_process_slice, NULL);
   GST_OBJECT_UNLOCK (gamma);
 
   return GST_FLOW_OK;
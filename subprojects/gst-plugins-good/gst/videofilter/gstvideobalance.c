@@ -518,6 +518,16 @@ gst_video_balance_transform_caps (GstBaseTransform * trans,
   return ret;
 }
 
+/* called with the object lock held by the streaming thread */
+static void
+gst_video_balance_process_slice (GstVideoFilter * vfilter, GstVideoFrame * in_frame,
+    GstVideoFrame * out_frame, gpointer user_data)
+{
+  GstVideoBalance *videobalance = GST_VIDEO_BALANCE (vfilter);
+
+  videobalance->process (videobalance, out_frame);
+}
+
 static GstFlowReturn
 gst_video_balance_transform_frame_ip (GstVideoFilter * vfilter,
     GstVideoFrame * frame)
@@ -528,7 +538,8 @@ gst_video_balance_transform_frame_ip (GstVideoFilter * vfilter,
     goto not_negotiated;
 
   GST_OBJECT_LOCK (videobalance);
-  videobalance->process (videobalance, frame);
+  gst_video_filter_process_slices (vfilter, frame, frame,
+      gst_video_balance_process_slice, NULL);
   GST_OBJECT_UNLOCK (videobalance);
 
   return GST_FLOW_OK;
@@ -1168,6 +1168,16 @@ gst_video_flip_before_transform (GstBaseTransform * trans, GstBuffer * in)
     gst_object_sync_values (GST_OBJECT (videoflip), stream_time);
 }
 
+/* called with the object lock held by the streaming thread */
+static void
+gst_video_flip_process_slice (GstVideoFilter * vfilter,
+    GstVideoFrame * in_frame, GstVideoFrame * out_frame, gpointer user_data)
+{
+  GstVideoFlip *videoflip = GST_VIDEO_FLIP (vfilter);
+
+  videoflip->process (videoflip, out_frame, in_frame);
+}
+
 static GstFlowReturn
 gst_video_flip_transform_frame (GstVideoFilter * vfilter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame)
@@ -1195,7 +1205,13 @@ gst_video_flip_transform_frame (GstVideoFilter * vfilter,
       GST_VIDEO_FRAME_WIDTH (out_frame), GST_VIDEO_FRAME_HEIGHT (out_frame));
   g_type_class_unref (enum_class);
 
-  videoflip->process (videoflip, out_frame, in_frame);
+  /* only horizontal flipping maps every output row to the same input row */
+  if (videoflip->active_method == GST_VIDEO_ORIENTATION_HORIZ ||
+      videoflip->active_method == GST_VIDEO_ORIENTATION_IDENTITY)
+    gst_video_filter_process_slices (vfilter, in_frame, out_frame,
+        gst_video_flip_process_slice, NULL);
+  else
+    videoflip->process (videoflip, out_frame, in_frame);
 
   proposed = videoflip->proposed_method;
   active = videoflip->active_method;
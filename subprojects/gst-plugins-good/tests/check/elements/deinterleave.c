@@ -43,6 +43,8 @@ static GstPad *mysrcpad, **mysinkpads;
 static gint nsinkpads;
 static GstBus *bus;
 static GstElement *deinterleave;
+/* memory of the non-interleaved input the output buffers have to share */
+static GstMemory *planar_memory;
 
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
@@ -56,7 +58,7 @@ static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS ("audio/x-raw, "
         "format = (string) " GST_AUDIO_NE (F32) ", "
-        "channels = (int) { 2, 3 }, layout = (string) interleaved, rate = (int) {32000, 48000}"));
+        "channels = (int) { 2, 3 }, layout = (string) {interleaved, non-interleaved}, rate = (int) {32000, 48000}"));
 
 #define CAPS_32khz \
         "audio/x-raw, " \
@@ -99,6 +101,19 @@ deinterleave_chain_func (GstPad * pad, GstObject * parent, GstBuffer * buffer)
     g_assert_not_reached ();
   }
   gst_buffer_unmap (buffer, &map);
+
+  if (planar_memory) {
+    GstMemory *mem;
+    gsize offset = strcmp (GST_PAD_NAME (pad), "sink0") == 0 ? 0 :
+        48000 * sizeof (gfloat);
+
+    /* the plane is shared, not copied */
+    fail_unless_equals_int (gst_buffer_n_memory (buffer), 1);
+    mem = gst_buffer_peek_memory (buffer, 0);
+    fail_unless (mem->parent == planar_memory);
+    fail_unless_equals_int (mem->offset, planar_memory->offset + offset);
+    fail_unless_equals_int (mem->size, 48000 * sizeof (gfloat));
+  }
   gst_buffer_unref (buffer);
 
   return GST_FLOW_OK;
@@ -199,6 +214,78 @@ GST_START_TEST (test_2_channels)
 
 GST_END_TEST;
 
+GST_START_TEST (test_2_channels_non_interleaved)
+{
+  GstPad *sinkpad;
+  gint i;
+  GstBuffer *inbuf;
+  GstCaps *caps;
+  gfloat *indata;
+  GstMapInfo map;
+  GstAudioInfo info;
+
+  mysinkpads = g_new0 (GstPad *, 2);
+  nsinkpads = 0;
+
+  deinterleave = gst_element_factory_make ("deinterleave", NULL);
+  fail_unless (deinterleave != NULL);
+
+  mysrcpad = gst_pad_new_from_static_template (&srctemplate, "src");
+  fail_unless (mysrcpad != NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+
+  gst_audio_info_set_format (&info, GST_AUDIO_FORMAT_F32, 48000, 2, NULL);
+  info.layout = GST_AUDIO_LAYOUT_NON_INTERLEAVED;
+  caps = gst_audio_info_to_caps (&info);
+
+  gst_check_setup_events (mysrcpad, deinterleave, caps, GST_FORMAT_TIME);
+
+  sinkpad = gst_element_get_static_pad (deinterleave, "sink");
+  fail_unless (sinkpad != NULL);
+  fail_unless (gst_pad_link (mysrcpad, sinkpad) == GST_PAD_LINK_OK);
+  g_object_unref (sinkpad);
+
+  g_signal_connect (deinterleave, "pad-added",
+      G_CALLBACK (deinterleave_pad_added), GINT_TO_POINTER (2));
+
+  bus = gst_bus_new ();
+  gst_element_set_bus (deinterleave, bus);
+
+  fail_unless (gst_element_set_state (deinterleave,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+
+  inbuf = gst_buffer_new_and_alloc (2 * 48000 * sizeof (gfloat));
+  gst_buffer_map (inbuf, &map, GST_MAP_WRITE);
+  indata = (gfloat *) map.data;
+  for (i = 0; i < 48000; i++) {
+    indata[i] = -1.0;
+    indata[48000 + i] = 1.0;
+  }
+  gst_buffer_unmap (inbuf, &map);
+  gst_buffer_add_audio_meta (inbuf, &info, 48000, NULL);
+  planar_memory = gst_buffer_peek_memory (inbuf, 0);
+
+  fail_unless (gst_pad_push (mysrcpad, inbuf) == GST_FLOW_OK);
+  fail_unless_equals_int (nsinkpads, 2);
+  planar_memory = NULL;
+
+  fail_unless (gst_element_set_state (deinterleave,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+
+  for (i = 0; i < nsinkpads; i++)
+    g_object_unref (mysinkpads[i]);
+  g_free (mysinkpads);
+  mysinkpads = NULL;
+
+  g_object_unref (deinterleave);
+  gst_bus_set_flushing (bus, TRUE);
+  g_object_unref (bus);
+  gst_caps_unref (caps);
+  gst_object_unref (mysrcpad);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_2_channels_1_linked)
 {
   GstPad *sinkpad;
@@ -647,6 +734,7 @@ deinterleave_suite (void)
   tcase_set_timeout (tc_chain, 180);
   tcase_add_test (tc_chain, test_create_and_unref);
   tcase_add_test (tc_chain, test_2_channels);
+  tcase_add_test (tc_chain, test_2_channels_non_interleaved);
   tcase_add_test (tc_chain, test_2_channels_1_linked);
   tcase_add_test (tc_chain, test_2_channels_caps_change);
   tcase_add_test (tc_chain, test_8_channels_float32);
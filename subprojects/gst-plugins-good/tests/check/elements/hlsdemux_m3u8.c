@@ -686,6 +686,50 @@ GST_START_TEST (test_advance_fragment)
 
 GST_END_TEST;
 
+GST_START_TEST (test_get_fragment_after)
+{
+  GstHLSMediaPlaylist *pl;
+  GstM3U8MediaSegment *current, *mf;
+
+  pl = load_m3u8 (BYTE_RANGES_PLAYLIST);
+
+  current = gst_hls_media_playlist_get_starting_segment (pl);
+  fail_unless (current != NULL);
+  assert_equals_uint64 (current->offset, 100);
+
+  /* Upcoming fragments can be looked up without advancing */
+  mf = gst_hls_media_playlist_get_fragment_after (pl, current, 1, TRUE);
+  fail_unless (mf != NULL);
+  assert_equals_uint64 (mf->offset, 1000);
+  gst_m3u8_media_segment_unref (mf);
+
+  mf = gst_hls_media_playlist_get_fragment_after (pl, current, 3, TRUE);
+  fail_unless (mf != NULL);
+  assert_equals_uint64 (mf->stream_time, 30 * GST_SECOND);
+  assert_equals_uint64 (mf->offset, 3000);
+  gst_m3u8_media_segment_unref (mf);
+
+  /* Past the end of the playlist */
+  mf = gst_hls_media_playlist_get_fragment_after (pl, current, 4, TRUE);
+  fail_unless (mf == NULL);
+
+  /* Backward from the start */
+  mf = gst_hls_media_playlist_get_fragment_after (pl, current, 1, FALSE);
+  fail_unless (mf == NULL);
+  gst_m3u8_media_segment_unref (current);
+
+  /* Backward from the last fragment */
+  current = g_ptr_array_index (pl->segments, 3);
+  mf = gst_hls_media_playlist_get_fragment_after (pl, current, 2, FALSE);
+  fail_unless (mf != NULL);
+  assert_equals_uint64 (mf->offset, 1000);
+  gst_m3u8_media_segment_unref (mf);
+
+  gst_hls_media_playlist_unref (pl);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_get_duration)
 {
   GstHLSMediaPlaylist *pl;
@@ -843,6 +887,107 @@ GST_START_TEST (test_map_tag)
 
 GST_END_TEST;
 
+GST_START_TEST (test_playlist_update_reuses_segments)
+{
+  GstHLSMediaPlaylist *pl, *pl2;
+  GstM3U8MediaSegment *seg;
+  const gchar *update = "#EXTM3U\n\
+#EXT-X-TARGETDURATION:4\n\
+#EXT-X-MEDIA-SEQUENCE:11\n\
+#EXTINF:4,\n\
+seg11.ts\n\
+#EXTINF:4,\n\
+seg12.ts\n\
+#EXTINF:4,\n\
+seg13.ts\n";
+
+  pl = load_m3u8 ("#EXTM3U\n\
+#EXT-X-TARGETDURATION:4\n\
+#EXT-X-MEDIA-SEQUENCE:10\n\
+#EXTINF:4,\n\
+seg10.ts\n\
+#EXTINF:4,\n\
+seg11.ts\n\
+#EXTINF:4,\n\
+seg12.ts\n");
+  assert_equals_int (pl->segments->len, 3);
+
+  pl2 = gst_hls_media_playlist_parse_with_reference (g_strdup (update),
+      "http://localhost/test.m3u8", NULL, pl);
+  fail_unless (pl2 != NULL);
+  assert_equals_int (pl2->segments->len, 3);
+
+  /* Unchanged segments are shared, new ones are created */
+  fail_unless (g_ptr_array_index (pl2->segments, 0) ==
+      g_ptr_array_index (pl->segments, 1));
+  fail_unless (g_ptr_array_index (pl2->segments, 1) ==
+      g_ptr_array_index (pl->segments, 2));
+  seg = g_ptr_array_index (pl2->segments, 2);
+  assert_equals_int64 (seg->sequence, 13);
+  assert_equals_string (seg->uri, "http://localhost/seg13.ts");
+  assert_equals_uint64 (pl2->duration, 12 * GST_SECOND);
+
+  gst_hls_media_playlist_unref (pl);
+  gst_hls_media_playlist_unref (pl2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_playlist_delta_update)
+{
+  GstHLSMediaPlaylist *pl, *pl2;
+  GstM3U8MediaSegment *seg;
+  const gchar *delta = "#EXTM3U\n\
+#EXT-X-TARGETDURATION:4\n\
+#EXT-X-SERVER-CONTROL:CAN-SKIP-UNTIL=24.0\n\
+#EXT-X-MEDIA-SEQUENCE:11\n\
+#EXT-X-SKIP:SKIPPED-SEGMENTS=2\n\
+#EXTINF:4,\n\
+seg13.ts\n";
+
+  pl = load_m3u8 ("#EXTM3U\n\
+#EXT-X-TARGETDURATION:4\n\
+#EXT-X-SERVER-CONTROL:CAN-SKIP-UNTIL=24.0\n\
+#EXT-X-MEDIA-SEQUENCE:10\n\
+#EXTINF:4,\n\
+seg10.ts\n\
+#EXTINF:4,\n\
+seg11.ts\n\
+#EXTINF:4,\n\
+seg12.ts\n");
+  assert_equals_uint64 (pl->skip_boundary, 24 * GST_SECOND);
+
+  /* A delta update can't be used without the playlist it applies to */
+  fail_unless (gst_hls_media_playlist_parse (g_strdup (delta),
+          "http://localhost/test.m3u8", NULL) == NULL);
+
+  pl2 = gst_hls_media_playlist_parse_with_reference (g_strdup (delta),
+      "http://localhost/test.m3u8", NULL, pl);
+  fail_unless (pl2 != NULL);
+  assert_equals_int (pl2->segments->len, 3);
+  fail_unless (g_ptr_array_index (pl2->segments, 0) ==
+      g_ptr_array_index (pl->segments, 1));
+  fail_unless (g_ptr_array_index (pl2->segments, 1) ==
+      g_ptr_array_index (pl->segments, 2));
+  seg = g_ptr_array_index (pl2->segments, 2);
+  assert_equals_int64 (seg->sequence, 13);
+  assert_equals_string (seg->uri, "http://localhost/seg13.ts");
+  gst_hls_media_playlist_unref (pl2);
+  gst_hls_media_playlist_unref (pl);
+
+  /* The skipped segments must be present in the previous playlist */
+  pl = load_m3u8 ("#EXTM3U\n\
+#EXT-X-TARGETDURATION:4\n\
+#EXT-X-MEDIA-SEQUENCE:12\n\
+#EXTINF:4,\n\
+seg12.ts\n");
+  fail_unless (gst_hls_media_playlist_parse_with_reference (g_strdup (delta),
+          "http://localhost/test.m3u8", NULL, pl) == NULL);
+  gst_hls_media_playlist_unref (pl);
+}
+
+GST_END_TEST;
+
 static Suite *
 hlsdemux_suite (void)
 {
@@ -871,12 +1016,15 @@ hlsdemux_suite (void)
   tcase_add_test (tc_m3u8, test_playlist_media_files);
   tcase_add_test (tc_m3u8, test_playlist_byte_range_media_files);
   tcase_add_test (tc_m3u8, test_advance_fragment);
+  tcase_add_test (tc_m3u8, test_get_fragment_after);
   tcase_add_test (tc_m3u8, test_get_duration);
   tcase_add_test (tc_m3u8, test_get_target_duration);
   tcase_add_test (tc_m3u8, test_get_stream_for_bitrate);
   tcase_add_test (tc_m3u8, test_url_with_slash_query_param);
   tcase_add_test (tc_m3u8, test_stream_inf_tag);
   tcase_add_test (tc_m3u8, test_map_tag);
+  tcase_add_test (tc_m3u8, test_playlist_update_reuses_segments);
+  tcase_add_test (tc_m3u8, test_playlist_delta_update);
   return s;
 }
 
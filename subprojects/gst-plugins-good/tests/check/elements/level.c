@@ -24,6 +24,8 @@
  * with newer GLib versions (>= 2.31.0) */
 #define GLIB_DISABLE_DEPRECATION_WARNINGS
 
+#include <math.h>
+
 #include <gst/audio/audio.h>
 #include <gst/check/gstcheck.h>
 
@@ -35,7 +37,7 @@ static GstPad *mysrcpad, *mysinkpad;
 #define LEVEL_CAPS_TEMPLATE_STRING \
   "audio/x-raw, " \
     "format = (string) { "GST_AUDIO_NE(S16)", "GST_AUDIO_NE(F32)" }, " \
-    "layout = (string) interleaved, " \
+    "layout = (string) { interleaved, non-interleaved }, " \
     "rate = (int) [ 1, MAX ], " \
     "channels = (int) [ 1, 8 ]"
 
@@ -56,6 +58,14 @@ static GstPad *mysrcpad, *mysinkpad;
     "channels = (int) 2, "  \
     "channel-mask = (bitmask) 3"
 
+#define LEVEL_F32_PLANAR_CAPS_STRING \
+  "audio/x-raw, " \
+    "format = (string) "GST_AUDIO_NE(F32)", " \
+    "layout = (string) non-interleaved, " \
+    "rate = (int) 48000, " \
+    "channels = (int) 2, "  \
+    "channel-mask = (bitmask) 3"
+
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -140,6 +150,35 @@ create_f32_buffer (gfloat val_l, gfloat val_r)
   return buf;
 }
 
+/* create a planar stereo 48kHz buffer of @frames with a 1kHz sine of
+ * amplitude @amp on both channels, starting at frame @offset */
+static GstBuffer *
+create_f32_planar_sine_buffer (gdouble amp, guint offset, guint frames)
+{
+  GstBuffer *buf = gst_buffer_new_and_alloc (2 * frames * sizeof (gfloat));
+  GstAudioInfo info;
+  GstMapInfo map;
+  guint j;
+  gfloat *data;
+
+  gst_audio_info_set_format (&info, GST_AUDIO_FORMAT_F32, 48000, 2, NULL);
+  info.layout = GST_AUDIO_LAYOUT_NON_INTERLEAVED;
+  gst_buffer_add_audio_meta (buf, &info, frames, NULL);
+
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  data = (gfloat *) map.data;
+  for (j = 0; j < frames; ++j) {
+    data[j] = data[frames + j] =
+        amp * sin (2 * G_PI * 1000 * (offset + j) / 48000.0);
+  }
+  gst_buffer_unmap (buf, &map);
+  GST_BUFFER_TIMESTAMP (buf) =
+      gst_util_uint64_scale_int (offset, GST_SECOND, 48000);
+  GST_BUFFER_DURATION (buf) =
+      gst_util_uint64_scale_int (frames, GST_SECOND, 48000);
+  return buf;
+}
+
 /* tests */
 
 GST_START_TEST (test_ref_counts)
@@ -635,6 +674,126 @@ GST_START_TEST (test_rtp_audio_level_meta)
 
 GST_END_TEST;
 
+GST_START_TEST (test_levels_property)
+{
+  GstElement *level;
+  GstBuffer *inbuffer;
+  GstBus *bus;
+  GstStructure *structure;
+  const GValue *list, *value;
+  GValueArray *arr;
+  gdouble dB;
+  gint i;
+
+  level = setup_level (LEVEL_S16_CAPS_STRING);
+  g_object_set (level, "post-messages", FALSE,
+      "interval", (guint64) GST_SECOND / 10, NULL);
+  gst_element_set_state (level, GST_STATE_PLAYING);
+  bus = gst_bus_new ();
+  gst_element_set_bus (level, bus);
+
+  /* nothing measured yet */
+  g_object_get (level, "levels", &structure, NULL);
+  fail_unless (structure == NULL);
+
+  /* create a fake 0.1 sec buffer with a half-amplitude block signal */
+  inbuffer = create_s16_buffer (16536, 16536);
+  fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+
+  /* no message, but the levels can be read from the property */
+  fail_if (gst_bus_have_pending (bus));
+  g_object_get (level, "levels", &structure, NULL);
+  fail_unless (structure != NULL);
+  fail_unless_equals_string (gst_structure_get_name (structure), "level");
+  fail_unless (gst_structure_has_field (structure, "timestamp"));
+  fail_if (gst_structure_has_field (structure, "integrated-loudness"));
+
+  list = gst_structure_get_value (structure, "rms");
+  arr = g_value_get_boxed (list);
+  fail_unless_equals_int (arr->n_values, 2);
+  for (i = 0; i < 2; ++i) {
+    value = g_value_array_get_nth (arr, i);
+    dB = g_value_get_double (value);
+    /* block wave of half amplitude has -5.94 dB */
+    fail_if (dB < -6.1);
+    fail_if (dB > -5.9);
+  }
+  gst_structure_free (structure);
+
+  /* clean up */
+  gst_element_set_bus (level, NULL);
+  gst_object_unref (bus);
+  gst_element_set_state (level, GST_STATE_NULL);
+  cleanup_level (level);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_loudness)
+{
+  GstElement *level;
+  GstBuffer *inbuffer;
+  GstBus *bus;
+  GstMessage *message;
+  const GstStructure *structure;
+  gdouble momentary, short_term, integrated, rms;
+  const GValue *list;
+  guint offset;
+
+  level = setup_level (LEVEL_F32_PLANAR_CAPS_STRING);
+  g_object_set (level, "post-messages", TRUE, "loudness", TRUE,
+      "interval", (guint64) GST_SECOND, NULL);
+  gst_element_set_state (level, GST_STATE_PLAYING);
+  bus = gst_bus_new ();
+  gst_element_set_bus (level, bus);
+
+  /* 4 seconds of a stereo 1kHz sine at -23 dBFS in 20ms buffers, which
+   * EBU Tech 3341 expects to measure as -23 LUFS */
+  for (offset = 0; offset < 4 * 48000; offset += 960) {
+    inbuffer = create_f32_planar_sine_buffer (pow (10, -23 / 20.0), offset,
+        960);
+    fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  }
+
+  /* skip to the last message */
+  message = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT);
+  fail_unless (message != NULL);
+  while (gst_bus_have_pending (bus)) {
+    gst_message_unref (message);
+    message = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT);
+    fail_unless (message != NULL);
+  }
+  structure = gst_message_get_structure (message);
+
+  fail_unless (gst_structure_get_double (structure, "momentary-loudness",
+          &momentary));
+  fail_unless (gst_structure_get_double (structure, "short-term-loudness",
+          &short_term));
+  fail_unless (gst_structure_get_double (structure, "integrated-loudness",
+          &integrated));
+  GST_DEBUG ("loudness M %f S %f I %f", momentary, short_term, integrated);
+  fail_unless (fabs (momentary + 23.0) < 0.1);
+  fail_unless (fabs (short_term + 23.0) < 0.1);
+  fail_unless (fabs (integrated + 23.0) < 0.1);
+
+  /* the planar input gives the same per channel levels: a sine of amplitude
+   * -23 dBFS has an rms of -26 dBFS */
+  list = gst_structure_get_value (structure, "rms");
+  rms = g_value_get_double (g_value_array_get_nth (g_value_get_boxed (list),
+          1));
+  fail_unless (fabs (rms + 23.0 + 3.01) < 0.1);
+
+  /* clean up */
+  gst_message_unref (message);
+  gst_bus_set_flushing (bus, TRUE);
+  gst_element_set_bus (level, NULL);
+  gst_object_unref (bus);
+  gst_element_set_state (level, GST_STATE_NULL);
+  cleanup_level (level);
+}
+
+GST_END_TEST;
+
 static Suite *
 level_suite (void)
 {
@@ -651,6 +810,8 @@ level_suite (void)
   tcase_add_test (tc_chain, test_message_count);
   tcase_add_test (tc_chain, test_message_timestamps);
   tcase_add_test (tc_chain, test_rtp_audio_level_meta);
+  tcase_add_test (tc_chain, test_levels_property);
+  tcase_add_test (tc_chain, test_loudness);
 
   return s;
 }
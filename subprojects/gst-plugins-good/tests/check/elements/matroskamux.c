@@ -75,12 +75,14 @@ test_ebml_header_with_version (gint version,
 
   inbuffer = gst_harness_create_buffer (h, 1);
   fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h, inbuffer));
-  fail_unless_equals_int (2, gst_harness_buffers_received (h));
 
   outbuffer = gst_harness_pull (h);
   compare_buffer_to_data (outbuffer, data, data_size);
   gst_buffer_unref (outbuffer);
 
+  gst_buffer_unref (gst_harness_pull (h));
+  fail_unless_equals_int (2, gst_harness_buffers_received (h));
+
   gst_harness_teardown (h);
 }
 
@@ -143,9 +145,9 @@ GST_START_TEST (test_vorbis_header)
 
   inbuffer = gst_harness_create_buffer (h, 1);
   fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h, inbuffer));
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
 
-  outbuffer = gst_harness_pull (h);
-  while (outbuffer != NULL) {
+  while (gst_harness_pull_until_eos (h, &outbuffer) && outbuffer) {
     buffer_size = gst_buffer_get_size (outbuffer);
 
     if (!vorbis_header_found && buffer_size >= sizeof (data)) {
@@ -159,8 +161,6 @@ GST_START_TEST (test_vorbis_header)
 
     ASSERT_BUFFER_REFCOUNT (outbuffer, "outbuffer", 1);
     gst_buffer_unref (outbuffer);
-
-    outbuffer = gst_harness_try_pull (h);
   }
 
   fail_unless (vorbis_header_found);
@@ -178,6 +178,7 @@ test_block_group_with_version (gint version,
   GstHarness *h;
   GstBuffer *inbuffer, *outbuffer;
   guint8 data1[] = { 0x42 };
+  gint i;
 
   h = setup_matroskamux_harness (AC3_CAPS_STRING);
   g_object_set (h->element, "version", version, NULL);
@@ -186,14 +187,10 @@ test_block_group_with_version (gint version,
   inbuffer = gst_harness_create_buffer (h, 1);
   GST_BUFFER_TIMESTAMP (inbuffer) = 0;
   fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h, inbuffer));
-  fail_unless_equals_int (5, gst_harness_buffers_received (h));
 
-  outbuffer = gst_harness_pull (h);
-  fail_unless (outbuffer != NULL);
-  while (outbuffer != NULL) {
-    gst_buffer_unref (outbuffer);
-    outbuffer = gst_harness_try_pull (h);
-  }
+  for (i = 0; i < 5; i++)
+    gst_buffer_unref (gst_harness_pull (h));
+  fail_unless_equals_int (5, gst_harness_buffers_received (h));
 
   /* Now push a buffer */
   inbuffer = gst_harness_create_buffer (h, 1);
@@ -238,21 +235,17 @@ GST_START_TEST (test_reset)
 {
   GstHarness *h;
   GstBuffer *inbuffer;
-  GstBuffer *outbuffer;
+  gint i;
 
   h = setup_matroskamux_harness (AC3_CAPS_STRING);
 
   inbuffer = gst_harness_create_buffer (h, 1);
   GST_BUFFER_TIMESTAMP (inbuffer) = 0;
   fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h, inbuffer));
-  fail_unless_equals_int (5, gst_harness_buffers_received (h));
 
-  outbuffer = gst_harness_pull (h);
-  fail_unless (outbuffer != NULL);
-  while (outbuffer != NULL) {
-    gst_buffer_unref (outbuffer);
-    outbuffer = gst_harness_try_pull (h);
-  }
+  for (i = 0; i < 5; i++)
+    gst_buffer_unref (gst_harness_pull (h));
+  fail_unless_equals_int (5, gst_harness_buffers_received (h));
 
   fail_unless_equals_int (GST_STATE_CHANGE_SUCCESS,
       gst_element_set_state (h->element, GST_STATE_NULL));
@@ -263,12 +256,8 @@ GST_START_TEST (test_reset)
   GST_BUFFER_TIMESTAMP (inbuffer) = 0;
   fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h, inbuffer));
 
-  outbuffer = gst_harness_pull (h);
-  fail_unless (outbuffer != NULL);
-  while (outbuffer != NULL) {
-    gst_buffer_unref (outbuffer);
-    outbuffer = gst_harness_try_pull (h);
-  }
+  for (i = 0; i < 5; i++)
+    gst_buffer_unref (gst_harness_pull (h));
 
   gst_harness_teardown (h);
 }
@@ -351,6 +340,39 @@ GST_START_TEST (test_timecodescale)
 
 GST_END_TEST;
 
+GST_START_TEST (test_sparse_subtitle_gap)
+{
+  GstHarness *h, *audio_h, *sub_h;
+  GstBuffer *inbuffer;
+  gint i;
+
+  h = gst_harness_new_with_padnames ("matroskamux", NULL, "src");
+  gst_harness_set_sink_caps_str (h, "video/x-matroska; audio/x-matroska");
+
+  audio_h = gst_harness_new_with_element (h->element, "audio_%u", NULL);
+  gst_harness_set_src_caps_str (audio_h, AC3_CAPS_STRING);
+  sub_h = gst_harness_new_with_element (h->element, "subtitle_%u", NULL);
+  gst_harness_set_src_caps_str (sub_h, "text/x-raw, format=utf8");
+
+  inbuffer = gst_harness_create_buffer (audio_h, 1);
+  GST_BUFFER_TIMESTAMP (inbuffer) = 0;
+  fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (audio_h, inbuffer));
+
+  /* without the gap the muxer would wait for subtitle data */
+  fail_unless (gst_harness_push_event (sub_h,
+          gst_event_new_gap (0, GST_SECOND)));
+
+  /* headers and the audio block */
+  for (i = 0; i < 5; i++)
+    gst_buffer_unref (gst_harness_pull (h));
+
+  gst_harness_teardown (sub_h);
+  gst_harness_teardown (audio_h);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 /* Create a new chapter */
 static GstTocEntry *
 new_chapter (const guint chapter_nb, const gint64 start, const gint64 stop)
@@ -942,12 +964,9 @@ test_toc (gboolean with_edition)
   fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
   ASSERT_MINI_OBJECT_REFCOUNT (test_toc, "test_toc", 1);
 
-  outbuffer = gst_harness_pull (h);
-  fail_unless (outbuffer != NULL);
-
   /* Merge buffers */
   merged_buffer = gst_buffer_new ();
-  while (outbuffer != NULL) {
+  while (gst_harness_pull_until_eos (h, &outbuffer) && outbuffer) {
     if (outbuffer->offset == gst_buffer_get_size (merged_buffer)) {
       gst_buffer_append_memory (merged_buffer,
           gst_buffer_get_all_memory (outbuffer));
@@ -958,8 +977,8 @@ test_toc (gboolean with_edition)
     }
 
     gst_buffer_unref (outbuffer);
-    outbuffer = gst_harness_try_pull (h);
   }
+  fail_unless (gst_buffer_get_size (merged_buffer) > 0);
 
   fail_unless (gst_buffer_map (merged_buffer, &info, GST_MAP_READ));
   index = 0;
@@ -1011,6 +1030,7 @@ matroskamux_suite (void)
   tcase_add_test (tc_chain, test_link_webmmux_webm_sink);
   tcase_add_loop_test (tc_chain, test_timecodescale,
       0, G_N_ELEMENTS (timecodescales));
+  tcase_add_test (tc_chain, test_sparse_subtitle_gap);
 
   tcase_add_test (tc_chain, test_toc_with_edition);
   tcase_add_test (tc_chain, test_toc_without_edition);
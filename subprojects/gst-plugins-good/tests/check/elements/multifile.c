@@ -376,6 +376,63 @@ GST_START_TEST (test_multifilesrc_stop_index)
 
 GST_END_TEST;
 
+GST_START_TEST (test_multifilesrc_prefetch)
+{
+  GstElement *src;
+  GstEvent *event;
+  GstPad *sinkpad;
+  gchar *fn, *data;
+  gsize size;
+  guint64 offset = 0;
+  GList *l;
+
+  src = gst_check_setup_element ("multifilesrc");
+  fail_unless (src != NULL);
+
+  fn = g_build_filename (GST_TEST_FILES_PATH, "image.jpg", NULL);
+  fail_unless (g_file_get_contents (fn, &data, &size, NULL));
+  g_object_set (src, "location", fn, NULL);
+  g_free (fn);
+
+  g_object_set (src, "stop-index", 5, "prefetch", 3, "cache-size",
+      (guint64) size, NULL);
+
+  sinkpad = gst_check_setup_sink_pad_by_name (src, &sinktemplate, "src");
+  fail_unless (sinkpad != NULL);
+  gst_pad_set_active (sinkpad, TRUE);
+
+  gst_element_set_state (src, GST_STATE_PLAYING);
+
+  gst_element_get_state (src, NULL, NULL, -1);
+
+  /* busy-loop for EOS */
+  do {
+    g_usleep (G_USEC_PER_SEC / 10);
+    event = gst_pad_get_sticky_event (sinkpad, GST_EVENT_EOS, 0);
+  } while (event == NULL);
+  gst_event_unref (event);
+
+  fail_unless_equals_int (g_list_length (buffers), 5 + 1);
+  for (l = buffers; l; l = l->next) {
+    GstBuffer *buf = l->data;
+
+    fail_unless_equals_int (gst_buffer_get_size (buf), size);
+    fail_unless (gst_buffer_memcmp (buf, 0, data, size) == 0);
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buf), offset);
+    offset += size;
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET_END (buf), offset);
+  }
+  g_free (data);
+
+  gst_element_set_state (src, GST_STATE_NULL);
+
+  gst_check_drop_buffers ();
+  gst_check_teardown_pad_by_name (src, "src");
+  gst_check_teardown_element (src);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 multifile_suite (void)
@@ -390,6 +447,7 @@ multifile_suite (void)
   tcase_add_test (tc_chain, test_multifilesink_key_unit);
   tcase_add_test (tc_chain, test_multifilesrc);
   tcase_add_test (tc_chain, test_multifilesrc_stop_index);
+  tcase_add_test (tc_chain, test_multifilesrc_prefetch);
 
   return s;
 }
@@ -23,6 +23,7 @@
 #include "qtdemux.h"
 #include <glib/gprintf.h>
 #include <gst/check/gstharness.h>
+#include <gst/base/gstbytewriter.h>
 
 typedef struct
 {
@@ -888,6 +889,219 @@ GST_START_TEST (test_qtdemux_pad_names)
 
 GST_END_TEST;
 
+/* writes the header of an atom and returns its start for qt_atom_end() */
+static guint
+qt_atom_start (GstByteWriter * bw, const gchar * fourcc)
+{
+  guint pos = gst_byte_writer_get_pos (bw);
+
+  gst_byte_writer_put_uint32_be (bw, 0);
+  gst_byte_writer_put_data (bw, (const guint8 *) fourcc, 4);
+
+  return pos;
+}
+
+static void
+qt_atom_end (GstByteWriter * bw, guint pos)
+{
+  guint end = gst_byte_writer_get_pos (bw);
+
+  gst_byte_writer_set_pos (bw, pos);
+  gst_byte_writer_put_uint32_be (bw, end - pos);
+  gst_byte_writer_set_pos (bw, end);
+}
+
+/* builds a file with one video track of @n_samples 1 byte samples, the
+ * samples listed in @syncs (1-based) are keyframes */
+static GstBuffer *
+create_sparse_stss_file (guint32 n_samples, const guint32 * syncs,
+    guint n_syncs)
+{
+  GstByteWriter bw;
+  guint moov, trak, mdia, minf, stbl, atom, stco_offset, i;
+
+  gst_byte_writer_init (&bw);
+
+  atom = qt_atom_start (&bw, "ftyp");
+  gst_byte_writer_put_data (&bw, (const guint8 *) "isom", 4);
+  gst_byte_writer_put_uint32_be (&bw, 0);
+  gst_byte_writer_put_data (&bw, (const guint8 *) "isom", 4);
+  qt_atom_end (&bw, atom);
+
+  moov = qt_atom_start (&bw, "moov");
+
+  atom = qt_atom_start (&bw, "mvhd");
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* version and flags */
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* creation time */
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* modification time */
+  gst_byte_writer_put_uint32_be (&bw, 1000);    /* timescale */
+  gst_byte_writer_put_uint32_be (&bw, n_samples);       /* duration */
+  gst_byte_writer_put_uint32_be (&bw, 0x00010000);      /* rate */
+  gst_byte_writer_put_uint16_be (&bw, 0x0100);  /* volume */
+  gst_byte_writer_fill (&bw, 0, 10);
+  gst_byte_writer_put_uint32_be (&bw, 0x00010000);      /* matrix */
+  gst_byte_writer_fill (&bw, 0, 12);
+  gst_byte_writer_put_uint32_be (&bw, 0x00010000);
+  gst_byte_writer_fill (&bw, 0, 12);
+  gst_byte_writer_put_uint32_be (&bw, 0x40000000);
+  gst_byte_writer_fill (&bw, 0, 24);
+  gst_byte_writer_put_uint32_be (&bw, 2);       /* next track id */
+  qt_atom_end (&bw, atom);
+
+  trak = qt_atom_start (&bw, "trak");
+
+  atom = qt_atom_start (&bw, "tkhd");
+  gst_byte_writer_put_uint32_be (&bw, 7);       /* version and flags */
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* creation time */
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* modification time */
+  gst_byte_writer_put_uint32_be (&bw, 1);       /* track id */
+  gst_byte_writer_put_uint32_be (&bw, 0);
+  gst_byte_writer_put_uint32_be (&bw, n_samples);       /* duration */
+  gst_byte_writer_fill (&bw, 0, 16);
+  gst_byte_writer_put_uint32_be (&bw, 0x00010000);      /* matrix */
+  gst_byte_writer_fill (&bw, 0, 12);
+  gst_byte_writer_put_uint32_be (&bw, 0x00010000);
+  gst_byte_writer_fill (&bw, 0, 12);
+  gst_byte_writer_put_uint32_be (&bw, 0x40000000);
+  gst_byte_writer_put_uint32_be (&bw, 16 << 16);        /* width */
+  gst_byte_writer_put_uint32_be (&bw, 16 << 16);        /* height */
+  qt_atom_end (&bw, atom);
+
+  mdia = qt_atom_start (&bw, "mdia");
+
+  atom = qt_atom_start (&bw, "mdhd");
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* version and flags */
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* creation time */
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* modification time */
+  gst_byte_writer_put_uint32_be (&bw, 1000);    /* timescale */
+  gst_byte_writer_put_uint32_be (&bw, n_samples);       /* duration */
+  gst_byte_writer_put_uint16_be (&bw, 0x55c4);  /* language */
+  gst_byte_writer_put_uint16_be (&bw, 0);
+  qt_atom_end (&bw, atom);
+
+  atom = qt_atom_start (&bw, "hdlr");
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* version and flags */
+  gst_byte_writer_put_uint32_be (&bw, 0);
+  gst_byte_writer_put_data (&bw, (const guint8 *) "vide", 4);
+  gst_byte_writer_fill (&bw, 0, 13);    /* reserved and empty name */
+  qt_atom_end (&bw, atom);
+
+  minf = qt_atom_start (&bw, "minf");
+
+  atom = qt_atom_start (&bw, "vmhd");
+  gst_byte_writer_put_uint32_be (&bw, 1);       /* version and flags */
+  gst_byte_writer_fill (&bw, 0, 8);
+  qt_atom_end (&bw, atom);
+
+  stbl = qt_atom_start (&bw, "stbl");
+
+  atom = qt_atom_start (&bw, "stsd");
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* version and flags */
+  gst_byte_writer_put_uint32_be (&bw, 1);       /* entry count */
+  gst_byte_writer_put_uint32_be (&bw, 86);
+  gst_byte_writer_put_data (&bw, (const guint8 *) "jpeg", 4);
+  gst_byte_writer_fill (&bw, 0, 6);
+  gst_byte_writer_put_uint16_be (&bw, 1);       /* data reference index */
+  gst_byte_writer_fill (&bw, 0, 16);
+  gst_byte_writer_put_uint16_be (&bw, 16);      /* width */
+  gst_byte_writer_put_uint16_be (&bw, 16);      /* height */
+  gst_byte_writer_put_uint32_be (&bw, 0x00480000);      /* resolution */
+  gst_byte_writer_put_uint32_be (&bw, 0x00480000);
+  gst_byte_writer_put_uint32_be (&bw, 0);
+  gst_byte_writer_put_uint16_be (&bw, 1);       /* frame count */
+  gst_byte_writer_fill (&bw, 0, 32);    /* compressor name */
+  gst_byte_writer_put_uint16_be (&bw, 24);      /* depth */
+  gst_byte_writer_put_uint16_be (&bw, 0xffff);  /* no color table */
+  qt_atom_end (&bw, atom);
+
+  atom = qt_atom_start (&bw, "stts");
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* version and flags */
+  gst_byte_writer_put_uint32_be (&bw, 1);       /* entry count */
+  gst_byte_writer_put_uint32_be (&bw, n_samples);
+  gst_byte_writer_put_uint32_be (&bw, 1);       /* sample delta */
+  qt_atom_end (&bw, atom);
+
+  atom = qt_atom_start (&bw, "stss");
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* version and flags */
+  gst_byte_writer_put_uint32_be (&bw, n_syncs);
+  for (i = 0; i < n_syncs; i++)
+    gst_byte_writer_put_uint32_be (&bw, syncs[i]);
+  qt_atom_end (&bw, atom);
+
+  atom = qt_atom_start (&bw, "stsc");
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* version and flags */
+  gst_byte_writer_put_uint32_be (&bw, 1);       /* entry count */
+  gst_byte_writer_put_uint32_be (&bw, 1);       /* first chunk */
+  gst_byte_writer_put_uint32_be (&bw, n_samples);       /* samples per chunk */
+  gst_byte_writer_put_uint32_be (&bw, 1);       /* sample description */
+  qt_atom_end (&bw, atom);
+
+  atom = qt_atom_start (&bw, "stsz");
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* version and flags */
+  gst_byte_writer_put_uint32_be (&bw, 1);       /* sample size */
+  gst_byte_writer_put_uint32_be (&bw, n_samples);
+  qt_atom_end (&bw, atom);
+
+  atom = qt_atom_start (&bw, "stco");
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* version and flags */
+  gst_byte_writer_put_uint32_be (&bw, 1);       /* entry count */
+  stco_offset = gst_byte_writer_get_pos (&bw);
+  gst_byte_writer_put_uint32_be (&bw, 0);       /* filled in below */
+  qt_atom_end (&bw, atom);
+
+  qt_atom_end (&bw, stbl);
+  qt_atom_end (&bw, minf);
+  qt_atom_end (&bw, mdia);
+  qt_atom_end (&bw, trak);
+  qt_atom_end (&bw, moov);
+
+  atom = qt_atom_start (&bw, "mdat");
+  gst_byte_writer_set_pos (&bw, stco_offset);
+  gst_byte_writer_put_uint32_be (&bw, atom + 8);
+  gst_byte_writer_set_pos (&bw, atom + 8);
+  gst_byte_writer_fill (&bw, 0, n_samples);
+  qt_atom_end (&bw, atom);
+
+  return gst_byte_writer_reset_and_get_buffer (&bw);
+}
+
+GST_START_TEST (test_qtdemux_sparse_stss)
+{
+  GstHarness *h;
+  GstBuffer *buf;
+  guint32 syncs[] = { 1, 4097, 8193, 9000, 12000 };
+  guint32 n_samples = 12000, i, j = 0;
+
+  /* The goal of this test is to check that the sync samples of a track are
+   * only marked once the sample table has grown to them. The sample table is
+   * allocated in chunks of 4096 entries as it gets parsed, and the sync
+   * samples are spread over several of those chunks */
+
+  h = gst_harness_new_with_padnames ("qtdemux", "sink", "video_0");
+  gst_harness_set_src_caps_str (h, "video/quicktime");
+
+  buf = create_sparse_stss_file (n_samples, syncs, G_N_ELEMENTS (syncs));
+  fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  fail_unless_equals_int (gst_harness_buffers_received (h), n_samples);
+  for (i = 0; i < n_samples; i++) {
+    gboolean keyframe = (j < G_N_ELEMENTS (syncs) && syncs[j] == i + 1);
+
+    buf = gst_harness_pull (h);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buf), i * GST_MSECOND);
+    fail_unless_equals_int (GST_BUFFER_FLAG_IS_SET (buf,
+            GST_BUFFER_FLAG_DELTA_UNIT), !keyframe);
+    gst_buffer_unref (buf);
+    if (keyframe)
+      j++;
+  }
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 qtdemux_suite (void)
 {
@@ -901,6 +1115,7 @@ qtdemux_suite (void)
   tcase_add_test (tc_chain, test_qtdemux_duplicated_moov);
   tcase_add_test (tc_chain, test_qtdemux_stream_change);
   tcase_add_test (tc_chain, test_qtdemux_pad_names);
+  tcase_add_test (tc_chain, test_qtdemux_sparse_stss);
 
   return s;
 }
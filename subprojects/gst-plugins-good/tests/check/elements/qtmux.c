@@ -757,6 +757,88 @@ GST_START_TEST (test_video_pad_frag_asc_finalise)
 
 GST_END_TEST;
 
+GST_START_TEST (test_audio_pad_frag_chunked)
+{
+  GstElement *qtmux;
+  GstBuffer *inbuffer, *outbuffer;
+  GstCaps *caps;
+  GstSegment segment;
+  GList *l, *next;
+  guint8 data_moof[4] = "moof";
+  guint32 sequence, last_sequence = 0;
+  gint num_moofs = 0, num_chunks = 0, num_fragments = 0, num_markers = 0;
+  int i;
+
+  qtmux = setup_qtmux (&srcaudiotemplate, "audio_%u", FALSE);
+  g_object_set (qtmux, "fragment-duration", 200, NULL);
+  g_object_set (qtmux, "chunk-duration", 80, NULL);
+  fail_unless (gst_element_set_state (qtmux,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+
+  caps = gst_pad_get_pad_template_caps (mysrcpad);
+  gst_pad_set_caps (mysrcpad, caps);
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < 20; i++) {
+    inbuffer = gst_buffer_new_and_alloc (1);
+    gst_buffer_memset (inbuffer, 0, 0, 1);
+    GST_BUFFER_TIMESTAMP (inbuffer) = i * 40 * GST_MSECOND;
+    GST_BUFFER_DURATION (inbuffer) = 40 * GST_MSECOND;
+    fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()) == TRUE);
+
+  wait_for_eos ();
+
+  cleanup_qtmux (qtmux, "audio_%u");
+
+  for (l = buffers; l; l = next) {
+    outbuffer = GST_BUFFER (l->data);
+    next = l->next;
+
+    if (gst_buffer_get_size (outbuffer) > 24 &&
+        gst_buffer_memcmp (outbuffer, 4, data_moof, sizeof (data_moof)) == 0) {
+      num_moofs++;
+      if (GST_BUFFER_FLAG_IS_SET (outbuffer, GST_BUFFER_FLAG_DELTA_UNIT))
+        num_chunks++;
+      else
+        num_fragments++;
+      /* the first moof starts a fragment */
+      fail_unless (num_moofs > 1 || num_fragments == 1);
+
+      /* every moof gets a new sequence number in its mfhd */
+      gst_buffer_extract (outbuffer, 20, &sequence, 4);
+      sequence = GUINT32_FROM_BE (sequence);
+      fail_unless (num_moofs == 1 || sequence > last_sequence);
+      last_sequence = sequence;
+    }
+
+    if (GST_BUFFER_FLAG_IS_SET (outbuffer, GST_BUFFER_FLAG_MARKER)) {
+      num_markers++;
+      /* the end of a chunk is followed by the next chunk, or the index */
+      fail_unless (next == NULL || gst_buffer_memcmp (GST_BUFFER (next->data),
+              4, data_moof, sizeof (data_moof)) == 0
+          || gst_buffer_memcmp (GST_BUFFER (next->data), 4, "mfra", 4) == 0);
+    }
+  }
+
+  /* 800 ms of data in 200 ms fragments split into 80 ms chunks */
+  fail_unless (num_fragments >= 4);
+  fail_unless (num_chunks >= num_fragments);
+  fail_unless_equals_int (num_markers, num_moofs);
+
+  gst_check_drop_buffers ();
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_reuse)
 {
   GstElement *qtmux = setup_qtmux (&srcvideotemplate, "video_%u", TRUE);
@@ -1886,6 +1968,7 @@ qtmux_suite (void)
   tcase_add_test (tc_chain, test_video_pad_frag_asc_streamable);
   tcase_add_test (tc_chain, test_audio_pad_frag_asc_streamable);
   tcase_add_test (tc_chain, test_video_pad_frag_asc_finalise);
+  tcase_add_test (tc_chain, test_audio_pad_frag_chunked);
 
   tcase_add_test (tc_chain, test_average_bitrate);
 
@@ -535,6 +535,101 @@ GST_START_TEST (test_rtph264depay_fu_a)
 
   buffer = gst_harness_pull (h);
   fail_unless (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_MARKER));
+
+  /* the fragments are not copied but reference the RTP packets */
+  fail_unless (gst_buffer_n_memory (buffer) > 1);
+  {
+    const guint8 nal_start[] = { 0x00, 0x00, 0x00, 0x01, 0x65 };
+    gsize offset = sizeof (nal_start);
+
+    fail_unless_equals_int (gst_buffer_get_size (buffer),
+        sizeof (nal_start) + sizeof (rtp_h264_idr_fu_start) +
+        sizeof (rtp_h264_idr_fu_middle) + sizeof (rtp_h264_idr_fu_end) -
+        3 * 14);
+    fail_unless_equals_int (gst_buffer_memcmp (buffer, 0, nal_start,
+            sizeof (nal_start)), 0);
+    fail_unless_equals_int (gst_buffer_memcmp (buffer, offset,
+            rtp_h264_idr_fu_start + 14, sizeof (rtp_h264_idr_fu_start) - 14),
+        0);
+    offset += sizeof (rtp_h264_idr_fu_start) - 14;
+    fail_unless_equals_int (gst_buffer_memcmp (buffer, offset,
+            rtp_h264_idr_fu_middle + 14, sizeof (rtp_h264_idr_fu_middle) - 14),
+        0);
+    offset += sizeof (rtp_h264_idr_fu_middle) - 14;
+    fail_unless_equals_int (gst_buffer_memcmp (buffer, offset,
+            rtp_h264_idr_fu_end + 14, sizeof (rtp_h264_idr_fu_end) - 14), 0);
+  }
+  gst_buffer_unref (buffer);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+#define N_FU_A_FRAGMENTS 40
+#define FU_A_FRAGMENT_SIZE 8
+
+static GstBuffer *
+create_fu_a_packet (guint16 seq, guint8 fu_header, gboolean marker)
+{
+  guint8 *data = g_malloc (12 + 2 + FU_A_FRAGMENT_SIZE);
+
+  /* RTP header */
+  data[0] = 0x80;
+  data[1] = marker ? 0xe0 : 0x60;
+  GST_WRITE_UINT16_BE (data + 2, seq);
+  GST_WRITE_UINT32_BE (data + 4, 0x203b6ecf);
+  GST_WRITE_UINT32_BE (data + 8, 0x6c54218d);
+  /* FU indicator and header of an IDR slice */
+  data[12] = 0x7c;
+  data[13] = fu_header;
+  memset (data + 14, seq & 0xff, FU_A_FRAGMENT_SIZE);
+
+  return gst_buffer_new_wrapped (data, 12 + 2 + FU_A_FRAGMENT_SIZE);
+}
+
+GST_START_TEST (test_rtph264depay_fu_a_many_fragments)
+{
+  GstHarness *h = gst_harness_new ("rtph264depay");
+  const guint8 nal_start[] = { 0x00, 0x00, 0x00, 0x01, 0x65 };
+  GstBuffer *buffer;
+  GstMapInfo map;
+  guint16 seq = 0x5fd2;
+  gint i;
+
+  /* more fragments than a buffer can hold memories, the NAL must still be
+   * complete and in order */
+  gst_harness_set_caps_str (h,
+      "application/x-rtp,media=video,clock-rate=90000,encoding-name=H264",
+      "video/x-h264,alignment=au,stream-format=byte-stream");
+
+  for (i = 0; i < N_FU_A_FRAGMENTS; i++) {
+    guint8 fu_header = 0x05;
+
+    if (i == 0)
+      fu_header |= 0x80;
+    else if (i == N_FU_A_FRAGMENTS - 1)
+      fu_header |= 0x40;
+
+    buffer = create_fu_a_packet (seq + i, fu_header,
+        i == N_FU_A_FRAGMENTS - 1);
+    fail_unless_equals_int (gst_harness_push (h, buffer), GST_FLOW_OK);
+  }
+
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 1);
+  buffer = gst_harness_pull (h);
+  fail_unless (gst_buffer_n_memory (buffer) <= gst_buffer_get_max_memory ());
+
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+  fail_unless_equals_int (map.size,
+      sizeof (nal_start) + N_FU_A_FRAGMENTS * FU_A_FRAGMENT_SIZE);
+  fail_unless_equals_int (memcmp (map.data, nal_start, sizeof (nal_start)),
+      0);
+  for (i = 0; i < N_FU_A_FRAGMENTS * FU_A_FRAGMENT_SIZE; i++) {
+    fail_unless_equals_int (map.data[sizeof (nal_start) + i],
+        (seq + i / FU_A_FRAGMENT_SIZE) & 0xff);
+  }
+  gst_buffer_unmap (buffer, &map);
   gst_buffer_unref (buffer);
 
   gst_harness_teardown (h);
@@ -1468,6 +1563,7 @@ rtph264_suite (void)
   tcase_add_test (tc_chain, test_rtph264depay_marker_to_flag);
   tcase_add_test (tc_chain, test_rtph264depay_stap_a_marker);
   tcase_add_test (tc_chain, test_rtph264depay_fu_a);
+  tcase_add_test (tc_chain, test_rtph264depay_fu_a_many_fragments);
   tcase_add_test (tc_chain, test_rtph264depay_fu_a_missing_start);
 
   tc_chain = tcase_create ("rtph264pay");
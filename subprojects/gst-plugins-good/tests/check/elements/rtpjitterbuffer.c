@@ -298,6 +298,33 @@ GST_START_TEST (test_push_unordered)
 
 GST_END_TEST;
 
+GST_START_TEST (test_push_interleaved)
+{
+  GstElement *jitterbuffer;
+  const guint num_buffers = 8;
+  const guint order[] = { 0, 7, 3, 5, 1, 6, 2, 4 };
+  GstBuffer *buffer;
+  guint i;
+
+  jitterbuffer = setup_jitterbuffer (num_buffers);
+  fail_unless (start_jitterbuffer (jitterbuffer)
+      == GST_STATE_CHANGE_SUCCESS, "could not set to playing");
+
+  /* push buffers so that each one lands somewhere in the middle */
+  for (i = 0; i < G_N_ELEMENTS (order); i++) {
+    buffer = g_list_nth_data (inbuffers, order[i]);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* check the buffer list */
+  check_jitterbuffer_results (num_buffers);
+
+  /* cleanup */
+  cleanup_jitterbuffer (jitterbuffer);
+}
+
+GST_END_TEST;
+
 gboolean is_eos;
 
 static gboolean
@@ -3377,6 +3404,7 @@ rtpjitterbuffer_suite (void)
   tcase_add_test (tc_chain, test_push_forward_seq);
   tcase_add_test (tc_chain, test_push_backward_seq);
   tcase_add_test (tc_chain, test_push_unordered);
+  tcase_add_test (tc_chain, test_push_interleaved);
   tcase_add_test (tc_chain, test_push_eos);
   tcase_add_test (tc_chain, test_basetime);
   tcase_add_test (tc_chain, test_clear_pt_map);
@@ -172,7 +172,7 @@ session_harness_get_last_twcc_stats (SessionHarness * h)
 }
 
 static SessionHarness *
-session_harness_new (void)
+session_harness_new_full (gboolean rtcp_shared_scheduler)
 {
   SessionHarness *h = g_new0 (SessionHarness, 1);
   h->caps = generate_caps ();
@@ -183,6 +183,8 @@ session_harness_new (void)
 
   h->session = gst_element_factory_make ("rtpsession", NULL);
   gst_element_set_clock (h->session, GST_CLOCK_CAST (h->testclock));
+  g_object_set (h->session, "rtcp-shared-scheduler", rtcp_shared_scheduler,
+      NULL);
 
   h->send_rtp_h = gst_harness_new_with_element (h->session,
       "send_rtp_sink", "send_rtp_src");
@@ -207,6 +209,12 @@ session_harness_new (void)
   return h;
 }
 
+static SessionHarness *
+session_harness_new (void)
+{
+  return session_harness_new_full (FALSE);
+}
+
 static void
 session_harness_free (SessionHarness * h)
 {
@@ -419,6 +427,39 @@ GST_START_TEST (test_multiple_ssrc_rr)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtcp_shared_scheduler)
+{
+  SessionHarness *h = session_harness_new_full (TRUE);
+  GstFlowReturn res;
+  GstBuffer *out_buf;
+  GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+  GstRTCPPacket rtcp_packet;
+  gint i;
+
+  for (i = 0; i < 2; i++) {
+    res = session_harness_recv_rtp (h, generate_test_buffer (i, 0xDEADBEEF));
+    fail_unless_equals_int (GST_FLOW_OK, res);
+  }
+
+  /* the timeouts are handled by the shared scheduler, on the system clock */
+  for (i = 0; i < 3; i++) {
+    session_harness_crank_clock (h);
+    out_buf = session_harness_pull_rtcp (h);
+
+    fail_unless (gst_rtcp_buffer_validate (out_buf));
+    gst_rtcp_buffer_map (out_buf, GST_MAP_READ, &rtcp);
+    fail_unless (gst_rtcp_buffer_get_first_packet (&rtcp, &rtcp_packet));
+    fail_unless_equals_int (GST_RTCP_TYPE_RR,
+        gst_rtcp_packet_get_type (&rtcp_packet));
+    gst_rtcp_buffer_unmap (&rtcp);
+    gst_buffer_unref (out_buf);
+  }
+
+  session_harness_free (h);
+}
+
+GST_END_TEST;
+
 /* This verifies that rtpsession will correctly place RBs round-robin
  * across multiple RRs when there are too many senders that their RBs
  * do not fit in one RR */
@@ -4285,6 +4326,7 @@ rtpsession_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_multiple_ssrc_rr);
+  tcase_add_test (tc_chain, test_rtcp_shared_scheduler);
   tcase_add_test (tc_chain, test_multiple_senders_roundrobin_rbs);
   tcase_add_test (tc_chain, test_no_rbs_for_internal_senders);
   tcase_add_test (tc_chain, test_internal_sources_timeout);
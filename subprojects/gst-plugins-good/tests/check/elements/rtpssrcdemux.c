@@ -325,6 +325,55 @@ GST_START_TEST (test_rtpssrcdemux_rtcp_app)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtpssrcdemux_buffer_list)
+{
+  GstHarness *h = gst_harness_new_with_padnames ("rtpssrcdemux", "sink", NULL);
+  guint8 bad_pkt[] = {
+    0x01, 0x02, 0x03
+  };
+  GstBufferList *list;
+  GSList *src_h = NULL, *walk;
+  guint i;
+
+  gst_harness_set_src_caps_str (h, "application/x-rtp");
+  g_signal_connect (h->element,
+      "new-ssrc-pad", (GCallback) new_ssrc_pad_found, &src_h);
+  gst_harness_play (h);
+
+  /* interleave two SSRCs and an invalid packet in one list */
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 4; i++)
+    gst_buffer_list_add (list, create_buffer (i, 1 + (i % 2)));
+  gst_buffer_list_insert (list, 2, gst_buffer_new_wrapped_full (0, bad_pkt,
+          sizeof bad_pkt, 0, sizeof bad_pkt, NULL, NULL));
+
+  fail_unless_equals_int (GST_FLOW_OK, gst_harness_push_list (h, list));
+
+  fail_unless_equals_int (g_slist_length (src_h), 2);
+  for (walk = src_h; walk; walk = walk->next) {
+    GstHarness *src = walk->data;
+    guint16 prev_seq = 0;
+
+    fail_unless_equals_int (gst_harness_buffers_received (src), 2);
+    for (i = 0; i < 2; i++) {
+      GstBuffer *buf = gst_harness_pull (src);
+      GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+
+      fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp));
+      if (i > 0)
+        fail_unless_equals_int (gst_rtp_buffer_get_seq (&rtp), prev_seq + 2);
+      prev_seq = gst_rtp_buffer_get_seq (&rtp);
+      gst_rtp_buffer_unmap (&rtp);
+      gst_buffer_unref (buf);
+    }
+  }
+
+  g_slist_free_full (src_h, (GDestroyNotify) gst_harness_teardown);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtpssrcdemux_invalid_rtp)
 {
   GstHarness *h = gst_harness_new_with_padnames ("rtpssrcdemux", "sink", NULL);
@@ -464,6 +513,7 @@ rtpssrcdemux_suite (void)
   tcase_add_test (tc_chain, test_oob_event_locking);
   tcase_add_test (tc_chain, test_rtpssrcdemux_max_streams);
   tcase_add_test (tc_chain, test_rtpssrcdemux_rtcp_app);
+  tcase_add_test (tc_chain, test_rtpssrcdemux_buffer_list);
   tcase_add_test (tc_chain, test_rtpssrcdemux_invalid_rtp);
   tcase_add_test (tc_chain, test_rtpssrcdemux_invalid_rtcp);
   tcase_add_test (tc_chain, test_rtp_and_rtcp_arrives_simultaneously);
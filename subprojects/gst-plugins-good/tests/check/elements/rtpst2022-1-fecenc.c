@@ -212,6 +212,50 @@ GST_START_TEST (test_columns)
 
 GST_END_TEST;
 
+/* Large enough to go through the vectorized XOR path as well as its tail */
+#define LIST_PAYLOAD_LEN 1317
+
+GST_START_TEST (test_row_buffer_list)
+{
+  GstHarness *h, *h_fec_1;
+  GstBufferList *list;
+  guint8 payloads[6][LIST_PAYLOAD_LEN];
+  guint8 expected[LIST_PAYLOAD_LEN];
+  guint i, j;
+  GstElement *enc = gst_element_factory_make ("rtpst2022-1-fecenc", NULL);
+
+  g_object_set (enc, "columns", 3, "enable-column-fec", FALSE, NULL);
+  h = gst_harness_new_with_element (enc, "sink", "src");
+  h_fec_1 = gst_harness_new_with_element (h->element, NULL, "fec_1");
+
+  gst_harness_set_src_caps_str (h, "application/x-rtp");
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 6; i++) {
+    for (j = 0; j < LIST_PAYLOAD_LEN; j++)
+      payloads[i][j] = (i * 31 + j * 7) & 0xff;
+    gst_buffer_list_add (list, make_media_sample (i, 0, payloads[i],
+            LIST_PAYLOAD_LEN));
+  }
+
+  fail_unless_equals_int (gst_harness_push_list (h, list), GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 6);
+
+  for (i = 0; i < 2; i++) {
+    for (j = 0; j < LIST_PAYLOAD_LEN; j++)
+      expected[j] = payloads[i * 3][j] ^ payloads[i * 3 + 1][j] ^
+          payloads[i * 3 + 2][j];
+    pull_and_check (h_fec_1, 2 - i, i * 3, LIST_PAYLOAD_LEN, 33, 0, TRUE, 1,
+        3, expected, LIST_PAYLOAD_LEN);
+  }
+
+  gst_object_unref (enc);
+  gst_harness_teardown (h);
+  gst_harness_teardown (h_fec_1);
+}
+
+GST_END_TEST;
+
 static Suite *
 st2022_1_dec_suite (void)
 {
@@ -222,6 +266,7 @@ st2022_1_dec_suite (void)
 
   tcase_add_test (tc_chain, test_row);
   tcase_add_test (tc_chain, test_columns);
+  tcase_add_test (tc_chain, test_row_buffer_list);
 
   return s;
 }
@@ -305,6 +305,84 @@ GST_START_TEST (test_timer_queue_timer_offset)
 
 GST_END_TEST;
 
+GST_START_TEST (test_timer_queue_reschedule_from_no_timeout)
+{
+  RtpTimerQueue *queue = rtp_timer_queue_new ();
+  RtpTimer *timer, *next, *prev;
+
+  rtp_timer_queue_set_deadline (queue, 0, -1, 0);
+  rtp_timer_queue_set_deadline (queue, 1, -1, 0);
+  rtp_timer_queue_set_deadline (queue, 2, -1, 0);
+  rtp_timer_queue_set_deadline (queue, 3, 1 * GST_SECOND, 0);
+
+  /* a timer between two timers without timeout must still move */
+  timer = rtp_timer_queue_find (queue, 1);
+  fail_if (timer == NULL);
+  rtp_timer_queue_set_deadline (queue, 1, 2 * GST_SECOND, 0);
+  next = (RtpTimer *) timer->list.next;
+  prev = (RtpTimer *) timer->list.prev;
+  fail_if (prev == NULL);
+  fail_unless (next == NULL);
+  fail_unless_equals_int (3, prev->seqnum);
+
+  g_object_unref (queue);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_timer_queue_many_timers)
+{
+  RtpTimerQueue *queue = rtp_timer_queue_new ();
+  GRand *rand = g_rand_new_with_seed (42);
+  RtpTimer *timer, *prev;
+  guint i, len;
+
+  /* spread the timers over all levels of the wheels */
+  for (i = 0; i < 20000; i++) {
+    guint16 seqnum = g_rand_int_range (rand, 0, 2000);
+    GstClockTime timeout = g_rand_int_range (rand, 0, 60000) * GST_MSECOND +
+        g_rand_int_range (rand, 0, 4) * 250 * GST_USECOND;
+
+    switch (g_rand_int_range (rand, 0, 4)) {
+      case 0:
+        timer = rtp_timer_queue_find (queue, seqnum);
+        if (timer) {
+          rtp_timer_queue_unschedule (queue, timer);
+          rtp_timer_free (timer);
+        }
+        break;
+      case 1:
+        timer = rtp_timer_queue_pop_until (queue, timeout);
+        if (timer)
+          rtp_timer_free (timer);
+        break;
+      default:
+        rtp_timer_queue_set_expected (queue, seqnum, timeout, 0, 0);
+        break;
+    }
+  }
+
+  len = 0;
+  prev = NULL;
+  for (timer = rtp_timer_queue_peek_earliest (queue); timer;
+      timer = rtp_timer_get_next (timer)) {
+    if (prev) {
+      fail_unless (prev->timeout <= timer->timeout);
+      if (prev->timeout == timer->timeout)
+        fail_unless (prev->seqnum < timer->seqnum);
+    }
+    fail_unless (rtp_timer_queue_find (queue, timer->seqnum) == timer);
+    prev = timer;
+    len++;
+  }
+  fail_unless_equals_int (len, rtp_timer_queue_length (queue));
+
+  g_rand_free (rand);
+  g_object_unref (queue);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtptimerqueue_suite (void)
 {
@@ -319,6 +397,8 @@ rtptimerqueue_suite (void)
   tcase_add_test (tc_chain, test_timer_queue_update_timer_seqnum);
   tcase_add_test (tc_chain, test_timer_queue_dup_timer);
   tcase_add_test (tc_chain, test_timer_queue_timer_offset);
+  tcase_add_test (tc_chain, test_timer_queue_reschedule_from_no_timeout);
+  tcase_add_test (tc_chain, test_timer_queue_many_timers);
 
   return s;
 }
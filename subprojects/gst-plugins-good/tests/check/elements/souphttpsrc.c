@@ -400,6 +400,80 @@ GST_START_TEST (test_bad_password_digest_auth)
 
 GST_END_TEST;
 
+static GObject *
+start_pooled_pipeline (GstElement * pipe, const gchar * url)
+{
+  GstElement *src, *sink;
+  GstMessage *msg;
+  const GstStructure *s;
+  GstContext *context;
+  GObject *session;
+
+  src = gst_element_factory_make ("souphttpsrc", NULL);
+  fail_unless (src != NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  fail_unless (sink != NULL);
+
+  gst_bin_add_many (GST_BIN (pipe), src, sink, NULL);
+  fail_unless (gst_element_link (src, sink));
+  g_object_set (src, "location", url, "pooled-session", TRUE, NULL);
+
+  gst_element_set_state (pipe, GST_STATE_PAUSED);
+
+  /* The session gets advertised when the element starts */
+  msg = gst_bus_poll (GST_ELEMENT_BUS (pipe), GST_MESSAGE_HAVE_CONTEXT, -1);
+  gst_message_parse_have_context (msg, &context);
+  fail_unless_equals_string (gst_context_get_context_type (context),
+      "gst.soup.session");
+  s = gst_context_get_structure (context);
+  session = g_value_get_object (gst_structure_get_value (s, "session"));
+  fail_unless (session != NULL);
+  gst_context_unref (context);
+  gst_message_unref (msg);
+
+  return session;
+}
+
+GST_START_TEST (test_pooled_session)
+{
+  GstElement *pipe1, *pipe2;
+  GObject *session1, *session2;
+  SoupServer *server;
+  gchar *url;
+
+  server = run_server (FALSE);
+  if (server == NULL) {
+    g_print ("Failed to start up HTTP server");
+    return;
+  }
+
+  url = g_strdup_printf ("http://127.0.0.1:%u/",
+      get_port_from_server (server));
+
+  /* Elements of unrelated pipelines share the same session */
+  pipe1 = gst_pipeline_new (NULL);
+  session1 = start_pooled_pipeline (pipe1, url);
+  pipe2 = gst_pipeline_new (NULL);
+  session2 = start_pooled_pipeline (pipe2, url);
+  fail_unless (session1 == session2);
+
+  gst_element_set_state (pipe1, GST_STATE_NULL);
+  gst_element_set_state (pipe2, GST_STATE_NULL);
+  gst_object_unref (pipe1);
+  gst_object_unref (pipe2);
+
+  /* and it is kept around for the next users */
+  pipe1 = gst_pipeline_new (NULL);
+  fail_unless (start_pooled_pipeline (pipe1, url) == session1);
+  gst_element_set_state (pipe1, GST_STATE_NULL);
+  gst_object_unref (pipe1);
+
+  g_free (url);
+  gst_object_unref (server);
+}
+
+GST_END_TEST;
+
 static gboolean icy_caps = FALSE;
 
 static void
@@ -507,6 +581,7 @@ souphttpsrc_suite (void)
   tcase_add_test (tc_chain, test_bad_user_digest_auth);
   tcase_add_test (tc_chain, test_bad_password_digest_auth);
   tcase_add_test (tc_chain, test_https);
+  tcase_add_test (tc_chain, test_pooled_session);
 
   suite_add_tcase (s, tc_internet);
   tcase_set_timeout (tc_internet, 250);
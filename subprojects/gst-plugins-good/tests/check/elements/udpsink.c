@@ -239,6 +239,151 @@ GST_START_TEST (test_udpsink_dscp)
 
 GST_END_TEST;
 
+GST_START_TEST (test_udpsink_txtime_pacing)
+{
+  GstElement *udpsink;
+  GstPad *srcpad;
+  GSocket *socket;
+  GSocketAddress *addr;
+  GInetAddress *inet_addr;
+  GstClock *clock;
+  GstSegment segment;
+  GstBufferList *list;
+  GError *error = NULL;
+  guint data_size, received = 0;
+  gchar buf[RTP_HEADER_SIZE + RTP_PAYLOAD_SIZE];
+  guint16 port;
+  guint i;
+
+  socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM,
+      G_SOCKET_PROTOCOL_UDP, &error);
+  fail_unless (socket != NULL && error == NULL);
+  inet_addr = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  addr = g_inet_socket_address_new (inet_addr, 0);
+  fail_unless (g_socket_bind (socket, addr, FALSE, &error));
+  g_object_unref (addr);
+  g_object_unref (inet_addr);
+  addr = g_socket_get_local_address (socket, &error);
+  port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (addr));
+  g_object_unref (addr);
+  g_socket_set_timeout (socket, 5);
+
+  list = create_buffer_list (&data_size);
+  for (i = 0; i < gst_buffer_list_length (list); i++)
+    GST_BUFFER_PTS (gst_buffer_list_get (list, i)) = 0;
+
+  udpsink = gst_check_setup_element ("udpsink");
+  g_object_set (udpsink, "host", "127.0.0.1", "port", port,
+      "txtime-pacing", TRUE, "txtime-packet-spread", 1000 * GST_USECOND,
+      "sync", FALSE, NULL);
+  srcpad = gst_check_setup_src_pad_by_name (udpsink, &srctemplate, "sink");
+
+  /* schedule the packets slightly in the future. Without the necessary
+   * permissions the packets are sent right away. */
+  clock = gst_system_clock_obtain ();
+  gst_element_set_clock (udpsink, clock);
+  gst_element_set_base_time (udpsink,
+      gst_clock_get_time (clock) + 10 * GST_MSECOND);
+  gst_element_set_start_time (udpsink, GST_CLOCK_TIME_NONE);
+
+  gst_element_set_state (udpsink, GST_STATE_PLAYING);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("hey there!"));
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  fail_unless_equals_int (gst_pad_push_list (srcpad, list), GST_FLOW_OK);
+
+  while (received < data_size) {
+    gssize ret = g_socket_receive (socket, buf, sizeof (buf), NULL, &error);
+
+    fail_unless (ret > 0, "failed to receive: %s",
+        error ? error->message : "no data");
+    received += ret;
+  }
+  fail_unless_equals_int (received, data_size);
+
+  gst_check_teardown_pad_by_name (udpsink, "sink");
+  gst_check_teardown_element (udpsink);
+  gst_object_unref (clock);
+  g_object_unref (socket);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_udpsink_gso)
+{
+  GstElement *udpsink;
+  GstPad *srcpad;
+  GSocket *socket;
+  GSocketAddress *addr;
+  GInetAddress *inet_addr;
+  GstSegment segment;
+  GstBufferList *list;
+  GError *error = NULL;
+  gchar buf[RTP_HEADER_SIZE + RTP_PAYLOAD_SIZE];
+  guint16 port;
+  guint i;
+
+  socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM,
+      G_SOCKET_PROTOCOL_UDP, &error);
+  fail_unless (socket != NULL && error == NULL);
+  inet_addr = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  addr = g_inet_socket_address_new (inet_addr, 0);
+  fail_unless (g_socket_bind (socket, addr, FALSE, &error));
+  g_object_unref (addr);
+  g_object_unref (inet_addr);
+  addr = g_socket_get_local_address (socket, &error);
+  port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (addr));
+  g_object_unref (addr);
+  g_socket_set_timeout (socket, 5);
+
+  /* a run of equally sized packets that ends with a shorter one, followed
+   * by a packet that starts a new run */
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 4; i++)
+    gst_buffer_list_add (list,
+        gst_buffer_new_allocate (NULL, RTP_HEADER_SIZE + RTP_PAYLOAD_SIZE,
+            NULL));
+  gst_buffer_list_add (list, gst_buffer_new_allocate (NULL, 100, NULL));
+  gst_buffer_list_add (list, gst_buffer_new_allocate (NULL, 200, NULL));
+
+  udpsink = gst_check_setup_element ("udpsink");
+  g_object_set (udpsink, "host", "127.0.0.1", "port", port, "gso", TRUE,
+      NULL);
+  srcpad = gst_check_setup_src_pad_by_name (udpsink, &srctemplate, "sink");
+
+  gst_element_set_state (udpsink, GST_STATE_PLAYING);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("hey there!"));
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  fail_unless_equals_int (gst_pad_push_list (srcpad, list), GST_FLOW_OK);
+
+  /* the receiver still sees every packet on its own */
+  for (i = 0; i < 6; i++) {
+    gssize ret = g_socket_receive (socket, buf, sizeof (buf), NULL, &error);
+
+    fail_unless (ret > 0, "failed to receive: %s",
+        error ? error->message : "no data");
+    if (i < 4)
+      fail_unless_equals_int (ret, RTP_HEADER_SIZE + RTP_PAYLOAD_SIZE);
+    else
+      fail_unless_equals_int (ret, (i - 3) * 100);
+  }
+
+  gst_check_teardown_pad_by_name (udpsink, "sink");
+  gst_check_teardown_element (udpsink);
+  g_object_unref (socket);
+}
+
+GST_END_TEST;
+
 static Suite *
 udpsink_suite (void)
 {
@@ -251,6 +396,8 @@ udpsink_suite (void)
   tcase_add_test (tc_chain, test_udpsink_bufferlist);
   tcase_add_test (tc_chain, test_udpsink_client_add_remove);
   tcase_add_test (tc_chain, test_udpsink_dscp);
+  tcase_add_test (tc_chain, test_udpsink_txtime_pacing);
+  tcase_add_test (tc_chain, test_udpsink_gso);
 
   return s;
 }
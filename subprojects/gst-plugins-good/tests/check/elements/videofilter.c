@@ -24,6 +24,7 @@
 
 #include <gst/video/video.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 
 gboolean have_eos = FALSE;
 
@@ -239,6 +240,49 @@ GST_START_TEST (test_videoflip)
 
 GST_END_TEST;
 
+/* large enough for the frame to be processed in several slices */
+GST_START_TEST (test_videoflip_horizontal_slices)
+{
+  GstHarness *h;
+  GstBuffer *buf;
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  guint8 *data;
+  gint x, y, stride;
+
+  h = gst_harness_new_parse ("videoflip method=horizontal-flip");
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw,format=I420,width=320,height=240,framerate=25/1");
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 320, 240);
+  buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+  gst_buffer_memset (buf, 0, 0x80, GST_VIDEO_INFO_SIZE (&info));
+
+  fail_unless (gst_video_frame_map (&frame, &info, buf, GST_MAP_WRITE));
+  data = GST_VIDEO_FRAME_PLANE_DATA (&frame, 0);
+  stride = GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0);
+  for (y = 0; y < 240; y++)
+    for (x = 0; x < 320; x++)
+      data[y * stride + x] = (x + y) & 0xff;
+  gst_video_frame_unmap (&frame);
+
+  buf = gst_harness_push_and_pull (h, buf);
+  fail_unless (buf != NULL);
+
+  fail_unless (gst_video_frame_map (&frame, &info, buf, GST_MAP_READ));
+  data = GST_VIDEO_FRAME_PLANE_DATA (&frame, 0);
+  stride = GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0);
+  for (y = 0; y < 240; y++)
+    for (x = 0; x < 320; x++)
+      fail_unless_equals_int (data[y * stride + x], (319 - x + y) & 0xff);
+  gst_video_frame_unmap (&frame);
+
+  gst_buffer_unref (buf);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_gamma)
 {
   check_filter ("gamma", 2, NULL);
@@ -257,6 +301,7 @@ videofilter_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_videobalance);
   tcase_add_test (tc_chain, test_videoflip);
+  tcase_add_test (tc_chain, test_videoflip_horizontal_slices);
   tcase_add_test (tc_chain, test_gamma);
 
   return s;
@@ -197,6 +197,39 @@ class Pad(Gst.Pad):
             raise LinkError(ret)
         return ret
 
+    def add_batch_probe(self, interval, callback, max_samples=100):
+        """
+        Collects the buffers flowing through the pad and calls
+        `callback(pad, samples)` from the streaming thread with the list of
+        Gst.Sample collected since the previous call, at most once every
+        `interval` nanoseconds. Python is not entered for the other buffers.
+
+        The samples keep their buffers alive until the callback returns, so
+        buffers from a pool are not released for reuse in the meantime. The
+        callback is called earlier once `max_samples` buffers are collected,
+        on EOS, and when the probe is removed with `Gst.Pad.remove_probe()`.
+
+        Returns the probe id, to be used with `Gst.Pad.remove_probe()`.
+        """
+        return _gi_gst.pad_add_batch_probe(self, interval, callback,
+                                           max_samples)
+
+    def add_stats_probe(self, interval, callback):
+        """
+        Counts the buffers flowing through the pad and calls
+        `callback(pad, stats)` from the streaming thread at most once every
+        `interval` nanoseconds. `stats` is a dict with the number of
+        `buffers` and `bytes` since the previous call, the `duration` that
+        covers and the `last-pts` seen. The callback is also called on EOS
+        and when the probe is removed with `Gst.Pad.remove_probe()`.
+
+        Returns the probe id, to be used with `Gst.Pad.remove_probe()`.
+        """
+        return _gi_gst.pad_add_stats_probe(self, interval, callback)
+
+    def remove_probe(self, id):
+        _gi_gst.pad_remove_interval_probe(self, id)
+
 Pad = override(Pad)
 __all__.append('Pad')
 
@@ -14,3 +14,71 @@ def __video_info_from_caps(*args):
 
 
 GstVideo.VideoInfo.from_caps = __video_info_from_caps
+
+
+class VideoFrameMapInfo:
+    """
+    A video frame mapped with GstVideo.VideoFrame.map_planes().
+
+    `planes` holds one memoryview per plane pointing into the mapped memory of
+    the buffer, without copying it, and `strides` the stride of each plane.
+    The views are writable if the frame was mapped with Gst.MapFlags.WRITE.
+
+    The views are released when the frame is unmapped and can't be used
+    anymore afterwards. Anything still exporting them at that point (e.g. a
+    NumPy array created from a plane) makes unmapping fail.
+    """
+
+    def __init__(self, info, buffer, mapinfo, offsets, strides):
+        self.info = info
+        self.buffer = buffer
+        self.strides = list(strides)
+        self.planes = []
+        self.__mapinfo = mapinfo
+
+        # A plane extends up to the start of the next one in memory
+        ends = sorted(set(offsets + [mapinfo.size]))
+        for offset in offsets:
+            end = next((e for e in ends if e > offset), mapinfo.size)
+            self.planes.append(mapinfo.data[offset:end])
+
+    def unmap(self):
+        if self.__mapinfo is None:
+            return True
+
+        for plane in self.planes:
+            plane.release()
+        self.planes = []
+
+        mapinfo, self.__mapinfo = self.__mapinfo, None
+        return self.buffer.unmap(mapinfo)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, type, value, tb):
+        if not self.unmap():
+            raise Gst.MapError('MappingError', 'Unmapping was not successful')
+
+
+__all__.append('VideoFrameMapInfo')
+
+
+def __video_frame_map_planes(info, buffer, flags):
+    meta = GstVideo.buffer_get_video_meta(buffer)
+    if meta is not None:
+        offsets = list(meta.offset[:meta.n_planes])
+        strides = meta.stride[:meta.n_planes]
+    else:
+        n_planes = info.finfo.n_planes
+        offsets = list(info.offset[:n_planes])
+        strides = info.stride[:n_planes]
+
+    mapinfo = buffer.map(flags)
+    if mapinfo.__parent__ is None:
+        return None
+
+    return VideoFrameMapInfo(info, buffer, mapinfo, offsets, strides)
+
+
+GstVideo.VideoFrame.map_planes = staticmethod(__video_frame_map_planes)
@@ -1073,6 +1073,344 @@ _gst_buffer_override_unmap (PyObject * self, PyObject * args)
   return success;
 }
 
+/* Buffer probe that only calls into Python once per interval, with either
+ * all buffers seen since the last call (as samples) or statistics about
+ * them, so that the GIL is not taken for every single buffer. Pending data
+ * is also handed over on EOS, when a batch is full and when the probe is
+ * removed with pad_remove_interval_probe() */
+typedef struct
+{
+  gint refcount;
+  GMutex lock;
+  PyObject *callback;
+  GstClockTime interval;
+  gint64 last_call;             /* monotonic time, in microseconds */
+  gboolean removed;
+
+  /* for looking up the probe on removal, with interval_probes_lock */
+  GstPad *pad;
+  gulong id;
+  gboolean freed;
+
+  /* batch probes only */
+  GPtrArray *samples;
+  guint max_samples;
+
+  /* stats probes only */
+  guint64 buffers;
+  guint64 bytes;
+  GstClockTime last_pts;
+} PyGstIntervalProbe;
+
+/* default maximum number of samples retained by a batch probe */
+#define DEFAULT_MAX_BATCH_SAMPLES 100
+
+/* interval probes of a pad by id, as qdata of the pad */
+static GMutex interval_probes_lock;
+#define INTERVAL_PROBES_QUARK \
+    g_quark_from_static_string ("gst-python-interval-probes")
+
+static PyGstIntervalProbe *
+py_interval_probe_ref (PyGstIntervalProbe * probe)
+{
+  g_atomic_int_inc (&probe->refcount);
+
+  return probe;
+}
+
+static void
+py_interval_probe_unref (PyGstIntervalProbe * probe)
+{
+  PyGILState_STATE state;
+
+  if (!g_atomic_int_dec_and_test (&probe->refcount))
+    return;
+
+  /* Samples that were not delivered yet are dropped */
+  if (probe->samples)
+    g_ptr_array_unref (probe->samples);
+  g_mutex_clear (&probe->lock);
+
+  state = PyGILState_Ensure ();
+  Py_DECREF (probe->callback);
+  PyGILState_Release (state);
+
+  g_free (probe);
+}
+
+static void
+py_interval_probe_free (PyGstIntervalProbe * probe)
+{
+  GHashTable *probes;
+
+  /* called with the pad lock, so this must not call into Python */
+  g_mutex_lock (&interval_probes_lock);
+  probes = g_object_get_qdata (G_OBJECT (probe->pad), INTERVAL_PROBES_QUARK);
+  if (probes && g_hash_table_lookup (probes,
+          GUINT_TO_POINTER (probe->id)) == probe)
+    g_hash_table_remove (probes, GUINT_TO_POINTER (probe->id));
+  probe->freed = TRUE;
+  g_mutex_unlock (&interval_probes_lock);
+
+  py_interval_probe_unref (probe);
+}
+
+static void
+py_interval_probe_add_buffer (PyGstIntervalProbe * probe, GstPad * pad,
+    GstBuffer * buffer)
+{
+  if (probe->samples) {
+    GstCaps *caps = gst_pad_get_current_caps (pad);
+
+    g_ptr_array_add (probe->samples, gst_sample_new (buffer, caps, NULL,
+            NULL));
+    if (caps)
+      gst_caps_unref (caps);
+  } else {
+    probe->buffers++;
+    probe->bytes += gst_buffer_get_size (buffer);
+    if (GST_BUFFER_PTS_IS_VALID (buffer))
+      probe->last_pts = GST_BUFFER_PTS (buffer);
+  }
+}
+
+/* Takes the data collected since the last call and calls the callback with
+ * it, must be called with the probe lock which is released */
+static void
+py_interval_probe_deliver (PyGstIntervalProbe * probe, GstPad * pad,
+    gint64 now)
+{
+  PyGILState_STATE state;
+  PyObject *py_pad, *py_data, *ret;
+  GPtrArray *samples = NULL;
+  guint64 buffers = 0, bytes = 0;
+  GstClockTime last_pts = GST_CLOCK_TIME_NONE, elapsed;
+
+  elapsed = (now - probe->last_call) * GST_USECOND;
+  probe->last_call = now;
+
+  if (probe->samples) {
+    if (probe->samples->len == 0) {
+      g_mutex_unlock (&probe->lock);
+      return;
+    }
+    samples = probe->samples;
+    probe->samples =
+        g_ptr_array_new_with_free_func ((GDestroyNotify) gst_sample_unref);
+  } else {
+    buffers = probe->buffers;
+    bytes = probe->bytes;
+    last_pts = probe->last_pts;
+    probe->buffers = probe->bytes = 0;
+  }
+  g_mutex_unlock (&probe->lock);
+
+  state = PyGILState_Ensure ();
+
+  py_pad = pygobject_new (G_OBJECT (pad));
+  if (samples) {
+    guint i;
+
+    py_data = PyList_New (samples->len);
+    for (i = 0; py_data && i < samples->len; i++) {
+      GstSample *sample = gst_sample_ref (g_ptr_array_index (samples, i));
+
+      PyList_SET_ITEM (py_data, i, pyg_boxed_new (GST_TYPE_SAMPLE, sample,
+              FALSE, TRUE));
+    }
+    g_ptr_array_unref (samples);
+  } else {
+    py_data = Py_BuildValue ("{s:K,s:K,s:K,s:K}", "buffers",
+        (unsigned long long) buffers, "bytes", (unsigned long long) bytes,
+        "duration", (unsigned long long) elapsed, "last-pts",
+        (unsigned long long) last_pts);
+  }
+
+  if (py_pad && py_data) {
+    ret = PyObject_CallFunctionObjArgs (probe->callback, py_pad, py_data,
+        NULL);
+    if (ret)
+      Py_DECREF (ret);
+  } else {
+    ret = NULL;
+  }
+  if (!ret)
+    PyErr_Print ();
+
+  Py_XDECREF (py_pad);
+  Py_XDECREF (py_data);
+  PyGILState_Release (state);
+}
+
+static GstPadProbeReturn
+py_interval_probe_cb (GstPad * pad, GstPadProbeInfo * info,
+    PyGstIntervalProbe * probe)
+{
+  gboolean flush = FALSE;
+  gint64 now;
+
+  g_mutex_lock (&probe->lock);
+  if (probe->removed) {
+    g_mutex_unlock (&probe->lock);
+    return GST_PAD_PROBE_OK;
+  }
+
+  if (info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+    py_interval_probe_add_buffer (probe, pad, GST_PAD_PROBE_INFO_BUFFER (info));
+  } else if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST (info);
+    guint i, len = gst_buffer_list_length (list);
+
+    for (i = 0; i < len; i++)
+      py_interval_probe_add_buffer (probe, pad, gst_buffer_list_get (list, i));
+  } else if (info->type & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
+    /* nothing follows EOS that would trigger the next call */
+    if (GST_EVENT_TYPE (GST_PAD_PROBE_INFO_EVENT (info)) != GST_EVENT_EOS) {
+      g_mutex_unlock (&probe->lock);
+      return GST_PAD_PROBE_OK;
+    }
+    flush = TRUE;
+  }
+
+  /* batched samples keep their buffers alive, so don't retain too many */
+  if (probe->samples && probe->samples->len >= probe->max_samples)
+    flush = TRUE;
+
+  now = g_get_monotonic_time ();
+  if (!flush && (now - probe->last_call) * GST_USECOND < probe->interval) {
+    g_mutex_unlock (&probe->lock);
+    return GST_PAD_PROBE_OK;
+  }
+
+  py_interval_probe_deliver (probe, pad, now);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static PyObject *
+_gst_pad_add_interval_probe (PyObject * args, gboolean batch)
+{
+  PyTypeObject *gst_pad_type;
+  PyObject *py_pad, *callback;
+  unsigned long long interval;
+  unsigned int max_samples = DEFAULT_MAX_BATCH_SAMPLES;
+  PyGstIntervalProbe *probe;
+  GHashTable *probes;
+  GstPad *pad;
+  gulong id;
+
+  /* Look up Gst.Pad, interval, callback and max_samples parameters */
+  gst_pad_type = pygobject_lookup_class (GST_TYPE_PAD);
+  if (!PyArg_ParseTuple (args, "O!KO|I", gst_pad_type, &py_pad, &interval,
+          &callback, &max_samples))
+    return NULL;
+
+  if (!PyCallable_Check (callback)) {
+    PyErr_SetString (PyExc_TypeError, "callback must be callable");
+    return NULL;
+  }
+
+  if (max_samples == 0) {
+    PyErr_SetString (PyExc_ValueError, "max_samples must be positive");
+    return NULL;
+  }
+
+  pad = GST_PAD (pygobject_get (py_pad));
+
+  probe = g_new0 (PyGstIntervalProbe, 1);
+  probe->refcount = 1;
+  g_mutex_init (&probe->lock);
+  Py_INCREF (callback);
+  probe->callback = callback;
+  probe->interval = interval;
+  probe->last_call = g_get_monotonic_time ();
+  probe->last_pts = GST_CLOCK_TIME_NONE;
+  probe->pad = pad;
+  if (batch) {
+    probe->samples =
+        g_ptr_array_new_with_free_func ((GDestroyNotify) gst_sample_unref);
+    probe->max_samples = max_samples;
+  }
+
+  /* keep the probe alive until it is registered, the pad lock is taken
+   * before interval_probes_lock when it is freed */
+  py_interval_probe_ref (probe);
+  id = gst_pad_add_probe (pad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST |
+      GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+      (GstPadProbeCallback) py_interval_probe_cb, probe,
+      (GDestroyNotify) py_interval_probe_free);
+
+  g_mutex_lock (&interval_probes_lock);
+  probe->id = id;
+  if (!probe->freed) {
+    probes = g_object_get_qdata (G_OBJECT (pad), INTERVAL_PROBES_QUARK);
+    if (probes == NULL) {
+      probes = g_hash_table_new (NULL, NULL);
+      g_object_set_qdata_full (G_OBJECT (pad), INTERVAL_PROBES_QUARK, probes,
+          (GDestroyNotify) g_hash_table_unref);
+    }
+    g_hash_table_insert (probes, GUINT_TO_POINTER (id), probe);
+  }
+  g_mutex_unlock (&interval_probes_lock);
+  py_interval_probe_unref (probe);
+
+  return PyLong_FromUnsignedLong (id);
+}
+
+static PyObject *
+_gst_pad_add_batch_probe (PyObject * self, PyObject * args)
+{
+  return _gst_pad_add_interval_probe (args, TRUE);
+}
+
+static PyObject *
+_gst_pad_add_stats_probe (PyObject * self, PyObject * args)
+{
+  return _gst_pad_add_interval_probe (args, FALSE);
+}
+
+/* Removes a probe and, if it is an interval probe, hands over the data it
+ * collected since its last call */
+static PyObject *
+_gst_pad_remove_interval_probe (PyObject * self, PyObject * args)
+{
+  PyTypeObject *gst_pad_type;
+  PyObject *py_pad;
+  unsigned long id;
+  PyGstIntervalProbe *probe = NULL;
+  GHashTable *probes;
+  GstPad *pad;
+
+  gst_pad_type = pygobject_lookup_class (GST_TYPE_PAD);
+  if (!PyArg_ParseTuple (args, "O!k", gst_pad_type, &py_pad, &id))
+    return NULL;
+
+  pad = GST_PAD (pygobject_get (py_pad));
+
+  g_mutex_lock (&interval_probes_lock);
+  probes = g_object_get_qdata (G_OBJECT (pad), INTERVAL_PROBES_QUARK);
+  if (probes)
+    probe = g_hash_table_lookup (probes, GUINT_TO_POINTER (id));
+  if (probe)
+    py_interval_probe_ref (probe);
+  g_mutex_unlock (&interval_probes_lock);
+
+  /* the streaming thread might be waiting for the GIL in the probe */
+  Py_BEGIN_ALLOW_THREADS;
+  gst_pad_remove_probe (pad, id);
+  Py_END_ALLOW_THREADS;
+
+  if (probe) {
+    g_mutex_lock (&probe->lock);
+    probe->removed = TRUE;
+    py_interval_probe_deliver (probe, pad, g_get_monotonic_time ());
+    py_interval_probe_unref (probe);
+  }
+
+  Py_RETURN_NONE;
+}
+
 static PyMethodDef _gi_gst_functions[] = {
   {"trace", (PyCFunction) _wrap_gst_trace, METH_VARARGS,
       NULL},
@@ -1103,6 +1441,15 @@ static PyMethodDef _gi_gst_functions[] = {
   {"memory_override_unmap", (PyCFunction) _gst_memory_override_unmap,
         METH_VARARGS,
       NULL},
+  {"pad_add_batch_probe", (PyCFunction) _gst_pad_add_batch_probe,
+        METH_VARARGS,
+      NULL},
+  {"pad_add_stats_probe", (PyCFunction) _gst_pad_add_stats_probe,
+        METH_VARARGS,
+      NULL},
+  {"pad_remove_interval_probe", (PyCFunction) _gst_pad_remove_interval_probe,
+        METH_VARARGS,
+      NULL},
   {NULL, NULL, 0, NULL}
 };
 
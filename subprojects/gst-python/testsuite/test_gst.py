@@ -22,6 +22,7 @@ import overrides_hack
 overrides_hack
 from common import TestCase, unittest
 
+import gi
 from gi.repository import Gst
 
 class TimeArgsTest(TestCase):
@@ -112,5 +113,112 @@ class TestBufferMap(TestCase):
         with self.assertRaises(ValueError):
             info.data[0]
 
+class TestPadIntervalProbes(TestCase):
+
+    def setup_pads(self):
+        Gst.init(None)
+        src = Gst.Pad.new("src", Gst.PadDirection.SRC)
+        sink = Gst.Pad.new("sink", Gst.PadDirection.SINK)
+        sink.set_chain_function(lambda pad, buf: Gst.FlowReturn.OK)
+        src.set_active(True)
+        sink.set_active(True)
+        src.link(sink)
+        src.push_event(Gst.Event.new_stream_start("test"))
+        src.push_event(Gst.Event.new_segment(Gst.Segment.new()))
+        return src
+
+    def test_batch_probe(self):
+        src = self.setup_pads()
+        batches = []
+        src.add_batch_probe(Gst.SECOND * 3600,
+                            lambda pad, samples: batches.append(samples))
+        self.assertEqual(src.push(Gst.Buffer.new_wrapped([42])),
+                         Gst.FlowReturn.OK)
+        self.assertEqual(batches, [])
+
+        src.add_batch_probe(0, lambda pad, samples: batches.append(samples))
+        self.assertEqual(src.push(Gst.Buffer.new_wrapped([42])),
+                         Gst.FlowReturn.OK)
+        self.assertEqual(len(batches), 1)
+        self.assertEqual(len(batches[0]), 1)
+        self.assertEqual(batches[0][0].get_buffer().get_size(), 1)
+
+    def test_batch_probe_max_samples(self):
+        src = self.setup_pads()
+        batches = []
+        src.add_batch_probe(Gst.SECOND * 3600,
+                            lambda pad, samples: batches.append(samples),
+                            max_samples=3)
+        for i in range(7):
+            self.assertEqual(src.push(Gst.Buffer.new_wrapped([i])),
+                             Gst.FlowReturn.OK)
+        self.assertEqual([len(b) for b in batches], [3, 3])
+
+    def test_batch_probe_eos(self):
+        src = self.setup_pads()
+        batches = []
+        src.add_batch_probe(Gst.SECOND * 3600,
+                            lambda pad, samples: batches.append(samples))
+        for i in range(2):
+            self.assertEqual(src.push(Gst.Buffer.new_wrapped([i])),
+                             Gst.FlowReturn.OK)
+        self.assertEqual(batches, [])
+        src.push_event(Gst.Event.new_eos())
+        self.assertEqual([len(b) for b in batches], [2])
+
+    def test_batch_probe_remove(self):
+        src = self.setup_pads()
+        batches = []
+        probe_id = src.add_batch_probe(
+            Gst.SECOND * 3600, lambda pad, samples: batches.append(samples))
+        self.assertEqual(src.push(Gst.Buffer.new_wrapped([42])),
+                         Gst.FlowReturn.OK)
+        self.assertEqual(batches, [])
+        src.remove_probe(probe_id)
+        self.assertEqual([len(b) for b in batches], [1])
+
+        self.assertEqual(src.push(Gst.Buffer.new_wrapped([42])),
+                         Gst.FlowReturn.OK)
+        self.assertEqual(len(batches), 1)
+
+        # other probes are still removed normally
+        probe_id = src.add_probe(Gst.PadProbeType.BUFFER,
+                                 lambda pad, info: Gst.PadProbeReturn.OK)
+        src.remove_probe(probe_id)
+
+    def test_stats_probe(self):
+        src = self.setup_pads()
+        stats = []
+        src.add_stats_probe(0, lambda pad, s: stats.append(s))
+        buf = Gst.Buffer.new_wrapped([1, 2, 3])
+        buf.pts = Gst.SECOND
+        self.assertEqual(src.push(buf), Gst.FlowReturn.OK)
+        self.assertEqual(len(stats), 1)
+        self.assertEqual(stats[0]["buffers"], 1)
+        self.assertEqual(stats[0]["bytes"], 3)
+        self.assertEqual(stats[0]["last-pts"], Gst.SECOND)
+
+class TestVideoFrameMapPlanes(TestCase):
+
+    def test_map_planes(self):
+        Gst.init(None)
+        gi.require_version('GstVideo', '1.0')
+        from gi.repository import GstVideo
+
+        info = GstVideo.VideoInfo.new()
+        info.set_format(GstVideo.VideoFormat.I420, 4, 4)
+        buf = Gst.Buffer.new_allocate(None, info.size, None)
+        with GstVideo.VideoFrame.map_planes(info, buf,
+                Gst.MapFlags.READ | Gst.MapFlags.WRITE) as frame:
+            self.assertEqual(len(frame.planes), 3)
+            self.assertEqual(len(frame.planes[0]), 16)
+            luma = frame.planes[0]
+            frame.planes[1][0] = 42
+
+        with self.assertRaises(ValueError):
+            luma[0]
+        with buf.map(Gst.MapFlags.READ) as mapinfo:
+            self.assertEqual(mapinfo.data[16], 42)
+
 if __name__ == "__main__":
     unittest.main()
@@ -85,6 +85,10 @@ struct _GstRTSPClientPrivate
   gpointer send_messages_data;
   GDestroyNotify send_messages_notify;
   GArray *data_seqs;
+  GQueue send_queue;            /* of SendQueueItem */
+  GSource *send_queue_source;
+  guint send_queue_size;
+  GstRTSPClientDropPolicy send_queue_drop_policy;
 
   GstRTSPSessionPool *session_pool;
   gulong session_removed_id;
@@ -123,6 +127,13 @@ typedef struct
   guint seq;
 } DataSeq;
 
+typedef struct
+{
+  guint8 channel;
+  GstBuffer *buffer;
+  GstBufferList *buffer_list;
+} SendQueueItem;
+
 static GMutex tunnels_lock;
 static GHashTable *tunnels;     /* protected by tunnels_lock */
 
@@ -132,6 +143,8 @@ static GHashTable *tunnels;     /* protected by tunnels_lock */
 #define DEFAULT_MOUNT_POINTS            NULL
 #define DEFAULT_DROP_BACKLOG            TRUE
 #define DEFAULT_POST_SESSION_TIMEOUT    -1
+#define DEFAULT_SEND_QUEUE_SIZE         0
+#define DEFAULT_SEND_QUEUE_DROP_POLICY  GST_RTSP_CLIENT_DROP_POLICY_OLDEST
 
 #define RTSP_CTRL_CB_INTERVAL           1
 #define RTSP_CTRL_TIMEOUT_VALUE         60
@@ -143,6 +156,8 @@ enum
   PROP_MOUNT_POINTS,
   PROP_DROP_BACKLOG,
   PROP_POST_SESSION_TIMEOUT,
+  PROP_SEND_QUEUE_SIZE,
+  PROP_SEND_QUEUE_DROP_POLICY,
   PROP_LAST
 };
 
@@ -188,6 +203,7 @@ static void gst_rtsp_client_set_property (GObject * object, guint propid,
 static void gst_rtsp_client_finalize (GObject * obj);
 
 static void rtsp_ctrl_timeout_remove (GstRTSPClient * client);
+static void send_queue_item_free (SendQueueItem * item);
 
 static GstSDPMessage *create_sdp (GstRTSPClient * client, GstRTSPMedia * media);
 static gboolean handle_sdp (GstRTSPClient * client, GstRTSPContext * ctx,
@@ -211,6 +227,29 @@ static gboolean pre_signal_accumulator (GSignalInvocationHint * ihint,
 
 G_DEFINE_TYPE_WITH_PRIVATE (GstRTSPClient, gst_rtsp_client, G_TYPE_OBJECT);
 
+#define C_ENUM(v) ((gint) v)
+
+GType
+gst_rtsp_client_drop_policy_get_type (void)
+{
+  static gsize id = 0;
+  static const GEnumValue values[] = {
+    {C_ENUM (GST_RTSP_CLIENT_DROP_POLICY_OLDEST),
+        "GST_RTSP_CLIENT_DROP_POLICY_OLDEST", "oldest"},
+    {C_ENUM (GST_RTSP_CLIENT_DROP_POLICY_NEWEST),
+        "GST_RTSP_CLIENT_DROP_POLICY_NEWEST", "newest"},
+    {C_ENUM (GST_RTSP_CLIENT_DROP_POLICY_CLOSE),
+        "GST_RTSP_CLIENT_DROP_POLICY_CLOSE", "close"},
+    {0, NULL, NULL}
+  };
+
+  if (g_once_init_enter (&id)) {
+    GType tmp = g_enum_register_static ("GstRTSPClientDropPolicy", values);
+    g_once_init_leave (&id, tmp);
+  }
+  return (GType) id;
+}
+
 static void
 gst_rtsp_client_class_init (GstRTSPClientClass * klass)
 {
@@ -278,6 +317,43 @@ gst_rtsp_client_class_init (GstRTSPClientClass * klass)
           G_MAXINT, DEFAULT_POST_SESSION_TIMEOUT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTSPClient:send-queue-size:
+   *
+   * The maximum number of RTP/RTCP buffers or buffer lists to queue for
+   * sending over interleaved TCP.
+   *
+   * When this is not 0, the streaming threads of the media only queue the
+   * data for the client. The queue is written from the context the client
+   * is attached to, all pending data in one go, so that a slow client does
+   * not delay the other clients of a shared media. What happens when the
+   * queue is full is decided by #GstRTSPClient:send-queue-drop-policy.
+   *
+   * 0 disables the queue and the data is written directly from the
+   * streaming threads.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_SEND_QUEUE_SIZE,
+      g_param_spec_uint ("send-queue-size", "Send Queue Size",
+          "Maximum number of interleaved data items to queue for sending "
+          "from the client context (0 = disabled)", 0, G_MAXUINT,
+          DEFAULT_SEND_QUEUE_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPClient:send-queue-drop-policy:
+   *
+   * What to do with interleaved data when the send queue is full.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_SEND_QUEUE_DROP_POLICY,
+      g_param_spec_enum ("send-queue-drop-policy", "Send Queue Drop Policy",
+          "What to do when the send queue is full",
+          GST_TYPE_RTSP_CLIENT_DROP_POLICY, DEFAULT_SEND_QUEUE_DROP_POLICY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_rtsp_client_signals[SIGNAL_CLOSED] =
       g_signal_new ("closed", G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
       G_STRUCT_OFFSET (GstRTSPClientClass, closed), NULL, NULL, NULL,
@@ -609,6 +685,9 @@ gst_rtsp_client_init (GstRTSPClient * client)
   g_mutex_init (&priv->send_lock);
   g_mutex_init (&priv->watch_lock);
   priv->data_seqs = g_array_new (FALSE, FALSE, sizeof (DataSeq));
+  g_queue_init (&priv->send_queue);
+  priv->send_queue_size = DEFAULT_SEND_QUEUE_SIZE;
+  priv->send_queue_drop_policy = DEFAULT_SEND_QUEUE_DROP_POLICY;
   priv->drop_backlog = DEFAULT_DROP_BACKLOG;
   priv->post_session_timeout = DEFAULT_POST_SESSION_TIMEOUT;
   priv->transports =
@@ -781,6 +860,9 @@ gst_rtsp_client_finalize (GObject * obj)
   g_assert (priv->sessions == NULL);
   g_assert (priv->session_removed_id == 0);
 
+  g_assert (priv->send_queue_source == NULL);
+  g_queue_foreach (&priv->send_queue, (GFunc) send_queue_item_free, NULL);
+  g_queue_clear (&priv->send_queue);
   g_array_unref (priv->data_seqs);
   g_hash_table_unref (priv->transports);
   g_hash_table_unref (priv->pipelined_requests);
@@ -827,6 +909,16 @@ gst_rtsp_client_get_property (GObject * object, guint propid,
     case PROP_POST_SESSION_TIMEOUT:
       g_value_set_int (value, priv->post_session_timeout);
       break;
+    case PROP_SEND_QUEUE_SIZE:
+      g_mutex_lock (&priv->send_lock);
+      g_value_set_uint (value, priv->send_queue_size);
+      g_mutex_unlock (&priv->send_lock);
+      break;
+    case PROP_SEND_QUEUE_DROP_POLICY:
+      g_mutex_lock (&priv->send_lock);
+      g_value_set_enum (value, priv->send_queue_drop_policy);
+      g_mutex_unlock (&priv->send_lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -856,6 +948,16 @@ gst_rtsp_client_set_property (GObject * object, guint propid,
       priv->post_session_timeout = g_value_get_int (value);
       g_mutex_unlock (&priv->lock);
       break;
+    case PROP_SEND_QUEUE_SIZE:
+      g_mutex_lock (&priv->send_lock);
+      priv->send_queue_size = g_value_get_uint (value);
+      g_mutex_unlock (&priv->send_lock);
+      break;
+    case PROP_SEND_QUEUE_DROP_POLICY:
+      g_mutex_lock (&priv->send_lock);
+      priv->send_queue_drop_policy = g_value_get_enum (value);
+      g_mutex_unlock (&priv->send_lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -1170,6 +1272,194 @@ do_close (gpointer user_data)
   return G_SOURCE_REMOVE;
 }
 
+static void
+send_queue_item_free (SendQueueItem * item)
+{
+  gst_clear_buffer (&item->buffer);
+  gst_clear_buffer_list (&item->buffer_list);
+  g_free (item);
+}
+
+static void
+send_queue_clear (GstRTSPClient * client)
+{
+  GstRTSPClientPrivate *priv = client->priv;
+  GSource *source;
+  GQueue queue;
+
+  g_mutex_lock (&priv->send_lock);
+  source = priv->send_queue_source;
+  priv->send_queue_source = NULL;
+  queue = priv->send_queue;
+  g_queue_init (&priv->send_queue);
+  g_mutex_unlock (&priv->send_lock);
+
+  /* the source holds a ref to the client, drop it without the lock */
+  if (source) {
+    g_source_destroy (source);
+    g_source_unref (source);
+  }
+  g_queue_foreach (&queue, (GFunc) send_queue_item_free, NULL);
+  g_queue_clear (&queue);
+}
+
+static gboolean
+send_queue_is_enabled (GstRTSPClient * client)
+{
+  GstRTSPClientPrivate *priv = client->priv;
+
+  return priv->send_queue_size > 0 && priv->watch_context != NULL;
+}
+
+static gboolean send_queue_flush (gpointer user_data);
+
+/* with send_lock */
+static void
+send_queue_schedule (GstRTSPClient * client)
+{
+  GstRTSPClientPrivate *priv = client->priv;
+
+  if (priv->send_queue_source || g_queue_is_empty (&priv->send_queue))
+    return;
+
+  /* write from the context of the client so that the streaming threads
+   * never wait for the socket of a slow client */
+  priv->send_queue_source = g_idle_source_new ();
+  g_source_set_callback (priv->send_queue_source, send_queue_flush,
+      g_object_ref (client), g_object_unref);
+  g_source_attach (priv->send_queue_source, priv->watch_context);
+}
+
+/* with send_lock, returns FALSE when the client should be closed */
+static gboolean
+send_queue_push (GstRTSPClient * client, guint8 channel, GstBuffer * buffer,
+    GstBufferList * buffer_list)
+{
+  GstRTSPClientPrivate *priv = client->priv;
+  SendQueueItem *item;
+
+  if (g_queue_get_length (&priv->send_queue) >= priv->send_queue_size) {
+    switch (priv->send_queue_drop_policy) {
+      case GST_RTSP_CLIENT_DROP_POLICY_NEWEST:
+        GST_DEBUG_OBJECT (client, "send queue full, dropping data for "
+            "channel %d", channel);
+        return TRUE;
+      case GST_RTSP_CLIENT_DROP_POLICY_CLOSE:
+        GST_WARNING_OBJECT (client, "send queue full, closing connection");
+        return FALSE;
+      case GST_RTSP_CLIENT_DROP_POLICY_OLDEST:
+      default:
+        while (g_queue_get_length (&priv->send_queue) >= priv->send_queue_size) {
+          GST_DEBUG_OBJECT (client, "send queue full, dropping oldest data");
+          send_queue_item_free (g_queue_pop_head (&priv->send_queue));
+        }
+        break;
+    }
+  }
+
+  item = g_new0 (SendQueueItem, 1);
+  item->channel = channel;
+  if (buffer)
+    item->buffer = gst_buffer_ref (buffer);
+  if (buffer_list)
+    item->buffer_list = gst_buffer_list_ref (buffer_list);
+  g_queue_push_tail (&priv->send_queue, item);
+
+  send_queue_schedule (client);
+
+  return TRUE;
+}
+
+/* called from the watch context, sends all queued data of the channels
+ * that have nothing pending in the watch with one call so that the
+ * interleaved frames can be written together */
+static gboolean
+send_queue_flush (gpointer user_data)
+{
+  GstRTSPClient *client = user_data;
+  GstRTSPClientPrivate *priv = client->priv;
+  GstRTSPMessage *messages;
+  GList *walk, *next;
+  guint i, n_messages = 0;
+  gboolean ret = TRUE;
+
+  g_mutex_lock (&priv->send_lock);
+  if (priv->send_queue_source == g_main_current_source ())
+    g_clear_pointer (&priv->send_queue_source, g_source_unref);
+
+  for (walk = priv->send_queue.head; walk; walk = walk->next) {
+    SendQueueItem *item = walk->data;
+
+    if (get_data_seq (client, item->channel) != 0)
+      continue;
+
+    if (item->buffer_list)
+      n_messages += gst_buffer_list_length (item->buffer_list);
+    else
+      n_messages++;
+  }
+
+  if (n_messages == 0) {
+    /* rescheduled when the pending data has been sent */
+    g_mutex_unlock (&priv->send_lock);
+    return G_SOURCE_REMOVE;
+  }
+
+  messages = g_new0 (GstRTSPMessage, n_messages);
+  i = 0;
+  for (walk = priv->send_queue.head; walk; walk = next) {
+    SendQueueItem *item = walk->data;
+
+    next = walk->next;
+
+    if (get_data_seq (client, item->channel) != 0)
+      continue;
+
+    if (item->buffer_list) {
+      guint j, len = gst_buffer_list_length (item->buffer_list);
+
+      for (j = 0; j < len; j++) {
+        gst_rtsp_message_init_data (&messages[i], item->channel);
+        gst_rtsp_message_set_body_buffer (&messages[i],
+            gst_buffer_list_get (item->buffer_list, j));
+        i++;
+      }
+    } else {
+      gst_rtsp_message_init_data (&messages[i], item->channel);
+      gst_rtsp_message_set_body_buffer (&messages[i], item->buffer);
+      i++;
+    }
+
+    g_queue_delete_link (&priv->send_queue, walk);
+    send_queue_item_free (item);
+  }
+
+  GST_LOG_OBJECT (client, "sending %u queued data messages", n_messages);
+
+  if (priv->send_messages_func) {
+    ret =
+        priv->send_messages_func (client, messages, n_messages, FALSE,
+        priv->send_data);
+  } else if (priv->send_func) {
+    for (i = 0; i < n_messages; i++) {
+      ret = priv->send_func (client, &messages[i], FALSE, priv->send_data);
+      if (!ret)
+        break;
+    }
+  }
+  g_mutex_unlock (&priv->send_lock);
+
+  for (i = 0; i < n_messages; i++) {
+    gst_rtsp_message_unset (&messages[i]);
+  }
+  g_free (messages);
+
+  if (!ret)
+    gst_rtsp_client_close (client);
+
+  return G_SOURCE_REMOVE;
+}
+
 static gboolean
 do_send_data (GstBuffer * buffer, guint8 channel, GstRTSPClient * client)
 {
@@ -1182,12 +1472,13 @@ do_send_data (GstBuffer * buffer, guint8 channel, GstRTSPClient * client)
   gst_rtsp_message_set_body_buffer (&message, buffer);
 
   g_mutex_lock (&priv->send_lock);
-  if (get_data_seq (client, channel) != 0) {
+  if (send_queue_is_enabled (client)) {
+    ret = send_queue_push (client, channel, buffer, NULL);
+  } else if (get_data_seq (client, channel) != 0) {
     GST_WARNING ("already a queued data message for channel %d", channel);
     g_mutex_unlock (&priv->send_lock);
     return FALSE;
-  }
-  if (priv->send_messages_func) {
+  } else if (priv->send_messages_func) {
     ret =
         priv->send_messages_func (client, &message, 1, FALSE, priv->send_data);
   } else if (priv->send_func) {
@@ -1213,6 +1504,13 @@ do_send_data (GstBuffer * buffer, guint8 channel, GstRTSPClient * client)
 static gboolean
 do_check_back_pressure (guint8 channel, GstRTSPClient * client)
 {
+  GstRTSPClientPrivate *priv = client->priv;
+
+  /* with the send queue, data can be queued while the watch is still
+   * sending until the queue is full */
+  if (send_queue_is_enabled (client))
+    return g_queue_get_length (&priv->send_queue) >= priv->send_queue_size;
+
   return get_data_seq (client, channel) != 0;
 }
 
@@ -1226,6 +1524,12 @@ do_send_data_list (GstBufferList * buffer_list, guint8 channel,
   GstRTSPMessage *messages;
 
   g_mutex_lock (&priv->send_lock);
+  if (send_queue_is_enabled (client)) {
+    ret = send_queue_push (client, channel, NULL, buffer_list);
+    g_mutex_unlock (&priv->send_lock);
+    goto done;
+  }
+
   if (get_data_seq (client, channel) != 0) {
     GST_WARNING ("already a queued data message for channel %d", channel);
     g_mutex_unlock (&priv->send_lock);
@@ -1256,6 +1560,7 @@ do_send_data_list (GstBufferList * buffer_list, guint8 channel,
     gst_rtsp_message_unset (&messages[i]);
   }
 
+done:
   if (!ret) {
     GSource *idle_src;
 
@@ -1313,6 +1618,8 @@ gst_rtsp_client_close (GstRTSPClient * client)
   }
 
   g_mutex_unlock (&priv->watch_lock);
+
+  send_queue_clear (client);
 }
 
 static gchar *
@@ -4878,6 +5185,7 @@ do_send_messages (GstRTSPClient * client, GstRTSPMessage * messages,
   GstRTSPClientPrivate *priv = client->priv;
   guint id = 0;
   GstRTSPResult ret;
+  guint32 done[256 / 32] = { 0, };
   guint i;
 
   /* send the message */
@@ -4893,14 +5201,18 @@ do_send_messages (GstRTSPClient * client, GstRTSPMessage * messages,
       guint8 channel = 0;
       GstRTSPResult r;
 
-      /* We assume that all data messages in the list are for the
-       * same channel */
+      /* The messages of the send queue can be for several channels,
+       * handle each channel once */
       r = gst_rtsp_message_parse_data (&messages[i], &channel);
       if (r != GST_RTSP_OK) {
         ret = r;
         goto error;
       }
 
+      if (done[channel / 32] & (1U << (channel % 32)))
+        continue;
+      done[channel / 32] |= 1U << (channel % 32);
+
       /* check if the message has been queued for transmission in watch */
       if (id) {
         /* store the seq number so we can wait until it has been sent */
@@ -4920,7 +5232,6 @@ do_send_messages (GstRTSPClient * client, GstRTSPMessage * messages,
           g_mutex_lock (&priv->send_lock);
         }
       }
-      break;
     }
   }
 
@@ -4946,20 +5257,41 @@ message_sent (GstRTSPWatch * watch, guint cseq, gpointer user_data)
 {
   GstRTSPClient *client = GST_RTSP_CLIENT (user_data);
   GstRTSPClientPrivate *priv = client->priv;
-  GstRTSPStreamTransport *trans = NULL;
+  GstRTSPStreamTransport **trans;
   guint8 channel = 0;
+  guint i, j, n_trans = 0;
 
   g_mutex_lock (&priv->send_lock);
 
-  if (get_data_channel (client, cseq, &channel)) {
-    trans = g_hash_table_lookup (priv->transports, GINT_TO_POINTER (channel));
+  /* a batch from the send queue can have data for several channels with
+   * the same seq, collect the transports once each */
+  trans = g_newa (GstRTSPStreamTransport *, priv->data_seqs->len);
+  while (get_data_channel (client, cseq, &channel)) {
+    GstRTSPStreamTransport *tr;
+
+    tr = g_hash_table_lookup (priv->transports, GINT_TO_POINTER (channel));
     set_data_seq (client, channel, 0);
+
+    for (j = 0; j < n_trans; j++) {
+      if (trans[j] == tr)
+        break;
+    }
+    if (tr && j == n_trans)
+      trans[n_trans++] = g_object_ref (tr);
+
+    if (cseq == 0)
+      break;
   }
+
+  /* send what was queued for the channels while they were busy */
+  if (send_queue_is_enabled (client))
+    send_queue_schedule (client);
   g_mutex_unlock (&priv->send_lock);
 
-  if (trans) {
+  for (i = 0; i < n_trans; i++) {
     GST_DEBUG_OBJECT (client, "emit 'message-sent' signal");
-    gst_rtsp_stream_transport_message_sent (trans);
+    gst_rtsp_stream_transport_message_sent (trans[i]);
+    g_object_unref (trans[i]);
   }
 
   return GST_RTSP_OK;
@@ -5257,6 +5589,7 @@ client_watch_notify (GstRTSPClient * client)
   gst_rtsp_client_set_send_func (client, NULL, NULL, NULL);
   gst_rtsp_client_set_send_messages_func (client, NULL, NULL, NULL);
   rtsp_ctrl_timeout_remove (client);
+  send_queue_clear (client);
   gst_rtsp_client_session_filter (client, cleanup_session, &closed);
 
   if (closed)
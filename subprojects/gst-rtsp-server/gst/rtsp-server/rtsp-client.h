@@ -44,6 +44,26 @@ typedef struct _GstRTSPClientPrivate GstRTSPClientPrivate;
 #define GST_RTSP_CLIENT_CAST(obj)         ((GstRTSPClient*)(obj))
 #define GST_RTSP_CLIENT_CLASS_CAST(klass) ((GstRTSPClientClass*)(klass))
 
+/**
+ * GstRTSPClientDropPolicy:
+ * @GST_RTSP_CLIENT_DROP_POLICY_OLDEST: drop the oldest queued data
+ * @GST_RTSP_CLIENT_DROP_POLICY_NEWEST: drop the data that does not fit
+ * @GST_RTSP_CLIENT_DROP_POLICY_CLOSE: close the connection of the client
+ *
+ * What to do with interleaved data when the send queue of a client is full.
+ *
+ * Since: 1.22
+ */
+typedef enum {
+  GST_RTSP_CLIENT_DROP_POLICY_OLDEST,
+  GST_RTSP_CLIENT_DROP_POLICY_NEWEST,
+  GST_RTSP_CLIENT_DROP_POLICY_CLOSE
+} GstRTSPClientDropPolicy;
+
+#define GST_TYPE_RTSP_CLIENT_DROP_POLICY (gst_rtsp_client_drop_policy_get_type())
+GST_RTSP_SERVER_API
+GType gst_rtsp_client_drop_policy_get_type (void);
+
 /**
  * GstRTSPClientSendFunc:
  * @client: a #GstRTSPClient
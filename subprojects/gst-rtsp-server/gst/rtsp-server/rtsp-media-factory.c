@@ -74,6 +74,8 @@ struct _GstRTSPMediaFactoryPrivate
 
   GMutex medias_lock;
   GHashTable *medias;           /* protected by medias_lock */
+  GHashTable *warm_pools;       /* protected by medias_lock */
+  guint warm_pool_size;         /* protected by medias_lock */
 
   GType media_gtype;
 
@@ -82,6 +84,21 @@ struct _GstRTSPMediaFactoryPrivate
   GstRTSPPublishClockMode publish_clock_mode;
 };
 
+/* prepared media kept ready for one key, see warm-pool-size */
+typedef struct
+{
+  GQueue medias;
+  GstRTSPUrl *url;
+  guint pending;                /* refills in progress */
+  gboolean disabled;            /* media for this key can't be warmed */
+} WarmPool;
+
+typedef struct
+{
+  GstRTSPMediaFactory *factory;
+  gchar *key;
+} WarmJob;
+
 #define DEFAULT_LAUNCH          NULL
 #define DEFAULT_SHARED          FALSE
 #define DEFAULT_SUSPEND_MODE    GST_RTSP_SUSPEND_MODE_NONE
@@ -98,6 +115,7 @@ struct _GstRTSPMediaFactoryPrivate
 #define DEFAULT_DO_RETRANSMISSION FALSE
 #define DEFAULT_DSCP_QOS        (-1)
 #define DEFAULT_ENABLE_RTCP     TRUE
+#define DEFAULT_WARM_POOL_SIZE  0
 
 enum
 {
@@ -117,6 +135,7 @@ enum
   PROP_BIND_MCAST_ADDRESS,
   PROP_DSCP_QOS,
   PROP_ENABLE_RTCP,
+  PROP_WARM_POOL_SIZE,
   PROP_LAST
 };
 
@@ -137,6 +156,7 @@ static void gst_rtsp_media_factory_get_property (GObject * object, guint propid,
 static void gst_rtsp_media_factory_set_property (GObject * object, guint propid,
     const GValue * value, GParamSpec * pspec);
 static void gst_rtsp_media_factory_finalize (GObject * obj);
+static void warm_pool_free (WarmPool * pool);
 
 static gchar *default_gen_key (GstRTSPMediaFactory * factory,
     const GstRTSPUrl * url);
@@ -268,6 +288,20 @@ gst_rtsp_media_factory_class_init (GstRTSPMediaFactoryClass * klass)
           "The IP DSCP field to use", -1, 63,
           DEFAULT_DSCP_QOS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTSPMediaFactory:warm-pool-size:
+   *
+   * The number of prepared media to keep ready for each url when the media
+   * is not shared. See gst_rtsp_media_factory_set_warm_pool_size().
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_WARM_POOL_SIZE,
+      g_param_spec_uint ("warm-pool-size", "Warm Pool Size",
+          "The number of prepared media to keep ready per url (0 = disabled)",
+          0, G_MAXUINT, DEFAULT_WARM_POOL_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONSTRUCTED] =
       g_signal_new ("media-constructed", G_TYPE_FROM_CLASS (klass),
       G_SIGNAL_RUN_LAST, G_STRUCT_OFFSET (GstRTSPMediaFactoryClass,
@@ -318,6 +352,9 @@ gst_rtsp_media_factory_init (GstRTSPMediaFactory * factory)
   g_mutex_init (&priv->medias_lock);
   priv->medias = g_hash_table_new_full (g_str_hash, g_str_equal,
       g_free, g_object_unref);
+  priv->warm_pools = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, (GDestroyNotify) warm_pool_free);
+  priv->warm_pool_size = DEFAULT_WARM_POOL_SIZE;
   priv->media_gtype = GST_TYPE_RTSP_MEDIA;
 }
 
@@ -332,6 +369,7 @@ gst_rtsp_media_factory_finalize (GObject * obj)
   if (priv->permissions)
     gst_rtsp_permissions_unref (priv->permissions);
   g_hash_table_unref (priv->medias);
+  g_hash_table_unref (priv->warm_pools);
   g_mutex_clear (&priv->medias_lock);
   g_free (priv->launch);
   g_mutex_clear (&priv->lock);
@@ -402,6 +440,10 @@ gst_rtsp_media_factory_get_property (GObject * object, guint propid,
       g_value_set_boolean (value,
           gst_rtsp_media_factory_is_enable_rtcp (factory));
       break;
+    case PROP_WARM_POOL_SIZE:
+      g_value_set_uint (value,
+          gst_rtsp_media_factory_get_warm_pool_size (factory));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -467,6 +509,10 @@ gst_rtsp_media_factory_set_property (GObject * object, guint propid,
       gst_rtsp_media_factory_set_enable_rtcp (factory,
           g_value_get_boolean (value));
       break;
+    case PROP_WARM_POOL_SIZE:
+      gst_rtsp_media_factory_set_warm_pool_size (factory,
+          g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -1360,6 +1406,175 @@ weak_ref_free (GWeakRef * ref)
   g_slice_free (GWeakRef, ref);
 }
 
+static GstRTSPMedia *
+construct_media (GstRTSPMediaFactory * factory, const GstRTSPUrl * url)
+{
+  GstRTSPMediaFactoryClass *klass = GST_RTSP_MEDIA_FACTORY_GET_CLASS (factory);
+  GstRTSPMedia *media;
+
+  if (!klass->construct)
+    return NULL;
+
+  media = klass->construct (factory, url);
+  if (media == NULL)
+    return NULL;
+
+  g_signal_emit (factory,
+      gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONSTRUCTED], 0, media, NULL);
+
+  /* configure the media */
+  if (klass->configure)
+    klass->configure (factory, media);
+
+  g_signal_emit (factory,
+      gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONFIGURE], 0, media, NULL);
+
+  if (!gst_rtsp_media_is_reusable (media)) {
+    /* when not reusable, connect to the unprepare signal to remove the item
+     * from our cache when it gets unprepared */
+    g_signal_connect_data (media, "unprepared",
+        (GCallback) media_unprepared, weak_ref_new (factory),
+        (GClosureNotify) weak_ref_free, 0);
+  }
+  return media;
+}
+
+/* only media that is handed to a single client and prepared for playing can
+ * be kept warm */
+static gboolean
+media_can_warm (GstRTSPMedia * media)
+{
+  return !gst_rtsp_media_is_shared (media) &&
+      !(gst_rtsp_media_get_transport_mode (media) &
+      GST_RTSP_TRANSPORT_MODE_RECORD);
+}
+
+static void
+warm_media_release (GstRTSPMedia * media)
+{
+  gst_rtsp_media_unprepare (media);
+  g_object_unref (media);
+}
+
+static void
+warm_pool_free (WarmPool * pool)
+{
+  g_queue_foreach (&pool->medias, (GFunc) warm_media_release, NULL);
+  g_queue_clear (&pool->medias);
+  gst_rtsp_url_free (pool->url);
+  g_slice_free (WarmPool, pool);
+}
+
+/* runs the mainloop of a warm media until the media is unprepared */
+static gpointer
+warm_thread_func (GstRTSPThread * thread)
+{
+  g_main_loop_run (thread->loop);
+  gst_rtsp_thread_unref (thread);
+
+  return NULL;
+}
+
+static void
+warm_job_func (WarmJob * job, gpointer user_data)
+{
+  GstRTSPMediaFactory *factory = job->factory;
+  GstRTSPMediaFactoryPrivate *priv = factory->priv;
+  GstRTSPMedia *media = NULL;
+  GstRTSPThread *thread;
+  GstRTSPUrl *url = NULL;
+  WarmPool *pool;
+  GThread *loop_thread;
+
+  g_mutex_lock (&priv->medias_lock);
+  pool = g_hash_table_lookup (priv->warm_pools, job->key);
+  if (pool && !pool->disabled)
+    url = gst_rtsp_url_copy (pool->url);
+  g_mutex_unlock (&priv->medias_lock);
+
+  if (url == NULL)
+    goto done;
+
+  media = construct_media (factory, url);
+  gst_rtsp_url_free (url);
+
+  if (media == NULL)
+    goto done;
+
+  if (!media_can_warm (media)) {
+    g_mutex_lock (&priv->medias_lock);
+    pool = g_hash_table_lookup (priv->warm_pools, job->key);
+    if (pool)
+      pool->disabled = TRUE;
+    g_mutex_unlock (&priv->medias_lock);
+    g_clear_object (&media);
+    goto done;
+  }
+
+  thread = gst_rtsp_thread_new (GST_RTSP_THREAD_TYPE_MEDIA);
+  loop_thread = g_thread_new ("rtsp-warm-media",
+      (GThreadFunc) warm_thread_func, gst_rtsp_thread_ref (thread));
+  g_thread_unref (loop_thread);
+
+  GST_DEBUG ("preparing warm media %p", media);
+  if (!gst_rtsp_media_prepare (media, thread)) {
+    GST_WARNING ("failed to prepare warm media %p", media);
+    g_clear_object (&media);
+  }
+
+done:
+  g_mutex_lock (&priv->medias_lock);
+  pool = g_hash_table_lookup (priv->warm_pools, job->key);
+  if (pool) {
+    pool->pending--;
+    if (media && !pool->disabled &&
+        pool->medias.length < priv->warm_pool_size) {
+      g_queue_push_tail (&pool->medias, media);
+      media = NULL;
+    }
+  }
+  g_mutex_unlock (&priv->medias_lock);
+
+  if (media)
+    warm_media_release (media);
+
+  g_object_unref (job->factory);
+  g_free (job->key);
+  g_slice_free (WarmJob, job);
+}
+
+static GThreadPool *
+get_warm_thread_pool (void)
+{
+  static GThreadPool *warm_thread_pool = NULL;
+
+  if (g_once_init_enter (&warm_thread_pool)) {
+    GThreadPool *pool;
+
+    pool = g_thread_pool_new ((GFunc) warm_job_func, NULL, -1, FALSE, NULL);
+    g_once_init_leave (&warm_thread_pool, pool);
+  }
+  return warm_thread_pool;
+}
+
+/* must be called with medias_lock */
+static void
+warm_pool_refill_unlocked (GstRTSPMediaFactory * factory, const gchar * key,
+    WarmPool * pool)
+{
+  GstRTSPMediaFactoryPrivate *priv = factory->priv;
+
+  while (!pool->disabled &&
+      pool->medias.length + pool->pending < priv->warm_pool_size) {
+    WarmJob *job = g_slice_new (WarmJob);
+
+    job->factory = g_object_ref (factory);
+    job->key = g_strdup (key);
+    pool->pending++;
+    g_thread_pool_push (get_warm_thread_pool (), job, NULL);
+  }
+}
+
 /**
  * gst_rtsp_media_factory_construct:
  * @factory: a #GstRTSPMediaFactory
@@ -1408,26 +1623,39 @@ gst_rtsp_media_factory_construct (GstRTSPMediaFactory * factory,
   } else
     media = NULL;
 
+  if (media == NULL && key && priv->warm_pool_size > 0 &&
+      !gst_rtsp_media_factory_is_shared (factory)) {
+    WarmPool *pool;
+
+    pool = g_hash_table_lookup (priv->warm_pools, key);
+    if (pool == NULL) {
+      pool = g_slice_new0 (WarmPool);
+      g_queue_init (&pool->medias);
+      pool->url = gst_rtsp_url_copy (url);
+      g_hash_table_insert (priv->warm_pools, g_strdup (key), pool);
+    }
+    if (!pool->disabled) {
+      media = g_queue_pop_head (&pool->medias);
+      if (media) {
+        GST_INFO ("using warm media %p for url %s", media, url->abspath);
+        /* the caller prepares the media again */
+        gst_rtsp_media_release_prepare (media);
+      }
+      warm_pool_refill_unlocked (factory, key, pool);
+    }
+  }
+
   if (media == NULL) {
     /* nothing cached found, try to create one */
-    if (klass->construct) {
-      media = klass->construct (factory, url);
-      if (media)
-        g_signal_emit (factory,
-            gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONSTRUCTED], 0, media,
-            NULL);
-    } else
-      media = NULL;
+    media = construct_media (factory, url);
 
     if (media) {
-      /* configure the media */
-      if (klass->configure)
-        klass->configure (factory, media);
-
-      g_signal_emit (factory,
-          gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONFIGURE], 0, media,
-          NULL);
+      if (key && !media_can_warm (media)) {
+        WarmPool *pool = g_hash_table_lookup (priv->warm_pools, key);
 
+        if (pool)
+          pool->disabled = TRUE;
+      }
       /* check if we can cache this media */
       if (gst_rtsp_media_is_shared (media) && key) {
         /* insert in the hashtable, takes ownership of the key */
@@ -1435,13 +1663,6 @@ gst_rtsp_media_factory_construct (GstRTSPMediaFactory * factory,
         g_hash_table_insert (priv->medias, key, media);
         key = NULL;
       }
-      if (!gst_rtsp_media_is_reusable (media)) {
-        /* when not reusable, connect to the unprepare signal to remove the item
-         * from our cache when it gets unprepared */
-        g_signal_connect_data (media, "unprepared",
-            (GCallback) media_unprepared, weak_ref_new (factory),
-            (GClosureNotify) weak_ref_free, 0);
-      }
     }
   }
   g_mutex_unlock (&priv->medias_lock);
@@ -1762,6 +1983,82 @@ gst_rtsp_media_factory_is_enable_rtcp (GstRTSPMediaFactory * factory)
   return result;
 }
 
+/**
+ * gst_rtsp_media_factory_set_warm_pool_size:
+ * @factory: a #GstRTSPMediaFactory
+ * @size: the number of warm media
+ *
+ * Keep @size prepared media ready for each url @factory constructs media
+ * for. gst_rtsp_media_factory_construct() hands out one of these instead of
+ * constructing a new media and the pool is refilled in the background, so
+ * that clients don't have to wait for the pipeline to preroll.
+ *
+ * Only media that is not shared and not in record mode is kept warm. The
+ * media is constructed and configured when it is added to the pool, this is also
+ * when the #GstRTSPMediaFactory::media-constructed and
+ * #GstRTSPMediaFactory::media-configure signals are emitted for it.
+ *
+ * A @size of 0 disables the pool.
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_media_factory_set_warm_pool_size (GstRTSPMediaFactory * factory,
+    guint size)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+  GHashTableIter iter;
+  gpointer key, value;
+  GQueue trimmed = G_QUEUE_INIT;
+  GstRTSPMedia *media;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory));
+
+  priv = factory->priv;
+
+  g_mutex_lock (&priv->medias_lock);
+  priv->warm_pool_size = size;
+  g_hash_table_iter_init (&iter, priv->warm_pools);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    WarmPool *pool = value;
+
+    while (pool->medias.length > size)
+      g_queue_push_tail (&trimmed, g_queue_pop_tail (&pool->medias));
+    warm_pool_refill_unlocked (factory, key, pool);
+  }
+  g_mutex_unlock (&priv->medias_lock);
+
+  while ((media = g_queue_pop_head (&trimmed)))
+    warm_media_release (media);
+}
+
+/**
+ * gst_rtsp_media_factory_get_warm_pool_size:
+ * @factory: a #GstRTSPMediaFactory
+ *
+ * Get the number of prepared media @factory keeps ready for each url.
+ *
+ * Returns: the warm pool size
+ *
+ * Since: 1.22
+ */
+guint
+gst_rtsp_media_factory_get_warm_pool_size (GstRTSPMediaFactory * factory)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+  guint result;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory), 0);
+
+  priv = factory->priv;
+
+  g_mutex_lock (&priv->medias_lock);
+  result = priv->warm_pool_size;
+  g_mutex_unlock (&priv->medias_lock);
+
+  return result;
+}
+
 static gchar *
 default_gen_key (GstRTSPMediaFactory * factory, const GstRTSPUrl * url)
 {
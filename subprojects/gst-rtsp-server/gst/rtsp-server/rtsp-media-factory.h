@@ -265,6 +265,13 @@ void                  gst_rtsp_media_factory_set_enable_rtcp (GstRTSPMediaFactor
 GST_RTSP_SERVER_API
 gboolean              gst_rtsp_media_factory_is_enable_rtcp (GstRTSPMediaFactory * factory);
 
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_factory_set_warm_pool_size (GstRTSPMediaFactory * factory,
+                                                                 guint size);
+
+GST_RTSP_SERVER_API
+guint                 gst_rtsp_media_factory_get_warm_pool_size (GstRTSPMediaFactory * factory);
+
 /* creating the media from the factory and a url */
 
 GST_RTSP_SERVER_API
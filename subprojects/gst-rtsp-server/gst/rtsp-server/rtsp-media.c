@@ -2120,6 +2120,24 @@ gst_rtsp_media_set_enable_rtcp (GstRTSPMedia * media, gboolean enable)
   g_mutex_unlock (&priv->lock);
 }
 
+/* Drop the prepare count taken by whoever prepared @media without
+ * unpreparing it, the media stays prepared until the next user that
+ * prepares it also unprepares it. Used for the warm pool of the factory. */
+void
+gst_rtsp_media_release_prepare (GstRTSPMedia * media)
+{
+  GstRTSPMediaPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA (media));
+
+  priv = media->priv;
+
+  g_rec_mutex_lock (&priv->state_lock);
+  if (priv->prepare_count > 0)
+    priv->prepare_count--;
+  g_rec_mutex_unlock (&priv->state_lock);
+}
+
 static GList *
 _find_payload_types (GstRTSPMedia * media)
 {
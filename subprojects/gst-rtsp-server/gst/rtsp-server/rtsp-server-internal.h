@@ -28,6 +28,10 @@ G_BEGIN_DECLS
 
 /* Internal GstRTSPStreamTransport interface */
 
+/* a TCP transport is dropped when its backlog exceeds both limits */
+#define MAX_BACKLOG_DURATION (10 * GST_SECOND)
+#define MAX_BACKLOG_SIZE 100
+
 typedef gboolean (*GstRTSPBackPressureFunc) (guint8 channel, gpointer user_data);
 
 gboolean                 gst_rtsp_stream_transport_backlog_push  (GstRTSPStreamTransport *trans,
@@ -59,6 +63,7 @@ gboolean                 gst_rtsp_stream_transport_check_back_pressure (GstRTSPS
 gboolean                 gst_rtsp_stream_is_tcp_receiver (GstRTSPStream * stream);
 
 void                     gst_rtsp_media_set_enable_rtcp (GstRTSPMedia *media, gboolean enable);
+void                     gst_rtsp_media_release_prepare (GstRTSPMedia *media);
 void                     gst_rtsp_stream_set_enable_rtcp (GstRTSPStream *stream, gboolean enable);
 
 G_END_DECLS
@@ -37,6 +37,11 @@
  * or use gst_rtsp_session_pool_create_watch() to be notified when session
  * cleanup should be performed.
  *
+ * The sessions are spread over several shards, each with its own lock, so
+ * that lookups of different sessions do not contend. The timeouts are kept in
+ * a timer wheel so that the cleanup only inspects the sessions that might have
+ * expired.
+ *
  * Last reviewed on 2013-07-11 (1.0.0)
  */
 #ifdef HAVE_CONFIG_H
@@ -45,12 +50,47 @@
 
 #include "rtsp-session-pool.h"
 
-struct _GstRTSPSessionPoolPrivate
+/* must be a power of 2 */
+#define N_SHARDS        16
+
+/* granularity and number of slots of the timer wheel, the wheel covers
+ * slightly more than the default session timeout */
+#define WHEEL_TICK      (G_USEC_PER_SEC / 4)
+#define WHEEL_SLOTS     256
+
+#define TICK_NONE       -1
+#define TICK_EXPIRED    -2
+
+typedef struct
+{
+  GstRTSPSession *session;
+  GstRTSPSessionPoolPrivate *priv;
+  gulong notify_id;
+
+  /* protected by the pool lock */
+  GList link;
+  gint64 tick;
+} PoolEntry;
+
+typedef struct
 {
-  GMutex lock;                  /* protects everything in this struct */
-  guint max_sessions;
-  GHashTable *sessions;
+  GRWLock lock;                 /* protects sessions and sessions_cookie */
+  GHashTable *sessions;         /* sessionid -> PoolEntry */
   guint sessions_cookie;
+} PoolShard;
+
+struct _GstRTSPSessionPoolPrivate
+{
+  gint max_sessions;            /* atomic */
+  gint n_sessions;              /* atomic */
+
+  PoolShard shards[N_SHARDS];
+
+  /* lock order: shard lock, lock */
+  GMutex lock;                  /* protects the timer wheel */
+  GQueue wheel[WHEEL_SLOTS];    /* of PoolEntry */
+  gint64 wheel_tick;            /* first tick in the wheel */
+  GQueue expired;               /* of PoolEntry */
 };
 
 #define DEFAULT_MAX_SESSIONS 0
@@ -90,10 +130,161 @@ static void gst_rtsp_session_pool_finalize (GObject * object);
 static gchar *create_session_id (GstRTSPSessionPool * pool);
 static GstRTSPSession *create_session (GstRTSPSessionPool * pool,
     const gchar * id);
+static void pool_entry_free (PoolEntry * entry);
 
 G_DEFINE_TYPE_WITH_PRIVATE (GstRTSPSessionPool, gst_rtsp_session_pool,
     G_TYPE_OBJECT);
 
+static inline PoolShard *
+get_shard (GstRTSPSessionPoolPrivate * priv, const gchar * sessionid)
+{
+  return &priv->shards[g_str_hash (sessionid) & (N_SHARDS - 1)];
+}
+
+/* with priv->lock, @entry must not be scheduled */
+static void
+wheel_schedule (GstRTSPSessionPoolPrivate * priv, PoolEntry * entry,
+    gint64 now)
+{
+  gint timeout;
+  gint64 tick;
+
+  timeout = gst_rtsp_session_next_timeout_usec (entry->session, now);
+  if (timeout < 0) {
+    /* never times out, scheduled again when the timeout changes */
+    entry->tick = TICK_NONE;
+    return;
+  }
+
+  if (timeout == 0) {
+    entry->tick = TICK_EXPIRED;
+    g_queue_push_tail_link (&priv->expired, &entry->link);
+    return;
+  }
+
+  /* round up so that the session expired when its tick is reached, sessions
+   * beyond the end of the wheel are checked again at the end */
+  tick = (now + (gint64) timeout * 1000 + WHEEL_TICK - 1) / WHEEL_TICK;
+  tick = CLAMP (tick, priv->wheel_tick, priv->wheel_tick + WHEEL_SLOTS - 1);
+
+  entry->tick = tick;
+  g_queue_push_tail_link (&priv->wheel[tick % WHEEL_SLOTS], &entry->link);
+}
+
+/* with priv->lock */
+static void
+wheel_unschedule (GstRTSPSessionPoolPrivate * priv, PoolEntry * entry)
+{
+  if (entry->tick == TICK_NONE)
+    return;
+
+  if (entry->tick == TICK_EXPIRED)
+    g_queue_unlink (&priv->expired, &entry->link);
+  else
+    g_queue_unlink (&priv->wheel[entry->tick % WHEEL_SLOTS], &entry->link);
+
+  entry->tick = TICK_NONE;
+}
+
+/* with priv->lock. Checks the sessions of all the ticks up to @now again.
+ * The sessions are only inspected here, touching a session does not move it
+ * in the wheel. */
+static void
+wheel_advance (GstRTSPSessionPoolPrivate * priv, gint64 now)
+{
+  gint64 now_tick = now / WHEEL_TICK;
+  GQueue due = G_QUEUE_INIT;
+  GList *link;
+  gint64 i, n;
+
+  if (priv->wheel_tick > now_tick)
+    return;
+
+  n = MIN (now_tick - priv->wheel_tick + 1, WHEEL_SLOTS);
+  for (i = 0; i < n; i++) {
+    GQueue *slot = &priv->wheel[(priv->wheel_tick + i) % WHEEL_SLOTS];
+
+    if (g_queue_is_empty (slot))
+      continue;
+
+    if (g_queue_is_empty (&due)) {
+      due = *slot;
+    } else {
+      due.tail->next = slot->head;
+      slot->head->prev = due.tail;
+      due.tail = slot->tail;
+      due.length += slot->length;
+    }
+    g_queue_init (slot);
+  }
+  priv->wheel_tick = now_tick + 1;
+
+  while ((link = g_queue_pop_head_link (&due))) {
+    PoolEntry *entry = link->data;
+
+    entry->tick = TICK_NONE;
+    wheel_schedule (priv, entry, now);
+  }
+}
+
+static void
+on_session_notify (GstRTSPSession * session, GParamSpec * pspec,
+    GstRTSPSessionPoolPrivate * priv)
+{
+  PoolShard *shard;
+  PoolEntry *entry;
+
+  if (g_strcmp0 (pspec->name, "timeout") != 0 &&
+      g_strcmp0 (pspec->name, "extra-timeout") != 0)
+    return;
+
+  /* the session can expire earlier now, schedule it again */
+  shard = get_shard (priv, gst_rtsp_session_get_sessionid (session));
+  g_rw_lock_reader_lock (&shard->lock);
+  entry = g_hash_table_lookup (shard->sessions,
+      gst_rtsp_session_get_sessionid (session));
+  if (entry && entry->session == session) {
+    g_mutex_lock (&priv->lock);
+    wheel_unschedule (priv, entry);
+    wheel_schedule (priv, entry, g_get_monotonic_time ());
+    g_mutex_unlock (&priv->lock);
+  }
+  g_rw_lock_reader_unlock (&shard->lock);
+}
+
+static PoolEntry *
+pool_entry_new (GstRTSPSessionPoolPrivate * priv, GstRTSPSession * session)
+{
+  PoolEntry *entry;
+
+  entry = g_new0 (PoolEntry, 1);
+  entry->session = session;
+  entry->priv = priv;
+  entry->link.data = entry;
+  entry->tick = TICK_NONE;
+  entry->notify_id = g_signal_connect (session, "notify",
+      G_CALLBACK (on_session_notify), priv);
+
+  return entry;
+}
+
+/* called with the shard lock when the entry is removed from the shard */
+static void
+pool_entry_free (PoolEntry * entry)
+{
+  GstRTSPSessionPoolPrivate *priv = entry->priv;
+
+  g_mutex_lock (&priv->lock);
+  wheel_unschedule (priv, entry);
+  g_mutex_unlock (&priv->lock);
+
+  g_atomic_int_add (&priv->n_sessions, -1);
+
+  g_signal_handler_disconnect (entry->session, entry->notify_id);
+  g_object_unref (entry->session);
+  g_free (entry);
+}
+
 static void
 gst_rtsp_session_pool_class_init (GstRTSPSessionPoolClass * klass)
 {
@@ -128,12 +319,22 @@ static void
 gst_rtsp_session_pool_init (GstRTSPSessionPool * pool)
 {
   GstRTSPSessionPoolPrivate *priv;
+  guint i;
 
   pool->priv = priv = gst_rtsp_session_pool_get_instance_private (pool);
 
+  for (i = 0; i < N_SHARDS; i++) {
+    g_rw_lock_init (&priv->shards[i].lock);
+    priv->shards[i].sessions = g_hash_table_new_full (g_str_hash, g_str_equal,
+        NULL, (GDestroyNotify) pool_entry_free);
+  }
+
   g_mutex_init (&priv->lock);
-  priv->sessions = g_hash_table_new_full (g_str_hash, g_str_equal,
-      NULL, g_object_unref);
+  for (i = 0; i < WHEEL_SLOTS; i++)
+    g_queue_init (&priv->wheel[i]);
+  priv->wheel_tick = g_get_monotonic_time () / WHEEL_TICK;
+  g_queue_init (&priv->expired);
+
   priv->max_sessions = DEFAULT_MAX_SESSIONS;
 }
 
@@ -149,9 +350,13 @@ gst_rtsp_session_pool_finalize (GObject * object)
 {
   GstRTSPSessionPool *pool = GST_RTSP_SESSION_POOL (object);
   GstRTSPSessionPoolPrivate *priv = pool->priv;
+  guint i;
 
   gst_rtsp_session_pool_filter (pool, remove_sessions_func, NULL);
-  g_hash_table_unref (priv->sessions);
+  for (i = 0; i < N_SHARDS; i++) {
+    g_hash_table_unref (priv->shards[i].sessions);
+    g_rw_lock_clear (&priv->shards[i].lock);
+  }
   g_mutex_clear (&priv->lock);
 
   G_OBJECT_CLASS (gst_rtsp_session_pool_parent_class)->finalize (object);
@@ -224,9 +429,7 @@ gst_rtsp_session_pool_set_max_sessions (GstRTSPSessionPool * pool, guint max)
 
   priv = pool->priv;
 
-  g_mutex_lock (&priv->lock);
-  priv->max_sessions = max;
-  g_mutex_unlock (&priv->lock);
+  g_atomic_int_set (&priv->max_sessions, max);
 }
 
 /**
@@ -248,9 +451,7 @@ gst_rtsp_session_pool_get_max_sessions (GstRTSPSessionPool * pool)
 
   priv = pool->priv;
 
-  g_mutex_lock (&priv->lock);
-  result = priv->max_sessions;
-  g_mutex_unlock (&priv->lock);
+  result = g_atomic_int_get (&priv->max_sessions);
 
   return result;
 }
@@ -273,9 +474,7 @@ gst_rtsp_session_pool_get_n_sessions (GstRTSPSessionPool * pool)
 
   priv = pool->priv;
 
-  g_mutex_lock (&priv->lock);
-  result = g_hash_table_size (priv->sessions);
-  g_mutex_unlock (&priv->lock);
+  result = g_atomic_int_get (&priv->n_sessions);
 
   return result;
 }
@@ -294,21 +493,24 @@ gst_rtsp_session_pool_get_n_sessions (GstRTSPSessionPool * pool)
 GstRTSPSession *
 gst_rtsp_session_pool_find (GstRTSPSessionPool * pool, const gchar * sessionid)
 {
-  GstRTSPSessionPoolPrivate *priv;
-  GstRTSPSession *result;
+  PoolShard *shard;
+  PoolEntry *entry;
+  GstRTSPSession *result = NULL;
 
   g_return_val_if_fail (GST_IS_RTSP_SESSION_POOL (pool), NULL);
   g_return_val_if_fail (sessionid != NULL, NULL);
 
-  priv = pool->priv;
+  shard = get_shard (pool->priv, sessionid);
 
-  g_mutex_lock (&priv->lock);
-  result = g_hash_table_lookup (priv->sessions, sessionid);
-  if (result) {
-    g_object_ref (result);
+  /* only the access time of the session is updated, the timer wheel sees
+   * the new timeout when the session is due */
+  g_rw_lock_reader_lock (&shard->lock);
+  entry = g_hash_table_lookup (shard->sessions, sessionid);
+  if (entry) {
+    result = g_object_ref (entry->session);
     gst_rtsp_session_touch (result);
   }
-  g_mutex_unlock (&priv->lock);
+  g_rw_lock_reader_unlock (&shard->lock);
 
   return result;
 }
@@ -348,8 +550,10 @@ gst_rtsp_session_pool_create (GstRTSPSessionPool * pool)
   GstRTSPSessionPoolPrivate *priv;
   GstRTSPSession *result = NULL;
   GstRTSPSessionPoolClass *klass;
+  PoolShard *shard;
   gchar *id = NULL;
   guint retry;
+  gint max_sessions;
 
   g_return_val_if_fail (GST_IS_RTSP_SESSION_POOL (pool), NULL);
 
@@ -369,33 +573,45 @@ gst_rtsp_session_pool_create (GstRTSPSessionPool * pool)
     if (id == NULL)
       goto no_session;
 
-    g_mutex_lock (&priv->lock);
-    /* check session limit */
-    if (priv->max_sessions > 0) {
-      if (g_hash_table_size (priv->sessions) >= priv->max_sessions)
-        goto too_many_sessions;
+    /* check session limit, reserve our place so that concurrent creates in
+     * other shards can't go over the limit */
+    max_sessions = g_atomic_int_get (&priv->max_sessions);
+    if (g_atomic_int_add (&priv->n_sessions, 1) >= max_sessions &&
+        max_sessions > 0) {
+      g_atomic_int_add (&priv->n_sessions, -1);
+      goto too_many_sessions;
     }
+
+    shard = get_shard (priv, id);
+    g_rw_lock_writer_lock (&shard->lock);
     /* check if the sessionid existed */
-    result = g_hash_table_lookup (priv->sessions, id);
-    if (result) {
+    if (g_hash_table_contains (shard->sessions, id)) {
       /* found, retry with a different session id */
-      result = NULL;
+      g_atomic_int_add (&priv->n_sessions, -1);
       retry++;
       if (retry > 100)
         goto collision;
     } else {
+      PoolEntry *entry;
+
       /* not found, create session and insert it in the pool */
       if (klass->create_session)
         result = klass->create_session (pool, id);
-      if (result == NULL)
-        goto too_many_sessions;
+      if (result == NULL) {
+        g_atomic_int_add (&priv->n_sessions, -1);
+        goto no_create;
+      }
       /* take additional ref for the pool */
-      g_object_ref (result);
-      g_hash_table_insert (priv->sessions,
-          (gchar *) gst_rtsp_session_get_sessionid (result), result);
-      priv->sessions_cookie++;
+      entry = pool_entry_new (priv, g_object_ref (result));
+      g_hash_table_insert (shard->sessions,
+          (gchar *) gst_rtsp_session_get_sessionid (result), entry);
+      shard->sessions_cookie++;
+
+      g_mutex_lock (&priv->lock);
+      wheel_schedule (priv, entry, g_get_monotonic_time ());
+      g_mutex_unlock (&priv->lock);
     }
-    g_mutex_unlock (&priv->lock);
+    g_rw_lock_writer_unlock (&shard->lock);
 
     g_free (id);
   } while (result == NULL);
@@ -416,14 +632,20 @@ no_session:
 collision:
   {
     GST_WARNING ("can't find unique sessionid for GstRTSPSessionPool %p", pool);
-    g_mutex_unlock (&priv->lock);
+    g_rw_lock_writer_unlock (&shard->lock);
     g_free (id);
     return NULL;
   }
 too_many_sessions:
   {
-    GST_WARNING ("session pool reached max sessions of %d", priv->max_sessions);
-    g_mutex_unlock (&priv->lock);
+    GST_WARNING ("session pool reached max sessions of %d", max_sessions);
+    g_free (id);
+    return NULL;
+  }
+no_create:
+  {
+    GST_WARNING ("can't create session with GstRTSPSessionPool %p", pool);
+    g_rw_lock_writer_unlock (&shard->lock);
     g_free (id);
     return NULL;
   }
@@ -441,22 +663,25 @@ too_many_sessions:
 gboolean
 gst_rtsp_session_pool_remove (GstRTSPSessionPool * pool, GstRTSPSession * sess)
 {
-  GstRTSPSessionPoolPrivate *priv;
-  gboolean found;
+  PoolShard *shard;
+  PoolEntry *entry;
+  const gchar *sessionid;
+  gboolean found = FALSE;
 
   g_return_val_if_fail (GST_IS_RTSP_SESSION_POOL (pool), FALSE);
   g_return_val_if_fail (GST_IS_RTSP_SESSION (sess), FALSE);
 
-  priv = pool->priv;
+  sessionid = gst_rtsp_session_get_sessionid (sess);
+  shard = get_shard (pool->priv, sessionid);
 
-  g_mutex_lock (&priv->lock);
+  g_rw_lock_writer_lock (&shard->lock);
   g_object_ref (sess);
-  found =
-      g_hash_table_remove (priv->sessions,
-      gst_rtsp_session_get_sessionid (sess));
-  if (found)
-    priv->sessions_cookie++;
-  g_mutex_unlock (&priv->lock);
+  entry = g_hash_table_lookup (shard->sessions, sessionid);
+  if (entry && entry->session == sess) {
+    found = g_hash_table_remove (shard->sessions, sessionid);
+    shard->sessions_cookie++;
+  }
+  g_rw_lock_writer_unlock (&shard->lock);
 
   if (found)
     g_signal_emit (pool, gst_rtsp_session_pool_signals[SIGNAL_SESSION_REMOVED],
@@ -467,28 +692,6 @@ gst_rtsp_session_pool_remove (GstRTSPSessionPool * pool, GstRTSPSession * sess)
   return found;
 }
 
-typedef struct
-{
-  gint64 now_monotonic_time;
-  GstRTSPSessionPool *pool;
-  GList *removed;
-} CleanupData;
-
-static gboolean
-cleanup_func (gchar * sessionid, GstRTSPSession * sess, CleanupData * data)
-{
-  gboolean expired;
-
-  expired = gst_rtsp_session_is_expired_usec (sess, data->now_monotonic_time);
-
-  if (expired) {
-    GST_DEBUG ("session expired");
-    data->removed = g_list_prepend (data->removed, g_object_ref (sess));
-  }
-
-  return expired;
-}
-
 /**
  * gst_rtsp_session_pool_cleanup:
  * @pool: a #GstRTSPSessionPool
@@ -502,28 +705,59 @@ guint
 gst_rtsp_session_pool_cleanup (GstRTSPSessionPool * pool)
 {
   GstRTSPSessionPoolPrivate *priv;
-  guint result;
-  CleanupData data;
-  GList *walk;
+  guint result = 0;
+  gint64 now;
+  GList *walk, *expired = NULL, *removed = NULL;
+  GQueue pending;
 
   g_return_val_if_fail (GST_IS_RTSP_SESSION_POOL (pool), 0);
 
   priv = pool->priv;
 
-  data.now_monotonic_time = g_get_monotonic_time ();
-
-  data.pool = pool;
-  data.removed = NULL;
+  now = g_get_monotonic_time ();
 
+  /* collect the expired sessions, the sessions that were touched in the
+   * meantime are scheduled again */
   g_mutex_lock (&priv->lock);
-  result =
-      g_hash_table_foreach_remove (priv->sessions, (GHRFunc) cleanup_func,
-      &data);
-  if (result > 0)
-    priv->sessions_cookie++;
+  wheel_advance (priv, now);
+  pending = priv->expired;
+  g_queue_init (&priv->expired);
+  while (!g_queue_is_empty (&pending)) {
+    PoolEntry *entry = g_queue_pop_head_link (&pending)->data;
+
+    entry->tick = TICK_NONE;
+    wheel_schedule (priv, entry, now);
+    if (entry->tick == TICK_EXPIRED)
+      expired = g_list_prepend (expired, g_object_ref (entry->session));
+  }
   g_mutex_unlock (&priv->lock);
 
-  for (walk = data.removed; walk; walk = walk->next) {
+  for (walk = expired; walk; walk = walk->next) {
+    GstRTSPSession *sess = walk->data;
+    const gchar *sessionid = gst_rtsp_session_get_sessionid (sess);
+    PoolShard *shard = get_shard (priv, sessionid);
+    PoolEntry *entry;
+    gboolean is_expired = FALSE;
+
+    g_rw_lock_writer_lock (&shard->lock);
+    entry = g_hash_table_lookup (shard->sessions, sessionid);
+    if (entry && entry->session == sess) {
+      g_mutex_lock (&priv->lock);
+      is_expired = (entry->tick == TICK_EXPIRED);
+      g_mutex_unlock (&priv->lock);
+    }
+    if (is_expired) {
+      GST_DEBUG ("session expired");
+      g_hash_table_remove (shard->sessions, sessionid);
+      shard->sessions_cookie++;
+      removed = g_list_prepend (removed, g_object_ref (sess));
+      result++;
+    }
+    g_rw_lock_writer_unlock (&shard->lock);
+  }
+  g_list_free_full (expired, g_object_unref);
+
+  for (walk = removed; walk; walk = walk->next) {
     GstRTSPSession *sess = walk->data;
 
     g_signal_emit (pool,
@@ -531,7 +765,7 @@ gst_rtsp_session_pool_cleanup (GstRTSPSessionPool * pool)
 
     g_object_unref (sess);
   }
-  g_list_free (data.removed);
+  g_list_free (removed);
 
   return result;
 }
@@ -570,7 +804,7 @@ gst_rtsp_session_pool_filter (GstRTSPSessionPool * pool,
   gpointer key, value;
   GList *result;
   GHashTable *visited;
-  guint cookie;
+  guint i, cookie;
 
   g_return_val_if_fail (GST_IS_RTSP_SESSION_POOL (pool), NULL);
 
@@ -580,70 +814,83 @@ gst_rtsp_session_pool_filter (GstRTSPSessionPool * pool,
   if (func)
     visited = g_hash_table_new_full (NULL, NULL, g_object_unref, NULL);
 
-  g_mutex_lock (&priv->lock);
-restart:
-  g_hash_table_iter_init (&iter, priv->sessions);
-  cookie = priv->sessions_cookie;
-  while (g_hash_table_iter_next (&iter, &key, &value)) {
-    GstRTSPSession *session = value;
-    GstRTSPFilterResult res;
-    gboolean changed;
-
-    if (func) {
-      /* only visit each session once */
-      if (g_hash_table_contains (visited, session))
-        continue;
-
-      g_hash_table_add (visited, g_object_ref (session));
-      g_mutex_unlock (&priv->lock);
-
-      res = func (pool, session, user_data);
-
-      g_mutex_lock (&priv->lock);
-    } else
-      res = GST_RTSP_FILTER_REF;
-
-    changed = (cookie != priv->sessions_cookie);
-
-    switch (res) {
-      case GST_RTSP_FILTER_REMOVE:
-      {
-        gboolean removed = TRUE;
-
-        if (changed)
-          /* something changed, check if we still have the session */
-          removed = g_hash_table_remove (priv->sessions, key);
-        else
-          g_hash_table_iter_remove (&iter);
-
-        if (removed) {
-          /* if we managed to remove the session, update the cookie and
-           * signal */
-          cookie = ++priv->sessions_cookie;
-          g_mutex_unlock (&priv->lock);
-
-          g_signal_emit (pool,
-              gst_rtsp_session_pool_signals[SIGNAL_SESSION_REMOVED], 0,
-              session);
-
-          g_mutex_lock (&priv->lock);
-          /* cookie could have changed again, make sure we restart */
-          changed |= (cookie != priv->sessions_cookie);
+  for (i = 0; i < N_SHARDS; i++) {
+    PoolShard *shard = &priv->shards[i];
+
+    g_rw_lock_writer_lock (&shard->lock);
+  restart:
+    g_hash_table_iter_init (&iter, shard->sessions);
+    cookie = shard->sessions_cookie;
+    while (g_hash_table_iter_next (&iter, &key, &value)) {
+      PoolEntry *entry = value;
+      GstRTSPSession *session = entry->session;
+      GstRTSPFilterResult res;
+      gboolean changed;
+
+      if (func) {
+        /* only visit each session once */
+        if (g_hash_table_contains (visited, session))
+          continue;
+
+        g_hash_table_add (visited, g_object_ref (session));
+        g_rw_lock_writer_unlock (&shard->lock);
+
+        res = func (pool, session, user_data);
+
+        g_rw_lock_writer_lock (&shard->lock);
+      } else
+        res = GST_RTSP_FILTER_REF;
+
+      changed = (cookie != shard->sessions_cookie);
+
+      switch (res) {
+        case GST_RTSP_FILTER_REMOVE:
+        {
+          gboolean removed = TRUE;
+
+          /* keep the session alive for the signal, the entry owns the ref
+           * of the pool */
+          g_object_ref (session);
+
+          if (changed) {
+            /* something changed, check if we still have the session */
+            entry = g_hash_table_lookup (shard->sessions, key);
+            removed = (entry && entry->session == session);
+            if (removed)
+              g_hash_table_remove (shard->sessions, key);
+          } else
+            g_hash_table_iter_remove (&iter);
+
+          if (removed) {
+            /* if we managed to remove the session, update the cookie and
+             * signal */
+            cookie = ++shard->sessions_cookie;
+            g_rw_lock_writer_unlock (&shard->lock);
+
+            g_signal_emit (pool,
+                gst_rtsp_session_pool_signals[SIGNAL_SESSION_REMOVED], 0,
+                session);
+
+            g_rw_lock_writer_lock (&shard->lock);
+            /* cookie could have changed again, make sure we restart */
+            changed |= (cookie != shard->sessions_cookie);
+          }
+          g_object_unref (session);
+          break;
         }
-        break;
+        case GST_RTSP_FILTER_REF:
+          /* keep ref */
+          result = g_list_prepend (result, g_object_ref (session));
+          break;
+        case GST_RTSP_FILTER_KEEP:
+        default:
+          break;
       }
-      case GST_RTSP_FILTER_REF:
-        /* keep ref */
-        result = g_list_prepend (result, g_object_ref (session));
-        break;
-      case GST_RTSP_FILTER_KEEP:
-      default:
-        break;
+      if (changed)
+        goto restart;
     }
-    if (changed)
-      goto restart;
+    g_rw_lock_writer_unlock (&shard->lock);
   }
-  g_mutex_unlock (&priv->lock);
 
   if (func)
     g_hash_table_unref (visited);
@@ -658,19 +905,26 @@ typedef struct
   gint timeout;
 } GstPoolSource;
 
-static void
-collect_timeout (gchar * sessionid, GstRTSPSession * sess, GstPoolSource * psrc)
+/* with priv->lock, the timeout in milliseconds until the next tick of the
+ * wheel with sessions or -1 */
+static gint
+wheel_next_timeout (GstRTSPSessionPoolPrivate * priv, gint64 now)
 {
-  gint timeout;
-  gint64 now_monotonic_time;
+  gint64 i;
+
+  wheel_advance (priv, now);
 
-  now_monotonic_time = g_get_monotonic_time ();
+  if (!g_queue_is_empty (&priv->expired))
+    return 0;
 
-  timeout = gst_rtsp_session_next_timeout_usec (sess, now_monotonic_time);
+  for (i = 0; i < WHEEL_SLOTS; i++) {
+    gint64 tick = priv->wheel_tick + i;
+
+    if (!g_queue_is_empty (&priv->wheel[tick % WHEEL_SLOTS]))
+      return MAX (tick * WHEEL_TICK - now + 999, 0) / 1000;
+  }
 
-  GST_INFO ("%p: next timeout: %d", sess, timeout);
-  if (psrc->timeout == -1 || timeout < psrc->timeout)
-    psrc->timeout = timeout;
+  return -1;
 }
 
 static gboolean
@@ -681,11 +935,10 @@ gst_pool_source_prepare (GSource * source, gint * timeout)
   gboolean result;
 
   psrc = (GstPoolSource *) source;
-  psrc->timeout = -1;
   priv = psrc->pool->priv;
 
   g_mutex_lock (&priv->lock);
-  g_hash_table_foreach (priv->sessions, (GHFunc) collect_timeout, psrc);
+  psrc->timeout = wheel_next_timeout (priv, g_get_monotonic_time ());
   g_mutex_unlock (&priv->lock);
 
   if (timeout)
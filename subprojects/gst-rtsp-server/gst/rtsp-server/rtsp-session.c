@@ -623,6 +623,9 @@ gst_rtsp_session_set_timeout (GstRTSPSession * session, guint timeout)
   g_mutex_lock (&priv->lock);
   priv->timeout = timeout;
   g_mutex_unlock (&priv->lock);
+
+  /* let the session pool schedule the new timeout */
+  g_object_notify (G_OBJECT (session), "timeout");
 }
 
 /**
@@ -92,9 +92,6 @@ struct _GstRTSPStreamTransportPrivate
   GRecMutex backlog_lock;
 };
 
-#define MAX_BACKLOG_DURATION (10 * GST_SECOND)
-#define MAX_BACKLOG_SIZE 100
-
 typedef struct
 {
   GstBuffer *buffer;
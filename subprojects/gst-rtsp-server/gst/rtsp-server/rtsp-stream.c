@@ -63,6 +63,12 @@
  *
  * Once the backlog reaches an overly large duration, the transport is dropped as
  * the client was deemed too slow.
+ *
+ * With gst_rtsp_stream_set_gop_cache_size() the RTP samples sent by rtpbin
+ * since the last keyframe are kept, whether or not there are transports, and
+ * queued on the backlog of TCP transports when they are added. Clients joining
+ * a shared live stream can then start decoding right away instead of waiting
+ * for the next keyframe.
  */
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -230,6 +236,21 @@ struct _GstRTSPStreamPrivate
   gulong block_early_rtcp_probe;
   GstPad *block_early_rtcp_pad_ipv6;
   gulong block_early_rtcp_probe_ipv6;
+
+  /* GOP cache for TCP transports, protected by lock. Contains the RTP samples
+   * since the last keyframe if gop_cache_valid */
+  guint gop_cache_size;
+  GQueue gop_cache;
+  gsize gop_cache_bytes;
+  gboolean gop_cache_valid;
+  GstPad *gop_sink_pad;
+  gulong gop_sink_probe;
+  gulong gop_send_probe;
+  /* set when the payloader receives a keyframe, accessed atomically */
+  gint gop_keyframe_pending;
+  /* TCP transports that got the cache, with the last cached sample they got.
+   * Live samples up to that one are not sent to them again */
+  GHashTable *gop_cache_joined;
 };
 
 #define DEFAULT_CONTROL         NULL
@@ -240,6 +261,12 @@ struct _GstRTSPStreamPrivate
 #define DEFAULT_BIND_MCAST_ADDRESS FALSE
 #define DEFAULT_DO_RATE_CONTROL TRUE
 #define DEFAULT_ENABLE_RTCP TRUE
+#define DEFAULT_GOP_CACHE_SIZE 0
+
+/* stay well below the backlog limits at which a TCP transport is dropped, so
+ * that the live data can still be queued behind a burst of cached samples */
+#define GOP_CACHE_MAX_SAMPLES (MAX_BACKLOG_SIZE / 2)
+#define GOP_CACHE_MAX_DURATION (MAX_BACKLOG_DURATION / 2)
 
 enum
 {
@@ -340,6 +367,10 @@ gst_rtsp_stream_init (GstRTSPStream * stream)
   priv->bind_mcast_address = DEFAULT_BIND_MCAST_ADDRESS;
   priv->do_rate_control = DEFAULT_DO_RATE_CONTROL;
   priv->enable_rtcp = DEFAULT_ENABLE_RTCP;
+  priv->gop_cache_size = DEFAULT_GOP_CACHE_SIZE;
+  g_queue_init (&priv->gop_cache);
+  priv->gop_cache_joined = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) gst_sample_unref);
 
   g_mutex_init (&priv->lock);
 
@@ -359,6 +390,31 @@ gst_rtsp_stream_init (GstRTSPStream * stream)
   priv->block_early_rtcp_probe_ipv6 = 0;
 }
 
+/* With lock, or when the stream is not used anymore */
+static void
+gop_cache_clear (GstRTSPStreamPrivate * priv)
+{
+  GstSample *sample;
+
+  while ((sample = g_queue_pop_head (&priv->gop_cache)))
+    gst_sample_unref (sample);
+  priv->gop_cache_bytes = 0;
+}
+
+/* With lock, or when the stream is not used anymore */
+static void
+gop_cache_remove_probes (GstRTSPStreamPrivate * priv)
+{
+  if (priv->gop_sink_probe)
+    gst_pad_remove_probe (priv->gop_sink_pad, priv->gop_sink_probe);
+  if (priv->gop_send_probe)
+    gst_pad_remove_probe (priv->send_src[0], priv->gop_send_probe);
+  priv->gop_sink_probe = priv->gop_send_probe = 0;
+  gst_clear_object (&priv->gop_sink_pad);
+}
+
+static void gop_cache_add_probes (GstRTSPStream * stream);
+
 typedef struct _UdpClientAddrInfo UdpClientAddrInfo;
 
 struct _UdpClientAddrInfo
@@ -427,6 +483,10 @@ gst_rtsp_stream_finalize (GObject * obj)
   g_free (priv->multicast_iface);
   g_list_free_full (priv->mcast_clients, (GDestroyNotify) free_mcast_client);
 
+  gop_cache_remove_probes (priv);
+  gop_cache_clear (priv);
+  g_hash_table_unref (priv->gop_cache_joined);
+
   gst_object_unref (priv->payloader);
   if (priv->srcpad)
     gst_object_unref (priv->srcpad);
@@ -2658,6 +2718,151 @@ check_transport_backlog (GstRTSPStream * stream, GstRTSPStreamTransport * trans)
   }
 }
 
+static GstBuffer *
+get_first_sample_buffer (GstSample * sample)
+{
+  GstBufferList *buffer_list = gst_sample_get_buffer_list (sample);
+
+  if (buffer_list)
+    return gst_buffer_list_length (buffer_list) > 0 ?
+        gst_buffer_list_get (buffer_list, 0) : NULL;
+
+  return gst_sample_get_buffer (sample);
+}
+
+/* the buffer or buffer list of @sample, which is passed on unchanged from
+ * rtpbin to the appsink */
+static gpointer
+get_sample_data (GstSample * sample)
+{
+  GstBufferList *buffer_list = gst_sample_get_buffer_list (sample);
+
+  if (buffer_list)
+    return buffer_list;
+
+  return gst_sample_get_buffer (sample);
+}
+
+/* With priv->lock. Keeps the RTP @sample sent by rtpbin if it belongs to the
+ * current GOP, which starts with the first sample of a @keyframe */
+static void
+gop_cache_add (GstRTSPStream * stream, GstSample * sample, gboolean keyframe)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  GstBuffer *buffer = gst_sample_get_buffer (sample);
+  GstBufferList *buffer_list = gst_sample_get_buffer_list (sample);
+  GstBuffer *first, *head;
+  GstClockTime duration = 0;
+  gsize size;
+
+  first = get_first_sample_buffer (sample);
+  if (!first)
+    return;
+
+  if (keyframe) {
+    gop_cache_clear (priv);
+    priv->gop_cache_valid = TRUE;
+  }
+
+  if (!priv->gop_cache_valid)
+    return;
+
+  size = buffer ? gst_buffer_get_size (buffer) :
+      gst_buffer_list_calculate_size (buffer_list);
+
+  if (!g_queue_is_empty (&priv->gop_cache)) {
+    head = get_first_sample_buffer (g_queue_peek_head (&priv->gop_cache));
+
+    if (GST_CLOCK_TIME_IS_VALID (GST_BUFFER_DTS_OR_PTS (first)) &&
+        GST_CLOCK_TIME_IS_VALID (GST_BUFFER_DTS_OR_PTS (head)))
+      duration = GST_CLOCK_DIFF (GST_BUFFER_DTS_OR_PTS (head),
+          GST_BUFFER_DTS_OR_PTS (first));
+  }
+
+  if (priv->gop_cache_bytes + size > priv->gop_cache_size ||
+      priv->gop_cache.length >= GOP_CACHE_MAX_SAMPLES ||
+      duration > GOP_CACHE_MAX_DURATION) {
+    GST_DEBUG_OBJECT (stream, "GOP does not fit into %u bytes, %u samples "
+        "or %" GST_TIME_FORMAT ", dropping it", priv->gop_cache_size,
+        GOP_CACHE_MAX_SAMPLES, GST_TIME_ARGS (GOP_CACHE_MAX_DURATION));
+    gop_cache_clear (priv);
+    priv->gop_cache_valid = FALSE;
+    return;
+  }
+
+  g_queue_push_tail (&priv->gop_cache, gst_sample_ref (sample));
+  priv->gop_cache_bytes += size;
+}
+
+/* With priv->lock. Queues the cached GOP on the backlog of a new TCP
+ * transport, it is then sent before the live data */
+static void
+gop_cache_send (GstRTSPStream * stream, GstRTSPStreamTransport * trans)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  GList *walk;
+
+  if (!priv->gop_cache_valid || g_queue_is_empty (&priv->gop_cache))
+    return;
+
+  GST_DEBUG_OBJECT (stream, "queueing %u cached samples (%" G_GSIZE_FORMAT
+      " bytes) on %" GST_PTR_FORMAT, priv->gop_cache.length,
+      priv->gop_cache_bytes, trans);
+
+  gst_rtsp_stream_transport_lock_backlog (trans);
+  for (walk = priv->gop_cache.head; walk; walk = walk->next) {
+    GstSample *sample = walk->data;
+    GstBuffer *buffer = gst_sample_get_buffer (sample);
+    GstBufferList *buffer_list = gst_sample_get_buffer_list (sample);
+
+    if (!gst_rtsp_stream_transport_backlog_push (trans,
+            buffer ? gst_buffer_ref (buffer) : NULL,
+            buffer_list ? gst_buffer_list_ref (buffer_list) : NULL, TRUE)) {
+      /* the client will have to wait for the next keyframe instead */
+      GST_WARNING_OBJECT (stream, "backlog of %" GST_PTR_FORMAT " is full, "
+          "not sending the cached GOP", trans);
+      gst_rtsp_stream_transport_clear_backlog (trans);
+      gst_rtsp_stream_transport_unlock_backlog (trans);
+      return;
+    }
+  }
+  gst_rtsp_stream_transport_unlock_backlog (trans);
+
+  g_hash_table_insert (priv->gop_cache_joined, trans,
+      gst_sample_ref (g_queue_peek_tail (&priv->gop_cache)));
+}
+
+/* With priv->lock. Checks whether @sample was already sent to @trans as part
+ * of the cached GOP */
+static gboolean
+gop_cache_was_sent (GstRTSPStream * stream, GstRTSPStreamTransport * trans,
+    GstSample * sample)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  GstSample *last;
+  gpointer data = get_sample_data (sample);
+  GList *walk;
+
+  last = g_hash_table_lookup (priv->gop_cache_joined, trans);
+  if (!last)
+    return FALSE;
+
+  for (walk = priv->gop_cache.head; walk; walk = walk->next) {
+    if (get_sample_data (walk->data) == data) {
+      if (walk->data == last)
+        g_hash_table_remove (priv->gop_cache_joined, trans);
+      return TRUE;
+    }
+    if (walk->data == last)
+      break;
+  }
+
+  /* the transport caught up with the live data */
+  g_hash_table_remove (priv->gop_cache_joined, trans);
+
+  return FALSE;
+}
+
 /* Must be called with priv->lock */
 static void
 send_tcp_message (GstRTSPStream * stream, gint idx)
@@ -2711,6 +2916,10 @@ send_tcp_message (GstRTSPStream * stream, gint idx)
       GstBuffer *buf_ref = NULL;
       GstBufferList *buflist_ref = NULL;
 
+      if (is_rtp && g_hash_table_size (priv->gop_cache_joined) > 0 &&
+          gop_cache_was_sent (stream, tr, sample))
+        continue;
+
       gst_rtsp_stream_transport_lock_backlog (tr);
 
       if (buffer)
@@ -4043,6 +4252,9 @@ gst_rtsp_stream_join_bin (GstRTSPStream * stream, GstBin * bin,
     priv->caps_sig = g_signal_connect (priv->send_src[0], "notify::caps",
         (GCallback) caps_notify, stream);
     priv->caps = gst_pad_get_current_caps (priv->send_src[0]);
+
+    if (priv->gop_cache_size > 0)
+      gop_cache_add_probes (stream);
   }
 
   priv->joined_bin = bin;
@@ -4137,6 +4349,10 @@ gst_rtsp_stream_leave_bin (GstRTSPStream * stream, GstBin * bin,
   }
 
   clear_tr_cache (priv);
+  gop_cache_remove_probes (priv);
+  gop_cache_clear (priv);
+  priv->gop_cache_valid = FALSE;
+  g_hash_table_remove_all (priv->gop_cache_joined);
 
   GST_INFO ("stream %p leaving bin", stream);
 
@@ -4261,6 +4477,19 @@ gst_rtsp_stream_get_joined_bin (GstRTSPStream * stream)
   return bin;
 }
 
+/* With priv->lock */
+static GstSample *
+gop_cache_get_first_sample (GstRTSPStreamPrivate * priv)
+{
+  GstSample *sample = g_queue_peek_head (&priv->gop_cache);
+
+  if (gst_sample_get_buffer (sample))
+    return gst_sample_ref (sample);
+
+  return gst_sample_new (get_first_sample_buffer (sample),
+      gst_sample_get_caps (sample), gst_sample_get_segment (sample), NULL);
+}
+
 /**
  * gst_rtsp_stream_get_rtpinfo:
  * @stream: a #GstRTSPStream
@@ -4302,6 +4531,9 @@ gst_rtsp_stream_get_rtpinfo (GstRTSPStream * stream,
       g_object_get (priv->udpsink[0], "last-sample", &last_sample, NULL);
     else if (priv->mcast_udpsink[0])
       g_object_get (priv->mcast_udpsink[0], "last-sample", &last_sample, NULL);
+    else if (priv->gop_cache_valid && !g_queue_is_empty (&priv->gop_cache))
+      /* new TCP transports start with the cached GOP */
+      last_sample = gop_cache_get_first_sample (priv);
     else
       g_object_get (priv->appsink[0], "last-sample", &last_sample, NULL);
 
@@ -4771,9 +5003,12 @@ update_transport (GstRTSPStream * stream, GstRTSPStreamTransport * trans,
         GST_INFO ("adding TCP %s", tr->destination);
         priv->transports = g_list_prepend (priv->transports, trans);
         priv->n_tcp_transports++;
+        if (priv->gop_cache_size > 0)
+          gop_cache_send (stream, trans);
       } else {
         GST_INFO ("removing TCP %s", tr->destination);
         priv->transports = g_list_delete_link (priv->transports, tr_element);
+        g_hash_table_remove (priv->gop_cache_joined, trans);
 
         gst_rtsp_stream_transport_lock_backlog (trans);
         gst_rtsp_stream_transport_clear_backlog (trans);
@@ -6370,6 +6605,151 @@ gst_rtsp_stream_get_rate_control (GstRTSPStream * stream)
   return ret;
 }
 
+static GstPadProbeReturn
+gop_cache_sink_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstRTSPStream * stream)
+{
+  GstBuffer *buffer;
+
+  if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList *buffer_list = GST_PAD_PROBE_INFO_BUFFER_LIST (info);
+
+    buffer = gst_buffer_list_length (buffer_list) > 0 ?
+        gst_buffer_list_get (buffer_list, 0) : NULL;
+  } else {
+    buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  }
+
+  if (buffer && !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT))
+    g_atomic_int_set (&stream->priv->gop_keyframe_pending, TRUE);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* Caches what rtpbin sends, the same samples that TCP transports get */
+static GstPadProbeReturn
+gop_cache_send_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstRTSPStream * stream)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  GstSample *sample;
+  GstCaps *caps;
+  gboolean keyframe;
+
+  /* payloaders don't reliably flag the RTP packets of keyframes, the first
+   * packet after a keyframe went into the payloader starts a new GOP */
+  keyframe = g_atomic_int_compare_and_exchange (&priv->gop_keyframe_pending,
+      TRUE, FALSE);
+
+  caps = gst_pad_get_current_caps (pad);
+  sample = gst_sample_new (NULL, caps, NULL, NULL);
+  if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST)
+    gst_sample_set_buffer_list (sample, GST_PAD_PROBE_INFO_BUFFER_LIST (info));
+  else
+    gst_sample_set_buffer (sample, GST_PAD_PROBE_INFO_BUFFER (info));
+  if (caps)
+    gst_caps_unref (caps);
+
+  g_mutex_lock (&priv->lock);
+  gop_cache_add (stream, sample, keyframe);
+  g_mutex_unlock (&priv->lock);
+
+  gst_sample_unref (sample);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* With lock. The cache is filled from the RTP sent by rtpbin, so that it
+ * does not depend on any transport being present */
+static void
+gop_cache_add_probes (GstRTSPStream * stream)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+
+  if (priv->gop_send_probe || !priv->send_src[0])
+    return;
+
+  priv->gop_sink_pad = gst_element_get_static_pad (priv->payloader, "sink");
+  if (!priv->gop_sink_pad) {
+    GST_WARNING_OBJECT (stream, "payloader has no sink pad, can't detect "
+        "keyframes for the GOP cache");
+    return;
+  }
+
+  priv->gop_sink_probe = gst_pad_add_probe (priv->gop_sink_pad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) gop_cache_sink_probe, stream, NULL);
+  priv->gop_send_probe = gst_pad_add_probe (priv->send_src[0],
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) gop_cache_send_probe, stream, NULL);
+}
+
+/**
+ * gst_rtsp_stream_set_gop_cache_size:
+ * @stream: a #GstRTSPStream
+ * @size: the maximum size of the cache in bytes, 0 disables it
+ *
+ * Keep the RTP packets since the last keyframe in a cache of at most @size
+ * bytes. The cached packets are sent to TCP transports first when they are
+ * added, so that clients joining a shared live stream can start decoding
+ * immediately instead of waiting for the next keyframe. The RTP-Info of
+ * streams that are only sent over TCP then refers to the first cached packet.
+ *
+ * When a group of pictures doesn't fit into the cache, or holds more than half
+ * of the packets or duration a TCP backlog may hold before the client is
+ * dropped, nothing is cached until the next keyframe. If the backlog of a new
+ * transport can't take the cached packets, the transport only gets the live
+ * data.
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_stream_set_gop_cache_size (GstRTSPStream * stream, guint size)
+{
+  GstRTSPStreamPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_STREAM (stream));
+
+  priv = stream->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->gop_cache_size = size;
+
+  if (size == 0) {
+    gop_cache_remove_probes (priv);
+    gop_cache_clear (priv);
+    priv->gop_cache_valid = FALSE;
+    g_hash_table_remove_all (priv->gop_cache_joined);
+  } else {
+    gop_cache_add_probes (stream);
+  }
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_stream_get_gop_cache_size:
+ * @stream: a #GstRTSPStream
+ *
+ * Get the maximum size of the GOP cache of @stream.
+ *
+ * Returns: the size in bytes, 0 if the cache is disabled.
+ *
+ * Since: 1.22
+ */
+guint
+gst_rtsp_stream_get_gop_cache_size (GstRTSPStream * stream)
+{
+  guint size;
+
+  g_return_val_if_fail (GST_IS_RTSP_STREAM (stream), 0);
+
+  g_mutex_lock (&stream->priv->lock);
+  size = stream->priv->gop_cache_size;
+  g_mutex_unlock (&stream->priv->lock);
+
+  return size;
+}
+
 /**
  * gst_rtsp_stream_unblock_rtcp:
  *
@@ -368,6 +368,12 @@ gboolean           gst_rtsp_stream_get_rate_control (GstRTSPStream * stream);
 GST_RTSP_SERVER_API
 void               gst_rtsp_stream_unblock_rtcp (GstRTSPStream * stream);
 
+GST_RTSP_SERVER_API
+void               gst_rtsp_stream_set_gop_cache_size (GstRTSPStream * stream, guint size);
+
+GST_RTSP_SERVER_API
+guint              gst_rtsp_stream_get_gop_cache_size (GstRTSPStream * stream);
+
 /**
  * GstRTSPStreamTransportFilterFunc:
  * @stream: a #GstRTSPStream object
@@ -420,6 +420,67 @@ GST_START_TEST (test_allow_bind_mcast)
 
 GST_END_TEST;
 
+GST_START_TEST (test_warm_pool)
+{
+  GstRTSPMediaFactory *factory;
+  GstRTSPMedia *media;
+  GstRTSPUrl *url;
+  GstRTSPThreadPool *pool;
+  GstRTSPThread *thread;
+  guint size;
+  gint i;
+
+  factory = gst_rtsp_media_factory_new ();
+  fail_unless (gst_rtsp_media_factory_get_warm_pool_size (factory) == 0);
+  g_object_set (factory, "warm-pool-size", 1, NULL);
+  g_object_get (factory, "warm-pool-size", &size, NULL);
+  fail_unless_equals_int (size, 1);
+
+  fail_unless (gst_rtsp_url_parse ("rtsp://localhost:8554/test",
+          &url) == GST_RTSP_OK);
+
+  gst_rtsp_media_factory_set_launch (factory,
+      "( videotestsrc ! rtpvrawpay pt=96 name=pay0 )");
+
+  /* the first media is constructed as usual and starts filling the pool */
+  media = gst_rtsp_media_factory_construct (factory, url);
+  fail_unless (GST_IS_RTSP_MEDIA (media));
+  fail_unless (gst_rtsp_media_get_status (media) ==
+      GST_RTSP_MEDIA_STATUS_UNPREPARED);
+  g_object_unref (media);
+
+  /* wait for the pool to hand out a prepared media */
+  for (i = 0; i < 100; i++) {
+    media = gst_rtsp_media_factory_construct (factory, url);
+    fail_unless (GST_IS_RTSP_MEDIA (media));
+    if (gst_rtsp_media_get_status (media) == GST_RTSP_MEDIA_STATUS_PREPARED)
+      break;
+    g_object_unref (media);
+    media = NULL;
+    g_usleep (G_USEC_PER_SEC / 20);
+  }
+  fail_unless (media != NULL);
+
+  /* preparing the warm media again is a noop, unpreparing it must stop it */
+  pool = gst_rtsp_thread_pool_new ();
+  thread = gst_rtsp_thread_pool_get_thread (pool,
+      GST_RTSP_THREAD_TYPE_MEDIA, NULL);
+  fail_unless (gst_rtsp_media_prepare (media, thread));
+  fail_unless (gst_rtsp_media_unprepare (media));
+  fail_unless (gst_rtsp_media_get_status (media) ==
+      GST_RTSP_MEDIA_STATUS_UNPREPARED);
+  g_object_unref (media);
+
+  gst_rtsp_media_factory_set_warm_pool_size (factory, 0);
+
+  g_object_unref (pool);
+  gst_rtsp_thread_pool_cleanup ();
+  gst_rtsp_url_free (url);
+  g_object_unref (factory);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtspmediafactory_suite (void)
 {
@@ -437,6 +498,7 @@ rtspmediafactory_suite (void)
   tcase_add_test (tc, test_reset);
   tcase_add_test (tc, test_mcast_ttl);
   tcase_add_test (tc, test_allow_bind_mcast);
+  tcase_add_test (tc, test_warm_pool);
 
   return s;
 }
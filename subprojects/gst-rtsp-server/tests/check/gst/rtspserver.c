@@ -2123,6 +2123,27 @@ GST_START_TEST (test_shared_tcp)
 
 GST_END_TEST;
 
+static void
+client_connected_send_queue_cb (GstRTSPServer * server,
+    GstRTSPClient * client, gpointer user_data)
+{
+  g_object_set (client, "send-queue-size", 16, "send-queue-drop-policy",
+      GST_RTSP_CLIENT_DROP_POLICY_OLDEST, NULL);
+}
+
+/* Test adding and removing clients to a 'Shared' media when the clients
+ * write the interleaved data from their send queue.
+ * CASE: unicast TCP */
+GST_START_TEST (test_shared_tcp_send_queue)
+{
+  g_signal_connect (server, "client-connected",
+      G_CALLBACK (client_connected_send_queue_cb), NULL);
+
+  test_shared (thread_func_tcp);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_announce_without_sdp)
 {
   GstRTSPConnection *conn;
@@ -2742,6 +2763,7 @@ rtspserver_suite (void)
   tcase_add_test (tc, test_play_smpte_range_tcp);
   tcase_add_test (tc, test_shared_udp);
   tcase_add_test (tc, test_shared_tcp);
+  tcase_add_test (tc, test_shared_tcp_send_queue);
   tcase_add_test (tc, test_announce_without_sdp);
   tcase_add_test (tc, test_record_tcp);
   tcase_add_test (tc, test_multiple_transports);
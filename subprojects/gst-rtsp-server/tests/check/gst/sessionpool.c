@@ -187,6 +187,53 @@ GST_START_TEST (test_pool)
 
 GST_END_TEST;
 
+GST_START_TEST (test_cleanup_many)
+{
+  GstRTSPSessionPool *pool;
+  GstRTSPSession *sessions[64];
+  GstRTSPSession *compare;
+  gint i;
+
+  pool = gst_rtsp_session_pool_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (sessions); i++) {
+    sessions[i] = gst_rtsp_session_pool_create (pool);
+    fail_unless (GST_IS_RTSP_SESSION (sessions[i]));
+    /* let every other session time out after one second */
+    if (i % 2 == 0)
+      g_object_set (sessions[i], "timeout", 1, "extra-timeout", 0, NULL);
+  }
+  fail_unless_equals_int (gst_rtsp_session_pool_get_n_sessions (pool), 64);
+  fail_unless_equals_int (gst_rtsp_session_pool_cleanup (pool), 0);
+
+  /* a session that is found is touched and stays */
+  g_usleep (G_USEC_PER_SEC * 6 / 10);
+  compare = gst_rtsp_session_pool_find (pool,
+      gst_rtsp_session_get_sessionid (sessions[0]));
+  fail_unless (compare == sessions[0]);
+  g_object_unref (compare);
+
+  g_usleep (G_USEC_PER_SEC * 8 / 10);
+  fail_unless_equals_int (gst_rtsp_session_pool_cleanup (pool), 31);
+  fail_unless_equals_int (gst_rtsp_session_pool_get_n_sessions (pool), 33);
+
+  for (i = 0; i < G_N_ELEMENTS (sessions); i++) {
+    compare = gst_rtsp_session_pool_find (pool,
+        gst_rtsp_session_get_sessionid (sessions[i]));
+    if (i % 2 == 0 && i != 0) {
+      fail_unless (compare == NULL);
+    } else {
+      fail_unless (compare == sessions[i]);
+      g_object_unref (compare);
+    }
+    g_object_unref (sessions[i]);
+  }
+
+  g_object_unref (pool);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtspsessionpool_suite (void)
 {
@@ -196,6 +243,7 @@ rtspsessionpool_suite (void)
   suite_add_tcase (s, tc);
   tcase_set_timeout (tc, 15);
   tcase_add_test (tc, test_pool);
+  tcase_add_test (tc, test_cleanup_many);
 
   return s;
 }
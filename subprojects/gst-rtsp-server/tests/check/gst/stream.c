@@ -18,6 +18,7 @@
  */
 
 #include <gst/check/gstcheck.h>
+#include <gst/rtp/gstrtpbuffer.h>
 
 #include <rtsp-stream.h>
 #include <rtsp-address-pool.h>
@@ -498,6 +499,216 @@ GST_START_TEST (test_tcp_transport)
 
 GST_END_TEST;
 
+GST_START_TEST (test_gop_cache_size)
+{
+  GstPad *srcpad;
+  GstElement *pay;
+  GstRTSPStream *stream;
+  GstBin *bin;
+  GstElement *rtpbin;
+
+  srcpad = gst_pad_new ("testsrcpad", GST_PAD_SRC);
+  fail_unless (srcpad != NULL);
+  gst_pad_set_active (srcpad, TRUE);
+  pay = gst_element_factory_make ("rtpgstpay", "testpayloader");
+  fail_unless (pay != NULL);
+  stream = gst_rtsp_stream_new (0, pay, srcpad);
+  fail_unless (stream != NULL);
+  gst_object_unref (pay);
+  gst_object_unref (srcpad);
+  rtpbin = gst_element_factory_make ("rtpbin", "testrtpbin");
+  fail_unless (rtpbin != NULL);
+  bin = GST_BIN (gst_bin_new ("testbin"));
+  fail_unless (bin != NULL);
+  fail_unless (gst_bin_add (bin, rtpbin));
+
+  /* disabled by default */
+  fail_unless_equals_int (gst_rtsp_stream_get_gop_cache_size (stream), 0);
+
+  gst_rtsp_stream_set_gop_cache_size (stream, 1024 * 1024);
+  fail_unless_equals_int (gst_rtsp_stream_get_gop_cache_size (stream),
+      1024 * 1024);
+
+  gst_rtsp_stream_set_protocols (stream, GST_RTSP_LOWER_TRANS_TCP);
+  fail_unless (gst_rtsp_stream_join_bin (stream, bin, rtpbin, GST_STATE_NULL));
+  fail_unless (gst_rtsp_stream_leave_bin (stream, bin, rtpbin));
+
+  gst_rtsp_stream_set_gop_cache_size (stream, 0);
+  fail_unless_equals_int (gst_rtsp_stream_get_gop_cache_size (stream), 0);
+
+  gst_object_unref (bin);
+  gst_object_unref (stream);
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  GArray *seqnums;
+  GstRTSPStreamTransport *trans;
+} GopCacheData;
+
+static gboolean
+gop_cache_send_rtp (GstBuffer * buffer, guint8 channel, gpointer user_data)
+{
+  GopCacheData *data = user_data;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  guint16 seqnum;
+
+  fail_unless (gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp));
+  seqnum = gst_rtp_buffer_get_seq (&rtp);
+  gst_rtp_buffer_unmap (&rtp);
+
+  g_mutex_lock (&data->lock);
+  g_array_append_val (data->seqnums, seqnum);
+  g_cond_signal (&data->cond);
+  g_mutex_unlock (&data->lock);
+
+  gst_rtsp_stream_transport_message_sent (data->trans);
+
+  return TRUE;
+}
+
+static gboolean
+gop_cache_send_rtcp (GstBuffer * buffer, guint8 channel, gpointer user_data)
+{
+  GopCacheData *data = user_data;
+
+  gst_rtsp_stream_transport_message_sent (data->trans);
+
+  return TRUE;
+}
+
+static void
+gop_cache_push (GstPad * srcpad, guint16 seqnum, gboolean keyframe)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBuffer *buffer;
+
+  buffer = gst_rtp_buffer_new_allocate (10, 0, 0);
+  fail_unless (gst_rtp_buffer_map (buffer, GST_MAP_WRITE, &rtp));
+  gst_rtp_buffer_set_payload_type (&rtp, 96);
+  gst_rtp_buffer_set_seq (&rtp, seqnum);
+  gst_rtp_buffer_set_timestamp (&rtp, seqnum * 3600);
+  gst_rtp_buffer_unmap (&rtp);
+
+  GST_BUFFER_PTS (buffer) = seqnum * 40 * GST_MSECOND;
+  if (!keyframe)
+    GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+  /* not linked as long as there are no transports */
+  gst_pad_push (srcpad, buffer);
+}
+
+/* a TCP client joining a running stream first gets the cached GOP, and then
+ * the live data without duplicates */
+GST_START_TEST (test_gop_cache_burst)
+{
+  GopCacheData data;
+  GstRTSPTransport *transport;
+  GstRTSPStreamTransport *tr;
+  GstRTSPStream *stream;
+  GstPad *srcpad, *paysrc, *paysink;
+  GstElement *pay;
+  GstElement *pipeline;
+  GstElement *rtpbin;
+  GstSegment segment;
+  GstCaps *caps;
+  guint16 expected[] = { 10, 11, 12, 13 };
+  guint i;
+
+  g_mutex_init (&data.lock);
+  g_cond_init (&data.cond);
+  data.seqnums = g_array_new (FALSE, FALSE, sizeof (guint16));
+
+  pipeline = gst_pipeline_new ("testpipeline");
+  rtpbin = gst_element_factory_make ("rtpbin", "testrtpbin");
+  fail_unless (rtpbin != NULL);
+  fail_unless (gst_bin_add (GST_BIN (pipeline), rtpbin));
+
+  /* an identity payloader, to control the RTP packets */
+  pay = gst_element_factory_make ("identity", "testpayloader");
+  fail_unless (pay != NULL);
+  fail_unless (gst_bin_add (GST_BIN (pipeline), pay));
+  paysrc = gst_element_get_static_pad (pay, "src");
+  paysink = gst_element_get_static_pad (pay, "sink");
+  srcpad = gst_pad_new ("testsrcpad", GST_PAD_SRC);
+  fail_unless (gst_pad_link (srcpad, paysink) == GST_PAD_LINK_OK);
+  gst_object_unref (paysink);
+
+  stream = gst_rtsp_stream_new (0, pay, paysrc);
+  fail_unless (stream != NULL);
+  gst_object_unref (paysrc);
+
+  gst_rtsp_stream_set_protocols (stream, GST_RTSP_LOWER_TRANS_TCP);
+  gst_rtsp_stream_set_rate_control (stream, FALSE);
+  gst_rtsp_stream_set_gop_cache_size (stream, 1024 * 1024);
+  fail_unless (gst_rtsp_stream_join_bin (stream, GST_BIN (pipeline), rtpbin,
+          GST_STATE_NULL));
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+
+  gst_pad_set_active (srcpad, TRUE);
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_stream_start ("test")));
+  caps = gst_caps_from_string ("application/x-rtp, media=video, payload=96, "
+      "clock-rate=90000, encoding-name=H264");
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_caps (caps)));
+  gst_caps_unref (caps);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_segment (&segment)));
+
+  /* the cache is filled without any transport */
+  gop_cache_push (srcpad, 8, FALSE);
+  gop_cache_push (srcpad, 9, FALSE);
+  gop_cache_push (srcpad, 10, TRUE);
+  gop_cache_push (srcpad, 11, FALSE);
+  gop_cache_push (srcpad, 12, FALSE);
+
+  fail_unless (gst_rtsp_transport_new (&transport) == GST_RTSP_OK);
+  transport->lower_transport = GST_RTSP_LOWER_TRANS_TCP;
+  transport->interleaved.min = 0;
+  transport->interleaved.max = 1;
+  fail_unless (gst_rtsp_stream_complete_stream (stream, transport));
+
+  tr = gst_rtsp_stream_transport_new (stream, transport);
+  fail_unless (tr);
+  data.trans = tr;
+  gst_rtsp_stream_transport_set_callbacks (tr, gop_cache_send_rtp,
+      gop_cache_send_rtcp, &data, NULL);
+  fail_unless (gst_rtsp_stream_add_transport (stream, tr));
+
+  /* the live packet follows the burst */
+  gop_cache_push (srcpad, 13, FALSE);
+
+  g_mutex_lock (&data.lock);
+  while (data.seqnums->len < G_N_ELEMENTS (expected))
+    g_cond_wait (&data.cond, &data.lock);
+  g_mutex_unlock (&data.lock);
+
+  fail_unless_equals_int (data.seqnums->len, G_N_ELEMENTS (expected));
+  for (i = 0; i < G_N_ELEMENTS (expected); i++)
+    fail_unless_equals_int (g_array_index (data.seqnums, guint16, i),
+        expected[i]);
+
+  fail_unless (gst_rtsp_stream_remove_transport (stream, tr));
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_NULL) ==
+      GST_STATE_CHANGE_SUCCESS);
+  fail_unless (gst_rtsp_stream_leave_bin (stream, GST_BIN (pipeline), rtpbin));
+
+  g_object_unref (tr);
+  gst_object_unref (srcpad);
+  gst_object_unref (pipeline);
+  gst_object_unref (stream);
+  g_array_unref (data.seqnums);
+  g_cond_clear (&data.cond);
+  g_mutex_clear (&data.lock);
+}
+
+GST_END_TEST;
+
 static void
 check_multicast_client_address (const gchar * destination, guint port,
     const gchar * expected_addr_str, gboolean expected_res)
@@ -695,6 +906,8 @@ rtspstream_suite (void)
   tcase_add_test (tc, test_allocate_udp_ports_multicast);
   tcase_add_test (tc, test_allocate_udp_ports_client_settings);
   tcase_add_test (tc, test_tcp_transport);
+  tcase_add_test (tc, test_gop_cache_size);
+  tcase_add_test (tc, test_gop_cache_burst);
   tcase_add_test (tc, test_multicast_client_address);
   tcase_add_test (tc, test_multicast_client_address_invalid);
   tcase_add_test (tc, test_add_transport_twice);
@@ -551,6 +551,7 @@ init_pre (GOptionContext * context, GOptionGroup * group, gpointer data,
 
 #ifndef GST_DISABLE_GST_DEBUG
   _priv_gst_debug_init ();
+  _priv_gst_tracing_pre_init ();
   priv_gst_dump_dot_dir = g_getenv ("GST_DEBUG_DUMP_DOT_DIR");
 #endif
 
@@ -789,6 +790,7 @@ init_post (GOptionContext * context, GOptionGroup * group, gpointer data,
 
   g_type_class_ref (gst_param_spec_fraction_get_type ());
   gst_parse_context_get_type ();
+  gst_parse_template_get_type ();
 
   _priv_gst_plugin_initialize ();
 
@@ -828,6 +830,10 @@ init_post (GOptionContext * context, GOptionGroup * group, gpointer data,
   _priv_gst_tracing_init ();
 #endif
 
+  /* Load the plugins from GST_PLUGIN_PRELOAD in the background now that
+   * the registry is ready */
+  _priv_gst_registry_preload_plugins_async ();
+
   return TRUE;
 }
 
@@ -86,6 +86,8 @@ typedef struct {
 struct _GstPluginPrivate {
   GList *deps;    /* list of GstPluginDep structures */
   GstStructure *cache_data;
+  /* SHA-256 of the plugin file, only if GST_REGISTRY_CONTENT_HASH is set */
+  gchar *file_hash;
 };
 
 /* Private function for getting plugin features directly */
@@ -112,6 +114,11 @@ G_GNUC_INTERNAL  gboolean _priv_plugin_deps_env_vars_changed (GstPlugin * plugin
 
 G_GNUC_INTERNAL  gboolean _priv_plugin_deps_files_changed (GstPlugin * plugin);
 
+G_GNUC_INTERNAL  gboolean _priv_gst_registry_content_hash_enabled (void);
+
+G_GNUC_INTERNAL  gboolean _priv_gst_plugin_file_hash_matches (GstPlugin * plugin,
+                                                              const gchar * filename);
+
 /* init functions called from gst_init(). */
 G_GNUC_INTERNAL  void  _priv_gst_quarks_initialize (void);
 G_GNUC_INTERNAL  void  _priv_gst_mini_object_initialize (void);
@@ -153,6 +160,56 @@ gboolean _priv_gst_registry_remove_cache_plugins (GstRegistry *registry);
 
 G_GNUC_INTERNAL  void _priv_gst_registry_cleanup (void);
 
+G_GNUC_INTERNAL  void _priv_gst_registry_preload_plugins_async (void);
+
+G_GNUC_INTERNAL
+void _priv_gst_registry_add_binary_cache (GstRegistry *registry, GBytes *cache);
+
+/* Per-thread free lists for small, frequently allocated blocks of a fixed
+ * size such as queries, events and their structures */
+typedef struct _GstFreeList GstFreeList;
+struct _GstFreeList {
+  gsize block_size;
+  GPrivate cache;
+};
+
+G_GNUC_INTERNAL  void _priv_gst_free_list_cache_free (gpointer cache);
+
+#define GST_FREE_LIST_INIT(size) \
+    { (size), G_PRIVATE_INIT (_priv_gst_free_list_cache_free) }
+
+G_GNUC_INTERNAL  gpointer _priv_gst_free_list_alloc0 (GstFreeList *list);
+
+G_GNUC_INTERNAL  void _priv_gst_free_list_free (GstFreeList *list, gpointer block);
+
+/* Free lists shared by all threads, for blocks that are usually freed by
+ * another thread than the one that allocated them, such as buffer memory
+ * passed from a producer to a consumer thread */
+#define GST_SHARED_FREE_LIST_MAX_BLOCKS 32
+
+typedef struct _GstSharedFreeList GstSharedFreeList;
+struct _GstSharedFreeList {
+  gsize block_size;
+  GMutex lock;
+  guint n_blocks;
+  gpointer blocks[GST_SHARED_FREE_LIST_MAX_BLOCKS];
+};
+
+#define GST_SHARED_FREE_LIST_INIT(size) { (size), }
+
+G_GNUC_INTERNAL  gpointer _priv_gst_shared_free_list_alloc (GstSharedFreeList *list);
+
+G_GNUC_INTERNAL  void _priv_gst_shared_free_list_free (GstSharedFreeList *list, gpointer block);
+
+G_GNUC_INTERNAL  void _priv_gst_shared_free_list_clear (GstSharedFreeList *list);
+
+/* Small system memory allocations with extra storage for the caller */
+G_GNUC_INTERNAL
+GstMemory * _priv_gst_sysmem_alloc_with_header (GstAllocator * allocator,
+                                                gsize header_size, gsize size,
+                                                GstAllocationParams * params,
+                                                gpointer * header);
+
 GST_API
 gboolean _gst_plugin_loader_client_run (void);
 
@@ -421,6 +478,9 @@ struct _GstTypeFindFactory {
   GstTypeFindFunction           function;
   gchar **                      extensions;
   GstCaps *                     caps;
+  /* serialized caps from the mapped registry cache, parsed into @caps on
+   * first use */
+  const gchar *                 caps_string;
 
   gpointer                      user_data;
   GDestroyNotify                user_data_notify;
@@ -462,6 +522,9 @@ struct _GstElementFactory {
   GType                 type;                   /* unique GType of element or 0 if not loaded */
 
   gpointer              metadata;
+  /* serialized metadata from the mapped registry cache, parsed into
+   * @metadata on first use */
+  const gchar *         metadata_string;
 
   GList *               staticpadtemplates;     /* GstStaticPadTemplate list */
   guint                 numpadtemplates;
@@ -490,6 +553,9 @@ struct _GstDeviceProviderFactory {
 
   GstDeviceProvider         *provider;
   gpointer                   metadata;
+  /* serialized metadata from the mapped registry cache, parsed into
+   * @metadata on first use */
+  const gchar               *metadata_string;
 
   gpointer _gst_reserved[GST_PADDING];
 };
@@ -513,6 +579,8 @@ struct _GstDynamicTypeFactoryClass {
 
 /* privat flag used by GstBus / GstMessage */
 #define GST_MESSAGE_FLAG_ASYNC_DELIVERY (GST_MINI_OBJECT_FLAG_LAST << 0)
+/* private flag used by GstBus for queued messages that can be coalesced */
+#define GST_MESSAGE_FLAG_COALESCE (GST_MINI_OBJECT_FLAG_LAST << 1)
 
 /* private struct used by GstClock and GstSystemClock */
 struct _GstClockEntryImpl
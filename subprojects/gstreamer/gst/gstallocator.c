@@ -334,6 +334,10 @@ gst_allocator_alloc (GstAllocator * allocator, gsize size,
   else
     mem = NULL;
 
+  if (mem) {
+    GST_TRACER_MEMORY_ALLOC (allocator, mem);
+  }
+
   return mem;
 }
 
@@ -353,6 +357,8 @@ gst_allocator_free (GstAllocator * allocator, GstMemory * memory)
   g_return_if_fail (memory != NULL);
   g_return_if_fail (memory->allocator == allocator);
 
+  GST_TRACER_MEMORY_FREE (allocator, memory);
+
   aclass = GST_ALLOCATOR_GET_CLASS (allocator);
   if (aclass->free)
     aclass->free (allocator, memory);
@@ -368,6 +374,9 @@ typedef struct
 
   gpointer user_data;
   GDestroyNotify notify;
+
+  /* the free list the block is returned to, if any */
+  GstSharedFreeList *free_list;
 } GstMemorySystem;
 
 typedef struct
@@ -397,6 +406,7 @@ _sysmem_init (GstMemorySystem * mem, GstMemoryFlags flags,
   mem->data = data;
   mem->user_data = user_data;
   mem->notify = notify;
+  mem->free_list = NULL;
 }
 
 /* create a new memory block that manages the given memory */
@@ -547,6 +557,10 @@ default_free (GstAllocator * allocator, GstMemory * mem)
 
   slice_size = dmem->slice_size;
 
+  if (dmem->free_list) {
+    _priv_gst_shared_free_list_free (dmem->free_list, mem);
+    return;
+  }
 #ifdef USE_POISONING
   /* just poison the structs, not all the data */
   memset (mem, 0xff, sizeof (GstMemorySystem));
@@ -555,6 +569,81 @@ default_free (GstAllocator * allocator, GstMemory * mem)
   g_slice_free1 (slice_size, mem);
 }
 
+/* Small blocks holding a memory, a caller provided header and the data are
+ * recycled through free lists, one per block size class. Buffers are often
+ * freed by another thread than the one that allocated them, so the lists are
+ * shared between threads. */
+#define SYSMEM_HEADER_ALIGN(s) (((s) + 15) & ~((gsize) 15))
+
+static GstSharedFreeList sysmem_free_lists[] = {
+  GST_SHARED_FREE_LIST_INIT (1024),
+  GST_SHARED_FREE_LIST_INIT (2048),
+  GST_SHARED_FREE_LIST_INIT (4096),
+};
+
+/* Allocates memory of @size bytes from @allocator together with
+ * @header_size bytes for use by the caller, in a single block. The header
+ * stays valid until the returned memory is freed. Returns %NULL when
+ * @allocator is not the system memory allocator or when the block would be
+ * too big, the caller should fall back to gst_allocator_alloc() then. */
+GstMemory *
+_priv_gst_sysmem_alloc_with_header (GstAllocator * allocator,
+    gsize header_size, gsize size, GstAllocationParams * params,
+    gpointer * header)
+{
+  static GstAllocationParams defparams = { 0, 0, 0, 0, };
+  GstMemorySystem *mem;
+  GstSharedFreeList *free_list = NULL;
+  gsize maxsize, align, aoffset, hsize, block_size, padding;
+  guint8 *data;
+  guint i;
+
+  if (allocator == NULL)
+    allocator = _default_allocator;
+  if (allocator != _sysmem_allocator)
+    return NULL;
+
+  if (params == NULL)
+    params = &defparams;
+
+  align = params->align | gst_memory_alignment;
+  maxsize = size + params->prefix + params->padding;
+  hsize = SYSMEM_HEADER_ALIGN (sizeof (GstMemorySystem));
+  block_size = hsize + SYSMEM_HEADER_ALIGN (header_size) + maxsize + align;
+
+  for (i = 0; i < G_N_ELEMENTS (sysmem_free_lists); i++) {
+    if (block_size <= sysmem_free_lists[i].block_size) {
+      free_list = &sysmem_free_lists[i];
+      break;
+    }
+  }
+  if (free_list == NULL)
+    return NULL;
+
+  mem = _priv_gst_shared_free_list_alloc (free_list);
+  *header = (guint8 *) mem + hsize;
+  data = (guint8 *) * header + SYSMEM_HEADER_ALIGN (header_size);
+
+  /* do alignment, the block has room for it */
+  if ((aoffset = ((guintptr) data & align)))
+    data += (align + 1) - aoffset;
+
+  if (params->prefix && (params->flags & GST_MEMORY_FLAG_ZERO_PREFIXED))
+    memset (data, 0, params->prefix);
+
+  padding = params->padding;
+  if (padding && (params->flags & GST_MEMORY_FLAG_ZERO_PADDED))
+    memset (data + params->prefix + size, 0, padding);
+
+  _sysmem_init (mem, params->flags, NULL, free_list->block_size, data,
+      maxsize, align, params->prefix, size, NULL, NULL);
+  mem->free_list = free_list;
+
+  GST_TRACER_MEMORY_ALLOC (allocator, GST_MEMORY_CAST (mem));
+
+  return GST_MEMORY_CAST (mem);
+}
+
 static void
 gst_allocator_sysmem_finalize (GObject * obj)
 {
@@ -625,6 +714,11 @@ _priv_gst_allocator_initialize (void)
 void
 _priv_gst_allocator_cleanup (void)
 {
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (sysmem_free_lists); i++)
+    _priv_gst_shared_free_list_clear (&sysmem_free_lists[i]);
+
   gst_object_unref (_sysmem_allocator);
   _sysmem_allocator = NULL;
 
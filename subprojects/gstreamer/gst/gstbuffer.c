@@ -144,6 +144,16 @@ GType _gst_buffer_type = 0;
 
 #define GST_BUFFER_MEM_MAX         16
 
+/* Number and size of the meta items that can be stored inside the
+ * GstBufferImpl itself instead of being allocated separately */
+#define GST_BUFFER_META_INLINE_N     4
+#define GST_BUFFER_META_INLINE_SIZE  64
+
+/* Size of the per-buffer API type to meta lookup table, power of 2 */
+#define GST_BUFFER_META_INDEX_SIZE   8
+#define GST_BUFFER_META_INDEX_HASH(api) \
+    ((((gsize) (api) >> 4) ^ ((gsize) (api) >> 9)) & (GST_BUFFER_META_INDEX_SIZE - 1))
+
 #define GST_BUFFER_SLICE_SIZE(b)   (((GstBufferImpl *)(b))->slice_size)
 #define GST_BUFFER_MEM_LEN(b)      (((GstBufferImpl *)(b))->len)
 #define GST_BUFFER_MEM_ARRAY(b)    (((GstBufferImpl *)(b))->mem)
@@ -151,6 +161,16 @@ GType _gst_buffer_type = 0;
 #define GST_BUFFER_BUFMEM(b)       (((GstBufferImpl *)(b))->bufmem)
 #define GST_BUFFER_META(b)         (((GstBufferImpl *)(b))->item)
 #define GST_BUFFER_TAIL_META(b)    (((GstBufferImpl *)(b))->tail_item)
+#define GST_BUFFER_META_INDEX(b)   (((GstBufferImpl *)(b))->meta_index)
+
+typedef union
+{
+  guint8 data[GST_BUFFER_META_INLINE_SIZE];
+  /* for alignment */
+  guint64 u64;
+  gdouble d;
+  gpointer p;
+} GstBufferInlineMeta;
 
 typedef struct
 {
@@ -165,10 +185,17 @@ typedef struct
   /* memory of the buffer when allocated from 1 chunk */
   GstMemory *bufmem;
 
-  /* FIXME, make metadata allocation more efficient by using part of the
-   * GstBufferImpl */
   GstMetaItem *item;
   GstMetaItem *tail_item;
+
+  /* For each hash bucket, the first item of the list whose API type falls
+   * into it, or NULL if there is none */
+  GstMetaItem *meta_index[GST_BUFFER_META_INDEX_SIZE];
+
+  /* storage for the first few small metas, bit n of inline_meta_used is set
+   * when inline_meta[n] is in use */
+  guint inline_meta_used;
+  GstBufferInlineMeta inline_meta[GST_BUFFER_META_INLINE_N];
 } GstBufferImpl;
 
 static gint64 meta_seq;         /* 0 *//* ATOMIC */
@@ -207,6 +234,66 @@ gst_atomic_int64_inc (gint64 * atomic)
 }
 #endif
 
+static GstMetaItem *
+_meta_item_alloc (GstBuffer * buffer, gsize size, gboolean zero)
+{
+  GstBufferImpl *impl = (GstBufferImpl *) buffer;
+  GstMetaItem *item;
+  guint i;
+
+  if (size <= GST_BUFFER_META_INLINE_SIZE) {
+    for (i = 0; i < GST_BUFFER_META_INLINE_N; i++) {
+      if (!(impl->inline_meta_used & (1 << i))) {
+        impl->inline_meta_used |= (1 << i);
+        item = (GstMetaItem *) impl->inline_meta[i].data;
+        if (zero)
+          memset (item, 0, size);
+        return item;
+      }
+    }
+  }
+
+  if (zero)
+    return g_slice_alloc0 (size);
+  else
+    return g_slice_alloc (size);
+}
+
+static void
+_meta_item_free (GstBuffer * buffer, GstMetaItem * item, gsize size)
+{
+  GstBufferImpl *impl = (GstBufferImpl *) buffer;
+  guint8 *p = (guint8 *) item;
+
+  if (p >= impl->inline_meta[0].data
+      && p < (guint8 *) (impl->inline_meta + GST_BUFFER_META_INLINE_N)) {
+    guint i = (p - impl->inline_meta[0].data) / sizeof (GstBufferInlineMeta);
+
+    impl->inline_meta_used &= ~(1 << i);
+    return;
+  }
+
+  g_slice_free1 (size, item);
+}
+
+/* Must be called after @item was unlinked from the list of @buffer */
+static void
+_meta_index_remove (GstBuffer * buffer, GstMetaItem * item)
+{
+  guint h = GST_BUFFER_META_INDEX_HASH (item->meta.info->api);
+  GstMetaItem *walk;
+
+  if (GST_BUFFER_META_INDEX (buffer)[h] != item)
+    return;
+
+  /* find the next item falling into the same bucket */
+  for (walk = item->next; walk; walk = walk->next) {
+    if (GST_BUFFER_META_INDEX_HASH (walk->meta.info->api) == h)
+      break;
+  }
+  GST_BUFFER_META_INDEX (buffer)[h] = walk;
+}
+
 static gboolean
 _is_span (GstMemory ** mem, gsize len, gsize * poffset, GstMemory ** parent)
 {
@@ -665,31 +752,44 @@ gst_buffer_copy_into (GstBuffer * dest, GstBuffer * src,
     }
   }
 
-  if (flags & GST_BUFFER_COPY_META) {
+  if ((flags & GST_BUFFER_COPY_META) && GST_BUFFER_META (src)) {
+    GstMetaTransformCopy copy_data;
+    /* Don't copy memory metas if we only copied part of the buffer, didn't
+     * copy memories or merged memories. In all these cases the memory
+     * structure has changed and the memory meta becomes meaningless.
+     */
+    gboolean skip_memory_metas = region || !(flags & GST_BUFFER_COPY_MEMORY)
+        || (flags & GST_BUFFER_COPY_MERGE);
+    GType last_api = 0;
+    gboolean last_is_memory = FALSE;
+
+    copy_data.region = region;
+    copy_data.offset = offset;
+    copy_data.size = size;
+
     /* NOTE: GstGLSyncMeta copying relies on the meta
      *       being copied now, after the buffer data,
      *       so this has to happen last */
     for (walk = GST_BUFFER_META (src); walk; walk = walk->next) {
       GstMeta *meta = &walk->meta;
       const GstMetaInfo *info = meta->info;
+      gboolean is_memory = FALSE;
+
+      if (skip_memory_metas) {
+        /* metas of the same API are often next to each other */
+        if (info->api != last_api) {
+          last_api = info->api;
+          last_is_memory =
+              gst_meta_api_type_has_tag (info->api, _gst_meta_tag_memory);
+        }
+        is_memory = last_is_memory;
+      }
 
-      /* Don't copy memory metas if we only copied part of the buffer, didn't
-       * copy memories or merged memories. In all these cases the memory
-       * structure has changed and the memory meta becomes meaningless.
-       */
-      if ((region || !(flags & GST_BUFFER_COPY_MEMORY)
-              || (flags & GST_BUFFER_COPY_MERGE))
-          && gst_meta_api_type_has_tag (info->api, _gst_meta_tag_memory)) {
+      if (is_memory) {
         GST_CAT_DEBUG (GST_CAT_BUFFER,
             "don't copy memory meta %p of API type %s", meta,
             g_type_name (info->api));
       } else if (info->transform_func) {
-        GstMetaTransformCopy copy_data;
-
-        copy_data.region = region;
-        copy_data.offset = offset;
-        copy_data.size = size;
-
         if (!info->transform_func (dest, meta, src,
                 _gst_meta_transform_copy, &copy_data)) {
           GST_CAT_ERROR (GST_CAT_BUFFER,
@@ -790,7 +890,7 @@ _gst_buffer_free (GstBuffer * buffer)
 
     next = walk->next;
     /* and free the slice */
-    g_slice_free1 (ITEM_SIZE (info), walk);
+    _meta_item_free (buffer, walk, ITEM_SIZE (info));
   }
 
   /* get the size, when unreffing the memory, we could also unref the buffer
@@ -836,6 +936,8 @@ gst_buffer_init (GstBufferImpl * buffer, gsize size)
 
   GST_BUFFER_MEM_LEN (buffer) = 0;
   GST_BUFFER_META (buffer) = NULL;
+  memset (GST_BUFFER_META_INDEX (buffer), 0, sizeof (buffer->meta_index));
+  buffer->inline_meta_used = 0;
 }
 
 /**
@@ -888,6 +990,34 @@ gst_buffer_new_allocate (GstAllocator * allocator, gsize size,
 
 #if 1
   if (size > 0) {
+    gpointer header;
+
+    /* small buffers from the system allocator are placed in the same block
+     * as their memory. The buffer keeps a ref to the memory until it is
+     * freed so the block stays around even when the memory is removed from
+     * the buffer. */
+    mem = _priv_gst_sysmem_alloc_with_header (allocator,
+        sizeof (GstBufferImpl), size, params, &header);
+    if (mem != NULL) {
+      newbuf = GST_BUFFER_CAST (header);
+      GST_CAT_LOG (GST_CAT_BUFFER, "new %p", newbuf);
+
+      /* a slice size of 0 marks the buffer as part of the memory block */
+      gst_buffer_init ((GstBufferImpl *) newbuf, 0);
+      GST_BUFFER_BUFMEM (newbuf) = gst_memory_ref (mem);
+
+      gst_memory_lock (mem, GST_LOCK_FLAG_EXCLUSIVE);
+      _memory_add (newbuf, -1, mem);
+
+      GST_CAT_LOG (GST_CAT_BUFFER,
+          "new buffer %p of size %" G_GSIZE_FORMAT " in memory block %p",
+          newbuf, size, mem);
+
+      GST_BUFFER_FLAG_UNSET (newbuf, GST_BUFFER_FLAG_TAG_MEMORY);
+
+      return newbuf;
+    }
+
     mem = gst_allocator_alloc (allocator, size, params);
     if (G_UNLIKELY (mem == NULL))
       goto no_memory;
@@ -2245,8 +2375,14 @@ gst_buffer_get_meta (GstBuffer * buffer, GType api)
   g_return_val_if_fail (buffer != NULL, NULL);
   g_return_val_if_fail (api != 0, NULL);
 
+  /* The index holds the first item of each bucket, if there's none there's
+   * no meta of this API, if it has the right API it's the first one */
+  item = GST_BUFFER_META_INDEX (buffer)[GST_BUFFER_META_INDEX_HASH (api)];
+  if (item == NULL || item->meta.info->api == api)
+    return item ? &item->meta : NULL;
+
   /* find GstMeta of the requested API */
-  for (item = GST_BUFFER_META (buffer); item; item = item->next) {
+  for (item = item->next; item; item = item->next) {
     GstMeta *meta = &item->meta;
     if (meta->info->api == api) {
       result = meta;
@@ -2306,10 +2442,7 @@ gst_buffer_add_meta (GstBuffer * buffer, const GstMetaInfo * info,
    * init function but let's play safe here and prevent
    * uninitialized memory
    */
-  if (!info->init_func)
-    item = g_slice_alloc0 (size);
-  else
-    item = g_slice_alloc (size);
+  item = _meta_item_alloc (buffer, size, info->init_func == NULL);
   result = &item->meta;
   result->info = info;
   result->flags = GST_META_FLAG_NONE;
@@ -2333,11 +2466,15 @@ gst_buffer_add_meta (GstBuffer * buffer, const GstMetaInfo * info,
     GST_BUFFER_TAIL_META (buffer) = item;
   }
 
+  if (!GST_BUFFER_META_INDEX (buffer)[GST_BUFFER_META_INDEX_HASH (info->api)])
+    GST_BUFFER_META_INDEX (buffer)[GST_BUFFER_META_INDEX_HASH (info->api)] =
+        item;
+
   return result;
 
 init_failed:
   {
-    g_slice_free1 (size, item);
+    _meta_item_free (buffer, item, size);
     return NULL;
   }
 }
@@ -2383,12 +2520,14 @@ gst_buffer_remove_meta (GstBuffer * buffer, GstMeta * meta)
       else
         prev->next = walk->next;
 
+      _meta_index_remove (buffer, walk);
+
       /* call free_func if any */
       if (info->free_func)
         info->free_func (m, buffer);
 
       /* and free the slice */
-      g_slice_free1 (ITEM_SIZE (info), walk);
+      _meta_item_free (buffer, walk, ITEM_SIZE (info));
       break;
     }
     prev = walk;
@@ -2531,12 +2670,14 @@ gst_buffer_foreach_meta (GstBuffer * buffer, GstBufferForeachMetaFunc func,
       else
         prev->next = next;
 
+      _meta_index_remove (buffer, walk);
+
       /* call free_func if any */
       if (info->free_func)
         info->free_func (m, buffer);
 
       /* and free the slice */
-      g_slice_free1 (ITEM_SIZE (info), walk);
+      _meta_item_free (buffer, walk, ITEM_SIZE (info));
     } else {
       prev = walk;
     }
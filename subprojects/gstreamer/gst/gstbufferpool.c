@@ -64,26 +64,13 @@
 #include "gst_private.h"
 #include "glib-compat-private.h"
 
-#include <errno.h>
-#ifdef HAVE_UNISTD_H
-#  include <unistd.h>
-#endif
-#include <sys/types.h>
-
 #include "gstatomicqueue.h"
-#include "gstpoll.h"
 #include "gstinfo.h"
 #include "gstquark.h"
 #include "gstvalue.h"
 
 #include "gstbufferpool.h"
 
-#ifdef G_OS_WIN32
-#  ifndef EWOULDBLOCK
-#  define EWOULDBLOCK EAGAIN    /* This is just to placate gcc */
-#  endif
-#endif /* G_OS_WIN32 */
-
 GST_DEBUG_CATEGORY_STATIC (gst_buffer_pool_debug);
 #define GST_CAT_DEFAULT gst_buffer_pool_debug
 
@@ -93,7 +80,14 @@ GST_DEBUG_CATEGORY_STATIC (gst_buffer_pool_debug);
 struct _GstBufferPoolPrivate
 {
   GstAtomicQueue *queue;
-  GstPoll *poll;
+
+  /* for waiting until a buffer is released when all buffers are in use. The
+   * lock is only taken when there is no free buffer, or when somebody is
+   * waiting, acquiring and releasing is lock-free otherwise */
+  GMutex wait_lock;
+  GCond wait_cond;
+  gint waiters;
+  guint wait_seqnum;
 
   GRecMutex rec_lock;
 
@@ -159,7 +153,8 @@ gst_buffer_pool_init (GstBufferPool * pool)
 
   g_rec_mutex_init (&priv->rec_lock);
 
-  priv->poll = gst_poll_new_timer ();
+  g_mutex_init (&priv->wait_lock);
+  g_cond_init (&priv->wait_cond);
   priv->queue = gst_atomic_queue_new (16);
   pool->flushing = 1;
   priv->active = FALSE;
@@ -171,10 +166,6 @@ gst_buffer_pool_init (GstBufferPool * pool)
   gst_allocation_params_init (&priv->params);
   gst_buffer_pool_config_set_allocator (priv->config, priv->allocator,
       &priv->params);
-  /* 1 control write for flushing - the flush token */
-  gst_poll_write_control (priv->poll);
-  /* 1 control write for marking that we are not waiting for poll - the wait token */
-  gst_poll_write_control (priv->poll);
 
   GST_DEBUG_OBJECT (pool, "created");
 }
@@ -208,7 +199,8 @@ gst_buffer_pool_finalize (GObject * object)
   GST_DEBUG_OBJECT (pool, "%p finalize", pool);
 
   gst_atomic_queue_unref (priv->queue);
-  gst_poll_free (priv->poll);
+  g_cond_clear (&priv->wait_cond);
+  g_mutex_clear (&priv->wait_lock);
   gst_structure_free (priv->config);
   g_rec_mutex_clear (&priv->rec_lock);
 
@@ -407,20 +399,8 @@ default_stop (GstBufferPool * pool)
   GstBuffer *buffer;
 
   /* clear the pool */
-  while ((buffer = gst_atomic_queue_pop (priv->queue))) {
-    while (!gst_poll_read_control (priv->poll)) {
-      if (errno == EWOULDBLOCK) {
-        /* We put the buffer into the queue but did not finish writing control
-         * yet, let's wait a bit and retry */
-        g_thread_yield ();
-        continue;
-      } else {
-        /* Critical error but GstPoll already complained */
-        break;
-      }
-    }
+  while ((buffer = gst_atomic_queue_pop (priv->queue)))
     do_free_buffer (pool, buffer);
-  }
   return priv->cur_buffers == 0;
 }
 
@@ -445,6 +425,26 @@ do_stop (GstBufferPool * pool)
   return TRUE;
 }
 
+/* wakes up threads waiting in default_acquire_buffer() to check again if
+ * they can get a buffer now */
+static inline void
+wake_waiters (GstBufferPool * pool, gboolean all)
+{
+  GstBufferPoolPrivate *priv = pool->priv;
+
+  /* the common case, nobody is waiting and we don't have to take the lock */
+  if (g_atomic_int_get (&priv->waiters) == 0)
+    return;
+
+  g_mutex_lock (&priv->wait_lock);
+  priv->wait_seqnum++;
+  if (all)
+    g_cond_broadcast (&priv->wait_cond);
+  else
+    g_cond_signal (&priv->wait_cond);
+  g_mutex_unlock (&priv->wait_lock);
+}
+
 /* must be called with the lock */
 static void
 do_set_flushing (GstBufferPool * pool, gboolean flushing)
@@ -459,8 +459,8 @@ do_set_flushing (GstBufferPool * pool, gboolean flushing)
 
   if (flushing) {
     g_atomic_int_set (&pool->flushing, 1);
-    /* Write the flush token to wake up any waiters */
-    gst_poll_write_control (priv->poll);
+    /* wake up any waiters */
+    wake_waiters (pool, TRUE);
 
     if (pclass->flush_start)
       pclass->flush_start (pool);
@@ -468,19 +468,6 @@ do_set_flushing (GstBufferPool * pool, gboolean flushing)
     if (pclass->flush_stop)
       pclass->flush_stop (pool);
 
-    while (!gst_poll_read_control (priv->poll)) {
-      if (errno == EWOULDBLOCK) {
-        /* This should not really happen unless flushing and unflushing
-         * happens on different threads. Let's wait a bit to get back flush
-         * token from the thread that was setting it to flushing */
-        g_thread_yield ();
-        continue;
-      } else {
-        /* Critical error but GstPoll already complained */
-        break;
-      }
-    }
-
     g_atomic_int_set (&pool->flushing, 0);
   }
 }
@@ -1111,6 +1098,7 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
 {
   GstFlowReturn result;
   GstBufferPoolPrivate *priv = pool->priv;
+  guint seqnum;
 
   while (TRUE) {
     if (G_UNLIKELY (GST_BUFFER_POOL_IS_FLUSHING (pool)))
@@ -1119,17 +1107,6 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
     /* try to get a buffer from the queue */
     *buffer = gst_atomic_queue_pop (priv->queue);
     if (G_LIKELY (*buffer)) {
-      while (!gst_poll_read_control (priv->poll)) {
-        if (errno == EWOULDBLOCK) {
-          /* We put the buffer into the queue but did not finish writing control
-           * yet, let's wait a bit and retry */
-          g_thread_yield ();
-          continue;
-        } else {
-          /* Critical error but GstPoll already complained */
-          break;
-        }
-      }
       result = GST_FLOW_OK;
       GST_LOG_OBJECT (pool, "acquired buffer %p", *buffer);
       break;
@@ -1152,35 +1129,25 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
       break;
     }
 
-    /* now we release the control socket, we wait for a buffer release or
-     * flushing */
-    if (!gst_poll_read_control (pool->priv->poll)) {
-      if (errno == EWOULDBLOCK) {
-        /* This means that we have two threads trying to allocate buffers
-         * already, and the other one already got the wait token. This
-         * means that we only have to wait for the poll now and not write the
-         * token afterwards: we will be woken up once the other thread is
-         * woken up and that one will write the wait token it removed */
-        GST_LOG_OBJECT (pool, "waiting for free buffers or flushing");
-        gst_poll_wait (priv->poll, GST_CLOCK_TIME_NONE);
-      } else {
-        /* This is a critical error, GstPoll already gave a warning */
-        result = GST_FLOW_ERROR;
-        break;
-      }
-    } else {
-      /* We're the first thread waiting, we got the wait token and have to
-       * write it again later
-       * OR
-       * We're a second thread and just consumed the flush token and block all
-       * other threads, in which case we must not wait and give it back
-       * immediately */
-      if (!GST_BUFFER_POOL_IS_FLUSHING (pool)) {
-        GST_LOG_OBJECT (pool, "waiting for free buffers or flushing");
-        gst_poll_wait (priv->poll, GST_CLOCK_TIME_NONE);
-      }
-      gst_poll_write_control (pool->priv->poll);
+    /* wait for a buffer release or flushing. We announce ourselves as a
+     * waiter before checking again, so that a release happening concurrently
+     * either sees us waiting and wakes us up, or is seen by the checks */
+    GST_TRACER_BUFFER_POOL_WAIT_PRE (pool);
+    g_mutex_lock (&priv->wait_lock);
+    g_atomic_int_inc (&priv->waiters);
+    seqnum = priv->wait_seqnum;
+    while (seqnum == priv->wait_seqnum
+        && !GST_BUFFER_POOL_IS_FLUSHING (pool)
+        && gst_atomic_queue_length (priv->queue) == 0
+        && (priv->max_buffers == 0
+            || (guint) g_atomic_int_get (&priv->cur_buffers) >=
+            priv->max_buffers)) {
+      GST_LOG_OBJECT (pool, "waiting for free buffers or flushing");
+      g_cond_wait (&priv->wait_cond, &priv->wait_lock);
     }
+    g_atomic_int_add (&priv->waiters, -1);
+    g_mutex_unlock (&priv->wait_lock);
+    GST_TRACER_BUFFER_POOL_WAIT_POST (pool);
   }
 
   return result;
@@ -1294,6 +1261,7 @@ gst_buffer_pool_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
     /* all buffers from the pool point to the pool and have the refcount of the
      * pool incremented */
     (*buffer)->pool = gst_object_ref (pool);
+    GST_TRACER_BUFFER_POOL_BUFFER_ACQUIRED (pool, *buffer);
   } else {
     dec_outstanding (pool);
   }
@@ -1322,7 +1290,7 @@ default_release_buffer (GstBufferPool * pool, GstBuffer * buffer)
 
   /* keep it around in our queue */
   gst_atomic_queue_push (pool->priv->queue, buffer);
-  gst_poll_write_control (pool->priv->poll);
+  wake_waiters (pool, FALSE);
 
   return;
 
@@ -1348,7 +1316,7 @@ not_writable:
 discard:
   {
     do_free_buffer (pool, buffer);
-    gst_poll_write_control (pool->priv->poll);
+    wake_waiters (pool, FALSE);
     return;
   }
 }
@@ -1377,6 +1345,8 @@ gst_buffer_pool_release_buffer (GstBufferPool * pool, GstBuffer * buffer)
   if (!g_atomic_pointer_compare_and_exchange (&buffer->pool, pool, NULL))
     return;
 
+  GST_TRACER_BUFFER_POOL_BUFFER_RELEASED (pool, buffer);
+
   pclass = GST_BUFFER_POOL_GET_CLASS (pool);
 
   /* reset the buffer when needed */
@@ -98,6 +98,9 @@ enum
 
 #define DEFAULT_ENABLE_ASYNC (TRUE)
 
+/* maximum number of messages a bus watch dispatches per main loop wakeup */
+#define MAX_DISPATCH_MESSAGES 32
+
 enum
 {
   PROP_0,
@@ -106,6 +109,8 @@ enum
 
 static void gst_bus_dispose (GObject * object);
 static void gst_bus_finalize (GObject * object);
+static GstMessage *gst_bus_resolve_coalesced (GstBus * bus,
+    GstMessage * message, gboolean take);
 
 static guint gst_bus_signals[LAST_SIGNAL] = { 0 };
 
@@ -137,6 +142,52 @@ sync_handler_unref (SyncHandler * handler)
   g_free (handler);
 }
 
+/* a queued message that can be replaced by later messages with the same
+ * source, type and structure name */
+typedef struct
+{
+  GstObject *src;
+  GstMessageType type;
+  GQuark name;
+
+  /* the message in the queue and the latest one posted with the same key,
+   * which is delivered in its place */
+  GstMessage *queued;
+  GstMessage *latest;
+} CoalesceEntry;
+
+static void
+coalesce_entry_set_key (CoalesceEntry * entry, GstMessage * message)
+{
+  const GstStructure *s = gst_message_get_structure (message);
+
+  entry->src = GST_MESSAGE_SRC (message);
+  entry->type = GST_MESSAGE_TYPE (message);
+  entry->name = s ? gst_structure_get_name_id (s) : 0;
+}
+
+static guint
+coalesce_entry_hash (gconstpointer key)
+{
+  const CoalesceEntry *entry = key;
+
+  return g_direct_hash (entry->src) ^ (guint) entry->type ^ entry->name;
+}
+
+static gboolean
+coalesce_entry_equal (gconstpointer a, gconstpointer b)
+{
+  const CoalesceEntry *ea = a, *eb = b;
+
+  return ea->src == eb->src && ea->type == eb->type && ea->name == eb->name;
+}
+
+static void
+coalesce_entry_free (CoalesceEntry * entry)
+{
+  g_slice_free (CoalesceEntry, entry);
+}
+
 struct _GstBusPrivate
 {
   GstAtomicQueue *queue;
@@ -152,6 +203,10 @@ struct _GstBusPrivate
   gboolean enable_async;
   GstPoll *poll;
   GPollFD pollfd;
+
+  gint coalesce_types;
+  GMutex coalesce_lock;
+  GHashTable *coalesce;
 };
 
 #define gst_bus_parent_class parent_class
@@ -252,6 +307,9 @@ gst_bus_init (GstBus * bus)
   bus->priv->enable_async = DEFAULT_ENABLE_ASYNC;
   g_mutex_init (&bus->priv->queue_lock);
   bus->priv->queue = gst_atomic_queue_new (32);
+  g_mutex_init (&bus->priv->coalesce_lock);
+  bus->priv->coalesce = g_hash_table_new_full (coalesce_entry_hash,
+      coalesce_entry_equal, (GDestroyNotify) coalesce_entry_free, NULL);
 
   GST_DEBUG_OBJECT (bus, "created");
 }
@@ -268,13 +326,17 @@ gst_bus_dispose (GObject * object)
     do {
       message = gst_atomic_queue_pop (bus->priv->queue);
       if (message)
-        gst_message_unref (message);
+        gst_message_unref (gst_bus_resolve_coalesced (bus, message, TRUE));
     } while (message != NULL);
     gst_atomic_queue_unref (bus->priv->queue);
     bus->priv->queue = NULL;
     g_mutex_unlock (&bus->priv->queue_lock);
     g_mutex_clear (&bus->priv->queue_lock);
 
+    g_hash_table_unref (bus->priv->coalesce);
+    bus->priv->coalesce = NULL;
+    g_mutex_clear (&bus->priv->coalesce_lock);
+
     if (bus->priv->poll)
       gst_poll_free (bus->priv->poll);
     bus->priv->poll = NULL;
@@ -315,6 +377,83 @@ gst_bus_new (void)
   return result;
 }
 
+/* Replaces the latest message of a pending coalesce entry with @message and
+ * returns %TRUE if there is one, taking ownership of @message. Otherwise a
+ * new entry is made for @message when its type is coalesced and %FALSE is
+ * returned so that the caller queues it. */
+static gboolean
+gst_bus_coalesce_message (GstBus * bus, GstMessage * message)
+{
+  GstBusPrivate *priv = bus->priv;
+  CoalesceEntry key, *entry;
+  guint types;
+
+  types = (guint) g_atomic_int_get (&priv->coalesce_types);
+  if (types == 0 || GST_MESSAGE_TYPE_IS_EXTENDED (message) ||
+      (GST_MESSAGE_TYPE (message) & types) == 0)
+    return FALSE;
+
+  coalesce_entry_set_key (&key, message);
+
+  g_mutex_lock (&priv->coalesce_lock);
+  entry = g_hash_table_lookup (priv->coalesce, &key);
+  if (entry) {
+    if (entry->latest != entry->queued)
+      gst_message_unref (entry->latest);
+    entry->latest = message;
+    g_mutex_unlock (&priv->coalesce_lock);
+    return TRUE;
+  }
+
+  entry = g_slice_new (CoalesceEntry);
+  *entry = key;
+  entry->queued = entry->latest = message;
+  g_hash_table_add (priv->coalesce, entry);
+  GST_MINI_OBJECT_FLAG_SET (message, GST_MESSAGE_FLAG_COALESCE);
+  g_mutex_unlock (&priv->coalesce_lock);
+
+  return FALSE;
+}
+
+/* Returns the message to deliver in place of @message from the queue. With
+ * @take, @message was popped and its coalesce entry is released, and
+ * ownership of @message is transferred to the returned message. Without
+ * @take a new reference to the message to deliver is returned. */
+static GstMessage *
+gst_bus_resolve_coalesced (GstBus * bus, GstMessage * message, gboolean take)
+{
+  GstBusPrivate *priv = bus->priv;
+  CoalesceEntry key, *entry;
+  GstMessage *latest = message;
+
+  if (!GST_MINI_OBJECT_FLAG_IS_SET (message, GST_MESSAGE_FLAG_COALESCE))
+    return take ? message : gst_message_ref (message);
+
+  coalesce_entry_set_key (&key, message);
+
+  g_mutex_lock (&priv->coalesce_lock);
+  entry = g_hash_table_lookup (priv->coalesce, &key);
+  if (entry && entry->queued == message) {
+    latest = entry->latest;
+    if (take) {
+      GST_MINI_OBJECT_FLAG_UNSET (message, GST_MESSAGE_FLAG_COALESCE);
+      g_hash_table_remove (priv->coalesce, &key);
+    }
+  }
+  /* the latest message can be replaced as soon as we release the lock */
+  if (!take)
+    gst_message_ref (latest);
+  g_mutex_unlock (&priv->coalesce_lock);
+
+  if (take && latest != message) {
+    GST_DEBUG_OBJECT (bus, "[msg %p] replaced by coalesced message %p",
+        message, latest);
+    gst_message_unref (message);
+  }
+
+  return latest;
+}
+
 /**
  * gst_bus_post:
  * @bus: a #GstBus to post on
@@ -377,6 +516,12 @@ gst_bus_post (GstBus * bus, GstMessage * message)
       GST_DEBUG_OBJECT (bus, "[msg %p] dropped", message);
       break;
     case GST_BUS_PASS:
+      /* replace a pending message with the same key, no need to queue it or
+       * wake up anybody */
+      if (gst_bus_coalesce_message (bus, message)) {
+        GST_DEBUG_OBJECT (bus, "[msg %p] coalesced", message);
+        break;
+      }
       /* pass the message to the async queue, refcount passed in the queue */
       GST_DEBUG_OBJECT (bus, "[msg %p] pushing on async queue", message);
       gst_atomic_queue_push (bus->priv->queue, message);
@@ -498,6 +643,61 @@ gst_bus_set_flushing (GstBus * bus, gboolean flushing)
   g_list_free_full (message_list, (GDestroyNotify) gst_message_unref);
 }
 
+/**
+ * gst_bus_set_coalesce_types:
+ * @bus: a #GstBus
+ * @types: message types to coalesce, or 0 to disable coalescing
+ *
+ * Enables coalescing of queued messages of @types. When a message of one of
+ * @types is posted while an earlier message with the same source, type and
+ * structure name is still waiting on @bus, the new message replaces the
+ * earlier one instead of being queued after it. The latest message is then
+ * delivered at the position of the earliest one.
+ *
+ * This is useful for frequent messages where only the latest value matters,
+ * like the #GST_MESSAGE_ELEMENT messages of level or spectrum,
+ * #GST_MESSAGE_QOS or #GST_MESSAGE_BUFFERING, and keeps an application that
+ * can't keep up from waking up for every one of them. Messages that a sync
+ * handler delivers with #GST_BUS_ASYNC and extended message types are never
+ * coalesced.
+ *
+ * A bus watch also dispatches runs of queued messages of @types in a single
+ * main loop iteration instead of waking up for each of them.
+ *
+ * Since: 1.22
+ */
+void
+gst_bus_set_coalesce_types (GstBus * bus, GstMessageType types)
+{
+  g_return_if_fail (GST_IS_BUS (bus));
+
+  /* extended types are never coalesced */
+  types &= ~GST_MESSAGE_EXTENDED;
+
+  GST_DEBUG_OBJECT (bus, "coalescing message types 0x%x", (guint) types);
+
+  g_atomic_int_set (&bus->priv->coalesce_types, (gint) types);
+}
+
+/**
+ * gst_bus_get_coalesce_types:
+ * @bus: a #GstBus
+ *
+ * Gets the message types that are coalesced on @bus, see
+ * gst_bus_set_coalesce_types().
+ *
+ * Returns: the coalesced message types.
+ *
+ * Since: 1.22
+ */
+GstMessageType
+gst_bus_get_coalesce_types (GstBus * bus)
+{
+  g_return_val_if_fail (GST_IS_BUS (bus), 0);
+
+  return (GstMessageType) g_atomic_int_get (&bus->priv->coalesce_types);
+}
+
 /**
  * gst_bus_timed_pop_filtered:
  * @bus: a #GstBus to pop from
@@ -557,6 +757,8 @@ gst_bus_timed_pop_filtered (GstBus * bus, GstClockTime timeout,
         }
       }
 
+      message = gst_bus_resolve_coalesced (bus, message, TRUE);
+
       GST_DEBUG_OBJECT (bus, "got message %p, %s from %s, type mask is %u",
           message, GST_MESSAGE_TYPE_NAME (message),
           GST_MESSAGE_SRC_NAME (message), (guint) types);
@@ -699,7 +901,7 @@ gst_bus_peek (GstBus * bus)
   g_mutex_lock (&bus->priv->queue_lock);
   message = gst_atomic_queue_peek (bus->priv->queue);
   if (message)
-    gst_message_ref (message);
+    message = gst_bus_resolve_coalesced (bus, message, FALSE);
   g_mutex_unlock (&bus->priv->queue_lock);
 
   GST_DEBUG_OBJECT (bus, "peek on bus, got message %p", message);
@@ -789,6 +991,27 @@ gst_bus_source_check (GSource * source)
   return bsrc->bus->priv->pollfd.revents & (G_IO_IN | G_IO_HUP | G_IO_ERR);
 }
 
+/* whether the next queued message is of a type that is coalesced */
+static gboolean
+gst_bus_next_is_coalesced (GstBus * bus)
+{
+  GstMessageType types;
+  GstMessage *message;
+  gboolean ret = FALSE;
+
+  types = (GstMessageType) g_atomic_int_get (&bus->priv->coalesce_types);
+  if (types == 0)
+    return FALSE;
+
+  g_mutex_lock (&bus->priv->queue_lock);
+  message = gst_atomic_queue_peek (bus->priv->queue);
+  if (message)
+    ret = (GST_MESSAGE_TYPE (message) & types) != 0;
+  g_mutex_unlock (&bus->priv->queue_lock);
+
+  return ret;
+}
+
 static gboolean
 gst_bus_source_dispatch (GSource * source, GSourceFunc callback,
     gpointer user_data)
@@ -796,8 +1019,9 @@ gst_bus_source_dispatch (GSource * source, GSourceFunc callback,
   GstBusFunc handler = (GstBusFunc) callback;
   GstBusSource *bsource = (GstBusSource *) source;
   GstMessage *message;
-  gboolean keep;
+  gboolean keep = TRUE;
   GstBus *bus;
+  guint i, n_messages;
 
   g_return_val_if_fail (bsource != NULL, FALSE);
 
@@ -805,23 +1029,41 @@ gst_bus_source_dispatch (GSource * source, GSourceFunc callback,
 
   g_return_val_if_fail (GST_IS_BUS (bus), FALSE);
 
-  message = gst_bus_pop (bus);
+  /* handle runs of already queued messages of coalesced types in one go
+   * instead of going through the main loop for each of them, but not the ones
+   * posted while dispatching so that other sources get a chance to run. Other
+   * messages are dispatched one by one as the handler might stop iterating
+   * the main loop after any of them, and the following messages then have
+   * to stay on the bus */
+  n_messages = gst_atomic_queue_length (bus->priv->queue);
+  n_messages = CLAMP (n_messages, 1, MAX_DISPATCH_MESSAGES);
+
+  for (i = 0; i < n_messages && keep; i++) {
+    if (i > 0 && !gst_bus_next_is_coalesced (bus))
+      break;
 
-  /* The message queue might be empty if some other thread or callback set
-   * the bus to flushing between check/prepare and dispatch */
-  if (G_UNLIKELY (message == NULL))
-    return TRUE;
+    message = gst_bus_pop (bus);
 
-  if (!handler)
-    goto no_handler;
+    /* The message queue might be empty if some other thread or callback set
+     * the bus to flushing between check/prepare and dispatch */
+    if (G_UNLIKELY (message == NULL))
+      break;
+
+    if (!handler)
+      goto no_handler;
+
+    GST_DEBUG_OBJECT (bus, "source %p calling dispatch with %" GST_PTR_FORMAT,
+        source, message);
 
-  GST_DEBUG_OBJECT (bus, "source %p calling dispatch with %" GST_PTR_FORMAT,
-      source, message);
+    keep = handler (bus, message, user_data);
+    gst_message_unref (message);
 
-  keep = handler (bus, message, user_data);
-  gst_message_unref (message);
+    GST_DEBUG_OBJECT (bus, "source %p handler returns %d", source, keep);
 
-  GST_DEBUG_OBJECT (bus, "source %p handler returns %d", source, keep);
+    /* the handler removed the watch */
+    if (g_source_is_destroyed (source))
+      break;
+  }
 
   return keep;
 
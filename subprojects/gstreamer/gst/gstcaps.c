@@ -129,16 +129,152 @@ static void gst_caps_transform_to_string (const GValue * src_value,
     GValue * dest_value);
 static gboolean gst_caps_from_string_inplace (GstCaps * caps,
     const gchar * string);
+static GstCaps *_gst_caps_copy (const GstCaps * caps);
 
 GType _gst_caps_type = 0;
 GstCaps *_gst_caps_any;
 GstCaps *_gst_caps_none;
 
+/* Optional memoization of caps operations, enabled by setting
+ * GST_CAPS_CACHE_SIZE. Only caps that are not writable are cached and each
+ * entry keeps a reference to its input caps, so they can neither be freed
+ * (and their pointer reused) nor modified until the entry is evicted, which
+ * means entries can just be keyed on the caps pointers. */
+typedef enum
+{
+  CAPS_CACHE_OP_INTERSECT_ZIG_ZAG = GST_CAPS_INTERSECT_ZIG_ZAG,
+  CAPS_CACHE_OP_INTERSECT_FIRST = GST_CAPS_INTERSECT_FIRST,
+  CAPS_CACHE_OP_IS_SUBSET,
+  CAPS_CACHE_OP_CAN_INTERSECT
+} GstCapsCacheOp;
+
+typedef struct
+{
+  GstCaps *caps1;
+  GstCaps *caps2;
+  GstCapsCacheOp op;
+
+  /* result of intersections, owned by the cache */
+  GstCaps *result;
+  /* result of the other operations */
+  gboolean res;
+} GstCapsCacheEntry;
+
+static GMutex caps_cache_lock;
+static GHashTable *caps_cache;
+static GstCapsCacheEntry *caps_cache_entries;
+static guint caps_cache_size;
+static guint caps_cache_next;
+
+static guint
+gst_caps_cache_entry_hash (gconstpointer key)
+{
+  const GstCapsCacheEntry *entry = key;
+
+  return (g_direct_hash (entry->caps1) * 31 +
+      g_direct_hash (entry->caps2)) ^ entry->op;
+}
+
+static gboolean
+gst_caps_cache_entry_equal (gconstpointer a, gconstpointer b)
+{
+  const GstCapsCacheEntry *entry1 = a, *entry2 = b;
+
+  return entry1->caps1 == entry2->caps1 && entry1->caps2 == entry2->caps2
+      && entry1->op == entry2->op;
+}
+
+static void
+gst_caps_cache_entry_clear (GstCapsCacheEntry * entry)
+{
+  gst_clear_caps (&entry->caps1);
+  gst_clear_caps (&entry->caps2);
+  gst_clear_caps (&entry->result);
+}
+
+static gboolean
+gst_caps_cache_lookup (const GstCaps * caps1, const GstCaps * caps2,
+    GstCapsCacheOp op, gboolean * res, GstCaps ** result)
+{
+  GstCapsCacheEntry key, *entry;
+
+  if (G_LIKELY (caps_cache_size == 0))
+    return FALSE;
+
+  if (gst_caps_is_writable (caps1) || gst_caps_is_writable (caps2))
+    return FALSE;
+
+  key.caps1 = (GstCaps *) caps1;
+  key.caps2 = (GstCaps *) caps2;
+  key.op = op;
+
+  g_mutex_lock (&caps_cache_lock);
+  entry = g_hash_table_lookup (caps_cache, &key);
+  if (entry) {
+    if (result)
+      /* copy so the caller gets writable caps, as without the cache */
+      *result = _gst_caps_copy (entry->result);
+    if (res)
+      *res = entry->res;
+  }
+  g_mutex_unlock (&caps_cache_lock);
+
+  if (entry)
+    GST_CAT_LOG (GST_CAT_CAPS, "cache hit for %p and %p (op %d)", caps1,
+        caps2, op);
+
+  return entry != NULL;
+}
+
+static void
+gst_caps_cache_store (const GstCaps * caps1, const GstCaps * caps2,
+    GstCapsCacheOp op, gboolean res, GstCaps * result)
+{
+  GstCapsCacheEntry key, *entry;
+
+  if (G_LIKELY (caps_cache_size == 0))
+    return;
+
+  if (gst_caps_is_writable (caps1) || gst_caps_is_writable (caps2))
+    return;
+
+  key.caps1 = (GstCaps *) caps1;
+  key.caps2 = (GstCaps *) caps2;
+  key.op = op;
+
+  g_mutex_lock (&caps_cache_lock);
+  /* another thread might have stored the same operation meanwhile */
+  if (g_hash_table_contains (caps_cache, &key)) {
+    g_mutex_unlock (&caps_cache_lock);
+    return;
+  }
+
+  entry = &caps_cache_entries[caps_cache_next];
+  caps_cache_next = (caps_cache_next + 1) % caps_cache_size;
+
+  /* evict the oldest entry */
+  if (entry->caps1) {
+    g_hash_table_remove (caps_cache, entry);
+    gst_caps_cache_entry_clear (entry);
+  }
+
+  entry->caps1 = gst_caps_ref ((GstCaps *) caps1);
+  entry->caps2 = gst_caps_ref ((GstCaps *) caps2);
+  entry->op = op;
+  entry->result = result ? _gst_caps_copy (result) : NULL;
+  entry->res = res;
+
+  g_hash_table_add (caps_cache, entry);
+  g_mutex_unlock (&caps_cache_lock);
+}
+
 GST_DEFINE_MINI_OBJECT_TYPE (GstCaps, gst_caps);
 
 void
 _priv_gst_caps_initialize (void)
 {
+  const gchar *env;
+
   _gst_caps_type = gst_caps_get_type ();
 
   _gst_caps_any = gst_caps_new_any ();
@@ -146,11 +282,34 @@ _priv_gst_caps_initialize (void)
 
   g_value_register_transform_func (_gst_caps_type,
       G_TYPE_STRING, gst_caps_transform_to_string);
+
+  env = g_getenv ("GST_CAPS_CACHE_SIZE");
+  if (env != NULL && *env != '\0') {
+    caps_cache_size = MIN (g_ascii_strtoull (env, NULL, 10), G_MAXUINT16);
+    if (caps_cache_size > 0) {
+      GST_CAT_INFO (GST_CAT_CAPS, "caching up to %u caps operations",
+          caps_cache_size);
+      caps_cache = g_hash_table_new (gst_caps_cache_entry_hash,
+          gst_caps_cache_entry_equal);
+      caps_cache_entries = g_new0 (GstCapsCacheEntry, caps_cache_size);
+      caps_cache_next = 0;
+    }
+  }
 }
 
 void
 _priv_gst_caps_cleanup (void)
 {
+  guint i;
+
+  if (caps_cache_size > 0) {
+    for (i = 0; i < caps_cache_size; i++)
+      gst_caps_cache_entry_clear (&caps_cache_entries[i]);
+    g_clear_pointer (&caps_cache_entries, g_free);
+    g_clear_pointer (&caps_cache, g_hash_table_unref);
+    caps_cache_size = 0;
+  }
+
   gst_caps_unref (_gst_caps_any);
   _gst_caps_any = NULL;
   gst_caps_unref (_gst_caps_none);
@@ -1334,6 +1493,10 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
   if (CAPS_IS_ANY (subset) || CAPS_IS_EMPTY (superset))
     return FALSE;
 
+  if (gst_caps_cache_lookup (subset, superset, CAPS_CACHE_OP_IS_SUBSET, &ret,
+          NULL))
+    return ret;
+
   for (i = GST_CAPS_LEN (subset) - 1; i >= 0; i--) {
     s1 = gst_caps_get_structure_unchecked (subset, i);
     f1 = gst_caps_get_features_unchecked (subset, i);
@@ -1362,6 +1525,8 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
     }
   }
 
+  gst_caps_cache_store (subset, superset, CAPS_CACHE_OP_IS_SUBSET, ret, NULL);
+
   return ret;
 }
 
@@ -1544,6 +1709,7 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
   GstStructure *struct2;
   GstCapsFeatures *features1;
   GstCapsFeatures *features2;
+  gboolean ret = FALSE;
 
   g_return_val_if_fail (GST_IS_CAPS (caps1), FALSE);
   g_return_val_if_fail (GST_IS_CAPS (caps2), FALSE);
@@ -1560,6 +1726,10 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
   if (G_UNLIKELY (CAPS_IS_ANY (caps1) || CAPS_IS_ANY (caps2)))
     return TRUE;
 
+  if (gst_caps_cache_lookup (caps1, caps2, CAPS_CACHE_OP_CAN_INTERSECT, &ret,
+          NULL))
+    return ret;
+
   /* run zigzag on top line then right line, this preserves the caps order
    * much better than a simple loop.
    *
@@ -1598,7 +1768,8 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
         features2 = GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY;
       if (gst_caps_features_is_equal (features1, features2) &&
           gst_structure_can_intersect (struct1, struct2)) {
-        return TRUE;
+        ret = TRUE;
+        goto done;
       }
       /* move down left */
       k++;
@@ -1608,7 +1779,10 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
     }
   }
 
-  return FALSE;
+done:
+  gst_caps_cache_store (caps1, caps2, CAPS_CACHE_OP_CAN_INTERSECT, ret, NULL);
+
+  return ret;
 }
 
 static GstCaps *
@@ -1755,6 +1929,8 @@ GstCaps *
 gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
     GstCapsIntersectMode mode)
 {
+  GstCaps *result;
+
   g_return_val_if_fail (GST_IS_CAPS (caps1), NULL);
   g_return_val_if_fail (GST_IS_CAPS (caps2), NULL);
 
@@ -1774,15 +1950,29 @@ gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
   if (G_UNLIKELY (CAPS_IS_ANY (caps2)))
     return gst_caps_ref (caps1);
 
+  if (G_UNLIKELY (mode != GST_CAPS_INTERSECT_FIRST
+          && mode != GST_CAPS_INTERSECT_ZIG_ZAG)) {
+    g_warning ("Unknown caps intersect mode: %d", mode);
+    mode = GST_CAPS_INTERSECT_ZIG_ZAG;
+  }
+
+  if (gst_caps_cache_lookup (caps1, caps2, (GstCapsCacheOp) mode, NULL,
+          &result))
+    return result;
+
   switch (mode) {
     case GST_CAPS_INTERSECT_FIRST:
-      return gst_caps_intersect_first (caps1, caps2);
-    default:
-      g_warning ("Unknown caps intersect mode: %d", mode);
-      /* fallthrough */
+      result = gst_caps_intersect_first (caps1, caps2);
+      break;
     case GST_CAPS_INTERSECT_ZIG_ZAG:
-      return gst_caps_intersect_zig_zag (caps1, caps2);
+    default:
+      result = gst_caps_intersect_zig_zag (caps1, caps2);
+      break;
   }
+
+  gst_caps_cache_store (caps1, caps2, (GstCapsCacheOp) mode, FALSE, result);
+
+  return result;
 }
 
 /**
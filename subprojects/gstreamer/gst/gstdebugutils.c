@@ -473,15 +473,33 @@ debug_dump_describe_caps (GstCaps * caps, GstDebugGraphDetails details)
   return media;
 }
 
+static gchar *
+debug_dump_escape_label (const gchar * label)
+{
+  GString *str = g_string_sized_new (strlen (label));
+
+  for (; *label; label++) {
+    if (*label == '\n')
+      g_string_append (str, "\\n");
+    else if (*label == '"')
+      g_string_append_c (str, '\'');
+    else
+      g_string_append_c (str, *label);
+  }
+  return g_string_free (str, FALSE);
+}
+
 static void
 debug_dump_element_pad_link (GstPad * pad, GstElement * element,
-    GstDebugGraphDetails details, GString * str, const gint indent)
+    GstDebugGraphDetails details, GstDebugGraphLinkLabelFunc label_func,
+    gpointer user_data, GString * str, const gint indent)
 {
   GstElement *peer_element;
   GstPad *peer_pad;
   GstCaps *caps, *peer_caps;
   gchar *media = NULL;
   gchar *media_src = NULL, *media_sink = NULL;
+  gchar *extra = NULL;
   gchar *pad_name, *element_name;
   gchar *peer_pad_name, *peer_element_name;
   const gchar *spc = MAKE_INDENT (indent);
@@ -516,6 +534,27 @@ debug_dump_element_pad_link (GstPad * pad, GstElement * element,
       gst_caps_unref (caps);
     }
 
+    if (label_func) {
+      gchar *label = label_func (pad, user_data);
+
+      if (label) {
+        extra = debug_dump_escape_label (label);
+        g_free (label);
+      }
+    }
+
+    if (extra) {
+      if (media) {
+        gchar *tmp = g_strdup_printf ("%s\\n%s", media, extra);
+
+        g_free (media);
+        g_free (extra);
+        media = tmp;
+      } else if (!media_src || !media_sink) {
+        media = extra;
+      }
+    }
+
     pad_name = debug_dump_make_object_name (GST_OBJECT (pad));
     if (element) {
       element_name = debug_dump_make_object_name (GST_OBJECT (element));
@@ -540,12 +579,13 @@ debug_dump_element_pad_link (GstPad * pad, GstElement * element,
        * we need an empty label to make space */
       g_string_append_printf (str,
           "%s%s_%s -> %s_%s [labeldistance=\"10\", labelangle=\"0\", "
-          "label=\"                                                  \", "
-          "taillabel=\"%s\", headlabel=\"%s\"]\n",
+          "label=\"%s\", taillabel=\"%s\", headlabel=\"%s\"]\n",
           spc, element_name, pad_name, peer_element_name, peer_pad_name,
+          extra ? extra : "                                                  ",
           media_src, media_sink);
       g_free (media_src);
       g_free (media_sink);
+      g_free (extra);
     } else {
       g_string_append_printf (str, "%s%s_%s -> %s_%s\n", spc,
           element_name, pad_name, peer_element_name, peer_pad_name);
@@ -611,6 +651,7 @@ debug_dump_element_pads (GstIterator * pad_iter, GstPad * pad,
  */
 static void
 debug_dump_element (GstBin * bin, GstDebugGraphDetails details,
+    GstDebugGraphLinkLabelFunc label_func, gpointer user_data,
     GString * str, const gint indent)
 {
   GstIterator *element_iter, *pad_iter;
@@ -691,7 +732,8 @@ debug_dump_element (GstBin * bin, GstDebugGraphDetails details,
         if (GST_IS_BIN (element)) {
           g_string_append_printf (str, "%s  fillcolor=\"#ffffff\";\n", spc);
           /* recurse */
-          debug_dump_element (GST_BIN (element), details, str, indent + 1);
+          debug_dump_element (GST_BIN (element), details, label_func,
+              user_data, str, indent + 1);
         } else {
           if (src_pads && !sink_pads)
             g_string_append_printf (str, "%s  fillcolor=\"#ffaaaa\";\n", spc);
@@ -711,8 +753,8 @@ debug_dump_element (GstBin * bin, GstDebugGraphDetails details,
                 pad = g_value_get_object (&item2);
                 if (gst_pad_is_linked (pad)) {
                   if (gst_pad_get_direction (pad) == GST_PAD_SRC) {
-                    debug_dump_element_pad_link (pad, element, details, str,
-                        indent);
+                    debug_dump_element_pad_link (pad, element, details,
+                        label_func, user_data, str, indent);
                   } else {
                     GstPad *peer_pad = gst_pad_get_peer (pad);
 
@@ -720,7 +762,7 @@ debug_dump_element (GstBin * bin, GstDebugGraphDetails details,
                       if (!GST_IS_GHOST_PAD (peer_pad)
                           && GST_IS_PROXY_PAD (peer_pad)) {
                         debug_dump_element_pad_link (peer_pad, NULL, details,
-                            str, indent);
+                            label_func, user_data, str, indent);
                       }
                       gst_object_unref (peer_pad);
                     }
@@ -818,6 +860,31 @@ debug_dump_footer (GString * str)
  */
 gchar *
 gst_debug_bin_to_dot_data (GstBin * bin, GstDebugGraphDetails details)
+{
+  return gst_debug_bin_to_dot_data_full (bin, details, NULL, NULL);
+}
+
+/**
+ * gst_debug_bin_to_dot_data_full:
+ * @bin: the top-level pipeline that should be analyzed
+ * @details: type of #GstDebugGraphDetails to use
+ * @label_func: (scope call) (nullable): function to get an additional label
+ *     for each link
+ * @user_data: user data for @label_func
+ *
+ * Like gst_debug_bin_to_dot_data() but calls @label_func for the source pad
+ * of every link in the graph. The returned text is appended to the label of
+ * the link, which makes it possible to annotate a pipeline graph with live
+ * data such as the throughput of each link.
+ *
+ * Returns: (transfer full): a string containing the pipeline in graphviz
+ * dot format.
+ *
+ * Since: 1.22
+ */
+gchar *
+gst_debug_bin_to_dot_data_full (GstBin * bin, GstDebugGraphDetails details,
+    GstDebugGraphLinkLabelFunc label_func, gpointer user_data)
 {
   GString *str;
 
@@ -826,7 +893,7 @@ gst_debug_bin_to_dot_data (GstBin * bin, GstDebugGraphDetails details)
   str = g_string_new (NULL);
 
   debug_dump_header (bin, details, str);
-  debug_dump_element (bin, details, str, 1);
+  debug_dump_element (bin, details, label_func, user_data, str, 1);
   debug_dump_footer (str);
 
   return g_string_free (str, FALSE);
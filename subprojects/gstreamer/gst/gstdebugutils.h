@@ -59,11 +59,30 @@ typedef enum {
 } GstDebugGraphDetails;
 
 
+/**
+ * GstDebugGraphLinkLabelFunc:
+ * @pad: the source pad of the link
+ * @user_data: the user data passed to gst_debug_bin_to_dot_data_full()
+ *
+ * Function called for every link of a pipeline graph to get an additional
+ * label for it. Newlines in the returned text start a new line in the label.
+ *
+ * Returns: (transfer full) (nullable): the additional label, or %NULL
+ *
+ * Since: 1.22
+ */
+typedef gchar * (*GstDebugGraphLinkLabelFunc) (GstPad *pad, gpointer user_data);
+
 /********** pipeline graphs **********/
 
 GST_API
 gchar * gst_debug_bin_to_dot_data (GstBin *bin, GstDebugGraphDetails details);
 
+GST_API
+gchar * gst_debug_bin_to_dot_data_full (GstBin *bin, GstDebugGraphDetails details,
+                                        GstDebugGraphLinkLabelFunc label_func,
+                                        gpointer user_data);
+
 GST_API
 void gst_debug_bin_to_dot_file (GstBin *bin, GstDebugGraphDetails details, const gchar *file_name);
 
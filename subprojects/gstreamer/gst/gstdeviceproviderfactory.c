@@ -138,6 +138,7 @@ gst_device_provider_factory_cleanup (GstDeviceProviderFactory * factory)
     gst_structure_free ((GstStructure *) factory->metadata);
     factory->metadata = NULL;
   }
+  factory->metadata_string = NULL;
   if (factory->type) {
     factory->type = G_TYPE_INVALID;
   }
@@ -407,6 +408,31 @@ gst_device_provider_factory_get_device_provider_type (GstDeviceProviderFactory *
   return factory->type;
 }
 
+/* factories loaded from the registry cache only parse their metadata when
+ * it is first needed */
+static GstStructure *
+gst_device_provider_factory_ensure_metadata (GstDeviceProviderFactory *
+    factory)
+{
+  GstStructure *metadata = g_atomic_pointer_get (&factory->metadata);
+
+  if (G_UNLIKELY (metadata == NULL && factory->metadata_string != NULL)) {
+    metadata = gst_structure_from_string (factory->metadata_string, NULL);
+    if (metadata == NULL) {
+      GST_ERROR_OBJECT (factory, "Failed to deserialize metadata '%s'",
+          factory->metadata_string);
+      return NULL;
+    }
+    if (!g_atomic_pointer_compare_and_exchange (&factory->metadata, NULL,
+            metadata)) {
+      gst_structure_free (metadata);
+      metadata = g_atomic_pointer_get (&factory->metadata);
+    }
+  }
+
+  return metadata;
+}
+
 /**
  * gst_device_provider_factory_get_metadata:
  * @factory: a #GstDeviceProviderFactory
@@ -423,7 +449,13 @@ const gchar *
 gst_device_provider_factory_get_metadata (GstDeviceProviderFactory * factory,
     const gchar * key)
 {
-  return gst_structure_get_string ((GstStructure *) factory->metadata, key);
+  GstStructure *metadata;
+
+  metadata = gst_device_provider_factory_ensure_metadata (factory);
+  if (metadata == NULL)
+    return NULL;
+
+  return gst_structure_get_string (metadata, key);
 }
 
 /**
@@ -448,7 +480,7 @@ gst_device_provider_factory_get_metadata_keys (GstDeviceProviderFactory *
 
   g_return_val_if_fail (GST_IS_DEVICE_PROVIDER_FACTORY (factory), NULL);
 
-  metadata = (GstStructure *) factory->metadata;
+  metadata = gst_device_provider_factory_ensure_metadata (factory);
   if (metadata == NULL)
     return NULL;
 
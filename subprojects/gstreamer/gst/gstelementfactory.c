@@ -155,6 +155,7 @@ gst_element_factory_cleanup (GstElementFactory * factory)
     gst_structure_free ((GstStructure *) factory->metadata);
     factory->metadata = NULL;
   }
+  factory->metadata_string = NULL;
   if (factory->type) {
     factory->type = G_TYPE_INVALID;
   }
@@ -474,9 +475,11 @@ gst_element_factory_create_with_properties (GstElementFactory * factory,
   GstElement *element;
   GstElementClass *oclass;
   GstElementFactory *newfactory;
+  GstClockTime start;
 
   g_return_val_if_fail (factory != NULL, NULL);
 
+  start = GST_TRACER_TIMESTAMP;
   newfactory =
       GST_ELEMENT_FACTORY (gst_plugin_feature_load (GST_PLUGIN_FEATURE
           (factory)));
@@ -504,11 +507,14 @@ gst_element_factory_create_with_properties (GstElementFactory * factory,
    */
   oclass = GST_ELEMENT_GET_CLASS (element);
   if (!g_atomic_pointer_compare_and_exchange (&oclass->elementfactory,
-          (GstElementFactory *) NULL, factory))
+          (GstElementFactory *) NULL, factory)) {
     gst_object_unref (factory);
-  else
+  } else {
     /* This ref will never be dropped as the class is never destroyed */
     GST_OBJECT_FLAG_SET (factory, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+    GST_TRACER_ELEMENT_FACTORY_FIRST_USE (factory, element,
+        GST_TRACER_ELAPSED (start));
+  }
 
   if (!g_object_is_floating ((GObject *) element)) {
     /* The reference we receive here should be floating, but we can't force
@@ -846,6 +852,30 @@ gst_element_factory_get_element_type (GstElementFactory * factory)
   return factory->type;
 }
 
+/* factories loaded from the registry cache only parse their metadata when
+ * it is first needed */
+static GstStructure *
+gst_element_factory_ensure_metadata (GstElementFactory * factory)
+{
+  GstStructure *metadata = g_atomic_pointer_get (&factory->metadata);
+
+  if (G_UNLIKELY (metadata == NULL && factory->metadata_string != NULL)) {
+    metadata = gst_structure_from_string (factory->metadata_string, NULL);
+    if (metadata == NULL) {
+      GST_ERROR_OBJECT (factory, "Failed to deserialize metadata '%s'",
+          factory->metadata_string);
+      return NULL;
+    }
+    if (!g_atomic_pointer_compare_and_exchange (&factory->metadata, NULL,
+            metadata)) {
+      gst_structure_free (metadata);
+      metadata = g_atomic_pointer_get (&factory->metadata);
+    }
+  }
+
+  return metadata;
+}
+
 /**
  * gst_element_factory_get_metadata:
  * @factory: a #GstElementFactory
@@ -860,9 +890,15 @@ const gchar *
 gst_element_factory_get_metadata (GstElementFactory * factory,
     const gchar * key)
 {
+  GstStructure *metadata;
+
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
-  return gst_structure_get_string ((GstStructure *) factory->metadata, key);
+  metadata = gst_element_factory_ensure_metadata (factory);
+  if (metadata == NULL)
+    return NULL;
+
+  return gst_structure_get_string (metadata, key);
 }
 
 /**
@@ -884,7 +920,7 @@ gst_element_factory_get_metadata_keys (GstElementFactory * factory)
 
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
-  metadata = (GstStructure *) factory->metadata;
+  metadata = gst_element_factory_ensure_metadata (factory);
   if (metadata == NULL)
     return NULL;
 
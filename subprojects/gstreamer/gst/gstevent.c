@@ -94,6 +94,9 @@ typedef struct
 
 #define GST_EVENT_STRUCTURE(e)  (((GstEventImpl *)(e))->structure)
 
+static GstFreeList event_free_list =
+    GST_FREE_LIST_INIT (sizeof (GstEventImpl));
+
 typedef struct
 {
   const gint type;
@@ -234,7 +237,7 @@ _gst_event_free (GstEvent * event)
   memset (event, 0xff, sizeof (GstEventImpl));
 #endif
 
-  g_slice_free1 (sizeof (GstEventImpl), event);
+  _priv_gst_free_list_free (&event_free_list, event);
 }
 
 static void gst_event_init (GstEventImpl * event, GstEventType type);
@@ -245,7 +248,7 @@ _gst_event_copy (GstEvent * event)
   GstEventImpl *copy;
   GstStructure *s;
 
-  copy = g_slice_new0 (GstEventImpl);
+  copy = _priv_gst_free_list_alloc0 (&event_free_list);
 
   gst_event_init (copy, GST_EVENT_TYPE (event));
 
@@ -305,7 +308,7 @@ gst_event_new_custom (GstEventType type, GstStructure * structure)
 {
   GstEventImpl *event;
 
-  event = g_slice_new0 (GstEventImpl);
+  event = _priv_gst_free_list_alloc0 (&event_free_list);
 
   GST_CAT_DEBUG (GST_CAT_EVENT, "creating new event %p %s %d", event,
       gst_event_type_get_name (type), type);
@@ -326,7 +329,7 @@ gst_event_new_custom (GstEventType type, GstStructure * structure)
   /* ERRORS */
 had_parent:
   {
-    g_slice_free1 (sizeof (GstEventImpl), event);
+    _priv_gst_free_list_free (&event_free_list, event);
     g_warning ("structure is already owned by another object");
     return NULL;
   }
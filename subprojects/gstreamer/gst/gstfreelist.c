@@ -0,0 +1,132 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * gstfreelist.c: per-thread free lists for small fixed size blocks
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Queries, events and the structures they carry are often created and
+ * destroyed for every buffer, for example position and latency queries done
+ * by sinks and demuxers. Instead of going through the system allocator every
+ * time, each thread keeps a few of the freed blocks around and hands them out
+ * again on the next allocation.
+ *
+ * Blocks are allocated with g_malloc() so they can always be released with
+ * g_free(), regardless of the thread that frees them. The number of cached
+ * blocks per thread and list is bounded and the cache is released when the
+ * thread exits.
+ *
+ * Blocks that typically move between threads, like buffer memory going from
+ * a producer to a consumer thread, would only pile up in the cache of the
+ * freeing thread and never be reused. Those use a shared free list instead,
+ * a single bounded cache protected by a mutex. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "gst_private.h"
+
+#define FREE_LIST_MAX_BLOCKS 16
+
+typedef struct
+{
+  guint n_blocks;
+  gpointer blocks[FREE_LIST_MAX_BLOCKS];
+} GstFreeListCache;
+
+void
+_priv_gst_free_list_cache_free (gpointer data)
+{
+  GstFreeListCache *cache = data;
+  guint i;
+
+  for (i = 0; i < cache->n_blocks; i++)
+    g_free (cache->blocks[i]);
+  g_free (cache);
+}
+
+gpointer
+_priv_gst_free_list_alloc0 (GstFreeList * list)
+{
+  GstFreeListCache *cache = g_private_get (&list->cache);
+
+  if (cache && cache->n_blocks > 0) {
+    gpointer block = cache->blocks[--cache->n_blocks];
+
+    memset (block, 0, list->block_size);
+    return block;
+  }
+
+  return g_malloc0 (list->block_size);
+}
+
+void
+_priv_gst_free_list_free (GstFreeList * list, gpointer block)
+{
+  GstFreeListCache *cache = g_private_get (&list->cache);
+
+  if (G_UNLIKELY (cache == NULL)) {
+    cache = g_new0 (GstFreeListCache, 1);
+    g_private_set (&list->cache, cache);
+  }
+
+  if (cache->n_blocks < FREE_LIST_MAX_BLOCKS)
+    cache->blocks[cache->n_blocks++] = block;
+  else
+    g_free (block);
+}
+
+gpointer
+_priv_gst_shared_free_list_alloc (GstSharedFreeList * list)
+{
+  gpointer block = NULL;
+
+  g_mutex_lock (&list->lock);
+  if (list->n_blocks > 0)
+    block = list->blocks[--list->n_blocks];
+  g_mutex_unlock (&list->lock);
+
+  if (block == NULL)
+    block = g_malloc (list->block_size);
+
+  return block;
+}
+
+void
+_priv_gst_shared_free_list_free (GstSharedFreeList * list, gpointer block)
+{
+  g_mutex_lock (&list->lock);
+  if (list->n_blocks < GST_SHARED_FREE_LIST_MAX_BLOCKS) {
+    list->blocks[list->n_blocks++] = block;
+    block = NULL;
+  }
+  g_mutex_unlock (&list->lock);
+
+  g_free (block);
+}
+
+void
+_priv_gst_shared_free_list_clear (GstSharedFreeList * list)
+{
+  g_mutex_lock (&list->lock);
+  while (list->n_blocks > 0)
+    g_free (list->blocks[--list->n_blocks]);
+  g_mutex_unlock (&list->lock);
+}
@@ -399,7 +399,13 @@ _priv_gst_debug_init (void)
       log_file = stderr;
     }
 
-    gst_debug_add_log_function (gst_debug_log_default, log_file, NULL);
+    env = g_getenv ("GST_DEBUG_BINARY");
+    if (env != NULL && *env != '\0' && log_file != stderr
+        && log_file != stdout) {
+      gst_debug_add_log_function (gst_debug_log_binary, log_file, NULL);
+    } else {
+      gst_debug_add_log_function (gst_debug_log_default, log_file, NULL);
+    }
   }
 
   __gst_printf_pointer_extension_set_func
@@ -1439,6 +1445,592 @@ gst_debug_log_default (GstDebugCategory * category, GstDebugLevel level,
     g_free (obj);
 }
 
+/* Binary log output
+ *
+ * Messages are not formatted but serialized into a compact binary form: the
+ * format string, file, function and category names are interned and written
+ * out once, while the arguments are stored as raw values. Each thread
+ * serializes its messages into its own ring buffer without taking any locks,
+ * only writing out the buffer to the log file needs the lock. Messages using
+ * GStreamer specific format extensions (e.g. GST_PTR_FORMAT) need to be
+ * formatted right away and are stored as preformatted strings instead.
+ *
+ * The resulting file can be turned into a regular debug log with the
+ * gst-debug-decode.py script from gst-devtools.
+ *
+ * File format, all values in host byte order:
+ *   header:  "GSTBLOG\0", guint32 version, guint32 byte order mark
+ *            (0x01020304), guint32 pid
+ *   intern:  guint8 'S', guint32 id, string
+ *   message: guint8 'M', guint64 elapsed time, guint64 thread, guint8 level,
+ *            guint32 category id, guint32 file id, guint32 function id,
+ *            guint32 line, string object, guint32 format id (0 if the only
+ *            argument is the preformatted message), guint32 n_args, args
+ *   arg:     guint8 'i' + gint64, 'u' + guint64, 'd' + gdouble,
+ *            'p' + guint64 or 's' + string
+ *   string:  guint32 length (G_MAXUINT32 for NULL) followed by the bytes
+ *
+ * Format strings, file and function names are interned by their content as
+ * bindings and gst_debug_log() callers can pass strings that don't outlive
+ * the call, so their addresses might get reused for other strings. */
+
+#define BINARY_LOG_VERSION 1
+#define BINARY_LOG_BUFFER_SIZE (64 * 1024)
+#define BINARY_LOG_BUFFER_MASK (BINARY_LOG_BUFFER_SIZE - 1)
+
+typedef struct
+{
+  /* ring buffer, head is only written by the owning thread, tail only with
+   * the binary_log_lock */
+  guint8 *data;
+  gint head;
+  gint tail;
+
+  /* scratch space for serializing one message */
+  GByteArray *scratch;
+
+  /* string -> id, owning thread only */
+  GHashTable *strings;
+  guint generation;
+} GstDebugBinaryThread;
+
+static GMutex binary_log_lock;
+static FILE *binary_log_file;
+static GHashTable *binary_log_strings;
+static guint32 binary_log_n_strings;
+static GSList *binary_log_threads;
+static gint binary_log_generation;
+
+static void gst_debug_binary_thread_free (gpointer data);
+static GPrivate binary_log_thread =
+G_PRIVATE_INIT (gst_debug_binary_thread_free);
+
+#define BINARY_APPEND(a, type, val) G_STMT_START { \
+    type __v = (val); \
+    g_byte_array_append ((a), (const guint8 *) &__v, sizeof (type)); \
+  } G_STMT_END
+
+static void
+binary_log_append_string (GByteArray * a, const gchar * str, gssize len)
+{
+  if (str == NULL) {
+    BINARY_APPEND (a, guint32, G_MAXUINT32);
+    return;
+  }
+
+  if (len < 0)
+    len = strlen (str);
+  BINARY_APPEND (a, guint32, len);
+  g_byte_array_append (a, (const guint8 *) str, len);
+}
+
+/* with binary_log_lock */
+static void
+binary_log_write_locked (gconstpointer data, gsize len)
+{
+  if (binary_log_file)
+    fwrite (data, 1, len, binary_log_file);
+}
+
+/* with binary_log_lock */
+static void
+binary_log_flush_thread_locked (GstDebugBinaryThread * thread)
+{
+  guint head = g_atomic_int_get (&thread->head);
+  guint tail = thread->tail;
+
+  while (tail != head) {
+    guint offset = tail & BINARY_LOG_BUFFER_MASK;
+    guint len = MIN (head - tail, BINARY_LOG_BUFFER_SIZE - offset);
+
+    binary_log_write_locked (thread->data + offset, len);
+    tail += len;
+  }
+  g_atomic_int_set (&thread->tail, tail);
+}
+
+/* with binary_log_lock */
+static void
+binary_log_flush_all_locked (void)
+{
+  GSList *l;
+
+  for (l = binary_log_threads; l; l = l->next)
+    binary_log_flush_thread_locked (l->data);
+
+  if (binary_log_file)
+    fflush (binary_log_file);
+}
+
+/* with binary_log_lock, starts writing to @file. The interned strings are
+ * forgotten so they are written again to the new file. */
+static void
+binary_log_set_file_locked (FILE * file)
+{
+  binary_log_flush_all_locked ();
+
+  g_atomic_pointer_set (&binary_log_file, file);
+  g_clear_pointer (&binary_log_strings, g_hash_table_unref);
+  binary_log_n_strings = 0;
+  g_atomic_int_inc (&binary_log_generation);
+
+  if (file) {
+    guint32 header[3];
+
+    header[0] = BINARY_LOG_VERSION;
+    header[1] = 0x01020304;
+    header[2] = _gst_getpid ();
+    binary_log_write_locked ("GSTBLOG", 8);
+    binary_log_write_locked (header, sizeof (header));
+  }
+}
+
+static void
+gst_debug_binary_thread_free (gpointer data)
+{
+  GstDebugBinaryThread *thread = data;
+
+  g_mutex_lock (&binary_log_lock);
+  binary_log_flush_thread_locked (thread);
+  if (binary_log_file)
+    fflush (binary_log_file);
+  binary_log_threads = g_slist_remove (binary_log_threads, thread);
+  g_mutex_unlock (&binary_log_lock);
+
+  g_hash_table_unref (thread->strings);
+  g_byte_array_unref (thread->scratch);
+  g_free (thread->data);
+  g_free (thread);
+}
+
+static GstDebugBinaryThread *
+binary_log_get_thread (void)
+{
+  GstDebugBinaryThread *thread = g_private_get (&binary_log_thread);
+
+  if (G_UNLIKELY (thread == NULL)) {
+    thread = g_new0 (GstDebugBinaryThread, 1);
+    thread->data = g_malloc (BINARY_LOG_BUFFER_SIZE);
+    thread->scratch = g_byte_array_sized_new (256);
+    thread->strings =
+        g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    thread->generation = g_atomic_int_get (&binary_log_generation);
+    g_private_set (&binary_log_thread, thread);
+
+    g_mutex_lock (&binary_log_lock);
+    binary_log_threads = g_slist_prepend (binary_log_threads, thread);
+    g_mutex_unlock (&binary_log_lock);
+  }
+
+  return thread;
+}
+
+/* Returns the id of @str, writing it to the log file first if it was not
+ * seen before. Only the first lookup of a string from each thread takes the
+ * lock. %NULL has the id 0. */
+static guint32
+binary_log_intern (GstDebugBinaryThread * thread, const gchar * str)
+{
+  gpointer id;
+  guint generation = g_atomic_int_get (&binary_log_generation);
+
+  if (G_UNLIKELY (str == NULL))
+    return 0;
+
+  if (G_UNLIKELY (thread->generation != generation)) {
+    g_hash_table_remove_all (thread->strings);
+    thread->generation = generation;
+  }
+
+  if (G_LIKELY (g_hash_table_lookup_extended (thread->strings, str, NULL,
+              &id)))
+    return GPOINTER_TO_UINT (id);
+
+  g_mutex_lock (&binary_log_lock);
+  if (binary_log_strings == NULL)
+    binary_log_strings =
+        g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  id = g_hash_table_lookup (binary_log_strings, str);
+  if (id == NULL) {
+    GByteArray *def = g_byte_array_sized_new (64);
+
+    id = GUINT_TO_POINTER (++binary_log_n_strings);
+    g_hash_table_insert (binary_log_strings, g_strdup (str), id);
+
+    BINARY_APPEND (def, guint8, 'S');
+    BINARY_APPEND (def, guint32, GPOINTER_TO_UINT (id));
+    binary_log_append_string (def, str, -1);
+    binary_log_write_locked (def->data, def->len);
+    g_byte_array_unref (def);
+  }
+  g_mutex_unlock (&binary_log_lock);
+
+  g_hash_table_insert (thread->strings, g_strdup (str), id);
+
+  return GPOINTER_TO_UINT (id);
+}
+
+/* Serializes the arguments of @format into @a. Returns the number of
+ * arguments or -1 if the format can't be stored unformatted. */
+static gint
+binary_log_append_args (GByteArray * a, const gchar * format, va_list args)
+{
+  const gchar *p = format;
+  gint n_args = 0;
+
+  while ((p = strchr (p, '%'))) {
+    /* 'h', 'H' (hh), 'l', 'L' (ll), 'D' (long double), 'j', 'z' or 't'.
+     * intmax_t is assumed to be 64 bits and ptrdiff_t to be pointer sized */
+    gint length = 0;
+    gint precision = -1;
+    gint i;
+
+    p++;
+    if (*p == '%') {
+      p++;
+      continue;
+    }
+
+    /* flags */
+    while (*p && strchr ("-+ #0'", *p))
+      p++;
+
+    /* width and precision */
+    for (i = 0; i < 2; i++) {
+      if (i == 1) {
+        if (*p != '.')
+          break;
+        p++;
+      }
+      if (*p == '*') {
+        gint val = va_arg (args, gint);
+
+        /* a negative precision is taken as if it was omitted */
+        if (i == 1 && val >= 0)
+          precision = val;
+        BINARY_APPEND (a, guint8, 'i');
+        BINARY_APPEND (a, gint64, val);
+        n_args++;
+        p++;
+      } else {
+        if (i == 1)
+          precision = 0;
+        while (g_ascii_isdigit (*p)) {
+          if (i == 1 && precision < G_MAXINT / 10)
+            precision = precision * 10 + (*p - '0');
+          p++;
+        }
+        /* positional arguments */
+        if (*p == '$')
+          return -1;
+      }
+    }
+
+    /* length modifiers */
+    switch (*p) {
+      case 'h':
+        length = (p[1] == 'h') ? 'H' : 'h';
+        p += (p[1] == 'h') ? 2 : 1;
+        break;
+      case 'l':
+        length = (p[1] == 'l') ? 'L' : 'l';
+        p += (p[1] == 'l') ? 2 : 1;
+        break;
+      case 'q':
+        length = 'L';
+        p++;
+        break;
+      case 'L':
+        length = 'D';
+        p++;
+        break;
+      case 'j':
+      case 'z':
+      case 't':
+        length = *p++;
+        break;
+      case 'I':
+        if (p[1] == '6' && p[2] == '4') {
+          length = 'L';
+          p += 3;
+        } else if (p[1] == '3' && p[2] == '2') {
+          p += 3;
+        }
+        break;
+      default:
+        break;
+    }
+
+    switch (*p) {
+      case 'd':
+      case 'i':{
+        gint64 val;
+
+        switch (length) {
+          case 'H':
+            val = (gchar) va_arg (args, gint);
+            break;
+          case 'h':
+            val = (gshort) va_arg (args, gint);
+            break;
+          case 'l':
+            val = va_arg (args, glong);
+            break;
+          case 'L':
+          case 'D':
+          case 'j':
+            val = va_arg (args, gint64);
+            break;
+          case 'z':
+          case 't':
+            val = va_arg (args, gssize);
+            break;
+          default:
+            val = va_arg (args, gint);
+            break;
+        }
+        BINARY_APPEND (a, guint8, 'i');
+        BINARY_APPEND (a, gint64, val);
+        break;
+      }
+      case 'o':
+      case 'u':
+      case 'x':
+      case 'X':{
+        guint64 val;
+
+        switch (length) {
+          case 'H':
+            val = (guchar) va_arg (args, guint);
+            break;
+          case 'h':
+            val = (gushort) va_arg (args, guint);
+            break;
+          case 'l':
+            val = va_arg (args, gulong);
+            break;
+          case 'L':
+          case 'D':
+          case 'j':
+            val = va_arg (args, guint64);
+            break;
+          case 'z':
+          case 't':
+            val = va_arg (args, gsize);
+            break;
+          default:
+            val = va_arg (args, guint);
+            break;
+        }
+        BINARY_APPEND (a, guint8, 'u');
+        BINARY_APPEND (a, guint64, val);
+        break;
+      }
+      case 'c':
+        BINARY_APPEND (a, guint8, 'i');
+        BINARY_APPEND (a, gint64, va_arg (args, gint));
+        break;
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        BINARY_APPEND (a, guint8, 'd');
+        if (length == 'D')
+          BINARY_APPEND (a, gdouble, va_arg (args, long double));
+        else
+          BINARY_APPEND (a, gdouble, va_arg (args, gdouble));
+        break;
+      case 's':{
+        const gchar *str;
+        gssize len = -1;
+
+        /* wide strings */
+        if (length != 0)
+          return -1;
+
+        /* with a precision the string does not need to be NUL-terminated */
+        str = va_arg (args, const gchar *);
+        if (str && precision >= 0) {
+          const gchar *end = memchr (str, '\0', precision);
+
+          len = end ? end - str : precision;
+        }
+        BINARY_APPEND (a, guint8, 's');
+        binary_log_append_string (a, str, len);
+        break;
+      }
+      case 'p':
+        /* GStreamer printf extensions need to be formatted right away */
+        if (p[1] == '\a')
+          return -1;
+        BINARY_APPEND (a, guint8, 'p');
+        BINARY_APPEND (a, guint64, GPOINTER_TO_SIZE (va_arg (args, gpointer)));
+        break;
+      default:
+        return -1;
+    }
+    p++;
+    n_args++;
+  }
+
+  return n_args;
+}
+
+/* Copies the serialized message to the thread's ring buffer */
+static void
+binary_log_commit (GstDebugBinaryThread * thread, GstDebugLevel level)
+{
+  GByteArray *a = thread->scratch;
+  guint head = thread->head;
+  guint offset, len;
+
+  if (G_UNLIKELY (a->len > BINARY_LOG_BUFFER_SIZE - (head -
+              (guint) g_atomic_int_get (&thread->tail)))) {
+    g_mutex_lock (&binary_log_lock);
+    binary_log_flush_thread_locked (thread);
+    /* does not fit at all, write it out directly */
+    if (a->len > BINARY_LOG_BUFFER_SIZE)
+      binary_log_write_locked (a->data, a->len);
+    g_mutex_unlock (&binary_log_lock);
+
+    if (a->len > BINARY_LOG_BUFFER_SIZE)
+      return;
+  }
+
+  offset = head & BINARY_LOG_BUFFER_MASK;
+  len = MIN (a->len, BINARY_LOG_BUFFER_SIZE - offset);
+  memcpy (thread->data + offset, a->data, len);
+  if (len < a->len)
+    memcpy (thread->data, a->data + len, a->len - len);
+  g_atomic_int_set (&thread->head, head + a->len);
+
+  /* make sure errors make it to the file, the application might be about to
+   * abort */
+  if (G_UNLIKELY (level == GST_LEVEL_ERROR)) {
+    g_mutex_lock (&binary_log_lock);
+    binary_log_flush_all_locked ();
+    g_mutex_unlock (&binary_log_lock);
+  }
+}
+
+/**
+ * gst_debug_log_binary:
+ * @category: category to log
+ * @level: level of the message
+ * @file: the file that emitted the message, usually the __FILE__ identifier
+ * @function: the function that emitted the message
+ * @line: the line from that the message was emitted, usually __LINE__
+ * @object: (transfer none) (allow-none): the object this message relates to,
+ *     or %NULL if none
+ * @message: the actual message
+ * @user_data: the FILE* to log to
+ *
+ * A logging handler that writes messages in a compact binary form instead
+ * of formatting them, which is a lot cheaper when logging at high debug
+ * levels. Format strings and source locations are only written once and the
+ * arguments are stored as raw values. Messages are collected in per-thread
+ * buffers and written out to @user_data when a buffer is full, when an error
+ * is logged, when the thread exits or when the log function is removed.
+ *
+ * The log can be turned into the same text format as written by
+ * gst_debug_log_default() with the gst-debug-decode.py script from
+ * gst-devtools.
+ *
+ * Only one file can be logged to in binary form at a time. This handler can
+ * also be selected instead of the default handler by setting the
+ * `GST_DEBUG_BINARY` environment variable in addition to `GST_DEBUG_FILE`.
+ *
+ * Since: 1.22
+ */
+void
+gst_debug_log_binary (GstDebugCategory * category, GstDebugLevel level,
+    const gchar * file, const gchar * function, gint line,
+    GObject * object, GstDebugMessage * message, gpointer user_data)
+{
+  GstDebugBinaryThread *thread;
+  GstClockTime elapsed;
+  GByteArray *a;
+  guint n_args_pos;
+  gint n_args = -1;
+
+  g_return_if_fail (user_data != NULL);
+
+  elapsed = GST_CLOCK_DIFF (_priv_gst_start_time, gst_util_get_timestamp ());
+
+  if (G_UNLIKELY (g_atomic_pointer_get (&binary_log_file) != user_data)) {
+    g_mutex_lock (&binary_log_lock);
+    if (binary_log_file != user_data)
+      binary_log_set_file_locked (user_data);
+    g_mutex_unlock (&binary_log_lock);
+  }
+
+  thread = binary_log_get_thread ();
+  a = thread->scratch;
+  g_byte_array_set_size (a, 0);
+
+  BINARY_APPEND (a, guint8, 'M');
+  BINARY_APPEND (a, guint64, elapsed);
+  BINARY_APPEND (a, guint64, GPOINTER_TO_SIZE (g_thread_self ()));
+  BINARY_APPEND (a, guint8, level);
+  BINARY_APPEND (a, guint32, binary_log_intern (thread,
+          gst_debug_category_get_name (category)));
+  BINARY_APPEND (a, guint32, binary_log_intern (thread, file));
+  BINARY_APPEND (a, guint32, binary_log_intern (thread, function));
+  BINARY_APPEND (a, guint32, line);
+
+  if (object) {
+    gchar *obj = gst_debug_print_object (object);
+
+    binary_log_append_string (a, obj, -1);
+    g_free (obj);
+  } else {
+    binary_log_append_string (a, "", 0);
+  }
+
+  n_args_pos = a->len;
+
+  /* the message may already be formatted by another handler, or be a
+   * literal without format */
+  if (message->message == NULL) {
+    va_list args;
+
+    BINARY_APPEND (a, guint32, binary_log_intern (thread, message->format));
+    BINARY_APPEND (a, guint32, 0);
+
+    G_VA_COPY (args, message->arguments);
+    n_args = binary_log_append_args (a, message->format, args);
+    va_end (args);
+  }
+
+  if (n_args >= 0) {
+    guint32 n = n_args;
+
+    memcpy (a->data + n_args_pos + sizeof (guint32), &n, sizeof (guint32));
+  } else {
+    g_byte_array_set_size (a, n_args_pos);
+    BINARY_APPEND (a, guint32, 0);
+    BINARY_APPEND (a, guint32, 1);
+    BINARY_APPEND (a, guint8, 's');
+    binary_log_append_string (a, gst_debug_message_get (message), -1);
+  }
+
+  binary_log_commit (thread, level);
+}
+
+/* Writes out all pending binary messages and stops writing to the current
+ * file */
+static void
+gst_debug_binary_log_reset (void)
+{
+  g_mutex_lock (&binary_log_lock);
+  binary_log_set_file_locked (NULL);
+  g_mutex_unlock (&binary_log_lock);
+}
+
 /**
  * gst_debug_level_get_name:
  * @level: the level to get the name for
@@ -1584,6 +2176,10 @@ gst_debug_remove_log_function (GstLogFunction func)
   if (func == NULL)
     func = gst_debug_log_default;
 
+  /* write out what is still pending before the file is closed */
+  if (func == gst_debug_log_binary)
+    gst_debug_binary_log_reset ();
+
   removals =
       gst_debug_remove_with_compare_func
       (gst_debug_compare_log_function_by_func, (gpointer) func);
@@ -2275,6 +2871,8 @@ _gst_debug_register_funcptr (GstDebugFuncPtr func, const gchar * ptrname)
 void
 _priv_gst_debug_cleanup (void)
 {
+  gst_debug_binary_log_reset ();
+
   g_mutex_lock (&__dbg_functions_mutex);
 
   if (__gst_function_pointers) {
@@ -2431,6 +3029,13 @@ gst_debug_log_default (GstDebugCategory * category, GstDebugLevel level,
 {
 }
 
+void
+gst_debug_log_binary (GstDebugCategory * category, GstDebugLevel level,
+    const gchar * file, const gchar * function, gint line,
+    GObject * object, GstDebugMessage * message, gpointer unused)
+{
+}
+
 const gchar *
 gst_debug_level_get_name (GstDebugLevel level)
 {
@@ -4679,6 +4679,34 @@ gst_pad_push_data (GstPad * pad, GstPadProbeType type, void *data)
   }
 #endif
 
+  /* Fast path for the common case: no probes installed and no sticky events
+   * waiting to be forwarded. Nothing below can change the peer then, so skip
+   * the sticky event checks and the probes and go straight to it. */
+  if (G_LIKELY (pad->num_probes == 0 && !GST_PAD_HAS_PENDING_EVENTS (pad)
+          && (peer = GST_PAD_PEER (pad)) != NULL)) {
+    gst_object_ref (peer);
+    pad->priv->using++;
+    GST_OBJECT_UNLOCK (pad);
+
+    ret = gst_pad_chain_data_unchecked (peer, type, data);
+    data = NULL;
+
+    gst_object_unref (peer);
+
+    /* idle probes might have been added while we were pushing */
+    GST_OBJECT_LOCK (pad);
+    pad->ABI.abi.last_flowret = ret;
+    pad->priv->using--;
+    if (pad->priv->using == 0) {
+      /* pad is not active anymore, trigger idle callbacks */
+      PROBE_NO_DATA (pad, GST_PAD_PROBE_TYPE_PUSH | GST_PAD_PROBE_TYPE_IDLE,
+          probe_stopped, ret);
+    }
+    GST_OBJECT_UNLOCK (pad);
+
+    return ret;
+  }
+
   if (G_UNLIKELY ((ret = check_sticky (pad, NULL))) != GST_FLOW_OK)
     goto events_error;
 
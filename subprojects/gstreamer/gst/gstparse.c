@@ -49,6 +49,10 @@ G_DEFINE_BOXED_TYPE (GstParseContext, gst_parse_context,
     (GBoxedCopyFunc) gst_parse_context_copy,
     (GBoxedFreeFunc) gst_parse_context_free);
 
+G_DEFINE_BOXED_TYPE (GstParseTemplate, gst_parse_template,
+    (GBoxedCopyFunc) gst_parse_template_ref,
+    (GBoxedFreeFunc) gst_parse_template_unref);
+
 /**
  * gst_parse_error_quark:
  *
@@ -345,7 +349,7 @@ gst_parse_launch_full (const gchar * pipeline_description,
       pipeline_description);
 
   element = priv_gst_parse_launch (pipeline_description, &myerror, context,
-      flags);
+      flags, NULL);
 
   /* don't return partially constructed pipeline if FATAL_ERRORS was given */
   if (G_UNLIKELY (myerror != NULL && element != NULL)) {
@@ -371,3 +375,181 @@ gst_parse_launch_full (const gchar * pipeline_description,
   return NULL;
 #endif
 }
+
+/**
+ * gst_parse_template_new:
+ * @pipeline_description: the command line describing the pipeline
+ * @context: (allow-none): a parse context allocated with
+ *      gst_parse_context_new(), or %NULL
+ * @flags: parsing options, or #GST_PARSE_FLAG_NONE
+ * @error: the error message in case of an erroneous pipeline.
+ *
+ * Parses @pipeline_description once into a template from which any number of
+ * pipelines can be created with gst_parse_template_instantiate(). The
+ * template stores the resolved element factories, the property values
+ * converted from their string representation, the parsed link caps and the
+ * links to perform, so instantiating it neither parses the description nor
+ * looks up factories or deserializes values again.
+ *
+ * The pipeline is built once while creating the template. Unlike with
+ * gst_parse_launch_full(), any error, including recoverable ones, makes this
+ * function fail.
+ *
+ * Property values that hold objects (e.g. bins described for element
+ * properties) and properties of children set through #GstChildProxy are
+ * parsed again for every instance.
+ *
+ * Returns: (transfer full) (nullable): a new #GstParseTemplate or %NULL on
+ *     failure.
+ *
+ * Since: 1.22
+ */
+GstParseTemplate *
+gst_parse_template_new (const gchar * pipeline_description,
+    GstParseContext * context, GstParseFlags flags, GError ** error)
+{
+#ifndef GST_DISABLE_PARSE
+  GstParseTemplate *templ;
+  GstElement *element;
+  GError *myerror = NULL;
+
+  g_return_val_if_fail (pipeline_description != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  GST_CAT_INFO (GST_CAT_PIPELINE, "compiling pipeline description '%s'",
+      pipeline_description);
+
+  templ = g_slice_new0 (GstParseTemplate);
+  templ->refcount = 1;
+  templ->flags = flags;
+  templ->ops = g_array_new (FALSE, TRUE, sizeof (plan_op_t));
+  templ->toplevel = -1;
+
+  element = priv_gst_parse_launch (pipeline_description, &myerror, context,
+      flags, templ);
+  if (element)
+    gst_object_unref (gst_object_ref_sink (element));
+
+  if (G_UNLIKELY (myerror != NULL || templ->toplevel < 0)) {
+    if (myerror)
+      g_propagate_error (error, myerror);
+    else
+      g_set_error (error, GST_PARSE_ERROR, GST_PARSE_ERROR_EMPTY,
+          "Could not create a template from pipeline description");
+    gst_parse_template_unref (templ);
+    return NULL;
+  }
+
+  GST_CAT_DEBUG (GST_CAT_PIPELINE, "template %p has %u elements and %u "
+      "operations", templ, templ->n_elements, templ->ops->len);
+
+  return templ;
+#else
+  gchar *msg;
+
+  GST_WARNING ("Disabled API called");
+
+  msg = gst_error_get_message (GST_CORE_ERROR, GST_CORE_ERROR_DISABLED);
+  g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_DISABLED, "%s", msg);
+  g_free (msg);
+
+  return NULL;
+#endif
+}
+
+/**
+ * gst_parse_template_ref:
+ * @templ: a #GstParseTemplate
+ *
+ * Increases the refcount of @templ.
+ *
+ * Returns: (transfer full): @templ
+ *
+ * Since: 1.22
+ */
+GstParseTemplate *
+gst_parse_template_ref (GstParseTemplate * templ)
+{
+#ifndef GST_DISABLE_PARSE
+  g_return_val_if_fail (templ != NULL, NULL);
+
+  g_atomic_int_inc (&templ->refcount);
+#endif
+  return templ;
+}
+
+/**
+ * gst_parse_template_unref:
+ * @templ: (transfer full): a #GstParseTemplate
+ *
+ * Decreases the refcount of @templ, freeing it when the last reference is
+ * dropped.
+ *
+ * Since: 1.22
+ */
+void
+gst_parse_template_unref (GstParseTemplate * templ)
+{
+#ifndef GST_DISABLE_PARSE
+  g_return_if_fail (templ != NULL);
+
+  if (g_atomic_int_dec_and_test (&templ->refcount)) {
+    priv_gst_parse_template_clear (templ);
+    g_array_unref (templ->ops);
+    g_slice_free (GstParseTemplate, templ);
+  }
+#endif
+}
+
+/**
+ * gst_parse_template_instantiate:
+ * @templ: a #GstParseTemplate
+ * @error: the error message in case the pipeline could not be created.
+ *
+ * Creates a new pipeline from @templ. This is equivalent to calling
+ * gst_parse_launch_full() with the description, parse context and flags
+ * @templ was created with. It is safe to instantiate a template from
+ * multiple threads at once.
+ *
+ * Returns: (transfer floating) (nullable): a new element on success, %NULL
+ *    on failure. Like with gst_parse_launch_full(), a partially constructed
+ *    element might be returned together with @error, unless
+ *    #GST_PARSE_FLAG_FATAL_ERRORS was given.
+ *
+ * Since: 1.22
+ */
+GstElement *
+gst_parse_template_instantiate (GstParseTemplate * templ, GError ** error)
+{
+#ifndef GST_DISABLE_PARSE
+  GstElement *element;
+  GError *myerror = NULL;
+
+  g_return_val_if_fail (templ != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  element = priv_gst_parse_template_instantiate (templ, &myerror);
+
+  if (G_UNLIKELY (myerror != NULL && element != NULL)) {
+    if ((templ->flags & GST_PARSE_FLAG_FATAL_ERRORS)) {
+      gst_object_unref (element);
+      element = NULL;
+    }
+  }
+
+  if (myerror)
+    g_propagate_error (error, myerror);
+
+  return element;
+#else
+  gchar *msg;
+
+  GST_WARNING ("Disabled API called");
+
+  msg = gst_error_get_message (GST_CORE_ERROR, GST_CORE_ERROR_DISABLED);
+  g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_DISABLED, "%s", msg);
+  g_free (msg);
+
+  return NULL;
+#endif
+}
@@ -131,8 +131,39 @@ GstElement      * gst_parse_launchv_full (const gchar     ** argv,
                                           GstParseFlags      flags,
                                           GError          ** error) G_GNUC_MALLOC;
 
+#define GST_TYPE_PARSE_TEMPLATE (gst_parse_template_get_type())
+
+/**
+ * GstParseTemplate:
+ *
+ * Opaque structure.
+ *
+ * Since: 1.22
+ */
+typedef struct _GstParseTemplate GstParseTemplate;
+
+GST_API
+GType              gst_parse_template_get_type    (void);
+
+GST_API
+GstParseTemplate * gst_parse_template_new         (const gchar      * pipeline_description,
+                                                   GstParseContext  * context,
+                                                   GstParseFlags      flags,
+                                                   GError          ** error) G_GNUC_MALLOC;
+GST_API
+GstParseTemplate * gst_parse_template_ref         (GstParseTemplate * templ);
+
+GST_API
+void               gst_parse_template_unref       (GstParseTemplate * templ);
+
+GST_API
+GstElement       * gst_parse_template_instantiate (GstParseTemplate * templ,
+                                                   GError          ** error) G_GNUC_MALLOC;
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstParseContext, gst_parse_context_free)
 
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstParseTemplate, gst_parse_template_unref)
+
 G_END_DECLS
 
 #endif /* __GST_PARSE_H__ */
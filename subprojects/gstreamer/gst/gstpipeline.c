@@ -86,6 +86,7 @@
 #include "gstinfo.h"
 #include "gstsystemclock.h"
 #include "gstutils.h"
+#include "glib-compat-private.h"
 
 GST_DEBUG_CATEGORY_STATIC (pipeline_debug);
 #define GST_CAT_DEFAULT pipeline_debug
@@ -100,13 +101,15 @@ enum
 #define DEFAULT_DELAY           0
 #define DEFAULT_AUTO_FLUSH_BUS  TRUE
 #define DEFAULT_LATENCY         GST_CLOCK_TIME_NONE
+#define DEFAULT_TASK_POOL       NULL
 
 enum
 {
   PROP_0,
   PROP_DELAY,
   PROP_AUTO_FLUSH_BUS,
-  PROP_LATENCY
+  PROP_LATENCY,
+  PROP_TASK_POOL
 };
 
 struct _GstPipelinePrivate
@@ -122,6 +125,13 @@ struct _GstPipelinePrivate
 
   GstClockTime latency;
 
+  /* pool assigned to the streaming threads of all pads in the pipeline */
+  GstTaskPool *task_pool;
+
+  /* GstPipelineTaskAffinity applied to newly created tasks, most recently
+   * added first */
+  GList *task_affinities;
+
   /* seqnum of the most recent instant-rate-request, %GST_SEQNUM_INVALID if none */
   guint32 instant_rate_seqnum;
   gdouble active_instant_rate;
@@ -129,6 +139,20 @@ struct _GstPipelinePrivate
   GstClockTime instant_rate_clock_anchor;
 };
 
+typedef struct
+{
+  GPatternSpec *pattern;
+  guint *cpus;
+  guint n_cpus;
+} GstPipelineTaskAffinity;
+
+static void
+gst_pipeline_task_affinity_free (GstPipelineTaskAffinity * affinity)
+{
+  g_pattern_spec_free (affinity->pattern);
+  g_free (affinity->cpus);
+  g_free (affinity);
+}
 
 static void gst_pipeline_dispose (GObject * object);
 static void gst_pipeline_set_property (GObject * object, guint prop_id,
@@ -205,6 +229,19 @@ gst_pipeline_class_init (GstPipelineClass * klass)
           "Latency to configure on the pipeline", 0, G_MAXUINT64,
           DEFAULT_LATENCY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstPipeline:task-pool:
+   *
+   * The #GstTaskPool to run all streaming threads of the pipeline from.
+   * See gst_pipeline_set_task_pool().
+   *
+   * Since: 1.22
+   **/
+  g_object_class_install_property (gobject_class, PROP_TASK_POOL,
+      g_param_spec_object ("task-pool", "Task Pool",
+          "The task pool to run the streaming threads of the pipeline from",
+          GST_TYPE_TASK_POOL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->dispose = gst_pipeline_dispose;
 
   gst_element_class_set_static_metadata (gstelement_class, "Pipeline object",
@@ -232,6 +269,7 @@ gst_pipeline_init (GstPipeline * pipeline)
   pipeline->priv->auto_flush_bus = DEFAULT_AUTO_FLUSH_BUS;
   pipeline->delay = DEFAULT_DELAY;
   pipeline->priv->latency = DEFAULT_LATENCY;
+  pipeline->priv->task_pool = DEFAULT_TASK_POOL;
 
   pipeline->priv->is_live = FALSE;
 
@@ -259,6 +297,10 @@ gst_pipeline_dispose (GObject * object)
 
   /* clear and unref any fixed clock */
   gst_object_replace ((GstObject **) clock_p, NULL);
+  gst_object_replace ((GstObject **) & pipeline->priv->task_pool, NULL);
+  g_list_free_full (pipeline->priv->task_affinities,
+      (GDestroyNotify) gst_pipeline_task_affinity_free);
+  pipeline->priv->task_affinities = NULL;
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
@@ -279,6 +321,9 @@ gst_pipeline_set_property (GObject * object, guint prop_id,
     case PROP_LATENCY:
       gst_pipeline_set_latency (pipeline, g_value_get_uint64 (value));
       break;
+    case PROP_TASK_POOL:
+      gst_pipeline_set_task_pool (pipeline, g_value_get_object (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -301,6 +346,9 @@ gst_pipeline_get_property (GObject * object, guint prop_id,
     case PROP_LATENCY:
       g_value_set_uint64 (value, gst_pipeline_get_latency (pipeline));
       break;
+    case PROP_TASK_POOL:
+      g_value_take_object (value, gst_pipeline_get_task_pool (pipeline));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -600,6 +648,41 @@ invalid_clock:
   }
 }
 
+/* with pipeline LOCK. Pad tasks only get their "element:pad" name when their
+ * thread enters them, after the CREATE stream status, so the name is built
+ * from the pad that posted the message instead. */
+static void
+gst_pipeline_apply_task_affinity (GstPipeline * pipeline, GstTask * task,
+    GstObject * src, GstElement * owner)
+{
+  GstElementFactory *factory;
+  const gchar *factory_name = NULL;
+  gchar *task_name;
+  GList *l;
+
+  if (GST_IS_PAD (src) && GST_OBJECT_PARENT (src))
+    task_name = g_strdup_printf ("%s:%s", GST_DEBUG_PAD_NAME (src));
+  else
+    task_name = gst_object_get_name (GST_OBJECT_CAST (task));
+  if (owner && (factory = gst_element_get_factory (owner)))
+    factory_name = GST_OBJECT_NAME (factory);
+
+  for (l = pipeline->priv->task_affinities; l; l = l->next) {
+    GstPipelineTaskAffinity *affinity = l->data;
+
+    if ((task_name && g_pattern_match_string (affinity->pattern, task_name)) ||
+        (factory_name &&
+            g_pattern_match_string (affinity->pattern, factory_name))) {
+      GST_DEBUG_OBJECT (pipeline, "restricting task %s to %u CPUs",
+          GST_STR_NULL (task_name), affinity->n_cpus);
+      gst_task_set_cpu_affinity (task, affinity->cpus, affinity->n_cpus);
+      break;
+    }
+  }
+
+  g_free (task_name);
+}
+
 /* intercept the bus messages from our children. We watch for the ASYNC_START
  * message with is posted by the elements (sinks) that require a reset of the
  * running_time after a flush. ASYNC_START also brings the pipeline back into
@@ -663,6 +746,43 @@ gst_pipeline_handle_message (GstBin * bin, GstMessage * message)
 
       break;
     }
+    case GST_MESSAGE_STREAM_STATUS:
+    {
+      GstStreamStatusType type;
+      const GValue *val;
+      GstTaskPool *pool;
+      GstElement *owner;
+      GstTask *task;
+
+      gst_message_parse_stream_status (message, &type, &owner);
+      if (type != GST_STREAM_STATUS_TYPE_CREATE)
+        break;
+
+      val = gst_message_get_stream_status_object (message);
+      if (val == NULL || !G_VALUE_HOLDS (val, GST_TYPE_TASK))
+        break;
+
+      /* this is called from the thread creating the task, before it is
+       * started, so we can still change its pool. An application sync
+       * handler on the bus runs after us and can override the choice. */
+      task = g_value_get_object (val);
+
+      GST_OBJECT_LOCK (pipeline);
+      pool = pipeline->priv->task_pool ?
+          gst_object_ref (pipeline->priv->task_pool) : NULL;
+      if (pipeline->priv->task_affinities)
+        gst_pipeline_apply_task_affinity (pipeline, task,
+            GST_MESSAGE_SRC (message), owner);
+      GST_OBJECT_UNLOCK (pipeline);
+
+      if (pool) {
+        GST_DEBUG_OBJECT (pipeline, "using pool %" GST_PTR_FORMAT
+            " for task %" GST_PTR_FORMAT, pool, task);
+        gst_task_set_pool (task, pool);
+        gst_object_unref (pool);
+      }
+      break;
+    }
     default:
       break;
   }
@@ -1168,3 +1288,132 @@ gst_pipeline_handle_instant_rate (GstPipeline * pipeline, gdouble rate,
 
   return gst_element_send_event (GST_ELEMENT_CAST (pipeline), event);
 }
+
+/**
+ * gst_pipeline_set_task_pool:
+ * @pipeline: a #GstPipeline
+ * @pool: (transfer none) (nullable): a #GstTaskPool, or %NULL
+ *
+ * Sets the #GstTaskPool that the streaming threads of all pads in @pipeline
+ * are run from. The pool is assigned to every #GstTask when its creation is
+ * announced with a %GST_STREAM_STATUS_TYPE_CREATE message, so it only
+ * affects tasks created after this call. @pool must already have been
+ * prepared with gst_task_pool_prepare().
+ *
+ * Sharing one prepared pool between several pipelines allows the threads of
+ * pipelines that are stopped to be reused by pipelines that are started,
+ * instead of every pipeline creating and destroying its own threads. The
+ * pool must be able to run as many tasks concurrently as there are
+ * streaming threads in all pipelines using it, as each #GstTask occupies
+ * one thread while it is started.
+ *
+ * Passing %NULL restores the default behaviour of using the default task
+ * pool.
+ *
+ * Since: 1.22
+ */
+void
+gst_pipeline_set_task_pool (GstPipeline * pipeline, GstTaskPool * pool)
+{
+  g_return_if_fail (GST_IS_PIPELINE (pipeline));
+  g_return_if_fail (pool == NULL || GST_IS_TASK_POOL (pool));
+
+  GST_OBJECT_LOCK (pipeline);
+  gst_object_replace ((GstObject **) & pipeline->priv->task_pool,
+      (GstObject *) pool);
+  GST_OBJECT_UNLOCK (pipeline);
+}
+
+/**
+ * gst_pipeline_get_task_pool:
+ * @pipeline: a #GstPipeline
+ *
+ * Gets the #GstTaskPool set with gst_pipeline_set_task_pool().
+ *
+ * Returns: (transfer full) (nullable): the #GstTaskPool of @pipeline, or
+ * %NULL if the default task pool is used. Unref after usage.
+ *
+ * Since: 1.22
+ */
+GstTaskPool *
+gst_pipeline_get_task_pool (GstPipeline * pipeline)
+{
+  GstTaskPool *pool = NULL;
+
+  g_return_val_if_fail (GST_IS_PIPELINE (pipeline), NULL);
+
+  GST_OBJECT_LOCK (pipeline);
+  if (pipeline->priv->task_pool)
+    pool = gst_object_ref (pipeline->priv->task_pool);
+  GST_OBJECT_UNLOCK (pipeline);
+
+  return pool;
+}
+
+/**
+ * gst_pipeline_add_task_affinity:
+ * @pipeline: a #GstPipeline
+ * @pattern: a glob-style pattern
+ * @cpus: (array length=n_cpus) (nullable): the CPU numbers the matching
+ *   streaming threads may run on
+ * @n_cpus: the number of elements in @cpus
+ *
+ * Restrict the streaming threads of @pipeline to the CPUs in @cpus. The
+ * policy applies to every task that is created in the pipeline after this
+ * call and whose name or whose owner element's factory name matches
+ * @pattern. The tasks of pads are named after their pad, so for example
+ * "demux*:video_*" matches the streaming threads of the video source pads of
+ * elements named "demux" followed by any suffix and "avdec_*" all streaming
+ * threads of libav decoders.
+ *
+ * When several policies match a task, the most recently added one is used.
+ * Passing %NULL or an empty array as @cpus makes matching tasks keep the
+ * affinity of the thread they run in. See gst_task_set_cpu_affinity().
+ *
+ * Since: 1.22
+ */
+void
+gst_pipeline_add_task_affinity (GstPipeline * pipeline, const gchar * pattern,
+    const guint * cpus, guint n_cpus)
+{
+  GstPipelineTaskAffinity *affinity;
+
+  g_return_if_fail (GST_IS_PIPELINE (pipeline));
+  g_return_if_fail (pattern != NULL);
+  g_return_if_fail (cpus != NULL || n_cpus == 0);
+
+  affinity = g_new0 (GstPipelineTaskAffinity, 1);
+  affinity->pattern = g_pattern_spec_new (pattern);
+  affinity->cpus = n_cpus ? g_memdup2 (cpus, n_cpus * sizeof (guint)) : NULL;
+  affinity->n_cpus = n_cpus;
+
+  GST_OBJECT_LOCK (pipeline);
+  pipeline->priv->task_affinities =
+      g_list_prepend (pipeline->priv->task_affinities, affinity);
+  GST_OBJECT_UNLOCK (pipeline);
+}
+
+/**
+ * gst_pipeline_clear_task_affinities:
+ * @pipeline: a #GstPipeline
+ *
+ * Remove all policies added with gst_pipeline_add_task_affinity(). Tasks that
+ * were already created keep their affinity.
+ *
+ * Since: 1.22
+ */
+void
+gst_pipeline_clear_task_affinities (GstPipeline * pipeline)
+{
+  GList *affinities;
+
+  g_return_if_fail (GST_IS_PIPELINE (pipeline));
+
+  GST_OBJECT_LOCK (pipeline);
+  affinities = pipeline->priv->task_affinities;
+  pipeline->priv->task_affinities = NULL;
+  GST_OBJECT_UNLOCK (pipeline);
+
+  g_list_free_full (affinities,
+      (GDestroyNotify) gst_pipeline_task_affinity_free);
+}
@@ -130,6 +130,20 @@ void            gst_pipeline_set_auto_flush_bus (GstPipeline *pipeline, gboolean
 GST_API
 gboolean        gst_pipeline_get_auto_flush_bus (GstPipeline *pipeline);
 
+GST_API
+void            gst_pipeline_set_task_pool      (GstPipeline *pipeline, GstTaskPool *pool);
+
+GST_API
+GstTaskPool*    gst_pipeline_get_task_pool      (GstPipeline *pipeline);
+
+GST_API
+void            gst_pipeline_add_task_affinity      (GstPipeline *pipeline,
+                                                     const gchar *pattern,
+                                                     const guint *cpus,
+                                                     guint n_cpus);
+GST_API
+void            gst_pipeline_clear_task_affinities  (GstPipeline *pipeline);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstPipeline, gst_object_unref)
 
 G_END_DECLS
@@ -113,7 +113,7 @@ static const gchar known_licenses[] = "LGPL\000"        /* GNU Lesser General Pu
     GST_LICENSE_UNKNOWN;        /* some other license */
 
 static GstPlugin *gst_plugin_register_func (GstPlugin * plugin,
-    const GstPluginDesc * desc, gpointer user_data);
+    const GstPluginDesc * desc, gpointer user_data, GstClockTime * init_time);
 static void gst_plugin_desc_copy (GstPluginDesc * dest,
     const GstPluginDesc * src);
 
@@ -155,6 +155,7 @@ gst_plugin_finalize (GObject * object)
   if (plugin->priv->cache_data) {
     gst_structure_free (plugin->priv->cache_data);
   }
+  g_free (plugin->priv->file_hash);
 
   G_OBJECT_CLASS (gst_plugin_parent_class)->finalize (object);
 }
@@ -212,6 +213,7 @@ gst_plugin_register_static (gint major_version, gint minor_version,
     init_func, version, license, source, package, origin, NULL,
   };
   GstPlugin *plugin;
+  GstClockTime init_time = GST_CLOCK_TIME_NONE;
   gboolean res = FALSE;
 
   g_return_val_if_fail (name != NULL, FALSE);
@@ -228,10 +230,12 @@ gst_plugin_register_static (gint major_version, gint minor_version,
 
   GST_LOG ("attempting to load static plugin \"%s\" now...", name);
   plugin = g_object_new (GST_TYPE_PLUGIN, NULL);
-  if (gst_plugin_register_func (plugin, &desc, NULL) != NULL) {
+  if (gst_plugin_register_func (plugin, &desc, NULL, &init_time) != NULL) {
     GST_INFO ("registered static plugin \"%s\"", name);
     res = gst_registry_add_plugin (gst_registry_get (), plugin);
     GST_INFO ("added static plugin \"%s\", result: %d", name, res);
+    if (res)
+      GST_TRACER_PLUGIN_LOADED (plugin, init_time, init_time);
   }
   return res;
 }
@@ -279,6 +283,7 @@ gst_plugin_register_static_full (gint major_version, gint minor_version,
     origin, NULL,
   };
   GstPlugin *plugin;
+  GstClockTime init_time = GST_CLOCK_TIME_NONE;
   gboolean res = FALSE;
 
   g_return_val_if_fail (name != NULL, FALSE);
@@ -295,10 +300,13 @@ gst_plugin_register_static_full (gint major_version, gint minor_version,
 
   GST_LOG ("attempting to load static plugin \"%s\" now...", name);
   plugin = g_object_new (GST_TYPE_PLUGIN, NULL);
-  if (gst_plugin_register_func (plugin, &desc, user_data) != NULL) {
+  if (gst_plugin_register_func (plugin, &desc, user_data,
+          &init_time) != NULL) {
     GST_INFO ("registered static plugin \"%s\"", name);
     res = gst_registry_add_plugin (gst_registry_get (), plugin);
     GST_INFO ("added static plugin \"%s\", result: %d", name, res);
+    if (res)
+      GST_TRACER_PLUGIN_LOADED (plugin, init_time, init_time);
   }
   return res;
 }
@@ -484,8 +492,10 @@ gst_plugin_check_version (gint major, gint minor)
 
 static GstPlugin *
 gst_plugin_register_func (GstPlugin * plugin, const GstPluginDesc * desc,
-    gpointer user_data)
+    gpointer user_data, GstClockTime * init_time)
 {
+  GstClockTime start;
+
   if (!gst_plugin_check_version (desc->major_version, desc->minor_version)) {
     if (GST_CAT_DEFAULT)
       GST_WARNING ("plugin \"%s\" has incompatible version "
@@ -521,6 +531,7 @@ gst_plugin_register_func (GstPlugin * plugin, const GstPluginDesc * desc,
   if (plugin->module)
     g_module_make_resident (plugin->module);
 
+  start = GST_TRACER_TIMESTAMP;
   if (user_data) {
     if (!(((GstPluginInitFullFunc) (desc->plugin_init)) (plugin, user_data))) {
       if (GST_CAT_DEFAULT)
@@ -537,6 +548,8 @@ gst_plugin_register_func (GstPlugin * plugin, const GstPluginDesc * desc,
     }
   }
 
+  *init_time = GST_TRACER_ELAPSED (start);
+
   if (GST_CAT_DEFAULT)
     GST_LOG ("plugin \"%s\" initialised", GST_STR_NULL (plugin->filename));
 
@@ -808,6 +821,7 @@ _priv_gst_plugin_load_file_for_registry (const gchar * filename,
   GStatBuf file_status;
   gboolean new_plugin = TRUE;
   GModuleFlags flags;
+  GstClockTime start, init_time = GST_CLOCK_TIME_NONE;
 
   g_return_val_if_fail (filename != NULL, NULL);
 
@@ -831,6 +845,8 @@ _priv_gst_plugin_load_file_for_registry (const gchar * filename,
   GST_CAT_DEBUG (GST_CAT_PLUGIN_LOADING, "attempt to load plugin \"%s\"",
       filename);
 
+  start = GST_TRACER_TIMESTAMP;
+
   if (!g_module_supported ()) {
     GST_CAT_DEBUG (GST_CAT_PLUGIN_LOADING, "module loading not supported");
     g_set_error (error,
@@ -928,6 +944,8 @@ _priv_gst_plugin_load_file_for_registry (const gchar * filename,
     plugin->file_size = file_status.st_size;
     plugin->filename = g_strdup (filename);
     plugin->basename = g_path_get_basename (filename);
+    if (_priv_gst_registry_content_hash_enabled ())
+      plugin->priv->file_hash = gst_plugin_compute_file_hash (filename);
   }
 
   plugin->module = module;
@@ -968,7 +986,7 @@ _priv_gst_plugin_load_file_for_registry (const gchar * filename,
   GST_LOG ("Plugin %p for file \"%s\" prepared, registering...",
       plugin, filename);
 
-  if (!gst_plugin_register_func (plugin, desc, NULL)) {
+  if (!gst_plugin_register_func (plugin, desc, NULL, &init_time)) {
     /* remove signal handler */
     _gst_plugin_fault_handler_restore ();
     GST_DEBUG ("gst_plugin_register_func failed for plugin \"%s\"", filename);
@@ -991,6 +1009,8 @@ _priv_gst_plugin_load_file_for_registry (const gchar * filename,
     gst_registry_add_plugin (registry, plugin);
   }
 
+  GST_TRACER_PLUGIN_LOADED (plugin, GST_TRACER_ELAPSED (start), init_time);
+
   g_mutex_unlock (&gst_plugin_loading_mutex);
   return plugin;
 
@@ -1847,6 +1867,51 @@ gst_plugin_ext_dep_get_stat_hash (GstPlugin * plugin, GstPluginDep * dep)
   return scan_hash;
 }
 
+gboolean
+_priv_gst_registry_content_hash_enabled (void)
+{
+  const gchar *env = g_getenv ("GST_REGISTRY_CONTENT_HASH");
+
+  return env != NULL && strcmp (env, "no") != 0;
+}
+
+static gchar *
+gst_plugin_compute_file_hash (const gchar * filename)
+{
+  GMappedFile *file;
+  gchar *hash;
+
+  file = g_mapped_file_new (filename, FALSE, NULL);
+  if (!file)
+    return NULL;
+
+  hash = g_compute_checksum_for_data (G_CHECKSUM_SHA256,
+      (const guchar *) g_mapped_file_get_contents (file),
+      g_mapped_file_get_length (file));
+  g_mapped_file_unref (file);
+
+  return hash;
+}
+
+gboolean
+_priv_gst_plugin_file_hash_matches (GstPlugin * plugin, const gchar * filename)
+{
+  gchar *hash;
+  gboolean ret;
+
+  if (!plugin->priv->file_hash)
+    return FALSE;
+
+  hash = gst_plugin_compute_file_hash (filename);
+  ret = hash && strcmp (hash, plugin->priv->file_hash) == 0;
+  g_free (hash);
+
+  GST_LOG_OBJECT (plugin, "content of %s %s", filename,
+      ret ? "unchanged" : "changed");
+
+  return ret;
+}
+
 gboolean
 _priv_plugin_deps_files_changed (GstPlugin * plugin)
 {
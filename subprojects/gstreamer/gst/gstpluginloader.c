@@ -82,6 +82,8 @@ typedef struct _PendingPluginEntry
   gchar *filename;
   off_t file_size;
   time_t file_mtime;
+  /* when the entry was queued, for tracers */
+  GstClockTime queued_ts;
 } PendingPluginEntry;
 
 struct _GstPluginLoader
@@ -111,6 +113,9 @@ struct _GstPluginLoader
   gboolean rx_done;
   gboolean rx_got_sync;
 
+  /* when the last plugin details were received, for tracers */
+  GstClockTime last_details_ts;
+
   /* Head and tail of the pending plugins list. List of
      PendingPluginEntry structs */
   GList *pending_plugins;
@@ -240,6 +245,7 @@ plugin_loader_load (GstPluginLoader * loader, const gchar * filename,
   entry->filename = g_strdup (filename);
   entry->file_size = file_size;
   entry->file_mtime = file_mtime;
+  entry->queued_ts = GST_TRACER_TIMESTAMP;
   loader->pending_plugins_tail =
       g_list_append (loader->pending_plugins_tail, entry);
 
@@ -990,7 +996,7 @@ handle_rx_packet (GstPluginLoader * l,
       if (payload_len > 0) {
         GstPlugin *newplugin = NULL;
         if (!_priv_gst_registry_chunks_load_plugin (l->registry, &tmp,
-                tmp + payload_len, &newplugin)) {
+                tmp + payload_len, FALSE, &newplugin)) {
           /* Got garbage from the child, so fail and trigger replay of plugins */
           GST_ERROR_OBJECT (l->registry,
               "Problems loading plugin details with tag %u from scanner", tag);
@@ -1003,12 +1009,25 @@ handle_rx_packet (GstPluginLoader * l,
             newplugin->filename);
         newplugin->registered = TRUE;
 
+        /* The child handles one plugin after the other, so the time since it
+         * was queued or since the previous reply is what it took to load */
+        if (entry != NULL && GST_CLOCK_TIME_IS_VALID (entry->queued_ts)) {
+          GstClockTime now = gst_util_get_timestamp ();
+
+          GST_TRACER_PLUGIN_LOADED (newplugin,
+              now - MAX (entry->queued_ts, l->last_details_ts),
+              GST_CLOCK_TIME_NONE);
+          l->last_details_ts = now;
+        }
+
         /* We got a set of plugin details - remember it for later */
         l->got_plugin_details = TRUE;
       } else if (entry != NULL) {
         /* Create a blacklist entry for this file to prevent scanning every time */
         plugin_loader_create_blacklist_plugin (l, entry);
         l->got_plugin_details = TRUE;
+        if (GST_CLOCK_TIME_IS_VALID (entry->queued_ts))
+          l->last_details_ts = gst_util_get_timestamp ();
       }
 
       if (entry != NULL) {
@@ -83,6 +83,9 @@
 #endif
 #include <sys/time.h>
 #include <sys/socket.h>
+#ifdef HAVE_EPOLL
+#include <sys/epoll.h>
+#endif
 #endif
 
 #ifdef G_OS_WIN32
@@ -124,6 +127,7 @@ typedef enum
   GST_POLL_MODE_PSELECT,
   GST_POLL_MODE_POLL,
   GST_POLL_MODE_PPOLL,
+  GST_POLL_MODE_EPOLL,
   GST_POLL_MODE_WINDOWS
 } GstPollMode;
 
@@ -142,6 +146,20 @@ struct _GstPoll
 #ifndef G_OS_WIN32
   GstPollFD control_read_fd;
   GstPollFD control_write_fd;
+#ifdef HAVE_EPOLL
+  /* epoll state, only used from the waiting thread with the lock */
+  gint epoll_fd;
+  gboolean epoll_failed;
+  gboolean epoll_dirty;
+  /* registered epoll events per fd number, 0 when not registered */
+  GArray *epoll_state;
+  /* index in active_fds per fd number, -1 when not in active_fds */
+  GArray *epoll_index;
+  /* indices in active_fds that got revents in the last wait */
+  GArray *epoll_ready;
+  struct epoll_event *epoll_events;
+  guint epoll_events_len;
+#endif
 #else
   GArray *active_fds_ignored;
   GArray *events;
@@ -434,12 +452,235 @@ pollable_timeout (GstClockTime timeout)
 }
 #endif
 
+#ifdef HAVE_EPOLL
+/* below this number of fds poll() is just as fast and doesn't need an
+ * epoll_ctl() call for every change to the set */
+#define EPOLL_MIN_FDS 64
+
+static gboolean
+gst_poll_use_epoll (GstPoll * set)
+{
+  gboolean res;
+
+  /* timers are waited on from multiple threads at once and only ever contain
+   * the control socket */
+  if (set->timer || set->epoll_failed)
+    return FALSE;
+
+  g_mutex_lock (&set->lock);
+  res = set->fds->len >= EPOLL_MIN_FDS;
+  g_mutex_unlock (&set->lock);
+
+  return res;
+}
+
+static guint32
+pollfd_events_to_epoll (gshort events)
+{
+  /* EPOLLERR is always reported, we add it so that a registered fd never
+   * has an empty mask */
+  guint32 res = EPOLLERR;
+
+  if (events & POLLIN)
+    res |= EPOLLIN;
+  if (events & POLLOUT)
+    res |= EPOLLOUT;
+  if (events & POLLPRI)
+    res |= EPOLLPRI;
+
+  return res;
+}
+
+static gshort
+epoll_events_to_pollfd (guint32 events)
+{
+  gshort res = 0;
+
+  if (events & EPOLLIN)
+    res |= POLLIN;
+  if (events & EPOLLOUT)
+    res |= POLLOUT;
+  if (events & EPOLLPRI)
+    res |= POLLPRI;
+  if (events & EPOLLERR)
+    res |= POLLERR;
+  if (events & EPOLLHUP)
+    res |= POLLHUP;
+
+  return res;
+}
+
+static gboolean
+gst_poll_epoll_ctl (GstPoll * set, gint op, gint fd, guint32 events)
+{
+  struct epoll_event ev;
+
+  memset (&ev, 0, sizeof (ev));
+  ev.events = events;
+  ev.data.fd = fd;
+
+  if (epoll_ctl (set->epoll_fd, op, fd, &ev) == 0)
+    return TRUE;
+
+  /* the fd was closed, which unregisters it, and the number got reused
+   * without removing it from the set first */
+  if (op == EPOLL_CTL_MOD && errno == ENOENT)
+    return epoll_ctl (set->epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
+
+  return FALSE;
+}
+
+/* with the lock. Unregisters @fd right away instead of on the next sync, as
+ * the fd might get closed and its number reused by a new fd that is added
+ * with the same events before then, which would then look registered
+ * already */
+static void
+gst_poll_epoll_remove (GstPoll * set, gint fd)
+{
+  guint32 *state;
+
+  if (fd >= set->epoll_state->len)
+    return;
+
+  state = &g_array_index (set->epoll_state, guint32, fd);
+  if (*state == 0)
+    return;
+
+  /* fails when the fd was closed already, which also unregistered it */
+  if (set->epoll_fd >= 0)
+    gst_poll_epoll_ctl (set, EPOLL_CTL_DEL, fd, 0);
+  *state = 0;
+}
+
+/* with the lock. Brings the epoll registrations in line with active_fds and
+ * rebuilds the fd to index map. On failure, for example for fds that epoll
+ * doesn't support such as regular files, epoll is disabled for @set and
+ * we fall back to poll() */
+static gboolean
+gst_poll_epoll_sync (GstPoll * set)
+{
+  guint i, size;
+  gint max_fd = -1;
+
+  if (set->epoll_fd < 0) {
+    set->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+    if (set->epoll_fd < 0)
+      goto error;
+  }
+
+  for (i = 0; i < set->active_fds->len; i++) {
+    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, i);
+
+    max_fd = MAX (max_fd, pfd->fd);
+  }
+
+  size = MAX (set->epoll_state->len, max_fd + 1);
+  g_array_set_size (set->epoll_state, size);
+  g_array_set_size (set->epoll_index, size);
+  for (i = 0; i < size; i++)
+    g_array_index (set->epoll_index, gint, i) = -1;
+
+  for (i = 0; i < set->active_fds->len; i++) {
+    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, i);
+    guint32 *state = &g_array_index (set->epoll_state, guint32, pfd->fd);
+    guint32 events = pollfd_events_to_epoll (pfd->events);
+
+    g_array_index (set->epoll_index, gint, pfd->fd) = i;
+
+    if (*state == events)
+      continue;
+
+    if (!gst_poll_epoll_ctl (set, *state ? EPOLL_CTL_MOD : EPOLL_CTL_ADD,
+            pfd->fd, events))
+      goto error;
+
+    *state = events;
+  }
+
+  /* unregister the fds that were removed from the set */
+  for (i = 0; i < size; i++) {
+    guint32 *state = &g_array_index (set->epoll_state, guint32, i);
+
+    if (*state == 0 || g_array_index (set->epoll_index, gint, i) >= 0)
+      continue;
+
+    /* fails when the fd was closed already, which also unregistered it */
+    gst_poll_epoll_ctl (set, EPOLL_CTL_DEL, i, 0);
+    *state = 0;
+  }
+
+  if (set->epoll_events_len < set->active_fds->len) {
+    set->epoll_events_len = set->active_fds->len;
+    set->epoll_events = g_renew (struct epoll_event, set->epoll_events,
+        set->epoll_events_len);
+  }
+
+  /* active_fds was just copied and has no revents */
+  g_array_set_size (set->epoll_ready, 0);
+  set->epoll_dirty = FALSE;
+
+  return TRUE;
+
+error:
+  {
+    GST_WARNING ("%p: disabling epoll: %s", set, g_strerror (errno));
+    if (set->epoll_fd >= 0)
+      close (set->epoll_fd);
+    set->epoll_fd = -1;
+    set->epoll_failed = TRUE;
+    g_array_set_size (set->epoll_state, 0);
+    return FALSE;
+  }
+}
+
+/* fills in the revents of active_fds like poll() would, only touching the
+ * entries that have activity */
+static gint
+gst_poll_epoll_wait (GstPoll * set, GstClockTime timeout)
+{
+  gint t, res, i;
+  guint j;
+
+  /* clear the results of the previous wait */
+  for (j = 0; j < set->epoll_ready->len; j++) {
+    guint idx = g_array_index (set->epoll_ready, guint, j);
+
+    g_array_index (set->active_fds, struct pollfd, idx).revents = 0;
+  }
+  g_array_set_size (set->epoll_ready, 0);
+
+  if (timeout != GST_CLOCK_TIME_NONE) {
+    /* round up, waking up too early makes callers spin */
+    t = (gint) MIN ((timeout + GST_MSECOND - 1) / GST_MSECOND, G_MAXINT);
+  } else {
+    t = -1;
+  }
+
+  res = epoll_wait (set->epoll_fd, set->epoll_events, set->epoll_events_len, t);
+
+  for (i = 0; i < res; i++) {
+    struct epoll_event *ev = &set->epoll_events[i];
+    guint idx = g_array_index (set->epoll_index, gint, ev->data.fd);
+
+    g_array_index (set->active_fds, struct pollfd, idx).revents =
+        epoll_events_to_pollfd (ev->events);
+    g_array_append_val (set->epoll_ready, idx);
+  }
+
+  return res;
+}
+#endif
+
 static GstPollMode
 choose_mode (GstPoll * set, GstClockTime timeout)
 {
   GstPollMode mode;
 
   if (set->mode == GST_POLL_MODE_AUTO) {
+#ifdef HAVE_EPOLL
+    if (gst_poll_use_epoll (set))
+      return GST_POLL_MODE_EPOLL;
+#endif
 #ifdef HAVE_PPOLL
     mode = GST_POLL_MODE_PPOLL;
 #elif defined(HAVE_POLL)
@@ -686,6 +927,13 @@ gst_poll_new (gboolean controllable)
   nset->active_fds = g_array_new (FALSE, FALSE, sizeof (struct pollfd));
   nset->control_read_fd.fd = -1;
   nset->control_write_fd.fd = -1;
+#ifdef HAVE_EPOLL
+  nset->epoll_fd = -1;
+  nset->epoll_dirty = TRUE;
+  nset->epoll_state = g_array_new (FALSE, TRUE, sizeof (guint32));
+  nset->epoll_index = g_array_new (FALSE, FALSE, sizeof (gint));
+  nset->epoll_ready = g_array_new (FALSE, FALSE, sizeof (guint));
+#endif
   {
     gint control_sock[2];
 
@@ -776,6 +1024,14 @@ gst_poll_free (GstPoll * set)
     close (set->control_write_fd.fd);
   if (set->control_read_fd.fd >= 0)
     close (set->control_read_fd.fd);
+#ifdef HAVE_EPOLL
+  if (set->epoll_fd >= 0)
+    close (set->epoll_fd);
+  g_array_free (set->epoll_state, TRUE);
+  g_array_free (set->epoll_index, TRUE);
+  g_array_free (set->epoll_ready, TRUE);
+  g_free (set->epoll_events);
+#endif
 #else
   CloseHandle (set->wakeup_event);
 
@@ -946,6 +1202,9 @@ gst_poll_remove_fd (GstPoll * set, GstPollFD * fd)
 
     /* mark fd as removed by setting the index to -1 */
     fd->idx = -1;
+#ifdef HAVE_EPOLL
+    gst_poll_epoll_remove (set, fd->fd);
+#endif
     MARK_REBUILD (set);
   } else {
     GST_WARNING ("%p: couldn't find fd !", set);
@@ -1440,6 +1699,9 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
       g_array_set_size (set->active_fds, set->fds->len);
       memcpy (set->active_fds->data, set->fds->data,
           set->fds->len * sizeof (struct pollfd));
+#ifdef HAVE_EPOLL
+      set->epoll_dirty = TRUE;
+#endif
 #else
       if (!gst_poll_prepare_winsock_active_sets (set))
         goto winsock_error;
@@ -1447,6 +1709,19 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
       g_mutex_unlock (&set->lock);
     }
 
+#ifdef HAVE_EPOLL
+    if (mode == GST_POLL_MODE_EPOLL && set->epoll_dirty) {
+      gboolean synced;
+
+      g_mutex_lock (&set->lock);
+      synced = gst_poll_epoll_sync (set);
+      g_mutex_unlock (&set->lock);
+
+      if (!synced)
+        mode = choose_mode (set, timeout);
+    }
+#endif
+
     switch (mode) {
       case GST_POLL_MODE_AUTO:
         g_assert_not_reached ();
@@ -1470,6 +1745,16 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
 #else
         g_assert_not_reached ();
         errno = ENOSYS;
+#endif
+        break;
+      }
+      case GST_POLL_MODE_EPOLL:
+      {
+#ifdef HAVE_EPOLL
+        res = gst_poll_epoll_wait (set, timeout);
+#else
+        g_assert_not_reached ();
+        errno = ENOSYS;
 #endif
         break;
       }
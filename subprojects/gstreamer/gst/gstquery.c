@@ -77,6 +77,9 @@ typedef struct
 
 #define GST_QUERY_STRUCTURE(q)  (((GstQueryImpl *)(q))->structure)
 
+static GstFreeList query_free_list =
+    GST_FREE_LIST_INIT (sizeof (GstQueryImpl));
+
 
 typedef struct
 {
@@ -200,7 +203,7 @@ _gst_query_free (GstQuery * query)
   memset (query, 0xff, sizeof (GstQueryImpl));
 #endif
 
-  g_slice_free1 (sizeof (GstQueryImpl), query);
+  _priv_gst_free_list_free (&query_free_list, query);
 }
 
 static GstQuery *
@@ -674,7 +677,7 @@ gst_query_new_custom (GstQueryType type, GstStructure * structure)
 {
   GstQueryImpl *query;
 
-  query = g_slice_new0 (GstQueryImpl);
+  query = _priv_gst_free_list_alloc0 (&query_free_list);
 
   GST_DEBUG ("creating new query %p %s", query, gst_query_type_get_name (type));
 
@@ -697,7 +700,7 @@ gst_query_new_custom (GstQueryType type, GstStructure * structure)
   /* ERRORS */
 had_parent:
   {
-    g_slice_free1 (sizeof (GstQueryImpl), query);
+    _priv_gst_free_list_free (&query_free_list, query);
     g_warning ("structure is already owned by another object");
     return NULL;
   }
@@ -166,6 +166,10 @@ struct _GstRegistryPrivate
   guint32 tfl_cookie;
   GList *device_provider_factory_list;
   guint32 dmfl_cookie;
+
+  /* contents of the binary registry caches that were loaded, features
+   * loaded from them reference strings inside */
+  GList *binary_caches;
 };
 
 /* the one instance of the default registry and the mutex protecting the
@@ -180,6 +184,8 @@ static GstRegistry *_gst_registry_default = NULL;
 static gboolean _gst_enable_registry_fork = DEFAULT_FORK;
 /* List of plugins that need preloading/reloading after scanning registry */
 extern GSList *_priv_gst_preload_plugins;
+/* Loads the plugins from GST_PLUGIN_PRELOAD in the background */
+static GThreadPool *_gst_preload_pool = NULL;
 
 #ifndef GST_DISABLE_REGISTRY
 /* Set to TRUE to disable registry, behaves similar to GST_DISABLE_REGISTRY */
@@ -319,6 +325,10 @@ gst_registry_finalize (GObject * object)
     gst_plugin_feature_list_free (registry->priv->device_provider_factory_list);
   }
 
+  g_list_free_full (registry->priv->binary_caches,
+      (GDestroyNotify) g_bytes_unref);
+  registry->priv->binary_caches = NULL;
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -1101,14 +1111,40 @@ typedef enum
   REGISTRY_SCAN_HELPER_RUNNING
 } GstRegistryScanHelperState;
 
+#define MAX_SCAN_HELPERS 16
+
 typedef struct
 {
   GstRegistry *registry;
   GstRegistryScanHelperState helper_state;
-  GstPluginLoader *helper;
+  /* plugin files are handed out to the helpers round-robin, so that they
+   * are loaded concurrently */
+  GstPluginLoader *helpers[MAX_SCAN_HELPERS];
+  guint n_helpers;
+  guint max_helpers;
+  guint next_helper;
+  /* basenames of the files handed to a helper, the plugins only appear in
+   * the registry once the helper sent back their details */
+  GHashTable *scanned_basenames;
+  gboolean content_hash;
   gboolean changed;
 } GstRegistryScanContext;
 
+static guint
+get_max_scan_helpers (void)
+{
+  const gchar *env;
+  guint n;
+
+  if ((env = g_getenv ("GST_REGISTRY_SCANNERS"))) {
+    n = (guint) g_ascii_strtoull (env, NULL, 10);
+    if (n > 0)
+      return MIN (n, MAX_SCAN_HELPERS);
+  }
+
+  return CLAMP (g_get_num_processors (), 1, 4);
+}
+
 static void
 init_scan_context (GstRegistryScanContext * context, GstRegistry * registry)
 {
@@ -1133,19 +1169,61 @@ init_scan_context (GstRegistryScanContext * context, GstRegistry * registry)
   else
     context->helper_state = REGISTRY_SCAN_HELPER_DISABLED;
 
-  context->helper = NULL;
+  context->n_helpers = 0;
+  context->max_helpers = get_max_scan_helpers ();
+  context->next_helper = 0;
+  context->scanned_basenames =
+      g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  context->content_hash = _priv_gst_registry_content_hash_enabled ();
   context->changed = FALSE;
 }
 
+static void
+clear_scan_helpers (GstRegistryScanContext * context)
+{
+  guint i;
+
+  /* waits for every helper to send back the details of its plugins */
+  for (i = 0; i < context->n_helpers; i++) {
+    context->changed |=
+        _priv_gst_plugin_loader_funcs.destroy (context->helpers[i]);
+    context->helpers[i] = NULL;
+  }
+  context->n_helpers = 0;
+  context->next_helper = 0;
+}
+
 static void
 clear_scan_context (GstRegistryScanContext * context)
 {
-  if (context->helper) {
-    context->changed |= _priv_gst_plugin_loader_funcs.destroy (context->helper);
-    context->helper = NULL;
+  clear_scan_helpers (context);
+
+  if (context->scanned_basenames) {
+    g_hash_table_destroy (context->scanned_basenames);
+    context->scanned_basenames = NULL;
   }
 }
 
+static GstPluginLoader *
+get_scan_helper (GstRegistryScanContext * context)
+{
+  if (context->next_helper >= context->n_helpers
+      && context->n_helpers < context->max_helpers) {
+    GstPluginLoader *helper;
+
+    helper = _priv_gst_plugin_loader_funcs.create (context->registry);
+    if (helper) {
+      GST_DEBUG ("Started plugin scanner %u", context->n_helpers);
+      context->helpers[context->n_helpers++] = helper;
+    }
+  }
+
+  if (context->next_helper >= context->n_helpers)
+    context->next_helper = 0;
+
+  return context->helpers[context->next_helper++];
+}
+
 static gboolean
 gst_registry_scan_plugin_file (GstRegistryScanContext * context,
     const gchar * filename, off_t file_size, time_t file_mtime)
@@ -1162,10 +1240,12 @@ gst_registry_scan_plugin_file (GstRegistryScanContext * context,
   /* Have a plugin to load - see if the scan-helper needs starting */
   if (context->helper_state == REGISTRY_SCAN_HELPER_NOT_STARTED) {
     GST_DEBUG ("Starting plugin scanner for file %s", filename);
-    context->helper = _priv_gst_plugin_loader_funcs.create (context->registry);
-    if (context->helper != NULL)
+    context->helpers[0] =
+        _priv_gst_plugin_loader_funcs.create (context->registry);
+    if (context->helpers[0] != NULL) {
+      context->n_helpers = 1;
       context->helper_state = REGISTRY_SCAN_HELPER_RUNNING;
-    else {
+    } else {
       GST_WARNING ("Failed starting plugin scanner. Scanning in-process");
       context->helper_state = REGISTRY_SCAN_HELPER_DISABLED;
     }
@@ -1173,7 +1253,7 @@ gst_registry_scan_plugin_file (GstRegistryScanContext * context,
 
   if (context->helper_state == REGISTRY_SCAN_HELPER_RUNNING) {
     GST_DEBUG ("Using scan-helper to load plugin %s", filename);
-    if (!_priv_gst_plugin_loader_funcs.load (context->helper,
+    if (!_priv_gst_plugin_loader_funcs.load (get_scan_helper (context),
             filename, file_size, file_mtime)) {
       g_warning ("External plugin loader failed. This most likely means that "
           "the plugin loader helper binary was not found or could not be run. "
@@ -1204,7 +1284,7 @@ gst_registry_scan_plugin_file (GstRegistryScanContext * context,
   }
 #ifndef GST_DISABLE_REGISTRY
   if (!__registry_reuse_plugin_scanner) {
-    clear_scan_context (context);
+    clear_scan_helpers (context);
     context->helper_state = REGISTRY_SCAN_HELPER_NOT_STARTED;
   }
 #endif
@@ -1343,6 +1423,13 @@ gst_registry_scan_path_level (GstRegistryScanContext * context,
 
     /* plug-ins are considered unique by basename; if the given name
      * was already seen by the registry, we ignore it */
+    if (g_hash_table_contains (context->scanned_basenames, dirent)) {
+      GST_DEBUG_OBJECT (context->registry,
+          "plugin %s already being scanned from another path", dirent);
+      g_free (filename);
+      continue;
+    }
+
     plugin = gst_registry_lookup_bn (context->registry, dirent);
     if (plugin) {
       gboolean env_vars_changed, deps_changed = FALSE;
@@ -1371,6 +1458,19 @@ gst_registry_scan_path_level (GstRegistryScanContext * context,
         GST_LOG_OBJECT (context->registry,
             "marking plugin %p as registered as %s", plugin, filename);
         plugin->registered = TRUE;
+      } else if (context->content_hash && !env_vars_changed
+          && plugin->file_size == file_status.st_size
+          && !strcmp (plugin->filename, filename)
+          && !(deps_changed = _priv_plugin_deps_files_changed (plugin))
+          && _priv_gst_plugin_file_hash_matches (plugin, filename)) {
+        /* e.g. a registry cache shipped with the plugins, only the mtime
+         * differs. Store the new mtime so the next check is cheap again */
+        GST_LOG_OBJECT (context->registry, "file %s cached, content unchanged",
+            filename);
+        GST_OBJECT_FLAG_UNSET (plugin, GST_PLUGIN_FLAG_CACHED);
+        plugin->file_mtime = file_status.st_mtime;
+        plugin->registered = TRUE;
+        changed = TRUE;
       } else {
         GST_INFO_OBJECT (context->registry, "cached info for %s is stale",
             filename);
@@ -1382,6 +1482,7 @@ gst_registry_scan_path_level (GstRegistryScanContext * context,
             (gint64) plugin->file_size, (gint64) file_status.st_size,
             env_vars_changed, deps_changed, plugin->filename, filename);
         gst_registry_remove_plugin (context->registry, plugin);
+        g_hash_table_add (context->scanned_basenames, g_strdup (dirent));
         changed |= gst_registry_scan_plugin_file (context, filename,
             file_status.st_size, file_status.st_mtime);
       }
@@ -1390,6 +1491,7 @@ gst_registry_scan_path_level (GstRegistryScanContext * context,
     } else {
       GST_DEBUG_OBJECT (context->registry, "file %s not yet in registry",
           filename);
+      g_hash_table_add (context->scanned_basenames, g_strdup (dirent));
       changed |= gst_registry_scan_plugin_file (context, filename,
           file_status.st_size, file_status.st_mtime);
     }
@@ -1491,12 +1593,30 @@ _priv_plugin_get_features (GstRegistry * registry, GstPlugin * plugin)
   return res;
 }
 
+/* Keep the contents of a binary registry cache alive for as long as the
+ * registry, so that features loaded from it can point into it instead of
+ * copying strings. Takes ownership of @cache. */
+void
+_priv_gst_registry_add_binary_cache (GstRegistry * registry, GBytes * cache)
+{
+  GST_OBJECT_LOCK (registry);
+  registry->priv->binary_caches =
+      g_list_prepend (registry->priv->binary_caches, cache);
+  GST_OBJECT_UNLOCK (registry);
+}
+
 /* Unref and delete the default registry */
 void
 _priv_gst_registry_cleanup (void)
 {
   GstRegistry *registry;
 
+  /* let the background preloading finish before the registry goes away */
+  if (_gst_preload_pool) {
+    g_thread_pool_free (_gst_preload_pool, FALSE, TRUE);
+    _gst_preload_pool = NULL;
+  }
+
   g_mutex_lock (&_gst_registry_mutex);
   if ((registry = _gst_registry_default) != NULL) {
     _gst_registry_default = NULL;
@@ -1574,6 +1694,56 @@ load_plugin_func (gpointer data, gpointer user_data)
   }
 }
 
+static void
+preload_plugin_by_name_func (gpointer data, gpointer user_data)
+{
+  gchar *name = data;
+  GstPlugin *plugin;
+
+  GST_DEBUG ("Pre-loading plugin %s in the background", name);
+
+  plugin = gst_plugin_load_by_name (name);
+
+  if (plugin) {
+    GST_INFO ("Loaded plugin: \"%s\"", name);
+    gst_object_unref (plugin);
+  } else {
+    GST_WARNING ("Failed to pre-load plugin: \"%s\"", name);
+  }
+  g_free (name);
+}
+
+/* Pushes the comma separated plugin names from GST_PLUGIN_PRELOAD to a thread
+ * pool so that gst_init() doesn't have to wait for them. The module loading
+ * itself is serialized by the plugin loading lock, so this mostly overlaps
+ * the loading with the application's own startup. */
+void
+_priv_gst_registry_preload_plugins_async (void)
+{
+  const gchar *env;
+  gchar **names;
+  guint i, n;
+
+  env = g_getenv ("GST_PLUGIN_PRELOAD");
+  if (env == NULL || *env == '\0' || _gst_preload_pool != NULL)
+    return;
+
+  names = g_strsplit (env, ",", -1);
+  n = g_strv_length (names);
+
+  GST_DEBUG ("Pre-loading %u plugins in the background", n);
+  _gst_preload_pool = g_thread_pool_new (preload_plugin_by_name_func, NULL,
+      MIN (n, g_get_num_processors ()), FALSE, NULL);
+
+  for (i = 0; i < n; i++) {
+    gchar *name = g_strstrip (names[i]);
+
+    if (*name != '\0')
+      g_thread_pool_push (_gst_preload_pool, g_strdup (name), NULL);
+  }
+  g_strfreev (names);
+}
+
 char *
 priv_gst_get_relocated_libgstreamer (void)
 {
@@ -1817,6 +1987,10 @@ ensure_current_registry (GError ** error)
   gboolean ret = TRUE;
   gboolean do_update = TRUE;
   gboolean have_cache = TRUE;
+  GstRegistryScanAndUpdateResult result =
+      REGISTRY_SCAN_AND_UPDATE_SUCCESS_NOT_CHANGED;
+  GstClockTime start, read_time = GST_CLOCK_TIME_NONE;
+  GstClockTime scan_time = GST_CLOCK_TIME_NONE;
 
   default_registry = gst_registry_get ();
 
@@ -1830,8 +2004,10 @@ ensure_current_registry (GError ** error)
 
   if (!_gst_disable_registry_cache) {
     GST_INFO ("reading registry cache: %s", registry_file);
+    start = GST_TRACER_TIMESTAMP;
     have_cache = priv_gst_registry_binary_read_cache (default_registry,
         registry_file);
+    read_time = GST_TRACER_ELAPSED (start);
     /* Only ever read the registry cache once, then disable it for
      * subsequent updates during the program lifetime */
     _gst_disable_registry_cache = TRUE;
@@ -1858,11 +2034,17 @@ ensure_current_registry (GError ** error)
     }
     /* now check registry */
     GST_DEBUG ("Updating registry cache");
-    scan_and_update_registry (default_registry, registry_file, TRUE, error);
+    start = GST_TRACER_TIMESTAMP;
+    result = scan_and_update_registry (default_registry, registry_file, TRUE,
+        error);
+    scan_time = GST_TRACER_ELAPSED (start);
   } else {
     GST_DEBUG ("Not updating registry cache (disabled)");
   }
 
+  GST_TRACER_REGISTRY_UPDATED (default_registry, read_time, scan_time,
+      result == REGISTRY_SCAN_AND_UPDATE_SUCCESS_UPDATED);
+
   g_free (registry_file);
   GST_INFO ("registry reading and updating done, result = %d", ret);
 
@@ -579,6 +579,7 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
   gsize size;
   GError *err = NULL;
   gboolean res = FALSE;
+  gboolean have_plugins = FALSE;
   guint32 filter_env_hash = 0;
   gint check_magic_result;
 #ifndef GST_DISABLE_GST_DEBUG
@@ -596,12 +597,17 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
   timer = g_timer_new ();
 #endif
 
+  /* The loaded features keep pointing into the cache contents. On Windows a
+   * mapped file can't be replaced, which would prevent updating the
+   * registry, so read it into memory there */
+#ifndef G_OS_WIN32
   mapped = g_mapped_file_new (location, FALSE, &err);
   if (G_UNLIKELY (err != NULL)) {
     GST_INFO ("Unable to mmap file %s : %s", location, err->message);
     g_error_free (err);
     err = NULL;
   }
+#endif
 
   if (mapped == NULL) {
     /* Error mmap-ing the cache, try a plain memory read */
@@ -666,7 +672,9 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
       GST_DEBUG ("reading binary registry %" G_GSIZE_FORMAT "(%x)/%"
           G_GSIZE_FORMAT, (gsize) in - (gsize) contents,
           (guint) ((gsize) in - (gsize) contents), size);
-      if (!_priv_gst_registry_chunks_load_plugin (registry, &in, end, NULL)) {
+      have_plugins = TRUE;
+      if (!_priv_gst_registry_chunks_load_plugin (registry, &in, end, TRUE,
+              NULL)) {
         GST_ERROR ("Problem while reading binary registry %s", location);
         goto Error;
       }
@@ -683,12 +691,27 @@ done:
   GST_INFO ("loaded %s in %lf seconds", location, seconds);
 
   res = TRUE;
-  /* TODO: once we re-use the pointers to registry contents, return here */
 
 Error:
 #ifndef GST_DISABLE_GST_DEBUG
   g_timer_destroy (timer);
 #endif
+  /* Strings, pad template caps and metadata of the loaded features point
+   * into the cache contents and are only parsed on first use, so keep them
+   * around for as long as the registry. Mapped pages are shared read-only
+   * between all processes using the same registry. */
+  if (have_plugins) {
+    GBytes *cache;
+
+    if (mapped) {
+      cache = g_mapped_file_get_bytes (mapped);
+    } else {
+      cache = g_bytes_new_take (contents, size);
+      contents = NULL;
+    }
+    _priv_gst_registry_add_binary_cache (registry, cache);
+  }
+
   if (mapped) {
     g_mapped_file_unref (mapped);
   } else {
@@ -300,9 +300,13 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
       }
     }
 
-    /* pack element metadata strings */
-    gst_registry_chunks_save_string (list,
-        gst_structure_to_string (factory->metadata));
+    /* pack element metadata strings, reusing the cached string if the
+     * metadata was never needed */
+    if (factory->metadata)
+      gst_registry_chunks_save_string (list,
+          gst_structure_to_string (factory->metadata));
+    else
+      gst_registry_chunks_save_const_string (list, factory->metadata_string);
   } else if (GST_IS_TYPE_FIND_FACTORY (feature)) {
     GstRegistryChunkTypeFindFactory *tff;
     GstTypeFindFactory *factory = GST_TYPE_FIND_FACTORY (feature);
@@ -335,6 +339,9 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
       gst_caps_unref (fcaps);
 
       gst_registry_chunks_save_string (list, str);
+    } else if (factory->caps_string) {
+      /* still the simplified caps loaded from the cache */
+      gst_registry_chunks_save_const_string (list, factory->caps_string);
     } else {
       gst_registry_chunks_save_const_string (list, "");
     }
@@ -353,8 +360,11 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
 
 
     /* pack element metadata strings */
-    gst_registry_chunks_save_string (list,
-        gst_structure_to_string (factory->metadata));
+    if (factory->metadata)
+      gst_registry_chunks_save_string (list,
+          gst_structure_to_string (factory->metadata));
+    else
+      gst_registry_chunks_save_const_string (list, factory->metadata_string);
   } else if (GST_IS_TRACER_FACTORY (feature)) {
     /* Initialize with zeroes because of struct padding and
      * valgrind complaining about copying uninitialized memory
@@ -473,6 +483,10 @@ _priv_gst_registry_chunks_save_plugin (GList ** list, GstRegistry * registry,
 
   gst_plugin_feature_list_free (plugin_features);
 
+  /* pack file hash */
+  gst_registry_chunks_save_const_string (list,
+      plugin->priv->file_hash ? plugin->priv->file_hash : "");
+
   /* pack cache data */
   if (plugin->priv->cache_data) {
     gchar *cache_str = gst_structure_to_string (plugin->priv->cache_data);
@@ -517,7 +531,7 @@ fail:
  */
 static gboolean
 gst_registry_chunks_load_pad_template (GstElementFactory * factory, gchar ** in,
-    gchar * end)
+    gchar * end, gboolean persistent)
 {
   GstRegistryChunkPadTemplate *pt;
   GstStaticPadTemplate *template = NULL;
@@ -532,9 +546,14 @@ gst_registry_chunks_load_pad_template (GstElementFactory * factory, gchar ** in,
   template->direction = (GstPadDirection) pt->direction;
   template->static_caps.caps = NULL;
 
-  /* unpack pad template strings */
-  unpack_const_string (*in, template->name_template, end, fail);
-  unpack_const_string (*in, template->static_caps.string, end, fail);
+  /* unpack pad template strings, the caps are only parsed when needed */
+  if (persistent) {
+    unpack_string_nocopy (*in, template->name_template, end, fail);
+    unpack_string_nocopy (*in, template->static_caps.string, end, fail);
+  } else {
+    unpack_const_string (*in, template->name_template, end, fail);
+    unpack_const_string (*in, template->static_caps.string, end, fail);
+  }
 
   __gst_element_factory_add_static_pad_template (factory, template);
   GST_DEBUG ("Added pad_template %s", template->name_template);
@@ -556,7 +575,7 @@ fail:
  */
 static gboolean
 gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin * plugin)
+    gchar * end, gboolean persistent, GstPlugin * plugin)
 {
   GstRegistryChunkPluginFeature *pf = NULL;
   GstPluginFeature *feature = NULL;
@@ -615,12 +634,16 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     /* unpack element factory strings */
     unpack_string_nocopy (*in, meta_data_str, end, fail);
     if (meta_data_str && *meta_data_str) {
-      factory->metadata = gst_structure_from_string (meta_data_str, NULL);
-      if (!factory->metadata) {
-        GST_ERROR
-            ("Error when trying to deserialize structure for metadata '%s'",
-            meta_data_str);
-        goto fail;
+      if (persistent) {
+        factory->metadata_string = meta_data_str;
+      } else {
+        factory->metadata = gst_structure_from_string (meta_data_str, NULL);
+        if (!factory->metadata) {
+          GST_ERROR
+              ("Error when trying to deserialize structure for metadata '%s'",
+              meta_data_str);
+          goto fail;
+        }
       }
     }
     n = ef->npadtemplates;
@@ -629,7 +652,7 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     /* load pad templates */
     for (i = 0; i < n; i++) {
       if (G_UNLIKELY (!gst_registry_chunks_load_pad_template (factory, in,
-                  end))) {
+                  end, persistent))) {
         GST_ERROR ("Error while loading binary pad template");
         goto fail;
       }
@@ -671,10 +694,13 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
 
     /* load typefinder caps */
     unpack_string_nocopy (*in, const_str, end, fail);
-    if (const_str != NULL && *const_str != '\0')
-      factory->caps = gst_caps_from_string (const_str);
-    else
-      factory->caps = NULL;
+    factory->caps = NULL;
+    if (const_str != NULL && *const_str != '\0') {
+      if (persistent)
+        factory->caps_string = const_str;
+      else
+        factory->caps = gst_caps_from_string (const_str);
+    }
 
     /* load extensions */
     if (tff->nextensions) {
@@ -704,12 +730,16 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     /* unpack element factory strings */
     unpack_string_nocopy (*in, meta_data_str, end, fail);
     if (meta_data_str && *meta_data_str) {
-      factory->metadata = gst_structure_from_string (meta_data_str, NULL);
-      if (!factory->metadata) {
-        GST_ERROR
-            ("Error when trying to deserialize structure for metadata '%s'",
-            meta_data_str);
-        goto fail;
+      if (persistent) {
+        factory->metadata_string = meta_data_str;
+      } else {
+        factory->metadata = gst_structure_from_string (meta_data_str, NULL);
+        if (!factory->metadata) {
+          GST_ERROR
+              ("Error when trying to deserialize structure for metadata '%s'",
+              meta_data_str);
+          goto fail;
+        }
       }
     }
   } else if (GST_IS_TRACER_FACTORY (feature)) {
@@ -820,10 +850,13 @@ fail:
  * Make a new GstPlugin from current GstRegistryChunkPluginElement structure
  * and add it to the GstRegistry. Return an offset to the next
  * GstRegistryChunkPluginElement structure.
+ *
+ * If @persistent is %TRUE the data at @in stays valid for the lifetime of
+ * @registry and feature strings point into it instead of being copied.
  */
 gboolean
 _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin ** out_plugin)
+    gchar * end, gboolean persistent, GstPlugin ** out_plugin)
 {
 #ifndef GST_DISABLE_GST_DEBUG
   gchar *start = *in;
@@ -874,6 +907,11 @@ _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
   if (cache_str != NULL && *cache_str != '\0')
     plugin->priv->cache_data = gst_structure_from_string (cache_str, NULL);
 
+  /* unpack file hash */
+  unpack_string (*in, plugin->priv->file_hash, end, fail);
+  if (plugin->priv->file_hash[0] == '\0')
+    g_clear_pointer (&plugin->priv->file_hash, g_free);
+
   /* If the license string is 'BLACKLIST', mark this as a blacklisted
    * plugin */
   if (strcmp (plugin->desc.license, "BLACKLIST") == 0)
@@ -890,7 +928,7 @@ _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
   /* Load plugin features */
   for (i = 0; i < n; i++) {
     if (G_UNLIKELY (!gst_registry_chunks_load_feature (registry, in, end,
-                plugin))) {
+                persistent, plugin))) {
       GST_ERROR ("Error while loading binary feature for plugin '%s'",
           GST_STR_NULL (plugin->desc.name));
       gst_registry_remove_plugin (registry, plugin);
@@ -157,6 +157,38 @@ struct _GstStructureField
   GValue value;
 };
 
+/* Well-known structures are nearly always created with the same fields in
+ * the same order. A shape maps the quarks of these fields to the slot they
+ * are expected at, so looking them up is a single comparison instead of a
+ * scan over all fields. The slot is only a hint, structures that were built
+ * differently fall back to the scan. */
+#define SHAPE_MAX_FIELDS 16
+#define SHAPE_TABLE_SIZE 32     /* power of two, > 1.5 * SHAPE_MAX_FIELDS */
+
+typedef struct
+{
+  GQuark name;
+  GQuark quarks[SHAPE_TABLE_SIZE];
+  guint8 slots[SHAPE_TABLE_SIZE];
+} GstStructureShape;
+
+#define SHAPE_HASH(q) ((((guint32) (q)) * 2654435761u) >> 27)
+
+static const gchar *const shape_descs[][SHAPE_MAX_FIELDS + 1] = {
+  {"video/x-raw", "format", "width", "height", "interlace-mode",
+      "pixel-aspect-ratio", "framerate", "colorimetry", "chroma-site", NULL},
+  {"audio/x-raw", "format", "layout", "rate", "channels", "channel-mask",
+      NULL},
+  {"GstEventQOS", "type", "proportion", "diff", "timestamp", NULL},
+  {"GstEventSeek", "rate", "format", "flags", "cur-type", "cur", "stop-type",
+      "stop", "trickmode-interval", NULL},
+  {"GstQueryPosition", "format", "current", NULL},
+  {"GstQueryDuration", "format", "duration", NULL},
+  {"GstQueryLatency", "live", "min-latency", "max-latency", NULL},
+};
+
+static GstStructureShape shapes[G_N_ELEMENTS (shape_descs)];
+
 typedef struct
 {
   GstStructure s;
@@ -166,6 +198,10 @@ typedef struct
 
   guint fields_len;             /* Number of valid items in fields */
   guint fields_alloc;           /* Allocated items in fields */
+  guint arr_alloc;              /* Allocated items in arr */
+
+  /* Expected field layout of well-known structures, or NULL */
+  const GstStructureShape *shape;
 
   /* Fields are allocated if GST_STRUCTURE_IS_USING_DYNAMIC_ARRAY(),
    *  else it's a pointer to the arr field. */
@@ -183,6 +219,15 @@ typedef struct
 #define GST_STRUCTURE_FIELD(structure, index) \
   (&((GstStructureImpl*)(structure))->fields[(index)])
 
+/* Structures with the default number of preallocated fields are recycled
+ * through a per-thread free list, as most structures are small and short
+ * lived (queries, events, messages) */
+#define STRUCTURE_DEFAULT_ALLOC 8
+
+static GstFreeList structure_free_list =
+    GST_FREE_LIST_INIT (sizeof (GstStructureImpl) +
+    (STRUCTURE_DEFAULT_ALLOC - 1) * sizeof (GstStructureField));
+
 #define IS_MUTABLE(structure) \
     (!GST_STRUCTURE_REFCOUNT(structure) || \
      g_atomic_int_get (GST_STRUCTURE_REFCOUNT(structure)) == 1)
@@ -255,11 +300,64 @@ GType _gst_structure_type = 0;
 G_DEFINE_BOXED_TYPE (GstStructure, gst_structure,
     gst_structure_copy_conditional, gst_structure_free);
 
+static void
+gst_structure_shapes_init (void)
+{
+  guint i, j;
+
+  for (i = 0; i < G_N_ELEMENTS (shape_descs); i++) {
+    GstStructureShape *shape = &shapes[i];
+
+    shape->name = g_quark_from_static_string (shape_descs[i][0]);
+
+    for (j = 0; shape_descs[i][j + 1] != NULL; j++) {
+      GQuark quark = g_quark_from_static_string (shape_descs[i][j + 1]);
+      guint h = SHAPE_HASH (quark);
+
+      while (shape->quarks[h] != 0)
+        h = (h + 1) & (SHAPE_TABLE_SIZE - 1);
+
+      shape->quarks[h] = quark;
+      shape->slots[h] = j;
+    }
+  }
+}
+
+static inline const GstStructureShape *
+gst_structure_shape_for_name (GQuark name)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (shapes); i++) {
+    if (shapes[i].name == name)
+      return &shapes[i];
+  }
+
+  return NULL;
+}
+
+/* Returns the expected slot of @field in structures of @shape, or -1 */
+static inline gint
+gst_structure_shape_lookup (const GstStructureShape * shape, GQuark field)
+{
+  guint h = SHAPE_HASH (field);
+
+  while (shape->quarks[h] != 0) {
+    if (shape->quarks[h] == field)
+      return shape->slots[h];
+    h = (h + 1) & (SHAPE_TABLE_SIZE - 1);
+  }
+
+  return -1;
+}
+
 void
 _priv_gst_structure_initialize (void)
 {
   _gst_structure_type = gst_structure_get_type ();
 
+  gst_structure_shapes_init ();
+
   g_value_register_transform_func (_gst_structure_type, G_TYPE_STRING,
       gst_structure_transform_to_string);
 
@@ -277,16 +375,21 @@ gst_structure_new_id_empty_with_size (GQuark quark, guint prealloc)
     prealloc = 1;
 
   n_alloc = GST_ROUND_UP_8 (prealloc);
-  structure =
-      g_malloc0 (sizeof (GstStructureImpl) + (n_alloc -
-          1) * sizeof (GstStructureField));
+  if (n_alloc == STRUCTURE_DEFAULT_ALLOC)
+    structure = _priv_gst_free_list_alloc0 (&structure_free_list);
+  else
+    structure =
+        g_malloc0 (sizeof (GstStructureImpl) + (n_alloc -
+            1) * sizeof (GstStructureField));
 
   ((GstStructure *) structure)->type = _gst_structure_type;
   ((GstStructure *) structure)->name = quark;
   GST_STRUCTURE_REFCOUNT (structure) = NULL;
+  structure->shape = gst_structure_shape_for_name (quark);
 
   structure->fields_len = 0;
   structure->fields_alloc = n_alloc;
+  structure->arr_alloc = n_alloc;
   structure->fields = &structure->arr[0];
 
   GST_TRACE ("created structure %p", structure);
@@ -546,7 +649,10 @@ gst_structure_free (GstStructure * structure)
 #endif
   GST_TRACE ("free structure %p", structure);
 
-  g_free (structure);
+  if (((GstStructureImpl *) structure)->arr_alloc == STRUCTURE_DEFAULT_ALLOC)
+    _priv_gst_free_list_free (&structure_free_list, structure);
+  else
+    g_free (structure);
 }
 
 /**
@@ -688,6 +794,8 @@ gst_structure_set_name (GstStructure * structure, const gchar * name)
   g_return_if_fail (gst_structure_validate_name (name));
 
   structure->name = g_quark_from_string (name);
+  ((GstStructureImpl *) structure)->shape =
+      gst_structure_shape_for_name (structure->name);
 }
 
 static inline void
@@ -1010,9 +1118,6 @@ gst_structure_set_field (GstStructure * structure, GstStructureField * field)
 {
   GstStructureField *f;
   GType field_value_type;
-  guint i, len;
-
-  len = GST_STRUCTURE_LEN (structure);
 
   field_value_type = G_VALUE_TYPE (&field->value);
   if (field_value_type == G_TYPE_STRING) {
@@ -1063,14 +1168,11 @@ gst_structure_set_field (GstStructure * structure, GstStructureField * field)
     }
   }
 
-  for (i = 0; i < len; i++) {
-    f = GST_STRUCTURE_FIELD (structure, i);
-
-    if (G_UNLIKELY (f->name == field->name)) {
-      g_value_unset (&f->value);
-      memcpy (f, field, sizeof (GstStructureField));
-      return;
-    }
+  f = gst_structure_id_get_field (structure, field->name);
+  if (f) {
+    g_value_unset (&f->value);
+    memcpy (f, field, sizeof (GstStructureField));
+    return;
   }
 
   _structure_append_val (structure, field);
@@ -1081,11 +1183,22 @@ gst_structure_set_field (GstStructure * structure, GstStructureField * field)
 static GstStructureField *
 gst_structure_id_get_field (const GstStructure * structure, GQuark field_id)
 {
+  const GstStructureShape *shape = ((GstStructureImpl *) structure)->shape;
   GstStructureField *field;
   guint i, len;
 
   len = GST_STRUCTURE_LEN (structure);
 
+  if (shape) {
+    gint slot = gst_structure_shape_lookup (shape, field_id);
+
+    if (slot >= 0 && (guint) slot < len) {
+      field = GST_STRUCTURE_FIELD (structure, slot);
+      if (G_LIKELY (field->name == field_id))
+        return field;
+    }
+  }
+
   for (i = 0; i < len; i++) {
     field = GST_STRUCTURE_FIELD (structure, i);
 
@@ -349,6 +349,7 @@ struct _GstSystemClockPrivate
   GCond entries_changed;
 
   GstClockType clock_type;
+  GstClockTime wait_slack;
 
 #ifdef G_OS_WIN32
   LARGE_INTEGER frequency;
@@ -368,10 +369,13 @@ struct _GstSystemClockPrivate
 #define DEFAULT_CLOCK_TYPE GST_CLOCK_TYPE_MONOTONIC
 #endif
 
+#define DEFAULT_WAIT_SLACK 0
+
 enum
 {
   PROP_0,
   PROP_CLOCK_TYPE,
+  PROP_WAIT_SLACK,
   /* FILL ME */
 };
 
@@ -395,7 +399,7 @@ static GstClockReturn gst_system_clock_id_wait_jitter (GstClock * clock,
     GstClockEntry * entry, GstClockTimeDiff * jitter);
 static GstClockReturn gst_system_clock_id_wait_jitter_unlocked
     (GstClock * clock, GstClockEntry * entry, GstClockTimeDiff * jitter,
-    gboolean restart);
+    gboolean restart, GstClockTime slack);
 static GstClockReturn gst_system_clock_id_wait_async (GstClock * clock,
     GstClockEntry * entry);
 static void gst_system_clock_id_unschedule (GstClock * clock,
@@ -429,6 +433,24 @@ gst_system_clock_class_init (GstSystemClockClass * klass)
           GST_TYPE_CLOCK_TYPE, DEFAULT_CLOCK_TYPE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstSystemClock:wait-slack:
+   *
+   * Maximum amount of time in nanoseconds a wait may end late so that it can
+   * wake up together with other waits. Deadlines are rounded up to a
+   * multiple of this value, which turns many sinks syncing on the same clock
+   * into a few wakeups instead of one per sink. 0 waits as precisely as
+   * possible.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_WAIT_SLACK,
+      g_param_spec_uint64 ("wait-slack", "Wait slack",
+          "Maximum time in nanoseconds a wait may end late to coalesce "
+          "wakeups (0 = precise)",
+          0, G_MAXUINT64, DEFAULT_WAIT_SLACK,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstclock_class->get_internal_time = gst_system_clock_get_internal_time;
   gstclock_class->get_resolution = gst_system_clock_get_resolution;
   gstclock_class->wait = gst_system_clock_id_wait_jitter;
@@ -450,6 +472,7 @@ gst_system_clock_init (GstSystemClock * clock)
   clock->priv = priv = gst_system_clock_get_instance_private (clock);
 
   priv->clock_type = DEFAULT_CLOCK_TYPE;
+  priv->wait_slack = DEFAULT_WAIT_SLACK;
 
   priv->entries = NULL;
   g_cond_init (&priv->entries_changed);
@@ -542,6 +565,11 @@ gst_system_clock_set_property (GObject * object, guint prop_id,
       GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, sysclock, "clock-type set to %d",
           sysclock->priv->clock_type);
       break;
+    case PROP_WAIT_SLACK:
+      GST_SYSTEM_CLOCK_LOCK (sysclock);
+      sysclock->priv->wait_slack = g_value_get_uint64 (value);
+      GST_SYSTEM_CLOCK_UNLOCK (sysclock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -558,6 +586,11 @@ gst_system_clock_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_CLOCK_TYPE:
       g_value_set_enum (value, sysclock->priv->clock_type);
       break;
+    case PROP_WAIT_SLACK:
+      GST_SYSTEM_CLOCK_LOCK (sysclock);
+      g_value_set_uint64 (value, sysclock->priv->wait_slack);
+      GST_SYSTEM_CLOCK_UNLOCK (sysclock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -670,7 +703,7 @@ gst_system_clock_async_thread (GstClock * clock)
   /* now enter our (almost) infinite loop */
   while (!priv->stopping) {
     GstClockEntry *entry;
-    GstClockTime requested;
+    GstClockTime requested, slack;
     GstClockReturn res;
 
     /* check if something to be done */
@@ -716,6 +749,7 @@ gst_system_clock_async_thread (GstClock * clock)
     GST_CLOCK_ENTRY_STATUS (entry) = GST_CLOCK_BUSY;
 
     requested = entry->time;
+    slack = priv->wait_slack;
 
     /* needs to be locked again before the next loop iteration, and we only
      * unlock it here so that gst_system_clock_id_wait_async() is guaranteed
@@ -728,7 +762,7 @@ gst_system_clock_async_thread (GstClock * clock)
     /* now wait for the entry */
     res =
         gst_system_clock_id_wait_jitter_unlocked (clock, (GstClockID) entry,
-        NULL, FALSE);
+        NULL, FALSE, slack);
 
     switch (res) {
       case GST_CLOCK_UNSCHEDULED:
@@ -928,6 +962,21 @@ gst_system_clock_get_resolution (GstClock * clock)
 #endif /* __APPLE__ */
 }
 
+/* rounds the monotonic deadline @target (in ns) up to a multiple of @slack,
+ * saturating instead of overflowing for huge @slack values */
+static inline gint64
+align_deadline (gint64 target, GstClockTime slack)
+{
+  guint64 rem = (guint64) target % slack;
+
+  if (rem == 0)
+    return target;
+  if (slack - rem > (guint64) (G_MAXINT64 - target))
+    return G_MAXINT64;
+
+  return target + (gint64) (slack - rem);
+}
+
 /* synchronously wait on the given GstClockEntry.
  *
  * We do this by blocking on the entry specifically rather than a global
@@ -944,7 +993,8 @@ gst_system_clock_get_resolution (GstClock * clock)
  */
 static GstClockReturn
 gst_system_clock_id_wait_jitter_unlocked (GstClock * clock,
-    GstClockEntry * entry, GstClockTimeDiff * jitter, gboolean restart)
+    GstClockEntry * entry, GstClockTimeDiff * jitter, gboolean restart,
+    GstClockTime slack)
 {
   GstClockTime entryt, now;
   GstClockTimeDiff diff;
@@ -984,34 +1034,45 @@ gst_system_clock_id_wait_jitter_unlocked (GstClock * clock,
     while (TRUE) {
       gboolean waitret;
 
-#ifdef HAVE_CLOCK_NANOSLEEP
-      if (diff <= 500 * GST_USECOND) {
-        /* In order to provide more accurate wait, we will use BLOCKING
-           clock_nanosleep for any deadlines at or below 500us */
-        struct timespec end;
-        GST_TIME_TO_TIMESPEC (mono_ts * 1000 + diff, end);
-        GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
+      if (slack > 0) {
+        /* wake up at the end of the slack window the deadline falls in,
+         * together with all other waits ending in that window. The precise
+         * short waits below would defeat this. */
         waitret =
-            clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &end, NULL) == 0;
-        GST_SYSTEM_CLOCK_ENTRY_LOCK ((GstClockEntryImpl *) entry);
+            GST_SYSTEM_CLOCK_ENTRY_WAIT_UNTIL ((GstClockEntryImpl *) entry,
+            align_deadline (mono_ts * 1000 + diff, slack));
       } else {
+#ifdef HAVE_CLOCK_NANOSLEEP
+        if (diff <= 500 * GST_USECOND) {
+          /* In order to provide more accurate wait, we will use BLOCKING
+             clock_nanosleep for any deadlines at or below 500us */
+          struct timespec end;
+          GST_TIME_TO_TIMESPEC (mono_ts * 1000 + diff, end);
+          GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
+          waitret =
+              clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &end,
+              NULL) == 0;
+          GST_SYSTEM_CLOCK_ENTRY_LOCK ((GstClockEntryImpl *) entry);
+        } else {
 
-        if (diff < 2 * GST_MSECOND) {
-          /* For any deadline within 2ms, we first use the regular non-blocking
-             wait by reducing the diff accordingly */
-          diff -= 500 * GST_USECOND;
-        }
+          if (diff < 2 * GST_MSECOND) {
+            /* For any deadline within 2ms, we first use the regular
+               non-blocking wait by reducing the diff accordingly */
+            diff -= 500 * GST_USECOND;
+          }
 #endif
 
-        /* now wait on the entry, it either times out or the cond is signalled.
-         * The status of the entry is BUSY only around the wait. */
-        waitret =
-            GST_SYSTEM_CLOCK_ENTRY_WAIT_UNTIL ((GstClockEntryImpl *) entry,
-            mono_ts * 1000 + diff);
+          /* now wait on the entry, it either times out or the cond is
+           * signalled. The status of the entry is BUSY only around the
+           * wait. */
+          waitret =
+              GST_SYSTEM_CLOCK_ENTRY_WAIT_UNTIL ((GstClockEntryImpl *) entry,
+              mono_ts * 1000 + diff);
 
 #ifdef HAVE_CLOCK_NANOSLEEP
-      }
+        }
 #endif
+      }
 
       /* get the new status, mark as DONE. We do this so that the unschedule
        * function knows when we left the poll and doesn't need to wakeup the
@@ -1097,9 +1158,11 @@ gst_system_clock_id_wait_jitter (GstClock * clock, GstClockEntry * entry,
 {
   GstClockReturn status;
   GstClockEntryImpl *entry_impl = (GstClockEntryImpl *) entry;
+  GstClockTime slack;
 
   GST_SYSTEM_CLOCK_LOCK (clock);
   ensure_entry_initialized (entry_impl);
+  slack = GST_SYSTEM_CLOCK_CAST (clock)->priv->wait_slack;
   GST_SYSTEM_CLOCK_UNLOCK (clock);
 
   GST_SYSTEM_CLOCK_ENTRY_LOCK (entry_impl);
@@ -1121,7 +1184,8 @@ gst_system_clock_id_wait_jitter (GstClock * clock, GstClockEntry * entry,
   GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "waiting on entry %p", entry);
 
   status =
-      gst_system_clock_id_wait_jitter_unlocked (clock, entry, jitter, TRUE);
+      gst_system_clock_id_wait_jitter_unlocked (clock, entry, jitter, TRUE,
+      slack);
 
   GST_SYSTEM_CLOCK_ENTRY_UNLOCK (entry_impl);
 
@@ -53,15 +53,25 @@
 
 #define GST_TAG_IS_VALID(tag)           (gst_tag_get_info (tag) != NULL)
 
+/* The structure holding the tags is refcounted separately so that copies of
+ * a tag list can share it. It is only copied when one of the lists sharing
+ * it gets modified. */
+typedef struct
+{
+  gint refcount;
+  GstStructure *structure;
+} GstTagListData;
+
 typedef struct _GstTagListImpl
 {
   GstTagList taglist;
 
-  GstStructure *structure;
+  GstTagListData *data;
   GstTagScope scope;
 } GstTagListImpl;
 
-#define GST_TAG_LIST_STRUCTURE(taglist)  ((GstTagListImpl*)(taglist))->structure
+#define GST_TAG_LIST_DATA(taglist)  ((GstTagListImpl*)(taglist))->data
+#define GST_TAG_LIST_STRUCTURE(taglist)  GST_TAG_LIST_DATA(taglist)->structure
 #define GST_TAG_LIST_SCOPE(taglist)  ((GstTagListImpl*)(taglist))->scope
 
 typedef struct
@@ -686,20 +696,48 @@ gst_tag_is_fixed (const gchar * tag)
 }
 
 /* takes ownership of the structure */
+static GstTagListData *
+gst_tag_list_data_new (GstStructure * s)
+{
+  GstTagListData *data;
+
+  data = g_slice_new (GstTagListData);
+  data->refcount = 1;
+  data->structure = s;
+
+  return data;
+}
+
+static GstTagListData *
+gst_tag_list_data_ref (GstTagListData * data)
+{
+  g_atomic_int_inc (&data->refcount);
+
+  return data;
+}
+
+static void
+gst_tag_list_data_unref (GstTagListData * data)
+{
+  if (g_atomic_int_dec_and_test (&data->refcount)) {
+    gst_structure_free (data->structure);
+    g_slice_free (GstTagListData, data);
+  }
+}
+
+/* takes ownership of the data */
 static GstTagList *
-gst_tag_list_new_internal (GstStructure * s, GstTagScope scope)
+gst_tag_list_new_with_data (GstTagListData * data, GstTagScope scope)
 {
   GstTagList *tag_list;
 
-  g_assert (s != NULL);
-
   tag_list = (GstTagList *) g_slice_new (GstTagListImpl);
 
   gst_mini_object_init (GST_MINI_OBJECT_CAST (tag_list), 0, GST_TYPE_TAG_LIST,
       (GstMiniObjectCopyFunction) __gst_tag_list_copy, NULL,
       (GstMiniObjectFreeFunction) __gst_tag_list_free);
 
-  GST_TAG_LIST_STRUCTURE (tag_list) = s;
+  GST_TAG_LIST_DATA (tag_list) = data;
   GST_TAG_LIST_SCOPE (tag_list) = scope;
 
 #ifdef DEBUG_REFCOUNT
@@ -709,6 +747,32 @@ gst_tag_list_new_internal (GstStructure * s, GstTagScope scope)
   return tag_list;
 }
 
+/* takes ownership of the structure */
+static GstTagList *
+gst_tag_list_new_internal (GstStructure * s, GstTagScope scope)
+{
+  g_assert (s != NULL);
+
+  return gst_tag_list_new_with_data (gst_tag_list_data_new (s), scope);
+}
+
+/* Returns the structure of @list for modification, copying it first if it
+ * is shared with other tag lists. @list must be writable. */
+static GstStructure *
+gst_tag_list_get_writable_structure (GstTagList * list)
+{
+  GstTagListData *data = GST_TAG_LIST_DATA (list);
+
+  /* nobody else can take a new reference if we hold the only one */
+  if (G_UNLIKELY (g_atomic_int_get (&data->refcount) > 1)) {
+    GST_TAG_LIST_DATA (list) =
+        gst_tag_list_data_new (gst_structure_copy (data->structure));
+    gst_tag_list_data_unref (data);
+  }
+
+  return GST_TAG_LIST_STRUCTURE (list);
+}
+
 static void
 __gst_tag_list_free (GstTagList * list)
 {
@@ -718,7 +782,7 @@ __gst_tag_list_free (GstTagList * list)
   GST_CAT_TRACE (GST_CAT_TAGS, "freeing taglist %p", list);
 #endif
 
-  gst_structure_free (GST_TAG_LIST_STRUCTURE (list));
+  gst_tag_list_data_unref (GST_TAG_LIST_DATA (list));
 
 #ifdef USE_POISONING
   memset (list, 0xff, sizeof (GstTagListImpl));
@@ -730,13 +794,11 @@ __gst_tag_list_free (GstTagList * list)
 static GstTagList *
 __gst_tag_list_copy (const GstTagList * list)
 {
-  const GstStructure *s;
-
   g_return_val_if_fail (GST_IS_TAG_LIST (list), NULL);
 
-  s = GST_TAG_LIST_STRUCTURE (list);
-  return gst_tag_list_new_internal (gst_structure_copy (s),
-      GST_TAG_LIST_SCOPE (list));
+  /* the tags are only copied when either list gets modified */
+  return gst_tag_list_new_with_data (gst_tag_list_data_ref (GST_TAG_LIST_DATA
+          (list)), GST_TAG_LIST_SCOPE (list));
 }
 
 /**
@@ -1030,7 +1092,7 @@ static void
 gst_tag_list_add_value_internal (GstTagList * tag_list, GstTagMergeMode mode,
     const gchar * tag, const GValue * value, GstTagInfo * info)
 {
-  GstStructure *list = GST_TAG_LIST_STRUCTURE (tag_list);
+  GstStructure *list;
   const GValue *value2;
   GQuark tag_quark;
 
@@ -1051,6 +1113,7 @@ gst_tag_list_add_value_internal (GstTagList * tag_list, GstTagMergeMode mode,
   }
 
   tag_quark = info->name_quark;
+  list = gst_tag_list_get_writable_structure (tag_list);
 
   if (info->merge_func
       && (value2 = gst_structure_id_get_value (list, tag_quark)) != NULL) {
@@ -1137,11 +1200,18 @@ gst_tag_list_insert (GstTagList * into, const GstTagList * from,
   g_return_if_fail (GST_IS_TAG_LIST (from));
   g_return_if_fail (GST_TAG_MODE_IS_VALID (mode));
 
-  data.list = into;
-  data.mode = mode;
+  /* replacing everything leaves @into with exactly the tags of @from, so
+   * share those instead of copying them one by one */
   if (mode == GST_TAG_MERGE_REPLACE_ALL) {
-    gst_structure_remove_all_fields (GST_TAG_LIST_STRUCTURE (into));
+    GstTagListData *old = GST_TAG_LIST_DATA (into);
+
+    GST_TAG_LIST_DATA (into) = gst_tag_list_data_ref (GST_TAG_LIST_DATA (from));
+    gst_tag_list_data_unref (old);
+    return;
   }
+
+  data.list = into;
+  data.mode = mode;
   gst_structure_foreach (GST_TAG_LIST_STRUCTURE (from),
       gst_tag_list_copy_foreach, &data);
 }
@@ -1175,6 +1245,14 @@ gst_tag_list_merge (const GstTagList * list1, const GstTagList * list2,
     return NULL;
   }
 
+  /* merging into an empty list yields the tags of the other list unless they
+   * are all to be kept out, share them in that case */
+  if ((!list1 || gst_tag_list_is_empty (list1)) && list2
+      && mode != GST_TAG_MERGE_KEEP_ALL) {
+    return gst_tag_list_new_with_data (gst_tag_list_data_ref (GST_TAG_LIST_DATA
+            (list2)), list1 ? GST_TAG_LIST_SCOPE (list1) : GST_TAG_SCOPE_STREAM);
+  }
+
   /* create empty list, we need to do this to correctly handling merge modes */
   list1_cp = (list1) ? gst_tag_list_copy (list1) : gst_tag_list_new_empty ();
   list2_cp = (list2) ? list2 : gst_tag_list_new_empty ();
@@ -1284,7 +1362,8 @@ gst_tag_list_add_valist (GstTagList * list, GstTagMergeMode mode,
   g_return_if_fail (tag != NULL);
 
   if (mode == GST_TAG_MERGE_REPLACE_ALL) {
-    gst_structure_remove_all_fields (GST_TAG_LIST_STRUCTURE (list));
+    gst_structure_remove_all_fields (gst_tag_list_get_writable_structure
+        (list));
   }
 
   while (tag != NULL) {
@@ -1335,7 +1414,8 @@ gst_tag_list_add_valist_values (GstTagList * list, GstTagMergeMode mode,
   g_return_if_fail (tag != NULL);
 
   if (mode == GST_TAG_MERGE_REPLACE_ALL) {
-    gst_structure_remove_all_fields (GST_TAG_LIST_STRUCTURE (list));
+    gst_structure_remove_all_fields (gst_tag_list_get_writable_structure
+        (list));
   }
 
   while (tag != NULL) {
@@ -1387,7 +1467,10 @@ gst_tag_list_remove_tag (GstTagList * list, const gchar * tag)
   g_return_if_fail (gst_tag_list_is_writable (list));
   g_return_if_fail (tag != NULL);
 
-  gst_structure_remove_field (GST_TAG_LIST_STRUCTURE (list), tag);
+  /* don't unshare the tags if there is nothing to remove */
+  if (gst_structure_has_field (GST_TAG_LIST_STRUCTURE (list), tag))
+    gst_structure_remove_field (gst_tag_list_get_writable_structure (list),
+        tag);
 }
 
 typedef struct
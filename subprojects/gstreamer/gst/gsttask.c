@@ -65,8 +65,17 @@
  * name on Linux. Please note that the object name should be configured before the
  * task is started; changing the object name after the task has been started, has
  * no effect on the thread name.
+ *
+ * The CPUs the thread of a task may run on can be restricted with
+ * gst_task_set_cpu_affinity(). The affinity is applied when the thread enters
+ * the task function and the previous affinity of the thread is restored when
+ * it leaves, so that threads of a #GstTaskPool can be reused by other tasks.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE             /* for sched_setaffinity() */
+#endif
+
 #include "gst_private.h"
 
 #include "gstinfo.h"
@@ -83,6 +92,11 @@
 #include <pthread.h>
 #endif
 
+#ifdef HAVE_SCHED_SETAFFINITY
+#include <sched.h>
+#include <errno.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (task_debug);
 #define GST_CAT_DEFAULT (task_debug)
 
@@ -106,6 +120,16 @@ struct _GstTaskPrivate
   /* remember the pool and id that is currently running. */
   gpointer id;
   GstTaskPool *pool_id;
+
+  /* CPU affinity, protected by the object lock */
+  guint *cpus;
+  guint n_cpus;
+
+#ifdef HAVE_SCHED_SETAFFINITY
+  /* affinity of the thread before entering the task function */
+  cpu_set_t saved_affinity;
+  gboolean restore_affinity;
+#endif
 };
 
 #ifdef _MSC_VER
@@ -276,6 +300,8 @@ gst_task_finalize (GObject * object)
 
   gst_object_unref (priv->pool);
 
+  g_free (priv->cpus);
+
   /* task thread cannot be running here since it holds a ref
    * to the task so that the finalize could not have happened */
   g_cond_clear (&task->cond);
@@ -283,6 +309,56 @@ gst_task_finalize (GObject * object)
   G_OBJECT_CLASS (gst_task_parent_class)->finalize (object);
 }
 
+/* called from the task thread without the object LOCK */
+static void
+gst_task_configure_affinity (GstTask * task)
+{
+#ifdef HAVE_SCHED_SETAFFINITY
+  GstTaskPrivate *priv = task->priv;
+  cpu_set_t set;
+  guint i, n_cpus;
+
+  GST_OBJECT_LOCK (task);
+  n_cpus = priv->n_cpus;
+  CPU_ZERO (&set);
+  for (i = 0; i < n_cpus; i++) {
+    if (priv->cpus[i] < CPU_SETSIZE)
+      CPU_SET (priv->cpus[i], &set);
+  }
+  GST_OBJECT_UNLOCK (task);
+
+  if (n_cpus == 0)
+    return;
+
+  priv->restore_affinity = sched_getaffinity (0, sizeof (cpu_set_t),
+      &priv->saved_affinity) == 0;
+
+  if (sched_setaffinity (0, sizeof (cpu_set_t), &set) != 0) {
+    GST_WARNING_OBJECT (task, "failed to set CPU affinity: %s",
+        g_strerror (errno));
+    priv->restore_affinity = FALSE;
+  } else {
+    GST_DEBUG_OBJECT (task, "set CPU affinity to %u CPUs", n_cpus);
+  }
+#endif
+}
+
+static void
+gst_task_restore_affinity (GstTask * task)
+{
+#ifdef HAVE_SCHED_SETAFFINITY
+  GstTaskPrivate *priv = task->priv;
+
+  if (!priv->restore_affinity)
+    return;
+
+  if (sched_setaffinity (0, sizeof (cpu_set_t), &priv->saved_affinity) != 0)
+    GST_WARNING_OBJECT (task, "failed to restore CPU affinity: %s",
+        g_strerror (errno));
+  priv->restore_affinity = FALSE;
+#endif
+}
+
 /* should be called with the object LOCK */
 static void
 gst_task_configure_name (GstTask * task)
@@ -356,8 +432,9 @@ gst_task_func (GstTask * task)
 
   /* locking order is TASK_LOCK, LOCK */
   g_rec_mutex_lock (lock);
-  /* configure the thread name now */
+  /* configure the thread name and affinity now */
   gst_task_configure_name (task);
+  gst_task_configure_affinity (task);
 
   while (G_LIKELY (GET_TASK_STATE (task) != GST_TASK_STOPPED)) {
     GST_OBJECT_LOCK (task);
@@ -384,6 +461,8 @@ gst_task_func (GstTask * task)
     task->func (task->user_data);
   }
 
+  gst_task_restore_affinity (task);
+
   g_rec_mutex_unlock (lock);
 
   GST_OBJECT_LOCK (task);
@@ -665,6 +744,69 @@ gst_task_set_leave_callback (GstTask * task, GstTaskThreadFunc leave_func,
   GST_OBJECT_UNLOCK (task);
 }
 
+/**
+ * gst_task_set_cpu_affinity:
+ * @task: a #GstTask
+ * @cpus: (array length=n_cpus) (nullable): the CPU numbers the thread of
+ *   @task may run on
+ * @n_cpus: the number of elements in @cpus
+ *
+ * Restrict the thread of @task to the CPUs in @cpus. The affinity is applied
+ * the next time a thread enters the task function, so it should be configured
+ * before the task is started. Passing %NULL or an empty array keeps the
+ * affinity of the thread the task runs in.
+ *
+ * This currently only has an effect on Linux.
+ *
+ * MT safe.
+ *
+ * Since: 1.22
+ */
+void
+gst_task_set_cpu_affinity (GstTask * task, const guint * cpus, guint n_cpus)
+{
+  g_return_if_fail (GST_IS_TASK (task));
+  g_return_if_fail (cpus != NULL || n_cpus == 0);
+
+  GST_OBJECT_LOCK (task);
+  g_free (task->priv->cpus);
+  task->priv->cpus = n_cpus ? g_memdup2 (cpus, n_cpus * sizeof (guint)) : NULL;
+  task->priv->n_cpus = n_cpus;
+  GST_OBJECT_UNLOCK (task);
+}
+
+/**
+ * gst_task_get_cpu_affinity:
+ * @task: a #GstTask
+ * @n_cpus: (out): the number of elements in the returned array
+ *
+ * Get the CPUs the thread of @task is restricted to, as configured with
+ * gst_task_set_cpu_affinity().
+ *
+ * Returns: (array length=n_cpus) (transfer full) (nullable): the CPU numbers,
+ *   or %NULL if no affinity is configured. Free with g_free().
+ *
+ * MT safe.
+ *
+ * Since: 1.22
+ */
+guint *
+gst_task_get_cpu_affinity (GstTask * task, guint * n_cpus)
+{
+  guint *cpus;
+
+  g_return_val_if_fail (GST_IS_TASK (task), NULL);
+  g_return_val_if_fail (n_cpus != NULL, NULL);
+
+  GST_OBJECT_LOCK (task);
+  *n_cpus = task->priv->n_cpus;
+  cpus = *n_cpus ? g_memdup2 (task->priv->cpus, *n_cpus * sizeof (guint)) :
+      NULL;
+  GST_OBJECT_UNLOCK (task);
+
+  return cpus;
+}
+
 /**
  * gst_task_get_state:
  * @task: The #GstTask to query
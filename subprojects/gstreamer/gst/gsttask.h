@@ -193,6 +193,13 @@ void            gst_task_set_leave_callback  (GstTask *task,
                                               gpointer user_data,
                                               GDestroyNotify notify);
 GST_API
+void            gst_task_set_cpu_affinity    (GstTask *task,
+                                              const guint *cpus,
+                                              guint n_cpus);
+GST_API
+guint *         gst_task_get_cpu_affinity    (GstTask *task,
+                                              guint *n_cpus);
+GST_API
 GstTaskState    gst_task_get_state      (GstTask *task);
 
 GST_API
@@ -54,7 +54,11 @@ static const gchar *_quark_strings[] = {
   "element-change-state-pre", "element-change-state-post",
   "mini-object-created", "mini-object-destroyed", "object-created",
   "object-destroyed", "mini-object-reffed", "mini-object-unreffed",
-  "object-reffed", "object-unreffed", "plugin-feature-loaded"
+  "object-reffed", "object-unreffed", "plugin-feature-loaded",
+  "buffer-pool-buffer-acquired", "buffer-pool-buffer-released",
+  "buffer-pool-wait-pre", "buffer-pool-wait-post", "memory-alloc",
+  "memory-free", "plugin-loaded", "registry-updated",
+  "element-factory-first-use"
 };
 
 GQuark _priv_gst_tracer_quark_table[GST_TRACER_QUARK_MAX];
@@ -63,6 +67,90 @@ GQuark _priv_gst_tracer_quark_table[GST_TRACER_QUARK_MAX];
 
 gboolean _priv_tracer_enabled = FALSE;
 GHashTable *_priv_tracers = NULL;
+gboolean _priv_tracer_queue_init_events = FALSE;
+
+/* events from gst_init() that happened before the tracers got created */
+typedef struct
+{
+  GstTracerQuarkId hook;
+  GstClockTime ts;
+  GstObject *object;
+  GstClockTime t1, t2;
+  gboolean flag;
+} GstTracerInitEvent;
+
+static GQueue init_events = G_QUEUE_INIT;
+
+/* Called early from gst_init(), before the registry gets loaded */
+void
+_priv_gst_tracing_pre_init (void)
+{
+  const gchar *env = g_getenv ("GST_TRACERS");
+
+  /* Only pay for queueing if tracers are going to be created */
+  _priv_tracer_queue_init_events = (env != NULL && *env != '\0');
+}
+
+void
+_priv_gst_tracing_queue_init_event (GstTracerQuarkId hook, GstObject * object,
+    GstClockTime t1, GstClockTime t2, gboolean flag)
+{
+  GstTracerInitEvent *ev = g_slice_new (GstTracerInitEvent);
+
+  ev->hook = hook;
+  ev->ts = GST_TRACER_TS;
+  ev->object = gst_object_ref (object);
+  ev->t1 = t1;
+  ev->t2 = t2;
+  ev->flag = flag;
+  g_queue_push_tail (&init_events, ev);
+}
+
+#define GST_TRACER_REPLAY(key,type,args) G_STMT_START{ \
+  GList *__l, *__n;                                                  \
+  GstTracerHook *h;                                                  \
+  __l = g_hash_table_lookup (_priv_tracers, GINT_TO_POINTER (key));  \
+  for (__n = __l; __n; __n = g_list_next (__n)) {                    \
+    h = (GstTracerHook *) __n->data;                                 \
+    ((type)(h->func)) args;                                          \
+  }                                                                  \
+  __l = g_hash_table_lookup (_priv_tracers, NULL);                   \
+  for (__n = __l; __n; __n = g_list_next (__n)) {                    \
+    h = (GstTracerHook *) __n->data;                                 \
+    ((type)(h->func)) args;                                          \
+  }                                                                  \
+}G_STMT_END
+
+/* Dispatch the queued events with their original timestamps */
+static void
+gst_tracing_replay_init_events (void)
+{
+  GstTracerInitEvent *ev;
+
+  while ((ev = g_queue_pop_head (&init_events))) {
+    GstClockTime ts = ev->ts;
+
+    if (_priv_tracer_enabled) {
+      switch (ev->hook) {
+        case GST_TRACER_QUARK_HOOK_PLUGIN_LOADED:
+          GST_TRACER_REPLAY (GST_TRACER_QUARK (HOOK_PLUGIN_LOADED),
+              GstTracerHookPluginLoaded, (GST_TRACER_ARGS,
+                  GST_PLUGIN_CAST (ev->object), ev->t1, ev->t2));
+          break;
+        case GST_TRACER_QUARK_HOOK_REGISTRY_UPDATED:
+          GST_TRACER_REPLAY (GST_TRACER_QUARK (HOOK_REGISTRY_UPDATED),
+              GstTracerHookRegistryUpdated, (GST_TRACER_ARGS,
+                  GST_REGISTRY (ev->object), ev->t1, ev->t2, ev->flag));
+          break;
+        default:
+          g_assert_not_reached ();
+      }
+    }
+
+    gst_object_unref (ev->object);
+    g_slice_free (GstTracerInitEvent, ev);
+  }
+}
 
 /* Initialize the tracing system */
 void
@@ -135,6 +223,9 @@ _priv_gst_tracing_init (void)
     }
     g_strfreev (t);
   }
+
+  _priv_tracer_queue_init_events = FALSE;
+  gst_tracing_replay_init_events ();
 }
 
 void
@@ -144,6 +235,10 @@ _priv_gst_tracing_deinit (void)
   GstTracerHook *hook;
 
   _priv_tracer_enabled = FALSE;
+  _priv_tracer_queue_init_events = FALSE;
+  /* drops anything that was queued without being replayed */
+  gst_tracing_replay_init_events ();
+
   if (!_priv_tracers)
     return;
 
@@ -27,6 +27,7 @@
 #include <glib-object.h>
 #include <gst/gstconfig.h>
 #include <gst/gstbin.h>
+#include <gst/gstregistry.h>
 #include <gst/gstutils.h>
 
 G_BEGIN_DECLS
@@ -35,6 +36,7 @@ G_BEGIN_DECLS
 
 /* tracing hooks */
 
+void _priv_gst_tracing_pre_init (void);
 void _priv_gst_tracing_init (void);
 void _priv_gst_tracing_deinit (void);
 
@@ -80,6 +82,15 @@ typedef enum /*< skip >*/
   GST_TRACER_QUARK_HOOK_OBJECT_REFFED,
   GST_TRACER_QUARK_HOOK_OBJECT_UNREFFED,
   GST_TRACER_QUARK_HOOK_PLUGIN_FEATURE_LOADED,
+  GST_TRACER_QUARK_HOOK_BUFFER_POOL_BUFFER_ACQUIRED,
+  GST_TRACER_QUARK_HOOK_BUFFER_POOL_BUFFER_RELEASED,
+  GST_TRACER_QUARK_HOOK_BUFFER_POOL_WAIT_PRE,
+  GST_TRACER_QUARK_HOOK_BUFFER_POOL_WAIT_POST,
+  GST_TRACER_QUARK_HOOK_MEMORY_ALLOC,
+  GST_TRACER_QUARK_HOOK_MEMORY_FREE,
+  GST_TRACER_QUARK_HOOK_PLUGIN_LOADED,
+  GST_TRACER_QUARK_HOOK_REGISTRY_UPDATED,
+  GST_TRACER_QUARK_HOOK_ELEMENT_FACTORY_FIRST_USE,
   GST_TRACER_QUARK_MAX
 } GstTracerQuarkId;
 
@@ -97,12 +108,28 @@ typedef struct {
 extern gboolean _priv_tracer_enabled;
 /* key are hook-id quarks, values are GstTracerHook */
 extern GHashTable *_priv_tracers;
+/* TRUE while gst_init() runs with tracers requested, init-time events are
+ * queued and replayed once the tracers got created */
+extern gboolean _priv_tracer_queue_init_events;
+
+void _priv_gst_tracing_queue_init_event (GstTracerQuarkId hook,
+    GstObject *object, GstClockTime t1, GstClockTime t2, gboolean flag);
 
 #define GST_TRACER_IS_ENABLED (_priv_tracer_enabled)
 
 #define GST_TRACER_TS \
   GST_CLOCK_DIFF (_priv_gst_start_time, gst_util_get_timestamp ())
 
+/* timestamps for measuring durations reported to tracers, only taken when
+ * somebody is going to consume them */
+#define GST_TRACER_TIMESTAMP \
+  ((_priv_tracer_enabled || _priv_tracer_queue_init_events) ? \
+      gst_util_get_timestamp () : GST_CLOCK_TIME_NONE)
+
+#define GST_TRACER_ELAPSED(start) \
+  (GST_CLOCK_TIME_IS_VALID (start) ? \
+      GST_CLOCK_DIFF ((start), gst_util_get_timestamp ()) : GST_CLOCK_TIME_NONE)
+
 /* tracing hooks */
 
 #define GST_TRACER_ARGS h->tracer, ts
@@ -722,9 +749,292 @@ typedef void (*GstTracerHookPluginFeatureLoaded) (GObject *self, GstClockTime ts
     GstTracerHookPluginFeatureLoaded, (GST_TRACER_ARGS, feature)); \
 }G_STMT_END
 
+/**
+ * GstTracerHookBufferPoolBufferAcquired:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @pool: the buffer pool
+ * @buffer: the buffer that was acquired from @pool
+ *
+ * Hook called when a buffer was acquired from a #GstBufferPool named
+ * "buffer-pool-buffer-acquired".
+ *
+ * Since: 1.22
+ */
+typedef void (*GstTracerHookBufferPoolBufferAcquired) (GObject *self,
+    GstClockTime ts, GstBufferPool *pool, GstBuffer *buffer);
+/**
+ * GST_TRACER_BUFFER_POOL_BUFFER_ACQUIRED:
+ * @pool: the buffer pool
+ * @buffer: the acquired buffer
+ *
+ * Add a tracepoint when a buffer was acquired from a buffer pool.
+ *
+ * Since: 1.22
+ */
+#define GST_TRACER_BUFFER_POOL_BUFFER_ACQUIRED(pool, buffer) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_BUFFER_POOL_BUFFER_ACQUIRED), \
+    GstTracerHookBufferPoolBufferAcquired, (GST_TRACER_ARGS, pool, buffer)); \
+}G_STMT_END
+
+/**
+ * GstTracerHookBufferPoolBufferReleased:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @pool: the buffer pool
+ * @buffer: the buffer that is being released to @pool
+ *
+ * Hook called when a buffer is released to a #GstBufferPool named
+ * "buffer-pool-buffer-released".
+ *
+ * Since: 1.22
+ */
+typedef void (*GstTracerHookBufferPoolBufferReleased) (GObject *self,
+    GstClockTime ts, GstBufferPool *pool, GstBuffer *buffer);
+/**
+ * GST_TRACER_BUFFER_POOL_BUFFER_RELEASED:
+ * @pool: the buffer pool
+ * @buffer: the released buffer
+ *
+ * Add a tracepoint when a buffer is released to a buffer pool.
+ *
+ * Since: 1.22
+ */
+#define GST_TRACER_BUFFER_POOL_BUFFER_RELEASED(pool, buffer) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_BUFFER_POOL_BUFFER_RELEASED), \
+    GstTracerHookBufferPoolBufferReleased, (GST_TRACER_ARGS, pool, buffer)); \
+}G_STMT_END
+
+/**
+ * GstTracerHookBufferPoolWaitPre:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @pool: the buffer pool
+ *
+ * Pre-hook called before a thread blocks waiting for a buffer to be
+ * released to a #GstBufferPool named "buffer-pool-wait-pre".
+ *
+ * Since: 1.22
+ */
+typedef void (*GstTracerHookBufferPoolWaitPre) (GObject *self, GstClockTime ts,
+    GstBufferPool *pool);
+/**
+ * GST_TRACER_BUFFER_POOL_WAIT_PRE:
+ * @pool: the buffer pool
+ *
+ * Add a tracepoint before waiting for a free buffer in a buffer pool.
+ *
+ * Since: 1.22
+ */
+#define GST_TRACER_BUFFER_POOL_WAIT_PRE(pool) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_BUFFER_POOL_WAIT_PRE), \
+    GstTracerHookBufferPoolWaitPre, (GST_TRACER_ARGS, pool)); \
+}G_STMT_END
+
+/**
+ * GstTracerHookBufferPoolWaitPost:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @pool: the buffer pool
+ *
+ * Post-hook called when a thread stopped waiting for a buffer to be
+ * released to a #GstBufferPool named "buffer-pool-wait-post".
+ *
+ * Since: 1.22
+ */
+typedef void (*GstTracerHookBufferPoolWaitPost) (GObject *self,
+    GstClockTime ts, GstBufferPool *pool);
+/**
+ * GST_TRACER_BUFFER_POOL_WAIT_POST:
+ * @pool: the buffer pool
+ *
+ * Add a tracepoint after waiting for a free buffer in a buffer pool.
+ *
+ * Since: 1.22
+ */
+#define GST_TRACER_BUFFER_POOL_WAIT_POST(pool) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_BUFFER_POOL_WAIT_POST), \
+    GstTracerHookBufferPoolWaitPost, (GST_TRACER_ARGS, pool)); \
+}G_STMT_END
+
+/**
+ * GstTracerHookMemoryAlloc:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @allocator: the allocator
+ * @memory: the memory that was allocated from @allocator
+ *
+ * Hook called when a #GstMemory was allocated from a #GstAllocator named
+ * "memory-alloc".
+ *
+ * Since: 1.22
+ */
+typedef void (*GstTracerHookMemoryAlloc) (GObject *self, GstClockTime ts,
+    GstAllocator *allocator, GstMemory *memory);
+/**
+ * GST_TRACER_MEMORY_ALLOC:
+ * @allocator: the allocator
+ * @memory: the allocated memory
+ *
+ * Add a tracepoint when memory was allocated from an allocator.
+ *
+ * Since: 1.22
+ */
+#define GST_TRACER_MEMORY_ALLOC(allocator, memory) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_MEMORY_ALLOC), \
+    GstTracerHookMemoryAlloc, (GST_TRACER_ARGS, allocator, memory)); \
+}G_STMT_END
+
+/**
+ * GstTracerHookMemoryFree:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @allocator: the allocator
+ * @memory: the memory that is being freed
+ *
+ * Hook called when a #GstMemory is about to be freed by its #GstAllocator
+ * named "memory-free".
+ *
+ * Since: 1.22
+ */
+typedef void (*GstTracerHookMemoryFree) (GObject *self, GstClockTime ts,
+    GstAllocator *allocator, GstMemory *memory);
+/**
+ * GST_TRACER_MEMORY_FREE:
+ * @allocator: the allocator
+ * @memory: the memory being freed
+ *
+ * Add a tracepoint when memory is freed by its allocator.
+ *
+ * Since: 1.22
+ */
+#define GST_TRACER_MEMORY_FREE(allocator, memory) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_MEMORY_FREE), \
+    GstTracerHookMemoryFree, (GST_TRACER_ARGS, allocator, memory)); \
+}G_STMT_END
+
+/**
+ * GstTracerHookPluginLoaded:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @plugin: the plugin that has been loaded
+ * @load_time: the time it took to load the plugin, including opening the
+ *   module and running its init function
+ * @init_time: the time spent in the plugin's init function, or
+ *   %GST_CLOCK_TIME_NONE if the plugin was loaded by the plugin scanner helper
+ *
+ * Hook called when a plugin has been loaded named "plugin-loaded". Plugins
+ * that are loaded from gst_init() before the tracers exist are reported once
+ * the tracers got created, with their original timestamps.
+ *
+ * Since: 1.22
+ */
+typedef void (*GstTracerHookPluginLoaded) (GObject *self, GstClockTime ts,
+    GstPlugin *plugin, GstClockTime load_time, GstClockTime init_time);
+/**
+ * GST_TRACER_PLUGIN_LOADED:
+ * @plugin: the plugin that has been loaded
+ * @load_time: the time it took to load the plugin
+ * @init_time: the time spent in the plugin's init function
+ *
+ * Add a tracepoint when a plugin has been loaded.
+ *
+ * Since: 1.22
+ */
+#define GST_TRACER_PLUGIN_LOADED(plugin, load_time, init_time) G_STMT_START{ \
+  if (G_UNLIKELY (_priv_tracer_queue_init_events)) { \
+    _priv_gst_tracing_queue_init_event (GST_TRACER_QUARK_HOOK_PLUGIN_LOADED, \
+        GST_OBJECT_CAST (plugin), load_time, init_time, FALSE); \
+  } else { \
+    GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_PLUGIN_LOADED), \
+      GstTracerHookPluginLoaded, (GST_TRACER_ARGS, plugin, load_time, \
+      init_time)); \
+  } \
+}G_STMT_END
+
+/**
+ * GstTracerHookRegistryUpdated:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @registry: the registry
+ * @read_time: the time it took to read the registry cache, or
+ *   %GST_CLOCK_TIME_NONE if the cache was not read
+ * @scan_time: the time it took to validate the registry cache against the
+ *   plugin paths, or %GST_CLOCK_TIME_NONE if no update was done
+ * @changed: whether the scan found changes and the cache was written
+ *
+ * Hook called when the registry has been read and updated named
+ * "registry-updated".
+ *
+ * Since: 1.22
+ */
+typedef void (*GstTracerHookRegistryUpdated) (GObject *self, GstClockTime ts,
+    GstRegistry *registry, GstClockTime read_time, GstClockTime scan_time,
+    gboolean changed);
+/**
+ * GST_TRACER_REGISTRY_UPDATED:
+ * @registry: the registry
+ * @read_time: the time it took to read the registry cache
+ * @scan_time: the time it took to validate the registry cache
+ * @changed: whether the scan found changes
+ *
+ * Add a tracepoint when the registry has been updated.
+ *
+ * Since: 1.22
+ */
+#define GST_TRACER_REGISTRY_UPDATED(registry, read_time, scan_time, changed) G_STMT_START{ \
+  if (G_UNLIKELY (_priv_tracer_queue_init_events)) { \
+    _priv_gst_tracing_queue_init_event (GST_TRACER_QUARK_HOOK_REGISTRY_UPDATED, \
+        GST_OBJECT_CAST (registry), read_time, scan_time, changed); \
+  } else { \
+    GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_REGISTRY_UPDATED), \
+      GstTracerHookRegistryUpdated, (GST_TRACER_ARGS, registry, read_time, \
+      scan_time, changed)); \
+  } \
+}G_STMT_END
+
+/**
+ * GstTracerHookElementFactoryFirstUse:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @factory: the element factory
+ * @element: the first element created by @factory
+ * @create_time: the time it took to create @element, including loading the
+ *   plugin and initializing the element class
+ *
+ * Hook called when an element factory created its first element named
+ * "element-factory-first-use".
+ *
+ * Since: 1.22
+ */
+typedef void (*GstTracerHookElementFactoryFirstUse) (GObject *self,
+    GstClockTime ts, GstElementFactory *factory, GstElement *element,
+    GstClockTime create_time);
+/**
+ * GST_TRACER_ELEMENT_FACTORY_FIRST_USE:
+ * @factory: the element factory
+ * @element: the first element created by @factory
+ * @create_time: the time it took to create @element
+ *
+ * Add a tracepoint when an element factory created its first element.
+ *
+ * Since: 1.22
+ */
+#define GST_TRACER_ELEMENT_FACTORY_FIRST_USE(factory, element, create_time) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_ELEMENT_FACTORY_FIRST_USE), \
+    GstTracerHookElementFactoryFirstUse, (GST_TRACER_ARGS, factory, element, \
+    create_time)); \
+}G_STMT_END
+
+
 
 #else /* !GST_DISABLE_GST_TRACER_HOOKS */
 
+static inline void
+_priv_gst_tracing_pre_init (void)
+{
+}
+
 static inline void
 _priv_gst_tracing_init (void)
 {
@@ -772,6 +1082,18 @@ _priv_gst_tracing_deinit (void)
 #define GST_TRACER_OBJECT_REFFED(object, new_refcount)
 #define GST_TRACER_OBJECT_UNREFFED(object, new_refcount)
 #define GST_TRACER_PLUGIN_FEATURE_LOADED(feature)
+#define GST_TRACER_BUFFER_POOL_BUFFER_ACQUIRED(pool, buffer)
+#define GST_TRACER_BUFFER_POOL_BUFFER_RELEASED(pool, buffer)
+#define GST_TRACER_BUFFER_POOL_WAIT_PRE(pool)
+#define GST_TRACER_BUFFER_POOL_WAIT_POST(pool)
+#define GST_TRACER_MEMORY_ALLOC(allocator, memory)
+#define GST_TRACER_MEMORY_FREE(allocator, memory)
+#define GST_TRACER_PLUGIN_LOADED(plugin, load_time, init_time)
+#define GST_TRACER_REGISTRY_UPDATED(registry, read_time, scan_time, changed)
+#define GST_TRACER_ELEMENT_FACTORY_FIRST_USE(factory, element, create_time)
+
+#define GST_TRACER_TIMESTAMP GST_CLOCK_TIME_NONE
+#define GST_TRACER_ELAPSED(start) ((void) (start), GST_CLOCK_TIME_NONE)
 
 #endif /* GST_DISABLE_GST_TRACER_HOOKS */
 
@@ -164,9 +164,28 @@ gst_type_find_factory_get_list (void)
 GstCaps *
 gst_type_find_factory_get_caps (GstTypeFindFactory * factory)
 {
+  GstCaps *caps;
+
   g_return_val_if_fail (GST_IS_TYPE_FIND_FACTORY (factory), NULL);
 
-  return factory->caps;
+  caps = g_atomic_pointer_get (&factory->caps);
+
+  /* factories loaded from the registry cache only parse their caps when
+   * they are first needed */
+  if (G_UNLIKELY (caps == NULL && factory->caps_string != NULL)) {
+    caps = gst_caps_from_string (factory->caps_string);
+    if (caps == NULL) {
+      GST_ERROR_OBJECT (factory, "Failed to deserialize caps '%s'",
+          factory->caps_string);
+      return NULL;
+    }
+    if (!g_atomic_pointer_compare_and_exchange (&factory->caps, NULL, caps)) {
+      gst_caps_unref (caps);
+      caps = g_atomic_pointer_get (&factory->caps);
+    }
+  }
+
+  return caps;
 }
 
 /**
@@ -24,6 +24,36 @@ typedef struct {
   reference_t last;
 } chain_t;
 
+typedef enum {
+  PLAN_OP_CREATE,       /* create element from factory */
+  PLAN_OP_CREATE_URI,   /* create element from factory and set str as URI */
+  PLAN_OP_SET,          /* set property str of element to value */
+  PLAN_OP_SET_STRING,   /* parse the assignment str on element */
+  PLAN_OP_PRESET,       /* load preset str on element */
+  PLAN_OP_ADD,          /* add child to the bin element */
+  PLAN_OP_LINK          /* perform link from element to child */
+} plan_op_type_t;
+
+typedef struct {
+  plan_op_type_t type;
+  /* indices into the elements of an instance, -1 for links to references
+   * that have to be resolved by name */
+  gint element;
+  gint child;
+  GstElementFactory *factory;
+  gchar *str;
+  GValue value;
+  link_t *link; /* elements are unset, only names, pads and caps are used */
+} plan_op_t;
+
+struct _GstParseTemplate {
+  gint refcount;
+  GstParseFlags flags;
+  GArray *ops; /* plan_op_t */
+  guint n_elements;
+  gint toplevel;
+};
+
 typedef struct _graph_t graph_t;
 struct _graph_t {
   chain_t *chain; /* links are supposed to be done now */
@@ -31,6 +61,9 @@ struct _graph_t {
   GError **error;
   GstParseContext *ctx; /* may be NULL */
   GstParseFlags flags;
+  /* when compiling a template, the operations are recorded in here */
+  GstParseTemplate *plan;
+  GHashTable *plan_elements; /* GstElement -> index */
 };
 
 
@@ -104,6 +137,12 @@ gst_parse_unescape (gchar *str)
 G_GNUC_INTERNAL GstElement *priv_gst_parse_launch (const gchar      * str,
                                                    GError          ** err,
                                                    GstParseContext  * ctx,
-                                                   GstParseFlags      flags);
+                                                   GstParseFlags      flags,
+                                                   GstParseTemplate * plan);
+
+G_GNUC_INTERNAL GstElement *priv_gst_parse_template_instantiate (GstParseTemplate * plan,
+                                                                GError          ** err);
+
+G_GNUC_INTERNAL void        priv_gst_parse_template_clear (GstParseTemplate * plan);
 
 #endif /* __GST_PARSE_TYPES_H__ */
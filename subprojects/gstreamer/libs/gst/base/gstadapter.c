@@ -126,6 +126,7 @@
 
 #include <gst/gst_private.h>
 #include "gstadapter.h"
+#include "gstbytereader-private.h"
 #include <string.h>
 #include <gst/base/gstqueuearray.h>
 
@@ -575,6 +576,136 @@ gst_adapter_unmap (GstAdapter * adapter)
   }
 }
 
+typedef struct
+{
+  guint n_chunks;
+  GstBuffer **buffers;
+  GstMapInfo *infos;
+} GstAdapterChunksPrivate;
+
+/**
+ * gst_adapter_map_chunks: (skip)
+ * @adapter: a #GstAdapter
+ * @offset: the bytes offset in the adapter to start from
+ * @size: the number of bytes to map
+ * @chunks: (out caller-allocates): a #GstAdapterChunks to fill
+ *
+ * Maps @size bytes of data starting at @offset without merging the
+ * buffers contained in @adapter. Unlike gst_adapter_map() this never copies
+ * any data: @chunks is filled with one #GstAdapterChunk per buffer covered
+ * by the requested range, in order.
+ *
+ * The data stays valid until gst_adapter_unmap_chunks() is called, which
+ * has to happen before data is flushed from @adapter.
+ *
+ * Returns: %TRUE if the data could be mapped, %FALSE otherwise.
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_adapter_map_chunks (GstAdapter * adapter, gsize offset, gsize size,
+    GstAdapterChunks * chunks)
+{
+  GstAdapterChunksPrivate *priv;
+  GstBuffer *buf;
+  gsize skip, bsize, left;
+  guint idx, first, n, i;
+
+  g_return_val_if_fail (GST_IS_ADAPTER (adapter), FALSE);
+  g_return_val_if_fail (chunks != NULL, FALSE);
+  g_return_val_if_fail (size > 0, FALSE);
+  g_return_val_if_fail (offset + size <= adapter->size, FALSE);
+
+  memset (chunks, 0, sizeof (GstAdapterChunks));
+
+  /* find the first buffer */
+  skip = offset + adapter->skip;
+  idx = 0;
+  buf = gst_queue_array_peek_nth (adapter->bufqueue, idx);
+  bsize = gst_buffer_get_size (buf);
+  while (skip >= bsize) {
+    skip -= bsize;
+    buf = gst_queue_array_peek_nth (adapter->bufqueue, ++idx);
+    bsize = gst_buffer_get_size (buf);
+  }
+  first = idx;
+
+  /* and count how many buffers the range covers */
+  n = 0;
+  left = size + skip;
+  while (left > 0) {
+    buf = gst_queue_array_peek_nth (adapter->bufqueue, idx++);
+    left -= MIN (left, gst_buffer_get_size (buf));
+    n++;
+  }
+
+  /* all arrays in one allocation, they only contain pointer sized fields */
+  priv = g_malloc (sizeof (GstAdapterChunksPrivate) +
+      n * (sizeof (GstMapInfo) + sizeof (GstAdapterChunk) +
+          sizeof (GstBuffer *)));
+  priv->n_chunks = 0;
+  priv->infos = (GstMapInfo *) (priv + 1);
+  chunks->chunks = (GstAdapterChunk *) (priv->infos + n);
+  priv->buffers = (GstBuffer **) (chunks->chunks + n);
+  chunks->priv = priv;
+
+  left = size;
+  for (i = 0; i < n; i++) {
+    GstMapInfo *info = &priv->infos[i];
+
+    buf = gst_queue_array_peek_nth (adapter->bufqueue, first + i);
+    if (!gst_buffer_map (buf, info, GST_MAP_READ)) {
+      GST_WARNING_OBJECT (adapter, "failed to map buffer %p", buf);
+      gst_adapter_unmap_chunks (adapter, chunks);
+      return FALSE;
+    }
+    priv->buffers[i] = gst_buffer_ref (buf);
+    priv->n_chunks++;
+
+    chunks->chunks[i].data = info->data + skip;
+    chunks->chunks[i].size = MIN (left, info->size - skip);
+    left -= chunks->chunks[i].size;
+    skip = 0;
+  }
+  chunks->n_chunks = n;
+
+  GST_LOG_OBJECT (adapter, "mapped %" G_GSIZE_FORMAT " bytes at offset %"
+      G_GSIZE_FORMAT " in %u chunks", size, offset, n);
+
+  return TRUE;
+}
+
+/**
+ * gst_adapter_unmap_chunks: (skip)
+ * @adapter: a #GstAdapter
+ * @chunks: a #GstAdapterChunks filled by gst_adapter_map_chunks()
+ *
+ * Releases the data mapped by gst_adapter_map_chunks().
+ *
+ * Since: 1.22
+ */
+void
+gst_adapter_unmap_chunks (GstAdapter * adapter, GstAdapterChunks * chunks)
+{
+  GstAdapterChunksPrivate *priv;
+  guint i;
+
+  g_return_if_fail (GST_IS_ADAPTER (adapter));
+  g_return_if_fail (chunks != NULL);
+
+  priv = chunks->priv;
+  if (priv == NULL)
+    return;
+
+  for (i = 0; i < priv->n_chunks; i++) {
+    gst_buffer_unmap (priv->buffers[i], &priv->infos[i]);
+    gst_buffer_unref (priv->buffers[i]);
+  }
+  g_free (priv);
+
+  memset (chunks, 0, sizeof (GstAdapterChunks));
+}
+
 /**
  * gst_adapter_copy: (skip)
  * @adapter: a #GstAdapter
@@ -1658,6 +1789,7 @@ gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
   guint8 *bdata;
   GstBuffer *buf;
   guint idx;
+  gboolean start_code;
 
   g_return_val_if_fail (size > 0, -1);
   g_return_val_if_fail (offset + size <= adapter->size, -1);
@@ -1699,10 +1831,21 @@ gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
   /* set the state to something that does not match */
   state = ~pattern;
 
+  /* Special case found in MPEG and H264, handled by the same vectorized
+   * scanner as GstByteReader for everything that doesn't cross buffers */
+  start_code = (pattern == 0x00000100) && (mask == 0xffffff00);
+
   /* now find data */
   do {
+    gsize head;
+
     bsize = MIN (bsize, size);
-    for (i = 0; i < bsize; i++) {
+
+    /* with the start code scanner, only the first 3 bytes that can complete
+     * a match started in the previous buffer go through the state */
+    head = start_code ? MIN (bsize, 3) : bsize;
+
+    for (i = 0; i < head; i++) {
       state = ((state << 8) | bdata[i]);
       if (G_UNLIKELY ((state & mask) == pattern)) {
         /* we have a match but we need to have skipped at
@@ -1715,6 +1858,22 @@ gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
         }
       }
     }
+
+    if (head < bsize) {
+      gint ret = _gst_byte_reader_scan_for_start_code (bdata, bsize);
+
+      if (ret >= 0) {
+        if (G_LIKELY (value))
+          *value = (1 << 8) | bdata[ret + 3];
+        gst_buffer_unmap (buf, &info);
+        return offset + skip + ret;
+      }
+
+      /* keep the last bytes for matches crossing into the next buffer */
+      for (i = bsize - 3; i < bsize; i++)
+        state = ((state << 8) | bdata[i]);
+    }
+
     size -= bsize;
     if (size == 0)
       break;
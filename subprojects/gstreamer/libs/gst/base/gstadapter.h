@@ -48,6 +48,39 @@ G_BEGIN_DECLS
 typedef struct _GstAdapter GstAdapter;
 typedef struct _GstAdapterClass GstAdapterClass;
 
+/**
+ * GstAdapterChunk:
+ * @data: (array length=size): the data of the chunk
+ * @size: the size of @data
+ *
+ * A contiguous piece of the data mapped with gst_adapter_map_chunks().
+ *
+ * Since: 1.22
+ */
+typedef struct {
+  const guint8 *data;
+  gsize size;
+} GstAdapterChunk;
+
+/**
+ * GstAdapterChunks:
+ * @chunks: (array length=n_chunks): the mapped chunks
+ * @n_chunks: the number of chunks
+ *
+ * A scatter-gather view of the data of a #GstAdapter, see
+ * gst_adapter_map_chunks().
+ *
+ * Since: 1.22
+ */
+typedef struct {
+  GstAdapterChunk *chunks;
+  guint n_chunks;
+
+  /*< private >*/
+  gpointer priv;
+  gpointer _gst_reserved[GST_PADDING];
+} GstAdapterChunks;
+
 GST_BASE_API
 GType                   gst_adapter_get_type            (void);
 
@@ -66,6 +99,12 @@ gconstpointer           gst_adapter_map                 (GstAdapter *adapter, gs
 GST_BASE_API
 void                    gst_adapter_unmap               (GstAdapter *adapter);
 
+GST_BASE_API
+gboolean                gst_adapter_map_chunks          (GstAdapter *adapter, gsize offset, gsize size,
+                                                         GstAdapterChunks *chunks);
+GST_BASE_API
+void                    gst_adapter_unmap_chunks        (GstAdapter *adapter, GstAdapterChunks *chunks);
+
 GST_BASE_API
 void                    gst_adapter_copy                (GstAdapter *adapter, gpointer dest,
                                                          gsize offset, gsize size);
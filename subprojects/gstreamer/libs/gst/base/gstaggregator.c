@@ -407,6 +407,12 @@ struct _GstAggregatorPrivate
   gint64 latency;               /* protected by both src_lock and all pad locks */
   gboolean emit_signals;
   gboolean ignore_inactive_pads;
+
+  /* statistics, protected by the object lock */
+  guint64 n_ready;              /* all pads had data before the deadline */
+  guint64 n_timeout;            /* the deadline was reached */
+  GstClockTime total_lateness;
+  GstClockTime max_lateness;
 };
 
 /* Seek event forwarding helper */
@@ -436,6 +442,7 @@ enum
   PROP_START_TIME_SELECTION,
   PROP_START_TIME,
   PROP_EMIT_SIGNALS,
+  PROP_STATS,
   PROP_LAST
 };
 
@@ -817,6 +824,10 @@ gst_aggregator_wait_and_check (GstAggregator * self, gboolean * timeout)
     GST_DEBUG_OBJECT (self, "all pads have data");
     SRC_UNLOCK (self);
 
+    GST_OBJECT_LOCK (self);
+    self->priv->n_ready++;
+    GST_OBJECT_UNLOCK (self);
+
     return TRUE;
   }
 
@@ -910,6 +921,13 @@ gst_aggregator_wait_and_check (GstAggregator * self, gboolean * timeout)
         pad->priv->waited_once = TRUE;
         PAD_UNLOCK (pad);
       }
+
+      /* a positive jitter is how late we woke up after the deadline */
+      self->priv->n_timeout++;
+      if (jitter > 0) {
+        self->priv->total_lateness += jitter;
+        self->priv->max_lateness = MAX (self->priv->max_lateness, jitter);
+      }
       GST_OBJECT_UNLOCK (self);
 
       SRC_UNLOCK (self);
@@ -921,6 +939,12 @@ gst_aggregator_wait_and_check (GstAggregator * self, gboolean * timeout)
   res = gst_aggregator_check_pads_ready (self, NULL);
   SRC_UNLOCK (self);
 
+  if (res) {
+    GST_OBJECT_LOCK (self);
+    self->priv->n_ready++;
+    GST_OBJECT_UNLOCK (self);
+  }
+
   return res;
 }
 
@@ -1475,6 +1499,11 @@ gst_aggregator_start (GstAggregator * self)
 
   gst_aggregator_set_allocation (self, NULL, NULL, NULL, NULL);
 
+  GST_OBJECT_LOCK (self);
+  self->priv->n_ready = self->priv->n_timeout = 0;
+  self->priv->total_lateness = self->priv->max_lateness = 0;
+  GST_OBJECT_UNLOCK (self);
+
   klass = GST_AGGREGATOR_GET_CLASS (self);
 
   if (klass->start)
@@ -2699,6 +2728,24 @@ gst_aggregator_get_latency_property (GstAggregator * agg)
   return res;
 }
 
+static GstStructure *
+gst_aggregator_get_stats (GstAggregator * agg)
+{
+  GstAggregatorPrivate *priv = agg->priv;
+  GstStructure *s;
+
+  GST_OBJECT_LOCK (agg);
+  s = gst_structure_new ("application/x-gst-aggregator-stats",
+      "ready", G_TYPE_UINT64, priv->n_ready,
+      "timeouts", G_TYPE_UINT64, priv->n_timeout,
+      "average-lateness", G_TYPE_UINT64,
+      priv->n_timeout ? priv->total_lateness / priv->n_timeout : 0,
+      "max-lateness", G_TYPE_UINT64, priv->max_lateness, NULL);
+  GST_OBJECT_UNLOCK (agg);
+
+  return s;
+}
+
 static void
 gst_aggregator_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -2753,6 +2800,9 @@ gst_aggregator_get_property (GObject * object, guint prop_id,
     case PROP_EMIT_SIGNALS:
       g_value_set_boolean (value, agg->priv->emit_signals);
       break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_aggregator_get_stats (agg));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2859,6 +2909,31 @@ gst_aggregator_class_init (GstAggregatorClass * klass)
           "Send signals", DEFAULT_EMIT_SIGNALS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAggregator:stats:
+   *
+   * Statistics about how the live deadline is met. This property returns a
+   * #GstStructure with name `application/x-gst-aggregator-stats` with the
+   * following fields:
+   *
+   * - "ready" G_TYPE_UINT64   Number of times all pads had data before the
+   *   deadline
+   * - "timeouts" G_TYPE_UINT64   Number of times the deadline was reached
+   *   before all pads had data
+   * - "average-lateness" G_TYPE_UINT64   Average time in nanoseconds the
+   *   aggregator woke up after a deadline
+   * - "max-lateness" G_TYPE_UINT64   Maximum time in nanoseconds the
+   *   aggregator woke up after a deadline
+   *
+   * The statistics are reset when the element goes from READY to PAUSED.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Aggregator Statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstAggregator::samples-selected:
    * @aggregator: The #GstAggregator that emitted the signal
@@ -3242,6 +3317,9 @@ enum
 {
   PAD_PROP_0,
   PAD_PROP_EMIT_SIGNALS,
+  PAD_PROP_CURRENT_LEVEL_BUFFERS,
+  PAD_PROP_CURRENT_LEVEL_BYTES,
+  PAD_PROP_CURRENT_LEVEL_TIME,
 };
 
 enum
@@ -3318,6 +3396,29 @@ gst_aggregator_pad_get_property (GObject * object, guint prop_id,
     case PAD_PROP_EMIT_SIGNALS:
       g_value_set_boolean (value, pad->priv->emit_signals);
       break;
+    case PAD_PROP_CURRENT_LEVEL_BUFFERS:
+      PAD_LOCK (pad);
+      g_value_set_uint (value, pad->priv->num_buffers);
+      PAD_UNLOCK (pad);
+      break;
+    case PAD_PROP_CURRENT_LEVEL_BYTES:{
+      guint bytes = 0;
+      GList *l;
+
+      PAD_LOCK (pad);
+      for (l = pad->priv->data.head; l; l = l->next) {
+        if (GST_IS_BUFFER (l->data))
+          bytes += gst_buffer_get_size (l->data);
+      }
+      PAD_UNLOCK (pad);
+      g_value_set_uint (value, bytes);
+      break;
+    }
+    case PAD_PROP_CURRENT_LEVEL_TIME:
+      PAD_LOCK (pad);
+      g_value_set_uint64 (value, pad->priv->time_level);
+      PAD_UNLOCK (pad);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3362,6 +3463,46 @@ gst_aggregator_pad_class_init (GstAggregatorPadClass * klass)
       g_param_spec_boolean ("emit-signals", "Emit signals",
           "Send signals to signal data consumption", DEFAULT_PAD_EMIT_SIGNALS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAggregatorPad:current-level-buffers:
+   *
+   * The number of buffers currently queued on the pad.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class,
+      PAD_PROP_CURRENT_LEVEL_BUFFERS,
+      g_param_spec_uint ("current-level-buffers", "Current level buffers",
+          "Current number of buffers queued on the pad", 0, G_MAXUINT, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAggregatorPad:current-level-bytes:
+   *
+   * The amount of data currently queued on the pad, in bytes.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class,
+      PAD_PROP_CURRENT_LEVEL_BYTES,
+      g_param_spec_uint ("current-level-bytes", "Current level bytes",
+          "Current amount of data queued on the pad (bytes)", 0, G_MAXUINT, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAggregatorPad:current-level-time:
+   *
+   * The running time between the oldest and the newest data queued on the
+   * pad.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class,
+      PAD_PROP_CURRENT_LEVEL_TIME,
+      g_param_spec_uint64 ("current-level-time", "Current level time",
+          "Current amount of data queued on the pad (in ns)", 0, G_MAXUINT64,
+          0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
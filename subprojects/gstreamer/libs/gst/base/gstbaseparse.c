@@ -307,6 +307,14 @@ struct _GstBaseParsePrivate
   /* Pending serialized events */
   GList *pending_events;
 
+  /* frames collected for pushing as one buffer list in forward playback,
+   * only used when max_batch_frames > 1 */
+  guint max_batch_frames;
+  GstBufferList *batch;
+  /* flow return of a batch pushed ahead of a serialized event, returned
+   * from the next chain call */
+  GstFlowReturn batch_ret;
+
   /* If baseparse has checked the caps to identify if it is
    * handling video or audio */
   gboolean checked_media;
@@ -478,6 +486,7 @@ static inline GstFlowReturn gst_base_parse_check_sync (GstBaseParse * parse);
 static gboolean gst_base_parse_is_seekable (GstBaseParse * parse);
 
 static void gst_base_parse_push_pending_events (GstBaseParse * parse);
+static GstFlowReturn gst_base_parse_push_batch (GstBaseParse * parse);
 
 static void
 gst_base_parse_clear_queues (GstBaseParse * parse)
@@ -511,6 +520,12 @@ gst_base_parse_clear_queues (GstBaseParse * parse)
   g_list_free (parse->priv->pending_events);
   parse->priv->pending_events = NULL;
 
+  if (parse->priv->batch) {
+    gst_buffer_list_unref (parse->priv->batch);
+    parse->priv->batch = NULL;
+  }
+  parse->priv->batch_ret = GST_FLOW_OK;
+
   parse->priv->checked_media = FALSE;
 }
 
@@ -839,6 +854,7 @@ gst_base_parse_reset (GstBaseParse * parse)
   parse->priv->passthrough = FALSE;
   parse->priv->pts_interpolate = TRUE;
   parse->priv->infer_ts = TRUE;
+  parse->priv->max_batch_frames = 0;
   parse->priv->has_timing_info = FALSE;
   parse->priv->min_bitrate = G_MAXUINT;
   parse->priv->max_bitrate = 0;
@@ -1203,6 +1219,17 @@ gst_base_parse_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
   GstBaseParseClass *bclass = GST_BASE_PARSE_GET_CLASS (parse);
   gboolean ret;
 
+  /* frames parsed before this event have to go out first */
+  if (GST_EVENT_IS_SERIALIZED (event)) {
+    GstFlowReturn batch_ret = gst_base_parse_push_batch (parse);
+
+    if (batch_ret != GST_FLOW_OK) {
+      GST_DEBUG_OBJECT (parse, "pushing batch before %s event returned %s",
+          GST_EVENT_TYPE_NAME (event), gst_flow_get_name (batch_ret));
+      parse->priv->batch_ret = batch_ret;
+    }
+  }
+
   ret = bclass->sink_event (parse, event);
 
   return ret;
@@ -2330,9 +2357,14 @@ static void
 gst_base_parse_push_pending_events (GstBaseParse * parse)
 {
   if (G_UNLIKELY (parse->priv->pending_events)) {
-    GList *r = g_list_reverse (parse->priv->pending_events);
+    GList *r;
     GList *l;
 
+    /* keep events ordered with the frames already batched */
+    gst_base_parse_push_batch (parse);
+
+    r = g_list_reverse (parse->priv->pending_events);
+
     parse->priv->pending_events = NULL;
     for (l = r; l != NULL; l = l->next) {
       gst_pad_push_event (parse->srcpad, GST_EVENT_CAST (l->data));
@@ -2588,7 +2620,17 @@ gst_base_parse_push_frame (GstBaseParse * parse, GstBaseParseFrame * frame)
     gst_buffer_unref (buffer);
     ret = GST_FLOW_OK;
   } else if (ret == GST_FLOW_OK) {
-    if (parse->segment.rate > 0.0) {
+    if (parse->segment.rate > 0.0 && parse->priv->max_batch_frames > 1) {
+      if (!parse->priv->batch)
+        parse->priv->batch =
+            gst_buffer_list_new_sized (parse->priv->max_batch_frames);
+      GST_LOG_OBJECT (parse, "frame (%" G_GSIZE_FORMAT " bytes) batched",
+          size);
+      gst_buffer_list_add (parse->priv->batch, buffer);
+      if (gst_buffer_list_length (parse->priv->batch) >=
+          parse->priv->max_batch_frames)
+        ret = gst_base_parse_push_batch (parse);
+    } else if (parse->segment.rate > 0.0) {
       GST_LOG_OBJECT (parse, "pushing frame (%" G_GSIZE_FORMAT " bytes) now..",
           size);
       ret = gst_pad_push (parse->srcpad, buffer);
@@ -2659,6 +2701,26 @@ no_caps:
   }
 }
 
+/* Pushes the frames collected in batch mode, if any */
+static GstFlowReturn
+gst_base_parse_push_batch (GstBaseParse * parse)
+{
+  GstBufferList *batch = parse->priv->batch;
+  GstFlowReturn ret;
+
+  if (G_LIKELY (batch == NULL))
+    return GST_FLOW_OK;
+
+  parse->priv->batch = NULL;
+
+  GST_LOG_OBJECT (parse, "pushing batch of %u frames",
+      gst_buffer_list_length (batch));
+  ret = gst_pad_push_list (parse->srcpad, batch);
+  GST_LOG_OBJECT (parse, "batch pushed, flow %s", gst_flow_get_name (ret));
+
+  return ret;
+}
+
 /**
  * gst_base_parse_finish_frame:
  * @parse: a #GstBaseParse
@@ -3087,6 +3149,15 @@ gst_base_parse_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   bclass = GST_BASE_PARSE_GET_CLASS (parse);
   GST_DEBUG_OBJECT (parent, "chain");
 
+  /* report a failure of the batch pushed from the event handler */
+  if (G_UNLIKELY (parse->priv->batch_ret != GST_FLOW_OK)) {
+    ret = parse->priv->batch_ret;
+    parse->priv->batch_ret = GST_FLOW_OK;
+    if (buffer)
+      gst_buffer_unref (buffer);
+    return ret;
+  }
+
   /* early out for speed, if we need to skip */
   if (buffer && GST_BUFFER_IS_DISCONT (buffer))
     parse->priv->skip = 0;
@@ -3216,7 +3287,7 @@ gst_base_parse_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
       frame.buffer = gst_buffer_make_writable (buffer);
       ret = gst_base_parse_push_frame (parse, &frame);
       gst_base_parse_frame_free (&frame);
-      return ret;
+      goto done;
     }
     if (G_UNLIKELY (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DISCONT))) {
       /* upstream feeding us in reverse playback;
@@ -3317,6 +3388,13 @@ gst_base_parse_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   }
 
 done:
+  {
+    GstFlowReturn batch_ret = gst_base_parse_push_batch (parse);
+
+    if (ret == GST_FLOW_OK)
+      ret = batch_ret;
+  }
+
   GST_LOG_OBJECT (parse, "chain leaving");
   return ret;
 }
@@ -3612,6 +3690,13 @@ gst_base_parse_loop (GstPad * pad)
 
   ret = gst_base_parse_scan_frame (parse, klass);
 
+  {
+    GstFlowReturn batch_ret = gst_base_parse_push_batch (parse);
+
+    if (ret == GST_FLOW_OK)
+      ret = batch_ret;
+  }
+
   /* eat expected eos signalling past segment in reverse playback */
   if (parse->segment.rate < 0.0 && ret == GST_FLOW_EOS &&
       parse->segment.position >= parse->segment.stop) {
@@ -4064,6 +4149,32 @@ gst_base_parse_set_infer_ts (GstBaseParse * parse, gboolean infer_ts)
   GST_INFO_OBJECT (parse, "TS inferring: %s", (infer_ts) ? "yes" : "no");
 }
 
+/**
+ * gst_base_parse_set_max_batch_frames:
+ * @parse: a #GstBaseParse
+ * @max_frames: maximum number of frames pushed together
+ *
+ * Enables batch mode when @max_frames is larger than 1. In batch mode the
+ * frames finished while handling one input buffer, for example by calling
+ * gst_base_parse_finish_frame() several times from a single
+ * #GstBaseParseClass.handle_frame() call, are pushed downstream together as
+ * a #GstBufferList of up to @max_frames buffers instead of one by one. Each
+ * buffer keeps its own timestamps. This reduces the per-frame overhead for
+ * formats with many small frames.
+ *
+ * Batching only applies to forward playback, and the collected frames are
+ * always pushed before any serialized event and before the input buffer is
+ * returned, so it doesn't add latency.
+ *
+ * Since: 1.22
+ */
+void
+gst_base_parse_set_max_batch_frames (GstBaseParse * parse, guint max_frames)
+{
+  parse->priv->max_batch_frames = max_frames;
+  GST_INFO_OBJECT (parse, "max batch frames: %u", max_frames);
+}
+
 /**
  * gst_base_parse_set_latency:
  * @parse: a #GstBaseParse
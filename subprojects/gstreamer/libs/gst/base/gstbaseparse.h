@@ -347,6 +347,9 @@ GST_BASE_API
 void            gst_base_parse_set_infer_ts (GstBaseParse * parse,
                                              gboolean infer_ts);
 GST_BASE_API
+void            gst_base_parse_set_max_batch_frames (GstBaseParse * parse,
+                                                     guint max_frames);
+GST_BASE_API
 void            gst_base_parse_set_frame_rate  (GstBaseParse * parse,
                                                 guint          fps_num,
                                                 guint          fps_den,
@@ -278,6 +278,9 @@ struct _GstBaseSinkPrivate
   gsize rc_accumulated;
 
   gboolean drop_out_of_segment;
+
+  /* sync lists on their first buffer also without render_list */
+  gboolean list_sync;
 };
 
 #define DO_RUNNING_AVG(avg,val,size) (((val) + ((size)-1) * (avg)) / (size))
@@ -833,6 +836,58 @@ gst_base_sink_get_drop_out_of_segment (GstBaseSink * sink)
   return res;
 }
 
+/**
+ * gst_base_sink_set_list_sync:
+ * @sink: the sink
+ * @list_sync: handle buffer lists as a whole
+ *
+ * Configure @sink to handle buffer lists as a whole even if the subclass
+ * does not implement #GstBaseSinkClass::render_list. Such lists are then
+ * synchronised against the clock once, using the first buffer of the list,
+ * after which all buffers of the list are passed to
+ * #GstBaseSinkClass::prepare and #GstBaseSinkClass::render back to back.
+ *
+ * When disabled, the default, lists are split into individual buffers that
+ * are each synchronised against the clock. Subclasses implementing
+ * #GstBaseSinkClass::render_list always receive complete lists.
+ *
+ * Since: 1.22
+ */
+void
+gst_base_sink_set_list_sync (GstBaseSink * sink, gboolean list_sync)
+{
+  g_return_if_fail (GST_IS_BASE_SINK (sink));
+
+  GST_OBJECT_LOCK (sink);
+  sink->priv->list_sync = list_sync;
+  GST_OBJECT_UNLOCK (sink);
+}
+
+/**
+ * gst_base_sink_get_list_sync:
+ * @sink: the sink
+ *
+ * Checks if @sink handles buffer lists as a whole, see
+ * gst_base_sink_set_list_sync().
+ *
+ * Returns: %TRUE if the sink synchronises buffer lists on their first buffer.
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_base_sink_get_list_sync (GstBaseSink * sink)
+{
+  gboolean res;
+
+  g_return_val_if_fail (GST_IS_BASE_SINK (sink), FALSE);
+
+  GST_OBJECT_LOCK (sink);
+  res = sink->priv->list_sync;
+  GST_OBJECT_UNLOCK (sink);
+
+  return res;
+}
+
 /**
  * gst_base_sink_set_max_lateness:
  * @sink: the sink
@@ -3749,6 +3804,45 @@ gst_base_sink_needs_preroll (GstBaseSink * basesink)
   return res;
 }
 
+/* with STREAM_LOCK, PREROLL_LOCK
+ *
+ * Prepares all buffers of a list that is handled as a whole by a subclass
+ * that does not implement prepare_list. */
+static GstFlowReturn
+gst_base_sink_prepare_each (GstBaseSink * basesink, GstBufferList * list)
+{
+  GstBaseSinkClass *bclass = GST_BASE_SINK_GET_CLASS (basesink);
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i, len;
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len && ret == GST_FLOW_OK; i++)
+    ret = bclass->prepare (basesink, gst_buffer_list_get (list, i));
+
+  return ret;
+}
+
+/* with STREAM_LOCK, PREROLL_LOCK
+ *
+ * Renders all buffers of a list that is handled as a whole by a subclass
+ * that does not implement render_list. */
+static GstFlowReturn
+gst_base_sink_render_each (GstBaseSink * basesink, GstBufferList * list)
+{
+  GstBaseSinkClass *bclass = GST_BASE_SINK_GET_CLASS (basesink);
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i, len;
+
+  if (!bclass->render)
+    return GST_FLOW_OK;
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len && ret == GST_FLOW_OK; i++)
+    ret = bclass->render (basesink, gst_buffer_list_get (list, i));
+
+  return ret;
+}
+
 /* with STREAM_LOCK, PREROLL_LOCK
  *
  * Takes a buffer and compare the timestamps with the last segment.
@@ -3904,6 +3998,10 @@ gst_base_sink_chain_unlocked (GstBaseSink * basesink, GstPad * pad,
         ret = bclass->prepare_list (basesink, GST_BUFFER_LIST_CAST (obj));
         if (G_UNLIKELY (ret != GST_FLOW_OK))
           goto prepare_failed;
+      } else if (bclass->prepare) {
+        ret = gst_base_sink_prepare_each (basesink, GST_BUFFER_LIST_CAST (obj));
+        if (G_UNLIKELY (ret != GST_FLOW_OK))
+          goto prepare_failed;
       }
     }
 
@@ -3955,6 +4053,8 @@ again:
 
     if (bclass->render_list)
       ret = bclass->render_list (basesink, buffer_list);
+    else
+      ret = gst_base_sink_render_each (basesink, buffer_list);
 
     /* Set the first buffer and buffer list to be included in last sample */
     gst_base_sink_set_last_buffer (basesink, sync_buf);
@@ -4118,7 +4218,8 @@ gst_base_sink_chain_list (GstPad * pad, GstObject * parent,
   basesink = GST_BASE_SINK (parent);
   bclass = GST_BASE_SINK_GET_CLASS (basesink);
 
-  if (G_LIKELY (bclass->render_list)) {
+  if (G_LIKELY (bclass->render_list)
+      || gst_base_sink_get_list_sync (basesink)) {
     result = gst_base_sink_chain_main (basesink, pad, list, TRUE);
   } else {
     guint i, len;
@@ -238,6 +238,14 @@ void            gst_base_sink_set_drop_out_of_segment (GstBaseSink *sink, gboole
 GST_BASE_API
 gboolean        gst_base_sink_get_drop_out_of_segment (GstBaseSink *sink);
 
+/* synchronizing buffer lists on their first buffer */
+
+GST_BASE_API
+void            gst_base_sink_set_list_sync     (GstBaseSink *sink, gboolean list_sync);
+
+GST_BASE_API
+gboolean        gst_base_sink_get_list_sync     (GstBaseSink *sink);
+
 /* dropping late buffers */
 
 GST_BASE_API
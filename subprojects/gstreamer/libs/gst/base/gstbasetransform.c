@@ -131,6 +131,13 @@
  *
  *   * Implied %TRUE if no transform function is implemented.
  *   * Implied %FALSE if ONLY transform function is implemented.
+ *
+ * # Buffer lists
+ *
+ * Buffer lists are forwarded as a whole in passthrough mode, unless QoS is
+ * enabled or transform_ip is called in passthrough mode. Otherwise they are
+ * handed to the transform_list or transform_ip_list functions when the
+ * subclass implements them, and split into individual buffers if it doesn't.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -278,6 +285,8 @@ static GstFlowReturn gst_base_transform_getrange (GstPad * pad,
     GstObject * parent, guint64 offset, guint length, GstBuffer ** buffer);
 static GstFlowReturn gst_base_transform_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buffer);
+static GstFlowReturn gst_base_transform_chain_list (GstPad * pad,
+    GstObject * parent, GstBufferList * list);
 static GstCaps *gst_base_transform_default_transform_caps (GstBaseTransform *
     trans, GstPadDirection direction, GstCaps * caps, GstCaps * filter);
 static GstCaps *gst_base_transform_default_fixate_caps (GstBaseTransform *
@@ -390,6 +399,8 @@ gst_base_transform_init (GstBaseTransform * trans,
       GST_DEBUG_FUNCPTR (gst_base_transform_sink_event));
   gst_pad_set_chain_function (trans->sinkpad,
       GST_DEBUG_FUNCPTR (gst_base_transform_chain));
+  gst_pad_set_chain_list_function (trans->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_base_transform_chain_list));
   gst_pad_set_activatemode_function (trans->sinkpad,
       GST_DEBUG_FUNCPTR (gst_base_transform_sink_activate_mode));
   gst_pad_set_query_function (trans->sinkpad,
@@ -2393,6 +2404,178 @@ done:
   return ret;
 }
 
+/* Takes ownership of @list. Forwards the list downstream as is when
+ * @transform is %FALSE, otherwise hands it to the list transform functions
+ * first */
+static GstFlowReturn
+gst_base_transform_handle_list (GstBaseTransform * trans, GstBufferList * list,
+    gboolean transform, gboolean in_place)
+{
+  GstBaseTransformClass *klass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+  GstBaseTransformPrivate *priv = trans->priv;
+  GstBufferList *outlist = NULL;
+  GstClockTime position = GST_CLOCK_TIME_NONE;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBuffer *buffer;
+  guint i, len;
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len; i++) {
+    buffer = gst_buffer_list_get (list, i);
+
+    if (klass->before_transform)
+      klass->before_transform (trans, buffer);
+
+    if (GST_BUFFER_IS_DISCONT (buffer)) {
+      GST_DEBUG_OBJECT (trans, "got DISCONT buffer %p", buffer);
+      priv->discont = TRUE;
+    }
+  }
+
+  /* calculate end position of the incoming list */
+  buffer = gst_buffer_list_get (list, len - 1);
+  if (GST_BUFFER_TIMESTAMP_IS_VALID (buffer)) {
+    position = GST_BUFFER_TIMESTAMP (buffer);
+    if (GST_BUFFER_DURATION_IS_VALID (buffer))
+      position += GST_BUFFER_DURATION (buffer);
+  }
+
+  if (!transform) {
+    GST_DEBUG_OBJECT (trans, "forwarding list of %u buffers", len);
+    outlist = list;
+  } else if (in_place) {
+    list = gst_buffer_list_make_writable (list);
+    for (i = 0; i < len; i++)
+      gst_buffer_list_get_writable (list, i);
+
+    GST_DEBUG_OBJECT (trans, "doing inplace transform of %u buffers", len);
+    ret = klass->transform_ip_list (trans, list);
+    outlist = list;
+  } else {
+    GST_DEBUG_OBJECT (trans, "doing non-inplace transform of %u buffers", len);
+    ret = klass->transform_list (trans, list, &outlist);
+  }
+
+  if (ret != GST_FLOW_OK || outlist == NULL
+      || gst_buffer_list_length (outlist) == 0) {
+    GST_DEBUG_OBJECT (trans, "no output list, got return %s",
+        gst_flow_get_name (ret));
+    if (outlist)
+      gst_buffer_list_unref (outlist);
+    goto done;
+  }
+
+  len = gst_buffer_list_length (outlist);
+
+  if (trans->segment.format == GST_FORMAT_TIME) {
+    /* Remember last stop position */
+    if (position != GST_CLOCK_TIME_NONE)
+      trans->segment.position = position;
+
+    buffer = gst_buffer_list_get (outlist, len - 1);
+    if (GST_BUFFER_TIMESTAMP_IS_VALID (buffer)) {
+      priv->position_out = GST_BUFFER_TIMESTAMP (buffer);
+      if (GST_BUFFER_DURATION_IS_VALID (buffer))
+        priv->position_out += GST_BUFFER_DURATION (buffer);
+    } else if (position != GST_CLOCK_TIME_NONE) {
+      priv->position_out = position;
+    }
+  }
+
+  /* apply DISCONT flag if the first buffer is not yet marked as such */
+  if (priv->discont) {
+    GST_DEBUG_OBJECT (trans, "we have a pending DISCONT");
+    if (!GST_BUFFER_IS_DISCONT (gst_buffer_list_get (outlist, 0))) {
+      GST_DEBUG_OBJECT (trans, "marking DISCONT on first output buffer");
+      outlist = gst_buffer_list_make_writable (outlist);
+      buffer = gst_buffer_list_get_writable (outlist, 0);
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+    }
+    priv->discont = FALSE;
+  }
+  priv->processed += len;
+
+  ret = gst_pad_push_list (trans->srcpad, outlist);
+
+done:
+  /* convert internal flow to OK and mark discont for the next buffer. */
+  if (ret == GST_BASE_TRANSFORM_FLOW_DROPPED) {
+    GST_DEBUG_OBJECT (trans, "dropped a list, marking DISCONT");
+    priv->discont = TRUE;
+    ret = GST_FLOW_OK;
+  }
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_base_transform_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (parent);
+  GstBaseTransformClass *klass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+  GstBaseTransformPrivate *priv = trans->priv;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i, len;
+
+  len = gst_buffer_list_length (list);
+  if (len == 0)
+    goto done;
+
+  /* renegotiate first so that we decide on the current mode */
+  if (G_UNLIKELY (!gst_base_transform_reconfigure_unlocked (trans)))
+    goto not_negotiated;
+
+  if (!priv->negotiated && !priv->passthrough && (klass->set_caps != NULL))
+    goto not_negotiated;
+
+  /* subclasses that override how input is submitted or output is generated,
+   * e.g. for segment clipping or to queue data, need to see every buffer */
+  if (klass->submit_input_buffer != default_submit_input_buffer ||
+      klass->generate_output != default_generate_output)
+    goto chain_buffers;
+
+  if (priv->passthrough) {
+    /* QoS and transform_ip are decided per buffer */
+    if (!(klass->transform_ip_on_passthrough && klass->transform_ip) &&
+        !(gst_base_transform_is_qos_enabled (trans) &&
+            trans->segment.format == GST_FORMAT_TIME))
+      return gst_base_transform_handle_list (trans, list, FALSE, FALSE);
+  } else if (priv->always_in_place) {
+    if (klass->transform_ip_list)
+      return gst_base_transform_handle_list (trans, list, TRUE, TRUE);
+  } else {
+    if (klass->transform_list)
+      return gst_base_transform_handle_list (trans, list, TRUE, FALSE);
+  }
+
+chain_buffers:
+
+  GST_LOG_OBJECT (trans, "chaining each buffer in list");
+
+  for (i = 0; i < len; i++) {
+    GstBuffer *buffer = gst_buffer_list_get (list, i);
+
+    ret = gst_base_transform_chain (pad, parent, gst_buffer_ref (buffer));
+    if (ret != GST_FLOW_OK)
+      break;
+  }
+
+done:
+  gst_buffer_list_unref (list);
+
+  return ret;
+
+  /* ERRORS */
+not_negotiated:
+  {
+    gst_buffer_list_unref (list);
+    if (GST_PAD_IS_FLUSHING (trans->srcpad))
+      return GST_FLOW_FLUSHING;
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+}
+
 static void
 gst_base_transform_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
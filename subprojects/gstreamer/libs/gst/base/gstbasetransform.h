@@ -209,6 +209,14 @@ struct _GstBaseTransform {
  *                   do 1-to-1 transformations of input to output buffers can either
  *                   return GST_BASE_TRANSFORM_FLOW_DROPPED or simply not generate
  *                   an output buffer until they are ready to do so. (Since: 1.6)
+ * @transform_list: Optional. Transforms a complete #GstBufferList into a new
+ *                  list instead of handling each buffer individually. Only
+ *                  used when the element does not operate in-place and is
+ *                  not in passthrough mode. (Since: 1.22)
+ * @transform_ip_list: Optional. Transforms all buffers of a #GstBufferList
+ *                  in-place. The list and its buffers are writable. Only
+ *                  used when the element operates in-place and is not in
+ *                  passthrough mode. (Since: 1.22)
  *
  * Subclasses can override any of the available virtual methods or not, as
  * needed. At minimum either @transform or @transform_ip need to be overridden.
@@ -309,8 +317,25 @@ struct _GstBaseTransformClass {
    */
   GstFlowReturn (*generate_output) (GstBaseTransform *trans, GstBuffer **outbuf);
 
+  /**
+   * GstBaseTransformClass::transform_list:
+   * @inlist: (transfer full): the input buffer list
+   * @outlist: (out) (transfer full): the output buffer list
+   *
+   * Since: 1.22
+   */
+  GstFlowReturn (*transform_list)    (GstBaseTransform *trans, GstBufferList *inlist,
+                                      GstBufferList **outlist);
+
+  /**
+   * GstBaseTransformClass::transform_ip_list:
+   *
+   * Since: 1.22
+   */
+  GstFlowReturn (*transform_ip_list) (GstBaseTransform *trans, GstBufferList *list);
+
   /*< private >*/
-  gpointer       _gst_reserved[GST_PADDING_LARGE - 2];
+  gpointer       _gst_reserved[GST_PADDING_LARGE - 4];
 };
 
 GST_BASE_API
@@ -0,0 +1,53 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstbytereader-x86-avx2.h"
+
+#include <immintrin.h>
+
+/* Returns the number of bytes at the start of @data that certainly contain
+ * no 00 00 01 start code, in steps of 32 bytes. Every candidate position of
+ * a block needs the three start code bytes plus the byte following them. */
+guint
+_gst_byte_reader_skip_start_code_free_avx2 (const guint8 * data, guint size)
+{
+  const __m256i zero = _mm256_setzero_si256 ();
+  const __m256i one = _mm256_set1_epi8 (1);
+  guint i;
+
+  for (i = 0; i + 32 + 3 <= size; i += 32) {
+    __m256i b0 = _mm256_loadu_si256 ((const __m256i *) (data + i));
+    __m256i b1 = _mm256_loadu_si256 ((const __m256i *) (data + i + 1));
+    __m256i b2 = _mm256_loadu_si256 ((const __m256i *) (data + i + 2));
+    __m256i m;
+
+    m = _mm256_and_si256 (_mm256_cmpeq_epi8 (b0, zero),
+        _mm256_cmpeq_epi8 (b1, zero));
+    m = _mm256_and_si256 (m, _mm256_cmpeq_epi8 (b2, one));
+
+    if (_mm256_movemask_epi8 (m) != 0)
+      break;
+  }
+
+  return i;
+}
@@ -0,0 +1,29 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef GST_BYTE_READER_X86_AVX2_H
+#define GST_BYTE_READER_X86_AVX2_H
+
+#include <glib.h>
+
+G_GNUC_INTERNAL
+guint _gst_byte_reader_skip_start_code_free_avx2 (const guint8 * data,
+    guint size);
+
+#endif /* GST_BYTE_READER_X86_AVX2_H */
@@ -25,10 +25,24 @@
 
 #define GST_BYTE_READER_DISABLE_INLINES
 #include "gstbytereader.h"
+#include "gstbytereader-private.h"
 
 #include "gst/glib-compat-private.h"
 #include <string.h>
 
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HAVE_SSE2_SCAN 1
+#elif defined (__ARM_NEON) && defined (__aarch64__)
+#include <arm_neon.h>
+#define HAVE_NEON_SCAN 1
+#endif
+
+#if defined (HAVE_AVX2) && (defined (__GNUC__) || defined (__clang__))
+#include "gstbytereader-x86-avx2.h"
+#define HAVE_AVX2_SCAN 1
+#endif
+
 /**
  * SECTION:gstbytereader
  * @title: GstByteReader
@@ -864,7 +878,7 @@ gst_byte_reader_dup_data (GstByteReader * reader, guint size, guint8 ** val)
 
 /* Special optimized scan for mask 0xffffff00 and pattern 0x00000100 */
 static inline gint
-_scan_for_start_code (const guint8 * data, guint size)
+_scan_for_start_code_c (const guint8 * data, guint size)
 {
   guint8 *pdata = (guint8 *) data;
   guint8 *pend = (guint8 *) (data + size - 4);
@@ -885,6 +899,93 @@ _scan_for_start_code (const guint8 * data, guint size)
   return -1;
 }
 
+/* Returns the number of bytes at the start of @data that certainly contain
+ * no 00 00 01 start code, in steps of 16 bytes. Every candidate position of
+ * a block needs the three start code bytes plus the byte following them.
+ * The exact position in the first block with a match is found by the scalar
+ * code, as is anything in the last few bytes. */
+static guint
+_skip_start_code_free (const guint8 * data, guint size)
+{
+  guint i = 0;
+
+#if defined (HAVE_SSE2_SCAN)
+  const __m128i zero = _mm_setzero_si128 ();
+  const __m128i one = _mm_set1_epi8 (1);
+
+  for (; i + 16 + 3 <= size; i += 16) {
+    __m128i b0 = _mm_loadu_si128 ((const __m128i *) (data + i));
+    __m128i b1 = _mm_loadu_si128 ((const __m128i *) (data + i + 1));
+    __m128i b2 = _mm_loadu_si128 ((const __m128i *) (data + i + 2));
+    __m128i m;
+
+    m = _mm_and_si128 (_mm_cmpeq_epi8 (b0, zero), _mm_cmpeq_epi8 (b1, zero));
+    m = _mm_and_si128 (m, _mm_cmpeq_epi8 (b2, one));
+
+    if (_mm_movemask_epi8 (m) != 0)
+      break;
+  }
+#elif defined (HAVE_NEON_SCAN)
+  const uint8x16_t zero = vdupq_n_u8 (0);
+  const uint8x16_t one = vdupq_n_u8 (1);
+
+  for (; i + 16 + 3 <= size; i += 16) {
+    uint8x16_t b0 = vld1q_u8 (data + i);
+    uint8x16_t b1 = vld1q_u8 (data + i + 1);
+    uint8x16_t b2 = vld1q_u8 (data + i + 2);
+    uint8x16_t m;
+
+    m = vandq_u8 (vceqq_u8 (b0, zero), vceqq_u8 (b1, zero));
+    m = vandq_u8 (m, vceqq_u8 (b2, one));
+
+    if (vmaxvq_u8 (m) != 0)
+      break;
+  }
+#endif
+
+  return i;
+}
+
+#ifdef HAVE_AVX2_SCAN
+typedef guint (*SkipStartCodeFreeFunc) (const guint8 * data, guint size);
+
+static guint _skip_start_code_free_init (const guint8 * data, guint size);
+
+static SkipStartCodeFreeFunc skip_start_code_free = _skip_start_code_free_init;
+
+static guint
+_skip_start_code_free_init (const guint8 * data, guint size)
+{
+  SkipStartCodeFreeFunc func = _skip_start_code_free;
+
+  /* there is no CPU feature detection in core, so ask the CPU directly */
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    func = _gst_byte_reader_skip_start_code_free_avx2;
+
+  g_atomic_pointer_set (&skip_start_code_free, func);
+
+  return func (data, size);
+}
+#else
+#define skip_start_code_free _skip_start_code_free
+#endif
+
+gint
+_gst_byte_reader_scan_for_start_code (const guint8 * data, guint size)
+{
+  guint skip;
+  gint ret;
+
+  skip = skip_start_code_free (data, size);
+  if (size - skip < 4)
+    return -1;
+
+  ret = _scan_for_start_code_c (data + skip, size - skip);
+
+  return ret < 0 ? ret : ret + skip;
+}
+
 static inline guint
 _masked_scan_uint32_peek (const GstByteReader * reader,
     guint32 mask, guint32 pattern, guint offset, guint size, guint32 * value)
@@ -905,7 +1006,7 @@ _masked_scan_uint32_peek (const GstByteReader * reader,
 
   /* Handle special case found in MPEG and H264 */
   if ((pattern == 0x00000100) && (mask == 0xffffff00)) {
-    gint ret = _scan_for_start_code (data, size);
+    gint ret = _gst_byte_reader_scan_for_start_code (data, size);
 
     if (ret == -1)
       return ret;
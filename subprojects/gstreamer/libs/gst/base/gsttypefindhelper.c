@@ -41,6 +41,84 @@
 
 #include "gsttypefindhelper.h"
 
+/* ************************ magic bytes index ***************************** */
+
+/* Typefinders don't declare the bytes they look for, so we learn them: the
+ * first bytes of a stream that a typefinder identified with maximum
+ * probability are remembered, and the next stream starting with the same
+ * bytes tries that typefinder first. With a lot of typefinders installed
+ * this avoids running most of them for common formats. */
+#define MAGIC_SIZE 4
+#define MAGIC_INDEX_MAX_ENTRIES 256
+
+static GMutex magic_index_lock;
+static GHashTable *magic_index = NULL;
+
+static const gchar *
+magic_index_lookup (guint32 magic)
+{
+  const gchar *name = NULL;
+
+  g_mutex_lock (&magic_index_lock);
+  if (magic_index)
+    name = g_hash_table_lookup (magic_index, GUINT_TO_POINTER (magic));
+  g_mutex_unlock (&magic_index_lock);
+
+  return name;
+}
+
+static void
+magic_index_remember (GstObject * obj, const guint8 * data, gsize size,
+    GstTypeFindFactory * factory)
+{
+  guint32 magic;
+
+  if (data == NULL || size < MAGIC_SIZE || factory == NULL)
+    return;
+
+  magic = GST_READ_UINT32_BE (data);
+
+  GST_LOG_OBJECT (obj, "remembering typefinder %s for magic 0x%08x",
+      GST_OBJECT_NAME (factory), magic);
+
+  g_mutex_lock (&magic_index_lock);
+  if (magic_index == NULL)
+    magic_index = g_hash_table_new (NULL, NULL);
+  else if (g_hash_table_size (magic_index) >= MAGIC_INDEX_MAX_ENTRIES)
+    g_hash_table_remove_all (magic_index);
+  /* factory names are kept as interned strings, so the index never refers to
+   * a factory that might have been removed from the registry */
+  g_hash_table_insert (magic_index, GUINT_TO_POINTER (magic),
+      (gpointer) g_intern_string (GST_OBJECT_NAME (factory)));
+  g_mutex_unlock (&magic_index_lock);
+}
+
+static GList *
+prioritize_magic (GstObject * obj, GList * type_list, const guint8 * data,
+    gsize size)
+{
+  const gchar *name;
+  GList *l;
+
+  if (data == NULL || size < MAGIC_SIZE)
+    return type_list;
+
+  name = magic_index_lookup (GST_READ_UINT32_BE (data));
+  if (name == NULL)
+    return type_list;
+
+  for (l = type_list; l; l = l->next) {
+    if (strcmp (GST_OBJECT_NAME (l->data), name) == 0) {
+      GST_LOG_OBJECT (obj, "moving typefind %s for magic to head", name);
+      type_list = g_list_remove_link (type_list, l);
+      type_list = g_list_concat (l, type_list);
+      break;
+    }
+  }
+
+  return type_list;
+}
+
 /* ********************** typefinding in pull mode ************************ */
 
 static void
@@ -49,6 +127,7 @@ helper_find_suggest (gpointer data, guint probability, GstCaps * caps);
 typedef struct
 {
   GstBuffer *buffer;
+  guint64 offset;
   GstMapInfo map;
 } GstMappedBuffer;
 
@@ -66,6 +145,30 @@ typedef struct
   GstFlowReturn flow_ret;
 } GstTypeFindHelper;
 
+/* keeps the buffer list sorted by end offset, highest first */
+static void
+helper_insert_buffer (GstTypeFindHelper * helper, GstMappedBuffer * bmap)
+{
+  guint64 end = bmap->offset + bmap->map.size;
+  GSList *walk;
+  gint pos = 0;
+
+  for (walk = helper->buffers; walk; walk = walk->next, pos++) {
+    GstMappedBuffer *bmp = (GstMappedBuffer *) walk->data;
+
+    if (bmp->offset + bmp->map.size <= end)
+      break;
+  }
+  helper->buffers = g_slist_insert (helper->buffers, bmap, pos);
+  helper->last_offset = MAX (helper->last_offset, end);
+}
+
+static const gchar *
+helper_factory_name (GstTypeFindHelper * helper)
+{
+  return helper->factory ? GST_OBJECT_NAME (helper->factory) : "helper";
+}
+
 /*
  * helper_find_peek:
  * @data: helper data struct
@@ -84,7 +187,9 @@ helper_find_peek (gpointer data, gint64 offset, guint size)
 {
   GstTypeFindHelper *helper;
   GstBuffer *buffer;
-  GSList *insert_pos = NULL;
+  GstMappedBuffer *head = NULL;
+  guint64 head_end = 0;
+  guint64 pull_offset, pull_size;
   gsize buf_size;
   guint64 buf_offset;
   GstMappedBuffer *bmap;
@@ -95,7 +200,7 @@ helper_find_peek (gpointer data, gint64 offset, guint size)
   helper = (GstTypeFindHelper *) data;
 
   GST_LOG_OBJECT (helper->obj, "'%s' called peek (%" G_GINT64_FORMAT
-      ", %u)", GST_OBJECT_NAME (helper->factory), offset, size);
+      ", %u)", helper_factory_name (helper), offset, size);
 
   if (size == 0)
     return NULL;
@@ -108,40 +213,47 @@ helper_find_peek (gpointer data, gint64 offset, guint size)
   }
 
   /* see if we have a matching buffer already in our list */
-  if (size > 0 && offset <= helper->last_offset) {
+  if (offset < helper->last_offset) {
     GSList *walk;
 
     for (walk = helper->buffers; walk; walk = walk->next) {
       GstMappedBuffer *bmp = (GstMappedBuffer *) walk->data;
-      GstBuffer *buf = GST_BUFFER_CAST (bmp->buffer);
-
-      buf_offset = GST_BUFFER_OFFSET (buf);
-      buf_size = bmp->map.size;
-
-      /* buffers are kept sorted by end offset (highest first) in the list, so
-       * at this point we save the current position and stop searching if
-       * we're after the searched end offset */
-      if (buf_offset <= offset) {
-        if ((offset + size) < (buf_offset + buf_size)) {
-          /* must already have been mapped before */
-          return (guint8 *) bmp->map.data + (offset - buf_offset);
-        }
-      } else if (offset + size >= buf_offset + buf_size) {
-        insert_pos = walk;
-        break;
+      guint64 buf_end = bmp->offset + bmp->map.size;
+
+      if (bmp->offset > offset || offset >= buf_end)
+        continue;
+
+      if (offset + size <= buf_end) {
+        /* must already have been mapped before */
+        return (guint8 *) bmp->map.data + (offset - bmp->offset);
+      }
+
+      /* the buffer covers the start of the requested range, only the rest
+       * needs to be pulled */
+      if (buf_end > head_end) {
+        head = bmp;
+        head_end = buf_end;
       }
     }
   }
 
-  buffer = NULL;
   /* some typefinders go in 1 byte steps over 1k of data and request
    * small buffers. It is really inefficient to pull each time, and pulling
    * a larger chunk is almost free. Trying to pull a larger chunk at the end
    * of the file is also not a problem here, we'll just get a truncated buffer
    * in that case (and we'll have to double-check the size we actually get
    * anyway, see below) */
+  if (head) {
+    pull_offset = head_end;
+    pull_size = MAX (offset + size - head_end, 4096);
+  } else {
+    pull_offset = offset;
+    pull_size = MAX (size, 4096);
+  }
+
+  buffer = NULL;
   helper->flow_ret =
-      helper->func (helper->obj, helper->parent, offset, MAX (size, 4096),
+      helper->func (helper->obj, helper->parent, pull_offset, pull_size,
       &buffer);
 
   if (helper->flow_ret != GST_FLOW_OK)
@@ -162,9 +274,27 @@ helper_find_peek (gpointer data, gint64 offset, guint size)
   }
 #endif
 
+  buf_offset = GST_BUFFER_OFFSET (buffer);
+
+  if (buf_offset != -1 && buf_offset != pull_offset) {
+    GST_DEBUG ("dropping buffer with unexpected offset %" G_GUINT64_FORMAT ", "
+        "expected offset was %" G_GUINT64_FORMAT, buf_offset, pull_offset);
+    gst_buffer_unref (buffer);
+    return NULL;
+  }
+
+  if (head) {
+    GstBuffer *merged;
+
+    /* prepend the part of the cached buffer we already have instead of
+     * pulling the overlapping range again */
+    merged = gst_buffer_copy_region (head->buffer, GST_BUFFER_COPY_MEMORY,
+        offset - head->offset, head_end - offset);
+    buffer = gst_buffer_append (merged, buffer);
+  }
+
   /* getrange might silently return shortened buffers at the end of a file,
    * we must, however, always return either the full requested data or %NULL */
-  buf_offset = GST_BUFFER_OFFSET (buffer);
   buf_size = gst_buffer_get_size (buffer);
 
   if (buf_size < size) {
@@ -174,29 +304,14 @@ helper_find_peek (gpointer data, gint64 offset, guint size)
     return NULL;
   }
 
-  if (buf_offset != -1 && buf_offset != offset) {
-    GST_DEBUG ("dropping buffer with unexpected offset %" G_GUINT64_FORMAT ", "
-        "expected offset was %" G_GUINT64_FORMAT, buf_offset, offset);
-    gst_buffer_unref (buffer);
-    return NULL;
-  }
-
   bmap = g_slice_new0 (GstMappedBuffer);
 
   if (!gst_buffer_map (buffer, &bmap->map, GST_MAP_READ))
     goto map_failed;
 
   bmap->buffer = buffer;
-
-  if (insert_pos) {
-    helper->buffers = g_slist_insert_before (helper->buffers, insert_pos, bmap);
-  } else {
-    /* if insert_pos is not set, our offset is bigger than the largest offset
-     * we have so far; since we keep the list sorted with highest offsets
-     * first, we need to prepend the buffer to the list */
-    helper->last_offset = GST_BUFFER_OFFSET (buffer) + buf_size;
-    helper->buffers = g_slist_prepend (helper->buffers, bmap);
-  }
+  bmap->offset = offset;
+  helper_insert_buffer (helper, bmap);
 
   return bmap->map.data;
 
@@ -230,7 +345,7 @@ helper_find_suggest (gpointer data, guint probability, GstCaps * caps)
 
   GST_LOG_OBJECT (helper->obj,
       "'%s' called suggest (%u, %" GST_PTR_FORMAT ")",
-      GST_OBJECT_NAME (helper->factory), probability, caps);
+      helper_factory_name (helper), probability, caps);
 
   if (probability > helper->best_probability) {
     gst_caps_replace (&helper->caps, caps);
@@ -244,7 +359,7 @@ helper_find_get_length (gpointer data)
   GstTypeFindHelper *helper = (GstTypeFindHelper *) data;
 
   GST_LOG_OBJECT (helper->obj, "'%s' called get_length, returning %"
-      G_GUINT64_FORMAT, GST_OBJECT_NAME (helper->factory), helper->size);
+      G_GUINT64_FORMAT, helper_factory_name (helper), helper->size);
 
   return helper->size;
 }
@@ -382,6 +497,7 @@ gst_type_find_helper_get_range_full (GstObject * obj, GstObject * parent,
   GSList *walk;
   GList *l, *type_list;
   GstCaps *result = NULL;
+  const guint8 *magic;
 
   g_return_val_if_fail (GST_IS_OBJECT (obj), GST_FLOW_ERROR);
   g_return_val_if_fail (func != NULL, GST_FLOW_ERROR);
@@ -398,6 +514,7 @@ gst_type_find_helper_get_range_full (GstObject * obj, GstObject * parent,
   helper.obj = obj;
   helper.parent = parent;
   helper.flow_ret = GST_FLOW_OK;
+  helper.factory = NULL;
 
   find.data = &helper;
   find.peek = helper_find_peek;
@@ -409,8 +526,13 @@ gst_type_find_helper_get_range_full (GstObject * obj, GstObject * parent,
     find.get_length = helper_find_get_length;
   }
 
+  /* almost all typefinders look at the start of the stream, so this doesn't
+   * pull anything that isn't needed anyway */
+  magic = helper_find_peek (&helper, 0, MAGIC_SIZE);
+
   type_list = gst_type_find_factory_get_list ();
   type_list = prioritize_extension (obj, type_list, extension);
+  type_list = prioritize_magic (obj, type_list, magic, magic ? MAGIC_SIZE : 0);
 
   for (l = type_list; l; l = l->next) {
     helper.factory = GST_TYPE_FIND_FACTORY (l->data);
@@ -419,6 +541,8 @@ gst_type_find_helper_get_range_full (GstObject * obj, GstObject * parent,
       /* Any other flow return can be ignored here, we found
        * something before any error with highest probability */
       helper.flow_ret = GST_FLOW_OK;
+      magic_index_remember (obj, magic, magic ? MAGIC_SIZE : 0,
+          helper.factory);
       break;
     } else if (helper.flow_ret != GST_FLOW_OK
         && helper.flow_ret != GST_FLOW_EOS) {
@@ -660,12 +784,15 @@ gst_type_find_helper_for_data_with_extension (GstObject * obj,
 
   type_list = gst_type_find_factory_get_list ();
   type_list = prioritize_extension (obj, type_list, extension);
+  type_list = prioritize_magic (obj, type_list, data, size);
 
   for (l = type_list; l; l = l->next) {
     helper.factory = GST_TYPE_FIND_FACTORY (l->data);
     gst_type_find_factory_call_function (helper.factory, &find);
-    if (helper.best_probability >= GST_TYPE_FIND_MAXIMUM)
+    if (helper.best_probability >= GST_TYPE_FIND_MAXIMUM) {
+      magic_index_remember (obj, data, size, helper.factory);
       break;
+    }
   }
   gst_plugin_feature_list_free (type_list);
 
@@ -86,6 +86,11 @@ static GParamSpec *properties[PROP_LAST];
 
 /* mapping functions */
 
+/* maps a block of control-values to the target plain data type, values that
+ * are NAN are skipped and leave the target untouched */
+typedef void (*GstDirectControlBindingConvertValues) (GstDirectControlBinding *
+    self, const gdouble * src_values, guint n_values, gpointer dest_values);
+
 #define DEFINE_CONVERT(type,Type,TYPE,ROUNDING_OP) \
 static void \
 convert_g_value_to_##type (GstDirectControlBinding *self, gdouble s, GValue *d) \
@@ -121,6 +126,36 @@ abs_convert_value_to_##type (GstDirectControlBinding *self, gdouble s, gpointer
 { \
   g##type *d = (g##type *)d_; \
   *d = (g##type) ROUNDING_OP (s); \
+} \
+\
+static void \
+convert_values_to_##type (GstDirectControlBinding *self, const gdouble *s, guint n, gpointer d_) \
+{ \
+  GParamSpec##Type *pspec = G_PARAM_SPEC_##TYPE (((GstControlBinding *)self)->pspec); \
+  gdouble min = pspec->minimum, max = pspec->maximum; \
+  g##type *d = (g##type *)d_; \
+  guint i; \
+  \
+  for (i = 0; i < n; i++) { \
+    gdouble v; \
+    \
+    if (isnan (s[i])) \
+      continue; \
+    v = CLAMP (s[i], 0.0, 1.0); \
+    d[i] = (g##type) ROUNDING_OP (min * (1-v)) + (g##type) ROUNDING_OP (max * v); \
+  } \
+} \
+\
+static void \
+abs_convert_values_to_##type (GstDirectControlBinding *self, const gdouble *s, guint n, gpointer d_) \
+{ \
+  g##type *d = (g##type *)d_; \
+  guint i; \
+  \
+  for (i = 0; i < n; i++) { \
+    if (!isnan (s[i])) \
+      d[i] = (g##type) ROUNDING_OP (s[i]); \
+  } \
 }
 
 DEFINE_CONVERT (int, Int, INT, rint);
@@ -244,10 +279,12 @@ gst_direct_control_binding_constructor (GType type, guint n_construct_params,
     if (self->ABI.abi.want_absolute) { \
         self->convert_g_value = abs_convert_g_value_to_##type; \
         self->convert_value = abs_convert_value_to_##type; \
+        self->ABI.abi.convert_values = abs_convert_values_to_##type; \
     } \
     else { \
         self->convert_g_value = convert_g_value_to_##type; \
         self->convert_value = convert_value_to_##type; \
+        self->ABI.abi.convert_values = convert_values_to_##type; \
     } \
     self->byte_size = sizeof (g##type);
 
@@ -432,6 +469,7 @@ gst_direct_control_binding_get_value_array (GstControlBinding * _self,
   gdouble *src_val;
   gboolean res = FALSE;
   GstDirectControlBindingConvertValue convert;
+  GstDirectControlBindingConvertValues convert_values;
   gint byte_size;
   guint8 *values = (guint8 *) values_;
 
@@ -442,20 +480,26 @@ gst_direct_control_binding_get_value_array (GstControlBinding * _self,
   g_return_val_if_fail (GST_CONTROL_BINDING_PSPEC (self), FALSE);
 
   convert = self->convert_value;
+  convert_values = self->ABI.abi.convert_values;
   byte_size = self->byte_size;
 
   src_val = g_new0 (gdouble, n_values);
   if ((res = gst_control_source_get_value_array (self->cs, timestamp,
               interval, n_values, src_val))) {
-    for (i = 0; i < n_values; i++) {
-      /* we will only get NAN for sparse control sources, such as triggers */
-      if (!isnan (src_val[i])) {
-        convert (self, src_val[i], (gpointer) values);
-      } else {
-        GST_LOG ("no control value for property %s at index %d", _self->name,
-            i);
+    /* numeric types are converted as a whole block */
+    if (convert_values) {
+      convert_values (self, src_val, n_values, values_);
+    } else {
+      for (i = 0; i < n_values; i++) {
+        /* we will only get NAN for sparse control sources, such as triggers */
+        if (!isnan (src_val[i])) {
+          convert (self, src_val[i], (gpointer) values);
+        } else {
+          GST_LOG ("no control value for property %s at index %d",
+              _self->name, i);
+        }
+        values += byte_size;
       }
-      values += byte_size;
     }
   } else {
     GST_LOG ("failed to get control value for property %s at ts %"
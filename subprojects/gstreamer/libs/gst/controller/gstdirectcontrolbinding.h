@@ -90,6 +90,7 @@ struct _GstDirectControlBinding {
     gpointer _gst_reserved[GST_PADDING];
     struct {
       gboolean want_absolute;
+      gpointer convert_values;
     } abi;
   } ABI;
 };
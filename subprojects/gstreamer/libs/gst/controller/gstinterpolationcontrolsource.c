@@ -105,6 +105,65 @@ _get_nearest_control_points2 (GstTimedValueControlSource * self,
   }
 }
 
+/* Fills @n values of one segment between two control points, starting at
+ * @ts. Called with the lock held and @cp1 set, @cp2 can be %NULL. */
+typedef void (*InterpolateSegmentFunc) (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime ts,
+    GstClockTime interval, guint n, gdouble * values);
+
+/* number of values starting at @ts that fall before @next_ts */
+static inline guint
+_get_segment_length (GstClockTime ts, GstClockTime interval,
+    GstClockTime next_ts, guint n_remaining)
+{
+  guint64 n;
+
+  if (!GST_CLOCK_TIME_IS_VALID (next_ts) || interval == 0)
+    return n_remaining;
+
+  n = (next_ts - ts + interval - 1) / interval;
+  return MIN (n, n_remaining);
+}
+
+/* Looks up the control points only once per segment and lets @fill compute
+ * all values of the segment in one go instead of per value */
+static gboolean
+_get_value_array_segmented (GstTimedValueControlSource * self,
+    GstClockTime timestamp, GstClockTime interval, guint n_values,
+    gdouble * values, InterpolateSegmentFunc fill)
+{
+  gboolean ret = FALSE;
+  guint i = 0, j, n;
+  GstClockTime ts = timestamp;
+  GstClockTime next_ts;
+  GstControlPoint *cp1, *cp2;
+
+  g_mutex_lock (&self->lock);
+
+  while (i < n_values) {
+    _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
+    n = _get_segment_length (ts, interval, next_ts, n_values - i);
+
+    GST_LOG ("values[%3u..%3u] : ts=%" GST_TIME_FORMAT ", next_ts=%"
+        GST_TIME_FORMAT, i, i + n - 1, GST_TIME_ARGS (ts),
+        GST_TIME_ARGS (next_ts));
+
+    if (cp1) {
+      fill (self, cp1, cp2, ts, interval, n, values + i);
+      ret = TRUE;
+    } else {
+      for (j = 0; j < n; j++)
+        values[i + j] = NAN;
+    }
+
+    i += n;
+    ts += n * interval;
+  }
+
+  g_mutex_unlock (&self->lock);
+  return ret;
+}
+
 
 /*  steps-like (no-)interpolation, default */
 /*  just returns the value for the most recent key-frame */
@@ -135,38 +194,25 @@ interpolate_none_get (GstTimedValueControlSource * self, GstClockTime timestamp,
   return ret;
 }
 
+static void
+_interpolate_none_segment (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime ts,
+    GstClockTime interval, guint n, gdouble * values)
+{
+  gdouble value = _interpolate_none (self, cp1);
+  guint i;
+
+  for (i = 0; i < n; i++)
+    values[i] = value;
+}
+
 static gboolean
 interpolate_none_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gdouble * values)
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    if (ts >= next_ts) {
-      _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
-    }
-    if (cp1) {
-      *values = _interpolate_none (self, cp1);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, *values);
-    } else {
-      *values = NAN;
-      GST_LOG ("values[%3d]=-", i);
-    }
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
+  return _get_value_array_segmented (self, timestamp, interval, n_values,
+      values, _interpolate_none_segment);
 }
 
 
@@ -207,40 +253,37 @@ interpolate_linear_get (GstTimedValueControlSource * self,
   return ret;
 }
 
+static void
+_interpolate_linear_segment (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime ts,
+    GstClockTime interval, guint n, gdouble * values)
+{
+  gdouble value1 = cp1->value;
+  gdouble slope, diff, step;
+  guint i;
+
+  if (!cp2) {
+    for (i = 0; i < n; i++)
+      values[i] = value1;
+    return;
+  }
+
+  slope = (cp2->value - value1) /
+      gst_guint64_to_gdouble (cp2->timestamp - cp1->timestamp);
+  diff = gst_guint64_to_gdouble (ts - cp1->timestamp);
+  step = gst_guint64_to_gdouble (interval);
+
+  for (i = 0; i < n; i++)
+    values[i] = value1 + (diff + i * step) * slope;
+}
+
 static gboolean
 interpolate_linear_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gdouble * values)
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    if (ts >= next_ts) {
-      _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
-    }
-    if (cp1) {
-      *values = _interpolate_linear (cp1->timestamp, cp1->value,
-          (cp2 ? cp2->timestamp : GST_CLOCK_TIME_NONE),
-          (cp2 ? cp2->value : 0.0), ts);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, *values);
-    } else {
-      *values = NAN;
-      GST_LOG ("values[%3d]=-", i);
-    }
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
+  return _get_value_array_segmented (self, timestamp, interval, n_values,
+      values, _interpolate_linear_segment);
 }
 
 
@@ -392,43 +435,56 @@ interpolate_cubic_get (GstTimedValueControlSource * self,
   return ret;
 }
 
+static void
+_interpolate_cubic_segment (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime ts,
+    GstClockTime interval, guint n, gdouble * values)
+{
+  gdouble h, z1, z2, c1, c2, span, diff, step;
+  guint i;
+
+  if (!self->valid_cache) {
+    _interpolate_cubic_update_cache (self);
+    self->valid_cache = TRUE;
+  }
+
+  if (!cp2) {
+    for (i = 0; i < n; i++)
+      values[i] = cp1->value;
+    return;
+  }
+
+  /* same as _interpolate_cubic() with everything that only depends on the
+   * control points hoisted out of the loop */
+  h = cp1->cache.cubic.h;
+  z1 = cp1->cache.cubic.z / h;
+  z2 = cp2->cache.cubic.z / h;
+  c1 = cp1->value / h - h * cp1->cache.cubic.z;
+  c2 = cp2->value / h - h * cp2->cache.cubic.z;
+  span = gst_guint64_to_gdouble (cp2->timestamp - cp1->timestamp);
+  diff = gst_guint64_to_gdouble (ts - cp1->timestamp);
+  step = gst_guint64_to_gdouble (interval);
+
+  for (i = 0; i < n; i++) {
+    gdouble diff1 = diff + i * step;
+    gdouble diff2 = span - diff1;
+
+    values[i] = z2 * diff1 * diff1 * diff1 + z1 * diff2 * diff2 * diff2 +
+        c2 * diff1 + c1 * diff2;
+  }
+}
+
 static gboolean
 interpolate_cubic_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gdouble * values)
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
   if (self->nvalues <= 2)
     return interpolate_linear_get_value_array (self, timestamp, interval,
         n_values, values);
 
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    if (ts >= next_ts) {
-      _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
-    }
-    if (cp1) {
-      *values = _interpolate_cubic (self, cp1, cp1->value, cp2,
-          (cp2 ? cp2->value : 0.0), ts);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, *values);
-    } else {
-      *values = NAN;
-      GST_LOG ("values[%3d]=-", i);
-    }
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
+  return _get_value_array_segmented (self, timestamp, interval, n_values,
+      values, _interpolate_cubic_segment);
 }
 
 
@@ -561,43 +617,50 @@ interpolate_cubic_monotonic_get (GstTimedValueControlSource * self,
   return ret;
 }
 
+static void
+_interpolate_cubic_monotonic_segment (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime ts,
+    GstClockTime interval, guint n, gdouble * values)
+{
+  gdouble value1 = cp1->value;
+  gdouble c1s, c2s, c3s, diff, step;
+  guint i;
+
+  if (!self->valid_cache) {
+    _interpolate_cubic_monotonic_update_cache (self);
+    self->valid_cache = TRUE;
+  }
+
+  if (!cp2) {
+    for (i = 0; i < n; i++)
+      values[i] = value1;
+    return;
+  }
+
+  c1s = cp1->cache.cubic_monotonic.c1s;
+  c2s = cp1->cache.cubic_monotonic.c2s;
+  c3s = cp1->cache.cubic_monotonic.c3s;
+  diff = gst_guint64_to_gdouble (ts - cp1->timestamp);
+  step = gst_guint64_to_gdouble (interval);
+
+  for (i = 0; i < n; i++) {
+    gdouble d = diff + i * step;
+
+    values[i] = value1 + (c1s + (c2s + c3s * d) * d) * d;
+  }
+}
+
 static gboolean
 interpolate_cubic_monotonic_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gdouble * values)
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
   if (self->nvalues <= 2)
     return interpolate_linear_get_value_array (self, timestamp, interval,
         n_values, values);
 
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    if (ts >= next_ts) {
-      _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
-    }
-    if (cp1) {
-      *values = _interpolate_cubic_monotonic (self, cp1, cp1->value, cp2,
-          (cp2 ? cp2->value : 0.0), ts);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, *values);
-    } else {
-      *values = NAN;
-      GST_LOG ("values[%3d]=-", i);
-    }
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
+  return _get_value_array_segmented (self, timestamp, interval, n_values,
+      values, _interpolate_cubic_monotonic_segment);
 }
 
 
@@ -26,6 +26,10 @@
  * everything received there to stdout, while forwarding everything received
  * on stdout to those sockets.
  * Additionally it provides the MAC address of a network interface via stdout
+ *
+ * Where SO_TIMESTAMPING is available, packets are forwarded together with the
+ * time the kernel received them, so that scheduling of this process and the
+ * pipe to the PTP clock do not add jitter to the receive times.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -56,6 +60,12 @@
 #include <sys/capability.h>
 #endif
 
+#ifdef HAVE_SO_TIMESTAMPING
+#include <time.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+#endif
+
 #include <glib.h>
 #include <gio/gio.h>
 
@@ -85,28 +95,121 @@ static GSocketAddress *event_saddr, *general_saddr;
 static GSocket *socket_event, *socket_general;
 static GIOChannel *stdin_channel, *stdout_channel;
 
+#ifdef HAVE_SO_TIMESTAMPING
+static gboolean have_timestamping = FALSE;
+
+static gboolean
+enable_timestamping (GSocket * socket)
+{
+  gint flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+
+  if (setsockopt (g_socket_get_fd (socket), SOL_SOCKET, SO_TIMESTAMPING,
+          &flags, sizeof (flags)) != 0) {
+    g_warning ("Couldn't enable receive timestamps: %s", g_strerror (errno));
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Receives one packet and converts its kernel receive time from
+ * CLOCK_REALTIME to CLOCK_MONOTONIC, which is what the PTP clock observes
+ * its system clock with. @timestamp is 0 if there was no receive time */
+static gssize
+receive_timestamped (GSocket * socket, gchar * buffer, gsize size,
+    guint64 * timestamp)
+{
+  struct iovec iov;
+  union
+  {
+    struct cmsghdr hdr;
+    gchar buf[CMSG_SPACE (sizeof (struct scm_timestamping))];
+  } control;
+  struct msghdr msg = { 0, };
+  struct cmsghdr *cmsg;
+  gssize read;
+
+  iov.iov_base = buffer;
+  iov.iov_len = size;
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = &control;
+  msg.msg_controllen = sizeof (control);
+
+  do {
+    read = recvmsg (g_socket_get_fd (socket), &msg, 0);
+  } while (read == -1 && errno == EINTR);
+  if (read == -1)
+    g_error ("Failed to read from socket: %s", g_strerror (errno));
+
+  *timestamp = 0;
+  for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+    struct scm_timestamping ts;
+    struct timespec realtime, monotonic;
+    gint64 age;
+
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SO_TIMESTAMPING)
+      continue;
+
+    /* Software timestamp is in the first slot */
+    memcpy (&ts, CMSG_DATA (cmsg), sizeof (ts));
+    if (ts.ts[0].tv_sec == 0 && ts.ts[0].tv_nsec == 0)
+      break;
+
+    clock_gettime (CLOCK_MONOTONIC, &monotonic);
+    clock_gettime (CLOCK_REALTIME, &realtime);
+    age = (gint64) GST_TIMESPEC_TO_TIME (realtime) -
+        (gint64) GST_TIMESPEC_TO_TIME (ts.ts[0]);
+
+    /* Ignore timestamps that went through a wall clock step */
+    if (age >= 0 && age < GST_SECOND)
+      *timestamp = GST_TIMESPEC_TO_TIME (monotonic) - age;
+    break;
+  }
+
+  return read;
+}
+#endif
+
 static gboolean
 have_socket_data_cb (GSocket * socket, GIOCondition condition,
     gpointer user_data)
 {
-  gchar buffer[8192];
+  /* Room for the receive time in front of the packet */
+  gchar buffer[8 + 8192];
+  gchar *data = buffer + 8;
+  guint64 timestamp = 0;
   gssize read;
   gsize written;
   GError *err = NULL;
   GIOStatus status;
   StdIOHeader header = { 0, };
 
-  read = g_socket_receive (socket, buffer, sizeof (buffer), NULL, &err);
-  if (read == -1)
-    g_error ("Failed to read from socket: %s", err->message);
-  g_clear_error (&err);
+#ifdef HAVE_SO_TIMESTAMPING
+  if (have_timestamping) {
+    read = receive_timestamped (socket, data, 8192, &timestamp);
+  } else
+#endif
+  {
+    read = g_socket_receive (socket, data, 8192, NULL, &err);
+    if (read == -1)
+      g_error ("Failed to read from socket: %s", err->message);
+    g_clear_error (&err);
+  }
 
   if (verbose)
     g_message ("Received %" G_GSSIZE_FORMAT " bytes from %s socket", read,
         (socket == socket_event ? "event" : "general"));
 
+  if (timestamp != 0) {
+    GST_WRITE_UINT64_BE (buffer, timestamp);
+    data = buffer;
+    read += 8;
+    header.type = TYPE_TIMESTAMPED;
+  } else {
+    header.type = (socket == socket_event) ? TYPE_EVENT : TYPE_GENERAL;
+  }
   header.size = read;
-  header.type = (socket == socket_event) ? TYPE_EVENT : TYPE_GENERAL;
 
   status =
       g_io_channel_write_chars (stdout_channel, (gchar *) & header,
@@ -124,7 +227,7 @@ have_socket_data_cb (GSocket * socket, GIOCondition condition,
   }
 
   status =
-      g_io_channel_write_chars (stdout_channel, buffer, read, &written, &err);
+      g_io_channel_write_chars (stdout_channel, data, read, &written, &err);
   if (status == G_IO_STATUS_ERROR) {
     g_error ("Failed to write to stdout: %s", err->message);
     g_clear_error (&err);
@@ -246,6 +349,11 @@ setup_sockets (void)
   g_object_unref (bind_saddr);
   g_object_unref (bind_addr);
 
+#ifdef HAVE_SO_TIMESTAMPING
+  have_timestamping = enable_timestamping (socket_event)
+      && enable_timestamping (socket_general);
+#endif
+
   /* Probe all non-loopback interfaces */
   if (!ifaces) {
 #if defined(HAVE_SIOCGIFCONF_SIOCGIFFLAGS_SIOCGIFHWADDR)
@@ -32,6 +32,9 @@
  * query the exposed clock over the network for its values.
  *
  * The #GstNetTimeProvider typically wraps the clock used by a #GstPipeline.
+ *
+ * Requests from many clients are received and answered in batches, with a
+ * single system call each way where the platform supports it.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -49,6 +52,10 @@ GST_DEBUG_CATEGORY_STATIC (ntp_debug);
 #define DEFAULT_PORT            5637
 #define DEFAULT_QOS_DSCP        -1
 
+/* Maximum number of requests received and answered with a single
+ * g_socket_receive_messages() / g_socket_send_messages() call */
+#define MAX_BATCH_SIZE          32
+
 #define IS_ACTIVE(self) (g_atomic_int_get (&((self)->priv->active)))
 
 enum
@@ -78,6 +85,16 @@ struct _GstNetTimeProviderPrivate
   gboolean made_cancel_fd;
 };
 
+/* A request is answered in place: the local time of the client is sent back
+ * unchanged, followed by the time of our clock */
+typedef struct
+{
+  guint8 data[GST_NET_TIME_PACKET_SIZE];
+  GInputVector in_vec;
+  GOutputVector out_vec;
+  GSocketAddress *addr;
+} GstNetTimeProviderSlot;
+
 static void gst_net_time_provider_initable_iface_init (gpointer g_iface);
 
 static gboolean gst_net_time_provider_start (GstNetTimeProvider * bself,
@@ -169,13 +186,45 @@ gst_net_time_provider_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+/* Receives all requests that are queued on the socket right now, up to
+ * MAX_BATCH_SIZE. The socket is non-blocking. Returns the number of requests
+ * or -1 on error */
+static gint
+gst_net_time_provider_receive_batch (GSocket * socket, GCancellable * cancel,
+    GstNetTimeProviderSlot * slots, GInputMessage * msgs, GError ** err)
+{
+  guint i;
+
+  for (i = 0; i < MAX_BATCH_SIZE; i++) {
+    GstNetTimeProviderSlot *slot = &slots[i];
+    GInputMessage *msg = &msgs[i];
+
+    slot->addr = NULL;
+    slot->in_vec.buffer = slot->data;
+    slot->in_vec.size = GST_NET_TIME_PACKET_SIZE;
+
+    msg->address = &slot->addr;
+    msg->vectors = &slot->in_vec;
+    msg->num_vectors = 1;
+    msg->bytes_received = 0;
+    msg->flags = G_SOCKET_MSG_NONE;
+    msg->control_messages = NULL;
+    msg->num_control_messages = NULL;
+  }
+
+  return g_socket_receive_messages (socket, msgs, MAX_BATCH_SIZE,
+      G_SOCKET_MSG_NONE, cancel, err);
+}
+
 static gpointer
 gst_net_time_provider_thread (gpointer data)
 {
   GstNetTimeProvider *self = data;
   GCancellable *cancel = self->priv->cancel;
   GSocket *socket = self->priv->socket;
-  GstNetTimePacket *packet;
+  GstNetTimeProviderSlot slots[MAX_BATCH_SIZE];
+  GInputMessage in_msgs[MAX_BATCH_SIZE];
+  GOutputMessage out_msgs[MAX_BATCH_SIZE];
   GError *err = NULL;
   gint cur_qos_dscp = DEFAULT_QOS_DSCP;
   gint new_qos_dscp;
@@ -183,8 +232,8 @@ gst_net_time_provider_thread (gpointer data)
   GST_INFO_OBJECT (self, "time provider thread is running");
 
   while (TRUE) {
-    GSocketAddress *sender_addr = NULL;
-
+    gint n_received, i;
+    guint n_replies;
 
     GST_LOG_OBJECT (self, "waiting on socket");
     if (!g_socket_condition_wait (socket, G_IO_IN, cancel, &err)) {
@@ -201,16 +250,24 @@ gst_net_time_provider_thread (gpointer data)
     }
 
     /* got data in */
-    packet = gst_net_time_packet_receive (socket, &sender_addr, &err);
+    n_received = gst_net_time_provider_receive_batch (socket, cancel, slots,
+        in_msgs, &err);
 
-    if (err != NULL) {
-      GST_DEBUG_OBJECT (self, "receive error: %s", err->message);
-      g_usleep (G_USEC_PER_SEC / 10);
+    if (n_received < 0) {
+      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        break;
+
+      if (!g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+        GST_DEBUG_OBJECT (self, "receive error: %s", err->message);
+        g_usleep (G_USEC_PER_SEC / 10);
+      }
       g_error_free (err);
       err = NULL;
       continue;
     }
 
+    GST_LOG_OBJECT (self, "received %d requests", n_received);
+
     /* before next sending check if need to change QoS */
     new_qos_dscp = self->priv->qos_dscp;
     if (cur_qos_dscp != new_qos_dscp &&
@@ -219,15 +276,51 @@ gst_net_time_provider_thread (gpointer data)
       cur_qos_dscp = new_qos_dscp;
     }
 
+    n_replies = 0;
     if (IS_ACTIVE (self)) {
-      /* do what we were asked to and send the packet back */
-      packet->remote_time = gst_clock_get_time (self->priv->clock);
+      for (i = 0; i < n_received; i++) {
+        GstNetTimeProviderSlot *slot = &slots[i];
+        GOutputMessage *msg = &out_msgs[n_replies];
+
+        if (slot->addr == NULL
+            || in_msgs[i].bytes_received < GST_NET_TIME_PACKET_SIZE) {
+          GST_LOG_OBJECT (self, "ignoring short time packet (%" G_GSIZE_FORMAT
+              " < %d)", in_msgs[i].bytes_received, GST_NET_TIME_PACKET_SIZE);
+          continue;
+        }
+
+        slot->out_vec.buffer = slot->data;
+        slot->out_vec.size = GST_NET_TIME_PACKET_SIZE;
+
+        msg->address = slot->addr;
+        msg->vectors = &slot->out_vec;
+        msg->num_vectors = 1;
+        msg->bytes_sent = 0;
+        msg->control_messages = NULL;
+        msg->num_control_messages = 0;
+        n_replies++;
+      }
+    }
+
+    if (n_replies > 0) {
+      GstClockTime now;
+      guint j;
+
+      /* do what we were asked to and send the packets back. All replies go
+       * out with the same syscall, so one clock reading is good for all */
+      now = gst_clock_get_time (self->priv->clock);
+      for (j = 0; j < n_replies; j++) {
+        GST_WRITE_UINT64_BE (((guint8 *) out_msgs[j].vectors[0].buffer) +
+            sizeof (GstClockTime), now);
+      }
 
       /* ignore errors */
-      gst_net_time_packet_send (packet, socket, sender_addr, NULL);
-      g_object_unref (sender_addr);
-      g_free (packet);
+      g_socket_send_messages (socket, out_msgs, n_replies, G_SOCKET_MSG_NONE,
+          NULL, NULL);
     }
+
+    for (i = 0; i < n_received; i++)
+      g_clear_object (&slots[i].addr);
   }
 
   g_error_free (err);
@@ -361,6 +454,10 @@ gst_net_time_provider_start (GstNetTimeProvider * self, GError ** error)
       self->priv->address, port);
   g_object_unref (bound_addr);
 
+  /* We wait for the socket to become readable and then only take the
+   * requests that are queued at that time */
+  g_socket_set_blocking (socket, FALSE);
+
   self->priv->socket = socket;
   self->priv->cancel = g_cancellable_new ();
   self->priv->made_cancel_fd =
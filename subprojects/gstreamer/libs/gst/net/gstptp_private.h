@@ -7,7 +7,10 @@ enum
 {
   TYPE_EVENT,
   TYPE_GENERAL,
-  TYPE_CLOCK_ID
+  TYPE_CLOCK_ID,
+  /* event or general message prefixed with the kernel receive time as
+   * big-endian CLOCK_MONOTONIC nanoseconds */
+  TYPE_TIMESTAMPED
 };
 
 typedef struct
@@ -33,7 +33,12 @@
  * required as PTP listens on ports < 1024 and thus requires special
  * privileges. Once this helper process is started, the main process will
  * synchronize to all PTP domains that are detected on the selected
- * interfaces.
+ * interfaces. All domains share the same helper process and sockets.
+ *
+ * Where the platform supports it (SO_TIMESTAMPING on Linux), the helper
+ * process forwards the time the kernel received each packet, so that
+ * scheduling delays of the helper process and the main process do not end up
+ * in the clock observations.
  *
  * gst_ptp_clock_new() then allows to create a GstClock that provides the PTP
  * time from a master clock inside a specific PTP domain. This clock will only
@@ -1798,7 +1803,7 @@ have_stdin_data_cb (GIOChannel * channel, GIOCondition condition,
 {
   GIOStatus status;
   StdIOHeader header;
-  gchar buffer[8192];
+  gchar buffer[8 + 8192];
   GError *err = NULL;
   gsize read;
 
@@ -1828,7 +1833,7 @@ have_stdin_data_cb (GIOChannel * channel, GIOCondition condition,
     GST_ERROR ("Unexpected read size: %" G_GSIZE_FORMAT, read);
     g_main_loop_quit (main_loop);
     return G_SOURCE_REMOVE;
-  } else if (header.size > 8192) {
+  } else if (header.size > sizeof (buffer)) {
     GST_ERROR ("Unexpected size: %u", header.size);
     g_main_loop_quit (main_loop);
     return G_SOURCE_REMOVE;
@@ -1866,6 +1871,27 @@ have_stdin_data_cb (GIOChannel * channel, GIOCondition condition,
       }
       break;
     }
+    case TYPE_TIMESTAMPED:{
+      GstClockTime now = gst_clock_get_time (observation_system_clock);
+      GstClockTime receive_time;
+      PtpMessage msg;
+
+      if (header.size < 8)
+        break;
+
+      /* The helper took the receive time from the kernel on the same
+       * monotonic clock, but don't trust it if it is in the future */
+      receive_time = GST_READ_UINT64_BE (buffer);
+      if (receive_time > now)
+        receive_time = now;
+
+      if (parse_ptp_message (&msg, (const guint8 *) buffer + 8,
+              header.size - 8)) {
+        dump_ptp_message (&msg);
+        handle_ptp_message (&msg, receive_time);
+      }
+      break;
+    }
     default:
     case TYPE_CLOCK_ID:{
       if (header.size != 8) {
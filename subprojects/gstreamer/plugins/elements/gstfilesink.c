@@ -38,6 +38,11 @@
 #  include "config.h"
 #endif
 
+/* for sync_file_range() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+
 #include <glib/gi18n-lib.h>
 
 #include <gst/gst.h>
@@ -111,6 +116,7 @@ GST_DEBUG_CATEGORY_STATIC (gst_file_sink_debug);
 #define DEFAULT_APPEND		FALSE
 #define DEFAULT_O_SYNC		FALSE
 #define DEFAULT_MAX_TRANSIENT_ERROR_TIMEOUT	0
+#define DEFAULT_WRITEBACK_SIZE	0
 
 enum
 {
@@ -121,6 +127,7 @@ enum
   PROP_APPEND,
   PROP_O_SYNC,
   PROP_MAX_TRANSIENT_ERROR_TIMEOUT,
+  PROP_WRITEBACK_SIZE,
   PROP_LAST
 };
 
@@ -253,6 +260,27 @@ gst_file_sink_class_init (GstFileSinkClass * klass)
           G_MAXINT, DEFAULT_MAX_TRANSIENT_ERROR_TIMEOUT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstFileSink:writeback-size
+   *
+   * Every time this many bytes were written, start the writeback of the new
+   * data to disk in the background and drop the previously written data from
+   * the page cache. This bounds the amount of dirty pages the kernel has to
+   * write back at once, which otherwise can block the streaming thread for
+   * a long time when writing many high bitrate streams, or when a buffer
+   * with the %GST_BUFFER_FLAG_SYNC_AFTER flag requires an fsync().
+   *
+   * Only supported on Linux, 0 leaves page cache handling to the kernel.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_WRITEBACK_SIZE,
+      g_param_spec_uint64 ("writeback-size", "Writeback Size",
+          "Start asynchronous writeback of the written data to disk every "
+          "this many bytes and drop it from the page cache (0 = disabled)",
+          0, G_MAXUINT64, DEFAULT_WRITEBACK_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "File Sink",
       "Sink/File", "Write stream to a file",
@@ -287,6 +315,7 @@ gst_file_sink_init (GstFileSink * filesink)
   filesink->buffer_mode = DEFAULT_BUFFER_MODE;
   filesink->buffer_size = DEFAULT_BUFFER_SIZE;
   filesink->append = FALSE;
+  filesink->writeback_size = DEFAULT_WRITEBACK_SIZE;
 
   gst_base_sink_set_sync (GST_BASE_SINK (filesink), FALSE);
 }
@@ -364,6 +393,9 @@ gst_file_sink_set_property (GObject * object, guint prop_id,
     case PROP_MAX_TRANSIENT_ERROR_TIMEOUT:
       sink->max_transient_error_timeout = g_value_get_int (value);
       break;
+    case PROP_WRITEBACK_SIZE:
+      sink->writeback_size = g_value_get_uint64 (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -395,6 +427,9 @@ gst_file_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_MAX_TRANSIENT_ERROR_TIMEOUT:
       g_value_set_int (value, sink->max_transient_error_timeout);
       break;
+    case PROP_WRITEBACK_SIZE:
+      g_value_set_uint64 (value, sink->writeback_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -419,6 +454,9 @@ gst_file_sink_open_file (GstFileSink * sink)
   /* try to seek in the file to figure out if it is seekable */
   sink->seekable = gst_file_sink_do_seek (sink, 0);
 
+  sink->writeback_pos = sink->current_pos;
+  sink->writeback_prev_len = 0;
+
   if (sink->buffer)
     g_free (sink->buffer);
   sink->buffer = NULL;
@@ -577,6 +615,11 @@ gst_file_sink_do_seek (GstFileSink * filesink, guint64 new_offset)
    * presumably this should basically yield new_offset */
   gst_file_sink_get_current_offset (filesink, &filesink->current_pos);
 
+  /* rewritten ranges will be written back with the next fsync() or by the
+   * kernel, just continue tracking from the new position */
+  filesink->writeback_pos = filesink->current_pos;
+  filesink->writeback_prev_len = 0;
+
   return TRUE;
 
   /* ERRORS */
@@ -797,6 +840,51 @@ gst_file_sink_flush_buffer (GstFileSink * filesink)
   return flow_ret;
 }
 
+/* Hands the data written since the last call over to the kernel for writeback
+ * once writeback-size bytes accumulated, and drops the range handed over the
+ * previous time from the page cache */
+static void
+gst_file_sink_writeback (GstFileSink * sink)
+{
+#if defined (HAVE_SYNC_FILE_RANGE) && defined (HAVE_POSIX_FADVISE)
+  guint64 start, len;
+  int fd;
+
+  if (sink->writeback_size == 0 || sink->current_pos < sink->writeback_pos ||
+      sink->current_pos - sink->writeback_pos < sink->writeback_size)
+    return;
+
+  fd = fileno (sink->file);
+  start = sink->writeback_pos;
+  len = sink->current_pos - start;
+
+  GST_LOG_OBJECT (sink, "starting writeback of %" G_GUINT64_FORMAT
+      " bytes at offset %" G_GUINT64_FORMAT, len, start);
+
+  if (sync_file_range (fd, start, len, SYNC_FILE_RANGE_WRITE) < 0) {
+    GST_WARNING_OBJECT (sink, "sync_file_range() failed: %s, disabling "
+        "writeback", g_strerror (errno));
+    sink->writeback_size = 0;
+    return;
+  }
+
+  /* The previous range was handed over one writeback-size ago and should be
+   * on disk by now, in which case this does not block. Once it's written we
+   * won't need it anymore so don't let it pile up in the page cache */
+  if (sink->writeback_prev_len > 0) {
+    sync_file_range (fd, sink->writeback_prev_start, sink->writeback_prev_len,
+        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+        SYNC_FILE_RANGE_WAIT_AFTER);
+    posix_fadvise (fd, sink->writeback_prev_start, sink->writeback_prev_len,
+        POSIX_FADV_DONTNEED);
+  }
+
+  sink->writeback_prev_start = start;
+  sink->writeback_prev_len = len;
+  sink->writeback_pos = sink->current_pos;
+#endif
+}
+
 static gboolean
 has_sync_after_buffer (GstBuffer ** buffer, guint idx, gpointer user_data)
 {
@@ -919,6 +1007,9 @@ gst_file_sink_render_list (GstBaseSink * bsink, GstBufferList * buffer_list)
     }
   }
 
+  if (flow == GST_FLOW_OK && !sync_after)
+    gst_file_sink_writeback (sink);
+
   if (flow == GST_FLOW_OK && sync_after) {
     do {
       fsync_ret = fsync (fileno (sink->file));
@@ -1003,6 +1094,9 @@ gst_file_sink_render (GstBaseSink * sink, GstBuffer * buffer)
     flow = GST_FLOW_OK;
   }
 
+  if (flow == GST_FLOW_OK && !sync_after)
+    gst_file_sink_writeback (filesink);
+
   if (flow == GST_FLOW_OK && sync_after) {
     do {
       fsync_ret = fsync (fileno (filesink->file));
@@ -95,6 +95,12 @@ struct _GstFileSink {
   gboolean o_sync;
   gint max_transient_error_timeout;
 
+  /* asynchronous writeback, see writeback-size property */
+  guint64 writeback_size;
+  guint64 writeback_pos;
+  guint64 writeback_prev_start;
+  guint64 writeback_prev_len;
+
   gboolean flushing;
 };
 
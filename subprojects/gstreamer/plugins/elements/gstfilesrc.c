@@ -76,6 +76,10 @@
 #endif
 #endif
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 #include <errno.h>
 #include <string.h>
 
@@ -110,11 +114,15 @@ enum
 };
 
 #define DEFAULT_BLOCKSIZE       4*1024
+#define DEFAULT_READ_AHEAD      0
+#define DEFAULT_USE_MMAP        FALSE
 
 enum
 {
   PROP_0,
-  PROP_LOCATION
+  PROP_LOCATION,
+  PROP_READ_AHEAD,
+  PROP_USE_MMAP
 };
 
 static void gst_file_src_finalize (GObject * object);
@@ -129,6 +137,8 @@ static gboolean gst_file_src_stop (GstBaseSrc * basesrc);
 
 static gboolean gst_file_src_is_seekable (GstBaseSrc * src);
 static gboolean gst_file_src_get_size (GstBaseSrc * src, guint64 * size);
+static GstFlowReturn gst_file_src_create (GstBaseSrc * src, guint64 offset,
+    guint length, GstBuffer ** buffer);
 static GstFlowReturn gst_file_src_fill (GstBaseSrc * src, guint64 offset,
     guint length, GstBuffer * buf);
 
@@ -163,6 +173,44 @@ gst_file_src_class_init (GstFileSrcClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
 
+  /**
+   * GstFileSrc:read-ahead
+   *
+   * Number of bytes after the current read position that the kernel is asked
+   * to read into the page cache in the background. This allows reading from
+   * the disk to overlap with the processing of the previous data downstream,
+   * so that reads do not block the streaming thread for long.
+   *
+   * Only supported on systems with posix_fadvise(), 0 leaves read-ahead to
+   * the kernel.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_READ_AHEAD,
+      g_param_spec_uint ("read-ahead", "Read Ahead",
+          "Number of bytes after the current position to prefetch "
+          "asynchronously (0 = kernel default)", 0, G_MAXUINT,
+          DEFAULT_READ_AHEAD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstFileSrc:use-mmap
+   *
+   * Map regular files into memory and push buffers that point directly into
+   * the mapping instead of reading into newly allocated buffers. This avoids
+   * copying the data, which helps with large uncompressed files.
+   *
+   * The file must not be truncated while it is mapped. Only supported on
+   * systems with mmap(), otherwise the file is read normally.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Map the file into memory instead of reading it", DEFAULT_USE_MMAP,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gobject_class->finalize = gst_file_src_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -176,6 +224,7 @@ gst_file_src_class_init (GstFileSrcClass * klass)
   gstbasesrc_class->stop = GST_DEBUG_FUNCPTR (gst_file_src_stop);
   gstbasesrc_class->is_seekable = GST_DEBUG_FUNCPTR (gst_file_src_is_seekable);
   gstbasesrc_class->get_size = GST_DEBUG_FUNCPTR (gst_file_src_get_size);
+  gstbasesrc_class->create = GST_DEBUG_FUNCPTR (gst_file_src_create);
   gstbasesrc_class->fill = GST_DEBUG_FUNCPTR (gst_file_src_fill);
 
   if (sizeof (off_t) < 8) {
@@ -192,6 +241,8 @@ gst_file_src_init (GstFileSrc * src)
   src->uri = NULL;
 
   src->is_regular = FALSE;
+  src->read_ahead = DEFAULT_READ_AHEAD;
+  src->use_mmap = DEFAULT_USE_MMAP;
 
   gst_base_src_set_blocksize (GST_BASE_SRC (src), DEFAULT_BLOCKSIZE);
 }
@@ -270,6 +321,12 @@ gst_file_src_set_property (GObject * object, guint prop_id,
     case PROP_LOCATION:
       gst_file_src_set_location (src, g_value_get_string (value), NULL);
       break;
+    case PROP_READ_AHEAD:
+      src->read_ahead = g_value_get_uint (value);
+      break;
+    case PROP_USE_MMAP:
+      src->use_mmap = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -290,6 +347,12 @@ gst_file_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_LOCATION:
       g_value_set_string (value, src->filename);
       break;
+    case PROP_READ_AHEAD:
+      g_value_set_uint (value, src->read_ahead);
+      break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, src->use_mmap);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -306,6 +369,131 @@ gst_file_src_get_property (GObject * object, guint prop_id, GValue * value,
  * the sort of attitude we want to be advertising.  No sir.
  *
  */
+/* Asks the kernel to prefetch the next read-ahead bytes after @position. A
+ * new request is only made once half of the previously requested range was
+ * consumed. This also works for the mapped file as it shares the page cache */
+static void
+gst_file_src_prefetch (GstFileSrc * src, guint64 position)
+{
+#ifdef HAVE_POSIX_FADVISE
+  guint64 start, end;
+
+  if (src->read_ahead == 0 || !src->is_regular)
+    return;
+
+  end = position + src->read_ahead;
+
+  /* we seeked backwards, start over */
+  if (src->prefetch_end > end)
+    src->prefetch_end = position;
+
+  if (src->prefetch_end > position &&
+      src->prefetch_end - position > src->read_ahead / 2)
+    return;
+
+  start = MAX (position, src->prefetch_end);
+
+  GST_LOG_OBJECT (src, "prefetching %" G_GUINT64_FORMAT " bytes at offset %"
+      G_GUINT64_FORMAT, end - start, start);
+
+  posix_fadvise (src->fd, start, end - start, POSIX_FADV_WILLNEED);
+  src->prefetch_end = end;
+#endif
+}
+
+#ifdef HAVE_MMAP
+typedef struct
+{
+  gpointer data;
+  gsize size;
+} GstFileSrcMapping;
+
+static void
+gst_file_src_mapping_free (GstFileSrcMapping * mapping)
+{
+  munmap (mapping->data, mapping->size);
+  g_free (mapping);
+}
+
+/* Maps the whole file read-only. Blocks are then pushed as sub-memories of
+ * the mapping, which stays mapped until the last of them is freed. */
+static void
+gst_file_src_map (GstFileSrc * src)
+{
+  struct_stat stat_results;
+  GstFileSrcMapping *mapping;
+  gpointer data;
+  gsize size;
+
+  if (fstat (src->fd, &stat_results) < 0 || stat_results.st_size <= 0 ||
+      (guint64) stat_results.st_size > G_MAXSIZE)
+    return;
+
+  size = stat_results.st_size;
+  data = mmap (NULL, size, PROT_READ, MAP_SHARED, src->fd, 0);
+  if (data == MAP_FAILED) {
+    GST_WARNING_OBJECT (src, "failed to map file, reading instead: %s",
+        g_strerror (errno));
+    return;
+  }
+#ifdef MADV_SEQUENTIAL
+  madvise (data, size, MADV_SEQUENTIAL);
+#endif
+
+  GST_DEBUG_OBJECT (src, "mapped %" G_GSIZE_FORMAT " bytes", size);
+
+  mapping = g_new (GstFileSrcMapping, 1);
+  mapping->data = data;
+  mapping->size = size;
+
+  src->mapping_data = data;
+  src->mapping_size = size;
+  src->mapping = gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, data, size,
+      0, size, mapping, (GDestroyNotify) gst_file_src_mapping_free);
+}
+#endif
+
+static GstFlowReturn
+gst_file_src_create (GstBaseSrc * basesrc, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+  GstFileSrc *src = GST_FILE_SRC_CAST (basesrc);
+  GstBuffer *buf;
+
+  /* offset is -1 when reading sequentially from a non-seekable file, and a
+   * regular file can grow beyond the mapped size, so read those normally */
+  if (!src->mapping || offset >= src->mapping_size)
+    return GST_BASE_SRC_CLASS (parent_class)->create (basesrc, offset, length,
+        buffer);
+
+  length = MIN (length, src->mapping_size - offset);
+
+  GST_LOG_OBJECT (src, "Mapping %u bytes at offset 0x%" G_GINT64_MODIFIER "x",
+      length, offset);
+
+  if (*buffer) {
+    /* downstream provided the buffer to fill */
+    buf = *buffer;
+    length = gst_buffer_fill (buf, 0, src->mapping_data + offset, length);
+    if (gst_buffer_get_size (buf) != length)
+      gst_buffer_resize (buf, 0, length);
+  } else {
+    buf = gst_buffer_new ();
+    if (length > 0)
+      gst_buffer_append_memory (buf, gst_memory_share (src->mapping, offset,
+              length));
+  }
+
+  gst_file_src_prefetch (src, offset + length);
+
+  GST_BUFFER_OFFSET (buf) = offset;
+  GST_BUFFER_OFFSET_END (buf) = offset + length;
+
+  *buffer = buf;
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_file_src_fill (GstBaseSrc * basesrc, guint64 offset, guint length,
     GstBuffer * buf)
@@ -359,6 +547,8 @@ gst_file_src_fill (GstBaseSrc * basesrc, guint64 offset, guint length,
     src->read_position += ret;
   }
 
+  gst_file_src_prefetch (src, src->read_position);
+
   gst_buffer_unmap (buf, &info);
   if (bytes_read != length)
     gst_buffer_resize (buf, 0, bytes_read);
@@ -537,6 +727,17 @@ gst_file_src_start (GstBaseSrc * basesrc)
 
   gst_base_src_set_dynamic_size (basesrc, src->seekable);
 
+#ifdef HAVE_POSIX_FADVISE
+  src->prefetch_end = 0;
+  if (src->read_ahead > 0 && src->is_regular)
+    posix_fadvise (src->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+#ifdef HAVE_MMAP
+  if (src->use_mmap && src->is_regular)
+    gst_file_src_map (src);
+#endif
+
   return TRUE;
 
   /* ERROR */
@@ -600,6 +801,12 @@ gst_file_src_stop (GstBaseSrc * basesrc)
 {
   GstFileSrc *src = GST_FILE_SRC (basesrc);
 
+  /* buffers that were pushed keep the mapping alive until they are freed */
+  if (src->mapping) {
+    gst_memory_unref (src->mapping);
+    src->mapping = NULL;
+  }
+
   /* close the file */
   g_close (src->fd, NULL);
 
@@ -63,6 +63,14 @@ struct _GstFileSrc {
   gboolean seekable;                    /* whether the file is seekable */
   gboolean is_regular;                  /* whether it's a (symlink to a)
                                            regular file */
+
+  guint read_ahead;                     /* bytes to prefetch */
+  guint64 prefetch_end;                 /* end of the prefetched range */
+
+  gboolean use_mmap;                    /* map the file instead of reading */
+  GstMemory *mapping;                   /* memory wrapping the mapped file */
+  guint8 *mapping_data;
+  gsize mapping_size;
 };
 
 struct _GstFileSrcClass {
@@ -196,8 +196,7 @@ static void gst_single_queue_unref (GstSingleQueue * squeue);
 static GstSingleQueue *gst_single_queue_ref (GstSingleQueue * squeue);
 
 static void wake_up_next_non_linked (GstMultiQueue * mq);
-static void compute_high_id (GstMultiQueue * mq);
-static void compute_high_time (GstMultiQueue * mq, guint groupid);
+static void compute_high_id_and_time (GstMultiQueue * mq, guint groupid);
 static void single_queue_overrun_cb (GstDataQueue * dq, GstSingleQueue * sq);
 static void single_queue_underrun_cb (GstDataQueue * dq, GstSingleQueue * sq);
 
@@ -2192,10 +2191,8 @@ next:
       gboolean should_wait;
       /* Go to sleep until it's time to push this buffer */
 
-      /* Recompute the highid */
-      compute_high_id (mq);
-      /* Recompute the high time */
-      compute_high_time (mq, sq->groupid);
+      /* Recompute the highid and high time */
+      compute_high_id_and_time (mq, sq->groupid);
 
       GST_DEBUG_OBJECT (mq,
           "groupid %d high_time %" GST_STIME_FORMAT " next_time %"
@@ -2235,8 +2232,7 @@ next:
         }
 
         /* Recompute the high time and ID */
-        compute_high_time (mq, sq->groupid);
-        compute_high_id (mq);
+        compute_high_id_and_time (mq, sq->groupid);
 
         GST_DEBUG_OBJECT (mq, "queue %d woken from sleeping for not-linked "
             "wakeup with newid %u, highid %u, next_time %" GST_STIME_FORMAT
@@ -2259,11 +2255,11 @@ next:
       }
 
       /* Re-compute the high_id in case someone else pushed */
-      compute_high_id (mq);
-      compute_high_time (mq, sq->groupid);
-    } else {
-      compute_high_id (mq);
-      compute_high_time (mq, sq->groupid);
+      compute_high_id_and_time (mq, sq->groupid);
+    } else if (mq->numwaiting > 0) {
+      /* Only needed to wake up waiting non-linked pads. A pad that becomes
+       * not-linked recomputes the values itself before deciding to wait */
+      compute_high_id_and_time (mq, sq->groupid);
       /* Wake up all non-linked pads */
       wake_up_next_non_linked (mq);
     }
@@ -2313,8 +2309,7 @@ next:
     GST_LOG_OBJECT (mq, "SingleQueue %d : Changed from active to non-active",
         sq->id);
 
-    compute_high_id (mq);
-    compute_high_time (mq, sq->groupid);
+    compute_high_id_and_time (mq, sq->groupid);
     do_update_buffering = TRUE;
 
     /* maybe no-one is waiting */
@@ -2370,8 +2365,7 @@ next:
   GST_MULTI_QUEUE_MUTEX_LOCK (mq);
   if (mq->numwaiting > 0 && (GST_PAD_IS_EOS (srcpad)
           || sq->srcresult == GST_FLOW_EOS)) {
-    compute_high_time (mq, sq->groupid);
-    compute_high_id (mq);
+    compute_high_id_and_time (mq, sq->groupid);
     wake_up_next_non_linked (mq);
   }
   GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
@@ -2983,65 +2977,20 @@ wake_up_next_non_linked (GstMultiQueue * mq)
 
 /* WITH LOCK TAKEN */
 static void
-compute_high_id (GstMultiQueue * mq)
+compute_high_id_and_time (GstMultiQueue * mq, guint groupid)
 {
   /* The high-id is either the highest id among the linked pads, or if all
-   * pads are not-linked, it's the lowest not-linked pad */
-  GList *tmp;
-  guint32 lowest = G_MAXUINT32;
-  guint32 highid = G_MAXUINT32;
-
-  for (tmp = mq->queues; tmp; tmp = g_list_next (tmp)) {
-    GstSingleQueue *sq = (GstSingleQueue *) tmp->data;
-    GstPad *srcpad = g_weak_ref_get (&sq->srcpad);
-
-    if (!srcpad) {
-      GST_INFO_OBJECT (mq,
-          "srcpad has been removed already... ignoring single queue");
-
-      continue;
-    }
-
-    GST_LOG_OBJECT (mq, "inspecting sq:%d , nextid:%d, oldid:%d, srcresult:%s",
-        sq->id, sq->nextid, sq->oldid, gst_flow_get_name (sq->srcresult));
-
-    /* No need to consider queues which are not waiting */
-    if (sq->nextid == 0) {
-      GST_LOG_OBJECT (mq, "sq:%d is not waiting - ignoring", sq->id);
-      gst_object_unref (srcpad);
-      continue;
-    }
-
-    if (sq->srcresult == GST_FLOW_NOT_LINKED) {
-      if (sq->nextid < lowest)
-        lowest = sq->nextid;
-    } else if (!GST_PAD_IS_EOS (srcpad) && sq->srcresult != GST_FLOW_EOS) {
-      /* If we don't have a global highid, or the global highid is lower than
-       * this single queue's last outputted id, store the queue's one,
-       * unless the singlequeue output is at EOS */
-      if ((highid == G_MAXUINT32) || (sq->oldid > highid))
-        highid = sq->oldid;
-    }
-    gst_object_unref (srcpad);
-  }
-
-  if (highid == G_MAXUINT32 || lowest < highid)
-    mq->highid = lowest;
-  else
-    mq->highid = highid;
-
-  GST_LOG_OBJECT (mq, "Highid is now : %u, lowest non-linked %u", mq->highid,
-      lowest);
-}
-
-/* WITH LOCK TAKEN */
-static void
-compute_high_time (GstMultiQueue * mq, guint groupid)
-{
-  /* The high-time is either the highest last time among the linked
+   * pads are not-linked, it's the lowest not-linked pad.
+   *
+   * The high-time is either the highest last time among the linked
    * pads, or if all pads are not-linked, it's the lowest nex time of
-   * not-linked pad */
+   * not-linked pad.
+   *
+   * Both are computed in a single pass over the queues as this is done for
+   * most items pushed when there are waiting not-linked pads. */
   GList *tmp;
+  guint32 lowest_id = G_MAXUINT32;
+  guint32 highid = G_MAXUINT32;
   GstClockTimeDiff highest = GST_CLOCK_STIME_NONE;
   GstClockTimeDiff lowest = GST_CLOCK_STIME_NONE;
   GstClockTimeDiff group_high = GST_CLOCK_STIME_NONE;
@@ -3050,13 +2999,10 @@ compute_high_time (GstMultiQueue * mq, guint groupid)
   /* Number of streams which belong to groupid */
   guint group_count = 0;
 
-  if (!mq->sync_by_running_time)
-    /* return GST_CLOCK_STIME_NONE; */
-    return;
-
-  for (tmp = mq->queues; tmp; tmp = tmp->next) {
+  for (tmp = mq->queues; tmp; tmp = g_list_next (tmp)) {
     GstSingleQueue *sq = (GstSingleQueue *) tmp->data;
     GstPad *srcpad = g_weak_ref_get (&sq->srcpad);
+    gboolean is_eos;
 
     if (!srcpad) {
       GST_INFO_OBJECT (mq,
@@ -3065,29 +3011,46 @@ compute_high_time (GstMultiQueue * mq, guint groupid)
       continue;
     }
 
-    GST_LOG_OBJECT (mq,
-        "inspecting sq:%d (group:%d) , next_time:%" GST_STIME_FORMAT
-        ", last_time:%" GST_STIME_FORMAT ", srcresult:%s", sq->id, sq->groupid,
+    is_eos = GST_PAD_IS_EOS (srcpad) || sq->srcresult == GST_FLOW_EOS;
+    gst_object_unref (srcpad);
+
+    GST_LOG_OBJECT (mq, "inspecting sq:%d (group:%d), nextid:%d, oldid:%d, "
+        "next_time:%" GST_STIME_FORMAT ", last_time:%" GST_STIME_FORMAT
+        ", srcresult:%s", sq->id, sq->groupid, sq->nextid, sq->oldid,
         GST_STIME_ARGS (sq->next_time), GST_STIME_ARGS (sq->last_time),
         gst_flow_get_name (sq->srcresult));
 
+    /* No need to consider queues which are not waiting */
+    if (sq->nextid != 0) {
+      if (sq->srcresult == GST_FLOW_NOT_LINKED) {
+        if (sq->nextid < lowest_id)
+          lowest_id = sq->nextid;
+      } else if (!is_eos) {
+        /* If we don't have a global highid, or the global highid is lower
+         * than this single queue's last outputted id, store the queue's one,
+         * unless the singlequeue output is at EOS */
+        if ((highid == G_MAXUINT32) || (sq->oldid > highid))
+          highid = sq->oldid;
+      }
+    }
+
+    if (!mq->sync_by_running_time)
+      continue;
+
     if (sq->groupid == groupid)
       group_count++;
 
     if (sq->srcresult == GST_FLOW_NOT_LINKED) {
       /* No need to consider queues which are not waiting */
-      if (!GST_CLOCK_STIME_IS_VALID (sq->next_time)) {
-        GST_LOG_OBJECT (mq, "sq:%d is not waiting - ignoring", sq->id);
-        gst_object_unref (srcpad);
+      if (!GST_CLOCK_STIME_IS_VALID (sq->next_time))
         continue;
-      }
 
       if (lowest == GST_CLOCK_STIME_NONE || sq->next_time < lowest)
         lowest = sq->next_time;
       if (sq->groupid == groupid && (group_low == GST_CLOCK_STIME_NONE
               || sq->next_time < group_low))
         group_low = sq->next_time;
-    } else if (!GST_PAD_IS_EOS (srcpad) && sq->srcresult != GST_FLOW_EOS) {
+    } else if (!is_eos) {
       /* If we don't have a global high time, or the global high time
        * is lower than this single queue's last outputted time, store
        * the queue's one, unless the singlequeue output is at EOS. */
@@ -3099,17 +3062,19 @@ compute_high_time (GstMultiQueue * mq, guint groupid)
                   && sq->last_time > group_high)))
         group_high = sq->last_time;
     }
-    GST_LOG_OBJECT (mq,
-        "highest now %" GST_STIME_FORMAT " lowest %" GST_STIME_FORMAT,
-        GST_STIME_ARGS (highest), GST_STIME_ARGS (lowest));
-    if (sq->groupid == groupid)
-      GST_LOG_OBJECT (mq,
-          "grouphigh %" GST_STIME_FORMAT " grouplow %" GST_STIME_FORMAT,
-          GST_STIME_ARGS (group_high), GST_STIME_ARGS (group_low));
-
-    gst_object_unref (srcpad);
   }
 
+  if (highid == G_MAXUINT32 || lowest_id < highid)
+    mq->highid = lowest_id;
+  else
+    mq->highid = highid;
+
+  GST_LOG_OBJECT (mq, "Highid is now : %u, lowest non-linked %u", mq->highid,
+      lowest_id);
+
+  if (!mq->sync_by_running_time)
+    return;
+
   if (highest == GST_CLOCK_STIME_NONE)
     mq->high_time = lowest;
   else
@@ -3127,7 +3092,7 @@ compute_high_time (GstMultiQueue * mq, guint groupid)
   GST_LOG_OBJECT (mq,
       "MQ High time is now : %" GST_STIME_FORMAT ", group %d high time %"
       GST_STIME_FORMAT ", lowest non-linked %" GST_STIME_FORMAT,
-      GST_STIME_ARGS (mq->high_time), groupid, GST_STIME_ARGS (mq->high_time),
+      GST_STIME_ARGS (mq->high_time), groupid, GST_STIME_ARGS (res),
       GST_STIME_ARGS (lowest));
 
   for (tmp = mq->queues; tmp; tmp = tmp->next) {
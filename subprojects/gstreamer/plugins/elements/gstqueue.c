@@ -122,13 +122,21 @@ enum
   PROP_MIN_THRESHOLD_TIME,
   PROP_LEAKY,
   PROP_SILENT,
-  PROP_FLUSH_ON_EOS
+  PROP_FLUSH_ON_EOS,
+  PROP_LOCK_FREE
 };
 
 /* default property values */
 #define DEFAULT_MAX_SIZE_BUFFERS  200   /* 200 buffers */
 #define DEFAULT_MAX_SIZE_BYTES    (10 * 1024 * 1024)    /* 10 MB       */
 #define DEFAULT_MAX_SIZE_TIME     GST_SECOND    /* 1 second    */
+#define DEFAULT_LOCK_FREE         FALSE
+
+/* number of slots of the lock-free ring on top of max-size-buffers, or when
+ * there is no buffers limit */
+#define RING_EXTRA_SLOTS          64
+#define RING_DEFAULT_SIZE         1024
+#define RING_MAX_SIZE             (1 << 20)
 
 #define GST_QUEUE_MUTEX_LOCK(q) G_STMT_START {                          \
   g_mutex_lock (&q->qlock);                                              \
@@ -202,6 +210,8 @@ static GstFlowReturn gst_queue_chain_list (GstPad * pad, GstObject * parent,
     GstBufferList * buffer_list);
 static GstFlowReturn gst_queue_push_one (GstQueue * queue);
 static void gst_queue_loop (GstPad * pad);
+static void gst_queue_ring_loop (GstPad * pad);
+static gboolean gst_queue_start_task (GstQueue * queue);
 
 static GstFlowReturn gst_queue_handle_sink_event (GstPad * pad,
     GstObject * parent, GstEvent * event);
@@ -214,6 +224,7 @@ static gboolean gst_queue_handle_src_query (GstPad * pad, GstObject * parent,
     GstQuery * query);
 
 static void gst_queue_locked_flush (GstQueue * queue, gboolean full);
+static void gst_queue_ring_free (GstQueue * queue);
 
 static gboolean gst_queue_src_activate_mode (GstPad * pad, GstObject * parent,
     GstPadMode mode, gboolean active);
@@ -231,6 +242,16 @@ typedef struct
   gboolean is_query;
 } GstQueueItem;
 
+struct _GstQueueRingSlot
+{
+  GstMiniObject *item;
+  gsize size;
+  guint n_buffers;
+  /* sink running time when the item was queued */
+  GstClockTimeDiff time;
+  gboolean is_query;
+};
+
 #define GST_TYPE_QUEUE_LEAKY (queue_leaky_get_type ())
 
 static GType
@@ -405,6 +426,29 @@ gst_queue_class_init (GstQueueClass * klass)
           G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * queue:lock-free:
+   *
+   * Pass items from the upstream streaming thread to the queue's streaming
+   * thread through a fixed size ring that does not need the queue lock for
+   * buffers. The lock is only taken when the queue runs empty or full,
+   * and for serialized events and queries, which stay ordered with the
+   * buffers.
+   *
+   * The size of the ring is derived from #GstQueue:max-size-buffers when the
+   * queue goes to PAUSED. Leaking on the downstream end, the min-threshold
+   * properties and #GstQueue:flush-on-eos are not supported in this mode, a
+   * downstream leaky queue will block like a non-leaky one.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_LOCK_FREE,
+      g_param_spec_boolean ("lock-free", "Lock free",
+          "Pass buffers to the streaming thread without locking",
+          DEFAULT_LOCK_FREE,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_queue_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -478,6 +522,8 @@ gst_queue_init (GstQueue * queue)
 
   queue->newseg_applied_to_src = FALSE;
 
+  queue->lock_free = DEFAULT_LOCK_FREE;
+
   GST_DEBUG_OBJECT (queue,
       "initialized queue's not_empty & not_full conditions");
 }
@@ -497,6 +543,7 @@ gst_queue_finalize (GObject * object)
       gst_mini_object_unref (qitem->item);
   }
   gst_queue_array_free (queue->queue);
+  gst_queue_ring_free (queue);
 
   g_mutex_clear (&queue->qlock);
   g_cond_clear (&queue->item_add);
@@ -539,6 +586,11 @@ update_time_level (GstQueue * queue)
   }
   sink_time = queue->sinktime;
 
+  /* in lock-free mode the time level is calculated by the producer from the
+   * time each item was queued, see gst_queue_ring_is_filled() */
+  if (queue->ring)
+    return;
+
   if (queue->src_tainted) {
     GST_LOG_OBJECT (queue, "update src time");
     queue->srctime =
@@ -698,11 +750,238 @@ apply_buffer_list (GstQueue * queue, GstBufferList * buffer_list,
   update_time_level (queue);
 }
 
+/* In lock-free mode, items are passed from the sinkpad streaming thread (the
+ * producer) to the srcpad task (the consumer) through a fixed size ring
+ * instead of the queue array. The consumer only writes ring_head and the
+ * producer only writes ring_tail, so buffers are passed without taking the
+ * queue lock. The lock and the item_add/item_del conditions are only used
+ * when one side has to wait for the other, and waiting_add/waiting_del tell
+ * the other side whether it needs to signal.
+ *
+ * Serialized events and queries go through the same ring, so they stay
+ * ordered with the buffers. The buffers and bytes levels are updated
+ * atomically, the time level is calculated by the producer from the sink
+ * running time each item was queued at. */
+
+static inline guint
+gst_queue_ring_length (GstQueue * queue)
+{
+  return (guint) g_atomic_int_get (&queue->ring_tail) -
+      (guint) g_atomic_int_get (&queue->ring_head);
+}
+
+/* from the producer side */
+static gboolean
+gst_queue_ring_is_full (GstQueue * queue)
+{
+  return gst_queue_ring_length (queue) >= queue->ring_size;
+}
+
+/* from the producer side, updates the time level */
+static gboolean
+gst_queue_ring_is_filled (GstQueue * queue)
+{
+  guint head, len;
+
+  head = g_atomic_int_get (&queue->ring_head);
+  len = (guint) queue->ring_tail - head;
+  if (len >= queue->ring_size)
+    return TRUE;
+
+  /* only the producer writes the slots, the one at head stays valid even when
+   * the consumer takes it while we look at it */
+  queue->cur_level.time = 0;
+  if (len > 0) {
+    GstClockTimeDiff oldest = queue->ring[head & (queue->ring_size - 1)].time;
+
+    if (GST_CLOCK_STIME_IS_VALID (oldest)
+        && GST_CLOCK_STIME_IS_VALID (queue->sinktime)
+        && queue->sinktime >= oldest)
+      queue->cur_level.time = queue->sinktime - oldest;
+  }
+
+  return ((queue->max_size.buffers > 0 &&
+          (guint) g_atomic_int_get (&queue->cur_level.buffers) >=
+          queue->max_size.buffers) ||
+      (queue->max_size.bytes > 0 &&
+          (guint) g_atomic_int_get (&queue->cur_level.bytes) >=
+          queue->max_size.bytes) ||
+      (queue->max_size.time > 0 &&
+          queue->cur_level.time >= queue->max_size.time));
+}
+
+/* wait for the consumer to take an item while @filled returns TRUE, with the
+ * queue lock if @locked. Returns FALSE when flushing. */
+static gboolean
+gst_queue_ring_wait_del (GstQueue * queue, gboolean locked,
+    gboolean (*filled) (GstQueue * queue))
+{
+  gboolean res;
+
+  if (!locked)
+    GST_QUEUE_MUTEX_LOCK (queue);
+  g_atomic_int_set (&queue->waiting_del, TRUE);
+  /* check again now that the consumer will signal us */
+  if (queue->srcresult == GST_FLOW_OK && filled (queue)) {
+    STATUS (queue, queue->sinkpad, "wait for DEL");
+    g_cond_wait (&queue->item_del, &queue->qlock);
+  }
+  g_atomic_int_set (&queue->waiting_del, FALSE);
+  res = (queue->srcresult == GST_FLOW_OK);
+  if (!locked)
+    GST_QUEUE_MUTEX_UNLOCK (queue);
+
+  return res;
+}
+
+/* wait for the producer to add an item. Returns FALSE when flushing. */
+static gboolean
+gst_queue_ring_wait_add (GstQueue * queue)
+{
+  gboolean res;
+
+  GST_QUEUE_MUTEX_LOCK (queue);
+  g_atomic_int_set (&queue->waiting_add, TRUE);
+  if (queue->srcresult == GST_FLOW_OK && gst_queue_ring_length (queue) == 0) {
+    STATUS (queue, queue->srcpad, "wait for ADD");
+    g_cond_wait (&queue->item_add, &queue->qlock);
+  }
+  g_atomic_int_set (&queue->waiting_add, FALSE);
+  res = (queue->srcresult == GST_FLOW_OK);
+  GST_QUEUE_MUTEX_UNLOCK (queue);
+
+  return res;
+}
+
+/* add @slot to the ring, waiting for a free slot if needed. From the producer
+ * side, with the queue lock if @locked. Returns FALSE when flushing, the item
+ * is not queued then. */
+static gboolean
+gst_queue_ring_push (GstQueue * queue, const GstQueueRingSlot * slot,
+    gboolean locked)
+{
+  guint tail = queue->ring_tail;
+
+  while (gst_queue_ring_is_full (queue)) {
+    if (!gst_queue_ring_wait_del (queue, locked, gst_queue_ring_is_full))
+      return FALSE;
+  }
+
+  g_atomic_int_add (&queue->cur_level.buffers, slot->n_buffers);
+  g_atomic_int_add (&queue->cur_level.bytes, (guint) slot->size);
+
+  queue->ring[tail & (queue->ring_size - 1)] = *slot;
+  /* publish the slot to the consumer */
+  g_atomic_int_set (&queue->ring_tail, tail + 1);
+
+  if (g_atomic_int_get (&queue->waiting_add)) {
+    if (!locked)
+      GST_QUEUE_MUTEX_LOCK (queue);
+    STATUS (queue, queue->sinkpad, "signal ADD");
+    g_cond_signal (&queue->item_add);
+    if (!locked)
+      GST_QUEUE_MUTEX_UNLOCK (queue);
+  }
+
+  return TRUE;
+}
+
+/* take the oldest item from the ring. From the consumer side, or from any
+ * thread when the srcpad task is stopped, with the queue lock if @locked. */
+static gboolean
+gst_queue_ring_pop (GstQueue * queue, GstQueueRingSlot * slot,
+    gboolean locked)
+{
+  guint head = queue->ring_head;
+
+  if (head == (guint) g_atomic_int_get (&queue->ring_tail))
+    return FALSE;
+
+  *slot = queue->ring[head & (queue->ring_size - 1)];
+
+  g_atomic_int_add (&queue->cur_level.buffers, -(gint) slot->n_buffers);
+  g_atomic_int_add (&queue->cur_level.bytes, -(gint) slot->size);
+  /* give the slot back to the producer */
+  g_atomic_int_set (&queue->ring_head, head + 1);
+
+  if (g_atomic_int_get (&queue->waiting_del)) {
+    if (!locked)
+      GST_QUEUE_MUTEX_LOCK (queue);
+    STATUS (queue, queue->srcpad, "signal DEL");
+    g_cond_signal (&queue->item_del);
+    if (!locked)
+      GST_QUEUE_MUTEX_UNLOCK (queue);
+  }
+
+  return TRUE;
+}
+
+/* with QUEUE_LOCK, from the consumer side */
+static void
+gst_queue_ring_flush (GstQueue * queue, gboolean full)
+{
+  GstQueueRingSlot slot;
+
+  while (gst_queue_ring_pop (queue, &slot, TRUE)) {
+    if (!full && !slot.is_query && GST_IS_EVENT (slot.item)
+        && GST_EVENT_IS_STICKY (slot.item)
+        && GST_EVENT_TYPE (slot.item) != GST_EVENT_SEGMENT
+        && GST_EVENT_TYPE (slot.item) != GST_EVENT_EOS) {
+      gst_pad_store_sticky_event (queue->srcpad, GST_EVENT_CAST (slot.item));
+    }
+    if (!slot.is_query)
+      gst_mini_object_unref (slot.item);
+  }
+}
+
+/* with QUEUE_LOCK, when the srcpad task is stopped */
+static void
+gst_queue_ring_free (GstQueue * queue)
+{
+  if (queue->ring == NULL)
+    return;
+
+  gst_queue_ring_flush (queue, TRUE);
+  g_free (queue->ring);
+  queue->ring = NULL;
+  queue->ring_size = 0;
+}
+
+/* with QUEUE_LOCK, when the srcpad task is stopped */
+static void
+gst_queue_ring_alloc (GstQueue * queue)
+{
+  guint size, needed;
+
+  /* keep some room for events and queries */
+  if (queue->max_size.buffers > 0)
+    needed = MIN (queue->max_size.buffers, RING_MAX_SIZE) + RING_EXTRA_SLOTS;
+  else
+    needed = RING_DEFAULT_SIZE;
+
+  size = 1;
+  while (size < needed)
+    size <<= 1;
+
+  if (queue->ring && queue->ring_size == size)
+    return;
+
+  gst_queue_ring_free (queue);
+  queue->ring = g_new0 (GstQueueRingSlot, size);
+  queue->ring_size = size;
+  queue->ring_head = queue->ring_tail = 0;
+
+  GST_DEBUG_OBJECT (queue, "using lock-free ring of %u items", size);
+}
+
 static void
 gst_queue_locked_flush (GstQueue * queue, gboolean full)
 {
   GstQueueItem *qitem;
 
+  if (queue->ring)
+    gst_queue_ring_flush (queue, full);
+
   while ((qitem = gst_queue_array_pop_head_struct (queue->queue))) {
     /* Then lose another reference because we are supposed to destroy that
        data when flushing */
@@ -718,7 +997,13 @@ gst_queue_locked_flush (GstQueue * queue, gboolean full)
   }
   queue->last_query = FALSE;
   g_cond_signal (&queue->query_handled);
-  GST_QUEUE_CLEAR_LEVEL (queue->cur_level);
+  if (queue->ring) {
+    /* the producer might still be adding to the levels, the ring flush took
+     * out what was queued */
+    queue->cur_level.time = 0;
+  } else {
+    GST_QUEUE_CLEAR_LEVEL (queue->cur_level);
+  }
   queue->min_threshold.buffers = queue->orig_min_threshold.buffers;
   queue->min_threshold.bytes = queue->orig_min_threshold.bytes;
   queue->min_threshold.time = queue->orig_min_threshold.time;
@@ -774,18 +1059,21 @@ gst_queue_locked_enqueue_buffer_list (GstQueue * queue, gpointer item)
   GST_QUEUE_SIGNAL_ADD (queue);
 }
 
-static inline void
+/* returns FALSE when flushing in lock-free mode, the event is not queued
+ * then */
+static inline gboolean
 gst_queue_locked_enqueue_event (GstQueue * queue, gpointer item)
 {
   GstQueueItem qitem;
   GstEvent *event = GST_EVENT_CAST (item);
+  GstClockTimeDiff sinktime = queue->sinktime;
 
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_EOS:
       GST_CAT_LOG_OBJECT (queue_dataflow, queue, "got EOS from upstream");
       /* Zero the thresholds, this makes sure the queue is completely
        * filled and we can read all data from the queue. */
-      if (queue->flush_on_eos)
+      if (queue->flush_on_eos && !queue->ring)
         gst_queue_locked_flush (queue, FALSE);
       else
         GST_QUEUE_CLEAR_LEVEL (queue->min_threshold);
@@ -795,7 +1083,7 @@ gst_queue_locked_enqueue_event (GstQueue * queue, gpointer item)
     case GST_EVENT_SEGMENT:
       apply_segment (queue, event, &queue->sink_segment, TRUE);
       /* if the queue is empty, apply sink segment on the source */
-      if (gst_queue_array_is_empty (queue->queue)) {
+      if (!queue->ring && gst_queue_array_is_empty (queue->queue)) {
         GST_CAT_LOG_OBJECT (queue_dataflow, queue, "Apply segment on srcpad");
         apply_segment (queue, event, &queue->src_segment, FALSE);
         queue->newseg_applied_to_src = TRUE;
@@ -811,11 +1099,24 @@ gst_queue_locked_enqueue_event (GstQueue * queue, gpointer item)
       break;
   }
 
+  if (queue->ring) {
+    GstQueueRingSlot slot;
+
+    slot.item = item;
+    slot.size = 0;
+    slot.n_buffers = 0;
+    slot.time = sinktime;
+    slot.is_query = FALSE;
+    return gst_queue_ring_push (queue, &slot, TRUE);
+  }
+
   qitem.item = item;
   qitem.is_query = FALSE;
   qitem.size = 0;
   gst_queue_array_push_tail_struct (queue->queue, &qitem);
   GST_QUEUE_SIGNAL_ADD (queue);
+
+  return TRUE;
 }
 
 /* dequeue an item from the queue and update level stats, with QUEUE_LOCK */
@@ -954,8 +1255,7 @@ gst_queue_handle_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
       queue->eos = FALSE;
       queue->unexpected = FALSE;
       if (gst_pad_is_active (queue->srcpad)) {
-        gst_pad_start_task (queue->srcpad, (GstTaskFunction) gst_queue_loop,
-            queue->srcpad, NULL);
+        gst_queue_start_task (queue);
       } else {
         GST_INFO_OBJECT (queue->srcpad, "not re-starting task on srcpad, "
             "pad not active any longer");
@@ -1007,8 +1307,7 @@ gst_queue_handle_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
                 queue->srcresult = GST_FLOW_OK;
                 queue->eos = FALSE;
                 queue->unexpected = FALSE;
-                gst_pad_start_task (queue->srcpad,
-                    (GstTaskFunction) gst_queue_loop, queue->srcpad, NULL);
+                gst_queue_start_task (queue);
               } else {
                 queue->eos = FALSE;
                 queue->unexpected = FALSE;
@@ -1020,7 +1319,10 @@ gst_queue_handle_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
           }
         }
 
-        gst_queue_locked_enqueue_event (queue, event);
+        if (!gst_queue_locked_enqueue_event (queue, event)) {
+          GST_QUEUE_MUTEX_UNLOCK (queue);
+          goto out_flow_error;
+        }
         GST_QUEUE_MUTEX_UNLOCK (queue);
       } else {
         /* non-serialized events are forwarded downstream immediately */
@@ -1066,11 +1368,23 @@ gst_queue_handle_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
         GST_QUEUE_MUTEX_LOCK_CHECK (queue, out_flushing);
         GST_LOG_OBJECT (queue, "queuing query %p (%s)", query,
             GST_QUERY_TYPE_NAME (query));
-        qitem.item = GST_MINI_OBJECT_CAST (query);
-        qitem.is_query = TRUE;
-        qitem.size = 0;
-        gst_queue_array_push_tail_struct (queue->queue, &qitem);
-        GST_QUEUE_SIGNAL_ADD (queue);
+        if (queue->ring) {
+          GstQueueRingSlot slot;
+
+          slot.item = GST_MINI_OBJECT_CAST (query);
+          slot.size = 0;
+          slot.n_buffers = 0;
+          slot.time = queue->sinktime;
+          slot.is_query = TRUE;
+          if (!gst_queue_ring_push (queue, &slot, TRUE))
+            goto out_flushing;
+        } else {
+          qitem.item = GST_MINI_OBJECT_CAST (query);
+          qitem.is_query = TRUE;
+          qitem.size = 0;
+          gst_queue_array_push_tail_struct (queue->queue, &qitem);
+          GST_QUEUE_SIGNAL_ADD (queue);
+        }
         while (queue->srcresult == GST_FLOW_OK &&
             queue->last_handled_query != query)
           g_cond_wait (&queue->query_handled, &queue->qlock);
@@ -1178,6 +1492,124 @@ discont_first_buffer (GstBuffer ** buffer, guint i, gpointer user_data)
   return FALSE;
 }
 
+static GstMiniObject *
+gst_queue_mark_discont (GstQueue * queue, GstMiniObject * obj,
+    gboolean is_list)
+{
+  if (!is_list) {
+    GstBuffer *buffer = GST_BUFFER_CAST (obj);
+    GstBuffer *subbuffer = gst_buffer_make_writable (buffer);
+
+    if (subbuffer) {
+      buffer = subbuffer;
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+    } else {
+      GST_DEBUG_OBJECT (queue, "Could not mark buffer as DISCONT");
+    }
+
+    obj = GST_MINI_OBJECT_CAST (buffer);
+  } else {
+    GstBufferList *buffer_list = GST_BUFFER_LIST_CAST (obj);
+
+    buffer_list = gst_buffer_list_make_writable (buffer_list);
+    gst_buffer_list_foreach (buffer_list, discont_first_buffer, queue);
+    obj = GST_MINI_OBJECT_CAST (buffer_list);
+  }
+
+  return obj;
+}
+
+/* queue a buffer or buffer list in lock-free mode, the queue lock is only
+ * taken when we need to wait for free space */
+static GstFlowReturn
+gst_queue_ring_chain (GstQueue * queue, GstMiniObject * obj, gboolean is_list)
+{
+  GstQueueRingSlot slot;
+  GstFlowReturn ret;
+
+  if (g_atomic_int_get (&queue->srcresult) != GST_FLOW_OK)
+    goto out_flushing;
+  /* when we received EOS, we refuse any more data */
+  if (queue->eos || g_atomic_int_get (&queue->unexpected))
+    goto out_eos;
+
+  while (gst_queue_ring_is_filled (queue)) {
+    if (!queue->silent) {
+      g_signal_emit (queue, gst_queue_signals[SIGNAL_OVERRUN], 0);
+      /* we recheck, the signal could have changed the thresholds */
+      if (!gst_queue_ring_is_filled (queue))
+        break;
+    }
+
+    if (queue->leaky == GST_QUEUE_LEAK_UPSTREAM) {
+      /* next buffer needs to get a DISCONT flag */
+      queue->tail_needs_discont = TRUE;
+      GST_CAT_DEBUG_OBJECT (queue_dataflow, queue,
+          "queue is full, leaking buffer on upstream end");
+      gst_mini_object_unref (obj);
+      return GST_FLOW_OK;
+    }
+
+    /* only the srcpad task can take items out of the ring, so leaking on the
+     * downstream end waits for free space too */
+    GST_CAT_DEBUG_OBJECT (queue_dataflow, queue,
+        "queue is full, waiting for free space");
+    while (gst_queue_ring_is_filled (queue)) {
+      if (!gst_queue_ring_wait_del (queue, FALSE, gst_queue_ring_is_filled))
+        goto out_flushing;
+    }
+
+    GST_CAT_DEBUG_OBJECT (queue_dataflow, queue, "queue is not full");
+    if (!queue->silent)
+      g_signal_emit (queue, gst_queue_signals[SIGNAL_RUNNING], 0);
+  }
+
+  if (queue->tail_needs_discont) {
+    obj = gst_queue_mark_discont (queue, obj, is_list);
+    queue->tail_needs_discont = FALSE;
+  }
+
+  slot.item = obj;
+  slot.time = queue->sinktime;
+  slot.is_query = FALSE;
+  if (is_list) {
+    GstBufferList *buffer_list = GST_BUFFER_LIST_CAST (obj);
+
+    slot.size = gst_buffer_list_calculate_size (buffer_list);
+    slot.n_buffers = gst_buffer_list_length (buffer_list);
+    apply_buffer_list (queue, buffer_list, &queue->sink_segment, TRUE);
+  } else {
+    GstBuffer *buffer = GST_BUFFER_CAST (obj);
+
+    slot.size = gst_buffer_get_size (buffer);
+    slot.n_buffers = 1;
+    apply_buffer (queue, buffer, &queue->sink_segment, TRUE);
+  }
+
+  if (!gst_queue_ring_push (queue, &slot, FALSE))
+    goto out_flushing;
+
+  return GST_FLOW_OK;
+
+  /* special conditions */
+out_flushing:
+  {
+    ret = g_atomic_int_get (&queue->srcresult);
+    GST_CAT_LOG_OBJECT (queue_dataflow, queue,
+        "exit because task paused, reason: %s", gst_flow_get_name (ret));
+    gst_mini_object_unref (obj);
+
+    return ret;
+  }
+out_eos:
+  {
+    GST_CAT_LOG_OBJECT (queue_dataflow, queue, "exit because we received EOS");
+    gst_mini_object_unref (obj);
+
+    return GST_FLOW_EOS;
+  }
+}
+
 static GstFlowReturn
 gst_queue_chain_buffer_or_list (GstPad * pad, GstObject * parent,
     GstMiniObject * obj, gboolean is_list)
@@ -1186,6 +1618,9 @@ gst_queue_chain_buffer_or_list (GstPad * pad, GstObject * parent,
 
   queue = GST_QUEUE_CAST (parent);
 
+  if (queue->ring)
+    return gst_queue_ring_chain (queue, obj, is_list);
+
   /* we have to lock the queue since we span threads */
   GST_QUEUE_MUTEX_LOCK_CHECK (queue, out_flushing);
   /* when we received EOS, we refuse any more data */
@@ -1264,25 +1699,7 @@ gst_queue_chain_buffer_or_list (GstPad * pad, GstObject * parent,
   }
 
   if (queue->tail_needs_discont) {
-    if (!is_list) {
-      GstBuffer *buffer = GST_BUFFER_CAST (obj);
-      GstBuffer *subbuffer = gst_buffer_make_writable (buffer);
-
-      if (subbuffer) {
-        buffer = subbuffer;
-        GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
-      } else {
-        GST_DEBUG_OBJECT (queue, "Could not mark buffer as DISCONT");
-      }
-
-      obj = GST_MINI_OBJECT_CAST (buffer);
-    } else {
-      GstBufferList *buffer_list = GST_BUFFER_LIST_CAST (obj);
-
-      buffer_list = gst_buffer_list_make_writable (buffer_list);
-      gst_buffer_list_foreach (buffer_list, discont_first_buffer, queue);
-      obj = GST_MINI_OBJECT_CAST (buffer_list);
-    }
+    obj = gst_queue_mark_discont (queue, obj, is_list);
     queue->tail_needs_discont = FALSE;
   }
 
@@ -1505,6 +1922,32 @@ out_flushing_query:
   }
 }
 
+/* with QUEUE_LOCK, releases the lock */
+static void
+gst_queue_pause_loop (GstQueue * queue)
+{
+  gboolean eos = queue->eos;
+  GstFlowReturn ret = queue->srcresult;
+
+  gst_pad_pause_task (queue->srcpad);
+  GST_CAT_LOG_OBJECT (queue_dataflow, queue,
+      "pause task, reason:  %s", gst_flow_get_name (ret));
+  if (ret == GST_FLOW_FLUSHING) {
+    gst_queue_locked_flush (queue, FALSE);
+  } else {
+    GST_QUEUE_SIGNAL_DEL (queue);
+    queue->last_query = FALSE;
+    g_cond_signal (&queue->query_handled);
+  }
+  GST_QUEUE_MUTEX_UNLOCK (queue);
+  /* let app know about us giving up if upstream is not expected to do so */
+  /* EOS is already taken care of elsewhere */
+  if (eos && (ret == GST_FLOW_NOT_LINKED || ret < GST_FLOW_EOS)) {
+    GST_ELEMENT_FLOW_ERROR (queue, ret);
+    gst_pad_push_event (queue->srcpad, gst_event_new_eos ());
+  }
+}
+
 static void
 gst_queue_loop (GstPad * pad)
 {
@@ -1550,30 +1993,161 @@ gst_queue_loop (GstPad * pad)
   /* ERRORS */
 out_flushing:
   {
-    gboolean eos = queue->eos;
-    GstFlowReturn ret = queue->srcresult;
+    gst_queue_pause_loop (queue);
+    return;
+  }
+}
 
-    gst_pad_pause_task (queue->srcpad);
-    GST_CAT_LOG_OBJECT (queue_dataflow, queue,
-        "pause task, reason:  %s", gst_flow_get_name (ret));
-    if (ret == GST_FLOW_FLUSHING) {
-      gst_queue_locked_flush (queue, FALSE);
-    } else {
-      GST_QUEUE_SIGNAL_DEL (queue);
-      queue->last_query = FALSE;
-      g_cond_signal (&queue->query_handled);
+/* push the item in @slot downstream, in lock-free mode. */
+static GstFlowReturn
+gst_queue_ring_push_one (GstQueue * queue, GstQueueRingSlot * slot)
+{
+  GstFlowReturn result = GST_FLOW_OK;
+  GstMiniObject *data = slot->item;
+
+next:
+  if (GST_IS_BUFFER (data) || GST_IS_BUFFER_LIST (data)) {
+    if (GST_IS_BUFFER (data))
+      result = gst_pad_push (queue->srcpad, GST_BUFFER_CAST (data));
+    else
+      result = gst_pad_push_list (queue->srcpad, GST_BUFFER_LIST_CAST (data));
+
+    if (result == GST_FLOW_EOS) {
+      GST_CAT_LOG_OBJECT (queue_dataflow, queue, "got EOS from downstream");
+      /* drop items until one we can push again, see gst_queue_push_one() */
+      GST_QUEUE_MUTEX_LOCK (queue);
+      while (gst_queue_ring_pop (queue, slot, TRUE)) {
+        data = slot->item;
+        if (GST_IS_BUFFER (data)) {
+          GST_CAT_LOG_OBJECT (queue_dataflow, queue,
+              "dropping EOS buffer %p", data);
+          gst_buffer_unref (GST_BUFFER_CAST (data));
+        } else if (GST_IS_BUFFER_LIST (data)) {
+          GST_CAT_LOG_OBJECT (queue_dataflow, queue,
+              "dropping EOS buffer list %p", data);
+          gst_buffer_list_unref (GST_BUFFER_LIST_CAST (data));
+        } else if (GST_IS_EVENT (data)) {
+          GstEvent *event = GST_EVENT_CAST (data);
+          GstEventType type = GST_EVENT_TYPE (event);
+
+          if (type == GST_EVENT_EOS || type == GST_EVENT_SEGMENT
+              || type == GST_EVENT_STREAM_START) {
+            GST_CAT_LOG_OBJECT (queue_dataflow, queue,
+                "pushing pushable event %s after EOS",
+                GST_EVENT_TYPE_NAME (event));
+            GST_QUEUE_MUTEX_UNLOCK (queue);
+            goto next;
+          }
+          GST_CAT_LOG_OBJECT (queue_dataflow, queue,
+              "dropping EOS event %p", event);
+          gst_event_unref (event);
+        } else if (GST_IS_QUERY (data)) {
+          GST_CAT_LOG_OBJECT (queue_dataflow, queue,
+              "dropping query %p because of EOS", data);
+          queue->last_query = FALSE;
+          queue->last_handled_query = GST_QUERY_CAST (data);
+          g_cond_signal (&queue->query_handled);
+        }
+      }
+      g_atomic_int_set (&queue->unexpected, TRUE);
+      GST_QUEUE_MUTEX_UNLOCK (queue);
+      result = GST_FLOW_OK;
     }
+  } else if (GST_IS_EVENT (data)) {
+    GstEvent *event = GST_EVENT_CAST (data);
+    GstEventType type = GST_EVENT_TYPE (event);
+
+    gst_pad_push_event (queue->srcpad, event);
+
+    /* if we're EOS, return EOS so that the task pauses. */
+    if (type == GST_EVENT_EOS) {
+      GST_CAT_LOG_OBJECT (queue_dataflow, queue,
+          "pushed EOS event %p, return EOS", event);
+      result = GST_FLOW_EOS;
+    }
+  } else if (GST_IS_QUERY (data)) {
+    GstQuery *query = GST_QUERY_CAST (data);
+    gboolean ret;
+
+    ret = gst_pad_peer_query (queue->srcpad, query);
+    GST_QUEUE_MUTEX_LOCK (queue);
+    queue->last_query = ret;
+    queue->last_handled_query = query;
+    g_cond_signal (&queue->query_handled);
     GST_QUEUE_MUTEX_UNLOCK (queue);
-    /* let app know about us giving up if upstream is not expected to do so */
-    /* EOS is already taken care of elsewhere */
-    if (eos && (ret == GST_FLOW_NOT_LINKED || ret < GST_FLOW_EOS)) {
-      GST_ELEMENT_FLOW_ERROR (queue, ret);
-      gst_pad_push_event (queue->srcpad, gst_event_new_eos ());
+    GST_CAT_LOG_OBJECT (queue_dataflow, queue,
+        "did query %p, return %d", query, ret);
+  } else {
+    g_warning
+        ("Unexpected item %p dequeued from queue %s (refcounting problem?)",
+        data, GST_OBJECT_NAME (queue));
+  }
+
+  return result;
+}
+
+static void
+gst_queue_ring_loop (GstPad * pad)
+{
+  GstQueue *queue;
+  GstQueueRingSlot slot;
+  GstFlowReturn ret;
+
+  queue = (GstQueue *) GST_PAD_PARENT (pad);
+
+  if (g_atomic_int_get (&queue->srcresult) != GST_FLOW_OK)
+    goto out_flushing;
+
+  if (!gst_queue_ring_pop (queue, &slot, FALSE)) {
+    GST_CAT_DEBUG_OBJECT (queue_dataflow, queue, "queue is empty");
+    if (!queue->silent)
+      g_signal_emit (queue, gst_queue_signals[SIGNAL_UNDERRUN], 0);
+
+    while (!gst_queue_ring_pop (queue, &slot, FALSE)) {
+      if (!gst_queue_ring_wait_add (queue))
+        goto out_flushing;
+    }
+
+    GST_CAT_DEBUG_OBJECT (queue_dataflow, queue, "queue is not empty");
+    if (!queue->silent) {
+      g_signal_emit (queue, gst_queue_signals[SIGNAL_RUNNING], 0);
+      g_signal_emit (queue, gst_queue_signals[SIGNAL_PUSHING], 0);
     }
+  }
+
+  ret = gst_queue_ring_push_one (queue, &slot);
+  if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+    GST_QUEUE_MUTEX_LOCK (queue);
+    /* don't overwrite the flushing state */
+    if (queue->srcresult == GST_FLOW_OK)
+      queue->srcresult = ret;
+    gst_queue_pause_loop (queue);
+  }
+
+  return;
+
+  /* ERRORS */
+out_flushing:
+  {
+    GST_QUEUE_MUTEX_LOCK (queue);
+    gst_queue_pause_loop (queue);
     return;
   }
 }
 
+static gboolean
+gst_queue_start_task (GstQueue * queue)
+{
+  GstTaskFunction func;
+
+  if (queue->ring)
+    func = (GstTaskFunction) gst_queue_ring_loop;
+  else
+    func = (GstTaskFunction) gst_queue_loop;
+
+  return gst_pad_start_task (queue->srcpad, func, queue->srcpad, NULL);
+}
+
 static gboolean
 gst_queue_handle_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
@@ -1592,7 +2166,7 @@ gst_queue_handle_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
         /* when we got not linked, assume downstream is linked again now and we
          * can try to start pushing again */
         queue->srcresult = GST_FLOW_OK;
-        gst_pad_start_task (pad, (GstTaskFunction) gst_queue_loop, pad, NULL);
+        gst_queue_start_task (queue);
       }
       GST_QUEUE_MUTEX_UNLOCK (queue);
 
@@ -1716,13 +2290,21 @@ gst_queue_sink_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
         queue->srcresult = GST_FLOW_FLUSHING;
         /* the item del signal will unblock */
         GST_QUEUE_SIGNAL_DEL (queue);
+        if (queue->ring)
+          GST_QUEUE_SIGNAL_ADD (queue);
         GST_QUEUE_MUTEX_UNLOCK (queue);
 
         /* step 2, wait until streaming thread stopped and flush queue */
         GST_PAD_STREAM_LOCK (pad);
+        /* the ring can only be flushed when the srcpad task is not taking
+         * items out of it */
+        if (queue->ring)
+          GST_PAD_STREAM_LOCK (queue->srcpad);
         GST_QUEUE_MUTEX_LOCK (queue);
         gst_queue_locked_flush (queue, TRUE);
         GST_QUEUE_MUTEX_UNLOCK (queue);
+        if (queue->ring)
+          GST_PAD_STREAM_UNLOCK (queue->srcpad);
         GST_PAD_STREAM_UNLOCK (pad);
       }
       result = TRUE;
@@ -1747,12 +2329,14 @@ gst_queue_src_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
     case GST_PAD_MODE_PUSH:
       if (active) {
         GST_QUEUE_MUTEX_LOCK (queue);
+        if (queue->lock_free)
+          gst_queue_ring_alloc (queue);
+        else
+          gst_queue_ring_free (queue);
         queue->srcresult = GST_FLOW_OK;
         queue->eos = FALSE;
         queue->unexpected = FALSE;
-        result =
-            gst_pad_start_task (pad, (GstTaskFunction) gst_queue_loop, pad,
-            NULL);
+        result = gst_queue_start_task (queue);
         GST_QUEUE_MUTEX_UNLOCK (queue);
       } else {
         /* step 1, unblock loop function */
@@ -1780,7 +2364,7 @@ gst_queue_src_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
 static void
 queue_capacity_change (GstQueue * queue)
 {
-  if (queue->leaky == GST_QUEUE_LEAK_DOWNSTREAM) {
+  if (queue->leaky == GST_QUEUE_LEAK_DOWNSTREAM && !queue->ring) {
     gst_queue_leak_downstream (queue);
   }
 
@@ -1844,6 +2428,9 @@ gst_queue_set_property (GObject * object,
     case PROP_FLUSH_ON_EOS:
       queue->flush_on_eos = g_value_get_boolean (value);
       break;
+    case PROP_LOCK_FREE:
+      queue->lock_free = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1897,6 +2484,9 @@ gst_queue_get_property (GObject * object,
     case PROP_FLUSH_ON_EOS:
       g_value_set_boolean (value, queue->flush_on_eos);
       break;
+    case PROP_LOCK_FREE:
+      g_value_set_boolean (value, queue->lock_free);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
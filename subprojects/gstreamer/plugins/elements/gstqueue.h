@@ -46,6 +46,7 @@ typedef struct _GstQueue GstQueue;
 typedef struct _GstQueueSize GstQueueSize;
 typedef enum _GstQueueLeaky GstQueueLeaky;
 typedef struct _GstQueueClass GstQueueClass;
+typedef struct _GstQueueRingSlot GstQueueRingSlot;
 
 /**
  * GstQueueLeaky:
@@ -138,6 +139,15 @@ struct _GstQueue {
   GstQuery *last_handled_query;
 
   gboolean flush_on_eos; /* flush on EOS */
+
+  /* single producer, single consumer ring used instead of the queue array
+   * when lock-free is enabled. ring_head is only written by the srcpad task,
+   * ring_tail only by the sinkpad streaming thread */
+  gboolean lock_free;
+  GstQueueRingSlot *ring;
+  guint ring_size;
+  gint ring_head;
+  gint ring_tail;
 };
 
 struct _GstQueueClass {
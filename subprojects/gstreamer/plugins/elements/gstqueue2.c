@@ -85,6 +85,10 @@
 #include <fcntl.h>
 #endif
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -109,6 +113,8 @@ enum
 #define QUEUE_IS_USING_TEMP_FILE(queue) ((queue)->temp_template != NULL)
 #define QUEUE_IS_USING_RING_BUFFER(queue) ((queue)->ring_buffer_max_size != 0)  /* for consistency with the above macro */
 #define QUEUE_IS_USING_QUEUE(queue) (!QUEUE_IS_USING_TEMP_FILE(queue) && !QUEUE_IS_USING_RING_BUFFER (queue))
+/* the temp file is accessed with stdio and not through a memory mapping */
+#define QUEUE_IS_USING_FILE_IO(queue) (QUEUE_IS_USING_TEMP_FILE(queue) && (queue)->temp_map == NULL)
 
 #define QUEUE_MAX_BYTES(queue) MIN((queue)->max_level.bytes, (queue)->ring_buffer_max_size)
 
@@ -126,6 +132,11 @@ enum
 #define DEFAULT_TEMP_REMOVE        TRUE
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
 #define DEFAULT_USE_BITRATE_QUERY  TRUE
+#define DEFAULT_USE_MMAP           FALSE
+
+/* amount of data in the memory mapped temp file the kernel is asked to read
+ * ahead of the reading position */
+#define MMAP_READAHEAD_SIZE (2 * 1024 * 1024)
 
 enum
 {
@@ -150,6 +161,7 @@ enum
   PROP_AVG_IN_RATE,
   PROP_USE_BITRATE_QUERY,
   PROP_BITRATE,
+  PROP_USE_MMAP,
   PROP_LAST
 };
 static GParamSpec *obj_props[PROP_LAST] = { NULL, };
@@ -467,6 +479,23 @@ gst_queue2_class_init (GstQueue2Class * klass)
       "Conversion value between data size and time",
       0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GstQueue2:use-mmap:
+   *
+   * Memory map the temp file when it is used as a ring buffer, i.e. when
+   * both #GstQueue2:temp-template and #GstQueue2:ring-buffer-max-size are
+   * set. Data is then copied into and out of the mapping instead of being
+   * written and read with stdio on the streaming threads. The kernel writes
+   * the data back to the file asynchronously and reads ahead of the reading
+   * position, which makes seeking within the downloaded ranges cheap.
+   *
+   * Since: 1.22
+   */
+  obj_props[PROP_USE_MMAP] = g_param_spec_boolean ("use-mmap",
+      "Use mmap", "Memory map the temp file when it is used as a ring buffer",
+      DEFAULT_USE_MMAP,
+      G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
 
   /* set several parent class virtual functions */
@@ -564,6 +593,7 @@ gst_queue2_init (GstQueue2 * queue)
   queue->ring_buffer_max_size = DEFAULT_RING_BUFFER_MAX_SIZE;
 
   queue->use_bitrate_query = DEFAULT_USE_BITRATE_QUERY;
+  queue->use_mmap = DEFAULT_USE_MMAP;
 
   GST_DEBUG_OBJECT (queue,
       "initialized queue's not_empty & not_full conditions");
@@ -1481,15 +1511,30 @@ gst_queue2_read_data_at_offset (GstQueue2 * queue, guint64 offset, guint length,
   guint8 *ring_buffer;
   size_t res;
 
-  ring_buffer = queue->ring_buffer;
+  ring_buffer = queue->temp_map ? queue->temp_map : queue->ring_buffer;
 
-  if (QUEUE_IS_USING_TEMP_FILE (queue) && FSEEK_FILE (queue->temp_file, offset))
+  if (QUEUE_IS_USING_FILE_IO (queue) && FSEEK_FILE (queue->temp_file, offset))
     goto seek_failed;
 
+#if defined (HAVE_MMAP) && defined (MADV_WILLNEED)
+  /* make the kernel read the data after this one in the background, also
+   * after a seek */
+  if (queue->temp_map && (offset + length > queue->readahead_pos
+          || offset + MMAP_READAHEAD_SIZE < queue->readahead_pos)) {
+    guint64 start = offset & ~((guint64) 4095);
+    guint64 end = MIN (offset + length + MMAP_READAHEAD_SIZE,
+        queue->temp_map_size);
+
+    if (end > start)
+      madvise (queue->temp_map + start, end - start, MADV_WILLNEED);
+    queue->readahead_pos = end;
+  }
+#endif
+
   /* this should not block */
   GST_LOG_OBJECT (queue, "Reading %d bytes from offset %" G_GUINT64_FORMAT,
       length, offset);
-  if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+  if (QUEUE_IS_USING_FILE_IO (queue)) {
     res = fread (dst, 1, length, queue->temp_file);
   } else {
     memcpy (dst, ring_buffer + offset, length);
@@ -1499,7 +1544,7 @@ gst_queue2_read_data_at_offset (GstQueue2 * queue, guint64 offset, guint length,
   GST_LOG_OBJECT (queue, "read %" G_GSIZE_FORMAT " bytes", res);
 
   if (G_UNLIKELY (res < length)) {
-    if (!QUEUE_IS_USING_TEMP_FILE (queue))
+    if (!QUEUE_IS_USING_FILE_IO (queue))
       goto could_not_read;
     /* check for errors or EOF */
     if (ferror (queue->temp_file))
@@ -1749,6 +1794,53 @@ gst_queue2_read_item_from_file (GstQueue2 * queue)
   return item;
 }
 
+/* must be called with MUTEX_LOCK. Memory maps the temp file if requested and
+ * possible, otherwise the file is accessed with stdio. */
+static void
+gst_queue2_map_temp_file (GstQueue2 * queue, gint fd)
+{
+#ifdef HAVE_MMAP
+  gpointer map;
+
+  if (!queue->use_mmap || !QUEUE_IS_USING_RING_BUFFER (queue))
+    return;
+
+  if (queue->ring_buffer_max_size > G_MAXSIZE)
+    goto too_big;
+
+  /* the file must be as big as the mapping, reading past its end would
+   * raise SIGBUS */
+  if (ftruncate (fd, (off_t) queue->ring_buffer_max_size) != 0)
+    goto failed;
+
+  map = mmap (NULL, queue->ring_buffer_max_size, PROT_READ | PROT_WRITE,
+      MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED)
+    goto failed;
+
+  queue->temp_map = map;
+  queue->temp_map_size = queue->ring_buffer_max_size;
+  queue->readahead_pos = 0;
+
+  GST_DEBUG_OBJECT (queue, "mapped %" G_GUINT64_FORMAT " bytes of temp file",
+      queue->ring_buffer_max_size);
+  return;
+
+  /* ERRORS */
+too_big:
+  {
+    GST_WARNING_OBJECT (queue, "ring buffer too big to be mapped");
+    return;
+  }
+failed:
+  {
+    GST_WARNING_OBJECT (queue, "could not map the temp file, using stdio: %s",
+        g_strerror (errno));
+    return;
+  }
+#endif
+}
+
 /* must be called with MUTEX_LOCK. Will briefly release the lock when notifying
  * the temp filename. */
 static gboolean
@@ -1789,6 +1881,8 @@ gst_queue2_open_temp_location_file (GstQueue2 * queue)
   g_free (queue->temp_location);
   queue->temp_location = name;
 
+  gst_queue2_map_temp_file (queue, fd);
+
   GST_QUEUE2_MUTEX_UNLOCK (queue);
 
   /* we can't emit the notify with the lock */
@@ -1840,6 +1934,13 @@ gst_queue2_close_temp_location_file (GstQueue2 * queue)
 
   GST_DEBUG_OBJECT (queue, "closing temp file");
 
+#ifdef HAVE_MMAP
+  if (queue->temp_map) {
+    munmap (queue->temp_map, queue->temp_map_size);
+    queue->temp_map = NULL;
+  }
+#endif
+
   fflush (queue->temp_file);
   fclose (queue->temp_file);
 
@@ -1862,6 +1963,11 @@ gst_queue2_flush_temp_file (GstQueue2 * queue)
 
   GST_DEBUG_OBJECT (queue, "flushing temp file");
 
+  /* truncating the file would make the mapping invalid, the ranges are
+   * reset so the old data is overwritten */
+  if (queue->temp_map)
+    return;
+
   queue->temp_file = g_freopen (queue->temp_location, "wb+", queue->temp_file);
 }
 
@@ -1956,7 +2062,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
     writing_pos = queue->current->rb_writing_pos;
   else
     writing_pos = queue->current->writing_pos;
-  ring_buffer = queue->ring_buffer;
+  ring_buffer = queue->temp_map ? queue->temp_map : queue->ring_buffer;
   rb_size = queue->ring_buffer_max_size;
 
   if (!gst_buffer_map (buffer, &info, GST_MAP_READ))
@@ -2099,7 +2205,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
       new_writing_pos = writing_pos + to_write;
     }
 
-    if (QUEUE_IS_USING_TEMP_FILE (queue)
+    if (QUEUE_IS_USING_FILE_IO (queue)
         && FSEEK_FILE (queue->temp_file, writing_pos))
       goto seek_failed;
 
@@ -2109,7 +2215,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
           "] (rb wpos %" G_GUINT64_FORMAT ")", to_write, queue->current->offset,
           queue->current->writing_pos, queue->current->rb_writing_pos);
       /* either not using ring buffer or no wrapping, just write */
-      if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+      if (QUEUE_IS_USING_FILE_IO (queue)) {
         if (fwrite (data, to_write, 1, queue->temp_file) != 1)
           goto handle_error;
       } else {
@@ -2154,7 +2260,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
       if (block_one > 0) {
         GST_INFO_OBJECT (queue, "writing %u bytes", block_one);
         /* write data to end of ring buffer */
-        if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+        if (QUEUE_IS_USING_FILE_IO (queue)) {
           if (fwrite (data, block_one, 1, queue->temp_file) != 1)
             goto handle_error;
         } else {
@@ -2162,12 +2268,12 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
         }
       }
 
-      if (QUEUE_IS_USING_TEMP_FILE (queue) && FSEEK_FILE (queue->temp_file, 0))
+      if (QUEUE_IS_USING_FILE_IO (queue) && FSEEK_FILE (queue->temp_file, 0))
         goto seek_failed;
 
       if (block_two > 0) {
         GST_INFO_OBJECT (queue, "writing %u bytes", block_two);
-        if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+        if (QUEUE_IS_USING_FILE_IO (queue)) {
           if (fwrite (data + block_one, block_two, 1, queue->temp_file) != 1)
             goto handle_error;
         } else {
@@ -3979,6 +4085,9 @@ gst_queue2_set_property (GObject * object,
     case PROP_RING_BUFFER_MAX_SIZE:
       queue->ring_buffer_max_size = g_value_get_uint64 (value);
       break;
+    case PROP_USE_MMAP:
+      queue->use_mmap = g_value_get_boolean (value);
+      break;
     case PROP_USE_BITRATE_QUERY:
       queue->use_bitrate_query = g_value_get_boolean (value);
       break;
@@ -4053,6 +4162,9 @@ gst_queue2_get_property (GObject * object,
     case PROP_RING_BUFFER_MAX_SIZE:
       g_value_set_uint64 (value, queue->ring_buffer_max_size);
       break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, queue->use_mmap);
+      break;
     case PROP_AVG_IN_RATE:
     {
       gdouble in_rate = queue->byte_in_rate;
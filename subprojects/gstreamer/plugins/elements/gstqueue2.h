@@ -164,6 +164,12 @@ struct _GstQueue2
   guint64 ring_buffer_max_size;
   guint8 * ring_buffer;
 
+  /* memory mapped temp file used as ring buffer */
+  gboolean use_mmap;
+  guint8 * temp_map;
+  gsize temp_map_size;
+  guint64 readahead_pos;
+
   gint downstream_may_block;
 
   GstBufferingMode mode;
@@ -82,12 +82,54 @@ gst_tee_pull_mode_get_type (void)
   return type;
 }
 
+#define GST_TYPE_TEE_DISPATCH_MODE (gst_tee_dispatch_mode_get_type())
+static GType
+gst_tee_dispatch_mode_get_type (void)
+{
+  static GType type = 0;
+  static const GEnumValue data[] = {
+    {GST_TEE_DISPATCH_MODE_SEQUENTIAL,
+        "Push to the src pads one after the other", "sequential"},
+    {GST_TEE_DISPATCH_MODE_PARALLEL,
+        "Push to the src pads concurrently from a shared thread pool",
+        "parallel"},
+    {0, NULL, NULL},
+  };
+
+  if (!type) {
+    type = g_enum_register_static ("GstTeeDispatchMode", data);
+  }
+  return type;
+}
+
+#define GST_TYPE_TEE_LEAKY (gst_tee_leaky_get_type())
+static GType
+gst_tee_leaky_get_type (void)
+{
+  static GType type = 0;
+  static const GEnumValue data[] = {
+    {GST_TEE_LEAKY_NO, "Not Leaky", "no"},
+    {GST_TEE_LEAKY_UPSTREAM, "Leaky on upstream (new buffers)", "upstream"},
+    {GST_TEE_LEAKY_DOWNSTREAM, "Leaky on downstream (old buffers)",
+        "downstream"},
+    {0, NULL, NULL},
+  };
+
+  if (!type) {
+    type = g_enum_register_static ("GstTeeLeaky", data);
+  }
+  return type;
+}
+
 #define DEFAULT_PROP_NUM_SRC_PADS	0
 #define DEFAULT_PROP_HAS_CHAIN		TRUE
 #define DEFAULT_PROP_SILENT		TRUE
 #define DEFAULT_PROP_LAST_MESSAGE	NULL
 #define DEFAULT_PULL_MODE		GST_TEE_PULL_MODE_NEVER
 #define DEFAULT_PROP_ALLOW_NOT_LINKED	FALSE
+#define DEFAULT_PROP_DISPATCH_MODE	GST_TEE_DISPATCH_MODE_SEQUENTIAL
+#define DEFAULT_PROP_MAX_BACKLOG	8
+#define DEFAULT_PROP_LEAKY		GST_TEE_LEAKY_NO
 
 enum
 {
@@ -99,6 +141,9 @@ enum
   PROP_PULL_MODE,
   PROP_ALLOC_PAD,
   PROP_ALLOW_NOT_LINKED,
+  PROP_DISPATCH_MODE,
+  PROP_MAX_BACKLOG,
+  PROP_LEAKY,
 };
 
 static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src_%u",
@@ -141,6 +186,12 @@ struct _GstTeePad
   gboolean pushed;
   GstFlowReturn result;
   gboolean removed;
+
+  /* parallel dispatch, protected by the tee object lock */
+  GstTee *tee;
+  GQueue backlog;
+  gboolean scheduled;
+  gboolean queued;
 };
 
 struct _GstTeePadClass
@@ -150,9 +201,29 @@ struct _GstTeePadClass
 
 G_DEFINE_TYPE (GstTeePad, gst_tee_pad, GST_TYPE_PAD);
 
+static void
+gst_tee_pad_clear_backlog (GstTeePad * pad)
+{
+  GstMiniObject *item;
+
+  while ((item = g_queue_pop_head (&pad->backlog)))
+    gst_mini_object_unref (item);
+}
+
+static void
+gst_tee_pad_finalize (GObject * object)
+{
+  gst_tee_pad_clear_backlog (GST_TEE_PAD_CAST (object));
+
+  G_OBJECT_CLASS (gst_tee_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_tee_pad_class_init (GstTeePadClass * klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->finalize = gst_tee_pad_finalize;
 }
 
 static void
@@ -167,6 +238,7 @@ static void
 gst_tee_pad_init (GstTeePad * pad)
 {
   gst_tee_pad_reset (pad);
+  g_queue_init (&pad->backlog);
 }
 
 static GstPad *gst_tee_request_new_pad (GstElement * element,
@@ -225,6 +297,8 @@ gst_tee_finalize (GObject * object)
 
   g_free (tee->last_message);
 
+  g_cond_clear (&tee->dispatch_cond);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -288,6 +362,59 @@ gst_tee_class_init (GstTeeClass * klass)
           "all unlinked", DEFAULT_PROP_ALLOW_NOT_LINKED,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstTee:dispatch-mode
+   *
+   * How data is pushed to the src pads. In parallel mode, every src pad gets
+   * a backlog of up to #GstTee:max-backlog items that is pushed downstream
+   * from a thread pool shared by all tee elements, so a slow branch does not
+   * delay the other branches and no queue element is needed per branch.
+   * Threads are only busy while a branch has data to push.
+   *
+   * Flow errors of a branch are returned upstream with the next buffer, and
+   * serialized events and queries wait until all branches pushed their
+   * backlog.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_DISPATCH_MODE,
+      g_param_spec_enum ("dispatch-mode", "Dispatch mode",
+          "How data is pushed to the src pads", GST_TYPE_TEE_DISPATCH_MODE,
+          DEFAULT_PROP_DISPATCH_MODE,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstTee:max-backlog
+   *
+   * The maximum number of buffers or buffer lists queued for each src pad
+   * in parallel #GstTee:dispatch-mode.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_BACKLOG,
+      g_param_spec_uint ("max-backlog", "Max backlog",
+          "Maximum number of buffers queued per src pad in parallel "
+          "dispatch mode", 1, G_MAXUINT, DEFAULT_PROP_MAX_BACKLOG,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstTee:leaky
+   *
+   * What to do when the backlog of a src pad is full in parallel
+   * #GstTee:dispatch-mode. When not leaky, upstream is blocked until the
+   * branch pushed some of its backlog.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_LEAKY,
+      g_param_spec_enum ("leaky", "Leaky",
+          "Where to drop buffers when the backlog of a src pad is full in "
+          "parallel dispatch mode", GST_TYPE_TEE_LEAKY, DEFAULT_PROP_LEAKY,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "Tee pipe fitting",
       "Generic",
@@ -301,6 +428,8 @@ gst_tee_class_init (GstTeeClass * klass)
   gstelement_class->release_pad = GST_DEBUG_FUNCPTR (gst_tee_release_pad);
 
   gst_type_mark_as_plugin_api (GST_TYPE_TEE_PULL_MODE, 0);
+  gst_type_mark_as_plugin_api (GST_TYPE_TEE_DISPATCH_MODE, 0);
+  gst_type_mark_as_plugin_api (GST_TYPE_TEE_LEAKY, 0);
 }
 
 static void
@@ -324,6 +453,11 @@ gst_tee_init (GstTee * tee)
   tee->pad_indexes = g_hash_table_new (NULL, NULL);
 
   tee->last_message = NULL;
+
+  tee->dispatch_mode = DEFAULT_PROP_DISPATCH_MODE;
+  tee->max_backlog = DEFAULT_PROP_MAX_BACKLOG;
+  tee->leaky = DEFAULT_PROP_LEAKY;
+  g_cond_init (&tee->dispatch_cond);
 }
 
 static void
@@ -390,6 +524,7 @@ gst_tee_request_new_pad (GstElement * element, GstPadTemplate * templ,
           "name", name, "direction", templ->direction, "template", templ,
           NULL));
   GST_TEE_PAD_CAST (srcpad)->index = index;
+  GST_TEE_PAD_CAST (srcpad)->tee = tee;
   g_free (name);
 
   mode = tee->sink_mode;
@@ -458,6 +593,10 @@ gst_tee_release_pad (GstElement * element, GstPad * pad)
   index = GST_TEE_PAD_CAST (pad)->index;
   /* mark the pad as removed so that future pad_alloc fails with NOT_LINKED. */
   GST_TEE_PAD_CAST (pad)->removed = TRUE;
+  /* drop what was not pushed yet and wake up upstream if it waits for
+   * room in the backlog */
+  gst_tee_pad_clear_backlog (GST_TEE_PAD_CAST (pad));
+  g_cond_broadcast (&tee->dispatch_cond);
   if (tee->allocpad == pad) {
     tee->allocpad = NULL;
     changed = TRUE;
@@ -508,6 +647,17 @@ gst_tee_set_property (GObject * object, guint prop_id, const GValue * value,
     case PROP_ALLOW_NOT_LINKED:
       tee->allow_not_linked = g_value_get_boolean (value);
       break;
+    case PROP_DISPATCH_MODE:
+      tee->dispatch_mode = (GstTeeDispatchMode) g_value_get_enum (value);
+      break;
+    case PROP_MAX_BACKLOG:
+      tee->max_backlog = g_value_get_uint (value);
+      g_cond_broadcast (&tee->dispatch_cond);
+      break;
+    case PROP_LEAKY:
+      tee->leaky = (GstTeeLeaky) g_value_get_enum (value);
+      g_cond_broadcast (&tee->dispatch_cond);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -544,6 +694,15 @@ gst_tee_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_ALLOW_NOT_LINKED:
       g_value_set_boolean (value, tee->allow_not_linked);
       break;
+    case PROP_DISPATCH_MODE:
+      g_value_set_enum (value, tee->dispatch_mode);
+      break;
+    case PROP_MAX_BACKLOG:
+      g_value_set_uint (value, tee->max_backlog);
+      break;
+    case PROP_LEAKY:
+      g_value_set_enum (value, tee->leaky);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -551,11 +710,63 @@ gst_tee_get_property (GObject * object, guint prop_id, GValue * value,
   GST_OBJECT_UNLOCK (tee);
 }
 
+/* with LOCK, waits until all src pads pushed their backlog */
+static void
+gst_tee_dispatch_wait_idle (GstTee * tee)
+{
+  GList *pads;
+
+restart:
+  for (pads = GST_ELEMENT_CAST (tee)->srcpads; pads; pads = pads->next) {
+    GstTeePad *tpad = GST_TEE_PAD_CAST (pads->data);
+
+    if (tpad->scheduled && !tee->dispatch_flushing) {
+      g_cond_wait (&tee->dispatch_cond, GST_OBJECT_GET_LOCK (tee));
+      goto restart;
+    }
+  }
+}
+
+/* with LOCK */
+static void
+gst_tee_dispatch_set_flushing (GstTee * tee, gboolean flushing)
+{
+  GList *pads;
+
+  tee->dispatch_flushing = flushing;
+  if (!flushing)
+    tee->flush_seq++;
+  for (pads = GST_ELEMENT_CAST (tee)->srcpads; pads; pads = pads->next) {
+    GstTeePad *tpad = GST_TEE_PAD_CAST (pads->data);
+
+    if (flushing) {
+      gst_tee_pad_clear_backlog (tpad);
+    } else {
+      tpad->pushed = FALSE;
+      tpad->result = GST_FLOW_NOT_LINKED;
+    }
+  }
+  g_cond_broadcast (&tee->dispatch_cond);
+}
+
 static gboolean
 gst_tee_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
+  GstTee *tee = GST_TEE (parent);
   gboolean res;
 
+  GST_OBJECT_LOCK (tee);
+  if (tee->dispatch_mode == GST_TEE_DISPATCH_MODE_PARALLEL) {
+    if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_START)
+      gst_tee_dispatch_set_flushing (tee, TRUE);
+    else if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP)
+      gst_tee_dispatch_set_flushing (tee, FALSE);
+    else if (GST_EVENT_IS_SERIALIZED (event))
+      /* keep the event in order with the queued buffers */
+      gst_tee_dispatch_wait_idle (tee);
+  }
+  GST_OBJECT_UNLOCK (tee);
+
   switch (GST_EVENT_TYPE (event)) {
     default:
       res = gst_pad_event_default (pad, parent, event);
@@ -739,6 +950,13 @@ gst_tee_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
   GstTee *tee = GST_TEE (parent);
   gboolean res;
 
+  if (GST_QUERY_IS_SERIALIZED (query)) {
+    GST_OBJECT_LOCK (tee);
+    if (tee->dispatch_mode == GST_TEE_DISPATCH_MODE_PARALLEL)
+      gst_tee_dispatch_wait_idle (tee);
+    GST_OBJECT_UNLOCK (tee);
+  }
+
   switch (GST_QUERY_TYPE (query)) {
     case GST_QUERY_ALLOCATION:
     {
@@ -865,6 +1083,171 @@ clear_pads (GstPad * pad, GstTee * tee)
   GST_TEE_PAD_CAST (pad)->result = GST_FLOW_NOT_LINKED;
 }
 
+/* pushes the backlog of a src pad, runs in a thread of the dispatch pool */
+static void
+gst_tee_dispatch_func (GstTeePad * tpad, gpointer user_data)
+{
+  GstTee *tee = tpad->tee;
+  GstMiniObject *item;
+  GstFlowReturn ret;
+  guint flush_seq;
+
+  GST_OBJECT_LOCK (tee);
+  while ((item = g_queue_pop_head (&tpad->backlog))) {
+    /* there is room in the backlog again */
+    g_cond_broadcast (&tee->dispatch_cond);
+    flush_seq = tee->flush_seq;
+    GST_OBJECT_UNLOCK (tee);
+
+    if (GST_IS_BUFFER_LIST (item))
+      ret = gst_pad_push_list (GST_PAD_CAST (tpad), GST_BUFFER_LIST (item));
+    else
+      ret = gst_pad_push (GST_PAD_CAST (tpad), GST_BUFFER (item));
+
+    GST_LOG_OBJECT (tpad, "Pushing item %p yielded result %s", item,
+        gst_flow_get_name (ret));
+
+    GST_OBJECT_LOCK (tee);
+    /* a flush happened while pushing, the FLUSHING result belongs to the
+     * previous flush and must not be returned upstream after it */
+    if (G_UNLIKELY (flush_seq != tee->flush_seq)) {
+      GST_DEBUG_OBJECT (tpad, "ignoring result %s from before flush",
+          gst_flow_get_name (ret));
+      continue;
+    }
+    if (tpad->removed)
+      ret = GST_FLOW_NOT_LINKED;
+    tpad->pushed = TRUE;
+    tpad->result = ret;
+
+    /* the error is returned upstream with the next buffer, there is
+     * no point in pushing the rest */
+    if (G_UNLIKELY (ret != GST_FLOW_OK && ret != GST_FLOW_NOT_LINKED))
+      gst_tee_pad_clear_backlog (tpad);
+  }
+  tpad->scheduled = FALSE;
+  g_cond_broadcast (&tee->dispatch_cond);
+  GST_OBJECT_UNLOCK (tee);
+
+  gst_object_unref (tpad);
+  gst_object_unref (tee);
+}
+
+static GThreadPool *
+gst_tee_get_dispatch_pool (void)
+{
+  static GThreadPool *pool = NULL;
+
+  if (g_once_init_enter (&pool)) {
+    GThreadPool *p;
+
+    /* not limited, a branch blocked in preroll must not keep the other
+     * branches from getting their data */
+    p = g_thread_pool_new ((GFunc) gst_tee_dispatch_func, NULL, -1, FALSE,
+        NULL);
+    g_once_init_leave (&pool, p);
+  }
+
+  return pool;
+}
+
+static GstFlowReturn
+gst_tee_dispatch_data (GstTee * tee, gpointer data)
+{
+  GList *pads;
+  guint32 cookie;
+  GstFlowReturn ret, cret;
+
+  GST_OBJECT_LOCK (tee);
+  for (pads = GST_ELEMENT_CAST (tee)->srcpads; pads; pads = pads->next)
+    GST_TEE_PAD_CAST (pads->data)->queued = FALSE;
+
+restart:
+  if (tee->allow_not_linked) {
+    cret = GST_FLOW_OK;
+  } else {
+    cret = GST_FLOW_NOT_LINKED;
+  }
+  pads = GST_ELEMENT_CAST (tee)->srcpads;
+  cookie = GST_ELEMENT_CAST (tee)->pads_cookie;
+
+  for (; pads; pads = pads->next) {
+    GstTeePad *tpad = GST_TEE_PAD_CAST (pads->data);
+
+    if (GST_PAD_CAST (tpad) == tee->pull_pad)
+      continue;
+
+    /* result of the last push on this pad, pads that did not push anything
+     * yet count as linked */
+    ret = tpad->pushed ? tpad->result : GST_FLOW_OK;
+    if (G_UNLIKELY (ret != GST_FLOW_OK && ret != GST_FLOW_NOT_LINKED))
+      goto error;
+    if (G_LIKELY (ret != GST_FLOW_NOT_LINKED))
+      cret = ret;
+
+    if (tpad->queued)
+      continue;
+
+    while (tpad->backlog.length >= tee->max_backlog && !tpad->removed
+        && !tee->dispatch_flushing) {
+      if (tee->leaky == GST_TEE_LEAKY_UPSTREAM) {
+        GST_DEBUG_OBJECT (tpad, "backlog full, dropping new item");
+        break;
+      } else if (tee->leaky == GST_TEE_LEAKY_DOWNSTREAM) {
+        GST_DEBUG_OBJECT (tpad, "backlog full, dropping old item");
+        gst_mini_object_unref (g_queue_pop_head (&tpad->backlog));
+        break;
+      }
+
+      g_cond_wait (&tee->dispatch_cond, GST_OBJECT_GET_LOCK (tee));
+
+      if (G_UNLIKELY (GST_ELEMENT_CAST (tee)->pads_cookie != cookie)) {
+        GST_LOG_OBJECT (tee, "pad list changed");
+        goto restart;
+      }
+    }
+
+    if (G_UNLIKELY (tee->dispatch_flushing))
+      goto flushing;
+
+    tpad->queued = TRUE;
+    if (tpad->removed || tpad->backlog.length >= tee->max_backlog)
+      continue;
+
+    g_queue_push_tail (&tpad->backlog, gst_mini_object_ref (data));
+    if (!tpad->scheduled) {
+      tpad->scheduled = TRUE;
+      gst_object_ref (tee);
+      gst_object_ref (tpad);
+      g_thread_pool_push (gst_tee_get_dispatch_pool (), tpad, NULL);
+    }
+  }
+  GST_OBJECT_UNLOCK (tee);
+
+  gst_mini_object_unref (GST_MINI_OBJECT_CAST (data));
+
+  return cret;
+
+  /* ERRORS */
+flushing:
+  {
+    GST_DEBUG_OBJECT (tee, "flushing");
+    ret = GST_FLOW_FLUSHING;
+    goto done;
+  }
+error:
+  {
+    GST_DEBUG_OBJECT (tee, "branch returned %s", gst_flow_get_name (ret));
+    goto done;
+  }
+done:
+  {
+    GST_OBJECT_UNLOCK (tee);
+    gst_mini_object_unref (GST_MINI_OBJECT_CAST (data));
+    return ret;
+  }
+}
+
 static GstFlowReturn
 gst_tee_handle_data (GstTee * tee, gpointer data, gboolean is_list)
 {
@@ -878,6 +1261,11 @@ gst_tee_handle_data (GstTee * tee, gpointer data, gboolean is_list)
   GST_OBJECT_LOCK (tee);
   pads = GST_ELEMENT_CAST (tee)->srcpads;
 
+  if (tee->dispatch_mode == GST_TEE_DISPATCH_MODE_PARALLEL && pads) {
+    GST_OBJECT_UNLOCK (tee);
+    return gst_tee_dispatch_data (tee, data);
+  }
+
   /* special case for zero pads */
   if (G_UNLIKELY (!pads))
     goto no_pads;
@@ -1061,6 +1449,9 @@ gst_tee_sink_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
     {
       GST_OBJECT_LOCK (tee);
       tee->sink_mode = active ? mode : GST_PAD_MODE_NONE;
+      /* unblocks upstream when deactivating and resets the flow returns of
+       * previous runs when activating */
+      gst_tee_dispatch_set_flushing (tee, !active);
 
       if (active && !tee->has_chain)
         goto no_chain;
@@ -57,6 +57,39 @@ typedef enum {
   GST_TEE_PULL_MODE_SINGLE,
 } GstTeePullMode;
 
+/**
+ * GstTeeDispatchMode:
+ * @GST_TEE_DISPATCH_MODE_SEQUENTIAL: Push to the src pads one after the other
+ *     from the upstream streaming thread.
+ * @GST_TEE_DISPATCH_MODE_PARALLEL: Queue the data for each src pad and push it
+ *     to the src pads concurrently from a shared pool of threads.
+ *
+ * How tee pushes data to its src pads.
+ *
+ * Since: 1.22
+ */
+typedef enum {
+  GST_TEE_DISPATCH_MODE_SEQUENTIAL,
+  GST_TEE_DISPATCH_MODE_PARALLEL,
+} GstTeeDispatchMode;
+
+/**
+ * GstTeeLeaky:
+ * @GST_TEE_LEAKY_NO: Block upstream until a full branch has room again.
+ * @GST_TEE_LEAKY_UPSTREAM: Drop new data for a full branch.
+ * @GST_TEE_LEAKY_DOWNSTREAM: Drop the oldest queued data of a full branch.
+ *
+ * What tee does in %GST_TEE_DISPATCH_MODE_PARALLEL when the backlog of a
+ * src pad is full.
+ *
+ * Since: 1.22
+ */
+typedef enum {
+  GST_TEE_LEAKY_NO,
+  GST_TEE_LEAKY_UPSTREAM,
+  GST_TEE_LEAKY_DOWNSTREAM,
+} GstTeeLeaky;
+
 /**
  * GstTee:
  *
@@ -81,6 +114,16 @@ struct _GstTee {
   GstPad         *pull_pad;
 
   gboolean        allow_not_linked;
+
+  /* parallel dispatch, protected by the object lock */
+  GstTeeDispatchMode dispatch_mode;
+  guint           max_backlog;
+  GstTeeLeaky     leaky;
+  gboolean        dispatch_flushing;
+  /* incremented on every flush stop, to ignore the results of pushes
+   * that started before */
+  guint           flush_seq;
+  GCond           dispatch_cond;
 };
 
 struct _GstTeeClass {
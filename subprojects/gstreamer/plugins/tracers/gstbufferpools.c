@@ -0,0 +1,566 @@
+/* GStreamer
+ *
+ * gstbufferpools.c: tracing module for buffer pool and allocator usage
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-bufferpools
+ * @short_description: log buffer pool and allocator usage
+ *
+ * A tracing module that keeps track of how #GstBufferPool and #GstAllocator
+ * objects are used.
+ *
+ * For every buffer pool it counts the acquired and outstanding buffers and
+ * the time threads spent waiting for a buffer to be released to the pool,
+ * as a total, a maximum and a histogram. For every allocator it counts the
+ * allocations and the bytes allocated in total and currently alive.
+ *
+ * A `buffer-pool-stats` or `allocator-stats` record is logged when a pool or
+ * allocator is destroyed and for all remaining ones when the tracer is
+ * destroyed:
+ *
+ * ```
+ * $ GST_TRACERS=bufferpools GST_DEBUG=GST_TRACER:7 gst-launch-1.0 ...
+ * ```
+ *
+ * The #GstBufferPoolsTracer::get-stats action signal returns the current
+ * statistics while the tracer is running.
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gstbufferpools.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_buffer_pools_debug);
+#define GST_CAT_DEFAULT gst_buffer_pools_debug
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_buffer_pools_debug, "bufferpools", 0, \
+        "buffer pools tracer");
+#define gst_buffer_pools_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstBufferPoolsTracer, gst_buffer_pools_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+enum
+{
+  /* actions */
+  SIGNAL_GET_STATS,
+
+  LAST_SIGNAL
+};
+
+static guint gst_buffer_pools_tracer_signals[LAST_SIGNAL] = { 0 };
+
+static GstTracerRecord *tr_pool_stats;
+static GstTracerRecord *tr_allocator_stats;
+
+/* bucket 0 counts waits below 1us, bucket i counts waits in
+ * [2^(i-1), 2^i) us and the last bucket all longer waits */
+#define WAIT_HISTOGRAM_BUCKETS 24
+
+typedef struct
+{
+  gchar *name;
+  guint64 num_acquired;
+  guint outstanding;
+  guint max_outstanding;
+  guint64 num_waits;
+  GstClockTime wait_time;
+  GstClockTime max_wait_time;
+  guint64 wait_histogram[WAIT_HISTOGRAM_BUCKETS];
+} GstPoolStats;
+
+typedef struct
+{
+  gchar *name;
+  guint64 num_allocs;
+  guint64 num_bytes;
+  guint64 live_allocs;
+  guint64 live_bytes;
+  guint64 max_live_bytes;
+} GstAllocatorStats;
+
+/* start of the current wait of a thread on a buffer pool */
+static GPrivate wait_start = G_PRIVATE_INIT (g_free);
+
+static void
+free_pool_stats (GstPoolStats * stats)
+{
+  g_free (stats->name);
+  g_free (stats);
+}
+
+static void
+free_allocator_stats (GstAllocatorStats * stats)
+{
+  g_free (stats->name);
+  g_free (stats);
+}
+
+/* called with the lock */
+static GstPoolStats *
+get_pool_stats (GstBufferPoolsTracer * self, GstBufferPool * pool)
+{
+  GstPoolStats *stats = g_hash_table_lookup (self->pools, pool);
+
+  if (G_UNLIKELY (!stats)) {
+    stats = g_new0 (GstPoolStats, 1);
+    stats->name = gst_object_get_name (GST_OBJECT_CAST (pool));
+    g_hash_table_insert (self->pools, pool, stats);
+  }
+  return stats;
+}
+
+/* called with the lock */
+static GstAllocatorStats *
+get_allocator_stats (GstBufferPoolsTracer * self, GstAllocator * allocator)
+{
+  GstAllocatorStats *stats = g_hash_table_lookup (self->allocators, allocator);
+
+  if (G_UNLIKELY (!stats)) {
+    stats = g_new0 (GstAllocatorStats, 1);
+    stats->name = gst_object_get_name (GST_OBJECT_CAST (allocator));
+    g_hash_table_insert (self->allocators, allocator, stats);
+  }
+  return stats;
+}
+
+static guint
+wait_histogram_index (GstClockTime wait)
+{
+  guint64 us = wait / GST_USECOND;
+  guint ix = 0;
+
+  while (us && ix < WAIT_HISTOGRAM_BUCKETS - 1) {
+    us >>= 1;
+    ix++;
+  }
+  return ix;
+}
+
+static void
+log_pool_stats (GstPoolStats * stats, GstClockTime ts)
+{
+  gst_tracer_record_log (tr_pool_stats, ts, stats->name, stats->num_acquired,
+      stats->outstanding, stats->max_outstanding, stats->num_waits,
+      stats->wait_time, stats->max_wait_time);
+}
+
+static void
+log_allocator_stats (GstAllocatorStats * stats, GstClockTime ts)
+{
+  gst_tracer_record_log (tr_allocator_stats, ts, stats->name,
+      stats->num_allocs, stats->num_bytes, stats->live_allocs,
+      stats->live_bytes, stats->max_live_bytes);
+}
+
+static GstStructure *
+get_pool_summary (GstPoolStats * stats)
+{
+  GstStructure *s;
+  GValue histogram = G_VALUE_INIT;
+  guint i;
+
+  g_value_init (&histogram, GST_TYPE_ARRAY);
+  for (i = 0; i < WAIT_HISTOGRAM_BUCKETS; i++) {
+    GValue v = G_VALUE_INIT;
+
+    g_value_init (&v, G_TYPE_UINT64);
+    g_value_set_uint64 (&v, stats->wait_histogram[i]);
+    gst_value_array_append_and_take_value (&histogram, &v);
+  }
+
+  s = gst_structure_new ("buffer-pool-stats",
+      "name", G_TYPE_STRING, stats->name,
+      "num-acquired", G_TYPE_UINT64, stats->num_acquired,
+      "outstanding", G_TYPE_UINT, stats->outstanding,
+      "max-outstanding", G_TYPE_UINT, stats->max_outstanding,
+      "num-waits", G_TYPE_UINT64, stats->num_waits,
+      "wait-time", G_TYPE_UINT64, stats->wait_time,
+      "max-wait-time", G_TYPE_UINT64, stats->max_wait_time, NULL);
+  gst_structure_take_value (s, "wait-histogram", &histogram);
+
+  return s;
+}
+
+static GstStructure *
+get_allocator_summary (GstAllocatorStats * stats)
+{
+  return gst_structure_new ("allocator-stats",
+      "name", G_TYPE_STRING, stats->name,
+      "num-allocs", G_TYPE_UINT64, stats->num_allocs,
+      "num-bytes", G_TYPE_UINT64, stats->num_bytes,
+      "live-allocs", G_TYPE_UINT64, stats->live_allocs,
+      "live-bytes", G_TYPE_UINT64, stats->live_bytes,
+      "max-live-bytes", G_TYPE_UINT64, stats->max_live_bytes, NULL);
+}
+
+/* hooks */
+
+static void
+do_buffer_acquired (GstBufferPoolsTracer * self, GstClockTime ts,
+    GstBufferPool * pool, GstBuffer * buffer)
+{
+  GstPoolStats *stats;
+
+  g_mutex_lock (&self->lock);
+  stats = get_pool_stats (self, pool);
+  stats->num_acquired++;
+  stats->outstanding++;
+  stats->max_outstanding = MAX (stats->max_outstanding, stats->outstanding);
+  g_mutex_unlock (&self->lock);
+}
+
+static void
+do_buffer_released (GstBufferPoolsTracer * self, GstClockTime ts,
+    GstBufferPool * pool, GstBuffer * buffer)
+{
+  GstPoolStats *stats;
+
+  g_mutex_lock (&self->lock);
+  stats = g_hash_table_lookup (self->pools, pool);
+  /* buffers acquired before the tracer was created are not counted */
+  if (stats && stats->outstanding > 0)
+    stats->outstanding--;
+  g_mutex_unlock (&self->lock);
+}
+
+static void
+do_wait_pre (GstBufferPoolsTracer * self, GstClockTime ts,
+    GstBufferPool * pool)
+{
+  GstClockTime *start = g_private_get (&wait_start);
+
+  if (G_UNLIKELY (!start)) {
+    start = g_new (GstClockTime, 1);
+    g_private_set (&wait_start, start);
+  }
+  *start = ts;
+}
+
+static void
+do_wait_post (GstBufferPoolsTracer * self, GstClockTime ts,
+    GstBufferPool * pool)
+{
+  GstClockTime *start = g_private_get (&wait_start);
+  GstClockTime wait;
+  GstPoolStats *stats;
+
+  if (G_UNLIKELY (!start || !GST_CLOCK_TIME_IS_VALID (*start)))
+    return;
+
+  wait = GST_CLOCK_DIFF (*start, ts);
+  *start = GST_CLOCK_TIME_NONE;
+
+  g_mutex_lock (&self->lock);
+  stats = get_pool_stats (self, pool);
+  stats->num_waits++;
+  stats->wait_time += wait;
+  stats->max_wait_time = MAX (stats->max_wait_time, wait);
+  stats->wait_histogram[wait_histogram_index (wait)]++;
+  g_mutex_unlock (&self->lock);
+}
+
+static void
+do_memory_alloc (GstBufferPoolsTracer * self, GstClockTime ts,
+    GstAllocator * allocator, GstMemory * memory)
+{
+  GstAllocatorStats *stats;
+  gsize size = memory->maxsize;
+
+  g_mutex_lock (&self->lock);
+  stats = get_allocator_stats (self, allocator);
+  stats->num_allocs++;
+  stats->num_bytes += size;
+  stats->live_allocs++;
+  stats->live_bytes += size;
+  stats->max_live_bytes = MAX (stats->max_live_bytes, stats->live_bytes);
+  g_hash_table_insert (self->memories, memory, GSIZE_TO_POINTER (size));
+  g_mutex_unlock (&self->lock);
+}
+
+static void
+do_memory_free (GstBufferPoolsTracer * self, GstClockTime ts,
+    GstAllocator * allocator, GstMemory * memory)
+{
+  GstAllocatorStats *stats;
+  gpointer size;
+
+  g_mutex_lock (&self->lock);
+  /* memory that was not allocated with gst_allocator_alloc() while we were
+   * running is not counted */
+  if (g_hash_table_lookup_extended (self->memories, memory, NULL, &size)) {
+    g_hash_table_remove (self->memories, memory);
+    stats = get_allocator_stats (self, allocator);
+    stats->live_allocs--;
+    stats->live_bytes -= GPOINTER_TO_SIZE (size);
+  }
+  g_mutex_unlock (&self->lock);
+}
+
+static void
+do_object_destroyed (GstBufferPoolsTracer * self, GstClockTime ts,
+    GstObject * object)
+{
+  gpointer stats;
+
+  if (GST_IS_BUFFER_POOL (object)) {
+    g_mutex_lock (&self->lock);
+    if ((stats = g_hash_table_lookup (self->pools, object))) {
+      log_pool_stats (stats, ts);
+      g_hash_table_remove (self->pools, object);
+    }
+    g_mutex_unlock (&self->lock);
+  } else if (GST_IS_ALLOCATOR (object)) {
+    g_mutex_lock (&self->lock);
+    if ((stats = g_hash_table_lookup (self->allocators, object))) {
+      log_allocator_stats (stats, ts);
+      g_hash_table_remove (self->allocators, object);
+    }
+    g_mutex_unlock (&self->lock);
+  }
+}
+
+/* tracer class */
+
+static GstStructure *
+gst_buffer_pools_tracer_get_stats (GstBufferPoolsTracer * self)
+{
+  GstStructure *info;
+  GValue pools = G_VALUE_INIT;
+  GValue allocators = G_VALUE_INIT;
+  GHashTableIter iter;
+  gpointer stats;
+
+  g_value_init (&pools, GST_TYPE_LIST);
+  g_value_init (&allocators, GST_TYPE_LIST);
+
+  g_mutex_lock (&self->lock);
+  g_hash_table_iter_init (&iter, self->pools);
+  while (g_hash_table_iter_next (&iter, NULL, &stats)) {
+    GValue s_value = G_VALUE_INIT;
+
+    g_value_init (&s_value, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&s_value, get_pool_summary (stats));
+    gst_value_list_append_and_take_value (&pools, &s_value);
+  }
+  g_hash_table_iter_init (&iter, self->allocators);
+  while (g_hash_table_iter_next (&iter, NULL, &stats)) {
+    GValue s_value = G_VALUE_INIT;
+
+    g_value_init (&s_value, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&s_value, get_allocator_summary (stats));
+    gst_value_list_append_and_take_value (&allocators, &s_value);
+  }
+  g_mutex_unlock (&self->lock);
+
+  info = gst_structure_new_empty ("bufferpools");
+  gst_structure_take_value (info, "pools", &pools);
+  gst_structure_take_value (info, "allocators", &allocators);
+
+  return info;
+}
+
+static void
+gst_buffer_pools_tracer_constructed (GObject * object)
+{
+  GstBufferPoolsTracer *self = GST_BUFFER_POOLS_TRACER (object);
+  gchar *params, *tmp;
+  const gchar *name;
+  GstStructure *params_struct = NULL;
+
+  g_object_get (self, "params", &params, NULL);
+
+  if (!params)
+    return;
+
+  tmp = g_strdup_printf ("bufferpools,%s", params);
+  params_struct = gst_structure_from_string (tmp, NULL);
+  g_free (tmp);
+  g_free (params);
+  if (!params_struct)
+    return;
+
+  /* Set the name if assigned */
+  name = gst_structure_get_string (params_struct, "name");
+  if (name)
+    gst_object_set_name (GST_OBJECT (self), name);
+
+  gst_structure_free (params_struct);
+}
+
+static void
+gst_buffer_pools_tracer_finalize (GObject * object)
+{
+  GstBufferPoolsTracer *self = GST_BUFFER_POOLS_TRACER (object);
+  GstClockTime ts = gst_util_get_timestamp ();
+  GHashTableIter iter;
+  gpointer stats;
+
+  g_hash_table_iter_init (&iter, self->pools);
+  while (g_hash_table_iter_next (&iter, NULL, &stats))
+    log_pool_stats (stats, ts);
+  g_hash_table_iter_init (&iter, self->allocators);
+  while (g_hash_table_iter_next (&iter, NULL, &stats))
+    log_allocator_stats (stats, ts);
+
+  g_hash_table_unref (self->pools);
+  g_hash_table_unref (self->allocators);
+  g_hash_table_unref (self->memories);
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_buffer_pools_tracer_class_init (GstBufferPoolsTracerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->constructed = gst_buffer_pools_tracer_constructed;
+  gobject_class->finalize = gst_buffer_pools_tracer_finalize;
+
+  /* announce trace formats */
+  /* *INDENT-OFF* */
+  tr_pool_stats = gst_tracer_record_new ("buffer-pool-stats.class",
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "summary ts",
+          NULL),
+      "name", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "name of the buffer pool",
+          NULL),
+      "num-acquired", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of buffers acquired",
+          NULL),
+      "outstanding", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT,
+          "description", G_TYPE_STRING, "number of buffers not released yet",
+          NULL),
+      "max-outstanding", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT,
+          "description", G_TYPE_STRING, "maximum number of outstanding buffers",
+          NULL),
+      "num-waits", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of waits for a free buffer",
+          NULL),
+      "wait-time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "total time spent waiting in ns",
+          NULL),
+      "max-wait-time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "longest wait in ns",
+          NULL),
+      NULL);
+  tr_allocator_stats = gst_tracer_record_new ("allocator-stats.class",
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "summary ts",
+          NULL),
+      "name", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "name of the allocator",
+          NULL),
+      "num-allocs", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of allocations",
+          NULL),
+      "num-bytes", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of bytes allocated",
+          NULL),
+      "live-allocs", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of allocations not freed yet",
+          NULL),
+      "live-bytes", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of bytes not freed yet",
+          NULL),
+      "max-live-bytes", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "maximum number of bytes alive",
+          NULL),
+      NULL);
+  /* *INDENT-ON* */
+
+  GST_OBJECT_FLAG_SET (tr_pool_stats, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  GST_OBJECT_FLAG_SET (tr_allocator_stats, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+
+  /**
+   * GstBufferPoolsTracer::get-stats:
+   * @bufferpoolstracer: the buffer pools tracer object to emit this signal on
+   *
+   * Returns a #GstStructure with two fields, `pools` and `allocators`, each
+   * containing a #GST_TYPE_LIST of #GstStructure with the statistics of the
+   * buffer pools and allocators that are alive.
+   *
+   * Each `buffer-pool-stats` structure has the fields `name`,
+   * `num-acquired`, `outstanding`, `max-outstanding`, `num-waits`,
+   * `wait-time` and `max-wait-time` in nanoseconds and `wait-histogram`, a
+   * #GST_TYPE_ARRAY counting the waits below 1us at index 0 and the waits
+   * between 2^(i-1) and 2^i us at index i.
+   *
+   * Each `allocator-stats` structure has the fields `name`, `num-allocs`,
+   * `num-bytes`, `live-allocs`, `live-bytes` and `max-live-bytes`.
+   *
+   * Returns: (transfer full): a newly-allocated #GstStructure
+   *
+   * Since: 1.22
+   */
+  gst_buffer_pools_tracer_signals[SIGNAL_GET_STATS] =
+      g_signal_new_class_handler ("get-stats", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_CALLBACK (gst_buffer_pools_tracer_get_stats), NULL, NULL, NULL,
+      GST_TYPE_STRUCTURE, 0, G_TYPE_NONE);
+}
+
+static void
+gst_buffer_pools_tracer_init (GstBufferPoolsTracer * self)
+{
+  GstTracer *tracer = GST_TRACER (self);
+
+  g_mutex_init (&self->lock);
+  self->pools = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) free_pool_stats);
+  self->allocators = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) free_allocator_stats);
+  self->memories = g_hash_table_new (NULL, NULL);
+
+  gst_tracing_register_hook (tracer, "buffer-pool-buffer-acquired",
+      G_CALLBACK (do_buffer_acquired));
+  gst_tracing_register_hook (tracer, "buffer-pool-buffer-released",
+      G_CALLBACK (do_buffer_released));
+  gst_tracing_register_hook (tracer, "buffer-pool-wait-pre",
+      G_CALLBACK (do_wait_pre));
+  gst_tracing_register_hook (tracer, "buffer-pool-wait-post",
+      G_CALLBACK (do_wait_post));
+  gst_tracing_register_hook (tracer, "memory-alloc",
+      G_CALLBACK (do_memory_alloc));
+  gst_tracing_register_hook (tracer, "memory-free",
+      G_CALLBACK (do_memory_free));
+  gst_tracing_register_hook (tracer, "object-destroyed",
+      G_CALLBACK (do_object_destroyed));
+}
@@ -0,0 +1,612 @@
+/* GStreamer
+ *
+ * gstchrometrace.c: tracing module writing the Chrome trace event format
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-chrometrace
+ * @short_description: write a timeline in the Chrome trace event format
+ *
+ * A tracing module that writes a JSON file in the Chrome trace event format,
+ * which can be opened with the Perfetto UI (https://ui.perfetto.dev) or
+ * `chrome://tracing`.
+ *
+ * Every streaming thread gets its own track containing:
+ *
+ * * a span for every buffer or buffer list push, named after the element
+ *   receiving it, so nested spans show the chain functions called
+ * * a span for every pull_range() call
+ * * an instant event for every message posted from that thread
+ *
+ * In addition, the fill level of `queue` and `queue2` elements is written as
+ * counters whenever data enters or leaves them.
+ *
+ * Events are collected in per-thread buffers and only written to the file
+ * when a buffer is full, when its thread exits or when the tracer is
+ * destroyed, so no lock is shared between streaming threads.
+ *
+ * The file to write to can be set with the `file` parameter, it defaults to
+ * `gst-trace.json` in the current directory. The
+ * #GstChromeTraceTracer::flush action signal writes out all pending events
+ * while the tracer is running.
+ *
+ * ```
+ * $ GST_TRACERS="chrometrace(file=/tmp/trace.json)" gst-launch-1.0 ...
+ * ```
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <string.h>
+#include <errno.h>
+
+#include "gstchrometrace.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_chrome_trace_debug);
+#define GST_CAT_DEFAULT gst_chrome_trace_debug
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_chrome_trace_debug, "chrometrace", 0, \
+        "chrome trace tracer");
+#define gst_chrome_trace_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstChromeTraceTracer, gst_chrome_trace_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+#define DEFAULT_FILE "gst-trace.json"
+
+enum
+{
+  /* actions */
+  SIGNAL_FLUSH,
+
+  LAST_SIGNAL
+};
+
+static guint gst_chrome_trace_tracer_signals[LAST_SIGNAL] = { 0 };
+
+/* size at which a thread buffer is written to the file */
+#define FLUSH_SIZE (64 * 1024)
+
+/* protects the tracer instance, its file and the thread buffers list */
+G_LOCK_DEFINE_STATIC (trace);
+static GstChromeTraceTracer *active_tracer;
+
+static GQuark pad_info_quark;
+
+static gint next_tid = 0;
+
+typedef struct
+{
+  /* protected by the trace lock */
+  GstChromeTraceTracer *tracer;
+
+  /* protects @data, only contended when the tracer is destroyed */
+  GMutex lock;
+  GString *data;
+  guint tid;
+  gboolean named;
+} ThreadBuffer;
+
+/* what a pad pushes to, cached on the pad */
+typedef struct
+{
+  GstPad *peer;
+  gchar *name;
+  /* if the element of the pad or of its peer is a queue */
+  gboolean is_queue;
+  gboolean peer_is_queue;
+} PadInfo;
+
+static void
+write_data (GstChromeTraceTracer * self, GString * data)
+{
+  if (self->out && data->len > 0) {
+    if (fwrite (data->str, 1, data->len, self->out) != data->len)
+      GST_WARNING_OBJECT (self, "failed to write trace: %s",
+          g_strerror (errno));
+  }
+}
+
+static void
+thread_buffer_free (ThreadBuffer * tb)
+{
+  G_LOCK (trace);
+  if (tb->tracer) {
+    write_data (tb->tracer, tb->data);
+    tb->tracer->buffers = g_list_remove (tb->tracer->buffers, tb);
+  }
+  G_UNLOCK (trace);
+
+  g_mutex_clear (&tb->lock);
+  g_string_free (tb->data, TRUE);
+  g_free (tb);
+}
+
+static GPrivate thread_buffer = G_PRIVATE_INIT ((GDestroyNotify)
+    thread_buffer_free);
+
+static void
+append_escaped (GString * s, const gchar * str)
+{
+  for (; *str; str++) {
+    switch (*str) {
+      case '"':
+        g_string_append (s, "\\\"");
+        break;
+      case '\\':
+        g_string_append (s, "\\\\");
+        break;
+      default:
+        if ((guchar) * str < 0x20)
+          g_string_append_printf (s, "\\u%04x", (guchar) * str);
+        else
+          g_string_append_c (s, *str);
+        break;
+    }
+  }
+}
+
+/* appends the fields shared by all events, timestamps are in microseconds */
+static void
+append_event_start (ThreadBuffer * tb, const gchar * ph, GstClockTime ts)
+{
+  g_string_append_printf (tb->data,
+      "{\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%" G_GUINT64_FORMAT
+      ".%03u", ph, tb->tid, ts / 1000, (guint) (ts % 1000));
+}
+
+static void
+append_thread_name (ThreadBuffer * tb, const gchar * name)
+{
+  g_string_append_printf (tb->data,
+      "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\","
+      "\"args\":{\"name\":\"", tb->tid);
+  append_escaped (tb->data, name);
+  g_string_append (tb->data, "\"}},\n");
+}
+
+/* returns the buffer of the current thread, locked */
+static ThreadBuffer *
+thread_buffer_lock (GstChromeTraceTracer * self)
+{
+  ThreadBuffer *tb = g_private_get (&thread_buffer);
+
+  if (G_UNLIKELY (tb == NULL)) {
+    gchar *name;
+
+    tb = g_new0 (ThreadBuffer, 1);
+    g_mutex_init (&tb->lock);
+    tb->data = g_string_sized_new (FLUSH_SIZE + 1024);
+    tb->tid = (guint) g_atomic_int_add (&next_tid, 1) + 1;
+
+    /* a better name is set once the thread pushes data */
+    name = g_strdup_printf ("thread %u", tb->tid);
+    append_thread_name (tb, name);
+    g_free (name);
+
+    g_private_set (&thread_buffer, tb);
+  }
+
+  if (G_UNLIKELY (tb->tracer != self)) {
+    G_LOCK (trace);
+    tb->tracer = self;
+    self->buffers = g_list_prepend (self->buffers, tb);
+    G_UNLOCK (trace);
+  }
+
+  g_mutex_lock (&tb->lock);
+
+  return tb;
+}
+
+static void
+thread_buffer_unlock (GstChromeTraceTracer * self, ThreadBuffer * tb)
+{
+  GString *full = NULL;
+
+  if (G_UNLIKELY (tb->data->len >= FLUSH_SIZE)) {
+    full = tb->data;
+    tb->data = g_string_sized_new (FLUSH_SIZE + 1024);
+  }
+  g_mutex_unlock (&tb->lock);
+
+  if (full) {
+    G_LOCK (trace);
+    write_data (self, full);
+    G_UNLOCK (trace);
+    g_string_free (full, TRUE);
+  }
+}
+
+/* if @element has the level properties of queue and queue2 */
+static gboolean
+is_queue (GstElement * element)
+{
+  GObjectClass *klass;
+  GParamSpec *pspec;
+
+  if (!element)
+    return FALSE;
+
+  klass = G_OBJECT_GET_CLASS (element);
+  pspec = g_object_class_find_property (klass, "current-level-buffers");
+  if (!pspec || pspec->value_type != G_TYPE_UINT)
+    return FALSE;
+  pspec = g_object_class_find_property (klass, "current-level-bytes");
+  if (!pspec || pspec->value_type != G_TYPE_UINT)
+    return FALSE;
+  pspec = g_object_class_find_property (klass, "current-level-time");
+  if (!pspec || pspec->value_type != G_TYPE_UINT64)
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+pad_info_free (PadInfo * info)
+{
+  g_free (info->name);
+  g_free (info);
+}
+
+/* returns the cached info for @pad, refreshed when it was relinked */
+static PadInfo *
+get_pad_info (GstPad * pad)
+{
+  PadInfo *info;
+  GstPad *peer, *real_peer;
+  GstElement *parent, *peer_parent = NULL;
+
+  info = g_object_get_qdata (G_OBJECT (pad), pad_info_quark);
+  /* unlocked read, only used to notice relinks */
+  peer = GST_PAD_PEER (pad);
+  if (G_LIKELY (info && info->peer == peer))
+    return info;
+
+  info = g_new0 (PadInfo, 1);
+  info->peer = peer;
+
+  parent = gst_pad_get_parent_element (pad);
+
+  /* follow ghost pads to the element handling the data */
+  real_peer = gst_pad_get_peer (pad);
+  while (real_peer && GST_IS_GHOST_PAD (real_peer)) {
+    GstPad *target = gst_ghost_pad_get_target (GST_GHOST_PAD_CAST (real_peer));
+
+    gst_object_unref (real_peer);
+    real_peer = target;
+  }
+  if (real_peer) {
+    peer_parent = gst_pad_get_parent_element (real_peer);
+    gst_object_unref (real_peer);
+  }
+
+  info->name = g_strdup (peer_parent ? GST_OBJECT_NAME (peer_parent) :
+      GST_OBJECT_NAME (pad));
+  info->is_queue = is_queue (parent);
+  info->peer_is_queue = is_queue (peer_parent);
+
+  if (parent)
+    gst_object_unref (parent);
+  if (peer_parent)
+    gst_object_unref (peer_parent);
+
+  g_object_set_qdata_full (G_OBJECT (pad), pad_info_quark, info,
+      (GDestroyNotify) pad_info_free);
+
+  return info;
+}
+
+static void
+append_queue_level (ThreadBuffer * tb, GstClockTime ts, GstElement * queue)
+{
+  guint buffers = 0, bytes = 0;
+  guint64 time = 0;
+
+  g_object_get (queue, "current-level-buffers", &buffers,
+      "current-level-bytes", &bytes, "current-level-time", &time, NULL);
+
+  append_event_start (tb, "C", ts);
+  g_string_append (tb->data, ",\"name\":\"");
+  append_escaped (tb->data, GST_OBJECT_NAME (queue));
+  g_string_append_printf (tb->data, " level\",\"args\":{\"buffers\":%u,"
+      "\"bytes\":%u,\"time-ms\":%" G_GUINT64_FORMAT "}},\n", buffers, bytes,
+      time / GST_MSECOND);
+}
+
+static void
+do_push_pre (GstChromeTraceTracer * self, GstClockTime ts, GstPad * pad,
+    const gchar * cat)
+{
+  ThreadBuffer *tb;
+  PadInfo *info;
+
+  info = get_pad_info (pad);
+  tb = thread_buffer_lock (self);
+
+  if (G_UNLIKELY (!tb->named)) {
+    gchar *name = g_strdup_printf ("%s:%s", GST_DEBUG_PAD_NAME (pad));
+
+    append_thread_name (tb, name);
+    g_free (name);
+    tb->named = TRUE;
+  }
+
+  /* the element of the pad stays alive while it pushes, the peer element
+   * is only looked up for queues */
+  if (info->is_queue)
+    append_queue_level (tb, ts, GST_ELEMENT_CAST (GST_OBJECT_PARENT (pad)));
+  if (info->peer_is_queue) {
+    GstPad *peer = gst_pad_get_peer (pad);
+    GstElement *queue = NULL;
+
+    if (peer) {
+      queue = gst_pad_get_parent_element (peer);
+      gst_object_unref (peer);
+    }
+    if (queue) {
+      append_queue_level (tb, ts, queue);
+      gst_object_unref (queue);
+    }
+  }
+
+  append_event_start (tb, "B", ts);
+  g_string_append_printf (tb->data, ",\"cat\":\"%s\",\"name\":\"", cat);
+  append_escaped (tb->data, info->name);
+  g_string_append (tb->data, "\",\"args\":{\"pad\":\"");
+  append_escaped (tb->data, GST_OBJECT_NAME (pad));
+  g_string_append (tb->data, "\"}},\n");
+
+  thread_buffer_unlock (self, tb);
+}
+
+static void
+do_span_end (GstChromeTraceTracer * self, GstClockTime ts, GstFlowReturn res)
+{
+  ThreadBuffer *tb;
+
+  tb = thread_buffer_lock (self);
+  append_event_start (tb, "E", ts);
+  g_string_append_printf (tb->data, ",\"args\":{\"result\":\"%s\"}},\n",
+      gst_flow_get_name (res));
+  thread_buffer_unlock (self, tb);
+}
+
+static void
+do_push_buffer_pre (GstChromeTraceTracer * self, GstClockTime ts,
+    GstPad * pad, GstBuffer * buffer)
+{
+  do_push_pre (self, ts, pad, "push");
+}
+
+static void
+do_push_buffer_post (GstChromeTraceTracer * self, GstClockTime ts,
+    GstPad * pad, GstFlowReturn res)
+{
+  do_span_end (self, ts, res);
+}
+
+static void
+do_push_buffer_list_pre (GstChromeTraceTracer * self, GstClockTime ts,
+    GstPad * pad, GstBufferList * list)
+{
+  do_push_pre (self, ts, pad, "push-list");
+}
+
+static void
+do_push_buffer_list_post (GstChromeTraceTracer * self, GstClockTime ts,
+    GstPad * pad, GstFlowReturn res)
+{
+  do_span_end (self, ts, res);
+}
+
+static void
+do_pull_range_pre (GstChromeTraceTracer * self, GstClockTime ts,
+    GstPad * pad, guint64 offset, guint size)
+{
+  ThreadBuffer *tb;
+  PadInfo *info;
+
+  info = get_pad_info (pad);
+  tb = thread_buffer_lock (self);
+  append_event_start (tb, "B", ts);
+  g_string_append (tb->data, ",\"cat\":\"pull\",\"name\":\"");
+  append_escaped (tb->data, info->name);
+  g_string_append_printf (tb->data, "\",\"args\":{\"offset\":%"
+      G_GUINT64_FORMAT ",\"size\":%u}},\n", offset, size);
+  thread_buffer_unlock (self, tb);
+}
+
+static void
+do_pull_range_post (GstChromeTraceTracer * self, GstClockTime ts,
+    GstPad * pad, GstBuffer * buffer, GstFlowReturn res)
+{
+  do_span_end (self, ts, res);
+}
+
+static void
+do_element_post_message_pre (GstChromeTraceTracer * self, GstClockTime ts,
+    GstElement * element, GstMessage * msg)
+{
+  ThreadBuffer *tb;
+
+  tb = thread_buffer_lock (self);
+  append_event_start (tb, "i", ts);
+  g_string_append_printf (tb->data, ",\"s\":\"t\",\"cat\":\"message\","
+      "\"name\":\"%s\",\"args\":{\"src\":\"", GST_MESSAGE_TYPE_NAME (msg));
+  append_escaped (tb->data, GST_OBJECT_NAME (element));
+  g_string_append (tb->data, "\"}},\n");
+  thread_buffer_unlock (self, tb);
+}
+
+static void
+gst_chrome_trace_tracer_constructed (GObject * object)
+{
+  GstChromeTraceTracer *self = GST_CHROME_TRACE_TRACER (object);
+  GstTracer *tracer = GST_TRACER (self);
+  gchar *params, *tmp;
+  GstStructure *params_struct = NULL;
+  const gchar *file = NULL;
+
+  G_OBJECT_CLASS (parent_class)->constructed (object);
+
+  g_object_get (self, "params", &params, NULL);
+  if (params) {
+    tmp = g_strdup_printf ("chrometrace,%s", params);
+    params_struct = gst_structure_from_string (tmp, NULL);
+    g_free (tmp);
+    if (params_struct) {
+      const gchar *name = gst_structure_get_string (params_struct, "name");
+
+      if (name)
+        gst_object_set_name (GST_OBJECT (self), name);
+      file = gst_structure_get_string (params_struct, "file");
+    } else
+      GST_WARNING_OBJECT (self, "invalid params: %s", params);
+  }
+  if (!file)
+    file = DEFAULT_FILE;
+
+  G_LOCK (trace);
+  if (active_tracer) {
+    G_UNLOCK (trace);
+    GST_WARNING_OBJECT (self, "only one chrometrace tracer can be active");
+    goto done;
+  }
+
+  self->out = fopen (file, "w");
+  if (!self->out) {
+    G_UNLOCK (trace);
+    GST_WARNING_OBJECT (self, "failed to open %s: %s", file,
+        g_strerror (errno));
+    goto done;
+  }
+  fputs ("[\n", self->out);
+  active_tracer = self;
+  G_UNLOCK (trace);
+
+  GST_INFO_OBJECT (self, "writing trace to %s", file);
+
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (do_push_buffer_pre));
+  gst_tracing_register_hook (tracer, "pad-push-post",
+      G_CALLBACK (do_push_buffer_post));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (do_push_buffer_list_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-post",
+      G_CALLBACK (do_push_buffer_list_post));
+  gst_tracing_register_hook (tracer, "pad-pull-range-pre",
+      G_CALLBACK (do_pull_range_pre));
+  gst_tracing_register_hook (tracer, "pad-pull-range-post",
+      G_CALLBACK (do_pull_range_post));
+  gst_tracing_register_hook (tracer, "element-post-message-pre",
+      G_CALLBACK (do_element_post_message_pre));
+
+done:
+  if (params_struct)
+    gst_structure_free (params_struct);
+  g_free (params);
+}
+
+/* call with the trace lock */
+static void
+flush_buffers (GstChromeTraceTracer * self, gboolean detach)
+{
+  GList *l;
+
+  for (l = self->buffers; l; l = l->next) {
+    ThreadBuffer *tb = l->data;
+
+    g_mutex_lock (&tb->lock);
+    write_data (self, tb->data);
+    g_string_truncate (tb->data, 0);
+    if (detach)
+      tb->tracer = NULL;
+    g_mutex_unlock (&tb->lock);
+  }
+
+  if (self->out)
+    fflush (self->out);
+}
+
+static void
+gst_chrome_trace_tracer_flush (GstChromeTraceTracer * self)
+{
+  G_LOCK (trace);
+  flush_buffers (self, FALSE);
+  G_UNLOCK (trace);
+}
+
+static void
+gst_chrome_trace_tracer_finalize (GObject * object)
+{
+  GstChromeTraceTracer *self = GST_CHROME_TRACE_TRACER (object);
+
+  G_LOCK (trace);
+  flush_buffers (self, TRUE);
+  g_list_free (self->buffers);
+  self->buffers = NULL;
+
+  if (self->out) {
+    /* every event is followed by a comma, end with one that is not */
+    fputs ("{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\","
+        "\"args\":{\"name\":\"GStreamer\"}}\n]\n", self->out);
+    fclose (self->out);
+    self->out = NULL;
+  }
+  if (active_tracer == self)
+    active_tracer = NULL;
+  G_UNLOCK (trace);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_chrome_trace_tracer_class_init (GstChromeTraceTracerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->constructed = gst_chrome_trace_tracer_constructed;
+  gobject_class->finalize = gst_chrome_trace_tracer_finalize;
+
+  pad_info_quark = g_quark_from_static_string ("chrometrace-pad-info");
+
+  /**
+   * GstChromeTraceTracer::flush:
+   * @chrometrace: the chrome trace tracer object to emit this signal on
+   *
+   * Writes the events collected so far by all threads to the trace file.
+   * The file is only terminated when the tracer is destroyed but can be
+   * loaded before that.
+   *
+   * Since: 1.22
+   */
+  gst_chrome_trace_tracer_signals[SIGNAL_FLUSH] =
+      g_signal_new_class_handler ("flush", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_CALLBACK (gst_chrome_trace_tracer_flush), NULL, NULL, NULL,
+      G_TYPE_NONE, 0, G_TYPE_NONE);
+}
+
+static void
+gst_chrome_trace_tracer_init (GstChromeTraceTracer * self)
+{
+}
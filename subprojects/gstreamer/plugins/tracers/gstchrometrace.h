@@ -0,0 +1,50 @@
+/* GStreamer
+ *
+ * gstchrometrace.h: tracing module writing the Chrome trace event format
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_CHROME_TRACE_TRACER_H__
+#define __GST_CHROME_TRACE_TRACER_H__
+
+#include <stdio.h>
+
+#include <gst/gst.h>
+#include <gst/gsttracer.h>
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE(GstChromeTraceTracer, gst_chrome_trace_tracer, GST,
+    CHROME_TRACE_TRACER, GstTracer)
+/**
+ * GstChromeTraceTracer:
+ *
+ * Opaque #GstChromeTraceTracer data structure
+ */
+struct _GstChromeTraceTracer {
+  GstTracer 	 parent;
+
+  /*< private >*/
+  /* protected by the global trace lock */
+  FILE *out;
+  /* the per-thread buffers writing to @out */
+  GList *buffers;
+};
+
+G_END_DECLS
+
+#endif /* __GST_CHROME_TRACE_TRACER_H__ */
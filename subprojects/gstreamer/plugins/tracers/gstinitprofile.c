@@ -0,0 +1,513 @@
+/* GStreamer
+ *
+ * gstinitprofile.c: tracing module profiling plugin loading and startup
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-initprofile
+ * @short_description: profile plugin loading and startup time
+ *
+ * A tracing module that reports where the time goes when GStreamer starts up
+ * and when elements are created for the first time:
+ *
+ * * `registry-update`: the time it took to read the registry cache and to
+ *   validate it against the plugin paths, rescanning the changed plugins.
+ * * `plugin-load`: the time it took to load a plugin, including opening the
+ *   module, and the time spent in its init function. Plugins that were
+ *   loaded by the plugin scanner helper while updating the registry have no
+ *   init time since they were loaded in another process.
+ * * `factory-first-use`: the time it took to create the first element of an
+ *   element factory, which includes loading its plugin on demand and
+ *   initializing the element class.
+ *
+ * The events from gst_init() are reported once the tracer got created, with
+ * their original timestamps. When the tracer is destroyed, a
+ * `plugin-load-summary` record is logged for the plugins that took the
+ * longest to load.
+ *
+ * ```
+ * $ GST_TRACERS=initprofile GST_DEBUG=GST_TRACER:7 gst-launch-1.0 ...
+ * ```
+ *
+ * The tracer accepts the following parameters:
+ *
+ * * `top`: the number of plugins in the summary, 10 by default.
+ *
+ * The #GstInitProfileTracer::get-stats action signal returns the statistics
+ * collected so far.
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gstinitprofile.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_init_profile_debug);
+#define GST_CAT_DEFAULT gst_init_profile_debug
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_init_profile_debug, "initprofile", 0, \
+        "init profile tracer");
+#define gst_init_profile_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstInitProfileTracer, gst_init_profile_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+#define DEFAULT_TOP 10
+
+enum
+{
+  /* actions */
+  SIGNAL_GET_STATS,
+
+  LAST_SIGNAL
+};
+
+static guint gst_init_profile_tracer_signals[LAST_SIGNAL] = { 0 };
+
+static GstTracerRecord *tr_registry_update;
+static GstTracerRecord *tr_plugin_load;
+static GstTracerRecord *tr_factory_first_use;
+static GstTracerRecord *tr_plugin_load_summary;
+
+typedef struct
+{
+  gchar *name;
+  gchar *filename;
+  /* the plugin can be loaded by the plugin scanner and again in process */
+  GstClockTime load_time;
+  GstClockTime init_time;
+  /* creating the first element of each of the plugin's factories */
+  GstClockTime first_use_time;
+} GstPluginProfile;
+
+typedef struct
+{
+  gchar *name;
+  gchar *plugin;
+  GstClockTime create_time;
+} GstFactoryProfile;
+
+static void
+free_plugin_profile (GstPluginProfile * profile)
+{
+  g_free (profile->name);
+  g_free (profile->filename);
+  g_free (profile);
+}
+
+static void
+free_factory_profile (GstFactoryProfile * profile)
+{
+  g_free (profile->name);
+  g_free (profile->plugin);
+  g_free (profile);
+}
+
+/* durations are GST_CLOCK_TIME_NONE when they could not be measured */
+static inline GstClockTime
+add_time (GstClockTime total, GstClockTime time)
+{
+  if (!GST_CLOCK_TIME_IS_VALID (time))
+    return total;
+  if (!GST_CLOCK_TIME_IS_VALID (total))
+    return time;
+  return total + time;
+}
+
+static GstPluginProfile *
+get_plugin_profile (GstInitProfileTracer * self, const gchar * name)
+{
+  GstPluginProfile *profile = g_hash_table_lookup (self->plugins, name);
+
+  if (!profile) {
+    profile = g_new0 (GstPluginProfile, 1);
+    profile->name = g_strdup (name);
+    profile->load_time = GST_CLOCK_TIME_NONE;
+    profile->init_time = GST_CLOCK_TIME_NONE;
+    profile->first_use_time = GST_CLOCK_TIME_NONE;
+    g_hash_table_insert (self->plugins, profile->name, profile);
+  }
+  return profile;
+}
+
+/* hooks */
+
+static void
+do_registry_updated (GstInitProfileTracer * self, GstClockTime ts,
+    GstRegistry * registry, GstClockTime read_time, GstClockTime scan_time,
+    gboolean changed)
+{
+  GList *plugins = gst_registry_get_plugin_list (registry);
+
+  gst_tracer_record_log (tr_registry_update, read_time, scan_time, changed,
+      g_list_length (plugins), ts);
+  gst_plugin_list_free (plugins);
+
+  g_mutex_lock (&self->lock);
+  self->registry_read_time = add_time (self->registry_read_time, read_time);
+  self->registry_scan_time = add_time (self->registry_scan_time, scan_time);
+  self->registry_changed |= changed;
+  g_mutex_unlock (&self->lock);
+}
+
+static void
+do_plugin_loaded (GstInitProfileTracer * self, GstClockTime ts,
+    GstPlugin * plugin, GstClockTime load_time, GstClockTime init_time)
+{
+  const gchar *name = gst_plugin_get_name (plugin);
+  const gchar *filename = gst_plugin_get_filename (plugin);
+  GstPluginProfile *profile;
+
+  GST_DEBUG_OBJECT (self, "plugin %s loaded in %" GST_TIME_FORMAT
+      ", init %" GST_TIME_FORMAT, name, GST_TIME_ARGS (load_time),
+      GST_TIME_ARGS (init_time));
+
+  gst_tracer_record_log (tr_plugin_load, name, filename ? filename : "",
+      load_time, init_time, ts);
+
+  g_mutex_lock (&self->lock);
+  profile = get_plugin_profile (self, name);
+  if (!profile->filename && filename)
+    profile->filename = g_strdup (filename);
+  profile->load_time = add_time (profile->load_time, load_time);
+  profile->init_time = add_time (profile->init_time, init_time);
+  g_mutex_unlock (&self->lock);
+}
+
+static void
+do_element_factory_first_use (GstInitProfileTracer * self, GstClockTime ts,
+    GstElementFactory * factory, GstElement * element,
+    GstClockTime create_time)
+{
+  GstPluginFeature *feature = GST_PLUGIN_FEATURE_CAST (factory);
+  const gchar *plugin_name = gst_plugin_feature_get_plugin_name (feature);
+  GstFactoryProfile *profile;
+  GstPluginProfile *plugin_profile;
+
+  if (!plugin_name)
+    plugin_name = "";
+
+  gst_tracer_record_log (tr_factory_first_use, GST_OBJECT_NAME (factory),
+      plugin_name, create_time, ts);
+
+  profile = g_new0 (GstFactoryProfile, 1);
+  profile->name = g_strdup (GST_OBJECT_NAME (factory));
+  profile->plugin = g_strdup (plugin_name);
+  profile->create_time = create_time;
+
+  g_mutex_lock (&self->lock);
+  g_queue_push_tail (&self->factories, profile);
+  plugin_profile = get_plugin_profile (self, plugin_name);
+  plugin_profile->first_use_time =
+      add_time (plugin_profile->first_use_time, create_time);
+  g_mutex_unlock (&self->lock);
+}
+
+/* slowest plugins first */
+static gint
+compare_load_time (gconstpointer a, gconstpointer b)
+{
+  const GstPluginProfile *pa = a, *pb = b;
+  GstClockTime ta = add_time (0, pa->load_time);
+  GstClockTime tb = add_time (0, pb->load_time);
+
+  if (ta == tb)
+    return g_strcmp0 (pa->name, pb->name);
+  return ta > tb ? -1 : 1;
+}
+
+static GstStructure *
+get_plugin_stats (GstPluginProfile * profile)
+{
+  return gst_structure_new ("plugin-stats",
+      "name", G_TYPE_STRING, profile->name,
+      "filename", G_TYPE_STRING, profile->filename,
+      "load-time", G_TYPE_UINT64, profile->load_time,
+      "init-time", G_TYPE_UINT64, profile->init_time,
+      "first-use-time", G_TYPE_UINT64, profile->first_use_time, NULL);
+}
+
+static GstStructure *
+gst_init_profile_tracer_get_stats (GstInitProfileTracer * self)
+{
+  GstStructure *info;
+  GValue plugins = G_VALUE_INIT;
+  GValue factories = G_VALUE_INIT;
+  GList *sorted, *node;
+
+  g_value_init (&plugins, GST_TYPE_LIST);
+  g_value_init (&factories, GST_TYPE_LIST);
+
+  g_mutex_lock (&self->lock);
+  sorted = g_list_sort (g_hash_table_get_values (self->plugins),
+      compare_load_time);
+  for (node = sorted; node; node = node->next) {
+    GValue s_value = G_VALUE_INIT;
+
+    g_value_init (&s_value, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&s_value, get_plugin_stats (node->data));
+    gst_value_list_append_and_take_value (&plugins, &s_value);
+  }
+  g_list_free (sorted);
+
+  for (node = self->factories.head; node; node = node->next) {
+    GstFactoryProfile *profile = node->data;
+    GValue s_value = G_VALUE_INIT;
+
+    g_value_init (&s_value, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&s_value, gst_structure_new ("factory-stats",
+            "name", G_TYPE_STRING, profile->name,
+            "plugin", G_TYPE_STRING, profile->plugin,
+            "create-time", G_TYPE_UINT64, profile->create_time, NULL));
+    gst_value_list_append_and_take_value (&factories, &s_value);
+  }
+
+  info = gst_structure_new ("initprofile",
+      "registry-read-time", G_TYPE_UINT64, self->registry_read_time,
+      "registry-scan-time", G_TYPE_UINT64, self->registry_scan_time,
+      "registry-changed", G_TYPE_BOOLEAN, self->registry_changed, NULL);
+  g_mutex_unlock (&self->lock);
+
+  gst_structure_take_value (info, "plugins", &plugins);
+  gst_structure_take_value (info, "factories", &factories);
+
+  return info;
+}
+
+/* tracer class */
+
+static void
+gst_init_profile_tracer_constructed (GObject * object)
+{
+  GstInitProfileTracer *self = GST_INIT_PROFILE_TRACER (object);
+  gchar *params, *tmp;
+  const gchar *name;
+  GstStructure *params_struct = NULL;
+
+  g_object_get (self, "params", &params, NULL);
+
+  if (!params)
+    return;
+
+  tmp = g_strdup_printf ("initprofile,%s", params);
+  params_struct = gst_structure_from_string (tmp, NULL);
+  g_free (tmp);
+  g_free (params);
+
+  if (!params_struct)
+    return;
+
+  /* Set the name if assigned */
+  name = gst_structure_get_string (params_struct, "name");
+  if (name)
+    gst_object_set_name (GST_OBJECT (self), name);
+
+  gst_structure_get_uint (params_struct, "top", &self->top);
+
+  gst_structure_free (params_struct);
+}
+
+static void
+gst_init_profile_tracer_finalize (GObject * object)
+{
+  GstInitProfileTracer *self = GST_INIT_PROFILE_TRACER (object);
+  GList *sorted, *node;
+  guint i;
+
+  sorted = g_list_sort (g_hash_table_get_values (self->plugins),
+      compare_load_time);
+  for (node = sorted, i = 0; node && i < self->top; node = node->next, i++) {
+    GstPluginProfile *profile = node->data;
+
+    gst_tracer_record_log (tr_plugin_load_summary, profile->name,
+        profile->load_time, profile->init_time, profile->first_use_time);
+  }
+  g_list_free (sorted);
+
+  g_hash_table_destroy (self->plugins);
+  g_queue_foreach (&self->factories, (GFunc) free_factory_profile, NULL);
+  g_queue_clear (&self->factories);
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_init_profile_tracer_class_init (GstInitProfileTracerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->constructed = gst_init_profile_tracer_constructed;
+  gobject_class->finalize = gst_init_profile_tracer_finalize;
+
+  /* *INDENT-OFF* */
+  tr_registry_update = gst_tracer_record_new ("registry-update.class",
+      "read-time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "time it took to read the registry cache in ns",
+          NULL),
+      "scan-time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "time it took to validate the registry cache in ns",
+          NULL),
+      "changed", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_BOOLEAN,
+          "description", G_TYPE_STRING,
+              "whether plugins changed and the cache was written",
+          NULL),
+      "plugins", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT,
+          "description", G_TYPE_STRING, "number of plugins in the registry",
+          NULL),
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "ts when the registry was updated",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      NULL);
+
+  tr_plugin_load = gst_tracer_record_new ("plugin-load.class",
+      "plugin", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "name of the plugin",
+          NULL),
+      "filename", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "module of the plugin",
+          NULL),
+      "load-time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "time it took to load the plugin in ns",
+          NULL),
+      "init-time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "time spent in the plugin init function in ns",
+          NULL),
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "ts when the plugin was loaded",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      NULL);
+
+  tr_factory_first_use = gst_tracer_record_new ("factory-first-use.class",
+      "factory", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "name of the element factory",
+          NULL),
+      "plugin", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "name of the plugin",
+          NULL),
+      "create-time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "time it took to create the first element in ns",
+          NULL),
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "ts when the element was created",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      NULL);
+
+  tr_plugin_load_summary = gst_tracer_record_new ("plugin-load-summary.class",
+      "plugin", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "name of the plugin",
+          NULL),
+      "load-time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "total time spent loading the plugin in ns",
+          NULL),
+      "init-time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "total time spent in the plugin init function in ns",
+          NULL),
+      "first-use-time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "total time spent creating the first elements in ns",
+          NULL),
+      NULL);
+  /* *INDENT-ON* */
+
+  GST_OBJECT_FLAG_SET (tr_registry_update, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  GST_OBJECT_FLAG_SET (tr_plugin_load, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  GST_OBJECT_FLAG_SET (tr_factory_first_use, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  GST_OBJECT_FLAG_SET (tr_plugin_load_summary, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+
+  /**
+   * GstInitProfileTracer::get-stats:
+   * @initprofiletracer: the init profile tracer object to emit this signal on
+   *
+   * Returns a #GstStructure with the `registry-read-time` and
+   * `registry-scan-time` in nanoseconds, the `registry-changed` boolean and
+   * two #GST_TYPE_LIST fields:
+   *
+   * * `plugins`: a `plugin-stats` structure per plugin, slowest to load
+   *   first, with the fields `name`, `filename`, `load-time`, `init-time` and
+   *   `first-use-time`.
+   * * `factories`: a `factory-stats` structure per element factory in the
+   *   order of their first use, with the fields `name`, `plugin` and
+   *   `create-time`.
+   *
+   * Times that could not be measured are %GST_CLOCK_TIME_NONE.
+   *
+   * Returns: (transfer full): a newly-allocated #GstStructure
+   *
+   * Since: 1.22
+   */
+  gst_init_profile_tracer_signals[SIGNAL_GET_STATS] =
+      g_signal_new_class_handler ("get-stats", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_CALLBACK (gst_init_profile_tracer_get_stats), NULL, NULL, NULL,
+      GST_TYPE_STRUCTURE, 0, G_TYPE_NONE);
+}
+
+static void
+gst_init_profile_tracer_init (GstInitProfileTracer * self)
+{
+  GstTracer *tracer = GST_TRACER (self);
+
+  g_mutex_init (&self->lock);
+  self->top = DEFAULT_TOP;
+  self->plugins = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+      (GDestroyNotify) free_plugin_profile);
+  g_queue_init (&self->factories);
+  self->registry_read_time = GST_CLOCK_TIME_NONE;
+  self->registry_scan_time = GST_CLOCK_TIME_NONE;
+
+  gst_tracing_register_hook (tracer, "registry-updated",
+      G_CALLBACK (do_registry_updated));
+  gst_tracing_register_hook (tracer, "plugin-loaded",
+      G_CALLBACK (do_plugin_loaded));
+  gst_tracing_register_hook (tracer, "element-factory-first-use",
+      G_CALLBACK (do_element_factory_first_use));
+}
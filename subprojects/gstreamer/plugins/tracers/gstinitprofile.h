@@ -0,0 +1,56 @@
+/* GStreamer
+ *
+ * gstinitprofile.h: tracing module profiling plugin loading and startup
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_INIT_PROFILE_TRACER_H__
+#define __GST_INIT_PROFILE_TRACER_H__
+
+#include <gst/gst.h>
+#include <gst/gsttracer.h>
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE(GstInitProfileTracer, gst_init_profile_tracer, GST,
+    INIT_PROFILE_TRACER, GstTracer)
+/**
+ * GstInitProfileTracer:
+ *
+ * Opaque #GstInitProfileTracer data structure
+ */
+struct _GstInitProfileTracer {
+  GstTracer 	 parent;
+
+  /*< private >*/
+  /* number of plugins in the summary */
+  guint top;
+
+  GMutex lock;
+  /* plugin name -> GstPluginProfile, protected by @lock */
+  GHashTable *plugins;
+  /* GstFactoryProfile list in order of first use, protected by @lock */
+  GQueue factories;
+  /* the registry update, protected by @lock */
+  GstClockTime registry_read_time;
+  GstClockTime registry_scan_time;
+  gboolean registry_changed;
+};
+
+G_END_DECLS
+
+#endif /* __GST_INIT_PROFILE_TRACER_H__ */
@@ -31,6 +31,30 @@
  * ```
  * GST_TRACERS="latency(flags=pipeline+element)" GST_DEBUG=GST_TRACER:7 ./...
  * ```
+ *
+ * The custom events do not cross process boundaries, e.g. between udpsink and
+ * udpsrc. The `reference` flag enables a mode based on
+ * #GstReferenceTimestampMeta instead: the tracer adds a meta with the current
+ * system time to the buffers produced by sources that don't have one yet, and
+ * logs the difference between the current system time and the oldest such
+ * meta for every buffer arriving at a sink, as a `reference-latency` record.
+ * When the tracer is destroyed, the distribution of these latencies is logged
+ * per sink pad as a `reference-latency-summary` record.
+ *
+ * By default the metas use the `timestamp/x-ntp` reference, which the RTP
+ * `urn:ietf:params:rtp-hdrext:ntp-64` header extension carries over the
+ * network and which the ipcpipeline elements carry between processes, so that
+ * the glass-to-glass latency of a distributed pipeline can be measured when
+ * the system clocks of the machines are synchronized:
+ *
+ * ```
+ * GST_TRACERS="latency(flags=reference)" GST_DEBUG=GST_TRACER:7 ./...
+ * ```
+ *
+ * The `reference-caps` parameter selects another reference, either
+ * `timestamp/x-ntp` or `timestamp/x-unix`, and `reference-stamp=false`
+ * disables the metas added at the sources, e.g. when the sources already add
+ * capture timestamps themselves.
  */
 /* TODO(ensonic): if there are two sources feeding into a mixer/muxer and later
  * we fan-out with tee and have two sinks, each sink would get all two events,
@@ -44,6 +68,8 @@
 #  include "config.h"
 #endif
 
+#include <stdlib.h>
+
 #include "gstlatency.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_latency_debug);
@@ -68,6 +94,24 @@ static GQuark drop_sub_latency_quark;
 static GstTracerRecord *tr_latency;
 static GstTracerRecord *tr_element_latency;
 static GstTracerRecord *tr_element_reported_latency;
+static GstTracerRecord *tr_reference_latency;
+static GstTracerRecord *tr_reference_latency_summary;
+
+/* seconds between the NTP and the UNIX epochs */
+#define NTP_UNIX_OFFSET (G_GUINT64_CONSTANT (2208988800) * GST_SECOND)
+
+/* number of most recent latencies kept per sink pad for the percentiles */
+#define REFERENCE_LATENCY_SAMPLES 4096
+
+typedef struct
+{
+  gchar *element;
+  gchar *pad;
+  guint64 count;
+  GstClockTime min;
+  GstClockTime max;
+  GstClockTime samples[REFERENCE_LATENCY_SAMPLES];
+} GstReferenceLatencyStats;
 
 /* The private stack for each thread */
 static GPrivate latency_query_stack =
@@ -479,6 +523,191 @@ do_push_event_pre (GstTracer * self, guint64 ts, GstPad * pad, GstEvent * ev)
     gst_object_unref (parent);
 }
 
+static void
+free_reference_latency_stats (GstReferenceLatencyStats * stats)
+{
+  g_free (stats->element);
+  g_free (stats->pad);
+  g_free (stats);
+}
+
+static GstClockTime
+get_reference_time (GstLatencyTracer * self)
+{
+  return g_get_real_time () * GST_USECOND + self->reference_offset;
+}
+
+/* Returns the oldest reference timestamp of @buffer, the origin of the data
+ * when several elements added one */
+static GstClockTime
+get_oldest_reference_timestamp (GstLatencyTracer * self, GstBuffer * buffer)
+{
+  GstClockTime oldest = GST_CLOCK_TIME_NONE;
+  gpointer state = NULL;
+  GstMeta *meta;
+
+  while ((meta = gst_buffer_iterate_meta_filtered (buffer, &state,
+              GST_REFERENCE_TIMESTAMP_META_API_TYPE))) {
+    GstReferenceTimestampMeta *rmeta = (GstReferenceTimestampMeta *) meta;
+
+    if (!gst_caps_is_subset (rmeta->reference, self->reference_caps))
+      continue;
+    if (!GST_CLOCK_TIME_IS_VALID (oldest) || rmeta->timestamp < oldest)
+      oldest = rmeta->timestamp;
+  }
+
+  return oldest;
+}
+
+static void
+stamp_reference_timestamp (GstLatencyTracer * self, GstBuffer * buffer,
+    GstClockTime now)
+{
+  if (!gst_buffer_is_writable (buffer))
+    return;
+
+  if (!gst_buffer_get_reference_timestamp_meta (buffer, self->reference_caps))
+    gst_buffer_add_reference_timestamp_meta (buffer, self->reference_caps, now,
+        GST_CLOCK_TIME_NONE);
+}
+
+static void
+log_reference_latency (GstLatencyTracer * self, GstElement * sink_parent,
+    GstPad * sink_pad, GstBuffer * buffer, GstClockTime now, guint64 ts)
+{
+  GstReferenceLatencyStats *stats;
+  GstClockTime origin, latency;
+  gchar *element_name, *pad_name, *key;
+
+  origin = get_oldest_reference_timestamp (self, buffer);
+  if (!GST_CLOCK_TIME_IS_VALID (origin))
+    return;
+
+  /* clocks of different machines may be slightly out of sync */
+  latency = now > origin ? now - origin : 0;
+
+  element_name = gst_element_get_name (sink_parent);
+  pad_name = gst_pad_get_name (sink_pad);
+  gst_tracer_record_log (tr_reference_latency, element_name, pad_name,
+      latency, ts);
+
+  key = g_strdup_printf ("%s:%s", element_name, pad_name);
+  g_mutex_lock (&self->lock);
+  stats = g_hash_table_lookup (self->reference_stats, key);
+  if (!stats) {
+    stats = g_new0 (GstReferenceLatencyStats, 1);
+    stats->element = element_name;
+    stats->pad = pad_name;
+    stats->min = latency;
+    g_hash_table_insert (self->reference_stats, key, stats);
+  } else {
+    g_free (element_name);
+    g_free (pad_name);
+    g_free (key);
+  }
+  stats->samples[stats->count % REFERENCE_LATENCY_SAMPLES] = latency;
+  stats->count++;
+  stats->min = MIN (stats->min, latency);
+  stats->max = MAX (stats->max, latency);
+  g_mutex_unlock (&self->lock);
+}
+
+static GstElement *
+get_sink_peer (GstPad * pad, GstPad ** peer_pad)
+{
+  GstElement *peer_parent;
+
+  *peer_pad = gst_pad_get_peer (pad);
+  peer_parent = get_real_pad_parent (*peer_pad);
+  if (peer_parent && !GST_OBJECT_FLAG_IS_SET (peer_parent,
+          GST_ELEMENT_FLAG_SINK)) {
+    gst_object_unref (peer_parent);
+    peer_parent = NULL;
+  }
+  if (!peer_parent && *peer_pad) {
+    gst_object_unref (*peer_pad);
+    *peer_pad = NULL;
+  }
+
+  return peer_parent;
+}
+
+static void
+do_reference_push_buffer_pre (GstLatencyTracer * self, guint64 ts,
+    GstPad * pad, GstBuffer * buffer)
+{
+  GstElement *parent = get_real_pad_parent (pad);
+  GstClockTime now = get_reference_time (self);
+  GstElement *peer_parent;
+  GstPad *peer_pad;
+
+  if (self->reference_stamp && parent && !GST_IS_BIN (parent) &&
+      GST_OBJECT_FLAG_IS_SET (parent, GST_ELEMENT_FLAG_SOURCE))
+    stamp_reference_timestamp (self, buffer, now);
+
+  if ((peer_parent = get_sink_peer (pad, &peer_pad))) {
+    log_reference_latency (self, peer_parent, peer_pad, buffer, now, ts);
+    gst_object_unref (peer_pad);
+    gst_object_unref (peer_parent);
+  }
+
+  if (parent)
+    gst_object_unref (parent);
+}
+
+static void
+do_reference_push_buffer_list_pre (GstLatencyTracer * self, guint64 ts,
+    GstPad * pad, GstBufferList * list)
+{
+  GstElement *parent = get_real_pad_parent (pad);
+  GstClockTime now = get_reference_time (self);
+  GstElement *peer_parent;
+  GstPad *peer_pad;
+  guint i, len = gst_buffer_list_length (list);
+
+  if (self->reference_stamp && parent && !GST_IS_BIN (parent) &&
+      GST_OBJECT_FLAG_IS_SET (parent, GST_ELEMENT_FLAG_SOURCE) &&
+      gst_buffer_list_is_writable (list)) {
+    for (i = 0; i < len; i++)
+      stamp_reference_timestamp (self, gst_buffer_list_get (list, i), now);
+  }
+
+  if ((peer_parent = get_sink_peer (pad, &peer_pad))) {
+    for (i = 0; i < len; i++)
+      log_reference_latency (self, peer_parent, peer_pad,
+          gst_buffer_list_get (list, i), now, ts);
+    gst_object_unref (peer_pad);
+    gst_object_unref (peer_parent);
+  }
+
+  if (parent)
+    gst_object_unref (parent);
+}
+
+static gint
+compare_clock_times (gconstpointer a, gconstpointer b)
+{
+  GstClockTime ta = *(const GstClockTime *) a;
+  GstClockTime tb = *(const GstClockTime *) b;
+
+  return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+/* sorts the samples, so only called once when the tracer is destroyed */
+static void
+log_reference_latency_summary (GstReferenceLatencyStats * stats, guint64 ts)
+{
+  guint n = MIN (stats->count, REFERENCE_LATENCY_SAMPLES);
+  GstClockTime *sorted = stats->samples;
+
+  /* the percentiles are computed over the most recent latencies */
+  qsort (sorted, n, sizeof (GstClockTime), compare_clock_times);
+
+  gst_tracer_record_log (tr_reference_latency_summary, stats->element,
+      stats->pad, stats->count, stats->min, sorted[(n - 1) * 50 / 100],
+      sorted[(n - 1) * 90 / 100], sorted[(n - 1) * 99 / 100], stats->max, ts);
+}
+
 static void
 do_query_post (GstLatencyTracer * tracer, GstClockTime ts, GstPad * pad,
     GstQuery * query, gboolean res)
@@ -583,16 +812,75 @@ gst_latency_tracer_constructed (GObject * object)
           self->flags |= GST_LATENCY_TRACER_FLAG_ELEMENT;
         else if (g_str_equal (split[i], "reported"))
           self->flags |= GST_LATENCY_TRACER_FLAG_REPORTED_ELEMENT;
+        else if (g_str_equal (split[i], "reference"))
+          self->flags |= GST_LATENCY_TRACER_FLAG_REFERENCE;
         else
           GST_WARNING ("Invalid latency tracer flags %s", split[i]);
       }
 
       g_strfreev (split);
     }
+
+    if (self->flags & GST_LATENCY_TRACER_FLAG_REFERENCE) {
+      const gchar *reference_caps;
+
+      gst_structure_get_boolean (params_struct, "reference-stamp",
+          &self->reference_stamp);
+
+      reference_caps = gst_structure_get_string (params_struct,
+          "reference-caps");
+      if (reference_caps) {
+        GstCaps *caps = gst_caps_from_string (reference_caps);
+
+        if (caps && gst_caps_is_fixed (caps)) {
+          gst_caps_replace (&self->reference_caps, caps);
+        } else {
+          GST_WARNING_OBJECT (self, "Invalid reference caps %s",
+              reference_caps);
+        }
+        if (caps)
+          gst_caps_unref (caps);
+      }
+    }
     gst_structure_free (params_struct);
   }
 
   g_free (params);
+
+  if (self->flags & GST_LATENCY_TRACER_FLAG_REFERENCE) {
+    GstTracer *tracer = GST_TRACER (self);
+
+    /* NTP timestamps count from 1900, all other ones from the UNIX epoch */
+    if (gst_structure_has_name (gst_caps_get_structure (self->reference_caps,
+                0), "timestamp/x-ntp"))
+      self->reference_offset = NTP_UNIX_OFFSET;
+    else
+      self->reference_offset = 0;
+
+    gst_tracing_register_hook (tracer, "pad-push-pre",
+        G_CALLBACK (do_reference_push_buffer_pre));
+    gst_tracing_register_hook (tracer, "pad-push-list-pre",
+        G_CALLBACK (do_reference_push_buffer_list_pre));
+  }
+}
+
+static void
+gst_latency_tracer_finalize (GObject * object)
+{
+  GstLatencyTracer *self = GST_LATENCY_TRACER (object);
+  guint64 ts = gst_util_get_timestamp ();
+  GHashTableIter iter;
+  gpointer stats;
+
+  g_hash_table_iter_init (&iter, self->reference_stats);
+  while (g_hash_table_iter_next (&iter, NULL, &stats))
+    log_reference_latency_summary (stats, ts);
+
+  g_hash_table_unref (self->reference_stats);
+  gst_caps_unref (self->reference_caps);
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
 static void
@@ -601,6 +889,7 @@ gst_latency_tracer_class_init (GstLatencyTracerClass * klass)
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   gobject_class->constructed = gst_latency_tracer_constructed;
+  gobject_class->finalize = gst_latency_tracer_finalize;
 
   latency_probe_id = g_quark_from_static_string ("latency_probe.id");
   sub_latency_probe_id = g_quark_from_static_string ("sub_latency_probe.id");
@@ -726,12 +1015,83 @@ gst_latency_tracer_class_init (GstLatencyTracerClass * klass)
           "max", G_TYPE_UINT64, G_MAXUINT64,
           NULL),
       NULL);
+
+  tr_reference_latency = gst_tracer_record_new ("reference-latency.class",
+      "sink-element", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE,
+          GST_TRACER_VALUE_SCOPE_ELEMENT,
+          NULL),
+      "sink", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_PAD,
+          NULL),
+      "time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "time since the reference timestamp of the buffer in ns",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "ts when the latency has been logged",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      NULL);
+
+  tr_reference_latency_summary = gst_tracer_record_new (
+      "reference-latency-summary.class",
+      "sink-element", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE,
+          GST_TRACER_VALUE_SCOPE_ELEMENT,
+          NULL),
+      "sink", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_PAD,
+          NULL),
+      "count", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of latencies measured",
+          NULL),
+      "min", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "the minimum latency in ns",
+          NULL),
+      "p50", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "the median latency in ns",
+          NULL),
+      "p90", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "the 90th percentile latency in ns",
+          NULL),
+      "p99", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "the 99th percentile latency in ns",
+          NULL),
+      "max", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "the maximum latency in ns",
+          NULL),
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "ts when the summary has been logged",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      NULL);
   /* *INDENT-ON* */
 
   GST_OBJECT_FLAG_SET (tr_latency, GST_OBJECT_FLAG_MAY_BE_LEAKED);
   GST_OBJECT_FLAG_SET (tr_element_latency, GST_OBJECT_FLAG_MAY_BE_LEAKED);
   GST_OBJECT_FLAG_SET (tr_element_reported_latency,
       GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  GST_OBJECT_FLAG_SET (tr_reference_latency, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  GST_OBJECT_FLAG_SET (tr_reference_latency_summary,
+      GST_OBJECT_FLAG_MAY_BE_LEAKED);
 }
 
 static void
@@ -742,6 +1102,12 @@ gst_latency_tracer_init (GstLatencyTracer * self)
   /* only trace pipeline latency by default */
   self->flags = GST_LATENCY_TRACER_FLAG_PIPELINE;
 
+  g_mutex_init (&self->lock);
+  self->reference_caps = gst_caps_new_empty_simple ("timestamp/x-ntp");
+  self->reference_stamp = TRUE;
+  self->reference_stats = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, (GDestroyNotify) free_reference_latency_stats);
+
   /* in push mode, pre/post will be called before/after the peer chain
    * function has been called. For this reaosn, we only use -pre to avoid
    * accounting for the processing time of the peer element (the sink) */
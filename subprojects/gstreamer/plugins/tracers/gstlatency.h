@@ -47,6 +47,7 @@ typedef enum
   GST_LATENCY_TRACER_FLAG_PIPELINE = 1 << 0,
   GST_LATENCY_TRACER_FLAG_ELEMENT = 1 << 1,
   GST_LATENCY_TRACER_FLAG_REPORTED_ELEMENT = 1 << 2,
+  GST_LATENCY_TRACER_FLAG_REFERENCE = 1 << 3,
 } GstLatencyTracerFlags;
 
 /**
@@ -59,6 +60,15 @@ struct _GstLatencyTracer {
 
   /*< private >*/
   GstLatencyTracerFlags flags;
+
+  /* reference timestamp mode */
+  GstCaps *reference_caps;
+  GstClockTime reference_offset;
+  gboolean reference_stamp;
+  GMutex lock;
+  /* "element:pad" of the sink pads -> GstReferenceLatencyStats,
+   * protected by @lock */
+  GHashTable *reference_stats;
 };
 
 struct _GstLatencyTracerClass {
@@ -39,7 +39,7 @@
  * active at the same time.
  *
  * Parameters can also be passed to each tracer. The leaks tracer currently
- * accepts five params:
+ * accepts seven params:
  * 1. filters: (string) to filter which objects to record
  * 2. check-refs: (boolean) whether to record every location where a leaked
  *    object was reffed and unreffed
@@ -47,6 +47,18 @@
  * 4. name: (string) set a name for the tracer object itself
  * 5. log-leaks-on-deinit: (boolean) whether to report all leaks on
  *    gst_deinit() by printing them in the debug log; "true" by default
+ * 6. sample-rate: (uint) enables the sampling mode, see below
+ * 7. snapshot-interval: (uint) in sampling mode, log the per-type counters
+ *    every that many milliseconds; 0, the default, disables this
+ *
+ * Tracking every object is expensive, so the sampling mode is meant for
+ * finding slow leaks in long running processes. With `sample-rate=N` only
+ * one in N objects of each type is tracked, and only those are reported as
+ * leaks with their stack traces. In addition the number of objects created
+ * and alive is counted for every type with atomic operations. These counters
+ * are logged as `object-type-stats` records every `snapshot-interval` and on
+ * gst_deinit(), and can be retrieved with the
+ * #GstLeaksTracer::get-type-stats action signal.
  *
  * Examples:
  * ```
@@ -55,6 +67,9 @@
  * ```
  * GST_TRACERS='leaks(filters="GstBuffer",stack-traces-flags=full,check-refs=true);leaks(name=all-leaks)'
  * ```
+ * ```
+ * GST_TRACERS='leaks(sample-rate=1000,snapshot-interval=60000)'
+ * ```
  */
 
 #ifdef HAVE_CONFIG_H
@@ -80,6 +95,7 @@ enum
   SIGNAL_ACTIVITY_GET_CHECKPOINT,
   SIGNAL_ACTIVITY_LOG_CHECKPOINT,
   SIGNAL_ACTIVITY_STOP_TRACKING,
+  SIGNAL_GET_TYPE_STATS,
 
   LAST_SIGNAL
 };
@@ -99,6 +115,7 @@ static GstStructure *gst_leaks_tracer_activity_get_checkpoint (GstLeaksTracer *
     self);
 static void gst_leaks_tracer_activity_log_checkpoint (GstLeaksTracer * self);
 static void gst_leaks_tracer_activity_stop_tracking (GstLeaksTracer * self);
+static GstStructure *gst_leaks_tracer_get_type_stats (GstLeaksTracer * self);
 
 #ifdef G_OS_UNIX
 static void gst_leaks_tracer_setup_signals (GstLeaksTracer * leaks);
@@ -109,7 +126,9 @@ static GstTracerRecord *tr_alive;
 static GstTracerRecord *tr_refings;
 static GstTracerRecord *tr_added = NULL;
 static GstTracerRecord *tr_removed = NULL;
+static GstTracerRecord *tr_type_stats;
 static GQueue instances = G_QUEUE_INIT;
+static gint instance_count;
 static guint gst_leaks_tracer_signals[LAST_SIGNAL] = { 0 };
 
 G_LOCK_DEFINE_STATIC (instances);
@@ -129,6 +148,52 @@ typedef struct
   GList *refing_infos;
 } ObjectRefingInfos;
 
+/* per-type counters of the sampling mode, only modified atomically. They
+ * are 64 bit as short-lived objects like buffers easily exceed 2^31 */
+typedef struct
+{
+  GType type;
+  guint64 created;
+  gint64 live;
+} TypeStats;
+
+#ifdef __GCC_HAVE_SYNC_COMPARE_AND_SWAP_8
+#define type_stats_add(counter, val) \
+    __atomic_fetch_add ((counter), (val), __ATOMIC_RELAXED)
+#define type_stats_get(counter) __atomic_load_n ((counter), __ATOMIC_RELAXED)
+#else
+G_LOCK_DEFINE_STATIC (type_stats);
+
+static guint64
+type_stats_add_locked (guint64 * counter, gint64 val)
+{
+  guint64 old;
+
+  G_LOCK (type_stats);
+  old = *counter;
+  *counter += val;
+  G_UNLOCK (type_stats);
+
+  return old;
+}
+
+static guint64
+type_stats_get_locked (guint64 * counter)
+{
+  guint64 val;
+
+  G_LOCK (type_stats);
+  val = *counter;
+  G_UNLOCK (type_stats);
+
+  return val;
+}
+
+#define type_stats_add(counter, val) \
+    type_stats_add_locked ((guint64 *) (counter), (val))
+#define type_stats_get(counter) type_stats_get_locked ((guint64 *) (counter))
+#endif
+
 static void
 object_refing_info_free (ObjectRefingInfo * refinfo)
 {
@@ -218,6 +283,7 @@ static void
 set_params_from_structure (GstLeaksTracer * self, GstStructure * params)
 {
   const gchar *filters, *name;
+  guint interval;
 
   filters = gst_structure_get_string (params, "filters");
   if (filters)
@@ -229,6 +295,11 @@ set_params_from_structure (GstLeaksTracer * self, GstStructure * params)
 
   gst_structure_get_boolean (params, "check-refs", &self->check_refs);
   gst_structure_get_boolean (params, "log-leaks-on-deinit", &self->log_leaks);
+
+  gst_structure_get_uint (params, "sample-rate", &self->sample_rate);
+  if (gst_structure_get_uint (params, "snapshot-interval", &interval))
+    self->snapshot_interval = interval * GST_MSECOND;
+  self->next_snapshot_ts = self->snapshot_interval;
 }
 
 static void
@@ -377,9 +448,103 @@ mini_object_weak_cb (gpointer data, GstMiniObject * object)
   handle_object_destroyed (self, object);
 }
 
+static TypeStats *
+get_type_stats (GstLeaksTracer * self, GType type)
+{
+  TypeStats *stats = g_type_get_qdata (type, self->type_stats_quark);
+
+  if (G_UNLIKELY (!stats)) {
+    GST_OBJECT_LOCK (self);
+    stats = g_type_get_qdata (type, self->type_stats_quark);
+    if (!stats) {
+      stats = g_new0 (TypeStats, 1);
+      stats->type = type;
+      g_ptr_array_add (self->type_stats, stats);
+      g_type_set_qdata (type, self->type_stats_quark, stats);
+    }
+    GST_OBJECT_UNLOCK (self);
+  }
+  return stats;
+}
+
+/* called with the object lock */
+static void
+log_type_stats (GstLeaksTracer * self, GstClockTime ts)
+{
+  guint i;
+
+  for (i = 0; i < self->type_stats->len; i++) {
+    TypeStats *stats = g_ptr_array_index (self->type_stats, i);
+    gint64 live = type_stats_get (&stats->live);
+
+    gst_tracer_record_log (tr_type_stats, ts, g_type_name (stats->type),
+        (guint64) type_stats_get (&stats->created), (guint64) MAX (live, 0));
+  }
+}
+
+static void
+maybe_log_snapshot (GstLeaksTracer * self, GstClockTime ts)
+{
+  GstClockTime next;
+
+  if (G_LIKELY (!self->snapshot_interval))
+    return;
+
+  next = self->next_snapshot_ts;
+  if (G_LIKELY (ts < next))
+    return;
+
+  /* only one of the threads gets to log the snapshot */
+  GST_OBJECT_LOCK (self);
+  if (self->next_snapshot_ts == next) {
+    self->next_snapshot_ts = ts + self->snapshot_interval;
+    log_type_stats (self, ts);
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+/* Returns TRUE if the object was picked as a sample to be tracked */
+static gboolean
+sample_object_created (GstLeaksTracer * self, GType type, GstClockTime ts)
+{
+  TypeStats *stats = get_type_stats (self, type);
+  guint64 n = type_stats_add (&stats->created, 1);
+
+  type_stats_add (&stats->live, 1);
+
+  /* remember the start time of the hook timestamps, for logging from
+   * outside of the hooks */
+  if (G_UNLIKELY (!g_atomic_int_get (&self->have_ts_offset))) {
+    GST_OBJECT_LOCK (self);
+    if (!self->have_ts_offset) {
+      self->ts_offset = GST_CLOCK_DIFF (ts, gst_util_get_timestamp ());
+      g_atomic_int_set (&self->have_ts_offset, TRUE);
+    }
+    GST_OBJECT_UNLOCK (self);
+  }
+
+  maybe_log_snapshot (self, ts);
+
+  return n % self->sample_rate == 0;
+}
+
+static void
+sample_object_destroyed (GstLeaksTracer * self, GType type)
+{
+  TypeStats *stats;
+
+  if (type == 0)
+    return;
+
+  /* only types that passed the filter when created have stats */
+  stats = g_type_get_qdata (type, self->type_stats_quark);
+  if (stats)
+    type_stats_add (&stats->live, -1);
+}
+
 static void
 handle_object_created (GstLeaksTracer * self, gpointer object, GType type,
-    gboolean gobject)
+    gboolean gobject, GstClockTime ts)
 {
   ObjectRefingInfos *infos;
 
@@ -387,6 +552,9 @@ handle_object_created (GstLeaksTracer * self, gpointer object, GType type,
   if (!should_handle_object_type (self, type))
     return;
 
+  if (self->sample_rate && !sample_object_created (self, type, ts))
+    return;
+
   infos = g_malloc0 (sizeof (ObjectRefingInfos));
   if (gobject)
     g_object_weak_ref ((GObject *) object, object_weak_cb, self);
@@ -411,7 +579,8 @@ mini_object_created_cb (GstTracer * tracer, GstClockTime ts,
 {
   GstLeaksTracer *self = GST_LEAKS_TRACER_CAST (tracer);
 
-  handle_object_created (self, object, GST_MINI_OBJECT_TYPE (object), FALSE);
+  handle_object_created (self, object, GST_MINI_OBJECT_TYPE (object), FALSE,
+      ts);
 }
 
 static void
@@ -424,7 +593,24 @@ object_created_cb (GstTracer * tracer, GstClockTime ts, GstObject * object)
   if (g_type_is_a (object_type, GST_TYPE_TRACER))
     return;
 
-  handle_object_created (self, object, object_type, TRUE);
+  handle_object_created (self, object, object_type, TRUE, ts);
+}
+
+static void
+mini_object_destroyed_cb (GstTracer * tracer, GstClockTime ts,
+    GstMiniObject * object)
+{
+  GstLeaksTracer *self = GST_LEAKS_TRACER_CAST (tracer);
+
+  sample_object_destroyed (self, GST_MINI_OBJECT_TYPE (object));
+}
+
+static void
+object_destroyed_cb (GstTracer * tracer, GstClockTime ts, GstObject * object)
+{
+  GstLeaksTracer *self = GST_LEAKS_TRACER_CAST (tracer);
+
+  sample_object_destroyed (self, G_OBJECT_TYPE (object));
 }
 
 static void
@@ -501,9 +687,18 @@ mini_object_unreffed_cb (GstTracer * tracer, GstClockTime ts,
 static void
 gst_leaks_tracer_init (GstLeaksTracer * self)
 {
+  gchar *quark_name;
+
   self->log_leaks = DEFAULT_LOG_LEAKS;
   self->objects = g_hash_table_new_full (NULL, NULL, NULL,
       (GDestroyNotify) object_refing_infos_free);
+  self->type_stats = g_ptr_array_new_with_free_func (g_free);
+
+  /* the type qdata outlives us, so never reuse a quark between instances */
+  quark_name = g_strdup_printf ("GstLeaksTracer-type-stats-%d",
+      g_atomic_int_add (&instance_count, 1));
+  self->type_stats_quark = g_quark_from_string (quark_name);
+  g_free (quark_name);
 
   if (g_getenv ("GST_LEAKS_TRACER_SIG")) {
 #ifdef G_OS_UNIX
@@ -544,7 +739,14 @@ gst_leaks_tracer_constructed (GObject * object)
 
   /* We rely on weak pointers rather than (mini-)object-destroyed hooks so we
    * are notified of objects being destroyed even during the shuting down of
-   * the tracing system. */
+   * the tracing system. The per-type counters of the sampling mode can't
+   * afford a weak pointer on every object though. */
+  if (self->sample_rate) {
+    gst_tracing_register_hook (tracer, "mini-object-destroyed",
+        G_CALLBACK (mini_object_destroyed_cb));
+    gst_tracing_register_hook (tracer, "object-destroyed",
+        G_CALLBACK (object_destroyed_cb));
+  }
 
   ((GObjectClass *) gst_leaks_tracer_parent_class)->constructed (object);
 }
@@ -742,6 +944,14 @@ gst_leaks_tracer_finalize (GObject * object)
   if (self->log_leaks)
     leaks = process_leaks (self, NULL);
 
+  if (self->sample_rate) {
+    GST_OBJECT_LOCK (self);
+    /* in the timebase of the hooks, like the snapshots */
+    log_type_stats (self, GST_CLOCK_DIFF (self->ts_offset,
+            gst_util_get_timestamp ()));
+    GST_OBJECT_UNLOCK (self);
+  }
+
   /* Remove weak references */
   g_hash_table_iter_init (&iter, self->objects);
   while (g_hash_table_iter_next (&iter, &obj, NULL)) {
@@ -758,6 +968,7 @@ gst_leaks_tracer_finalize (GObject * object)
   g_clear_pointer (&self->added, g_hash_table_unref);
   g_clear_pointer (&self->removed, g_hash_table_unref);
   g_clear_pointer (&self->unhandled_filter, g_hash_table_unref);
+  g_clear_pointer (&self->type_stats, g_ptr_array_unref);
 
   G_LOCK (instances);
   g_queue_remove (&instances, self);
@@ -797,6 +1008,14 @@ gst_leaks_tracer_finalize (GObject * object)
     "trace", GST_TYPE_STRUCTURE, gst_structure_new ("value", \
         "type", G_TYPE_GTYPE, G_TYPE_STRING, \
         NULL)
+#define RECORD_FIELD_CREATED \
+    "created", GST_TYPE_STRUCTURE, gst_structure_new ("value", \
+        "type", G_TYPE_GTYPE, G_TYPE_UINT64, \
+        NULL)
+#define RECORD_FIELD_LIVE \
+    "live", GST_TYPE_STRUCTURE, gst_structure_new ("value", \
+        "type", G_TYPE_GTYPE, G_TYPE_UINT64, \
+        NULL)
 
 #ifdef G_OS_UNIX
 static gboolean
@@ -1093,6 +1312,39 @@ gst_leaks_tracer_activity_stop_tracking (GstLeaksTracer * self)
   GST_OBJECT_UNLOCK (self);
 }
 
+static GstStructure *
+gst_leaks_tracer_get_type_stats (GstLeaksTracer * self)
+{
+  GstStructure *info;
+  GValue types = G_VALUE_INIT;
+  guint i;
+
+  g_value_init (&types, GST_TYPE_LIST);
+
+  GST_OBJECT_LOCK (self);
+  for (i = 0; i < self->type_stats->len; i++) {
+    TypeStats *stats = g_ptr_array_index (self->type_stats, i);
+    gint64 live = type_stats_get (&stats->live);
+    GValue s_value = G_VALUE_INIT;
+    GstStructure *s;
+
+    s = gst_structure_new ("object-type-stats",
+        "type-name", G_TYPE_STRING, g_type_name (stats->type),
+        "created", G_TYPE_UINT64, (guint64) type_stats_get (&stats->created),
+        "live", G_TYPE_UINT64, (guint64) MAX (live, 0), NULL);
+    /* avoid copy of the structure */
+    g_value_init (&s_value, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&s_value, s);
+    gst_value_list_append_and_take_value (&types, &s_value);
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  info = gst_structure_new_empty ("type-stats");
+  gst_structure_take_value (info, "type-stats-list", &types);
+
+  return info;
+}
+
 static void
 gst_leaks_tracer_class_init (GstLeaksTracerClass * klass)
 {
@@ -1119,6 +1371,11 @@ gst_leaks_tracer_class_init (GstLeaksTracerClass * klass)
       RECORD_FIELD_TYPE_NAME, RECORD_FIELD_ADDRESS, NULL);
   GST_OBJECT_FLAG_SET (tr_removed, GST_OBJECT_FLAG_MAY_BE_LEAKED);
 
+  tr_type_stats = gst_tracer_record_new ("object-type-stats.class",
+      RECORD_FIELD_TYPE_TS, RECORD_FIELD_TYPE_NAME, RECORD_FIELD_CREATED,
+      RECORD_FIELD_LIVE, NULL);
+  GST_OBJECT_FLAG_SET (tr_type_stats, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+
   /**
    * GstLeaksTracer::get-live-objects:
    * @leakstracer: the leaks tracer object to emit this signal on
@@ -1271,10 +1528,35 @@ gst_leaks_tracer_class_init (GstLeaksTracerClass * klass)
           activity_stop_tracking), NULL, NULL, NULL, G_TYPE_NONE, 0,
       G_TYPE_NONE);
 
+  /**
+   * GstLeaksTracer::get-type-stats:
+   * @leakstracer: the leaks tracer object to emit this signal on
+   *
+   * Returns a #GstStructure with a `"type-stats-list"` field, a #GValue of
+   * type #GST_TYPE_LIST containing one #GstStructure per object type seen
+   * by the sampling mode with the following fields:
+   *
+   * `type-name`: a string representing the type of the objects
+   * `created`: the number of objects of that type created so far
+   * `live`: the number of objects of that type currently alive
+   *
+   * The list is empty unless the `sample-rate` param is set.
+   *
+   * Returns: (transfer full): a newly-allocated #GstStructure
+   *
+   * Since: 1.22
+   */
+  gst_leaks_tracer_signals[SIGNAL_GET_TYPE_STATS] =
+      g_signal_new ("get-type-stats", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, G_STRUCT_OFFSET (GstLeaksTracerClass,
+          get_type_stats), NULL, NULL, NULL, GST_TYPE_STRUCTURE, 0,
+      G_TYPE_NONE);
+
   klass->get_live_objects = gst_leaks_tracer_get_live_objects;
   klass->log_live_objects = gst_leaks_tracer_log_live_objects;
   klass->activity_start_tracking = gst_leaks_tracer_activity_start_tracking;
   klass->activity_get_checkpoint = gst_leaks_tracer_activity_get_checkpoint;
   klass->activity_log_checkpoint = gst_leaks_tracer_activity_log_checkpoint;
   klass->activity_stop_tracking = gst_leaks_tracer_activity_stop_tracking;
+  klass->get_type_stats = gst_leaks_tracer_get_type_stats;
 }
@@ -72,6 +72,19 @@ struct _GstLeaksTracer {
   gboolean log_leaks;
 
   GstStackTraceFlags trace_flags;
+
+  /* sampling mode, see the sample-rate param. The TypeStats are stored as
+   * qdata on their GType with @type_stats_quark and owned by @type_stats,
+   * which is protected by object lock */
+  guint sample_rate;
+  GQuark type_stats_quark;
+  GPtrArray *type_stats;
+  GstClockTime snapshot_interval;
+  GstClockTime next_snapshot_ts;
+  /* absolute time minus hook timestamp, set with the object lock once
+   * @have_ts_offset is set */
+  GstClockTimeDiff ts_offset;
+  gint have_ts_offset;
 };
 
 struct _GstLeaksTracerClass {
@@ -84,6 +97,7 @@ struct _GstLeaksTracerClass {
   GstStructure * (*activity_get_checkpoint)     (GstLeaksTracer *tracer);
   void           (*activity_log_checkpoint)     (GstLeaksTracer *tracer);
   void           (*activity_stop_tracking)      (GstLeaksTracer *tracer);
+  GstStructure * (*get_type_stats)              (GstLeaksTracer *tracer);
 };
 
 G_GNUC_INTERNAL GType gst_leaks_tracer_get_type (void);
@@ -0,0 +1,431 @@
+/* GStreamer
+ *
+ * gstpipelinegraph.c: tracing module exporting annotated pipeline graphs
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-pipelinegraph
+ * @short_description: periodically export annotated pipeline graphs
+ *
+ * A tracing module that periodically exports the graph of every running
+ * top-level pipeline in graphviz dot format. Each link is annotated with the
+ * number of buffers and bytes per second that went through it since the
+ * previous export and with the time the last push over it took. Links
+ * leaving a queue or queue2 element also show the fill level of the queue.
+ *
+ * The graphs are posted as `pipeline-graph` element messages with a `dot`
+ * string field on the bus of the pipeline. If the `GST_DEBUG_DUMP_DOT_DIR`
+ * environment variable is set they are also written to
+ * `<pipeline-name>.live.dot` in that directory, replacing the previous
+ * export, so that a viewer like xdot shows the live state of the pipeline:
+ *
+ * ```
+ * $ GST_TRACERS="pipelinegraph(interval=500)" GST_DEBUG_DUMP_DOT_DIR=/tmp \
+ *   gst-launch-1.0 ...
+ * $ xdot /tmp/pipeline0.live.dot
+ * ```
+ *
+ * The tracer accepts the following parameters:
+ *
+ * * `interval`: the export interval in milliseconds, 1000 by default.
+ * * `details`: the #GstDebugGraphDetails of the graphs, `media-type` by
+ *   default.
+ * * `post-messages`: whether to post the graphs on the bus, %TRUE by
+ *   default.
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <string.h>
+
+#include "gstpipelinegraph.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_pipeline_graph_debug);
+#define GST_CAT_DEFAULT gst_pipeline_graph_debug
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_pipeline_graph_debug, "pipelinegraph", 0, \
+        "pipeline graph tracer");
+#define gst_pipeline_graph_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstPipelineGraphTracer, gst_pipeline_graph_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+#define DEFAULT_INTERVAL (GST_SECOND)
+#define DEFAULT_DETAILS (GST_DEBUG_GRAPH_SHOW_MEDIA_TYPE)
+
+static gint instance_count = 0;
+
+typedef struct
+{
+  guint64 buffers;
+  guint64 bytes;
+  GstClockTime push_start;
+  GstClockTime push_time;
+
+  /* counters at the previous export */
+  guint64 prev_buffers;
+  guint64 prev_bytes;
+  GstClockTime prev_ts;
+} GstPadMetrics;
+
+static GstPadMetrics *
+get_pad_metrics (GstPipelineGraphTracer * self, GstPad * pad, GstClockTime ts)
+{
+  GstPadMetrics *metrics;
+
+  metrics = g_object_get_qdata ((GObject *) pad, self->metrics_quark);
+  if (G_UNLIKELY (!metrics)) {
+    metrics = g_new0 (GstPadMetrics, 1);
+    metrics->push_time = GST_CLOCK_TIME_NONE;
+    metrics->prev_ts = ts;
+    g_object_set_qdata_full ((GObject *) pad, self->metrics_quark, metrics,
+        g_free);
+  }
+  return metrics;
+}
+
+/* hooks */
+
+static void
+do_push_buffer_pre (GstPipelineGraphTracer * self, GstClockTime ts,
+    GstPad * pad, GstBuffer * buffer)
+{
+  GstPadMetrics *metrics = get_pad_metrics (self, pad, ts);
+
+  metrics->buffers++;
+  metrics->bytes += gst_buffer_get_size (buffer);
+  metrics->push_start = ts;
+}
+
+static void
+do_push_buffer_list_pre (GstPipelineGraphTracer * self, GstClockTime ts,
+    GstPad * pad, GstBufferList * list)
+{
+  GstPadMetrics *metrics = get_pad_metrics (self, pad, ts);
+
+  metrics->buffers += gst_buffer_list_length (list);
+  metrics->bytes += gst_buffer_list_calculate_size (list);
+  metrics->push_start = ts;
+}
+
+static void
+do_push_buffer_post (GstPipelineGraphTracer * self, GstClockTime ts,
+    GstPad * pad, GstFlowReturn res)
+{
+  GstPadMetrics *metrics;
+
+  metrics = g_object_get_qdata ((GObject *) pad, self->metrics_quark);
+  if (metrics)
+    metrics->push_time = ts - metrics->push_start;
+}
+
+static void
+do_element_change_state_post (GstPipelineGraphTracer * self, GstClockTime ts,
+    GstElement * element, GstStateChange transition,
+    GstStateChangeReturn result)
+{
+  GList *node;
+
+  if (!GST_IS_PIPELINE (element) || GST_OBJECT_PARENT (element))
+    return;
+
+  g_mutex_lock (&self->lock);
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED &&
+      result != GST_STATE_CHANGE_FAILURE) {
+    GWeakRef *ref = g_new0 (GWeakRef, 1);
+
+    g_weak_ref_init (ref, element);
+    self->pipelines = g_list_prepend (self->pipelines, ref);
+  } else if (transition == GST_STATE_CHANGE_PAUSED_TO_READY) {
+    for (node = self->pipelines; node; node = node->next) {
+      GWeakRef *ref = node->data;
+      GstElement *pipeline = g_weak_ref_get (ref);
+
+      if (pipeline)
+        gst_object_unref (pipeline);
+      if (pipeline == element) {
+        g_weak_ref_clear (ref);
+        g_free (ref);
+        self->pipelines = g_list_delete_link (self->pipelines, node);
+        break;
+      }
+    }
+  }
+  g_mutex_unlock (&self->lock);
+}
+
+/* export */
+
+static void
+append_queue_level (GString * str, GstElement * element)
+{
+  GObjectClass *klass = G_OBJECT_GET_CLASS (element);
+  static const gchar *const props[] = { "current-level-buffers",
+    "current-level-bytes", "current-level-time", "max-size-buffers",
+    "max-size-bytes", "max-size-time"
+  };
+  guint buffers, bytes, max_buffers, max_bytes;
+  guint64 time, max_time;
+  gdouble fill = 0.0;
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (props); i++) {
+    GParamSpec *pspec = g_object_class_find_property (klass, props[i]);
+
+    if (!pspec || pspec->value_type != (g_str_has_suffix (props[i], "-time") ?
+            G_TYPE_UINT64 : G_TYPE_UINT))
+      return;
+  }
+
+  g_object_get (element, "current-level-buffers", &buffers,
+      "current-level-bytes", &bytes, "current-level-time", &time,
+      "max-size-buffers", &max_buffers, "max-size-bytes", &max_bytes,
+      "max-size-time", &max_time, NULL);
+
+  /* the queue is full when any of its limits is reached */
+  if (max_buffers)
+    fill = MAX (fill, (gdouble) buffers / max_buffers);
+  if (max_bytes)
+    fill = MAX (fill, (gdouble) bytes / max_bytes);
+  if (max_time)
+    fill = MAX (fill, (gdouble) time / max_time);
+
+  g_string_append_printf (str, "\nqueue %u buffers, %u bytes, %.1f ms "
+      "(%.0f%% full)", buffers, bytes, (gdouble) time / GST_MSECOND,
+      fill * 100.0);
+}
+
+static gchar *
+make_link_label (GstPad * pad, gpointer user_data)
+{
+  GstPipelineGraphTracer *self = user_data;
+  GstClockTime ts = gst_util_get_timestamp ();
+  GstPadMetrics *metrics;
+  GstElement *element;
+  GString *str;
+  gdouble elapsed;
+
+  metrics = g_object_get_qdata ((GObject *) pad, self->metrics_quark);
+  if (!metrics)
+    return NULL;
+
+  str = g_string_new (NULL);
+
+  elapsed = (gdouble) (ts - metrics->prev_ts) / GST_SECOND;
+  if (elapsed > 0.0) {
+    g_string_append_printf (str, "%.1f buffers/s, %.1f kB/s",
+        (metrics->buffers - metrics->prev_buffers) / elapsed,
+        (metrics->bytes - metrics->prev_bytes) / elapsed / 1024.0);
+  }
+  metrics->prev_buffers = metrics->buffers;
+  metrics->prev_bytes = metrics->bytes;
+  metrics->prev_ts = ts;
+
+  if (GST_CLOCK_TIME_IS_VALID (metrics->push_time)) {
+    g_string_append_printf (str, "\npush %.3f ms",
+        (gdouble) metrics->push_time / GST_MSECOND);
+  }
+
+  if ((element = gst_pad_get_parent_element (pad))) {
+    append_queue_level (str, element);
+    gst_object_unref (element);
+  }
+
+  return g_string_free (str, FALSE);
+}
+
+static void
+export_pipeline (GstPipelineGraphTracer * self, GstElement * pipeline)
+{
+  const gchar *dir;
+  gchar *dot;
+
+  dot = gst_debug_bin_to_dot_data_full (GST_BIN_CAST (pipeline),
+      self->details, make_link_label, self);
+
+  if (self->post_messages) {
+    gst_element_post_message (pipeline,
+        gst_message_new_element (GST_OBJECT_CAST (pipeline),
+            gst_structure_new ("pipeline-graph", "dot", G_TYPE_STRING, dot,
+                NULL)));
+  }
+
+  dir = g_getenv ("GST_DEBUG_DUMP_DOT_DIR");
+  if (dir && *dir) {
+    gchar *file_name, *full_file_name;
+    GError *err = NULL;
+
+    file_name = g_strdup_printf ("%s.live.dot", GST_OBJECT_NAME (pipeline));
+    full_file_name = g_build_filename (dir, file_name, NULL);
+    if (!g_file_set_contents (full_file_name, dot, -1, &err)) {
+      GST_WARNING_OBJECT (self, "failed to write %s: %s", full_file_name,
+          err->message);
+      g_clear_error (&err);
+    }
+    g_free (full_file_name);
+    g_free (file_name);
+  }
+
+  g_free (dot);
+}
+
+static gboolean
+export_pipelines (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  GstPipelineGraphTracer *self = user_data;
+  GList *node;
+
+  g_mutex_lock (&self->lock);
+  for (node = self->pipelines; node; node = node->next) {
+    GstElement *pipeline = g_weak_ref_get (node->data);
+
+    if (pipeline) {
+      export_pipeline (self, pipeline);
+      gst_object_unref (pipeline);
+    }
+  }
+  g_mutex_unlock (&self->lock);
+
+  return TRUE;
+}
+
+/* tracer class */
+
+static void
+gst_pipeline_graph_tracer_constructed (GObject * object)
+{
+  GstPipelineGraphTracer *self = GST_PIPELINE_GRAPH_TRACER (object);
+  gchar *params, *tmp;
+  const gchar *name, *details;
+  GstStructure *params_struct = NULL;
+  guint interval;
+
+  g_object_get (self, "params", &params, NULL);
+
+  if (params) {
+    tmp = g_strdup_printf ("pipelinegraph,%s", params);
+    params_struct = gst_structure_from_string (tmp, NULL);
+    g_free (tmp);
+    g_free (params);
+  }
+
+  if (params_struct) {
+    /* Set the name if assigned */
+    name = gst_structure_get_string (params_struct, "name");
+    if (name)
+      gst_object_set_name (GST_OBJECT (self), name);
+
+    if (gst_structure_get_uint (params_struct, "interval", &interval))
+      self->interval = interval * GST_MSECOND;
+
+    gst_structure_get_boolean (params_struct, "post-messages",
+        &self->post_messages);
+
+    details = gst_structure_get_string (params_struct, "details");
+    if (details) {
+      GValue value = G_VALUE_INIT;
+
+      g_value_init (&value, GST_TYPE_DEBUG_GRAPH_DETAILS);
+      if (gst_value_deserialize (&value, details))
+        self->details = g_value_get_flags (&value);
+      else
+        GST_WARNING_OBJECT (self, "invalid details '%s'", details);
+      g_value_unset (&value);
+    }
+
+    gst_structure_free (params_struct);
+  }
+
+  if (self->interval == 0) {
+    GST_WARNING_OBJECT (self, "interval must be greater than 0");
+    self->interval = DEFAULT_INTERVAL;
+  }
+
+  self->clock = gst_system_clock_obtain ();
+  self->clock_id = gst_clock_new_periodic_id (self->clock,
+      gst_clock_get_time (self->clock) + self->interval, self->interval);
+  gst_clock_id_wait_async (self->clock_id, export_pipelines, self, NULL);
+}
+
+static void
+gst_pipeline_graph_tracer_finalize (GObject * object)
+{
+  GstPipelineGraphTracer *self = GST_PIPELINE_GRAPH_TRACER (object);
+  GList *node;
+
+  if (self->clock_id) {
+    gst_clock_id_unschedule (self->clock_id);
+    gst_clock_id_unref (self->clock_id);
+  }
+  if (self->clock)
+    gst_object_unref (self->clock);
+
+  /* wait for a running export */
+  g_mutex_lock (&self->lock);
+  for (node = self->pipelines; node; node = node->next) {
+    g_weak_ref_clear (node->data);
+    g_free (node->data);
+  }
+  g_list_free (self->pipelines);
+  g_mutex_unlock (&self->lock);
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_pipeline_graph_tracer_class_init (GstPipelineGraphTracerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->constructed = gst_pipeline_graph_tracer_constructed;
+  gobject_class->finalize = gst_pipeline_graph_tracer_finalize;
+}
+
+static void
+gst_pipeline_graph_tracer_init (GstPipelineGraphTracer * self)
+{
+  GstTracer *tracer = GST_TRACER (self);
+  gchar *quark_name;
+
+  g_mutex_init (&self->lock);
+  self->details = DEFAULT_DETAILS;
+  self->interval = DEFAULT_INTERVAL;
+  self->post_messages = TRUE;
+
+  /* the pad qdata can outlive us, so never reuse a quark between instances */
+  quark_name = g_strdup_printf ("GstPipelineGraphTracer-metrics-%d",
+      g_atomic_int_add (&instance_count, 1));
+  self->metrics_quark = g_quark_from_string (quark_name);
+  g_free (quark_name);
+
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (do_push_buffer_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (do_push_buffer_list_pre));
+  gst_tracing_register_hook (tracer, "pad-push-post",
+      G_CALLBACK (do_push_buffer_post));
+  gst_tracing_register_hook (tracer, "pad-push-list-post",
+      G_CALLBACK (do_push_buffer_post));
+  gst_tracing_register_hook (tracer, "element-change-state-post",
+      G_CALLBACK (do_element_change_state_post));
+}
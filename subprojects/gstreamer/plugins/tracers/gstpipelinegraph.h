@@ -0,0 +1,58 @@
+/* GStreamer
+ *
+ * gstpipelinegraph.h: tracing module exporting annotated pipeline graphs
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_PIPELINE_GRAPH_TRACER_H__
+#define __GST_PIPELINE_GRAPH_TRACER_H__
+
+#include <gst/gst.h>
+#include <gst/gsttracer.h>
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE(GstPipelineGraphTracer, gst_pipeline_graph_tracer, GST,
+    PIPELINE_GRAPH_TRACER, GstTracer)
+/**
+ * GstPipelineGraphTracer:
+ *
+ * Opaque #GstPipelineGraphTracer data structure
+ */
+struct _GstPipelineGraphTracer {
+  GstTracer 	 parent;
+
+  /*< private >*/
+  /* qdata key of the per pad metrics of this instance */
+  GQuark metrics_quark;
+
+  GstDebugGraphDetails details;
+  GstClockTime interval;
+  gboolean post_messages;
+
+  GstClock *clock;
+  GstClockID clock_id;
+
+  /* serializes the exports and protects @pipelines */
+  GMutex lock;
+  /* list of GWeakRef to the running top-level pipelines */
+  GList *pipelines;
+};
+
+G_END_DECLS
+
+#endif /* __GST_PIPELINE_GRAPH_TRACER_H__ */
@@ -0,0 +1,629 @@
+/* GStreamer
+ *
+ * gstqueuelevels.c: tracing module sampling queue levels
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-queuelevels
+ * @short_description: sample queue levels and detect stalls
+ *
+ * A tracing module that periodically samples the fill level of every queue
+ * in the running pipelines. Queues are elements or pads exposing the
+ * `current-level-buffers`, `current-level-bytes` and `current-level-time`
+ * properties, like queue, queue2, appsrc, the sink pads of multiqueue and the
+ * sink pads of #GstAggregator subclasses. Each sample is logged as a
+ * `queue-level` record.
+ *
+ * A queue is considered stalled when it is holding data in the PLAYING state
+ * and nothing left it for longer than the stall threshold, i.e. the element
+ * downstream of the queue is not consuming data. A `queue-stall` record is
+ * then logged and, unless disabled, a warning message is posted on behalf of
+ * the queue with a `queue-stall` details structure naming the blocked element
+ * in its `blocked-element` field and the stall duration in nanoseconds in its
+ * `duration` field.
+ *
+ * ```
+ * GST_TRACERS="queuelevels(interval=50,stall-threshold=500)" \
+ *   GST_DEBUG=GST_TRACER:7 gst-launch-1.0 ...
+ * ```
+ *
+ * The tracer accepts the following parameters:
+ *
+ * * `interval`: the sampling interval in milliseconds, 100 by default.
+ * * `stall-threshold`: the time in milliseconds after which a queue holding
+ *   data that is not consumed is reported as stalled, 1000 by default.
+ * * `post-messages`: whether to post a warning message for the stalls, %TRUE
+ *   by default.
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gstqueuelevels.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_queue_levels_debug);
+#define GST_CAT_DEFAULT gst_queue_levels_debug
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_queue_levels_debug, "queuelevels", 0, \
+        "queue levels tracer");
+#define gst_queue_levels_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstQueueLevelsTracer, gst_queue_levels_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+#define DEFAULT_INTERVAL (100 * GST_MSECOND)
+#define DEFAULT_STALL_THRESHOLD (GST_SECOND)
+
+static GstTracerRecord *tr_queue_level;
+static GstTracerRecord *tr_queue_stall;
+
+static gint instance_count = 0;
+
+typedef struct
+{
+  /* the element or pad holding the data */
+  GWeakRef queue;
+  /* the pad through which the data leaves the queue */
+  GWeakRef output;
+  /* last time the queue was seen empty or not running */
+  GstClockTime last_idle;
+  gboolean stalled;
+} GstQueueEntry;
+
+typedef struct
+{
+  GstClockTime last_output;
+} GstQueueActivity;
+
+static void
+free_queue_entry (GstQueueEntry * entry)
+{
+  g_weak_ref_clear (&entry->queue);
+  g_weak_ref_clear (&entry->output);
+  g_free (entry);
+}
+
+static gboolean
+has_queue_levels (gpointer object)
+{
+  return g_object_class_find_property (G_OBJECT_GET_CLASS (object),
+      "current-level-buffers") != NULL;
+}
+
+static void
+add_queue (GstQueueLevelsTracer * self, gpointer object)
+{
+  GstQueueEntry *entry = g_new0 (GstQueueEntry, 1);
+
+  GST_DEBUG_OBJECT (self, "sampling %" GST_PTR_FORMAT, object);
+
+  g_weak_ref_init (&entry->queue, object);
+  g_weak_ref_init (&entry->output, NULL);
+  entry->last_idle = gst_util_get_timestamp ();
+
+  g_mutex_lock (&self->lock);
+  self->queues = g_list_prepend (self->queues, entry);
+  g_mutex_unlock (&self->lock);
+}
+
+static GstElement *
+get_real_pad_parent (GstPad * pad)
+{
+  GstObject *parent;
+
+  if (!pad)
+    return NULL;
+
+  parent = gst_object_get_parent (GST_OBJECT_CAST (pad));
+
+  /* if parent of pad is a ghost-pad, then pad is a proxy_pad */
+  if (parent && GST_IS_GHOST_PAD (parent)) {
+    GstObject *tmp;
+    pad = GST_PAD_CAST (parent);
+    tmp = gst_object_get_parent (GST_OBJECT_CAST (pad));
+    gst_object_unref (parent);
+    parent = tmp;
+  }
+  return GST_ELEMENT_CAST (parent);
+}
+
+/* The hook timestamps are relative to gst_init() and the sampling callback
+ * has no way to get that base, so all times are taken with
+ * gst_util_get_timestamp() instead */
+static void
+update_activity (GstQueueLevelsTracer * self, GstPad * pad)
+{
+  GstQueueActivity *activity;
+
+  activity = g_object_get_qdata ((GObject *) pad, self->activity_quark);
+  if (activity)
+    activity->last_output = gst_util_get_timestamp ();
+}
+
+/* hooks */
+
+static void
+do_element_new (GstQueueLevelsTracer * self, GstClockTime ts,
+    GstElement * element)
+{
+  if (has_queue_levels (element))
+    add_queue (self, element);
+}
+
+static void
+do_element_add_pad (GstQueueLevelsTracer * self, GstClockTime ts,
+    GstElement * element, GstPad * pad)
+{
+  /* multiqueue source pads report the level of their sink pad */
+  if (GST_PAD_IS_SINK (pad) && has_queue_levels (pad))
+    add_queue (self, pad);
+}
+
+static void
+do_push_buffer_pre (GstQueueLevelsTracer * self, GstClockTime ts,
+    GstPad * pad, GstBuffer * buffer)
+{
+  update_activity (self, pad);
+}
+
+static void
+do_push_buffer_list_pre (GstQueueLevelsTracer * self, GstClockTime ts,
+    GstPad * pad, GstBufferList * list)
+{
+  update_activity (self, pad);
+}
+
+static void
+do_pull_range_pre (GstQueueLevelsTracer * self, GstClockTime ts, GstPad * pad,
+    guint64 offset, guint size)
+{
+  GstPad *peer = gst_pad_get_peer (pad);
+
+  if (peer) {
+    update_activity (self, peer);
+    gst_object_unref (peer);
+  }
+}
+
+/* sampling */
+
+static guint64
+get_level (gpointer object, const gchar * property)
+{
+  GParamSpec *pspec;
+  GValue value = G_VALUE_INIT, level = G_VALUE_INIT;
+  guint64 ret = 0;
+
+  /* the properties are guint on some elements and guint64 on others */
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (object), property);
+  if (!pspec)
+    return 0;
+
+  g_value_init (&value, pspec->value_type);
+  g_value_init (&level, G_TYPE_UINT64);
+  g_object_get_property (object, property, &value);
+  if (g_value_transform (&value, &level))
+    ret = g_value_get_uint64 (&level);
+  g_value_unset (&value);
+  g_value_unset (&level);
+
+  return ret;
+}
+
+/* Returns the pad the data of @queue leaves through, which is the first
+ * source pad of queue elements and the internally linked pad of queue pads */
+static GstPad *
+find_output_pad (gpointer queue)
+{
+  GstPad *output = NULL;
+
+  if (GST_IS_PAD (queue)) {
+    GstIterator *it = gst_pad_iterate_internal_links (queue);
+    GValue item = G_VALUE_INIT;
+
+    if (it) {
+      if (gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+        output = g_value_dup_object (&item);
+        g_value_unset (&item);
+      }
+      gst_iterator_free (it);
+    }
+  } else {
+    GstElement *element = queue;
+
+    GST_OBJECT_LOCK (element);
+    if (element->srcpads)
+      output = gst_object_ref (element->srcpads->data);
+    GST_OBJECT_UNLOCK (element);
+  }
+
+  return output;
+}
+
+static GstPad *
+get_output_pad (GstQueueLevelsTracer * self, GstQueueEntry * entry,
+    gpointer queue, GstClockTime now)
+{
+  GstPad *output = g_weak_ref_get (&entry->output);
+
+  if (!output && (output = find_output_pad (queue))) {
+    g_weak_ref_set (&entry->output, output);
+    if (!g_object_get_qdata ((GObject *) output, self->activity_quark)) {
+      GstQueueActivity *activity = g_new0 (GstQueueActivity, 1);
+
+      activity->last_output = now;
+      g_object_set_qdata_full ((GObject *) output, self->activity_quark,
+          activity, g_free);
+    }
+  }
+
+  return output;
+}
+
+static GstMessage *
+report_stall (GstQueueLevelsTracer * self, GstElement * element,
+    const gchar * pad_name, GstPad * output, GstClockTime duration,
+    guint64 buffers, guint64 bytes, guint64 time, GstClockTime now)
+{
+  GstElement *blocked = NULL;
+  GstPad *peer;
+  gchar *element_name, *blocked_name;
+  GstMessage *msg = NULL;
+
+  if ((peer = gst_pad_get_peer (output))) {
+    blocked = get_real_pad_parent (peer);
+    gst_object_unref (peer);
+  }
+  blocked_name = blocked ? gst_element_get_name (blocked) : g_strdup ("");
+  element_name = gst_element_get_name (element);
+
+  GST_WARNING_OBJECT (self, "%s:%s stalled for %" GST_TIME_FORMAT
+      ", blocked by '%s'", element_name, pad_name, GST_TIME_ARGS (duration),
+      blocked_name);
+
+  gst_tracer_record_log (tr_queue_stall, element_name, pad_name, blocked_name,
+      duration, now);
+
+  if (self->post_messages) {
+    GError *err;
+    gchar *debug;
+
+    err = g_error_new (GST_STREAM_ERROR, GST_STREAM_ERROR_FAILED,
+        "Element '%s' did not consume any data from '%s' for %"
+        G_GUINT64_FORMAT " ms", blocked_name, element_name,
+        duration / GST_MSECOND);
+    debug = g_strdup_printf ("%s:%s holds %" G_GUINT64_FORMAT " buffers, %"
+        G_GUINT64_FORMAT " bytes, %" GST_TIME_FORMAT, element_name, pad_name,
+        buffers, bytes, GST_TIME_ARGS (time));
+    msg = gst_message_new_warning_with_details (GST_OBJECT_CAST (element),
+        err, debug, gst_structure_new ("queue-stall",
+            "blocked-element", G_TYPE_STRING, blocked_name,
+            "duration", G_TYPE_UINT64, duration, NULL));
+    g_error_free (err);
+    g_free (debug);
+  }
+
+  g_free (element_name);
+  g_free (blocked_name);
+  if (blocked)
+    gst_object_unref (blocked);
+
+  return msg;
+}
+
+/* Samples the level of @entry, returns %FALSE when the queue is gone. Stall
+ * messages are added to @messages, to be posted without holding the lock */
+static gboolean
+sample_queue (GstQueueLevelsTracer * self, GstQueueEntry * entry,
+    GstClockTime now, GList ** messages)
+{
+  gpointer queue;
+  GstElement *element;
+  GstPad *output;
+  GstQueueActivity *activity;
+  guint64 buffers, bytes, time;
+  GstClockTime since;
+  gchar *element_name, *pad_name;
+
+  if (!(queue = g_weak_ref_get (&entry->queue)))
+    return FALSE;
+
+  if (GST_IS_PAD (queue))
+    element = gst_pad_get_parent_element (queue);
+  else
+    element = gst_object_ref (queue);
+
+  /* request pads may be sampled before being added to their element */
+  if (!element)
+    goto done;
+
+  buffers = get_level (queue, "current-level-buffers");
+  bytes = get_level (queue, "current-level-bytes");
+  time = get_level (queue, "current-level-time");
+
+  output = get_output_pad (self, entry, queue, now);
+  if (GST_IS_PAD (queue))
+    pad_name = gst_pad_get_name (queue);
+  else if (output)
+    pad_name = gst_pad_get_name (output);
+  else
+    pad_name = g_strdup ("");
+  element_name = gst_element_get_name (element);
+
+  gst_tracer_record_log (tr_queue_level, element_name, pad_name, buffers,
+      bytes, time, now);
+
+  if (!output || GST_STATE (element) != GST_STATE_PLAYING ||
+      (!buffers && !bytes && !time)) {
+    entry->last_idle = now;
+    entry->stalled = FALSE;
+    goto out;
+  }
+
+  activity = g_object_get_qdata ((GObject *) output, self->activity_quark);
+  since = MAX (entry->last_idle, activity->last_output);
+  if (now < since + self->stall_threshold) {
+    entry->stalled = FALSE;
+  } else if (!entry->stalled) {
+    GstMessage *msg;
+
+    /* only report once per stall */
+    entry->stalled = TRUE;
+    msg = report_stall (self, element, pad_name, output, now - since, buffers,
+        bytes, time, now);
+    if (msg)
+      *messages = g_list_prepend (*messages, msg);
+  }
+
+out:
+  g_free (element_name);
+  g_free (pad_name);
+  if (output)
+    gst_object_unref (output);
+  gst_object_unref (element);
+done:
+  gst_object_unref (queue);
+  return TRUE;
+}
+
+static gboolean
+sample_queues (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  GstQueueLevelsTracer *self = user_data;
+  GstClockTime now = gst_util_get_timestamp ();
+  GList *node, *next, *messages = NULL;
+
+  g_mutex_lock (&self->lock);
+  for (node = self->queues; node; node = next) {
+    next = node->next;
+    if (!sample_queue (self, node->data, now, &messages)) {
+      free_queue_entry (node->data);
+      self->queues = g_list_delete_link (self->queues, node);
+    }
+  }
+  g_mutex_unlock (&self->lock);
+
+  for (node = messages; node; node = node->next) {
+    GstMessage *msg = node->data;
+
+    gst_element_post_message (GST_ELEMENT_CAST (GST_MESSAGE_SRC (msg)), msg);
+  }
+  g_list_free (messages);
+
+  return TRUE;
+}
+
+/* called once the clock dropped the last reference to the sampling entry,
+ * sample_queues() is not running anymore then */
+static void
+sampling_stopped (GstQueueLevelsTracer * self)
+{
+  g_mutex_lock (&self->lock);
+  self->sampling = FALSE;
+  g_cond_signal (&self->cond);
+  g_mutex_unlock (&self->lock);
+}
+
+/* tracer class */
+
+static void
+gst_queue_levels_tracer_constructed (GObject * object)
+{
+  GstQueueLevelsTracer *self = GST_QUEUE_LEVELS_TRACER (object);
+  gchar *params, *tmp;
+  const gchar *name;
+  GstStructure *params_struct = NULL;
+  guint value;
+
+  g_object_get (self, "params", &params, NULL);
+
+  if (params) {
+    tmp = g_strdup_printf ("queuelevels,%s", params);
+    params_struct = gst_structure_from_string (tmp, NULL);
+    g_free (tmp);
+    g_free (params);
+  }
+
+  if (params_struct) {
+    /* Set the name if assigned */
+    name = gst_structure_get_string (params_struct, "name");
+    if (name)
+      gst_object_set_name (GST_OBJECT (self), name);
+
+    if (gst_structure_get_uint (params_struct, "interval", &value))
+      self->interval = value * GST_MSECOND;
+    if (gst_structure_get_uint (params_struct, "stall-threshold", &value))
+      self->stall_threshold = value * GST_MSECOND;
+
+    gst_structure_get_boolean (params_struct, "post-messages",
+        &self->post_messages);
+
+    gst_structure_free (params_struct);
+  }
+
+  if (self->interval == 0) {
+    GST_WARNING_OBJECT (self, "interval must be greater than 0");
+    self->interval = DEFAULT_INTERVAL;
+  }
+
+  self->clock = gst_system_clock_obtain ();
+  self->clock_id = gst_clock_new_periodic_id (self->clock,
+      gst_clock_get_time (self->clock) + self->interval, self->interval);
+  self->sampling = TRUE;
+  gst_clock_id_wait_async (self->clock_id, sample_queues, self,
+      (GDestroyNotify) sampling_stopped);
+}
+
+static void
+gst_queue_levels_tracer_finalize (GObject * object)
+{
+  GstQueueLevelsTracer *self = GST_QUEUE_LEVELS_TRACER (object);
+
+  if (self->clock_id) {
+    gst_clock_id_unschedule (self->clock_id);
+    gst_clock_id_unref (self->clock_id);
+  }
+
+  /* the clock thread might still be running the callback, wait until it
+   * released it */
+  g_mutex_lock (&self->lock);
+  while (self->sampling)
+    g_cond_wait (&self->cond, &self->lock);
+  g_list_free_full (self->queues, (GDestroyNotify) free_queue_entry);
+  g_mutex_unlock (&self->lock);
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond);
+
+  if (self->clock)
+    gst_object_unref (self->clock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_queue_levels_tracer_class_init (GstQueueLevelsTracerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->constructed = gst_queue_levels_tracer_constructed;
+  gobject_class->finalize = gst_queue_levels_tracer_finalize;
+
+  /* *INDENT-OFF* */
+  tr_queue_level = gst_tracer_record_new ("queue-level.class",
+      "element", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE,
+          GST_TRACER_VALUE_SCOPE_ELEMENT,
+          NULL),
+      "pad", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_PAD,
+          NULL),
+      "buffers", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of queued buffers",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "bytes", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of queued bytes",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "duration of the queued data in ns",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "ts when the level has been sampled",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      NULL);
+
+  tr_queue_stall = gst_tracer_record_new ("queue-stall.class",
+      "element", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE,
+          GST_TRACER_VALUE_SCOPE_ELEMENT,
+          NULL),
+      "pad", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_PAD,
+          NULL),
+      "blocked-element", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE,
+          GST_TRACER_VALUE_SCOPE_ELEMENT,
+          NULL),
+      "duration", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "time since data last left the queue in ns",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "ts when the stall has been detected",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      NULL);
+  /* *INDENT-ON* */
+
+  GST_OBJECT_FLAG_SET (tr_queue_level, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  GST_OBJECT_FLAG_SET (tr_queue_stall, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+}
+
+static void
+gst_queue_levels_tracer_init (GstQueueLevelsTracer * self)
+{
+  GstTracer *tracer = GST_TRACER (self);
+  gchar *quark_name;
+
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+  self->interval = DEFAULT_INTERVAL;
+  self->stall_threshold = DEFAULT_STALL_THRESHOLD;
+  self->post_messages = TRUE;
+
+  /* the pad qdata can outlive us, so never reuse a quark between instances */
+  quark_name = g_strdup_printf ("GstQueueLevelsTracer-activity-%d",
+      g_atomic_int_add (&instance_count, 1));
+  self->activity_quark = g_quark_from_string (quark_name);
+  g_free (quark_name);
+
+  gst_tracing_register_hook (tracer, "element-new",
+      G_CALLBACK (do_element_new));
+  gst_tracing_register_hook (tracer, "element-add-pad",
+      G_CALLBACK (do_element_add_pad));
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (do_push_buffer_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (do_push_buffer_list_pre));
+  gst_tracing_register_hook (tracer, "pad-pull-range-pre",
+      G_CALLBACK (do_pull_range_pre));
+}
@@ -0,0 +1,61 @@
+/* GStreamer
+ *
+ * gstqueuelevels.h: tracing module sampling queue levels
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_QUEUE_LEVELS_TRACER_H__
+#define __GST_QUEUE_LEVELS_TRACER_H__
+
+#include <gst/gst.h>
+#include <gst/gsttracer.h>
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE(GstQueueLevelsTracer, gst_queue_levels_tracer, GST,
+    QUEUE_LEVELS_TRACER, GstTracer)
+/**
+ * GstQueueLevelsTracer:
+ *
+ * Opaque #GstQueueLevelsTracer data structure
+ */
+struct _GstQueueLevelsTracer {
+  GstTracer 	 parent;
+
+  /*< private >*/
+  /* qdata key of the output activity of the queues of this instance */
+  GQuark activity_quark;
+
+  GstClockTime interval;
+  GstClockTime stall_threshold;
+  gboolean post_messages;
+
+  GstClock *clock;
+  GstClockID clock_id;
+
+  /* serializes the samples and protects @queues and @sampling */
+  GMutex lock;
+  GCond cond;
+  /* the sampled elements and pads */
+  GList *queues;
+  /* TRUE until the clock released the sampling callback */
+  gboolean sampling;
+};
+
+G_END_DECLS
+
+#endif /* __GST_QUEUE_LEVELS_TRACER_H__ */
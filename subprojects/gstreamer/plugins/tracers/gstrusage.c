@@ -23,8 +23,37 @@
  * @short_description: log resource usage stats
  *
  * A tracing module that take `rusage()` snapshots and logs them.
+ *
+ * When the `elements` param is set to `true`, the time spent in every element
+ * is accounted as well. The time between the pre and post hooks of a buffer
+ * (list) push or a pull_range() call is attributed to the element handling it,
+ * minus the time spent in nested pushes and pulls, so that every element only
+ * gets its own exclusive time even if a thread runs a chain of elements. The
+ * time between two pushes from the bottom of a thread is attributed to the
+ * element pushing, typically a source.
+ *
+ * The time is measured with the tracer timestamps, or with
+ * `CLOCK_THREAD_CPUTIME_ID` if the `thread-cputime` param is set to `true`, in
+ * which case time spent blocked is not counted.
+ *
+ * Every `interval` milliseconds (1000 by default) the `top` elements (5 by
+ * default) of a pipeline that used the most time in that interval are logged
+ * as `element-rusage` records and posted in an element message named
+ * `rusage-elements` on the bus of the pipeline. The message has the fields
+ * `interval` (#guint64) with the length of the interval in nanoseconds and
+ * `elements` (#GST_TYPE_LIST) containing a #GstStructure per element with the
+ * fields `element` (#gchararray), `time` (#guint64) with the time spent in
+ * nanoseconds and `cpuload` (#guint) with the share of the interval in ‰.
+ *
+ * ```
+ * $ GST_TRACERS="rusage(elements=true,thread-cputime=true)" gst-launch-1.0 -m ...
+ * ```
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE             /* for sched_getcpu() */
+#endif
+
 #ifdef HAVE_CONFIG_H
 #  include "config.h"
 #endif
@@ -32,6 +61,10 @@
 #include <unistd.h>
 #include "gstrusage.h"
 
+#ifdef HAVE_SCHED_GETCPU
+#include <sched.h>
+#endif
+
 #ifdef HAVE_SYS_RESOURCE_H
 #ifndef __USE_GNU
 # define __USE_GNU              /* RUSAGE_THREAD */
@@ -43,6 +76,7 @@ GST_DEBUG_CATEGORY_STATIC (gst_rusage_debug);
 #define GST_CAT_DEFAULT gst_rusage_debug
 
 G_LOCK_DEFINE (_proc);
+G_LOCK_DEFINE_STATIC (_elements);
 
 #define _do_init \
     GST_DEBUG_CATEGORY_INIT (gst_rusage_debug, "rusage", 0, "rusage tracer");
@@ -53,10 +87,13 @@ G_DEFINE_TYPE_WITH_CODE (GstRUsageTracer, gst_rusage_tracer, GST_TYPE_TRACER,
 /* remember x measurements per self->window */
 #define WINDOW_SUBDIV 100
 
+#define DEFAULT_INTERVAL (GST_SECOND)
+#define DEFAULT_TOP 5
+
 /* number of cpus to scale cpu-usage in threads */
 static glong num_cpus = 1;
 
-static GstTracerRecord *tr_proc, *tr_thread;
+static GstTracerRecord *tr_proc, *tr_thread, *tr_element;
 
 typedef struct
 {
@@ -69,6 +106,44 @@ static void free_thread_stats (gpointer data);
 
 static GPrivate thread_stats_key = G_PRIVATE_INIT (free_thread_stats);
 
+typedef struct
+{
+  gchar *name;
+  /* the bus of the pipeline, only used to group elements */
+  gpointer bus;
+  /* time spent in this element and the part of it that has been reported */
+  GstClockTime time;
+  GstClockTime reported_time;
+  GstClockTime delta;
+} GstElementRUsage;
+
+typedef struct
+{
+  GstClockTime last_ts;
+} GstRUsageReport;
+
+/* an element handling a push or pull in the current thread */
+typedef struct
+{
+  GstElement *element;
+  GstClockTime start;
+  /* time spent in nested pushes and pulls */
+  GstClockTime child_time;
+} GstElementFrame;
+
+typedef struct
+{
+  GArray *frames;
+  /* the element that pushed last from the bottom of the stack and when it
+   * returned, only used for comparing */
+  gpointer root;
+  GstClockTime root_end;
+} GstThreadFrames;
+
+static void free_thread_frames (gpointer data);
+
+static GPrivate thread_frames_key = G_PRIVATE_INIT (free_thread_frames);
+
 /* data helper */
 
 static void
@@ -164,6 +239,13 @@ do_stats (GstTracer * obj, guint64 ts)
   GstClockTime tproc = G_GUINT64_CONSTANT (0);
   GstClockTime tthread = G_GUINT64_CONSTANT (0);
   GstClockTime dts, dtproc;
+  gint cpu = -1;
+
+#ifdef HAVE_SCHED_GETCPU
+  /* allows checking the CPU affinity of streaming threads, see
+   * gst_task_set_cpu_affinity() */
+  cpu = sched_getcpu ();
+#endif
 
 #ifdef HAVE_CLOCK_GETTIME
   {
@@ -245,7 +327,7 @@ do_stats (GstTracer * obj, guint64 ts)
   cur_cpuload = (guint) gst_util_uint64_scale (dtproc,
       G_GINT64_CONSTANT (1000), dts);
   gst_tracer_record_log (tr_thread, (guint64) (guintptr) thread_id, ts,
-      MIN (avg_cpuload, 1000), MIN (cur_cpuload, 1000), stats->tthread);
+      MIN (avg_cpuload, 1000), MIN (cur_cpuload, 1000), stats->tthread, cpu);
 
   avg_cpuload = (guint) gst_util_uint64_scale (tproc / num_cpus,
       G_GINT64_CONSTANT (1000), ts);
@@ -259,6 +341,280 @@ do_stats (GstTracer * obj, guint64 ts)
   /* *INDENT-ON* */
 }
 
+/* per element accounting */
+
+static void
+free_element_rusage (GstElementRUsage * stats)
+{
+  g_free (stats->name);
+  g_free (stats);
+}
+
+static void
+free_thread_frames (gpointer data)
+{
+  GstThreadFrames *tf = data;
+
+  g_array_free (tf->frames, TRUE);
+  g_free (tf);
+}
+
+static GstThreadFrames *
+get_thread_frames (void)
+{
+  GstThreadFrames *tf = g_private_get (&thread_frames_key);
+
+  if (G_UNLIKELY (!tf)) {
+    tf = g_new0 (GstThreadFrames, 1);
+    tf->frames = g_array_new (FALSE, FALSE, sizeof (GstElementFrame));
+    tf->root_end = GST_CLOCK_TIME_NONE;
+    g_private_set (&thread_frames_key, tf);
+  }
+  return tf;
+}
+
+static GstClockTime
+get_element_time (GstRUsageTracer * self, GstClockTime ts)
+{
+#ifdef HAVE_CLOCK_GETTIME
+  if (self->thread_cputime) {
+    struct timespec now;
+
+    if (!clock_gettime (CLOCK_THREAD_CPUTIME_ID, &now))
+      return GST_TIMESPEC_TO_TIME (now);
+  }
+#endif
+  return ts;
+}
+
+static GstElement *
+get_pad_element (GstPad * pad)
+{
+  GstObject *parent;
+
+  if (!pad)
+    return NULL;
+
+  parent = GST_OBJECT_PARENT (pad);
+  return GST_IS_ELEMENT (parent) ? GST_ELEMENT_CAST (parent) : NULL;
+}
+
+static gint
+compare_element_rusage (gconstpointer a, gconstpointer b)
+{
+  const GstElementRUsage *sa = *(const GstElementRUsage **) a;
+  const GstElementRUsage *sb = *(const GstElementRUsage **) b;
+
+  if (sa->delta == sb->delta)
+    return 0;
+  return sa->delta > sb->delta ? -1 : 1;
+}
+
+/* called with the _elements lock */
+static GstStructure *
+make_report (GstRUsageTracer * self, gpointer bus, GstClockTime ts,
+    GstClockTime window)
+{
+  GstStructure *s;
+  GPtrArray *sorted;
+  GHashTableIter iter;
+  GValue elements = G_VALUE_INIT;
+  gpointer value;
+  guint i;
+
+  sorted = g_ptr_array_new ();
+  g_hash_table_iter_init (&iter, self->element_stats);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    GstElementRUsage *stats = value;
+
+    if (stats->bus != bus)
+      continue;
+
+    stats->delta = stats->time - stats->reported_time;
+    stats->reported_time = stats->time;
+    if (stats->delta > 0)
+      g_ptr_array_add (sorted, stats);
+  }
+  g_ptr_array_sort (sorted, compare_element_rusage);
+
+  g_value_init (&elements, GST_TYPE_LIST);
+  for (i = 0; i < MIN (sorted->len, self->top); i++) {
+    GstElementRUsage *stats = g_ptr_array_index (sorted, i);
+    GValue s_value = G_VALUE_INIT;
+    guint cpuload;
+
+    cpuload = (guint) gst_util_uint64_scale (stats->delta,
+        G_GINT64_CONSTANT (1000), window);
+    cpuload = MIN (cpuload, 1000);
+
+    gst_tracer_record_log (tr_element, ts, stats->name, stats->delta,
+        cpuload);
+
+    g_value_init (&s_value, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&s_value, gst_structure_new ("element-rusage",
+            "element", G_TYPE_STRING, stats->name,
+            "time", G_TYPE_UINT64, stats->delta,
+            "cpuload", G_TYPE_UINT, cpuload, NULL));
+    gst_value_list_append_and_take_value (&elements, &s_value);
+  }
+  g_ptr_array_free (sorted, TRUE);
+
+  s = gst_structure_new ("rusage-elements",
+      "interval", G_TYPE_UINT64, window, NULL);
+  gst_structure_take_value (s, "elements", &elements);
+
+  return s;
+}
+
+static void
+add_element_time (GstRUsageTracer * self, GstElement * element,
+    GstClockTime time, GstClockTime ts)
+{
+  GstElementRUsage *stats;
+  GstRUsageReport *report;
+  GstStructure *s = NULL;
+  gpointer bus = GST_ELEMENT_BUS (element);
+
+  G_LOCK (_elements);
+  stats = g_hash_table_lookup (self->element_stats, element);
+  if (G_UNLIKELY (!stats)) {
+    stats = g_new0 (GstElementRUsage, 1);
+    stats->name = gst_object_get_name (GST_OBJECT_CAST (element));
+    g_hash_table_insert (self->element_stats, element, stats);
+  }
+  stats->bus = bus;
+  stats->time += time;
+
+  if (bus) {
+    report = g_hash_table_lookup (self->reports, bus);
+    if (G_UNLIKELY (!report)) {
+      report = g_new0 (GstRUsageReport, 1);
+      report->last_ts = ts;
+      g_hash_table_insert (self->reports, bus, report);
+    } else if (ts >= report->last_ts + self->interval) {
+      s = make_report (self, bus, ts, ts - report->last_ts);
+      report->last_ts = ts;
+    }
+  }
+  G_UNLOCK (_elements);
+
+  /* the element is alive while it handles data and its messages end up on
+   * the bus of the pipeline */
+  if (s)
+    gst_element_post_message (element,
+        gst_message_new_element (GST_OBJECT_CAST (element), s));
+}
+
+static void
+element_time_pre (GstRUsageTracer * self, GstClockTime ts, GstPad * pad,
+    GstElement * element)
+{
+  GstThreadFrames *tf = get_thread_frames ();
+  GstClockTime now = get_element_time (self, ts);
+  GstElementFrame frame;
+
+  if (tf->frames->len == 0) {
+    GstElement *pusher = get_pad_element (pad);
+
+    /* account the time since the last push to the element pushing again */
+    if (pusher && pusher == tf->root && GST_CLOCK_TIME_IS_VALID (tf->root_end)
+        && now > tf->root_end)
+      add_element_time (self, pusher, now - tf->root_end, ts);
+  }
+
+  frame.element = element;
+  frame.start = now;
+  frame.child_time = 0;
+  g_array_append_val (tf->frames, frame);
+}
+
+static void
+element_time_post (GstRUsageTracer * self, GstClockTime ts, GstPad * pad)
+{
+  GstThreadFrames *tf = get_thread_frames ();
+  GstClockTime now, total;
+  GstElementFrame frame;
+
+  /* the tracer was created during a push */
+  if (G_UNLIKELY (tf->frames->len == 0))
+    return;
+
+  now = get_element_time (self, ts);
+  frame = g_array_index (tf->frames, GstElementFrame, tf->frames->len - 1);
+  g_array_set_size (tf->frames, tf->frames->len - 1);
+
+  total = now > frame.start ? now - frame.start : 0;
+
+  if (tf->frames->len > 0) {
+    g_array_index (tf->frames, GstElementFrame,
+        tf->frames->len - 1).child_time += total;
+  } else {
+    tf->root = get_pad_element (pad);
+    tf->root_end = now;
+  }
+
+  if (frame.element)
+    add_element_time (self, frame.element,
+        total - MIN (frame.child_time, total), ts);
+}
+
+static void
+do_push_buffer_pre (GstRUsageTracer * self, GstClockTime ts, GstPad * pad,
+    GstBuffer * buffer)
+{
+  element_time_pre (self, ts, pad, get_pad_element (GST_PAD_PEER (pad)));
+}
+
+static void
+do_push_buffer_post (GstRUsageTracer * self, GstClockTime ts, GstPad * pad,
+    GstFlowReturn res)
+{
+  element_time_post (self, ts, pad);
+}
+
+static void
+do_push_buffer_list_pre (GstRUsageTracer * self, GstClockTime ts,
+    GstPad * pad, GstBufferList * list)
+{
+  element_time_pre (self, ts, pad, get_pad_element (GST_PAD_PEER (pad)));
+}
+
+static void
+do_push_buffer_list_post (GstRUsageTracer * self, GstClockTime ts,
+    GstPad * pad, GstFlowReturn res)
+{
+  element_time_post (self, ts, pad);
+}
+
+static void
+do_pull_range_pre (GstRUsageTracer * self, GstClockTime ts, GstPad * pad,
+    guint64 offset, guint size)
+{
+  element_time_pre (self, ts, pad, get_pad_element (GST_PAD_PEER (pad)));
+}
+
+static void
+do_pull_range_post (GstRUsageTracer * self, GstClockTime ts, GstPad * pad,
+    GstBuffer * buffer, GstFlowReturn res)
+{
+  element_time_post (self, ts, pad);
+}
+
+static void
+do_object_destroyed (GstRUsageTracer * self, GstClockTime ts,
+    GstObject * object)
+{
+  if (GST_IS_ELEMENT (object)) {
+    G_LOCK (_elements);
+    g_hash_table_remove (self->element_stats, object);
+    G_UNLOCK (_elements);
+  } else if (GST_IS_BUS (object)) {
+    G_LOCK (_elements);
+    g_hash_table_remove (self->reports, object);
+    G_UNLOCK (_elements);
+  }
+}
+
 /* tracer class */
 
 static void
@@ -268,6 +624,8 @@ gst_rusage_tracer_constructed (GObject * object)
   gchar *params, *tmp;
   const gchar *name;
   GstStructure *params_struct = NULL;
+  GstTracer *tracer = GST_TRACER (self);
+  guint interval;
 
   g_object_get (self, "params", &params, NULL);
 
@@ -285,7 +643,31 @@ gst_rusage_tracer_constructed (GObject * object)
   name = gst_structure_get_string (params_struct, "name");
   if (name)
     gst_object_set_name (GST_OBJECT (self), name);
+
+  gst_structure_get_boolean (params_struct, "elements", &self->elements);
+  gst_structure_get_boolean (params_struct, "thread-cputime",
+      &self->thread_cputime);
+  if (gst_structure_get_uint (params_struct, "interval", &interval))
+    self->interval = MAX (interval, 1) * GST_MSECOND;
+  gst_structure_get_uint (params_struct, "top", &self->top);
   gst_structure_free (params_struct);
+
+  if (self->elements) {
+    gst_tracing_register_hook (tracer, "pad-push-pre",
+        G_CALLBACK (do_push_buffer_pre));
+    gst_tracing_register_hook (tracer, "pad-push-post",
+        G_CALLBACK (do_push_buffer_post));
+    gst_tracing_register_hook (tracer, "pad-push-list-pre",
+        G_CALLBACK (do_push_buffer_list_pre));
+    gst_tracing_register_hook (tracer, "pad-push-list-post",
+        G_CALLBACK (do_push_buffer_list_post));
+    gst_tracing_register_hook (tracer, "pad-pull-range-pre",
+        G_CALLBACK (do_pull_range_pre));
+    gst_tracing_register_hook (tracer, "pad-pull-range-post",
+        G_CALLBACK (do_pull_range_post));
+    gst_tracing_register_hook (tracer, "object-destroyed",
+        G_CALLBACK (do_object_destroyed));
+  }
 }
 
 static void
@@ -294,6 +676,8 @@ gst_rusage_tracer_finalize (GObject * obj)
   GstRUsageTracer *self = GST_RUSAGE_TRACER (obj);
 
   free_trace_values (self->tvs_proc);
+  g_hash_table_unref (self->element_stats);
+  g_hash_table_unref (self->reports);
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -346,6 +730,12 @@ gst_rusage_tracer_class_init (GstRUsageTracerClass * klass)
           "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
           "max", G_TYPE_UINT64, G_MAXUINT64,
           NULL),
+      "cpu", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_INT,
+          "description", G_TYPE_STRING, "cpu the thread is running on, -1 if unknown",
+          "min", G_TYPE_INT, -1,
+          "max", G_TYPE_INT, G_MAXINT,
+          NULL),
       NULL);
   tr_proc = gst_tracer_record_new ("proc-rusage.class",
       "process-id", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
@@ -377,10 +767,33 @@ gst_rusage_tracer_class_init (GstRUsageTracerClass * klass)
           "max", G_TYPE_UINT64, G_MAXUINT64,
           NULL),
       NULL);
+  tr_element = gst_tracer_record_new ("element-rusage.class",
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "event ts",
+          NULL),
+      "element", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "name of the element",
+          NULL),
+      "time", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "time spent in element during the interval in ns",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      "cpuload", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT,
+          "description", G_TYPE_STRING, "share of the interval spent in element in ‰",
+          "min", G_TYPE_UINT, 0,
+          "max", G_TYPE_UINT, 1000,
+          NULL),
+      NULL);
   /* *INDENT-ON* */
 
   GST_OBJECT_FLAG_SET (tr_thread, GST_OBJECT_FLAG_MAY_BE_LEAKED);
   GST_OBJECT_FLAG_SET (tr_proc, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  GST_OBJECT_FLAG_SET (tr_element, GST_OBJECT_FLAG_MAY_BE_LEAKED);
 }
 
 static void
@@ -406,5 +819,11 @@ gst_rusage_tracer_init (GstRUsageTracer * self)
   self->tvs_proc = make_trace_values (GST_SECOND);
   self->main_thread_id = g_thread_self ();
 
+  self->interval = DEFAULT_INTERVAL;
+  self->top = DEFAULT_TOP;
+  self->element_stats = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) free_element_rusage);
+  self->reports = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+
   GST_DEBUG ("rusage: main thread=%p", self->main_thread_id);
 }
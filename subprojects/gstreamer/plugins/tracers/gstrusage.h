@@ -68,6 +68,16 @@ struct _GstRUsageTracer {
   /* for ts calibration */
   gpointer main_thread_id;
   guint64 tproc_base;
+
+  /* per element accounting, see the elements param */
+  gboolean elements;
+  gboolean thread_cputime;
+  GstClockTime interval;
+  guint top;
+  /* GstElement -> GstElementRUsage and GstBus -> GstRUsageReport, both
+   * protected by the _elements lock */
+  GHashTable *element_stats;
+  GHashTable *reports;
 };
 
 struct _GstRUsageTracerClass {
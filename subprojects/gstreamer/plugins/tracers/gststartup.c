@@ -0,0 +1,419 @@
+/* GStreamer
+ *
+ * gststartup.c: tracing module that logs pipeline startup phases
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-startup
+ * @short_description: log the startup phases of pipelines
+ *
+ * A tracing module that measures how long a pipeline takes to start. The
+ * clock starts when a top-level bin begins its READY to PAUSED transition
+ * and every record carries the time elapsed since then.
+ *
+ * The following phases are logged:
+ *
+ * * `start`: the top-level bin starts going to PAUSED.
+ * * `added`: an element was added to a bin of the pipeline.
+ * * `ready`, `paused`: an element reached READY or PAUSED.
+ * * `first-buffer`: the first buffer left a source pad of an element.
+ * * `sink-first-buffer`: the first buffer reached a sink element.
+ * * `prerolled`: the pipeline posted ASYNC_DONE.
+ * * `playing`: the pipeline reached PLAYING.
+ *
+ * Tracking stops when the pipeline goes back to READY.
+ *
+ * ```
+ * $ GST_TRACERS=startup GST_DEBUG=GST_TRACER:7 gst-play-1.0 file.mkv
+ * ```
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gststartup.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_startup_debug);
+#define GST_CAT_DEFAULT gst_startup_debug
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_startup_debug, "startup", 0, "startup tracer");
+#define gst_startup_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstStartupTracer, gst_startup_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+static GstTracerRecord *tr_startup;
+
+static GQuark startup_data_quark;
+static GQuark startup_pad_quark;
+
+static gint startup_generation = 0;
+
+typedef struct
+{
+  GstStartupTracer *tracer;
+  GstClockTime start;
+  guint generation;
+} StartupData;
+
+static void
+startup_data_free (StartupData * data)
+{
+  g_atomic_int_add (&data->tracer->active, -1);
+  g_free (data);
+}
+
+/* returns the top-level element @element belongs to, with a ref */
+static GstElement *
+get_toplevel (GstElement * element)
+{
+  GstObject *obj, *parent;
+
+  obj = gst_object_ref (element);
+  while ((parent = gst_object_get_parent (obj))) {
+    gst_object_unref (obj);
+    obj = parent;
+  }
+  return GST_ELEMENT_CAST (obj);
+}
+
+static gboolean
+get_startup_data (GstStartupTracer * self, GstElement * toplevel,
+    GstClockTime * start, guint * generation)
+{
+  StartupData *data;
+  gboolean ret = FALSE;
+
+  g_mutex_lock (&self->lock);
+  data = g_object_get_qdata (G_OBJECT (toplevel), startup_data_quark);
+  if (data) {
+    *start = data->start;
+    *generation = data->generation;
+    ret = TRUE;
+  }
+  g_mutex_unlock (&self->lock);
+
+  return ret;
+}
+
+static void
+log_phase (GstClockTime ts, GstElement * toplevel, GstClockTime start,
+    const gchar * phase, GstElement * element, GstPad * pad)
+{
+  gchar *pipeline_name, *element_name = NULL, *pad_name = NULL;
+
+  pipeline_name = gst_object_get_name (GST_OBJECT_CAST (toplevel));
+  if (element)
+    element_name = gst_object_get_name (GST_OBJECT_CAST (element));
+  if (pad)
+    pad_name = gst_object_get_name (GST_OBJECT_CAST (pad));
+
+  gst_tracer_record_log (tr_startup, (guint64) (guintptr) g_thread_self (),
+      ts, pipeline_name, phase, element_name ? element_name : "",
+      pad_name ? pad_name : "", (guint64) (ts > start ? ts - start : 0));
+
+  g_free (pipeline_name);
+  g_free (element_name);
+  g_free (pad_name);
+}
+
+/* logs @phase for @element if the pipeline it is in is starting up */
+static void
+log_element_phase (GstStartupTracer * self, GstClockTime ts,
+    GstElement * element, const gchar * phase)
+{
+  GstElement *toplevel;
+  GstClockTime start;
+  guint generation;
+
+  toplevel = get_toplevel (element);
+  if (toplevel != element &&
+      get_startup_data (self, toplevel, &start, &generation))
+    log_phase (ts, toplevel, start, phase, element, NULL);
+  gst_object_unref (toplevel);
+}
+
+/* follows ghost pads down to the pad of the element handling the data */
+static GstPad *
+get_real_peer (GstPad * pad)
+{
+  GstPad *peer, *target;
+
+  peer = gst_pad_get_peer (pad);
+  while (peer && GST_IS_GHOST_PAD (peer)) {
+    target = gst_ghost_pad_get_target (GST_GHOST_PAD_CAST (peer));
+    gst_object_unref (peer);
+    peer = target;
+  }
+  return peer;
+}
+
+static void
+do_first_buffer (GstStartupTracer * self, GstClockTime ts, GstPad * pad)
+{
+  GstElement *parent, *toplevel;
+  GstClockTime start;
+  guint generation;
+  GstPad *peer;
+  GstElement *sink;
+
+  if (!g_atomic_int_get (&self->active))
+    return;
+
+  /* proxy pads have a ghost pad as parent and return NULL here, ghost pads
+   * are reported through the element pad behind them */
+  parent = gst_pad_get_parent_element (pad);
+  if (!parent)
+    return;
+  if (GST_IS_BIN (parent))
+    goto done;
+
+  toplevel = get_toplevel (parent);
+  if (!get_startup_data (self, toplevel, &start, &generation))
+    goto done_toplevel;
+
+  if (GPOINTER_TO_UINT (g_object_get_qdata (G_OBJECT (pad),
+              startup_pad_quark)) == generation)
+    goto done_toplevel;
+  g_object_set_qdata (G_OBJECT (pad), startup_pad_quark,
+      GUINT_TO_POINTER (generation));
+
+  log_phase (ts, toplevel, start, "first-buffer", parent, pad);
+
+  peer = get_real_peer (pad);
+  if (peer) {
+    sink = gst_pad_get_parent_element (peer);
+    if (sink) {
+      if (GST_OBJECT_FLAG_IS_SET (sink, GST_ELEMENT_FLAG_SINK))
+        log_phase (ts, toplevel, start, "sink-first-buffer", sink, peer);
+      gst_object_unref (sink);
+    }
+    gst_object_unref (peer);
+  }
+
+done_toplevel:
+  gst_object_unref (toplevel);
+done:
+  gst_object_unref (parent);
+}
+
+static void
+do_push_buffer_pre (GstStartupTracer * self, GstClockTime ts, GstPad * pad,
+    GstBuffer * buffer)
+{
+  do_first_buffer (self, ts, pad);
+}
+
+static void
+do_push_buffer_list_pre (GstStartupTracer * self, GstClockTime ts,
+    GstPad * pad, GstBufferList * list)
+{
+  do_first_buffer (self, ts, pad);
+}
+
+static void
+do_bin_add_post (GstStartupTracer * self, GstClockTime ts, GstBin * bin,
+    GstElement * element, gboolean result)
+{
+  if (!result || !g_atomic_int_get (&self->active))
+    return;
+
+  log_element_phase (self, ts, element, "added");
+}
+
+static void
+do_element_change_state_pre (GstStartupTracer * self, GstClockTime ts,
+    GstElement * element, GstStateChange transition)
+{
+  StartupData *data;
+  GstObject *parent;
+
+  if (!GST_IS_BIN (element))
+    return;
+
+  parent = gst_object_get_parent (GST_OBJECT_CAST (element));
+  if (parent) {
+    gst_object_unref (parent);
+    return;
+  }
+
+  switch (transition) {
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      data = g_new (StartupData, 1);
+      data->tracer = self;
+      data->start = ts;
+      /* 0 is used for pads that were never seen */
+      do {
+        data->generation =
+            (guint) g_atomic_int_add (&startup_generation, 1) + 1;
+      } while (data->generation == 0);
+
+      g_atomic_int_inc (&self->active);
+      g_mutex_lock (&self->lock);
+      g_object_set_qdata_full (G_OBJECT (element), startup_data_quark, data,
+          (GDestroyNotify) startup_data_free);
+      g_mutex_unlock (&self->lock);
+
+      GST_DEBUG_OBJECT (self, "%" GST_PTR_FORMAT " starting up", element);
+      log_phase (ts, element, ts, "start", NULL, NULL);
+      break;
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      g_mutex_lock (&self->lock);
+      g_object_set_qdata (G_OBJECT (element), startup_data_quark, NULL);
+      g_mutex_unlock (&self->lock);
+      break;
+    default:
+      break;
+  }
+}
+
+static void
+do_element_change_state_post (GstStartupTracer * self, GstClockTime ts,
+    GstElement * element, GstStateChange transition,
+    GstStateChangeReturn result)
+{
+  GstElement *toplevel;
+  GstClockTime start;
+  guint generation;
+
+  if (!g_atomic_int_get (&self->active))
+    return;
+
+  if (result == GST_STATE_CHANGE_FAILURE || result == GST_STATE_CHANGE_ASYNC)
+    return;
+
+  switch (transition) {
+    case GST_STATE_CHANGE_NULL_TO_READY:
+      log_element_phase (self, ts, element, "ready");
+      break;
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      log_element_phase (self, ts, element, "paused");
+      break;
+    case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
+      toplevel = get_toplevel (element);
+      if (toplevel == element &&
+          get_startup_data (self, element, &start, &generation))
+        log_phase (ts, element, start, "playing", NULL, NULL);
+      gst_object_unref (toplevel);
+      break;
+    default:
+      break;
+  }
+}
+
+static void
+do_element_post_message_pre (GstStartupTracer * self, GstClockTime ts,
+    GstElement * element, GstMessage * msg)
+{
+  GstElement *toplevel;
+  GstClockTime start;
+  guint generation;
+
+  if (GST_MESSAGE_TYPE (msg) != GST_MESSAGE_ASYNC_DONE ||
+      !g_atomic_int_get (&self->active))
+    return;
+
+  toplevel = get_toplevel (element);
+  if (toplevel == element &&
+      get_startup_data (self, element, &start, &generation))
+    log_phase (ts, element, start, "prerolled", NULL, NULL);
+  gst_object_unref (toplevel);
+}
+
+static void
+gst_startup_tracer_finalize (GObject * object)
+{
+  GstStartupTracer *self = GST_STARTUP_TRACER (object);
+
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_startup_tracer_class_init (GstStartupTracerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->finalize = gst_startup_tracer_finalize;
+
+  startup_data_quark = g_quark_from_static_string ("startup-tracer-data");
+  startup_pad_quark = g_quark_from_static_string ("startup-tracer-pad");
+
+  /* announce trace formats */
+  /* *INDENT-OFF* */
+  tr_startup = gst_tracer_record_new ("startup.class",
+      "thread-id", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_THREAD,
+          NULL),
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "event ts",
+          NULL),
+      "pipeline", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "name of the top-level bin",
+          NULL),
+      "phase", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "startup phase that was reached",
+          NULL),
+      "element", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "name of the element, if any",
+          NULL),
+      "pad", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          "description", G_TYPE_STRING, "name of the pad, if any",
+          NULL),
+      "elapsed", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+              "time since the pipeline started going to PAUSED (in ns)",
+          "min", G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
+          "max", G_TYPE_UINT64, G_MAXUINT64,
+          NULL),
+      NULL);
+  /* *INDENT-ON* */
+
+  GST_OBJECT_FLAG_SET (tr_startup, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+}
+
+static void
+gst_startup_tracer_init (GstStartupTracer * self)
+{
+  GstTracer *tracer = GST_TRACER (self);
+
+  g_mutex_init (&self->lock);
+
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (do_push_buffer_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (do_push_buffer_list_pre));
+  gst_tracing_register_hook (tracer, "bin-add-post",
+      G_CALLBACK (do_bin_add_post));
+  gst_tracing_register_hook (tracer, "element-change-state-pre",
+      G_CALLBACK (do_element_change_state_pre));
+  gst_tracing_register_hook (tracer, "element-change-state-post",
+      G_CALLBACK (do_element_change_state_post));
+  gst_tracing_register_hook (tracer, "element-post-message-pre",
+      G_CALLBACK (do_element_post_message_pre));
+}
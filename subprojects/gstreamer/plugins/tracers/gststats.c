@@ -23,6 +23,26 @@
  * @short_description: log event stats
  *
  * A tracing module that builds usage statistic for elements and pads.
+ *
+ * By default every buffer, event, message and query is logged, which allows
+ * the `gst-stats` tool to build its report offline. For long running or high
+ * rate pipelines the tracer can instead aggregate buffer statistics in
+ * process by passing `aggregate=true`:
+ * ```
+ * GST_TRACERS='stats(aggregate=true,interval=1000)'
+ * ```
+ *
+ * In this mode individual buffers are no longer logged. Instead, per pad
+ * histograms of the time between buffers and of the time spent in
+ * push/pull, and per element histograms of the time spent handling a buffer
+ * are collected. Every `interval` milliseconds (1000 by default, 0 disables
+ * periodic summaries) and when a pad or element is freed, `pad-summary` and
+ * `element-summary` records with the 50th, 99th and 99.9th percentiles are
+ * logged. The same data can be fetched at any time with the
+ * #GstStatsTracer::get-stats action signal.
+ *
+ * The histograms are log-linear with 16 sub-buckets per power of two, so the
+ * reported percentiles are accurate to about 3%.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -39,6 +59,19 @@ GST_DEBUG_CATEGORY_STATIC (gst_stats_debug);
 static GQuark data_quark;
 G_LOCK_DEFINE (_elem_stats);
 G_LOCK_DEFINE (_pad_stats);
+G_LOCK_DEFINE (_agg_stats);
+
+#define DEFAULT_INTERVAL (1000 * GST_MSECOND)
+
+enum
+{
+  /* actions */
+  SIGNAL_GET_STATS,
+
+  LAST_SIGNAL
+};
+
+static guint gst_stats_tracer_signals[LAST_SIGNAL] = { 0 };
 
 #define _do_init \
     GST_DEBUG_CATEGORY_INIT (gst_stats_debug, "stats", 0, "stats tracer"); \
@@ -54,6 +87,44 @@ static GstTracerRecord *tr_element_query;
 static GstTracerRecord *tr_event;
 static GstTracerRecord *tr_message;
 static GstTracerRecord *tr_query;
+static GstTracerRecord *tr_pad_summary;
+static GstTracerRecord *tr_element_summary;
+
+/* log-linear histogram: values below HISTOGRAM_SUB_BUCKETS get their own
+ * bucket, every power of two above that is split in HISTOGRAM_SUB_BUCKETS
+ * linear buckets */
+#define HISTOGRAM_SUB_BUCKET_BITS 4
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_NUM_BUCKETS \
+    ((64 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+typedef struct
+{
+  guint64 count;
+  guint64 buckets[HISTOGRAM_NUM_BUCKETS];
+} GstStatsHistogram;
+
+typedef struct
+{
+  guint64 p50, p99, p999;
+} GstStatsPercentiles;
+
+typedef struct
+{
+  GstStatsTracer *tracer;
+  gchar *name;
+  /* pads only: buffers going through this pad */
+  guint64 num_buffers;
+  guint64 num_bytes;
+  GstClockTime first_ts;
+  GstClockTime last_ts;
+  /* pads only: start of the current push/pull */
+  GstClockTime start_ts;
+  /* pads only: time between two buffers */
+  GstStatsHistogram interval;
+  /* pads: time spent in push/pull, elements: time spent handling a buffer */
+  GstStatsHistogram time;
+} GstStatsAggregate;
 
 typedef struct
 {
@@ -63,6 +134,8 @@ typedef struct
   GstClockTime last_ts;
   /* hierarchy */
   guint parent_ix;
+  /* only with aggregate=true */
+  GstStatsAggregate *agg;
 } GstPadStats;
 
 typedef struct
@@ -75,8 +148,275 @@ typedef struct
   GstClockTime treal;
   /* hierarchy */
   guint parent_ix;
+  /* only with aggregate=true */
+  GstStatsAggregate *agg;
 } GstElementStats;
 
+/* histogram helper */
+
+static inline guint
+histogram_msb (guint64 value)
+{
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll (value);
+#else
+  guint msb = 0;
+
+  while (value >>= 1)
+    msb++;
+  return msb;
+#endif
+}
+
+/* 64 bit counters, so that they don't wrap on long runs */
+#ifdef __GCC_HAVE_SYNC_COMPARE_AND_SWAP_8
+static inline void
+histogram_counter_inc (guint64 * counter)
+{
+  __atomic_fetch_add (counter, 1, __ATOMIC_RELAXED);
+}
+
+static inline guint64
+histogram_counter_get (guint64 * counter)
+{
+  return __atomic_load_n (counter, __ATOMIC_RELAXED);
+}
+#else
+G_LOCK_DEFINE_STATIC (histogram);
+
+static inline void
+histogram_counter_inc (guint64 * counter)
+{
+  G_LOCK (histogram);
+  (*counter)++;
+  G_UNLOCK (histogram);
+}
+
+static inline guint64
+histogram_counter_get (guint64 * counter)
+{
+  guint64 value;
+
+  G_LOCK (histogram);
+  value = *counter;
+  G_UNLOCK (histogram);
+
+  return value;
+}
+#endif
+
+static inline void
+histogram_record (GstStatsHistogram * hist, GstClockTimeDiff diff)
+{
+  guint64 value = MAX (diff, 0);
+  guint ix;
+
+  if (value < HISTOGRAM_SUB_BUCKETS) {
+    ix = value;
+  } else {
+    guint shift = histogram_msb (value) - HISTOGRAM_SUB_BUCKET_BITS;
+
+    ix = (shift + 1) * HISTOGRAM_SUB_BUCKETS +
+        ((value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1));
+  }
+
+  /* elements can be fed from several streaming threads at once */
+  histogram_counter_inc (&hist->buckets[ix]);
+  histogram_counter_inc (&hist->count);
+}
+
+/* returns the middle of the value range covered by bucket @ix */
+static guint64
+histogram_bucket_value (guint ix)
+{
+  guint shift;
+
+  if (ix < HISTOGRAM_SUB_BUCKETS)
+    return ix;
+
+  shift = ix / HISTOGRAM_SUB_BUCKETS - 1;
+  return ((guint64) (HISTOGRAM_SUB_BUCKETS + ix % HISTOGRAM_SUB_BUCKETS) <<
+      shift) + ((G_GUINT64_CONSTANT (1) << shift) >> 1);
+}
+
+static void
+histogram_get_percentiles (GstStatsHistogram * hist, GstStatsPercentiles * p)
+{
+  guint64 count = histogram_counter_get (&hist->count);
+  guint64 n50, n99, n999, seen = 0;
+  guint ix;
+
+  p->p50 = p->p99 = p->p999 = 0;
+  if (!count)
+    return;
+
+  /* the rank of each percentile, ceil (count * p), written so that it can't
+   * overflow */
+  n50 = count - count / 2;
+  n99 = count - count / 100;
+  n999 = count - count / 1000;
+
+  for (ix = 0; ix < HISTOGRAM_NUM_BUCKETS; ix++) {
+    guint64 n = histogram_counter_get (&hist->buckets[ix]);
+
+    if (!n)
+      continue;
+    seen += n;
+    if (!p->p50 && seen >= n50)
+      p->p50 = histogram_bucket_value (ix);
+    if (!p->p99 && seen >= n99)
+      p->p99 = histogram_bucket_value (ix);
+    if (seen >= n999) {
+      p->p999 = histogram_bucket_value (ix);
+      break;
+    }
+  }
+}
+
+/* aggregation helper */
+
+static GstStatsAggregate *
+new_aggregate_stats (GstStatsTracer * self, const gchar * name)
+{
+  GstStatsAggregate *agg = g_new0 (GstStatsAggregate, 1);
+
+  agg->tracer = self;
+  agg->name = g_strdup (name);
+  agg->first_ts = agg->last_ts = agg->start_ts = GST_CLOCK_TIME_NONE;
+  return agg;
+}
+
+static void
+free_aggregate_stats (GstStatsAggregate * agg)
+{
+  g_free (agg->name);
+  g_free (agg);
+}
+
+static gdouble
+get_buffer_rate (GstStatsAggregate * agg)
+{
+  GstClockTime duration;
+
+  if (agg->num_buffers < 2)
+    return 0.0;
+
+  duration = agg->last_ts - agg->first_ts;
+  if (duration == 0)
+    return 0.0;
+
+  return (gdouble) (agg->num_buffers - 1) * GST_SECOND / duration;
+}
+
+static void
+log_pad_summary (GstPadStats * stats, GstClockTime ts)
+{
+  GstStatsAggregate *agg = stats->agg;
+  GstStatsPercentiles interval, time;
+
+  if (!agg->num_buffers && !histogram_counter_get (&agg->time.count))
+    return;
+
+  histogram_get_percentiles (&agg->interval, &interval);
+  histogram_get_percentiles (&agg->time, &time);
+  gst_tracer_record_log (tr_pad_summary, ts, stats->index, stats->parent_ix,
+      agg->num_buffers, agg->num_bytes, get_buffer_rate (agg), interval.p50,
+      interval.p99, interval.p999, time.p50, time.p99, time.p999);
+}
+
+static void
+log_element_summary (GstElementStats * stats, GstClockTime ts)
+{
+  GstStatsAggregate *agg = stats->agg;
+  GstStatsPercentiles time;
+
+  if (!histogram_counter_get (&agg->time.count))
+    return;
+
+  histogram_get_percentiles (&agg->time, &time);
+  gst_tracer_record_log (tr_element_summary, ts, stats->index,
+      stats->parent_ix, histogram_counter_get (&agg->time.count),
+      time.p50, time.p99, time.p999);
+}
+
+static GstStructure *
+get_pad_summary (GstPadStats * stats)
+{
+  GstStatsAggregate *agg = stats->agg;
+  GstStatsPercentiles interval, time;
+
+  histogram_get_percentiles (&agg->interval, &interval);
+  histogram_get_percentiles (&agg->time, &time);
+  return gst_structure_new ("pad-stats",
+      "pad-ix", G_TYPE_UINT, stats->index,
+      "element-ix", G_TYPE_UINT, stats->parent_ix,
+      "name", G_TYPE_STRING, agg->name,
+      "num-buffers", G_TYPE_UINT64, agg->num_buffers,
+      "num-bytes", G_TYPE_UINT64, agg->num_bytes,
+      "buffer-rate", G_TYPE_DOUBLE, get_buffer_rate (agg),
+      "interval-p50", G_TYPE_UINT64, interval.p50,
+      "interval-p99", G_TYPE_UINT64, interval.p99,
+      "interval-p999", G_TYPE_UINT64, interval.p999,
+      "time-p50", G_TYPE_UINT64, time.p50,
+      "time-p99", G_TYPE_UINT64, time.p99,
+      "time-p999", G_TYPE_UINT64, time.p999, NULL);
+}
+
+static GstStructure *
+get_element_summary (GstElementStats * stats)
+{
+  GstStatsAggregate *agg = stats->agg;
+  GstStatsPercentiles time;
+
+  histogram_get_percentiles (&agg->time, &time);
+  return gst_structure_new ("element-stats",
+      "element-ix", G_TYPE_UINT, stats->index,
+      "parent-ix", G_TYPE_UINT, stats->parent_ix,
+      "name", G_TYPE_STRING, agg->name,
+      "num-buffers", G_TYPE_UINT64,
+      histogram_counter_get (&agg->time.count),
+      "time-p50", G_TYPE_UINT64, time.p50,
+      "time-p99", G_TYPE_UINT64, time.p99,
+      "time-p999", G_TYPE_UINT64, time.p999, NULL);
+}
+
+static void
+log_summaries (GstStatsTracer * self, GstClockTime ts)
+{
+  guint i;
+
+  G_LOCK (_agg_stats);
+  for (i = 0; i < self->agg_elements->len; i++)
+    log_element_summary (g_ptr_array_index (self->agg_elements, i), ts);
+  for (i = 0; i < self->agg_pads->len; i++)
+    log_pad_summary (g_ptr_array_index (self->agg_pads, i), ts);
+  G_UNLOCK (_agg_stats);
+}
+
+static inline void
+maybe_log_summaries (GstStatsTracer * self, GstClockTime ts)
+{
+  GstClockTime next;
+
+  if (G_LIKELY (!self->interval))
+    return;
+
+  next = self->next_summary_ts;
+  if (G_LIKELY (ts < next))
+    return;
+
+  /* only one of the streaming threads gets to log the summary */
+  G_LOCK (_agg_stats);
+  if (self->next_summary_ts != next) {
+    G_UNLOCK (_agg_stats);
+    return;
+  }
+  self->next_summary_ts = ts + self->interval;
+  G_UNLOCK (_agg_stats);
+
+  log_summaries (self, ts);
+}
+
 /* data helper */
 
 static GstElementStats no_elem_stats = { 0, };
@@ -88,6 +428,12 @@ fill_element_stats (GstStatsTracer * self, GstElement * element)
 
   stats->index = self->num_elements++;
   stats->parent_ix = G_MAXUINT;
+  if (self->aggregate) {
+    stats->agg = new_aggregate_stats (self, GST_OBJECT_NAME (element));
+    G_LOCK (_agg_stats);
+    g_ptr_array_add (self->agg_elements, stats);
+    G_UNLOCK (_agg_stats);
+  }
   return stats;
 }
 
@@ -103,7 +449,20 @@ log_new_element_stats (GstElementStats * stats, GstElement * element,
 static void
 free_element_stats (gpointer data)
 {
-  g_slice_free (GstElementStats, data);
+  GstElementStats *stats = data;
+
+  if (stats->agg) {
+    GstStatsAggregate *agg = stats->agg;
+
+    G_LOCK (_agg_stats);
+    if (agg->tracer) {
+      log_element_summary (stats, agg->last_ts);
+      g_ptr_array_remove_fast (agg->tracer->agg_elements, stats);
+    }
+    G_UNLOCK (_agg_stats);
+    free_aggregate_stats (agg);
+  }
+  g_slice_free (GstElementStats, stats);
 }
 
 static GstElementStats *
@@ -190,6 +549,12 @@ fill_pad_stats (GstStatsTracer * self, GstPad * pad)
 
   stats->index = self->num_pads++;
   stats->parent_ix = G_MAXUINT;
+  if (self->aggregate) {
+    stats->agg = new_aggregate_stats (self, GST_OBJECT_NAME (pad));
+    G_LOCK (_agg_stats);
+    g_ptr_array_add (self->agg_pads, stats);
+    G_UNLOCK (_agg_stats);
+  }
 
   return stats;
 }
@@ -206,7 +571,20 @@ log_new_pad_stats (GstPadStats * stats, GstPad * pad)
 static void
 free_pad_stats (gpointer data)
 {
-  g_slice_free (GstPadStats, data);
+  GstPadStats *stats = data;
+
+  if (stats->agg) {
+    GstStatsAggregate *agg = stats->agg;
+
+    G_LOCK (_agg_stats);
+    if (agg->tracer) {
+      log_pad_summary (stats, agg->last_ts);
+      g_ptr_array_remove_fast (agg->tracer->agg_pads, stats);
+    }
+    G_UNLOCK (_agg_stats);
+    free_aggregate_stats (agg);
+  }
+  g_slice_free (GstPadStats, stats);
 }
 
 static GstPadStats *
@@ -242,18 +620,47 @@ get_pad_stats (GstStatsTracer * self, GstPad * pad)
   return stats;
 }
 
+static void
+do_aggregate_buffer_stats (GstStatsTracer * self, GstPadStats * stats,
+    GstBuffer * buf, GstClockTime ts)
+{
+  GstStatsAggregate *agg = stats->agg;
+
+  if (!agg)
+    return;
+
+  if (agg->num_buffers)
+    histogram_record (&agg->interval, GST_CLOCK_DIFF (agg->last_ts, ts));
+  else
+    agg->first_ts = ts;
+  agg->last_ts = ts;
+  agg->num_buffers++;
+  agg->num_bytes += gst_buffer_get_size (buf);
+}
+
 static void
 do_buffer_stats (GstStatsTracer * self, GstPad * this_pad,
     GstPadStats * this_pad_stats, GstPad * that_pad,
     GstPadStats * that_pad_stats, GstBuffer * buf, GstClockTime elapsed)
 {
-  GstElement *this_elem = get_real_pad_parent (this_pad);
-  GstElementStats *this_elem_stats = get_element_stats (self, this_elem);
-  GstElement *that_elem = get_real_pad_parent (that_pad);
-  GstElementStats *that_elem_stats = get_element_stats (self, that_elem);
-  GstClockTime pts = GST_BUFFER_PTS (buf);
-  GstClockTime dts = GST_BUFFER_DTS (buf);
-  GstClockTime dur = GST_BUFFER_DURATION (buf);
+  GstElement *this_elem;
+  GstElementStats *this_elem_stats;
+  GstElement *that_elem;
+  GstElementStats *that_elem_stats;
+  GstClockTime pts, dts, dur;
+
+  if (self->aggregate) {
+    do_aggregate_buffer_stats (self, this_pad_stats, buf, elapsed);
+    return;
+  }
+
+  this_elem = get_real_pad_parent (this_pad);
+  this_elem_stats = get_element_stats (self, this_elem);
+  that_elem = get_real_pad_parent (that_pad);
+  that_elem_stats = get_element_stats (self, that_elem);
+  pts = GST_BUFFER_PTS (buf);
+  dts = GST_BUFFER_DTS (buf);
+  dur = GST_BUFFER_DURATION (buf);
 
   gst_tracer_record_log (tr_buffer, (guint64) (guintptr) g_thread_self (),
       elapsed, this_pad_stats->index, this_elem_stats->index,
@@ -279,7 +686,7 @@ do_query_stats (GstStatsTracer * self, GstPad * this_pad,
       gst_query_get_structure (qry), have_res, res);
 }
 
-static void
+static GstElementStats *
 do_element_stats (GstStatsTracer * self, GstPad * pad, GstClockTime elapsed1,
     GstClockTime elapsed2)
 {
@@ -293,7 +700,7 @@ do_element_stats (GstStatsTracer * self, GstPad * pad, GstClockTime elapsed1,
   GstElementStats *peer_stats;
 
   if (!peer_pad)
-    return;
+    return NULL;
 
   /* walk the ghost pad chain downstream to get the real pad */
   /* if parent of peer_pad is a ghost-pad, then peer_pad is a proxy_pad */
@@ -323,7 +730,7 @@ do_element_stats (GstStatsTracer * self, GstPad * pad, GstClockTime elapsed1,
         " transmission on unparented target pad %s_%s -> %s_%s\n",
         GST_TIME_ARGS (elapsed), GST_DEBUG_PAD_NAME (pad),
         GST_DEBUG_PAD_NAME (peer_pad));
-    return;
+    return NULL;
   }
   peer_stats = get_element_stats (self, GST_ELEMENT_CAST (parent));
 
@@ -352,6 +759,31 @@ do_element_stats (GstStatsTracer * self, GstPad * pad, GstClockTime elapsed1,
   this_stats->last_ts = elapsed2;
   peer_stats->last_ts = elapsed2;
 #endif
+  return peer_stats;
+}
+
+static void
+do_aggregate_element_stats (GstStatsTracer * self, GstPadStats * pad_stats,
+    GstElementStats * peer_stats, GstClockTime ts)
+{
+  GstStatsAggregate *agg = pad_stats->agg;
+  GstClockTimeDiff elapsed;
+
+  if (!agg || !GST_CLOCK_TIME_IS_VALID (agg->start_ts))
+    return;
+
+  elapsed = GST_CLOCK_DIFF (agg->start_ts, ts);
+  agg->start_ts = GST_CLOCK_TIME_NONE;
+
+  histogram_record (&agg->time, elapsed);
+  /* the time spent in push/pull is accounted to the peer element, the same
+   * way treal is */
+  if (peer_stats && peer_stats->agg) {
+    histogram_record (&peer_stats->agg->time, elapsed);
+    peer_stats->agg->last_ts = ts;
+  }
+
+  maybe_log_summaries (self, ts);
 }
 
 /* hooks */
@@ -364,6 +796,8 @@ do_push_buffer_pre (GstStatsTracer * self, guint64 ts, GstPad * this_pad,
   GstPad *that_pad = GST_PAD_PEER (this_pad);
   GstPadStats *that_pad_stats = get_pad_stats (self, that_pad);
 
+  if (this_pad_stats->agg)
+    this_pad_stats->agg->start_ts = ts;
   do_buffer_stats (self, this_pad, this_pad_stats, that_pad, that_pad_stats,
       buffer, ts);
 }
@@ -373,8 +807,11 @@ do_push_buffer_post (GstStatsTracer * self, guint64 ts, GstPad * pad,
     GstFlowReturn res)
 {
   GstPadStats *stats = get_pad_stats (self, pad);
+  GstElementStats *peer_stats;
 
-  do_element_stats (self, pad, stats->last_ts, ts);
+  peer_stats = do_element_stats (self, pad, stats->last_ts, ts);
+  if (self->aggregate)
+    do_aggregate_element_stats (self, stats, peer_stats, ts);
 }
 
 typedef struct
@@ -408,6 +845,8 @@ do_push_buffer_list_pre (GstStatsTracer * self, guint64 ts, GstPad * this_pad,
     that_pad_stats, ts
   };
 
+  if (this_pad_stats->agg)
+    this_pad_stats->agg->start_ts = ts;
   gst_buffer_list_foreach (list, do_push_buffer_list_item, &args);
 }
 
@@ -416,8 +855,11 @@ do_push_buffer_list_post (GstStatsTracer * self, guint64 ts, GstPad * pad,
     GstFlowReturn res)
 {
   GstPadStats *stats = get_pad_stats (self, pad);
+  GstElementStats *peer_stats;
 
-  do_element_stats (self, pad, stats->last_ts, ts);
+  peer_stats = do_element_stats (self, pad, stats->last_ts, ts);
+  if (self->aggregate)
+    do_aggregate_element_stats (self, stats, peer_stats, ts);
 }
 
 static void
@@ -425,6 +867,8 @@ do_pull_range_pre (GstStatsTracer * self, guint64 ts, GstPad * pad)
 {
   GstPadStats *stats = get_pad_stats (self, pad);
   stats->last_ts = ts;
+  if (stats->agg)
+    stats->agg->start_ts = ts;
 }
 
 static void
@@ -435,12 +879,15 @@ do_pull_range_post (GstStatsTracer * self, guint64 ts, GstPad * this_pad,
   guint64 last_ts = this_pad_stats->last_ts;
   GstPad *that_pad = GST_PAD_PEER (this_pad);
   GstPadStats *that_pad_stats = get_pad_stats (self, that_pad);
+  GstElementStats *peer_stats;
 
   if (buffer != NULL) {
     do_buffer_stats (self, this_pad, this_pad_stats, that_pad, that_pad_stats,
         buffer, ts);
   }
-  do_element_stats (self, this_pad, last_ts, ts);
+  peer_stats = do_element_stats (self, this_pad, last_ts, ts);
+  if (self->aggregate)
+    do_aggregate_element_stats (self, this_pad_stats, peer_stats, ts);
 }
 
 static void
@@ -520,12 +967,52 @@ do_query_post (GstStatsTracer * self, guint64 ts, GstPad * this_pad,
 
 /* tracer class */
 
+static GstStructure *
+gst_stats_tracer_get_stats (GstStatsTracer * self)
+{
+  GstStructure *info;
+  GValue pads = G_VALUE_INIT;
+  GValue elements = G_VALUE_INIT;
+  guint i;
+
+  g_value_init (&pads, GST_TYPE_LIST);
+  g_value_init (&elements, GST_TYPE_LIST);
+
+  if (self->aggregate) {
+    G_LOCK (_agg_stats);
+    for (i = 0; i < self->agg_elements->len; i++) {
+      GValue s_value = G_VALUE_INIT;
+
+      g_value_init (&s_value, GST_TYPE_STRUCTURE);
+      g_value_take_boxed (&s_value,
+          get_element_summary (g_ptr_array_index (self->agg_elements, i)));
+      gst_value_list_append_and_take_value (&elements, &s_value);
+    }
+    for (i = 0; i < self->agg_pads->len; i++) {
+      GValue s_value = G_VALUE_INIT;
+
+      g_value_init (&s_value, GST_TYPE_STRUCTURE);
+      g_value_take_boxed (&s_value,
+          get_pad_summary (g_ptr_array_index (self->agg_pads, i)));
+      gst_value_list_append_and_take_value (&pads, &s_value);
+    }
+    G_UNLOCK (_agg_stats);
+  }
+
+  info = gst_structure_new_empty ("stats");
+  gst_structure_take_value (info, "elements", &elements);
+  gst_structure_take_value (info, "pads", &pads);
+
+  return info;
+}
+
 static void
 gst_stats_tracer_constructed (GObject * object)
 {
   GstStatsTracer *self = GST_STATS_TRACER (object);
   gchar *params, *tmp;
   const gchar *name;
+  gint interval;
   GstStructure *params_struct = NULL;
 
   g_object_get (self, "params", &params, NULL);
@@ -543,15 +1030,53 @@ gst_stats_tracer_constructed (GObject * object)
   name = gst_structure_get_string (params_struct, "name");
   if (name)
     gst_object_set_name (GST_OBJECT (self), name);
+
+  gst_structure_get_boolean (params_struct, "aggregate", &self->aggregate);
+  if (gst_structure_get_int (params_struct, "interval", &interval))
+    self->interval = MAX (interval, 0) * GST_MSECOND;
+  self->next_summary_ts = self->interval;
+
   gst_structure_free (params_struct);
 }
 
+static void
+gst_stats_tracer_finalize (GObject * object)
+{
+  GstStatsTracer *self = GST_STATS_TRACER (object);
+  guint i;
+
+  /* objects that are still alive keep their stats, but must not refer to us
+   * anymore */
+  G_LOCK (_agg_stats);
+  for (i = 0; i < self->agg_elements->len; i++) {
+    GstElementStats *stats = g_ptr_array_index (self->agg_elements, i);
+
+    log_element_summary (stats, stats->agg->last_ts);
+    stats->agg->tracer = NULL;
+  }
+  for (i = 0; i < self->agg_pads->len; i++) {
+    GstPadStats *stats = g_ptr_array_index (self->agg_pads, i);
+
+    log_pad_summary (stats, stats->agg->last_ts);
+    stats->agg->tracer = NULL;
+  }
+  G_UNLOCK (_agg_stats);
+
+  g_ptr_array_unref (self->agg_elements);
+  g_ptr_array_unref (self->agg_pads);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 static void
 gst_stats_tracer_class_init (GstStatsTracerClass * klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   gobject_class->constructed = gst_stats_tracer_constructed;
+  gobject_class->finalize = gst_stats_tracer_finalize;
+
+  klass->get_stats = gst_stats_tracer_get_stats;
 
   /* announce trace formats */
   /* *INDENT-OFF* */
@@ -773,6 +1298,86 @@ gst_stats_tracer_class_init (GstStatsTracerClass * klass)
           "description", G_TYPE_STRING, "ipad direction",
           NULL),
       NULL);
+  tr_pad_summary = gst_tracer_record_new ("pad-summary.class",
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "summary ts",
+          NULL),
+      "pad-ix", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_PAD,
+          NULL),
+      "element-ix", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_ELEMENT,
+          NULL),
+      "num-buffers", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of buffers",
+          NULL),
+      "num-bytes", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of bytes",
+          NULL),
+      "buffer-rate", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_DOUBLE,
+          "description", G_TYPE_STRING, "average buffers per second",
+          NULL),
+      "interval-p50", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "median time between buffers in ns",
+          NULL),
+      "interval-p99", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "99th percentile of the time between buffers in ns",
+          NULL),
+      "interval-p999", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "99.9th percentile of the time between buffers in ns",
+          NULL),
+      "time-p50", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "median time spent in push/pull in ns",
+          NULL),
+      "time-p99", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "99th percentile of the time spent in push/pull in ns",
+          NULL),
+      "time-p999", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "99.9th percentile of the time spent in push/pull in ns",
+          NULL),
+      NULL);
+  tr_element_summary = gst_tracer_record_new ("element-summary.class",
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "summary ts",
+          NULL),
+      "element-ix", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_ELEMENT,
+          NULL),
+      "parent-ix", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_ELEMENT,
+          NULL),
+      "num-buffers", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "number of buffers handled",
+          NULL),
+      "time-p50", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "median time spent handling a buffer in ns",
+          NULL),
+      "time-p99", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "99th percentile of the time spent handling a buffer in ns",
+          NULL),
+      "time-p999", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "99.9th percentile of the time spent handling a buffer in ns",
+          NULL),
+      NULL);
   /* *INDENT-ON* */
 
   GST_OBJECT_FLAG_SET (tr_buffer, GST_OBJECT_FLAG_MAY_BE_LEAKED);
@@ -782,6 +1387,36 @@ gst_stats_tracer_class_init (GstStatsTracerClass * klass)
   GST_OBJECT_FLAG_SET (tr_query, GST_OBJECT_FLAG_MAY_BE_LEAKED);
   GST_OBJECT_FLAG_SET (tr_new_element, GST_OBJECT_FLAG_MAY_BE_LEAKED);
   GST_OBJECT_FLAG_SET (tr_new_pad, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  GST_OBJECT_FLAG_SET (tr_pad_summary, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  GST_OBJECT_FLAG_SET (tr_element_summary, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+
+  /**
+   * GstStatsTracer::get-stats:
+   * @statstracer: the stats tracer object to emit this signal on
+   *
+   * Returns a #GstStructure with two fields, `elements` and `pads`, each
+   * containing a #GST_TYPE_LIST of #GstStructure with the statistics that
+   * have been aggregated so far. The lists are empty unless the tracer was
+   * created with `aggregate=true`.
+   *
+   * Each `element-stats` structure has the fields `element-ix`, `parent-ix`,
+   * `name`, `num-buffers` and `time-p50`, `time-p99`, `time-p999` for the
+   * time spent handling a buffer in nanoseconds.
+   *
+   * Each `pad-stats` structure has the fields `pad-ix`, `element-ix`, `name`,
+   * `num-buffers`, `num-bytes`, `buffer-rate` in buffers per second,
+   * `interval-p50`, `interval-p99`, `interval-p999` for the time between
+   * buffers and `time-p50`, `time-p99`, `time-p999` for the time spent in
+   * push/pull, all in nanoseconds.
+   *
+   * Returns: (transfer full): a newly-allocated #GstStructure
+   *
+   * Since: 1.22
+   */
+  gst_stats_tracer_signals[SIGNAL_GET_STATS] =
+      g_signal_new ("get-stats", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, G_STRUCT_OFFSET (GstStatsTracerClass,
+          get_stats), NULL, NULL, NULL, GST_TYPE_STRUCTURE, 0, G_TYPE_NONE);
 }
 
 static void
@@ -789,6 +1424,10 @@ gst_stats_tracer_init (GstStatsTracer * self)
 {
   GstTracer *tracer = GST_TRACER (self);
 
+  self->interval = DEFAULT_INTERVAL;
+  self->agg_pads = g_ptr_array_new ();
+  self->agg_elements = g_ptr_array_new ();
+
   gst_tracing_register_hook (tracer, "pad-push-pre",
       G_CALLBACK (do_push_buffer_pre));
   gst_tracing_register_hook (tracer, "pad-push-post",
@@ -52,12 +52,22 @@ struct _GstStatsTracer {
 
   /*< private >*/
   guint num_elements, num_pads;
+
+  /* in-process aggregation, see the aggregate param */
+  gboolean aggregate;
+  GstClockTime interval;
+  GstClockTime next_summary_ts;
+  /* GstPadStats / GstElementStats being aggregated, protected by the
+   * _agg_stats lock */
+  GPtrArray *agg_pads;
+  GPtrArray *agg_elements;
 };
 
 struct _GstStatsTracerClass {
   GstTracerClass parent_class;
 
-  /* signals */
+  /* actions */
+  GstStructure * (*get_stats) (GstStatsTracer *tracer);
 };
 
 G_GNUC_INTERNAL GType gst_stats_tracer_get_type (void);
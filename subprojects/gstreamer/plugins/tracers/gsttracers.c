@@ -30,6 +30,12 @@
 #include "gststats.h"
 #include "gstleaks.h"
 #include "gstfactories.h"
+#include "gstinitprofile.h"
+#include "gststartup.h"
+#include "gstchrometrace.h"
+#include "gstbufferpools.h"
+#include "gstpipelinegraph.h"
+#include "gstqueuelevels.h"
 
 static gboolean
 plugin_init (GstPlugin * plugin)
@@ -51,6 +57,23 @@ plugin_init (GstPlugin * plugin)
   if (!gst_tracer_register (plugin, "factories",
           gst_factories_tracer_get_type ()))
     return FALSE;
+  if (!gst_tracer_register (plugin, "startup", gst_startup_tracer_get_type ()))
+    return FALSE;
+  if (!gst_tracer_register (plugin, "chrometrace",
+          gst_chrome_trace_tracer_get_type ()))
+    return FALSE;
+  if (!gst_tracer_register (plugin, "bufferpools",
+          gst_buffer_pools_tracer_get_type ()))
+    return FALSE;
+  if (!gst_tracer_register (plugin, "pipelinegraph",
+          gst_pipeline_graph_tracer_get_type ()))
+    return FALSE;
+  if (!gst_tracer_register (plugin, "queuelevels",
+          gst_queue_levels_tracer_get_type ()))
+    return FALSE;
+  if (!gst_tracer_register (plugin, "initprofile",
+          gst_init_profile_tracer_get_type ()))
+    return FALSE;
   return TRUE;
 }
 
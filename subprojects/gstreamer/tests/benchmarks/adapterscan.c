@@ -0,0 +1,136 @@
+/* GStreamer
+ * Copyright (C) <2022> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Compares start code scanning with gst_adapter_masked_scan_uint32() to a
+ * plain byte by byte scan over the chunks of gst_adapter_map_chunks() */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gst/gst.h>
+#include <gst/base/base.h>
+
+#define CHUNK_SIZE 1316
+
+static gssize
+scan_bytewise (GstAdapter * adapter, gsize offset, gsize size)
+{
+  GstAdapterChunks chunks;
+  guint32 state = ~0x00000100;
+  gsize pos = offset;
+  gssize ret = -1;
+  guint i, j;
+
+  if (!gst_adapter_map_chunks (adapter, offset, size, &chunks))
+    return -1;
+
+  for (i = 0; i < chunks.n_chunks && ret < 0; i++) {
+    for (j = 0; j < chunks.chunks[i].size; j++, pos++) {
+      state = (state << 8) | chunks.chunks[i].data[j];
+      if ((state & 0xffffff00) == 0x00000100 && pos >= offset + 3) {
+        ret = pos - 3;
+        break;
+      }
+    }
+  }
+
+  gst_adapter_unmap_chunks (adapter, &chunks);
+
+  return ret;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstAdapter *adapter;
+  GstClockTime start, end;
+  gssize offset;
+  guint n_chunks, n_iterations, i, found;
+  gsize size;
+
+  gst_init (&argc, &argv);
+
+  if (argc != 3) {
+    g_print ("usage: %s <num_chunks> <iterations>\n", argv[0]);
+    exit (-1);
+  }
+
+  n_chunks = atoi (argv[1]);
+  n_iterations = atoi (argv[2]);
+  if (n_chunks == 0 || n_iterations == 0) {
+    g_print ("number of chunks and iterations must be greater than 0\n");
+    exit (-2);
+  }
+
+  /* one start code every 10 chunks, some of them across chunks */
+  adapter = gst_adapter_new ();
+  for (i = 0; i < n_chunks; i++) {
+    guint8 *data = g_malloc (CHUNK_SIZE);
+    guint j;
+
+    for (j = 0; j < CHUNK_SIZE; j++)
+      data[j] = g_random_int_range (2, 256);
+    if (i % 20 == 19) {
+      data[CHUNK_SIZE / 2] = data[CHUNK_SIZE / 2 + 1] = 0x00;
+      data[CHUNK_SIZE / 2 + 2] = 0x01;
+    } else if (i % 20 == 9) {
+      /* completed by the first byte of the next chunk */
+      data[CHUNK_SIZE - 2] = data[CHUNK_SIZE - 1] = 0x00;
+    } else if (i % 20 == 10) {
+      data[0] = 0x01;
+    }
+    gst_adapter_push (adapter, gst_buffer_new_wrapped (data, CHUNK_SIZE));
+  }
+  size = gst_adapter_available (adapter);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_iterations; i++) {
+    found = 0;
+    offset = 0;
+    while ((offset = gst_adapter_masked_scan_uint32 (adapter, 0xffffff00,
+                0x00000100, offset, size - offset)) >= 0) {
+      found++;
+      offset += 4;
+      if (offset + 4 > size)
+        break;
+    }
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("masked scan:   %u start codes, average %" GST_TIME_FORMAT
+      " per pass\n", found, GST_TIME_ARGS ((end - start) / n_iterations));
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_iterations; i++) {
+    found = 0;
+    offset = 0;
+    while ((offset = scan_bytewise (adapter, offset, size - offset)) >= 0) {
+      found++;
+      offset += 4;
+      if (offset + 4 > size)
+        break;
+    }
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("bytewise scan: %u start codes, average %" GST_TIME_FORMAT
+      " per pass\n", found, GST_TIME_ARGS ((end - start) / n_iterations));
+
+  g_object_unref (adapter);
+
+  return 0;
+}
@@ -24,6 +24,7 @@
 
 
 #define NUM_CAPS 10000
+#define NUM_LOOKUPS 1000000
 
 #define AUDIO_FORMATS_ALL " { S8, U8, " \
     "S16LE, S16BE, U16LE, U16BE, " \
@@ -47,7 +48,11 @@ main (gint argc, gchar * argv[])
   GstCaps **capses;
   GstCaps *protocaps;
   GstClockTime start, end;
-  gint i;
+  GstStructure *s;
+  GstQuery *query;
+  gint i, width, height, fps_n, fps_d;
+  gboolean live;
+  GstClockTime min, max;
 
   gst_init (&argc, &argv);
 
@@ -71,5 +76,34 @@ main (gint argc, gchar * argv[])
   g_free (capses);
   gst_caps_unref (protocaps);
 
+  /* field lookups in well-known structures */
+  protocaps = gst_caps_from_string ("video/x-raw, format=(string)I420, "
+      "width=(int)1920, height=(int)1080, interlace-mode=(string)progressive, "
+      "pixel-aspect-ratio=(fraction)1/1, framerate=(fraction)30/1, "
+      "colorimetry=(string)bt709, chroma-site=(string)mpeg2");
+  s = gst_caps_get_structure (protocaps, 0);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_LOOKUPS; i++) {
+    gst_structure_get_int (s, "width", &width);
+    gst_structure_get_int (s, "height", &height);
+    gst_structure_get_fraction (s, "framerate", &fps_n, &fps_d);
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - %d video caps field lookups\n",
+      GST_TIME_ARGS (end - start), 3 * i);
+  gst_caps_unref (protocaps);
+
+  query = gst_query_new_latency ();
+  gst_query_set_latency (query, TRUE, 20 * GST_MSECOND, GST_CLOCK_TIME_NONE);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_LOOKUPS; i++)
+    gst_query_parse_latency (query, &live, &min, &max);
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - parsing %d latency queries\n",
+      GST_TIME_ARGS (end - start), i);
+  gst_query_unref (query);
+
   return 0;
 }
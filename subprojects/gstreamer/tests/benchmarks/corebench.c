@@ -0,0 +1,572 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * corebench.c: microbenchmarks for the core data flow paths
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* This benchmark runs a fixed set of microbenchmarks on the core push/chain
+ * path and on commonly used core APIs, and prints one line of CSV per
+ * benchmark so that results can be compared between releases:
+ *
+ *   name,iterations,ns_per_op,objects_per_op
+ *
+ * objects_per_op is the number of GstMiniObject and GstObject instances
+ * created per operation, counted with the tracer hooks. Other memory
+ * allocations, e.g. of GstMemory backing store or GstStructure fields, are
+ * not included.
+ *
+ * The run can be controlled with a few command line options:
+ *
+ *  -i iterations: number of operations per benchmark
+ *  -e elements: number of identity elements in the push benchmarks
+ *  -f filter: only run benchmarks whose name contains this string
+ */
+
+#include <gst/gst.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BUFFER_LIST_SIZE 16
+
+typedef void (*BenchFunc) (gpointer user_data);
+
+/* all benchmarks are run from the main thread only */
+static guint64 objects_created;
+
+/* Minimal tracer counting object creations */
+typedef struct
+{
+  GstTracer parent;
+} BenchTracer;
+
+typedef struct
+{
+  GstTracerClass parent_class;
+} BenchTracerClass;
+
+static GType bench_tracer_get_type (void);
+G_DEFINE_TYPE (BenchTracer, bench_tracer, GST_TYPE_TRACER);
+
+static void
+do_mini_object_created (GstTracer * self, GstClockTime ts,
+    GstMiniObject * object)
+{
+  objects_created++;
+}
+
+static void
+do_object_created (GstTracer * self, GstClockTime ts, GstObject * object)
+{
+  objects_created++;
+}
+
+static void
+bench_tracer_class_init (BenchTracerClass * klass)
+{
+}
+
+static void
+bench_tracer_init (BenchTracer * self)
+{
+  GstTracer *tracer = GST_TRACER (self);
+
+  gst_tracing_register_hook (tracer, "mini-object-created",
+      G_CALLBACK (do_mini_object_created));
+  gst_tracing_register_hook (tracer, "object-created",
+      G_CALLBACK (do_object_created));
+}
+
+static const gchar *filter = NULL;
+static gint iterations = 100000;
+
+static void
+run_benchmark (const gchar * name, BenchFunc func, gpointer user_data)
+{
+  GstClockTime start, end;
+  guint64 start_objects;
+  gint i;
+
+  if (filter && !strstr (name, filter))
+    return;
+
+  /* warm up caches and lazily initialized state */
+  for (i = 0; i < MAX (iterations / 100, 1); i++)
+    func (user_data);
+
+  start_objects = objects_created;
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < iterations; i++)
+    func (user_data);
+  end = gst_util_get_timestamp ();
+
+  g_print ("%s,%d,%.1f,%.2f\n", name, iterations,
+      (gdouble) (end - start) / iterations,
+      (gdouble) (objects_created - start_objects) / iterations);
+}
+
+/* Push benchmarks: buffers are pushed from a floating source pad through a
+ * chain of identity elements into a fakesink */
+typedef struct
+{
+  GstElement *pipeline;
+  GstPad *srcpad;
+  GList *probes;
+  GstBuffer *buffer;
+  GstBufferList *list;
+  GstCaps *caps[2];
+  guint caps_idx;
+} PushBench;
+
+static gboolean
+push_bench_setup (PushBench * b, gint n_elements)
+{
+  GstElement *prev, *sink;
+  GstPad *sinkpad;
+  GstSegment segment;
+  gint i;
+
+  memset (b, 0, sizeof (PushBench));
+
+  b->pipeline = gst_pipeline_new ("pipeline");
+  sink = gst_element_factory_make ("fakesink", NULL);
+  if (!sink)
+    return FALSE;
+  g_object_set (sink, "sync", FALSE, "async", FALSE, NULL);
+
+  prev = gst_element_factory_make ("identity", NULL);
+  if (!prev) {
+    gst_object_unref (sink);
+    return FALSE;
+  }
+  gst_bin_add (GST_BIN (b->pipeline), prev);
+  sinkpad = gst_element_get_static_pad (prev, "sink");
+
+  for (i = 1; i < n_elements; i++) {
+    GstElement *next = gst_element_factory_make ("identity", NULL);
+
+    gst_bin_add (GST_BIN (b->pipeline), next);
+    gst_element_link (prev, next);
+    prev = next;
+  }
+  gst_bin_add (GST_BIN (b->pipeline), sink);
+  gst_element_link (prev, sink);
+
+  b->srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  gst_pad_link (b->srcpad, sinkpad);
+  gst_object_unref (sinkpad);
+  gst_pad_set_active (b->srcpad, TRUE);
+
+  gst_element_set_state (b->pipeline, GST_STATE_PLAYING);
+
+  b->caps[0] = gst_caps_from_string ("video/x-raw, format=I420, width=320, "
+      "height=240, framerate=30/1");
+  b->caps[1] = gst_caps_from_string ("video/x-raw, format=I420, width=640, "
+      "height=480, framerate=30/1");
+
+  gst_pad_push_event (b->srcpad, gst_event_new_stream_start ("corebench"));
+  gst_pad_push_event (b->srcpad, gst_event_new_caps (b->caps[0]));
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (b->srcpad, gst_event_new_segment (&segment));
+
+  b->buffer = gst_buffer_new_allocate (NULL, 1024, NULL);
+  b->list = gst_buffer_list_new_sized (BUFFER_LIST_SIZE);
+  for (i = 0; i < BUFFER_LIST_SIZE; i++)
+    gst_buffer_list_add (b->list, gst_buffer_ref (b->buffer));
+
+  return TRUE;
+}
+
+static void
+push_bench_teardown (PushBench * b)
+{
+  gst_element_set_state (b->pipeline, GST_STATE_NULL);
+  gst_pad_set_active (b->srcpad, FALSE);
+  gst_object_unref (b->srcpad);
+  gst_object_unref (b->pipeline);
+  g_list_free_full (b->probes, gst_object_unref);
+  gst_buffer_list_unref (b->list);
+  gst_buffer_unref (b->buffer);
+  gst_caps_unref (b->caps[0]);
+  gst_caps_unref (b->caps[1]);
+}
+
+static GstPadProbeReturn
+pass_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  return GST_PAD_PROBE_OK;
+}
+
+/* install a buffer probe on all source pads of the chain */
+static void
+push_bench_add_probes (PushBench * b)
+{
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+
+  it = gst_bin_iterate_elements (GST_BIN (b->pipeline));
+  while (gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    GstPad *pad = gst_element_get_static_pad (g_value_get_object (&item),
+        "src");
+
+    if (pad) {
+      gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, pass_probe, NULL,
+          NULL);
+      b->probes = g_list_prepend (b->probes, pad);
+    }
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+}
+
+static void
+bench_pad_push (gpointer user_data)
+{
+  PushBench *b = user_data;
+
+  gst_pad_push (b->srcpad, gst_buffer_ref (b->buffer));
+}
+
+static void
+bench_pad_push_new_buffer (gpointer user_data)
+{
+  PushBench *b = user_data;
+
+  gst_pad_push (b->srcpad, gst_buffer_new ());
+}
+
+static void
+bench_pad_push_list (gpointer user_data)
+{
+  PushBench *b = user_data;
+
+  gst_pad_push_list (b->srcpad, gst_buffer_list_ref (b->list));
+}
+
+static void
+bench_probe_add_remove (gpointer user_data)
+{
+  PushBench *b = user_data;
+  gulong id;
+
+  id = gst_pad_add_probe (b->srcpad, GST_PAD_PROBE_TYPE_BUFFER, pass_probe,
+      NULL, NULL);
+  gst_pad_remove_probe (b->srcpad, id);
+}
+
+static void
+bench_caps_event (gpointer user_data)
+{
+  PushBench *b = user_data;
+
+  b->caps_idx ^= 1;
+  gst_pad_push_event (b->srcpad, gst_event_new_caps (b->caps[b->caps_idx]));
+}
+
+static void
+bench_caps_query (gpointer user_data)
+{
+  PushBench *b = user_data;
+
+  gst_caps_unref (gst_pad_peer_query_caps (b->srcpad, NULL));
+}
+
+static void
+bench_accept_caps (gpointer user_data)
+{
+  PushBench *b = user_data;
+
+  gst_pad_peer_query_accept_caps (b->srcpad, b->caps[1]);
+}
+
+static void
+bench_position_query (gpointer user_data)
+{
+  PushBench *b = user_data;
+  gint64 position;
+
+  gst_pad_peer_query_position (b->srcpad, GST_FORMAT_TIME, &position);
+}
+
+static void
+bench_latency_query (gpointer user_data)
+{
+  PushBench *b = user_data;
+  GstQuery *query;
+
+  query = gst_query_new_latency ();
+  gst_pad_peer_query (b->srcpad, query);
+  gst_query_unref (query);
+}
+
+/* Query and event creation */
+
+static void
+bench_query_new_position (gpointer user_data)
+{
+  GstQuery *query;
+  gint64 position;
+
+  query = gst_query_new_position (GST_FORMAT_TIME);
+  gst_query_set_position (query, GST_FORMAT_TIME, 0);
+  gst_query_parse_position (query, NULL, &position);
+  gst_query_unref (query);
+}
+
+static void
+bench_event_new_custom (gpointer user_data)
+{
+  gst_event_unref (gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM,
+          gst_structure_new ("corebench", "seqnum", G_TYPE_UINT, 1, NULL)));
+}
+
+/* Buffer pool churn */
+
+static void
+bench_pool_acquire_release (gpointer user_data)
+{
+  GstBufferPool *pool = user_data;
+  GstBuffer *buf;
+
+  gst_buffer_pool_acquire_buffer (pool, &buf, NULL);
+  gst_buffer_unref (buf);
+}
+
+static void
+bench_pool_acquire_release_many (gpointer user_data)
+{
+  GstBufferPool *pool = user_data;
+  GstBuffer *bufs[8];
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (bufs); i++)
+    gst_buffer_pool_acquire_buffer (pool, &bufs[i], NULL);
+  for (i = 0; i < G_N_ELEMENTS (bufs); i++)
+    gst_buffer_unref (bufs[i]);
+}
+
+/* Structure and caps operations */
+
+static const gchar *caps_str =
+    "video/x-raw, format=(string){ I420, YV12, NV12 }, "
+    "width=(int)[ 1, 4096 ], height=(int)[ 1, 4096 ], "
+    "framerate=(fraction)[ 0/1, 120/1 ]";
+
+static void
+bench_structure_new_get (gpointer user_data)
+{
+  GstStructure *s;
+  gint width;
+  const gchar *format;
+
+  s = gst_structure_new ("video/x-raw", "format", G_TYPE_STRING, "I420",
+      "width", G_TYPE_INT, 320, "height", G_TYPE_INT, 240, NULL);
+  gst_structure_get_int (s, "width", &width);
+  format = gst_structure_get_string (s, "format");
+  g_assert (format != NULL);
+  gst_structure_free (s);
+}
+
+static void
+bench_structure_to_from_string (gpointer user_data)
+{
+  GstStructure *s = user_data, *copy;
+  gchar *str;
+
+  str = gst_structure_to_string (s);
+  copy = gst_structure_from_string (str, NULL);
+  g_free (str);
+  gst_structure_free (copy);
+}
+
+static void
+bench_caps_from_string (gpointer user_data)
+{
+  gst_caps_unref (gst_caps_from_string (caps_str));
+}
+
+static void
+bench_caps_intersect (gpointer user_data)
+{
+  GstCaps **caps = user_data;
+
+  gst_caps_unref (gst_caps_intersect (caps[0], caps[1]));
+}
+
+static void
+bench_caps_is_subset (gpointer user_data)
+{
+  GstCaps **caps = user_data;
+
+  gst_caps_is_subset (caps[1], caps[0]);
+}
+
+static void
+bench_caps_fixate (gpointer user_data)
+{
+  GstCaps **caps = user_data;
+
+  gst_caps_unref (gst_caps_fixate (gst_caps_copy (caps[0])));
+}
+
+static void
+run_push_benchmarks (gint n_elements)
+{
+  PushBench b;
+  gchar *name;
+
+  if (!push_bench_setup (&b, n_elements)) {
+    g_printerr ("need the identity and fakesink elements\n");
+    exit (1);
+  }
+
+#define RUN(bname, func) G_STMT_START { \
+    name = g_strdup_printf (bname "-%d", n_elements); \
+    run_benchmark (name, func, &b); \
+    g_free (name); \
+  } G_STMT_END
+
+  RUN ("pad-push", bench_pad_push);
+  RUN ("pad-push-new-buffer", bench_pad_push_new_buffer);
+  RUN ("pad-push-list", bench_pad_push_list);
+  RUN ("caps-event", bench_caps_event);
+  RUN ("caps-query", bench_caps_query);
+  RUN ("accept-caps", bench_accept_caps);
+  RUN ("position-query", bench_position_query);
+  RUN ("latency-query", bench_latency_query);
+  run_benchmark ("probe-add-remove", bench_probe_add_remove, &b);
+  push_bench_add_probes (&b);
+  RUN ("pad-push-probes", bench_pad_push);
+  RUN ("pad-push-list-probes", bench_pad_push_list);
+
+#undef RUN
+
+  push_bench_teardown (&b);
+}
+
+static void
+run_pool_benchmarks (void)
+{
+  GstBufferPool *pool;
+  GstStructure *config;
+
+  pool = gst_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, NULL, 1024, 0, 0);
+  gst_buffer_pool_set_config (pool, config);
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  run_benchmark ("pool-acquire-release", bench_pool_acquire_release, pool);
+  run_benchmark ("pool-acquire-release-8", bench_pool_acquire_release_many,
+      pool);
+
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+}
+
+static void
+run_query_event_benchmarks (void)
+{
+  run_benchmark ("query-new-position", bench_query_new_position, NULL);
+  run_benchmark ("event-new-custom", bench_event_new_custom, NULL);
+}
+
+static void
+run_caps_benchmarks (void)
+{
+  GstStructure *s;
+  GstCaps *caps[2];
+
+  s = gst_structure_new ("video/x-raw", "format", G_TYPE_STRING, "I420",
+      "width", G_TYPE_INT, 320, "height", G_TYPE_INT, 240,
+      "framerate", GST_TYPE_FRACTION, 30, 1, NULL);
+  caps[0] = gst_caps_from_string (caps_str);
+  caps[1] = gst_caps_from_string ("video/x-raw, format=(string)NV12, "
+      "width=(int)1920, height=(int)1080, framerate=(fraction)30/1");
+
+  run_benchmark ("structure-new-get", bench_structure_new_get, NULL);
+  run_benchmark ("structure-to-from-string", bench_structure_to_from_string,
+      s);
+  run_benchmark ("caps-from-string", bench_caps_from_string, NULL);
+  run_benchmark ("caps-intersect", bench_caps_intersect, caps);
+  run_benchmark ("caps-is-subset", bench_caps_is_subset, caps);
+  run_benchmark ("caps-fixate", bench_caps_fixate, caps);
+
+  gst_caps_unref (caps[0]);
+  gst_caps_unref (caps[1]);
+  gst_structure_free (s);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gint n_elements = 10;
+  gchar *filter_str = NULL;
+  GstTracer *tracer;
+
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"iterations", 'i', 0, G_OPTION_ARG_INT, &iterations,
+        "Number of operations per benchmark (default: 100000)", NULL}
+    ,
+    {"elements", 'e', 0, G_OPTION_ARG_INT, &n_elements,
+        "Number of identity elements in the push benchmarks (default: 10)",
+        NULL}
+    ,
+    {"filter", 'f', 0, G_OPTION_ARG_STRING, &filter_str,
+        "Only run benchmarks whose name contains this string", NULL}
+    ,
+    {NULL}
+  };
+  GError *err = NULL;
+
+  g_set_prgname ("corebench");
+
+  /* check command line options */
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_clear_error (&err);
+    g_option_context_free (ctx);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (iterations < 1 || n_elements < 1) {
+    g_printerr ("iterations and elements must be positive\n");
+    return 1;
+  }
+  filter = filter_str;
+
+  tracer = g_object_new (bench_tracer_get_type (), NULL);
+  gst_object_ref_sink (tracer);
+
+  g_print ("name,iterations,ns_per_op,objects_per_op\n");
+
+  run_push_benchmarks (n_elements);
+  run_pool_benchmarks ();
+  run_query_event_benchmarks ();
+  run_caps_benchmarks ();
+
+  gst_object_unref (tracer);
+  g_free (filter_str);
+
+  return 0;
+}
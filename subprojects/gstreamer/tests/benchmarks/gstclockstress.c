@@ -19,6 +19,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <gst/gst.h>
 #include <gst/glib-compat-private.h>
 
@@ -43,19 +44,80 @@ run_test (void *user_data)
   return NULL;
 }
 
+#define WAIT_INTERVAL (10 * GST_MSECOND)
+/* resolution used to count distinct wakeups */
+#define WAKEUP_WINDOW (50 * GST_USECOND)
+
+static GMutex wait_lock;
+static GHashTable *wakeups;
+static guint64 total_lateness;
+static guint64 max_lateness;
+
+/* every thread waits on a periodic id with a random phase, like live sinks
+ * syncing on the pipeline clock do */
+static void *
+run_wait_test (void *user_data)
+{
+  GstClock *sysclock = GST_CLOCK_CAST (user_data);
+  GstClockID id;
+  GstClockTime start;
+
+  start = gst_clock_get_time (sysclock) + WAIT_INTERVAL +
+      g_random_int_range (0, WAIT_INTERVAL);
+  id = gst_clock_new_periodic_id (sysclock, start, WAIT_INTERVAL);
+
+  while (running) {
+    GstClockTimeDiff jitter;
+    GstClockTime target, now;
+
+    target = GST_CLOCK_ENTRY_TIME ((GstClockEntry *) id);
+    gst_clock_id_wait (id, &jitter);
+    now = gst_clock_get_time (sysclock);
+
+    g_mutex_lock (&wait_lock);
+    g_hash_table_add (wakeups, GSIZE_TO_POINTER (now / WAKEUP_WINDOW));
+    if (now > target) {
+      total_lateness += now - target;
+      max_lateness = MAX (max_lateness, now - target);
+    }
+    count++;
+    g_mutex_unlock (&wait_lock);
+  }
+  gst_clock_id_unref (id);
+
+  g_thread_exit (NULL);
+  return NULL;
+}
+
+static void
+usage (const gchar * name)
+{
+  g_print ("usage: %s <num_threads>\n", name);
+  g_print ("       %s --wait <num_threads> [wait_slack_us]\n", name);
+  exit (-1);
+}
+
 gint
 main (gint argc, gchar * argv[])
 {
   GThread *threads[MAX_THREADS];
+  GThreadFunc func = run_test;
+  gboolean wait_test = FALSE;
   gint num_threads;
   gint t;
   GstClock *sysclock;
 
   gst_init (&argc, &argv);
 
-  if (argc != 2) {
-    g_print ("usage: %s <num_threads>\n", argv[0]);
-    exit (-1);
+  if (argc >= 2 && !strcmp (argv[1], "--wait")) {
+    if (argc != 3 && argc != 4)
+      usage (argv[0]);
+    wait_test = TRUE;
+    func = run_wait_test;
+    argv++;
+    argc--;
+  } else if (argc != 2) {
+    usage (argv[0]);
   }
 
   num_threads = atoi (argv[1]);
@@ -67,11 +129,18 @@ main (gint argc, gchar * argv[])
 
   sysclock = gst_system_clock_obtain ();
 
+  if (wait_test) {
+    GstClockTime slack = argc == 3 ? atoi (argv[2]) * GST_USECOND : 0;
+
+    g_object_set (sysclock, "wait-slack", slack, NULL);
+    g_mutex_init (&wait_lock);
+    wakeups = g_hash_table_new (NULL, NULL);
+  }
+
   for (t = 0; t < num_threads; t++) {
     GError *error = NULL;
 
-    threads[t] = g_thread_try_new ("clockstresstest", run_test,
-        sysclock, &error);
+    threads[t] = g_thread_try_new ("clockstresstest", func, sysclock, &error);
 
     if (error) {
       printf ("ERROR: g_thread_try_new() %s\n", error->message);
@@ -92,7 +161,17 @@ main (gint argc, gchar * argv[])
     g_thread_join (threads[t]);
   }
 
-  g_print ("performed %d get_time operations\n", count);
+  if (wait_test) {
+    g_print ("performed %d waits in %u distinct %" G_GUINT64_FORMAT
+        "us windows, lateness avg %" G_GUINT64_FORMAT "us max %"
+        G_GUINT64_FORMAT "us\n", count, g_hash_table_size (wakeups),
+        WAKEUP_WINDOW / GST_USECOND,
+        count ? total_lateness / count / GST_USECOND : 0,
+        max_lateness / GST_USECOND);
+    g_hash_table_unref (wakeups);
+  } else {
+    g_print ("performed %d get_time operations\n", count);
+  }
 
   gst_object_unref (sysclock);
 
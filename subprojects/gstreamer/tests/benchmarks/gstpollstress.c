@@ -20,9 +20,16 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <gst/gst.h>
 #include "gst/glib-compat-private.h"
 
+#ifndef G_OS_WIN32
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#endif
+
 static GstPoll *set;
 static GList *fds = NULL;
 static GMutex fdlock;
@@ -136,6 +143,73 @@ run_test (void *threadid)
   return NULL;
 }
 
+#define SCALE_ITERATIONS 10000
+
+#ifndef G_OS_WIN32
+/* measures the cost of a wait with one active fd out of @num_fds, and of a
+ * wait after the set was changed */
+static gboolean
+run_scale (gint num_fds)
+{
+  GstPoll *poll;
+  GstPollFD *pfds;
+  gint *peers;
+  gdouble wait_time, ctl_time;
+  gint i, n = 0;
+
+  poll = gst_poll_new (TRUE);
+  pfds = g_new (GstPollFD, num_fds);
+  peers = g_new (gint, num_fds);
+
+  for (n = 0; n < num_fds; n++) {
+    gint sv[2];
+
+    if (socketpair (PF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+      g_print ("can't create %d fds: %s (raise ulimit -n)\n", num_fds,
+          g_strerror (errno));
+      goto done;
+    }
+
+    gst_poll_fd_init (&pfds[n]);
+    pfds[n].fd = sv[0];
+    peers[n] = sv[1];
+    gst_poll_add_fd (poll, &pfds[n]);
+    gst_poll_fd_ctl_read (poll, &pfds[n], TRUE);
+  }
+
+  /* one readable fd, so that every wait returns immediately */
+  if (write (peers[num_fds / 2], "x", 1) != 1)
+    goto done;
+
+  g_timer_start (timer);
+  for (i = 0; i < SCALE_ITERATIONS; i++)
+    gst_poll_wait (poll, GST_CLOCK_TIME_NONE);
+  wait_time = g_timer_elapsed (timer, NULL);
+
+  g_timer_start (timer);
+  for (i = 0; i < SCALE_ITERATIONS; i++) {
+    gst_poll_fd_ctl_write (poll, &pfds[i % num_fds], i & 1);
+    gst_poll_wait (poll, GST_CLOCK_TIME_NONE);
+  }
+  ctl_time = g_timer_elapsed (timer, NULL);
+
+  g_print ("%6d fds: %10.3f us per wait, %10.3f us per ctl + wait\n",
+      num_fds, wait_time * 1000000 / SCALE_ITERATIONS,
+      ctl_time * 1000000 / SCALE_ITERATIONS);
+
+done:
+  for (i = 0; i < n; i++) {
+    close (pfds[i].fd);
+    close (peers[i]);
+  }
+  g_free (peers);
+  g_free (pfds);
+  gst_poll_free (poll);
+
+  return n == num_fds;
+}
+#endif
+
 gint
 main (gint argc, gchar * argv[])
 {
@@ -148,8 +222,25 @@ main (gint argc, gchar * argv[])
   g_mutex_init (&fdlock);
   timer = g_timer_new ();
 
+  if (argc >= 2 && !strcmp (argv[1], "--scale")) {
+#ifndef G_OS_WIN32
+    gint max_fds = argc > 2 ? atoi (argv[2]) : 10000;
+    gint num_fds;
+
+    for (num_fds = 10; num_fds <= max_fds; num_fds *= 10) {
+      if (!run_scale (num_fds))
+        break;
+    }
+    return 0;
+#else
+    g_print ("--scale is not supported on this platform\n");
+    exit (-1);
+#endif
+  }
+
   if (argc != 2) {
     g_print ("usage: %s <num_threads>\n", argv[0]);
+    g_print ("       %s --scale [max_fds]\n", argv[0]);
     exit (-1);
   }
 
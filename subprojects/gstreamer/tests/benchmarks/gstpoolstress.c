@@ -23,6 +23,57 @@
 #include "gst/glib-compat-private.h"
 
 #define BUFFER_SIZE (1400)
+#define NUM_THREADS (4)
+/* small pool so that the threads have to wait for each other sometimes */
+#define MAX_BUFFERS_THREADED (NUM_THREADS * 2)
+
+static guint64 nbuffers;
+
+static gpointer
+acquire_release_func (gpointer data)
+{
+  GstBufferPool *pool = data;
+  GstBuffer *tmp;
+  guint64 i;
+
+  for (i = 0; i < nbuffers; i++) {
+    if (gst_buffer_pool_acquire_buffer (pool, &tmp, NULL) != GST_FLOW_OK)
+      break;
+    gst_buffer_unref (tmp);
+  }
+
+  return NULL;
+}
+
+static GstClockTimeDiff
+run_threaded (guint max_buffers)
+{
+  GThread *threads[NUM_THREADS];
+  GstBufferPool *pool;
+  GstStructure *conf;
+  GstClockTime start, end;
+  gint i;
+
+  pool = gst_buffer_pool_new ();
+
+  conf = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (conf, NULL, BUFFER_SIZE, 0, max_buffers);
+  gst_buffer_pool_set_config (pool, conf);
+
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_THREADS; i++)
+    threads[i] = g_thread_new ("poolstress", acquire_release_func, pool);
+  for (i = 0; i < NUM_THREADS; i++)
+    g_thread_join (threads[i]);
+  end = gst_util_get_timestamp ();
+
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+
+  return GST_CLOCK_DIFF (start, end);
+}
 
 gint
 main (gint argc, gchar * argv[])
@@ -31,8 +82,7 @@ main (gint argc, gchar * argv[])
   GstBuffer *tmp;
   GstBufferPool *pool;
   GstClockTime start, end;
-  GstClockTimeDiff dur1, dur2;
-  guint64 nbuffers;
+  GstClockTimeDiff dur1, dur2, dur3;
   GstStructure *conf;
 
   gst_init (&argc, &argv);
@@ -90,5 +140,21 @@ main (gint argc, gchar * argv[])
   gst_buffer_pool_set_active (pool, FALSE);
   gst_object_unref (pool);
 
+  /* acquire and release from multiple threads on the same pool */
+  dur3 = run_threaded (0);
+  g_print ("*** total %" GST_TIME_FORMAT " - average %" GST_TIME_FORMAT
+      "  - Done creating %" G_GUINT64_FORMAT " pooled buffers from %d threads"
+      "\n", GST_TIME_ARGS (dur3),
+      GST_TIME_ARGS (dur3 / (nbuffers * NUM_THREADS)),
+      nbuffers * NUM_THREADS, NUM_THREADS);
+
+  /* same, but with a limited number of buffers so threads have to wait */
+  dur3 = run_threaded (MAX_BUFFERS_THREADED);
+  g_print ("*** total %" GST_TIME_FORMAT " - average %" GST_TIME_FORMAT
+      "  - Done creating %" G_GUINT64_FORMAT " pooled buffers from %d threads"
+      " with at most %d buffers\n", GST_TIME_ARGS (dur3),
+      GST_TIME_ARGS (dur3 / (nbuffers * NUM_THREADS)),
+      nbuffers * NUM_THREADS, NUM_THREADS, MAX_BUFFERS_THREADED);
+
   return 0;
 }
@@ -0,0 +1,214 @@
+/* GStreamer
+ *
+ * Unit test for the bufferpools tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+static GstTracer *
+get_tracer_by_name (const gchar * name)
+{
+  GList *tracers, *l;
+  GstTracer *tracer = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next)
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), name) == 0)
+      tracer = gst_object_ref (l->data);
+
+  g_list_free_full (tracers, gst_object_unref);
+  return tracer;
+}
+
+/* returns the stats structure with @name from the @field list of the
+ * tracer stats */
+static GstStructure *
+get_stats (const gchar * field, const gchar * name)
+{
+  GstTracer *tracer;
+  GstStructure *stats, *res = NULL;
+  const GValue *list;
+  guint i;
+
+  tracer = get_tracer_by_name ("pools");
+  fail_unless (tracer);
+  g_signal_emit_by_name (tracer, "get-stats", &stats);
+  gst_object_unref (tracer);
+
+  list = gst_structure_get_value (stats, field);
+  fail_unless (list);
+  for (i = 0; i < gst_value_list_get_size (list); i++) {
+    const GstStructure *s =
+        gst_value_get_structure (gst_value_list_get_value (list, i));
+
+    if (g_strcmp0 (gst_structure_get_string (s, "name"), name) == 0)
+      res = gst_structure_copy (s);
+  }
+  gst_structure_free (stats);
+
+  return res;
+}
+
+static GstBufferPool *
+create_pool (guint max_buffers)
+{
+  GstBufferPool *pool = gst_buffer_pool_new ();
+  GstStructure *conf = gst_buffer_pool_get_config (pool);
+  GstCaps *caps = gst_caps_new_empty_simple ("test/data");
+
+  gst_buffer_pool_config_set_params (conf, caps, 10, 0, max_buffers);
+  gst_caps_unref (caps);
+  fail_unless (gst_buffer_pool_set_config (pool, conf));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  return pool;
+}
+
+static gpointer
+acquire_thread (GstBufferPool * pool)
+{
+  GstBuffer *buf = NULL;
+
+  fail_unless_equals_int (gst_buffer_pool_acquire_buffer (pool, &buf, NULL),
+      GST_FLOW_OK);
+  gst_buffer_unref (buf);
+
+  return NULL;
+}
+
+GST_START_TEST (test_pool_stats)
+{
+  GstBufferPool *pool = create_pool (1);
+  GstBuffer *buf = NULL;
+  GstStructure *s;
+  const GValue *histogram;
+  GThread *thread;
+  guint64 num_acquired, num_waits, wait_time, count;
+  guint outstanding, max_outstanding, i;
+
+  fail_unless_equals_int (gst_buffer_pool_acquire_buffer (pool, &buf, NULL),
+      GST_FLOW_OK);
+
+  s = get_stats ("pools", GST_OBJECT_NAME (pool));
+  fail_unless (s);
+  fail_unless (gst_structure_get (s, "num-acquired", G_TYPE_UINT64,
+          &num_acquired, "outstanding", G_TYPE_UINT, &outstanding, NULL));
+  fail_unless_equals_uint64 (num_acquired, 1);
+  fail_unless_equals_int (outstanding, 1);
+  gst_structure_free (s);
+
+  /* the pool is exhausted, the thread has to wait until we release */
+  thread = g_thread_new ("acquire", (GThreadFunc) acquire_thread, pool);
+  g_usleep (G_USEC_PER_SEC / 20);
+  gst_buffer_unref (buf);
+  g_thread_join (thread);
+
+  s = get_stats ("pools", GST_OBJECT_NAME (pool));
+  fail_unless (s);
+  fail_unless (gst_structure_get (s, "num-acquired", G_TYPE_UINT64,
+          &num_acquired, "outstanding", G_TYPE_UINT, &outstanding,
+          "max-outstanding", G_TYPE_UINT, &max_outstanding, "num-waits",
+          G_TYPE_UINT64, &num_waits, "wait-time", G_TYPE_UINT64, &wait_time,
+          NULL));
+  fail_unless_equals_uint64 (num_acquired, 2);
+  fail_unless_equals_int (outstanding, 0);
+  fail_unless_equals_int (max_outstanding, 1);
+  fail_unless (num_waits >= 1);
+  fail_unless (wait_time > 0);
+
+  histogram = gst_structure_get_value (s, "wait-histogram");
+  fail_unless (histogram);
+  count = 0;
+  for (i = 0; i < gst_value_array_get_size (histogram); i++)
+    count += g_value_get_uint64 (gst_value_array_get_value (histogram, i));
+  fail_unless_equals_uint64 (count, num_waits);
+  gst_structure_free (s);
+
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_allocator_stats)
+{
+  GstAllocator *allocator;
+  GstMemory *mem;
+  GstStructure *s;
+  guint64 num_allocs, live_allocs, live_bytes, max_live_bytes;
+
+  allocator = gst_allocator_find (NULL);
+  mem = gst_allocator_alloc (allocator, 100000, NULL);
+
+  s = get_stats ("allocators", GST_OBJECT_NAME (allocator));
+  fail_unless (s);
+  fail_unless (gst_structure_get (s, "num-allocs", G_TYPE_UINT64, &num_allocs,
+          "live-allocs", G_TYPE_UINT64, &live_allocs, "live-bytes",
+          G_TYPE_UINT64, &live_bytes, NULL));
+  fail_unless (num_allocs >= 1);
+  fail_unless (live_allocs >= 1);
+  fail_unless (live_bytes >= 100000);
+  gst_structure_free (s);
+
+  gst_memory_unref (mem);
+
+  s = get_stats ("allocators", GST_OBJECT_NAME (allocator));
+  fail_unless (s);
+  fail_unless (gst_structure_get (s, "live-bytes", G_TYPE_UINT64,
+          &live_bytes, "max-live-bytes", G_TYPE_UINT64, &max_live_bytes,
+          NULL));
+  fail_unless (live_bytes < 100000);
+  fail_unless (max_live_bytes >= 100000);
+  gst_structure_free (s);
+
+  gst_object_unref (allocator);
+}
+
+GST_END_TEST;
+
+static Suite *
+bufferpoolstracer_suite (void)
+{
+  Suite *s = suite_create ("bufferpoolstracer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_pool_stats);
+  tcase_add_test (tc_chain, test_allocator_stats);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (bufferpoolstracer); because we need to set
+ * the env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  g_setenv ("GST_TRACERS", "bufferpools(name=pools)", TRUE);
+
+  gst_check_init (&argc, &argv);
+  s = bufferpoolstracer_suite ();
+
+  return gst_check_run_suite (s, "bufferpoolstracer", __FILE__);
+}
@@ -0,0 +1,129 @@
+/* GStreamer
+ *
+ * Unit test for the chrometrace tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
+
+static gchar *trace_file;
+
+static GstTracer *
+get_tracer_by_name (const gchar * name)
+{
+  GList *tracers, *l;
+  GstTracer *tracer = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next)
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), name) == 0)
+      tracer = gst_object_ref (l->data);
+
+  g_list_free_full (tracers, gst_object_unref);
+  return tracer;
+}
+
+GST_START_TEST (test_trace_events)
+{
+  GstElement *pipe;
+  GstTracer *tracer;
+  GstMessage *m;
+  gchar *contents;
+
+  pipe = gst_parse_launch ("fakesrc num-buffers=20 ! queue name=q ! "
+      "fakesink name=sink", NULL);
+  fail_unless (pipe);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+  m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), -1, GST_MESSAGE_EOS);
+  gst_message_unref (m);
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipe);
+
+  tracer = get_tracer_by_name ("trace");
+  fail_unless (tracer);
+  g_signal_emit_by_name (tracer, "flush");
+  gst_object_unref (tracer);
+
+  fail_unless (g_file_get_contents (trace_file, &contents, NULL, NULL));
+  fail_unless (g_str_has_prefix (contents, "[\n"));
+  /* the streaming threads are named after the pad pushing */
+  fail_unless (strstr (contents, "\"name\":\"thread_name\",\"args\":{\"name\":"
+          "\"fakesrc0:src\"}") != NULL);
+  fail_unless (strstr (contents, "\"name\":\"thread_name\",\"args\":{\"name\":"
+          "\"q:src\"}") != NULL);
+  /* spans for the pushes into the queue and the sink */
+  fail_unless (strstr (contents, "\"ph\":\"B\"") != NULL);
+  fail_unless (strstr (contents, "\"ph\":\"E\"") != NULL);
+  fail_unless (strstr (contents, "\"cat\":\"push\",\"name\":\"q\"") != NULL);
+  fail_unless (strstr (contents, "\"cat\":\"push\",\"name\":\"sink\"") != NULL);
+  /* the queue level counter */
+  fail_unless (strstr (contents, "\"ph\":\"C\"") != NULL);
+  fail_unless (strstr (contents, "\"name\":\"q level\"") != NULL);
+  /* and the messages */
+  fail_unless (strstr (contents, "\"name\":\"eos\"") != NULL);
+  g_free (contents);
+}
+
+GST_END_TEST;
+
+static Suite *
+chrometracetracer_suite (void)
+{
+  Suite *s = suite_create ("chrometracetracer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_trace_events);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (chrometracetracer); because we need to set
+ * the env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+  gchar *tracers;
+  gint fd, ret;
+
+  fd = g_file_open_tmp ("chrometrace-XXXXXX.json", &trace_file, NULL);
+  g_assert (fd != -1);
+  g_close (fd, NULL);
+
+  tracers = g_strdup_printf ("chrometrace(name=trace,file=\"%s\")",
+      trace_file);
+  g_setenv ("GST_TRACERS", tracers, TRUE);
+  g_free (tracers);
+
+  gst_check_init (&argc, &argv);
+  s = chrometracetracer_suite ();
+  ret = gst_check_run_suite (s, "chrometracetracer", __FILE__);
+
+  g_unlink (trace_file);
+  g_free (trace_file);
+
+  return ret;
+}
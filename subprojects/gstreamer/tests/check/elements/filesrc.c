@@ -303,6 +303,62 @@ GST_START_TEST (test_pull)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pull_mmap)
+{
+  GstElement *src;
+  GstPad *pad;
+  GstFlowReturn ret;
+  GstBuffer *buffer, *buffer2;
+  gchar *contents;
+  gsize size;
+  gboolean use_mmap;
+
+  fail_unless (g_file_get_contents (TESTFILE, &contents, &size, NULL));
+  fail_unless (size > 200);
+
+  src = setup_filesrc ();
+
+  g_object_set (G_OBJECT (src), "location", TESTFILE, "use-mmap", TRUE, NULL);
+  g_object_get (G_OBJECT (src), "use-mmap", &use_mmap, NULL);
+  fail_unless (use_mmap);
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to ready");
+
+  pad = gst_element_get_static_pad (src, "src");
+  fail_unless (pad != NULL);
+  fail_unless (gst_pad_activate_mode (pad, GST_PAD_MODE_PULL, TRUE));
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  buffer = NULL;
+  ret = gst_pad_get_range (pad, 100, 100, &buffer);
+  fail_unless (ret == GST_FLOW_OK);
+  fail_unless (gst_buffer_get_size (buffer) == 100);
+  fail_unless (gst_buffer_memcmp (buffer, 0, contents + 100, 100) == 0);
+
+  /* reading at the end gives the remaining bytes */
+  buffer2 = NULL;
+  ret = gst_pad_get_range (pad, size - 10, 20, &buffer2);
+  fail_unless (ret == GST_FLOW_OK);
+  fail_unless (gst_buffer_get_size (buffer2) == 10);
+  fail_unless (gst_buffer_memcmp (buffer2, 0, contents + size - 10, 10) == 0);
+  gst_buffer_unref (buffer2);
+
+  /* the buffer still points into the file after stopping */
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+  fail_unless (gst_buffer_memcmp (buffer, 0, contents + 100, 100) == 0);
+  gst_buffer_unref (buffer);
+
+  gst_object_unref (pad);
+  cleanup_filesrc (src);
+  g_free (contents);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_coverage)
 {
   GstElement *src;
@@ -554,6 +610,7 @@ filesrc_suite (void)
   tcase_add_test (tc_chain, test_seeking);
   tcase_add_test (tc_chain, test_reverse);
   tcase_add_test (tc_chain, test_pull);
+  tcase_add_test (tc_chain, test_pull_mmap);
   tcase_add_test (tc_chain, test_coverage);
   tcase_add_test (tc_chain, test_uri_interface);
   tcase_add_test (tc_chain, test_uri_query);
@@ -0,0 +1,149 @@
+/* GStreamer
+ *
+ * Unit test for the initprofile tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+static GstStructure *
+get_stats (void)
+{
+  GList *tracers, *l;
+  GstStructure *stats = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next)
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), "init") == 0)
+      g_signal_emit_by_name (l->data, "get-stats", &stats);
+
+  g_list_free_full (tracers, gst_object_unref);
+  fail_unless (stats != NULL);
+  return stats;
+}
+
+static const GstStructure *
+find_stats (const GstStructure * stats, const gchar * field,
+    const gchar * name, guint * count)
+{
+  const GValue *list = gst_structure_get_value (stats, field);
+  const GstStructure *res = NULL;
+  guint i;
+
+  fail_unless (GST_VALUE_HOLDS_LIST (list));
+  *count = 0;
+  for (i = 0; i < gst_value_list_get_size (list); i++) {
+    const GstStructure *s =
+        gst_value_get_structure (gst_value_list_get_value (list, i));
+
+    if (g_strcmp0 (gst_structure_get_string (s, "name"), name) == 0) {
+      res = s;
+      (*count)++;
+    }
+  }
+  return res;
+}
+
+GST_START_TEST (test_init_events_replayed)
+{
+  GstStructure *stats;
+  const GstStructure *s;
+  GstClockTime load_time;
+  guint count;
+
+  stats = get_stats ();
+
+  /* the tracer plugin itself got loaded while creating the tracers */
+  s = find_stats (stats, "plugins", "coretracers", &count);
+  fail_unless (s != NULL);
+  fail_unless (gst_structure_get_uint64 (s, "load-time", &load_time));
+  fail_unless (GST_CLOCK_TIME_IS_VALID (load_time));
+
+  /* and the static core elements were registered before */
+  s = find_stats (stats, "plugins", "staticelements", &count);
+  fail_unless (s != NULL);
+
+  gst_structure_free (stats);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_factory_first_use)
+{
+  GstElement *e1, *e2;
+  GstStructure *stats;
+  const GstStructure *s;
+  GstClockTime create_time;
+  guint count;
+
+  e1 = gst_element_factory_make ("identity", NULL);
+  e2 = gst_element_factory_make ("identity", NULL);
+  fail_unless (e1 && e2);
+
+  /* only the first element is reported */
+  stats = get_stats ();
+  s = find_stats (stats, "factories", "identity", &count);
+  fail_unless (s != NULL);
+  fail_unless_equals_int (count, 1);
+  fail_unless_equals_string (gst_structure_get_string (s, "plugin"),
+      "coreelements");
+  fail_unless (gst_structure_get_uint64 (s, "create-time", &create_time));
+  fail_unless (GST_CLOCK_TIME_IS_VALID (create_time));
+
+  s = find_stats (stats, "plugins", "coreelements", &count);
+  fail_unless (s != NULL);
+  fail_unless (gst_structure_get_uint64 (s, "first-use-time", &create_time));
+  fail_unless (GST_CLOCK_TIME_IS_VALID (create_time));
+  gst_structure_free (stats);
+
+  gst_object_unref (e1);
+  gst_object_unref (e2);
+}
+
+GST_END_TEST;
+
+static Suite *
+initprofiletracer_suite (void)
+{
+  Suite *s = suite_create ("initprofiletracer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_init_events_replayed);
+  tcase_add_test (tc_chain, test_factory_first_use);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (initprofiletracer); because we need to
+ * set the env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  g_setenv ("GST_TRACERS", "initprofile(name=init)", TRUE);
+
+  gst_check_init (&argc, &argv);
+  s = initprofiletracer_suite ();
+
+  return gst_check_run_suite (s, "initprofiletracer", __FILE__);
+}
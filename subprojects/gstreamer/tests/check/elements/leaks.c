@@ -493,12 +493,73 @@ GST_START_TEST (test_activity_get_checkpoint)
 
 GST_END_TEST;
 
+static void
+get_type_stats (GstTracer * tracer, const gchar * type_name,
+    guint64 * created, guint64 * live)
+{
+  GstStructure *info;
+  const GValue *list;
+  guint i;
+
+  *created = *live = 0;
+
+  g_signal_emit_by_name (tracer, "get-type-stats", &info);
+  list = gst_structure_get_value (info, "type-stats-list");
+  fail_unless (G_VALUE_HOLDS (list, GST_TYPE_LIST));
+
+  for (i = 0; i < gst_value_list_get_size (list); i++) {
+    const GstStructure *s =
+        gst_value_get_structure (gst_value_list_get_value (list, i));
+
+    if (g_strcmp0 (gst_structure_get_string (s, "type-name"), type_name) == 0)
+      fail_unless (gst_structure_get (s, "created", G_TYPE_UINT64, created,
+              "live", G_TYPE_UINT64, live, NULL));
+  }
+  gst_structure_free (info);
+}
+
+/* Count objects in sampling mode */
+GST_START_TEST (test_sampling_type_stats)
+{
+  GstTracer *tracer = get_tracer_by_name ("sampled");
+  GstBuffer *bufs[8];
+  guint64 created, live, created_before, live_before;
+  guint i;
+
+  fail_unless (tracer);
+
+  get_type_stats (tracer, "GstBuffer", &created_before, &live_before);
+
+  for (i = 0; i < G_N_ELEMENTS (bufs); i++)
+    bufs[i] = gst_buffer_new ();
+
+  get_type_stats (tracer, "GstBuffer", &created, &live);
+  fail_unless_equals_uint64 (created, created_before + G_N_ELEMENTS (bufs));
+  fail_unless_equals_uint64 (live, live_before + G_N_ELEMENTS (bufs));
+
+  for (i = 0; i < G_N_ELEMENTS (bufs); i++)
+    gst_buffer_unref (bufs[i]);
+
+  get_type_stats (tracer, "GstBuffer", &created, &live);
+  fail_unless_equals_uint64 (created, created_before + G_N_ELEMENTS (bufs));
+  fail_unless_equals_uint64 (live, live_before);
+
+  /* only the filtered types are counted */
+  get_type_stats (tracer, "GstEvent", &created, &live);
+  fail_unless_equals_uint64 (created, 0);
+
+  gst_object_unref (tracer);
+}
+
+GST_END_TEST;
+
 static Suite *
 leakstracer_suite (void)
 {
   Suite *s = suite_create ("leakstracer");
   TCase *tc_chain_1 = tcase_create ("live-objects");
   TCase *tc_chain_2 = tcase_create ("activity-tracking");
+  TCase *tc_chain_3 = tcase_create ("sampling");
 
   suite_add_tcase (s, tc_chain_1);
   tcase_add_test (tc_chain_1, test_log_live_objects);
@@ -510,6 +571,9 @@ leakstracer_suite (void)
   tcase_add_test (tc_chain_2, test_activity_log_checkpoint);
   tcase_add_test (tc_chain_2, test_activity_get_checkpoint);
 
+  suite_add_tcase (s, tc_chain_3);
+  tcase_add_test (tc_chain_3, test_sampling_type_stats);
+
   return s;
 }
 
@@ -520,7 +584,8 @@ main (int argc, char **argv)
 {
   Suite *s;
   g_setenv ("GST_TRACERS", "leaks(name=plain,log-leaks-on-deinit=false);"
-      "leaks(name=more,filters=GstPad,check-refs=true,stack-traces-flags=none,log-leaks-on-deinit=false);",
+      "leaks(name=more,filters=GstPad,check-refs=true,stack-traces-flags=none,log-leaks-on-deinit=false);"
+      "leaks(name=sampled,filters=GstBuffer,sample-rate=4,log-leaks-on-deinit=false);",
       TRUE);
   gst_check_init (&argc, &argv);
   s = leakstracer_suite ();
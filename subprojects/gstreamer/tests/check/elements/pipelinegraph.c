@@ -0,0 +1,130 @@
+/* GStreamer
+ *
+ * Unit test for the pipelinegraph tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+GST_START_TEST (test_graph_messages)
+{
+  GstElement *pipe;
+  GstMessage *m;
+  gboolean seen_rates = FALSE, seen_queue = FALSE;
+
+  /* identity sleeps 2ms per buffer so the pipeline runs for a few exports */
+  pipe = gst_parse_launch ("fakesrc num-buffers=100 ! "
+      "identity sleep-time=2000 ! queue ! fakesink", NULL);
+  fail_unless (pipe);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  while ((m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), -1,
+              GST_MESSAGE_EOS | GST_MESSAGE_ELEMENT))) {
+    const GstStructure *s = gst_message_get_structure (m);
+
+    if (GST_MESSAGE_TYPE (m) == GST_MESSAGE_EOS) {
+      gst_message_unref (m);
+      break;
+    }
+
+    if (gst_structure_has_name (s, "pipeline-graph")) {
+      const gchar *dot = gst_structure_get_string (s, "dot");
+
+      fail_unless (dot != NULL);
+      fail_unless (g_str_has_prefix (dot, "digraph pipeline {"));
+      if (strstr (dot, "buffers/s"))
+        seen_rates = TRUE;
+      if (strstr (dot, "queue ") && strstr (dot, "% full"))
+        seen_queue = TRUE;
+    }
+    gst_message_unref (m);
+  }
+
+  fail_unless (seen_rates);
+  fail_unless (seen_queue);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static gchar *
+label_pad_name (GstPad * pad, gpointer user_data)
+{
+  (*(guint *) user_data)++;
+  return g_strdup_printf ("link \"%s\"\nsecond line", GST_PAD_NAME (pad));
+}
+
+GST_START_TEST (test_dot_data_link_labels)
+{
+  GstElement *pipe, *src, *sink;
+  guint calls = 0;
+  gchar *dot;
+
+  pipe = gst_pipeline_new (NULL);
+  src = gst_element_factory_make ("fakesrc", NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  gst_bin_add_many (GST_BIN (pipe), src, sink, NULL);
+  fail_unless (gst_element_link (src, sink));
+
+  dot = gst_debug_bin_to_dot_data_full (GST_BIN (pipe),
+      GST_DEBUG_GRAPH_SHOW_MEDIA_TYPE, label_pad_name, &calls);
+  fail_unless_equals_int (calls, 1);
+  /* quotes and newlines are escaped for dot */
+  fail_unless (strstr (dot, "link 'src'\\nsecond line") != NULL);
+  g_free (dot);
+
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static Suite *
+pipelinegraphtracer_suite (void)
+{
+  Suite *s = suite_create ("pipelinegraphtracer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_graph_messages);
+  tcase_add_test (tc_chain, test_dot_data_link_labels);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (pipelinegraphtracer); because we need to
+ * set the env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  g_setenv ("GST_TRACERS", "pipelinegraph(interval=20)", TRUE);
+
+  gst_check_init (&argc, &argv);
+  s = pipelinegraphtracer_suite ();
+
+  return gst_check_run_suite (s, "pipelinegraphtracer", __FILE__);
+}
@@ -0,0 +1,135 @@
+/* GStreamer
+ *
+ * Unit test for the queuelevels tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+static GstPadProbeReturn
+block_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_stall_warning)
+{
+  GstElement *pipe, *queue, *sink;
+  GstPad *pad;
+  GstMessage *m;
+  const GstStructure *details;
+  gulong probe_id;
+
+  /* the sink doesn't preroll so that the pipeline reaches PLAYING while the
+   * sink is blocked */
+  pipe = gst_parse_launch ("fakesrc ! queue name=q ! fakesink name=sink "
+      "async=false", NULL);
+  fail_unless (pipe);
+  queue = gst_bin_get_by_name (GST_BIN (pipe), "q");
+  sink = gst_bin_get_by_name (GST_BIN (pipe), "sink");
+
+  pad = gst_element_get_static_pad (sink, "sink");
+  probe_id = gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM,
+      block_probe, NULL, NULL);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), 5 * GST_SECOND,
+      GST_MESSAGE_WARNING | GST_MESSAGE_ERROR);
+  fail_unless (m != NULL);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (m), GST_MESSAGE_WARNING);
+  fail_unless (GST_MESSAGE_SRC (m) == GST_OBJECT (queue));
+
+  gst_message_parse_warning_details (m, &details);
+  fail_unless (details != NULL);
+  fail_unless (gst_structure_has_name (details, "queue-stall"));
+  fail_unless_equals_string (gst_structure_get_string (details,
+          "blocked-element"), "sink");
+  gst_message_unref (m);
+
+  gst_pad_remove_probe (pad, probe_id);
+  gst_object_unref (pad);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (sink);
+  gst_object_unref (queue);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_no_stall_when_flowing)
+{
+  GstElement *pipe;
+  GstMessage *m;
+
+  /* identity sleeps 2ms per buffer so the queue holds data for a few
+   * samples while it keeps flowing */
+  pipe = gst_parse_launch ("fakesrc num-buffers=100 ! queue ! "
+      "identity sleep-time=2000 ! fakesink", NULL);
+  fail_unless (pipe);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), -1,
+      GST_MESSAGE_EOS | GST_MESSAGE_WARNING | GST_MESSAGE_ERROR);
+  fail_unless (m != NULL);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (m), GST_MESSAGE_EOS);
+  gst_message_unref (m);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static Suite *
+queuelevelstracer_suite (void)
+{
+  Suite *s = suite_create ("queuelevelstracer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_stall_warning);
+  tcase_add_test (tc_chain, test_no_stall_when_flowing);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (queuelevelstracer); because we need to
+ * set the env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  g_setenv ("GST_TRACERS", "queuelevels(interval=10,stall-threshold=100)",
+      TRUE);
+
+  gst_check_init (&argc, &argv);
+  s = queuelevelstracer_suite ();
+
+  return gst_check_run_suite (s, "queuelevelstracer", __FILE__);
+}
@@ -0,0 +1,106 @@
+/* GStreamer
+ *
+ * Unit test for the rusage tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+GST_START_TEST (test_element_reports)
+{
+  GstElement *pipe;
+  GstMessage *m;
+  gboolean seen_identity = FALSE, seen_report = FALSE;
+
+  /* identity sleeps 2ms per buffer so it dominates the report */
+  pipe = gst_parse_launch ("fakesrc num-buffers=100 ! "
+      "identity name=slow sleep-time=2000 ! fakesink", NULL);
+  fail_unless (pipe);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  while ((m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), -1,
+              GST_MESSAGE_EOS | GST_MESSAGE_ELEMENT))) {
+    const GstStructure *s = gst_message_get_structure (m);
+
+    if (GST_MESSAGE_TYPE (m) == GST_MESSAGE_EOS) {
+      gst_message_unref (m);
+      break;
+    }
+
+    if (gst_structure_has_name (s, "rusage-elements")) {
+      const GValue *elements = gst_structure_get_value (s, "elements");
+      const GstStructure *top;
+      guint64 interval, time;
+
+      seen_report = TRUE;
+      fail_unless (gst_structure_get_uint64 (s, "interval", &interval));
+      fail_unless (interval > 0);
+      fail_unless (G_VALUE_HOLDS (elements, GST_TYPE_LIST));
+
+      if (gst_value_list_get_size (elements) > 0) {
+        top = gst_value_get_structure (gst_value_list_get_value (elements, 0));
+        fail_unless (gst_structure_get_uint64 (top, "time", &time));
+        fail_unless (time <= interval);
+        if (!g_strcmp0 (gst_structure_get_string (top, "element"), "slow"))
+          seen_identity = TRUE;
+      }
+    }
+    gst_message_unref (m);
+  }
+
+  fail_unless (seen_report);
+  fail_unless (seen_identity);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static Suite *
+rusagetracer_suite (void)
+{
+  Suite *s = suite_create ("rusagetracer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_element_reports);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (rusagetracer); because we need to set the
+ * env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  g_setenv ("GST_TRACERS", "rusage(elements=true,interval=20,top=2)", TRUE);
+
+  gst_check_init (&argc, &argv);
+  s = rusagetracer_suite ();
+
+  return gst_check_run_suite (s, "rusagetracer", __FILE__);
+}
@@ -0,0 +1,149 @@
+/* GStreamer
+ *
+ * Unit test for the stats tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+#define NUM_BUFFERS 20
+
+static GstTracer *
+get_tracer_by_name (const gchar * name)
+{
+  GList *tracers, *l;
+  GstTracer *tracer = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next)
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), name) == 0)
+      tracer = gst_object_ref (l->data);
+
+  g_list_free_full (tracers, gst_object_unref);
+  return tracer;
+}
+
+static const GstStructure *
+find_stats (const GValue * list, const gchar * name)
+{
+  guint i;
+
+  for (i = 0; i < gst_value_list_get_size (list); i++) {
+    const GstStructure *s =
+        gst_value_get_structure (gst_value_list_get_value (list, i));
+
+    if (!g_strcmp0 (gst_structure_get_string (s, "name"), name))
+      return s;
+  }
+  return NULL;
+}
+
+GST_START_TEST (test_get_stats)
+{
+  GstElement *pipe, *src, *sink;
+  GstTracer *tracer;
+  GstStructure *info;
+  const GstStructure *s;
+  const GValue *value;
+  guint64 num_buffers, p50, p99, p999;
+  GstMessage *m;
+
+  pipe = gst_pipeline_new ("pipeline");
+  src = gst_element_factory_make ("fakesrc", "src");
+  fail_unless (src);
+  g_object_set (src, "num-buffers", NUM_BUFFERS, "sizetype", 2,
+      "sizemax", 100, NULL);
+  sink = gst_element_factory_make ("fakesink", "sink");
+  fail_unless (sink);
+
+  gst_bin_add_many (GST_BIN (pipe), src, sink, NULL);
+  fail_unless (gst_element_link (src, sink));
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+  m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), -1, GST_MESSAGE_EOS);
+  gst_message_unref (m);
+
+  tracer = get_tracer_by_name ("aggregated");
+  fail_unless (tracer);
+  g_signal_emit_by_name (tracer, "get-stats", &info);
+  fail_unless (info);
+
+  /* the src pad pushed all buffers */
+  value = gst_structure_get_value (info, "pads");
+  fail_unless (GST_VALUE_HOLDS_LIST (value));
+  s = find_stats (value, "src");
+  fail_unless (s);
+  fail_unless (gst_structure_get_uint64 (s, "num-buffers", &num_buffers));
+  fail_unless_equals_uint64 (num_buffers, NUM_BUFFERS);
+  fail_unless (gst_structure_get_uint64 (s, "num-bytes", &num_buffers));
+  fail_unless_equals_uint64 (num_buffers, NUM_BUFFERS * 100);
+  fail_unless (gst_structure_get_uint64 (s, "interval-p50", &p50));
+  fail_unless (gst_structure_get_uint64 (s, "interval-p99", &p99));
+  fail_unless (gst_structure_get_uint64 (s, "interval-p999", &p999));
+  fail_unless (p50 <= p99);
+  fail_unless (p99 <= p999);
+
+  /* and the time spent in the push is accounted to the sink */
+  value = gst_structure_get_value (info, "elements");
+  fail_unless (GST_VALUE_HOLDS_LIST (value));
+  s = find_stats (value, "sink");
+  fail_unless (s);
+  fail_unless (gst_structure_get_uint64 (s, "num-buffers", &num_buffers));
+  fail_unless_equals_uint64 (num_buffers, NUM_BUFFERS);
+  fail_unless (gst_structure_get_uint64 (s, "time-p50", &p50));
+  fail_unless (gst_structure_get_uint64 (s, "time-p999", &p999));
+  fail_unless (p50 <= p999);
+
+  gst_structure_free (info);
+  gst_object_unref (tracer);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static Suite *
+statstracer_suite (void)
+{
+  Suite *s = suite_create ("statstracer");
+  TCase *tc_chain = tcase_create ("aggregate");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_get_stats);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (statstracer); because we need to set the
+ * env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+  g_setenv ("GST_TRACERS", "stats(name=aggregated,aggregate=true,interval=0)",
+      TRUE);
+  gst_check_init (&argc, &argv);
+  s = statstracer_suite ();
+  return gst_check_run_suite (s, "statstracer", __FILE__);
+}
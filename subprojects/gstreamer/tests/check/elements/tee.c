@@ -108,6 +108,75 @@ GST_START_TEST (test_num_buffers)
 
 GST_END_TEST;
 
+/* construct fakesrc num-buffers=20 ! tee dispatch-mode=parallel ! fakesink
+ * t. ! fakesink ... without queues, each fakesink should receive all buffers.
+ */
+GST_START_TEST (test_parallel_dispatch)
+{
+#define NUM_PARALLEL_SINKS 4
+#define NUM_PARALLEL_BUFFERS 20
+  GstElement *pipeline, *src, *tee;
+  GstElement *sinks[NUM_PARALLEL_SINKS];
+  GstPad *req_pads[NUM_PARALLEL_SINKS];
+  guint counts[NUM_PARALLEL_SINKS];
+  GstBus *bus;
+  GstMessage *msg;
+  gint i;
+
+  pipeline = gst_pipeline_new ("pipeline");
+  src = gst_check_setup_element ("fakesrc");
+  g_object_set (src, "num-buffers", NUM_PARALLEL_BUFFERS, NULL);
+  tee = gst_check_setup_element ("tee");
+  gst_util_set_object_arg (G_OBJECT (tee), "dispatch-mode", "parallel");
+  g_object_set (tee, "max-backlog", 2, NULL);
+  fail_unless (gst_bin_add (GST_BIN (pipeline), src));
+  fail_unless (gst_bin_add (GST_BIN (pipeline), tee));
+  fail_unless (gst_element_link (src, tee));
+
+  for (i = 0; i < NUM_PARALLEL_SINKS; ++i) {
+    GstPad *sinkpad;
+
+    counts[i] = 0;
+
+    sinks[i] = gst_check_setup_element ("fakesink");
+    fail_unless (gst_bin_add (GST_BIN (pipeline), sinks[i]));
+    g_object_set (sinks[i], "signal-handoffs", TRUE, "sync", FALSE, NULL);
+    g_signal_connect (sinks[i], "handoff", (GCallback) handoff, &counts[i]);
+
+    req_pads[i] = gst_element_request_pad_simple (tee, "src_%u");
+    fail_unless (req_pads[i] != NULL);
+
+    sinkpad = gst_element_get_static_pad (sinks[i], "sink");
+    fail_unless_equals_int (gst_pad_link (req_pads[i], sinkpad),
+        GST_PAD_LINK_OK);
+    gst_object_unref (sinkpad);
+  }
+
+  bus = gst_element_get_bus (pipeline);
+  fail_if (bus == NULL);
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  msg = gst_bus_poll (bus, GST_MESSAGE_EOS | GST_MESSAGE_ERROR, -1);
+  fail_if (GST_MESSAGE_TYPE (msg) != GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  /* EOS waits for all backlogs to be pushed */
+  for (i = 0; i < NUM_PARALLEL_SINKS; ++i) {
+    fail_unless_equals_int (counts[i], NUM_PARALLEL_BUFFERS);
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+
+  for (i = 0; i < NUM_PARALLEL_SINKS; ++i) {
+    gst_element_release_request_pad (tee, req_pads[i]);
+    gst_object_unref (req_pads[i]);
+  }
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 /* we use fakesrc ! tee ! fakesink and then randomly request/release and link
  * some pads from tee. This should happily run without any errors. */
 GST_START_TEST (test_stress)
@@ -951,6 +1020,7 @@ tee_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_num_buffers);
+  tcase_add_test (tc_chain, test_parallel_dispatch);
   tcase_add_test (tc_chain, test_stress);
   tcase_add_test (tc_chain, test_release_while_buffer_alloc);
   tcase_add_test (tc_chain, test_release_while_second_buffer_alloc);
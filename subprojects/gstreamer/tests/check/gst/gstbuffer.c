@@ -905,6 +905,82 @@ GST_START_TEST (test_writable_memory)
 
 GST_END_TEST;
 
+/* small buffers share their allocation with their memory, make sure the
+ * memory stays usable after the buffer is gone */
+GST_START_TEST (test_small_buffer_memory)
+{
+  GstAllocationParams params;
+  GstBuffer *buf, *copy;
+  GstMemory *mem;
+  GstMapInfo info;
+
+  buf = gst_buffer_new_and_alloc (200);
+  fail_unless (gst_buffer_is_writable (buf));
+  mem = gst_buffer_peek_memory (buf, 0);
+  fail_unless (gst_memory_is_writable (mem));
+  fail_unless_equals_int (gst_buffer_get_size (buf), 200);
+  gst_buffer_memset (buf, 0, 0x5a, 200);
+
+  mem = gst_buffer_get_memory (buf, 0);
+  copy = gst_buffer_copy (buf);
+  gst_buffer_unref (buf);
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  fail_unless_equals_int (info.size, 200);
+  fail_unless (info.data[0] == 0x5a && info.data[199] == 0x5a);
+  gst_memory_unmap (mem);
+  gst_memory_unref (mem);
+
+  fail_unless (gst_buffer_memcmp (copy, 199, "\x5a", 1) == 0);
+  gst_buffer_unref (copy);
+
+  /* alignment, prefix and padding are honoured */
+  gst_allocation_params_init (&params);
+  params.align = 63;
+  params.prefix = 16;
+  params.padding = 16;
+  params.flags = GST_MEMORY_FLAG_ZERO_PREFIXED | GST_MEMORY_FLAG_ZERO_PADDED;
+  buf = gst_buffer_new_allocate (NULL, 100, &params);
+  mem = gst_buffer_peek_memory (buf, 0);
+  fail_unless_equals_int (mem->offset, 16);
+  fail_unless (mem->maxsize >= 132);
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+  fail_unless ((((guintptr) info.data) - 16) % 64 == 0);
+  fail_unless (info.data[-1] == 0 && info.data[100] == 0);
+  gst_memory_unmap (mem);
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
+static gpointer
+unref_buffer_thread_func (gpointer data)
+{
+  gst_buffer_unref (GST_BUFFER_CAST (data));
+
+  return NULL;
+}
+
+/* small buffers freed by another thread are reused by the allocating one */
+GST_START_TEST (test_small_buffer_recycle)
+{
+  GstBuffer *buf;
+  GstMemory *mem;
+  GThread *thread;
+
+  buf = gst_buffer_new_and_alloc (200);
+  mem = gst_buffer_peek_memory (buf, 0);
+
+  thread = g_thread_new ("unref", unref_buffer_thread_func, buf);
+  g_thread_join (thread);
+
+  buf = gst_buffer_new_and_alloc (200);
+  fail_unless (gst_buffer_peek_memory (buf, 0) == mem);
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_wrapped_bytes)
 {
   GBytes *bytes = g_bytes_new_static (ro_memory, sizeof (ro_memory));
@@ -968,6 +1044,8 @@ gst_buffer_suite (void)
   tcase_add_test (tc_chain, test_fill);
   tcase_add_test (tc_chain, test_parent_buffer_meta);
   tcase_add_test (tc_chain, test_writable_memory);
+  tcase_add_test (tc_chain, test_small_buffer_memory);
+  tcase_add_test (tc_chain, test_small_buffer_recycle);
   tcase_add_test (tc_chain, test_wrapped_bytes);
   tcase_add_test (tc_chain, test_new_memdup);
 
@@ -336,6 +336,78 @@ GST_START_TEST (test_no_deadlock_for_buffer_discard)
 
 GST_END_TEST;
 
+static gpointer
+acquire_buf (gpointer p)
+{
+  GstBufferPool *pool = p;
+  GstBuffer *buf = NULL;
+  GstFlowReturn ret;
+
+  ret = gst_buffer_pool_acquire_buffer (pool, &buf, NULL);
+  if (buf)
+    gst_buffer_unref (buf);
+
+  return GINT_TO_POINTER (ret);
+}
+
+GST_START_TEST (test_release_wakes_up_waiting_acquire)
+{
+  GstBufferPool *pool;
+  GstBuffer *buf;
+  GThread *threads[4];
+  gint i;
+
+  pool = create_pool (10, 1, 1);
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf,
+          NULL) == GST_FLOW_OK);
+
+  /* all of them will block until the buffer is released */
+  for (i = 0; i < G_N_ELEMENTS (threads); i++)
+    threads[i] = g_thread_new (NULL, acquire_buf, pool);
+
+  g_usleep (G_USEC_PER_SEC / 100);
+  gst_buffer_unref (buf);
+
+  /* every thread releases the buffer again, so all of them get it in turn */
+  for (i = 0; i < G_N_ELEMENTS (threads); i++)
+    fail_unless_equals_int (GPOINTER_TO_INT (g_thread_join (threads[i])),
+        GST_FLOW_OK);
+
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_flushing_wakes_up_waiting_acquire)
+{
+  GstBufferPool *pool;
+  GstBuffer *buf;
+  GThread *thread;
+
+  pool = create_pool (10, 1, 1);
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf,
+          NULL) == GST_FLOW_OK);
+
+  /* blocks until we set the pool to flushing */
+  thread = g_thread_new (NULL, acquire_buf, pool);
+  g_usleep (G_USEC_PER_SEC / 100);
+  gst_buffer_pool_set_flushing (pool, TRUE);
+
+  fail_unless_equals_int (GPOINTER_TO_INT (g_thread_join (thread)),
+      GST_FLOW_FLUSHING);
+
+  gst_buffer_pool_set_flushing (pool, FALSE);
+  gst_buffer_unref (buf);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_buffer_pool_suite (void)
 {
@@ -355,6 +427,8 @@ gst_buffer_pool_suite (void)
   tcase_add_test (tc_chain, test_pool_config_validate);
   tcase_add_test (tc_chain, test_flushing_pool_returns_flushing);
   tcase_add_test (tc_chain, test_no_deadlock_for_buffer_discard);
+  tcase_add_test (tc_chain, test_release_wakes_up_waiting_acquire);
+  tcase_add_test (tc_chain, test_flushing_wakes_up_waiting_acquire);
 
   return s;
 }
@@ -457,6 +457,38 @@ message_check_func (GstBus * bus, GstMessage * message, gpointer data)
   check_messages_seen |= 1 << index;
 }
 
+/* test that the messages behind the one gst_bus_poll() returned stay on the
+ * bus */
+GST_START_TEST (test_poll_keeps_queued_messages)
+{
+  GstMessage *m;
+  guint i;
+
+  test_bus = gst_bus_new ();
+
+  send_10_app_messages ();
+
+  m = gst_bus_poll (test_bus, GST_MESSAGE_APPLICATION, GST_CLOCK_TIME_NONE);
+  fail_unless (m != NULL);
+  gst_message_unref (m);
+
+  for (i = 1; i < 10; i++) {
+    gint msg_id;
+
+    m = gst_bus_pop (test_bus);
+    fail_unless (m != NULL, "message %u was lost", i);
+    fail_unless (gst_structure_get_int (gst_message_get_structure (m),
+            "msg_id", &msg_id));
+    fail_unless_equals_int (msg_id, i);
+    gst_message_unref (m);
+  }
+  fail_if (gst_bus_have_pending (test_bus), "unexpected messages on bus");
+
+  gst_object_unref (test_bus);
+}
+
+GST_END_TEST;
+
 /* test that removing and adding the signal watch again works */
 GST_START_TEST (test_watch_twice)
 {
@@ -900,6 +932,163 @@ GST_START_TEST (test_async_message)
 
 GST_END_TEST;
 
+static GstMessage *
+new_level_message (GstObject * src, const gchar * name, gint value)
+{
+  return gst_message_new_element (src, gst_structure_new (name,
+          "value", G_TYPE_INT, value, NULL));
+}
+
+static gint
+get_level_value (GstMessage * message)
+{
+  gint value = -1;
+
+  gst_structure_get_int (gst_message_get_structure (message), "value", &value);
+  return value;
+}
+
+GST_START_TEST (test_coalesce)
+{
+  GstObject *src1, *src2;
+  GstMessage *message;
+
+  test_bus = gst_bus_new ();
+  src1 = (GstObject *) gst_pipeline_new ("src1");
+  src2 = (GstObject *) gst_pipeline_new ("src2");
+
+  gst_bus_set_coalesce_types (test_bus, GST_MESSAGE_ELEMENT);
+  fail_unless_equals_int (gst_bus_get_coalesce_types (test_bus),
+      GST_MESSAGE_ELEMENT);
+
+  gst_bus_post (test_bus, new_level_message (src1, "level", 1));
+  gst_bus_post (test_bus, new_level_message (src2, "level", 2));
+  gst_bus_post (test_bus, new_level_message (src1, "spectrum", 3));
+  gst_bus_post (test_bus, gst_message_new_eos (src1));
+  gst_bus_post (test_bus, gst_message_new_eos (src1));
+  gst_bus_post (test_bus, new_level_message (src1, "level", 4));
+  gst_bus_post (test_bus, new_level_message (src1, "level", 5));
+
+  /* peek sees the latest message */
+  message = gst_bus_peek (test_bus);
+  fail_unless_equals_int (get_level_value (message), 5);
+  gst_message_unref (message);
+
+  /* the latest level from src1 takes the place of the first one */
+  message = gst_bus_pop (test_bus);
+  fail_unless (GST_MESSAGE_SRC (message) == src1);
+  fail_unless (gst_message_has_name (message, "level"));
+  fail_unless_equals_int (get_level_value (message), 5);
+  gst_message_unref (message);
+
+  message = gst_bus_pop (test_bus);
+  fail_unless (GST_MESSAGE_SRC (message) == src2);
+  fail_unless_equals_int (get_level_value (message), 2);
+  gst_message_unref (message);
+
+  message = gst_bus_pop (test_bus);
+  fail_unless (gst_message_has_name (message, "spectrum"));
+  fail_unless_equals_int (get_level_value (message), 3);
+  gst_message_unref (message);
+
+  /* other types are not coalesced */
+  message = gst_bus_pop (test_bus);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (message), GST_MESSAGE_EOS);
+  gst_message_unref (message);
+  message = gst_bus_pop (test_bus);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (message), GST_MESSAGE_EOS);
+  gst_message_unref (message);
+
+  fail_if (gst_bus_have_pending (test_bus), "unexpected messages on bus");
+
+  /* once popped, a new message is queued again */
+  gst_bus_post (test_bus, new_level_message (src1, "level", 6));
+  message = gst_bus_pop (test_bus);
+  fail_unless_equals_int (get_level_value (message), 6);
+  gst_message_unref (message);
+
+  /* pending coalesced messages are released on dispose */
+  gst_bus_post (test_bus, new_level_message (src1, "level", 7));
+  gst_bus_post (test_bus, new_level_message (src1, "level", 8));
+
+  gst_object_unref (test_bus);
+  gst_object_unref (src1);
+  gst_object_unref (src2);
+}
+
+GST_END_TEST;
+
+#define MAX_DISPATCH_TEST_MESSAGES 100
+
+static gint dispatched;
+
+static gboolean
+count_messages_cb (GstBus * bus, GstMessage * message, gpointer data)
+{
+  dispatched++;
+  return TRUE;
+}
+
+GST_START_TEST (test_watch_dispatches_batch)
+{
+  GMainContext *ctx;
+  GSource *source;
+  guint i;
+
+  test_bus = gst_bus_new ();
+  ctx = g_main_context_new ();
+
+  source = gst_bus_create_watch (test_bus);
+  g_source_set_callback (source, (GSourceFunc) count_messages_cb, NULL, NULL);
+  g_source_attach (source, ctx);
+
+  /* without coalescing every message needs its own dispatch */
+  send_10_app_messages ();
+  dispatched = 0;
+  g_main_context_iteration (ctx, FALSE);
+  fail_unless_equals_int (dispatched, 1);
+  while (g_main_context_iteration (ctx, FALSE))
+    /* nothing */ ;
+  fail_unless_equals_int (dispatched, 10);
+
+  /* queued messages of coalesced types are handled in a single dispatch,
+   * distinct structure names keep them from being coalesced here */
+  gst_bus_set_coalesce_types (test_bus, GST_MESSAGE_APPLICATION);
+  for (i = 0; i < 10; i++)
+    gst_bus_post (test_bus, gst_message_new_application (NULL,
+            gst_structure_new_empty (i % 2 ? "test-odd" : "test-even")));
+  gst_bus_post (test_bus, gst_message_new_application (NULL,
+          gst_structure_new_empty ("test-last")));
+
+  dispatched = 0;
+  g_main_context_iteration (ctx, FALSE);
+  fail_unless_equals_int (dispatched, 3);
+  fail_if (gst_bus_have_pending (test_bus), "unexpected messages on bus");
+
+  for (i = 0; i < MAX_DISPATCH_TEST_MESSAGES; i++) {
+    gchar *name = g_strdup_printf ("test-%u", i);
+
+    gst_bus_post (test_bus, gst_message_new_application (NULL,
+            gst_structure_new_empty (name)));
+    g_free (name);
+  }
+
+  /* but a single dispatch is bounded */
+  dispatched = 0;
+  g_main_context_iteration (ctx, FALSE);
+  fail_unless (dispatched < MAX_DISPATCH_TEST_MESSAGES);
+  while (g_main_context_iteration (ctx, FALSE))
+    /* nothing */ ;
+  fail_unless_equals_int (dispatched, MAX_DISPATCH_TEST_MESSAGES);
+
+  g_source_destroy (source);
+  g_source_unref (source);
+  g_main_context_unref (ctx);
+  gst_object_unref (test_bus);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_single_gsource)
 {
   GstBus *bus = gst_bus_new ();
@@ -938,6 +1127,7 @@ gst_bus_suite (void)
   tcase_add_test (tc_chain, test_hammer_bus);
   tcase_add_test (tc_chain, test_watch);
   tcase_add_test (tc_chain, test_watch_with_poll);
+  tcase_add_test (tc_chain, test_poll_keeps_queued_messages);
   tcase_add_test (tc_chain, test_watch_twice);
   tcase_add_test (tc_chain, test_watch_with_custom_context);
   tcase_add_test (tc_chain, test_add_watch_with_custom_context);
@@ -949,6 +1139,8 @@ gst_bus_suite (void)
   tcase_add_test (tc_chain, test_custom_main_context);
   tcase_add_test (tc_chain, test_async_message);
   tcase_add_test (tc_chain, test_single_gsource);
+  tcase_add_test (tc_chain, test_coalesce);
+  tcase_add_test (tc_chain, test_watch_dispatches_batch);
   return s;
 }
 
@@ -1842,6 +1842,135 @@ GST_START_TEST (test_fixed)
 
 GST_END_TEST;
 
+/* must match the GST_CAPS_CACHE_SIZE set in main() */
+#define CAPS_CACHE_SIZE 4
+
+/* returns @caps with an extra ref so that it is not writable and thus
+ * considered by the caps cache */
+static GstCaps *
+shared_caps_from_string (const gchar * str)
+{
+  return gst_caps_ref (gst_caps_from_string (str));
+}
+
+static void
+unref_shared_caps (GstCaps * caps)
+{
+  gst_caps_unref (caps);
+  gst_caps_unref (caps);
+}
+
+GST_START_TEST (test_cache_hit)
+{
+  GstCaps *caps1, *caps2, *res1, *res2;
+
+  caps1 = shared_caps_from_string ("video/x-raw, format = (string) I420, "
+      "width = (int) [ 1, 100 ]");
+  caps2 = shared_caps_from_string ("video/x-raw, width = (int) 50");
+
+  res1 = gst_caps_intersect (caps1, caps2);
+  /* the cache entry keeps a ref on both inputs */
+  ASSERT_CAPS_REFCOUNT (caps1, "caps1", 3);
+  ASSERT_CAPS_REFCOUNT (caps2, "caps2", 3);
+
+  /* served from the cache, no new entry is added */
+  res2 = gst_caps_intersect (caps1, caps2);
+  ASSERT_CAPS_REFCOUNT (caps1, "caps1", 3);
+  ASSERT_CAPS_REFCOUNT (caps2, "caps2", 3);
+
+  fail_unless (res1 != res2);
+  fail_unless (gst_caps_is_writable (res2));
+  fail_unless (gst_caps_is_equal (res1, res2));
+
+  /* the other operations are cached as well */
+  fail_unless (gst_caps_can_intersect (caps1, caps2));
+  fail_unless (gst_caps_can_intersect (caps1, caps2));
+  fail_if (gst_caps_is_subset (caps1, caps2));
+  fail_if (gst_caps_is_subset (caps1, caps2));
+  ASSERT_CAPS_REFCOUNT (caps1, "caps1", 5);
+
+  gst_caps_unref (res1);
+  gst_caps_unref (res2);
+  unref_shared_caps (caps1);
+  unref_shared_caps (caps2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_cache_eviction)
+{
+  GstCaps *caps1, *others[CAPS_CACHE_SIZE], *res;
+  gint i;
+
+  caps1 = shared_caps_from_string ("audio/x-raw, rate = (int) [ 1, 96000 ]");
+  for (i = 0; i < CAPS_CACHE_SIZE; i++) {
+    gchar *str = g_strdup_printf ("audio/x-raw, rate = (int) %d",
+        8000 * (i + 1));
+
+    others[i] = shared_caps_from_string (str);
+    g_free (str);
+  }
+
+  res = gst_caps_intersect (caps1, others[0]);
+  gst_caps_unref (res);
+  ASSERT_CAPS_REFCOUNT (others[0], "others[0]", 3);
+
+  /* the cache is a ring, the first entry survives until it is full */
+  for (i = 1; i < CAPS_CACHE_SIZE; i++) {
+    res = gst_caps_intersect (caps1, others[i]);
+    gst_caps_unref (res);
+  }
+  ASSERT_CAPS_REFCOUNT (others[0], "others[0]", 3);
+  ASSERT_CAPS_REFCOUNT (caps1, "caps1", 2 + CAPS_CACHE_SIZE);
+
+  /* one more operation evicts the oldest entry and drops its refs */
+  fail_unless (gst_caps_can_intersect (caps1, others[1]));
+  ASSERT_CAPS_REFCOUNT (others[0], "others[0]", 2);
+  ASSERT_CAPS_REFCOUNT (caps1, "caps1", 2 + CAPS_CACHE_SIZE);
+
+  /* and the evicted operation is computed and stored again */
+  res = gst_caps_intersect (caps1, others[0]);
+  fail_unless_equals_int (gst_caps_get_size (res), 1);
+  gst_caps_unref (res);
+  ASSERT_CAPS_REFCOUNT (others[0], "others[0]", 3);
+
+  for (i = 0; i < CAPS_CACHE_SIZE; i++)
+    unref_shared_caps (others[i]);
+  unref_shared_caps (caps1);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_cache_result_writable)
+{
+  GstCaps *caps1, *caps2, *expected, *res;
+
+  caps1 = shared_caps_from_string ("video/x-raw, format = (string) { I420, "
+      "NV12 }, width = (int) 320");
+  caps2 = shared_caps_from_string ("video/x-raw, format = (string) NV12");
+  expected = gst_caps_from_string ("video/x-raw, format = (string) NV12, "
+      "width = (int) 320");
+
+  res = gst_caps_intersect (caps1, caps2);
+  fail_unless (gst_caps_is_equal (res, expected));
+
+  /* modifying the returned caps must not change the cached result */
+  fail_unless (gst_caps_is_writable (res));
+  gst_caps_set_simple (res, "format", G_TYPE_STRING, "YUY2",
+      "height", G_TYPE_INT, 240, NULL);
+  gst_caps_unref (res);
+
+  res = gst_caps_intersect (caps1, caps2);
+  fail_unless (gst_caps_is_equal (res, expected));
+  gst_caps_unref (res);
+
+  gst_caps_unref (expected);
+  unref_shared_caps (caps1);
+  unref_shared_caps (caps2);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_caps_suite (void)
 {
@@ -1880,8 +2009,26 @@ gst_caps_suite (void)
   tcase_add_test (tc_chain, test_equality);
   tcase_add_test (tc_chain, test_remains_any);
   tcase_add_test (tc_chain, test_fixed);
+  tcase_add_test (tc_chain, test_cache_hit);
+  tcase_add_test (tc_chain, test_cache_eviction);
+  tcase_add_test (tc_chain, test_cache_result_writable);
 
   return s;
 }
 
-GST_CHECK_MAIN (gst_caps);
+/* Replacement for GST_CHECK_MAIN (gst_caps); because the caps cache size
+ * is read from the env when gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+  gchar *size;
+
+  size = g_strdup_printf ("%d", CAPS_CACHE_SIZE);
+  g_setenv ("GST_CAPS_CACHE_SIZE", size, TRUE);
+  g_free (size);
+
+  gst_check_init (&argc, &argv);
+  s = gst_caps_suite ();
+  return gst_check_run_suite (s, "gst_caps", __FILE__);
+}
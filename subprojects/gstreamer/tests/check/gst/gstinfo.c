@@ -519,6 +519,241 @@ GST_START_TEST (info_post_gst_init_category_registration)
 
 GST_END_TEST;
 
+static gboolean
+find_bytes (const guint8 * data, gsize size, const gchar * str)
+{
+  gsize i, len = strlen (str);
+
+  for (i = 0; i + len <= size; i++) {
+    if (memcmp (data + i, str, len) == 0)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+GST_START_TEST (info_log_binary)
+{
+  FILE *file;
+  GstCaps *caps;
+  guint8 data[4096];
+  gsize size;
+
+  file = tmpfile ();
+  fail_unless (file != NULL);
+
+  gst_debug_remove_log_function (gst_debug_log_default);
+  gst_debug_add_log_function (gst_debug_log_binary, file, NULL);
+  gst_debug_set_default_threshold (GST_LEVEL_LOG);
+
+  caps = gst_caps_new_empty_simple ("binary/x-test");
+  GST_DEBUG ("raw %d %s %" G_GUINT64_FORMAT " %.2f", 42, "argument",
+      G_GUINT64_CONSTANT (1234567890123), 0.5);
+  GST_DEBUG ("formatted %" GST_PTR_FORMAT, caps);
+  gst_caps_unref (caps);
+
+  /* removing the log function writes out the pending messages */
+  gst_debug_set_default_threshold (GST_LEVEL_NONE);
+  gst_debug_remove_log_function (gst_debug_log_binary);
+  gst_debug_add_log_function (gst_debug_log_default, NULL, NULL);
+
+  rewind (file);
+  size = fread (data, 1, sizeof (data), file);
+  fclose (file);
+
+  fail_unless (size > 8);
+  fail_unless (memcmp (data, "GSTBLOG", 8) == 0);
+  /* format strings and string arguments are stored as is */
+  fail_unless (find_bytes (data, size, "raw %d %s %"));
+  fail_unless (find_bytes (data, size, "argument"));
+  fail_unless (find_bytes (data, size, "info_log_binary"));
+  /* the number was not formatted */
+  fail_if (find_bytes (data, size, "1234567890123"));
+  /* messages using printf extensions are formatted right away */
+  fail_unless (find_bytes (data, size, "formatted binary/x-test"));
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  const guint8 *data;
+  gsize size;
+  gsize pos;
+} BinaryLogReader;
+
+static void
+binary_log_read (BinaryLogReader * r, gpointer dest, gsize len)
+{
+  fail_unless (r->pos + len <= r->size);
+  memcpy (dest, r->data + r->pos, len);
+  r->pos += len;
+}
+
+static gchar *
+binary_log_read_string (BinaryLogReader * r)
+{
+  guint32 len;
+  gchar *str;
+
+  binary_log_read (r, &len, sizeof (len));
+  if (len == G_MAXUINT32)
+    return NULL;
+  str = g_malloc (len + 1);
+  binary_log_read (r, str, len);
+  str[len] = '\0';
+
+  return str;
+}
+
+/* Decodes the messages logged from @file in a binary log, returns a list of
+ * "format|args" strings with the arguments as "<type>:<value>" separated by
+ * '|' */
+static GList *
+binary_log_decode (const guint8 * data, gsize size, const gchar * file)
+{
+  BinaryLogReader r = { data, size, 20 };
+  GHashTable *strings;
+  GList *messages = NULL;
+
+  fail_unless (size >= 20);
+  fail_unless (memcmp (data, "GSTBLOG", 8) == 0);
+
+  strings = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+  while (r.pos < r.size) {
+    guint8 tag, level, type;
+    guint32 id, ids[4], n_args, i;
+    guint64 u64;
+    GString *msg;
+
+    binary_log_read (&r, &tag, 1);
+    if (tag == 'S') {
+      binary_log_read (&r, &id, sizeof (id));
+      g_hash_table_insert (strings, GUINT_TO_POINTER (id),
+          binary_log_read_string (&r));
+      continue;
+    }
+    fail_unless_equals_int (tag, 'M');
+
+    /* elapsed time, thread */
+    binary_log_read (&r, &u64, sizeof (u64));
+    binary_log_read (&r, &u64, sizeof (u64));
+    binary_log_read (&r, &level, 1);
+    /* category, file, function, line */
+    binary_log_read (&r, ids, sizeof (ids));
+    fail_unless (g_hash_table_contains (strings, GUINT_TO_POINTER (ids[0])));
+    fail_unless (g_hash_table_contains (strings, GUINT_TO_POINTER (ids[1])));
+    fail_unless (g_hash_table_contains (strings, GUINT_TO_POINTER (ids[2])));
+    g_free (binary_log_read_string (&r));
+
+    binary_log_read (&r, &id, sizeof (id));
+    binary_log_read (&r, &n_args, sizeof (n_args));
+    msg = g_string_new (id ? g_hash_table_lookup (strings,
+            GUINT_TO_POINTER (id)) : "");
+    fail_unless (id == 0 || g_hash_table_contains (strings,
+            GUINT_TO_POINTER (id)));
+
+    for (i = 0; i < n_args; i++) {
+      binary_log_read (&r, &type, 1);
+      switch (type) {
+        case 'i':{
+          gint64 val;
+
+          binary_log_read (&r, &val, sizeof (val));
+          g_string_append_printf (msg, "|i:%" G_GINT64_FORMAT, val);
+          break;
+        }
+        case 'u':
+        case 'p':
+          binary_log_read (&r, &u64, sizeof (u64));
+          g_string_append_printf (msg, "|%c:%" G_GUINT64_FORMAT, type, u64);
+          break;
+        case 'd':{
+          gdouble val;
+
+          binary_log_read (&r, &val, sizeof (val));
+          g_string_append_printf (msg, "|d:%g", val);
+          break;
+        }
+        case 's':{
+          gchar *str = binary_log_read_string (&r);
+
+          g_string_append_printf (msg, "|s:%s", str ? str : "(NULL)");
+          g_free (str);
+          break;
+        }
+        default:
+          fail ("unknown argument type %c", type);
+          break;
+      }
+    }
+    if (g_strcmp0 (g_hash_table_lookup (strings, GUINT_TO_POINTER (ids[1])),
+            file) == 0)
+      messages = g_list_append (messages, g_string_free (msg, FALSE));
+    else
+      g_string_free (msg, TRUE);
+  }
+  g_hash_table_unref (strings);
+
+  return messages;
+}
+
+GST_START_TEST (info_log_binary_decode)
+{
+  FILE *file;
+  const gchar unterminated[4] = { 'a', 'b', 'c', 'd' };
+  gchar *format;
+  guint8 data[4096];
+  gsize size;
+  GList *messages, *l;
+
+  file = tmpfile ();
+  fail_unless (file != NULL);
+
+  gst_debug_remove_log_function (gst_debug_log_default);
+  gst_debug_add_log_function (gst_debug_log_binary, file, NULL);
+  gst_debug_set_default_threshold (GST_LEVEL_LOG);
+
+  GST_DEBUG ("raw %d %s %" G_GUINT64_FORMAT " %.2f", 42, "argument",
+      G_GUINT64_CONSTANT (1234567890123), 0.5);
+  /* strings with a precision don't need to be NUL-terminated */
+  GST_DEBUG ("bounded %.*s %.3s", 2, unterminated, unterminated);
+  GST_DEBUG ("short %.10s", "abc");
+
+  /* formats that don't outlive the call and might end up at the same
+   * address */
+  format = g_strdup ("heap one %d");
+  call_GST_INFO (format, 1);
+  g_free (format);
+  format = g_strdup ("heap two %d");
+  call_GST_INFO (format, 2);
+  g_free (format);
+
+  gst_debug_set_default_threshold (GST_LEVEL_NONE);
+  gst_debug_remove_log_function (gst_debug_log_binary);
+  gst_debug_add_log_function (gst_debug_log_default, NULL, NULL);
+
+  rewind (file);
+  size = fread (data, 1, sizeof (data), file);
+  fclose (file);
+
+  messages = binary_log_decode (data, size, __FILE__);
+  fail_unless_equals_int (g_list_length (messages), 5);
+  l = messages;
+  fail_unless_equals_string (l->data, "raw %d %s %" G_GUINT64_FORMAT
+      " %.2f|i:42|s:argument|u:1234567890123|d:0.5");
+  l = l->next;
+  fail_unless_equals_string (l->data, "bounded %.*s %.3s|i:2|s:ab|s:abc");
+  l = l->next;
+  fail_unless_equals_string (l->data, "short %.10s|s:abc");
+  l = l->next;
+  fail_unless_equals_string (l->data, "heap one %d|i:1");
+  l = l->next;
+  fail_unless_equals_string (l->data, "heap two %d|i:2");
+  g_list_free_full (messages, g_free);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_info_suite (void)
 {
@@ -541,6 +776,8 @@ gst_info_suite (void)
   tcase_add_test (tc_chain, info_set_and_unset_single);
   tcase_add_test (tc_chain, info_set_and_unset_multiple);
   tcase_add_test (tc_chain, info_post_gst_init_category_registration);
+  tcase_add_test (tc_chain, info_log_binary);
+  tcase_add_test (tc_chain, info_log_binary_decode);
 #endif
 
   return s;
@@ -738,6 +738,68 @@ GST_START_TEST (test_meta_custom)
 
 GST_END_TEST;
 
+GST_START_TEST (test_meta_get_many)
+{
+  GstBuffer *buffer, *copy;
+  const GstMetaInfo *infos[8];
+  GstMeta *metas[8][2];
+  GType api;
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (infos); i++) {
+    gchar *name = g_strdup_printf ("test-get-many-%u", i);
+
+    infos[i] = gst_meta_register_custom (name, NULL, NULL, NULL, NULL);
+    fail_unless (infos[i] != NULL);
+    g_free (name);
+  }
+
+  buffer = gst_buffer_new_and_alloc (4);
+
+  /* more metas than can be stored inline, several of each API */
+  for (i = 0; i < G_N_ELEMENTS (infos); i++)
+    metas[i][0] = gst_buffer_add_meta (buffer, infos[i], NULL);
+  for (i = 0; i < G_N_ELEMENTS (infos); i++)
+    metas[i][1] = gst_buffer_add_meta (buffer, infos[i], NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (infos); i++)
+    fail_unless (gst_buffer_get_meta (buffer, infos[i]->api) == metas[i][0]);
+
+  api = gst_meta_api_type_register ("test-get-many-none-api", NULL);
+  fail_unless (gst_buffer_get_meta (buffer, api) == NULL);
+
+  /* removing the first meta of an API must expose the second one */
+  for (i = 0; i < G_N_ELEMENTS (infos); i += 2) {
+    fail_unless (gst_buffer_remove_meta (buffer, metas[i][0]));
+    fail_unless (gst_buffer_get_meta (buffer, infos[i]->api) == metas[i][1]);
+  }
+  for (i = 1; i < G_N_ELEMENTS (infos); i += 2)
+    fail_unless (gst_buffer_get_meta (buffer, infos[i]->api) == metas[i][0]);
+
+  /* slots freed by removed metas get reused */
+  for (i = 0; i < G_N_ELEMENTS (infos); i += 2) {
+    fail_unless (gst_buffer_remove_meta (buffer, metas[i][1]));
+    fail_unless (gst_buffer_get_meta (buffer, infos[i]->api) == NULL);
+    metas[i][0] = gst_buffer_add_meta (buffer, infos[i], NULL);
+    fail_unless (gst_buffer_get_meta (buffer, infos[i]->api) == metas[i][0]);
+  }
+
+  copy = gst_buffer_copy (buffer);
+  for (i = 0; i < G_N_ELEMENTS (infos); i++) {
+    GstMeta *meta = gst_buffer_get_meta (copy, infos[i]->api);
+
+    fail_unless (meta != NULL);
+    fail_unless (meta->info == infos[i]);
+  }
+  fail_unless_equals_int (count_buffer_meta (copy),
+      count_buffer_meta (buffer));
+
+  gst_buffer_unref (copy);
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
 static gboolean
 transform_custom (GstBuffer * transbuf, GstMeta * meta, GstBuffer * buffer,
     GQuark type, gpointer data, gint * user_data)
@@ -815,6 +877,7 @@ gst_buffermeta_suite (void)
   tcase_add_test (tc_chain, test_meta_iterate);
   tcase_add_test (tc_chain, test_meta_seqnum);
   tcase_add_test (tc_chain, test_meta_custom);
+  tcase_add_test (tc_chain, test_meta_get_many);
   tcase_add_test (tc_chain, test_meta_custom_transform);
 
   return s;
@@ -1666,6 +1666,129 @@ GST_START_TEST (test_pad_probe_pull_idle)
 GST_END_TEST;
 
 
+static GstFlowReturn
+idle_add_from_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
+{
+  GstPad *srcpad = GST_PAD_PEER (pad);
+
+  /* the upstream pad is still pushing, the idle probe must be delayed */
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_IDLE, idle_cb_return_ok,
+      NULL, NULL);
+  fail_if (idle_probe_called);
+
+  gst_buffer_unref (buf);
+  return GST_FLOW_OK;
+}
+
+GST_START_TEST (test_pad_probe_idle_added_during_push)
+{
+  GstPad *srcpad, *sinkpad;
+  GstSegment dummy_segment;
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  fail_unless (srcpad != NULL);
+  sinkpad = gst_pad_new ("sink", GST_PAD_SINK);
+  fail_unless (sinkpad != NULL);
+
+  gst_pad_set_chain_function (sinkpad, idle_add_from_chain);
+  fail_unless (gst_pad_link (srcpad, sinkpad) == GST_PAD_LINK_OK);
+
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_segment_init (&dummy_segment, GST_FORMAT_BYTES);
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_stream_start ("test")) == TRUE);
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_segment (&dummy_segment)) == TRUE);
+
+  /* no probes and no pending events, this goes through the probe-free
+   * push path and must still call the idle probe once the push is done */
+  idle_probe_called = FALSE;
+  fail_unless (gst_pad_push (srcpad, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless (idle_probe_called);
+
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+}
+
+GST_END_TEST;
+
+
+#define N_IDLE_PROBES 1000
+
+static gint idle_probe_calls[N_IDLE_PROBES];
+
+static GstPadProbeReturn
+idle_cb_count_remove (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  g_atomic_int_inc (&idle_probe_calls[GPOINTER_TO_INT (user_data)]);
+  return GST_PAD_PROBE_REMOVE;
+}
+
+static gpointer
+push_buffers_async (GstPad * pad)
+{
+  gint i;
+
+  for (i = 0; i < 10000; i++)
+    fail_unless (gst_pad_push (pad, gst_buffer_new ()) == GST_FLOW_OK);
+
+  return NULL;
+}
+
+GST_START_TEST (test_pad_probe_idle_added_while_pushing)
+{
+  GstPad *srcpad, *sinkpad;
+  GstSegment dummy_segment;
+  GThread *thread;
+  gint i;
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  fail_unless (srcpad != NULL);
+  sinkpad = gst_pad_new ("sink", GST_PAD_SINK);
+  fail_unless (sinkpad != NULL);
+
+  gst_pad_set_chain_function (sinkpad, gst_check_chain_func);
+  fail_unless (gst_pad_link (srcpad, sinkpad) == GST_PAD_LINK_OK);
+
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_segment_init (&dummy_segment, GST_FORMAT_BYTES);
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_stream_start ("test")) == TRUE);
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_segment (&dummy_segment)) == TRUE);
+
+  /* the idle probes remove themselves, so the pushes keep going through the
+   * probe-free push path while they are added. Each of them must be called
+   * exactly once, either from gst_pad_add_probe() or after a push */
+  thread = g_thread_try_new ("gst-check", (GThreadFunc) push_buffers_async,
+      srcpad, NULL);
+  for (i = 0; i < N_IDLE_PROBES; i++) {
+    idle_probe_calls[i] = 0;
+    gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_IDLE, idle_cb_count_remove,
+        GINT_TO_POINTER (i), NULL);
+  }
+  g_thread_join (thread);
+
+  for (i = 0; i < N_IDLE_PROBES; i++)
+    fail_unless_equals_int (g_atomic_int_get (&idle_probe_calls[i]), 1);
+
+  gst_check_drop_buffers ();
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+}
+
+GST_END_TEST;
+
+
 GST_START_TEST (test_pad_probe_pull_buffer)
 {
   GstPad *srcpad, *sinkpad;
@@ -3410,6 +3533,8 @@ gst_pad_suite (void)
   tcase_add_test (tc_chain, test_pad_blocking_with_probe_type_idle);
   tcase_add_test (tc_chain, test_pad_probe_pull);
   tcase_add_test (tc_chain, test_pad_probe_pull_idle);
+  tcase_add_test (tc_chain, test_pad_probe_idle_added_during_push);
+  tcase_add_test (tc_chain, test_pad_probe_idle_added_while_pushing);
   tcase_add_test (tc_chain, test_pad_probe_pull_buffer);
   tcase_add_test (tc_chain, test_pad_probe_remove);
   tcase_add_test (tc_chain, test_pad_disjoint_blocks_probe_remove);
@@ -737,6 +737,132 @@ GST_START_TEST (test_pipeline_processing_deadline_no_queue)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pipeline_task_pool)
+{
+  GstElement *pipeline, *fakesrc, *fakesink;
+  GstTaskPool *pool, *task_pool;
+  GstPad *srcpad;
+  GError *err = NULL;
+
+  pool = gst_task_pool_new ();
+  gst_task_pool_prepare (pool, &err);
+  fail_unless (err == NULL);
+
+  pipeline = gst_element_factory_make ("pipeline", "pipeline");
+  fakesrc = gst_element_factory_make ("fakesrc", "fakesrc");
+  fakesink = gst_element_factory_make ("fakesink", "fakesink");
+  fail_unless (pipeline && fakesrc && fakesink);
+
+  fail_unless (gst_pipeline_get_task_pool (GST_PIPELINE (pipeline)) == NULL);
+  g_object_set (pipeline, "task-pool", pool, NULL);
+  task_pool = gst_pipeline_get_task_pool (GST_PIPELINE (pipeline));
+  fail_unless (task_pool == pool);
+  gst_object_unref (task_pool);
+
+  gst_bin_add_many (GST_BIN (pipeline), fakesrc, fakesink, NULL);
+  fail_unless (gst_element_link (fakesrc, fakesink));
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_PAUSED),
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL, -1),
+      GST_STATE_CHANGE_SUCCESS);
+
+  srcpad = gst_element_get_static_pad (fakesrc, "src");
+  GST_OBJECT_LOCK (srcpad);
+  fail_unless (GST_PAD_TASK (srcpad) != NULL);
+  task_pool = gst_task_get_pool (GST_PAD_TASK (srcpad));
+  GST_OBJECT_UNLOCK (srcpad);
+  fail_unless (task_pool == pool);
+  gst_object_unref (task_pool);
+  gst_object_unref (srcpad);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
+static guint *
+get_src_task_affinity (GstElement * element, guint * n_cpus)
+{
+  GstPad *srcpad;
+  guint *cpus;
+
+  srcpad = gst_element_get_static_pad (element, "src");
+  GST_OBJECT_LOCK (srcpad);
+  fail_unless (GST_PAD_TASK (srcpad) != NULL);
+  cpus = gst_task_get_cpu_affinity (GST_PAD_TASK (srcpad), n_cpus);
+  GST_OBJECT_UNLOCK (srcpad);
+  gst_object_unref (srcpad);
+
+  return cpus;
+}
+
+GST_START_TEST (test_pipeline_task_affinity)
+{
+  GstElement *pipeline, *src0, *src1, *sink0, *sink1;
+  const guint cpus0[] = { 0 };
+  const guint cpus1[] = { 0, 1 };
+  guint *cpus, n_cpus;
+
+  pipeline = gst_element_factory_make ("pipeline", "pipeline");
+  src0 = gst_element_factory_make ("fakesrc", "src0");
+  src1 = gst_element_factory_make ("fakesrc", "src1");
+  sink0 = gst_element_factory_make ("fakesink", "sink0");
+  sink1 = gst_element_factory_make ("fakesink", "sink1");
+  fail_unless (pipeline && src0 && src1 && sink0 && sink1);
+
+  gst_bin_add_many (GST_BIN (pipeline), src0, src1, sink0, sink1, NULL);
+  fail_unless (gst_element_link (src0, sink0));
+  fail_unless (gst_element_link (src1, sink1));
+
+  /* the pad pattern was added last and takes precedence over the factory
+   * pattern for src0 */
+  gst_pipeline_add_task_affinity (GST_PIPELINE (pipeline), "fakesrc", cpus1,
+      G_N_ELEMENTS (cpus1));
+  gst_pipeline_add_task_affinity (GST_PIPELINE (pipeline), "src0:s*", cpus0,
+      G_N_ELEMENTS (cpus0));
+  gst_pipeline_add_task_affinity (GST_PIPELINE (pipeline), "sink*", cpus0,
+      G_N_ELEMENTS (cpus0));
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_PAUSED),
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL, -1),
+      GST_STATE_CHANGE_SUCCESS);
+
+  cpus = get_src_task_affinity (src0, &n_cpus);
+  fail_unless_equals_int (n_cpus, 1);
+  fail_unless_equals_int (cpus[0], 0);
+  g_free (cpus);
+
+  cpus = get_src_task_affinity (src1, &n_cpus);
+  fail_unless_equals_int (n_cpus, 2);
+  fail_unless_equals_int (cpus[0], 0);
+  fail_unless_equals_int (cpus[1], 1);
+  g_free (cpus);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+
+  /* cleared policies are not applied to new tasks anymore */
+  gst_pipeline_clear_task_affinities (GST_PIPELINE (pipeline));
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_PAUSED),
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL, -1),
+      GST_STATE_CHANGE_SUCCESS);
+
+  cpus = get_src_task_affinity (src0, &n_cpus);
+  fail_unless_equals_int (n_cpus, 0);
+  fail_unless (cpus == NULL);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 gst_pipeline_suite (void)
@@ -758,6 +884,8 @@ gst_pipeline_suite (void)
   tcase_add_test (tc_chain, test_pipeline_reset_start_time);
   tcase_add_test (tc_chain, test_pipeline_processing_deadline);
   tcase_add_test (tc_chain, test_pipeline_processing_deadline_no_queue);
+  tcase_add_test (tc_chain, test_pipeline_task_pool);
+  tcase_add_test (tc_chain, test_pipeline_task_affinity);
 
   return s;
 }
@@ -160,6 +160,75 @@ delayed_stop (gpointer data)
   return NULL;
 }
 
+#ifndef G_OS_WIN32
+#define N_MANY_FDS 80
+
+/* with many fds the set is waited on with epoll where available, check that
+ * an fd number that gets closed and reused between two waits is still
+ * watched */
+GST_START_TEST (test_poll_many_fds)
+{
+  GstPoll *set;
+  gint fds[N_MANY_FDS][2];
+  GstPollFD pfds[N_MANY_FDS];
+  gchar c = 'x';
+  gint i;
+
+  set = gst_poll_new (FALSE);
+  fail_if (set == NULL, "Failed to create a GstPoll");
+
+  for (i = 0; i < N_MANY_FDS; i++) {
+    fail_if (socketpair (PF_UNIX, SOCK_STREAM, 0, fds[i]) < 0,
+        "Could not create socket pair");
+    gst_poll_fd_init (&pfds[i]);
+    pfds[i].fd = fds[i][0];
+    fail_unless (gst_poll_add_fd (set, &pfds[i]), "Could not add descriptor");
+    fail_unless (gst_poll_fd_ctl_read (set, &pfds[i], TRUE),
+        "Could not mark the descriptor as readable");
+  }
+
+  fail_unless (gst_poll_wait (set, 0) == 0, "Waiting did not timeout");
+
+  fail_unless (write (fds[5][1], &c, 1) == 1);
+  fail_unless (gst_poll_wait (set, GST_SECOND) == 1, "Waiting failed");
+  fail_unless (gst_poll_fd_can_read (set, &pfds[5]),
+      "Descriptor should be readable");
+  fail_unless (read (fds[5][0], &c, 1) == 1);
+
+  fail_unless (gst_poll_wait (set, 0) == 0, "Waiting did not timeout");
+
+  /* close and replace a socket pair without waiting in between, the new
+   * sockets usually get the same numbers */
+  fail_unless (gst_poll_remove_fd (set, &pfds[7]),
+      "Could not remove descriptor");
+  close (fds[7][0]);
+  close (fds[7][1]);
+  fail_if (socketpair (PF_UNIX, SOCK_STREAM, 0, fds[7]) < 0,
+      "Could not create socket pair");
+  gst_poll_fd_init (&pfds[7]);
+  pfds[7].fd = fds[7][0];
+  fail_unless (gst_poll_add_fd (set, &pfds[7]), "Could not add descriptor");
+  fail_unless (gst_poll_fd_ctl_read (set, &pfds[7], TRUE),
+      "Could not mark the descriptor as readable");
+
+  fail_unless (write (fds[7][1], &c, 1) == 1);
+  fail_unless (gst_poll_wait (set, GST_SECOND) == 1, "Waiting failed");
+  fail_unless (gst_poll_fd_can_read (set, &pfds[7]),
+      "Descriptor should be readable");
+  fail_if (gst_poll_fd_can_read (set, &pfds[5]),
+      "Descriptor should not be readable");
+
+  gst_poll_free (set);
+
+  for (i = 0; i < N_MANY_FDS; i++) {
+    close (fds[i][0]);
+    close (fds[i][1]);
+  }
+}
+
+GST_END_TEST;
+#endif
+
 GST_START_TEST (test_poll_wait_stop)
 {
   GstPoll *set;
@@ -339,6 +408,7 @@ gst_poll_suite (void)
 #ifndef G_OS_WIN32
   tcase_add_test (tc_chain, test_poll_basic);
   tcase_add_test (tc_chain, test_poll_wait);
+  tcase_add_test (tc_chain, test_poll_many_fds);
   tcase_add_test (tc_chain, test_poll_wait_stop);
   tcase_add_test (tc_chain, test_poll_wait_restart);
   tcase_add_test (tc_chain, test_poll_wait_flush);
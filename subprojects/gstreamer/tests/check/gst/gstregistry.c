@@ -203,6 +203,62 @@ GST_START_TEST (test_registry_update)
 
 GST_END_TEST;
 
+/* Features loaded from the registry cache only parse their metadata and caps
+ * on first use, make sure they are still all available */
+GST_START_TEST (test_registry_lazy_features)
+{
+  GstElementFactory *factory;
+  GList *features, *l;
+
+  features = gst_element_factory_list_get_elements
+      (GST_ELEMENT_FACTORY_TYPE_ANY, GST_RANK_NONE);
+  fail_unless (features != NULL);
+
+  for (l = features; l; l = l->next) {
+    GstElementFactory *f = GST_ELEMENT_FACTORY (l->data);
+    const GList *templates;
+    gchar **keys;
+
+    fail_unless (gst_element_factory_get_metadata (f,
+            GST_ELEMENT_METADATA_LONGNAME) != NULL);
+    fail_unless (gst_element_factory_get_metadata (f,
+            GST_ELEMENT_METADATA_KLASS) != NULL);
+    keys = gst_element_factory_get_metadata_keys (f);
+    fail_unless (keys != NULL);
+    g_strfreev (keys);
+
+    templates = gst_element_factory_get_static_pad_templates (f);
+    for (; templates; templates = templates->next) {
+      GstStaticPadTemplate *templ = templates->data;
+      GstCaps *caps;
+
+      fail_unless (templ->name_template != NULL);
+      caps = gst_static_pad_template_get_caps (templ);
+      fail_unless (caps != NULL);
+      gst_caps_unref (caps);
+    }
+  }
+  gst_plugin_feature_list_free (features);
+
+  factory = gst_element_factory_find ("fakesrc");
+  fail_unless (factory != NULL);
+  fail_unless_equals_string (gst_element_factory_get_metadata (factory,
+          GST_ELEMENT_METADATA_LONGNAME), "Fake Source");
+  gst_object_unref (factory);
+
+  features = gst_type_find_factory_get_list ();
+  for (l = features; l; l = l->next) {
+    GstTypeFindFactory *f = GST_TYPE_FIND_FACTORY (l->data);
+    GstCaps *caps = gst_type_find_factory_get_caps (f);
+
+    /* parsed once and then kept */
+    fail_unless (gst_type_find_factory_get_caps (f) == caps);
+  }
+  gst_plugin_feature_list_free (features);
+}
+
+GST_END_TEST;
+
 static Suite *
 registry_suite (void)
 {
@@ -212,6 +268,7 @@ registry_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_registry_update);
+  tcase_add_test (tc_chain, test_registry_lazy_features);
 
   return s;
 }
@@ -1018,6 +1018,49 @@ GST_START_TEST (test_flagset)
 
 GST_END_TEST;
 
+/* well-known structures built in an unusual order must still work */
+GST_START_TEST (test_well_known_field_order)
+{
+  GstStructure *s;
+  gint val;
+
+  s = gst_structure_new ("video/x-raw", "height", G_TYPE_INT, 480,
+      "foo", G_TYPE_INT, 1, "width", G_TYPE_INT, 640, NULL);
+
+  fail_unless (gst_structure_get_int (s, "width", &val));
+  fail_unless_equals_int (val, 640);
+  fail_unless (gst_structure_get_int (s, "height", &val));
+  fail_unless_equals_int (val, 480);
+  fail_unless (gst_structure_get_int (s, "foo", &val));
+  fail_unless_equals_int (val, 1);
+  fail_if (gst_structure_has_field (s, "format"));
+
+  /* replace a field in place */
+  gst_structure_set (s, "width", G_TYPE_INT, 320, NULL);
+  fail_unless_equals_int (gst_structure_n_fields (s), 3);
+  fail_unless (gst_structure_get_int (s, "width", &val));
+  fail_unless_equals_int (val, 320);
+
+  gst_structure_remove_field (s, "height");
+  fail_if (gst_structure_has_field (s, "height"));
+  fail_unless (gst_structure_get_int (s, "width", &val));
+  fail_unless_equals_int (val, 320);
+
+  /* renaming changes the expected layout */
+  gst_structure_set_name (s, "audio/x-raw");
+  gst_structure_set (s, "format", G_TYPE_STRING, "S16LE", "rate", G_TYPE_INT,
+      48000, NULL);
+  fail_unless_equals_string (gst_structure_get_string (s, "format"), "S16LE");
+  fail_unless (gst_structure_get_int (s, "rate", &val));
+  fail_unless_equals_int (val, 48000);
+  fail_unless (gst_structure_get_int (s, "foo", &val));
+  fail_unless_equals_int (val, 1);
+
+  gst_structure_free (s);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_structure_suite (void)
 {
@@ -1050,6 +1093,7 @@ gst_structure_suite (void)
   tcase_add_test (tc_chain, test_map_in_place);
   tcase_add_test (tc_chain, test_filter_and_map_in_place);
   tcase_add_test (tc_chain, test_flagset);
+  tcase_add_test (tc_chain, test_well_known_field_order);
   return s;
 }
 
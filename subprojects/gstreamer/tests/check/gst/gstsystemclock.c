@@ -227,6 +227,43 @@ GST_START_TEST (test_resolution)
 
 GST_END_TEST;
 
+GST_START_TEST (test_wait_slack)
+{
+  GstClock *clock;
+  GstClockTime slack = 20 * GST_MSECOND;
+  guint64 val;
+  gint i;
+
+  clock = g_object_new (GST_TYPE_SYSTEM_CLOCK, "clock-type",
+      GST_CLOCK_TYPE_MONOTONIC, "wait-slack", slack, NULL);
+  g_object_get (clock, "wait-slack", &val, NULL);
+  fail_unless_equals_uint64 (val, slack);
+
+  /* waits end at the end of the slack window their deadline falls in,
+   * never before */
+  for (i = 1; i <= 5; i++) {
+    GstClockTime target, aligned, now;
+    GstClockID id;
+
+    target = gst_clock_get_time (clock) + i * 3 * GST_MSECOND;
+    aligned = ((target + slack - 1) / slack) * slack;
+
+    id = gst_clock_new_single_shot_id (clock, target);
+    fail_unless_equals_int (gst_clock_id_wait (id, NULL), GST_CLOCK_OK);
+    gst_clock_id_unref (id);
+
+    now = gst_clock_get_time (clock);
+    /* the deadline is computed from the microsecond monotonic time */
+    fail_unless (now + GST_USECOND >= aligned,
+        "woke up at %" GST_TIME_FORMAT " before aligned deadline %"
+        GST_TIME_FORMAT, GST_TIME_ARGS (now), GST_TIME_ARGS (aligned));
+  }
+
+  gst_object_unref (clock);
+}
+
+GST_END_TEST;
+
 typedef struct
 {
   GThread *thread_wait;
@@ -398,6 +435,7 @@ gst_systemclock_suite (void)
   tcase_add_test (tc_chain, test_async_full);
   tcase_add_test (tc_chain, test_set_default);
   tcase_add_test (tc_chain, test_resolution);
+  tcase_add_test (tc_chain, test_wait_slack);
   tcase_add_test (tc_chain, test_stress_cleanup_unschedule);
   tcase_add_test (tc_chain, test_stress_reschedule);
 
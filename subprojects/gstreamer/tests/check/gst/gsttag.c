@@ -584,6 +584,57 @@ GST_START_TEST (test_writability)
 
 GST_END_TEST;
 
+/* copies and merges share the tags until one of the lists is modified */
+GST_START_TEST (test_copy_on_write)
+{
+  GstTagList *tags, *copy, *merged;
+  const gchar *artist1, *artist2;
+  gchar *str;
+
+  tags = gst_tag_list_new (GST_TAG_ARTIST, "Foo", GST_TAG_TITLE, "Bar", NULL);
+  copy = gst_tag_list_copy (tags);
+  fail_unless (gst_tag_list_is_equal (tags, copy));
+
+  /* both lists return the same string since it is shared */
+  fail_unless (gst_tag_list_peek_string_index (tags, GST_TAG_ARTIST, 0,
+          &artist1));
+  fail_unless (gst_tag_list_peek_string_index (copy, GST_TAG_ARTIST, 0,
+          &artist2));
+  fail_unless (artist1 == artist2);
+
+  /* modifying the copy must not affect the original */
+  gst_tag_list_add (copy, GST_TAG_MERGE_REPLACE, GST_TAG_ARTIST, "Baz", NULL);
+  gst_tag_list_remove_tag (copy, GST_TAG_TITLE);
+  fail_if (gst_tag_list_is_equal (tags, copy));
+  fail_unless (gst_tag_list_get_string (tags, GST_TAG_ARTIST, &str));
+  fail_unless_equals_string (str, "Foo");
+  g_free (str);
+  fail_unless (gst_tag_list_get_tag_size (tags, GST_TAG_TITLE) == 1);
+  fail_unless (gst_tag_list_get_string (copy, GST_TAG_ARTIST, &str));
+  fail_unless_equals_string (str, "Baz");
+  g_free (str);
+  fail_unless (gst_tag_list_get_tag_size (copy, GST_TAG_TITLE) == 0);
+
+  /* and the other way around */
+  merged = gst_tag_list_merge (NULL, tags, GST_TAG_MERGE_APPEND);
+  fail_unless (gst_tag_list_is_equal (tags, merged));
+  gst_tag_list_add (tags, GST_TAG_MERGE_APPEND, GST_TAG_ARTIST, "Qux", NULL);
+  fail_unless (gst_tag_list_get_tag_size (tags, GST_TAG_ARTIST) == 2);
+  fail_unless (gst_tag_list_get_tag_size (merged, GST_TAG_ARTIST) == 1);
+
+  /* replacing everything takes over the other list's tags */
+  gst_tag_list_insert (merged, copy, GST_TAG_MERGE_REPLACE_ALL);
+  fail_unless (gst_tag_list_is_equal (merged, copy));
+  gst_tag_list_add (merged, GST_TAG_MERGE_APPEND, GST_TAG_ARTIST, "Qux", NULL);
+  fail_unless (gst_tag_list_get_tag_size (copy, GST_TAG_ARTIST) == 1);
+
+  gst_tag_list_unref (merged);
+  gst_tag_list_unref (copy);
+  gst_tag_list_unref (tags);
+}
+
+GST_END_TEST;
+
 /* this tests GstSample serialisation/deserialisation, esp. with multiple
  * samples in a tag list */
 GST_START_TEST (test_serialization)
@@ -664,6 +715,7 @@ gst_tag_suite (void)
   tcase_add_test (tc_chain, test_new_full);
   tcase_add_test (tc_chain, test_equal);
   tcase_add_test (tc_chain, test_writability);
+  tcase_add_test (tc_chain, test_copy_on_write);
   tcase_add_test (tc_chain, test_serialization);
   tcase_add_test (tc_chain, test_empty_taglist_serialization);
 
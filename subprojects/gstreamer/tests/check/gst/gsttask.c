@@ -73,6 +73,52 @@ GST_START_TEST (test_resume)
 
 GST_END_TEST;
 
+GST_START_TEST (test_cpu_affinity)
+{
+  const guint cpus[] = { 0, 2 };
+  GstTask *t;
+  guint *res, n_res;
+
+  t = gst_task_new (task_resume_func, &t, NULL);
+  fail_if (t == NULL);
+
+  res = gst_task_get_cpu_affinity (t, &n_res);
+  fail_unless (res == NULL);
+  fail_unless_equals_int (n_res, 0);
+
+  gst_task_set_cpu_affinity (t, cpus, G_N_ELEMENTS (cpus));
+  res = gst_task_get_cpu_affinity (t, &n_res);
+  fail_unless_equals_int (n_res, 2);
+  fail_unless_equals_int (res[0], 0);
+  fail_unless_equals_int (res[1], 2);
+  g_free (res);
+
+  /* the task still runs when restricted to CPU 0 */
+  gst_task_set_cpu_affinity (t, cpus, 1);
+
+  g_rec_mutex_init (&task_mutex);
+  gst_task_set_lock (t, &task_mutex);
+
+  g_cond_init (&task_cond);
+  g_mutex_init (&task_lock);
+
+  g_mutex_lock (&task_lock);
+  fail_unless (gst_task_start (t));
+  g_cond_wait (&task_cond, &task_lock);
+  fail_unless (gst_task_stop (t));
+  g_mutex_unlock (&task_lock);
+  fail_unless (gst_task_join (t));
+
+  gst_task_set_cpu_affinity (t, NULL, 0);
+  res = gst_task_get_cpu_affinity (t, &n_res);
+  fail_unless (res == NULL);
+  fail_unless_equals_int (n_res, 0);
+
+  gst_object_unref (t);
+}
+
+GST_END_TEST;
+
 static void
 task_signal_pause_func (void *data)
 {
@@ -478,6 +524,7 @@ gst_task_suite (void)
   tcase_add_test (tc_chain, test_join);
   tcase_add_test (tc_chain, test_pause_stop_race);
   tcase_add_test (tc_chain, test_resume);
+  tcase_add_test (tc_chain, test_cpu_affinity);
   tcase_add_test (tc_chain, test_shared_task_pool_shared_thread);
   tcase_add_test (tc_chain, test_shared_task_pool_two_threads);
 
@@ -1448,6 +1448,112 @@ GST_START_TEST (test_take_buffer_fast)
 
 GST_END_TEST;
 
+GST_START_TEST (test_scan_start_code)
+{
+  GstAdapter *adapter;
+  guint8 data[300] = { 0, };
+  guint32 value;
+  gssize offset;
+  guint split;
+
+  /* start codes at offsets 3, 70 and 200, with garbage around */
+  memset (data, 0xaa, sizeof (data));
+  data[3] = data[4] = 0x00;
+  data[5] = 0x01;
+  data[6] = 0xb3;
+  data[70] = data[71] = 0x00;
+  data[72] = 0x01;
+  data[73] = 0x00;
+  data[200] = data[201] = 0x00;
+  data[202] = 0x01;
+  data[203] = 0xb8;
+
+  /* split the data in two buffers at every possible position so that the
+   * start codes are found both inside buffers and across them */
+  for (split = 1; split < sizeof (data); split++) {
+    adapter = gst_adapter_new ();
+    gst_adapter_push (adapter, gst_buffer_new_memdup (data, split));
+    gst_adapter_push (adapter, gst_buffer_new_memdup (data + split,
+            sizeof (data) - split));
+
+    offset = gst_adapter_masked_scan_uint32_peek (adapter, 0xffffff00,
+        0x00000100, 0, sizeof (data), &value);
+    fail_unless_equals_int (offset, 3);
+    fail_unless_equals_int (value, 0x000001b3);
+
+    offset = gst_adapter_masked_scan_uint32_peek (adapter, 0xffffff00,
+        0x00000100, 4, sizeof (data) - 4, &value);
+    fail_unless_equals_int (offset, 70);
+    fail_unless_equals_int (value, 0x00000100);
+
+    offset = gst_adapter_masked_scan_uint32_peek (adapter, 0xffffff00,
+        0x00000100, 71, sizeof (data) - 71, &value);
+    fail_unless_equals_int (offset, 200);
+    fail_unless_equals_int (value, 0x000001b8);
+
+    /* the last byte of the start code isn't in range */
+    offset = gst_adapter_masked_scan_uint32_peek (adapter, 0xffffff00,
+        0x00000100, 71, 132, &value);
+    fail_unless_equals_int (offset, -1);
+
+    offset = gst_adapter_masked_scan_uint32_peek (adapter, 0xffffff00,
+        0x00000100, 201, sizeof (data) - 201, &value);
+    fail_unless_equals_int (offset, -1);
+
+    g_object_unref (adapter);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_map_chunks)
+{
+  GstAdapter *adapter;
+  GstAdapterChunks chunks;
+  guint8 data[30];
+  guint i, j, pos;
+
+  for (i = 0; i < sizeof (data); i++)
+    data[i] = i;
+
+  adapter = gst_adapter_new ();
+  gst_adapter_push (adapter, gst_buffer_new_memdup (data, 10));
+  gst_adapter_push (adapter, gst_buffer_new_memdup (data + 10, 10));
+  gst_adapter_push (adapter, gst_buffer_new_memdup (data + 20, 10));
+  gst_adapter_flush (adapter, 2);
+
+  /* within the first buffer */
+  fail_unless (gst_adapter_map_chunks (adapter, 1, 5, &chunks));
+  fail_unless_equals_int (chunks.n_chunks, 1);
+  fail_unless_equals_int (chunks.chunks[0].size, 5);
+  fail_unless (memcmp (chunks.chunks[0].data, data + 3, 5) == 0);
+  gst_adapter_unmap_chunks (adapter, &chunks);
+  fail_unless (chunks.chunks == NULL);
+
+  /* spanning all buffers */
+  fail_unless (gst_adapter_map_chunks (adapter, 5, 22, &chunks));
+  fail_unless_equals_int (chunks.n_chunks, 3);
+  fail_unless_equals_int (chunks.chunks[0].size, 3);
+  fail_unless_equals_int (chunks.chunks[1].size, 10);
+  fail_unless_equals_int (chunks.chunks[2].size, 9);
+  pos = 7;
+  for (i = 0; i < chunks.n_chunks; i++) {
+    for (j = 0; j < chunks.chunks[i].size; j++)
+      fail_unless_equals_int (chunks.chunks[i].data[j], data[pos++]);
+  }
+  gst_adapter_unmap_chunks (adapter, &chunks);
+
+  /* starting exactly at a buffer boundary */
+  fail_unless (gst_adapter_map_chunks (adapter, 8, 10, &chunks));
+  fail_unless_equals_int (chunks.n_chunks, 1);
+  fail_unless (memcmp (chunks.chunks[0].data, data + 10, 10) == 0);
+  gst_adapter_unmap_chunks (adapter, &chunks);
+
+  g_object_unref (adapter);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_adapter_suite (void)
 {
@@ -1465,6 +1571,8 @@ gst_adapter_suite (void)
   tcase_add_test (tc_chain, test_take_buf_order);
   tcase_add_test (tc_chain, test_timestamp);
   tcase_add_test (tc_chain, test_scan);
+  tcase_add_test (tc_chain, test_scan_start_code);
+  tcase_add_test (tc_chain, test_map_chunks);
   tcase_add_test (tc_chain, test_take_list);
   tcase_add_test (tc_chain, test_get_list);
   tcase_add_test (tc_chain, test_take_buffer_list);
@@ -758,6 +758,8 @@ _test_timeout (gint buffer_wait)
   GstMessage *msg;
   GstElement *pipeline, *src, *src1, *agg, *sink;
   GstPad *src1pad;
+  GstStructure *stats;
+  guint64 ready, timeouts, avg_lateness, max_lateness;
   gint count = 0;
 
   pipeline = gst_pipeline_new ("pipeline");
@@ -803,6 +805,19 @@ _test_timeout (gint buffer_wait)
    * testaggregator */
   fail_if (count < TIMEOUT_NUM_BUFFERS);
 
+  g_object_get (agg, "stats", &stats, NULL);
+  fail_unless (gst_structure_has_name (stats,
+          "application/x-gst-aggregator-stats"));
+  fail_unless (gst_structure_get_uint64 (stats, "ready", &ready));
+  fail_unless (gst_structure_get_uint64 (stats, "timeouts", &timeouts));
+  fail_unless (gst_structure_get_uint64 (stats, "average-lateness",
+          &avg_lateness));
+  fail_unless (gst_structure_get_uint64 (stats, "max-lateness",
+          &max_lateness));
+  fail_unless (ready + timeouts > 0);
+  fail_unless (avg_lateness <= max_lateness);
+  gst_structure_free (stats);
+
   gst_element_set_state (pipeline, GST_STATE_NULL);
   gst_object_unref (src1pad);
   gst_object_unref (bus);
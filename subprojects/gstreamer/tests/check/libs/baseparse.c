@@ -60,6 +60,8 @@ struct _GstParserTester
 
   /* don't immediately set the src caps when receiving sink caps */
   gboolean delay_srccaps;
+
+  guint max_batch_frames;
 };
 
 struct _GstParserTesterClass
@@ -72,6 +74,10 @@ G_DEFINE_TYPE (GstParserTester, gst_parser_tester, GST_TYPE_BASE_PARSE);
 static gboolean
 gst_parser_tester_start (GstBaseParse * parse)
 {
+  GstParserTester *test = (GstParserTester *) parse;
+
+  gst_base_parse_set_max_batch_frames (parse, test->max_batch_frames);
+
   return TRUE;
 }
 
@@ -366,6 +372,66 @@ GST_START_TEST (parser_reverse_playback_on_passthrough)
 
 GST_END_TEST;
 
+static GstBuffer *
+create_test_buffer_multi (guint64 first, guint n)
+{
+  GstBuffer *buffer;
+  guint64 *data = g_new (guint64, n);
+  guint i;
+
+  for (i = 0; i < n; i++)
+    data[i] = first + i;
+
+  buffer = gst_buffer_new_wrapped (data, n * sizeof (guint64));
+
+  GST_BUFFER_PTS (buffer) =
+      gst_util_uint64_scale_round (first, GST_SECOND * TEST_VIDEO_FPS_D,
+      TEST_VIDEO_FPS_N);
+  GST_BUFFER_DURATION (buffer) =
+      gst_util_uint64_scale_round (n * GST_SECOND, TEST_VIDEO_FPS_D,
+      TEST_VIDEO_FPS_N);
+
+  return buffer;
+}
+
+static GstPadProbeReturn
+count_lists_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  guint *n_lists = user_data;
+
+  fail_unless (gst_buffer_list_length (GST_PAD_PROBE_INFO_BUFFER_LIST (info))
+      <= 4);
+  *n_lists += 1;
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (parser_playback_batched)
+{
+  GList *input = NULL;
+  guint n_lists = 0;
+  GstPad *srcpad;
+
+  setup_parsertester ();
+
+  ((GstParserTester *) parsetest)->max_batch_frames = 4;
+  srcpad = gst_element_get_static_pad (parsetest, "src");
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      count_lists_probe, &n_lists, NULL);
+  gst_object_unref (srcpad);
+
+  /* 6 frames in the first buffer, 2 in the second one */
+  input = g_list_append (input, create_test_buffer_multi (0, 6));
+  input = g_list_append (input, create_test_buffer_multi (6, 2));
+
+  run_parser_playback_test (input, 8, 1.0);
+
+  /* 4 + 2 frames, then 2 frames */
+  fail_unless_equals_int (n_lists, 3);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (parser_empty_stream)
 {
   setup_parsertester ();
@@ -790,6 +856,7 @@ gst_baseparse_suite (void)
   suite_add_tcase (s, tc);
   tcase_add_checked_fixture (tc, baseparse_setup, baseparse_teardown);
   tcase_add_test (tc, parser_playback);
+  tcase_add_test (tc, parser_playback_batched);
   tcase_add_test (tc, parser_empty_stream);
   tcase_add_test (tc, parser_reverse_playback_on_passthrough);
   tcase_add_test (tc, parser_reverse_playback);
@@ -24,6 +24,7 @@
 #include <gst/gst.h>
 #include <gst/check/gstcheck.h>
 #include <gst/base/gstbasesink.h>
+#include <gst/check/gstharness.h>
 
 GST_START_TEST (basesink_last_sample_enabled)
 {
@@ -282,6 +283,55 @@ GST_START_TEST (basesink_position_query_handles_segment_offset)
 
 GST_END_TEST;
 
+static void
+handoff_count_cb (GstElement * sink, GstBuffer * buffer, GstPad * pad,
+    guint * count)
+{
+  (*count)++;
+}
+
+GST_START_TEST (basesink_list_sync)
+{
+  GstHarness *h;
+  GstBufferList *list;
+  GstSample *last_sample;
+  guint i, count = 0;
+
+  h = gst_harness_new ("fakesink");
+  g_object_set (h->element, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (h->element, "handoff", G_CALLBACK (handoff_count_cb),
+      &count);
+  gst_harness_set_src_caps_str (h, "foo/bar");
+
+  fail_if (gst_base_sink_get_list_sync (GST_BASE_SINK (h->element)));
+  gst_base_sink_set_list_sync (GST_BASE_SINK (h->element), TRUE);
+  fail_unless (gst_base_sink_get_list_sync (GST_BASE_SINK (h->element)));
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 3; i++) {
+    GstBuffer *buffer = gst_buffer_new_and_alloc (10);
+
+    GST_BUFFER_PTS (buffer) = i * GST_MSECOND;
+    GST_BUFFER_DURATION (buffer) = GST_MSECOND;
+    gst_buffer_list_add (list, buffer);
+  }
+
+  fail_unless_equals_int (gst_pad_push_list (h->srcpad, list), GST_FLOW_OK);
+
+  /* every buffer is rendered, but the list is handled as a whole */
+  fail_unless_equals_int (count, 3);
+  g_object_get (h->element, "last-sample", &last_sample, NULL);
+  fail_unless (last_sample != NULL);
+  fail_unless (gst_sample_get_buffer_list (last_sample) != NULL);
+  fail_unless_equals_int (gst_buffer_list_length (gst_sample_get_buffer_list
+          (last_sample)), 3);
+  gst_sample_unref (last_sample);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_basesrc_suite (void)
 {
@@ -294,6 +344,7 @@ gst_basesrc_suite (void)
   tcase_add_test (tc, basesink_test_gap);
   tcase_add_test (tc, basesink_test_eos_after_playing);
   tcase_add_test (tc, basesink_position_query_handles_segment_offset);
+  tcase_add_test (tc, basesink_list_sync);
 
   return s;
 }
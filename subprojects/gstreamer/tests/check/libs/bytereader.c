@@ -608,6 +608,65 @@ GST_START_TEST (test_scan)
 
 GST_END_TEST;
 
+/* the start code scan is vectorized, check it against a plain scan for
+ * start codes at all positions within and across blocks */
+GST_START_TEST (test_scan_start_codes)
+{
+  GstByteReader reader;
+  GRand *rand = g_rand_new_with_seed (42);
+  guint8 *data;
+  guint size = 256;
+  guint i, j, offset;
+
+  data = g_malloc (size);
+
+  for (i = 0; i < 500; i++) {
+    gint expected = -1, found;
+    guint32 val = 0;
+
+    for (j = 0; j < size; j++) {
+      /* mostly data without start codes, but with some zeros and ones */
+      switch (g_rand_int_range (rand, 0, 16)) {
+        case 0:
+          data[j] = 0;
+          break;
+        case 1:
+          data[j] = 1;
+          break;
+        default:
+          data[j] = g_rand_int_range (rand, 2, 256);
+          break;
+      }
+    }
+    /* place a start code at some random position */
+    if (i % 2) {
+      j = g_rand_int_range (rand, 0, size - 3);
+      data[j] = data[j + 1] = 0;
+      data[j + 2] = 1;
+    }
+
+    offset = g_rand_int_range (rand, 0, 32);
+    for (j = offset; j + 3 < size; j++) {
+      if (data[j] == 0 && data[j + 1] == 0 && data[j + 2] == 1) {
+        expected = j;
+        break;
+      }
+    }
+
+    gst_byte_reader_init (&reader, data, size);
+    found = gst_byte_reader_masked_scan_uint32_peek (&reader, 0xffffff00,
+        0x00000100, offset, size - offset, &val);
+    fail_unless_equals_int (found, expected);
+    if (found >= 0)
+      fail_unless_equals_int (val, 0x00000100 | data[found + 3]);
+  }
+
+  g_free (data);
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_string_funcs)
 {
   GstByteReader reader, backup;
@@ -836,6 +895,7 @@ gst_byte_reader_suite (void)
   tcase_add_test (tc_chain, test_get_float_be);
   tcase_add_test (tc_chain, test_position_tracking);
   tcase_add_test (tc_chain, test_scan);
+  tcase_add_test (tc_chain, test_scan_start_codes);
   tcase_add_test (tc_chain, test_string_funcs);
   tcase_add_test (tc_chain, test_dup_string);
   tcase_add_test (tc_chain, test_sub_reader);
@@ -31,6 +31,7 @@ typedef struct
   GstPad *sinkpad;
   GList *events;
   GList *buffers;
+  guint n_lists;
   GstElement *trans;
   GstBaseTransformClass *klass;
 } TestTransData;
@@ -84,6 +85,8 @@ GstFlowReturn (*klass_submit_input_buffer) (GstBaseTransform * trans,
     gboolean is_discont, GstBuffer * input) = NULL;
 GstFlowReturn (*klass_generate_output) (GstBaseTransform * trans,
     GstBuffer ** outbuf) = NULL;
+GstFlowReturn (*klass_transform_ip_list) (GstBaseTransform * trans,
+    GstBufferList * list) = NULL;
 
 static GstStaticPadTemplate *sink_template = &gst_test_trans_sink_template;
 static GstStaticPadTemplate *src_template = &gst_test_trans_src_template;
@@ -122,6 +125,8 @@ gst_test_trans_class_init (GstTestTransClass * klass)
     trans_class->submit_input_buffer = klass_submit_input_buffer;
   if (klass_generate_output)
     trans_class->generate_output = klass_generate_output;
+  if (klass_transform_ip_list)
+    trans_class->transform_ip_list = klass_transform_ip_list;
 }
 
 static void
@@ -147,6 +152,24 @@ result_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   return GST_FLOW_OK;
 }
 
+static GstFlowReturn
+result_sink_chain_list (GstPad * pad, GstObject * parent, GstBufferList * list)
+{
+  TestTransData *data;
+  guint i, len;
+
+  data = gst_pad_get_element_private (pad);
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len; i++)
+    data->buffers = g_list_append (data->buffers,
+        gst_buffer_ref (gst_buffer_list_get (list, i)));
+  data->n_lists++;
+  gst_buffer_list_unref (list);
+
+  return GST_FLOW_OK;
+}
+
 #if 0
 static GstFlowReturn
 result_buffer_alloc (GstPad * pad, guint64 offset, guint size, GstCaps * caps,
@@ -206,6 +229,7 @@ gst_test_trans_new (void)
   gst_pad_set_element_private (res->sinkpad, res);
 
   gst_pad_set_chain_function (res->sinkpad, result_sink_chain);
+  gst_pad_set_chain_list_function (res->sinkpad, result_sink_chain_list);
 
   tmp = gst_element_get_static_pad (res->trans, "sink");
   gst_pad_link (res->srcpad, tmp);
@@ -941,6 +941,178 @@ GST_START_TEST (basetransform_invalid_fixatecaps_impl)
 
 GST_END_TEST;
 
+static GstBufferList *
+create_test_list (guint n_buffers)
+{
+  GstBufferList *list;
+  guint i;
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < n_buffers; i++)
+    gst_buffer_list_add (list, gst_buffer_new_and_alloc (20));
+
+  return list;
+}
+
+/* passthrough without transform_ip forwards lists as a whole */
+GST_START_TEST (basetransform_chain_pt_list)
+{
+  TestTransData *trans;
+  GstBuffer *buffer;
+  GstFlowReturn res;
+  guint i;
+
+  trans = gst_test_trans_new ();
+
+  gst_test_trans_push_segment (trans);
+
+  res = gst_pad_push_list (trans->srcpad, create_test_list (3));
+  fail_unless (res == GST_FLOW_OK);
+  fail_unless_equals_int (trans->n_lists, 1);
+
+  for (i = 0; i < 3; i++) {
+    buffer = gst_test_trans_pop (trans);
+    fail_unless (buffer != NULL);
+    fail_unless (gst_buffer_get_size (buffer) == 20);
+    gst_buffer_unref (buffer);
+  }
+  fail_unless (gst_test_trans_pop (trans) == NULL);
+
+  gst_test_trans_free (trans);
+}
+
+GST_END_TEST;
+
+static guint submit_input_buffer_called;
+
+static GstFlowReturn
+counting_submit_input_buffer (GstBaseTransform * trans, gboolean is_discont,
+    GstBuffer * input)
+{
+  GstBaseTransformClass *base_class =
+      g_type_class_peek (GST_TYPE_BASE_TRANSFORM);
+
+  submit_input_buffer_called++;
+
+  return base_class->submit_input_buffer (trans, is_discont, input);
+}
+
+/* passthrough with an overridden submit_input_buffer sees every buffer */
+GST_START_TEST (basetransform_chain_pt_list_submit_input)
+{
+  TestTransData *trans;
+  GstBuffer *buffer;
+  GstFlowReturn res;
+  guint i;
+
+  klass_submit_input_buffer = counting_submit_input_buffer;
+  trans = gst_test_trans_new ();
+
+  gst_test_trans_push_segment (trans);
+
+  submit_input_buffer_called = 0;
+  res = gst_pad_push_list (trans->srcpad, create_test_list (3));
+  fail_unless (res == GST_FLOW_OK);
+  fail_unless_equals_int (submit_input_buffer_called, 3);
+  fail_unless_equals_int (trans->n_lists, 0);
+
+  for (i = 0; i < 3; i++) {
+    buffer = gst_test_trans_pop (trans);
+    fail_unless (buffer != NULL);
+    gst_buffer_unref (buffer);
+  }
+  fail_unless (gst_test_trans_pop (trans) == NULL);
+
+  gst_test_trans_free (trans);
+  klass_submit_input_buffer = NULL;
+}
+
+GST_END_TEST;
+
+static guint transform_ip_list_1_called;
+static gboolean transform_ip_list_1_writable;
+
+static GstFlowReturn
+transform_ip_list_1 (GstBaseTransform * trans, GstBufferList * list)
+{
+  guint i, len;
+
+  GST_DEBUG_OBJECT (trans, "transform list called");
+
+  transform_ip_list_1_called++;
+  transform_ip_list_1_writable = gst_buffer_list_is_writable (list);
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len; i++) {
+    if (!gst_buffer_is_writable (gst_buffer_list_get (list, i)))
+      transform_ip_list_1_writable = FALSE;
+  }
+
+  return GST_FLOW_OK;
+}
+
+/* in-place with transform_ip_list handles the list at once, with writable
+ * buffers, otherwise the list is split into buffers */
+GST_START_TEST (basetransform_chain_ip_list)
+{
+  TestTransData *trans;
+  GstBufferList *list;
+  GstBuffer *buffer, *extra;
+  GstFlowReturn res;
+  guint i;
+
+  klass_transform_ip = transform_ip_1;
+  klass_transform_ip_list = transform_ip_list_1;
+  trans = gst_test_trans_new ();
+
+  gst_test_trans_push_segment (trans);
+
+  list = create_test_list (3);
+  /* take additional ref to make one buffer non-writable */
+  extra = gst_buffer_ref (gst_buffer_list_get (list, 1));
+
+  transform_ip_1_called = FALSE;
+  transform_ip_list_1_called = 0;
+  transform_ip_list_1_writable = FALSE;
+  res = gst_pad_push_list (trans->srcpad, list);
+  fail_unless (res == GST_FLOW_OK);
+  fail_unless (transform_ip_1_called == FALSE);
+  fail_unless_equals_int (transform_ip_list_1_called, 1);
+  fail_unless (transform_ip_list_1_writable == TRUE);
+  fail_unless_equals_int (trans->n_lists, 1);
+  gst_buffer_unref (extra);
+
+  for (i = 0; i < 3; i++) {
+    buffer = gst_test_trans_pop (trans);
+    fail_unless (buffer != NULL);
+    gst_buffer_unref (buffer);
+  }
+
+  gst_test_trans_free (trans);
+
+  /* without transform_ip_list every buffer is handled individually */
+  klass_transform_ip_list = NULL;
+  trans = gst_test_trans_new ();
+
+  gst_test_trans_push_segment (trans);
+
+  transform_ip_1_called = FALSE;
+  res = gst_pad_push_list (trans->srcpad, create_test_list (3));
+  fail_unless (res == GST_FLOW_OK);
+  fail_unless (transform_ip_1_called == TRUE);
+  fail_unless_equals_int (trans->n_lists, 0);
+
+  for (i = 0; i < 3; i++) {
+    buffer = gst_test_trans_pop (trans);
+    fail_unless (buffer != NULL);
+    gst_buffer_unref (buffer);
+  }
+
+  gst_test_trans_free (trans);
+}
+
+GST_END_TEST;
+
 static void
 transform1_setup (void)
 {
@@ -960,6 +1132,7 @@ transform1_teardown (void)
   klass_fixate_caps = NULL;
   klass_submit_input_buffer = NULL;
   klass_generate_output = NULL;
+  klass_transform_ip_list = NULL;
 }
 
 static Suite *
@@ -974,9 +1147,12 @@ gst_basetransform_suite (void)
   /* pass through */
   tcase_add_test (tc, basetransform_chain_pt1);
   tcase_add_test (tc, basetransform_chain_pt2);
+  tcase_add_test (tc, basetransform_chain_pt_list);
+  tcase_add_test (tc, basetransform_chain_pt_list_submit_input);
   /* in place */
   tcase_add_test (tc, basetransform_chain_ip1);
   tcase_add_test (tc, basetransform_chain_ip2);
+  tcase_add_test (tc, basetransform_chain_ip_list);
   /* copy transform */
   tcase_add_test (tc, basetransform_chain_ct1);
   tcase_add_test (tc, basetransform_chain_ct2);
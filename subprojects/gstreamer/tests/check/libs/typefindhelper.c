@@ -39,6 +39,16 @@ static GstStaticCaps foobar_caps = GST_STATIC_CAPS ("foo/x-bar");
 
 #define FOOBAR_CAPS (gst_static_caps_get (&foobar_caps))
 
+static void range_typefind (GstTypeFind * tf, gpointer unused);
+
+static GstStaticCaps range_caps = GST_STATIC_CAPS ("foo/x-range");
+
+#define RANGE_CAPS (gst_static_caps_get (&range_caps))
+
+#define RANGE_DATA_SIZE 16384
+static guint8 range_data[RANGE_DATA_SIZE];
+static guint64 range_pulled;
+
 /* make sure the entire data in the buffer is available for peeking */
 GST_START_TEST (test_buffer_range)
 {
@@ -72,6 +82,54 @@ GST_START_TEST (test_buffer_range)
 
 GST_END_TEST;
 
+static GstFlowReturn
+range_getrange (GstObject * obj, GstObject * parent, guint64 offset,
+    guint length, GstBuffer ** buffer)
+{
+  if (offset >= RANGE_DATA_SIZE)
+    return GST_FLOW_EOS;
+
+  length = MIN (length, RANGE_DATA_SIZE - offset);
+  range_pulled += length;
+
+  *buffer = gst_buffer_new_memdup (range_data + offset, length);
+  GST_BUFFER_OFFSET (*buffer) = offset;
+
+  return GST_FLOW_OK;
+}
+
+/* make sure ranges that are partly cached don't get pulled again */
+GST_START_TEST (test_get_range_overlap)
+{
+  GstObject *obj;
+  GstCaps *caps;
+  guint i;
+
+  for (i = 0; i < RANGE_DATA_SIZE; i++)
+    range_data[i] = i * 7;
+
+  fail_unless (gst_type_find_register (NULL, "foo/x-range",
+          GST_RANK_PRIMARY + 100, range_typefind, NULL, RANGE_CAPS, NULL,
+          NULL));
+
+  obj = (GstObject *) gst_bin_new (NULL);
+  range_pulled = 0;
+
+  caps = gst_type_find_helper_get_range (obj, NULL, range_getrange,
+      RANGE_DATA_SIZE, NULL, NULL);
+  fail_unless (caps != NULL);
+  fail_unless (gst_structure_has_name (gst_caps_get_structure (caps, 0),
+          "foo/x-range"));
+  gst_caps_unref (caps);
+
+  /* every byte up to the highest peeked offset is pulled only once */
+  fail_unless_equals_uint64 (range_pulled, 12288);
+
+  gst_object_unref (obj);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_typefindhelper_suite (void)
 {
@@ -80,6 +138,7 @@ gst_typefindhelper_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_buffer_range);
+  tcase_add_test (tc_chain, test_get_range_overlap);
 
   return s;
 }
@@ -121,3 +180,29 @@ foobar_typefind (GstTypeFind * tf, gpointer unused)
 
   gst_type_find_suggest (tf, GST_TYPE_FIND_MAXIMUM, FOOBAR_CAPS);
 }
+
+static void
+range_typefind (GstTypeFind * tf, gpointer unused)
+{
+  const guint8 *data;
+
+  data = gst_type_find_peek (tf, 0, 4096);
+  fail_unless (data != NULL);
+  fail_unless (memcmp (data, range_data, 4096) == 0);
+
+  /* overlaps the cached range at the start */
+  data = gst_type_find_peek (tf, 2048, 4096);
+  fail_unless (data != NULL);
+  fail_unless (memcmp (data, range_data + 2048, 4096) == 0);
+
+  data = gst_type_find_peek (tf, 6000, 6288);
+  fail_unless (data != NULL);
+  fail_unless (memcmp (data, range_data + 6000, 6288) == 0);
+
+  /* fully cached, ending exactly at the end of a pulled buffer */
+  data = gst_type_find_peek (tf, 8000, 192);
+  fail_unless (data != NULL);
+  fail_unless (memcmp (data, range_data + 8000, 192) == 0);
+
+  gst_type_find_suggest (tf, GST_TYPE_FIND_MAXIMUM, RANGE_CAPS);
+}
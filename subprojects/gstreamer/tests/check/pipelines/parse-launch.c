@@ -734,6 +734,58 @@ GST_START_TEST (test_parsing)
 
 GST_END_TEST;
 
+GST_START_TEST (test_template)
+{
+  GstParseTemplate *templ;
+  GstElement *pipeline, *src, *sink;
+  GError *err = NULL;
+  gint sizemax, i;
+
+  templ = gst_parse_template_new ("fakesrc name=src num-buffers=4 sizemax=7 "
+      "! video/x-raw,width=8 ! ( identity silent=true ) ! fakesink name=sink "
+      "sync=true", NULL, GST_PARSE_FLAG_NONE, &err);
+  fail_unless (templ != NULL);
+  fail_unless (err == NULL);
+
+  for (i = 0; i < 2; i++) {
+    pipeline = gst_parse_template_instantiate (templ, &err);
+    fail_unless (pipeline != NULL);
+    fail_unless (err == NULL);
+    fail_unless (GST_IS_PIPELINE (pipeline));
+    fail_unless (g_object_is_floating (pipeline));
+    gst_object_ref_sink (pipeline);
+
+    src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+    fail_unless (src != NULL);
+    g_object_get (src, "sizemax", &sizemax, NULL);
+    fail_unless_equals_int (sizemax, 7);
+    sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+    fail_unless (sink != NULL);
+
+    fail_unless (GST_PAD_IS_LINKED (GST_ELEMENT (src)->srcpads->data));
+    fail_unless (GST_PAD_IS_LINKED (GST_ELEMENT (sink)->sinkpads->data));
+
+    gst_object_unref (src);
+    gst_object_unref (sink);
+    gst_object_unref (pipeline);
+  }
+
+  gst_parse_template_unref (templ);
+
+  /* unlike gst_parse_launch(), recoverable errors are fatal */
+  if (!g_getenv ("GST_DEBUG"))
+    gst_debug_set_default_threshold (GST_LEVEL_NONE);
+
+  templ = gst_parse_template_new ("fakesrc ! coffeesink", NULL,
+      GST_PARSE_FLAG_NONE, &err);
+  fail_unless (templ == NULL);
+  fail_unless (err != NULL);
+  fail_unless_equals_int (err->code, GST_PARSE_ERROR_NO_SUCH_ELEMENT);
+  g_clear_error (&err);
+}
+
+GST_END_TEST;
+
 static Suite *
 parse_suite (void)
 {
@@ -753,6 +805,7 @@ parse_suite (void)
   tcase_add_test (tc_chain, test_missing_elements);
   tcase_add_test (tc_chain, test_parsing);
   tcase_add_test (tc_chain, test_preset);
+  tcase_add_test (tc_chain, test_template);
   return s;
 }
 